@@ -0,0 +1,87 @@
+/**
+ * @file ann_benchmark.cpp
+ *
+ * Benchmarks of the forward and backward passes of neural network layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmark;
+
+//! The batch sizes and layer widths of the benchmarks.
+#define LAYER_SIZES { { 32, 64 }, { 32, 512 }, { 256, 64 }, { 256, 512 } }
+
+/**
+ * Time one forward and one backward pass of a network made of a linear layer
+ * of the given width followed by the given layer, on a batch of the given
+ * size.  The linear layer is timed on its own by LayerLinear, so the time of
+ * the given layer is the difference.
+ */
+template<typename LayerType>
+static void LayerForwardBackward(BenchmarkState& state)
+{
+  const size_t batchSize = state.Arg(0);
+  const size_t width = state.Arg(1);
+
+  FFN<MeanSquaredError<>> network;
+  network.Add<Linear<>>(width, width);
+  network.Add<LayerType>();
+  network.ResetParameters();
+
+  const arma::mat input = RandomDataset(batchSize, width);
+  const arma::mat target = RandomDataset(batchSize, width, 43);
+  arma::mat output, gradient;
+  while (state.KeepRunning())
+  {
+    network.Forward(input, output);
+    network.Backward(target, gradient);
+  }
+  state.SetCounter("points", batchSize);
+}
+MLPACK_BENCHMARK_TEMPLATE(LayerLinear, LayerForwardBackward<IdentityLayer<>>,
+    LAYER_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(LayerReLU, LayerForwardBackward<ReLULayer<>>,
+    LAYER_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(LayerSigmoid, LayerForwardBackward<SigmoidLayer<>>,
+    LAYER_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(LayerTanH, LayerForwardBackward<TanHLayer<>>,
+    LAYER_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(LayerLeakyReLU, LayerForwardBackward<LeakyReLU<>>,
+    LAYER_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(LayerDropout, LayerForwardBackward<Dropout<>>,
+    LAYER_SIZES);
+
+/**
+ * Time one forward and one backward pass of a convolution layer with 3x3
+ * kernels on 32x32 images, with the given batch size and number of maps.
+ */
+static void LayerConvolution(BenchmarkState& state)
+{
+  const size_t batchSize = state.Arg(0);
+  const size_t maps = state.Arg(1);
+
+  FFN<MeanSquaredError<>> network;
+  network.Add<Convolution<>>(maps, maps, 3, 3, 1, 1, 1, 1, 32, 32);
+  network.ResetParameters();
+
+  const arma::mat input = RandomDataset(batchSize, 32 * 32 * maps);
+  const arma::mat target = RandomDataset(batchSize, 32 * 32 * maps, 43);
+  arma::mat output, gradient;
+  while (state.KeepRunning())
+  {
+    network.Forward(input, output);
+    network.Backward(target, gradient);
+  }
+  state.SetCounter("points", batchSize);
+}
+MLPACK_BENCHMARK(LayerConvolution, { { 16, 1 }, { 16, 8 }, { 64, 8 } });
@@ -0,0 +1,241 @@
+/**
+ * @file benchmark.hpp
+ *
+ * A small harness for timing mlpack code.  Benchmarks are functions that are
+ * registered with a list of argument sets (e.g. dataset sizes and
+ * dimensions); each function is run once per argument set by
+ * mlpack_benchmarks, which reports the results as JSON or CSV.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <chrono>
+
+namespace mlpack {
+namespace benchmark {
+
+/**
+ * The state of one run of a benchmark: its arguments, and the timer.  A
+ * benchmark function does its setup, then repeats the code to time while
+ * KeepRunning() returns true:
+ *
+ * @code
+ * void KNNSearch(BenchmarkState& state)
+ * {
+ *   arma::mat data(state.Arg(1), state.Arg(0), arma::fill::randu);
+ *   KNN knn(data);
+ *   arma::Mat<size_t> neighbors;
+ *   arma::mat distances;
+ *   while (state.KeepRunning())
+ *     knn.Search(5, neighbors, distances);
+ * }
+ * MLPACK_BENCHMARK(KNNSearch, { { 1000, 3 }, { 10000, 3 } });
+ * @endcode
+ *
+ * The code is repeated until it has run for at least the minimum time and the
+ * minimum number of iterations.  Per-iteration setup that should not be timed
+ * can be bracketed with PauseTiming() and ResumeTiming().
+ */
+class BenchmarkState
+{
+ public:
+  /**
+   * Create the state of a run.
+   *
+   * @param args Arguments of the run.
+   * @param minTime Minimum total time of the timed iterations, in seconds.
+   * @param minIterations Minimum number of iterations.
+   */
+  BenchmarkState(const std::vector<size_t>& args,
+                 const double minTime,
+                 const size_t minIterations) :
+      args(args),
+      minTime(minTime),
+      minIterations(std::max(minIterations, (size_t) 1)),
+      iterations(0),
+      started(false),
+      running(false),
+      elapsed(0.0)
+  { /* Nothing to do here. */ }
+
+  //! Get the given argument of the run.
+  size_t Arg(const size_t i) const { return args[i]; }
+  //! Get all the arguments of the run.
+  const std::vector<size_t>& Args() const { return args; }
+
+  /**
+   * Return whether the timed code should be run (again).  The timer is started
+   * by the first call, and stopped when this returns false.
+   */
+  bool KeepRunning()
+  {
+    if (!started)
+    {
+      started = true;
+      ResumeTiming();
+      return true;
+    }
+
+    ++iterations;
+    if (iterations >= minIterations && Seconds() >= minTime)
+    {
+      PauseTiming();
+      return false;
+    }
+
+    return true;
+  }
+
+  //! Stop the timer, e.g. for setup that should not be timed.
+  void PauseTiming()
+  {
+    if (running)
+    {
+      elapsed += std::chrono::duration<double>(Clock::now() - start).count();
+      running = false;
+    }
+  }
+
+  //! Restart the timer.
+  void ResumeTiming()
+  {
+    if (!running)
+    {
+      start = Clock::now();
+      running = true;
+    }
+  }
+
+  /**
+   * Set a counter to report along with the time, e.g. the number of points
+   * processed by each iteration.
+   */
+  void SetCounter(const std::string& name, const double value)
+  {
+    counters[name] = value;
+  }
+
+  //! Get the counters.
+  const std::map<std::string, double>& Counters() const { return counters; }
+
+  //! Get the number of finished iterations.
+  size_t Iterations() const { return iterations; }
+
+  //! Get the total time of the timed iterations so far, in seconds.
+  double Seconds() const
+  {
+    return elapsed + (running ?
+        std::chrono::duration<double>(Clock::now() - start).count() : 0.0);
+  }
+
+ private:
+  //! Clock used for the timings.
+  typedef std::chrono::steady_clock Clock;
+
+  //! Arguments of the run.
+  std::vector<size_t> args;
+
+  //! Minimum total time of the timed iterations.
+  double minTime;
+
+  //! Minimum number of iterations.
+  size_t minIterations;
+
+  //! Number of finished iterations.
+  size_t iterations;
+
+  //! Whether KeepRunning() has been called.
+  bool started;
+
+  //! Whether the timer is running.
+  bool running;
+
+  //! Time of the timed iterations before the last ResumeTiming().
+  double elapsed;
+
+  //! Time of the last ResumeTiming().
+  Clock::time_point start;
+
+  //! Counters to report.
+  std::map<std::string, double> counters;
+};
+
+//! The type of a benchmark function.
+typedef void (*BenchmarkFunction)(BenchmarkState&);
+
+/**
+ * A registered benchmark: a function and the argument sets to run it with.
+ */
+struct Benchmark
+{
+  //! Name of the benchmark.
+  std::string name;
+
+  //! Function to run.
+  BenchmarkFunction function;
+
+  //! Argument sets to run the function with.
+  std::vector<std::vector<size_t>> args;
+};
+
+//! Get the list of registered benchmarks.
+inline std::vector<Benchmark>& Benchmarks()
+{
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+/**
+ * Registering object; creating a static instance registers a benchmark (see
+ * MLPACK_BENCHMARK()).
+ */
+struct BenchmarkRegistration
+{
+  BenchmarkRegistration(const std::string& name,
+                        BenchmarkFunction function,
+                        const std::vector<std::vector<size_t>>& args)
+  {
+    Benchmarks().push_back(Benchmark { name, function, args });
+  }
+};
+
+/**
+ * Generate a random dataset, with the given number of points (columns) and
+ * dimensions (rows), the same for every run.
+ */
+inline arma::mat RandomDataset(const size_t points,
+                               const size_t dimensions,
+                               const size_t seed = 42)
+{
+  arma::arma_rng::set_seed(seed);
+  return arma::randu<arma::mat>(dimensions, points);
+}
+
+} // namespace benchmark
+} // namespace mlpack
+
+/**
+ * Register the given benchmark function, to be run with each of the given
+ * argument sets.
+ */
+#define MLPACK_BENCHMARK(FUNCTION, ...) \
+    static mlpack::benchmark::BenchmarkRegistration \
+        FUNCTION##Registration(#FUNCTION, &FUNCTION, \
+        std::vector<std::vector<size_t>> __VA_ARGS__)
+
+/**
+ * Register the given instantiation of a benchmark function template, with the
+ * given name, to be run with each of the given argument sets.
+ */
+#define MLPACK_BENCHMARK_TEMPLATE(NAME, FUNCTION, ...) \
+    static mlpack::benchmark::BenchmarkRegistration \
+        NAME##Registration(#NAME, &FUNCTION, \
+        std::vector<std::vector<size_t>> __VA_ARGS__)
+
+#endif
@@ -0,0 +1,208 @@
+/**
+ * @file benchmark_main.cpp
+ *
+ * Entry point of mlpack_benchmarks: run the registered benchmarks and report
+ * the results.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/version.hpp>
+#include "benchmark.hpp"
+
+#include <ctime>
+#include <fstream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+//! The result of one run of a benchmark.
+struct Result
+{
+  std::string name;
+  std::vector<size_t> args;
+  size_t iterations;
+  double seconds;
+  std::map<std::string, double> counters;
+};
+
+//! Get the full name of a run: the benchmark name and its arguments.
+static std::string RunName(const std::string& name,
+                           const std::vector<size_t>& args)
+{
+  std::ostringstream oss;
+  oss << name;
+  for (size_t i = 0; i < args.size(); ++i)
+    oss << "/" << args[i];
+  return oss.str();
+}
+
+//! Write the results as JSON, in the layout used by Google Benchmark.
+static void WriteJSON(std::ostream& out, const std::vector<Result>& results)
+{
+  char date[64];
+  const std::time_t now = std::time(NULL);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  out << "{" << std::endl;
+  out << "  \"context\": {" << std::endl;
+  out << "    \"library\": \"mlpack\"," << std::endl;
+  out << "    \"version\": \"" << util::GetVersion() << "\"," << std::endl;
+  out << "    \"date\": \"" << date << "\"" << std::endl;
+  out << "  }," << std::endl;
+  out << "  \"benchmarks\": [" << std::endl;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const Result& r = results[i];
+    out << "    {" << std::endl;
+    out << "      \"name\": \"" << RunName(r.name, r.args) << "\","
+        << std::endl;
+    out << "      \"run_name\": \"" << r.name << "\"," << std::endl;
+    out << "      \"args\": [";
+    for (size_t j = 0; j < r.args.size(); ++j)
+      out << (j == 0 ? "" : ", ") << r.args[j];
+    out << "]," << std::endl;
+    out << "      \"iterations\": " << r.iterations << "," << std::endl;
+    for (std::map<std::string, double>::const_iterator it =
+        r.counters.begin(); it != r.counters.end(); ++it)
+    {
+      out << "      \"" << it->first << "\": " << it->second << ","
+          << std::endl;
+    }
+    out << "      \"real_time\": " << (1e9 * r.seconds / r.iterations) << ","
+        << std::endl;
+    out << "      \"time_unit\": \"ns\"" << std::endl;
+    out << "    }" << (i + 1 < results.size() ? "," : "") << std::endl;
+  }
+  out << "  ]" << std::endl;
+  out << "}" << std::endl;
+}
+
+//! Write the results as CSV, one line per run.
+static void WriteCSV(std::ostream& out, const std::vector<Result>& results)
+{
+  out << "name,iterations,real_time,time_unit,counters" << std::endl;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const Result& r = results[i];
+    out << RunName(r.name, r.args) << "," << r.iterations << ","
+        << (1e9 * r.seconds / r.iterations) << ",ns,";
+    for (std::map<std::string, double>::const_iterator it =
+        r.counters.begin(); it != r.counters.end(); ++it)
+    {
+      out << (it == r.counters.begin() ? "" : ";") << it->first << "="
+          << it->second;
+    }
+    out << std::endl;
+  }
+}
+
+static void PrintUsage(const char* program)
+{
+  std::cerr << "Usage: " << program << " [options]" << std::endl
+      << "  --filter <text>        Only run benchmarks whose names contain "
+      << "<text>." << std::endl
+      << "  --format <json|csv>    Format of the results (default json)."
+      << std::endl
+      << "  --output <file>        Write the results to <file> instead of "
+      << "stdout." << std::endl
+      << "  --min_time <seconds>   Minimum time of each run (default 0.5)."
+      << std::endl
+      << "  --min_iterations <n>   Minimum iterations of each run (default "
+      << "1)." << std::endl
+      << "  --list                 List the benchmarks and exit." << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  std::string filter, format = "json", output;
+  double minTime = 0.5;
+  size_t minIterations = 1;
+  bool list = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const bool hasValue = (i + 1 < argc);
+    if (arg == "--filter" && hasValue)
+      filter = argv[++i];
+    else if (arg == "--format" && hasValue)
+      format = argv[++i];
+    else if (arg == "--output" && hasValue)
+      output = argv[++i];
+    else if (arg == "--min_time" && hasValue)
+      minTime = std::atof(argv[++i]);
+    else if (arg == "--min_iterations" && hasValue)
+      minIterations = std::atoi(argv[++i]);
+    else if (arg == "--list")
+      list = true;
+    else
+    {
+      PrintUsage(argv[0]);
+      return (arg == "--help") ? 0 : 1;
+    }
+  }
+
+  if (format != "json" && format != "csv")
+  {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  std::vector<Result> results;
+  const std::vector<Benchmark>& benchmarks = Benchmarks();
+  for (size_t b = 0; b < benchmarks.size(); ++b)
+  {
+    for (size_t a = 0; a < benchmarks[b].args.size(); ++a)
+    {
+      const std::string name = RunName(benchmarks[b].name,
+          benchmarks[b].args[a]);
+      if (name.find(filter) == std::string::npos)
+        continue;
+
+      if (list)
+      {
+        std::cout << name << std::endl;
+        continue;
+      }
+
+      // Progress goes to stderr, so that stdout only holds the results.
+      std::cerr << "Running " << name << "..." << std::endl;
+      BenchmarkState state(benchmarks[b].args[a], minTime, minIterations);
+      benchmarks[b].function(state);
+
+      Result result;
+      result.name = benchmarks[b].name;
+      result.args = benchmarks[b].args[a];
+      result.iterations = std::max(state.Iterations(), (size_t) 1);
+      result.seconds = state.Seconds();
+      result.counters = state.Counters();
+      results.push_back(result);
+    }
+  }
+
+  if (list)
+    return 0;
+
+  std::ofstream file;
+  if (!output.empty())
+  {
+    file.open(output.c_str());
+    if (!file.is_open())
+    {
+      std::cerr << "Cannot open " << output << " for writing." << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = output.empty() ? std::cout : file;
+
+  if (format == "json")
+    WriteJSON(out, results);
+  else
+    WriteCSV(out, results);
+
+  return 0;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file decision_tree_benchmark.cpp
+ *
+ * Benchmarks of decision tree training and classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::benchmark;
+
+//! The dataset sizes, dimensions and numbers of classes of the benchmarks.
+#define TREE_SIZES { { 1000, 10, 2 }, { 10000, 10, 2 }, { 10000, 50, 5 }, \
+    { 100000, 10, 2 } }
+
+//! Get labels of the given number of classes, which depend on the first two
+//! dimensions of the points (so that there is something to learn).
+static arma::Row<size_t> Labels(const arma::mat& dataset,
+                                const size_t numClasses)
+{
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = std::min((size_t) (numClasses * 0.5 * (dataset(0, i) +
+        dataset(1, i))), numClasses - 1);
+  }
+  return labels;
+}
+
+//! Train a decision tree on (points, dimensions) random points.
+static void DecisionTreeTrain(BenchmarkState& state)
+{
+  const arma::mat dataset = RandomDataset(state.Arg(0), state.Arg(1));
+  const arma::Row<size_t> labels = Labels(dataset, state.Arg(2));
+  while (state.KeepRunning())
+    DecisionTree<> tree(dataset, labels, state.Arg(2));
+  state.SetCounter("points", state.Arg(0));
+}
+MLPACK_BENCHMARK(DecisionTreeTrain, TREE_SIZES);
+
+//! Classify (points, dimensions) random points with a trained decision tree.
+static void DecisionTreeClassify(BenchmarkState& state)
+{
+  const arma::mat dataset = RandomDataset(state.Arg(0), state.Arg(1));
+  const arma::Row<size_t> labels = Labels(dataset, state.Arg(2));
+  DecisionTree<> tree(dataset, labels, state.Arg(2));
+  arma::Row<size_t> predictions;
+  while (state.KeepRunning())
+    tree.Classify(dataset, predictions);
+  state.SetCounter("points", state.Arg(0));
+}
+MLPACK_BENCHMARK(DecisionTreeClassify, TREE_SIZES);
@@ -0,0 +1,78 @@
+/**
+ * @file io_benchmark.cpp
+ *
+ * Benchmarks of dataset loading and model serialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::benchmark;
+
+//! Load a CSV file of (points, dimensions) random values.
+static void LoadCSV(BenchmarkState& state)
+{
+  const std::string filename = "mlpack_benchmark_load.csv";
+  data::Save(filename, RandomDataset(state.Arg(0), state.Arg(1)), true);
+
+  arma::mat dataset;
+  while (state.KeepRunning())
+    data::Load(filename, dataset, true);
+
+  std::remove(filename.c_str());
+  state.SetCounter("points", state.Arg(0));
+  state.SetCounter("values", state.Arg(0) * state.Arg(1));
+}
+MLPACK_BENCHMARK(LoadCSV, { { 1000, 10 }, { 10000, 10 }, { 10000, 100 },
+    { 100000, 10 } });
+
+//! Get the file extension of the given serialization format: 0 is binary, 1
+//! is XML and 2 is text.
+static std::string Extension(const size_t format)
+{
+  return (format == 0) ? ".bin" : (format == 1) ? ".xml" : ".txt";
+}
+
+//! Serialize a KNN model (with its tree and dataset) built on (points,
+//! dimensions) random points, in the given format (see Extension()).
+static void SaveModel(BenchmarkState& state)
+{
+  const std::string filename = "mlpack_benchmark_save" +
+      Extension(state.Arg(2));
+  KNN knn(RandomDataset(state.Arg(0), state.Arg(1)));
+  while (state.KeepRunning())
+    data::Save(filename, "knn", knn, true);
+
+  std::remove(filename.c_str());
+  state.SetCounter("points", state.Arg(0));
+}
+MLPACK_BENCHMARK(SaveModel, { { 10000, 10, 0 }, { 10000, 10, 1 },
+    { 10000, 10, 2 }, { 100000, 10, 0 } });
+
+//! Deserialize a KNN model (with its tree and dataset) built on (points,
+//! dimensions) random points, in the given format (see Extension()).
+static void LoadModel(BenchmarkState& state)
+{
+  const std::string filename = "mlpack_benchmark_load" +
+      Extension(state.Arg(2));
+  {
+    KNN knn(RandomDataset(state.Arg(0), state.Arg(1)));
+    data::Save(filename, "knn", knn, true);
+  }
+
+  KNN knn;
+  while (state.KeepRunning())
+    data::Load(filename, "knn", knn, true);
+
+  std::remove(filename.c_str());
+  state.SetCounter("points", state.Arg(0));
+}
+MLPACK_BENCHMARK(LoadModel, { { 10000, 10, 0 }, { 10000, 10, 1 },
+    { 10000, 10, 2 }, { 100000, 10, 0 } });
@@ -0,0 +1,57 @@
+/**
+ * @file kmeans_benchmark.cpp
+ *
+ * Benchmarks of the Lloyd iteration types of k-means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/naive_kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kmeans;
+using namespace mlpack::benchmark;
+
+//! The dataset sizes, dimensions and numbers of clusters of the benchmarks.
+#define KMEANS_SIZES { { 10000, 3, 10 }, { 10000, 10, 10 }, \
+    { 10000, 10, 100 }, { 100000, 3, 10 } }
+
+/**
+ * Run 10 iterations of k-means with the given step type on (points,
+ * dimensions) random points, with the given number of clusters.  The initial
+ * centroids are the same for every run.
+ */
+template<template<class, class> class LloydStepType>
+static void KMeansIterations(BenchmarkState& state)
+{
+  const arma::mat dataset = RandomDataset(state.Arg(0), state.Arg(1));
+  const arma::mat initialCentroids = dataset.cols(0, state.Arg(2) - 1);
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, LloydStepType> kmeans(10);
+  arma::mat centroids;
+  while (state.KeepRunning())
+  {
+    centroids = initialCentroids;
+    kmeans.Cluster(dataset, state.Arg(2), centroids, true);
+  }
+  state.SetCounter("points", state.Arg(0));
+}
+MLPACK_BENCHMARK_TEMPLATE(KMeansNaive, KMeansIterations<NaiveKMeans>,
+    KMEANS_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(KMeansElkan, KMeansIterations<ElkanKMeans>,
+    KMEANS_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(KMeansHamerly, KMeansIterations<HamerlyKMeans>,
+    KMEANS_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(KMeansPellegMoore,
+    KMeansIterations<PellegMooreKMeans>, KMEANS_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(KMeansDualTree,
+    KMeansIterations<DefaultDualTreeKMeans>, KMEANS_SIZES);
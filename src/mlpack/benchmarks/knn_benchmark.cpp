@@ -0,0 +1,51 @@
+/**
+ * @file knn_benchmark.cpp
+ *
+ * Benchmarks of tree building and k-nearest-neighbor search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::benchmark;
+
+//! The dataset sizes and dimensions of the search benchmarks.
+#define SEARCH_SIZES { { 1000, 3 }, { 1000, 30 }, { 10000, 3 }, \
+    { 10000, 30 }, { 100000, 3 } }
+
+//! Build a kd-tree on (points, dimensions) random points.
+static void KNNBuildTree(BenchmarkState& state)
+{
+  const arma::mat dataset = RandomDataset(state.Arg(0), state.Arg(1));
+  KNN knn;
+  while (state.KeepRunning())
+    knn.Train(dataset);
+  state.SetCounter("points", state.Arg(0));
+}
+MLPACK_BENCHMARK(KNNBuildTree, SEARCH_SIZES);
+
+//! Find the 5 nearest neighbors of each of (points, dimensions) random points.
+template<NeighborSearchMode Mode>
+static void KNNSearch(BenchmarkState& state)
+{
+  const arma::mat dataset = RandomDataset(state.Arg(0), state.Arg(1));
+  KNN knn(dataset, Mode);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  while (state.KeepRunning())
+    knn.Search(5, neighbors, distances);
+  state.SetCounter("points", state.Arg(0));
+}
+MLPACK_BENCHMARK_TEMPLATE(KNNDualTreeSearch, KNNSearch<DUAL_TREE_MODE>,
+    SEARCH_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(KNNSingleTreeSearch, KNNSearch<SINGLE_TREE_MODE>,
+    SEARCH_SIZES);
+MLPACK_BENCHMARK_TEMPLATE(KNNNaiveSearch, KNNSearch<NAIVE_MODE>,
+    { { 1000, 3 }, { 1000, 30 }, { 10000, 3 } });
@@ -0,0 +1,42 @@
+/**
+ * @file range_search_benchmark.cpp
+ *
+ * Benchmarks of range search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::range;
+using namespace mlpack::benchmark;
+
+/**
+ * Find the neighbors of each of (points, dimensions) random points in the unit
+ * cube within a radius that holds about 10 points on average.
+ */
+template<bool SingleMode>
+static void RangeSearchTree(BenchmarkState& state)
+{
+  const size_t points = state.Arg(0);
+  const size_t dimensions = state.Arg(1);
+  const arma::mat dataset = RandomDataset(points, dimensions);
+
+  // The volume of the ball should be about 10 / points.
+  const double radius = std::pow(10.0 / points, 1.0 / dimensions);
+  RangeSearch<> rs(dataset, false, SingleMode);
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+  while (state.KeepRunning())
+    rs.Search(math::Range(0.0, radius), neighbors, distances);
+  state.SetCounter("points", points);
+}
+MLPACK_BENCHMARK_TEMPLATE(RangeSearchDualTree, RangeSearchTree<false>,
+    { { 1000, 3 }, { 1000, 10 }, { 10000, 3 }, { 10000, 10 } });
+MLPACK_BENCHMARK_TEMPLATE(RangeSearchSingleTree, RangeSearchTree<true>,
+    { { 1000, 3 }, { 1000, 10 }, { 10000, 3 }, { 10000, 10 } });
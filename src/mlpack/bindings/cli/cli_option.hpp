@@ -30,6 +30,7 @@
 #include "get_printable_param_value.hpp"
 #include "get_allocated_memory.hpp"
 #include "delete_allocated_memory.hpp"
+#include "copy_allocated_memory.hpp"
 
 namespace mlpack {
 namespace bindings {
@@ -160,6 +161,8 @@ class CLIOption
         &GetAllocatedMemory<N>;
     CLI::GetSingleton().functionMap[tname]["DeleteAllocatedMemory"] =
         &DeleteAllocatedMemory<N>;
+    CLI::GetSingleton().functionMap[tname]["CopyAllocatedMemory"] =
+        &CopyAllocatedMemory<N>;
   }
 };
 
@@ -0,0 +1,109 @@
+/**
+ * @file copy_allocated_memory.hpp
+ *
+ * Give a parameter a deep copy of the model held by another parameter, so that
+ * --serve can hand every run its own copy of a kept input model.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_COPY_ALLOCATED_MEMORY_HPP
+#define MLPACK_BINDINGS_CLI_COPY_ALLOCATED_MEMORY_HPP
+
+#include <mlpack/core/util/param_data.hpp>
+#include "get_param.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+template<typename T>
+bool CopyAllocatedMemory(
+    util::ParamData& /* d */,
+    util::ParamData& /* source */,
+    const typename boost::disable_if<data::HasSerialize<T>>::type* = 0,
+    const typename boost::disable_if<arma::is_arma_type<T>>::type* = 0)
+{
+  return false;
+}
+
+template<typename T>
+bool CopyAllocatedMemory(
+    util::ParamData& /* d */,
+    util::ParamData& /* source */,
+    const typename boost::enable_if<arma::is_arma_type<T>>::type* = 0)
+{
+  return false;
+}
+
+template<typename T>
+bool CopyAllocatedMemory(
+    util::ParamData& d,
+    util::ParamData& source,
+    const typename boost::disable_if<arma::is_arma_type<T>>::type* = 0,
+    const typename boost::enable_if<data::HasSerialize<T>>::type* = 0)
+{
+  // Only input models that were given can be copied; load the model if that
+  // wasn't done yet.
+  if (!source.input || (!source.loaded && !source.wasPassed))
+    return false;
+  const T& model = *GetParam<T>(source);
+
+  // Not every model can be copy-constructed, but every model can be
+  // serialized.
+  std::ostringstream stream;
+  {
+    boost::archive::binary_oarchive ar(stream);
+    ar << boost::serialization::make_nvp("model", model);
+  }
+
+  T* copy = new T();
+  try
+  {
+    std::istringstream copyStream(stream.str());
+    boost::archive::binary_iarchive ar(copyStream);
+    ar >> boost::serialization::make_nvp("model", *copy);
+  }
+  catch (...)
+  {
+    delete copy;
+    throw;
+  }
+
+  typedef std::tuple<T*, std::string> TupleType;
+  std::get<0>(*boost::any_cast<TupleType>(&d.value)) = copy;
+  d.loaded = true;
+  return true;
+}
+
+/**
+ * If the source parameter is an input model that was given, load it if
+ * needed, and make the given parameter hold a deep copy of the model (the
+ * given parameter should otherwise be a copy of the source parameter).
+ * Nothing is done for other parameters.
+ *
+ * @param d Parameter that receives the copy.
+ * @param input Pointer to the source parameter (a util::ParamData).
+ * @param output Pointer to a bool set to whether a copy was made.
+ */
+template<typename T>
+void CopyAllocatedMemory(const util::ParamData& d,
+                         const void* input,
+                         void* output)
+{
+  *((bool*) output) =
+      CopyAllocatedMemory<typename std::remove_pointer<T>::type>(
+      const_cast<util::ParamData&>(d),
+      *const_cast<util::ParamData*>((const util::ParamData*) input));
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
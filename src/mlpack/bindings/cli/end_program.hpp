@@ -14,16 +14,23 @@
 #define MLPACK_BINDINGS_CLI_END_PROGRAM_HPP
 
 #include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/memory_usage.hpp>
+#include <mlpack/core/util/profiler.hpp>
+#include <mlpack/core/util/work_counters.hpp>
+
+#include <fstream>
+#include <unordered_set>
 
 namespace mlpack {
 namespace bindings {
 namespace cli {
 
 /**
- * Handle command-line program termination.  If --help or --info was passed, we
- * won't make it here, so we don't have to write any contingencies for that.
+ * Finish a run of a command-line program: save or print the output parameters,
+ * and handle --verbose and --work_counters_file.  The memory held by the
+ * parameters is not freed (see FreeAllocatedMemory()).
  */
-inline void EndProgram()
+inline void EndRun()
 {
   // Stop the CLI timers.
   CLI::GetSingleton().timer.StopAllTimers();
@@ -71,13 +78,66 @@ inline void EndProgram()
       Log::Info << "  " << it2.first << ": ";
       CLI::GetSingleton().timer.PrintTimer(it2.first);
     }
+
+    // Scopes instrumented with MLPACK_PROFILE_SCOPE() are printed as a tree.
+    std::ostringstream profile;
+    Profiler::Print(profile);
+    if (!profile.str().empty())
+      Log::Info << "Program profile:" << std::endl << profile.str();
+
+    // The memory used by each timed phase.
+    if (MemoryUsage::Enabled())
+    {
+      std::ostringstream memory;
+      MemoryUsage::Print(memory);
+      Log::Info << "Memory usage:" << std::endl << memory.str();
+    }
+
+    const std::map<std::string, WorkCounts> counts = WorkCounters::GetAll();
+    if (!counts.empty())
+    {
+      Log::Info << "Work counters:" << std::endl;
+      for (auto it2 : counts)
+      {
+        Log::Info << "  " << it2.first << ": "
+            << it2.second.distanceEvaluations << " distance evaluations, "
+            << it2.second.nodeVisits << " node visits, " << it2.second.prunes
+            << " prunes, " << it2.second.cacheHits << " cache hits."
+            << std::endl;
+      }
+    }
+  }
+
+  // Programs that set up their own options may not have this one.
+  if (parameters.count("work_counters_file") &&
+      CLI::HasParam("work_counters_file"))
+  {
+    const std::string filename = CLI::GetParam<std::string>(
+        "work_counters_file");
+    std::ofstream stream(filename.c_str());
+    if (!stream.is_open())
+    {
+      Log::Fatal << "Cannot open file '" << filename << "' to write the work "
+          << "counters." << std::endl;
+    }
+    WorkCounters::WriteJSON(stream);
   }
+}
 
-  // Lastly clean up any memory.  If we are holding any pointers, then we "own"
-  // them.  But we may hold the same pointer twice, so we have to be careful to
-  // not delete it multiple times.
+/**
+ * Free the memory (i.e. the models) held by the parameters.  If we are holding
+ * any pointers, then we "own" them.  But we may hold the same pointer twice, so
+ * we have to be careful to not delete it multiple times.
+ *
+ * @param keep Addresses that must not be freed.
+ */
+inline void FreeAllocatedMemory(
+    const std::unordered_set<void*>& keep = std::unordered_set<void*>())
+{
+  const std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
   std::unordered_map<void*, const util::ParamData*> memoryAddresses;
-  it = parameters.begin();
+  std::map<std::string, util::ParamData>::const_iterator it =
+      parameters.begin();
   while (it != parameters.end())
   {
     const util::ParamData& data = it->second;
@@ -85,7 +145,8 @@ inline void EndProgram()
     void* result;
     CLI::GetSingleton().functionMap[data.tname]["GetAllocatedMemory"](data,
         NULL, (void*) &result);
-    if (result != NULL && memoryAddresses.count(result) == 0)
+    if (result != NULL && memoryAddresses.count(result) == 0 &&
+        keep.count(result) == 0)
       memoryAddresses[result] = &data;
 
     ++it;
@@ -105,6 +166,18 @@ inline void EndProgram()
   }
 }
 
+/**
+ * Handle command-line program termination.  If --help or --info was passed, we
+ * won't make it here, so we don't have to write any contingencies for that.
+ */
+inline void EndProgram()
+{
+  EndRun();
+
+  // Lastly clean up any memory.
+  FreeAllocatedMemory();
+}
+
 } // namespace cli
 } // namespace bindings
 } // namespace mlpack
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "parameter_type.hpp"
+#include "model_cache.hpp"
 
 namespace mlpack {
 namespace bindings {
@@ -112,8 +113,13 @@ T*& GetParam(
   const std::string& value = std::get<1>(*tuple);
   if (d.input && !d.loaded)
   {
+    // Go through the model cache if one is given (see --model_cache_dir).
     T* model = new T();
-    data::Load(value, "model", *model, true);
+    const std::string cacheDir = ModelCacheDir();
+    if (cacheDir.empty())
+      data::Load(value, "model", *model, true);
+    else
+      LoadCachedModel(value, cacheDir, *model);
     d.loaded = true;
     std::get<0>(*tuple) = model;
   }
@@ -0,0 +1,158 @@
+/**
+ * @file model_cache.hpp
+ *
+ * A cache of input models in the binary format, shared by all the runs of the
+ * command-line programs (--model_cache_dir).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_MODEL_CACHE_HPP
+#define MLPACK_BINDINGS_CLI_MODEL_CACHE_HPP
+
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/data/load.hpp>
+#include <mlpack/core/data/save.hpp>
+#include <mlpack/core/data/extension.hpp>
+
+#include <cstdio>
+#include <iomanip>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+  #include <process.h>
+#else
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Get the directory of the model cache given with --model_cache_dir, or an
+ * empty string if there is none (or the program has no such option).
+ */
+inline std::string ModelCacheDir()
+{
+  if (CLI::Parameters().count("model_cache_dir") == 0 ||
+      !CLI::HasParam("model_cache_dir"))
+    return "";
+
+  return CLI::GetParam<std::string>("model_cache_dir");
+}
+
+/**
+ * Get the name of the cached copy of the given model file in the given cache
+ * directory.  The name is a hash of the path of the file, its size and its
+ * modification time, so a cached copy is not used anymore once the file is
+ * changed.  An empty string is returned if the file does not exist.
+ *
+ * @param filename Name of the model file.
+ * @param cacheDir Directory of the cache.
+ */
+inline std::string ModelCachePath(const std::string& filename,
+                                  const std::string& cacheDir)
+{
+  struct stat info;
+  if (stat(filename.c_str(), &info) != 0)
+    return "";
+
+  std::ostringstream key;
+  key << filename << '\n' << (uint64_t) info.st_size << '\n'
+      << (int64_t) info.st_mtime << '\n' << (uint64_t) info.st_ino;
+
+  // 64-bit FNV-1a, so the name does not depend on the standard library.
+  const std::string keyString = key.str();
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < keyString.size(); ++i)
+  {
+    hash ^= (unsigned char) keyString[i];
+    hash *= 1099511628211ULL;
+  }
+
+  std::ostringstream path;
+  path << cacheDir;
+  if (!cacheDir.empty() && cacheDir[cacheDir.size() - 1] != '/')
+    path << '/';
+  path << "model-" << std::hex << std::setw(16) << std::setfill('0') << hash
+      << ".bin";
+  return path.str();
+}
+
+/**
+ * Load the given model, through the given cache directory.  If the cache holds
+ * a copy of the model file (see ModelCachePath()), the copy is loaded instead
+ * of the file.  The copy is in the binary format, which is memory-mapped when
+ * it is loaded, so loading it does not parse any text, and the pages of the
+ * copy are shared by all the processes that load it at the same time.
+ * Otherwise, the model file is loaded and a copy is added to the cache.
+ *
+ * The copy is written to a temporary file that is then renamed, so that
+ * concurrent runs never see a partial copy.  A copy that can't be loaded is
+ * ignored, and the cache is never cleaned up: remove the directory to clear
+ * it.  Only models in the XML and text formats are cached; binary models are
+ * loaded directly.
+ *
+ * Like data::Load() with fatal set to true, Log::Fatal is used if the model
+ * can't be loaded.
+ *
+ * @param filename Name of the model file.
+ * @param cacheDir Directory of the cache; it must exist.
+ * @param model Model to load.
+ */
+template<typename T>
+void LoadCachedModel(const std::string& filename,
+                     const std::string& cacheDir,
+                     T& model)
+{
+  // Only the text formats are worth caching.
+  const std::string extension = data::Extension(filename);
+  const std::string cachePath = ModelCachePath(filename, cacheDir);
+  if (cachePath.empty() || (extension != "xml" && extension != "txt"))
+  {
+    data::Load(filename, "model", model, true);
+    return;
+  }
+
+  struct stat cacheInfo;
+  if (stat(cachePath.c_str(), &cacheInfo) == 0 &&
+      data::Load(cachePath, "model", model, false, data::format::binary))
+  {
+    Log::Info << "Loaded '" << filename << "' from the model cache ('"
+        << cachePath << "')." << std::endl;
+    return;
+  }
+
+  data::Load(filename, "model", model, true);
+
+#ifdef _WIN32
+  const int pid = _getpid();
+#else
+  const int pid = (int) getpid();
+#endif
+  std::ostringstream temporaryPath;
+  temporaryPath << cachePath << "." << pid << ".tmp";
+  const std::string temporary = temporaryPath.str();
+
+  if (data::Save(temporary, "model", model, false, data::format::binary) &&
+      std::rename(temporary.c_str(), cachePath.c_str()) == 0)
+  {
+    Log::Info << "Added '" << filename << "' to the model cache ('"
+        << cachePath << "')." << std::endl;
+  }
+  else
+  {
+    std::remove(temporary.c_str());
+    Log::Warn << "Could not add '" << filename << "' to the model cache in '"
+        << cacheDir << "'." << std::endl;
+  }
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
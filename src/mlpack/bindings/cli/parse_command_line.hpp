@@ -27,6 +27,23 @@ PARAM_STRING_IN("info", "Get help on a specific module or option.", "", "");
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_FLAG("serve", "Keep running and read further runs from standard input, "
+    "one line of options per run, keeping loaded input models in memory.", "");
+PARAM_STRING_IN("model_cache_dir", "If specified, input models in the XML or "
+    "text formats are cached in this directory in the binary format, keyed by "
+    "the path, size and modification time of the model file; later runs load "
+    "the cached copy, which is memory-mapped, instead of parsing the model.",
+    "", "");
+PARAM_STRING_IN("work_counters_file", "If specified, the work done by tree-based "
+    "methods (distance evaluations, node visits, prunes and cache hits) is "
+    "written to this file as JSON.", "", "");
+PARAM_INT_IN("threads", "Number of threads to use for parallel computation (0 "
+    "uses all cores).  If not specified, the OMP_NUM_THREADS environment "
+    "variable is respected.", "", 0);
+PARAM_FLAG("numa", "If specified, the threads are pinned to the cores, spread "
+    "over the sockets, and large matrices are placed on the NUMA nodes of the "
+    "threads that read them.  This helps on machines with several sockets.",
+    "");
 
 /**
  * Parse the command line, setting all of the options inside of the CLI object
@@ -172,8 +189,27 @@ void ParseCommandLine(int argc, char** argv)
   {
     // Give [INFO ] output.
     Log::Info.ignoreInput = false;
+    // Report the memory used by each timed phase.
+    MemoryUsage::Enable();
   }
 
+  // Set the number of threads for the whole process.  Programs that set up
+  // their own options may not have this one.
+  if (parameters.count("threads") && CLI::HasParam("threads"))
+  {
+    const int threads = CLI::GetParam<int>("threads");
+    if (threads < 0)
+    {
+      Log::Fatal << "Invalid number of threads " << threads << " specified "
+          << "with --threads; must be 0 or greater." << std::endl;
+    }
+    Threads::SetCount((size_t) threads);
+  }
+
+  // NUMA awareness must be set before the data is loaded.
+  if (parameters.count("numa") && CLI::HasParam("numa"))
+    Threads::SetNumaAware(true);
+
   // Now, issue an error if we forgot any required options.
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
@@ -185,7 +221,9 @@ void ParseCommandLine(int argc, char** argv)
       CLI::GetSingleton().functionMap[d.tname]["MapParameterName"](d, NULL,
           (void*) &boostName);
 
-      if (!vmap.count(boostName))
+      // With --serve, the options may be given with each run instead.
+      if (!d.wasPassed &&
+          !(parameters.count("serve") && CLI::HasParam("serve")))
       {
         Log::Fatal << "Required option --" << boostName << " is undefined."
             << std::endl;
@@ -0,0 +1,236 @@
+/**
+ * @file serve.hpp
+ *
+ * Serve runs of a command-line program read from standard input, keeping the
+ * loaded models in memory between runs (--serve).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_HPP
+
+#include <mlpack/core/util/cli.hpp>
+#include "parse_command_line.hpp"
+#include "end_program.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Split a request into options.  Options are separated by whitespace; double
+ * quotes can be used to give values that contain whitespace.
+ *
+ * @param line Request to split.
+ */
+inline std::vector<std::string> SplitRequest(const std::string& line)
+{
+  std::vector<std::string> tokens;
+  std::string token;
+  bool quoted = false, inToken = false;
+  for (size_t i = 0; i < line.size(); ++i)
+  {
+    if (line[i] == '"')
+    {
+      quoted = !quoted;
+      inToken = true;
+    }
+    else if (!quoted && std::isspace(line[i]))
+    {
+      if (inToken)
+        tokens.push_back(token);
+      token.clear();
+      inToken = false;
+    }
+    else
+    {
+      token += line[i];
+      inToken = true;
+    }
+  }
+
+  if (quoted)
+    throw std::invalid_argument("unterminated quote in request");
+  if (inToken)
+    tokens.push_back(token);
+
+  return tokens;
+}
+
+/**
+ * Return whether the given request sets the given parameter.
+ *
+ * @param d Parameter.
+ * @param tokens Options of the request.
+ */
+inline bool RequestSetsParam(const util::ParamData& d,
+                             const std::vector<std::string>& tokens)
+{
+  std::string boostName;
+  CLI::GetSingleton().functionMap[d.tname]["MapParameterName"](d, NULL,
+      (void*) &boostName);
+
+  const std::string option = "--" + boostName;
+  const std::string alias = std::string("-") + d.alias;
+  for (size_t i = 0; i < tokens.size(); ++i)
+  {
+    if (tokens[i] == option || tokens[i].compare(0, option.size() + 1,
+        option + "=") == 0 || (d.alias != '\0' && tokens[i] == alias))
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * Serve runs of the program: read requests from the given stream, one line of
+ * options per request, and run the program with the options given on the
+ * command line plus the options of the request.  Input models are loaded once
+ * and kept in memory for the following runs, unless a request gives another
+ * file for them; so a model is loaded once, however many predictions are made
+ * with it.  Every run gets its own deep copy of the kept models, so a program
+ * that modifies its input model (e.g. to train it further) does not change
+ * the model the following runs see.
+ *
+ * After each run, a line "mlpack: ok" or "mlpack: error: <message>" is written
+ * to the output stream, so that a client can tell where the output of each run
+ * ends.  An empty line or the end of the stream ends serving.  Note that
+ * --help, --info and --version make the program exit.
+ *
+ * For example, with model.bin a trained model:
+ *
+ * @code
+ * $ mlpack_knn --input_model_file model.bin --serve
+ * --query_file q1.csv --k 5 --neighbors_file n1.csv
+ * mlpack: ok
+ * --query_file q2.csv --k 5 --neighbors_file n2.csv
+ * mlpack: ok
+ * @endcode
+ *
+ * Each request can hold many points, so a client can batch its predictions
+ * into one file per request.
+ *
+ * @param programName Name of the program, used as argv[0] of the requests.
+ * @param run Function that runs the program (i.e. mlpackMain()).
+ * @param in Stream to read requests from.
+ * @param out Stream to write the end of each run to.
+ */
+inline void Serve(const std::string& programName,
+                  void (*run)(),
+                  std::istream& in = std::cin,
+                  std::ostream& out = std::cout)
+{
+  std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
+
+  // The options given on the command line are the defaults of every request.
+  // The required options may be given with each request instead, so --serve
+  // itself is not a default.
+  std::map<std::string, util::ParamData> defaults = parameters;
+  defaults["serve"].wasPassed = false;
+  defaults["serve"].value = false;
+
+  // The input models that were loaded, as they were loaded; every run gets a
+  // copy of them.
+  std::map<std::string, util::ParamData> kept;
+
+  std::string line;
+  while (std::getline(in, line) && !line.empty())
+  {
+    try
+    {
+      const std::vector<std::string> tokens = SplitRequest(line);
+
+      // Give the run a copy of the kept input models, unless the request gives
+      // another file for them; reset everything else.
+      for (std::map<std::string, util::ParamData>::iterator it =
+          parameters.begin(); it != parameters.end(); ++it)
+      {
+        util::ParamData& d = it->second;
+        std::map<std::string, util::ParamData>::iterator k =
+            kept.find(it->first);
+        if (k == kept.end())
+        {
+          d = defaults[it->first];
+        }
+        else if (RequestSetsParam(k->second, tokens))
+        {
+          CLI::GetSingleton().functionMap[d.tname]["DeleteAllocatedMemory"](
+              k->second, NULL, NULL);
+          kept.erase(k);
+          d = defaults[it->first];
+        }
+        else
+        {
+          bool copied;
+          d = k->second;
+          CLI::GetSingleton().functionMap[d.tname]["CopyAllocatedMemory"](d,
+              (const void*) &k->second, (void*) &copied);
+        }
+      }
+
+      std::vector<char*> argv;
+      argv.push_back(const_cast<char*>(programName.c_str()));
+      for (size_t i = 0; i < tokens.size(); ++i)
+        argv.push_back(const_cast<char*>(tokens[i].c_str()));
+
+      // Only give [INFO ] output if this request asks for it.
+      Log::Info.ignoreInput = true;
+      ParseCommandLine((int) argv.size(), argv.data());
+
+      Timer::ResetAll();
+      Profiler::Reset();
+      WorkCounters::Reset();
+      Timer::Start("total_time");
+
+      // Load the new input models, and keep a copy of them before the run can
+      // modify them.
+      for (std::map<std::string, util::ParamData>::iterator it =
+          parameters.begin(); it != parameters.end(); ++it)
+      {
+        util::ParamData& d = it->second;
+        if (!d.input || kept.count(it->first) > 0)
+          continue;
+
+        bool copied;
+        util::ParamData copy = d;
+        CLI::GetSingleton().functionMap[d.tname]["CopyAllocatedMemory"](copy,
+            (const void*) &d, (void*) &copied);
+        if (copied)
+          kept[it->first] = copy;
+      }
+
+      run();
+      EndRun();
+      out << "mlpack: ok" << std::endl;
+    }
+    catch (std::exception& e)
+    {
+      // A failed run may leave timers running.
+      CLI::GetSingleton().timer.StopAllTimers();
+      out << "mlpack: error: " << e.what() << std::endl;
+    }
+
+    // Free the models of the run; the kept models are not parameters, so they
+    // are not freed.
+    FreeAllocatedMemory();
+    for (std::map<std::string, util::ParamData>::iterator it =
+        parameters.begin(); it != parameters.end(); ++it)
+      it->second = defaults[it->first];
+  }
+
+  for (std::map<std::string, util::ParamData>::iterator it = kept.begin();
+      it != kept.end(); ++it)
+  {
+    CLI::GetSingleton().functionMap[it->second.tname]["DeleteAllocatedMemory"](
+        it->second, NULL, NULL);
+  }
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
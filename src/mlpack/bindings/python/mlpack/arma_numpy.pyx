@@ -12,6 +12,13 @@ object, then the numpy object will "own" the matrix.
 Thus, know that if you convert a matrix type, remember that the resulting type
 is what "owns" the allocated memory.
 
+A numpy array is used in place whenever its memory is C-contiguous (this
+includes one-dimensional arrays and single rows or columns in Fortran order);
+other arrays have to be copied, because Armadillo needs contiguous memory with
+each point stored contiguously.  The Armadillo objects do not use "strict" mode,
+so moving them into a parameter keeps using the numpy memory instead of copying
+it.
+
 mlpack is free software; you may redistribute it and/or modify it under the
 terms of the 3-clause BSD license.  You should have received a copy of the
 3-clause BSD license along with mlpack.  If not, see
@@ -45,7 +52,7 @@ cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
@@ -65,7 +72,7 @@ cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
@@ -124,7 +131,7 @@ cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
@@ -145,7 +152,7 @@ cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
@@ -200,13 +207,13 @@ cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
     takeOwnership = True
 
   cdef arma.Col[double]* m = new arma.Col[double](<double*> X.data, X.shape[0],
-      False, True)
+      False, False)
 
   # Transfer memory ownership, if needed.
   if takeOwnership:
@@ -221,9 +228,10 @@ cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
     # If needed, make a copy where we own the memory.
     X = X.copy(order="C")
+    takeOwnership = True
 
   cdef arma.Col[size_t]* m = new arma.Col[size_t](<size_t*> X.data, X.shape[0],
       False, False)
@@ -50,3 +50,5 @@ cdef extern from "<mlpack/bindings/python/mlpack/cli_util.hpp>" \
   void DisableBacktrace() nogil except +
   void ResetTimers() nogil except +
   void EnableTimers() nogil except +
+  void SetThreads(int) nogil except +
+  void SetNumaAware(bool) nogil except +
@@ -163,6 +163,28 @@ inline void EnableTimers()
   Timer::EnableTiming();
 }
 
+/**
+ * Set the number of threads for the whole process (0 means all cores).
+ */
+inline void SetThreads(const int threads)
+{
+  if (threads < 0)
+  {
+    throw std::invalid_argument("invalid number of threads " +
+        std::to_string(threads) + "; must be 0 or greater");
+  }
+
+  Threads::SetCount((size_t) threads);
+}
+
+/**
+ * Enable or disable NUMA awareness for the whole process.
+ */
+inline void SetNumaAware(const bool numaAware)
+{
+  Threads::SetNumaAware(numaAware);
+}
+
 } // namespace util
 } // namespace mlpack
 
@@ -0,0 +1,18 @@
+#!/usr/bin/env python
+"""
+program_lock.py: lock shared by all mlpack bindings.
+
+Every mlpack program keeps its parameters in the same global CLI object, so only
+one program can run at a time.  Each binding holds this lock while it sets its
+parameters, runs, and collects its results.  The GIL is released while the
+program itself runs, so other Python threads keep running meanwhile; a thread
+that waits for the lock does not hold the GIL either.
+
+mlpack is free software; you may redistribute it and/or modify it under the
+terms of the 3-clause BSD license.  You should have received a copy of the
+3-clause BSD license along with mlpack.  If not, see
+http://www.opensource.org/licenses/BSD-3-Clause for more information.
+"""
+import threading
+
+program_lock = threading.Lock()
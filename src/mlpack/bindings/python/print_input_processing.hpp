@@ -80,6 +80,14 @@ void PrintInputProcessing(
     // If this parameter is "verbose", then enable verbose output.
     if (d.name == "verbose")
       std::cout << prefix << "  EnableVerbose()" << std::endl;
+
+    // If this parameter is "threads", then set the number of threads.
+    if (d.name == "threads")
+      std::cout << prefix << "  SetThreads(" << name << ")" << std::endl;
+
+    // If this parameter is "numa", then enable NUMA awareness.
+    if (d.name == "numa")
+      std::cout << prefix << "  SetNumaAware(" << name << ")" << std::endl;
   }
   else
   {
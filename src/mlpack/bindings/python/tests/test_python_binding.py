@@ -13,6 +13,7 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -538,6 +539,109 @@ class TestPythonBinding(unittest.TestCase):
     for j in range(10):
       self.assertEqual(output['matrix_and_info_out'][j, 4], x[cols[4]][j])
 
+  def testNumpyFortranMatrix(self):
+    """
+    A matrix in Fortran order should give the same results as in C order.
+    """
+    x = np.random.rand(100, 5)
+    z = np.asfortranarray(x)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 matrix_in=z)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(x[j, i], output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
+
+  def testMatrixAndInfoFortranNumpy(self):
+    """
+    A matrix with info in Fortran order should give the same results as in C
+    order.
+    """
+    x = np.random.rand(100, 10)
+    z = np.asfortranarray(x)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 matrix_and_info_in=z)
+
+    self.assertEqual(output['matrix_and_info_out'].shape[0], 100)
+    self.assertEqual(output['matrix_and_info_out'].shape[1], 10)
+
+    for i in range(10):
+      for j in range(100):
+        self.assertEqual(output['matrix_and_info_out'][j, i], x[j, i] * 2.0)
+
+  def testColView(self):
+    """
+    A strided view of a matrix can be passed as a column vector.
+    """
+    x = np.random.rand(100, 3)
+    z = x[:, 1]
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 col_in=z)
+
+    self.assertEqual(output['col_out'].shape[0], 100)
+    for i in range(100):
+      self.assertEqual(output['col_out'][i], x[i, 1] * 2)
+
+  def testThreads(self):
+    """
+    Bindings called from several threads at once should all give the right
+    results; half of them pass the flag, so mixed-up parameters would show.
+    """
+    inputs = [np.random.rand(100, 5) for i in range(8)]
+    outputs = [None] * len(inputs)
+
+    def run(i):
+      outputs[i] = test_python_binding(string_in='hello',
+                                       int_in=12,
+                                       double_in=4.0,
+                                       matrix_in=copy.copy(inputs[i]),
+                                       flag1=(i % 2 == 0))
+
+    threads = [threading.Thread(target=run, args=(i,))
+        for i in range(len(inputs))]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    for i in range(len(inputs)):
+      if i % 2 == 0:
+        self.assertEqual(outputs[i]['string_out'], 'hello2')
+      else:
+        self.assertNotEqual(outputs[i]['string_out'], 'hello2')
+      self.assertEqual(outputs[i]['matrix_out'].shape[0], 100)
+      self.assertEqual(outputs[i]['matrix_out'].shape[1], 4)
+      for j in range(100):
+        self.assertEqual(2 * inputs[i][j, 2], outputs[i]['matrix_out'][j, 2])
+
+  def testThreadsOption(self):
+    """
+    The number of threads can be given, and does not change the results.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 flag1=True,
+                                 threads=2)
+
+    self.assertEqual(output['string_out'], 'hello2')
+    self.assertEqual(output['int_out'], 13)
+    self.assertEqual(output['double_out'], 5.0)
+
   def testIntVector(self):
     """
     Test that we can pass a vector of ints and get back that same vector but
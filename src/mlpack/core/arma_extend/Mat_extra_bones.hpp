@@ -12,6 +12,14 @@
 template<typename Archive>
 void serialize(Archive& ar, const unsigned int version);
 
+/**
+ * Access the matrix that serialize() saves as an empty matrix in the calling
+ * thread (NULL if there is none).  This lets a large matrix that is referenced
+ * by a serialized object be written out of band, without copying or modifying
+ * it.
+ */
+inline static const Mat<eT>*& SerializeAsEmpty();
+
 /**
  * These will help us refer the proper vector / column types, only with
  * specifying the matrix type we want to use.
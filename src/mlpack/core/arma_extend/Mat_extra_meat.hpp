@@ -16,6 +16,20 @@ void Mat<eT>::serialize(Archive& ar, const unsigned int /* version */)
   using boost::serialization::make_nvp;
   using boost::serialization::make_array;
 
+  // A matrix that is written out of band is saved as an empty matrix.
+  if (Archive::is_saving::value && this == SerializeAsEmpty())
+  {
+    uword emptyRows = (vec_state == 2) ? 1 : 0;
+    uword emptyCols = (vec_state == 1) ? 1 : 0;
+    uword emptyElem = 0;
+    uhword emptyVecState = vec_state;
+    ar & make_nvp("n_rows", emptyRows);
+    ar & make_nvp("n_cols", emptyCols);
+    ar & make_nvp("n_elem", emptyElem);
+    ar & make_nvp("vec_state", emptyVecState);
+    return;
+  }
+
   const uword old_n_elem = n_elem;
 
   // This is accurate from Armadillo 3.6.0 onwards.
@@ -41,4 +55,11 @@ void Mat<eT>::serialize(Archive& ar, const unsigned int /* version */)
   }
 
   ar & make_array(access::rwp(mem), n_elem);
-}
\ No newline at end of file
+}
+
+template<typename eT>
+inline const Mat<eT>*& Mat<eT>::SerializeAsEmpty()
+{
+  static thread_local const Mat<eT>* matrix = NULL;
+  return matrix;
+}
@@ -79,6 +79,19 @@ class CVBase
   static void AssertWeightsConsistency(const MatType& xs,
                                        const WeightsType& weights);
 
+  /**
+   * Get the indices, in increasing order, of a random subset of the given size
+   * of n points.  The subset only depends on the seed, and the subset of some
+   * size contains the subsets of smaller sizes drawn with the same seed.
+   *
+   * @param n Number of points to draw from.
+   * @param size Number of points to draw.
+   * @param seed Seed of the random subset.
+   */
+  static arma::uvec RandomSubset(const size_t n,
+                                 const size_t size,
+                                 const size_t seed);
+
   /**
    * Train MLAlgorithm with given data points, predictions, and hyperparameters
    * depending on what CVBase constructor has been called.
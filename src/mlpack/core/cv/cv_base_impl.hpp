@@ -137,6 +137,31 @@ void CVBase<MLAlgorithm,
   }
 }
 
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+arma::uvec CVBase<MLAlgorithm,
+                  MatType,
+                  PredictionsType,
+                  WeightsType>::RandomSubset(const size_t n,
+                                             const size_t size,
+                                             const size_t seed)
+{
+  // A partial Fisher-Yates shuffle with its own generator: the first 'size'
+  // swaps don't depend on 'size', so the subsets are nested, and concurrent
+  // evaluations don't share the global generator.
+  std::mt19937 generator(seed);
+  arma::uvec order = arma::regspace<arma::uvec>(0, n - 1);
+  for (size_t i = 0; i < size; ++i)
+  {
+    const size_t j = i + generator() % (n - i);
+    std::swap(order[i], order[j]);
+  }
+
+  return arma::sort(order.head(size));
+}
+
 template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
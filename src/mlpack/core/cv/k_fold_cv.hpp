@@ -44,6 +44,11 @@ namespace cv {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * The folds are trained and evaluated in parallel (see Threads); the training
+ * and validation subsets are aliases of the data stored by the object, so no
+ * fold copies any data.  The models are trained concurrently, so MLAlgorithm
+ * must not share mutable state between instances.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -180,6 +185,21 @@ class KFoldCV
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get the fraction of each training set that Evaluate() trains on.
+  double TrainingFraction() const { return trainingFraction; }
+  /**
+   * Modify the fraction (in (0, 1]) of each training set that Evaluate()
+   * trains on; a random subset of each training set, fixed by SubsetSeed(), is
+   * used.  Training on a fraction of the data is a cheap way to compare
+   * hyper-parameters (see SuccessiveHalving).
+   */
+  double& TrainingFraction() { return trainingFraction; }
+
+  //! Get the seed of the random subsets that Evaluate() trains on.
+  size_t SubsetSeed() const { return subsetSeed; }
+  //! Modify the seed of the random subsets that Evaluate() trains on.
+  size_t& SubsetSeed() { return subsetSeed; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -209,6 +229,12 @@ class KFoldCV
   //! The number of bins in the dataset.
   const size_t k;
 
+  //! The fraction of each training set to train on.
+  double trainingFraction;
+
+  //! The seed of the random subsets of the training sets to train on.
+  size_t subsetSeed;
+
   //! The extended (by repeating the first k - 2 bins) data points.
   MatType xs;
   //! The extended (by repeating the first k - 2 bins) predictions.
@@ -278,6 +304,16 @@ class KFoldCV
    */
   inline size_t ValidationSubsetFirstCol(const size_t i);
 
+  /**
+   * Calculate the number of points of the ith training subset.
+   */
+  inline size_t TrainingSetSize(const size_t i);
+
+  /**
+   * Calculate the number of points of the ith training subset to train on.
+   */
+  inline size_t TrainingSubsetSize(const size_t i);
+
   /**
    * Get the ith training subset from a variable of a matrix type.
    */
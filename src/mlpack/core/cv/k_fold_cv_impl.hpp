@@ -135,7 +135,9 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    trainingFraction(1.0),
+    subsetSeed((size_t) math::RandInt(std::numeric_limits<int>::max()))
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -166,7 +168,9 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    trainingFraction(1.0),
+    subsetSeed((size_t) math::RandInt(std::numeric_limits<int>::max()))
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -191,6 +195,10 @@ double KFoldCV<MLAlgorithm,
                PredictionsType,
                WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
+  if (trainingFraction <= 0.0 || trainingFraction > 1.0)
+    throw std::invalid_argument("KFoldCV: the training fraction should be "
+        "more than 0 and not more than 1");
+
   return TrainAndEvaluate(args...);
 }
 
@@ -246,15 +254,22 @@ double KFoldCV<MLAlgorithm,
 {
   arma::vec evaluations(k);
 
-  for (size_t i = 0; i < k; ++i)
+  // The folds are independent, so they are trained in parallel.  Each one
+  // only reads aliases of the stored data.
+  Threads::ParallelFor(0, k, [&](const size_t i)
   {
     MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
         GetTrainingSubset(ys, i), args...);
     evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
         GetValidationSubset(ys, i));
+    // Several sets of hyper-parameters may be evaluated at once, so the last
+    // model is replaced in a critical section.
     if (i == k - 1)
+    {
+      #pragma omp critical(mlpack_k_fold_cv_model)
       modelPtr.reset(new MLAlgorithm(std::move(model)));
-  }
+    }
+  });
 
   return arma::mean(evaluations);
 }
@@ -273,7 +288,9 @@ double KFoldCV<MLAlgorithm,
 {
   arma::vec evaluations(k);
 
-  for (size_t i = 0; i < k; ++i)
+  // The folds are independent, so they are trained in parallel.  Each one
+  // only reads aliases of the stored data.
+  Threads::ParallelFor(0, k, [&](const size_t i)
   {
     MLAlgorithm&& model = (weights.n_elem > 0) ?
         base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
@@ -282,9 +299,14 @@ double KFoldCV<MLAlgorithm,
             args...);
     evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
         GetValidationSubset(ys, i));
+    // Several sets of hyper-parameters may be evaluated at once, so the last
+    // model is replaced in a critical section.
     if (i == k - 1)
+    {
+      #pragma omp critical(mlpack_k_fold_cv_model)
       modelPtr.reset(new MLAlgorithm(std::move(model)));
-  }
+    }
+  });
 
   return arma::mean(evaluations);
 }
@@ -341,6 +363,39 @@ void KFoldCV<MLAlgorithm,
     InitKFoldCVMat(weightsOrig, weights);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::TrainingSetSize(const size_t i)
+{
+  // If this is not the first fold, we have to handle it a little bit
+  // differently, since the last fold may contain slightly more than 'binSize'
+  // points.
+  return (i != 0) ? lastBinSize + (k - 2) * binSize : (k - 1) * binSize;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::TrainingSubsetSize(const size_t i)
+{
+  // Only a part of the training subset may be used.
+  return std::max((size_t) 1, (size_t) round(TrainingSetSize(i) *
+      trainingFraction));
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -370,14 +425,13 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
     arma::Mat<ElementType>& m,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
+  const size_t setSize = TrainingSetSize(i);
+  const size_t size = TrainingSubsetSize(i);
+  if (size == setSize)
+    return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, size, false,
+        true);
 
-  return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, subsetSize,
-      false, true);
+  return m.cols(binSize * i + Base::RandomSubset(setSize, size, subsetSeed));
 }
 
 template<typename MLAlgorithm,
@@ -394,13 +448,13 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
     arma::Row<ElementType>& r,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
+  const size_t setSize = TrainingSetSize(i);
+  const size_t size = TrainingSubsetSize(i);
+  if (size == setSize)
+    return arma::Row<ElementType>(r.colptr(binSize * i), size, false, true);
 
-  return arma::Row<ElementType>(r.colptr(binSize * i), subsetSize, false, true);
+  return arma::Row<ElementType>(r.cols(binSize * i +
+      Base::RandomSubset(setSize, size, subsetSeed)));
 }
 
 template<typename MLAlgorithm,
@@ -211,6 +211,21 @@ class SimpleCV
   //! Access and modify the last trained model.
   MLAlgorithm& Model();
 
+  //! Get the fraction of each training set that Evaluate() trains on.
+  double TrainingFraction() const { return trainingFraction; }
+  /**
+   * Modify the fraction (in (0, 1]) of each training set that Evaluate()
+   * trains on; a random subset of the training set, fixed by SubsetSeed(), is
+   * used.  Training on a fraction of the data is a cheap way to compare
+   * hyper-parameters (see SuccessiveHalving).
+   */
+  double& TrainingFraction() { return trainingFraction; }
+
+  //! Get the seed of the random subset that Evaluate() trains on.
+  size_t SubsetSeed() const { return subsetSeed; }
+  //! Modify the seed of the random subset that Evaluate() trains on.
+  size_t& SubsetSeed() { return subsetSeed; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -240,6 +255,12 @@ class SimpleCV
   //! The pointer to the last trained model.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! The fraction of the training set to train on.
+  double trainingFraction;
+
+  //! The seed of the random subset of the training set to train on.
+  size_t subsetSeed;
+
   /**
    * Assert data consistency and initialize fields required for running
    * cross-validation.
@@ -269,6 +290,12 @@ class SimpleCV
    */
   size_t CalculateAndAssertNumberOfTrainingPoints(const double validationSize);
 
+  /**
+   * Calculate the number of training points to train on, and assert the
+   * training fraction is legitimate.
+   */
+  size_t TrainingSubsetSize() const;
+
   /**
    * Get the specified submatrix without coping the data.
    */
@@ -285,6 +312,20 @@ class SimpleCV
                                    const size_t firstCol,
                                    const size_t lastCol);
 
+  /**
+   * Get the part of the training matrix to train on.  The data is only copied
+   * if the training fraction is less than 1.
+   */
+  template<typename ElementType>
+  arma::Mat<ElementType> GetTrainingSubset(arma::Mat<ElementType>& m);
+
+  /**
+   * Get the part of the training row to train on.  The data is only copied if
+   * the training fraction is less than 1.
+   */
+  template<typename ElementType>
+  arma::Row<ElementType> GetTrainingSubset(arma::Row<ElementType>& r);
+
   /**
    * Train and run evaluation in the case of non-weighted learning.
    */
@@ -143,7 +143,9 @@ SimpleCV<MLAlgorithm,
                                 PIT&& ys) :
     base(std::move(base)),
     xs(std::forward<MIT>(xs)),
-    ys(std::forward<PIT>(ys))
+    ys(std::forward<PIT>(ys)),
+    trainingFraction(1.0),
+    subsetSeed((size_t) math::RandInt(std::numeric_limits<int>::max()))
 {
   Base::AssertDataConsistency(this->xs, this->ys);
 
@@ -243,6 +245,25 @@ size_t SimpleCV<MLAlgorithm,
   return trainingPoints;
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t SimpleCV<MLAlgorithm,
+                Metric,
+                MatType,
+                PredictionsType,
+                WeightsType>::TrainingSubsetSize() const
+{
+  if (trainingFraction <= 0.0 || trainingFraction > 1.0)
+    throw std::invalid_argument("SimpleCV: the training fraction should be "
+        "more than 0 and not more than 1");
+
+  return std::max((size_t) 1, (size_t) round(trainingXs.n_cols *
+      trainingFraction));
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -281,6 +302,47 @@ arma::Row<ElementType> SimpleCV<MLAlgorithm,
       false, true);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename ElementType>
+arma::Mat<ElementType> SimpleCV<MLAlgorithm,
+                                Metric,
+                                MatType,
+                                PredictionsType,
+                                WeightsType>::GetTrainingSubset(
+    arma::Mat<ElementType>& m)
+{
+  const size_t size = TrainingSubsetSize();
+  if (size == m.n_cols)
+    return GetSubset(m, 0, m.n_cols - 1);
+
+  return m.cols(Base::RandomSubset(m.n_cols, size, subsetSeed));
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename ElementType>
+arma::Row<ElementType> SimpleCV<MLAlgorithm,
+                                Metric,
+                                MatType,
+                                PredictionsType,
+                                WeightsType>::GetTrainingSubset(
+    arma::Row<ElementType>& r)
+{
+  const size_t size = TrainingSubsetSize();
+  if (size == r.n_cols)
+    return GetSubset(r, 0, r.n_cols - 1);
+
+  return arma::Row<ElementType>(r.cols(Base::RandomSubset(r.n_cols, size,
+      subsetSeed)));
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -293,9 +355,18 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
-  modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  std::unique_ptr<MLAlgorithm> model(new MLAlgorithm(base.Train(
+      GetTrainingSubset(trainingXs),
+      GetTrainingSubset(trainingYs), args...)));
+  const double objective = Metric::Evaluate(*model, validationXs,
+      validationYs);
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  // Several sets of hyper-parameters may be evaluated at once, so the last
+  // model is replaced in a critical section.
+  #pragma omp critical(mlpack_simple_cv_model)
+  modelPtr = std::move(model);
+
+  return objective;
 }
 
 template<typename MLAlgorithm,
@@ -310,14 +381,25 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
+  std::unique_ptr<MLAlgorithm> model;
   if (trainingWeights.n_elem > 0)
-    modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, trainingWeights, args...)));
+    model.reset(new MLAlgorithm(base.Train(
+        GetTrainingSubset(trainingXs),
+        GetTrainingSubset(trainingYs),
+        GetTrainingSubset(trainingWeights), args...)));
   else
-    modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, args...)));
+    model.reset(new MLAlgorithm(base.Train(
+        GetTrainingSubset(trainingXs),
+        GetTrainingSubset(trainingYs), args...)));
+  const double objective = Metric::Evaluate(*model, validationXs,
+      validationYs);
+
+  // Several sets of hyper-parameters may be evaluated at once, so the last
+  // model is replaced in a critical section.
+  #pragma omp critical(mlpack_simple_cv_model)
+  modelPtr = std::move(model);
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return objective;
 }
 
 } // namespace cv
@@ -0,0 +1,166 @@
+/**
+ * @file chunked_reader.hpp
+ *
+ * A reader that returns the points of a dataset stored in a file in chunks, so
+ * that datasets larger than memory can be used with incremental algorithms.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_READER_HPP
+#define MLPACK_CORE_DATA_CHUNKED_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <fstream>
+
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Read a dataset from a file in chunks of at most a given number of points.
+ * Like data::Load(), each point is a column of the returned chunks.  CSV, TSV
+ * and text files, ARFF files, Armadillo binary files and (if Armadillo was
+ * built with HDF5 support) HDF5 files are supported; the format is chosen by
+ * the extension of the file.
+ *
+ * The same DatasetInfo is used for every chunk, so the mappings of
+ * categorical values are consistent across chunks and across passes.  For
+ * CSV, TSV and text files, the constructor takes a first pass over the file to
+ * find out which dimensions are categorical, like data::Load() does; for ARFF
+ * files the types come from the header, and binary formats are numeric.
+ *
+ * The reader can be used directly with the algorithms that train
+ * incrementally.  For instance, with the labels in the last dimension:
+ *
+ * @code
+ * data::ChunkedReader<> reader("dataset.csv", 10000);
+ * NaiveBayesClassifier<> nbc(reader.Dimensionality() - 1, numClasses);
+ * arma::mat chunk;
+ * while (reader.NextChunk(chunk))
+ * {
+ *   const arma::mat points = chunk.rows(0, chunk.n_rows - 2);
+ *   const arma::Row<size_t> labels =
+ *       arma::conv_to<arma::Row<size_t>>::from(chunk.row(chunk.n_rows - 1));
+ *   nbc.Train(points, labels, numClasses, true);
+ * }
+ * @endcode
+ *
+ * HoeffdingTree::Train() (with batchTraining = false),
+ * MiniBatchKMeans::Update() and GMM::Train() with gmm::OnlineEMFit can be fed
+ * the same way, and since the reader provides Reset() and NextChunk(), it is
+ * also a chunk source for det::HistogramTrainer().
+ *
+ * @tparam eT Element type of the chunks.
+ */
+template<typename eT = double>
+class ChunkedReader
+{
+ public:
+  /**
+   * Open the given file.  For CSV, TSV and text files, this reads the whole
+   * file once to build the DatasetInfo.  A std::runtime_error is thrown if the
+   * file can't be opened or its format isn't supported.
+   *
+   * @param filename Name of the file to read.
+   * @param chunkSize Maximum number of points in each chunk.
+   */
+  ChunkedReader(const std::string& filename, const size_t chunkSize = 65536);
+
+  //! Close the file.
+  ~ChunkedReader();
+
+  //! Restart from the first point of the file.
+  void Reset();
+
+  /**
+   * Read the next chunk of points into the given matrix, with one point per
+   * column.  A std::runtime_error is thrown on parse errors.
+   *
+   * @param chunk Matrix to store the chunk in.
+   * @return false if there are no more points.
+   */
+  bool NextChunk(arma::Mat<eT>& chunk);
+
+  //! Get the DatasetInfo shared by all chunks.
+  const DatasetInfo& Info() const { return info; }
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the maximum number of points in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+  //! Modify the maximum number of points in each chunk.
+  size_t& ChunkSize() { return chunkSize; }
+
+ private:
+  // A reader can't be copied.
+  ChunkedReader(const ChunkedReader& other);
+  ChunkedReader& operator=(const ChunkedReader& other);
+
+  //! The formats that can be read.
+  enum FileType
+  {
+    text,
+    arff,
+    armaBinary,
+    hdf5
+  };
+
+  //! Read the next chunk of a CSV, TSV or text file.
+  size_t NextTextChunk(arma::Mat<eT>& chunk);
+  //! Read the next chunk of an ARFF file.
+  size_t NextARFFChunk(arma::Mat<eT>& chunk);
+  //! Read the next chunk of an Armadillo binary file.
+  size_t NextBinaryChunk(arma::Mat<eT>& chunk);
+  //! Read the next chunk of an HDF5 file.
+  size_t NextHDF5Chunk(arma::Mat<eT>& chunk);
+
+  //! The name of the file.
+  std::string filename;
+  //! The format of the file.
+  FileType type;
+  //! The maximum number of points in each chunk.
+  size_t chunkSize;
+  //! The DatasetInfo shared by all chunks.
+  DatasetInfo info;
+  //! The dimensionality of the points.
+  size_t dimensionality;
+  //! The number of points in the file (only known for binary formats).
+  size_t points;
+  //! The number of points returned since the last reset.
+  size_t position;
+
+  //! The stream for all formats but HDF5.
+  std::ifstream stream;
+  //! The position of the first point in the stream.
+  std::streampos dataStart;
+  //! The number of lines before the first point, for text formats.
+  size_t dataLine;
+  //! The number of lines read, for text formats.
+  size_t lineNumber;
+  //! The separator of a CSV, TSV or text file.
+  char separator;
+  //! The element type code of an Armadillo binary file (e.g. "FN008").
+  std::string elemType;
+  //! Buffer for reading binary data.
+  std::vector<char> buffer;
+
+#ifdef ARMA_USE_HDF5
+  //! The HDF5 file.
+  hid_t file;
+  //! The HDF5 dataset with the points.
+  hid_t dataset;
+#endif
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "chunked_reader_impl.hpp"
+
+#endif
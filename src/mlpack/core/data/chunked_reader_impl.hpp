@@ -0,0 +1,416 @@
+/**
+ * @file chunked_reader_impl.hpp
+ *
+ * Implementation of the ChunkedReader class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_READER_IMPL_HPP
+#define MLPACK_CORE_DATA_CHUNKED_READER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "chunked_reader.hpp"
+
+#include <boost/algorithm/string/trim.hpp>
+
+#include "extension.hpp"
+#include "load_arff.hpp"
+#include "load_csv.hpp"
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+/**
+ * Read one row of a chunk from an Armadillo binary file, whose elements have
+ * type SrcType.
+ */
+template<typename SrcType, typename eT>
+void ReadBinaryRow(std::ifstream& stream,
+                   std::vector<char>& buffer,
+                   arma::Mat<eT>& chunk,
+                   const size_t row)
+{
+  buffer.resize(chunk.n_cols * sizeof(SrcType));
+  if (!stream.read(buffer.data(), buffer.size()))
+    throw std::runtime_error("ChunkedReader::NextChunk(): unexpected end of "
+        "binary data");
+
+  const SrcType* values = (const SrcType*) buffer.data();
+  for (size_t i = 0; i < chunk.n_cols; ++i)
+    chunk(row, i) = eT(values[i]);
+}
+
+#ifdef ARMA_USE_HDF5
+
+//! Get the HDF5 memory type of the given element type.
+inline hid_t HDF5Type(float) { return H5T_NATIVE_FLOAT; }
+inline hid_t HDF5Type(double) { return H5T_NATIVE_DOUBLE; }
+inline hid_t HDF5Type(int) { return H5T_NATIVE_INT; }
+inline hid_t HDF5Type(unsigned int) { return H5T_NATIVE_UINT; }
+inline hid_t HDF5Type(long) { return H5T_NATIVE_LONG; }
+inline hid_t HDF5Type(unsigned long) { return H5T_NATIVE_ULONG; }
+inline hid_t HDF5Type(long long) { return H5T_NATIVE_LLONG; }
+inline hid_t HDF5Type(unsigned long long) { return H5T_NATIVE_ULLONG; }
+
+#endif
+
+} // namespace details
+
+template<typename eT>
+ChunkedReader<eT>::ChunkedReader(const std::string& filename,
+                                 const size_t chunkSize) :
+    filename(filename),
+    type(text),
+    chunkSize(chunkSize),
+    dimensionality(0),
+    points(0),
+    position(0),
+    dataLine(0),
+    lineNumber(0),
+    separator(',')
+#ifdef ARMA_USE_HDF5
+    , file(-1),
+    dataset(-1)
+#endif
+{
+  if (chunkSize == 0)
+    throw std::invalid_argument("ChunkedReader: chunk size must be positive");
+
+  const std::string extension = Extension(filename);
+  if (extension == "h5" || extension == "hdf5" || extension == "hdf" ||
+      extension == "he5")
+  {
+#ifdef ARMA_USE_HDF5
+    type = hdf5;
+    file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0)
+      throw std::runtime_error("cannot open file '" + filename + "'");
+
+    // Armadillo stores matrices under this name, with the dimensions in the
+    // opposite order.  Since data::Save() transposes, the first dimension of
+    // the dataset is the dimensionality of the points.
+    dataset = H5Dopen2(file, "dataset", H5P_DEFAULT);
+    if (dataset < 0)
+    {
+      H5Fclose(file);
+      throw std::runtime_error("no dataset found in '" + filename + "'");
+    }
+
+    const hid_t space = H5Dget_space(dataset);
+    hsize_t dims[2];
+    const int rank = H5Sget_simple_extent_ndims(space);
+    if (rank == 2)
+      H5Sget_simple_extent_dims(space, dims, NULL);
+    H5Sclose(space);
+    if (rank != 2)
+    {
+      H5Dclose(dataset);
+      H5Fclose(file);
+      throw std::runtime_error("dataset in '" + filename + "' is not a "
+          "matrix");
+    }
+
+    dimensionality = dims[0];
+    points = dims[1];
+    info = DatasetInfo(dimensionality);
+    return;
+#else
+    throw std::runtime_error("cannot read '" + filename + "': Armadillo was "
+        "compiled without HDF5 support");
+#endif
+  }
+
+  stream.open(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("cannot open file '" + filename + "'");
+
+  if (extension == "csv" || extension == "tsv" || extension == "txt")
+  {
+    type = text;
+    separator = (extension == "csv") ? ',' : ((extension == "txt") ? ' ' :
+        '\t');
+
+    // Take a first pass through the file, to find the dimensionality and to
+    // let the DatasetInfo see every token (so that it can find the
+    // categorical dimensions) before anything is mapped.
+    std::string line, token;
+    bool firstLine = true;
+    while (std::getline(stream, line))
+    {
+      const char* begin = line.c_str();
+      const char* end = begin + line.size();
+      details::TrimRange(begin, end);
+
+      if (firstLine)
+      {
+        dimensionality = details::SplitLine(begin, end, separator,
+            [](const size_t, const char*, const char*) { });
+        info = DatasetInfo(dimensionality);
+        firstLine = false;
+      }
+
+      details::SplitLine(begin, end, separator,
+          [&](const size_t dim, const char* tokenBegin, const char* tokenEnd)
+          {
+            if (dim >= dimensionality)
+              return;
+
+            token.assign(tokenBegin, tokenEnd);
+            info.template MapFirstPass<eT>(token, dim);
+          });
+    }
+
+    stream.clear();
+    dataStart = 0;
+  }
+  else if (extension == "arff")
+  {
+    type = arff;
+    dimensionality = details::ReadARFFHeader(stream, dataLine, info);
+    dataStart = stream.tellg();
+  }
+  else if (extension == "bin")
+  {
+    type = armaBinary;
+
+    // The header is the element type, followed by the size of the matrix.
+    std::string header;
+    size_t rows, cols;
+    stream >> header >> rows >> cols;
+    stream.get();
+
+    const std::string prefix = "ARMA_MAT_BIN_";
+    if (!stream.good() || header.compare(0, prefix.size(), prefix) != 0)
+    {
+      throw std::runtime_error("'" + filename + "' is not an Armadillo binary "
+          "file");
+    }
+
+    elemType = header.substr(prefix.size());
+    if (elemType != "IU001" && elemType != "IS001" && elemType != "IU002" &&
+        elemType != "IS002" && elemType != "IU004" && elemType != "IS004" &&
+        elemType != "IU008" && elemType != "IS008" && elemType != "FN004" &&
+        elemType != "FN008")
+    {
+      throw std::runtime_error("unsupported element type in '" + filename +
+          "'");
+    }
+
+    // data::Save() transposes, so the rows of the stored matrix are points.
+    points = rows;
+    dimensionality = cols;
+    info = DatasetInfo(dimensionality);
+    dataStart = stream.tellg();
+  }
+  else
+  {
+    throw std::runtime_error("unable to detect type of '" + filename + "'; "
+        "incorrect extension?");
+  }
+
+  Reset();
+}
+
+template<typename eT>
+ChunkedReader<eT>::~ChunkedReader()
+{
+#ifdef ARMA_USE_HDF5
+  if (dataset >= 0)
+    H5Dclose(dataset);
+  if (file >= 0)
+    H5Fclose(file);
+#endif
+}
+
+template<typename eT>
+void ChunkedReader<eT>::Reset()
+{
+  position = 0;
+  lineNumber = dataLine;
+  if (type != hdf5)
+  {
+    stream.clear();
+    stream.seekg(dataStart);
+  }
+}
+
+template<typename eT>
+bool ChunkedReader<eT>::NextChunk(arma::Mat<eT>& chunk)
+{
+  size_t chunkPoints = 0;
+  switch (type)
+  {
+    case text:
+      chunkPoints = NextTextChunk(chunk);
+      break;
+    case arff:
+      chunkPoints = NextARFFChunk(chunk);
+      break;
+    case armaBinary:
+      chunkPoints = NextBinaryChunk(chunk);
+      break;
+    case hdf5:
+      chunkPoints = NextHDF5Chunk(chunk);
+      break;
+  }
+
+  position += chunkPoints;
+  return (chunkPoints > 0);
+}
+
+template<typename eT>
+size_t ChunkedReader<eT>::NextTextChunk(arma::Mat<eT>& chunk)
+{
+  chunk.set_size(dimensionality, chunkSize);
+
+  size_t chunkPoints = 0;
+  std::string line, token;
+  while (chunkPoints < chunkSize && std::getline(stream, line))
+  {
+    const char* begin = line.c_str();
+    const char* end = begin + line.size();
+    details::TrimRange(begin, end);
+
+    // The first pass let the DatasetInfo see every token, so the tokens of a
+    // numeric dimension are all numbers and only the others need mapping.
+    const size_t tokens = details::SplitLine(begin, end, separator,
+        [&](const size_t dim, const char* tokenBegin, const char* tokenEnd)
+        {
+          if (dim >= dimensionality)
+            return;
+
+          eT& value = chunk(dim, chunkPoints);
+          if (info.Type(dim) == Datatype::numeric &&
+              details::ParseNumber(tokenBegin, tokenEnd, value))
+            return;
+
+          token.assign(tokenBegin, tokenEnd);
+          value = info.template MapString<eT>(token, dim);
+        });
+
+    if (tokens != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "ChunkedReader::NextChunk(): wrong number of dimensions ("
+          << tokens << ") on line " << lineNumber << "; should be "
+          << dimensionality << " dimensions.";
+      throw std::runtime_error(oss.str());
+    }
+
+    ++lineNumber;
+    ++chunkPoints;
+  }
+
+  chunk.resize(dimensionality, chunkPoints);
+  return chunkPoints;
+}
+
+template<typename eT>
+size_t ChunkedReader<eT>::NextARFFChunk(arma::Mat<eT>& chunk)
+{
+  chunk.set_size(dimensionality, chunkSize);
+
+  size_t chunkPoints = 0;
+  std::string line;
+  while (chunkPoints < chunkSize && std::getline(stream, line))
+  {
+    ++lineNumber;
+    boost::trim(line);
+
+    // Skip empty lines and comments.
+    if (line.empty() || line[0] == '%')
+      continue;
+
+    details::ParseARFFLine(line, lineNumber, chunk, chunkPoints, info);
+    ++chunkPoints;
+  }
+
+  chunk.resize(dimensionality, chunkPoints);
+  return chunkPoints;
+}
+
+template<typename eT>
+size_t ChunkedReader<eT>::NextBinaryChunk(arma::Mat<eT>& chunk)
+{
+  const size_t chunkPoints = std::min(chunkSize, points - position);
+  chunk.set_size(dimensionality, chunkPoints);
+  if (chunkPoints == 0)
+    return 0;
+
+  // The stored matrix is column-major, so each dimension of the chunk is a
+  // contiguous block.
+  const size_t elemSize = std::stoul(elemType.substr(2));
+  for (size_t d = 0; d < dimensionality; ++d)
+  {
+    stream.seekg(dataStart + std::streamoff((d * points + position) *
+        elemSize));
+
+    if (elemType == "IU001")
+      details::ReadBinaryRow<uint8_t>(stream, buffer, chunk, d);
+    else if (elemType == "IS001")
+      details::ReadBinaryRow<int8_t>(stream, buffer, chunk, d);
+    else if (elemType == "IU002")
+      details::ReadBinaryRow<uint16_t>(stream, buffer, chunk, d);
+    else if (elemType == "IS002")
+      details::ReadBinaryRow<int16_t>(stream, buffer, chunk, d);
+    else if (elemType == "IU004")
+      details::ReadBinaryRow<uint32_t>(stream, buffer, chunk, d);
+    else if (elemType == "IS004")
+      details::ReadBinaryRow<int32_t>(stream, buffer, chunk, d);
+    else if (elemType == "IU008")
+      details::ReadBinaryRow<uint64_t>(stream, buffer, chunk, d);
+    else if (elemType == "IS008")
+      details::ReadBinaryRow<int64_t>(stream, buffer, chunk, d);
+    else if (elemType == "FN004")
+      details::ReadBinaryRow<float>(stream, buffer, chunk, d);
+    else
+      details::ReadBinaryRow<double>(stream, buffer, chunk, d);
+  }
+
+  return chunkPoints;
+}
+
+template<typename eT>
+size_t ChunkedReader<eT>::NextHDF5Chunk(arma::Mat<eT>& chunk)
+{
+#ifdef ARMA_USE_HDF5
+  const size_t chunkPoints = std::min(chunkSize, points - position);
+  chunk.set_size(dimensionality, chunkPoints);
+  if (chunkPoints == 0)
+    return 0;
+
+  // Select the points of this chunk in the file.
+  const hid_t fileSpace = H5Dget_space(dataset);
+  const hsize_t offset[2] = { 0, position };
+  const hsize_t count[2] = { dimensionality, chunkPoints };
+  H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset, NULL, count, NULL);
+  const hid_t memorySpace = H5Screate_simple(2, count, NULL);
+
+  // HDF5 is row-major, so this holds the transpose of the chunk.
+  arma::Mat<eT> transposed(chunkPoints, dimensionality);
+  const herr_t status = H5Dread(dataset, details::HDF5Type(eT()),
+      memorySpace, fileSpace, H5P_DEFAULT, transposed.memptr());
+
+  H5Sclose(memorySpace);
+  H5Sclose(fileSpace);
+
+  if (status < 0)
+    throw std::runtime_error("ChunkedReader::NextChunk(): cannot read from '"
+        + filename + "'");
+
+  chunk = transposed.t();
+  return chunkPoints;
+#else
+  chunk.reset();
+  return 0;
+#endif
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,365 @@
+/**
+ * @file columnar_impl.hpp
+ *
+ * Reading and writing of mlpack's columnar binary format (.mlcol files), which
+ * stores each dimension of a dataset contiguously, along with its type and its
+ * mappings, so that datasets with categorical dimensions don't have to be
+ * parsed and mapped again.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COLUMNAR_IMPL_HPP
+#define MLPACK_CORE_DATA_COLUMNAR_IMPL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_mapper.hpp"
+#include "mapped_file.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+/**
+ * The layout of a columnar file, with all integers stored as native 64-bit
+ * integers:
+ *
+ *  - a 64-byte header: the magic string "MLPACK_COLUMNAR\n", the Armadillo code
+ *    of the element type (such as "FN008", padded with zeros to 8 bytes), the
+ *    number of dimensions and the number of points;
+ *  - for each dimension, an entry with its type (0 for numeric, 1 for
+ *    categorical), the offset of its values, the offset of its mappings and the
+ *    number of its mappings;
+ *  - for each dimension, its values, starting at a multiple of 64 bytes;
+ *  - for each categorical dimension, the strings of its mappings in the order
+ *    of their values, each as its length and its characters.
+ */
+struct ColumnarEntry
+{
+  uint64_t type;
+  uint64_t dataOffset;
+  uint64_t mappingOffset;
+  uint64_t numMappings;
+};
+
+//! The magic string at the start of columnar files.
+const char columnarMagic[] = "MLPACK_COLUMNAR\n";
+//! The size of the header of columnar files.
+const size_t columnarHeaderSize = 64;
+//! The alignment of the values of each dimension.
+const size_t columnarAlignment = 64;
+
+//! Round up an offset to the alignment of the values of a dimension.
+inline size_t ColumnarAlign(const size_t offset)
+{
+  return (offset + columnarAlignment - 1) / columnarAlignment *
+      columnarAlignment;
+}
+
+//! Return the Armadillo code of the given element type, such as "FN008".
+template<typename eT>
+std::string ColumnarTypeCode()
+{
+  const std::string header = arma::diskio::gen_bin_header(arma::Mat<eT>());
+  return header.substr(header.size() - 5);
+}
+
+/**
+ * Save a matrix to a columnar file.  The dimensions are the rows of the matrix,
+ * or its columns if transpose is false.  If info isn't NULL, the types and
+ * mappings of the dimensions are saved too.  A std::runtime_error is thrown on
+ * errors.
+ */
+template<typename eT>
+void SaveColumnar(const std::string& filename,
+                  const arma::Mat<eT>& matrix,
+                  const DatasetInfo* info,
+                  const bool transpose)
+{
+  const size_t dimensions = transpose ? matrix.n_rows : matrix.n_cols;
+  const size_t points = transpose ? matrix.n_cols : matrix.n_rows;
+  if (info != NULL && info->Dimensionality() != dimensions)
+  {
+    std::ostringstream oss;
+    oss << "Cannot save '" << filename << "': the DatasetInfo has "
+        << info->Dimensionality() << " dimensions, but the matrix has "
+        << dimensions << ".";
+    throw std::runtime_error(oss.str());
+  }
+
+  std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("Cannot open file '" + filename + "' for writing;"
+        " save failed.");
+  }
+
+  // Lay out the values and then the mappings of each dimension.
+  std::vector<ColumnarEntry> entries(dimensions);
+  size_t offset = ColumnarAlign(columnarHeaderSize +
+      dimensions * sizeof(ColumnarEntry));
+  for (size_t d = 0; d < dimensions; ++d)
+  {
+    entries[d].type = (info != NULL &&
+        info->Type(d) == Datatype::categorical) ? 1 : 0;
+    entries[d].dataOffset = offset;
+    offset = ColumnarAlign(offset + points * sizeof(eT));
+  }
+
+  for (size_t d = 0; d < dimensions; ++d)
+  {
+    entries[d].mappingOffset = offset;
+    entries[d].numMappings = (entries[d].type == 1) ?
+        info->NumMappings(d) : 0;
+    for (size_t v = 0; v < entries[d].numMappings; ++v)
+      offset += sizeof(uint64_t) + info->UnmapString(v, d).size();
+  }
+
+  char header[columnarHeaderSize] = { 0 };
+  const std::string typeCode = ColumnarTypeCode<eT>();
+  const uint64_t sizes[2] = { dimensions, points };
+  std::memcpy(header, columnarMagic, 16);
+  std::memcpy(header + 16, typeCode.data(), std::min(typeCode.size(),
+      (size_t) 8));
+  std::memcpy(header + 24, sizes, sizeof(sizes));
+  stream.write(header, columnarHeaderSize);
+  stream.write((const char*) entries.data(),
+      dimensions * sizeof(ColumnarEntry));
+
+  // Each dimension is a row of the matrix (which has to be gathered), or a
+  // column.
+  const std::vector<char> padding(columnarAlignment, 0);
+  std::vector<eT> values(transpose ? points : 0);
+  size_t position = columnarHeaderSize + dimensions * sizeof(ColumnarEntry);
+  for (size_t d = 0; d < dimensions; ++d)
+  {
+    stream.write(padding.data(), entries[d].dataOffset - position);
+
+    const eT* dimensionValues = matrix.memptr() + d * points;
+    if (transpose)
+    {
+      for (size_t i = 0; i < points; ++i)
+        values[i] = matrix(d, i);
+      dimensionValues = values.data();
+    }
+
+    stream.write((const char*) dimensionValues, points * sizeof(eT));
+    position = entries[d].dataOffset + points * sizeof(eT);
+  }
+
+  if (dimensions > 0)
+    stream.write(padding.data(), entries[0].mappingOffset - position);
+
+  for (size_t d = 0; d < dimensions; ++d)
+  {
+    for (size_t v = 0; v < entries[d].numMappings; ++v)
+    {
+      const std::string& str = info->UnmapString(v, d);
+      const uint64_t length = str.size();
+      stream.write((const char*) &length, sizeof(uint64_t));
+      stream.write(str.data(), str.size());
+    }
+  }
+
+  if (!stream.good())
+    throw std::runtime_error("Save to '" + filename + "' failed.");
+}
+
+/**
+ * Copy the values of the given dimensions (at the given offsets of the file)
+ * into the rows of the matrix (or its columns if transpose is false),
+ * converting them from SrcType.  Blocks of points are copied in parallel.
+ */
+template<typename SrcType, typename eT>
+void CopyColumnarValues(const char* data,
+                        const std::vector<size_t>& offsets,
+                        const size_t points,
+                        arma::Mat<eT>& matrix,
+                        const bool transpose)
+{
+  const size_t blockSize = 4096;
+  const size_t blocks = (points + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, points);
+    for (size_t k = 0; k < offsets.size(); ++k)
+    {
+      const SrcType* values = (const SrcType*) (data + offsets[k]);
+      if (transpose)
+      {
+        for (size_t i = begin; i < end; ++i)
+          matrix(k, i) = eT(values[i]);
+      }
+      else
+      {
+        for (size_t i = begin; i < end; ++i)
+          matrix(i, k) = eT(values[i]);
+      }
+    }
+  }
+}
+
+/**
+ * Load the given dimensions (or all of them, if selection is NULL) of a
+ * columnar file into the rows of a matrix (or its columns if transpose is
+ * false).  If info isn't NULL, it is set to the types and mappings of those
+ * dimensions.  The file is memory-mapped, and only the selected dimensions are
+ * read.  A std::runtime_error is thrown on errors.
+ */
+template<typename eT>
+void LoadColumnar(const std::string& filename,
+                  arma::Mat<eT>& matrix,
+                  DatasetInfo* info,
+                  const std::vector<size_t>* selection,
+                  const bool transpose)
+{
+  MappedFile file(filename);
+  const char* data = file.Data();
+  const size_t size = file.Size();
+  if (size < columnarHeaderSize ||
+      std::memcmp(data, columnarMagic, 16) != 0)
+  {
+    throw std::runtime_error("'" + filename + "' is not an mlpack columnar "
+        "file.");
+  }
+
+  uint64_t sizes[2];
+  std::memcpy(sizes, data + 24, sizeof(sizes));
+  const size_t dimensions = (size_t) sizes[0];
+  const size_t points = (size_t) sizes[1];
+  const std::string typeCode(data + 16, std::find(data + 16, data + 24, '\0'));
+  if (dimensions > (size - columnarHeaderSize) / sizeof(ColumnarEntry))
+    throw std::runtime_error("'" + filename + "' is truncated.");
+
+  std::vector<ColumnarEntry> entries(dimensions);
+  std::memcpy(entries.data(), data + columnarHeaderSize,
+      dimensions * sizeof(ColumnarEntry));
+
+  std::vector<size_t> selected;
+  if (selection != NULL)
+  {
+    selected = *selection;
+  }
+  else
+  {
+    selected.resize(dimensions);
+    for (size_t d = 0; d < dimensions; ++d)
+      selected[d] = d;
+  }
+
+  const size_t elemSize = (size_t) (typeCode.size() == 5 ?
+      std::atoi(typeCode.c_str() + 2) : 0);
+  std::vector<size_t> offsets(selected.size());
+  for (size_t k = 0; k < selected.size(); ++k)
+  {
+    if (selected[k] >= dimensions)
+    {
+      std::ostringstream oss;
+      oss << "Cannot load dimension " << selected[k] << " of '" << filename
+          << "': it only has " << dimensions << " dimensions.";
+      throw std::runtime_error(oss.str());
+    }
+
+    const ColumnarEntry& entry = entries[selected[k]];
+    if (entry.dataOffset > size || elemSize == 0 ||
+        points > (size - entry.dataOffset) / elemSize)
+      throw std::runtime_error("'" + filename + "' is truncated.");
+    offsets[k] = (size_t) entry.dataOffset;
+  }
+
+  if (transpose)
+    matrix.set_size(selected.size(), points);
+  else
+    matrix.set_size(points, selected.size());
+
+  if (typeCode == ColumnarTypeCode<double>())
+    CopyColumnarValues<double>(data, offsets, points, matrix, transpose);
+  else if (typeCode == ColumnarTypeCode<float>())
+    CopyColumnarValues<float>(data, offsets, points, matrix, transpose);
+  else if (typeCode == ColumnarTypeCode<uint64_t>())
+    CopyColumnarValues<uint64_t>(data, offsets, points, matrix, transpose);
+  else if (typeCode == ColumnarTypeCode<int64_t>())
+    CopyColumnarValues<int64_t>(data, offsets, points, matrix, transpose);
+  else if (typeCode == ColumnarTypeCode<uint32_t>())
+    CopyColumnarValues<uint32_t>(data, offsets, points, matrix, transpose);
+  else if (typeCode == ColumnarTypeCode<int32_t>())
+    CopyColumnarValues<int32_t>(data, offsets, points, matrix, transpose);
+  else if (typeCode == ColumnarTypeCode<uint16_t>())
+    CopyColumnarValues<uint16_t>(data, offsets, points, matrix, transpose);
+  else if (typeCode == ColumnarTypeCode<int16_t>())
+    CopyColumnarValues<int16_t>(data, offsets, points, matrix, transpose);
+  else if (typeCode == ColumnarTypeCode<uint8_t>())
+    CopyColumnarValues<uint8_t>(data, offsets, points, matrix, transpose);
+  else if (typeCode == ColumnarTypeCode<int8_t>())
+    CopyColumnarValues<int8_t>(data, offsets, points, matrix, transpose);
+  else
+    throw std::runtime_error("'" + filename + "' holds elements of an "
+        "unsupported type (" + typeCode + ").");
+
+  if (info == NULL)
+    return;
+
+  // Re-create the mappings in the order of their values, so that each string
+  // gets its old value back.
+  *info = DatasetInfo(selected.size());
+  std::string str;
+  for (size_t k = 0; k < selected.size(); ++k)
+  {
+    const ColumnarEntry& entry = entries[selected[k]];
+    if (entry.type != 1)
+      continue;
+
+    info->Type(k) = Datatype::categorical;
+    size_t position = (size_t) entry.mappingOffset;
+    for (size_t v = 0; v < entry.numMappings; ++v)
+    {
+      uint64_t length;
+      if (position > size || size - position < sizeof(uint64_t))
+        throw std::runtime_error("'" + filename + "' is truncated.");
+      std::memcpy(&length, data + position, sizeof(uint64_t));
+      position += sizeof(uint64_t);
+      if (length > size - position)
+        throw std::runtime_error("'" + filename + "' is truncated.");
+
+      str.assign(data + position, (size_t) length);
+      position += (size_t) length;
+      info->MapString<size_t>(str, k);
+    }
+  }
+}
+
+//! Load a columnar file with the mappings of a DatasetInfo.
+template<typename eT>
+void LoadColumnarInfo(const std::string& filename,
+                      arma::Mat<eT>& matrix,
+                      DatasetInfo& info,
+                      const bool transpose)
+{
+  LoadColumnar(filename, matrix, &info, NULL, transpose);
+}
+
+//! Columnar files only hold the mappings of a DatasetInfo.
+template<typename eT, typename PolicyType>
+void LoadColumnarInfo(const std::string& filename,
+                      arma::Mat<eT>& /* matrix */,
+                      DatasetMapper<PolicyType>& /* info */,
+                      const bool /* transpose */)
+{
+  throw std::runtime_error("Cannot load '" + filename + "': columnar files "
+      "can only be loaded with a DatasetInfo.");
+}
+
+} // namespace details
+} // namespace data
+} // namespace mlpack
+
+#endif
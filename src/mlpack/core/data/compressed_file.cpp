@@ -0,0 +1,216 @@
+/**
+ * @file compressed_file.cpp
+ *
+ * Implementation of Decompress() and of the InputFileStream class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "compressed_file.hpp"
+#include "extension.hpp"
+
+#include <mlpack/core/util/log.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+#ifdef HAS_ZLIB
+  #include <zlib.h>
+#endif
+
+#ifdef HAS_ZSTD
+  #include <zstd.h>
+#endif
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+namespace {
+
+//! The initial size of the buffer for decompressed data.
+const size_t initialSize = 1 << 20;
+
+#ifdef HAS_ZLIB
+void DecompressGzip(const std::string& filename, std::vector<char>& data)
+{
+  gzFile file = gzopen(filename.c_str(), "rb");
+  if (file == NULL)
+    throw std::runtime_error("cannot open file '" + filename + "'");
+  gzbuffer(file, initialSize);
+
+  size_t size = 0;
+  data.resize(initialSize);
+  while (true)
+  {
+    if (size == data.size())
+      data.resize(2 * data.size());
+
+    // gzread() can't read more than INT_MAX bytes at once.
+    const unsigned int request = (unsigned int) std::min(data.size() - size,
+        (size_t) INT_MAX);
+    const int bytes = gzread(file, data.data() + size, request);
+    if (bytes < 0)
+    {
+      int error;
+      const std::string message = gzerror(file, &error);
+      gzclose(file);
+      throw std::runtime_error("cannot decompress file '" + filename + "': " +
+          message);
+    }
+    else if (bytes == 0)
+    {
+      break;
+    }
+
+    size += (size_t) bytes;
+  }
+
+  gzclose(file);
+  data.resize(size);
+}
+#endif
+
+#ifdef HAS_ZSTD
+void DecompressZstd(const std::string& filename, std::vector<char>& data)
+{
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("cannot open file '" + filename + "'");
+
+  ZSTD_DStream* zstream = ZSTD_createDStream();
+  ZSTD_initDStream(zstream);
+  std::vector<char> input(ZSTD_DStreamInSize());
+
+  size_t size = 0;
+  size_t result = 0;
+  data.resize(initialSize);
+  ZSTD_inBuffer in = { input.data(), 0, 0 };
+  while (true)
+  {
+    // Read more input once the decoder has consumed all of it.
+    if (in.pos == in.size)
+    {
+      stream.read(input.data(), input.size());
+      in.size = (size_t) stream.gcount();
+      in.pos = 0;
+    }
+
+    if (size == data.size())
+      data.resize(2 * data.size());
+
+    ZSTD_outBuffer out = { data.data() + size, data.size() - size, 0 };
+    result = ZSTD_decompressStream(zstream, &out, &in);
+    if (ZSTD_isError(result))
+    {
+      ZSTD_freeDStream(zstream);
+      throw std::runtime_error("cannot decompress file '" + filename + "': " +
+          ZSTD_getErrorName(result));
+    }
+
+    size += out.pos;
+
+    // Stop once there is no more input, and the decoder has nothing left.
+    if (in.size == 0 && out.pos < out.size)
+      break;
+  }
+
+  ZSTD_freeDStream(zstream);
+  if (result != 0)
+  {
+    throw std::runtime_error("cannot decompress file '" + filename + "': the "
+        "file is truncated");
+  }
+
+  data.resize(size);
+}
+#endif
+
+} // namespace
+
+void mlpack::data::Decompress(const std::string& filename,
+                              std::vector<char>& data)
+{
+  const std::string extension = Extension(filename);
+  if (extension == "gz")
+  {
+#ifdef HAS_ZLIB
+    DecompressGzip(filename, data);
+#else
+    throw std::runtime_error("cannot decompress file '" + filename + "': mlpack"
+        " was built without zlib support");
+#endif
+  }
+  else if (extension == "zst")
+  {
+#ifdef HAS_ZSTD
+    DecompressZstd(filename, data);
+#else
+    throw std::runtime_error("cannot decompress file '" + filename + "': mlpack"
+        " was built without zstd support");
+#endif
+  }
+  else
+  {
+    throw std::runtime_error("cannot decompress file '" + filename + "': "
+        "unknown compression format");
+  }
+}
+
+InputFileStream::InputFileStream() :
+    std::istream(NULL),
+    compressed(false),
+    decompressed(false)
+{
+  rdbuf(&fileBuf);
+}
+
+InputFileStream::InputFileStream(const std::string& filename,
+                                 const std::ios_base::openmode mode) :
+    std::istream(NULL),
+    compressed(false),
+    decompressed(false)
+{
+  rdbuf(&fileBuf);
+  open(filename, mode);
+}
+
+void InputFileStream::open(const std::string& filename,
+                           const std::ios_base::openmode mode)
+{
+  compressed = IsCompressed(filename);
+  decompressed = false;
+  if (!compressed)
+  {
+    rdbuf(&fileBuf);
+    if (fileBuf.open(filename.c_str(), mode | std::ios_base::in) == NULL)
+      setstate(std::ios_base::failbit);
+    else
+      clear();
+
+    return;
+  }
+
+  try
+  {
+    memory = MappedFile(filename);
+  }
+  catch (std::runtime_error& e)
+  {
+    Log::Warn << e.what() << "." << std::endl;
+    setstate(std::ios_base::failbit);
+    return;
+  }
+
+  memoryBuf.Reset(memory.Data(), memory.Size());
+  rdbuf(&memoryBuf);
+  clear();
+  decompressed = true;
+}
+
+bool InputFileStream::is_open() const
+{
+  return compressed ? decompressed : fileBuf.is_open();
+}
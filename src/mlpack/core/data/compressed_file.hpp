@@ -0,0 +1,138 @@
+/**
+ * @file compressed_file.hpp
+ *
+ * Support for reading gzip- and zstd-compressed datasets: decompression into
+ * memory, and an input stream that reads compressed and uncompressed files
+ * alike.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COMPRESSED_FILE_HPP
+#define MLPACK_CORE_DATA_COMPRESSED_FILE_HPP
+
+#include <fstream>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Decompress the whole of the given gzip (.gz) or zstd (.zst) file into memory.
+ * Concatenated gzip members and zstd frames are decompressed one after the
+ * other.  A std::runtime_error is thrown if the file can't be read or
+ * decompressed, or if mlpack was built without support for its codec (zlib or
+ * libzstd).
+ *
+ * @param filename Name of the compressed file.
+ * @param data Vector to store the decompressed contents in.
+ */
+void Decompress(const std::string& filename, std::vector<char>& data);
+
+/**
+ * A stream buffer that reads from a block of memory, which must stay valid
+ * while the buffer is used.  Seeking within the block is supported.
+ */
+class MemoryStreamBuf : public std::streambuf
+{
+ public:
+  //! Create a buffer on the given block of memory.
+  MemoryStreamBuf(const char* data = NULL, const size_t size = 0)
+  {
+    Reset(data, size);
+  }
+
+  //! Read from the given block of memory instead, from its start.
+  void Reset(const char* data, const size_t size)
+  {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+
+ protected:
+  //! Seek relative to the start, the current position or the end.
+  pos_type seekoff(off_type offset,
+                   std::ios_base::seekdir direction,
+                   std::ios_base::openmode which = std::ios_base::in)
+  {
+    if (!(which & std::ios_base::in))
+      return pos_type(off_type(-1));
+
+    const off_type position = offset + ((direction == std::ios_base::beg) ? 0 :
+        ((direction == std::ios_base::cur) ? gptr() - eback() :
+        egptr() - eback()));
+    if (position < 0 || position > egptr() - eback())
+      return pos_type(off_type(-1));
+
+    setg(eback(), eback() + position, egptr());
+    return pos_type(position);
+  }
+
+  //! Seek to the given position.
+  pos_type seekpos(pos_type position,
+                   std::ios_base::openmode which = std::ios_base::in)
+  {
+    return seekoff(off_type(position), std::ios_base::beg, which);
+  }
+};
+
+/**
+ * An input stream on a file that may be compressed.  Files that IsCompressed()
+ * recognizes are decompressed into memory when they are opened, and read from
+ * there; other files are read directly, like with std::ifstream.  This lets
+ * data::Load() read compressed datasets without decompressing them to disk
+ * first.
+ */
+class InputFileStream : public std::istream
+{
+ public:
+  //! Create a stream that isn't open.
+  InputFileStream();
+
+  /**
+   * Open the given file.  On failure, the failbit of the stream is set, and if
+   * the file couldn't be decompressed, the reason is printed to Log::Warn.
+   *
+   * @param filename Name of the file to open.
+   * @param mode Mode to open the file in (only used for uncompressed files).
+   */
+  InputFileStream(const std::string& filename,
+                  const std::ios_base::openmode mode = std::ios_base::in);
+
+  //! Open the given file (see the constructor).
+  void open(const std::string& filename,
+            const std::ios_base::openmode mode = std::ios_base::in);
+
+  //! Return whether a file was opened successfully.
+  bool is_open() const;
+
+  //! Return whether the open file is read from its decompressed contents.
+  bool Compressed() const { return compressed; }
+
+  //! Get the decompressed contents of a compressed file.
+  const MappedFile& Memory() const { return memory; }
+
+ private:
+  //! The buffer for uncompressed files.
+  std::filebuf fileBuf;
+  //! The decompressed contents of a compressed file.
+  MappedFile memory;
+  //! The buffer for the decompressed contents.
+  MemoryStreamBuf memoryBuf;
+  //! Whether the file is compressed.
+  bool compressed;
+  //! Whether a compressed file was opened successfully.
+  bool decompressed;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
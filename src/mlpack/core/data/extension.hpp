@@ -32,6 +32,28 @@ inline std::string Extension(const std::string& filename)
   return extension;
 }
 
+/**
+ * Return whether the given file is compressed, judging by its extension: .gz
+ * files are gzip-compressed and .zst files zstd-compressed.
+ */
+inline bool IsCompressed(const std::string& filename)
+{
+  const std::string extension = Extension(filename);
+  return (extension == "gz" || extension == "zst");
+}
+
+/**
+ * Return the extension of the given file once it is decompressed; for
+ * instance, "csv" for both "dataset.csv" and "dataset.csv.gz".
+ */
+inline std::string UncompressedExtension(const std::string& filename)
+{
+  if (!IsCompressed(filename))
+    return Extension(filename);
+
+  return Extension(filename.substr(0, filename.rfind('.')));
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_CUSTOM_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "impute_dimensions.hpp"
 
 namespace mlpack {
 namespace data {
@@ -71,6 +72,24 @@ class CustomImputation
     }
   }
 
+  /**
+   * Replace the missing values of each of the given dimensions with the custom
+   * value, in a single parallel pass.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value to get rid of, for each of the dimensions.
+   * @param dimensions Indices of the (distinct) dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    details::FillMissing(input, mappedValues, dimensions,
+        std::vector<double>(dimensions.size(), customValue), columnMajor);
+  }
+
  private:
   //! A user-defined value that the user wants to replace missing values with.
   T customValue;
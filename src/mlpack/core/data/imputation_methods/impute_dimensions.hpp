@@ -0,0 +1,85 @@
+/**
+ * @file impute_dimensions.hpp
+ *
+ * Utilities shared by the imputation strategies that impute several
+ * dimensions at once: finding missing values, and replacing them in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_IMPUTE_STRATEGIES_IMPUTE_DIMENSIONS_HPP
+#define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_IMPUTE_DIMENSIONS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+//! The number of points in each block of the parallel imputation passes.
+const size_t imputationBlockSize = 4096;
+
+//! Return whether a value is missing: equal to the mapped value, or NaN.
+template<typename T, typename U>
+inline bool IsMissing(const T value, const U mappedValue)
+{
+  return value == mappedValue || std::isnan(value);
+}
+
+/**
+ * Replace the missing values of each of the given (distinct) dimensions with
+ * the corresponding replacement.  If the matrix is column-major, the points
+ * are handled in parallel blocks, each for all the dimensions at once;
+ * otherwise each dimension is a contiguous column and the dimensions are
+ * handled in parallel.
+ */
+template<typename T>
+void FillMissing(arma::Mat<T>& input,
+                 const std::vector<T>& mappedValues,
+                 const std::vector<size_t>& dimensions,
+                 const std::vector<double>& replacements,
+                 const bool columnMajor)
+{
+  if (columnMajor)
+  {
+    const size_t numBlocks = (input.n_cols + imputationBlockSize - 1) /
+        imputationBlockSize;
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * imputationBlockSize;
+      const size_t end = std::min(begin + imputationBlockSize,
+          (size_t) input.n_cols);
+      for (size_t i = begin; i < end; ++i)
+      {
+        for (size_t j = 0; j < dimensions.size(); ++j)
+        {
+          if (IsMissing(input(dimensions[j], i), mappedValues[j]))
+            input(dimensions[j], i) = replacements[j];
+        }
+      }
+    }
+  }
+  else
+  {
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) dimensions.size(); ++j)
+    {
+      T* column = input.colptr(dimensions[j]);
+      for (size_t i = 0; i < input.n_rows; ++i)
+      {
+        if (IsMissing(column[i], mappedValues[j]))
+          column[i] = replacements[j];
+      }
+    }
+  }
+}
+
+} // namespace details
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_LISTWISE_DELETION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "impute_dimensions.hpp"
 
 namespace mlpack {
 namespace data {
@@ -66,6 +67,49 @@ class ListwiseDeletion
       input = input.rows(arma::uvec(colsToKeep));
     }
   }
+
+  /**
+   * Remove every point that has a missing value in any of the given
+   * dimensions, in a single pass over the matrix.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value to get rid of, for each of the dimensions.
+   * @param dimensions Indices of the dimensions to look for missing values in.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<char> keep(numPoints, 1);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
+    {
+      for (size_t j = 0; j < dimensions.size(); ++j)
+      {
+        const T value = columnMajor ? input(dimensions[j], i) :
+            input(i, dimensions[j]);
+        if (details::IsMissing(value, mappedValues[j]))
+        {
+          keep[i] = 0;
+          break;
+        }
+      }
+    }
+
+    std::vector<arma::uword> pointsToKeep;
+    for (size_t i = 0; i < numPoints; ++i)
+      if (keep[i])
+        pointsToKeep.push_back(i);
+
+    if (columnMajor)
+      input = input.cols(arma::uvec(pointsToKeep));
+    else
+      input = input.rows(arma::uvec(pointsToKeep));
+  }
 }; // class ListwiseDeletion
 
 } // namespace data
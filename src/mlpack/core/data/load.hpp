@@ -20,6 +20,7 @@
 
 #include "format.hpp"
 #include "dataset_mapper.hpp"
+#include "mapped_file.hpp"
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices and models. */ {
@@ -40,6 +41,11 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - mlpack columnar, denoted by .mlcol (see data::Save())
+ *
+ * Files other than HDF5 files may also be compressed with gzip or zstd, with
+ * .gz or .zst after the extension (such as "dataset.csv.gz"), if mlpack was
+ * built with zlib or libzstd.  They are decompressed into memory, not to disk.
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -180,6 +186,15 @@ bool Load(const std::string& filename,
  * - CSV (csv_ascii), denoted by .csv, or optionally .txt
  * - TSV (raw_ascii), denoted by .tsv, .csv, or .txt
  * - ASCII (raw_ascii), denoted by .txt
+ * - ARFF, denoted by .arff
+ *
+ * The mlpack columnar binary format, denoted by .mlcol, can also be loaded
+ * with a DatasetInfo; it holds the types and mappings that were given to
+ * data::Save(), so nothing is parsed or mapped.
+ *
+ * Text files may also be compressed with gzip or zstd, with .gz or .zst after
+ * the extension (such as "dataset.csv.gz"), if mlpack was built with zlib or
+ * libzstd.  They are decompressed into memory, not to disk.
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -209,6 +224,34 @@ bool Load(const std::string& filename,
           const bool fatal = false,
           const bool transpose = true);
 
+/**
+ * Loads only the given dimensions of an mlpack columnar file (denoted by
+ * .mlcol; see data::Save()), in the given order.  The file is memory-mapped,
+ * and the other dimensions are not read at all, so a few features can be
+ * loaded cheaply from a wide dataset.  The DatasetInfo is re-created with the
+ * types and mappings of the loaded dimensions, so dimension i of the matrix
+ * corresponds to dimensions[i] of the file.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the matrix does not load successfully.
+ *
+ * @param filename Name of the columnar file to load.
+ * @param matrix Matrix to load the dimensions into.
+ * @param info DatasetInfo to populate with the types and mappings.
+ * @param dimensions Indices of the dimensions to load.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param transpose If true, the dimensions are loaded into the rows of the
+ *     matrix.
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool LoadDimensions(const std::string& filename,
+                    arma::Mat<eT>& matrix,
+                    DatasetInfo& info,
+                    const std::vector<size_t>& dimensions,
+                    const bool fatal = false,
+                    const bool transpose = true);
+
 /**
  * Don't document these with doxygen; they aren't helpful for users to know
  * about.
@@ -272,6 +315,11 @@ extern template bool Load<double, IncrementPolicy>(
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
+ * Binary models are memory-mapped and read straight from memory.  The header
+ * that Save() writes before them is checked first, so models saved on a
+ * platform with a different byte order or integer sizes are rejected; binary
+ * models saved without a header by older versions of mlpack still load.
+ *
  * The name parameter should be specified to indicate the name of the structure
  * to be loaded.  This should be the same as the name that was used to save the
  * structure (otherwise, the loading procedure will fail).
@@ -287,6 +335,136 @@ bool Load(const std::string& filename,
           const bool fatal = false,
           format f = format::autodetect);
 
+/**
+ * Load a matrix from an Armadillo binary or raw binary file (denoted by .bin)
+ * without copying it: the file is mapped into memory, and the matrix uses the
+ * mapped elements directly.  Processes that load the same file this way share
+ * its pages in the page cache.  The mapping is private, so changes to the
+ * matrix are never written to the file.
+ *
+ * The given MappedFile takes over the mapping, and must outlive the matrix (and
+ * must not be reused for another load while the matrix is in use).  The matrix
+ * is not transposed, so a dataset saved with data::Save() and its default
+ * transposition is loaded with points as rows; save it with transpose = false
+ * to get points as columns.  As with Armadillo, raw binary files are loaded as
+ * a single column.
+ *
+ * The elements of an Armadillo binary file must have the type of the matrix.
+ * If they are not aligned in the file, they are copied (with a warning);
+ * data::Save() aligns them.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Matrix to load contents of file into.
+ * @param mapping Object to hold the mapping of the file.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Mat<eT>& matrix,
+                MappedFile& mapping,
+                const bool fatal = false);
+
+/**
+ * Load a column vector from an Armadillo binary or raw binary file without
+ * copying it; see the LoadMapped() overload for matrices.  The file may hold a
+ * row or a column vector.
+ *
+ * @param filename Name of file to load.
+ * @param vec Column vector to load contents of file into.
+ * @param mapping Object to hold the mapping of the file.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Col<eT>& vec,
+                MappedFile& mapping,
+                const bool fatal = false);
+
+/**
+ * Load a row vector from an Armadillo binary or raw binary file without
+ * copying it; see the LoadMapped() overload for matrices.  The file may hold a
+ * row or a column vector.
+ *
+ * @param filename Name of file to load.
+ * @param rowvec Row vector to load contents of file into.
+ * @param mapping Object to hold the mapping of the file.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Row<eT>& rowvec,
+                MappedFile& mapping,
+                const bool fatal = false);
+
+/**
+ * Load a sparse matrix from a file, guessing the format from the extension.
+ * The supported formats are:
+ *
+ *  - coordinate lists, denoted by .coo: one nonzero per line, as the row, the
+ *    column and the value, with zero-based indices (like Armadillo's
+ *    coord_ascii format).  Empty lines and lines starting with '#' or '%' are
+ *    skipped.
+ *  - libsvm / svmlight files, denoted by .svm, .libsvm or .svmlight; the labels
+ *    are discarded (use LoadLibSVM() to keep them).
+ *  - Armadillo binary (arma_binary), denoted by .bin.
+ *
+ * Text files are memory-mapped and parsed in parallel, and the matrix is built
+ * from its nonzeros directly, without a dense copy.  Like the other Load()
+ * overloads, the matrix is transposed by default, so that each line (or row)
+ * of the file is a column of the matrix: the first index of a coordinate list
+ * is then the point, and the second the dimension.  The points of a libsvm file
+ * are always columns, so the transpose parameter doesn't apply to it.  The size
+ * of the matrix is given by the largest index of each kind.
+ *
+ * Sparse matrices can only be loaded from C++: the command-line and Python
+ * bindings have no sparse matrix parameters, so their programs take dense
+ * matrices only.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the matrix does not load successfully.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Sparse matrix to load contents of file into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param transpose If true, transpose the matrix after loading (default true).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::SpMat<eT>& matrix,
+          const bool fatal = false,
+          const bool transpose = true);
+
+/**
+ * Load a libsvm / svmlight file into a sparse matrix and its labels.  Each line
+ * holds a label and then the nonzeros of a point, as index:value pairs with
+ * one-based indices; each point becomes a column of the matrix, which has as
+ * many rows as the largest index.  Comments (from '#' to the end of a line),
+ * empty lines and qid:... tokens are ignored.  The file is memory-mapped and
+ * parsed in parallel.
+ *
+ * The labels are read as numbers and converted to LabelType, so for
+ * classification they may have to be mapped with NormalizeLabels() first if
+ * they aren't already 0, 1, 2, ...
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the file does not load successfully.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Sparse matrix to load the points into.
+ * @param labels Row vector to load the labels into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT, typename LabelType>
+bool LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::Row<LabelType>& labels,
+                const bool fatal = false);
+
 } // namespace data
 } // namespace mlpack
 
@@ -294,5 +472,9 @@ bool Load(const std::string& filename,
 #include "load_model_impl.hpp"
 // Include implementation of Load() for vectors.
 #include "load_vec_impl.hpp"
+// Include implementation of LoadMapped().
+#include "load_mapped_impl.hpp"
+// Include implementation of Load() for sparse matrices.
+#include "load_sparse_impl.hpp"
 
 #endif
@@ -14,6 +14,7 @@
 
 // In case it hasn't been included yet.
 #include "load_arff.hpp"
+#include "compressed_file.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
 #include "is_naninf.hpp"
@@ -21,19 +22,27 @@
 namespace mlpack {
 namespace data {
 
-template<typename eT, typename PolicyType>
-void LoadARFF(const std::string& filename,
-              arma::Mat<eT>& matrix,
-              DatasetMapper<PolicyType>& info)
-{
-  // First, open the file.
-  std::ifstream ifs;
-  ifs.open(filename);
+namespace details {
 
+/**
+ * Read the header of an ARFF file, up to and including the @data line.  The
+ * DatasetMapper is reset if it is empty, and the types of its dimensions are
+ * set from the attributes.
+ *
+ * @param ifs Stream to read the header from.
+ * @param headerLines Set to the number of lines of the header.
+ * @param info DatasetMapper to set the types of.
+ * @return The dimensionality of the data.
+ */
+template<typename PolicyType>
+size_t ReadARFFHeader(std::istream& ifs,
+                      size_t& headerLines,
+                      DatasetMapper<PolicyType>& info)
+{
   std::string line;
   size_t dimensionality = 0;
   std::vector<bool> types;
-  size_t headerLines = 0;
+  headerLines = 0;
   while (!ifs.eof())
   {
     // Read the next line, then strip whitespace from either side.
@@ -125,7 +134,117 @@ void LoadARFF(const std::string& filename,
       info.Type(i) = Datatype::numeric;
   }
 
+  return dimensionality;
+}
+
+/**
+ * Parse a line of the @data section of an ARFF file (without whitespace on
+ * either side) into the given column of the matrix.
+ *
+ * @param line Line to parse.
+ * @param lineNumber Number of the line in the file, for error messages.
+ * @param matrix Matrix to store the point in.
+ * @param row Column of the matrix to store the point in.
+ * @param info DatasetMapper to map categorical values with.
+ */
+template<typename eT, typename PolicyType>
+void ParseARFFLine(const std::string& line,
+                   const size_t lineNumber,
+                   arma::Mat<eT>& matrix,
+                   const size_t row,
+                   DatasetMapper<PolicyType>& info)
+{
+  // Each line of the @data section must be a CSV (except sparse data, which we
+  // will handle later).  So now we can tokenize the CSV and parse it.  The '?'
+  // representing a missing value is not allowed, so if that occurs we throw an
+  // exception.  We also throw an exception if any piece of data does not match
+  // its type (categorical or numeric).
+
+  // If the first character is {, it is sparse data, and we can just say this
+  // is not handled for now...
+  if (line[0] == '{')
+    throw std::runtime_error("cannot yet parse sparse ARFF data");
+
+  // Tokenize the line.
+  typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
+  boost::escaped_list_separator<char> sep("\\", ",", "\"");
+  Tokenizer tok(line, sep);
+
+  size_t col = 0;
+  std::stringstream token;
+  for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+  {
+    // Check that we are not too many columns in.
+    if (col >= matrix.n_rows)
+    {
+      std::stringstream error;
+      error << "Too many columns in line " << lineNumber << ".";
+      throw std::runtime_error(error.str());
+    }
+
+    // What should this token be?
+    if (info.Type(col) == Datatype::categorical)
+    {
+      // Strip spaces before mapping.
+      std::string token = *it;
+      boost::trim(token);
+      // We load transposed.
+      matrix(col, row) = info.template MapString<eT>(token, col);
+    }
+    else if (info.Type(col) == Datatype::numeric)
+    {
+      // Attempt to read as numeric.
+      token.clear();
+      token.str(*it);
+
+      eT val = eT(0);
+      token >> val;
+
+      if (token.fail())
+      {
+        // Check for NaN or inf.
+        if (!IsNaNInf(val, token.str()))
+        {
+          // Okay, it's not NaN or inf.  If it's '?', we issue a specific
+          // error, otherwise we issue a general error.
+          std::stringstream error;
+          std::string tokenStr = token.str();
+          boost::trim(tokenStr);
+          if (tokenStr == "?")
+            error << "Missing values ('?') not supported, ";
+          else
+            error << "Parse error ";
+          error << "at line " << lineNumber << " token " << col << ": \""
+              << tokenStr << "\".";
+          throw std::runtime_error(error.str());
+        }
+      }
+
+      // If we made it to here, we have a value.
+      matrix(col, row) = val; // We load transposed.
+    }
+
+    ++col;
+  }
+}
+
+} // namespace details
+
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              DatasetMapper<PolicyType>& info)
+{
+  // First, open the file (and decompress it, if it is compressed).
+  InputFileStream ifs;
+  ifs.open(filename);
+
+  size_t headerLines;
+  const size_t dimensionality = details::ReadARFFHeader(ifs, headerLines,
+      info);
+
   // We need to find out how many lines of data are in the file.
+  std::string line;
   std::streampos pos = ifs.tellg();
   size_t row = 0;
   while (!ifs.eof())
@@ -149,78 +268,7 @@ void LoadARFF(const std::string& filename,
   {
     std::getline(ifs, line, '\n');
     boost::trim(line);
-    // Each line of the @data section must be a CSV (except sparse data, which
-    // we will handle later).  So now we can tokenize the
-    // CSV and parse it.  The '?' representing a missing value is not allowed,
-    // so if that occurs we throw an exception.  We also throw an exception if
-    // any piece of data does not match its type (categorical or numeric).
-
-    // If the first character is {, it is sparse data, and we can just say this
-    // is not handled for now...
-    if (line[0] == '{')
-      throw std::runtime_error("cannot yet parse sparse ARFF data");
-
-    // Tokenize the line.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", ",", "\"");
-    Tokenizer tok(line, sep);
-
-    size_t col = 0;
-    std::stringstream token;
-    for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
-    {
-      // Check that we are not too many columns in.
-      if (col >= matrix.n_rows)
-      {
-        std::stringstream error;
-        error << "Too many columns in line " << (headerLines + row) << ".";
-        throw std::runtime_error(error.str());
-      }
-
-      // What should this token be?
-      if (info.Type(col) == Datatype::categorical)
-      {
-        // Strip spaces before mapping.
-        std::string token = *it;
-        boost::trim(token);
-        // We load transposed.
-        matrix(col, row) = info.template MapString<eT>(token, col);
-      }
-      else if (info.Type(col) == Datatype::numeric)
-      {
-        // Attempt to read as numeric.
-        token.clear();
-        token.str(*it);
-
-        eT val = eT(0);
-        token >> val;
-
-        if (token.fail())
-        {
-          // Check for NaN or inf.
-          if (!IsNaNInf(val, token.str()))
-          {
-            // Okay, it's not NaN or inf.  If it's '?', we issue a specific
-            // error, otherwise we issue a general error.
-            std::stringstream error;
-            std::string tokenStr = token.str();
-            boost::trim(tokenStr);
-            if (tokenStr == "?")
-              error << "Missing values ('?') not supported, ";
-            else
-              error << "Parse error ";
-            error << "at line " << (headerLines + row) << " token " << col
-                << ": \"" << tokenStr << "\".";
-            throw std::runtime_error(error.str());
-          }
-        }
-
-        // If we made it to here, we have a value.
-        matrix(col, row) = val; // We load transposed.
-      }
-
-      ++col;
-    }
+    details::ParseARFFLine(line, headerLines + row, matrix, row, info);
     ++row;
   }
 }
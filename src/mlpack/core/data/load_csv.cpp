@@ -17,7 +17,7 @@ namespace mlpack {
 namespace data {
 
 LoadCSV::LoadCSV(const std::string& file) :
-  extension(Extension(file)),
+  extension(UncompressedExtension(file)),
   filename(file),
   inFile(file)
 {
@@ -24,6 +24,8 @@
 #include "extension.hpp"
 #include "format.hpp"
 #include "dataset_mapper.hpp"
+#include "mapped_file.hpp"
+#include "compressed_file.hpp"
 
 namespace mlpack {
 namespace data {
@@ -64,6 +66,28 @@ class LoadCSV
       NonTransposeParse(inout, infoSet);
   }
 
+  /**
+   * Load the file into the given matrix with the given DatasetInfo object.
+   * The file is mapped into memory and parsed in parallel, in newline-aligned
+   * chunks; tokens that are plain numbers are converted in place, and only the
+   * dimensions that have other tokens are passed through the DatasetInfo
+   * afterwards.  The result is the same as with the other overload.  Throws
+   * exceptions on errors.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetInfo to use while loading.
+   * @param transpose If true, the matrix should be transposed on loading
+   *     (default).
+   */
+  template<typename T>
+  void Load(arma::Mat<T>& inout,
+            DatasetMapper<IncrementPolicy>& infoSet,
+            const bool transpose = true)
+  {
+    CheckOpen();
+    MappedParse(inout, infoSet, transpose);
+  }
+
   /**
    * Peek at the file to determine the number of rows and columns in the matrix,
    * assuming a non-transposed matrix.  This will also take a first pass over
@@ -283,6 +307,21 @@ class LoadCSV
     }
   }
 
+  /**
+   * Parse a memory-mapped file in parallel, transposed or not.  A numeric token
+   * is stored without the DatasetMapper if every token of its dimension is a
+   * plain number; the tokens of all other dimensions are mapped serially, in
+   * the order of the file.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper to load with.
+   * @param transpose Whether each line of the file is a column of the matrix.
+   */
+  template<typename T, typename PolicyType>
+  void MappedParse(arma::Mat<T>& inout,
+                   DatasetMapper<PolicyType>& infoSet,
+                   const bool transpose);
+
   /**
    * Parse a transposed matrix.
    *
@@ -366,11 +405,15 @@ class LoadCSV
   std::string extension;
   //! Name of file.
   std::string filename;
-  //! Opened stream for reading.
-  std::ifstream inFile;
+  //! Opened stream for reading (on the decompressed contents of compressed
+  //! files).
+  InputFileStream inFile;
 };
 
 } // namespace data
 } // namespace mlpack
 
+// Include implementation.
+#include "load_csv_impl.hpp"
+
 #endif
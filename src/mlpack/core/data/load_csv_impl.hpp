@@ -0,0 +1,455 @@
+/**
+ * @file load_csv_impl.hpp
+ *
+ * Implementation of the parallel, memory-mapped CSV parser of LoadCSV.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_csv.hpp"
+
+#include "mapped_lines.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+//! Call the strto*() function that a stringstream extraction of T uses.
+inline float StringToFloat(const char* begin, char** end, float)
+{
+  return std::strtof(begin, end);
+}
+
+inline double StringToFloat(const char* begin, char** end, double)
+{
+  return std::strtod(begin, end);
+}
+
+inline long double StringToFloat(const char* begin, char** end, long double)
+{
+  return std::strtold(begin, end);
+}
+
+/**
+ * Return whether [begin, end) holds only digits, and at least one of them.
+ */
+inline bool AllDigits(const char* begin, const char* end)
+{
+  if (begin == end)
+    return false;
+
+  for (const char* p = begin; p != end; ++p)
+    if (*p < '0' || *p > '9')
+      return false;
+
+  return true;
+}
+
+/**
+ * Parse a token as a floating-point number without allocating anything.  Only
+ * plain decimal numbers are accepted, and only if they are in range; for those
+ * a stringstream extraction reads the whole token, with the same result.  For
+ * any other token false is returned, and the token has to be given to the
+ * DatasetMapper.  The character after the token must not be part of a number.
+ */
+template<typename T>
+bool ParseNumber(const char* begin,
+                 const char* end,
+                 T& value,
+                 const typename std::enable_if<
+                     std::is_floating_point<T>::value>::type* = 0)
+{
+  // Check for [+-]?[0-9]*(.[0-9]*)?([eE][+-]?[0-9]+)? with at least one digit
+  // in the mantissa, so that strto*() can't e.g. read "inf" or hexadecimal.
+  const char* p = begin;
+  if (p != end && (*p == '+' || *p == '-'))
+    ++p;
+
+  size_t digits = 0;
+  for (; p != end && *p >= '0' && *p <= '9'; ++p)
+    ++digits;
+  if (p != end && *p == '.')
+    for (++p; p != end && *p >= '0' && *p <= '9'; ++p)
+      ++digits;
+
+  if (digits == 0)
+    return false;
+
+  if (p != end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    if (p != end && (*p == '+' || *p == '-'))
+      ++p;
+    if (!AllDigits(p, end))
+      return false;
+    p = end;
+  }
+
+  if (p != end)
+    return false;
+
+  char* parsed;
+  errno = 0;
+  value = StringToFloat(begin, &parsed, T());
+  return (parsed == end && errno != ERANGE);
+}
+
+template<typename T>
+bool ParseNumber(const char* begin,
+                 const char* end,
+                 T& value,
+                 const typename std::enable_if<std::is_integral<T>::value &&
+                     std::is_signed<T>::value>::type* = 0)
+{
+  const char* digits = (begin != end && (*begin == '+' || *begin == '-')) ?
+      begin + 1 : begin;
+  if (!AllDigits(digits, end))
+    return false;
+
+  char* parsed;
+  errno = 0;
+  const long long result = std::strtoll(begin, &parsed, 10);
+  if (parsed != end || errno == ERANGE ||
+      result < (long long) std::numeric_limits<T>::min() ||
+      result > (long long) std::numeric_limits<T>::max())
+    return false;
+
+  value = (T) result;
+  return true;
+}
+
+template<typename T>
+bool ParseNumber(const char* begin,
+                 const char* end,
+                 T& value,
+                 const typename std::enable_if<std::is_integral<T>::value &&
+                     !std::is_signed<T>::value>::type* = 0)
+{
+  // Negative values are left to the DatasetMapper.
+  const char* digits = (begin != end && *begin == '+') ? begin + 1 : begin;
+  if (!AllDigits(digits, end))
+    return false;
+
+  char* parsed;
+  errno = 0;
+  const unsigned long long result = std::strtoull(begin, &parsed, 10);
+  if (parsed != end || errno == ERANGE ||
+      result > (unsigned long long) std::numeric_limits<T>::max())
+    return false;
+
+  value = (T) result;
+  return true;
+}
+
+template<typename T>
+bool ParseNumber(const char* /* begin */,
+                 const char* /* end */,
+                 T& /* value */,
+                 const typename std::enable_if<!std::is_floating_point<T>::value
+                     && !std::is_integral<T>::value>::type* = 0)
+{
+  return false;
+}
+
+/**
+ * A token of a given dimension, as a pointer into the mapped file (or into the
+ * copy of its last line).
+ */
+struct TokenKey
+{
+  size_t dimension;
+  const char* begin;
+  size_t length;
+
+  bool operator==(const TokenKey& other) const
+  {
+    return dimension == other.dimension && length == other.length &&
+        std::memcmp(begin, other.begin, length) == 0;
+  }
+};
+
+//! Hash a TokenKey with FNV-1a.
+struct TokenKeyHash
+{
+  size_t operator()(const TokenKey& key) const
+  {
+    uint64_t hash = 14695981039346656037ULL ^ (uint64_t) key.dimension;
+    for (size_t i = 0; i < key.length; ++i)
+      hash = (hash ^ (unsigned char) key.begin[i]) * 1099511628211ULL;
+    return (size_t) hash;
+  }
+};
+
+/**
+ * Split a line (without surrounding whitespace) into tokens the same way the
+ * boost::spirit rules of LoadCSV do, and call f(index, begin, end) for each
+ * token, with the whitespace around the token removed.  Like qi::parse(), this
+ * stops at the first delimiter that doesn't match.
+ *
+ * @param begin Start of the line.
+ * @param end End of the line.
+ * @param separator ',' for CSV, '\t' for TSV and ' ' for text files.
+ * @param f Function to call with each token.
+ * @return The number of tokens.
+ */
+template<typename FunctionType>
+size_t SplitLine(const char* begin,
+                 const char* end,
+                 const char separator,
+                 FunctionType&& f)
+{
+  // Tokens of TSV files may contain commas, and tokens of the other files may
+  // contain tabs.
+  const char excluded = (separator == '\t') ? '\t' : ',';
+
+  size_t tokens = 0;
+  const char* p = begin;
+  while (true)
+  {
+    const char* tokenBegin = p;
+    while (p != end && *p != ' ' && *p != '\r' && *p != '\n' && *p != excluded)
+      ++p;
+
+    const char* tokenEnd = p;
+    TrimRange(tokenBegin, tokenEnd);
+
+    f(tokens++, tokenBegin, tokenEnd);
+
+    // Match the delimiter: one or more spaces for text files, or the separator
+    // with any number of spaces on either side.
+    if (separator == ' ')
+    {
+      if (p == end || *p != ' ')
+        break;
+      while (p != end && *p == ' ')
+        ++p;
+    }
+    else
+    {
+      const char* q = p;
+      while (q != end && *q == ' ')
+        ++q;
+      if (q == end || *q != separator)
+        break;
+      for (++q; q != end && *q == ' '; ++q) { }
+      p = q;
+    }
+  }
+
+  return tokens;
+}
+
+} // namespace details
+
+template<typename T, typename PolicyType>
+void LoadCSV::MappedParse(arma::Mat<T>& inout,
+                          DatasetMapper<PolicyType>& infoSet,
+                          const bool transpose)
+{
+  // Compressed files were already decompressed into memory when the stream was
+  // opened.
+  MappedFile mapping;
+  if (!inFile.Compressed())
+    mapping = MappedFile(filename);
+  const MappedFile& file = inFile.Compressed() ? inFile.Memory() : mapping;
+  const char* data = file.Data();
+  const size_t size = file.Size();
+
+  const char separator = (extension == "csv") ? ',' :
+      ((extension == "txt") ? ' ' : '\t');
+
+  const std::string lastLine = details::UnterminatedLastLine(data, size);
+  const std::vector<size_t> chunkStart = details::LineChunks(data, size);
+  const size_t numChunks = chunkStart.size() - 1;
+
+  // Count the lines of each chunk, to know where the lines of each chunk go.
+  std::vector<size_t> chunkLines(numChunks + 1, 0);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const char* begin = data + chunkStart[c];
+    const char* end = data + chunkStart[c + 1];
+    chunkLines[c + 1] = std::count(begin, end, '\n') +
+        ((end == data + size && end != begin && lastLine.size() > 0) ? 1 : 0);
+  }
+  for (size_t c = 0; c < numChunks; ++c)
+    chunkLines[c + 1] += chunkLines[c];
+  const size_t lines = chunkLines[numChunks];
+
+  // The first line gives the number of tokens on each line.
+  size_t tokens = 0;
+  details::ForEachLine(data, data + chunkStart[1], 0, lastLine,
+      [&](const size_t line, const char* begin, const char* end)
+      {
+        if (line == 0)
+        {
+          tokens = details::SplitLine(begin, end, separator,
+              [](const size_t, const char*, const char*) { });
+        }
+      });
+
+  // When transposing, each line is a point; otherwise, each line is a
+  // dimension.  This resets the policy, like the boost::spirit parser.
+  const size_t dimensions = transpose ? tokens : lines;
+  infoSet = DatasetMapper<PolicyType>(dimensions);
+  if (transpose)
+    inout.set_size(tokens, lines);
+  else
+    inout.set_size(lines, tokens);
+
+  // Parse the numbers, and find the dimensions with a token that isn't a plain
+  // number; those must go through the DatasetMapper.  Different chunks share
+  // dimensions only when transposing, so the chunks only need their own flags
+  // then.
+  std::vector<std::vector<char>> needsMapping(transpose ? numChunks : 1,
+      std::vector<char>(dimensions, 0));
+  std::vector<size_t> badLine(numChunks, lines);
+  std::vector<size_t> badTokens(numChunks, 0);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    std::vector<char>& chunkNeedsMapping = needsMapping[transpose ? c : 0];
+    details::ForEachLine(data + chunkStart[c], data + chunkStart[c + 1],
+        chunkLines[c], lastLine,
+        [&](const size_t line, const char* begin, const char* end)
+        {
+          if (badLine[c] < lines)
+            return;
+
+          const size_t lineTokens = details::SplitLine(begin, end, separator,
+              [&](const size_t token, const char* tokenBegin,
+                  const char* tokenEnd)
+              {
+                if (token >= tokens)
+                  return;
+
+                T& value = transpose ? inout(token, line) : inout(line, token);
+                if (!details::ParseNumber(tokenBegin, tokenEnd, value))
+                {
+                  value = T(0);
+                  chunkNeedsMapping[transpose ? token : line] = 1;
+                }
+              });
+
+          if (lineTokens != tokens)
+          {
+            badLine[c] = line;
+            badTokens[c] = lineTokens;
+          }
+        });
+  }
+
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    if (badLine[c] < lines)
+    {
+      std::ostringstream oss;
+      oss << "LoadCSV::" << (transpose ? "TransposeParse" : "NonTransposeParse")
+          << "(): wrong number of dimensions (" << badTokens[c] << ") on line "
+          << badLine[c] << "; should be " << tokens << " dimensions.";
+      throw std::runtime_error(oss.str());
+    }
+  }
+
+  for (size_t c = 1; c < needsMapping.size(); ++c)
+    for (size_t d = 0; d < dimensions; ++d)
+      needsMapping[0][d] |= needsMapping[c][d];
+
+  if (std::find(needsMapping[0].begin(), needsMapping[0].end(), 1) ==
+      needsMapping[0].end())
+    return;
+
+  // Intern the tokens of the dimensions that need to be mapped, chunk by chunk:
+  // each distinct token of a dimension gets an index in the order of its first
+  // appearance in the chunk, and is kept as a pointer into the file, so
+  // repeated tokens cost a hash lookup and nothing else.
+  struct ChunkTokens
+  {
+    //! The distinct tokens, in the order of their first appearance.
+    std::vector<details::TokenKey> distinct;
+    //! For each mapped element of the matrix, its index and its token.
+    std::vector<std::pair<size_t, size_t>> cells;
+  };
+
+  std::vector<ChunkTokens> chunkTokens(numChunks);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    ChunkTokens& chunk = chunkTokens[c];
+    std::unordered_map<details::TokenKey, size_t, details::TokenKeyHash> ids;
+    details::ForEachLine(data + chunkStart[c], data + chunkStart[c + 1],
+        chunkLines[c], lastLine,
+        [&](const size_t line, const char* begin, const char* end)
+        {
+          details::SplitLine(begin, end, separator,
+              [&](const size_t token, const char* tokenBegin,
+                  const char* tokenEnd)
+              {
+                const size_t dimension = transpose ? token : line;
+                if (!needsMapping[0][dimension])
+                  return;
+
+                const details::TokenKey key = { dimension, tokenBegin,
+                    (size_t) (tokenEnd - tokenBegin) };
+                const std::pair<typename std::unordered_map<details::TokenKey,
+                    size_t, details::TokenKeyHash>::iterator, bool> result =
+                    ids.insert(std::make_pair(key, chunk.distinct.size()));
+                if (result.second)
+                  chunk.distinct.push_back(key);
+
+                const size_t index = transpose ? (line * tokens + token) :
+                    (token * lines + line);
+                chunk.cells.push_back(std::make_pair(index,
+                    result.first->second));
+              });
+        });
+  }
+
+  // The DatasetMapper isn't thread-safe, so the mapping itself is serial, but
+  // it only sees each distinct token of each chunk once.  The policy's answers
+  // only depend on the token once the first pass is done, and the chunks are
+  // visited in order, so the mappings are the same as with a serial parse.
+  std::string str;
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    for (const details::TokenKey& key : chunkTokens[c].distinct)
+    {
+      str.assign(key.begin, key.length);
+      infoSet.template MapFirstPass<T>(str, key.dimension);
+    }
+  }
+
+  std::vector<std::vector<T>> values(numChunks);
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    values[c].resize(chunkTokens[c].distinct.size());
+    for (size_t i = 0; i < chunkTokens[c].distinct.size(); ++i)
+    {
+      const details::TokenKey& key = chunkTokens[c].distinct[i];
+      str.assign(key.begin, key.length);
+      values[c][i] = infoSet.template MapString<T>(str, key.dimension);
+    }
+  }
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    for (const std::pair<size_t, size_t>& cell : chunkTokens[c].cells)
+      inout[cell.first] = values[c][cell.second];
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
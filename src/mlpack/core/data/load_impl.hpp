@@ -21,6 +21,8 @@
 #include "load_csv.hpp"
 #include "load.hpp"
 #include "extension.hpp"
+#include "compressed_file.hpp"
+#include "columnar_impl.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/tokenizer.hpp>
@@ -85,15 +87,43 @@ bool Load(const std::string& filename,
 {
   Timer::Start("loading_data");
 
-  // Get the extension.
-  std::string extension = Extension(filename);
+  // Get the extension (of the decompressed file, for compressed files).
+  std::string extension = UncompressedExtension(filename);
 
-  // Catch nonexistent files by opening the stream ourselves.
-  std::fstream stream;
+  // Columnar files are memory-mapped, not read through a stream.
+  if (extension == "mlcol")
+  {
+    try
+    {
+      details::LoadColumnar(filename, matrix, (DatasetInfo*) NULL, NULL,
+          transpose);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Loaded '" << filename << "' as mlpack columnar data.  Size "
+        << "is " << (transpose ? matrix.n_cols : matrix.n_rows) << " x "
+        << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
+    Threads::FirstTouch(matrix);
+    Timer::Stop("loading_data");
+    return true;
+  }
+
+  // Catch nonexistent files by opening the stream ourselves.  Compressed files
+  // are decompressed into memory here.
+  InputFileStream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
-  stream.open(filename.c_str(), std::fstream::in | std::fstream::binary);
+  stream.open(filename, std::fstream::in | std::fstream::binary);
 #else
-  stream.open(filename.c_str(), std::fstream::in);
+  stream.open(filename, std::fstream::in);
 #endif
   if (!stream.is_open())
   {
@@ -220,6 +250,20 @@ bool Load(const std::string& filename,
            extension == "he5")
   {
 #ifdef ARMA_USE_HDF5
+    // Armadillo reads HDF5 files by name, so they can't be decompressed first.
+    if (IsCompressed(filename))
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "Cannot load '" << filename << "': compressed HDF5 files "
+            << "are not supported." << std::endl;
+      else
+        Log::Warn << "Cannot load '" << filename << "': compressed HDF5 files "
+            << "are not supported." << std::endl;
+
+      return false;
+    }
+
     loadType = arma::hdf5_binary;
     stringType = "HDF5 data";
 #else
@@ -293,6 +337,10 @@ bool Load(const std::string& filename,
     inplace_transpose(matrix);
   }
 
+  // Place the columns on the NUMA nodes of the threads that will use them.
+  if (success)
+    Threads::FirstTouch(matrix);
+
   Timer::Stop("loading_data");
 
   // Finally, return the success indicator.
@@ -310,8 +358,8 @@ bool Load(const std::string& filename,
   // Get the extension and load as necessary.
   Timer::Start("loading_data");
 
-  // Get the extension.
-  std::string extension = Extension(filename);
+  // Get the extension (of the decompressed file, for compressed files).
+  std::string extension = UncompressedExtension(filename);
 
   // Catch nonexistent files by opening the stream ourselves.
   std::fstream stream;
@@ -348,6 +396,25 @@ bool Load(const std::string& filename,
       return false;
     }
   }
+  else if (extension == "mlcol")
+  {
+    Log::Info << "Loading '" << filename << "' as mlpack columnar dataset.  "
+        << std::flush;
+    try
+    {
+      details::LoadColumnarInfo(filename, matrix, info, transpose);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+  }
   else if (extension == "arff")
   {
     Log::Info << "Loading '" << filename << "' as ARFF dataset.  "
@@ -388,11 +455,58 @@ bool Load(const std::string& filename,
   Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
       << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
 
+  Threads::FirstTouch(matrix);
   Timer::Stop("loading_data");
 
   return true;
 }
 
+template<typename eT>
+bool LoadDimensions(const std::string& filename,
+                    arma::Mat<eT>& matrix,
+                    DatasetInfo& info,
+                    const std::vector<size_t>& dimensions,
+                    const bool fatal,
+                    const bool transpose)
+{
+  Timer::Start("loading_data");
+
+  if (Extension(filename) != "mlcol")
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Cannot load dimensions of '" << filename << "': only "
+          << "mlpack columnar (.mlcol) files are supported." << std::endl;
+    else
+      Log::Warn << "Cannot load dimensions of '" << filename << "': only "
+          << "mlpack columnar (.mlcol) files are supported." << std::endl;
+
+    return false;
+  }
+
+  try
+  {
+    details::LoadColumnar(filename, matrix, &info, &dimensions, transpose);
+  }
+  catch (std::exception& e)
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Loaded " << dimensions.size() << " dimensions of '"
+      << filename << "'.  Size is " << (transpose ? matrix.n_cols :
+      matrix.n_rows) << " x " << (transpose ? matrix.n_rows : matrix.n_cols)
+      << ".\n";
+  Timer::Stop("loading_data");
+  return true;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -0,0 +1,263 @@
+/**
+ * @file load_mapped_impl.hpp
+ *
+ * Implementation of LoadMapped(), which loads binary matrices and vectors
+ * without copying them out of a memory-mapped file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_MAPPED_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_MAPPED_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "load.hpp"
+#include "extension.hpp"
+
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+//! Report a LoadMapped() error, and return false.
+inline bool MappedLoadError(const std::string& message, const bool fatal)
+{
+  Timer::Stop("loading_data");
+  if (fatal)
+    Log::Fatal << message << std::endl;
+  else
+    Log::Warn << message << std::endl;
+
+  return false;
+}
+
+/**
+ * Map the given .bin file and find the matrix in it: after the header for an
+ * Armadillo binary file, or the whole file (as a column) for a raw binary file.
+ * On success, memory points to the first element, and aligned tells whether it
+ * can be used in place.
+ */
+template<typename eT>
+bool MapMatrix(const std::string& filename,
+               MappedFile& file,
+               const char*& memory,
+               size_t& rows,
+               size_t& cols,
+               bool& aligned,
+               const bool fatal)
+{
+  if (Extension(filename) != "bin")
+  {
+    return MappedLoadError("Cannot map '" + filename + "': only Armadillo "
+        "binary and raw binary (.bin) files can be loaded without copying.",
+        fatal);
+  }
+
+  try
+  {
+    file = MappedFile(filename);
+  }
+  catch (std::runtime_error& e)
+  {
+    return MappedLoadError("Cannot load '" + filename + "': " + e.what() +
+        ".", fatal);
+  }
+
+  const std::string prefix = "ARMA_MAT_BIN_";
+  size_t offset = 0;
+  if (file.Size() >= prefix.size() &&
+      std::memcmp(file.Data(), prefix.data(), prefix.size()) == 0)
+  {
+    // Read the header the way Armadillo does: the element type, then the size
+    // (possibly after padding), then exactly one character.
+    std::istringstream stream(std::string(file.Data(),
+        std::min(file.Size(), (size_t) 1024)));
+    std::string header;
+    stream >> header >> rows >> cols;
+    stream.get();
+    if (stream.fail())
+      return MappedLoadError("Corrupt header in '" + filename + "'.", fatal);
+
+    // The elements are used in place, so they can't be converted.
+    if (header != arma::diskio::gen_bin_header(arma::Mat<eT>()))
+    {
+      return MappedLoadError("'" + filename + "' holds elements of a different"
+          " type than the matrix to load into.", fatal);
+    }
+
+    offset = (size_t) stream.tellg();
+    if (rows != 0 && cols > (file.Size() - offset) / sizeof(eT) / rows)
+      return MappedLoadError("'" + filename + "' is truncated.", fatal);
+  }
+  else
+  {
+    // Like Armadillo, load raw binary data as a column.
+    if (file.Size() % sizeof(eT) != 0)
+    {
+      return MappedLoadError("Size of '" + filename + "' is not a multiple of "
+          "the element size.", fatal);
+    }
+
+    rows = file.Size() / sizeof(eT);
+    cols = 1;
+  }
+
+  // The mapping itself starts at a page boundary.
+  memory = file.Data() + offset;
+  aligned = (offset % alignof(eT) == 0);
+  if (!aligned)
+  {
+    Log::Warn << "The elements of '" << filename << "' are not aligned, so "
+        << "they will be copied.  Save the matrix with data::Save() to avoid "
+        << "this." << std::endl;
+  }
+
+  return true;
+}
+
+/**
+ * Point the given matrix or vector at the mapped elements, or copy them if they
+ * are not aligned.
+ */
+template<typename MatType>
+void UseMappedMemory(MatType& matrix,
+                     MappedFile& mapping,
+                     MappedFile& file,
+                     const char* memory,
+                     const size_t rows,
+                     const size_t cols,
+                     const bool aligned)
+{
+  typedef typename MatType::elem_type eT;
+
+  if (aligned)
+  {
+    // A matrix that doesn't use its auxiliary memory strictly can take the
+    // memory over without a copy.
+    arma::Mat<eT> tmp((eT*) memory, rows, cols, false, false);
+    matrix.steal_mem(tmp);
+    mapping = std::move(file);
+  }
+  else
+  {
+    matrix.set_size(rows, cols);
+    std::memcpy(matrix.memptr(), memory, rows * cols * sizeof(eT));
+  }
+}
+
+} // namespace details
+
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Mat<eT>& matrix,
+                MappedFile& mapping,
+                const bool fatal)
+{
+  Timer::Start("loading_data");
+
+  MappedFile file;
+  const char* memory;
+  size_t rows, cols;
+  bool aligned;
+  if (!details::MapMatrix<eT>(filename, file, memory, rows, cols, aligned,
+      fatal))
+  {
+    matrix.clear();
+    return false;
+  }
+
+  details::UseMappedMemory(matrix, mapping, file, memory, rows, cols, aligned);
+
+  Log::Info << "Mapped '" << filename << "'.  Size is " << matrix.n_rows
+      << " x " << matrix.n_cols << ".\n";
+  Timer::Stop("loading_data");
+
+  return true;
+}
+
+// Load a column vector.
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Col<eT>& vec,
+                MappedFile& mapping,
+                const bool fatal)
+{
+  Timer::Start("loading_data");
+
+  MappedFile file;
+  const char* memory;
+  size_t rows, cols;
+  bool aligned;
+  if (!details::MapMatrix<eT>(filename, file, memory, rows, cols, aligned,
+      fatal))
+  {
+    vec.clear();
+    return false;
+  }
+
+  // A row vector has the same elements in the same order.
+  if (rows > 1 && cols > 1)
+  {
+    vec.clear();
+    std::ostringstream oss;
+    oss << "Matrix in file '" << filename << "' is not a vector, but instead "
+        << "has size " << rows << "x" << cols << "!";
+    return details::MappedLoadError(oss.str(), fatal);
+  }
+
+  details::UseMappedMemory(vec, mapping, file, memory, rows * cols, 1,
+      aligned);
+
+  Log::Info << "Mapped '" << filename << "'.  Size is " << vec.n_elem << ".\n";
+  Timer::Stop("loading_data");
+
+  return true;
+}
+
+// Load a row vector.
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Row<eT>& rowvec,
+                MappedFile& mapping,
+                const bool fatal)
+{
+  Timer::Start("loading_data");
+
+  MappedFile file;
+  const char* memory;
+  size_t rows, cols;
+  bool aligned;
+  if (!details::MapMatrix<eT>(filename, file, memory, rows, cols, aligned,
+      fatal))
+  {
+    rowvec.clear();
+    return false;
+  }
+
+  // A column vector has the same elements in the same order.
+  if (rows > 1 && cols > 1)
+  {
+    rowvec.clear();
+    std::ostringstream oss;
+    oss << "Matrix in file '" << filename << "' is not a vector, but instead "
+        << "has size " << rows << "x" << cols << "!";
+    return details::MappedLoadError(oss.str(), fatal);
+  }
+
+  details::UseMappedMemory(rowvec, mapping, file, memory, 1, rows * cols,
+      aligned);
+
+  Log::Info << "Mapped '" << filename << "'.  Size is " << rowvec.n_elem
+      << ".\n";
+  Timer::Stop("loading_data");
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
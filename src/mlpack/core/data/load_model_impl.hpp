@@ -19,6 +19,8 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "extension.hpp"
+#include "compressed_file.hpp"
+#include "model_header.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -99,7 +101,16 @@ bool Load(const std::string& filename,
     }
     else if (f == format::binary)
     {
-      boost::archive::binary_iarchive ar(ifs);
+      // Map the file, so that the archive reads it straight from memory, with
+      // contiguous blocks such as the contents of matrices copied directly
+      // into place.
+      ifs.close();
+      MappedFile file(filename);
+      const size_t offset = details::ReadModelHeader(file.Data(), file.Size(),
+          filename);
+      MemoryStreamBuf buffer(file.Data() + offset, file.Size() - offset);
+      std::istream stream(&buffer);
+      boost::archive::binary_iarchive ar(stream);
       ar >> boost::serialization::make_nvp(name.c_str(), t);
     }
 
@@ -114,6 +125,15 @@ bool Load(const std::string& filename,
 
     return false;
   }
+  catch (std::runtime_error& e)
+  {
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
 }
 
 } // namespace data
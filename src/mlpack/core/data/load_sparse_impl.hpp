@@ -0,0 +1,414 @@
+/**
+ * @file load_sparse_impl.hpp
+ *
+ * Implementation of Load() for sparse matrices and of LoadLibSVM(), which parse
+ * coordinate lists and libsvm / svmlight files in parallel from a memory map.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_SPARSE_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_SPARSE_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "load.hpp"
+#include "extension.hpp"
+#include "mapped_lines.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+/**
+ * The nonzeros found in one chunk of the lines of a sparse text file.  For
+ * libsvm files, the columns are the indices of the points within the chunk.
+ */
+template<typename eT>
+struct SparseChunk
+{
+  SparseChunk() : points(0), rows(0), cols(0), failed(false), errorLine(0) { }
+
+  //! The row of each nonzero.
+  std::vector<arma::uword> rowIndices;
+  //! The column of each nonzero.
+  std::vector<arma::uword> colIndices;
+  //! The value of each nonzero.
+  std::vector<eT> values;
+  //! The label of each point (libsvm files only).
+  std::vector<double> labels;
+  //! The number of points (libsvm files only).
+  size_t points;
+  //! One more than the largest row index.
+  size_t rows;
+  //! One more than the largest column index.
+  size_t cols;
+  //! Whether a line couldn't be parsed.
+  bool failed;
+  //! The line of the chunk that couldn't be parsed.
+  size_t errorLine;
+};
+
+//! Parse an unsigned integer that starts at p, and advance p past it.
+inline bool ParseSparseIndex(const char*& p,
+                             const char* end,
+                             arma::uword& index)
+{
+  if (p == end || *p < '0' || *p > '9')
+    return false;
+
+  char* next;
+  errno = 0;
+  const unsigned long long value = std::strtoull(p, &next, 10);
+  if (errno == ERANGE || next > end ||
+      value > (unsigned long long) std::numeric_limits<arma::uword>::max())
+    return false;
+
+  index = (arma::uword) value;
+  p = next;
+  return true;
+}
+
+//! Parse a number that starts at p, and advance p past it.
+inline bool ParseSparseValue(const char*& p, const char* end, double& value)
+{
+  // strtod() would skip whitespace, possibly past the end of the line.
+  if (p == end || IsCSVSpace(*p))
+    return false;
+
+  char* next;
+  value = std::strtod(p, &next);
+  if (next == p || next > end)
+    return false;
+
+  p = next;
+  return true;
+}
+
+//! Return whether p is at the end of a token, and skip the whitespace after it.
+inline bool SkipSparseSpace(const char*& p, const char* end)
+{
+  if (p != end && !IsCSVSpace(*p))
+    return false;
+
+  while (p != end && IsCSVSpace(*p))
+    ++p;
+  return true;
+}
+
+/**
+ * Parse a (trimmed) line of a coordinate list: the row, the column and the
+ * value of a nonzero.  Empty lines and comments are skipped.
+ */
+template<typename eT>
+bool ParseCoordinateLine(const char* p,
+                         const char* end,
+                         SparseChunk<eT>& chunk)
+{
+  if (p == end || *p == '#' || *p == '%')
+    return true;
+
+  arma::uword row, col;
+  double value;
+  if (!ParseSparseIndex(p, end, row) || !SkipSparseSpace(p, end) ||
+      !ParseSparseIndex(p, end, col) || !SkipSparseSpace(p, end) ||
+      !ParseSparseValue(p, end, value) || p != end)
+    return false;
+
+  chunk.rowIndices.push_back(row);
+  chunk.colIndices.push_back(col);
+  chunk.values.push_back(eT(value));
+  chunk.rows = std::max(chunk.rows, (size_t) row + 1);
+  chunk.cols = std::max(chunk.cols, (size_t) col + 1);
+  return true;
+}
+
+/**
+ * Parse a (trimmed) line of a libsvm file: the label of a point, and then its
+ * nonzeros as index:value pairs.  Comments, empty lines and qid:... tokens are
+ * skipped.
+ */
+template<typename eT>
+bool ParseLibSVMLine(const char* p, const char* end, SparseChunk<eT>& chunk)
+{
+  const char* comment = (const char*) std::memchr(p, '#', end - p);
+  if (comment != NULL)
+  {
+    end = comment;
+    TrimRange(p, end);
+  }
+
+  if (p == end)
+    return true;
+
+  double label;
+  if (!ParseSparseValue(p, end, label) || !SkipSparseSpace(p, end))
+    return false;
+
+  const arma::uword point = chunk.points++;
+  chunk.labels.push_back(label);
+  while (p != end)
+  {
+    if (end - p >= 4 && std::strncmp(p, "qid:", 4) == 0)
+    {
+      while (p != end && !IsCSVSpace(*p))
+        ++p;
+      SkipSparseSpace(p, end);
+      continue;
+    }
+
+    arma::uword index;
+    double value;
+    if (!ParseSparseIndex(p, end, index) || index == 0 || p == end ||
+        *p != ':')
+      return false;
+
+    ++p;
+    if (!ParseSparseValue(p, end, value) || !SkipSparseSpace(p, end))
+      return false;
+
+    chunk.rowIndices.push_back(index - 1);
+    chunk.colIndices.push_back(point);
+    chunk.values.push_back(eT(value));
+    chunk.rows = std::max(chunk.rows, (size_t) index);
+  }
+
+  return true;
+}
+
+/**
+ * Map the given file and parse its lines with the given function, in parallel
+ * over chunks of lines.
+ */
+template<typename eT, typename LineFunctionType>
+bool ParseSparseFile(const std::string& filename,
+                     std::vector<SparseChunk<eT>>& chunks,
+                     LineFunctionType parseLine,
+                     const bool fatal)
+{
+  MappedFile file;
+  try
+  {
+    file = MappedFile(filename);
+  }
+  catch (std::runtime_error& e)
+  {
+    return MappedLoadError("Cannot load '" + filename + "': " + e.what() +
+        ".", fatal);
+  }
+
+  const char* data = file.Data();
+  const size_t size = file.Size();
+  const std::string lastLine = UnterminatedLastLine(data, size);
+  const std::vector<size_t> chunkStart = LineChunks(data, size);
+  const size_t numChunks = chunkStart.size() - 1;
+
+  chunks.clear();
+  chunks.resize(numChunks);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    SparseChunk<eT>& chunk = chunks[c];
+    ForEachLine(data + chunkStart[c], data + chunkStart[c + 1], 0, lastLine,
+        [&](const size_t line, const char* begin, const char* end)
+        {
+          if (!chunk.failed && !parseLine(begin, end, chunk))
+          {
+            chunk.failed = true;
+            chunk.errorLine = line;
+          }
+        });
+  }
+
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    if (chunks[c].failed)
+    {
+      const size_t line = std::count(data, data + chunkStart[c], '\n') +
+          chunks[c].errorLine + 1;
+      std::ostringstream oss;
+      oss << "Cannot parse line " << line << " of '" << filename << "'.";
+      return MappedLoadError(oss.str(), fatal);
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Build a sparse matrix from the nonzeros of the given chunks, which are freed
+ * on the way.  If libsvm is true, the columns are the indices of the points in
+ * each chunk; if transpose is true, the rows and columns are swapped.
+ */
+template<typename eT>
+bool BuildSparseMatrix(const std::string& filename,
+                       std::vector<SparseChunk<eT>>& chunks,
+                       arma::SpMat<eT>& matrix,
+                       const bool libsvm,
+                       const bool transpose,
+                       const bool fatal)
+{
+  const size_t numChunks = chunks.size();
+  std::vector<size_t> nonzeroStart(numChunks + 1, 0);
+  std::vector<size_t> pointStart(numChunks + 1, 0);
+  size_t rows = 0, cols = 0;
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    nonzeroStart[c + 1] = nonzeroStart[c] + chunks[c].values.size();
+    pointStart[c + 1] = pointStart[c] + chunks[c].points;
+    rows = std::max(rows, chunks[c].rows);
+    cols = std::max(cols, chunks[c].cols);
+  }
+  if (libsvm)
+    cols = pointStart[numChunks];
+
+  arma::umat locations(2, nonzeroStart[numChunks]);
+  arma::Col<eT> values(nonzeroStart[numChunks]);
+  const size_t rowLocation = transpose ? 1 : 0;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    SparseChunk<eT>& chunk = chunks[c];
+    const arma::uword colOffset = libsvm ? pointStart[c] : 0;
+    for (size_t i = 0; i < chunk.values.size(); ++i)
+    {
+      const size_t nonzero = nonzeroStart[c] + i;
+      locations(rowLocation, nonzero) = chunk.rowIndices[i];
+      locations(1 - rowLocation, nonzero) = chunk.colIndices[i] + colOffset;
+      values[nonzero] = chunk.values[i];
+    }
+
+    std::vector<arma::uword>().swap(chunk.rowIndices);
+    std::vector<arma::uword>().swap(chunk.colIndices);
+    std::vector<eT>().swap(chunk.values);
+  }
+
+  try
+  {
+    matrix = arma::SpMat<eT>(locations, values, transpose ? cols : rows,
+        transpose ? rows : cols);
+  }
+  catch (std::exception& e)
+  {
+    matrix.reset();
+    return MappedLoadError("Cannot load '" + filename + "': " + e.what(),
+        fatal);
+  }
+
+  return true;
+}
+
+} // namespace details
+
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::SpMat<eT>& matrix,
+          const bool fatal,
+          const bool transpose)
+{
+  Timer::Start("loading_data");
+
+  const std::string extension = UncompressedExtension(filename);
+  std::string stringType;
+  bool success;
+  if (extension == "coo")
+  {
+    stringType = "coordinate list";
+    std::vector<details::SparseChunk<eT>> chunks;
+    success = details::ParseSparseFile(filename, chunks,
+        details::ParseCoordinateLine<eT>, fatal) &&
+        details::BuildSparseMatrix(filename, chunks, matrix, false, transpose,
+        fatal);
+  }
+  else if (extension == "svm" || extension == "libsvm" ||
+      extension == "svmlight")
+  {
+    stringType = "libsvm data";
+    std::vector<details::SparseChunk<eT>> chunks;
+    success = details::ParseSparseFile(filename, chunks,
+        details::ParseLibSVMLine<eT>, fatal) &&
+        details::BuildSparseMatrix(filename, chunks, matrix, true, false,
+        fatal);
+  }
+  else if (extension == "bin")
+  {
+    stringType = "Armadillo binary formatted data";
+    success = matrix.quiet_load(filename, arma::arma_binary);
+    if (!success)
+    {
+      matrix.reset();
+      return details::MappedLoadError("Loading from '" + filename +
+          "' failed.", fatal);
+    }
+
+    if (transpose)
+      matrix = matrix.t();
+  }
+  else
+  {
+    return details::MappedLoadError("Unable to determine format to load from "
+        "extension '" + extension + "' of '" + filename + "'.  Sparse matrices "
+        "can be loaded from .coo, .svm, .libsvm, .svmlight and .bin files.",
+        fatal);
+  }
+
+  if (!success)
+    return false;
+
+  Log::Info << "Loaded '" << filename << "' as " << stringType << ".  Size is "
+      << matrix.n_rows << " x " << matrix.n_cols << ", with "
+      << matrix.n_nonzero << " nonzeros.\n";
+  Timer::Stop("loading_data");
+
+  return true;
+}
+
+template<typename eT, typename LabelType>
+bool LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::Row<LabelType>& labels,
+                const bool fatal)
+{
+  Timer::Start("loading_data");
+
+  std::vector<details::SparseChunk<eT>> chunks;
+  if (!details::ParseSparseFile(filename, chunks,
+      details::ParseLibSVMLine<eT>, fatal))
+  {
+    matrix.reset();
+    labels.clear();
+    return false;
+  }
+
+  std::vector<size_t> pointStart(chunks.size() + 1, 0);
+  for (size_t c = 0; c < chunks.size(); ++c)
+    pointStart[c + 1] = pointStart[c] + chunks[c].points;
+
+  labels.set_size(pointStart[chunks.size()]);
+  for (size_t c = 0; c < chunks.size(); ++c)
+    for (size_t i = 0; i < chunks[c].points; ++i)
+      labels[pointStart[c] + i] = (LabelType) chunks[c].labels[i];
+
+  if (!details::BuildSparseMatrix(filename, chunks, matrix, true, false,
+      fatal))
+  {
+    labels.clear();
+    return false;
+  }
+
+  Log::Info << "Loaded '" << filename << "' as libsvm data.  Size is "
+      << matrix.n_rows << " x " << matrix.n_cols << ", with "
+      << matrix.n_nonzero << " nonzeros.\n";
+  Timer::Stop("loading_data");
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -109,37 +109,29 @@ class IncrementPolicy
       // Otherwise, we must map.
     }
 
-    // If this condition is true, either we have no mapping for the given input
-    // or we have no mappings for the given dimension at all.  In either case,
-    // we create a mapping.
-    if (maps.count(dimension) == 0 ||
-        maps[dimension].first.count(input) == 0)
+    // Look up the maps of this dimension only once, and the input only once if
+    // it is already mapped.
+    typename MapType::mapped_type& dimensionMaps = maps[dimension];
+    const typename MapType::mapped_type::first_type::const_iterator it =
+        dimensionMaps.first.find(input);
+    if (it != dimensionMaps.first.end())
     {
-      // This input does not exist yet.
-      size_t numMappings = maps[dimension].first.size();
+      // This input already exists in the mapping.
+      return it->second;
+    }
 
-      // Change type of the feature to categorical.
-      if (numMappings == 0)
-        types[dimension] = Datatype::categorical;
+    // This input does not exist yet, so we create a mapping.
+    const size_t numMappings = dimensionMaps.first.size();
 
-      typedef typename std::pair<InputType, MappedType> PairType;
-      maps[dimension].first.insert(PairType(input, numMappings));
+    // Change type of the feature to categorical.
+    if (numMappings == 0)
+      types[dimension] = Datatype::categorical;
 
-      // Do we need to create the second map?
-      if (maps[dimension].second.count(numMappings) == 0)
-      {
-        maps[dimension].second.insert(std::make_pair(numMappings,
-            std::vector<InputType>()));
-      }
-      maps[dimension].second[numMappings].push_back(input);
+    typedef typename std::pair<InputType, MappedType> PairType;
+    dimensionMaps.first.insert(PairType(input, numMappings));
+    dimensionMaps.second[numMappings].push_back(input);
 
-      return T(numMappings);
-    }
-    else
-    {
-      // This input already exists in the mapping.
-      return maps[dimension].first.at(input);
-    }
+    return T(numMappings);
   }
 
  private:
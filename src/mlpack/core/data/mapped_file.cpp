@@ -0,0 +1,141 @@
+/**
+ * @file mapped_file.cpp
+ *
+ * Implementation of the MappedFile class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_file.hpp"
+#include "compressed_file.hpp"
+#include "extension.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+MappedFile::MappedFile() : data(NULL), size(0)
+{
+  /* Nothing to do here. */
+}
+
+MappedFile::MappedFile(const std::string& filename) : data(NULL), size(0)
+{
+  if (IsCompressed(filename))
+  {
+    Decompress(filename, buffer);
+    size = buffer.size();
+    data = (size > 0) ? buffer.data() : NULL;
+    return;
+  }
+
+#ifndef _WIN32
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("cannot open file '" + filename + "'");
+
+  struct stat info;
+  if (fstat(fd, &info) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("cannot determine size of file '" + filename +
+        "'");
+  }
+
+  size = (size_t) info.st_size;
+  if (size > 0)
+  {
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+        0);
+    if (memory == MAP_FAILED)
+    {
+      close(fd);
+      size = 0;
+      throw std::runtime_error("cannot map file '" + filename + "'");
+    }
+
+    data = (char*) memory;
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+#else
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+    throw std::runtime_error("cannot open file '" + filename + "'");
+
+  stream.seekg(0, std::ios::end);
+  size = (size_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+
+  if (size > 0)
+  {
+    data = new char[size];
+    if (!stream.read(data, size))
+    {
+      Release();
+      throw std::runtime_error("cannot read file '" + filename + "'");
+    }
+  }
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) :
+    data(other.data),
+    size(other.size),
+    buffer(std::move(other.buffer))
+{
+  other.data = NULL;
+  other.size = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+  if (this != &other)
+  {
+    Release();
+
+    data = other.data;
+    size = other.size;
+    buffer = std::move(other.buffer);
+    other.data = NULL;
+    other.size = 0;
+  }
+
+  return *this;
+}
+
+MappedFile::~MappedFile()
+{
+  Release();
+}
+
+void MappedFile::Release()
+{
+  if (!buffer.empty())
+  {
+    std::vector<char>().swap(buffer);
+  }
+  else if (data != NULL)
+  {
+#ifndef _WIN32
+    munmap(data, size);
+#else
+    delete[] data;
+#endif
+  }
+
+  data = NULL;
+  size = 0;
+}
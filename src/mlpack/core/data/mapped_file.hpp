@@ -0,0 +1,78 @@
+/**
+ * @file mapped_file.hpp
+ *
+ * Definition of the MappedFile class, a read-only view of a file that is
+ * mapped into memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mlpack {
+namespace data /** Functions to load and save matrices and models. */ {
+
+/**
+ * A file that is mapped into memory.  The mapping is private: the pages are
+ * shared with the page cache (and every other process that maps the same
+ * file) until they are written to, and writes are never carried through to the
+ * file.  On systems without mmap() the file is read into memory instead, and
+ * compressed files (see IsCompressed()) are decompressed into memory.
+ */
+class MappedFile
+{
+ public:
+  //! Create an empty mapping.
+  MappedFile();
+
+  /**
+   * Map the given file into memory.  A std::runtime_error is thrown if the
+   * file can't be opened or mapped.
+   *
+   * @param filename Name of the file to map.
+   */
+  MappedFile(const std::string& filename);
+
+  //! Move constructor.
+  MappedFile(MappedFile&& other);
+
+  //! Move assignment operator.
+  MappedFile& operator=(MappedFile&& other);
+
+  //! Unmap the file.
+  ~MappedFile();
+
+  //! Get the start of the mapped memory.
+  char* Data() const { return data; }
+  //! Get the size of the mapped memory in bytes.
+  size_t Size() const { return size; }
+
+ private:
+  // A mapping can't be copied.
+  MappedFile(const MappedFile& other);
+  MappedFile& operator=(const MappedFile& other);
+
+  //! Release the mapping.
+  void Release();
+
+  //! The start of the mapped memory.
+  char* data;
+
+  //! The size of the mapped memory in bytes.
+  size_t size;
+
+  //! The decompressed contents of a compressed file.
+  std::vector<char> buffer;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
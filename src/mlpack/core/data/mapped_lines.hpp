@@ -0,0 +1,128 @@
+/**
+ * @file mapped_lines.hpp
+ *
+ * Utilities for splitting a memory-mapped text file into lines, and into
+ * chunks of lines that can be parsed in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_LINES_HPP
+#define MLPACK_CORE_DATA_MAPPED_LINES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <cstring>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+//! Return whether a character is removed by boost::trim().
+inline bool IsCSVSpace(const char c)
+{
+  return (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+      c == '\r');
+}
+
+//! Remove the characters boost::trim() removes from either side of a range.
+inline void TrimRange(const char*& begin, const char*& end)
+{
+  while (begin != end && IsCSVSpace(*begin))
+    ++begin;
+  while (end != begin && IsCSVSpace(*(end - 1)))
+    --end;
+}
+
+/**
+ * Call f(line, begin, end) for each line of [begin, end), given the index of
+ * the first line, with the whitespace around each line removed.  If
+ * lastLine isn't empty, it is used instead of the unterminated line at the end
+ * of the range.
+ */
+template<typename FunctionType>
+void ForEachLine(const char* begin,
+                 const char* end,
+                 size_t line,
+                 const std::string& lastLine,
+                 FunctionType&& f)
+{
+  const char* p = begin;
+  while (p < end)
+  {
+    const char* lineBegin = p;
+    const char* lineEnd = (const char*) std::memchr(p, '\n', end - p);
+    if (lineEnd == NULL)
+    {
+      lineEnd = end;
+      if (!lastLine.empty())
+      {
+        lineBegin = lastLine.data();
+        lineEnd = lineBegin + lastLine.size();
+      }
+      p = end;
+    }
+    else
+    {
+      p = lineEnd + 1;
+    }
+
+    TrimRange(lineBegin, lineEnd);
+
+    f(line++, lineBegin, lineEnd);
+  }
+}
+
+/**
+ * Return a copy of the last line of a mapped file if it isn't terminated by a
+ * newline, and an empty string otherwise.  The number parsers may look at the
+ * character after a token, so ForEachLine() parses that copy instead.
+ */
+inline std::string UnterminatedLastLine(const char* data, const size_t size)
+{
+  if (size == 0 || data[size - 1] == '\n')
+    return std::string();
+
+  size_t lastLineStart = size;
+  while (lastLineStart > 0 && data[lastLineStart - 1] != '\n')
+    --lastLineStart;
+  return std::string(data + lastLineStart, data + size);
+}
+
+/**
+ * Split a mapped file into chunks that start at the beginning of a line, and
+ * return the offsets of the chunks (with the size of the file last).  There are
+ * several chunks for each thread, so that uneven lines still balance.
+ */
+inline std::vector<size_t> LineChunks(const char* data, const size_t size)
+{
+  #ifdef HAS_OPENMP
+    const size_t threads = (size_t) omp_get_max_threads();
+  #else
+    const size_t threads = 1;
+  #endif
+  const size_t numChunks = std::min(4 * threads, size / 4096 + 1);
+  std::vector<size_t> chunkStart(numChunks + 1, size);
+  chunkStart[0] = 0;
+  for (size_t c = 1; c < numChunks; ++c)
+  {
+    const size_t start = std::max(c * (size / numChunks), chunkStart[c - 1]);
+    const char* newline = (const char*) std::memchr(data + start, '\n',
+        size - start);
+    chunkStart[c] = (newline == NULL) ? size : (newline - data) + 1;
+  }
+
+  return chunkStart;
+}
+
+} // namespace details
+} // namespace data
+} // namespace mlpack
+
+#endif
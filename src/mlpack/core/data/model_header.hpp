@@ -0,0 +1,118 @@
+/**
+ * @file model_header.hpp
+ *
+ * The header that data::Save() writes before binary models, so that
+ * data::Load() can check that a binary model was saved on a compatible
+ * platform before handing it to boost::serialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MODEL_HEADER_HPP
+#define MLPACK_CORE_DATA_MODEL_HEADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+/**
+ * The header of binary models.  Binary boost::serialization archives store
+ * integers and floating-point numbers in the native format, so a model can
+ * only be loaded on a platform with the same byte order and integer sizes.
+ */
+struct ModelHeader
+{
+  //! The magic string, "MLPKMODL".
+  char magic[8];
+  //! The version of the header.
+  uint32_t version;
+  //! 0x01020304, in the byte order of the platform.
+  uint32_t byteOrder;
+  //! sizeof(size_t) on the platform.
+  uint32_t sizeTSize;
+  //! sizeof(arma::uword) on the platform.
+  uint32_t uwordSize;
+};
+
+//! The magic string at the start of binary models.
+const char modelMagic[8] = { 'M', 'L', 'P', 'K', 'M', 'O', 'D', 'L' };
+//! The current version of the header of binary models.
+const uint32_t modelHeaderVersion = 1;
+
+//! Return the header for binary models saved on this platform.
+inline ModelHeader CurrentModelHeader()
+{
+  ModelHeader header;
+  std::memcpy(header.magic, modelMagic, sizeof(modelMagic));
+  header.version = modelHeaderVersion;
+  header.byteOrder = 0x01020304;
+  header.sizeTSize = sizeof(size_t);
+  header.uwordSize = sizeof(arma::uword);
+  return header;
+}
+
+//! Write the header of a binary model to the given stream.
+inline void WriteModelHeader(std::ostream& stream)
+{
+  const ModelHeader header = CurrentModelHeader();
+  stream.write((const char*) &header, sizeof(ModelHeader));
+}
+
+/**
+ * Check the header at the start of the given binary model, and return its
+ * size, so that the archive starts after it.  Models saved without a header
+ * (by older versions of mlpack) are accepted as they are, and 0 is returned.
+ * A std::runtime_error is thrown if the model was saved by a newer version of
+ * mlpack or on an incompatible platform.
+ */
+inline size_t ReadModelHeader(const char* data,
+                              const size_t size,
+                              const std::string& filename)
+{
+  if (size < sizeof(ModelHeader) ||
+      std::memcmp(data, modelMagic, sizeof(modelMagic)) != 0)
+    return 0;
+
+  ModelHeader header;
+  std::memcpy(&header, data, sizeof(ModelHeader));
+  const ModelHeader current = CurrentModelHeader();
+  if (header.version > modelHeaderVersion)
+  {
+    throw std::runtime_error("Cannot load '" + filename + "': it was saved by "
+        "a newer version of mlpack.");
+  }
+
+  if (header.byteOrder != current.byteOrder)
+  {
+    throw std::runtime_error("Cannot load '" + filename + "': it was saved on "
+        "a platform with a different byte order; use an XML or text model to "
+        "move models between platforms.");
+  }
+
+  if (header.sizeTSize != current.sizeTSize ||
+      header.uwordSize != current.uwordSize)
+  {
+    std::ostringstream oss;
+    oss << "Cannot load '" << filename << "': it was saved on a platform with "
+        << "different integer sizes (" << (8 * header.sizeTSize) << "-bit "
+        << "size_t and " << (8 * header.uwordSize) << "-bit arma::uword); use "
+        << "an XML or text model to move models between platforms.";
+    throw std::runtime_error(oss.str());
+  }
+
+  return sizeof(ModelHeader);
+}
+
+} // namespace details
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -19,6 +19,7 @@
 #include <string>
 
 #include "format.hpp"
+#include "dataset_mapper.hpp"
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices. */ {
@@ -38,6 +39,8 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5 (hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
+ *  - mlpack columnar, denoted by .mlcol (see the overload that takes a
+ *    DatasetInfo)
  *
  * If the file extension is not one of those types, an error will be given.  If
  * the 'fatal' parameter is set to true, a std::runtime_error exception will be
@@ -58,6 +61,37 @@ bool Save(const std::string& filename,
           const bool fatal = false,
           bool transpose = true);
 
+/**
+ * Saves a matrix and the types and mappings of its dimensions.  The mappings
+ * are only kept in mlpack's columnar binary format, denoted by .mlcol; with
+ * other extensions, this is the same as the overload without a DatasetInfo, so
+ * categorical dimensions are saved as their mapped values.
+ *
+ * A columnar file stores each dimension (each row of the matrix, or each
+ * column if 'transpose' is false) contiguously, with its type and, for
+ * categorical dimensions, its mappings.  data::Load() gives back the same
+ * matrix and DatasetInfo without parsing or mapping anything, and
+ * data::LoadDimensions() can load only some of the dimensions.  The values are
+ * stored in the native byte order, so the files should not be moved between
+ * machines of different endianness.
+ *
+ * If the 'fatal' parameter is set to true, a std::runtime_error exception will
+ * be thrown upon failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Matrix to save into file.
+ * @param info Types and mappings of the dimensions of the matrix.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param transpose If true, the dimensions are the rows of the matrix.
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT>
+bool Save(const std::string& filename,
+          const arma::Mat<eT>& matrix,
+          const DatasetInfo& info,
+          const bool fatal = false,
+          bool transpose = true);
+
 /**
  * Saves a model to file, guessing the filetype from the extension, or,
  * optionally, saving the specified format.  If automatic extension detection is
@@ -75,6 +109,10 @@ bool Save(const std::string& filename,
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
+ * Binary models start with a small header that records the byte order and
+ * integer sizes of the platform, so that Load() can reject models from
+ * incompatible platforms with a clear error instead of misreading them.
+ *
  * The name parameter should be specified to indicate the name of the structure
  * to be saved.  If Load() is later called on the generated file, the name used
  * to load should be the same as the name used for this call to Save().
@@ -90,10 +128,65 @@ bool Save(const std::string& filename,
           const bool fatal = false,
           format f = format::autodetect);
 
+/**
+ * Save a sparse matrix to a file, guessing the format from the extension.  The
+ * supported formats are:
+ *
+ *  - coordinate lists, denoted by .coo: one nonzero per line, as the row, the
+ *    column and the value, with zero-based indices (like Armadillo's
+ *    coord_ascii format).
+ *  - Armadillo binary (arma_binary), denoted by .bin.
+ *
+ * Use SaveLibSVM() to save a libsvm / svmlight file.  The lines of coordinate
+ * lists are formatted in parallel, and with enough digits that loading the
+ * file with Load() gives the same values.  As with the other Save() overloads,
+ * the matrix is transposed by default, so the first index of each nonzero is
+ * its column (the point) and the second its row (the dimension).
+ *
+ * Like Load() for sparse matrices, this is only available from C++; the
+ * bindings have no sparse matrix parameters.
+ *
+ * If the 'fatal' parameter is set to true, a std::runtime_error exception will
+ * be thrown upon failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Sparse matrix to save into file.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param transpose If true, transpose the matrix before saving.
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT>
+bool Save(const std::string& filename,
+          const arma::SpMat<eT>& matrix,
+          const bool fatal = false,
+          const bool transpose = true);
+
+/**
+ * Save a sparse matrix and its labels to a libsvm / svmlight file: one line for
+ * each column, with its label and then its nonzeros as index:value pairs with
+ * one-based indices.  The lines are formatted in parallel.
+ *
+ * If the 'fatal' parameter is set to true, a std::runtime_error exception will
+ * be thrown upon failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Sparse matrix with the points to save.
+ * @param labels Labels of the points.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT, typename LabelType>
+bool SaveLibSVM(const std::string& filename,
+                const arma::SpMat<eT>& matrix,
+                const arma::Row<LabelType>& labels,
+                const bool fatal = false);
+
 } // namespace data
 } // namespace mlpack
 
 // Include implementation.
 #include "save_impl.hpp"
+// Include implementation of Save() for sparse matrices.
+#include "save_sparse_impl.hpp"
 
 #endif
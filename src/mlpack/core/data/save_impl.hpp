@@ -15,6 +15,8 @@
 // In case it hasn't already been included.
 #include "save.hpp"
 #include "extension.hpp"
+#include "columnar_impl.hpp"
+#include "model_header.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -23,6 +25,33 @@
 
 namespace mlpack {
 namespace data {
+namespace details {
+
+/**
+ * Save a matrix to a stream.  Armadillo binary files get spaces after the
+ * element type, which Armadillo skips when loading, so that the elements start
+ * at a multiple of 64 bytes; then LoadMapped() can use them in place.
+ */
+template<typename eT>
+bool SaveMatrix(const arma::Mat<eT>& matrix,
+                std::fstream& stream,
+                const arma::file_type saveType)
+{
+  if (saveType != arma::arma_binary)
+    return matrix.quiet_save(stream, saveType);
+
+  std::ostringstream size;
+  size << matrix.n_rows << ' ' << matrix.n_cols << '\n';
+  std::string header = arma::diskio::gen_bin_header(matrix) + '\n';
+  const size_t length = header.size() + size.str().size();
+  header += std::string((64 - length % 64) % 64, ' ') + size.str();
+
+  stream.write(header.data(), header.size());
+  stream.write((const char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+  return stream.good();
+}
+
+} // namespace details
 
 template<typename eT>
 bool Save(const std::string& filename,
@@ -64,6 +93,15 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // Columnar files are written by the overload that takes the mappings; here
+  // all the dimensions are numeric.
+  if (extension == "mlcol")
+  {
+    Timer::Stop("saving_data");
+    return Save(filename, matrix, DatasetInfo(transpose ? matrix.n_rows :
+        matrix.n_cols), fatal, transpose);
+  }
+
   // Catch errors opening the file.
   std::fstream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
@@ -161,7 +199,7 @@ bool Save(const std::string& filename,
     // We can't save with streams for HDF5.
     const bool success = (saveType == arma::hdf5_binary) ?
         tmp.quiet_save(filename, saveType) :
-        tmp.quiet_save(stream, saveType);
+        details::SaveMatrix(tmp, stream, saveType);
     if (!success)
     {
       Timer::Stop("saving_data");
@@ -178,7 +216,7 @@ bool Save(const std::string& filename,
     // We can't save with streams for HDF5.
     const bool success = (saveType == arma::hdf5_binary) ?
         matrix.quiet_save(filename, saveType) :
-        matrix.quiet_save(stream, saveType);
+        details::SaveMatrix(matrix, stream, saveType);
     if (!success)
     {
       Timer::Stop("saving_data");
@@ -197,6 +235,40 @@ bool Save(const std::string& filename,
   return true;
 }
 
+template<typename eT>
+bool Save(const std::string& filename,
+          const arma::Mat<eT>& matrix,
+          const DatasetInfo& info,
+          const bool fatal,
+          bool transpose)
+{
+  // Only columnar files can hold the mappings; in other formats, categorical
+  // dimensions are saved as their mapped values.
+  if (Extension(filename) != "mlcol")
+    return Save(filename, matrix, fatal, transpose);
+
+  Timer::Start("saving_data");
+  Log::Info << "Saving mlpack columnar data to '" << filename << "'."
+      << std::endl;
+  try
+  {
+    details::SaveColumnar(filename, matrix, &info, transpose);
+  }
+  catch (std::exception& e)
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Timer::Stop("saving_data");
+  return true;
+}
+
 //! Save a model to file.
 template<typename T>
 bool Save(const std::string& filename,
@@ -229,8 +301,11 @@ bool Save(const std::string& filename,
     }
   }
 
-  // Open the file to save to.
+  // Open the file to save to.  Large models are written through a large
+  // buffer.
+  std::vector<char> buffer(1 << 20);
   std::ofstream ofs;
+  ofs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
 #ifdef _WIN32
   if (f == format::binary) // Open non-text types in binary mode on Windows.
     ofs.open(filename, std::ofstream::out | std::ofstream::binary);
@@ -266,6 +341,8 @@ bool Save(const std::string& filename,
     }
     else if (f == format::binary)
     {
+      // The header lets Load() check that the platform is compatible.
+      details::WriteModelHeader(ofs);
       boost::archive::binary_oarchive ar(ofs);
       ar << boost::serialization::make_nvp(name.c_str(), t);
     }
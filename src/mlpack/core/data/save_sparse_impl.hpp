@@ -0,0 +1,209 @@
+/**
+ * @file save_sparse_impl.hpp
+ *
+ * Implementation of Save() for sparse matrices and of SaveLibSVM(), which
+ * format the lines of coordinate lists and libsvm / svmlight files in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SAVE_SPARSE_IMPL_HPP
+#define MLPACK_CORE_DATA_SAVE_SPARSE_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "save.hpp"
+#include "extension.hpp"
+
+#include <fstream>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+//! Report an error while saving a sparse matrix, and return false.
+inline bool SparseSaveError(const std::string& message, const bool fatal)
+{
+  Timer::Stop("saving_data");
+  if (fatal)
+    Log::Fatal << message << std::endl;
+  else
+    Log::Warn << message << std::endl;
+
+  return false;
+}
+
+/**
+ * Write the lines for the columns of a sparse matrix to the given stream.
+ * Blocks of columns are formatted in parallel with formatColumns(first, last,
+ * stream), a few blocks for each thread at a time, and written in order.
+ */
+template<typename eT, typename FormatFunctionType>
+bool WriteSparseColumns(std::ofstream& stream,
+                        const arma::SpMat<eT>& matrix,
+                        FormatFunctionType formatColumns)
+{
+  // Make sure that the compressed form of the matrix is up to date before
+  // several threads iterate over it.
+  (void) matrix.begin();
+
+  #ifdef HAS_OPENMP
+    const size_t threads = (size_t) omp_get_max_threads();
+  #else
+    const size_t threads = 1;
+  #endif
+  const size_t blockSize = 1024;
+  std::vector<std::string> blocks(4 * threads);
+  for (size_t first = 0; first < matrix.n_cols;
+       first += blockSize * blocks.size())
+  {
+    const size_t numBlocks = std::min(blocks.size(),
+        (matrix.n_cols - first + blockSize - 1) / blockSize);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = first + b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) matrix.n_cols);
+      std::ostringstream oss;
+      formatColumns(begin, end, oss);
+      blocks[b] = oss.str();
+    }
+
+    for (size_t b = 0; b < numBlocks; ++b)
+      stream.write(blocks[b].data(), blocks[b].size());
+  }
+
+  return stream.good();
+}
+
+} // namespace details
+
+template<typename eT>
+bool Save(const std::string& filename,
+          const arma::SpMat<eT>& matrix,
+          const bool fatal,
+          const bool transpose)
+{
+  Timer::Start("saving_data");
+
+  const std::string extension = Extension(filename);
+  if (extension == "bin")
+  {
+    Log::Info << "Saving Armadillo binary formatted data to '" << filename
+        << "'." << std::endl;
+    const bool success = transpose ?
+        arma::SpMat<eT>(matrix.t()).quiet_save(filename, arma::arma_binary) :
+        matrix.quiet_save(filename, arma::arma_binary);
+    if (!success)
+      return details::SparseSaveError("Save to '" + filename + "' failed.",
+          fatal);
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
+  if (extension != "coo")
+  {
+    return details::SparseSaveError("Unable to determine format to save to "
+        "from filename '" + filename + "'.  Sparse matrices can be saved to "
+        ".coo and .bin files, and with SaveLibSVM() to libsvm files.", fatal);
+  }
+
+  std::ofstream stream(filename.c_str());
+  if (!stream.is_open())
+  {
+    return details::SparseSaveError("Cannot open file '" + filename + "' for "
+        "writing; save failed.", fatal);
+  }
+
+  Log::Info << "Saving coordinate list to '" << filename << "'." << std::endl;
+  bool success = details::WriteSparseColumns(stream, matrix,
+      [&](const size_t first, const size_t last, std::ostringstream& oss)
+      {
+        oss.precision(std::numeric_limits<eT>::max_digits10);
+        typename arma::SpMat<eT>::const_iterator it = matrix.begin_col(first);
+        for (; it != matrix.end_col(last - 1); ++it)
+        {
+          if (transpose)
+            oss << it.col() << ' ' << it.row() << ' ' << (*it) << '\n';
+          else
+            oss << it.row() << ' ' << it.col() << ' ' << (*it) << '\n';
+        }
+      });
+
+  // Like Armadillo, keep the size of the matrix with an explicit zero in the
+  // last position if there is no nonzero there.
+  if (matrix.n_elem > 0 && matrix(matrix.n_rows - 1, matrix.n_cols - 1) == 0)
+  {
+    if (transpose)
+      stream << (matrix.n_cols - 1) << ' ' << (matrix.n_rows - 1) << " 0\n";
+    else
+      stream << (matrix.n_rows - 1) << ' ' << (matrix.n_cols - 1) << " 0\n";
+    success = success && stream.good();
+  }
+
+  if (!success)
+    return details::SparseSaveError("Save to '" + filename + "' failed.",
+        fatal);
+
+  Timer::Stop("saving_data");
+  return true;
+}
+
+template<typename eT, typename LabelType>
+bool SaveLibSVM(const std::string& filename,
+                const arma::SpMat<eT>& matrix,
+                const arma::Row<LabelType>& labels,
+                const bool fatal)
+{
+  Timer::Start("saving_data");
+
+  if (labels.n_elem != matrix.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "Cannot save '" << filename << "': there are " << labels.n_elem
+        << " labels for " << matrix.n_cols << " points.";
+    return details::SparseSaveError(oss.str(), fatal);
+  }
+
+  std::ofstream stream(filename.c_str());
+  if (!stream.is_open())
+  {
+    return details::SparseSaveError("Cannot open file '" + filename + "' for "
+        "writing; save failed.", fatal);
+  }
+
+  Log::Info << "Saving libsvm data to '" << filename << "'." << std::endl;
+  const bool success = details::WriteSparseColumns(stream, matrix,
+      [&](const size_t first, const size_t last, std::ostringstream& oss)
+      {
+        oss.precision(std::max(std::numeric_limits<eT>::max_digits10,
+            std::numeric_limits<LabelType>::max_digits10));
+        typename arma::SpMat<eT>::const_iterator it = matrix.begin_col(first);
+        for (size_t col = first; col < last; ++col)
+        {
+          oss << labels[col];
+          for (; it != matrix.end_col(col); ++it)
+            oss << ' ' << (it.row() + 1) << ':' << (*it);
+          oss << '\n';
+        }
+      });
+
+  if (!success)
+    return details::SparseSaveError("Save to '" + filename + "' failed.",
+        fatal);
+
+  Timer::Stop("saving_data");
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -17,6 +17,97 @@
 
 namespace mlpack {
 namespace data {
+namespace details {
+
+/**
+ * Return the order of the points of a split: the first trainSize indices are
+ * the training points and the rest the test points, each in a random order.
+ * If stratifyData is true, the test set holds the same fraction of the points
+ * of each class (rounded down), so the class proportions are the same in both
+ * sets.
+ */
+template<typename U>
+arma::Col<size_t> SplitOrder(const arma::Row<U>& labels,
+                             const double testRatio,
+                             const bool stratifyData,
+                             size_t& trainSize)
+{
+  const size_t n = labels.n_elem;
+  arma::Col<size_t> order =
+      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, n - 1, n));
+  if (!stratifyData)
+  {
+    trainSize = n - static_cast<size_t>(n * testRatio);
+    return order;
+  }
+
+  // Group the shuffled points by class, and take the test points of each class
+  // off the end of its group.
+  std::stable_sort(order.begin(), order.end(),
+      [&labels](const size_t a, const size_t b)
+      {
+        return labels[a] < labels[b];
+      });
+
+  std::vector<size_t> train, test;
+  size_t begin = 0;
+  while (begin < n)
+  {
+    size_t end = begin + 1;
+    while (end < n && labels[order[end]] == labels[order[begin]])
+      ++end;
+
+    const size_t classTest = static_cast<size_t>((end - begin) * testRatio);
+    train.insert(train.end(), order.begin() + begin,
+        order.begin() + (end - classTest));
+    test.insert(test.end(), order.begin() + (end - classTest),
+        order.begin() + end);
+    begin = end;
+  }
+
+  trainSize = train.size();
+  return arma::join_cols(arma::shuffle(arma::Col<size_t>(train)),
+      arma::shuffle(arma::Col<size_t>(test)));
+}
+
+/**
+ * Move the points of the given split order into place: afterwards, the first
+ * trainSize columns of the input (and elements of the labels, if given) are
+ * the training points.  Only the training points in the test region and the
+ * test points in the training region are moved, by swapping them in pairs in
+ * parallel, so no extra memory is needed; the points are not shuffled within
+ * each set.
+ */
+template<typename T, typename U>
+void PartitionInPlace(arma::Mat<T>& input,
+                      arma::Row<U>* labels,
+                      const arma::Col<size_t>& order,
+                      const size_t trainSize)
+{
+  std::vector<char> isTest(input.n_cols, 0);
+  for (size_t i = trainSize; i < order.n_elem; ++i)
+    isTest[order[i]] = 1;
+
+  // There are as many test points before trainSize as training points after.
+  std::vector<size_t> misplacedTest, misplacedTrain;
+  for (size_t i = 0; i < trainSize; ++i)
+    if (isTest[i])
+      misplacedTest.push_back(i);
+  for (size_t i = trainSize; i < input.n_cols; ++i)
+    if (!isTest[i])
+      misplacedTrain.push_back(i);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t k = 0; k < (omp_size_t) misplacedTest.size(); ++k)
+  {
+    input.swap_cols(misplacedTest[k], misplacedTrain[k]);
+    if (labels != NULL)
+      std::swap((*labels)[misplacedTest[k]], (*labels)[misplacedTrain[k]]);
+  }
+}
+
+} // namespace details
+
 /**
  * Given an input dataset and labels, split into a training set and test set.
  * Example usage below.  This overload places the split dataset into the four
@@ -44,6 +135,8 @@ namespace data {
  * @param trainLabel Vector to store training labels into.
  * @param testLabel Vector to store test labels into.
  * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param stratifyData If true, hold out testRatio of the points of each class,
+ *     so that the class proportions are the same in both sets.
  */
 template<typename T, typename U>
 void Split(const arma::Mat<T>& input,
@@ -52,26 +145,27 @@ void Split(const arma::Mat<T>& input,
            arma::Mat<T>& testData,
            arma::Row<U>& trainLabel,
            arma::Row<U>& testLabel,
-           const double testRatio)
+           const double testRatio,
+           const bool stratifyData = false)
 {
-  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
-  const size_t trainSize = input.n_cols - testSize;
+  size_t trainSize;
+  const arma::Col<size_t> order = details::SplitOrder(inputLabel, testRatio,
+      stratifyData, trainSize);
+  const size_t testSize = input.n_cols - trainSize;
   trainData.set_size(input.n_rows, trainSize);
   testData.set_size(input.n_rows, testSize);
   trainLabel.set_size(trainSize);
   testLabel.set_size(testSize);
 
-  const arma::Col<size_t> order =
-      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols - 1,
-                                                      input.n_cols));
-
-  for (size_t i = 0; i != trainSize; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) trainSize; ++i)
   {
     trainData.col(i) = input.col(order[i]);
     trainLabel(i) = inputLabel(order[i]);
   }
 
-  for (size_t i = 0; i != testSize; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) testSize; ++i)
   {
     testData.col(i) = input.col(order[i + trainSize]);
     testLabel(i) = inputLabel(order[i + trainSize]);
@@ -140,6 +234,8 @@ void Split(const arma::Mat<T>& input,
  * @param input Input dataset to split.
  * @param label Input labels to split.
  * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param stratifyData If true, hold out testRatio of the points of each class,
+ *     so that the class proportions are the same in both sets.
  * @return std::tuple containing trainData (arma::Mat<T>), testData
  *      (arma::Mat<T>), trainLabel (arma::Row<U>), and testLabel (arma::Row<U>).
  */
@@ -147,7 +243,8 @@ template<typename T, typename U>
 std::tuple<arma::Mat<T>, arma::Mat<T>, arma::Row<U>, arma::Row<U>>
 Split(const arma::Mat<T>& input,
       const arma::Row<U>& inputLabel,
-      const double testRatio)
+      const double testRatio,
+      const bool stratifyData = false)
 {
   arma::Mat<T> trainData;
   arma::Mat<T> testData;
@@ -155,7 +252,7 @@ Split(const arma::Mat<T>& input,
   arma::Row<U> testLabel;
 
   Split(input, inputLabel, trainData, testData, trainLabel, testLabel,
-      testRatio);
+      testRatio, stratifyData);
 
   return std::make_tuple(std::move(trainData),
                          std::move(testData),
@@ -192,6 +289,90 @@ Split(const arma::Mat<T>& input,
                          std::move(testData));
 }
 
+/**
+ * Given an input dataset and labels, split into a training set and test set
+ * in place, without copying the dataset.  The columns of the input (and the
+ * labels) are rearranged so that the training points come first, and the
+ * returned matrices and rows are aliases of the two parts of the input: they
+ * don't own their memory, so the input must outlive them and must not be
+ * resized while they are used.  This is useful for datasets too large to hold
+ * twice in memory.
+ *
+ * The same points are selected as with Split(), but only the points that are
+ * on the wrong side of the split are moved (in parallel, when OpenMP is
+ * available); the order of the points within each set is not random.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * // Hold out 20% of the points of each class.
+ * auto splitResult = SplitInPlace(input, label, 0.2, true);
+ * @endcode
+ *
+ * @param input Input dataset to split; its columns are rearranged.
+ * @param inputLabel Input labels to split; they are rearranged likewise.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param stratifyData If true, hold out testRatio of the points of each class,
+ *     so that the class proportions are the same in both sets.
+ * @return std::tuple containing aliases of trainData (arma::Mat<T>), testData
+ *      (arma::Mat<T>), trainLabel (arma::Row<U>), and testLabel (arma::Row<U>).
+ */
+template<typename T, typename U>
+std::tuple<arma::Mat<T>, arma::Mat<T>, arma::Row<U>, arma::Row<U>>
+SplitInPlace(arma::Mat<T>& input,
+             arma::Row<U>& inputLabel,
+             const double testRatio,
+             const bool stratifyData = false)
+{
+  size_t trainSize;
+  const arma::Col<size_t> order = details::SplitOrder(inputLabel, testRatio,
+      stratifyData, trainSize);
+  details::PartitionInPlace(input, &inputLabel, order, trainSize);
+
+  const size_t testSize = input.n_cols - trainSize;
+  return std::make_tuple(
+      arma::Mat<T>(input.memptr(), input.n_rows, trainSize, false, true),
+      arma::Mat<T>(input.memptr() + input.n_rows * trainSize, input.n_rows,
+          testSize, false, true),
+      arma::Row<U>(inputLabel.memptr(), trainSize, false, true),
+      arma::Row<U>(inputLabel.memptr() + trainSize, testSize, false, true));
+}
+
+/**
+ * Given an input dataset, split into a training set and test set in place,
+ * without copying the dataset.  The columns of the input are rearranged so
+ * that the training points come first, and the returned matrices are aliases
+ * of the two parts of the input; see the overload with labels for details.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * auto splitResult = SplitInPlace(input, 0.2);
+ * @endcode
+ *
+ * @param input Input dataset to split; its columns are rearranged.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @return std::tuple containing aliases of trainData (arma::Mat<T>) and
+ *      testData (arma::Mat<T>).
+ */
+template<typename T>
+std::tuple<arma::Mat<T>, arma::Mat<T>>
+SplitInPlace(arma::Mat<T>& input,
+             const double testRatio)
+{
+  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
+  const size_t trainSize = input.n_cols - testSize;
+  const arma::Col<size_t> order =
+      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols - 1,
+                                                      input.n_cols));
+  details::PartitionInPlace(input, (arma::Row<size_t>*) NULL, order,
+      trainSize);
+
+  return std::make_tuple(
+      arma::Mat<T>(input.memptr(), input.n_rows, trainSize, false, true),
+      arma::Mat<T>(input.memptr() + input.n_rows * trainSize, input.n_rows,
+          testSize, false, true));
+}
+
 } // namespace data
 } // namespace mlpack
 
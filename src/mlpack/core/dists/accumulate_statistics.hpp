@@ -0,0 +1,72 @@
+/**
+ * @file accumulate_statistics.hpp
+ *
+ * Parallel accumulation of the sufficient statistics of a distribution.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DISTRIBUTIONS_ACCUMULATE_STATISTICS_HPP
+#define MLPACK_CORE_DISTRIBUTIONS_ACCUMULATE_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace distribution {
+
+/**
+ * Compute the sufficient statistics of the given observations, in parallel.
+ * The observations are cut into chunks; every chunk is added to its own copy
+ * of the given empty statistics, and the copies are merged in order, so the
+ * result does not depend on the number of threads.
+ *
+ * StatisticsType must provide
+ *
+ * @code
+ * void Add(const arma::mat& observations,
+ *          const arma::vec* probabilities,
+ *          const size_t begin,
+ *          const size_t end);
+ * void Merge(const StatisticsType& other);
+ * @endcode
+ *
+ * where Add() adds the observations [begin, end), weighted by the given
+ * probabilities (or by 1 if they are NULL).
+ *
+ * @param observations List of observations.
+ * @param probabilities Probability of each observation, or NULL.
+ * @param empty Statistics of no observations, of the right dimensionality.
+ * @return The statistics of the observations.
+ */
+template<typename StatisticsType>
+StatisticsType AccumulateStatistics(const arma::mat& observations,
+                                    const arma::vec* probabilities,
+                                    const StatisticsType& empty)
+{
+  // Chunks of this many observations keep the work of a chunk well above the
+  // cost of merging it.
+  const size_t chunkSize = 4096;
+  const size_t chunks = (observations.n_cols + chunkSize - 1) / chunkSize;
+
+  std::vector<StatisticsType> partial(chunks, empty);
+  Threads::ParallelFor(0, chunks, [&](const size_t c)
+  {
+    const size_t begin = c * chunkSize;
+    const size_t end = std::min(size_t(observations.n_cols),
+        begin + chunkSize);
+    partial[c].Add(observations, probabilities, begin, end);
+  });
+
+  StatisticsType statistics(empty);
+  for (size_t c = 0; c < chunks; ++c)
+    statistics.Merge(partial[c]);
+
+  return statistics;
+}
+
+} // namespace distribution
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file diagonal_gaussian_distribution.cpp
+ *
+ * Implementation of the Gaussian distribution with diagonal covariance.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "diagonal_gaussian_distribution.hpp"
+#include <mlpack/methods/gmm/positive_definite_constraint.hpp>
+
+using namespace mlpack;
+using namespace mlpack::distribution;
+
+DiagonalGaussianDistribution::DiagonalGaussianDistribution(
+    const arma::vec& mean,
+    const arma::vec& covariance) :
+    mean(mean)
+{
+  Covariance(covariance);
+}
+
+void DiagonalGaussianDistribution::Covariance(const arma::vec& covariance)
+{
+  this->covariance = covariance;
+  FactorCovariance();
+}
+
+void DiagonalGaussianDistribution::Covariance(arma::vec&& covariance)
+{
+  this->covariance = std::move(covariance);
+  FactorCovariance();
+}
+
+void DiagonalGaussianDistribution::FactorCovariance()
+{
+  invCov = 1.0 / covariance;
+  logDetCov = arma::accu(arma::log(covariance));
+}
+
+double DiagonalGaussianDistribution::LogProbability(
+    const arma::vec& observation) const
+{
+  const size_t k = observation.n_elem;
+  const double v = arma::dot(arma::square(observation - mean), invCov);
+  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v;
+}
+
+arma::vec DiagonalGaussianDistribution::Random() const
+{
+  return arma::sqrt(covariance) % arma::randn<arma::vec>(mean.n_elem) + mean;
+}
+
+/**
+ * Estimate the Gaussian distribution directly from the given observations.
+ *
+ * @param observations List of observations.
+ */
+void DiagonalGaussianDistribution::Train(const arma::mat& observations)
+{
+  if (observations.n_cols == 0)
+  {
+    // This will end up just being empty.
+    mean.zeros(0);
+    covariance.zeros(0);
+    return;
+  }
+
+  mean = arma::mean(observations, 1);
+
+  // Only the variance of each dimension is needed.  Normalize with
+  // (1 / (n - 1)) so that it is the unbiased estimator.
+  const arma::mat obsNoMean = observations.each_col() - mean;
+  covariance = arma::sum(arma::square(obsNoMean), 1) /
+      (observations.n_cols - 1);
+
+  // Ensure that the covariance is positive definite.
+  gmm::PositiveDefiniteConstraint::ApplyConstraint(covariance);
+
+  FactorCovariance();
+}
+
+/**
+ * Estimate the Gaussian distribution from the given observations, taking into
+ * account the probability of each observation actually being from this
+ * distribution.
+ */
+void DiagonalGaussianDistribution::Train(const arma::mat& observations,
+                                         const arma::vec& probabilities)
+{
+  if (observations.n_cols == 0)
+  {
+    // This will end up just being empty.
+    mean.zeros(0);
+    covariance.zeros(0);
+    return;
+  }
+
+  // Save the sum of all the probabilities for normalization.
+  const double sumProb = arma::accu(probabilities);
+  if (sumProb == 0)
+  {
+    // Nothing in this Gaussian!  At least set the covariance so that it's
+    // invertible.
+    mean.zeros(observations.n_rows);
+    covariance.zeros(observations.n_rows);
+    covariance += 1e-50;
+    FactorCovariance();
+    return;
+  }
+
+  mean = (observations * probabilities) / sumProb;
+
+  const arma::mat obsNoMean = observations.each_col() - mean;
+  covariance = (arma::square(obsNoMean) * probabilities) / sumProb;
+
+  // Ensure that the covariance is positive definite.
+  gmm::PositiveDefiniteConstraint::ApplyConstraint(covariance);
+
+  FactorCovariance();
+}
@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "discrete_distribution.hpp"
+#include "accumulate_statistics.hpp"
 
 using namespace mlpack;
 using namespace mlpack::distribution;
@@ -49,29 +50,24 @@ arma::vec DiscreteDistribution::Random() const
   return result;
 }
 
-/**
- * Estimate the probability distribution directly from the given observations.
- */
-void DiscreteDistribution::Train(const arma::mat& observations)
+DiscreteDistribution::SufficientStatistics::SufficientStatistics(
+    const arma::Col<size_t>& numObservations) :
+    counts(numObservations.n_elem)
 {
-  // Make sure the observations have same dimension as the probabilities.
-  if (observations.n_rows != probabilities.size())
-  {
-    throw std::invalid_argument("observations must have same dimensionality as "
-        "the DiscreteDistribution object");
-  }
-
-  // Get the dimension size of the distribution.
-  const size_t dimensions = probabilities.size();
-
-  // Clear the old probabilities.
-  for (size_t i = 0; i < dimensions; i++)
-    probabilities[i].zeros();
+  for (size_t i = 0; i < numObservations.n_elem; ++i)
+    counts[i].zeros(numObservations[i]);
+}
 
-  // Iterate all the probabilities in each dimension
-  for (size_t r = 0; r < observations.n_cols; ++r)
+void DiscreteDistribution::SufficientStatistics::Add(
+    const arma::mat& observations,
+    const arma::vec* probabilities,
+    const size_t begin,
+    const size_t end)
+{
+  for (size_t r = begin; r < end; ++r)
   {
-    for (size_t i = 0; i < dimensions; ++i)
+    const double weight = probabilities ? (*probabilities)[r] : 1.0;
+    for (size_t i = 0; i < counts.size(); ++i)
     {
       // Add the probability of each observation.  The addition of 0.5 to the
       // observation is to turn the default flooring operation of the size_t
@@ -79,77 +75,88 @@ void DiscreteDistribution::Train(const arma::mat& observations)
       const size_t obs = size_t(observations(i, r) + 0.5);
 
       // Ensure that the observation is within the bounds.
-      if (obs >= probabilities[i].n_elem)
+      if (obs >= counts[i].n_elem)
       {
         std::ostringstream oss;
         oss << "observation " << r << " in dimension " << i << " ("
             << observations(i, r) << ") is invalid; must be in [0, "
-            << probabilities[i].n_elem << "] for this distribution";
+            << counts[i].n_elem << "] for this distribution";
         throw std::invalid_argument(oss.str());
       }
-      probabilities[i][obs]++;
+
+      counts[i][obs] += weight;
     }
   }
+}
 
-  // Now normalize the distributions.
-  for (size_t i = 0; i < dimensions; ++i)
+void DiscreteDistribution::SufficientStatistics::Merge(
+    const SufficientStatistics& other)
+{
+  if (other.counts.size() != counts.size())
   {
-    double sum = accu(probabilities[i]);
-    if (sum > 0)
-      probabilities[i] /= sum;
-    else // Force normalization.
-      probabilities[i].fill(1.0 / probabilities[i].n_elem);
+    throw std::invalid_argument("DiscreteDistribution::SufficientStatistics::"
+        "Merge(): statistics have different dimensionality");
   }
+
+  for (size_t i = 0; i < counts.size(); ++i)
+    counts[i] += other.counts[i];
 }
 
 /**
- * Estimate the probability distribution from the given observations when also
- * given probabilities that each observation is from this distribution.
+ * Compute the sufficient statistics of the given observations.
  */
-void DiscreteDistribution::Train(const arma::mat& observations,
-                                 const arma::vec& probObs)
+DiscreteDistribution::SufficientStatistics DiscreteDistribution::Statistics(
+    const arma::mat& observations,
+    const arma::vec* probabilities) const
 {
   // Make sure the observations have same dimension as the probabilities.
-  if (observations.n_rows != probabilities.size())
+  if (observations.n_rows != this->probabilities.size())
   {
     throw std::invalid_argument("observations must have same dimensionality as "
         "the DiscreteDistribution object");
   }
 
-  // Get the dimension size of the distribution.
-  size_t dimensions = probabilities.size();
+  arma::Col<size_t> numObservations(this->probabilities.size());
+  for (size_t i = 0; i < this->probabilities.size(); ++i)
+    numObservations[i] = this->probabilities[i].n_elem;
 
-  // Clear the old probabilities.
-  for (size_t i = 0; i < dimensions; i++)
-    probabilities[i].zeros();
+  return AccumulateStatistics(observations, probabilities,
+      SufficientStatistics(numObservations));
+}
 
-  // Ensure that the observation is within the bounds.
-  for (size_t r = 0; r < observations.n_cols; r++)
-  {
-    for (size_t i = 0; i < dimensions; i++)
-    {
-      // Add the probability of each observation. The addition of 0.5
-      // to the observation is to turn the default flooring operation
-      // of the size_t cast into a rounding observation.
-      const size_t obs = size_t(observations(i, r) + 0.5);
+/**
+ * Estimate the probability distribution directly from the given observations.
+ */
+void DiscreteDistribution::Train(const arma::mat& observations)
+{
+  Train(Statistics(observations));
+}
 
-      // Ensure that the observation is within the bounds.
-      if (obs >= probabilities[i].n_elem)
-      {
-        std::ostringstream oss;
-        oss << "observation " << r << " in dimension " << i << " ("
-            << observations(i, r) << ") is invalid; must be in [0, "
-            << probabilities[i].n_elem << "] for this distribution";
-        throw std::invalid_argument(oss.str());
-      }
+/**
+ * Estimate the probability distribution from the given observations when also
+ * given probabilities that each observation is from this distribution.
+ */
+void DiscreteDistribution::Train(const arma::mat& observations,
+                                 const arma::vec& probObs)
+{
+  Train(Statistics(observations, &probObs));
+}
 
-      probabilities[i][obs] += probObs[r];
-    }
+/**
+ * Estimate the probability distribution from the given sufficient statistics.
+ */
+void DiscreteDistribution::Train(const SufficientStatistics& statistics)
+{
+  if (statistics.Dimensionality() != probabilities.size())
+  {
+    throw std::invalid_argument("statistics must have same dimensionality as "
+        "the DiscreteDistribution object");
   }
 
   // Now normalize the distributions.
-  for (size_t i = 0; i < dimensions; ++i)
+  for (size_t i = 0; i < probabilities.size(); ++i)
   {
+    probabilities[i] = statistics.Counts(i);
     double sum = accu(probabilities[i]);
     if (sum > 0)
       probabilities[i] /= sum;
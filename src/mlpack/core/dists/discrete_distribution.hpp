@@ -198,6 +198,62 @@ class DiscreteDistribution
   void Train(const arma::mat& observations,
              const arma::vec& probabilities);
 
+  /**
+   * The sufficient statistics of a discrete distribution: the (weighted)
+   * number of times every value was observed in every dimension.  Statistics
+   * of separate sets of observations can be merged, so they can be computed
+   * for chunks of a dataset independently.
+   */
+  class SufficientStatistics
+  {
+   public:
+    /**
+     * Create statistics of no observations, for a distribution with the given
+     * number of possible values in every dimension.
+     */
+    SufficientStatistics(const arma::Col<size_t>& numObservations =
+        arma::Col<size_t>());
+
+    /**
+     * Add the observations [begin, end) of the given matrix, weighted by the
+     * given probabilities (or by 1 if they are NULL).
+     */
+    void Add(const arma::mat& observations,
+             const arma::vec* probabilities,
+             const size_t begin,
+             const size_t end);
+
+    //! Add the statistics of another set of observations.
+    void Merge(const SufficientStatistics& other);
+
+    //! Get the number of dimensions.
+    size_t Dimensionality() const { return counts.size(); }
+
+    //! Get the (weighted) counts of the values of the given dimension.
+    const arma::vec& Counts(const size_t dim) const { return counts[dim]; }
+
+   private:
+    //! The (weighted) counts of the values of every dimension.
+    std::vector<arma::vec> counts;
+  };
+
+  /**
+   * Compute the sufficient statistics of the given observations, in parallel.
+   *
+   * @param observations List of observations.
+   * @param probabilities Probability of each observation, or NULL.
+   */
+  SufficientStatistics Statistics(const arma::mat& observations,
+                                  const arma::vec* probabilities = NULL) const;
+
+  /**
+   * Estimate the probability distribution from the given sufficient
+   * statistics.
+   *
+   * @param statistics Sufficient statistics of the observations.
+   */
+  void Train(const SufficientStatistics& statistics);
+
   //! Return the vector of probabilities for the given dimension.
   arma::vec& Probabilities(const size_t dim = 0) { return probabilities[dim]; }
   //! Modify the vector of probabilities for the given dimension.
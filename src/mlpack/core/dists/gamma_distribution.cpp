@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "gamma_distribution.hpp"
+#include "accumulate_statistics.hpp"
 // This will include digamma and trigamma.
 #include <mlpack/core/boost_backport/boost_backport_math.hpp>
 
@@ -47,6 +48,61 @@ inline bool GammaDistribution::Converged(const double aOld,
   return (std::abs(aNew - aOld) / aNew) < tol;
 }
 
+GammaDistribution::SufficientStatistics::SufficientStatistics(
+    const size_t dimensionality) :
+    weight(0.0),
+    sum(arma::zeros<arma::vec>(dimensionality)),
+    logSum(arma::zeros<arma::vec>(dimensionality))
+{ /* Nothing to do. */ }
+
+void GammaDistribution::SufficientStatistics::Add(
+    const arma::mat& observations,
+    const arma::vec* probabilities,
+    const size_t begin,
+    const size_t end)
+{
+  if (begin >= end)
+    return;
+
+  const arma::mat block = observations.cols(begin, end - 1);
+  if (probabilities)
+  {
+    const arma::vec weights = probabilities->subvec(begin, end - 1);
+    weight += arma::accu(weights);
+    sum += block * weights;
+    logSum += arma::log(block) * weights;
+  }
+  else
+  {
+    weight += block.n_cols;
+    sum += arma::sum(block, 1);
+    logSum += arma::sum(arma::log(block), 1);
+  }
+}
+
+void GammaDistribution::SufficientStatistics::Merge(
+    const SufficientStatistics& other)
+{
+  if (other.sum.n_elem != sum.n_elem)
+  {
+    throw std::invalid_argument("GammaDistribution::SufficientStatistics::"
+        "Merge(): statistics have different dimensionality");
+  }
+
+  weight += other.weight;
+  sum += other.sum;
+  logSum += other.logSum;
+}
+
+// Computes the sufficient statistics of the given observations.
+GammaDistribution::SufficientStatistics GammaDistribution::Statistics(
+    const arma::mat& observations,
+    const arma::vec* probabilities)
+{
+  return AccumulateStatistics(observations, probabilities,
+      SufficientStatistics(observations.n_rows));
+}
+
 // Fits an alpha and beta parameter to each dimension of the data.
 void GammaDistribution::Train(const arma::mat& rdata, const double tol)
 {
@@ -54,14 +110,7 @@ void GammaDistribution::Train(const arma::mat& rdata, const double tol)
   if (arma::size(rdata) == arma::size(arma::mat()))
     return;
 
-  // Calculate log(mean(x)) and mean(log(x)) of each dataset row.
-  const arma::vec meanLogxVec = arma::mean(arma::log(rdata), 1);
-  const arma::vec meanxVec = arma::mean(rdata, 1);
-  const arma::vec logMeanxVec = arma::log(meanxVec);
-
-  // Call the statistics-only GammaDistribution::Train() function to fit the
-  // parameters. That function does all the work so we're done.
-  Train(logMeanxVec, meanLogxVec, meanxVec, tol);
+  Train(Statistics(rdata), tol);
 }
 
 // Fits an alpha and beta parameter according to observation probabilities.
@@ -73,21 +122,17 @@ void GammaDistribution::Train(const arma::mat& rdata,
   if (arma::size(rdata) == arma::size(arma::mat()))
     return;
 
-  arma::vec meanLogxVec(rdata.n_rows, arma::fill::zeros);
-  arma::vec meanxVec(rdata.n_rows, arma::fill::zeros);
-  arma::vec logMeanxVec(rdata.n_rows, arma::fill::zeros);
-
-  for (size_t i = 0; i < rdata.n_cols; i++)
-  {
-    meanLogxVec += probabilities(i) * arma::log(rdata.col(i));
-    meanxVec += probabilities(i) * rdata.col(i);
-  }
-
-  double totProbability = arma::accu(probabilities);
+  Train(Statistics(rdata, &probabilities), tol);
+}
 
-  meanLogxVec /= totProbability;
-  meanxVec /= totProbability;
-  logMeanxVec = arma::log(meanxVec);
+// Fits an alpha and beta parameter to the given sufficient statistics.
+void GammaDistribution::Train(const SufficientStatistics& statistics,
+                              const double tol)
+{
+  // Calculate log(mean(x)) and mean(log(x)) of each dimension.
+  const arma::vec meanxVec = statistics.Sum() / statistics.Weight();
+  const arma::vec meanLogxVec = statistics.LogSum() / statistics.Weight();
+  const arma::vec logMeanxVec = arma::log(meanxVec);
 
   // Call the statistics-only GammaDistribution::Train() function to fit the
   // parameters. That function does all the work so we're done.
@@ -117,8 +162,8 @@ void GammaDistribution::Train(const arma::vec& logMeanxVec,
   alpha.set_size(ndim);
   beta.set_size(ndim);
 
-  // Treat each dimension (i.e. row) independently.
-  for (size_t row = 0; row < ndim; ++row)
+  // Treat each dimension (i.e. row) independently, in parallel.
+  Threads::ParallelFor(0, ndim, [&](const size_t row)
   {
     // Statistics for this row.
     const double meanLogx = meanLogxVec(row);
@@ -155,7 +200,7 @@ void GammaDistribution::Train(const arma::vec& logMeanxVec,
 
     alpha(row) = aEst;
     beta(row) = meanx / aEst;
-  }
+  });
 }
 
 // Returns the probability of the provided observations.
@@ -232,7 +277,7 @@ arma::vec GammaDistribution::Random() const
   {
     std::gamma_distribution<double> dist(alpha(d), beta(d));
     // Use the mlpack random object.
-    randVec(d) = dist(mlpack::math::randGen);
+    randVec(d) = dist(mlpack::math::ThreadRandGen());
   }
 
   return randVec;
@@ -125,6 +125,70 @@ class GammaDistribution
                const arma::vec& meanxVec,
                const double tol = 1e-8);
 
+    /**
+     * The sufficient statistics of a Gamma distribution: the total weight of
+     * the observations, and the weighted sums of the observations and of their
+     * logarithms in every dimension.  Statistics of separate sets of
+     * observations can be merged, so they can be computed for chunks of a
+     * dataset independently.
+     */
+    class SufficientStatistics
+    {
+     public:
+      //! Create statistics of no observations of the given dimensionality.
+      SufficientStatistics(const size_t dimensionality = 0);
+
+      /**
+       * Add the observations [begin, end) of the given matrix, weighted by the
+       * given probabilities (or by 1 if they are NULL).
+       */
+      void Add(const arma::mat& observations,
+               const arma::vec* probabilities,
+               const size_t begin,
+               const size_t end);
+
+      //! Add the statistics of another set of observations.
+      void Merge(const SufficientStatistics& other);
+
+      //! Get the total weight of the observations.
+      double Weight() const { return weight; }
+      //! Get the weighted sum of the observations.
+      const arma::vec& Sum() const { return sum; }
+      //! Get the weighted sum of the logarithms of the observations.
+      const arma::vec& LogSum() const { return logSum; }
+
+     private:
+      //! The total weight of the observations.
+      double weight;
+      //! The weighted sum of the observations.
+      arma::vec sum;
+      //! The weighted sum of the logarithms of the observations.
+      arma::vec logSum;
+    };
+
+    /**
+     * Compute the sufficient statistics of the given observations, in
+     * parallel.
+     *
+     * @param observations List of observations.
+     * @param probabilities Probability of each observation, or NULL.
+     */
+    static SufficientStatistics Statistics(
+        const arma::mat& observations,
+        const arma::vec* probabilities = NULL);
+
+    /**
+     * This function trains (fits distribution parameters) to the given
+     * sufficient statistics.  The dimensions are fitted in parallel.
+     *
+     * @param statistics Sufficient statistics of the observations.
+     * @param tol Convergence tolerance. This is *not* an absolute measure:
+     *    It will stop the approximation once the *change* in the value is
+     *    smaller than tol.
+     */
+    void Train(const SufficientStatistics& statistics,
+               const double tol = 1e-8);
+
 
     /**
      * This function returns the probability of a group of observations.
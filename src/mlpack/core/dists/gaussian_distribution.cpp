@@ -11,6 +11,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "gaussian_distribution.hpp"
+#include "accumulate_statistics.hpp"
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
 
 using namespace mlpack;
@@ -78,48 +79,95 @@ arma::vec GaussianDistribution::Random() const
   return covLower * arma::randn<arma::vec>(mean.n_elem) + mean;
 }
 
-/**
- * Estimate the Gaussian distribution directly from the given observations.
- *
- * @param observations List of observations.
- */
-void GaussianDistribution::Train(const arma::mat& observations)
+GaussianDistribution::SufficientStatistics::SufficientStatistics(
+    const size_t dimensionality) :
+    count(0),
+    weight(0.0),
+    weighted(false),
+    mean(arma::zeros<arma::vec>(dimensionality)),
+    scatter(arma::zeros<arma::mat>(dimensionality, dimensionality))
+{ /* Nothing to do. */ }
+
+void GaussianDistribution::SufficientStatistics::Add(
+    const arma::mat& observations,
+    const arma::vec* probabilities,
+    const size_t begin,
+    const size_t end)
 {
-  if (observations.n_cols > 0)
+  if (begin >= end)
+    return;
+
+  const arma::mat block = observations.cols(begin, end - 1);
+  const arma::rowvec weights = probabilities ?
+      arma::rowvec(probabilities->subvec(begin, end - 1).t()) :
+      arma::ones<arma::rowvec>(block.n_cols);
+
+  // Compute the statistics of the block directly (it is small enough to stay
+  // in cache), and then merge them.
+  SufficientStatistics blockStatistics(block.n_rows);
+  blockStatistics.count = block.n_cols;
+  blockStatistics.weight = arma::accu(weights);
+  blockStatistics.weighted = (probabilities != NULL);
+  if (blockStatistics.weight != 0)
   {
-    mean.zeros(observations.n_rows);
-    covariance.zeros(observations.n_rows, observations.n_rows);
+    blockStatistics.mean = block * weights.t() / blockStatistics.weight;
+    arma::mat centered = block;
+    centered.each_col() -= blockStatistics.mean;
+    blockStatistics.scatter = (centered.each_row() % weights) * centered.t();
   }
-  else // This will end up just being empty.
+
+  Merge(blockStatistics);
+}
+
+void GaussianDistribution::SufficientStatistics::Merge(
+    const SufficientStatistics& other)
+{
+  if (other.mean.n_elem != mean.n_elem)
   {
-    // TODO(stephentu): why do we allow this case? why not throw an error?
-    mean.zeros(0);
-    covariance.zeros(0);
-    return;
+    throw std::invalid_argument("GaussianDistribution::SufficientStatistics::"
+        "Merge(): statistics have different dimensionality");
   }
 
-  // Calculate the mean.
-  for (size_t i = 0; i < observations.n_cols; i++)
-    mean += observations.col(i);
-
-  // Normalize the mean.
-  mean /= observations.n_cols;
+  count += other.count;
+  weighted = weighted || other.weighted;
+  if (other.weight == 0)
+    return;
 
-  // Now calculate the covariance.
-  for (size_t i = 0; i < observations.n_cols; i++)
+  if (weight == 0)
   {
-    arma::vec obsNoMean = observations.col(i) - mean;
-    covariance += obsNoMean * trans(obsNoMean);
+    weight = other.weight;
+    mean = other.mean;
+    scatter = other.scatter;
+    return;
   }
 
-  // Finish estimating the covariance by normalizing, with the (1 / (n - 1)) so
-  // that it is the unbiased estimator.
-  covariance /= (observations.n_cols - 1);
+  const double total = weight + other.weight;
+  const arma::vec delta = other.mean - mean;
+  mean += delta * (other.weight / total);
+  scatter += other.scatter + (delta * delta.t()) * (weight * other.weight /
+      total);
+  weight = total;
+}
 
-  // Ensure that the covariance is positive definite.
-  gmm::PositiveDefiniteConstraint::ApplyConstraint(covariance);
+/**
+ * Compute the sufficient statistics of the given observations.
+ */
+GaussianDistribution::SufficientStatistics GaussianDistribution::Statistics(
+    const arma::mat& observations,
+    const arma::vec* probabilities)
+{
+  return AccumulateStatistics(observations, probabilities,
+      SufficientStatistics(observations.n_rows));
+}
 
-  FactorCovariance();
+/**
+ * Estimate the Gaussian distribution directly from the given observations.
+ *
+ * @param observations List of observations.
+ */
+void GaussianDistribution::Train(const arma::mat& observations)
+{
+  Train(Statistics(observations));
 }
 
 /**
@@ -130,52 +178,42 @@ void GaussianDistribution::Train(const arma::mat& observations)
 void GaussianDistribution::Train(const arma::mat& observations,
                                  const arma::vec& probabilities)
 {
-  if (observations.n_cols > 0)
-  {
-    mean.zeros(observations.n_rows);
-    covariance.zeros(observations.n_rows, observations.n_rows);
-  }
-  else // This will end up just being empty.
+  Train(Statistics(observations, &probabilities));
+}
+
+/**
+ * Estimate the Gaussian distribution from the given sufficient statistics.
+ */
+void GaussianDistribution::Train(const SufficientStatistics& statistics)
+{
+  if (statistics.Count() == 0)
   {
-    // TODO(stephentu): same as above
+    // TODO(stephentu): why do we allow this case? why not throw an error?
     mean.zeros(0);
     covariance.zeros(0);
     return;
   }
 
-  double sumProb = 0;
-
-  // First calculate the mean, and save the sum of all the probabilities for
-  // later normalization.
-  for (size_t i = 0; i < observations.n_cols; i++)
-  {
-    mean += probabilities[i] * observations.col(i);
-    sumProb += probabilities[i];
-  }
-
-  if (sumProb == 0)
+  if (statistics.Weight() == 0)
   {
     // Nothing in this Gaussian!  At least set the covariance so that it's
     // invertible.
+    mean.zeros(statistics.Mean().n_elem);
+    covariance.zeros(mean.n_elem, mean.n_elem);
     covariance.diag() += 1e-50;
     FactorCovariance();
     return;
   }
 
-  // Normalize.
-  if (sumProb > 0)
-    mean /= sumProb;
-
-  // Now find the covariance.
-  for (size_t i = 0; i < observations.n_cols; i++)
-  {
-    arma::vec obsNoMean = observations.col(i) - mean;
-    covariance += probabilities[i] * (obsNoMean * trans(obsNoMean));
-  }
+  mean = statistics.Mean();
 
-  // This is probably biased, but I don't know how to unbias it.
-  if (sumProb > 0)
-    covariance /= sumProb;
+  // The unweighted estimate uses (1 / (n - 1)), so that it is the unbiased
+  // estimator; the weighted estimate is probably biased, but I don't know how
+  // to unbias it.
+  if (statistics.Weighted())
+    covariance = statistics.Scatter() / statistics.Weight();
+  else
+    covariance = statistics.Scatter() / (statistics.Count() - 1);
 
   // Ensure that the covariance is positive definite.
   gmm::PositiveDefiniteConstraint::ApplyConstraint(covariance);
@@ -52,11 +52,9 @@ void LaplaceDistribution::Estimate(const arma::mat& observations)
   mean = arma::mean(observations, 1);
 
   // The maximum likelihood estimate of the scale parameter is the mean
-  // deviation from the mean.
-  scale = 0.0;
-  for (size_t i = 0; i < observations.n_cols; ++i)
-    scale += arma::norm(observations.col(i) - mean, 2);
-  scale /= observations.n_cols;
+  // deviation from the mean.  It depends on the mean, so it takes a second
+  // pass over the observations.
+  scale = DeviationSum(observations, NULL) / observations.n_cols;
 }
 
 /**
@@ -69,16 +67,37 @@ void LaplaceDistribution::Estimate(const arma::mat& observations,
 {
   // I am not completely sure that this change results in a valid maximum
   // likelihood estimator given probabilities of points.
-  mean.zeros(observations.n_rows);
-  for (size_t i = 0; i < observations.n_cols; ++i)
-    mean += observations.col(i) * probabilities(i);
-  mean /= arma::accu(probabilities);
+  const double sumProbabilities = arma::accu(probabilities);
+  mean = observations * probabilities / sumProbabilities;
 
   // This is the same formula as the previous function, but here we are
   // multiplying by the probability that the point is actually from
   // this distribution.
-  scale = 0.0;
-  for (size_t i = 0; i < observations.n_cols; ++i)
-    scale += probabilities(i) * arma::norm(observations.col(i) - mean, 2);
-  scale /= arma::accu(probabilities);
+  scale = DeviationSum(observations, &probabilities) / sumProbabilities;
+}
+
+double LaplaceDistribution::DeviationSum(const arma::mat& observations,
+                                         const arma::vec* probabilities) const
+{
+  // Every chunk of observations is summed by its own thread, and the chunks
+  // are added in order, so the result does not depend on the number of
+  // threads.
+  const size_t chunkSize = 4096;
+  const size_t chunks = (observations.n_cols + chunkSize - 1) / chunkSize;
+  arma::vec sums(chunks);
+  Threads::ParallelFor(0, chunks, [&](const size_t c)
+  {
+    const size_t begin = c * chunkSize;
+    const size_t end = std::min(size_t(observations.n_cols),
+        begin + chunkSize);
+
+    arma::mat deviations = observations.cols(begin, end - 1);
+    deviations.each_col() -= mean;
+    const arma::rowvec norms = arma::sqrt(arma::sum(arma::square(deviations),
+        0));
+    sums[c] = probabilities ? arma::dot(norms,
+        probabilities->subvec(begin, end - 1)) : arma::accu(norms);
+  });
+
+  return arma::accu(sums);
 }
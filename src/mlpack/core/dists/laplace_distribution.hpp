@@ -155,6 +155,14 @@ class LaplaceDistribution
   arma::vec mean;
   //! Scale parameter of the distribution.
   double scale;
+
+  /**
+   * Compute the sum of the (weighted) distances of the given observations to
+   * the mean, in parallel.  The weights are the given probabilities, or 1 if
+   * they are NULL.
+   */
+  double DeviationSum(const arma::mat& observations,
+                      const arma::vec* probabilities) const;
 };
 
 } // namespace distribution
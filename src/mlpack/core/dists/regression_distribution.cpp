@@ -22,12 +22,9 @@ using namespace mlpack::distribution;
  */
 void RegressionDistribution::Train(const arma::mat& observations)
 {
-  regression::LinearRegression lr(observations.rows(1, observations.n_rows - 1),
-      arma::rowvec(observations.row(0)), 0, true);
-  rf = lr;
-  arma::rowvec fitted;
-  lr.Predict(observations.rows(1, observations.n_rows - 1), fitted);
-  err.Train(observations.row(0) - fitted);
+  rf.Lambda() = 0.0;
+  rf.Train(observations, 0, arma::rowvec(), true);
+  err.Train(Residuals(observations));
 }
 
 /**
@@ -44,12 +41,29 @@ void RegressionDistribution::Train(const arma::mat& observations,
 void RegressionDistribution::Train(const arma::mat& observations,
                                    const arma::rowvec& weights)
 {
-  regression::LinearRegression lr(observations.rows(1, observations.n_rows - 1),
-      arma::rowvec(observations.row(0)), weights, 0, true);
-  rf = lr;
-  arma::rowvec fitted;
-  lr.Predict(observations.rows(1, observations.n_rows - 1), fitted);
-  err.Train(observations.row(0) - fitted, weights.t());
+  // The predictors are read from the observations in place, so no weighted or
+  // sliced copy of the observations is made.
+  rf.Lambda() = 0.0;
+  rf.Train(observations, 0, weights, true);
+  err.Train(Residuals(observations), weights.t());
+}
+
+/**
+ * Compute the residuals y - (b_0 + b^T x) of the given observations as one
+ * product with the observations, without copying the predictors.
+ */
+arma::rowvec RegressionDistribution::Residuals(const arma::mat& observations)
+    const
+{
+  const arma::vec& parameters = rf.Parameters();
+  arma::vec coefficients(observations.n_rows);
+  coefficients[0] = 1.0;
+  coefficients.subvec(1, coefficients.n_elem - 1) =
+      -parameters.subvec(1, parameters.n_elem - 1);
+
+  arma::rowvec residuals = coefficients.t() * observations;
+  residuals -= parameters[0];
+  return residuals;
 }
 
 /**
@@ -35,6 +35,9 @@ class RegressionDistribution
   //! Error distribution.
   GaussianDistribution err;
 
+  //! Compute the residual of every observation under the regression function.
+  arma::rowvec Residuals(const arma::mat& observations) const;
+
  public:
   /**
    * Default constructor, which creates a Gaussian with zero dimension.
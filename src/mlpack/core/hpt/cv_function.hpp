@@ -69,6 +69,16 @@ class CVFunction
    */
   double Evaluate(const arma::mat& parameters);
 
+  /**
+   * Run cross-validation with the bound and passed parameters, without
+   * keeping the trained model as the best model.  Calls with different
+   * parameters may run in parallel.
+   *
+   * @param parameters Arguments (rather than the bound arguments) that should
+   *     be passed into the Evaluate method of the CVType object.
+   */
+  double EvaluateWithoutModel(const arma::mat& parameters);
+
   /**
    * Evaluate numerically the gradient of the CVFunction with the given
    * parameters.
@@ -82,6 +92,20 @@ class CVFunction
   //! Access and modify the best model so far.
   MLAlgorithm& BestModel() { return bestModel; }
 
+  //! Get the fraction of each training set the cross-validation trains on
+  //! (only available if the CVType object provides it).
+  double TrainingFraction() const { return cv.TrainingFraction(); }
+  //! Modify the fraction of each training set the cross-validation trains on
+  //! (only available if the CVType object provides it).
+  double& TrainingFraction() { return cv.TrainingFraction(); }
+
+  //! Get the seed of the random subsets the cross-validation trains on (only
+  //! available if the CVType object provides it).
+  size_t SubsetSeed() const { return cv.SubsetSeed(); }
+  //! Modify the seed of the random subsets the cross-validation trains on
+  //! (only available if the CVType object provides it).
+  size_t& SubsetSeed() { return cv.SubsetSeed(); }
+
  private:
   //! The type of tuples of BoundArgs.
   using BoundArgsTupleType = std::tuple<BoundArgs...>;
@@ -126,7 +150,9 @@ class CVFunction
            typename... Args,
            typename = typename
                std::enable_if<(BoundArgIndex + ParamIndex < TotalArgs)>::type>
-  inline double Evaluate(const arma::mat& parameters, const Args&... args);
+  inline double Evaluate(const arma::mat& parameters,
+                         const bool keepModel,
+                         const Args&... args);
 
   /**
    * Run cross-validation with the collected arguments.
@@ -137,7 +163,9 @@ class CVFunction
            typename = typename
                std::enable_if<BoundArgIndex + ParamIndex == TotalArgs>::type,
            typename = void>
-  inline double Evaluate(const arma::mat& parameters, const Args&... args);
+  inline double Evaluate(const arma::mat& parameters,
+                         const bool keepModel,
+                         const Args&... args);
 
   /**
    * Put the bound argument (at the BoundArgIndex position) as the next one.
@@ -147,7 +175,9 @@ class CVFunction
            typename... Args,
            typename = typename std::enable_if<
                UseBoundArg<BoundArgIndex, ParamIndex>::value>::type>
-  inline double PutNextArg(const arma::mat& parameters, const Args&... args);
+  inline double PutNextArg(const arma::mat& parameters,
+                           const bool keepModel,
+                           const Args&... args);
 
   /**
    * Put the element (at the ParamIndex position) of the parameters as the next
@@ -159,7 +189,9 @@ class CVFunction
            typename = typename std::enable_if<
                !UseBoundArg<BoundArgIndex, ParamIndex>::value>::type,
            typename = void>
-  inline double PutNextArg(const arma::mat& parameters, const Args&... args);
+  inline double PutNextArg(const arma::mat& parameters,
+                           const bool keepModel,
+                           const Args&... args);
 };
 
 
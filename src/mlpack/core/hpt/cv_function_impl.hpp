@@ -63,7 +63,17 @@ template<typename CVType,
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters)
 {
-  return Evaluate<0, 0>(parameters);
+  return Evaluate<0, 0>(parameters, true);
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+EvaluateWithoutModel(const arma::mat& parameters)
+{
+  return Evaluate<0, 0>(parameters, false);
 }
 
 template<typename CVType,
@@ -97,9 +107,10 @@ template<size_t BoundArgIndex,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters,
+    const bool keepModel,
     const Args&... args)
 {
-  return PutNextArg<BoundArgIndex, ParamIndex>(parameters, args...);
+  return PutNextArg<BoundArgIndex, ParamIndex>(parameters, keepModel, args...);
 }
 
 template<typename CVType,
@@ -113,9 +124,12 @@ template<size_t BoundArgIndex,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& /* parameters */,
+    const bool keepModel,
     const Args&... args)
 {
   double objective = cv.Evaluate(args...);
+  if (!keepModel)
+    return objective;
 
   // Change the best model if we have got a better score, or if we probably
   // have not assigned any valid (trained) model yet.
@@ -139,10 +153,11 @@ template<size_t BoundArgIndex,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
     const arma::mat& parameters,
+    const bool keepModel,
     const Args&... args)
 {
   return Evaluate<BoundArgIndex + 1, ParamIndex>(
-      parameters, args..., std::get<BoundArgIndex>(boundArgs).value);
+      parameters, keepModel, args..., std::get<BoundArgIndex>(boundArgs).value);
 }
 
 template<typename CVType,
@@ -156,10 +171,11 @@ template<size_t BoundArgIndex,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
     const arma::mat& parameters,
+    const bool keepModel,
     const Args&... args)
 {
   return Evaluate<BoundArgIndex, ParamIndex + 1>(
-      parameters, args..., parameters(ParamIndex, 0));
+      parameters, keepModel, args..., parameters(ParamIndex, 0));
 }
 
 } // namespace hpt
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -41,6 +42,18 @@ class CosineDistance
   template<typename VecTypeA, typename VecTypeB>
   static double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Evaluate the kernel between every column of a and every column of b, with
+   * one matrix multiplication.  KernelMatrix() uses this.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param result Matrix to store the kernel values in (a.n_cols x b.n_cols).
+   */
+  static void EvaluateBlock(const arma::mat& a,
+                            const arma::mat& b,
+                            arma::mat& result);
+
   //! Serialize the class (there's nothing to save).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -32,6 +32,22 @@ double CosineDistance::Evaluate(const VecTypeA& a, const VecTypeB& b)
     return dot(a, b) / denominator;
 }
 
+inline void CosineDistance::EvaluateBlock(const arma::mat& a,
+                                          const arma::mat& b,
+                                          arma::mat& result)
+{
+  // Points with a norm of 0 have a cosine similarity of 0 with everything (see
+  // above); their inverse norm is set to 0 to get that.
+  arma::rowvec aNorms = arma::sqrt(arma::sum(arma::square(a), 0));
+  arma::rowvec bNorms = arma::sqrt(arma::sum(arma::square(b), 0));
+  aNorms.transform([](const double n) { return (n == 0.0) ? 0.0 : 1.0 / n; });
+  bNorms.transform([](const double n) { return (n == 0.0) ? 0.0 : 1.0 / n; });
+
+  result = a.t() * b;
+  result.each_col() %= aNorms.t();
+  result.each_row() %= bNorms;
+}
+
 } // namespace kernel
 } // namespace mlpack
 
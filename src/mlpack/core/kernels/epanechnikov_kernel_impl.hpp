@@ -29,6 +29,15 @@ inline double EpanechnikovKernel::Evaluate(const VecTypeA& a, const VecTypeB& b)
       * inverseBandwidthSquared);
 }
 
+inline void EpanechnikovKernel::EvaluateBlock(const arma::mat& a,
+                                              const arma::mat& b,
+                                              arma::mat& result) const
+{
+  BlockSquaredDistances(a, b, result);
+  result = arma::clamp(1.0 - result * inverseBandwidthSquared, 0.0,
+      std::numeric_limits<double>::max());
+}
+
 /**
  * Obtains the convolution integral [integral of K(||x-a||) K(||b-x||) dx]
  * for the two vectors.
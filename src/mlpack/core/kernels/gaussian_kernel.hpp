@@ -15,6 +15,7 @@
 #define MLPACK_CORE_KERNELS_GAUSSIAN_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
 
@@ -68,6 +69,22 @@ class GaussianKernel
     return exp(gamma * metric::SquaredEuclideanDistance::Evaluate(a, b));
   }
 
+  /**
+   * Evaluate the kernel between every column of a and every column of b, with
+   * one matrix multiplication (for the squared distances).  KernelMatrix() uses this.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param result Matrix to store the kernel values in (a.n_cols x b.n_cols).
+   */
+  void EvaluateBlock(const arma::mat& a,
+                     const arma::mat& b,
+                     arma::mat& result) const
+  {
+    BlockSquaredDistances(a, b, result);
+    result = arma::exp(gamma * result);
+  }
+
   /**
    * Evaluation of the Gaussian kernel given the distance between two points.
    *
@@ -0,0 +1,180 @@
+/**
+ * @file kernel_matrix.hpp
+ *
+ * Computation of kernel matrices, in blocks, with one matrix multiplication per
+ * block for the kernels that support it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Compute the squared Euclidean distances between every column of a and every
+ * column of b, as ||a_i||^2 + ||b_j||^2 - 2 a_i^T b_j, so that the work is one
+ * matrix multiplication.  Negative values caused by rounding are set to 0.
+ *
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param distances Matrix to store the distances in (a.n_cols x b.n_cols).
+ */
+inline void BlockSquaredDistances(const arma::mat& a,
+                                  const arma::mat& b,
+                                  arma::mat& distances)
+{
+  distances = -2.0 * (a.t() * b);
+  distances.each_col() += arma::sum(arma::square(a), 0).t();
+  distances.each_row() += arma::sum(arma::square(b), 0);
+  distances.transform([](const double d) { return std::max(d, 0.0); });
+}
+
+// This gives us a HasEvaluateBlockCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a kernel has an
+// EvaluateBlock(...) function.
+HAS_MEM_FUNC(EvaluateBlock, HasEvaluateBlockCheck);
+
+/**
+ * 'value' is true if the kernel has a member EvaluateBlock(const arma::mat& a,
+ * const arma::mat& b, arma::mat& result) that evaluates the kernel between
+ * every column of a and every column of b.
+ */
+template<typename KernelType>
+struct HasEvaluateBlock
+{
+  static const bool value =
+    // Non-static version.
+    HasEvaluateBlockCheck<KernelType,
+        void(KernelType::*)(const arma::mat&,
+                            const arma::mat&,
+                            arma::mat&) const>::value ||
+    // Static version.
+    HasEvaluateBlockCheck<KernelType,
+        void(*)(const arma::mat&, const arma::mat&, arma::mat&)>::value;
+};
+
+//! Evaluate a block of the kernel matrix with the kernel's EvaluateBlock().
+template<typename KernelType>
+void EvaluateKernelBlock(
+    KernelType& kernel,
+    const arma::mat& a,
+    const arma::mat& b,
+    arma::mat& result,
+    const typename std::enable_if_t<HasEvaluateBlock<KernelType>::value>* = 0)
+{
+  kernel.EvaluateBlock(a, b, result);
+}
+
+//! Evaluate a block of the kernel matrix one pair of points at a time.
+template<typename KernelType>
+void EvaluateKernelBlock(
+    KernelType& kernel,
+    const arma::mat& a,
+    const arma::mat& b,
+    arma::mat& result,
+    const typename std::enable_if_t<!HasEvaluateBlock<KernelType>::value>* = 0)
+{
+  for (size_t j = 0; j < b.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      result(i, j) = kernel.Evaluate(a.unsafe_col(i), b.unsafe_col(j));
+}
+
+/**
+ * Compute the kernel matrix between every column of a and every column of b:
+ * result(i, j) = K(a_i, b_j).  The columns of the result are computed in
+ * blocks, in parallel (see Threads).  Kernels with an EvaluateBlock() member
+ * (the dot-product- and distance-based kernels) compute each block with one
+ * matrix multiplication followed by an elementwise transform; other kernels
+ * are evaluated one pair of points at a time.
+ *
+ * The kernel must be usable from several threads at once.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param result Matrix to store the kernel matrix in (a.n_cols x b.n_cols).
+ */
+template<typename KernelType>
+void KernelMatrix(KernelType& kernel,
+                  const arma::mat& a,
+                  const arma::mat& b,
+                  arma::mat& result)
+{
+  // Each block is large enough for an efficient matrix multiplication.
+  const size_t blockSize = 256;
+  const size_t numBlocks = (b.n_cols + blockSize - 1) / blockSize;
+
+  result.set_size(a.n_cols, b.n_cols);
+  Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    const size_t begin = block * blockSize;
+    const size_t count = std::min(blockSize, (size_t) b.n_cols - begin);
+
+    // Aliases of the columns of b and of the result; no memory is copied.
+    const arma::mat bBlock(const_cast<double*>(b.colptr(begin)), b.n_rows,
+        count, false, true);
+    arma::mat resultBlock(result.colptr(begin), a.n_cols, count, false, true);
+    EvaluateKernelBlock(kernel, a, bBlock, resultBlock);
+  });
+}
+
+/**
+ * Compute the (symmetric) kernel matrix of the given points: result(i, j) =
+ * K(x_i, x_j).  This overload is used for kernels with an EvaluateBlock()
+ * member; see KernelMatrix(kernel, a, b, result).
+ *
+ * @param kernel Kernel to evaluate.
+ * @param data Set of points.
+ * @param result Matrix to store the kernel matrix in (data.n_cols x
+ *     data.n_cols).
+ */
+template<typename KernelType>
+void KernelMatrix(
+    KernelType& kernel,
+    const arma::mat& data,
+    arma::mat& result,
+    const typename std::enable_if_t<HasEvaluateBlock<KernelType>::value>* = 0)
+{
+  KernelMatrix(kernel, data, data, result);
+}
+
+/**
+ * Compute the (symmetric) kernel matrix of the given points: result(i, j) =
+ * K(x_i, x_j).  This overload is used for kernels without an EvaluateBlock()
+ * member: only the upper triangle is evaluated (in parallel), and it is then
+ * copied to the lower triangle.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param data Set of points.
+ * @param result Matrix to store the kernel matrix in (data.n_cols x
+ *     data.n_cols).
+ */
+template<typename KernelType>
+void KernelMatrix(
+    KernelType& kernel,
+    const arma::mat& data,
+    arma::mat& result,
+    const typename std::enable_if_t<!HasEvaluateBlock<KernelType>::value>* = 0)
+{
+  result.set_size(data.n_cols, data.n_cols);
+  Threads::ParallelFor(0, data.n_cols, [&](const size_t j)
+  {
+    for (size_t i = 0; i <= j; ++i)
+      result(i, j) = kernel.Evaluate(data.unsafe_col(i), data.unsafe_col(j));
+  });
+
+  result = arma::symmatu(result);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
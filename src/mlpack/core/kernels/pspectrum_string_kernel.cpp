@@ -23,65 +23,134 @@ using namespace mlpack::kernel;
  * Initialize the PSpectrumStringKernel with the given string datasets.  For
  * more information on this, see the general class documentation.
  *
- * @param datasets Sets of string data.  @param p The length of substrings to
- * search.
+ * @param datasets Sets of string data.
+ * @param p The length of substrings to search.
  */
 mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
     const std::vector<std::vector<std::string> >& datasets,
     const size_t p) :
+    datasets(&datasets),
     p(p)
 {
-  // We have to assemble the counts of substrings.  This is not a particularly
-  // fast operation, unfortunately, but it only needs to be done once.
+  // We have to assemble the substrings of every string.  This only needs to
+  // be done once, and the strings are handled in parallel.
   Log::Info << "Assembling counts of substrings of length " << p << "."
       << std::endl;
 
-  // Resize for number of datasets.
-  counts.resize(datasets.size());
-
+  // Resize for number of datasets and strings, and find the first string of
+  // every dataset in the list of all strings.
+  spectra.resize(datasets.size());
+  std::vector<size_t> firstString(datasets.size() + 1, 0);
   for (size_t dataset = 0; dataset < datasets.size(); ++dataset)
   {
-    const std::vector<std::string>& set = datasets[dataset];
+    spectra[dataset].resize(datasets[dataset].size());
+    firstString[dataset + 1] = firstString[dataset] + datasets[dataset].size();
+  }
 
-    // Resize for number of strings in dataset.
-    counts[dataset].resize(set.size());
+  Threads::ParallelFor(0, firstString.back(), [&](const size_t string)
+  {
+    const size_t dataset = std::upper_bound(firstString.begin(),
+        firstString.end(), string) - firstString.begin() - 1;
+    const size_t index = string - firstString[dataset];
+
+    // Convenience references.
+    const std::string& str = datasets[dataset][index];
+    Spectrum& spectrum = spectra[dataset][index];
+
+    // Collect the codes of all valid substrings, then sort them and count the
+    // runs of equal codes.
+    std::vector<uint64_t> codes;
+    if (p > 0 && str.length() >= p)
+      codes.reserve(str.length() - p + 1);
+    for (size_t start = 0; p > 0 && start + p <= str.length(); ++start)
+    {
+      uint64_t code;
+      if (Encode(str, start, p, code))
+        codes.push_back(code);
+    }
+
+    std::sort(codes.begin(), codes.end());
+    for (size_t i = 0; i < codes.size(); ++i)
+    {
+      if (spectrum.empty() || spectrum.back().first != codes[i])
+        spectrum.push_back(std::make_pair(codes[i], (size_t) 0));
+      ++spectrum.back().second;
+    }
+    spectrum.shrink_to_fit();
+  });
+
+  Log::Info << "Substring extraction complete." << std::endl;
+}
+
+size_t mlpack::kernel::PSpectrumStringKernel::Count(
+    const size_t dataset,
+    const size_t index,
+    const std::string& substring) const
+{
+  uint64_t code;
+  if (substring.length() != p || !Encode(substring, 0, p, code))
+    return 0;
+
+  const Spectrum& spectrum = spectra[dataset][index];
+  Spectrum::const_iterator it = std::lower_bound(spectrum.begin(),
+      spectrum.end(), std::make_pair(code, (size_t) 0));
+
+  return (it != spectrum.end() && it->first == code) ? it->second : 0;
+}
 
-    // Inspect each string in the dataset.
+std::vector<std::vector<std::map<std::string, int> > >
+mlpack::kernel::PSpectrumStringKernel::Counts() const
+{
+  std::vector<std::vector<std::map<std::string, int> > > counts(
+      datasets->size());
+  for (size_t dataset = 0; dataset < datasets->size(); ++dataset)
+  {
+    const std::vector<std::string>& set = (*datasets)[dataset];
+    counts[dataset].resize(set.size());
     for (size_t index = 0; index < set.size(); ++index)
     {
-      // Convenience references.
       const std::string& str = set[index];
-      std::map<std::string, int>& mapping = counts[dataset][index];
-
-      size_t start = 0;
-      while ((start + p) <= str.length())
+      for (size_t start = 0; p > 0 && start + p <= str.length(); ++start)
       {
-        string sub = str.substr(start, p);
+        uint64_t code;
+        if (!Encode(str, start, p, code))
+          continue;
 
-        // Convert all characters to lowercase.
-        bool invalid = false;
+        string sub = str.substr(start, p);
         for (size_t j = 0; j < p; ++j)
-        {
-          if (!isalnum(sub[j]))
-          {
-            invalid = true;
-            break; // Only consider substrings with alphanumerics.
-          }
-
           sub[j] = tolower(sub[j]);
-        }
-
-        // Increment position in string.
-        ++start;
-
-        if (!invalid)
-        {
-          // Add to the map.
-          ++mapping[sub];
-        }
+        ++counts[dataset][index][sub];
       }
     }
   }
 
-  Log::Info << "Substring extraction complete." << std::endl;
+  return counts;
+}
+
+bool mlpack::kernel::PSpectrumStringKernel::Encode(const std::string& str,
+                                                   const size_t start,
+                                                   const size_t p,
+                                                   uint64_t& code)
+{
+  // 36^12 is the largest power of 36 that fits in 64 bits.
+  const bool exact = (p <= 12);
+
+  // The hash is 64-bit FNV-1a.
+  code = exact ? 0 : 14695981039346656037ULL;
+  for (size_t j = start; j < start + p; ++j)
+  {
+    // Only consider substrings with (ASCII) alphanumerics.
+    const unsigned char c = str[j];
+    if (c >= 128 || !isalnum(c))
+      return false;
+
+    // Digits come first, and letters are converted to lowercase.
+    const uint64_t value = isdigit(c) ? (c - '0') : (tolower(c) - 'a' + 10);
+    if (exact)
+      code = 36 * code + value;
+    else
+      code = (code ^ value) * 1099511628211ULL;
+  }
+
+  return true;
 }
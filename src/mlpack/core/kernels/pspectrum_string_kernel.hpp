@@ -22,6 +22,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/log.hpp>
+#include <mlpack/core/util/deprecated.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -61,6 +62,12 @@ namespace kernel {
  * the data according to the fake data matrix -- resulting in a meaningless
  * tree.  This kernel was originally written for the FastMKS method; so, at the
  * very least, it will work with that.
+ *
+ * Substrings are stored as 64-bit codes.  If p is more than 12, the codes are
+ * hashes, and two different substrings may (very rarely) get the same code; the
+ * kernel then counts them as the same substring, so it may overestimate the
+ * number of matches.  With n distinct substrings, the probability of any
+ * collision is about n^2 / 2^65.
  */
 class PSpectrumStringKernel
 {
@@ -89,12 +96,60 @@ class PSpectrumStringKernel
   template<typename VecType>
   double Evaluate(const VecType& a, const VecType& b) const;
 
-  //! Access the lists of substrings.
-  const std::vector<std::vector<std::map<std::string, int> > >& Counts() const
-  { return counts; }
-  //! Modify the lists of substrings.
-  std::vector<std::vector<std::map<std::string, int> > >& Counts()
-  { return counts; }
+  /**
+   * The substrings of length p of one string.  Every distinct substring is
+   * coded as an integer (see Encode()), and the codes are sorted, each with the
+   * number of times the substring appears.
+   */
+  typedef std::vector<std::pair<uint64_t, size_t> > Spectrum;
+
+  //! Access the substrings of every string of every dataset.
+  const std::vector<std::vector<Spectrum> >& Spectra() const { return spectra; }
+
+  /**
+   * Get the number of times the given substring (of length p) appears in the
+   * given string.  The substring is compared without regard to case.
+   *
+   * @param dataset Index of the dataset.
+   * @param index Index of the string in the dataset.
+   * @param substring Substring to count.
+   */
+  size_t Count(const size_t dataset,
+               const size_t index,
+               const std::string& substring) const;
+
+  //! Get the number of distinct substrings of the given string.
+  size_t NumSubstrings(const size_t dataset, const size_t index) const
+  { return spectra[dataset][index].size(); }
+
+  /**
+   * Get the counts of the substrings of every string of every dataset, as
+   * maps from the (lowercase) substrings to their counts.  The maps are built
+   * from the datasets given to the constructor on every call, so the datasets
+   * must still exist.  This will be removed in mlpack 4.0.0; use Spectra(),
+   * Count() or NumSubstrings() instead.
+   */
+  mlpack_deprecated std::vector<std::vector<std::map<std::string, int> > >
+      Counts() const;
+
+  /**
+   * Compute the code of the substring of length p of the given string that
+   * starts at the given position.  Substrings are only considered if all of
+   * their characters are alphanumeric, and case is ignored.  If p is at most
+   * 12, the code is the substring itself written in base 36, so different
+   * substrings have different codes; longer substrings are hashed to 64 bits
+   * with FNV-1a, so different substrings may collide.
+   *
+   * @param str String to take the substring from.
+   * @param start Position of the first character of the substring.
+   * @param p Length of the substring.
+   * @param code Set to the code of the substring.
+   * @return false if the substring has a character that is not alphanumeric.
+   */
+  static bool Encode(const std::string& str,
+                     const size_t start,
+                     const size_t p,
+                     uint64_t& code);
 
   //! Access the value of p.
   size_t P() const { return p; }
@@ -102,9 +157,11 @@ class PSpectrumStringKernel
   size_t& P() { return p; }
 
  private:
-  //! Mappings of the datasets to counts of substrings.  Such a huge structure
-  //! is not wonderful...
-  std::vector<std::vector<std::map<std::string, int> > > counts;
+  //! The datasets given to the constructor (only used by Counts()).
+  const std::vector<std::vector<std::string> >* datasets;
+
+  //! The substrings of every string of every dataset.
+  std::vector<std::vector<Spectrum> > spectra;
 
   //! The value of p to use in calculation.
   size_t p;
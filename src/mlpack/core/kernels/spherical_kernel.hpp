@@ -12,6 +12,7 @@
 
 #include <boost/math/special_functions/gamma.hpp>
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -47,6 +48,23 @@ class SphericalKernel
         (metric::SquaredEuclideanDistance::Evaluate(a, b) <= bandwidthSquared) ?
         1.0 : 0.0;
   }
+
+  /**
+   * Evaluate the kernel between every column of a and every column of b, with
+   * one matrix multiplication (for the squared distances).  KernelMatrix() uses this.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param result Matrix to store the kernel values in (a.n_cols x b.n_cols).
+   */
+  void EvaluateBlock(const arma::mat& a,
+                     const arma::mat& b,
+                     arma::mat& result) const
+  {
+    BlockSquaredDistances(a, b, result);
+    result.transform([this](const double d)
+        { return (d <= bandwidthSquared) ? 1.0 : 0.0; });
+  }
   /**
    * Obtains the convolution integral [integral K(||x-a||)K(||b-x||)dx]
    * for the two vectors.
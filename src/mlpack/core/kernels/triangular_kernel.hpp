@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_TRIANGULAR_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 
 namespace mlpack {
@@ -52,6 +53,23 @@ class TriangularKernel
         bandwidth));
   }
 
+  /**
+   * Evaluate the kernel between every column of a and every column of b, with
+   * one matrix multiplication (for the squared distances).  KernelMatrix() uses this.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param result Matrix to store the kernel values in (a.n_cols x b.n_cols).
+   */
+  void EvaluateBlock(const arma::mat& a,
+                     const arma::mat& b,
+                     arma::mat& result) const
+  {
+    BlockSquaredDistances(a, b, result);
+    result = arma::clamp(1 - arma::sqrt(result) / bandwidth, 0.0,
+        std::numeric_limits<double>::max());
+  }
+
   /**
    * Evaluate the triangular kernel given that the distance between the two
    * points is known.
@@ -60,29 +60,28 @@ void ColumnsToBlocks::Transform(const arma::mat& maximalInputs,
 
   const size_t rowOffset = blockHeight+bufSize;
   const size_t colOffset = blockWidth+bufSize;
-  output.ones(bufSize + rows * rowOffset,
-              bufSize + cols * colOffset);
-  output *= bufValue;
+  output.set_size(bufSize + rows * rowOffset,
+                  bufSize + cols * colOffset);
+  output.fill(bufValue);
 
-  size_t k = 0;
+  // Every block is copied independently of the others, so the blocks are
+  // copied in parallel.  Block k is in row k / cols and column k % cols of
+  // blocks.
   const size_t maxSize = std::min(rows * cols, (size_t) maximalInputs.n_cols);
-  for (size_t i = 0; i != rows; ++i)
+  Threads::ParallelFor(0, maxSize, [&](const size_t k)
   {
-    for (size_t j = 0; j != cols; ++j)
-    {
-      // Now, copy the elements of the row to the output submatrix.
-      const size_t minRow = bufSize + i * rowOffset;
-      const size_t minCol = bufSize + j * colOffset;
-      const size_t maxRow = i * rowOffset + blockHeight;
-      const size_t maxCol = j * colOffset + blockWidth;
+    const size_t i = k / cols;
+    const size_t j = k % cols;
 
-      output.submat(minRow, minCol, maxRow, maxCol) =
-          arma::reshape(maximalInputs.col(k++), blockHeight, blockWidth);
+    // Now, copy the elements of the row to the output submatrix.
+    const size_t minRow = bufSize + i * rowOffset;
+    const size_t minCol = bufSize + j * colOffset;
+    const size_t maxRow = i * rowOffset + blockHeight;
+    const size_t maxCol = j * colOffset + blockWidth;
 
-      if (k >= maxSize)
-        break;
-    }
-  }
+    output.submat(minRow, minCol, maxRow, maxCol) =
+        arma::reshape(maximalInputs.col(k), blockHeight, blockWidth);
+  });
 
   if (scale)
   {
@@ -90,7 +89,10 @@ void ColumnsToBlocks::Transform(const arma::mat& maximalInputs,
     const double min = output.min();
     if ((max - min) != 0)
     {
-      output = (output - min) / (max - min) * (maxRange - minRange) + minRange;
+      // Scale in place, without temporary matrices.
+      const double factor = (maxRange - minRange) / (max - min);
+      output.transform([&](const double x)
+          { return (x - min) * factor + minRange; });
     }
   }
 }
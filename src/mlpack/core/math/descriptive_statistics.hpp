@@ -0,0 +1,280 @@
+/**
+ * @file descriptive_statistics.hpp
+ *
+ * Single-pass, mergeable descriptive statistics of every dimension of a
+ * dataset that is seen in chunks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_DESCRIPTIVE_STATISTICS_HPP
+#define MLPACK_CORE_MATH_DESCRIPTIVE_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "quantile_sketch.hpp"
+
+namespace mlpack {
+namespace math {
+
+/**
+ * The minimum, maximum, mean, variance, skewness, excess kurtosis and median
+ * of every dimension of a dataset, computed in one pass over chunks of points.
+ * The central moments of each chunk are computed with two passes over the
+ * chunk and then combined with the running ones (Pebay's update formulas), so
+ * they are as accurate as the two-pass formulas.  The median comes from a
+ * QuantileSketch, or, in exact mode, from all of the values, which are then
+ * kept in memory.
+ *
+ * The dimensions of a chunk are handled in parallel.  The statistics of
+ * disjoint parts of a dataset can be computed separately and merged with
+ * Merge().
+ *
+ * @code
+ * data::ChunkedReader<> reader("dataset.csv");
+ * math::DescriptiveStatistics statistics(reader.Dimensionality());
+ * arma::mat chunk;
+ * while (reader.NextChunk(chunk))
+ *   statistics.Add(chunk);
+ * @endcode
+ */
+class DescriptiveStatistics
+{
+ public:
+  /**
+   * Create the statistics of no points.
+   *
+   * @param dimensionality Dimensionality of the points.
+   * @param exact If true, keep all values, and compute the median exactly.
+   * @param sketchCapacity Capacity of the quantile sketch of each dimension.
+   */
+  DescriptiveStatistics(const size_t dimensionality = 0,
+                        const bool exact = false,
+                        const size_t sketchCapacity = 1024) :
+      exact(exact),
+      count(0),
+      mins(dimensionality),
+      maxs(dimensionality),
+      means(dimensionality, arma::fill::zeros),
+      m2(dimensionality, arma::fill::zeros),
+      m3(dimensionality, arma::fill::zeros),
+      m4(dimensionality, arma::fill::zeros),
+      sketches(exact ? 0 : dimensionality, QuantileSketch(sketchCapacity)),
+      values(exact ? dimensionality : 0)
+  {
+    mins.fill(std::numeric_limits<double>::infinity());
+    maxs.fill(-std::numeric_limits<double>::infinity());
+  }
+
+  /**
+   * Add the given points (one per column) to the statistics.
+   *
+   * @param points The points to add.
+   */
+  void Add(const arma::mat& points)
+  {
+    if (points.n_rows != Dimensionality())
+    {
+      std::ostringstream oss;
+      oss << "DescriptiveStatistics::Add(): points have dimensionality "
+          << points.n_rows << ", but the statistics have dimensionality "
+          << Dimensionality() << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (points.n_cols == 0)
+      return;
+
+    // Every dimension becomes a contiguous column.
+    const arma::mat dimensions = points.t();
+    const double n = (double) points.n_cols;
+
+    Threads::ParallelFor(0, dimensions.n_cols, [&](const size_t d)
+    {
+      const arma::vec& x = dimensions.unsafe_col(d);
+      mins[d] = std::min(mins[d], x.min());
+      maxs[d] = std::max(maxs[d], x.max());
+
+      const double mean = arma::mean(x);
+      const arma::vec deviations = x - mean;
+      const arma::vec squares = arma::square(deviations);
+      Combine(d, n, mean, arma::accu(squares),
+          arma::dot(squares, deviations), arma::dot(squares, squares));
+
+      if (exact)
+      {
+        values[d].insert(values[d].end(), x.begin(), x.end());
+      }
+      else
+      {
+        for (size_t i = 0; i < x.n_elem; ++i)
+          sketches[d].Insert(x[i]);
+      }
+    });
+
+    count += points.n_cols;
+  }
+
+  /**
+   * Add the statistics of other points to these ones.  Both must have the same
+   * dimensionality and mode.
+   *
+   * @param other The statistics to merge.
+   */
+  void Merge(const DescriptiveStatistics& other)
+  {
+    if (other.Dimensionality() != Dimensionality() || other.exact != exact)
+    {
+      throw std::invalid_argument("DescriptiveStatistics::Merge(): the "
+          "statistics have different dimensionalities or modes!");
+    }
+
+    if (other.count == 0)
+      return;
+
+    Threads::ParallelFor(0, Dimensionality(), [&](const size_t d)
+    {
+      mins[d] = std::min(mins[d], other.mins[d]);
+      maxs[d] = std::max(maxs[d], other.maxs[d]);
+      Combine(d, (double) other.count, other.means[d], other.m2[d],
+          other.m3[d], other.m4[d]);
+
+      if (exact)
+        values[d].insert(values[d].end(), other.values[d].begin(),
+            other.values[d].end());
+      else
+        sketches[d].Merge(other.sketches[d]);
+    });
+
+    count += other.count;
+  }
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return means.n_elem; }
+  //! Get the number of points.
+  size_t Count() const { return count; }
+  //! Get whether the median is computed exactly.
+  bool Exact() const { return exact; }
+
+  //! Get the minimum of the given dimension.
+  double Min(const size_t d) const { return mins[d]; }
+  //! Get the maximum of the given dimension.
+  double Max(const size_t d) const { return maxs[d]; }
+  //! Get the mean of the given dimension.
+  double Mean(const size_t d) const { return means[d]; }
+
+  //! Get the variance of the given dimension, as a population or a sample.
+  double Variance(const size_t d, const bool population = false) const
+  { return m2[d] / (population ? count : count - 1.0); }
+
+  //! Get the standard deviation of the given dimension, as a population or a
+  //! sample.
+  double StandardDeviation(const size_t d, const bool population = false)
+      const
+  { return std::sqrt(Variance(d, population)); }
+
+  //! Get the skewness of the given dimension, as a population or a sample.
+  double Skewness(const size_t d, const bool population = false) const
+  {
+    const double n = (double) count;
+    const double s3 = std::pow(StandardDeviation(d, population), 3.0);
+    if (population)
+      return m3[d] / (n * s3);
+    else
+      return n * m3[d] / ((n - 1) * (n - 2) * s3);
+  }
+
+  //! Get the excess kurtosis of the given dimension, as a population or a
+  //! sample.
+  double Kurtosis(const size_t d, const bool population = false) const
+  {
+    const double n = (double) count;
+    if (population)
+      return n * m4[d] / (m2[d] * m2[d]) - 3;
+
+    const double s4 = std::pow(StandardDeviation(d, population), 4.0);
+    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
+    return normC * m4[d] / s4 - norm3;
+  }
+
+  /**
+   * Get the median of the given dimension.  In exact mode, the median of an
+   * even number of values is the mean of the two middle ones; otherwise it is
+   * approximated with the quantile sketch.
+   */
+  double Median(const size_t d) const
+  {
+    if (!exact)
+      return sketches[d].Quantile(0.5);
+
+    if (values[d].empty())
+      return std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<double> sorted(values[d]);
+    const size_t middle = sorted.size() / 2;
+    std::nth_element(sorted.begin(), sorted.begin() + middle, sorted.end());
+    const double upper = sorted[middle];
+    if (sorted.size() % 2 == 1)
+      return upper;
+
+    const double lower = *std::max_element(sorted.begin(),
+        sorted.begin() + middle);
+    return (lower + upper) / 2;
+  }
+
+ private:
+  //! If true, all values are kept, and the median is exact.
+  bool exact;
+  //! The number of points.
+  size_t count;
+  //! The minimum of every dimension.
+  arma::vec mins;
+  //! The maximum of every dimension.
+  arma::vec maxs;
+  //! The mean of every dimension.
+  arma::vec means;
+  //! The sum of squared deviations from the mean of every dimension.
+  arma::vec m2;
+  //! The sum of cubed deviations from the mean of every dimension.
+  arma::vec m3;
+  //! The sum of fourth powers of deviations from the mean of every dimension.
+  arma::vec m4;
+  //! The quantile sketch of every dimension, if not exact.
+  std::vector<QuantileSketch> sketches;
+  //! All values of every dimension, if exact.
+  std::vector<std::vector<double>> values;
+
+  /**
+   * Combine the moments of the given dimension with those of nB other values
+   * of the given mean and central moments.
+   */
+  void Combine(const size_t d,
+               const double nB,
+               const double meanB,
+               const double m2B,
+               const double m3B,
+               const double m4B)
+  {
+    const double nA = (double) count;
+    const double n = nA + nB;
+    const double delta = meanB - means[d];
+    const double delta2 = delta * delta;
+    const double m2A = m2[d];
+    const double m3A = m3[d];
+
+    means[d] += delta * nB / n;
+    m2[d] = m2A + m2B + delta2 * nA * nB / n;
+    m3[d] = m3A + m3B + delta2 * delta * nA * nB * (nA - nB) / (n * n) +
+        3 * delta * (nA * m2B - nB * m2A) / n;
+    m4[d] += m4B + delta2 * delta2 * nA * nB * (nA * nA - nA * nB + nB * nB) /
+        (n * n * n) + 6 * delta2 * (nA * nA * m2B + nB * nB * m2A) / (n * n) +
+        4 * delta * (nA * m3B - nB * m3A) / n;
+  }
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
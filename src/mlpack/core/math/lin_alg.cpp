@@ -13,6 +13,10 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/random.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace math;
 
@@ -33,6 +37,116 @@ void mlpack::math::VectorPower(arma::vec& vec, const double power)
   }
 }
 
+namespace {
+
+//! The number of columns that are handled at once.
+const size_t columnBlockSize = 4096;
+
+/**
+ * Call f(begin, end) for every block [begin, end) of the given number of
+ * columns, in parallel.
+ */
+template<typename FunctionType>
+void ForEachColumnBlock(const size_t cols, FunctionType f)
+{
+  const size_t numBlocks = (cols + columnBlockSize - 1) / columnBlockSize;
+  Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    const size_t begin = block * columnBlockSize;
+    f(begin, std::min(cols, begin + columnBlockSize));
+  });
+}
+
+/**
+ * Sum the d x d matrices that f(begin, end, sum) adds to sum for the blocks of
+ * the given number of columns.  The blocks are split into one range per task;
+ * every range has its own sum, and the sums are added in order.
+ */
+template<typename FunctionType>
+arma::mat SumColumnBlocks(const size_t d, const size_t cols, FunctionType f)
+{
+  const size_t numBlocks = (cols + columnBlockSize - 1) / columnBlockSize;
+  const size_t numRanges = std::max((size_t) 1,
+      std::min(Threads::Count(), numBlocks));
+
+  std::vector<arma::mat> sums(numRanges);
+  Threads::ParallelFor(0, numRanges, [&](const size_t range)
+  {
+    sums[range].zeros(d, d);
+    const size_t firstBlock = range * numBlocks / numRanges;
+    const size_t lastBlock = (range + 1) * numBlocks / numRanges;
+    for (size_t block = firstBlock; block < lastBlock; ++block)
+    {
+      const size_t begin = block * columnBlockSize;
+      f(begin, std::min(cols, begin + columnBlockSize), sums[range]);
+    }
+  });
+
+  arma::mat sum(d, d, arma::fill::zeros);
+  for (size_t range = 0; range < numRanges; ++range)
+    sum += sums[range];
+
+  return sum;
+}
+
+//! Compute the whitening matrix with the SVD of the given covariance matrix.
+void WhiteningMatrixSVD(const arma::mat& covariance,
+                        arma::mat& whiteningMatrix)
+{
+  arma::mat u, v, invSMatrix;
+  arma::vec sVector;
+
+  svd(u, sVector, v, covariance);
+
+  size_t d = sVector.n_elem;
+  invSMatrix.zeros(d, d);
+  invSMatrix.diag() = 1 / sqrt(sVector);
+
+  whiteningMatrix = v * invSMatrix * trans(u);
+}
+
+//! Compute the whitening matrix with the eigendecomposition of the given
+//! covariance matrix.
+void WhiteningMatrixEig(const arma::mat& covariance,
+                        arma::mat& whiteningMatrix)
+{
+  arma::mat diag, eigenvectors;
+  arma::vec eigenvalues;
+
+  // Get eigenvectors of covariance of input matrix.
+  eig_sym(eigenvalues, eigenvectors, covariance);
+
+  // Generate diagonal matrix using 1 / sqrt(eigenvalues) for each value.
+  VectorPower(eigenvalues, -0.5);
+  diag.zeros(eigenvalues.n_elem, eigenvalues.n_elem);
+  diag.diag() = eigenvalues;
+
+  // Our whitening matrix is diag(1 / sqrt(eigenvectors)) * eigenvalues.
+  whiteningMatrix = diag * trans(eigenvectors);
+}
+
+/**
+ * Compute the matrix that orthogonalizes x, C^{-0.5}, where C is the
+ * covariance matrix of x.
+ */
+void OrthogonalizationMatrix(const arma::mat& x, arma::mat& at)
+{
+  // For a matrix A, A^N = V * D^N * V', where VDV' is the
+  // eigendecomposition of the matrix A.
+  arma::vec mean, egval;
+  arma::mat covariance, eigenvalues, eigenvectors;
+  Covariance(x, mean, covariance);
+  eig_sym(egval, eigenvectors, covariance);
+  VectorPower(egval, -0.5);
+
+  eigenvalues.zeros(egval.n_elem, egval.n_elem);
+  eigenvalues.diag() = egval;
+
+  at = (eigenvectors * eigenvalues * trans(eigenvectors));
+}
+
+} // anonymous namespace
+
 /**
  * Creates a centered matrix, where centering is done by subtracting
  * the sum over the columns (a column vector) from each column of the matrix.
@@ -42,10 +156,85 @@ void mlpack::math::VectorPower(arma::vec& vec, const double power)
  */
 void mlpack::math::Center(const arma::mat& x, arma::mat& xCentered)
 {
+  if (&x != &xCentered)
+    xCentered = x;
+
+  Center(xCentered);
+}
+
+/**
+ * Center a matrix in place, by subtracting the mean of the columns from each
+ * column.
+ */
+void mlpack::math::Center(arma::mat& x)
+{
+  if (x.n_cols == 0)
+    return;
+
   // Get the mean of the elements in each row.
-  arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
+  const arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
 
-  xCentered = x - arma::repmat(rowMean, 1, x.n_cols);
+  ForEachColumnBlock(x.n_cols, [&](const size_t begin, const size_t end)
+  {
+    x.cols(begin, end - 1).each_col() -= rowMean;
+  });
+}
+
+/**
+ * Compute the mean and the covariance matrix of the columns of x without a
+ * centered copy of x.
+ */
+void mlpack::math::Covariance(const arma::mat& x,
+                              arma::vec& mean,
+                              arma::mat& covariance)
+{
+  if (x.n_cols == 0)
+  {
+    mean.zeros(x.n_rows);
+    covariance.zeros(x.n_rows, x.n_rows);
+    return;
+  }
+
+  mean = arma::sum(x, 1) / x.n_cols;
+
+  // Only one block of columns is centered at a time.
+  covariance = SumColumnBlocks(x.n_rows, x.n_cols,
+      [&](const size_t begin, const size_t end, arma::mat& sum)
+  {
+    arma::mat block = x.cols(begin, end - 1);
+    block.each_col() -= mean;
+    sum += block * block.t();
+  });
+
+  covariance /= (x.n_cols > 1) ? (x.n_cols - 1) : 1;
+}
+
+/**
+ * Compute the mean and the covariance matrix of the columns of a sparse
+ * matrix, folding the centering into the product.
+ */
+void mlpack::math::Covariance(const arma::sp_mat& x,
+                              arma::vec& mean,
+                              arma::mat& covariance)
+{
+  if (x.n_cols == 0)
+  {
+    mean.zeros(x.n_rows);
+    covariance.zeros(x.n_rows, x.n_rows);
+    return;
+  }
+
+  mean = arma::vec(arma::mat(arma::sum(x, 1))) / x.n_cols;
+
+  covariance = SumColumnBlocks(x.n_rows, x.n_cols,
+      [&](const size_t begin, const size_t end, arma::mat& sum)
+  {
+    const arma::sp_mat block = x.cols(begin, end - 1);
+    sum += block * block.t();
+  });
+
+  covariance -= x.n_cols * (mean * mean.t());
+  covariance /= (x.n_cols > 1) ? (x.n_cols - 1) : 1;
 }
 
 /**
@@ -57,19 +246,27 @@ void mlpack::math::WhitenUsingSVD(const arma::mat& x,
                                   arma::mat& xWhitened,
                                   arma::mat& whiteningMatrix)
 {
-  arma::mat covX, u, v, invSMatrix, temp1;
-  arma::vec sVector;
+  arma::vec mean;
+  arma::mat covX;
+  Covariance(x, mean, covX);
 
-  covX = ccov(x);
-
-  svd(u, sVector, v, covX);
-
-  size_t d = sVector.n_elem;
-  invSMatrix.zeros(d, d);
-  invSMatrix.diag() = 1 / sqrt(sVector);
+  WhiteningMatrixSVD(covX, whiteningMatrix);
+  xWhitened = whiteningMatrix * x;
+}
 
-  whiteningMatrix = v * invSMatrix * trans(u);
+/**
+ * Whitens a sparse matrix using the singular value decomposition of its
+ * covariance matrix.
+ */
+void mlpack::math::WhitenUsingSVD(const arma::sp_mat& x,
+                                  arma::mat& xWhitened,
+                                  arma::mat& whiteningMatrix)
+{
+  arma::vec mean;
+  arma::mat covX;
+  Covariance(x, mean, covX);
 
+  WhiteningMatrixSVD(covX, whiteningMatrix);
   xWhitened = whiteningMatrix * x;
 }
 
@@ -81,19 +278,29 @@ void mlpack::math::WhitenUsingEig(const arma::mat& x,
                                   arma::mat& xWhitened,
                                   arma::mat& whiteningMatrix)
 {
-  arma::mat diag, eigenvectors;
-  arma::vec eigenvalues;
+  arma::vec mean;
+  arma::mat covX;
+  Covariance(x, mean, covX);
 
-  // Get eigenvectors of covariance of input matrix.
-  eig_sym(eigenvalues, eigenvectors, ccov(x));
+  WhiteningMatrixEig(covX, whiteningMatrix);
 
-  // Generate diagonal matrix using 1 / sqrt(eigenvalues) for each value.
-  VectorPower(eigenvalues, -0.5);
-  diag.zeros(eigenvalues.n_elem, eigenvalues.n_elem);
-  diag.diag() = eigenvalues;
+  // Now apply the whitening matrix.
+  xWhitened = whiteningMatrix * x;
+}
 
-  // Our whitening matrix is diag(1 / sqrt(eigenvectors)) * eigenvalues.
-  whiteningMatrix = diag * trans(eigenvectors);
+/**
+ * Whitens a sparse matrix using the eigendecomposition of its covariance
+ * matrix.
+ */
+void mlpack::math::WhitenUsingEig(const arma::sp_mat& x,
+                                  arma::mat& xWhitened,
+                                  arma::mat& whiteningMatrix)
+{
+  arma::vec mean;
+  arma::mat covX;
+  Covariance(x, mean, covX);
+
+  WhiteningMatrixEig(covX, whiteningMatrix);
 
   // Now apply the whitening matrix.
   xWhitened = whiteningMatrix * x;
@@ -131,28 +338,31 @@ void mlpack::math::RandVector(arma::vec& v)
  */
 void mlpack::math::Orthogonalize(const arma::mat& x, arma::mat& W)
 {
-  // For a matrix A, A^N = V * D^N * V', where VDV' is the
-  // eigendecomposition of the matrix A.
-  arma::mat eigenvalues, eigenvectors;
-  arma::vec egval;
-  eig_sym(egval, eigenvectors, ccov(x));
-  VectorPower(egval, -0.5);
-
-  eigenvalues.zeros(egval.n_elem, egval.n_elem);
-  eigenvalues.diag() = egval;
+  if (&x == &W)
+  {
+    Orthogonalize(W);
+    return;
+  }
 
-  arma::mat at = (eigenvectors * eigenvalues * trans(eigenvectors));
+  arma::mat at;
+  OrthogonalizationMatrix(x, at);
 
   W = at * x;
 }
 
 /**
- * Orthogonalize x in-place.  This could be sped up by a custom
- * implementation.
+ * Orthogonalize x in-place.  The columns are transformed in parallel blocks,
+ * so only one block is copied at a time.
  */
 void mlpack::math::Orthogonalize(arma::mat& x)
 {
-  Orthogonalize(x, x);
+  arma::mat at;
+  OrthogonalizationMatrix(x, at);
+
+  ForEachColumnBlock(x.n_cols, [&](const size_t begin, const size_t end)
+  {
+    x.cols(begin, end - 1) = at * x.cols(begin, end - 1);
+  });
 }
 
 /**
@@ -303,3 +513,121 @@ void mlpack::math::SymKronId(const arma::mat& A, arma::mat& op)
     }
   }
 }
+
+bool mlpack::math::TSQR(const arma::mat& x,
+                        arma::mat& q,
+                        arma::mat& r,
+                        const size_t numBlocks)
+{
+  size_t blocks = numBlocks;
+  if (blocks == 0)
+  {
+    blocks = 1;
+    #ifdef HAS_OPENMP
+      blocks = omp_get_max_threads();
+    #endif
+  }
+
+  // Each block must be at least as tall as it is wide.
+  blocks = std::min(blocks, (size_t) x.n_rows / std::max((size_t) x.n_cols,
+      (size_t) 1));
+  if (blocks <= 1)
+    return arma::qr_econ(q, r, x);
+
+  const size_t cols = x.n_cols;
+  std::vector<arma::mat> localQ(blocks);
+  arma::mat stackedR(blocks * cols, cols);
+  bool success = true;
+
+  #pragma omp parallel for reduction(&&:success)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    const size_t begin = b * x.n_rows / blocks;
+    const size_t end = (b + 1) * x.n_rows / blocks;
+
+    arma::mat localR;
+    success = arma::qr_econ(localQ[b], localR, x.rows(begin, end - 1)) &&
+        success;
+    stackedR.rows(b * cols, (b + 1) * cols - 1) = localR;
+  }
+
+  if (!success)
+    return false;
+
+  // Decompose the stacked R factors, and apply the result to each block.
+  arma::mat stackedQ;
+  if (!arma::qr_econ(stackedQ, r, stackedR))
+    return false;
+
+  q.set_size(x.n_rows, cols);
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    const size_t begin = b * x.n_rows / blocks;
+    const size_t end = (b + 1) * x.n_rows / blocks;
+    q.rows(begin, end - 1) = localQ[b] *
+        stackedQ.rows(b * cols, (b + 1) * cols - 1);
+  }
+
+  return true;
+}
+
+void mlpack::math::Multiply(const arma::sp_mat& x,
+                            const arma::mat& y,
+                            arma::mat& result)
+{
+  // Accumulate the rows of the result transposed, so that each one is
+  // contiguous in memory.
+  arma::mat resultT(y.n_cols, x.n_rows, arma::fill::zeros);
+  const arma::mat yt = y.t();
+
+  size_t blocks = 1;
+  #ifdef HAS_OPENMP
+    blocks = 4 * omp_get_max_threads();
+  #endif
+  blocks = std::max(std::min(blocks, (size_t) x.n_rows), (size_t) 1);
+
+  // Each block of rows of the result is only written by one thread, which
+  // visits the nonzero elements of x within its rows; the row indices of each
+  // column are sorted, so the range is found by binary search.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    const arma::uword beginRow = b * x.n_rows / blocks;
+    const arma::uword endRow = (b + 1) * x.n_rows / blocks;
+
+    for (size_t j = 0; j < x.n_cols; ++j)
+    {
+      const arma::uword* first = x.row_indices + x.col_ptrs[j];
+      const arma::uword* last = x.row_indices + x.col_ptrs[j + 1];
+      for (const arma::uword* it = std::lower_bound(first, last, beginRow);
+           it != last && *it < endRow; ++it)
+      {
+        resultT.col(*it) += x.values[it - x.row_indices] * yt.col(j);
+      }
+    }
+  }
+
+  result = resultT.t();
+}
+
+void mlpack::math::TransposeMultiply(const arma::sp_mat& x,
+                                     const arma::mat& y,
+                                     arma::mat& result)
+{
+  // Accumulate the rows of the result transposed, so that each one is
+  // contiguous in memory.
+  arma::mat resultT(y.n_cols, x.n_cols);
+  const arma::mat yt = y.t();
+
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (omp_size_t j = 0; j < (omp_size_t) x.n_cols; ++j)
+  {
+    arma::vec column(resultT.colptr(j), resultT.n_rows, false, true);
+    column.zeros();
+    for (size_t k = x.col_ptrs[j]; k < x.col_ptrs[j + 1]; ++k)
+      column += x.values[k] * yt.col(x.row_indices[k]);
+  }
+
+  result = resultT.t();
+}
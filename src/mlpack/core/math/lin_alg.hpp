@@ -36,6 +36,40 @@ void VectorPower(arma::vec& vec, const double power);
  */
 void Center(const arma::mat& x, arma::mat& xCentered);
 
+/**
+ * Center a matrix in place, by subtracting the mean of the columns from each
+ * column.  The columns are handled in parallel blocks, and no copy of the
+ * matrix is made.
+ *
+ * @param x Matrix to center.
+ */
+void Center(arma::mat& x);
+
+/**
+ * Compute the mean and the (unbiased) covariance matrix of the columns of x
+ * without a centered copy of x: every block of columns is centered on its own
+ * and the products of the blocks are accumulated in parallel.
+ *
+ * @param x Input matrix (one point per column).
+ * @param mean Vector to store the mean of the columns in.
+ * @param covariance Matrix to store the covariance matrix in.
+ */
+void Covariance(const arma::mat& x, arma::vec& mean, arma::mat& covariance);
+
+/**
+ * Compute the mean and the (unbiased) covariance matrix of the columns of a
+ * sparse matrix.  The centering is folded into the product, as
+ * (x x^T - n mean mean^T) / (n - 1), so x is never densified; the products of
+ * blocks of columns are accumulated in parallel.
+ *
+ * @param x Input matrix (one point per column).
+ * @param mean Vector to store the mean of the columns in.
+ * @param covariance Matrix to store the covariance matrix in.
+ */
+void Covariance(const arma::sp_mat& x,
+                arma::vec& mean,
+                arma::mat& covariance);
+
 /**
  * Whitens a matrix using the singular value decomposition of the covariance
  * matrix. Whitening means the covariance matrix of the result is the identity
@@ -45,6 +79,14 @@ void WhitenUsingSVD(const arma::mat& x,
                     arma::mat& xWhitened,
                     arma::mat& whiteningMatrix);
 
+/**
+ * Whitens a sparse matrix using the singular value decomposition of its
+ * covariance matrix, which is computed without densifying x.
+ */
+void WhitenUsingSVD(const arma::sp_mat& x,
+                    arma::mat& xWhitened,
+                    arma::mat& whiteningMatrix);
+
 /**
  * Whitens a matrix using the eigendecomposition of the covariance matrix.
  * Whitening means the covariance matrix of the result is the identity matrix.
@@ -53,6 +95,14 @@ void WhitenUsingEig(const arma::mat& x,
                     arma::mat& xWhitened,
                     arma::mat& whiteningMatrix);
 
+/**
+ * Whitens a sparse matrix using the eigendecomposition of its covariance
+ * matrix, which is computed without densifying x.
+ */
+void WhitenUsingEig(const arma::sp_mat& x,
+                    arma::mat& xWhitened,
+                    arma::mat& whiteningMatrix);
+
 /**
  * Overwrites a dimension-N vector to a random vector on the unit sphere in R^N.
  */
@@ -65,8 +115,8 @@ void RandVector(arma::vec& v);
 void Orthogonalize(const arma::mat& x, arma::mat& W);
 
 /**
- * Orthogonalize x in-place.  This could be sped up by a custom
- * implementation.
+ * Orthogonalize x in-place.  The columns are transformed in parallel blocks,
+ * so only one block is copied at a time.
  */
 void Orthogonalize(arma::mat& x);
 
@@ -124,6 +174,60 @@ inline size_t SvecIndex(size_t i, size_t j, size_t n);
  */
 void SymKronId(const arma::mat& A, arma::mat& op);
 
+/**
+ * Compute the economical QR decomposition of a tall and skinny matrix with the
+ * TSQR algorithm: the rows are split into blocks whose QR decompositions are
+ * computed in parallel, and the stacked R factors of the blocks are then
+ * decomposed once more.  If the matrix is not tall enough to be split, this is
+ * the same as arma::qr_econ().
+ *
+ * @param x Matrix to decompose.
+ * @param q Orthonormal factor (x.n_rows x x.n_cols).
+ * @param r Upper triangular factor (x.n_cols x x.n_cols).
+ * @param numBlocks Number of blocks of rows (0 means the number of threads).
+ * @return false if a decomposition failed.
+ */
+bool TSQR(const arma::mat& x,
+          arma::mat& q,
+          arma::mat& r,
+          const size_t numBlocks = 0);
+
+/**
+ * Compute result = x * y.  For dense x this is a regular (BLAS) product; for
+ * sparse x, each thread computes a block of the rows of the result by
+ * streaming over the columns of x, so x is never transposed or densified.
+ *
+ * @param x Left operand.
+ * @param y Dense right operand.
+ * @param result Product.
+ */
+inline void Multiply(const arma::mat& x, const arma::mat& y, arma::mat& result)
+{
+  result = x * y;
+}
+
+void Multiply(const arma::sp_mat& x, const arma::mat& y, arma::mat& result);
+
+/**
+ * Compute result = x^T * y.  For dense x this is a regular (BLAS) product; for
+ * sparse x, the rows of the result (one per column of x) are computed in
+ * parallel blocks.
+ *
+ * @param x Left operand, that is transposed.
+ * @param y Dense right operand.
+ * @param result Product.
+ */
+inline void TransposeMultiply(const arma::mat& x,
+                              const arma::mat& y,
+                              arma::mat& result)
+{
+  result = x.t() * y;
+}
+
+void TransposeMultiply(const arma::sp_mat& x,
+                       const arma::mat& y,
+                       arma::mat& result);
+
 /**
  * Signum function.
  * Return 1 if x>0; return 0 if x=0; return -1 if x<0.
@@ -0,0 +1,336 @@
+/**
+ * @file pairwise_distances.hpp
+ *
+ * Computation of the distances between every point of one set and every point
+ * of another, in blocks, with one matrix multiplication per block for the
+ * Euclidean distances (also when the second set is sparse).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_PAIRWISE_DISTANCES_HPP
+#define MLPACK_CORE_MATH_PAIRWISE_DISTANCES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Information about how PairwiseDistances() may compute the distances of a
+ * metric.  By default, every distance is computed with the metric's
+ * Evaluate().
+ */
+template<typename MetricType>
+struct PairwiseDistanceTraits
+{
+  /**
+   * If true, the metric is the (squared) Euclidean distance, so the squared
+   * distances can be computed as ||a||^2 + ||b||^2 - 2 a^T b.
+   */
+  static const bool UsesInnerProducts = false;
+
+  //! If true, the square root of the squared Euclidean distance is taken.
+  static const bool TakeRoot = false;
+};
+
+//! The Euclidean and squared Euclidean distances are computed from inner
+//! products.
+template<bool TakeRootValue>
+struct PairwiseDistanceTraits<metric::LMetric<2, TakeRootValue>>
+{
+  static const bool UsesInnerProducts = true;
+  static const bool TakeRoot = TakeRootValue;
+};
+
+namespace details {
+
+//! 'value' is true if the distances between points of the given types and
+//! the given metric are computed with a matrix multiplication; this needs
+//! dense matrices holding the same element type.
+template<typename MetricType, typename MatTypeA, typename MatTypeB>
+struct UseMatrixMultiplication
+{
+  typedef typename MatTypeA::elem_type ElemType;
+
+  static const bool value =
+      PairwiseDistanceTraits<MetricType>::UsesInnerProducts &&
+      std::is_same<MatTypeA, arma::Mat<ElemType>>::value &&
+      std::is_same<MatTypeB, arma::Mat<ElemType>>::value;
+};
+
+//! 'value' is true if the distances between a dense set and a sparse set are
+//! computed with a (sparse times dense) matrix multiplication.
+template<typename MetricType, typename MatTypeA, typename MatTypeB>
+struct UseSparseMultiplication
+{
+  typedef typename MatTypeA::elem_type ElemType;
+
+  static const bool value =
+      PairwiseDistanceTraits<MetricType>::UsesInnerProducts &&
+      std::is_same<MatTypeA, arma::Mat<ElemType>>::value &&
+      std::is_same<MatTypeB, arma::SpMat<ElemType>>::value;
+};
+
+/**
+ * Shift the given points to their mean and compute the squared norms of the
+ * shifted points, for the distances computed with a matrix multiplication.
+ */
+template<typename MatType>
+void ShiftPoints(const MatType& a,
+                 arma::Col<typename MatType::elem_type>& center,
+                 MatType& shifted,
+                 arma::Col<typename MatType::elem_type>& norms,
+                 const std::true_type& /* useMultiplication */)
+{
+  if (a.n_cols == 0)
+    return;
+
+  center = arma::mean(a, 1);
+  shifted = a;
+  shifted.each_col() -= center;
+  norms = arma::sum(arma::square(shifted), 0).t();
+}
+
+//! Nothing needs to be prepared when the metric is evaluated directly.
+template<typename MatType>
+void ShiftPoints(const MatType& /* a */,
+                 arma::Col<typename MatType::elem_type>& /* center */,
+                 MatType& /* shifted */,
+                 arma::Col<typename MatType::elem_type>& /* norms */,
+                 const std::false_type& /* useMultiplication */)
+{ }
+
+/**
+ * Compute the squared norms of the given points, for the distances computed
+ * with a sparse matrix multiplication.  The points are not shifted, since that
+ * would make the sparse points dense.
+ */
+template<typename MatType>
+void SquaredNorms(const MatType& a,
+                  arma::Col<typename MatType::elem_type>& norms,
+                  const std::true_type& /* useSparseMultiplication */)
+{
+  norms = arma::sum(arma::square(a), 0).t();
+}
+
+//! Nothing needs to be prepared for the other distances.
+template<typename MatType>
+void SquaredNorms(const MatType& /* a */,
+                  arma::Col<typename MatType::elem_type>& /* norms */,
+                  const std::false_type& /* useSparseMultiplication */)
+{ }
+
+//! Turn the squared Euclidean distances of the expansion into the distances
+//! of the metric, clamping the rounding errors below 0.
+template<typename MetricType, typename ElemType>
+void FinishDistances(arma::Mat<ElemType>& result)
+{
+  if (PairwiseDistanceTraits<MetricType>::TakeRoot)
+    result.transform([](const ElemType d) { return std::sqrt(std::max(d,
+        ElemType(0))); });
+  else
+    result.transform([](const ElemType d) { return std::max(d, ElemType(0)); });
+}
+
+/**
+ * Compute the distances between every column of a and the columns [begin,
+ * begin + result.n_cols) of b with the metric's Evaluate().
+ */
+template<typename MetricType, typename MatTypeA, typename MatTypeB>
+void DistanceBlock(
+    MetricType& metric,
+    const MatTypeA& a,
+    const arma::Col<typename MatTypeA::elem_type>& /* center */,
+    const arma::Col<typename MatTypeA::elem_type>& /* aNorms */,
+    const MatTypeB& b,
+    const size_t begin,
+    arma::Mat<typename MatTypeA::elem_type>& result,
+    const typename std::enable_if_t<
+        !UseMatrixMultiplication<MetricType, MatTypeA, MatTypeB>::value &&
+        !UseSparseMultiplication<MetricType, MatTypeA, MatTypeB>::value>* = 0)
+{
+  for (size_t j = 0; j < result.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      result(i, j) = metric.Evaluate(a.col(i), b.col(begin + j));
+}
+
+/**
+ * Compute the (squared) Euclidean distances between every column of a and the
+ * columns [begin, begin + result.n_cols) of b as ||a_i||^2 + ||b_j||^2 -
+ * 2 a_i^T b_j, with one matrix multiplication.  The points are shifted by the
+ * given center first (a is already shifted, and aNorms holds its squared
+ * norms), which keeps the rounding error of the expansion small.
+ */
+template<typename MetricType, typename MatTypeA, typename MatTypeB>
+void DistanceBlock(
+    MetricType& /* metric */,
+    const MatTypeA& a,
+    const arma::Col<typename MatTypeA::elem_type>& center,
+    const arma::Col<typename MatTypeA::elem_type>& aNorms,
+    const MatTypeB& b,
+    const size_t begin,
+    arma::Mat<typename MatTypeA::elem_type>& result,
+    const typename std::enable_if_t<
+        UseMatrixMultiplication<MetricType, MatTypeA, MatTypeB>::value>* = 0)
+{
+  typedef typename MatTypeA::elem_type ElemType;
+
+  MatTypeB bBlock = b.cols(begin, begin + result.n_cols - 1);
+  bBlock.each_col() -= center;
+
+  result = ElemType(-2) * (a.t() * bBlock);
+  result.each_col() += aNorms;
+  result.each_row() += arma::sum(arma::square(bBlock), 0);
+  FinishDistances<MetricType>(result);
+}
+
+/**
+ * Compute the (squared) Euclidean distances between every column of the dense
+ * matrix a and the columns [begin, begin + result.n_cols) of the sparse matrix
+ * b as ||a_i||^2 + ||b_j||^2 - 2 a_i^T b_j; aNorms holds the squared norms of
+ * a.  The inner products are computed as (b^T a)^T, so only the nonzero
+ * elements of b are visited and a is never transposed.
+ */
+template<typename MetricType, typename MatTypeA, typename MatTypeB>
+void DistanceBlock(
+    MetricType& /* metric */,
+    const MatTypeA& a,
+    const arma::Col<typename MatTypeA::elem_type>& /* center */,
+    const arma::Col<typename MatTypeA::elem_type>& aNorms,
+    const MatTypeB& b,
+    const size_t begin,
+    arma::Mat<typename MatTypeA::elem_type>& result,
+    const typename std::enable_if_t<
+        UseSparseMultiplication<MetricType, MatTypeA, MatTypeB>::value>* = 0)
+{
+  typedef typename MatTypeA::elem_type ElemType;
+
+  const MatTypeB bBlock = b.cols(begin, begin + result.n_cols - 1);
+  const arma::Mat<ElemType> products = bBlock.t() * a;
+
+  arma::Row<ElemType> bNorms(bBlock.n_cols, arma::fill::zeros);
+  for (typename MatTypeB::const_iterator it = bBlock.begin();
+       it != bBlock.end(); ++it)
+    bNorms[it.col()] += (*it) * (*it);
+
+  result = ElemType(-2) * products.t();
+  result.each_col() += aNorms;
+  result.each_row() += bNorms;
+  FinishDistances<MetricType>(result);
+}
+
+} // namespace details
+
+/**
+ * Compute the distances between every column of a and every column of b:
+ * result(i, j) = d(a_i, b_j).  The columns of the result are computed in
+ * blocks, in parallel (see Threads); inside a parallel region the blocks are
+ * computed one after the other.
+ *
+ * For the Euclidean and squared Euclidean distances on dense matrices, each
+ * block is computed with one matrix multiplication (so float matrices are
+ * multiplied in single precision); this is also the case when a is dense and
+ * b is sparse, with the same element type.  Other metrics and other sparse
+ * matrices are evaluated one pair of points at a time, with the metric's
+ * Evaluate().
+ *
+ * The metric must be usable from several threads at once.
+ *
+ * @param metric Metric to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param result Matrix to store the distances in (a.n_cols x b.n_cols).
+ */
+template<typename MetricType, typename MatTypeA, typename MatTypeB>
+void PairwiseDistances(MetricType& metric,
+                       const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::Mat<typename MatTypeA::elem_type>& result)
+{
+  typedef typename MatTypeA::elem_type ElemType;
+
+  if (a.n_rows != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "PairwiseDistances(): dimensionality of the first set ("
+        << a.n_rows << ") does not match dimensionality of the second set ("
+        << b.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // When the distances come from a matrix multiplication, a is shifted to its
+  // mean, and its squared norms are computed only once.
+  typedef std::integral_constant<bool, details::UseMatrixMultiplication<
+      MetricType, MatTypeA, MatTypeB>::value> UseMultiplication;
+  arma::Col<ElemType> center, aNorms;
+  MatTypeA shiftedA;
+  details::ShiftPoints(a, center, shiftedA, aNorms, UseMultiplication());
+
+  // With a sparse b, a is not shifted, but its squared norms are computed only
+  // once too.
+  typedef std::integral_constant<bool, details::UseSparseMultiplication<
+      MetricType, MatTypeA, MatTypeB>::value> UseSparseMultiplication;
+  details::SquaredNorms(a, aNorms, UseSparseMultiplication());
+  const MatTypeA& blockA = UseMultiplication::value ? shiftedA : a;
+
+  // Each block is large enough for an efficient matrix multiplication.
+  const size_t blockSize = 256;
+  const size_t numBlocks = (b.n_cols + blockSize - 1) / blockSize;
+
+  result.set_size(a.n_cols, b.n_cols);
+  Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    const size_t begin = block * blockSize;
+    const size_t count = std::min(blockSize, (size_t) b.n_cols - begin);
+
+    // An alias of the columns of the result; no memory is copied.
+    arma::Mat<ElemType> resultBlock(result.colptr(begin), a.n_cols, count,
+        false, true);
+    details::DistanceBlock(metric, blockA, center, aNorms, b, begin,
+        resultBlock);
+  });
+}
+
+/**
+ * Compute the (symmetric) distance matrix of the given points: result(i, j) =
+ * d(x_i, x_j).  The distances are computed as in PairwiseDistances(metric,
+ * a, b, result), except that the metrics without a matrix multiplication only
+ * evaluate the upper triangle.  The diagonal is exactly 0.
+ *
+ * @param metric Metric to evaluate.
+ * @param data Set of points.
+ * @param result Matrix to store the distances in (data.n_cols x data.n_cols).
+ */
+template<typename MetricType, typename MatType>
+void PairwiseDistances(MetricType& metric,
+                       const MatType& data,
+                       arma::Mat<typename MatType::elem_type>& result)
+{
+  if (details::UseMatrixMultiplication<MetricType, MatType, MatType>::value)
+  {
+    PairwiseDistances(metric, data, data, result);
+    result = arma::symmatu(result);
+  }
+  else
+  {
+    result.set_size(data.n_cols, data.n_cols);
+    Threads::ParallelFor(0, data.n_cols, [&](const size_t j)
+    {
+      for (size_t i = 0; i < j; ++i)
+        result(i, j) = metric.Evaluate(data.col(i), data.col(j));
+    });
+
+    result = arma::symmatu(result);
+  }
+
+  result.diag().zeros();
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
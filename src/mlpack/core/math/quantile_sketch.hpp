@@ -0,0 +1,151 @@
+/**
+ * @file quantile_sketch.hpp
+ *
+ * A small mergeable sketch of a stream of values, which answers approximate
+ * quantile queries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_QUANTILE_SKETCH_HPP
+#define MLPACK_CORE_MATH_QUANTILE_SKETCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * A quantile sketch made of compactors, in the style of the KLL sketch.  The
+ * values are kept on levels, and a value on level l stands for 2^l values of
+ * the stream.  When a level holds 'capacity' values, they are sorted and every
+ * other one is promoted to the next level, alternating between the odd and the
+ * even ones.  The sketch therefore holds O(capacity * log(n / capacity))
+ * values, and the rank error of a quantile shrinks as the capacity grows.
+ *
+ * Sketches of different parts of a stream can be merged, so the parts can be
+ * sketched in parallel.
+ */
+class QuantileSketch
+{
+ public:
+  /**
+   * Create an empty sketch.
+   *
+   * @param capacity Number of values a level holds before it is compacted.
+   */
+  QuantileSketch(const size_t capacity = 256) :
+      capacity(std::max(capacity, (size_t) 2)),
+      count(0)
+  { }
+
+  //! Add a value to the sketch.
+  void Insert(const double value)
+  {
+    if (levels.empty())
+    {
+      levels.resize(1);
+      offsets.resize(1, 0);
+    }
+
+    levels[0].push_back(value);
+    ++count;
+    if (levels[0].size() >= capacity)
+      Compact(0);
+  }
+
+  //! Add the values of another sketch of the same capacity to this one.
+  void Merge(const QuantileSketch& other)
+  {
+    if (levels.size() < other.levels.size())
+    {
+      levels.resize(other.levels.size());
+      offsets.resize(other.levels.size(), 0);
+    }
+
+    for (size_t l = 0; l < other.levels.size(); ++l)
+      levels[l].insert(levels[l].end(), other.levels[l].begin(),
+          other.levels[l].end());
+    count += other.count;
+
+    for (size_t l = 0; l < levels.size(); ++l)
+      if (levels[l].size() >= capacity)
+        Compact(l);
+  }
+
+  /**
+   * Get the approximate q-quantile of the values: the smallest value of the
+   * sketch whose rank is at least q times the number of values.
+   *
+   * @param q The quantile, between 0 and 1.
+   * @return The quantile, or NaN if the sketch is empty.
+   */
+  double Quantile(const double q) const
+  {
+    std::vector<std::pair<double, size_t>> items;
+    for (size_t l = 0; l < levels.size(); ++l)
+      for (size_t i = 0; i < levels[l].size(); ++i)
+        items.push_back(std::make_pair(levels[l][i], size_t(1) << l));
+
+    if (items.empty())
+      return std::numeric_limits<double>::quiet_NaN();
+
+    std::sort(items.begin(), items.end());
+    const double target = q * count;
+    size_t rank = 0;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+      rank += items[i].second;
+      if (rank >= target)
+        return items[i].first;
+    }
+
+    return items.back().first;
+  }
+
+  //! Get the number of values added to the sketch.
+  size_t Count() const { return count; }
+
+  //! Get the number of values a level holds before it is compacted.
+  size_t Capacity() const { return capacity; }
+
+ private:
+  //! The number of values a level holds before it is compacted.
+  size_t capacity;
+  //! The number of values added.
+  size_t count;
+  //! The values of every level.
+  std::vector<std::vector<double>> levels;
+  //! Whether the odd (1) or even (0) values of each level are promoted next.
+  std::vector<size_t> offsets;
+
+  //! Promote every other value of the given level to the next one.
+  void Compact(const size_t level)
+  {
+    if (levels.size() == level + 1)
+    {
+      levels.resize(level + 2);
+      offsets.resize(level + 2, 0);
+    }
+
+    std::vector<double>& values = levels[level];
+    std::sort(values.begin(), values.end());
+
+    // An odd value out stays on this level.
+    const size_t pairs = values.size() / 2;
+    for (size_t i = 0; i < pairs; ++i)
+      levels[level + 1].push_back(values[2 * i + offsets[level]]);
+    values.erase(values.begin(), values.begin() + 2 * pairs);
+    offsets[level] ^= 1;
+
+    if (levels[level + 1].size() >= capacity)
+      Compact(level + 1);
+  }
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -1,7 +1,8 @@
 /**
  * @file random.cpp
  *
- * Declarations of global random number generators.
+ * Declarations of global random number generators, and the generators of
+ * other threads.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -10,6 +11,14 @@
  */
 #include <random>
 #include <mlpack/mlpack_export.hpp>
+#include "random.hpp"
+
+#include <atomic>
+#include <thread>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace math {
@@ -21,5 +30,105 @@ MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
 // Global normal distribution.
 MLPACK_EXPORT std::normal_distribution<> randNormalDist(0.0, 1.0);
 
+namespace {
+
+// The seed given to RandomSeed().  std::mt19937 is seeded with 5489 by default.
+std::atomic<uint64_t> streamSeed(5489);
+// Incremented by every call to RandomSeed(), so that threads reseed their
+// generators.
+std::atomic<size_t> seedGeneration(0);
+// Number of threads that are not OpenMP workers and have drawn numbers.
+std::atomic<size_t> otherThreads(0);
+// The thread that loaded mlpack, which uses the global generator.
+const std::thread::id mainThread = std::this_thread::get_id();
+
+// Streams of OpenMP workers, of other threads and of RandomStream() are kept
+// apart by these tags.
+const uint64_t workerStreams = 1;
+const uint64_t otherStreams = 2;
+const uint64_t userStreams = 3;
+
+//! Mix the bits of the given value (the SplitMix64 finalizer).
+uint64_t Mix(uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+//! Create the generator of the given stream of the given kind.
+std::mt19937 MakeGenerator(const uint64_t kind, const uint64_t stream)
+{
+  const uint64_t z = Mix(Mix(streamSeed + 0x9E3779B97F4A7C15ULL * kind) +
+      0x9E3779B97F4A7C15ULL * (stream + 1));
+  std::seed_seq seq { (uint32_t) z, (uint32_t) (z >> 32), (uint32_t) kind,
+      (uint32_t) stream };
+  return std::mt19937(seq);
+}
+
+//! The generator and normal distribution of a thread.
+struct ThreadState
+{
+  ThreadState() :
+      main(std::this_thread::get_id() == mainThread),
+      generation(seedGeneration - 1)
+  { }
+
+  bool main;
+  size_t generation;
+  std::mt19937 generator;
+  std::normal_distribution<> normalDist;
+};
+
+//! Get the state of the calling thread, reseeding it if RandomSeed() was
+//! called since it was last used.
+ThreadState& LocalState()
+{
+  thread_local ThreadState state;
+  if (!state.main && state.generation != seedGeneration)
+  {
+    state.generation = seedGeneration;
+    #ifdef HAS_OPENMP
+    if (omp_in_parallel() && omp_get_thread_num() > 0)
+    {
+      state.generator = MakeGenerator(workerStreams, omp_get_thread_num());
+    }
+    else
+    #endif
+    {
+      state.generator = MakeGenerator(otherStreams, otherThreads++);
+    }
+    state.normalDist.reset();
+  }
+
+  return state;
+}
+
+} // namespace
+
+void SeedRandomStreams(const size_t seed)
+{
+  streamSeed = seed;
+  otherThreads = 0;
+  ++seedGeneration;
+}
+
+std::mt19937& ThreadRandGen()
+{
+  ThreadState& state = LocalState();
+  return state.main ? randGen : state.generator;
+}
+
+std::normal_distribution<>& ThreadRandNormalDist()
+{
+  ThreadState& state = LocalState();
+  return state.main ? randNormalDist : state.normalDist;
+}
+
+std::mt19937 RandomStream(const size_t stream)
+{
+  return MakeGenerator(userStreams, stream);
+}
+
 } // namespace math
 } // namespace mlpack
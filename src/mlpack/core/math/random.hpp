@@ -30,6 +30,57 @@ extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
 
+/**
+ * Derive the generators of the other threads and the random streams from the
+ * given seed.  This is called by RandomSeed().
+ *
+ * @param seed Seed for the random number generators.
+ */
+void SeedRandomStreams(const size_t seed);
+
+/**
+ * Get the random number generator of the calling thread, which the random
+ * functions (Random(), RandInt(), RandNormal(), and so forth) use.  The thread
+ * that loaded mlpack uses the global randGen, so serial code gets the same
+ * numbers as before.  Every other thread gets its own generator, so the random
+ * functions can be called from parallel sections without locking.
+ *
+ * The generator of an OpenMP worker thread is derived from the seed and the
+ * number of the thread in its team; so, after RandomSeed(), the numbers drawn
+ * by each thread depend only on the seed and the number of threads.  (With
+ * dynamic scheduling, which indices a thread handles may vary between runs;
+ * code that must give the same results regardless of scheduling should use a
+ * RandomStream() per task instead.)  Threads that are not OpenMP workers get
+ * distinct generators in the order they first draw a number.
+ */
+std::mt19937& ThreadRandGen();
+
+/**
+ * Get the normal distribution of the calling thread.  A normal distribution
+ * caches values, so it cannot be shared between threads.  The thread that
+ * loaded mlpack uses the global randNormalDist.
+ */
+std::normal_distribution<>& ThreadRandNormalDist();
+
+/**
+ * Get a random number generator for the given stream.  The generator is
+ * derived from the seed given to RandomSeed() and the index of the stream,
+ * by hashing them (a counter-based scheme), so the streams are independent of
+ * each other and of the thread that uses them.  Parallel code that needs
+ * reproducible results can give each task its own stream:
+ *
+ * @code
+ * Threads::ParallelFor(0, numTrees, [&](const size_t i)
+ * {
+ *   std::mt19937 generator = math::RandomStream(i);
+ *   ...
+ * });
+ * @endcode
+ *
+ * @param stream Index of the stream.
+ */
+std::mt19937 RandomStream(const size_t stream);
+
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
  * The seed is casted to a 32-bit integer before being given to the random
@@ -43,6 +94,7 @@ inline void RandomSeed(const size_t seed)
     randGen.seed((uint32_t) seed);
     srand((unsigned int) seed);
     arma::arma_rng::set_seed(seed);
+    SeedRandomStreams(seed);
   #else
     (void) seed;
   #endif
@@ -62,6 +114,7 @@ inline void FixedRandomSeed()
   randGen.seed((uint32_t) seed);
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
+  SeedRandomStreams(seed);
 }
 #endif
 
@@ -70,7 +123,7 @@ inline void FixedRandomSeed()
  */
 inline double Random()
 {
-  return randUniformDist(randGen);
+  return randUniformDist(ThreadRandGen());
 }
 
 /**
@@ -78,7 +131,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * randUniformDist(ThreadRandGen());
 }
 
 /**
@@ -97,7 +150,8 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive *
+      randUniformDist(ThreadRandGen()));
 }
 
 /**
@@ -106,7 +160,7 @@ inline int RandInt(const int hiExclusive)
 inline int RandInt(const int lo, const int hiExclusive)
 {
   return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+                               * randUniformDist(ThreadRandGen()));
 }
 
 /**
@@ -114,7 +168,7 @@ inline int RandInt(const int lo, const int hiExclusive)
  */
 inline double RandNormal()
 {
-  return randNormalDist(randGen);
+  return ThreadRandNormalDist()(ThreadRandGen());
 }
 
 /**
@@ -126,7 +180,7 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * ThreadRandNormalDist()(ThreadRandGen()) + mean;
 }
 
 /**
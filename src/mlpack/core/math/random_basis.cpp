@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "random_basis.hpp"
+#include "random.hpp"
 
 using namespace arma;
 
@@ -22,24 +23,42 @@ void RandomBasis(mat& basis, const size_t d)
   {
     // [Q, R] = qr(randn(d, d));
     // Q = Q * diag(sign(diag(R)));
+    // The Gaussian matrix is drawn in parallel, in blocks of columns; each
+    // block draws from its own random stream, so the result does not depend
+    // on the number of threads.
+    const size_t blockSize = 64;
+    const size_t numBlocks = (d + blockSize - 1) / blockSize;
+    const size_t firstStream = (size_t) ThreadRandGen()();
+    mat gaussian(d, d);
+    Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+    {
+      std::mt19937 generator = RandomStream(firstStream + block);
+      std::normal_distribution<> normal;
+      const size_t end = std::min(d, (block + 1) * blockSize);
+      for (size_t j = block * blockSize; j < end; ++j)
+        for (size_t i = 0; i < d; ++i)
+          gaussian(i, j) = normal(generator);
+    });
+
     mat r;
-    if (qr(basis, r, randn<mat>(d, d)))
+    if (qr(basis, r, gaussian))
     {
-      vec rDiag(r.n_rows);
-      for (size_t i = 0; i < rDiag.n_elem; ++i)
+      // Scale each column by the sign of the diagonal of R in place.
+      for (size_t i = 0; i < r.n_rows; ++i)
       {
         if (r(i, i) < 0)
-          rDiag(i) = -1;
-        else if (r(i, i) > 0)
-          rDiag(i) = 1;
-        else
-          rDiag(i) = 0;
+          basis.col(i) *= -1;
+        else if (r(i, i) == 0)
+          basis.col(i).zeros();
       }
 
-      basis *= diagmat(rDiag);
+      // Flipping one column of a basis with a negative determinant gives a
+      // uniformly distributed rotation too, so no basis is drawn again.
+      const double determinant = det(basis);
+      if (determinant < 0)
+        basis.col(0) *= -1;
 
-      // Check if the determinant is positive.
-      if (det(basis) >= 0)
+      if (determinant != 0)
         break;
     }
   }
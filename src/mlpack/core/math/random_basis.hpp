@@ -19,7 +19,8 @@ namespace math {
 
 /**
  * Create a random d-dimensional orthogonal basis, storing it in the given
- * matrix.
+ * matrix.  The basis is a uniformly distributed rotation (its determinant is
+ * 1).  The random Gaussian matrix it is computed from is drawn in parallel.
  *
  * @param basis Matrix to store basis in.
  * @param d Desired number of dimensions in the basis.
@@ -17,12 +17,145 @@
 namespace mlpack {
 namespace math {
 
+namespace details {
+
+/**
+ * Gather the columns of the given dense matrix: output.col(i) =
+ * input.col(ordering[i]).  If input and output are the same object, the
+ * columns are permuted in place by following the cycles of the permutation,
+ * with one column of extra memory; otherwise the columns are copied in
+ * parallel, in blocks.
+ *
+ * @param input Matrix to take the columns from.
+ * @param ordering Permutation of the columns.
+ * @param output Matrix to store the permuted columns in.
+ */
+template<typename MatType>
+void GatherColumns(const MatType& input,
+                   const arma::uvec& ordering,
+                   MatType& output)
+{
+  typedef typename MatType::elem_type ElemType;
+  const size_t n = input.n_rows;
+
+  if (&input == &output)
+  {
+    std::vector<bool> done(ordering.n_elem, false);
+    std::vector<ElemType> column(n);
+    for (size_t start = 0; start < ordering.n_elem; ++start)
+    {
+      if (done[start])
+        continue;
+
+      std::copy(output.colptr(start), output.colptr(start) + n,
+          column.begin());
+      size_t i = start;
+      while (ordering[i] != start)
+      {
+        std::copy(output.colptr(ordering[i]), output.colptr(ordering[i]) + n,
+            output.colptr(i));
+        done[i] = true;
+        i = ordering[i];
+      }
+
+      std::copy(column.begin(), column.end(), output.colptr(i));
+      done[i] = true;
+    }
+
+    return;
+  }
+
+  output.set_size(input.n_rows, input.n_cols);
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (input.n_cols + blockSize - 1) / blockSize;
+  Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    const size_t end = std::min((size_t) input.n_cols,
+        (block + 1) * blockSize);
+    for (size_t i = block * blockSize; i < end; ++i)
+    {
+      std::copy(input.colptr(ordering[i]), input.colptr(ordering[i]) + n,
+          output.colptr(i));
+    }
+  });
+}
+
+/**
+ * Scatter the columns of the given dense matrix: output.col(ordering[i]) =
+ * input.col(i).  The inverse permutation is gathered (see GatherColumns()).
+ */
+template<typename MatType>
+void ScatterColumns(const MatType& input,
+                    const arma::uvec& ordering,
+                    MatType& output)
+{
+  arma::uvec inverse(ordering.n_elem);
+  for (size_t i = 0; i < ordering.n_elem; ++i)
+    inverse[ordering[i]] = i;
+
+  GatherColumns(input, inverse, output);
+}
+
+/**
+ * Scatter the columns of the given sparse matrix: output.col(ordering[i]) =
+ * input.col(i).  The compressed columns of the output are built directly from
+ * those of the input, in parallel, without sorting any entries.
+ *
+ * @param input Matrix to take the columns from.
+ * @param ordering Permutation of the columns.
+ * @param output Matrix to store the permuted columns in (may be input).
+ */
+template<typename MatType>
+void ScatterSparseColumns(const MatType& input,
+                          const arma::uvec& ordering,
+                          MatType& output)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  arma::uvec inverse(ordering.n_elem);
+  for (size_t i = 0; i < ordering.n_elem; ++i)
+    inverse[ordering[i]] = i;
+
+  arma::uvec colPtrs(input.n_cols + 1);
+  colPtrs[0] = 0;
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    colPtrs[j + 1] = colPtrs[j] + (input.col_ptrs[inverse[j] + 1] -
+        input.col_ptrs[inverse[j]]);
+  }
+
+  arma::uvec rowIndices(input.n_nonzero);
+  arma::Col<ElemType> values(input.n_nonzero);
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (input.n_cols + blockSize - 1) / blockSize;
+  Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    const size_t end = std::min((size_t) input.n_cols,
+        (block + 1) * blockSize);
+    for (size_t j = block * blockSize; j < end; ++j)
+    {
+      const size_t begin = input.col_ptrs[inverse[j]];
+      const size_t count = colPtrs[j + 1] - colPtrs[j];
+      std::copy(input.row_indices + begin, input.row_indices + begin + count,
+          rowIndices.memptr() + colPtrs[j]);
+      std::copy(input.values + begin, input.values + begin + count,
+          values.memptr() + colPtrs[j]);
+    }
+  });
+
+  output = MatType(rowIndices, colPtrs, values, input.n_rows, input.n_cols);
+}
+
+} // namespace details
+
 /**
  * Shuffle a dataset and associated labels (or responses).  It is expected that
  * inputPoints and inputLabels have the same number of columns (so, be sure that
  * inputLabels, if it is a vector, is a row vector).
  *
- * Shuffled data will be output into outputPoints and outputLabels.
+ * Shuffled data will be output into outputPoints and outputLabels.  If the
+ * output is the input, the columns are permuted in place, without a copy of
+ * the dataset; otherwise they are copied in parallel.
  */
 template<typename MatType, typename LabelsType>
 void ShuffleData(const MatType& inputPoints,
@@ -36,8 +169,8 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  outputPoints = inputPoints.cols(ordering);
-  outputLabels = inputLabels.cols(ordering);
+  details::GatherColumns(inputPoints, ordering, outputPoints);
+  details::GatherColumns(inputLabels, ordering, outputLabels);
 }
 
 /**
@@ -45,7 +178,8 @@ void ShuffleData(const MatType& inputPoints,
  * expected that inputPoints and inputLabels have the same number of columns
  * (so, be sure that inputLabels, if it is a vector, is a row vector).
  *
- * Shuffled data will be output into outputPoints and outputLabels.
+ * Shuffled data will be output into outputPoints and outputLabels.  The
+ * compressed columns of the output are built directly, in parallel.
  */
 template<typename MatType, typename LabelsType>
 void ShuffleData(const MatType& inputPoints,
@@ -59,37 +193,8 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  // Extract coordinate list representation.
-  arma::umat locations(2, inputPoints.n_nonzero);
-  arma::Col<typename MatType::elem_type> values(inputPoints.n_nonzero);
-  typename MatType::const_iterator it = inputPoints.begin();
-  size_t index = 0;
-  while (it != inputPoints.end())
-  {
-    locations(0, index) = it.row();
-    locations(1, index) = ordering[it.col()];
-    values(index) = (*it);
-    ++it;
-    ++index;
-  }
-
-  if (&inputPoints == &outputPoints || &inputLabels == &outputLabels)
-  {
-    MatType newOutputPoints(locations, values, inputPoints.n_rows,
-        inputPoints.n_cols, true);
-    LabelsType newOutputLabels(inputLabels.n_elem);
-    newOutputLabels.cols(ordering) = inputLabels;
-
-    outputPoints = std::move(newOutputPoints);
-    outputLabels = std::move(newOutputLabels);
-  }
-  else
-  {
-    outputPoints = MatType(locations, values, inputPoints.n_rows,
-        inputPoints.n_cols, true);
-    outputLabels.set_size(inputLabels.n_elem);
-    outputLabels.cols(ordering) = inputLabels;
-  }
+  details::ScatterSparseColumns(inputPoints, ordering, outputPoints);
+  details::ScatterColumns(inputLabels, ordering, outputLabels);
 }
 
 /**
@@ -125,13 +230,13 @@ void ShuffleData(const MatType& inputPoints,
       inputPoints.n_slices);
   outputLabelsPtr->set_size(inputLabels.n_rows, inputLabels.n_cols,
       inputLabels.n_slices);
-  for (size_t i = 0; i < ordering.n_elem; ++i)
+  Threads::ParallelFor(0, ordering.n_elem, [&](const size_t i)
   {
     outputPointsPtr->tube(0, ordering[i], outputPointsPtr->n_rows - 1,
         ordering[i]) = inputPoints.tube(0, i, inputPoints.n_rows - 1, i);
     outputLabelsPtr->tube(0, ordering[i], outputLabelsPtr->n_rows - 1,
         ordering[i]) = inputLabels.tube(0, i, inputLabels.n_rows - 1, i);
-  }
+  });
 
   // Clean up memory if needed.
   if (&inputPoints == &outputPoints)
@@ -170,9 +275,9 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  outputPoints = inputPoints.cols(ordering);
-  outputLabels = inputLabels.cols(ordering);
-  outputWeights = inputWeights.cols(ordering);
+  details::GatherColumns(inputPoints, ordering, outputPoints);
+  details::GatherColumns(inputLabels, ordering, outputLabels);
+  details::GatherColumns(inputWeights, ordering, outputWeights);
 }
 
 /**
@@ -198,43 +303,9 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  // Extract coordinate list representation.
-  arma::umat locations(2, inputPoints.n_nonzero);
-  arma::Col<typename MatType::elem_type> values(inputPoints.n_nonzero);
-  typename MatType::const_iterator it = inputPoints.begin();
-  size_t index = 0;
-  while (it != inputPoints.end())
-  {
-    locations(0, index) = it.row();
-    locations(1, index) = ordering[it.col()];
-    values(index) = (*it);
-    ++it;
-    ++index;
-  }
-
-  if (&inputPoints == &outputPoints || &inputLabels == &outputLabels ||
-      &inputWeights == &outputWeights)
-  {
-    MatType newOutputPoints(locations, values, inputPoints.n_rows,
-        inputPoints.n_cols, true);
-    LabelsType newOutputLabels(inputLabels.n_elem);
-    WeightsType newOutputWeights(inputWeights.n_elem);
-    newOutputLabels.cols(ordering) = inputLabels;
-    newOutputWeights.cols(ordering) = inputWeights;
-
-    outputPoints = std::move(newOutputPoints);
-    outputLabels = std::move(newOutputLabels);
-    outputWeights = std::move(newOutputWeights);
-  }
-  else
-  {
-    outputPoints = MatType(locations, values, inputPoints.n_rows,
-        inputPoints.n_cols, true);
-    outputLabels.set_size(inputLabels.n_elem);
-    outputLabels.cols(ordering) = inputLabels;
-    outputWeights.set_size(inputWeights.n_elem);
-    outputWeights.cols(ordering) = inputWeights;
-  }
+  details::ScatterSparseColumns(inputPoints, ordering, outputPoints);
+  details::ScatterColumns(inputLabels, ordering, outputLabels);
+  details::ScatterColumns(inputWeights, ordering, outputWeights);
 }
 
 } // namespace math
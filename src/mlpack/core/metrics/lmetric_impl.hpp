@@ -18,6 +18,213 @@
 namespace mlpack {
 namespace metric {
 
+namespace details {
+
+//! 'value' is true if the vector type stores its elements contiguously in
+//! memory (a dense column, or a column of a dense matrix).
+template<typename VecType>
+struct IsContiguousVector
+{
+  static const bool value = false;
+};
+
+template<typename eT>
+struct IsContiguousVector<arma::Col<eT>>
+{
+  static const bool value = true;
+};
+
+template<typename eT>
+struct IsContiguousVector<arma::subview_col<eT>>
+{
+  static const bool value = true;
+};
+
+//! 'value' is true if the distance between the two vector types can be
+//! computed directly from their memory: both are contiguous and hold the same
+//! floating-point type.
+template<typename VecTypeA, typename VecTypeB>
+struct UseDenseLoop
+{
+  static const bool value = IsContiguousVector<VecTypeA>::value &&
+      IsContiguousVector<VecTypeB>::value &&
+      std::is_same<typename VecTypeA::elem_type,
+                   typename VecTypeB::elem_type>::value &&
+      std::is_floating_point<typename VecTypeA::elem_type>::value;
+};
+
+//! Get the memory of a dense column.
+template<typename eT>
+inline const eT* VectorMemory(const arma::Col<eT>& v) { return v.memptr(); }
+
+//! Get the memory of a column of a dense matrix.
+template<typename eT>
+inline const eT* VectorMemory(const arma::subview_col<eT>& v)
+{
+  return v.colmem;
+}
+
+//! The term of the sum of an L-metric for one difference of coordinates.
+template<int Power>
+struct LMetricTerm
+{
+  template<typename eT>
+  static eT Apply(const eT d) { return std::pow(std::abs(d), (eT) Power); }
+};
+
+template<>
+struct LMetricTerm<1>
+{
+  template<typename eT>
+  static eT Apply(const eT d) { return std::abs(d); }
+};
+
+template<>
+struct LMetricTerm<2>
+{
+  template<typename eT>
+  static eT Apply(const eT d) { return d * d; }
+};
+
+template<>
+struct LMetricTerm<3>
+{
+  template<typename eT>
+  static eT Apply(const eT d) { return std::abs(d) * d * d; }
+};
+
+//! Compute the sum of the terms for points of a dimension known at compile
+//! time; the compiler unrolls and vectorizes the loop.
+template<int Power, size_t Dim, typename eT>
+inline eT FixedPowerSum(const eT* a, const eT* b)
+{
+  eT sum = 0;
+  for (size_t i = 0; i < Dim; ++i)
+    sum += LMetricTerm<Power>::Apply(a[i] - b[i]);
+  return sum;
+}
+
+/**
+ * Compute the sum of the terms of an L-metric directly from the memory of two
+ * points, without any temporary.  The common low dimensions use loops of a
+ * fixed length; other dimensions use four independent sums, so that the loop
+ * can be vectorized.
+ */
+template<int Power, typename eT>
+inline eT DensePowerSum(const eT* a, const eT* b, const size_t n)
+{
+  switch (n)
+  {
+    case 2: return FixedPowerSum<Power, 2>(a, b);
+    case 3: return FixedPowerSum<Power, 3>(a, b);
+    case 4: return FixedPowerSum<Power, 4>(a, b);
+    case 8: return FixedPowerSum<Power, 8>(a, b);
+    case 16: return FixedPowerSum<Power, 16>(a, b);
+  }
+
+  eT sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    sum0 += LMetricTerm<Power>::Apply(a[i] - b[i]);
+    sum1 += LMetricTerm<Power>::Apply(a[i + 1] - b[i + 1]);
+    sum2 += LMetricTerm<Power>::Apply(a[i + 2] - b[i + 2]);
+    sum3 += LMetricTerm<Power>::Apply(a[i + 3] - b[i + 3]);
+  }
+  for (; i < n; ++i)
+    sum0 += LMetricTerm<Power>::Apply(a[i] - b[i]);
+
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+//! Compute the sum of the terms of an L-metric with Armadillo expressions
+//! (for sparse vectors, integer vectors, and other expressions).
+template<int Power>
+struct ExpressionPowerSum
+{
+  template<typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type Apply(const VecTypeA& a,
+                                            const VecTypeB& b)
+  {
+    return arma::accu(arma::pow(arma::abs(a - b), Power));
+  }
+};
+
+template<>
+struct ExpressionPowerSum<1>
+{
+  template<typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type Apply(const VecTypeA& a,
+                                            const VecTypeB& b)
+  {
+    return arma::accu(arma::abs(a - b));
+  }
+};
+
+template<>
+struct ExpressionPowerSum<2>
+{
+  template<typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type Apply(const VecTypeA& a,
+                                            const VecTypeB& b)
+  {
+    return arma::accu(arma::square(a - b));
+  }
+};
+
+//! Compute the sum of the terms of an L-metric for two dense points.
+template<int Power, typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type PowerSum(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        UseDenseLoop<VecTypeA, VecTypeB>::value>* = 0)
+{
+  return DensePowerSum<Power>(VectorMemory(a), VectorMemory(b), a.n_elem);
+}
+
+//! Compute the sum of the terms of an L-metric for any other points.
+template<int Power, typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type PowerSum(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        !UseDenseLoop<VecTypeA, VecTypeB>::value>* = 0)
+{
+  return ExpressionPowerSum<Power>::Apply(a, b);
+}
+
+//! Compute the largest absolute difference of coordinates of two dense points.
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type MaxDifference(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        UseDenseLoop<VecTypeA, VecTypeB>::value>* = 0)
+{
+  typedef typename VecTypeA::elem_type ElemType;
+  const ElemType* aMem = VectorMemory(a);
+  const ElemType* bMem = VectorMemory(b);
+
+  ElemType result = 0;
+  for (size_t i = 0; i < a.n_elem; ++i)
+    result = std::max(result, (ElemType) std::abs(aMem[i] - bMem[i]));
+  return result;
+}
+
+//! Compute the largest absolute difference of coordinates of any other points.
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type MaxDifference(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        !UseDenseLoop<VecTypeA, VecTypeB>::value>* = 0)
+{
+  return arma::as_scalar(arma::max(arma::abs(a - b)));
+}
+
+} // namespace details
+
 // Unspecialized implementation.  This should almost never be used...
 template<int Power, bool TakeRoot>
 template<typename VecTypeA, typename VecTypeB>
@@ -42,7 +249,7 @@ typename VecTypeA::elem_type LMetric<1, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::accu(abs(a - b));
+  return details::PowerSum<1>(a, b);
 }
 
 template<>
@@ -51,7 +258,7 @@ typename VecTypeA::elem_type LMetric<1, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::accu(abs(a - b));
+  return details::PowerSum<1>(a, b);
 }
 
 // L2-metric specializations.
@@ -61,7 +268,7 @@ typename VecTypeA::elem_type LMetric<2, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return sqrt(arma::accu(square(a - b)));
+  return sqrt(details::PowerSum<2>(a, b));
 }
 
 template<>
@@ -70,7 +277,7 @@ typename VecTypeA::elem_type LMetric<2, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return accu(arma::square(a - b));
+  return details::PowerSum<2>(a, b);
 }
 
 // L3-metric specialization (not very likely to be used, but just in case).
@@ -80,11 +287,7 @@ typename VecTypeA::elem_type LMetric<3, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  typename VecTypeA::elem_type sum = 0;
-  for (size_t i = 0; i < a.n_elem; i++)
-    sum += std::pow(fabs(a[i] - b[i]), 3.0);
-
-  return std::pow(arma::accu(arma::pow(arma::abs(a - b), 3.0)), 1.0 / 3.0);
+  return std::pow(details::PowerSum<3>(a, b), 1.0 / 3.0);
 }
 
 template<>
@@ -93,7 +296,7 @@ typename VecTypeA::elem_type LMetric<3, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::accu(arma::pow(arma::abs(a - b), 3.0));
+  return details::PowerSum<3>(a, b);
 }
 
 // L-infinity (Chebyshev distance) specialization
@@ -103,7 +306,7 @@ typename VecTypeA::elem_type LMetric<INT_MAX, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::as_scalar(arma::max(arma::abs(a - b)));
+  return details::MaxDifference(a, b);
 }
 
 } // namespace metric
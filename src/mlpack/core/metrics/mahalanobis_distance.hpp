@@ -37,10 +37,25 @@ namespace metric {
  *
  * If you wish to use the KNN class or other tree-based algorithms with this
  * distance, it is recommended to instead stretch the dataset first, by
- * decomposing Q = L^T L (perhaps via a Cholesky decomposition), and then
- * multiply the data by L.  If you still wish to use the KNN class with a custom
- * distance anyway, you will need to use a different tree type than the default
- * KDTree, which only works with the LMetric class.
+ * decomposing Q = L^T L (via a Cholesky decomposition), and then multiply the
+ * data by L; Transform() does this.  The Euclidean distance between stretched
+ * points is the Mahalanobis distance between the original points, so the
+ * default KDTree and the EuclideanDistance can then be used, and each distance
+ * evaluation costs O(d) instead of O(d^2):
+ *
+ * @code
+ * MahalanobisDistance<> distance(covariance);
+ * arma::mat stretchedReferences, stretchedQueries;
+ * distance.Transform(references, stretchedReferences);
+ * distance.Transform(queries, stretchedQueries);
+ *
+ * KNN knn(std::move(stretchedReferences));
+ * knn.Search(stretchedQueries, k, neighbors, distances);
+ * @endcode
+ *
+ * If you still wish to use the KNN class with a custom distance anyway, you
+ * will need to use a different tree type than the default KDTree, which only
+ * works with the LMetric class.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -109,6 +124,30 @@ class MahalanobisDistance
    */
   arma::mat& Covariance() { return covariance; }
 
+  /**
+   * Get the matrix L such that Q = L^T L, where Q is the covariance matrix.  L
+   * is the upper triangular Cholesky factor of Q; if Q is only positive
+   * semidefinite, L is computed from the eigendecomposition of Q instead.  If
+   * the covariance matrix has not been set, the identity of the given
+   * dimensionality is returned.
+   *
+   * @param dimensionality Dimensionality of the points (used only if the
+   *     covariance matrix has not been set).
+   */
+  arma::mat Transformation(const size_t dimensionality = 0) const;
+
+  /**
+   * Stretch the given points by the transformation L (see Transformation()),
+   * so that the Euclidean distance between any two stretched points is the
+   * Mahalanobis distance between the original points.  Searching the stretched
+   * points with the EuclideanDistance (and any tree type) gives the results of
+   * searching the original points with this distance.
+   *
+   * @param input Points to stretch (one per column).
+   * @param output Matrix to store the stretched points in.
+   */
+  void Transform(const arma::mat& input, arma::mat& output) const;
+
   //! Serialize the Mahalanobis distance.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
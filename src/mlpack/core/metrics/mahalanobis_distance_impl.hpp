@@ -47,6 +47,49 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   return sqrt(out[0]);
 }
 
+template<bool TakeRoot>
+arma::mat MahalanobisDistance<TakeRoot>::Transformation(
+    const size_t dimensionality) const
+{
+  if (covariance.n_rows == 0)
+    return arma::eye<arma::mat>(dimensionality, dimensionality);
+
+  // Q = L^T L for the upper triangular Cholesky factor L.
+  arma::mat transformation;
+  if (arma::chol(transformation, covariance))
+    return transformation;
+
+  // The Cholesky decomposition fails if Q is singular; with the
+  // eigendecomposition Q = V D V^T, we can use L = D^(1/2) V^T.
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  if (!arma::eig_sym(eigenvalues, eigenvectors, covariance))
+  {
+    throw std::invalid_argument("MahalanobisDistance::Transformation(): "
+        "cannot decompose the covariance matrix");
+  }
+
+  // Small negative eigenvalues are rounding errors.
+  eigenvalues = arma::sqrt(arma::clamp(eigenvalues, 0.0, DBL_MAX));
+  return arma::diagmat(eigenvalues) * eigenvectors.t();
+}
+
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::Transform(const arma::mat& input,
+                                              arma::mat& output) const
+{
+  if (covariance.n_rows != 0 && covariance.n_cols != input.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "MahalanobisDistance::Transform(): dimensionality of the points ("
+        << input.n_rows << ") does not match the dimensionality of the "
+        << "covariance matrix (" << covariance.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  output = Transformation(input.n_rows) * input;
+}
+
 // Serialize the Mahalanobis distance.
 template<bool TakeRoot>
 template<typename Archive>
@@ -0,0 +1,193 @@
+/**
+ * @file lazy_adam_update.hpp
+ *
+ * Adam update for sparse gradients, with the moment decay and weight decay
+ * applied lazily to the coordinates that each gradient doesn't touch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_ADAM_LAZY_ADAM_UPDATE_HPP
+#define MLPACK_CORE_OPTIMIZERS_ADAM_LAZY_ADAM_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Adam update policy for sparse gradients, for use with SparseSGD.  Only the
+ * coordinates where the gradient is nonzero are updated at each step.  The
+ * step at which each coordinate was last updated is stored, and when it is
+ * touched again its moment estimates are first decayed by the missed steps
+ * (by \f$ \beta_1^k \f$ and \f$ \beta_2^k \f$), as they would have been with a
+ * zero gradient.  The parameter updates that the decaying first moment would
+ * have made in the meantime are dropped, as in the "lazy" Adam variants of
+ * other libraries; this is what makes the cost of each step proportional to
+ * the number of nonzeros in the gradient.
+ *
+ * Optionally, decoupled weight decay (as in AdamW) is applied: every step
+ * scales the parameters by \f$ 1 - \alpha \lambda \f$, and the missed steps
+ * are applied exactly when a coordinate is touched or Finalize() is called.
+ * The gradient of the function should then not include the regularization
+ * term.
+ *
+ * For more information on Adam, see AdamUpdate.
+ */
+class LazyAdamUpdate
+{
+ public:
+  /**
+   * Construct the lazy Adam update policy.
+   *
+   * @param epsilon The epsilon value used to initialise the squared gradient
+   *     parameter.
+   * @param beta1 The smoothing parameter.
+   * @param beta2 The second moment coefficient.
+   * @param lambda The decoupled weight decay.
+   */
+  LazyAdamUpdate(const double epsilon = 1e-8,
+                 const double beta1 = 0.9,
+                 const double beta2 = 0.999,
+                 const double lambda = 0.0) :
+      epsilon(epsilon),
+      beta1(beta1),
+      beta2(beta2),
+      lambda(lambda),
+      iteration(0)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The Initialize method is called by the SparseSGD optimizer before the
+   * start of the iteration update process.
+   *
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    m = arma::zeros<arma::mat>(rows, cols);
+    v = arma::zeros<arma::mat>(rows, cols);
+    lastUpdate = arma::zeros<arma::umat>(rows, cols);
+    iteration = 0;
+  }
+
+  /**
+   * Update step for lazy Adam.  Only the coordinates where the gradient is
+   * nonzero are brought up to date and updated.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::sp_mat& gradient)
+  {
+    // Increment the iteration counter variable.
+    ++iteration;
+
+    const double biasCorrection1 = 1.0 - std::pow(beta1, iteration);
+    const double biasCorrection2 = 1.0 - std::pow(beta2, iteration);
+    const double scale = stepSize * std::sqrt(biasCorrection2) /
+        biasCorrection1;
+
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+        it != gradient.end(); ++it)
+    {
+      const size_t i = it.row() + it.col() * iterate.n_rows;
+      CatchUp(iterate, stepSize, i, iteration - lastUpdate[i]);
+
+      // CatchUp() applied the decay of this step too.
+      m[i] += (1 - beta1) * (*it);
+      v[i] += (1 - beta2) * (*it) * (*it);
+      iterate[i] -= scale * m[i] / (std::sqrt(v[i]) + epsilon);
+      lastUpdate[i] = iteration;
+    }
+  }
+
+  /**
+   * Bring the weight decay and the moment estimates of all the coordinates up
+   * to date.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size used for the missed steps.
+   */
+  void Finalize(arma::mat& iterate, const double stepSize)
+  {
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+    {
+      CatchUp(iterate, stepSize, i, iteration - lastUpdate[i]);
+      lastUpdate[i] = iteration;
+    }
+  }
+
+  //! Get the value used to initialise the squared gradient parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used to initialise the squared gradient parameter.
+  double& Epsilon() { return epsilon; }
+
+  //! Get the smoothing parameter.
+  double Beta1() const { return beta1; }
+  //! Modify the smoothing parameter.
+  double& Beta1() { return beta1; }
+
+  //! Get the second moment coefficient.
+  double Beta2() const { return beta2; }
+  //! Modify the second moment coefficient.
+  double& Beta2() { return beta2; }
+
+  //! Get the decoupled weight decay.
+  double Lambda() const { return lambda; }
+  //! Modify the decoupled weight decay.
+  double& Lambda() { return lambda; }
+
+ private:
+  //! Apply the decay of the given number of steps to a coordinate.
+  void CatchUp(arma::mat& iterate,
+               const double stepSize,
+               const size_t i,
+               const size_t steps)
+  {
+    if (steps == 0)
+      return;
+
+    m[i] *= std::pow(beta1, (double) steps);
+    v[i] *= std::pow(beta2, (double) steps);
+    if (lambda != 0.0)
+      iterate[i] *= std::pow(1.0 - stepSize * lambda, (double) steps);
+  }
+
+  // The epsilon value used to initialise the squared gradient parameter.
+  double epsilon;
+
+  // The smoothing parameter.
+  double beta1;
+
+  // The second moment coefficient.
+  double beta2;
+
+  // The decoupled weight decay.
+  double lambda;
+
+  // The exponential moving average of gradient values.
+  arma::mat m;
+
+  // The exponential moving average of squared gradient values.
+  arma::mat v;
+
+  // The step at which each coordinate was last brought up to date.
+  arma::umat lastUpdate;
+
+  // The number of steps taken so far.
+  size_t iteration;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
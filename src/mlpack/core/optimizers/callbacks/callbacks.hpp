@@ -0,0 +1,268 @@
+/**
+ * @file callbacks.hpp
+ *
+ * Invocation of the callbacks that can be given to the Optimize() methods of
+ * the optimizers, at compile time, so that they cost nothing when unused.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_CALLBACKS_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_CALLBACKS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <initializer_list>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * The optimizers that support callbacks (SGD and the optimizers built on it,
+ * like Adam, as well as L_BFGS and SVRG) take any number of callback objects
+ * after the coordinates:
+ *
+ * @code
+ * SGD<> sgd(0.01, 32, 0);
+ * sgd.Optimize(f, coordinates, EarlyStopAtMinLoss(5), TimeBudget(60.0));
+ * @endcode
+ *
+ * A callback is any class with some of the following methods; the others are
+ * simply not called, and with no callbacks at all nothing is called, so the
+ * optimizers are as fast as without this mechanism.
+ *
+ *   // At the start and at the end of the optimization.
+ *   void BeginOptimization(OptimizerType& optimizer,
+ *                          FunctionType& function,
+ *                          arma::mat& coordinates);
+ *   void EndOptimization(OptimizerType& optimizer,
+ *                       FunctionType& function,
+ *                       arma::mat& coordinates);
+ *
+ *   // After each step (update of the coordinates).
+ *   bool StepTaken(OptimizerType& optimizer,
+ *                  FunctionType& function,
+ *                  arma::mat& coordinates);
+ *
+ *   // After a gradient has been computed, before it is used.
+ *   bool Gradient(OptimizerType& optimizer,
+ *                 FunctionType& function,
+ *                 const arma::mat& coordinates,
+ *                 const arma::mat& gradient);
+ *
+ *   // At the end of each epoch (a pass over the data, or an iteration of
+ *   // L-BFGS), with the objective of that epoch.
+ *   bool EndEpoch(OptimizerType& optimizer,
+ *                 FunctionType& function,
+ *                 const arma::mat& coordinates,
+ *                 const size_t epoch,
+ *                 const double objective);
+ *
+ * The methods can be templates, to work with any optimizer and function.  If
+ * any callback returns true from one of the last three methods, the
+ * optimization terminates (all the callbacks are still called for that event).
+ */
+class Callback
+{
+ public:
+  //! Call BeginOptimization() on all the callbacks that have it.
+  template<typename OptimizerType, typename FunctionType,
+           typename... CallbackTypes>
+  static void BeginOptimization(OptimizerType& optimizer,
+                                FunctionType& function,
+                                arma::mat& coordinates,
+                                CallbackTypes&... callbacks)
+  {
+    (void) std::initializer_list<int>{ (BeginOptimizationImpl(callbacks,
+        optimizer, function, coordinates, 0), 0)... };
+  }
+
+  //! Call EndOptimization() on all the callbacks that have it.
+  template<typename OptimizerType, typename FunctionType,
+           typename... CallbackTypes>
+  static void EndOptimization(OptimizerType& optimizer,
+                              FunctionType& function,
+                              arma::mat& coordinates,
+                              CallbackTypes&... callbacks)
+  {
+    (void) std::initializer_list<int>{ (EndOptimizationImpl(callbacks,
+        optimizer, function, coordinates, 0), 0)... };
+  }
+
+  //! Call StepTaken() on all the callbacks that have it, and return whether
+  //! any of them asked to terminate.
+  template<typename OptimizerType, typename FunctionType,
+           typename... CallbackTypes>
+  static bool StepTaken(OptimizerType& optimizer,
+                        FunctionType& function,
+                        arma::mat& coordinates,
+                        CallbackTypes&... callbacks)
+  {
+    bool terminate = false;
+    (void) std::initializer_list<int>{ (terminate |= StepTakenImpl(callbacks,
+        optimizer, function, coordinates, 0), 0)... };
+    return terminate;
+  }
+
+  //! Call Gradient() on all the callbacks that have it, and return whether
+  //! any of them asked to terminate.
+  template<typename OptimizerType, typename FunctionType,
+           typename... CallbackTypes>
+  static bool Gradient(OptimizerType& optimizer,
+                       FunctionType& function,
+                       const arma::mat& coordinates,
+                       const arma::mat& gradient,
+                       CallbackTypes&... callbacks)
+  {
+    bool terminate = false;
+    (void) std::initializer_list<int>{ (terminate |= GradientImpl(callbacks,
+        optimizer, function, coordinates, gradient, 0), 0)... };
+    return terminate;
+  }
+
+  //! Call EndEpoch() on all the callbacks that have it, and return whether
+  //! any of them asked to terminate.
+  template<typename OptimizerType, typename FunctionType,
+           typename... CallbackTypes>
+  static bool EndEpoch(OptimizerType& optimizer,
+                       FunctionType& function,
+                       const arma::mat& coordinates,
+                       const size_t epoch,
+                       const double objective,
+                       CallbackTypes&... callbacks)
+  {
+    bool terminate = false;
+    (void) std::initializer_list<int>{ (terminate |= EndEpochImpl(callbacks,
+        optimizer, function, coordinates, epoch, objective, 0), 0)... };
+    return terminate;
+  }
+
+ private:
+  // Each event has two overloads: the first (preferred through the int
+  // argument) is only viable if the callback has the method, and the second
+  // does nothing.
+
+  template<typename CallbackType, typename OptimizerType, typename FunctionType>
+  static auto BeginOptimizationImpl(CallbackType& callback,
+                                    OptimizerType& optimizer,
+                                    FunctionType& function,
+                                    arma::mat& coordinates,
+                                    int)
+      -> decltype(callback.BeginOptimization(optimizer, function, coordinates),
+                  void())
+  {
+    callback.BeginOptimization(optimizer, function, coordinates);
+  }
+
+  template<typename CallbackType, typename OptimizerType, typename FunctionType>
+  static void BeginOptimizationImpl(CallbackType& /* callback */,
+                                    OptimizerType& /* optimizer */,
+                                    FunctionType& /* function */,
+                                    arma::mat& /* coordinates */,
+                                    long)
+  { }
+
+  template<typename CallbackType, typename OptimizerType, typename FunctionType>
+  static auto EndOptimizationImpl(CallbackType& callback,
+                                  OptimizerType& optimizer,
+                                  FunctionType& function,
+                                  arma::mat& coordinates,
+                                  int)
+      -> decltype(callback.EndOptimization(optimizer, function, coordinates),
+                  void())
+  {
+    callback.EndOptimization(optimizer, function, coordinates);
+  }
+
+  template<typename CallbackType, typename OptimizerType, typename FunctionType>
+  static void EndOptimizationImpl(CallbackType& /* callback */,
+                                  OptimizerType& /* optimizer */,
+                                  FunctionType& /* function */,
+                                  arma::mat& /* coordinates */,
+                                  long)
+  { }
+
+  template<typename CallbackType, typename OptimizerType, typename FunctionType>
+  static auto StepTakenImpl(CallbackType& callback,
+                            OptimizerType& optimizer,
+                            FunctionType& function,
+                            arma::mat& coordinates,
+                            int)
+      -> decltype(callback.StepTaken(optimizer, function, coordinates), bool())
+  {
+    return callback.StepTaken(optimizer, function, coordinates);
+  }
+
+  template<typename CallbackType, typename OptimizerType, typename FunctionType>
+  static bool StepTakenImpl(CallbackType& /* callback */,
+                            OptimizerType& /* optimizer */,
+                            FunctionType& /* function */,
+                            arma::mat& /* coordinates */,
+                            long)
+  {
+    return false;
+  }
+
+  template<typename CallbackType, typename OptimizerType, typename FunctionType>
+  static auto GradientImpl(CallbackType& callback,
+                           OptimizerType& optimizer,
+                           FunctionType& function,
+                           const arma::mat& coordinates,
+                           const arma::mat& gradient,
+                           int)
+      -> decltype(callback.Gradient(optimizer, function, coordinates, gradient),
+                  bool())
+  {
+    return callback.Gradient(optimizer, function, coordinates, gradient);
+  }
+
+  template<typename CallbackType, typename OptimizerType, typename FunctionType>
+  static bool GradientImpl(CallbackType& /* callback */,
+                           OptimizerType& /* optimizer */,
+                           FunctionType& /* function */,
+                           const arma::mat& /* coordinates */,
+                           const arma::mat& /* gradient */,
+                           long)
+  {
+    return false;
+  }
+
+  template<typename CallbackType, typename OptimizerType, typename FunctionType>
+  static auto EndEpochImpl(CallbackType& callback,
+                           OptimizerType& optimizer,
+                           FunctionType& function,
+                           const arma::mat& coordinates,
+                           const size_t epoch,
+                           const double objective,
+                           int)
+      -> decltype(callback.EndEpoch(optimizer, function, coordinates, epoch,
+                  objective), bool())
+  {
+    return callback.EndEpoch(optimizer, function, coordinates, epoch,
+        objective);
+  }
+
+  template<typename CallbackType, typename OptimizerType, typename FunctionType>
+  static bool EndEpochImpl(CallbackType& /* callback */,
+                           OptimizerType& /* optimizer */,
+                           FunctionType& /* function */,
+                           const arma::mat& /* coordinates */,
+                           const size_t /* epoch */,
+                           const double /* objective */,
+                           long)
+  {
+    return false;
+  }
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// The callbacks that come with mlpack.
+#include "early_stop_at_min_loss.hpp"
+#include "time_budget.hpp"
+#include "checkpoint.hpp"
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file checkpoint.hpp
+ *
+ * A callback that saves the coordinates periodically during the optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_CHECKPOINT_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_CHECKPOINT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/save.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Save the coordinates with data::Save() every given number of epochs, and at
+ * the end of the optimization, so that a long optimization can be resumed
+ * from the last checkpoint (by loading the file and passing it as the
+ * starting point).  The format is chosen from the extension of the file name
+ * as usual; a binary format (".bin") is exact and fastest to write.  Errors
+ * while saving are reported as warnings, and don't stop the optimization.
+ */
+class Checkpoint
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param filename File to save the coordinates to.
+   * @param period Number of epochs between two checkpoints.
+   */
+  Checkpoint(const std::string& filename, const size_t period = 1) :
+      filename(filename),
+      period(std::max(period, (size_t) 1))
+  { /* Nothing to do. */ }
+
+  //! Save the coordinates if this epoch is a checkpoint.
+  template<typename OptimizerType, typename FunctionType>
+  bool EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const arma::mat& coordinates,
+                const size_t epoch,
+                const double /* objective */)
+  {
+    if (epoch % period == 0)
+      data::Save(filename, coordinates, false, false);
+    return false;
+  }
+
+  //! Save the final coordinates.
+  template<typename OptimizerType, typename FunctionType>
+  void EndOptimization(OptimizerType& /* optimizer */,
+                       FunctionType& /* function */,
+                       arma::mat& coordinates)
+  {
+    data::Save(filename, coordinates, false, false);
+  }
+
+  //! Get the file the coordinates are saved to.
+  const std::string& Filename() const { return filename; }
+  //! Modify the file the coordinates are saved to.
+  std::string& Filename() { return filename; }
+
+  //! Get the number of epochs between two checkpoints.
+  size_t Period() const { return period; }
+  //! Modify the number of epochs between two checkpoints.
+  size_t& Period() { return period; }
+
+ private:
+  //! The file the coordinates are saved to.
+  std::string filename;
+  //! The number of epochs between two checkpoints.
+  size_t period;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
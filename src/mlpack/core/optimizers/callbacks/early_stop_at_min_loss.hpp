@@ -0,0 +1,143 @@
+/**
+ * @file early_stop_at_min_loss.hpp
+ *
+ * A callback that stops the optimization when the loss stops decreasing.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_EARLY_STOP_AT_MIN_LOSS_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_EARLY_STOP_AT_MIN_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <functional>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Stop the optimization when the loss hasn't improved for the given number of
+ * epochs (the patience).  By default the loss is the objective that the
+ * optimizer reports at the end of each epoch; a function computing another
+ * loss from the coordinates (typically the loss on a validation set) can be
+ * given instead.  Optionally, the coordinates with the lowest loss are
+ * restored at the end of the optimization.
+ */
+class EarlyStopAtMinLoss
+{
+ public:
+  /**
+   * Stop when the objective of the optimizer hasn't improved for the given
+   * number of epochs.
+   *
+   * @param patience Number of epochs to wait for an improvement.
+   * @param restoreBest Whether to restore the best coordinates at the end.
+   */
+  EarlyStopAtMinLoss(const size_t patience = 10,
+                     const bool restoreBest = false) :
+      patience(patience),
+      restoreBest(restoreBest),
+      bestLoss(std::numeric_limits<double>::max()),
+      steps(0)
+  { /* Nothing to do. */ }
+
+  /**
+   * Stop when the loss computed by the given function hasn't improved for the
+   * given number of epochs.
+   *
+   * @param lossFunction Function computing the loss of the given coordinates.
+   * @param patience Number of epochs to wait for an improvement.
+   * @param restoreBest Whether to restore the best coordinates at the end.
+   */
+  EarlyStopAtMinLoss(std::function<double(const arma::mat&)> lossFunction,
+                     const size_t patience = 10,
+                     const bool restoreBest = false) :
+      lossFunction(lossFunction),
+      patience(patience),
+      restoreBest(restoreBest),
+      bestLoss(std::numeric_limits<double>::max()),
+      steps(0)
+  { /* Nothing to do. */ }
+
+  //! Reset the state at the start of the optimization.
+  template<typename OptimizerType, typename FunctionType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& /* function */,
+                         arma::mat& /* coordinates */)
+  {
+    bestLoss = std::numeric_limits<double>::max();
+    steps = 0;
+    best.reset();
+  }
+
+  //! Check whether the loss improved at the end of the epoch.
+  template<typename OptimizerType, typename FunctionType>
+  bool EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const arma::mat& coordinates,
+                const size_t /* epoch */,
+                const double objective)
+  {
+    const double loss = lossFunction ? lossFunction(coordinates) : objective;
+    if (loss < bestLoss)
+    {
+      bestLoss = loss;
+      steps = 0;
+      if (restoreBest)
+        best = coordinates;
+      return false;
+    }
+
+    if (++steps < patience)
+      return false;
+
+    Log::Info << "EarlyStopAtMinLoss: no improvement in " << patience
+        << " epochs; terminating optimization." << std::endl;
+    return true;
+  }
+
+  //! Restore the best coordinates, if requested.
+  template<typename OptimizerType, typename FunctionType>
+  void EndOptimization(OptimizerType& /* optimizer */,
+                       FunctionType& /* function */,
+                       arma::mat& coordinates)
+  {
+    if (restoreBest && best.n_elem == coordinates.n_elem)
+      coordinates = best;
+  }
+
+  //! Get the lowest loss seen.
+  double BestLoss() const { return bestLoss; }
+
+  //! Get the number of epochs to wait for an improvement.
+  size_t Patience() const { return patience; }
+  //! Modify the number of epochs to wait for an improvement.
+  size_t& Patience() { return patience; }
+
+  //! Get whether the best coordinates are restored at the end.
+  bool RestoreBest() const { return restoreBest; }
+  //! Modify whether the best coordinates are restored at the end.
+  bool& RestoreBest() { return restoreBest; }
+
+ private:
+  //! The function computing the loss, if not the objective.
+  std::function<double(const arma::mat&)> lossFunction;
+  //! The number of epochs to wait for an improvement.
+  size_t patience;
+  //! Whether to restore the best coordinates at the end.
+  bool restoreBest;
+  //! The lowest loss seen.
+  double bestLoss;
+  //! The number of epochs since the last improvement.
+  size_t steps;
+  //! The coordinates with the lowest loss, if restoreBest is set.
+  arma::mat best;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
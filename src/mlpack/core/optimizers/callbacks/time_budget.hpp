@@ -0,0 +1,94 @@
+/**
+ * @file time_budget.hpp
+ *
+ * A callback that stops the optimization when a time budget is exhausted.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_TIME_BUDGET_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_TIME_BUDGET_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <chrono>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Stop the optimization once the given number of seconds have passed since
+ * its start.  The time is checked after every step, so the budget is exceeded
+ * by at most the time of one step (or one epoch for optimizers that don't
+ * report steps).
+ */
+class TimeBudget
+{
+ public:
+  /**
+   * Create the callback with the given budget.
+   *
+   * @param seconds Number of seconds the optimization may take.
+   */
+  TimeBudget(const double seconds) : seconds(seconds) { }
+
+  //! Start the clock.
+  template<typename OptimizerType, typename FunctionType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& /* function */,
+                         arma::mat& /* coordinates */)
+  {
+    start = std::chrono::steady_clock::now();
+  }
+
+  //! Check the budget after each step.
+  template<typename OptimizerType, typename FunctionType>
+  bool StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 arma::mat& /* coordinates */)
+  {
+    return Exhausted();
+  }
+
+  //! Check the budget at the end of each epoch.
+  template<typename OptimizerType, typename FunctionType>
+  bool EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const arma::mat& /* coordinates */,
+                const size_t /* epoch */,
+                const double /* objective */)
+  {
+    return Exhausted();
+  }
+
+  //! Get the budget, in seconds.
+  double Seconds() const { return seconds; }
+  //! Modify the budget, in seconds.
+  double& Seconds() { return seconds; }
+
+ private:
+  //! Return whether the budget is exhausted.
+  bool Exhausted() const
+  {
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() < seconds)
+      return false;
+
+    Log::Info << "TimeBudget: " << seconds << " seconds have passed; "
+        << "terminating optimization." << std::endl;
+    return true;
+  }
+
+  //! The budget, in seconds.
+  double seconds;
+  //! The start of the optimization.
+  std::chrono::steady_clock::time_point start;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
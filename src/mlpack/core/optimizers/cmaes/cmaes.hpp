@@ -60,6 +60,12 @@ namespace optimization {
  * objective function on the first point in the dataset (presumably, the dataset
  * is held internally in the DecomposableFunctionType).
  *
+ * The candidates of each iteration are independent, so they can be evaluated
+ * concurrently by setting numThreads to a value other than 1.  In that case
+ * Evaluate() is called from several threads at once, so it must not modify
+ * the function object (as for the const Evaluate() of
+ * LogisticRegressionFunction).  The default is to use a single thread.
+ *
  * @tparam SelectionPolicy The selection strategy used for the evaluation step.
  */
 template<typename SelectionPolicyType = FullSelection>
@@ -83,6 +89,9 @@ class CMAES
    * @param tolerance Maximum absolute tolerance to terminate algorithm.
    * @param selectionPolicy Instantiated selection policy used to calculate the
    *     objective.
+   * @param numThreads The number of threads used to evaluate the population
+   *     (0 uses the OpenMP default).  Anything but 1 requires that the
+   *     function can be evaluated concurrently.
    */
   CMAES(const size_t lambda = 0,
         const double lowerBound = -10,
@@ -90,7 +99,8 @@ class CMAES
         const size_t batchSize = 32,
         const size_t maxIterations = 1000,
         const double tolerance = 1e-5,
-        const SelectionPolicyType& selectionPolicy = SelectionPolicyType());
+        const SelectionPolicyType& selectionPolicy = SelectionPolicyType(),
+        const size_t numThreads = 1);
 
   /**
    * Optimize the given function using CMA-ES. The given starting point will be
@@ -140,6 +150,11 @@ class CMAES
   //! Modify the selection policy.
   SelectionPolicyType& SelectionPolicy() { return selectionPolicy; }
 
+  //! Get the number of threads used to evaluate the population.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to evaluate the population.
+  size_t& NumThreads() { return numThreads; }
+
  private:
   //! Population size.
   size_t lambda;
@@ -161,6 +176,9 @@ class CMAES
 
   //! The selection policy used to calculate the objective.
   SelectionPolicyType selectionPolicy;
+
+  //! The number of threads used to evaluate the population.
+  size_t numThreads;
 };
 
 /**
@@ -20,6 +20,10 @@
 
 #include <mlpack/core/optimizers/function.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace optimization {
 
@@ -30,14 +34,16 @@ CMAES<SelectionPolicyType>::CMAES(const size_t lambda,
                                   const size_t batchSize,
                                   const size_t maxIterations,
                                   const double tolerance,
-                                  const SelectionPolicyType& selectionPolicy) :
+                                  const SelectionPolicyType& selectionPolicy,
+                                  const size_t numThreads) :
     lambda(lambda),
     lowerBound(lowerBound),
     upperBound(upperBound),
     batchSize(batchSize),
     maxIterations(maxIterations),
     tolerance(tolerance),
-    selectionPolicy(selectionPolicy)
+    selectionPolicy(selectionPolicy),
+    numThreads(numThreads)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -119,6 +125,12 @@ double CMAES<SelectionPolicyType>::Optimize(
   arma::mat eigvec;
   arma::vec eigvalZero = arma::zeros(iterate.n_elem);
 
+  // The number of threads used to evaluate the population.
+  #ifdef HAS_OPENMP
+    const int threads = (numThreads == 0) ? omp_get_max_threads() :
+        (int) numThreads;
+  #endif
+
   // The current visitation order (sorted by population objectives).
   arma::uvec idx = arma::linspace<arma::uvec>(0, lambda - 1, lambda);
 
@@ -146,10 +158,15 @@ double CMAES<SelectionPolicyType>::Optimize(
 
       pPosition.slice(idx(j)) = mPosition.slice(idx0) + sigma(idx0) *
           pStep.slice(idx(j));
+    }
 
-      // Calculate the objective function.
-      pObjective(idx(j)) = selectionPolicy.Select(function, batchSize,
-          pPosition.slice(idx(j)));
+    // Calculate the objective function of each candidate.  The candidates are
+    // independent, so they can be evaluated concurrently.
+    #pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (omp_size_t j = 0; j < (omp_size_t) lambda; ++j)
+    {
+      pObjective(j) = selectionPolicy.Select(function, batchSize,
+          pPosition.slice(j));
     }
 
     // Sort population.
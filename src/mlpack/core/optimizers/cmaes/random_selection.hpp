@@ -54,14 +54,26 @@ class RandomSelection
     // Find the number of functions to use.
     const size_t numFunctions = function.NumFunctions();
 
+    // Draw the selections first; CMAES may call this from several threads,
+    // and the random number generator is shared.
+    std::vector<size_t> selections;
+    #pragma omp critical(random_selection)
+    {
+      for (size_t f = 0; f < std::floor(numFunctions * fraction);
+          f += batchSize)
+      {
+        selections.push_back(math::RandInt(0, numFunctions));
+      }
+    }
+
     double objective = 0;
-    for (size_t f = 0; f < std::floor(numFunctions * fraction); f += batchSize)
+    for (size_t i = 0; i < selections.size(); ++i)
     {
-      const size_t selection = math::RandInt(0, numFunctions);
       const size_t effectiveBatchSize = std::min(batchSize,
-          numFunctions - selection);
+          numFunctions - selections[i]);
 
-      objective += function.Evaluate(iterate, selection, effectiveBatchSize);
+      objective += function.Evaluate(iterate, selections[i],
+          effectiveBatchSize);
     }
 
     return objective;
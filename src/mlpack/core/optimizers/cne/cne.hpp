@@ -18,6 +18,10 @@
 
 #include <mlpack/prereqs.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace optimization {
 
@@ -70,6 +74,14 @@ namespace optimization {
  * This class must implement the following function:
  *
  *   double Evaluate(const arma::mat& iterate);
+ *
+ * The candidates of each generation are independent, so they can be evaluated
+ * concurrently by setting numThreads to a value other than 1.  In that case
+ * Evaluate() is called on the candidates themselves from several threads at
+ * once, so it must use the coordinates it is given and must not modify the
+ * function object (as for the const Evaluate() of LogisticRegressionFunction).
+ * Functions that evaluate their own parameters (like the ANN types) can only
+ * be optimized with a single thread, which is the default.
  */
 class CNE
 {
@@ -94,6 +106,9 @@ class CNE
    * @param objectiveChange Minimum change in best fitness values between two
    *     consecutive generations should be greater than threshold. If set to
    *     negative value, objectiveChange is not considered.
+   * @param numThreads The number of threads used to evaluate the population
+   *     (0 uses the OpenMP default).  Anything but 1 requires that the
+   *     function can be evaluated concurrently.
    */
   CNE(const size_t populationSize = 500,
       const size_t maxGenerations = 5000,
@@ -101,7 +116,8 @@ class CNE
       const double mutationSize = 0.02,
       const double selectPercent = 0.2,
       const double tolerance = 1e-5,
-      const double objectiveChange = 1e-5);
+      const double objectiveChange = 1e-5,
+      const size_t numThreads = 1);
 
   /**
    * Optimize the given function using CNE. The given
@@ -151,6 +167,11 @@ class CNE
   //! Modify the termination criteria of change in fitness value.
   double& ObjectiveChange() { return objectiveChange; }
 
+  //! Get the number of threads used to evaluate the population.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to evaluate the population.
+  size_t& NumThreads() { return numThreads; }
+
  private:
   //! Reproduce candidates to create the next generation.
   void Reproduce();
@@ -205,6 +226,9 @@ class CNE
   //! Minimum change in best fitness values between two generations.
   double objectiveChange;
 
+  //! The number of threads used to evaluate the population.
+  size_t numThreads;
+
   //! Number of candidates to become parent for the next generation.
   size_t numElite;
 
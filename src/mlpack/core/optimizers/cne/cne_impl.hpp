@@ -27,7 +27,8 @@ CNE::CNE(const size_t populationSize,
          const double mutationSize,
          const double selectPercent,
          const double tolerance,
-         const double objectiveChange) :
+         const double objectiveChange,
+         const size_t numThreads) :
     populationSize(populationSize),
     maxGenerations(maxGenerations),
     mutationProb(mutationProb),
@@ -35,6 +36,7 @@ CNE::CNE(const size_t populationSize,
     selectPercent(selectPercent),
     tolerance(tolerance),
     objectiveChange(objectiveChange),
+    numThreads(numThreads),
     numElite(0),
     elements(0)
 { /* Nothing to do here. */ }
@@ -90,13 +92,29 @@ double CNE::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
   for (size_t gen = 1; gen <= maxGenerations; gen++)
   {
     // Calculating fitness values of all candidates.
-    for (size_t i = 0; i < populationSize; i++)
+    if (numThreads == 1)
     {
-       // Select a candidate and insert the parameters in the function.
-       iterate = population.slice(i);
+      for (size_t i = 0; i < populationSize; i++)
+      {
+         // Select a candidate and insert the parameters in the function.
+         iterate = population.slice(i);
 
-       // Find fitness of candidate.
-       fitnessValues[i] = function.Evaluate(iterate);
+         // Find fitness of candidate.
+         fitnessValues[i] = function.Evaluate(iterate);
+      }
+    }
+    else
+    {
+      // The candidates are independent, so evaluate them concurrently; the
+      // function must then use the coordinates it is given.
+      #ifdef HAS_OPENMP
+        const int threads = (numThreads == 0) ? omp_get_max_threads() :
+            (int) numThreads;
+      #endif
+
+      #pragma omp parallel for schedule(dynamic) num_threads(threads)
+      for (omp_size_t i = 0; i < (omp_size_t) populationSize; i++)
+        fitnessValues[i] = function.Evaluate(population.slice(i));
     }
 
     Log::Info << "Generation number: " << gen << " best fitness = "
@@ -0,0 +1,190 @@
+/**
+ * @file distributed_sgd.hpp
+ *
+ * Synchronous data-parallel stochastic gradient descent across several nodes,
+ * each holding a shard of the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_DISTRIBUTED_SGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_DISTRIBUTED_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/sgd/update_policies/vanilla_update.hpp>
+#include <mlpack/core/optimizers/sgd/update_policies/momentum_update.hpp>
+#include <mlpack/core/optimizers/adam/adam_update.hpp>
+#include "transports/single_node_transport.hpp"
+#include "transports/mpi_transport.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * DistributedSGD runs mini-batch stochastic gradient descent on several nodes
+ * at once, each of which holds its own shard of the data in its own instance
+ * of the function.  Every node calls Optimize() with its shard; at each step,
+ * each node computes the gradient of a batch of its shard, the gradients are
+ * summed over all the nodes with an all-reduce, and every node applies the
+ * same update to its copy of the parameters, so the copies stay identical.
+ * One step is therefore one step of SGD with a batch of NumNodes() *
+ * batchSize points (and the step size should be chosen accordingly).  The
+ * starting point of the first node is used by all of them.
+ *
+ * The nodes communicate through the transport, which must implement:
+ *
+ *   size_t Rank() const;
+ *   size_t NumNodes() const;
+ *   void AllReduce(arma::mat& matrix);
+ *   void Broadcast(arma::mat& matrix);
+ *
+ * (see SingleNodeTransport).  MPITransport is available when mlpack is built
+ * with MPI support (the USE_MPI CMake option).
+ *
+ * Any update policy of SGD can be used, like VanillaUpdate, MomentumUpdate,
+ * or AdamUpdate for distributed Adam.  The function has the same requirements
+ * as for SGD:
+ *
+ *   size_t NumFunctions();
+ *   void Shuffle();
+ *   double Evaluate(const arma::mat& coordinates,
+ *                   const size_t i,
+ *                   const size_t batchSize);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * The shards may have different sizes; a pass over the data lasts until the
+ * largest shard has been seen, and the nodes whose shards are exhausted
+ * contribute nothing to the remaining steps.
+ *
+ * @tparam UpdatePolicyType Update policy applied to the summed gradients.
+ * @tparam TransportType Transport used to communicate between the nodes.
+ */
+template<typename UpdatePolicyType = VanillaUpdate,
+         typename TransportType = SingleNodeTransport>
+class DistributedSGD
+{
+ public:
+  /**
+   * Construct the DistributedSGD optimizer with the given parameters.  The
+   * maximum number of iterations refers to the maximum number of points that
+   * are processed by each node.  All the nodes must use the same parameters.
+   *
+   * @param stepSize Step size for each iteration.
+   * @param batchSize Batch size to use on each node for each step.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order of each shard is shuffled;
+   *     otherwise, each function is visited in linear order.
+   * @param updatePolicy Instantiated update policy used to adjust the given
+   *     parameters.
+   * @param transport Instantiated transport used to communicate.
+   * @param resetPolicy Flag that determines whether update policy parameters
+   *     are reset before every Optimize call.
+   */
+  DistributedSGD(const double stepSize = 0.01,
+                 const size_t batchSize = 32,
+                 const size_t maxIterations = 100000,
+                 const double tolerance = 1e-5,
+                 const bool shuffle = true,
+                 const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+                 const TransportType& transport = TransportType(),
+                 const bool resetPolicy = true);
+
+  /**
+   * Optimize the given function on the shard of this node.  All the nodes
+   * must call this at the same time.  The given starting point will be
+   * modified to store the finishing point of the algorithm (the same on all
+   * the nodes), and the final objective value over all the shards is
+   * returned.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @param function Function to optimize, holding the shard of this node.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType>
+  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get whether or not the update policy parameters are reset before
+  //! Optimize call.
+  bool ResetPolicy() const { return resetPolicy; }
+  //! Modify whether or not the update policy parameters are reset before
+  //! Optimize call.
+  bool& ResetPolicy() { return resetPolicy; }
+
+  //! Get the update policy.
+  const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
+  //! Modify the update policy.
+  UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
+
+  //! Get the transport.
+  const TransportType& Transport() const { return transport; }
+  //! Modify the transport.
+  TransportType& Transport() { return transport; }
+
+ private:
+  //! The step size for each example.
+  double stepSize;
+
+  //! The batch size for processing on each node.
+  size_t batchSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+
+  //! The update policy used to update the parameters in each iteration.
+  UpdatePolicyType updatePolicy;
+
+  //! The transport used to communicate between the nodes.
+  TransportType transport;
+
+  //! Flag indicating whether update policy should be reset before running
+  //! optimization.
+  bool resetPolicy;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_sgd_impl.hpp"
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file distributed_sgd_impl.hpp
+ *
+ * Implementation of synchronous distributed stochastic gradient descent.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_DISTRIBUTED_SGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_DISTRIBUTED_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_sgd.hpp"
+
+#include <mlpack/core/optimizers/function.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+template<typename UpdatePolicyType, typename TransportType>
+DistributedSGD<UpdatePolicyType, TransportType>::DistributedSGD(
+    const double stepSize,
+    const size_t batchSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const UpdatePolicyType& updatePolicy,
+    const TransportType& transport,
+    const bool resetPolicy) :
+    stepSize(stepSize),
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    updatePolicy(updatePolicy),
+    transport(transport),
+    resetPolicy(resetPolicy)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename UpdatePolicyType, typename TransportType>
+template<typename DecomposableFunctionType>
+double DistributedSGD<UpdatePolicyType, TransportType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate)
+{
+  typedef Function<DecomposableFunctionType> FullFunctionType;
+  FullFunctionType& f(static_cast<FullFunctionType&>(function));
+
+  // Make sure we have all the methods that we need.
+  traits::CheckDecomposableFunctionTypeAPI<FullFunctionType>();
+
+  // Start all the nodes from the same point.
+  transport.Broadcast(iterate);
+
+  // Find the size of the largest shard, which determines the number of steps
+  // of each pass over the data.
+  const size_t numFunctions = f.NumFunctions();
+  arma::mat shardSizes(transport.NumNodes(), 1, arma::fill::zeros);
+  shardSizes[transport.Rank()] = numFunctions;
+  transport.AllReduce(shardSizes);
+  const size_t maxFunctions = (size_t) shardSizes.max();
+  if (maxFunctions == 0)
+  {
+    Log::Warn << "Distributed SGD: all the shards are empty; nothing to do."
+        << std::endl;
+    return 0.0;
+  }
+
+  // To keep track of where we are and how things are going.
+  size_t currentFunction = 0;
+  double overallObjective = 0;
+  double lastObjective = DBL_MAX;
+
+  // Initialize the update policy.
+  if (resetPolicy)
+    updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
+
+  // The gradient of the local batch, followed by its objective, which are
+  // summed over the nodes with a single all-reduce.
+  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  arma::mat message(iterate.n_elem + 1, 1);
+
+  // Now iterate!
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  for (size_t i = 0; i < actualMaxIterations; /* incrementing done manually */)
+  {
+    // Is this iteration the start of a sequence?
+    if (currentFunction >= maxFunctions)
+    {
+      // Output current objective function.
+      Log::Info << "Distributed SGD: iteration " << i << ", objective "
+          << overallObjective << "." << std::endl;
+
+      if (std::isnan(overallObjective) || std::isinf(overallObjective))
+      {
+        Log::Warn << "Distributed SGD: converged to " << overallObjective
+            << "; terminating with failure.  Try a smaller step size?"
+            << std::endl;
+        return overallObjective;
+      }
+
+      if (std::abs(lastObjective - overallObjective) < tolerance)
+      {
+        Log::Info << "Distributed SGD: minimized within tolerance "
+            << tolerance << "; terminating optimization." << std::endl;
+        return overallObjective;
+      }
+
+      // Reset the counter variables.
+      lastObjective = overallObjective;
+      overallObjective = 0;
+      currentFunction = 0;
+
+      if (shuffle) // Determine order of visitation.
+        f.Shuffle();
+    }
+
+    // The batch can't be larger than the user-specified batch size or the
+    // number of iterations left; the shard of this node may also be
+    // exhausted already.
+    const size_t stepBatchSize = std::min(batchSize, actualMaxIterations - i);
+    const size_t effectiveBatchSize = (currentFunction >= numFunctions) ? 0 :
+        std::min(stepBatchSize, numFunctions - currentFunction);
+
+    // Technically we are computing the objective before we take the step, but
+    // for many FunctionTypes it may be much quicker to do it like this.
+    if (effectiveBatchSize > 0)
+    {
+      message[iterate.n_elem] = f.EvaluateWithGradient(iterate,
+          currentFunction, gradient, effectiveBatchSize);
+      message.rows(0, iterate.n_elem - 1) = arma::vectorise(gradient);
+    }
+    else
+    {
+      message.zeros();
+    }
+
+    // Sum the gradients and the objectives over all the nodes.
+    transport.AllReduce(message);
+    overallObjective += message[iterate.n_elem];
+    gradient = arma::reshape(message.rows(0, iterate.n_elem - 1),
+        iterate.n_rows, iterate.n_cols);
+
+    // Use the update policy to take a step.
+    updatePolicy.Update(iterate, stepSize, gradient);
+
+    i += stepBatchSize;
+    currentFunction += stepBatchSize;
+  }
+
+  Log::Info << "Distributed SGD: maximum iterations (" << maxIterations
+      << ") reached; terminating optimization." << std::endl;
+
+  // Calculate final objective over all the shards.
+  arma::mat objective(1, 1, arma::fill::zeros);
+  for (size_t i = 0; i < numFunctions; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
+    objective[0] += f.Evaluate(iterate, i, effectiveBatchSize);
+  }
+  transport.AllReduce(objective);
+  return objective[0];
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
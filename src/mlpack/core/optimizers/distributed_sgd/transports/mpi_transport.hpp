@@ -0,0 +1,104 @@
+/**
+ * @file mpi_transport.hpp
+ *
+ * An MPI transport for DistributedSGD.  It is only available if mlpack was
+ * configured with USE_MPI and MPI was found (which defines HAS_MPI).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_MPI_TRANSPORT_HPP
+#define MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_MPI_TRANSPORT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_MPI
+
+#include <mpi.h>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * A transport for DistributedSGD that communicates with MPI: each process of
+ * the communicator is a node.  MPI must have been initialized (with
+ * MPI_Init()) before the transport is used, and the user is responsible for
+ * calling MPI_Finalize().  All the processes must run the optimization
+ * together, since every step is a collective operation.
+ *
+ * @code
+ * MPI_Init(&argc, &argv);
+ * // Each process loads its own shard of the data.
+ * LogisticRegressionFunction<> f(shard, shardLabels, lambda);
+ * DistributedSGD<VanillaUpdate, MPITransport> sgd(0.01, 32);
+ * arma::mat coordinates = f.InitialPoint();
+ * sgd.Optimize(f, coordinates);
+ * MPI_Finalize();
+ * @endcode
+ */
+class MPITransport
+{
+ public:
+  /**
+   * Create the transport for the given communicator.
+   *
+   * @param communicator Communicator of the processes that take part.
+   */
+  MPITransport(MPI_Comm communicator = MPI_COMM_WORLD) :
+      communicator(communicator)
+  { /* Nothing to do. */ }
+
+  //! Get the index of this process in the communicator.
+  size_t Rank() const
+  {
+    int rank;
+    MPI_Comm_rank(communicator, &rank);
+    return (size_t) rank;
+  }
+
+  //! Get the number of processes in the communicator.
+  size_t NumNodes() const
+  {
+    int size;
+    MPI_Comm_size(communicator, &size);
+    return (size_t) size;
+  }
+
+  //! Sum the given matrix over all the processes, in place.
+  void AllReduce(arma::mat& matrix)
+  {
+    if (MPI_Allreduce(MPI_IN_PLACE, matrix.memptr(), (int) matrix.n_elem,
+        MPI_DOUBLE, MPI_SUM, communicator) != MPI_SUCCESS)
+    {
+      throw std::runtime_error("MPITransport::AllReduce(): MPI_Allreduce() "
+          "failed.");
+    }
+  }
+
+  //! Replace the given matrix with the one of the first process.
+  void Broadcast(arma::mat& matrix)
+  {
+    if (MPI_Bcast(matrix.memptr(), (int) matrix.n_elem, MPI_DOUBLE, 0,
+        communicator) != MPI_SUCCESS)
+    {
+      throw std::runtime_error("MPITransport::Broadcast(): MPI_Bcast() "
+          "failed.");
+    }
+  }
+
+  //! Get the communicator.
+  MPI_Comm Communicator() const { return communicator; }
+
+ private:
+  //! The communicator of the processes that take part.
+  MPI_Comm communicator;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif // HAS_MPI
+
+#endif
@@ -0,0 +1,49 @@
+/**
+ * @file single_node_transport.hpp
+ *
+ * The trivial transport for DistributedSGD, with a single node.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_SINGLE_NODE_TRANSPORT_HPP
+#define MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_SGD_SINGLE_NODE_TRANSPORT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * A transport for DistributedSGD with only one node, so that there is nothing
+ * to communicate; DistributedSGD then behaves like SGD.  This also documents
+ * the interface that a transport must implement.
+ */
+class SingleNodeTransport
+{
+ public:
+  //! Get the index of this node, in [0, NumNodes()).
+  size_t Rank() const { return 0; }
+
+  //! Get the number of nodes.
+  size_t NumNodes() const { return 1; }
+
+  /**
+   * Replace the given matrix with the elementwise sum of the matrices given by
+   * all the nodes, which all have the same size.
+   */
+  void AllReduce(arma::mat& /* matrix */) { /* Nothing to do. */ }
+
+  /**
+   * Replace the given matrix with the one given by the first node (rank 0).
+   * The matrices of all the nodes already have the same size.
+   */
+  void Broadcast(arma::mat& /* matrix */) { /* Nothing to do. */ }
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
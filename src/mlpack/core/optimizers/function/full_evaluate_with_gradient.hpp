@@ -0,0 +1,120 @@
+/**
+ * @file full_evaluate_with_gradient.hpp
+ *
+ * Evaluate the objective and the gradient of a decomposable function over all
+ * of its functions, batch by batch, optionally in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_FUNCTION_FULL_EVALUATE_WITH_GRADIENT_HPP
+#define MLPACK_CORE_OPTIMIZERS_FUNCTION_FULL_EVALUATE_WITH_GRADIENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/function.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Compute the sum of the objectives and the sum of the gradients of all the
+ * functions of a decomposable function, in batches of the given size, in one
+ * pass.  This is the full gradient (the snapshot) that the variance-reduced
+ * optimizers (SVRG, SARAH, Katyusha) compute at each outer iteration.
+ *
+ * With more than one thread each thread takes a contiguous range of the
+ * batches and accumulates them into its own gradient, and the gradients of
+ * the threads are summed in order at the end, so for a given number of
+ * threads the result is deterministic.  The batch methods of the function
+ * must then be safe to call concurrently (see ParallelDecomposableFunction).
+ *
+ * @param function Function to evaluate.
+ * @param coordinates Coordinates to evaluate the function at.
+ * @param batchSize Number of functions in each batch.
+ * @param gradient Matrix to store the sum of the gradients into.
+ * @param numThreads Number of threads to use (0 means all of them).
+ * @return The sum of the objectives.
+ */
+template<typename DecomposableFunctionType>
+double FullEvaluateWithGradient(DecomposableFunctionType& function,
+                                const arma::mat& coordinates,
+                                const size_t batchSize,
+                                arma::mat& gradient,
+                                const size_t numThreads = 1)
+{
+  typedef Function<DecomposableFunctionType> FullFunctionType;
+  FullFunctionType& f = static_cast<FullFunctionType&>(function);
+
+  const size_t numFunctions = f.NumFunctions();
+  const size_t numBatches = (numFunctions + batchSize - 1) / batchSize;
+
+  #ifdef HAS_OPENMP
+    const size_t maxThreads = (numThreads == 0) ?
+        (size_t) omp_get_max_threads() : numThreads;
+  #else
+    const size_t maxThreads = 1;
+  #endif
+  const size_t threads = std::max(std::min(maxThreads, numBatches),
+      (size_t) 1);
+
+  if (threads == 1)
+  {
+    size_t effectiveBatchSize = std::min(batchSize, numFunctions);
+    double objective = f.EvaluateWithGradient(coordinates, 0, gradient,
+        effectiveBatchSize);
+
+    arma::mat batchGradient(coordinates.n_rows, coordinates.n_cols);
+    for (size_t i = effectiveBatchSize; i < numFunctions; i += batchSize)
+    {
+      // The last batch may be smaller.
+      effectiveBatchSize = std::min(batchSize, numFunctions - i);
+      objective += f.EvaluateWithGradient(coordinates, i, batchGradient,
+          effectiveBatchSize);
+      gradient += batchGradient;
+    }
+
+    return objective;
+  }
+
+  std::vector<double> objectives(threads, 0.0);
+  std::vector<arma::mat> gradients(threads);
+  #pragma omp parallel for schedule(static) num_threads(threads)
+  for (omp_size_t t = 0; t < (omp_size_t) threads; ++t)
+  {
+    const size_t firstBatch = t * numBatches / threads;
+    const size_t lastBatch = (t + 1) * numBatches / threads;
+
+    arma::mat batchGradient(coordinates.n_rows, coordinates.n_cols);
+    gradients[t].zeros(coordinates.n_rows, coordinates.n_cols);
+    for (size_t b = firstBatch; b < lastBatch; ++b)
+    {
+      const size_t begin = b * batchSize;
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - begin);
+      objectives[t] += f.EvaluateWithGradient(coordinates, begin,
+          batchGradient, effectiveBatchSize);
+      gradients[t] += batchGradient;
+    }
+  }
+
+  double objective = objectives[0];
+  gradient = std::move(gradients[0]);
+  for (size_t t = 1; t < threads; ++t)
+  {
+    objective += objectives[t];
+    gradient += gradients[t];
+  }
+
+  return objective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
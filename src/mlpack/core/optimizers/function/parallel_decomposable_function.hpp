@@ -0,0 +1,302 @@
+/**
+ * @file parallel_decomposable_function.hpp
+ *
+ * A wrapper for decomposable functions that evaluates each batch in parallel,
+ * so that SGD-like optimizers scale with the number of cores.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_FUNCTION_PARALLEL_DECOMPOSABLE_FUNCTION_HPP
+#define MLPACK_CORE_OPTIMIZERS_FUNCTION_PARALLEL_DECOMPOSABLE_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/function.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * ParallelDecomposableFunction wraps a decomposable function (one with
+ * NumFunctions(), Shuffle() and the batch forms of Evaluate(), Gradient() or
+ * EvaluateWithGradient()), and splits each batch that an optimizer asks for
+ * into one sub-batch for each thread.  The sub-batches are evaluated
+ * concurrently, each into its own gradient, and the results are reduced in
+ * order, so they don't depend on the number of threads beyond rounding.  Any
+ * optimizer for decomposable functions (SGD and its variants, Adam, RMSProp,
+ * AdaGrad, SMORMS3, SGDR, BigBatchSGD, ...) can then use all the cores, and
+ * so can optimizers of the whole objective like L-BFGS, since the whole
+ * objective is one big batch:
+ *
+ * @code
+ * LogisticRegressionFunction<> lrf(data, responses, lambda);
+ * ParallelDecomposableFunction<LogisticRegressionFunction<>> f(lrf);
+ * SGD<> sgd(0.01, 256);
+ * sgd.Optimize(f, coordinates);
+ * @endcode
+ *
+ * The wrapped function must allow its batch methods to be called concurrently
+ * on different batches: they must not modify the object (as with the const
+ * methods of LogisticRegressionFunction and SoftmaxRegressionFunction).
+ * Functions that keep caches or intermediate results, such as the ANN types
+ * and LMNNFunction, can't be wrapped.
+ *
+ * The results of the sub-batches have to combine into the result of the whole
+ * batch.  By default they are summed, which is right for functions whose batch
+ * objective and gradient are sums over the points (with any regularization
+ * scaled by the size of the batch, like LogisticRegressionFunction).  If the
+ * function returns the mean over the batch (plus a regularization term that
+ * doesn't depend on the size of the batch, like SoftmaxRegressionFunction),
+ * set 'averaged' to true, and the results are weighted by the sizes of the
+ * sub-batches instead.
+ *
+ * @tparam FunctionType Decomposable function type to wrap.
+ */
+template<typename FunctionType>
+class ParallelDecomposableFunction
+{
+ public:
+  /**
+   * Wrap the given function, which must outlive this object.
+   *
+   * @param function Function to evaluate in parallel.
+   * @param minBatchSize Smallest sub-batch to give to a thread; smaller
+   *     batches are evaluated by fewer threads.
+   * @param averaged Whether the function returns the mean over each batch
+   *     instead of the sum.
+   */
+  ParallelDecomposableFunction(FunctionType& function,
+                               const size_t minBatchSize = 32,
+                               const bool averaged = false) :
+      function(function),
+      minBatchSize(std::max(minBatchSize, (size_t) 1)),
+      averaged(averaged)
+  { /* Nothing to do. */ }
+
+  //! Return the number of functions (points) of the wrapped function.
+  size_t NumFunctions() const { return function.NumFunctions(); }
+
+  //! Shuffle the wrapped function.
+  void Shuffle() { function.Shuffle(); }
+
+  /**
+   * Evaluate the objective of the given batch, in parallel.
+   *
+   * @param coordinates Coordinates to evaluate the function at.
+   * @param begin First function (point) of the batch.
+   * @param batchSize Number of functions in the batch.
+   */
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t begin,
+                  const size_t batchSize)
+  {
+    const size_t numSubBatches = NumSubBatches(batchSize);
+    if (numSubBatches == 1)
+      return Wrapped().Evaluate(coordinates, begin, batchSize);
+
+    std::vector<double> objectives(numSubBatches);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) numSubBatches; ++j)
+    {
+      const size_t first = SubBatchBegin(begin, batchSize, numSubBatches, j);
+      const size_t last = SubBatchBegin(begin, batchSize, numSubBatches,
+          j + 1);
+      objectives[j] = Wrapped().Evaluate(coordinates, first, last - first);
+    }
+
+    double objective = 0.0;
+    for (size_t j = 0; j < numSubBatches; ++j)
+      objective += Weight(batchSize, numSubBatches, j) * objectives[j];
+    return objective;
+  }
+
+  /**
+   * Evaluate the gradient of the given batch, in parallel.
+   *
+   * @param coordinates Coordinates to evaluate the gradient at.
+   * @param begin First function (point) of the batch.
+   * @param gradient Matrix to store the gradient into.
+   * @param batchSize Number of functions in the batch.
+   */
+  void Gradient(const arma::mat& coordinates,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize)
+  {
+    const size_t numSubBatches = NumSubBatches(batchSize);
+    if (numSubBatches == 1)
+    {
+      Wrapped().Gradient(coordinates, begin, gradient, batchSize);
+      return;
+    }
+
+    gradients.resize(numSubBatches);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) numSubBatches; ++j)
+    {
+      const size_t first = SubBatchBegin(begin, batchSize, numSubBatches, j);
+      const size_t last = SubBatchBegin(begin, batchSize, numSubBatches,
+          j + 1);
+      Wrapped().Gradient(coordinates, first, gradients[j], last - first);
+    }
+
+    ReduceGradients(batchSize, numSubBatches, gradient);
+  }
+
+  /**
+   * Evaluate the objective and the gradient of the given batch, in parallel.
+   *
+   * @param coordinates Coordinates to evaluate the function at.
+   * @param begin First function (point) of the batch.
+   * @param gradient Matrix to store the gradient into.
+   * @param batchSize Number of functions in the batch.
+   */
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize)
+  {
+    const size_t numSubBatches = NumSubBatches(batchSize);
+    if (numSubBatches == 1)
+    {
+      return Wrapped().EvaluateWithGradient(coordinates, begin, gradient,
+          batchSize);
+    }
+
+    std::vector<double> objectives(numSubBatches);
+    gradients.resize(numSubBatches);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) numSubBatches; ++j)
+    {
+      const size_t first = SubBatchBegin(begin, batchSize, numSubBatches, j);
+      const size_t last = SubBatchBegin(begin, batchSize, numSubBatches,
+          j + 1);
+      objectives[j] = Wrapped().EvaluateWithGradient(coordinates, first,
+          gradients[j], last - first);
+    }
+
+    double objective = 0.0;
+    for (size_t j = 0; j < numSubBatches; ++j)
+      objective += Weight(batchSize, numSubBatches, j) * objectives[j];
+    ReduceGradients(batchSize, numSubBatches, gradient);
+    return objective;
+  }
+
+  /**
+   * Evaluate the objective over all the functions, in parallel.  This (with
+   * the other non-decomposable overloads) allows the wrapper to be given to
+   * optimizers that use the whole objective, like L-BFGS.
+   *
+   * @param coordinates Coordinates to evaluate the function at.
+   */
+  double Evaluate(const arma::mat& coordinates)
+  {
+    return Evaluate(coordinates, 0, NumFunctions());
+  }
+
+  /**
+   * Evaluate the gradient over all the functions, in parallel.
+   *
+   * @param coordinates Coordinates to evaluate the gradient at.
+   * @param gradient Matrix to store the gradient into.
+   */
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient)
+  {
+    Gradient(coordinates, 0, gradient, NumFunctions());
+  }
+
+  /**
+   * Evaluate the objective and the gradient over all the functions, in
+   * parallel.
+   *
+   * @param coordinates Coordinates to evaluate the function at.
+   * @param gradient Matrix to store the gradient into.
+   */
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              arma::mat& gradient)
+  {
+    return EvaluateWithGradient(coordinates, 0, gradient, NumFunctions());
+  }
+
+  //! Get the wrapped function.
+  const FunctionType& WrappedFunction() const { return function; }
+
+  //! Get the smallest sub-batch given to a thread.
+  size_t MinBatchSize() const { return minBatchSize; }
+  //! Modify the smallest sub-batch given to a thread.
+  size_t& MinBatchSize() { return minBatchSize; }
+
+  //! Get whether the results of the sub-batches are averaged.
+  bool Averaged() const { return averaged; }
+  //! Modify whether the results of the sub-batches are averaged.
+  bool& Averaged() { return averaged; }
+
+ private:
+  //! Get the wrapped function with all the derived methods.
+  Function<FunctionType>& Wrapped()
+  {
+    return static_cast<Function<FunctionType>&>(function);
+  }
+
+  //! Return the number of sub-batches to split a batch into.
+  size_t NumSubBatches(const size_t batchSize) const
+  {
+    #ifdef HAS_OPENMP
+      const size_t threads = (size_t) omp_get_max_threads();
+    #else
+      const size_t threads = 1;
+    #endif
+    return std::max(std::min(threads, batchSize / minBatchSize), (size_t) 1);
+  }
+
+  //! Return the first function of the given sub-batch.
+  static size_t SubBatchBegin(const size_t begin,
+                              const size_t batchSize,
+                              const size_t numSubBatches,
+                              const size_t subBatch)
+  {
+    return begin + subBatch * batchSize / numSubBatches;
+  }
+
+  //! Return the weight of the result of the given sub-batch.
+  double Weight(const size_t batchSize,
+                const size_t numSubBatches,
+                const size_t subBatch) const
+  {
+    if (!averaged)
+      return 1.0;
+
+    return (double) (SubBatchBegin(0, batchSize, numSubBatches, subBatch + 1) -
+        SubBatchBegin(0, batchSize, numSubBatches, subBatch)) / batchSize;
+  }
+
+  //! Combine the gradients of the sub-batches into the given gradient.
+  void ReduceGradients(const size_t batchSize,
+                       const size_t numSubBatches,
+                       arma::mat& gradient) const
+  {
+    gradient = Weight(batchSize, numSubBatches, 0) * gradients[0];
+    for (size_t j = 1; j < numSubBatches; ++j)
+      gradient += Weight(batchSize, numSubBatches, j) * gradients[j];
+  }
+
+  //! The wrapped function.
+  FunctionType& function;
+  //! The smallest sub-batch given to a thread.
+  size_t minBatchSize;
+  //! Whether the function returns the mean over each batch.
+  bool averaged;
+  //! The gradients of the sub-batches, kept to avoid reallocations.
+  std::vector<arma::mat> gradients;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_KATYUSHA_KATYUSHA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/function/full_evaluate_with_gradient.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -82,6 +83,10 @@ class KatyushaType
    * @param tolerance Maximum absolute tolerance to terminate algorithm.
    * @param shuffle If true, the function order is shuffled; otherwise, each
    *    function is visited in linear order.
+   * @param numThreads Number of threads used to compute the objective and the
+   *    full gradient of each outer iteration (0 means all of them).  With more
+   *    than one, the batch methods of the function must be safe to call
+   *    concurrently.
    */
   KatyushaType(const double convexity = 1.0,
                const double lipschitz = 10.0,
@@ -89,7 +94,8 @@ class KatyushaType
                const size_t maxIterations = 1000,
                const size_t innerIterations = 0,
                const double tolerance = 1e-5,
-               const bool shuffle = true);
+               const bool shuffle = true,
+               const size_t numThreads = 1);
 
   /**
    * Optimize the given function using Katyusha. The given starting point will
@@ -139,6 +145,11 @@ class KatyushaType
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return shuffle; }
 
+  //! Get the number of threads used for the full gradient.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used for the full gradient.
+  size_t& NumThreads() { return numThreads; }
+
  private:
   //! The convexity regularization term.
   double convexity;
@@ -161,6 +172,9 @@ class KatyushaType
   //! Controls whether or not the individual functions are shuffled when
   //! iterating.
   bool shuffle;
+
+  //! The number of threads used for the full gradient.
+  size_t numThreads;
 };
 
 // Convenience typedefs.
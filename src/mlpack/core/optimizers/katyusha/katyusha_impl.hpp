@@ -28,14 +28,16 @@ KatyushaType<Proximal>::KatyushaType(
     const size_t maxIterations,
     const size_t innerIterations,
     const double tolerance,
-    const bool shuffle) :
+    const bool shuffle,
+    const size_t numThreads) :
     convexity(convexity),
     lipschitz(lipschitz),
     batchSize(batchSize),
     maxIterations(maxIterations),
     innerIterations(innerIterations),
     tolerance(tolerance),
-    shuffle(shuffle)
+    shuffle(shuffle),
+    numThreads(numThreads)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -92,13 +94,10 @@ double KatyushaType<Proximal>::Optimize(
       std::numeric_limits<size_t>::max() : maxIterations;
   for (size_t i = 0; i < actualMaxIterations; ++i)
   {
-    // Calculate the objective function.
-    overallObjective = 0;
-    for (size_t f = 0; f < numFunctions; f += batchSize)
-    {
-      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-      overallObjective += function.Evaluate(iterate0, f, effectiveBatchSize);
-    }
+    // Calculate the objective function and the full gradient at the snapshot
+    // in one pass.
+    overallObjective = FullEvaluateWithGradient(function, iterate0, batchSize,
+        fullGradient, numThreads);
 
     if (std::isnan(overallObjective) || std::isinf(overallObjective))
     {
@@ -117,20 +116,6 @@ double KatyushaType<Proximal>::Optimize(
 
     lastObjective = overallObjective;
 
-    // Compute the full gradient.
-    size_t effectiveBatchSize = std::min(batchSize, numFunctions);
-    function.Gradient(iterate, 0, fullGradient, effectiveBatchSize);
-    for (size_t f = effectiveBatchSize; f < numFunctions;
-        /* incrementing done manually */)
-    {
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - f);
-
-      function.Gradient(iterate0, f, gradient, effectiveBatchSize);
-      fullGradient += gradient;
-
-      f += effectiveBatchSize;
-    }
     fullGradient /= (double) numFunctions;
 
     // To keep track of where we are and how things are going.
@@ -151,7 +136,8 @@ double KatyushaType<Proximal>::Optimize(
       }
 
       // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - currentFunction);
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - currentFunction);
       iterate = tau1 * z + tau2 * iterate0 + (1 - tau1 - tau2) * y;
 
       // Calculate variance reduced gradient.
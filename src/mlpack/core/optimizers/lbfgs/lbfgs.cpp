@@ -28,6 +28,8 @@ namespace optimization {
  *     (before giving up).
  * @param minStep The minimum step of the line search.
  * @param maxStep The maximum step of the line search.
+ * @param speculativeTrials The number of line search trials to evaluate at
+ *     once.
  */
 L_BFGS::L_BFGS(const size_t numBasis,
                const size_t maxIterations,
@@ -37,7 +39,8 @@ L_BFGS::L_BFGS(const size_t numBasis,
                const double factr,
                const size_t maxLineSearchTrials,
                const double minStep,
-               const double maxStep) :
+               const double maxStep,
+               const size_t speculativeTrials) :
     numBasis(numBasis),
     maxIterations(maxIterations),
     armijoConstant(armijoConstant),
@@ -46,7 +49,8 @@ L_BFGS::L_BFGS(const size_t numBasis,
     factr(factr),
     maxLineSearchTrials(maxLineSearchTrials),
     minStep(minStep),
-    maxStep(maxStep)
+    maxStep(maxStep),
+    speculativeTrials(speculativeTrials)
 {
   // Nothing to do.
 }
@@ -59,17 +63,15 @@ L_BFGS::L_BFGS(const size_t numBasis,
  */
 double L_BFGS::ChooseScalingFactor(const size_t iterationNum,
                                    const arma::mat& gradient,
-                                   const arma::cube& s,
-                                   const arma::cube& y)
+                                   const arma::mat& s,
+                                   const arma::mat& y)
 {
   double scalingFactor = 1.0;
   if (iterationNum > 0)
   {
-    int previousPos = (iterationNum - 1) % numBasis;
-    // Get s and y matrices once instead of multiple times.
-    const arma::mat& sMat = s.slice(previousPos);
-    const arma::mat& yMat = y.slice(previousPos);
-    scalingFactor = dot(sMat, yMat) / dot(yMat, yMat);
+    const size_t previousPos = (iterationNum - 1) % numBasis;
+    scalingFactor = dot(s.col(previousPos), y.col(previousPos)) /
+        dot(y.col(previousPos), y.col(previousPos));
   }
   else
   {
@@ -80,7 +82,17 @@ double L_BFGS::ChooseScalingFactor(const size_t iterationNum,
 }
 
 /**
- * Find the L_BFGS search direction.
+ * Find the L_BFGS search direction.  Instead of the two-loop recursion, whose
+ * dot products depend on each other, the compact representation of the
+ * inverse Hessian approximation of Byrd, Nocedal and Schnabel (1994) is used:
+ *
+ *   H = gamma I + [S gamma Y] [R^-T (D + gamma Y^T Y) R^-1, -R^-T; -R^-1, 0]
+ *       [S^T; gamma Y^T],
+ *
+ * where S and Y hold the stored pairs, from the oldest to the newest, R is the
+ * upper triangle of S^T Y, and D its diagonal.  The products with the history
+ * are then two matrix-vector products with S and Y on each side, and the rest
+ * of the work is on small matrices.
  *
  * @param gradient The gradient at the current point
  * @param iterationNum The iteration number
@@ -90,50 +102,51 @@ double L_BFGS::ChooseScalingFactor(const size_t iterationNum,
 void L_BFGS::SearchDirection(const arma::mat& gradient,
                              const size_t iterationNum,
                              const double scalingFactor,
-                             const arma::cube& s,
-                             const arma::cube& y,
+                             const arma::mat& s,
+                             const arma::mat& y,
+                             const arma::mat& sty,
+                             const arma::mat& yty,
                              arma::mat& searchDirection)
 {
-  // Start from this point.
-  searchDirection = gradient;
-
-  // See "A Recursive Formula to Compute H * g" in "Updating quasi-Newton
-  // matrices with limited storage" (Nocedal, 1980).
-
-  // Temporary variables.
-  arma::vec rho(numBasis);
-  arma::vec alpha(numBasis);
-
-  size_t limit = (numBasis > iterationNum) ? 0 : (iterationNum - numBasis);
-  for (size_t i = iterationNum; i != limit; i--)
+  const size_t stored = std::min(iterationNum, numBasis);
+  if (stored == 0)
   {
-    int translatedPosition = (i + (numBasis - 1)) % numBasis;
-    rho[iterationNum - i] = 1.0 / arma::dot(y.slice(translatedPosition),
-                                            s.slice(translatedPosition));
-    alpha[iterationNum - i] = rho[iterationNum - i] *
-        arma::dot(s.slice(translatedPosition), searchDirection);
-    searchDirection -= alpha[iterationNum - i] * y.slice(translatedPosition);
+    searchDirection = -scalingFactor * gradient;
+    return;
   }
 
-  searchDirection *= scalingFactor;
+  // The positions of the stored pairs, from the oldest to the newest.  The
+  // pairs occupy the first 'stored' columns, in some rotation.
+  arma::uvec order(stored);
+  for (size_t i = 0; i < stored; ++i)
+    order[i] = (iterationNum - stored + i) % numBasis;
 
-  for (size_t i = limit; i < iterationNum; i++)
-  {
-    int translatedPosition = i % numBasis;
-    double beta = rho[iterationNum - i - 1] *
-        arma::dot(y.slice(translatedPosition), searchDirection);
-    searchDirection += (alpha[iterationNum - i - 1] - beta) *
-        s.slice(translatedPosition);
-  }
+  const arma::vec g = arma::vectorise(gradient);
+  const arma::vec sg = s.cols(0, stored - 1).t() * g;
+  const arma::vec yg = y.cols(0, stored - 1).t() * g;
+
+  const arma::mat orderedSty = sty.submat(order, order);
+  const arma::vec u = arma::solve(arma::trimatu(orderedSty), sg.elem(order));
+  const arma::vec w = orderedSty.diag() % u + scalingFactor *
+      (yty.submat(order, order) * u - yg.elem(order));
+  const arma::vec p = arma::solve(arma::trimatl(orderedSty.t()), w);
 
-  // Negate the search direction so that it is a descent direction.
-  searchDirection *= -1;
+  // Put the coefficients back in the order of the columns of s and y.
+  arma::vec sCoef(stored), yCoef(stored);
+  sCoef.elem(order) = p;
+  yCoef.elem(order) = -scalingFactor * u;
+
+  // Negate the result so that it is a descent direction.
+  searchDirection = arma::reshape(-(scalingFactor * g +
+      s.cols(0, stored - 1) * sCoef + y.cols(0, stored - 1) * yCoef),
+      gradient.n_rows, gradient.n_cols);
 }
 
 /**
  * Update the y and s matrices, which store the differences between
  * the iterate and old iterate and the differences between the gradient and the
- * old gradient, respectively.
+ * old gradient, respectively, and the inner products between the stored
+ * vectors.
  *
  * @param iterationNum Iteration number
  * @param iterate Current point
@@ -146,14 +159,26 @@ void L_BFGS::UpdateBasisSet(const size_t iterationNum,
                             const arma::mat& oldIterate,
                             const arma::mat& gradient,
                             const arma::mat& oldGradient,
-                            arma::cube& s,
-                            arma::cube& y)
+                            arma::mat& s,
+                            arma::mat& y,
+                            arma::mat& sty,
+                            arma::mat& yty)
 {
   // Overwrite a certain position instead of pushing everything in the vector
   // back one position.
-  int overwritePos = iterationNum % numBasis;
-  s.slice(overwritePos) = iterate - oldIterate;
-  y.slice(overwritePos) = gradient - oldGradient;
+  const size_t overwritePos = iterationNum % numBasis;
+  s.col(overwritePos) = arma::vectorise(iterate - oldIterate);
+  y.col(overwritePos) = arma::vectorise(gradient - oldGradient);
+
+  // Update the inner products that involve the new pair.
+  const size_t stored = std::min(iterationNum + 1, numBasis);
+  const arma::vec syNew = s.cols(0, stored - 1).t() * y.col(overwritePos);
+  const arma::vec ysNew = y.cols(0, stored - 1).t() * s.col(overwritePos);
+  const arma::vec yyNew = y.cols(0, stored - 1).t() * y.col(overwritePos);
+  sty.submat(0, overwritePos, stored - 1, overwritePos) = syNew;
+  sty.submat(overwritePos, 0, overwritePos, stored - 1) = ysNew.t();
+  yty.submat(0, overwritePos, stored - 1, overwritePos) = yyNew;
+  yty.submat(overwritePos, 0, overwritePos, stored - 1) = yyNew.t();
 }
 
 } // namespace optimization
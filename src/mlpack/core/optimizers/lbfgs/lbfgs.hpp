@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/function.hpp>
+#include <mlpack/core/optimizers/callbacks/callbacks.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -31,6 +32,32 @@ namespace optimization {
  *  - double Evaluate(const arma::mat& coordinates);
  *  - void Gradient(const arma::mat& coordinates, arma::mat& gradient);
  *  - arma::mat& GetInitialPoint();
+ *
+ * Each iteration is dominated by the evaluations of the function, so for
+ * decomposable functions (like LogisticRegressionFunction) it pays to wrap the
+ * function in a ParallelDecomposableFunction, which evaluates the whole
+ * objective and gradient in parallel batches:
+ *
+ * @code
+ * LogisticRegressionFunction<> lrf(data, responses, lambda);
+ * ParallelDecomposableFunction<LogisticRegressionFunction<>> f(lrf);
+ * L_BFGS lbfgs;
+ * lbfgs.Optimize(f, coordinates);
+ * @endcode
+ *
+ * The search direction is computed from the compact representation of the
+ * inverse Hessian approximation, so the stored history is only touched by
+ * matrix-vector products.
+ *
+ * The line search can also evaluate several trial step sizes at once, in
+ * parallel: if speculativeTrials is greater than 1, the current trial and the
+ * next speculativeTrials - 1 smaller step sizes that the back-tracking search
+ * would try are evaluated together.  The accepted step is the same as that of
+ * the serial search; the speculative evaluations are wasted whenever the
+ * search has to increase the step instead.  This requires that
+ * EvaluateWithGradient() can be called concurrently on different points (so
+ * it must not modify the function object, which rules out wrapping it in a
+ * ParallelDecomposableFunction at the same time).
  */
 class L_BFGS
 {
@@ -51,6 +78,8 @@ class L_BFGS
    *     (before giving up).
    * @param minStep The minimum step of the line search.
    * @param maxStep The maximum step of the line search.
+   * @param speculativeTrials The number of line search trials to evaluate at
+   *     once, in parallel (1 means the serial line search).
    */
   L_BFGS(const size_t numBasis = 10, /* same default as scipy */
          const size_t maxIterations = 10000, /* many but not infinite */
@@ -60,7 +89,8 @@ class L_BFGS
          const double factr = 1e-15,
          const size_t maxLineSearchTrials = 50,
          const double minStep = 1e-20,
-         const double maxStep = 1e20);
+         const double maxStep = 1e20,
+         const size_t speculativeTrials = 1);
 
   /**
    * Return the point where the lowest function value has been found.
@@ -78,13 +108,21 @@ class L_BFGS
    * given starting point will be modified to store the finishing point of the
    * algorithm, and the final objective value is returned.
    *
+   * Any number of callbacks (see Callback) can be given after the starting
+   * point; each iteration is reported as an epoch, and each line search as a
+   * step.
+   *
    * @tparam FunctionType Type of the function to be optimized.
+   * @tparam CallbackTypes Types of the callbacks.
    * @param function Function to optimize; must have Evaluate() and Gradient().
    * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks to call during the optimization.
    * @return Objective value of the final point.
    */
-  template<typename FunctionType>
-  double Optimize(FunctionType& function, arma::mat& iterate);
+  template<typename FunctionType, typename... CallbackTypes>
+  double Optimize(FunctionType& function,
+                  arma::mat& iterate,
+                  CallbackTypes&&... callbacks);
 
   //! Get the memory size.
   size_t NumBasis() const { return numBasis; }
@@ -131,6 +169,11 @@ class L_BFGS
   //! Modify the maximum line search step size.
   double& MaxStep() { return maxStep; }
 
+  //! Get the number of line search trials evaluated at once.
+  size_t SpeculativeTrials() const { return speculativeTrials; }
+  //! Modify the number of line search trials evaluated at once.
+  size_t& SpeculativeTrials() { return speculativeTrials; }
+
  private:
   //! Size of memory for this L-BFGS optimizer.
   size_t numBasis;
@@ -150,6 +193,8 @@ class L_BFGS
   double minStep;
   //! Maximum step of the line search.
   double maxStep;
+  //! Number of line search trials evaluated at once.
+  size_t speculativeTrials;
 
   /**
    * Calculate the scaling factor, gamma, which is used to scale the Hessian
@@ -160,8 +205,8 @@ class L_BFGS
    */
   double ChooseScalingFactor(const size_t iterationNum,
                              const arma::mat& gradient,
-                             const arma::cube& s,
-                             const arma::cube& y);
+                             const arma::mat& s,
+                             const arma::mat& y);
 
   /**
    * Perform a back-tracking line search along the search direction to
@@ -185,7 +230,24 @@ class L_BFGS
                   const arma::mat& searchDirection);
 
   /**
-   * Find the L-BFGS search direction.
+   * Evaluate the objective and the gradient at the given number of trial step
+   * sizes along the search direction, in parallel.  The first step size is
+   * the given one, and each of the next ones is scaled by the given factor.
+   */
+  template<typename FunctionType>
+  void EvaluateTrials(FunctionType& function,
+                      const arma::mat& iterate,
+                      const arma::mat& searchDirection,
+                      double stepSize,
+                      const double scale,
+                      const size_t numTrials,
+                      std::vector<double>& stepSizes,
+                      std::vector<double>& objectives,
+                      std::vector<arma::mat>& gradients);
+
+  /**
+   * Find the L-BFGS search direction, using the compact representation of
+   * the inverse Hessian approximation.
    *
    * @param gradient The gradient at the current point
    * @param iteration_num The iteration number
@@ -195,14 +257,17 @@ class L_BFGS
   void SearchDirection(const arma::mat& gradient,
                        const size_t iterationNum,
                        const double scalingFactor,
-                       const arma::cube& s,
-                       const arma::cube& y,
+                       const arma::mat& s,
+                       const arma::mat& y,
+                       const arma::mat& sty,
+                       const arma::mat& yty,
                        arma::mat& searchDirection);
 
   /**
    * Update the y and s matrices, which store the differences
    * between the iterate and old iterate and the differences between the
-   * gradient and the old gradient, respectively.
+   * gradient and the old gradient, respectively (one per column), and the
+   * inner products s_i^T y_j and y_i^T y_j between their columns.
    *
    * @param iterationNum Iteration number
    * @param iterate Current point
@@ -215,8 +280,10 @@ class L_BFGS
                       const arma::mat& oldIterate,
                       const arma::mat& gradient,
                       const arma::mat& oldGradient,
-                      arma::cube& s,
-                      arma::cube& y);
+                      arma::mat& s,
+                      arma::mat& y,
+                      arma::mat& sty,
+                      arma::mat& yty);
 };
 
 } // namespace optimization
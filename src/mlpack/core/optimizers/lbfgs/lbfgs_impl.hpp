@@ -18,6 +18,10 @@
 
 #include <mlpack/core/optimizers/function.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace optimization {
 
@@ -74,13 +78,38 @@ bool L_BFGS::LineSearch(FunctionType& function,
   double bestStepSize = 1.0;
   double bestObjective = std::numeric_limits<double>::max();
 
+  // The trials evaluated speculatively, and the next one to look at.
+  std::vector<double> trialStepSizes;
+  std::vector<double> trialObjectives;
+  std::vector<arma::mat> trialGradients;
+  size_t nextTrial = 0;
+
   while (true)
   {
     // Perform a step and evaluate the gradient and the function values at that
     // point.
-    newIterateTmp = iterate;
-    newIterateTmp += stepSize * searchDirection;
-    functionValue = function.EvaluateWithGradient(newIterateTmp, gradient);
+    if (speculativeTrials <= 1)
+    {
+      newIterateTmp = iterate;
+      newIterateTmp += stepSize * searchDirection;
+      functionValue = function.EvaluateWithGradient(newIterateTmp, gradient);
+    }
+    else
+    {
+      // Evaluate this trial together with the next smaller step sizes, which
+      // the search tries next whenever the step is too long.
+      if (nextTrial == trialStepSizes.size())
+      {
+        EvaluateTrials(function, iterate, searchDirection, stepSize, dec,
+            std::min(speculativeTrials, maxLineSearchTrials - numIterations),
+            trialStepSizes, trialObjectives, trialGradients);
+        nextTrial = 0;
+      }
+
+      functionValue = trialObjectives[nextTrial];
+      gradient.swap(trialGradients[nextTrial]);
+      ++nextTrial;
+    }
     if (functionValue < bestObjective)
     {
       bestStepSize = stepSize;
@@ -127,6 +156,10 @@ bool L_BFGS::LineSearch(FunctionType& function,
 
     // Scale the step size.
     stepSize *= width;
+
+    // The speculative trials are only of use if the step size decreased.
+    if (width != dec)
+      nextTrial = trialStepSizes.size();
   }
 
   // Move to the new iterate.
@@ -134,6 +167,40 @@ bool L_BFGS::LineSearch(FunctionType& function,
   return true;
 }
 
+/**
+ * Evaluate the objective and the gradient at several trial step sizes along
+ * the search direction, in parallel.
+ */
+template<typename FunctionType>
+void L_BFGS::EvaluateTrials(FunctionType& function,
+                            const arma::mat& iterate,
+                            const arma::mat& searchDirection,
+                            double stepSize,
+                            const double scale,
+                            const size_t numTrials,
+                            std::vector<double>& stepSizes,
+                            std::vector<double>& objectives,
+                            std::vector<arma::mat>& gradients)
+{
+  stepSizes.resize(numTrials);
+  objectives.resize(numTrials);
+  gradients.resize(numTrials);
+  for (size_t t = 0; t < numTrials; ++t)
+  {
+    stepSizes[t] = stepSize;
+    stepSize *= scale;
+  }
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) numTrials; ++t)
+  {
+    arma::mat trialIterate = iterate;
+    trialIterate += stepSizes[t] * searchDirection;
+    gradients[t].set_size(iterate.n_rows, iterate.n_cols);
+    objectives[t] = function.EvaluateWithGradient(trialIterate, gradients[t]);
+  }
+}
+
 /**
  * Use L_BFGS to optimize the given function, starting at the given iterate
  * point and performing no more than the specified number of maximum iterations.
@@ -143,8 +210,10 @@ bool L_BFGS::LineSearch(FunctionType& function,
  * @param numIterations Maximum number of iterations to perform
  * @param iterate Starting point (will be modified)
  */
-template<typename FunctionType>
-double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
+template<typename FunctionType, typename... CallbackTypes>
+double L_BFGS::Optimize(FunctionType& function,
+                        arma::mat& iterate,
+                        CallbackTypes&&... callbacks)
 {
   // Use the Function<> wrapper to ensure the function has all of the functions
   // that we need.
@@ -154,14 +223,18 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
   // Check that we have all the functions we will need.
   traits::CheckFunctionTypeAPI<FullFunctionType>();
 
-  // Ensure that the cubes holding past iterations' information are the right
+  // Ensure that the matrices holding past iterations' information are the right
   // size.  Also set the current best point value to the maximum.
   const size_t rows = iterate.n_rows;
   const size_t cols = iterate.n_cols;
 
   arma::mat newIterateTmp(rows, cols);
-  arma::cube s(rows, cols, numBasis);
-  arma::cube y(rows, cols, numBasis);
+  arma::mat s(rows * cols, numBasis);
+  arma::mat y(rows * cols, numBasis);
+
+  // The inner products between the stored pairs.
+  arma::mat sty(numBasis, numBasis);
+  arma::mat yty(numBasis, numBasis);
 
   // The old iterate to be saved.
   arma::mat oldIterate;
@@ -181,9 +254,13 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
   double functionValue = f.EvaluateWithGradient(iterate, gradient);
   double prevFunctionValue = functionValue;
 
+  Callback::BeginOptimization(*this, function, iterate, callbacks...);
+  bool terminate = Callback::Gradient(*this, function, iterate, gradient,
+      callbacks...);
+
   // The main optimization loop.
-  for (size_t itNum = 0; optimizeUntilConvergence || (itNum != maxIterations);
-       ++itNum)
+  for (size_t itNum = 0; !terminate &&
+       (optimizeUntilConvergence || (itNum != maxIterations)); ++itNum)
   {
 #ifdef DEBUG
     Log::Debug << "L-BFGS iteration " << itNum << "; objective "
@@ -221,7 +298,8 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
 
     // Build an approximation to the Hessian and choose the search
     // direction for the current iteration.
-    SearchDirection(gradient, itNum, scalingFactor, s, y, searchDirection);
+    SearchDirection(gradient, itNum, scalingFactor, s, y, sty, yty,
+        searchDirection);
 
     // Save the old iterate and the gradient before stepping.
     oldIterate = iterate;
@@ -237,6 +315,18 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
     }
     Timer::Stop("line_search");
 
+    // Let the callbacks know about the step, and stop if one of them asks to.
+    terminate = Callback::StepTaken(*this, function, iterate, callbacks...);
+    terminate |= Callback::Gradient(*this, function, iterate, gradient,
+        callbacks...);
+    terminate |= Callback::EndEpoch(*this, function, iterate, itNum + 1,
+        functionValue, callbacks...);
+    if (terminate)
+    {
+      Log::Debug << "L-BFGS terminated by a callback." << std::endl;
+      break;
+    }
+
     // It is possible that the difference between the two coordinates is zero.
     // In this case we terminate successfully.
     if (accu(iterate != oldIterate) == 0)
@@ -258,9 +348,17 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
     }
 
     // Overwrite an old basis set.
-    UpdateBasisSet(itNum, iterate, oldIterate, gradient, oldGradient, s, y);
+    UpdateBasisSet(itNum, iterate, oldIterate, gradient, oldGradient, s, y,
+        sty, yty);
   } // End of the optimization loop.
 
+  Callback::EndOptimization(*this, function, iterate, callbacks...);
+
+  // A callback may have changed the coordinates (for instance, restored the
+  // best ones), so the objective is evaluated again.
+  if (sizeof...(CallbackTypes) > 0)
+    functionValue = f.Evaluate(iterate);
+
   return functionValue;
 }
 
@@ -15,6 +15,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/random.hpp>
 #include "decay_policies/constant_step.hpp"
+#include "visitation_order.hpp"
 
 namespace mlpack {
 namespace optimization {
@@ -53,6 +54,16 @@ namespace optimization {
  * out-param for the gradient, as ParallelSGD is only expected to be relevant in
  * situations where the computed gradient is sparse.
  *
+ * At each iteration, the threads walk through disjoint shares of a random
+ * order of the functions (see VisitationOrder), which is computed on the fly
+ * rather than stored and shuffled.  By default, each nonzero component of a
+ * gradient is applied with an OpenMP atomic update (which is relaxed, not
+ * sequentially consistent).  If atomicUpdates is false, the updates are plain
+ * unsynchronized writes, as in the original HOGWILD! algorithm: concurrent
+ * updates of the same coordinate may then be lost, which the algorithm
+ * tolerates when the gradients are sparse enough, in exchange for cheaper
+ * updates.
+ *
  * @tparam DecayPolicyType Step size update policy used by parallel SGD
  *     to update the stepsize after each iteration.
  */
@@ -76,12 +87,15 @@ class ParallelSGD
    * @param shuffle If true, the function order is shuffled; otherwise, each
    *     function is visited in linear order.
    * @param decayPolicy The step size update policy to use.
+   * @param atomicUpdates If false, the iterate is updated without atomic
+   *     operations.
   */
   ParallelSGD(const size_t maxIterations,
               const size_t threadShareSize,
               const double tolerance = 1e-5,
               const bool shuffle = true,
-              const DecayPolicyType& decayPolicy = DecayPolicyType());
+              const DecayPolicyType& decayPolicy = DecayPolicyType(),
+              const bool atomicUpdates = true);
 
   /**
    * Optimize the given function using the parallel SGD algorithm. The given
@@ -119,12 +133,32 @@ class ParallelSGD
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return shuffle; }
 
+  //! Get whether or not the iterate is updated with atomic operations.
+  bool AtomicUpdates() const { return atomicUpdates; }
+  //! Modify whether or not the iterate is updated with atomic operations.
+  bool& AtomicUpdates() { return atomicUpdates; }
+
   //! Get the step size decay policy.
   DecayPolicyType& DecayPolicy() const { return decayPolicy; }
   //! Modify the step size decay policy.
   DecayPolicyType& DecayPolicy() { return decayPolicy; }
 
  private:
+  //! Subtract the given value from a coordinate of the iterate, atomically
+  //! unless atomicUpdates is false.
+  void UpdateCoordinate(double& coordinate, const double value) const
+  {
+    if (atomicUpdates)
+    {
+      #pragma omp atomic
+      coordinate -= value;
+    }
+    else
+    {
+      coordinate -= value;
+    }
+  }
+
   //! The maximum number of allowed iterations.
   size_t maxIterations;
 
@@ -140,6 +174,9 @@ class ParallelSGD
 
   //! The step size decay policy.
   DecayPolicyType decayPolicy;
+
+  //! Whether or not the iterate is updated with atomic operations.
+  bool atomicUpdates;
 };
 
 } // namespace optimization
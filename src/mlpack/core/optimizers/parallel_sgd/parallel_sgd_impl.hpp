@@ -26,12 +26,14 @@ ParallelSGD<DecayPolicyType>::ParallelSGD(
     const size_t threadShareSize,
     const double tolerance,
     const bool shuffle,
-    const DecayPolicyType& decayPolicy) :
+    const DecayPolicyType& decayPolicy,
+    const bool atomicUpdates) :
     maxIterations(maxIterations),
     threadShareSize(threadShareSize),
     tolerance(tolerance),
     shuffle(shuffle),
-    decayPolicy(decayPolicy)
+    decayPolicy(decayPolicy),
+    atomicUpdates(atomicUpdates)
 { /* Nothing to do. */ }
 
 template <typename DecayPolicyType>
@@ -47,8 +49,7 @@ double ParallelSGD<DecayPolicyType>::Optimize(
   double lastObjective;
 
   // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
+  VisitationOrder visitationOrder(function.NumFunctions());
 
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
@@ -84,11 +85,7 @@ double ParallelSGD<DecayPolicyType>::Optimize(
 
     // Shuffle for uniform sampling of functions by each thread.
     if (shuffle)
-    {
-      // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
-    }
+      visitationOrder.Shuffle();
 
     #pragma omp parallel
     {
@@ -100,7 +97,7 @@ double ParallelSGD<DecayPolicyType>::Optimize(
       #endif
 
       for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
+          j < (threadId + 1) * threadShareSize && j < visitationOrder.Size();
           ++j)
       {
         // Each instance affects only some components of the decision variable.
@@ -118,8 +115,7 @@ double ParallelSGD<DecayPolicyType>::Optimize(
           for (arma::sp_mat::iterator cur = gradient.begin_col(i);
               cur != gradient.end_col(i); ++cur)
           {
-            #pragma omp atomic
-            iterate(cur.row(), i) -= stepSize * (*cur);
+            UpdateCoordinate(iterate(cur.row(), i), stepSize * (*cur));
           }
         }
       }
@@ -36,6 +36,9 @@ class SparseTestFunction
   //! Return 4 (the number of functions).
   size_t NumFunctions() const { return 4; }
 
+  //! Shuffle the functions (there is nothing to shuffle).
+  void Shuffle() { }
+
   //! Return 4 (the number of features).
   size_t NumFeatures() const { return 4; }
 
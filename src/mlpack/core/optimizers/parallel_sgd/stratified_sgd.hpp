@@ -0,0 +1,146 @@
+/**
+ * @file stratified_sgd.hpp
+ *
+ * Stratified parallel SGD for matrix factorization problems, where each
+ * training example touches the parameters of one user and one item only.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_STRATIFIED_SGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_STRATIFIED_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "decay_policies/constant_step.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An implementation of stratified (distributed) SGD for matrix factorization,
+ * as described in the following paper:
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title={Large-Scale Matrix Factorization with Distributed Stochastic
+ *       Gradient Descent},
+ *   author={Gemulla, R. and Nijkamp, E. and Haas, P.J. and Sismanis, Y.},
+ *   booktitle={Proceedings of the 17th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining (KDD '11)},
+ *   pages={69--77},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The users and the items are each split into P strata, and so the ratings are
+ * split into P x P blocks.  Each epoch is made of P sub-epochs; in each of
+ * them, P blocks that share no user stratum and no item stratum are processed
+ * at the same time, one per thread.  Since the threads never touch the same
+ * user or item parameters, no atomic operations or locks are needed, and the
+ * result of an epoch does not depend on the scheduling of the threads.
+ *
+ * The function to be optimized must implement the following methods:
+ *
+ *   size_t NumFunctions();
+ *   const arma::mat& Dataset();
+ *   double Evaluate(const arma::mat& parameters, const size_t i);
+ *   void Update(arma::mat& parameters, const size_t i, const double stepSize);
+ *   void Synchronize(arma::mat& parameters, const double stepSize);
+ *
+ * The dataset holds one rating per column, with the user in the first row and
+ * the item in the second row.  Update() takes an SGD step on rating i; it is
+ * called concurrently for ratings of different users and items, so it may
+ * only modify the parameters (and any other state) of its own user and item.
+ * Synchronize() is called between sub-epochs by a single thread, so that
+ * updates of parameters shared by strata (such as the implicit feedback
+ * factors of SVD++) can be applied there.
+ *
+ * @tparam DecayPolicyType Step size update policy used between epochs.
+ */
+template<typename DecayPolicyType = ConstantStep>
+class StratifiedSGD
+{
+ public:
+  /**
+   * Construct the stratified SGD optimizer with the given parameters.  One
+   * iteration is one full pass over the ratings.
+   *
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate the algorithm.
+   * @param shuffle If true, the order of the sub-epochs and of the ratings in
+   *     each block is shuffled at every iteration.
+   * @param decayPolicy The step size update policy to use.
+   * @param numStrata Number of strata of users and items (0 means the number
+   *     of threads).
+   */
+  StratifiedSGD(const size_t maxIterations,
+                const double tolerance = 1e-5,
+                const bool shuffle = true,
+                const DecayPolicyType& decayPolicy = DecayPolicyType(),
+                const size_t numStrata = 0);
+
+  /**
+   * Optimize the given function.  The given starting point will be modified
+   * to store the finishing point of the algorithm, and the value of the loss
+   * function at the final point is returned.
+   *
+   * @tparam FunctionType Type of function to be optimized.
+   * @param function Function to be optimized (minimized).
+   * @param iterate Starting point (will be modified).
+   * @return Objective value at the final point.
+   */
+  template<typename FunctionType>
+  double Optimize(FunctionType& function, arma::mat& iterate);
+
+  //! Get the maximum number of iterations (0 indicates no limits).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limits).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the ratings are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the ratings are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the step size decay policy.
+  const DecayPolicyType& DecayPolicy() const { return decayPolicy; }
+  //! Modify the step size decay policy.
+  DecayPolicyType& DecayPolicy() { return decayPolicy; }
+
+  //! Get the number of strata (0 means the number of threads).
+  size_t NumStrata() const { return numStrata; }
+  //! Modify the number of strata (0 means the number of threads).
+  size_t& NumStrata() { return numStrata; }
+
+ private:
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the ratings are shuffled.
+  bool shuffle;
+
+  //! The step size decay policy.
+  DecayPolicyType decayPolicy;
+
+  //! The number of strata of users and items.
+  size_t numStrata;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "stratified_sgd_impl.hpp"
+
+#endif
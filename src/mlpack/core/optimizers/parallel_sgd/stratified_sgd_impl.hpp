@@ -0,0 +1,149 @@
+/**
+ * @file stratified_sgd_impl.hpp
+ *
+ * Implementation of stratified parallel SGD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_STRATIFIED_SGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_STRATIFIED_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "stratified_sgd.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename DecayPolicyType>
+StratifiedSGD<DecayPolicyType>::StratifiedSGD(
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const DecayPolicyType& decayPolicy,
+    const size_t numStrata) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    decayPolicy(decayPolicy),
+    numStrata(numStrata)
+{ /* Nothing to do. */ }
+
+template<typename DecayPolicyType>
+template<typename FunctionType>
+double StratifiedSGD<DecayPolicyType>::Optimize(FunctionType& function,
+                                                arma::mat& iterate)
+{
+  const arma::mat& data = function.Dataset();
+  const size_t numFunctions = function.NumFunctions();
+
+  size_t strata = numStrata;
+  if (strata == 0)
+  {
+    strata = 1;
+    #ifdef HAS_OPENMP
+      strata = omp_get_max_threads();
+    #endif
+  }
+
+  // Sort the ratings by block, with a counting sort.  The user stratum of a
+  // rating is its user modulo the number of strata, and likewise for items.
+  const size_t numBlocks = strata * strata;
+  arma::Col<size_t> blockStarts(numBlocks + 1, arma::fill::zeros);
+  arma::Col<size_t> blocks(numFunctions);
+  for (size_t i = 0; i < numFunctions; ++i)
+  {
+    blocks[i] = (((size_t) data(0, i)) % strata) * strata +
+        ((size_t) data(1, i)) % strata;
+    ++blockStarts[blocks[i] + 1];
+  }
+  for (size_t b = 0; b < numBlocks; ++b)
+    blockStarts[b + 1] += blockStarts[b];
+
+  arma::Col<size_t> order(numFunctions);
+  arma::Col<size_t> position = blockStarts.subvec(0, numBlocks - 1);
+  for (size_t i = 0; i < numFunctions; ++i)
+    order[position[blocks[i]]++] = i;
+
+  // The sub-epoch s processes the blocks (b, (b + s) % strata).
+  arma::Col<size_t> shifts = arma::linspace<arma::Col<size_t>>(0, strata - 1,
+      strata);
+
+  double overallObjective = DBL_MAX;
+  double lastObjective;
+
+  // Iterate till the objective is within tolerance or the maximum number of
+  // allowed iterations is reached. If maxIterations is 0, this will iterate
+  // till convergence.
+  for (size_t i = 1; i != maxIterations; ++i)
+  {
+    // Calculate the overall objective.
+    lastObjective = overallObjective;
+    overallObjective = 0;
+
+    #pragma omp parallel for reduction(+:overallObjective)
+    for (omp_size_t j = 0; j < (omp_size_t) numFunctions; ++j)
+      overallObjective += function.Evaluate(iterate, j);
+
+    // Output current objective function.
+    Log::Info << "Stratified SGD: iteration " << i << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Stratified SGD: converged to " << overallObjective
+          << "; terminating with failure. Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "Stratified SGD: minimized within tolerance " << tolerance
+          << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    // Get the stepsize for this iteration.
+    const double stepSize = decayPolicy.StepSize(i);
+
+    if (shuffle)
+    {
+      shifts = arma::shuffle(shifts);
+      for (size_t b = 0; b < numBlocks; ++b)
+      {
+        if (blockStarts[b + 1] > blockStarts[b] + 1)
+        {
+          order.subvec(blockStarts[b], blockStarts[b + 1] - 1) =
+              arma::shuffle(order.subvec(blockStarts[b],
+                                         blockStarts[b + 1] - 1));
+        }
+      }
+    }
+
+    for (size_t s = 0; s < strata; ++s)
+    {
+      // These blocks share no user or item, so no synchronization is needed.
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) strata; ++b)
+      {
+        const size_t block = b * strata + (b + shifts[s]) % strata;
+        for (size_t j = blockStarts[block]; j < blockStarts[block + 1]; ++j)
+          function.Update(iterate, order[j], stepSize);
+      }
+
+      function.Synchronize(iterate, stepSize);
+    }
+  }
+
+  Log::Info << "Stratified SGD terminated with objective " << overallObjective
+      << "." << std::endl;
+  return overallObjective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
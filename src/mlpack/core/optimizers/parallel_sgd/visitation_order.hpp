@@ -0,0 +1,88 @@
+/**
+ * @file visitation_order.hpp
+ *
+ * A random order of visitation of the functions for ParallelSGD, computed on
+ * the fly instead of stored.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_VISITATION_ORDER_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_VISITATION_ORDER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * A permutation of the indices [0, n), given by the affine map
+ * k -> (multiplier * k + offset) mod n with the multiplier coprime to n.  Any
+ * element of the permutation can be computed in constant time, so each thread
+ * of ParallelSGD can walk through its own share of the order without a global
+ * permutation being stored and shuffled serially at every iteration.  The
+ * permutations are not uniformly distributed, but the order of visitation
+ * changes completely with each call to Shuffle().
+ */
+class VisitationOrder
+{
+ public:
+  //! Create the identity permutation of [0, n).
+  VisitationOrder(const size_t n = 0) : n(n), multiplier(1), offset(0) { }
+
+  //! Pick a new random permutation.
+  void Shuffle()
+  {
+    if (n <= 1)
+      return;
+
+    // Keep multiplier * k + offset from overflowing.
+    const uint64_t maxMultiplier = std::max<uint64_t>(std::min<uint64_t>(
+        n - 1, (std::numeric_limits<uint64_t>::max() - n) / n), 1);
+    std::uniform_int_distribution<uint64_t> multiplierDist(1, maxMultiplier);
+    do
+    {
+      multiplier = multiplierDist(math::ThreadRandGen());
+    } while (Gcd(multiplier, n) != 1);
+
+    offset = std::uniform_int_distribution<uint64_t>(0, n - 1)(
+        math::ThreadRandGen());
+  }
+
+  //! Get the index at the given position of the order.
+  size_t operator[](const size_t k) const
+  {
+    return (size_t) ((multiplier * k + offset) % n);
+  }
+
+  //! Get the number of indices in the order.
+  size_t Size() const { return n; }
+
+ private:
+  //! Return the greatest common divisor of a and b.
+  static uint64_t Gcd(uint64_t a, uint64_t b)
+  {
+    while (b != 0)
+    {
+      const uint64_t r = a % b;
+      a = b;
+      b = r;
+    }
+    return a;
+  }
+
+  //! The number of indices.
+  uint64_t n;
+  //! The multiplier of the affine map.
+  uint64_t multiplier;
+  //! The offset of the affine map.
+  uint64_t offset;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 
 #include "sarah_update.hpp"
 #include "sarah_plus_update.hpp"
+#include <mlpack/core/optimizers/function/full_evaluate_with_gradient.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -86,6 +87,10 @@ class SARAHType
    *     function is visited in linear order.
    * @param updatePolicy Instantiated update policy used to adjust the given
    *     parameters.
+   * @param numThreads Number of threads used to compute the objective and the
+   *     full gradient of each outer iteration (0 means all of them).  With
+   *     more than one, the batch methods of the function must be safe to call
+   *     concurrently.
    */
   SARAHType(const double stepSize = 0.01,
             const size_t batchSize = 32,
@@ -93,7 +98,8 @@ class SARAHType
             const size_t innerIterations = 0,
             const double tolerance = 1e-5,
             const bool shuffle = true,
-            const UpdatePolicyType& updatePolicy = UpdatePolicyType());
+            const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+            const size_t numThreads = 1);
 
   /**
    * Optimize the given function using SARAH. The given starting point will be
@@ -143,6 +149,11 @@ class SARAHType
   //! Modify the update policy.
   UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
 
+  //! Get the number of threads used for the full gradient.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used for the full gradient.
+  size_t& NumThreads() { return numThreads; }
+
  private:
   //! The step size for each example.
   double stepSize;
@@ -165,6 +176,9 @@ class SARAHType
 
   //! The update policy used to update the parameters in each iteration.
   UpdatePolicyType updatePolicy;
+
+  //! The number of threads used for the full gradient.
+  size_t numThreads;
 };
 
 // Convenience typedefs.
@@ -23,21 +23,35 @@ namespace optimization {
  * guaranteed descent, according to the Gauss-Southwell rule. This is a
  * deterministic approach and is generally more expensive to calculate.
  *
- * For more information, refer to the following.
- * @code
- * @misc{Nutini2015,
- *   author = {Julie Nutini and Mark Schmidt and Issam H.
- *             Laradji and Michael Friedlander and Hoyt Koepke},
- *   title  = {Coordinate Descent Converges Faster with the Gauss-Southwell Rule
- *             Than Random Selection},
- *   year   = {2015},
- *   eprint = {arXiv:1506.00552}
- * }
- * @endcode
+ * The magnitudes of the partial gradients (their L1 norms) are cached in a
+ * tournament tree, so the best coordinate is found in constant time, and
+ * changing the magnitude of one coordinate costs O(log n).  At each call, the
+ * coordinates of the iterate that changed since the previous call (usually
+ * just the one that was descended on) have their partial gradients
+ * recomputed; all of them are recomputed every RefreshInterval() calls.
+ *
+ * By default all the partial gradients are recomputed every 100 calls, so a
+ * call costs about one partial gradient instead of one per coordinate.  In
+ * between, the partial gradients of the coordinates that were not descended on
+ * may be stale if the function is not separable, so the chosen coordinate may
+ * not be the best one; an interval of 1 gives the exact Gauss-Southwell choice
+ * at every call, and an interval of 0 is exact for separable functions.
  */
 class GreedyDescent
 {
  public:
+  /**
+   * Construct the greedy descent policy.
+   *
+   * @param refreshInterval Number of calls between two recomputations of all
+   *    the partial gradients (0 means never, after the first).
+   */
+  GreedyDescent(const size_t refreshInterval = 100) :
+      refreshInterval(refreshInterval),
+      calls(0),
+      leaves(0)
+  { /* Nothing to do. */ }
+
   /**
    * The DescentFeature method is used to get the descent coordinate for the
    * current iteration.
@@ -50,28 +64,128 @@ class GreedyDescent
    * @return The index of the coordinate to be descended.
    */
   template <typename ResolvableFunctionType>
-  static size_t DescentFeature(const size_t /* iteration */,
-                               const arma::mat& iterate,
-                               const ResolvableFunctionType& function)
+  size_t DescentFeature(const size_t /* iteration */,
+                        const arma::mat& iterate,
+                        const ResolvableFunctionType& function)
   {
-    size_t bestFeature = 0;
-    double bestDescent = 0;
-    for (size_t i = 0; i < function.NumFeatures(); ++i)
+    const size_t numFeatures = function.NumFeatures();
+    // The features are usually the columns of the iterate, but the only
+    // requirement is that PartialGradient() gives the gradient of each one;
+    // otherwise the changes of the iterate can't be tracked.
+    const bool columns = (iterate.n_cols == numFeatures);
+    if (!columns || magnitudes.n_elem != numFeatures ||
+        arma::size(lastIterate) != arma::size(iterate) ||
+        (refreshInterval != 0 && calls % refreshInterval == 0))
     {
+      magnitudes.set_size(numFeatures);
+      if (columns)
+        ComputeMagnitudes(iterate, function, 0);
+      else
+        ComputeMagnitudes(iterate, function, 0L);
+      BuildTree();
+    }
+    else
+    {
+      // Only recompute the coordinates that changed.
       arma::sp_mat fGrad;
-
-      function.PartialGradient(iterate, i, fGrad);
-
-      double descent = arma::accu(fGrad);
-      if (descent > bestDescent)
+      for (size_t i = 0; i < numFeatures; ++i)
       {
-        bestFeature = i;
-        bestDescent = descent;
+        if (arma::any(iterate.col(i) != lastIterate.col(i)))
+        {
+          function.PartialGradient(iterate, i, fGrad);
+          magnitudes[i] = arma::accu(arma::abs(fGrad));
+          UpdateTree(i);
+        }
       }
     }
 
-    return bestFeature;
+    lastIterate = iterate;
+    ++calls;
+    return (numFeatures == 0) ? 0 : tree[1];
+  }
+
+  //! Get the number of calls between two full recomputations.
+  size_t RefreshInterval() const { return refreshInterval; }
+  //! Modify the number of calls between two full recomputations.
+  size_t& RefreshInterval() { return refreshInterval; }
+
+ private:
+  //! Compute all the magnitudes with one call to Gradient(), when the
+  //! function has it.
+  template <typename ResolvableFunctionType>
+  auto ComputeMagnitudes(const arma::mat& iterate,
+                         const ResolvableFunctionType& function,
+                         int)
+      -> decltype(function.Gradient(iterate, std::declval<arma::mat&>()),
+                  void())
+  {
+    arma::mat gradient;
+    function.Gradient(iterate, gradient);
+    for (size_t i = 0; i < magnitudes.n_elem; ++i)
+      magnitudes[i] = arma::accu(arma::abs(gradient.col(i)));
+  }
+
+  //! Compute all the magnitudes from the partial gradients, in parallel.
+  template <typename ResolvableFunctionType>
+  void ComputeMagnitudes(const arma::mat& iterate,
+                         const ResolvableFunctionType& function,
+                         long)
+  {
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) magnitudes.n_elem; ++i)
+    {
+      arma::sp_mat fGrad;
+      function.PartialGradient(iterate, i, fGrad);
+      magnitudes[i] = arma::accu(arma::abs(fGrad));
+    }
+  }
+
+  //! Return whichever of the two coordinates has the larger magnitude.
+  size_t Better(const size_t a, const size_t b) const
+  {
+    if (b >= magnitudes.n_elem)
+      return a;
+    if (a >= magnitudes.n_elem)
+      return b;
+    // Ties go to the lower index.
+    return (magnitudes[b] > magnitudes[a]) ? b : a;
   }
+
+  //! Build the tournament tree over all the magnitudes.
+  void BuildTree()
+  {
+    leaves = 1;
+    while (leaves < magnitudes.n_elem)
+      leaves *= 2;
+
+    // Leaves past the last coordinate hold an invalid index.
+    tree.assign(2 * leaves, magnitudes.n_elem);
+    for (size_t i = 0; i < magnitudes.n_elem; ++i)
+      tree[leaves + i] = i;
+    for (size_t k = leaves - 1; k > 0; --k)
+      tree[k] = Better(tree[2 * k], tree[2 * k + 1]);
+  }
+
+  //! Propagate a change of the magnitude of the given coordinate.
+  void UpdateTree(const size_t i)
+  {
+    for (size_t k = (leaves + i) / 2; k > 0; k /= 2)
+      tree[k] = Better(tree[2 * k], tree[2 * k + 1]);
+  }
+
+  //! The number of calls between two full recomputations.
+  size_t refreshInterval;
+  //! The number of calls so far.
+  size_t calls;
+  //! The iterate at the previous call.
+  arma::mat lastIterate;
+  //! The magnitudes of the partial gradients.
+  arma::vec magnitudes;
+  //! The number of leaves of the tree (a power of two).
+  size_t leaves;
+  //! The tournament tree; node k holds the best coordinate of its subtree, and
+  //! the children of node k are 2k and 2k + 1.
+  std::vector<size_t> tree;
 };
 
 } // namespace optimization
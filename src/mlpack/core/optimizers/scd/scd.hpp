@@ -55,6 +55,31 @@ namespace optimization {
  *  variable and PartialGradient is used to evaluate the partial gradient with
  *  respect to the jth feature.
  *
+ *  With a block size larger than one, SCD updates several coordinates at each
+ *  iteration, as in the Shotgun algorithm: the coordinates are chosen by the
+ *  descent policy, their partial gradients are all computed at the same point
+ *  in parallel, and then all of the coordinates are updated.  This converges
+ *  like the serial algorithm as long as the coordinates of a block don't
+ *  interact too much (for L1-regularized problems, as long as the block size
+ *  is small compared to the number of features divided by the spectral radius
+ *  of the data correlation matrix), and PartialGradient() must then be safe to
+ *  call concurrently.  RandomDescent and CyclicDescent give distinct
+ *  coordinates; GreedyDescent always picks the same one for a block, so it
+ *  should be used with a block size of one.
+ *
+ *  @code
+ *  @inproceedings{Bradley2011,
+ *    author    = {Bradley, Joseph K. and Kyrola, Aapo and Bickson, Danny and
+ *                 Guestrin, Carlos},
+ *    title     = {Parallel Coordinate Descent for L1-Regularized Loss
+ *                 Minimization},
+ *    booktitle = {Proceedings of the 28th International Conference on
+ *                 Machine Learning},
+ *    series    = {ICML '11},
+ *    year      = {2011}
+ *  }
+ *  @endcode
+ *
  *  @tparam DescentPolicy Descent policy to decide the order in which the
  *      coordinate for descent is selected.
  */
@@ -78,12 +103,15 @@ class SCD
    *    reported and checked for convergence.
    * @param descentPolicy The policy to use for picking up the coordinate to
    *    descend on.
+   * @param blockSize The number of coordinates updated in parallel at each
+   *    iteration.
    */
   SCD(const double stepSize = 0.01,
       const size_t maxIterations = 100000,
       const double tolerance = 1e-5,
       const size_t updateInterval = 1e3,
-      const DescentPolicyType descentPolicy = DescentPolicyType());
+      const DescentPolicyType descentPolicy = DescentPolicyType(),
+      const size_t blockSize = 1);
 
   /**
    * Optimize the given function using stochastic coordinate descent. The
@@ -123,6 +151,11 @@ class SCD
   //! Modify the descent policy.
   DescentPolicyType& DescentPolicy() { return descentPolicy; }
 
+  //! Get the number of coordinates updated at each iteration.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of coordinates updated at each iteration.
+  size_t& BlockSize() { return blockSize; }
+
  private:
   //! The step size for each example.
   double stepSize;
@@ -138,6 +171,9 @@ class SCD
 
   //! The descent policy used to pick the coordinates for the update.
   DescentPolicyType descentPolicy;
+
+  //! The number of coordinates updated at each iteration.
+  size_t blockSize;
 };
 
 } // namespace optimization
@@ -26,12 +26,14 @@ SCD<DescentPolicyType>::SCD(
     const size_t maxIterations,
     const double tolerance,
     const size_t updateInterval,
-    const DescentPolicyType descentPolicy) :
+    const DescentPolicyType descentPolicy,
+    const size_t blockSize) :
     stepSize(stepSize),
     maxIterations(maxIterations),
     tolerance(tolerance),
     updateInterval(updateInterval),
-    descentPolicy(descentPolicy)
+    descentPolicy(descentPolicy),
+    blockSize(blockSize)
 { /* Nothing to do */ }
 
 //! Optimize the function (minimize).
@@ -48,17 +50,50 @@ double SCD<DescentPolicyType>::Optimize(ResolvableFunctionType& function,
 
   arma::sp_mat gradient;
 
+  // For block updates: the coordinates of the block and their gradients.
+  std::vector<size_t> features;
+  std::vector<arma::sp_mat> gradients;
+
   // Start iterating.
   for (size_t i = 1; i != maxIterations; ++i)
   {
-    // Get the coordinate to descend on.
-    size_t featureIdx = descentPolicy.DescentFeature(i, iterate, function);
+    if (blockSize <= 1)
+    {
+      // Get the coordinate to descend on.
+      size_t featureIdx = descentPolicy.DescentFeature(i, iterate, function);
 
-    // Get the partial gradient with respect to this feature.
-    function.PartialGradient(iterate, featureIdx, gradient);
+      // Get the partial gradient with respect to this feature.
+      function.PartialGradient(iterate, featureIdx, gradient);
 
-    // Update the decision variable with the partial gradient.
-    iterate.col(featureIdx) -= stepSize * gradient.col(featureIdx);
+      // Update the decision variable with the partial gradient.
+      iterate.col(featureIdx) -= stepSize * gradient.col(featureIdx);
+    }
+    else
+    {
+      // Get the distinct coordinates of the block.
+      features.resize(blockSize);
+      for (size_t b = 0; b < blockSize; ++b)
+      {
+        features[b] = descentPolicy.DescentFeature((i - 1) * blockSize + b + 1,
+            iterate, function);
+      }
+      std::sort(features.begin(), features.end());
+      features.erase(std::unique(features.begin(), features.end()),
+          features.end());
+
+      // Compute all the partial gradients at the current point.
+      gradients.resize(features.size());
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) features.size(); ++b)
+        function.PartialGradient(iterate, features[b], gradients[b]);
+
+      // Update all of the coordinates.
+      for (size_t b = 0; b < features.size(); ++b)
+      {
+        iterate.col(features[b]) -= stepSize *
+            gradients[b].col(features[b]);
+      }
+    }
 
     // Check for convergence.
     if (i % updateInterval == 0)
@@ -23,14 +23,19 @@ namespace optimization {
 /**
  * The objective function that LRSDP is trying to optimize.
  *
+ * The dense n x n matrix R * R^T is never formed; the objective and the
+ * constraints are evaluated as Tr(R^T A R), directly from the nonzeros of
+ * sparse constraint matrices, so that the memory used is proportional to the
+ * size of R and of the constraints.  The constraints are evaluated in
+ * parallel.
+ *
  * Note: LRSDPfunction is designed and implemented to specifically work
- * with a combination of AugLagrangian and L-BFGS optimizer. Implemenation
- * of LRSDPFunction includes caching R * R^T matrix in order to avoid redundant
- * computations(Specifically with above two optimizers) of R * R^T matrix
- * through AugLagrangian optimizer call, as only L-BFGS takes part in updating
- * R(coordinates) matrix. So, be careful while using LRSDP with some other
- * optimizer. You may need to modify caching process of R * R^T matrix.
- * See EvaluateImpl() in lrsdp_function_impl.hpp for more details.
+ * with a combination of AugLagrangian and L-BFGS optimizer.  The values of
+ * the constraints computed by the evaluation of the augmented Lagrangian are
+ * cached and reused by its gradient, as L-BFGS always evaluates the gradient
+ * at the point it just evaluated.  So, be careful while using LRSDP with some
+ * other optimizer.  See EvaluateImpl() in lrsdp_function_impl.hpp for more
+ * details.
  */
 template <typename SDPType>
 class LRSDPFunction
@@ -97,11 +102,19 @@ class LRSDPFunction
   //! Modify the SDP object representing the problem.
   SDPType& SDP() { return sdp; }
 
-  //! Get R*R^T matrix.
-  const arma::mat& RRT() const { return rrt; }
+  //! Get the cached values of the constraints.
+  const arma::vec& Constraints() const { return constraints; }
+
+  //! Modify the cached values of the constraints.
+  arma::vec& Constraints() { return constraints; }
 
-  //! Modify R*R^T matrix.
-  arma::mat& RRT()  { return rrt; }
+  /**
+   * Compute Tr(R^T C R) for the given objective matrix, without forming
+   * R * R^T.
+   */
+  template <typename MatrixType>
+  static double ObjectiveTrace(const MatrixType& c,
+                               const arma::mat& coordinates);
 
  private:
   //! SDP object representing the problem
@@ -110,8 +123,8 @@ class LRSDPFunction
   //! Initial point.
   arma::mat initialPoint;
 
-  //! Cache R*R^T matrix.
-  arma::mat rrt;
+  //! Cache of the values of the constraints, Tr(A_i R R^T) - b_i.
+  arma::vec constraints;
 };
 
 // Declare specializations in lrsdp_function.cpp.
@@ -16,6 +16,10 @@
 
 #include "lrsdp_function.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace optimization {
 
@@ -29,9 +33,6 @@ LRSDPFunction<SDPType>::LRSDPFunction(const SDPType& sdp,
     Log::Warn << "LRSDPFunction::LRSDPFunction(): solution matrix will have "
         << "more columns than rows.  It may be more efficient to find the "
         << "transposed solution." << std::endl;
-
-  // Initialize R*R^T matrix.
-  rrt = initialPoint * trans(initialPoint);
 }
 
 template <typename SDPType>
@@ -45,19 +46,36 @@ LRSDPFunction<SDPType>::LRSDPFunction(const size_t numSparseConstraints,
     Log::Warn << "LRSDPFunction::LRSDPFunction(): solution matrix will have "
         << "more columns than rows.  It may be more efficient to find the "
         << "transposed solution." << std::endl;
+}
 
-  // Initialize R*R^T matrix.
-  rrt = initialPoint * trans(initialPoint);
+//! Utility function for calculating Tr(R^T A R) for a sparse constraint
+//! matrix A, where rt is R^T.  Since
+//!   Tr(R^T A R) = sum_{(j, k) : A_jk != 0} A_jk <R_j, R_k>,
+//! where R_j is the j'th row of R, only the nonzeros of A are touched, and
+//! neither A nor R R^T is densified.
+inline double ConstraintTrace(const arma::sp_mat& a,
+                              const arma::mat& /* coordinates */,
+                              const arma::mat& rt)
+{
+  double result = 0.0;
+  for (arma::sp_mat::const_iterator it = a.begin(); it != a.end(); ++it)
+    result += (*it) * arma::dot(rt.col(it.row()), rt.col(it.col()));
+  return result;
+}
+
+//! Utility function for calculating Tr(R^T A R) for a dense constraint matrix
+//! A, as the sum of the elements of (A R) % R.
+inline double ConstraintTrace(const arma::mat& a,
+                              const arma::mat& coordinates,
+                              const arma::mat& /* rt */)
+{
+  return arma::accu((a * coordinates) % coordinates);
 }
 
 template <typename SDPType>
-double LRSDPFunction<SDPType>::Evaluate(const arma::mat& /* coordinates */)
-                                        const
+double LRSDPFunction<SDPType>::Evaluate(const arma::mat& coordinates) const
 {
-  // Note: We don't require to update the R*R^T matrix here as the current
-  // function is only used by AugLagrangian, which do not update the coordinates
-  // matrix.
-  return accu(SDP().C() % rrt);
+  return ObjectiveTrace(SDP().C(), coordinates);
 }
 
 template <typename SDPType>
@@ -73,18 +91,16 @@ double LRSDPFunction<SDPType>::EvaluateConstraint(
     const size_t index,
     const arma::mat& coordinates) const
 {
-  // Note: We don't require to update the R*R^T matrix here as the current
-  // function is only used by AugLagrangian, which do not update the coordinates
-  // matrix.
-
-  // Using cached R*R^T gives better optimization for sparse matrices.
   if (index < SDP().NumSparseConstraints())
-    return accu(SDP().SparseA()[index] % rrt) - SDP().SparseB()[index];
+  {
+    const arma::mat rt = trans(coordinates);
+    return ConstraintTrace(SDP().SparseA()[index], coordinates, rt) -
+        SDP().SparseB()[index];
+  }
   const size_t index1 = index - SDP().NumSparseConstraints();
 
-  // For computation optimization we will be taking R^T * A first.
-  return trace((trans(coordinates) * SDP().DenseA()[index1]) * coordinates)
-                 - SDP().DenseB()[index1];
+  return ConstraintTrace(SDP().DenseA()[index1], coordinates, coordinates) -
+      SDP().DenseB()[index1];
 }
 
 template <typename SDPType>
@@ -97,62 +113,114 @@ void LRSDPFunction<SDPType>::GradientConstraint(
       << "for arbitrary optimizers!" << std::endl;
 }
 
-//! Utility function for updating R*R^T matrix.
-//! Note: Caching R*R^T provide significant computation optimization
-//! by reducing redundant R*R^T calculations in case of functions are not used
-//! updating coordinates matrix, hence leaving R*R^T unchanged.
+//! Utility function for calculating the objective Tr(R^T C R).
 template <typename SDPType>
-void UpdateRRT(LRSDPFunction<SDPType>& function,
-               const arma::mat& newrrt)
+template <typename MatrixType>
+double LRSDPFunction<SDPType>::ObjectiveTrace(const MatrixType& c,
+                                              const arma::mat& coordinates)
 {
-  function.RRT() = newrrt;
+  // Taking C * R first is cheaper than forming R R^T, and it keeps a sparse C
+  // sparse.
+  return arma::accu((c * coordinates) % coordinates);
 }
 
 //! Utility function for calculating part of the objective when AugLagrangian is
-//! used with an LRSDPFunction.
+//! used with an LRSDPFunction.  The values of the constraints are stored into
+//! 'constraints', at the given offset, so that the gradient can reuse them.
 template <typename MatrixType>
 static inline void
 UpdateObjective(double& objective,
-                const arma::mat& rrt,
+                const arma::mat& coordinates,
+                const arma::mat& rt,
                 const std::vector<MatrixType>& ais,
                 const arma::vec& bis,
                 const arma::vec& lambda,
                 const size_t lambdaOffset,
-                const double sigma)
+                const double sigma,
+                arma::vec& constraints)
 {
+  // The constraints are independent, so they are evaluated in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) ais.size(); ++i)
+  {
+    constraints[lambdaOffset + i] = ConstraintTrace(ais[i], coordinates, rt) -
+        bis[i];
+  }
+
   for (size_t i = 0; i < ais.size(); ++i)
   {
-    // Take the trace subtracted by the b_i.
-    // Here taking R^T * A first is not recommended as we are already
-    // using pre-computed R * R^T. Taking R^T * A first will result in increase
-    // in number of computations.
-    const double constraint = accu(ais[i] % rrt) - bis[i];
+    const double constraint = constraints[lambdaOffset + i];
     objective -= (lambda[lambdaOffset + i] * constraint);
     objective += (sigma / 2.) * constraint * constraint;
   }
 }
 
 //! Utility function for calculating part of the gradient when AugLagrangian is
-//! used with an LRSDPFunction.
-template <typename MatrixType>
+//! used with an LRSDPFunction, for sparse constraints: subtract
+//! sum_i y'_i A_i R from the gradient.  Each A_i R only touches the nonzeros of
+//! A_i; the products are accumulated per thread and then reduced.
 static inline void
-UpdateGradient(arma::mat& s,
-               const arma::mat& rrt,
-               const std::vector<MatrixType>& ais,
-               const arma::vec& bis,
+UpdateGradient(arma::mat& gradient,
+               const arma::mat& coordinates,
+               const std::vector<arma::sp_mat>& ais,
+               const arma::vec& constraints,
                const arma::vec& lambda,
                const size_t lambdaOffset,
                const double sigma)
 {
+  if (ais.empty())
+    return;
+
+  #ifdef HAS_OPENMP
+    const size_t threads = std::min((size_t) omp_get_max_threads(),
+        ais.size());
+  #else
+    const size_t threads = 1;
+  #endif
+
+  std::vector<arma::mat> sums(threads);
+  #pragma omp parallel for schedule(static) num_threads(threads)
+  for (omp_size_t t = 0; t < (omp_size_t) threads; ++t)
+  {
+    sums[t].zeros(arma::size(coordinates));
+    for (size_t i = t * ais.size() / threads;
+         i < (t + 1) * ais.size() / threads; ++i)
+    {
+      const double y = lambda[lambdaOffset + i] - sigma *
+          constraints[lambdaOffset + i];
+      sums[t] += y * (ais[i] * coordinates);
+    }
+  }
+
+  for (size_t t = 0; t < threads; ++t)
+    gradient -= sums[t];
+}
+
+//! Utility function for calculating part of the gradient when AugLagrangian is
+//! used with an LRSDPFunction, for dense constraints: subtract
+//! sum_i y'_i A_i R from the gradient.  The sum of the A_i is formed first, so
+//! that only one product with R is needed.
+static inline void
+UpdateGradient(arma::mat& gradient,
+               const arma::mat& coordinates,
+               const std::vector<arma::mat>& ais,
+               const arma::vec& constraints,
+               const arma::vec& lambda,
+               const size_t lambdaOffset,
+               const double sigma)
+{
+  if (ais.empty())
+    return;
+
+  arma::mat s(arma::size(ais[0]), arma::fill::zeros);
   for (size_t i = 0; i < ais.size(); ++i)
   {
-    // Here taking R^T * A first is not recommended as we are already
-    // using pre-computed R * R^T. Taking R^T * A first will result in increase
-    // in number of computations.
-    const double constraint = accu(ais[i] % rrt) - bis[i];
-    const double y = lambda[lambdaOffset + i] - sigma * constraint;
-    s -= y * ais[i];
+    const double y = lambda[lambdaOffset + i] - sigma *
+        constraints[lambdaOffset + i];
+    s += y * ais[i];
   }
+
+  gradient -= s * coordinates;
 }
 
 template <typename SDPType>
@@ -166,44 +234,29 @@ EvaluateImpl(LRSDPFunction<SDPType>& function,
   // L(R, y, s) = Tr(C * (R R^T)) -
   //     sum_{i = 1}^{m} (y_i (Tr(A_i * (R R^T)) - b_i)) +
   //     (sigma / 2) * sum_{i = 1}^{m} (Tr(A_i * (R R^T)) - b_i)^2
-
-  // Let's start with the objective: Tr(C * (R R^T)).
-  // Simple, possibly slow solution-- see below for optimization opportunity
-  //
-  // Note that Tr(C^T * (R R^T)) = Tr( (CR)^T * R ), so
-  // multiplying C * R first, and then taking the trace dot should be more
-  // memory efficient.
   //
-  // Similarly for the constraints, taking R^T * A first should be
-  // more efficient.
-  //
-  // For computation optimization we will be taking R^T * C first.
-  // Objective function = Tr((R^T * C) * R)
-
-  // Calculate R*R^T for updating cache.
-  const arma::mat rrt = coordinates * trans(coordinates);
-
-  // Update R*R^T matrix.
-  // Note that we can only use this optimization in case of L-BFGS optimizer
-  // or any other similar optimizer which calls Evaluate() before Gradient()
-  // with same coordinates matrix and uses only Evaluate() to update
-  // coordinates matrix.
-
-  // Note: In case optimizer also uses Gradient() for updating coordinates
-  // matrix than the same line of code can be used to update R*R^T through
-  // Gradient().
-  UpdateRRT(function, rrt);
-
-  // Optimized objective function.
-  double objective = trace((trans(coordinates) * function.SDP().C())
-                         * coordinates);
-
-  // Now each constraint.
-  UpdateObjective(objective, rrt, function.SDP().SparseA(),
-      function.SDP().SparseB(), lambda, 0, sigma);
-  UpdateObjective(objective, rrt, function.SDP().DenseA(),
-      function.SDP().DenseB(), lambda, function.SDP().NumSparseConstraints(),
-      sigma);
+  // R R^T is never formed: it is n x n and dense, while R is n x r with r
+  // usually much smaller than n.  Instead, Tr(C R R^T) = Tr(R^T C R) is
+  // computed by taking C * R first, and each Tr(A_i R R^T) either from the
+  // nonzeros of A_i (if it is sparse) or by taking A_i * R first.
+
+  // The rows of R, as columns, for the sparse constraints.
+  const arma::mat rt = trans(coordinates);
+
+  double objective = LRSDPFunction<SDPType>::ObjectiveTrace(
+      function.SDP().C(), coordinates);
+
+  // Now each constraint.  The values of the constraints are cached for
+  // Gradient(); note that this is only correct with L-BFGS or any other
+  // similar optimizer which calls Evaluate() before Gradient() with the same
+  // coordinates.
+  arma::vec& constraints = function.Constraints();
+  constraints.set_size(function.SDP().NumConstraints());
+  UpdateObjective(objective, coordinates, rt, function.SDP().SparseA(),
+      function.SDP().SparseB(), lambda, 0, sigma, constraints);
+  UpdateObjective(objective, coordinates, coordinates,
+      function.SDP().DenseA(), function.SDP().DenseB(), lambda,
+      function.SDP().NumSparseConstraints(), sigma, constraints);
 
   return objective;
 }
@@ -221,19 +274,20 @@ GradientImpl(const LRSDPFunction<SDPType>& function,
   //   with
   // S' = C - sum_{i = 1}^{m} y'_i A_i
   // y'_i = y_i - sigma * (Trace(A_i * (R R^T)) - b_i)
+  //
+  // S' is not formed either: each term is multiplied by R first, so sparse
+  // matrices stay sparse.
 
-  // Directly reterive R*R^T from cache.
-  const arma::mat rrt = function.RRT();
-  arma::mat s(function.SDP().C());
+  // Directly retrieve the values of the constraints from the cache.
+  const arma::vec& constraints = function.Constraints();
 
-  UpdateGradient(
-      s, rrt, function.SDP().SparseA(), function.SDP().SparseB(),
+  gradient = function.SDP().C() * coordinates;
+  UpdateGradient(gradient, coordinates, function.SDP().SparseA(), constraints,
       lambda, 0, sigma);
-  UpdateGradient(
-      s, rrt, function.SDP().DenseA(), function.SDP().DenseB(),
+  UpdateGradient(gradient, coordinates, function.SDP().DenseA(), constraints,
       lambda, function.SDP().NumSparseConstraints(), sigma);
 
-  gradient = 2 * s * coordinates;
+  gradient *= 2;
 }
 
 // Template specializations for function and gradient evaluation.
@@ -148,6 +148,24 @@ SolveLyapunov(arma::mat& X, const arma::mat& A, const arma::mat& H)
   arma::syl(X, A, A, -H);
 }
 
+/**
+ * Compute F v, where F = X sym I is the operator built by math::SymKronId():
+ *
+ *   F v = svec(0.5 * (X V + V X)),  V = smat(v).
+ *
+ * F is n2bar x n2bar with n2bar = n (n + 1) / 2, so it is never formed; this
+ * takes O(n^3) time and O(n^2) memory instead of O(n^4) memory.
+ */
+static inline void
+SymKronIdProduct(const arma::mat& X, const arma::vec& v, arma::vec& result)
+{
+  arma::mat V;
+  math::Smat(v, V);
+  // V and X are symmetric, so V X = (X V)^T.
+  const arma::mat XV = X * V;
+  math::Svec(arma::mat(0.5 * (XV + XV.t())), result);
+}
+
 /**
  * Solve the following KKT system (2.10) of [AHO98]:
  *
@@ -164,13 +182,14 @@ SolveLyapunov(arma::mat& X, const arma::mat& A, const arma::mat& H)
  *     E  = Z sym I
  *     F  = X sym I
  *
+ * F is applied with SymKronIdProduct(), given X.
  */
 static inline void
 SolveKKTSystem(const arma::sp_mat& Asparse,
                const arma::mat& Adense,
                const arma::mat& Z,
                const arma::mat& M,
-               const arma::mat& F,
+               const arma::mat& X,
                const arma::vec& rp,
                const arma::vec& rd,
                const arma::vec& rc,
@@ -181,13 +200,14 @@ SolveKKTSystem(const arma::sp_mat& Asparse,
 {
   arma::mat Frd_rc_Mat, Einv_Frd_rc_Mat,
             Einv_Frd_ATdy_rc_Mat, Frd_ATdy_rc_Mat;
-  arma::vec Einv_Frd_rc, Einv_Frd_ATdy_rc, dy;
+  arma::vec Frd, Frd_ATdy, Einv_Frd_rc, Einv_Frd_ATdy_rc, dy;
 
   // Note: Whenever a formula calls for E^(-1) v for some v, we solve Lyapunov
   // equations instead of forming an explicit inverse.
 
   // Compute the RHS of (2.12)
-  math::Smat(F * rd - rc, Frd_rc_Mat);
+  SymKronIdProduct(X, rd, Frd);
+  math::Smat(Frd - rc, Frd_rc_Mat);
   SolveLyapunov(Einv_Frd_rc_Mat, Z, 2. * Frd_rc_Mat);
   math::Svec(Einv_Frd_rc_Mat, Einv_Frd_rc);
 
@@ -209,8 +229,9 @@ SolveKKTSystem(const arma::sp_mat& Asparse,
     dydense = dy(arma::span(Asparse.n_rows, numConstraints - 1));
 
   // Compute dx from (2.13)
-  math::Smat(F * (rd - Asparse.t() * dysparse - Adense.t() * dydense) - rc,
-      Frd_ATdy_rc_Mat);
+  SymKronIdProduct(X, rd - Asparse.t() * dysparse - Adense.t() * dydense,
+      Frd_ATdy);
+  math::Smat(Frd_ATdy - rc, Frd_ATdy_rc_Mat);
   SolveLyapunov(Einv_Frd_ATdy_rc_Mat, Z, 2. * Frd_ATdy_rc_Mat);
   math::Svec(Einv_Frd_ATdy_rc_Mat, Einv_Frd_ATdy_rc);
   dsx = -Einv_Frd_ATdy_rc;
@@ -277,16 +298,15 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
   math::Svec(X, sx);
   math::Svec(Z, sz);
 
-  arma::vec rp, rd, rc, gk;
+  arma::vec rp, rd, rc;
 
-  arma::mat Rc, F, Einv_F_AsparseT, Einv_F_AdenseT, Gk,
-            M, DualCheck;
+  arma::mat Rc, M, DualCheck;
 
   rp.set_size(sdp.NumConstraints());
 
-  Einv_F_AsparseT.set_size(n2bar, sdp.NumSparseConstraints());
-  Einv_F_AdenseT.set_size(n2bar, sdp.NumDenseConstraints());
   M.set_size(sdp.NumConstraints(), sdp.NumConstraints());
+  const size_t numSparse = sdp.NumSparseConstraints();
+  const size_t numConstraints = sdp.NumConstraints();
 
   double primalObj = 0., alpha, beta;
   for (size_t iteration = 1; iteration != maxIterations; iteration++)
@@ -308,56 +328,34 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     // Rd = C - Z - smat A^T y
     rd = sc - sz - Asparse.t() * ysparse - Adense.t() * ydense;
 
-    math::SymKronId(X, F);
-
-    // We compute E^(-1) F A^T by solving Lyapunov equations.
-    // See (2.16).
-    for (size_t i = 0; i < sdp.NumSparseConstraints(); i++)
-    {
-      SolveLyapunov(Gk, Z, X * sdp.SparseA()[i] + sdp.SparseA()[i] * X);
-      math::Svec(Gk, gk);
-      Einv_F_AsparseT.col(i) = gk;
-    }
-
-    for (size_t i = 0; i < sdp.NumDenseConstraints(); i++)
-    {
-      SolveLyapunov(Gk, Z, X * sdp.DenseA()[i] + sdp.DenseA()[i] * X);
-      math::Svec(Gk, gk);
-      Einv_F_AdenseT.col(i) = gk;
-    }
-
-    // Form the M = A E^(-1) F A^T matrix (2.15)
+    // Form the M = A E^(-1) F A^T matrix (2.15), one column at a time.
     //
-    // Since we split A up into its sparse and dense components,
-    // we have to handle each block separately.
-    if (sdp.NumSparseConstraints())
+    // Column j is A svec(G_j), where G_j = E^(-1) F A_j solves a Lyapunov
+    // equation (2.16).  Only one G_j per thread is held at once, instead of
+    // the n2bar x m matrix E^(-1) F A^T, and the rows of the sparse
+    // constraints only touch the nonzeros of their A_i.  The columns are
+    // independent, so they are computed in parallel.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) numConstraints; ++j)
     {
-      M.submat(arma::span(0, sdp.NumSparseConstraints() - 1),
-               arma::span(0, sdp.NumSparseConstraints() - 1)) =
-          Asparse * Einv_F_AsparseT;
-      if (sdp.NumDenseConstraints())
+      arma::mat Gj;
+      arma::vec gj;
+      if ((size_t) j < numSparse)
       {
-        M.submat(arma::span(0, sdp.NumSparseConstraints() - 1),
-                 arma::span(sdp.NumSparseConstraints(),
-                            sdp.NumConstraints() - 1)) =
-            Asparse * Einv_F_AdenseT;
+        const arma::sp_mat& Aj = sdp.SparseA()[j];
+        SolveLyapunov(Gj, Z, X * Aj + Aj * X);
       }
-    }
-    if (sdp.NumDenseConstraints())
-    {
-      if (sdp.NumSparseConstraints())
+      else
       {
-        M.submat(arma::span(sdp.NumSparseConstraints(),
-                            sdp.NumConstraints() - 1),
-                 arma::span(0,
-                            sdp.NumSparseConstraints() - 1)) =
-            Adense * Einv_F_AsparseT;
+        const arma::mat& Aj = sdp.DenseA()[j - numSparse];
+        SolveLyapunov(Gj, Z, X * Aj + Aj * X);
       }
-      M.submat(arma::span(sdp.NumSparseConstraints(),
-                          sdp.NumConstraints() - 1),
-               arma::span(sdp.NumSparseConstraints(),
-                          sdp.NumConstraints() - 1)) =
-          Adense * Einv_F_AdenseT;
+      math::Svec(Gj, gj);
+
+      if (numSparse)
+        M.submat(0, j, numSparse - 1, j) = Asparse * gj;
+      if (numSparse < numConstraints)
+        M.submat(numSparse, j, numConstraints - 1, j) = Adense * gj;
     }
 
     const double sxdotsz = arma::dot(sx, sz);
@@ -369,7 +367,7 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     // This solves step (1) of Section 7, the "predictor" step.
     Rc = -0.5*(X*Z + Z*X);
     math::Svec(Rc, rc);
-    SolveKKTSystem(Asparse, Adense, Z, M, F, rp, rd, rc, dsx, dysparse, dydense,
+    SolveKKTSystem(Asparse, Adense, Z, M, X, rp, rd, rc, dsx, dysparse, dydense,
         dsz);
     math::Smat(dsx, dX);
     math::Smat(dsz, dZ);
@@ -399,7 +397,7 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     // Step (3), the "corrector" step.
     Rc = mu*arma::eye<arma::mat>(n, n) - 0.5*(X*Z + Z*X + dX*dZ + dZ*dX);
     math::Svec(Rc, rc);
-    SolveKKTSystem(Asparse, Adense, Z, M, F, rp, rd, rc, dsx, dysparse, dydense,
+    SolveKKTSystem(Asparse, Adense, Z, M, X, rp, rd, rc, dsx, dysparse, dydense,
         dsz);
     math::Smat(dsx, dX);
     math::Smat(dsz, dZ);
@@ -20,6 +20,7 @@
 #include "update_policies/momentum_update.hpp"
 #include "update_policies/nesterov_momentum_update.hpp"
 #include "decay_policies/no_decay.hpp"
+#include <mlpack/core/optimizers/callbacks/callbacks.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -121,14 +122,21 @@ class SGD
    * starting point will be modified to store the finishing point of the
    * algorithm, and the final objective value is returned.
    *
+   * Any number of callbacks (see Callback) can be given after the starting
+   * point; they are told about the end of each epoch (pass over the data),
+   * each gradient and each step, and can terminate the optimization.
+   *
    * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam CallbackTypes Types of the callbacks.
    * @param function Function to optimize.
    * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks to call during the optimization.
    * @return Objective value of the final point.
    */
-  template<typename DecomposableFunctionType>
+  template<typename DecomposableFunctionType, typename... CallbackTypes>
   double Optimize(DecomposableFunctionType& function,
-                  arma::mat& iterate);
+                  arma::mat& iterate,
+                  CallbackTypes&&... callbacks);
 
   //! Get the step size.
   double StepSize() const { return stepSize; }
@@ -44,10 +44,11 @@ SGD<UpdatePolicyType, DecayPolicyType>::SGD(
 
 //! Optimize the function (minimize).
 template<typename UpdatePolicyType, typename DecayPolicyType>
-template<typename DecomposableFunctionType>
+template<typename DecomposableFunctionType, typename... CallbackTypes>
 double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
     DecomposableFunctionType& function,
-    arma::mat& iterate)
+    arma::mat& iterate,
+    CallbackTypes&&... callbacks)
 {
   typedef Function<DecomposableFunctionType> FullFunctionType;
   FullFunctionType& f(static_cast<FullFunctionType&>(function));
@@ -62,16 +63,21 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
   size_t currentFunction = 0;
   double overallObjective = 0;
   double lastObjective = DBL_MAX;
+  size_t epoch = 0;
+  bool terminate = false;
 
   // Initialize the update policy.
   if (resetPolicy)
     updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
 
+  Callback::BeginOptimization(*this, function, iterate, callbacks...);
+
   // Now iterate!
   arma::mat gradient(iterate.n_rows, iterate.n_cols);
   const size_t actualMaxIterations = (maxIterations == 0) ?
       std::numeric_limits<size_t>::max() : maxIterations;
-  for (size_t i = 0; i < actualMaxIterations; /* incrementing done manually */)
+  for (size_t i = 0; i < actualMaxIterations && !terminate;
+      /* incrementing done manually */)
   {
     // Is this iteration the start of a sequence?
     if ((currentFunction % numFunctions) == 0 && i > 0)
@@ -80,10 +86,18 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
       Log::Info << "SGD: iteration " << i << ", objective " << overallObjective
           << "." << std::endl;
 
+      if (Callback::EndEpoch(*this, function, iterate, ++epoch,
+          overallObjective, callbacks...))
+      {
+        terminate = true;
+        break;
+      }
+
       if (std::isnan(overallObjective) || std::isinf(overallObjective))
       {
         Log::Warn << "SGD: converged to " << overallObjective << "; terminating"
             << " with failure.  Try a smaller step size?" << std::endl;
+        Callback::EndOptimization(*this, function, iterate, callbacks...);
         return overallObjective;
       }
 
@@ -91,6 +105,7 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
       {
         Log::Info << "SGD: minimized within tolerance " << tolerance << "; "
             << "terminating optimization." << std::endl;
+        Callback::EndOptimization(*this, function, iterate, callbacks...);
         return overallObjective;
       }
 
@@ -117,6 +132,11 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
     // for many FunctionTypes it may be much quicker to do it like this.
     overallObjective += f.EvaluateWithGradient(iterate, currentFunction,
         gradient, effectiveBatchSize);
+    if (Callback::Gradient(*this, function, iterate, gradient, callbacks...))
+    {
+      terminate = true;
+      break;
+    }
 
     // Use the update policy to take a step.
     updatePolicy.Update(iterate, stepSize, gradient);
@@ -126,10 +146,21 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
 
     i += effectiveBatchSize;
     currentFunction += effectiveBatchSize;
+
+    terminate = Callback::StepTaken(*this, function, iterate, callbacks...);
+  }
+
+  if (terminate)
+  {
+    Log::Info << "SGD: terminated by a callback." << std::endl;
+  }
+  else
+  {
+    Log::Info << "SGD: maximum iterations (" << maxIterations << ") reached; "
+        << "terminating optimization." << std::endl;
   }
 
-  Log::Info << "SGD: maximum iterations (" << maxIterations << ") reached; "
-      << "terminating optimization." << std::endl;
+  Callback::EndOptimization(*this, function, iterate, callbacks...);
 
   // Calculate final objective.
   overallObjective = 0;
@@ -0,0 +1,185 @@
+/**
+ * @file lazy_momentum_update.hpp
+ *
+ * Momentum update with L2 weight decay for sparse gradients, applied lazily to
+ * the coordinates that each gradient doesn't touch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SGD_LAZY_MOMENTUM_UPDATE_HPP
+#define MLPACK_CORE_OPTIMIZERS_SGD_LAZY_MOMENTUM_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Momentum update policy with L2 weight decay for sparse gradients, for use
+ * with SparseSGD.  Every step performs the same update as MomentumUpdate with
+ * the gradient \f$ \nabla f_i(A) + \lambda A \f$:
+ *
+ * \f[
+ * v = mu*v - \alpha (\nabla f_i(A) + \lambda A)
+ * A_{j + 1} = A_j + v
+ * \f]
+ *
+ * but only the coordinates where the gradient is nonzero are updated.  The
+ * step at which each coordinate was last updated is stored, and the steps it
+ * missed are applied at once the next time it is touched (or when Finalize()
+ * is called).  Between two touches the coordinate and its velocity evolve
+ * linearly, so the missed steps are applied exactly, in time logarithmic in
+ * their number, and the results are the same as those of the dense update as
+ * long as the step size is held constant.  The cost of each step is therefore
+ * proportional to the number of nonzeros in the gradient instead of the size
+ * of the parameters.
+ *
+ * With a momentum of 0 this is plain SGD with lazily-applied L2 weight decay.
+ * Since the weight decay is handled here, the gradient of the function should
+ * not include the regularization term.
+ */
+class LazyMomentumUpdate
+{
+ public:
+  /**
+   * Construct the lazy momentum update policy.
+   *
+   * @param momentum The momentum decay hyperparameter.
+   * @param lambda The L2 weight decay.
+   */
+  LazyMomentumUpdate(const double momentum = 0.5, const double lambda = 0.0) :
+      momentum(momentum),
+      lambda(lambda),
+      iteration(0)
+  { /* Do nothing. */ }
+
+  /**
+   * The Initialize method is called by the SparseSGD optimizer before the
+   * start of the iteration update process.  The velocity is set to zero and
+   * all the coordinates are marked as up to date.
+   *
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    velocity = arma::zeros<arma::mat>(rows, cols);
+    lastUpdate = arma::zeros<arma::umat>(rows, cols);
+    iteration = 0;
+  }
+
+  /**
+   * Update step for SparseSGD.  Only the coordinates where the gradient is
+   * nonzero are brought up to date and updated.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::sp_mat& gradient)
+  {
+    ++iteration;
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+        it != gradient.end(); ++it)
+    {
+      const size_t i = it.row() + it.col() * iterate.n_rows;
+      CatchUp(iterate, stepSize, i, iteration - 1 - lastUpdate[i]);
+
+      velocity[i] = momentum * velocity[i] - stepSize * ((*it) + lambda *
+          iterate[i]);
+      iterate[i] += velocity[i];
+      lastUpdate[i] = iteration;
+    }
+  }
+
+  /**
+   * Bring all the coordinates up to date, so that the iterate is the same as
+   * if every step had been applied densely.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size used for the missed steps.
+   */
+  void Finalize(arma::mat& iterate, const double stepSize)
+  {
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+    {
+      CatchUp(iterate, stepSize, i, iteration - lastUpdate[i]);
+      lastUpdate[i] = iteration;
+    }
+  }
+
+  //! Get the momentum.
+  double Momentum() const { return momentum; }
+  //! Modify the momentum.
+  double& Momentum() { return momentum; }
+
+  //! Get the L2 weight decay.
+  double Lambda() const { return lambda; }
+  //! Modify the L2 weight decay.
+  double& Lambda() { return lambda; }
+
+ private:
+  /**
+   * Apply the given number of steps with a zero gradient to a coordinate.
+   * Each of them maps (A, v) to ((1 - alpha lambda) A + mu v,
+   * -alpha lambda A + mu v), so they are applied by raising that 2x2 matrix to
+   * the number of steps.
+   */
+  void CatchUp(arma::mat& iterate,
+               const double stepSize,
+               const size_t i,
+               size_t steps)
+  {
+    if (steps == 0)
+      return;
+
+    double m[4] = { 1.0 - stepSize * lambda, momentum,
+                    -stepSize * lambda, momentum };
+    double r[4] = { 1.0, 0.0, 0.0, 1.0 };
+    while (steps > 0)
+    {
+      if (steps & 1)
+        Multiply(r, m);
+      Multiply(m, m);
+      steps >>= 1;
+    }
+
+    const double x = iterate[i];
+    iterate[i] = r[0] * x + r[1] * velocity[i];
+    velocity[i] = r[2] * x + r[3] * velocity[i];
+  }
+
+  //! Set a to a * b, for 2x2 matrices stored by rows.
+  static void Multiply(double* a, const double* b)
+  {
+    const double a0 = a[0] * b[0] + a[1] * b[2];
+    const double a1 = a[0] * b[1] + a[1] * b[3];
+    const double a2 = a[2] * b[0] + a[3] * b[2];
+    const double a3 = a[2] * b[1] + a[3] * b[3];
+    a[0] = a0;
+    a[1] = a1;
+    a[2] = a2;
+    a[3] = a3;
+  }
+
+  //! The momentum hyperparameter.
+  double momentum;
+  //! The L2 weight decay.
+  double lambda;
+  //! The velocity matrix.
+  arma::mat velocity;
+  //! The step at which each coordinate was last brought up to date.
+  arma::umat lastUpdate;
+  //! The number of steps taken so far.
+  size_t iteration;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file sparse_sgd.hpp
+ *
+ * Stochastic Gradient Descent for functions with sparse gradients, with update
+ * policies that only touch the nonzero coordinates of each gradient.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SPARSE_SGD_SPARSE_SGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_SPARSE_SGD_SPARSE_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/sgd/update_policies/lazy_momentum_update.hpp>
+#include <mlpack/core/optimizers/adam/lazy_adam_update.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * SparseSGD is mini-batch stochastic gradient descent (see SGD) for functions
+ * whose gradient on a batch is sparse, such as linear models on sparse,
+ * high-dimensional data.  The gradients are computed as arma::sp_mat, and the
+ * update policy only visits their nonzero coordinates, so the cost of a step
+ * is proportional to the number of nonzeros in the gradient instead of the
+ * number of parameters.  Momentum, moment decay and weight decay for the
+ * coordinates that a gradient doesn't touch are applied lazily, the next time
+ * they are touched; the iterate is brought completely up to date at the end of
+ * each pass over the data, before the objective is checked.
+ *
+ * For SparseSGD to work, a SparseFunctionType template parameter is required.
+ * This class must implement the following functions:
+ *
+ *   size_t NumFunctions();
+ *   void Shuffle();
+ *   double Evaluate(const arma::mat& coordinates,
+ *                   const size_t i,
+ *                   const size_t batchSize);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::sp_mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * The gradient should not include any L2 regularization term, since that is
+ * applied (lazily) by the update policy.
+ *
+ * The update policy must implement the following functions:
+ *
+ *   void Initialize(const size_t rows, const size_t cols);
+ *   void Update(arma::mat& iterate,
+ *               const double stepSize,
+ *               const arma::sp_mat& gradient);
+ *   void Finalize(arma::mat& iterate, const double stepSize);
+ *
+ * where Finalize() applies all the pending lazy updates.  LazyMomentumUpdate
+ * (momentum and L2 weight decay, which reduces to plain SGD with weight decay
+ * when the momentum is 0) and LazyAdamUpdate are available.
+ *
+ * @tparam UpdatePolicyType Sparse update policy used by SparseSGD during the
+ *     iterative update process.
+ */
+template<typename UpdatePolicyType = LazyMomentumUpdate>
+class SparseSGD
+{
+ public:
+  /**
+   * Construct the SparseSGD optimizer with the given parameters.  The maximum
+   * number of iterations refers to the maximum number of points that are
+   * processed (i.e., one iteration equals one point; one iteration does not
+   * equal one pass over the dataset).
+   *
+   * @param stepSize Step size for each iteration.
+   * @param batchSize Batch size to use for each step.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled; otherwise, each
+   *     function is visited in linear order.
+   * @param updatePolicy Instantiated update policy used to adjust the given
+   *     parameters.
+   * @param resetPolicy Flag that determines whether update policy parameters
+   *     are reset before every Optimize call.
+   */
+  SparseSGD(const double stepSize = 0.01,
+            const size_t batchSize = 32,
+            const size_t maxIterations = 100000,
+            const double tolerance = 1e-5,
+            const bool shuffle = true,
+            const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+            const bool resetPolicy = true);
+
+  /**
+   * Optimize the given function.  The given starting point will be modified
+   * to store the finishing point of the algorithm, and the final objective
+   * value is returned.
+   *
+   * @tparam SparseFunctionType Type of the function to be optimized.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  template<typename SparseFunctionType>
+  double Optimize(SparseFunctionType& function, arma::mat& iterate);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get whether or not the update policy parameters are reset before
+  //! Optimize call.
+  bool ResetPolicy() const { return resetPolicy; }
+  //! Modify whether or not the update policy parameters are reset before
+  //! Optimize call.
+  bool& ResetPolicy() { return resetPolicy; }
+
+  //! Get the update policy.
+  const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
+  //! Modify the update policy.
+  UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
+
+ private:
+  //! The step size for each example.
+  double stepSize;
+
+  //! The batch size for processing.
+  size_t batchSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+
+  //! The update policy used to update the parameters in each iteration.
+  UpdatePolicyType updatePolicy;
+
+  //! Flag indicating whether update policy should be reset before running
+  //! optimization.
+  bool resetPolicy;
+};
+
+//! Adam for sparse gradients, with lazily-applied moment decay.
+using LazyAdam = SparseSGD<LazyAdamUpdate>;
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_sgd_impl.hpp"
+
+#endif
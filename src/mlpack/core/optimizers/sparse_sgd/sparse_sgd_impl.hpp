@@ -0,0 +1,133 @@
+/**
+ * @file sparse_sgd_impl.hpp
+ *
+ * Implementation of stochastic gradient descent for sparse gradients.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SPARSE_SGD_SPARSE_SGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_SPARSE_SGD_SPARSE_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_sgd.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename UpdatePolicyType>
+SparseSGD<UpdatePolicyType>::SparseSGD(
+    const double stepSize,
+    const size_t batchSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const UpdatePolicyType& updatePolicy,
+    const bool resetPolicy) :
+    stepSize(stepSize),
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    updatePolicy(updatePolicy),
+    resetPolicy(resetPolicy)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename UpdatePolicyType>
+template<typename SparseFunctionType>
+double SparseSGD<UpdatePolicyType>::Optimize(SparseFunctionType& function,
+                                             arma::mat& iterate)
+{
+  // Find the number of functions to use.
+  const size_t numFunctions = function.NumFunctions();
+
+  // To keep track of where we are and how things are going.
+  size_t currentFunction = 0;
+  double overallObjective = 0;
+  double lastObjective = DBL_MAX;
+
+  // Initialize the update policy.
+  if (resetPolicy)
+    updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
+
+  // Now iterate!
+  arma::sp_mat gradient;
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  for (size_t i = 0; i < actualMaxIterations; /* incrementing done manually */)
+  {
+    // Is this iteration the start of a sequence?
+    if ((currentFunction % numFunctions) == 0 && i > 0)
+    {
+      // Apply the pending updates before looking at the objective.
+      updatePolicy.Finalize(iterate, stepSize);
+      overallObjective = 0;
+      for (size_t f = 0; f < numFunctions; f += batchSize)
+      {
+        const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
+        overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
+      }
+
+      // Output current objective function.
+      Log::Info << "Sparse SGD: iteration " << i << ", objective "
+          << overallObjective << "." << std::endl;
+
+      if (std::isnan(overallObjective) || std::isinf(overallObjective))
+      {
+        Log::Warn << "Sparse SGD: converged to " << overallObjective << "; "
+            << "terminating with failure.  Try a smaller step size?"
+            << std::endl;
+        return overallObjective;
+      }
+
+      if (std::abs(lastObjective - overallObjective) < tolerance)
+      {
+        Log::Info << "Sparse SGD: minimized within tolerance " << tolerance
+            << "; terminating optimization." << std::endl;
+        return overallObjective;
+      }
+
+      // Reset the counter variables.
+      lastObjective = overallObjective;
+      currentFunction = 0;
+
+      if (shuffle) // Determine order of visitation.
+        function.Shuffle();
+    }
+
+    // The batch can't be larger than the user-specified batch size, the
+    // number of iterations left or the number of functions left.
+    const size_t effectiveBatchSize = std::min(
+        std::min(batchSize, actualMaxIterations - i),
+        numFunctions - currentFunction);
+
+    function.Gradient(iterate, currentFunction, gradient, effectiveBatchSize);
+
+    // Use the update policy to take a step on the nonzero coordinates.
+    updatePolicy.Update(iterate, stepSize, gradient);
+
+    i += effectiveBatchSize;
+    currentFunction += effectiveBatchSize;
+  }
+
+  Log::Info << "Sparse SGD: maximum iterations (" << maxIterations << ") "
+      << "reached; terminating optimization." << std::endl;
+
+  // Calculate final objective.
+  updatePolicy.Finalize(iterate, stepSize);
+  overallObjective = 0;
+  for (size_t i = 0; i < numFunctions; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
+    overallObjective += function.Evaluate(iterate, i, effectiveBatchSize);
+  }
+  return overallObjective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
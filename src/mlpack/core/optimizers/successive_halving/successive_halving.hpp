@@ -0,0 +1,112 @@
+/**
+ * @file successive_halving.hpp
+ *
+ * Successive-halving optimization of hyper-parameters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SUCCESSIVE_HALVING_SUCCESSIVE_HALVING_HPP
+#define MLPACK_CORE_OPTIMIZERS_SUCCESSIVE_HALVING_SUCCESSIVE_HALVING_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An optimizer that finds the minimum of a given function over the points of
+ * a multidimensional grid (like GridSearch), by successive halving: all the
+ * points are first evaluated with a small budget, and only the best fraction
+ * of them goes on to the next rung, which has a larger budget, until the last
+ * rung evaluates the remaining points with the full budget.  The budget is the
+ * fraction of each training set that the function trains on; the subsets
+ * trained on are drawn at random once per search, so that every point of a rung
+ * sees the same data and each rung's data contains the previous rung's.  The
+ * points of each rung are evaluated in parallel.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{jamieson2016non,
+ *   title = {Non-stochastic Best Arm Identification and Hyperparameter
+ *       Optimization},
+ *   author = {Jamieson, Kevin and Talwalkar, Ameet},
+ *   booktitle = {Proceedings of the 19th International Conference on
+ *       Artificial Intelligence and Statistics (AISTATS)},
+ *   pages = {240--248},
+ *   year = {2016}
+ * }
+ * @endcode
+ *
+ * For SuccessiveHalving to work, a FunctionType template parameter is
+ * required. This class must implement the following functions (CVFunction
+ * does, if its cross-validation class provides TrainingFraction() and
+ * SubsetSeed()):
+ *
+ *   double Evaluate(const arma::mat& coordinates);
+ *   double EvaluateWithoutModel(const arma::mat& coordinates);
+ *   double& TrainingFraction();
+ *   size_t& SubsetSeed();
+ *
+ * EvaluateWithoutModel() must be safe to call for several points at once.
+ */
+class SuccessiveHalving
+{
+ public:
+  /**
+   * Create the SuccessiveHalving optimizer with the given parameters.
+   *
+   * @param minFraction Fraction of the full budget that the first rung uses.
+   * @param eta Each rung keeps the best 1 / eta of the points, and uses eta
+   *     times the budget of the previous rung.
+   */
+  SuccessiveHalving(const double minFraction = 1.0 / 9.0,
+                    const size_t eta = 3) :
+      minFraction(minFraction),
+      eta(eta)
+  { }
+
+  /**
+   * Optimize (minimize) the given function by successive halving over all
+   * possible combinations of values for the parameters specified in
+   * datasetInfo.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Variable for storing results.
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @return Objective value of the final point, with the full budget.
+   */
+  template<typename FunctionType>
+  double Optimize(
+      FunctionType& function,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo);
+
+  //! Get the fraction of the full budget that the first rung uses.
+  double MinFraction() const { return minFraction; }
+  //! Modify the fraction of the full budget that the first rung uses.
+  double& MinFraction() { return minFraction; }
+
+  //! Get the reduction factor between rungs.
+  size_t Eta() const { return eta; }
+  //! Modify the reduction factor between rungs.
+  size_t& Eta() { return eta; }
+
+ private:
+  //! The fraction of the full budget that the first rung uses.
+  double minFraction;
+  //! The reduction factor between rungs.
+  size_t eta;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation
+#include "successive_halving_impl.hpp"
+
+#endif
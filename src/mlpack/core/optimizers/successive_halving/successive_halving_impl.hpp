@@ -0,0 +1,126 @@
+/**
+ * @file successive_halving_impl.hpp
+ *
+ * Implementation of successive-halving optimization of hyper-parameters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SUCCESSIVE_HALVING_SUCCESSIVE_HALVING_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_SUCCESSIVE_HALVING_SUCCESSIVE_HALVING_IMPL_HPP
+
+#include <mlpack/core/optimizers/function.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+template<typename FunctionType>
+double SuccessiveHalving::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo)
+{
+  // Make sure we have the methods that we need.
+  traits::CheckNonDifferentiableFunctionTypeAPI<FunctionType>();
+
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    if (datasetInfo.Type(i) != data::Datatype::categorical)
+    {
+      std::ostringstream oss;
+      oss << "SuccessiveHalving::Optimize(): the dimension " << i
+          << " is not categorical" << std::endl;
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  if (minFraction <= 0.0 || minFraction > 1.0)
+  {
+    throw std::invalid_argument("SuccessiveHalving::Optimize(): the minimum "
+        "fraction should be more than 0 and not more than 1");
+  }
+
+  if (eta < 2)
+  {
+    throw std::invalid_argument("SuccessiveHalving::Optimize(): eta should "
+        "not be less than 2");
+  }
+
+  // Lay out all the points of the grid, one per column, in the order that
+  // GridSearch visits them (the last dimension changes fastest), so that ties
+  // are broken the same way.
+  const size_t dimensionality = datasetInfo.Dimensionality();
+  size_t numPoints = 1;
+  for (size_t i = 0; i < dimensionality; ++i)
+    numPoints *= datasetInfo.NumMappings(i);
+
+  arma::mat points(dimensionality, numPoints);
+  for (size_t p = 0; p < numPoints; ++p)
+  {
+    size_t index = p;
+    for (size_t i = dimensionality; i > 0; --i)
+    {
+      const size_t mappings = datasetInfo.NumMappings(i - 1);
+      points(i - 1, p) = datasetInfo.UnmapString(index % mappings, i - 1);
+      index /= mappings;
+    }
+  }
+
+  // The full budget is the training fraction the function has now; it is
+  // restored at the end.
+  const double fullFraction = function.TrainingFraction();
+
+  // All the rungs of this search train on subsets drawn with the same seed.
+  function.SubsetSeed() =
+      (size_t) math::RandInt(std::numeric_limits<int>::max());
+
+  arma::vec objectives;
+  try
+  {
+    double fraction = minFraction;
+    while (true)
+    {
+      function.TrainingFraction() = fullFraction * std::min(fraction, 1.0);
+
+      // The points of a rung are independent, so they are evaluated in
+      // parallel.
+      objectives.set_size(points.n_cols);
+      Threads::ParallelFor(0, points.n_cols, [&](const size_t p)
+      {
+        objectives[p] = function.EvaluateWithoutModel(points.col(p));
+      });
+
+      if (fraction >= 1.0 || points.n_cols == 1)
+        break;
+
+      // Keep the best points, in their original order.
+      const size_t kept = (points.n_cols + eta - 1) / eta;
+      const arma::uvec best = arma::sort(
+          arma::stable_sort_index(objectives).eval().head(kept));
+      points = points.cols(best);
+      fraction *= eta;
+    }
+  }
+  catch (...)
+  {
+    function.TrainingFraction() = fullFraction;
+    throw;
+  }
+
+  function.TrainingFraction() = fullFraction;
+
+  // The best point is evaluated once more with the full budget, so that the
+  // function keeps its model.
+  arma::uword bestIndex = 0;
+  objectives.min(bestIndex);
+  bestParameters = points.col(bestIndex);
+
+  return function.Evaluate(bestParameters);
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -14,9 +14,11 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/sgd/decay_policies/no_decay.hpp>
+#include <mlpack/core/optimizers/function/full_evaluate_with_gradient.hpp>
 
 #include "svrg_update.hpp"
 #include "barzilai_borwein_decay.hpp"
+#include <mlpack/core/optimizers/callbacks/callbacks.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -124,6 +126,10 @@ class SVRGType
    * @param decayPolicy Instantiated decay policy used to adjust the step size.
    * @param resetPolicy Flag that determines whether update policy parameters
    *     are reset before every Optimize call.
+   * @param numThreads Number of threads used to compute the objective and the
+   *     full gradient of each outer iteration (0 means all of them).  With
+   *     more than one, the batch methods of the function must be safe to call
+   *     concurrently.
    */
   SVRGType(const double stepSize = 0.01,
            const size_t batchSize = 32,
@@ -133,20 +139,29 @@ class SVRGType
            const bool shuffle = true,
            const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
            const DecayPolicyType& decayPolicy = DecayPolicyType(),
-           const bool resetPolicy = true);
+           const bool resetPolicy = true,
+           const size_t numThreads = 1);
 
   /**
    * Optimize the given function using SVRG. The given starting point will be
    * modified to store the finishing point of the algorithm, and the final
    * objective value is returned.
    *
+   * Any number of callbacks (see Callback) can be given after the starting
+   * point.  Each outer iteration is reported as an epoch, the full gradient
+   * of each outer iteration as a gradient, and each inner update as a step.
+   *
    * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam CallbackTypes Types of the callbacks.
    * @param function Function to optimize.
    * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks to call during the optimization.
    * @return Objective value of the final point.
    */
-  template<typename DecomposableFunctionType>
-  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+  template<typename DecomposableFunctionType, typename... CallbackTypes>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackTypes&&... callbacks);
 
   //! Get the step size.
   double StepSize() const { return stepSize; }
@@ -195,6 +210,11 @@ class SVRGType
   //! Modify the step size decay policy.
   DecayPolicyType& DecayPolicy() { return decayPolicy; }
 
+  //! Get the number of threads used for the full gradient.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used for the full gradient.
+  size_t& NumThreads() { return numThreads; }
+
  private:
   //! The step size for each example.
   double stepSize;
@@ -224,6 +244,9 @@ class SVRGType
   //! Flag indicating whether update policy
   //! should be reset before running optimization.
   bool resetPolicy;
+
+  //! The number of threads used for the full gradient.
+  size_t numThreads;
 };
 
 // Convenience typedefs.
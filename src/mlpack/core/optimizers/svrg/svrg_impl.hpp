@@ -28,7 +28,8 @@ SVRGType<UpdatePolicyType, DecayPolicyType>::SVRGType(
     const bool shuffle,
     const UpdatePolicyType& updatePolicy,
     const DecayPolicyType& decayPolicy,
-    const bool resetPolicy) :
+    const bool resetPolicy,
+    const size_t numThreads) :
     stepSize(stepSize),
     batchSize(batchSize),
     maxIterations(maxIterations),
@@ -37,15 +38,17 @@ SVRGType<UpdatePolicyType, DecayPolicyType>::SVRGType(
     shuffle(shuffle),
     updatePolicy(updatePolicy),
     decayPolicy(decayPolicy),
-    resetPolicy(resetPolicy)
+    resetPolicy(resetPolicy),
+    numThreads(numThreads)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
 template<typename UpdatePolicyType, typename DecayPolicyType>
-template<typename DecomposableFunctionType>
+template<typename DecomposableFunctionType, typename... CallbackTypes>
 double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
     DecomposableFunctionType& function,
-    arma::mat& iterate)
+    arma::mat& iterate,
+    CallbackTypes&&... callbacks)
 {
   // Find the number of functions to use.
   const size_t numFunctions = function.NumFunctions();
@@ -53,6 +56,7 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
   // To keep track of where we are and how things are going.
   double overallObjective = 0;
   double lastObjective = DBL_MAX;
+  bool terminate = false;
 
   // Set epoch length to n / b if the user asked for.
   if (innerIterations == 0)
@@ -72,16 +76,23 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
   if (numFunctions % batchSize != 0)
     ++numBatches; // Capture last few.
 
+  Callback::BeginOptimization(*this, function, iterate, callbacks...);
+
   const size_t actualMaxIterations = (maxIterations == 0) ?
       std::numeric_limits<size_t>::max() : maxIterations;
-  for (size_t i = 0; i < actualMaxIterations; ++i)
+  for (size_t i = 0; i < actualMaxIterations && !terminate; ++i)
   {
-    // Calculate the objective function.
-    overallObjective = 0;
-    for (size_t f = 0; f < numFunctions; f += batchSize)
+    // Calculate the objective function and the full gradient in one pass.
+    arma::mat fullGradient(iterate.n_rows, iterate.n_cols);
+    overallObjective = FullEvaluateWithGradient(function, iterate, batchSize,
+        fullGradient, numThreads);
+
+    // The objective is the one at the end of the previous epoch.
+    if (i > 0 && Callback::EndEpoch(*this, function, iterate, i,
+        overallObjective, callbacks...))
     {
-      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-      overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
+      terminate = true;
+      break;
     }
 
     if (std::isnan(overallObjective) || std::isinf(overallObjective))
@@ -89,6 +100,7 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
       Log::Warn << "SVRG: converged to " << overallObjective
           << "; terminating  with failure.  Try a smaller step size?"
           << std::endl;
+      Callback::EndOptimization(*this, function, iterate, callbacks...);
       return overallObjective;
     }
 
@@ -96,33 +108,25 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
     {
       Log::Info << "SVRG: minimized within tolerance " << tolerance
           << "; terminating optimization." << std::endl;
+      Callback::EndOptimization(*this, function, iterate, callbacks...);
       return overallObjective;
     }
 
     lastObjective = overallObjective;
 
-    // Compute the full gradient.
-    size_t effectiveBatchSize = std::min(batchSize, numFunctions);
-    arma::mat fullGradient(iterate.n_rows, iterate.n_cols);
-    function.Gradient(iterate, 0, fullGradient, effectiveBatchSize);
-    for (size_t f = effectiveBatchSize; f < numFunctions;
-        /* incrementing done manually */)
+    fullGradient /= (double) numFunctions;
+    if (Callback::Gradient(*this, function, iterate, fullGradient,
+        callbacks...))
     {
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - f);
-
-      function.Gradient(iterate, f, gradient, effectiveBatchSize);
-      fullGradient += gradient;
-
-      f += effectiveBatchSize;
+      terminate = true;
+      break;
     }
-    fullGradient /= (double) numFunctions;
 
     // Store current parameter for the calculation of the variance reduced
     // gradient.
     iterate0 = iterate;
 
-    for (size_t f = 0, currentFunction = 0; f < innerIterations;
+    for (size_t f = 0, currentFunction = 0; f < innerIterations && !terminate;
         /* incrementing done manually */)
     {
       // Is this iteration the start of a sequence?
@@ -136,7 +140,8 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
       }
 
       // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - currentFunction);
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - currentFunction);
 
       // Calculate variance reduced gradient.
       function.Gradient(iterate, currentFunction, gradient,
@@ -150,6 +155,8 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
 
       currentFunction += effectiveBatchSize;
       f += effectiveBatchSize;
+
+      terminate = Callback::StepTaken(*this, function, iterate, callbacks...);
     }
 
     // Update the learning rate if requested by the user.
@@ -157,8 +164,17 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
         stepSize);
   }
 
-  Log::Info << "SVRG: maximum iterations (" << maxIterations << ") reached; "
-      << "terminating optimization." << std::endl;
+  if (terminate)
+  {
+    Log::Info << "SVRG: terminated by a callback." << std::endl;
+  }
+  else
+  {
+    Log::Info << "SVRG: maximum iterations (" << maxIterations << ") "
+        << "reached; terminating optimization." << std::endl;
+  }
+
+  Callback::EndOptimization(*this, function, iterate, callbacks...);
 
   // Calculate final objective.
   overallObjective = 0;
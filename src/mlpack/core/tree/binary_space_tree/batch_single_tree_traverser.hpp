@@ -0,0 +1,101 @@
+/**
+ * @file batch_single_tree_traverser.hpp
+ *
+ * A nested class of BinarySpaceTree which traverses the tree with a block of
+ * query points at once, using a given set of rules which indicate the branches
+ * which can be pruned and the order in which to recurse.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_BATCH_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_BATCH_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "binary_space_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A single-tree traverser that pushes a block of query points down the tree
+ * together, so that every node is visited once per block instead of once per
+ * query point.  At every node, the block holds only the query points for which
+ * the node was not pruned; the block is split by the child that every query
+ * point visits first, and the other child is rescored (and visited by the
+ * query points that are still not pruned) afterwards.  Every query point sees
+ * the same sequence of Score(), Rescore() and BaseCase() calls as with the
+ * SingleTreeTraverser, except that the second child is rescored later, so the
+ * results are the same.  This gives much of the cache reuse of a dual-tree
+ * traversal for small batches of query points, without a query tree.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                      SplitType>::BatchSingleTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the batched single tree traverser with the given rule set.
+   */
+  BatchSingleTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse the tree with the given point.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const size_t queryIndex, BinarySpaceTree& referenceNode);
+
+  /**
+   * Traverse the tree with the given block of points.
+   *
+   * @param queryIndices The indices of the points in the query set which are
+   *     being used as the query points.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const std::vector<size_t>& queryIndices,
+                BinarySpaceTree& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+ private:
+  /**
+   * Rescore the given node for the given query points, and traverse it with
+   * the query points for which it is not pruned.
+   *
+   * @param queryIndices The indices of the query points.
+   * @param scores The old score of the node for every query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void TraverseRescored(const std::vector<size_t>& queryIndices,
+                        const std::vector<double>& scores,
+                        BinarySpaceTree& referenceNode);
+
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "batch_single_tree_traverser_impl.hpp"
+
+#endif
@@ -0,0 +1,143 @@
+/**
+ * @file batch_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the BatchSingleTreeTraverser for BinarySpaceTree, which
+ * traverses the tree with a block of query points at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_BATCH_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_BATCH_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "batch_single_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BatchSingleTreeTraverser<RuleType>::BatchSingleTreeTraverser(RuleType& rule) :
+    rule(rule),
+    numPrunes(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BatchSingleTreeTraverser<RuleType>::Traverse(
+    const size_t queryIndex,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+  Traverse(std::vector<size_t>(1, queryIndex), referenceNode);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BatchSingleTreeTraverser<RuleType>::Traverse(
+    const std::vector<size_t>& queryIndices,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+  if (queryIndices.empty())
+    return;
+
+  // If we are a leaf, run the base cases as necessary.
+  if (referenceNode.IsLeaf())
+  {
+    const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+    for (size_t q = 0; q < queryIndices.size(); ++q)
+      for (size_t i = referenceNode.Begin(); i < refEnd; ++i)
+        rule.BaseCase(queryIndices[q], i);
+
+    return;
+  }
+
+  // Split the block by the child that every query point recurses into first,
+  // and keep the score of the other child for rescoring.  If both scores are
+  // DBL_MAX, the query point does not recurse at all.
+  std::vector<size_t> leftFirst, rightFirst;
+  std::vector<double> rightScores, leftScores;
+  for (size_t q = 0; q < queryIndices.size(); ++q)
+  {
+    const double leftScore = rule.Score(queryIndices[q],
+        *referenceNode.Left());
+    const double rightScore = rule.Score(queryIndices[q],
+        *referenceNode.Right());
+
+    if (leftScore == DBL_MAX && rightScore == DBL_MAX)
+    {
+      numPrunes += 2; // Pruned both left and right.
+    }
+    else if (rightScore < leftScore)
+    {
+      rightFirst.push_back(queryIndices[q]);
+      leftScores.push_back(leftScore);
+    }
+    else
+    {
+      // Choose the left first if the scores are equal.
+      leftFirst.push_back(queryIndices[q]);
+      rightScores.push_back(rightScore);
+    }
+  }
+
+  Traverse(leftFirst, *referenceNode.Left());
+  Traverse(rightFirst, *referenceNode.Right());
+
+  // Is it still valid to recurse to the other child?
+  TraverseRescored(leftFirst, rightScores, *referenceNode.Right());
+  TraverseRescored(rightFirst, leftScores, *referenceNode.Left());
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BatchSingleTreeTraverser<RuleType>::TraverseRescored(
+    const std::vector<size_t>& queryIndices,
+    const std::vector<double>& scores,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+  std::vector<size_t> remaining;
+  for (size_t q = 0; q < queryIndices.size(); ++q)
+  {
+    if (rule.Rescore(queryIndices[q], referenceNode, scores[q]) != DBL_MAX)
+      remaining.push_back(queryIndices[q]);
+    else
+      ++numPrunes;
+  }
+
+  Traverse(remaining, referenceNode);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,16 @@
 
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
+
+#include <unordered_set>
+
+// Subtrees are built and traversed with OpenMP tasks, which are available since
+// OpenMP 3.0.
+#if defined(HAS_OPENMP) && defined(_OPENMP) && (_OPENMP >= 200805)
+  #include <omp.h>
+  #define MLPACK_BINARY_SPACE_TREE_USE_TASKS
+#endif
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -88,6 +98,9 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! Whether the descendants of this (root) node are stored contiguously in a
+  //! single buffer owned by this node; see CompactLayout().
+  bool compacted;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -95,6 +108,11 @@ class BinarySpaceTree
   template<typename RuleType>
   class SingleTreeTraverser;
 
+  //! A single-tree traverser that traverses the tree with a block of query
+  //! points at once; see batch_single_tree_traverser.hpp.
+  template<typename RuleType>
+  class BatchSingleTreeTraverser;
+
   //! A dual-tree traverser for binary space trees; see dual_tree_traverser.hpp.
   template<typename RuleType>
   class DualTreeTraverser;
@@ -102,6 +120,16 @@ class BinarySpaceTree
   template<typename RuleType>
   class BreadthFirstDualTreeTraverser;
 
+  //! A dual-tree traverser that traverses the top levels of the query tree in
+  //! parallel; see parallel_dual_tree_traverser.hpp.
+  template<typename RuleType>
+  class ParallelDualTreeTraverser;
+
+  //! A breadth-first dual-tree traverser that expands every level of the query
+  //! tree in parallel; see parallel_breadth_first_dual_tree_traverser.hpp.
+  template<typename RuleType>
+  class ParallelBreadthFirstDualTreeTraverser;
+
   /**
    * Construct this as the root node of a binary space tree using the given
    * dataset.  This will copy the input matrix; if you don't want this, consider
@@ -300,6 +328,82 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Relocate every descendant of this node into a single contiguous block of
+   * memory, in breadth-first order, so that traversals touch nodes that are
+   * close together instead of nodes scattered across the heap.  The structure
+   * of the tree does not change, so all of the existing traversers and rules
+   * can be used with a compacted tree as before.
+   *
+   * This may only be called on the root of a tree, and it should be called
+   * once the tree will not be modified anymore: pointers to any nodes other
+   * than the root are invalidated.  Copies of a compacted tree are not
+   * compacted.
+   */
+  void CompactLayout();
+
+  //! Return whether the descendants of this node are stored contiguously.
+  bool IsCompacted() const { return compacted; }
+
+  /**
+   * Insert the given points into the tree.  Each point is added to the leaf it
+   * falls into (descending towards the closest child), and the dataset is
+   * rearranged so that the points of every node stay contiguous.  Along the
+   * way, the bounds and statistics of the nodes that received points are
+   * updated, leaves that grow beyond maxLeafSize are split, and any subtree
+   * that becomes much deeper than its number of points warrants is rebuilt
+   * from scratch (in the style of a scapegoat tree).
+   *
+   * The indices in oldFromNew are the identifiers of the points; the new points
+   * get the identifiers following the largest one in oldFromNew, in the order
+   * they are given.  If oldFromNew is empty, the current points are taken to
+   * be numbered by their position in the dataset.
+   *
+   * This may only be called on the root of a tree that is not compacted.
+   * Pointers to nodes of the tree may be invalidated.
+   *
+   * @param points Points to insert.
+   * @param oldFromNew Mapping from positions in the dataset to point
+   *     identifiers; this is updated.
+   * @param maxLeafSize Maximum number of points in a leaf.
+   */
+  void InsertPoints(const MatType& points,
+                    std::vector<size_t>& oldFromNew,
+                    const size_t maxLeafSize = 20);
+
+  /**
+   * Delete the points with the given identifiers (see InsertPoints()) from the
+   * tree and from its dataset.  Nodes that lose points are updated, and
+   * subtrees that become empty or too small to be split are rebuilt.
+   * Identifiers that are not in the tree are ignored.
+   *
+   * This may only be called on the root of a tree that is not compacted.
+   * Pointers to nodes of the tree may be invalidated.
+   *
+   * @param indices Identifiers of the points to delete.
+   * @param oldFromNew Mapping from positions in the dataset to point
+   *     identifiers; this is updated.
+   * @param maxLeafSize Maximum number of points in a leaf.
+   * @return The number of points that were deleted.
+   */
+  size_t DeletePoints(const std::vector<size_t>& indices,
+                      std::vector<size_t>& oldFromNew,
+                      const size_t maxLeafSize = 20);
+
+  /**
+   * Recompute the bound, the distances to the parent and the statistic of
+   * every node from the current contents of the dataset, without changing the
+   * structure of the tree.  This is for points that have moved in place (for
+   * instance, after a new linear transformation of the data was written into
+   * Dataset()): the tree stays valid for exact searches, although its splits
+   * get less efficient as the points move further from where the tree was
+   * built.
+   */
+  void RefitBounds();
+
+  //! Return the number of levels of the tree below and including this node.
+  size_t TreeDepth() const;
+
   //! Return the bound object for this node.
   const BoundType<MetricType>& Bound() const { return bound; }
   //! Return the bound object for this node.
@@ -514,6 +618,22 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Build the two children of the current node, of which the left one holds
+   * the points before splitCol.  If the split type allows it (see SplitTraits)
+   * and the node is large enough, the two subtrees are built concurrently.
+   *
+   * @param splitCol The first point of the right child.
+   * @param oldFromNew Vector holding permuted indices, or NULL if the indices
+   *     aren't tracked.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void BuildChildren(const size_t splitCol,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize,
+                     SplitType<BoundType<MetricType>, MatType>& splitter);
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
@@ -523,6 +643,46 @@ class BinarySpaceTree
   template<typename BoundType2>
   void UpdateBound(BoundType2& boundToUpdate);
 
+  /**
+   * Delete the children of this node, whether they were allocated one by one
+   * or all together by CompactLayout().
+   */
+  void DeleteChildren();
+
+  /**
+   * Update the begin and count of this node and its descendants after points
+   * were inserted at or deleted from the given (sorted) positions of the old
+   * dataset.  A point inserted at position p belongs to the leaf that ends at
+   * p.  The nodes whose set of points changed are added to 'changed'.
+   */
+  void ShiftRanges(const std::vector<size_t>& positions,
+                   const bool inserted,
+                   std::unordered_set<const BinarySpaceTree*>& changed);
+
+  /**
+   * Refresh the nodes in 'changed' after points were inserted or deleted,
+   * bottom-up, rebuilding the subtrees that need it.  Returns the depth of this
+   * node's subtree.
+   */
+  size_t RefreshChanged(
+      const std::unordered_set<const BinarySpaceTree*>& changed,
+      const size_t maxLeafSize,
+      std::vector<size_t>& oldFromNew,
+      SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Rebuild the subtree rooted at this node from the points it holds.
+   */
+  void Rebuild(const size_t maxLeafSize,
+               std::vector<size_t>& oldFromNew,
+               SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Check the preconditions of InsertPoints() and DeletePoints(), and fill
+   * oldFromNew with the identity mapping if it is empty.
+   */
+  void PrepareUpdate(const char* function, std::vector<size_t>& oldFromNew);
+
   /**
    * Update the bound of the current node. This method is designed for
    * HollowBallBound only.
@@ -17,6 +17,7 @@
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <queue>
+#include <new>
 
 namespace mlpack {
 namespace tree {
@@ -40,7 +41,8 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    compacted(false)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -68,7 +70,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    compacted(false)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -102,7 +105,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    compacted(false)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -137,7 +141,8 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    compacted(false)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -165,7 +170,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    compacted(false)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -199,7 +205,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    compacted(false)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -238,7 +245,8 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    compacted(false)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -267,7 +275,8 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    compacted(false)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -301,7 +310,8 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    compacted(false)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -342,7 +352,8 @@ BinarySpaceTree(
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    compacted(false)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -400,7 +411,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    compacted(other.compacted)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -412,6 +424,7 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.compacted = false;
 
   // Set new parent.
   if (left)
@@ -455,14 +468,495 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
     delete dataset;
 }
 
+/**
+ * Move all of the descendants of this node into one contiguous buffer, in
+ * breadth-first order.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    CompactLayout()
+{
+  if (parent)
+  {
+    Log::Fatal << "BinarySpaceTree::CompactLayout(): can only be called on the "
+        << "root of a tree!" << std::endl;
+  }
+
+  if (compacted || !left)
+    return;
+
+  // Collect the descendants in breadth-first order.  Since both children of a
+  // node are always present, they end up next to each other.
+  std::vector<BinarySpaceTree*> nodes;
+  nodes.push_back(left);
+  nodes.push_back(right);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (nodes[i]->left)
+    {
+      nodes.push_back(nodes[i]->left);
+      nodes.push_back(nodes[i]->right);
+    }
+  }
+
+  BinarySpaceTree* buffer = static_cast<BinarySpaceTree*>(
+      ::operator new(nodes.size() * sizeof(BinarySpaceTree)));
+
+  // Every parent has been moved before its children, and the move constructor
+  // points the children at their new parent, so we only have to fix the
+  // parent's child pointer.  The moved-from node owns nothing anymore.
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    BinarySpaceTree* node = new (buffer + i) BinarySpaceTree(
+        std::move(*nodes[i]));
+    if (node->parent->left == nodes[i])
+      node->parent->left = node;
+    else
+      node->parent->right = node;
+
+    delete nodes[i];
+  }
+
+  compacted = true;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeleteChildren()
+{
+  if (!compacted)
+  {
+    delete left;
+    delete right;
+  }
+  else
+  {
+    // The descendants are stored in breadth-first order, starting with our
+    // left child.  Count them before anything is destroyed.
+    BinarySpaceTree* buffer = left;
+    size_t numNodes = 0;
+    std::queue<BinarySpaceTree*> queue;
+    queue.push(this);
+    while (!queue.empty())
+    {
+      BinarySpaceTree* node = queue.front();
+      queue.pop();
+      if (node->left)
+      {
+        numNodes += 2;
+        queue.push(node->left);
+        queue.push(node->right);
+      }
+    }
+
+    // The nodes in the buffer must not delete their own children.
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      buffer[i].left = NULL;
+      buffer[i].right = NULL;
+      buffer[i].~BinarySpaceTree();
+    }
+
+    ::operator delete(buffer);
+    compacted = false;
+  }
+
+  left = NULL;
+  right = NULL;
+}
+
+/**
+ * Insert points into the tree, keeping the points of every node contiguous.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    InsertPoints(const MatType& points,
+                 std::vector<size_t>& oldFromNew,
+                 const size_t maxLeafSize)
+{
+  PrepareUpdate("InsertPoints", oldFromNew);
+  if (points.n_cols == 0)
+    return;
+
+  if (dataset->n_cols > 0 && points.n_rows != dataset->n_rows)
+  {
+    Log::Fatal << "BinarySpaceTree::InsertPoints(): dimensionality of points ("
+        << points.n_rows << ") does not match dimensionality of dataset ("
+        << dataset->n_rows << ")!" << std::endl;
+  }
+
+  // The new points are numbered after the largest identifier in the tree.
+  size_t nextIndex = 0;
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    nextIndex = std::max(nextIndex, oldFromNew[i] + 1);
+
+  SplitType<BoundType<MetricType>, MatType> splitter;
+
+  // An empty tree is simply built from the new points.
+  if (count == 0)
+  {
+    *dataset = points;
+    count = points.n_cols;
+    oldFromNew.resize(points.n_cols);
+    for (size_t i = 0; i < points.n_cols; ++i)
+      oldFromNew[i] = nextIndex + i;
+
+    Rebuild(maxLeafSize, oldFromNew, splitter);
+    return;
+  }
+
+  // Find the leaf of each new point; the point will be placed in the dataset
+  // right after the points of that leaf.
+  std::vector<std::pair<size_t, size_t> > insertions(points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BinarySpaceTree* node = this;
+    while (!node->IsLeaf())
+    {
+      const ElemType leftDistance = node->left->bound.MinDistance(
+          points.col(i));
+      const ElemType rightDistance = node->right->bound.MinDistance(
+          points.col(i));
+
+      if ((leftDistance < rightDistance) || ((leftDistance == rightDistance) &&
+          (node->left->count <= node->right->count)))
+        node = node->left;
+      else
+        node = node->right;
+    }
+
+    insertions[i] = std::make_pair(node->begin + node->count, i);
+  }
+
+  std::sort(insertions.begin(), insertions.end());
+
+  // Merge the new points into the dataset.
+  MatType newDataset(dataset->n_rows, dataset->n_cols + points.n_cols);
+  std::vector<size_t> newOldFromNew(newDataset.n_cols);
+  std::vector<size_t> positions(insertions.size());
+  size_t oldCol = 0;
+  size_t newCol = 0;
+  for (size_t i = 0; i <= insertions.size(); ++i)
+  {
+    const size_t end = (i < insertions.size()) ? insertions[i].first :
+        dataset->n_cols;
+    if (end > oldCol)
+    {
+      newDataset.cols(newCol, newCol + (end - oldCol) - 1) =
+          dataset->cols(oldCol, end - 1);
+      for (size_t j = oldCol; j < end; ++j)
+        newOldFromNew[newCol++] = oldFromNew[j];
+      oldCol = end;
+    }
+
+    if (i < insertions.size())
+    {
+      newDataset.col(newCol) = points.col(insertions[i].second);
+      newOldFromNew[newCol++] = nextIndex + insertions[i].second;
+      positions[i] = insertions[i].first;
+    }
+  }
+
+  // Assign in place, so that references to the dataset stay valid.
+  *dataset = std::move(newDataset);
+  oldFromNew.swap(newOldFromNew);
+
+  std::unordered_set<const BinarySpaceTree*> changed;
+  ShiftRanges(positions, true, changed);
+  RefreshChanged(changed, maxLeafSize, oldFromNew, splitter);
+}
+
+/**
+ * Delete points from the tree and from its dataset.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+    SplitType>::DeletePoints(const std::vector<size_t>& indices,
+                             std::vector<size_t>& oldFromNew,
+                             const size_t maxLeafSize)
+{
+  PrepareUpdate("DeletePoints", oldFromNew);
+
+  std::vector<size_t> sortedIndices(indices);
+  std::sort(sortedIndices.begin(), sortedIndices.end());
+
+  // Find the positions of the points in the dataset.
+  std::vector<size_t> positions;
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    if (std::binary_search(sortedIndices.begin(), sortedIndices.end(),
+        oldFromNew[i]))
+      positions.push_back(i);
+  }
+
+  if (positions.empty())
+    return 0;
+
+  // Remove the points from the dataset.
+  MatType newDataset(dataset->n_rows, dataset->n_cols - positions.size());
+  std::vector<size_t> newOldFromNew(newDataset.n_cols);
+  size_t oldCol = 0;
+  size_t newCol = 0;
+  for (size_t i = 0; i <= positions.size(); ++i)
+  {
+    const size_t end = (i < positions.size()) ? positions[i] : dataset->n_cols;
+    if (end > oldCol)
+    {
+      newDataset.cols(newCol, newCol + (end - oldCol) - 1) =
+          dataset->cols(oldCol, end - 1);
+      for (size_t j = oldCol; j < end; ++j)
+        newOldFromNew[newCol++] = oldFromNew[j];
+    }
+
+    oldCol = end + 1;
+  }
+
+  // Assign in place, so that references to the dataset stay valid.
+  *dataset = std::move(newDataset);
+  oldFromNew.swap(newOldFromNew);
+
+  SplitType<BoundType<MetricType>, MatType> splitter;
+  std::unordered_set<const BinarySpaceTree*> changed;
+  ShiftRanges(positions, false, changed);
+  RefreshChanged(changed, maxLeafSize, oldFromNew, splitter);
+
+  return positions.size();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+    SplitType>::RefitBounds()
+{
+  // As during construction, the bound of a node is computed before the bounds
+  // of its children, and the statistic after them.
+  bound = BoundType<MetricType>(dataset->n_rows);
+  UpdateBound(bound);
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (!IsLeaf())
+  {
+    left->RefitBounds();
+    right->RefitBounds();
+
+    arma::vec center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->ParentDistance() = MetricType::Evaluate(center, leftCenter);
+    right->ParentDistance() = MetricType::Evaluate(center, rightCenter);
+  }
+
+  stat = StatisticType(*this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+    SplitType>::TreeDepth() const
+{
+  if (!left)
+    return 1;
+
+  return 1 + std::max(left->TreeDepth(), right->TreeDepth());
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    ShiftRanges(const std::vector<size_t>& positions,
+                const bool inserted,
+                std::unordered_set<const BinarySpaceTree*>& changed)
+{
+  const size_t oldBegin = begin;
+  const size_t oldEnd = begin + count;
+
+  size_t before, within;
+  if (inserted)
+  {
+    // Points inserted at our first position belong to the previous leaf.
+    before = std::upper_bound(positions.begin(), positions.end(), oldBegin) -
+        positions.begin();
+    within = (std::upper_bound(positions.begin(), positions.end(), oldEnd) -
+        positions.begin()) - before;
+    begin = oldBegin + before;
+    count += within;
+  }
+  else
+  {
+    before = std::lower_bound(positions.begin(), positions.end(), oldBegin) -
+        positions.begin();
+    within = (std::lower_bound(positions.begin(), positions.end(), oldEnd) -
+        positions.begin()) - before;
+    begin = oldBegin - before;
+    count -= within;
+  }
+
+  if (within > 0)
+    changed.insert(this);
+
+  if (left)
+  {
+    left->ShiftRanges(positions, inserted, changed);
+    right->ShiftRanges(positions, inserted, changed);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+    SplitType>::RefreshChanged(
+    const std::unordered_set<const BinarySpaceTree*>& changed,
+    const size_t maxLeafSize,
+    std::vector<size_t>& oldFromNew,
+    SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  if (changed.count(this) == 0)
+    return TreeDepth();
+
+  // Leaves that got too large are split, and nodes with an empty child or too
+  // few points to be split are rebuilt.
+  bool rebuild = IsLeaf() ? (count > maxLeafSize) :
+      (count <= maxLeafSize || left->count == 0 || right->count == 0);
+
+  size_t depth = 1;
+  if (!rebuild && !IsLeaf())
+  {
+    depth += std::max(
+        left->RefreshChanged(changed, maxLeafSize, oldFromNew, splitter),
+        right->RefreshChanged(changed, maxLeafSize, oldFromNew, splitter));
+
+    // In the style of a scapegoat tree, a subtree that became much deeper than
+    // a tree whose splits are at most 70/30 would be is rebuilt from scratch.
+    const double leaves = std::max((double) count /
+        std::max(maxLeafSize, (size_t) 1), 1.0);
+    const size_t maxDepth = 2 + (size_t) std::ceil(std::log(leaves) /
+        std::log(1.0 / 0.7));
+    rebuild = (depth > maxDepth);
+  }
+
+  if (rebuild)
+  {
+    Rebuild(maxLeafSize, oldFromNew, splitter);
+    return TreeDepth();
+  }
+
+  bound = BoundType<MetricType>(dataset->n_rows);
+  UpdateBound(bound);
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (!IsLeaf())
+  {
+    arma::vec center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->ParentDistance() = MetricType::Evaluate(center, leftCenter);
+    right->ParentDistance() = MetricType::Evaluate(center, rightCenter);
+  }
+
+  stat = StatisticType(*this);
+  return depth;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Rebuild(const size_t maxLeafSize,
+            std::vector<size_t>& oldFromNew,
+            SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  DeleteChildren();
+  bound = BoundType<MetricType>(dataset->n_rows);
+  SplitNode(oldFromNew, maxLeafSize, splitter);
+  stat = StatisticType(*this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    PrepareUpdate(const char* function, std::vector<size_t>& oldFromNew)
+{
+  if (parent)
+  {
+    Log::Fatal << "BinarySpaceTree::" << function << "(): can only be called "
+        << "on the root of a tree!" << std::endl;
+  }
+
+  if (compacted)
+  {
+    Log::Fatal << "BinarySpaceTree::" << function << "(): cannot modify a "
+        << "compacted tree!" << std::endl;
+  }
+
+  // If there is no mapping yet, the points are numbered by their position.
+  if (oldFromNew.empty())
+  {
+    oldFromNew.resize(dataset->n_cols);
+    for (size_t i = 0; i < dataset->n_cols; ++i)
+      oldFromNew[i] = i;
+  }
+  else if (oldFromNew.size() != dataset->n_cols)
+  {
+    Log::Fatal << "BinarySpaceTree::" << function << "(): size of oldFromNew ("
+        << oldFromNew.size() << ") does not match number of points in the "
+        << "dataset (" << dataset->n_cols << ")!" << std::endl;
+  }
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -783,10 +1277,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
+  BuildChildren(splitCol, NULL, maxLeafSize, splitter);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -850,10 +1341,7 @@ SplitNode(std::vector<size_t>& oldFromNew,
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  BuildChildren(splitCol, &oldFromNew, maxLeafSize, splitter);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -869,6 +1357,86 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildChildren(const size_t splitCol,
+              std::vector<size_t>* oldFromNew,
+              const size_t maxLeafSize,
+              SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // The children own disjoint column ranges of the dataset (and of
+  // oldFromNew), so they can be built independently.  Sparse matrices can't
+  // have their columns swapped independently, and small nodes aren't worth a
+  // task.
+  const bool concurrent =
+      SplitTraits<SplitType<BoundType<MetricType>, MatType> >::
+          ConcurrentChildren &&
+      !arma::is_SpMat<MatType>::value && count >= 8 * maxLeafSize &&
+      count >= 1024;
+
+#ifdef MLPACK_BINARY_SPACE_TREE_USE_TASKS
+  if (concurrent)
+  {
+    // The tasks need a team of threads to run on.
+    if (!omp_in_parallel())
+    {
+      #pragma omp parallel
+      {
+        #pragma omp single
+        BuildChildren(splitCol, oldFromNew, maxLeafSize, splitter);
+      }
+
+      return;
+    }
+
+    #pragma omp task shared(splitter)
+    {
+      if (oldFromNew)
+        left = new BinarySpaceTree(this, begin, splitCol - begin, *oldFromNew,
+            splitter, maxLeafSize);
+      else
+        left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
+            maxLeafSize);
+    }
+
+    #pragma omp task shared(splitter)
+    {
+      if (oldFromNew)
+        right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
+            *oldFromNew, splitter, maxLeafSize);
+      else
+        right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
+            splitter, maxLeafSize);
+    }
+
+    #pragma omp taskwait
+    return;
+  }
+#else
+  (void) concurrent;
+#endif
+
+  if (oldFromNew)
+  {
+    left = new BinarySpaceTree(this, begin, splitCol - begin, *oldFromNew,
+        splitter, maxLeafSize);
+    right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
+        *oldFromNew, splitter, maxLeafSize);
+  }
+  else
+  {
+    left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
+        maxLeafSize);
+    right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
+        splitter, maxLeafSize);
+  }
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -926,7 +1494,8 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    compacted(false)
 {
   // Nothing to do.
 }
@@ -947,10 +1516,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
       delete dataset;
 
@@ -61,8 +61,17 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
    */
   void Traverse(BinarySpaceTree& queryNode,
                 BinarySpaceTree& referenceNode);
+
+  /**
+   * Traverse the given query node with every reference frame in the given
+   * queue.  The queue is a heap ordered like a priority queue (see
+   * std::push_heap()), and it is empty when this returns.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceQueue Heap of frames to visit with the query node.
+   */
   void Traverse(BinarySpaceTree& queryNode,
-                std::priority_queue<QueueFrameType>& referenceQueue);
+                std::vector<QueueFrameType>& referenceQueue);
 
   //! Get the number of prunes.
   size_t NumPrunes() const { return numPrunes; }
@@ -103,6 +112,15 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! Queues that are not in use, kept with their memory so that the queues of
+  //! each level of the traversal do not allocate again.
+  std::vector<std::vector<QueueFrameType>> queuePool;
+
+  //! Take an empty queue from the pool (or a new one if the pool is empty).
+  std::vector<QueueFrameType> AcquireQueue();
+  //! Return a queue to the pool; it is cleared, but keeps its memory.
+  void ReleaseQueue(std::vector<QueueFrameType>& queue);
 };
 
 } // namespace tree
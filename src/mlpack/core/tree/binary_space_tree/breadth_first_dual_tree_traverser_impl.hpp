@@ -17,6 +17,8 @@
 // In case it hasn't been included yet.
 #include "breadth_first_dual_tree_traverser.hpp"
 
+#include <algorithm>
+
 namespace mlpack {
 namespace tree {
 
@@ -73,7 +75,7 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   if (rootScore == DBL_MAX)
     return; // This probably means something is wrong.
 
-  std::priority_queue<QueueFrameType> queue;
+  std::vector<QueueFrameType> queue = AcquireQueue();
 
   QueueFrameType rootFrame;
   rootFrame.queryNode = &queryRoot;
@@ -82,10 +84,11 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   rootFrame.score = 0.0;
   rootFrame.traversalInfo = rule.TraversalInfo();
 
-  queue.push(rootFrame);
+  queue.push_back(rootFrame);
 
   // Start the traversal.
   Traverse(queryRoot, queue);
+  ReleaseQueue(queue);
 }
 
 template<typename MetricType,
@@ -99,17 +102,19 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 BreadthFirstDualTreeTraverser<RuleType>::Traverse(
     BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
         queryNode,
-    std::priority_queue<QueueFrameType>& referenceQueue)
+    std::vector<QueueFrameType>& referenceQueue)
 {
   // Store queues for the children.  We will recurse into the children once our
-  // queue is empty.
-  std::priority_queue<QueueFrameType> leftChildQueue;
-  std::priority_queue<QueueFrameType> rightChildQueue;
+  // queue is empty.  The queues are heaps, ordered like a std::priority_queue,
+  // and come from the pool so that each level does not allocate.
+  std::vector<QueueFrameType> leftChildQueue = AcquireQueue();
+  std::vector<QueueFrameType> rightChildQueue = AcquireQueue();
 
   while (!referenceQueue.empty())
   {
-    QueueFrameType currentFrame = referenceQueue.top();
-    referenceQueue.pop();
+    std::pop_heap(referenceQueue.begin(), referenceQueue.end());
+    QueueFrameType currentFrame = referenceQueue.back();
+    referenceQueue.pop_back();
 
     BinarySpaceTree& queryNode = *currentFrame.queryNode;
     BinarySpaceTree& referenceNode = *currentFrame.referenceNode;
@@ -153,11 +158,13 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
       // We have to recurse down the query node.
       QueueFrameType fl = { queryNode.Left(), &referenceNode, queryDepth + 1,
           score, rule.TraversalInfo() };
-      leftChildQueue.push(fl);
+      leftChildQueue.push_back(fl);
+      std::push_heap(leftChildQueue.begin(), leftChildQueue.end());
 
       QueueFrameType fr = { queryNode.Right(), &referenceNode, queryDepth + 1,
           score, ti };
-      rightChildQueue.push(fr);
+      rightChildQueue.push_back(fr);
+      std::push_heap(rightChildQueue.begin(), rightChildQueue.end());
     }
     else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
     {
@@ -166,11 +173,13 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
       // traversal information correctly.
       QueueFrameType fl = { &queryNode, referenceNode.Left(), queryDepth,
           score, rule.TraversalInfo() };
-      referenceQueue.push(fl);
+      referenceQueue.push_back(fl);
+      std::push_heap(referenceQueue.begin(), referenceQueue.end());
 
       QueueFrameType fr = { &queryNode, referenceNode.Right(), queryDepth,
           score, ti };
-      referenceQueue.push(fr);
+      referenceQueue.push_back(fr);
+      std::push_heap(referenceQueue.begin(), referenceQueue.end());
     }
     else
     {
@@ -180,19 +189,23 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
       // correctly.
       QueueFrameType fll = { queryNode.Left(), referenceNode.Left(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      leftChildQueue.push(fll);
+      leftChildQueue.push_back(fll);
+      std::push_heap(leftChildQueue.begin(), leftChildQueue.end());
 
       QueueFrameType flr = { queryNode.Left(), referenceNode.Right(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      leftChildQueue.push(flr);
+      leftChildQueue.push_back(flr);
+      std::push_heap(leftChildQueue.begin(), leftChildQueue.end());
 
       QueueFrameType frl = { queryNode.Right(), referenceNode.Left(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      rightChildQueue.push(frl);
+      rightChildQueue.push_back(frl);
+      std::push_heap(rightChildQueue.begin(), rightChildQueue.end());
 
       QueueFrameType frr = { queryNode.Right(), referenceNode.Right(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      rightChildQueue.push(frr);
+      rightChildQueue.push_back(frr);
+      std::push_heap(rightChildQueue.begin(), rightChildQueue.end());
     }
   }
 
@@ -202,6 +215,45 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
     Traverse(*queryNode.Left(), leftChildQueue);
   if (rightChildQueue.size() > 0)
     Traverse(*queryNode.Right(), rightChildQueue);
+
+  ReleaseQueue(leftChildQueue);
+  ReleaseQueue(rightChildQueue);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+std::vector<typename BinarySpaceTree<MetricType, StatisticType, MatType,
+    BoundType, SplitType>::template BreadthFirstDualTreeTraverser<RuleType>::
+    QueueFrameType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BreadthFirstDualTreeTraverser<RuleType>::AcquireQueue()
+{
+  if (queuePool.empty())
+    return std::vector<QueueFrameType>();
+
+  std::vector<QueueFrameType> queue(std::move(queuePool.back()));
+  queuePool.pop_back();
+  return queue;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BreadthFirstDualTreeTraverser<RuleType>::ReleaseQueue(
+    std::vector<QueueFrameType>& queue)
+{
+  queue.clear();
+  queuePool.push_back(std::move(queue));
 }
 
 } // namespace tree
@@ -17,6 +17,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/core/tree/has_block_base_case.hpp>
 #include "binary_space_tree.hpp"
 
 namespace mlpack {
@@ -87,6 +88,29 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! The query points of the current leaf that could not be pruned, held in
+  //! the class so that it isn't continually being reallocated.
+  std::vector<size_t> leafQueries;
+
+  /**
+   * Compute the base cases between two leaves, one pair of points at a time.
+   */
+  template<typename Rule = RuleType>
+  void LeafBaseCases(
+      BinarySpaceTree& queryNode,
+      BinarySpaceTree& referenceNode,
+      const typename std::enable_if_t<!HasBlockBaseCase<Rule>::value>* = 0);
+
+  /**
+   * Compute the base cases between two leaves with a single call to
+   * BlockBaseCase() for all of the query points that can't be pruned.
+   */
+  template<typename Rule = RuleType>
+  void LeafBaseCases(
+      BinarySpaceTree& queryNode,
+      BinarySpaceTree& referenceNode,
+      const typename std::enable_if_t<HasBlockBaseCase<Rule>::value>* = 0);
 };
 
 } // namespace tree
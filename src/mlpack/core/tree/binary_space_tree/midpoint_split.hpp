@@ -17,6 +17,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/perform_split.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -119,6 +120,17 @@ class MidpointSplit
   }
 };
 
+/**
+ * The MidpointSplit only depends on the points of the node, so the children of a node
+ * can be built concurrently.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MidpointSplit<BoundType, MatType> >
+{
+ public:
+  static const bool ConcurrentChildren = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
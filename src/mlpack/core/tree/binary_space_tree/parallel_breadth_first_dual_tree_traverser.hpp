@@ -0,0 +1,136 @@
+/**
+ * @file parallel_breadth_first_dual_tree_traverser.hpp
+ *
+ * Defines the ParallelBreadthFirstDualTreeTraverser for the BinarySpaceTree
+ * tree type.  This is a nested class of BinarySpaceTree which traverses two
+ * trees in a breadth-first manner, like the BreadthFirstDualTreeTraverser, but
+ * expands all query nodes of one level of the query tree in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "binary_space_tree.hpp"
+#include "breadth_first_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A level-synchronous breadth-first dual-tree traverser.  The frontier holds
+ * the node combinations of one level of the query tree; all frames of a query
+ * node are expanded by the same thread (in the order of their scores, as the
+ * BreadthFirstDualTreeTraverser does), the query nodes of the level are
+ * expanded in parallel, and the frames of their children are collected into
+ * per-thread buffers that form the next frontier.
+ *
+ * The query nodes are handed out in chunks, and every chunk works with its own
+ * copy of the rules, so the RuleType has to be copy constructible, and copies
+ * of the rules have to share the results of the search.  The chunks of one
+ * level handle disjoint query nodes, and so disjoint query points: the rules
+ * may update the statistics of the query node they score and the results of
+ * its points without locking, but any other state they write to has to be
+ * kept per OpenMP thread (as DTBRules does).  The number of base cases and
+ * scores of the copies is added to the given rules after every level.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                      SplitType>::ParallelBreadthFirstDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the dual-tree traverser with the given rule set.
+   */
+  ParallelBreadthFirstDualTreeTraverser(RuleType& rule);
+
+  typedef QueueFrame<BinarySpaceTree, typename RuleType::TraversalInfoType>
+      QueueFrameType;
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(BinarySpaceTree& queryNode,
+                BinarySpaceTree& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+ private:
+  /**
+   * Expand the frames of one query node: the combinations with the reference
+   * children of a query leaf are expanded right away, and the combinations
+   * with the query children are added to the next frontier.
+   *
+   * @param frontier The current frontier.
+   * @param begin The first frame of the query node in the frontier.
+   * @param end One past the last frame of the query node in the frontier.
+   * @param nextFrontier The frontier of the next level.
+   */
+  void Expand(const std::vector<QueueFrameType>& frontier,
+              const size_t begin,
+              const size_t end,
+              std::vector<QueueFrameType>& nextFrontier);
+
+  //! Add the counters of the given traverser, and of its rules, to the
+  //! counters of this traverser and its rules.
+  void Merge(const ParallelBreadthFirstDualTreeTraverser& traverser);
+
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+
+  //! The heap of frames of the query node being expanded, held in the class
+  //! so that it isn't continually being reallocated.
+  std::vector<QueueFrameType> queue;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_breadth_first_dual_tree_traverser_impl.hpp"
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_HPP
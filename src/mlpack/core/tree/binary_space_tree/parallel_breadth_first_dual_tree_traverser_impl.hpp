@@ -0,0 +1,247 @@
+/**
+ * @file parallel_breadth_first_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelBreadthFirstDualTreeTraverser for
+ * BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_breadth_first_dual_tree_traverser.hpp"
+
+#include <algorithm>
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelBreadthFirstDualTreeTraverser<RuleType>::
+ParallelBreadthFirstDualTreeTraverser(RuleType& rule) :
+    rule(rule),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelBreadthFirstDualTreeTraverser<RuleType>::Traverse(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryRoot,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceRoot)
+{
+  // Increment the visit counter.
+  ++numVisited;
+
+  // Must score the root combination.
+  const double rootScore = rule.Score(queryRoot, referenceRoot);
+  if (rootScore == DBL_MAX)
+    return; // This probably means something is wrong.
+
+  QueueFrameType rootFrame;
+  rootFrame.queryNode = &queryRoot;
+  rootFrame.referenceNode = &referenceRoot;
+  rootFrame.queryDepth = 0;
+  rootFrame.score = 0.0;
+  rootFrame.traversalInfo = rule.TraversalInfo();
+
+  std::vector<QueueFrameType> frontier(1, rootFrame);
+  while (!frontier.empty())
+  {
+    // Gather the frames of every query node.  The query nodes of one level are
+    // disjoint, so they can be told apart by their first point.
+    std::stable_sort(frontier.begin(), frontier.end(),
+        [](const QueueFrameType& a, const QueueFrameType& b)
+        { return a.queryNode->Begin() < b.queryNode->Begin(); });
+
+    std::vector<size_t> groupBegins;
+    for (size_t i = 0; i < frontier.size(); ++i)
+      if (i == 0 || frontier[i].queryNode != frontier[i - 1].queryNode)
+        groupBegins.push_back(i);
+    groupBegins.push_back(frontier.size());
+    const size_t groups = groupBegins.size() - 1;
+
+    // The query nodes are handed out in a few chunks per thread, to balance
+    // the load.  Every chunk has its own rules and its own buffer for the next
+    // frontier.
+    const size_t chunks = std::min(groups, 4 * Threads::Count());
+    std::vector<RuleType> chunkRules(chunks, rule);
+    std::vector<ParallelBreadthFirstDualTreeTraverser> chunkTraversers;
+    chunkTraversers.reserve(chunks);
+    for (size_t c = 0; c < chunks; ++c)
+    {
+      chunkRules[c].BaseCases() = 0;
+      chunkRules[c].Scores() = 0;
+      chunkTraversers.emplace_back(chunkRules[c]);
+    }
+
+    std::vector<std::vector<QueueFrameType>> nextFrontiers(chunks);
+    Threads::ParallelFor(0, chunks, [&](const size_t c)
+    {
+      const size_t firstGroup = c * groups / chunks;
+      const size_t lastGroup = (c + 1) * groups / chunks;
+      for (size_t g = firstGroup; g < lastGroup; ++g)
+      {
+        chunkTraversers[c].Expand(frontier, groupBegins[g],
+            groupBegins[g + 1], nextFrontiers[c]);
+      }
+    });
+
+    frontier.clear();
+    for (size_t c = 0; c < chunks; ++c)
+    {
+      Merge(chunkTraversers[c]);
+      frontier.insert(frontier.end(), nextFrontiers[c].begin(),
+          nextFrontiers[c].end());
+    }
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelBreadthFirstDualTreeTraverser<RuleType>::Expand(
+    const std::vector<QueueFrameType>& frontier,
+    const size_t begin,
+    const size_t end,
+    std::vector<QueueFrameType>& nextFrontier)
+{
+  // The frames of the query node are visited in the order of their scores.
+  queue.assign(frontier.begin() + begin, frontier.begin() + end);
+  std::make_heap(queue.begin(), queue.end());
+
+  while (!queue.empty())
+  {
+    std::pop_heap(queue.begin(), queue.end());
+    QueueFrameType currentFrame = queue.back();
+    queue.pop_back();
+
+    BinarySpaceTree& queryNode = *currentFrame.queryNode;
+    BinarySpaceTree& referenceNode = *currentFrame.referenceNode;
+    typename RuleType::TraversalInfoType ti = currentFrame.traversalInfo;
+    rule.TraversalInfo() = ti;
+    const size_t queryDepth = currentFrame.queryDepth;
+
+    double score = rule.Score(queryNode, referenceNode);
+    ++numScores;
+
+    if (score == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    // If both are leaves, we must evaluate the base case.
+    if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+    {
+      // Loop through each of the points in each node.
+      const size_t queryEnd = queryNode.Begin() + queryNode.Count();
+      const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+      for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+      {
+        for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+          rule.BaseCase(query, ref);
+
+        numBaseCases += referenceNode.Count();
+      }
+    }
+    else if ((!queryNode.IsLeaf()) && referenceNode.IsLeaf())
+    {
+      // We have to recurse down the query node; that happens on the next
+      // level.
+      QueueFrameType fl = { queryNode.Left(), &referenceNode, queryDepth + 1,
+          score, rule.TraversalInfo() };
+      nextFrontier.push_back(fl);
+
+      QueueFrameType fr = { queryNode.Right(), &referenceNode, queryDepth + 1,
+          score, ti };
+      nextFrontier.push_back(fr);
+    }
+    else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
+    {
+      // We have to recurse down the reference node.  In this case the recursion
+      // order does matter.  Before recursing, though, we have to set the
+      // traversal information correctly.
+      QueueFrameType fl = { &queryNode, referenceNode.Left(), queryDepth,
+          score, rule.TraversalInfo() };
+      queue.push_back(fl);
+      std::push_heap(queue.begin(), queue.end());
+
+      QueueFrameType fr = { &queryNode, referenceNode.Right(), queryDepth,
+          score, ti };
+      queue.push_back(fr);
+      std::push_heap(queue.begin(), queue.end());
+    }
+    else
+    {
+      // We have to recurse down both query and reference nodes; that happens
+      // on the next level.
+      QueueFrameType fll = { queryNode.Left(), referenceNode.Left(),
+          queryDepth + 1, score, rule.TraversalInfo() };
+      nextFrontier.push_back(fll);
+
+      QueueFrameType flr = { queryNode.Left(), referenceNode.Right(),
+          queryDepth + 1, score, rule.TraversalInfo() };
+      nextFrontier.push_back(flr);
+
+      QueueFrameType frl = { queryNode.Right(), referenceNode.Left(),
+          queryDepth + 1, score, rule.TraversalInfo() };
+      nextFrontier.push_back(frl);
+
+      QueueFrameType frr = { queryNode.Right(), referenceNode.Right(),
+          queryDepth + 1, score, rule.TraversalInfo() };
+      nextFrontier.push_back(frr);
+    }
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelBreadthFirstDualTreeTraverser<RuleType>::Merge(
+    const ParallelBreadthFirstDualTreeTraverser& traverser)
+{
+  numPrunes += traverser.NumPrunes();
+  numVisited += traverser.NumVisited();
+  numScores += traverser.NumScores();
+  numBaseCases += traverser.NumBaseCases();
+
+  rule.BaseCases() += traverser.rule.BaseCases();
+  rule.Scores() += traverser.rule.Scores();
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_IMPL_HPP
@@ -0,0 +1,155 @@
+/**
+ * @file parallel_dual_tree_traverser.hpp
+ *
+ * Defines the ParallelDualTreeTraverser for the BinarySpaceTree tree type.
+ * This is a nested class of BinarySpaceTree which traverses two trees in a
+ * depth-first manner, like the DualTreeTraverser, but traverses the children
+ * of query nodes near the root of the query tree in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "binary_space_tree.hpp"
+#include "dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A dual-tree traverser that recurses into the two children of a query node as
+ * two OpenMP tasks, down to the given depth of the query tree; below that depth
+ * (and when the query node is a leaf) the DualTreeTraverser is used.  The
+ * OpenMP runtime distributes the tasks over the threads of its pool.
+ *
+ * Every task works with its own copy of the rules, so the RuleType has to be
+ * copy constructible, and copies of the rules have to share the results of the
+ * search; since different tasks handle disjoint sets of query points, no
+ * locking is necessary.  The number of base cases and scores of the copies is
+ * added to the given rules once the tasks are done.  Without OpenMP (or with
+ * an OpenMP version that doesn't support tasks) the traversal is serial.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                      SplitType>::ParallelDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the dual-tree traverser with the given rule set.
+   *
+   * @param rule The rules with which the trees will be traversed.
+   * @param taskDepth Number of levels of the query tree for which the query
+   *     children are traversed in parallel.
+   */
+  ParallelDualTreeTraverser(RuleType& rule, const size_t taskDepth = 8);
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(BinarySpaceTree& queryNode,
+                BinarySpaceTree& referenceNode);
+
+  //! Get the number of levels of the query tree that are traversed in
+  //! parallel.
+  size_t TaskDepth() const { return taskDepth; }
+  //! Modify the number of levels of the query tree that are traversed in
+  //! parallel.
+  size_t& TaskDepth() { return taskDepth; }
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+ private:
+  //! The traversal information type of the rules.
+  typedef typename RuleType::TraversalInfoType TraversalInfoType;
+
+  /**
+   * Traverse the two trees, spawning tasks for the query children if the
+   * task depth hasn't been reached yet.  This has to be called from within a
+   * parallel region.
+   */
+  void TraverseTasks(BinarySpaceTree& queryNode,
+                     BinarySpaceTree& referenceNode);
+
+  /**
+   * Traverse one child of a query node, with the traversal information of the
+   * query node.  If splitQuery is true, the reference node is kept; otherwise
+   * the reference node is split as well.
+   */
+  void TraverseQueryChild(BinarySpaceTree& queryChild,
+                          BinarySpaceTree& referenceNode,
+                          const bool splitQuery,
+                          const TraversalInfoType& traversalInfo);
+
+  /**
+   * Score the query node with both children of the reference node, and
+   * recurse into them in the order given by their scores.
+   */
+  void TraverseReferenceChildren(BinarySpaceTree& queryNode,
+                                 BinarySpaceTree& referenceNode);
+
+  /**
+   * Add the counters of the given traverser, and of its rules, to the counters
+   * of this traverser and its rules.
+   */
+  template<typename TraverserType>
+  void Merge(const TraverserType& traverser, const RuleType& traverserRule);
+
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The number of levels of the query tree that are traversed in parallel.
+  size_t taskDepth;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traverser_impl.hpp"
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
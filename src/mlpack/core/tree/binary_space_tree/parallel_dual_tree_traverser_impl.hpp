@@ -0,0 +1,268 @@
+/**
+ * @file parallel_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelDualTreeTraverser for BinarySpaceTree.  The
+ * trees must be the same type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::
+ParallelDualTreeTraverser(RuleType& rule, const size_t taskDepth) :
+    rule(rule),
+    taskDepth(taskDepth),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::Traverse(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryNode,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+#ifdef MLPACK_BINARY_SPACE_TREE_USE_TASKS
+  // The tasks need a team of threads to run on.
+  if (!omp_in_parallel())
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      TraverseTasks(queryNode, referenceNode);
+    }
+
+    return;
+  }
+#endif
+
+  TraverseTasks(queryNode, referenceNode);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::TraverseTasks(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryNode,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+  // Below the task depth, and for query leaves, nothing is left to
+  // parallelize.
+  if (taskDepth == 0 || queryNode.IsLeaf())
+  {
+    DualTreeTraverser<RuleType> traverser(rule);
+    traverser.Traverse(queryNode, referenceNode);
+    Merge(traverser, rule);
+    return;
+  }
+
+  // Increment the visit counter.
+  ++numVisited;
+
+  // Store the current traversal info.
+  const TraversalInfoType traversalInfo = rule.TraversalInfo();
+
+  // This is the same choice the DualTreeTraverser makes: either only the query
+  // node is split, or both nodes are.
+  const bool splitQuery = referenceNode.IsLeaf() ||
+      (queryNode.NumDescendants() > 3 * referenceNode.NumDescendants());
+
+  // Every query child is traversed with its own copy of the rules.
+  RuleType leftRule(rule);
+  RuleType rightRule(rule);
+  leftRule.BaseCases() = rightRule.BaseCases() = 0;
+  leftRule.Scores() = rightRule.Scores() = 0;
+
+  ParallelDualTreeTraverser leftTraverser(leftRule, taskDepth - 1);
+  ParallelDualTreeTraverser rightTraverser(rightRule, taskDepth - 1);
+
+  BinarySpaceTree* leftChild = queryNode.Left();
+  BinarySpaceTree* rightChild = queryNode.Right();
+  BinarySpaceTree* reference = &referenceNode;
+
+#ifdef MLPACK_BINARY_SPACE_TREE_USE_TASKS
+  #pragma omp task shared(leftTraverser, traversalInfo)
+#endif
+  leftTraverser.TraverseQueryChild(*leftChild, *reference, splitQuery,
+      traversalInfo);
+
+#ifdef MLPACK_BINARY_SPACE_TREE_USE_TASKS
+  #pragma omp task shared(rightTraverser, traversalInfo)
+#endif
+  rightTraverser.TraverseQueryChild(*rightChild, *reference, splitQuery,
+      traversalInfo);
+
+#ifdef MLPACK_BINARY_SPACE_TREE_USE_TASKS
+  #pragma omp taskwait
+#endif
+
+  Merge(leftTraverser, leftRule);
+  Merge(rightTraverser, rightRule);
+
+  // Restore the main traversal information.
+  rule.TraversalInfo() = traversalInfo;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::TraverseQueryChild(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryChild,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode,
+    const bool splitQuery,
+    const TraversalInfoType& traversalInfo)
+{
+  rule.TraversalInfo() = traversalInfo;
+
+  if (splitQuery)
+  {
+    const double score = rule.Score(queryChild, referenceNode);
+    ++numScores;
+
+    if (score != DBL_MAX)
+      TraverseTasks(queryChild, referenceNode);
+    else
+      ++numPrunes;
+  }
+  else
+  {
+    TraverseReferenceChildren(queryChild, referenceNode);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::TraverseReferenceChildren(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryNode,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceNode)
+{
+  // The recursion order does matter here.  Before recursing, we have to set
+  // the traversal information correctly.
+  const TraversalInfoType traversalInfo = rule.TraversalInfo();
+  double leftScore = rule.Score(queryNode, *referenceNode.Left());
+  const TraversalInfoType leftInfo = rule.TraversalInfo();
+  rule.TraversalInfo() = traversalInfo;
+  double rightScore = rule.Score(queryNode, *referenceNode.Right());
+  const TraversalInfoType rightInfo = rule.TraversalInfo();
+  numScores += 2;
+
+  if (leftScore == DBL_MAX && rightScore == DBL_MAX)
+  {
+    numPrunes += 2;
+  }
+  else if (leftScore <= rightScore)
+  {
+    // Recurse to the left first.
+    rule.TraversalInfo() = leftInfo;
+    TraverseTasks(queryNode, *referenceNode.Left());
+
+    // Is it still valid to recurse to the right?
+    rightScore = rule.Rescore(queryNode, *referenceNode.Right(), rightScore);
+
+    if (rightScore != DBL_MAX)
+    {
+      rule.TraversalInfo() = rightInfo;
+      TraverseTasks(queryNode, *referenceNode.Right());
+    }
+    else
+      ++numPrunes;
+  }
+  else
+  {
+    // Recurse to the right first.
+    TraverseTasks(queryNode, *referenceNode.Right());
+
+    // Is it still valid to recurse to the left?
+    leftScore = rule.Rescore(queryNode, *referenceNode.Left(), leftScore);
+
+    if (leftScore != DBL_MAX)
+    {
+      rule.TraversalInfo() = leftInfo;
+      TraverseTasks(queryNode, *referenceNode.Left());
+    }
+    else
+      ++numPrunes;
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+template<typename TraverserType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelDualTreeTraverser<RuleType>::Merge(
+    const TraverserType& traverser,
+    const RuleType& traverserRule)
+{
+  numPrunes += traverser.NumPrunes();
+  numVisited += traverser.NumVisited();
+  numScores += traverser.NumScores();
+  numBaseCases += traverser.NumBaseCases();
+
+  // The serial traverser works on our own rules, whose counters are up to date
+  // already.
+  if (&traverserRule != &rule)
+  {
+    rule.BaseCases() += traverserRule.BaseCases();
+    rule.Scores() += traverserRule.Scores();
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
@@ -0,0 +1,39 @@
+/**
+ * @file split_traits.hpp
+ *
+ * Definition of the SplitTraits class, which provides compile-time
+ * information about the split types of the BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SplitTraits class describes a split type of the BinarySpaceTree.  A split
+ * type that wants to change one of the defaults should specialize this class.
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * If true, splitting a node only depends on (and only modifies) the points
+   * of that node, and doesn't use the state of the splitter or random numbers.
+   * Then the two children of a node can be built concurrently, and the
+   * resulting tree (and the point permutation) doesn't depend on the order in
+   * which the children are built.
+   */
+  static const bool ConcurrentChildren = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file bound_distance.hpp
+ *
+ * Per-dimension kernels shared by the distance computations of the
+ * rectangular bounds (HRectBound and CellBound).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BOUND_DISTANCE_HPP
+#define MLPACK_CORE_TREE_BOUND_DISTANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace bound {
+
+/**
+ * The distance between two intervals [lo, hi] and [otherLo, otherHi] along one
+ * dimension, and the way the distances along all dimensions are combined by an
+ * LMetric.  A point is the interval [p, p].
+ *
+ * Everything here is branch-free (std::max() and std::fabs() compile to
+ * min/max and mask instructions), and the if statements on the metric are
+ * resolved at compile time, so the loops over the dimensions that use these
+ * functions can be vectorized by the compiler.
+ *
+ * @tparam MetricType The LMetric of the bound.
+ * @tparam ElemType The element type of the bound.
+ */
+template<typename MetricType, typename ElemType>
+struct BoundDistance
+{
+  //! Get the smallest distance between the two intervals (0 if they overlap).
+  static ElemType MinGap(const ElemType lo,
+                         const ElemType hi,
+                         const ElemType otherLo,
+                         const ElemType otherHi)
+  {
+    return std::max(std::max(otherLo - hi, lo - otherHi), ElemType(0));
+  }
+
+  //! Get the largest distance between the two intervals.
+  static ElemType MaxGap(const ElemType lo,
+                         const ElemType hi,
+                         const ElemType otherLo,
+                         const ElemType otherHi)
+  {
+    return std::max(std::fabs(otherHi - lo), std::fabs(hi - otherLo));
+  }
+
+  //! Raise the nonnegative distance along one dimension to the power of the
+  //! metric.
+  static ElemType Pow(const ElemType v)
+  {
+    // The compiler should optimize out this if statement entirely.
+    if (MetricType::Power == 1)
+      return v;
+    else if (MetricType::Power == 2)
+      return v * v;
+    else
+      return std::pow(v, (ElemType) MetricType::Power);
+  }
+
+  //! Turn the sum of the powers of the distances along every dimension into
+  //! the distance.
+  static ElemType Root(const ElemType sum)
+  {
+    // The compiler should optimize out this if statement entirely.
+    if (!MetricType::TakeRoot || MetricType::Power == 1)
+      return sum;
+    else if (MetricType::Power == 2)
+      return (ElemType) std::sqrt(sum);
+    else
+      return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
+  }
+};
+
+} // namespace bound
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_BOUND_DISTANCE_HPP
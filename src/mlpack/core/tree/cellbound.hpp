@@ -38,6 +38,7 @@
 #include <mlpack/core/math/range.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include "bound_traits.hpp"
+#include "bound_distance.hpp"
 #include "address.hpp"
 
 namespace mlpack {
@@ -244,6 +245,9 @@ class CellBound
   void serialize(Archive& ar, const unsigned int version);
 
  private:
+  //! The per-dimension distance kernels.
+  typedef BoundDistance<MetricType, ElemType> Distance;
+
   //! The precision of the tree element type.
   static constexpr size_t order = sizeof(AddressElemType) * CHAR_BIT;
   //! Maximum number of subrectangles.
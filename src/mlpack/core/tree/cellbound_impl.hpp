@@ -465,7 +465,7 @@ void CellBound<MetricType, ElemType>::UpdateAddressBounds(const MatType& data)
 }
 
 /**
- * Calculates minimum bound-to-point squared distance.
+ * Calculates minimum bound-to-point distance.
  */
 template<typename MetricType, typename ElemType>
 template<typename VecType>
@@ -475,69 +475,29 @@ inline ElemType CellBound<MetricType, ElemType>::MinDistance(
 {
   Log::Assert(point.n_elem == dim);
 
+  // Every subrectangle is one contiguous column of loBound and hiBound; the
+  // loop over the dimensions has no branches, so that it can be vectorized.
   ElemType minSum = std::numeric_limits<ElemType>::max();
-
-  ElemType lower, higher;
-
   for (size_t i = 0; i < numBounds; i++)
   {
-    ElemType sum = 0;
+    const ElemType* lo = loBound.colptr(i);
+    const ElemType* hi = hiBound.colptr(i);
 
+    ElemType sum = 0;
     for (size_t d = 0; d < dim; d++)
     {
-      lower = loBound(d, i) - point[d];
-      higher = point[d] - hiBound(d, i);
-
-      // Since only one of 'lower' or 'higher' is negative, if we add
-      // each's absolute value to itself and then sum those two, our
-      // result is the non negative half of the equation times two;
-      // then we raise to power Power.
-      if (MetricType::Power == 1)
-        sum += lower + std::fabs(lower) + higher + std::fabs(higher);
-      else if (MetricType::Power == 2)
-      {
-        ElemType dist = lower + std::fabs(lower) + higher + std::fabs(higher);
-        sum += dist * dist;
-      }
-      else
-      {
-        sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-            (ElemType) MetricType::Power);
-      }
-
-      if (sum >= minSum)
-        break;
+      const ElemType p = point[d];
+      sum += Distance::Pow(Distance::MinGap(lo[d], hi[d], p, p));
     }
 
-    if (sum < minSum)
-      minSum = sum;
+    minSum = std::min(minSum, sum);
   }
 
-  // Now take the Power'th root (but make sure our result is squared if it needs
-  // to be); then cancel out the constant of 2 (which may have been squared now)
-  // that was introduced earlier.  The compiler should optimize out the if
-  // statement entirely.
-  if (MetricType::Power == 1)
-    return minSum * 0.5;
-  else if (MetricType::Power == 2)
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) std::sqrt(minSum) * 0.5;
-    else
-      return minSum * 0.25;
-  }
-  else
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) pow((double) minSum,
-          1.0 / (double) MetricType::Power) / 2.0;
-    else
-      return minSum / pow(2.0, MetricType::Power);
-  }
+  return Distance::Root(minSum);
 }
 
 /**
- * Calculates minimum bound-to-bound squared distance.
+ * Calculates minimum bound-to-bound distance.
  */
 template<typename MetricType, typename ElemType>
 ElemType CellBound<MetricType, ElemType>::MinDistance(const CellBound& other)
@@ -546,65 +506,32 @@ ElemType CellBound<MetricType, ElemType>::MinDistance(const CellBound& other)
   Log::Assert(dim == other.dim);
 
   ElemType minSum = std::numeric_limits<ElemType>::max();
-
-  ElemType lower, higher;
-
   for (size_t i = 0; i < numBounds; i++)
+  {
+    const ElemType* lo = loBound.colptr(i);
+    const ElemType* hi = hiBound.colptr(i);
+
     for (size_t j = 0; j < other.numBounds; j++)
     {
+      const ElemType* otherLo = other.loBound.colptr(j);
+      const ElemType* otherHi = other.hiBound.colptr(j);
+
       ElemType sum = 0;
       for (size_t d = 0; d < dim; d++)
       {
-        lower = other.loBound(d, j) - hiBound(d, i);
-        higher = loBound(d, i) - other.hiBound(d, j);
-        // We invoke the following:
-        //   x + fabs(x) = max(x * 2, 0)
-        //   (x * 2)^2 / 4 = x^2
-
-        // The compiler should optimize out this if statement entirely.
-        if (MetricType::Power == 1)
-          sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-        else if (MetricType::Power == 2)
-        {
-          ElemType dist = lower + std::fabs(lower) + higher + std::fabs(higher);
-          sum += dist * dist;
-        }
-        else
-        {
-          sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-              (ElemType) MetricType::Power);
-        }
-
-        if (sum >= minSum)
-          break;
+        sum += Distance::Pow(Distance::MinGap(lo[d], hi[d], otherLo[d],
+            otherHi[d]));
       }
 
-      if (sum < minSum)
-        minSum = sum;
+      minSum = std::min(minSum, sum);
     }
-
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::Power == 1)
-    return minSum * 0.5;
-  else if (MetricType::Power == 2)
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) std::sqrt(minSum) * 0.5;
-    else
-      return minSum * 0.25;
-  }
-  else
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) pow((double) minSum,
-          1.0 / (double) MetricType::Power) / 2.0;
-    else
-      return minSum / pow(2.0, MetricType::Power);
   }
+
+  return Distance::Root(minSum);
 }
 
 /**
- * Calculates maximum bound-to-point squared distance.
+ * Calculates maximum bound-to-point distance.
  */
 template<typename MetricType, typename ElemType>
 template<typename VecType>
@@ -612,42 +539,25 @@ inline ElemType CellBound<MetricType, ElemType>::MaxDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType maxSum = std::numeric_limits<ElemType>::lowest();
-
   Log::Assert(point.n_elem == dim);
 
+  ElemType maxSum = std::numeric_limits<ElemType>::lowest();
   for (size_t i = 0; i < numBounds; i++)
   {
+    const ElemType* lo = loBound.colptr(i);
+    const ElemType* hi = hiBound.colptr(i);
+
     ElemType sum = 0;
     for (size_t d = 0; d < dim; d++)
     {
-      ElemType v = std::max(fabs(point[d] - loBound(d, i)),
-          fabs(hiBound(d, i) - point[d]));
-
-      if (MetricType::Power == 1)
-        sum += v; // v is non-negative.
-      else if (MetricType::Power == 2)
-        sum += v * v;
-      else
-        sum += std::pow(v, (ElemType) MetricType::Power);
+      const ElemType p = point[d];
+      sum += Distance::Pow(Distance::MaxGap(lo[d], hi[d], p, p));
     }
 
-    if (sum > maxSum)
-      maxSum = sum;
+    maxSum = std::max(maxSum, sum);
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return maxSum;
-    else if (MetricType::Power == 2)
-      return (ElemType) std::sqrt(maxSum);
-    else
-      return (ElemType) pow((double) maxSum, 1.0 / (double) MetricType::Power);
-  }
-  else
-    return maxSum;
+  return Distance::Root(maxSum);
 }
 
 /**
@@ -658,127 +568,76 @@ inline ElemType CellBound<MetricType, ElemType>::MaxDistance(
     const CellBound& other)
     const
 {
-  ElemType maxSum = std::numeric_limits<ElemType>::lowest();
-
   Log::Assert(dim == other.dim);
 
-  ElemType v;
+  ElemType maxSum = std::numeric_limits<ElemType>::lowest();
   for (size_t i = 0; i < numBounds; i++)
+  {
+    const ElemType* lo = loBound.colptr(i);
+    const ElemType* hi = hiBound.colptr(i);
+
     for (size_t j = 0; j < other.numBounds; j++)
     {
+      const ElemType* otherLo = other.loBound.colptr(j);
+      const ElemType* otherHi = other.hiBound.colptr(j);
+
       ElemType sum = 0;
       for (size_t d = 0; d < dim; d++)
       {
-        v = std::max(fabs(other.hiBound(d, j) - loBound(d, i)),
-            fabs(hiBound(d, i) - other.loBound(d, j)));
-
-        // The compiler should optimize out this if statement entirely.
-        if (MetricType::Power == 1)
-          sum += v; // v is non-negative.
-        else if (MetricType::Power == 2)
-          sum += v * v;
-        else
-          sum += std::pow(v, (ElemType) MetricType::Power);
+        sum += Distance::Pow(Distance::MaxGap(lo[d], hi[d], otherLo[d],
+            otherHi[d]));
       }
 
-      if (sum > maxSum)
-        maxSum = sum;
+      maxSum = std::max(maxSum, sum);
     }
-
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return maxSum;
-    else if (MetricType::Power == 2)
-      return (ElemType) std::sqrt(maxSum);
-    else
-      return (ElemType) pow((double) maxSum, 1.0 / (double) MetricType::Power);
   }
-  else
-    return maxSum;
+
+  return Distance::Root(maxSum);
 }
 
 /**
- * Calculates minimum and maximum bound-to-bound squared distance.
+ * Calculates minimum and maximum bound-to-bound distance.
  */
 template<typename MetricType, typename ElemType>
 inline math::RangeType<ElemType>
 CellBound<MetricType, ElemType>::RangeDistance(
     const CellBound& other) const
 {
-  ElemType minLoSum = std::numeric_limits<ElemType>::max();
-  ElemType maxHiSum = std::numeric_limits<ElemType>::lowest();
-
   Log::Assert(dim == other.dim);
 
-  ElemType v1, v2, vLo, vHi;
-
+  ElemType minLoSum = std::numeric_limits<ElemType>::max();
+  ElemType maxHiSum = std::numeric_limits<ElemType>::lowest();
   for (size_t i = 0; i < numBounds; i++)
+  {
+    const ElemType* lo = loBound.colptr(i);
+    const ElemType* hi = hiBound.colptr(i);
+
     for (size_t j = 0; j < other.numBounds; j++)
     {
+      const ElemType* otherLo = other.loBound.colptr(j);
+      const ElemType* otherHi = other.hiBound.colptr(j);
+
       ElemType loSum = 0;
       ElemType hiSum = 0;
       for (size_t d = 0; d < dim; d++)
       {
-        v1 = other.loBound(d, j) - hiBound(d, i);
-        v2 = loBound(d, i) - other.hiBound(d, j);
-        // One of v1 or v2 is negative.
-        if (v1 >= v2)
-        {
-          vHi = -v2; // Make it nonnegative.
-          vLo = (v1 > 0) ? v1 : 0; // Force to be 0 if negative.
-        }
-        else
-        {
-          vHi = -v1; // Make it nonnegative.
-          vLo = (v2 > 0) ? v2 : 0; // Force to be 0 if negative.
-        }
-
-        // The compiler should optimize out this if statement entirely.
-        if (MetricType::Power == 1)
-        {
-          loSum += vLo; // vLo is non-negative.
-          hiSum += vHi; // vHi is non-negative.
-        }
-        else if (MetricType::Power == 2)
-        {
-          loSum += vLo * vLo;
-          hiSum += vHi * vHi;
-        }
-        else
-        {
-          loSum += std::pow(vLo, (ElemType) MetricType::Power);
-          hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-        }
+        loSum += Distance::Pow(Distance::MinGap(lo[d], hi[d], otherLo[d],
+            otherHi[d]));
+        hiSum += Distance::Pow(Distance::MaxGap(lo[d], hi[d], otherLo[d],
+            otherHi[d]));
       }
 
-      if (loSum < minLoSum)
-        minLoSum = loSum;
-      if (hiSum > maxHiSum)
-        maxHiSum = hiSum;
-    }
-
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return math::RangeType<ElemType>(minLoSum, maxHiSum);
-    else if (MetricType::Power == 2)
-      return math::RangeType<ElemType>((ElemType) std::sqrt(minLoSum),
-                                       (ElemType) std::sqrt(maxHiSum));
-    else
-    {
-      return math::RangeType<ElemType>(
-          (ElemType) pow((double) minLoSum, 1.0 / (double) MetricType::Power),
-          (ElemType) pow((double) maxHiSum, 1.0 / (double) MetricType::Power));
+      minLoSum = std::min(minLoSum, loSum);
+      maxHiSum = std::max(maxHiSum, hiSum);
     }
   }
-  else
-    return math::RangeType<ElemType>(minLoSum, maxHiSum);
+
+  return math::RangeType<ElemType>(Distance::Root(minLoSum),
+                                   Distance::Root(maxHiSum));
 }
 
 /**
- * Calculates minimum and maximum bound-to-point squared distance.
+ * Calculates minimum and maximum bound-to-point distance.
  */
 template<typename MetricType, typename ElemType>
 template<typename VecType>
@@ -787,79 +646,30 @@ CellBound<MetricType, ElemType>::RangeDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType minLoSum = std::numeric_limits<ElemType>::max();
-  ElemType maxHiSum = std::numeric_limits<ElemType>::lowest();
-
   Log::Assert(point.n_elem == dim);
 
-  ElemType v1, v2, vLo, vHi;
+  ElemType minLoSum = std::numeric_limits<ElemType>::max();
+  ElemType maxHiSum = std::numeric_limits<ElemType>::lowest();
   for (size_t i = 0; i < numBounds; i++)
   {
+    const ElemType* lo = loBound.colptr(i);
+    const ElemType* hi = hiBound.colptr(i);
+
     ElemType loSum = 0;
     ElemType hiSum = 0;
     for (size_t d = 0; d < dim; d++)
     {
-      v1 = loBound(d, i) - point[d]; // Negative if point[d] > lo.
-      v2 = point[d] - hiBound(d, i); // Negative if point[d] < hi.
-      // One of v1 or v2 (or both) is negative.
-      if (v1 >= 0) // point[d] <= bounds_[d].Lo().
-      {
-        vHi = -v2; // v2 will be larger but must be negated.
-        vLo = v1;
-      }
-      else // point[d] is between lo and hi, or greater than hi.
-      {
-        if (v2 >= 0)
-        {
-          vHi = -v1; // v1 will be larger, but must be negated.
-          vLo = v2;
-        }
-        else
-        {
-          vHi = -std::min(v1, v2); // Both are negative, but we need the larger.
-          vLo = 0;
-        }
-      }
-
-      // The compiler should optimize out this if statement entirely.
-      if (MetricType::Power == 1)
-      {
-        loSum += vLo; // vLo is non-negative.
-        hiSum += vHi; // vHi is non-negative.
-      }
-      else if (MetricType::Power == 2)
-      {
-        loSum += vLo * vLo;
-        hiSum += vHi * vHi;
-      }
-      else
-      {
-        loSum += std::pow(vLo, (ElemType) MetricType::Power);
-        hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-      }
+      const ElemType p = point[d];
+      loSum += Distance::Pow(Distance::MinGap(lo[d], hi[d], p, p));
+      hiSum += Distance::Pow(Distance::MaxGap(lo[d], hi[d], p, p));
     }
-    if (loSum < minLoSum)
-      minLoSum = loSum;
-    if (hiSum > maxHiSum)
-      maxHiSum = hiSum;
-  }
 
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return math::RangeType<ElemType>(minLoSum, maxHiSum);
-    else if (MetricType::Power == 2)
-      return math::RangeType<ElemType>((ElemType) std::sqrt(minLoSum),
-                                       (ElemType) std::sqrt(maxHiSum));
-    else
-    {
-      return math::RangeType<ElemType>(
-          (ElemType) pow((double) minLoSum, 1.0 / (double) MetricType::Power),
-          (ElemType) pow((double) maxHiSum, 1.0 / (double) MetricType::Power));
-    }
+    minLoSum = std::min(minLoSum, loSum);
+    maxHiSum = std::max(maxHiSum, hiSum);
   }
-  else
-    return math::RangeType<ElemType>(minLoSum, maxHiSum);
+
+  return math::RangeType<ElemType>(Distance::Root(minLoSum),
+                                   Distance::Root(maxHiSum));
 }
 
 /**
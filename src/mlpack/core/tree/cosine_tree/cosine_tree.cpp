@@ -14,6 +14,8 @@
 
 #include <boost/math/distributions/normal.hpp>
 
+#include <chrono>
+
 namespace mlpack {
 namespace tree {
 
@@ -29,11 +31,11 @@ CosineTree::CosineTree(const arma::mat& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
-  for (size_t i = 0; i < numColumns; i++)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     indices[i] = i;
-    double l2Norm = arma::norm(dataset.col(i), 2);
-    l2NormsSquared(i) = l2Norm * l2Norm;
+    l2NormsSquared(i) = arma::dot(dataset.col(i), dataset.col(i));
   }
 
   // Frobenius norm of columns in the node.
@@ -75,7 +77,9 @@ CosineTree::CosineTree(CosineTree& parentNode,
 
 CosineTree::CosineTree(const arma::mat& dataset,
                        const double epsilon,
-                       const double delta) :
+                       const double delta,
+                       const size_t maxBasisSize,
+                       const double timeLimit) :
     dataset(dataset),
     delta(delta),
     left(NULL),
@@ -94,9 +98,25 @@ CosineTree::CosineTree(const arma::mat& dataset,
   // Initialize Monte Carlo error estimate for comparison.
   double monteCarloError = root.FrobNormSquared();
 
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
   while (treeQueue.size() > 0 &&
          (monteCarloError > epsilon * root.FrobNormSquared()))
   {
+    // Stop early if the sampling budget is exhausted; the basis then has the
+    // best error that could be reached within the budget.
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if ((maxBasisSize > 0 && treeQueue.size() >= maxBasisSize) ||
+        (timeLimit > 0.0 && elapsed.count() >= timeLimit))
+    {
+      Log::Info << "CosineTree::CosineTree(): sampling budget exhausted with "
+          << treeQueue.size() << " basis vectors and estimated relative error "
+          << (monteCarloError / root.FrobNormSquared()) << "." << std::endl;
+      break;
+    }
+
     // Pop node from queue with highest projection error.
     CosineTree* currentNode;
     currentNode = treeQueue.top();
@@ -123,11 +143,17 @@ CosineTree::CosineTree(const arma::mat& dataset,
     currentLeft = currentNode->Left();
     currentRight = currentNode->Right();
 
+    // Collect the current basis once; the basis vectors of the children are
+    // its only extension in this iteration.
+    arma::mat currentBasis;
+    QueueBasis(treeQueue, currentBasis);
+
     // Calculate basis vectors of left and right children.
     arma::vec lBasisVector, rBasisVector;
 
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
+    ModifiedGramSchmidt(currentBasis, currentLeft->Centroid(), lBasisVector,
+                        NULL);
+    ModifiedGramSchmidt(currentBasis, currentRight->Centroid(), rBasisVector,
                         &lBasisVector);
 
     // Add basis vectors to their respective nodes.
@@ -135,15 +161,17 @@ CosineTree::CosineTree(const arma::mat& dataset,
     currentRight->BasisVector(rBasisVector);
 
     // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentLeft, currentBasis, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentRight, currentBasis, &lBasisVector, &rBasisVector);
 
     // Push child nodes into the priority queue.
     treeQueue.push(currentLeft);
     treeQueue.push(currentRight);
 
-    // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    // Calculate Monte Carlo error estimate for the root node, whose subspace is
+    // now the current basis and the basis vectors of the two children.
+    monteCarloError = MonteCarloError(&root, currentBasis, &lBasisVector,
+        &rBasisVector);
   }
 
   // Construct the subspace basis from the current priority queue.
@@ -162,40 +190,66 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
                                      arma::vec& centroid,
                                      arma::vec& newBasisVector,
                                      arma::vec* addBasisVector)
+{
+  arma::mat currentBasis;
+  QueueBasis(treeQueue, currentBasis);
+  ModifiedGramSchmidt(currentBasis, centroid, newBasisVector, addBasisVector);
+}
+
+void CosineTree::ModifiedGramSchmidt(const arma::mat& currentBasis,
+                                     const arma::vec& centroid,
+                                     arma::vec& newBasisVector,
+                                     const arma::vec* addBasisVector)
 {
   // Set new basis vector to centroid.
   newBasisVector = centroid;
 
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
-
-  // For every vector in the current basis, remove its projection from the
-  // centroid.
-  for ( ; i != treeQueue.end(); i++)
+  // Remove the projection onto the current basis (and the additional basis
+  // vector, if it is passed) as two matrix-vector products.  This is done
+  // twice, since a single pass loses orthogonality when the centroid is
+  // nearly in the span of the basis.
+  for (size_t pass = 0; pass < 2; ++pass)
   {
-    currentNode = *i;
-
-    double projection = arma::dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
-  }
+    if (currentBasis.n_cols > 0)
+      newBasisVector -= currentBasis * (currentBasis.t() * newBasisVector);
 
-  // If additional basis vector is passed, take it into account.
-  if (addBasisVector)
-  {
-    double projection = arma::dot(*addBasisVector, centroid);
-    newBasisVector -= *addBasisVector * projection;
+    if (addBasisVector)
+    {
+      newBasisVector -= *addBasisVector *
+          arma::dot(*addBasisVector, newBasisVector);
+    }
   }
 
   // Normalize the modified centroid vector.
-  if (arma::norm(newBasisVector, 2))
-    newBasisVector /= arma::norm(newBasisVector, 2);
+  const double norm = arma::norm(newBasisVector, 2);
+  if (norm)
+    newBasisVector /= norm;
 }
 
 double CosineTree::MonteCarloError(CosineTree* node,
                                    CosineNodeQueue& treeQueue,
                                    arma::vec* addBasisVector1,
                                    arma::vec* addBasisVector2)
+{
+  arma::mat currentBasis;
+  QueueBasis(treeQueue, currentBasis);
+
+  // The additional basis vectors are only used if both are passed.
+  if (addBasisVector1 && addBasisVector2)
+  {
+    return MonteCarloError(node, currentBasis, addBasisVector1,
+        addBasisVector2);
+  }
+  else
+  {
+    return MonteCarloError(node, currentBasis, NULL, NULL);
+  }
+}
+
+double CosineTree::MonteCarloError(CosineTree* node,
+                                   const arma::mat& currentBasis,
+                                   const arma::vec* addBasisVector1,
+                                   const arma::vec* addBasisVector2)
 {
   std::vector<size_t> sampledIndices;
   arma::vec probabilities;
@@ -205,56 +259,29 @@ double CosineTree::MonteCarloError(CosineTree* node,
   size_t numSamples = log(node->NumColumns()) + 1;
   node->ColumnSamplesLS(sampledIndices, probabilities, numSamples);
 
-  // Get pointer to the original dataset.
-  arma::mat dataset = node->GetDataset();
-
-  // Initialize weighted projection magnitudes as zeros.
-  arma::vec weightedMagnitudes;
-  weightedMagnitudes.zeros(numSamples);
+  // Get a reference to the original dataset.
+  const arma::mat& dataset = node->GetDataset();
 
-  // Set size of projection vector, depending on whether additional basis
-  // vectors are passed.
-  size_t projectionSize;
-  if (addBasisVector1 && addBasisVector2)
-    projectionSize = treeQueue.size() + 2;
-  else
-    projectionSize = treeQueue.size();
-
-  // For each sample, calculate the weighted projection onto the current basis.
+  // Gather the sampled columns, so that their projections onto the current
+  // basis are a single matrix product.
+  arma::mat samples(dataset.n_rows, numSamples);
   for (size_t i = 0; i < numSamples; i++)
-  {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.end(); j++, k++)
-    {
-      currentNode = *j;
-
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
-    }
-    // If two additional vectors are passed, take their projections.
-    if (addBasisVector1 && addBasisVector2)
-    {
-      projection(k++) = arma::dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
-    }
-
-    // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
-    double frobProjectionSquared = frobProjection * frobProjection;
+    samples.col(i) = dataset.col(sampledIndices[i]);
 
-    // Calculate the weighted projection magnitude.
-    weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
+  // Calculate the squared norm of the projection of each sample.
+  arma::rowvec frobProjectionSquared(numSamples, arma::fill::zeros);
+  if (currentBasis.n_cols > 0)
+  {
+    frobProjectionSquared = arma::sum(arma::square(currentBasis.t() * samples),
+        0);
   }
+  if (addBasisVector1)
+    frobProjectionSquared += arma::square(addBasisVector1->t() * samples);
+  if (addBasisVector2)
+    frobProjectionSquared += arma::square(addBasisVector2->t() * samples);
+
+  // Calculate the weighted projection magnitudes.
+  arma::vec weightedMagnitudes = frobProjectionSquared.t() / probabilities;
 
   // Compute mean and standard deviation of the weighted samples.
   double mu = arma::mean(weightedMagnitudes);
@@ -279,20 +306,26 @@ double CosineTree::MonteCarloError(CosineTree* node,
 
 void CosineTree::ConstructBasis(CosineNodeQueue& treeQueue)
 {
-  // Initialize basis as matrix of zeros.
-  basis.zeros(dataset.n_rows, treeQueue.size());
-
-  // Variables for iterating through the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
+  QueueBasis(treeQueue, basis);
+}
 
-  // Transfer basis vectors from the queue to the basis matrix.
-  size_t j = 0;
-  for ( ; i != treeQueue.end(); i++, j++)
+void CosineTree::QueueBasis(const CosineNodeQueue& treeQueue,
+                            arma::mat& currentBasis)
+{
+  // Collect the nodes first, so that their basis vectors can be copied in
+  // parallel.
+  std::vector<CosineTree*> nodes(treeQueue.begin(), treeQueue.end());
+  if (nodes.empty())
   {
-    currentNode = *i;
-    basis.col(j) = currentNode->BasisVector();
+    currentBasis.reset();
+    return;
   }
+
+  currentBasis.set_size(nodes[0]->BasisVector().n_elem, nodes.size());
+
+  #pragma omp parallel for if (nodes.size() >= 64)
+  for (omp_size_t j = 0; j < (omp_size_t) nodes.size(); j++)
+    currentBasis.col(j) = nodes[j]->BasisVector();
 }
 
 void CosineTree::CosineNodeSplit()
@@ -424,19 +457,25 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; i++)
+  // The norms of the columns are already known, so each cosine only takes one
+  // dot product.
+  const arma::vec splitPoint = dataset.col(indices[splitPointIndex]);
+  const double splitPointNorm = std::sqrt(l2NormsSquared(splitPointIndex));
+
+  #pragma omp parallel for if (numColumns >= 1024)
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
-    if (l2NormsSquared(i) == 0)
+    if (l2NormsSquared(i) == 0 || splitPointNorm == 0)
     {
       cosines(i) = 0;
     }
     else
     {
-      cosines(i) =
-          std::abs(arma::norm_dot(dataset.col(indices[splitPointIndex]),
-                                  dataset.col(indices[i])));
+      cosines(i) = std::min(1.0, std::abs(arma::dot(splitPoint,
+          dataset.col(indices[i]))) / (splitPointNorm *
+          std::sqrt(l2NormsSquared(i))));
     }
   }
 }
@@ -446,10 +485,18 @@ void CosineTree::CalculateCentroid()
   // Initialize centroid as vector of zeros.
   centroid.zeros(dataset.n_rows);
 
-  // Calculate centroid of columns in the node.
-  for (size_t i = 0; i < numColumns; i++)
+  // Calculate centroid of columns in the node, with one partial sum per
+  // thread.
+  #pragma omp parallel if (numColumns >= 1024)
   {
-    centroid += dataset.col(indices[i]);
+    arma::vec partialSum(dataset.n_rows, arma::fill::zeros);
+
+    #pragma omp for nowait
+    for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
+      partialSum += dataset.col(indices[i]);
+
+    #pragma omp critical(cosine_tree_centroid)
+    centroid += partialSum;
   }
   centroid /= numColumns;
 }
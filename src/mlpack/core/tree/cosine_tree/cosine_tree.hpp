@@ -58,15 +58,21 @@ class CosineTree
    * split node. The basis vector from a node is the orthonormalized centroid of
    * its columns. The splitting continues till the Monte Carlo estimate of the
    * input matrix's projection on the obtained subspace is less than a fraction
-   * of the norm of the input matrix.
+   * of the norm of the input matrix, or until the sampling budget (the maximum
+   * size of the basis, or the time limit) is exhausted.
    *
    * @param dataset Matrix for which the CosineTree is constructed.
    * @param epsilon Error tolerance fraction for calculated subspace.
    * @param delta Cumulative probability for Monte Carlo error lower bound.
+   * @param maxBasisSize Maximum number of basis vectors (0 means no limit).
+   * @param timeLimit Maximum number of seconds to spend growing the tree (0
+   *     means no limit).
    */
   CosineTree(const arma::mat& dataset,
              const double epsilon,
-             const double delta);
+             const double delta,
+             const size_t maxBasisSize = 0,
+             const double timeLimit = 0.0);
 
   /**
    * Clean up the CosineTree: release allocated memory (including children).
@@ -241,6 +247,29 @@ class CosineTree
   double l2Error;
   //! Frobenius norm squared of columns in the node.
   double frobNormSquared;
+
+  /**
+   * Orthonormalize the passed centroid with respect to the given basis (one
+   * vector per column) and the additional basis vector, if it is not NULL.
+   */
+  void ModifiedGramSchmidt(const arma::mat& currentBasis,
+                           const arma::vec& centroid,
+                           arma::vec& newBasisVector,
+                           const arma::vec* addBasisVector);
+
+  /**
+   * Estimate the squared error of the projection of the input node's matrix
+   * onto the subspace spanned by the given basis and the additional basis
+   * vectors that are not NULL.
+   */
+  double MonteCarloError(CosineTree* node,
+                         const arma::mat& currentBasis,
+                         const arma::vec* addBasisVector1,
+                         const arma::vec* addBasisVector2);
+
+  //! Collect the basis vectors of the nodes in the queue, one per column.
+  static void QueueBasis(const CosineNodeQueue& treeQueue,
+                         arma::mat& currentBasis);
 };
 
 class CompareCosineNode
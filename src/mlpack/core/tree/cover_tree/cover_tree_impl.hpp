@@ -1242,8 +1242,11 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
 {
   // For each point, rebuild the distances.  The indices do not need to be
   // modified.
+  // These are independent, so large point sets (which occur near the root,
+  // where most of the construction time is spent) are split across threads.
   distanceComps += pointSetSize;
-  for (size_t i = 0; i < pointSetSize; ++i)
+  #pragma omp parallel for if (pointSetSize >= 4096)
+  for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
         dataset->col(indices[i]));
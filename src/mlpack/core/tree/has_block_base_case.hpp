@@ -0,0 +1,45 @@
+/**
+ * @file has_block_base_case.hpp
+ *
+ * Definition of HasBlockBaseCase, which tells whether a RuleType can evaluate
+ * all of the base cases between a set of query points and a contiguous range of
+ * reference points at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_HAS_BLOCK_BASE_CASE_HPP
+#define MLPACK_CORE_TREE_HAS_BLOCK_BASE_CASE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+HAS_MEM_FUNC(BlockBaseCase, HasBlockBaseCaseCheck);
+
+/**
+ * 'value' is true if the RuleType class has a member
+ * BlockBaseCase(const std::vector<size_t>& queries,
+ *               const size_t referenceBegin,
+ *               const size_t referenceCount).
+ *
+ * Traversers may call it instead of calling BaseCase() for every pair of points
+ * of two leaves.
+ */
+template<typename RuleType>
+struct HasBlockBaseCase
+{
+  static const bool value = HasBlockBaseCaseCheck<RuleType,
+      void(RuleType::*)(const std::vector<size_t>&,
+                        const size_t,
+                        const size_t)>::value;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,7 @@
 #include <mlpack/core/math/range.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include "bound_traits.hpp"
+#include "bound_distance.hpp"
 
 namespace mlpack {
 namespace bound {
@@ -132,6 +133,18 @@ class HRectBound
    */
   ElemType MinDistance(const HRectBound& other) const;
 
+  /**
+   * Calculates minimum bound-to-bound distances from this bound to each of the
+   * given bounds, e.g. the children of a node that are candidates for
+   * recursion.  This gives the same results as calling MinDistance() for every
+   * bound, but every dimension of this bound is only loaded once.
+   *
+   * @param others Bounds to which the minimum distances are requested.
+   * @param distances Vector to store the distance to each bound in.
+   */
+  void MinDistance(const std::vector<const HRectBound*>& others,
+                   arma::Col<ElemType>& distances) const;
+
   /**
    * Calculates maximum bound-to-point squared distance.
    *
@@ -149,6 +162,16 @@ class HRectBound
    */
   ElemType MaxDistance(const HRectBound& other) const;
 
+  /**
+   * Computes maximum distances from this bound to each of the given bounds.
+   * This gives the same results as calling MaxDistance() for every bound.
+   *
+   * @param others Bounds to which the maximum distances are requested.
+   * @param distances Vector to store the distance to each bound in.
+   */
+  void MaxDistance(const std::vector<const HRectBound*>& others,
+                   arma::Col<ElemType>& distances) const;
+
   /**
    * Calculates minimum and maximum bound-to-bound distance.
    *
@@ -221,6 +244,9 @@ class HRectBound
   void serialize(Archive& ar, const unsigned int version);
 
  private:
+  //! The per-dimension distance kernels.
+  typedef BoundDistance<MetricType, ElemType> Distance;
+
   //! The dimensionality of the bound.
   size_t dim;
   //! The bounds for each dimension.
@@ -159,7 +159,7 @@ inline ElemType HRectBound<MetricType, ElemType>::Volume() const
 }
 
 /**
- * Calculates minimum bound-to-point squared distance.
+ * Calculates minimum bound-to-point distance.
  */
 template<typename MetricType, typename ElemType>
 template<typename VecType>
@@ -170,55 +170,18 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
   Log::Assert(point.n_elem == dim);
 
   ElemType sum = 0;
-
-  ElemType lower, higher;
   for (size_t d = 0; d < dim; d++)
   {
-    lower = bounds[d].Lo() - point[d];
-    higher = point[d] - bounds[d].Hi();
-
-    // Since only one of 'lower' or 'higher' is negative, if we add each's
-    // absolute value to itself and then sum those two, our result is the
-    // nonnegative half of the equation times two; then we raise to power Power.
-    if (MetricType::Power == 1)
-      sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-    else if (MetricType::Power == 2)
-    {
-      ElemType dist = (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-      sum += dist * dist;
-    }
-    else
-    {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
-    }
+    const ElemType p = point[d];
+    sum += Distance::Pow(Distance::MinGap(bounds[d].Lo(), bounds[d].Hi(), p,
+        p));
   }
 
-  // Now take the Power'th root (but make sure our result is squared if it needs
-  // to be); then cancel out the constant of 2 (which may have been squared now)
-  // that was introduced earlier.  The compiler should optimize out the if
-  // statement entirely.
-  if (MetricType::Power == 1)
-    return sum * 0.5;
-  else if (MetricType::Power == 2)
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) std::sqrt(sum) * 0.5;
-    else
-      return sum * 0.25;
-  }
-  else
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) pow((double) sum,
-          1.0 / (double) MetricType::Power) / 2.0;
-    else
-      return sum / pow(2.0, MetricType::Power);
-  }
+  return Distance::Root(sum);
 }
 
 /**
- * Calculates minimum bound-to-bound squared distance.
+ * Calculates minimum bound-to-bound distance.
  */
 template<typename MetricType, typename ElemType>
 ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
@@ -227,59 +190,45 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
   Log::Assert(dim == other.dim);
 
   ElemType sum = 0;
-  const math::RangeType<ElemType>* mbound = bounds;
-  const math::RangeType<ElemType>* obound = other.bounds;
+  for (size_t d = 0; d < dim; d++)
+  {
+    sum += Distance::Pow(Distance::MinGap(bounds[d].Lo(), bounds[d].Hi(),
+        other.bounds[d].Lo(), other.bounds[d].Hi()));
+  }
+
+  return Distance::Root(sum);
+}
+
+/**
+ * Calculates minimum bound-to-bound distances to several bounds.
+ */
+template<typename MetricType, typename ElemType>
+void HRectBound<MetricType, ElemType>::MinDistance(
+    const std::vector<const HRectBound*>& others,
+    arma::Col<ElemType>& distances) const
+{
+  distances.zeros(others.size());
+  for (size_t i = 0; i < others.size(); ++i)
+    Log::Assert(dim == others[i]->dim);
 
-  ElemType lower, higher;
+  // Every dimension of this bound is loaded once for all of the other bounds.
   for (size_t d = 0; d < dim; d++)
   {
-    lower = obound->Lo() - mbound->Hi();
-    higher = mbound->Lo() - obound->Hi();
-    // We invoke the following:
-    //   x + fabs(x) = max(x * 2, 0)
-    //   (x * 2)^2 / 4 = x^2
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-    else if (MetricType::Power == 2)
-    {
-      ElemType dist = (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-      sum += dist * dist;
-    }
-    else
+    const ElemType lo = bounds[d].Lo();
+    const ElemType hi = bounds[d].Hi();
+    for (size_t i = 0; i < others.size(); ++i)
     {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
+      distances[i] += Distance::Pow(Distance::MinGap(lo, hi,
+          others[i]->bounds[d].Lo(), others[i]->bounds[d].Hi()));
     }
-
-    // Move bound pointers.
-    mbound++;
-    obound++;
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::Power == 1)
-    return sum * 0.5;
-  else if (MetricType::Power == 2)
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) std::sqrt(sum) * 0.5;
-    else
-      return sum * 0.25;
-  }
-  else
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) pow((double) sum,
-          1.0 / (double) MetricType::Power) / 2.0;
-    else
-      return sum / pow(2.0, MetricType::Power);
-  }
+  for (size_t i = 0; i < others.size(); ++i)
+    distances[i] = Distance::Root(distances[i]);
 }
 
 /**
- * Calculates maximum bound-to-point squared distance.
+ * Calculates maximum bound-to-point distance.
  */
 template<typename MetricType, typename ElemType>
 template<typename VecType>
@@ -287,36 +236,17 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType sum = 0;
-
   Log::Assert(point.n_elem == dim);
 
+  ElemType sum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    ElemType v = std::max(fabs(point[d] - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - point[d]));
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += v; // v is non-negative.
-    else if (MetricType::Power == 2)
-      sum += v * v;
-    else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+    const ElemType p = point[d];
+    sum += Distance::Pow(Distance::MaxGap(bounds[d].Lo(), bounds[d].Hi(), p,
+        p));
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return sum;
-    else if (MetricType::Power == 2)
-      return (ElemType) std::sqrt(sum);
-    else
-      return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
-  }
-  else
-    return sum;
+  return Distance::Root(sum);
 }
 
 /**
@@ -327,107 +257,74 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const HRectBound& other)
     const
 {
-  ElemType sum = 0;
-
   Log::Assert(dim == other.dim);
 
-  ElemType v;
+  ElemType sum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - other.bounds[d].Lo()));
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += v; // v is non-negative.
-    else if (MetricType::Power == 2)
-      sum += v * v;
-    else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+    sum += Distance::Pow(Distance::MaxGap(bounds[d].Lo(), bounds[d].Hi(),
+        other.bounds[d].Lo(), other.bounds[d].Hi()));
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::TakeRoot)
+  return Distance::Root(sum);
+}
+
+/**
+ * Computes maximum distances to several bounds.
+ */
+template<typename MetricType, typename ElemType>
+void HRectBound<MetricType, ElemType>::MaxDistance(
+    const std::vector<const HRectBound*>& others,
+    arma::Col<ElemType>& distances) const
+{
+  distances.zeros(others.size());
+  for (size_t i = 0; i < others.size(); ++i)
+    Log::Assert(dim == others[i]->dim);
+
+  // Every dimension of this bound is loaded once for all of the other bounds.
+  for (size_t d = 0; d < dim; d++)
   {
-    if (MetricType::Power == 1)
-      return sum;
-    else if (MetricType::Power == 2)
-      return (ElemType) std::sqrt(sum);
-    else
-      return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
+    const ElemType lo = bounds[d].Lo();
+    const ElemType hi = bounds[d].Hi();
+    for (size_t i = 0; i < others.size(); ++i)
+    {
+      distances[i] += Distance::Pow(Distance::MaxGap(lo, hi,
+          others[i]->bounds[d].Lo(), others[i]->bounds[d].Hi()));
+    }
   }
-  else
-    return sum;
+
+  for (size_t i = 0; i < others.size(); ++i)
+    distances[i] = Distance::Root(distances[i]);
 }
 
 /**
- * Calculates minimum and maximum bound-to-bound squared distance.
+ * Calculates minimum and maximum bound-to-bound distance.
  */
 template<typename MetricType, typename ElemType>
 inline math::RangeType<ElemType>
 HRectBound<MetricType, ElemType>::RangeDistance(
     const HRectBound& other) const
 {
-  ElemType loSum = 0;
-  ElemType hiSum = 0;
-
   Log::Assert(dim == other.dim);
 
-  ElemType v1, v2, vLo, vHi;
+  ElemType loSum = 0;
+  ElemType hiSum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    v1 = other.bounds[d].Lo() - bounds[d].Hi();
-    v2 = bounds[d].Lo() - other.bounds[d].Hi();
-    // One of v1 or v2 is negative.
-    if (v1 >= v2)
-    {
-      vHi = -v2; // Make it nonnegative.
-      vLo = (v1 > 0) ? v1 : 0; // Force to be 0 if negative.
-    }
-    else
-    {
-      vHi = -v1; // Make it nonnegative.
-      vLo = (v2 > 0) ? v2 : 0; // Force to be 0 if negative.
-    }
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-    {
-      loSum += vLo; // vLo is non-negative.
-      hiSum += vHi; // vHi is non-negative.
-    }
-    else if (MetricType::Power == 2)
-    {
-      loSum += vLo * vLo;
-      hiSum += vHi * vHi;
-    }
-    else
-    {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-    }
+    const ElemType lo = bounds[d].Lo();
+    const ElemType hi = bounds[d].Hi();
+    const ElemType otherLo = other.bounds[d].Lo();
+    const ElemType otherHi = other.bounds[d].Hi();
+    loSum += Distance::Pow(Distance::MinGap(lo, hi, otherLo, otherHi));
+    hiSum += Distance::Pow(Distance::MaxGap(lo, hi, otherLo, otherHi));
   }
 
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return math::RangeType<ElemType>(loSum, hiSum);
-    else if (MetricType::Power == 2)
-      return math::RangeType<ElemType>((ElemType) std::sqrt(loSum),
-                                       (ElemType) std::sqrt(hiSum));
-    else
-    {
-      return math::RangeType<ElemType>(
-          (ElemType) pow((double) loSum, 1.0 / (double) MetricType::Power),
-          (ElemType) pow((double) hiSum, 1.0 / (double) MetricType::Power));
-    }
-  }
-  else
-    return math::RangeType<ElemType>(loSum, hiSum);
+  return math::RangeType<ElemType>(Distance::Root(loSum),
+                                   Distance::Root(hiSum));
 }
 
 /**
- * Calculates minimum and maximum bound-to-point squared distance.
+ * Calculates minimum and maximum bound-to-point distance.
  */
 template<typename MetricType, typename ElemType>
 template<typename VecType>
@@ -436,70 +333,21 @@ HRectBound<MetricType, ElemType>::RangeDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType loSum = 0;
-  ElemType hiSum = 0;
-
   Log::Assert(point.n_elem == dim);
 
-  ElemType v1, v2, vLo, vHi;
+  ElemType loSum = 0;
+  ElemType hiSum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
-    v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
-    // One of v1 or v2 (or both) is negative.
-    if (v1 >= 0) // point[d] <= bounds_[d].Lo().
-    {
-      vHi = -v2; // v2 will be larger but must be negated.
-      vLo = v1;
-    }
-    else // point[d] is between lo and hi, or greater than hi.
-    {
-      if (v2 >= 0)
-      {
-        vHi = -v1; // v1 will be larger, but must be negated.
-        vLo = v2;
-      }
-      else
-      {
-        vHi = -std::min(v1, v2); // Both are negative, but we need the larger.
-        vLo = 0;
-      }
-    }
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-    {
-      loSum += vLo; // vLo is non-negative.
-      hiSum += vHi; // vHi is non-negative.
-    }
-    else if (MetricType::Power == 2)
-    {
-      loSum += vLo * vLo;
-      hiSum += vHi * vHi;
-    }
-    else
-    {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-    }
+    const ElemType lo = bounds[d].Lo();
+    const ElemType hi = bounds[d].Hi();
+    const ElemType p = point[d];
+    loSum += Distance::Pow(Distance::MinGap(lo, hi, p, p));
+    hiSum += Distance::Pow(Distance::MaxGap(lo, hi, p, p));
   }
 
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return math::RangeType<ElemType>(loSum, hiSum);
-    else if (MetricType::Power == 2)
-      return math::RangeType<ElemType>((ElemType) std::sqrt(loSum),
-                                       (ElemType) std::sqrt(hiSum));
-    else
-    {
-      return math::RangeType<ElemType>(
-          (ElemType) pow((double) loSum, 1.0 / (double) MetricType::Power),
-          (ElemType) pow((double) hiSum, 1.0 / (double) MetricType::Power));
-    }
-  }
-  else
-    return math::RangeType<ElemType>(loSum, hiSum);
+  return math::RangeType<ElemType>(Distance::Root(loSum),
+                                   Distance::Root(hiSum));
 }
 
 /**
@@ -0,0 +1,105 @@
+/**
+ * @file indexed_statistic.hpp
+ *
+ * Definition of IndexedStatistic, a statistic that only holds the index of its
+ * node, so that the actual statistics can be kept in dense per-tree tables.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_INDEXED_STATISTIC_HPP
+#define MLPACK_CORE_TREE_INDEXED_STATISTIC_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "enumerate_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A statistic that holds nothing but the index of its node.  Instead of storing
+ * their statistics in every node, algorithms that support this statistic keep
+ * them in tables with one entry per node (usually one array per field), which
+ * are indexed by Index().  This keeps the nodes small and the statistics that
+ * are updated together close in memory.
+ *
+ * The indices are assigned by IndexNodes() once the tree is built.
+ */
+class IndexedStatistic
+{
+ public:
+  //! Initialize the statistic; the index is assigned by IndexNodes().
+  IndexedStatistic() : index(0) { }
+
+  //! Initialize the statistic of a finished node.
+  template<typename TreeType>
+  IndexedStatistic(TreeType& /* node */) : index(0) { }
+
+  //! Nothing is stored in the node, so there is nothing to reset.
+  void Reset() { }
+
+  //! Get the index of the node.
+  size_t Index() const { return index; }
+  //! Modify the index of the node.
+  size_t& Index() { return index; }
+
+  //! Serialize the statistic.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(index);
+  }
+
+ private:
+  //! The index of the node.
+  size_t index;
+};
+
+namespace enumerate {
+
+//! Walker that numbers the nodes of a tree in depth-first preorder.
+class NodeIndexer
+{
+ public:
+  NodeIndexer() : count(0) { }
+
+  template<typename TreeType>
+  void Enter(TreeType* node, const TreeType* /* parent */)
+  { node->Stat().Index() = count++; }
+
+  template<typename TreeType>
+  void Leave(TreeType* /* node */, const TreeType* /* parent */) { }
+
+  //! Get the number of nodes seen so far.
+  size_t Count() const { return count; }
+
+ private:
+  //! The number of nodes seen so far.
+  size_t count;
+};
+
+} // namespace enumerate
+
+/**
+ * Assign the indices of the IndexedStatistic of every node of the given tree in
+ * depth-first preorder, so the root gets index 0 and every subtree takes a
+ * contiguous range of indices.  This must be called again if the tree is
+ * modified.
+ *
+ * @param tree The root of the tree.
+ * @return The number of nodes of the tree.
+ */
+template<typename TreeType>
+size_t IndexNodes(TreeType* tree)
+{
+  enumerate::NodeIndexer indexer;
+  EnumerateTree(tree, indexer);
+  return indexer.Count();
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_INDEXED_STATISTIC_HPP
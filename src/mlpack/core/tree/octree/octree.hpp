@@ -63,6 +63,9 @@ class Octree
   ElemType furthestDescendantDistance;
   //! An instantiated metric.
   MetricType metric;
+  //! Whether the descendants of this (root) node are stored contiguously in a
+  //! single buffer owned by this node; see CompactLayout().
+  bool compacted;
 
  public:
   /**
@@ -235,6 +238,21 @@ class Octree
    */
   ~Octree();
 
+  /**
+   * Relocate every descendant of this node into a single contiguous block of
+   * memory, in breadth-first order, so that traversals touch nodes that are
+   * close together, and the whole tree is freed in one step.  The structure
+   * of the tree does not change, so the traversers and rules work as before.
+   *
+   * This may only be called on the root of a tree: pointers to any nodes other
+   * than the root are invalidated.  Copies of a compacted tree are not
+   * compacted.
+   */
+  void CompactLayout();
+
+  //! Return whether the descendants of this node are stored contiguously.
+  bool IsCompacted() const { return compacted; }
+
   //! Return the dataset used by this node.
   const MatType& Dataset() const { return *dataset; }
 
@@ -399,6 +417,9 @@ class Octree
   friend class boost::serialization::access;
 
  private:
+  //! Delete the children of this node, whether they are compacted or not.
+  void DeleteChildren();
+
   /**
    * Split the node, using the given center and the given maximum width of this
    * node.
@@ -425,6 +446,82 @@ class Octree
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Construct this node as a child of the given parent from a run of points
+   * that are sorted by their Morton codes (see BuildFromMortonCodes()).
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of the first point of the node.
+   * @param count Number of points of the node.
+   * @param codes Morton codes of all points of the tree, in dataset order.
+   * @param level Level of the node in the codes (the root is at level 0).
+   * @param levels Number of levels held by the codes.
+   * @param center Center of the node (for splitting).
+   * @param width Width of the node in each dimension.
+   * @param oldFromNew Mappings from old to new, or NULL if they are not kept.
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(Octree* parent,
+         const size_t begin,
+         const size_t count,
+         const std::vector<uint64_t>& codes,
+         const size_t level,
+         const size_t levels,
+         const arma::vec& center,
+         const double width,
+         std::vector<size_t>* oldFromNew,
+         const size_t maxLeafSize);
+
+  /**
+   * Build the tree below the root.  Every point gets a Morton code that holds
+   * the index of the child it falls into on every level, the points are sorted
+   * by their codes once (in parallel), and every node then takes the run of
+   * points that share its code prefix.  This replaces the partitioning of
+   * SplitNode() on every level with a single permutation of the dataset.
+   *
+   * @param center Center of the root.
+   * @param width Width of the root.
+   * @param oldFromNew Mappings from old to new, or NULL if they are not kept.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void BuildFromMortonCodes(const arma::vec& center,
+                            const double width,
+                            std::vector<size_t>* oldFromNew,
+                            const size_t maxLeafSize);
+
+  /**
+   * Split the node into the runs of points that share the code prefix of each
+   * child.  The points must be sorted by their Morton codes.  A node that is
+   * still too large at the last level of the codes is split with SplitNode().
+   *
+   * @param codes Morton codes of all points of the tree, in dataset order.
+   * @param level Level of the node in the codes.
+   * @param levels Number of levels held by the codes.
+   * @param center Center of the node.
+   * @param width Width of the current node.
+   * @param oldFromNew Mappings from old to new, or NULL if they are not kept.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void SplitNodeByCode(const std::vector<uint64_t>& codes,
+                       const size_t level,
+                       const size_t levels,
+                       const arma::vec& center,
+                       const double width,
+                       std::vector<size_t>* oldFromNew,
+                       const size_t maxLeafSize);
+
+  /**
+   * Sort the given codes with a stable, parallel least-significant-digit radix
+   * sort, and fill the order of the sorted codes in the original vector.
+   *
+   * @param codes The codes to sort; they are sorted in place.
+   * @param order Filled with the original index of every sorted code.
+   * @param bits Number of low bits of the codes that are used.
+   */
+  static void RadixSort(std::vector<uint64_t>& codes,
+                        std::vector<size_t>& order,
+                        const size_t bits);
+
   /**
    * This is used for sorting points while splitting.
    */
@@ -15,6 +15,8 @@
 #include "octree.hpp"
 #include <mlpack/core/tree/perform_split.hpp>
 #include <stack>
+#include <algorithm>
+#include <new>
 
 namespace mlpack {
 namespace tree {
@@ -28,7 +30,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
     bound(dataset.n_rows),
     dataset(new MatType(dataset)),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    compacted(false)
 {
   if (count > 0)
   {
@@ -42,7 +45,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, maxLeafSize);
+    BuildFromMortonCodes(center, maxWidth, NULL, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -66,7 +69,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(dataset)),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    compacted(false)
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -84,7 +88,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    BuildFromMortonCodes(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -109,7 +113,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(dataset)),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    compacted(false)
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -127,7 +132,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    BuildFromMortonCodes(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -154,7 +159,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
     bound(dataset.n_rows),
     dataset(new MatType(std::move(dataset))),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    compacted(false)
 {
   if (count > 0)
   {
@@ -168,7 +174,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, maxLeafSize);
+    BuildFromMortonCodes(center, maxWidth, NULL, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -192,7 +198,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(std::move(dataset))),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    compacted(false)
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -210,7 +217,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    BuildFromMortonCodes(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -235,7 +242,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(std::move(dataset))),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    compacted(false)
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -253,7 +261,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    BuildFromMortonCodes(center, maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -284,7 +292,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     count(count),
     bound(parent->dataset->n_rows),
     dataset(parent->dataset),
-    parent(parent)
+    parent(parent),
+    compacted(false)
 {
   // Calculate empirical center of data.
   bound |= dataset->cols(begin, begin + count - 1);
@@ -319,7 +328,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     count(count),
     bound(parent->dataset->n_rows),
     dataset(parent->dataset),
-    parent(parent)
+    parent(parent),
+    compacted(false)
 {
   // Calculate empirical center of data.
   bound |= dataset->cols(begin, begin + count - 1);
@@ -340,6 +350,46 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   stat = StatisticType(*this);
 }
 
+//! Construct a child node from a run of points sorted by their Morton codes.
+template<typename MetricType, typename StatisticType, typename MatType>
+Octree<MetricType, StatisticType, MatType>::Octree(
+    Octree* parent,
+    const size_t begin,
+    const size_t count,
+    const std::vector<uint64_t>& codes,
+    const size_t level,
+    const size_t levels,
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize) :
+    begin(begin),
+    count(count),
+    bound(parent->dataset->n_rows),
+    dataset(parent->dataset),
+    parent(parent),
+    compacted(false)
+{
+  // Calculate empirical center of data.
+  bound |= dataset->cols(begin, begin + count - 1);
+
+  // Now split the node.
+  SplitNodeByCode(codes, level, levels, center, width, oldFromNew,
+      maxLeafSize);
+
+  // Calculate the distance from the empirical center of this node to the
+  // empirical center of the parent.
+  arma::vec trueCenter, parentCenter;
+  bound.Center(trueCenter);
+  parent->Bound().Center(parentCenter);
+  parentDistance = metric.Evaluate(trueCenter, parentCenter);
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
 //! Copy the given tree.
 template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(const Octree& other) :
@@ -351,7 +401,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(const Octree& other) :
     stat(other.stat),
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
-    metric(other.metric)
+    metric(other.metric),
+    compacted(false)
 {
   // If we have any children, we need to create them, and then ensure that their
   // parent links are set right.
@@ -375,7 +426,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(Octree&& other) :
     stat(std::move(other.stat)),
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
-    metric(std::move(other.metric))
+    metric(std::move(other.metric)),
+    compacted(other.compacted)
 {
   // Update the parent pointers of the direct children.
   for (size_t i = 0; i < children.size(); ++i)
@@ -387,6 +439,7 @@ Octree<MetricType, StatisticType, MatType>::Octree(Octree&& other) :
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
   other.parent = NULL;
+  other.compacted = false;
 }
 
 template<typename MetricType, typename StatisticType, typename MatType>
@@ -397,7 +450,8 @@ Octree<MetricType, StatisticType, MatType>::Octree() :
     dataset(new MatType()),
     parent(NULL),
     parentDistance(0.0),
-    furthestDescendantDistance(0.0)
+    furthestDescendantDistance(0.0),
+    compacted(false)
 {
   // Nothing to do.
 }
@@ -421,8 +475,83 @@ Octree<MetricType, StatisticType, MatType>::~Octree()
     delete dataset;
 
   // Now delete each of the children.
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
+  DeleteChildren();
+}
+
+/**
+ * Move all of the descendants of this node into one contiguous buffer, in
+ * breadth-first order.
+ */
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::CompactLayout()
+{
+  if (parent)
+  {
+    Log::Fatal << "Octree::CompactLayout(): can only be called on the root of "
+        << "a tree!" << std::endl;
+  }
+
+  if (compacted || children.empty())
+    return;
+
+  // Collect the descendants in breadth-first order, so that the children of
+  // every node end up next to each other.
+  std::vector<Octree*> nodes(children.begin(), children.end());
+  for (size_t i = 0; i < nodes.size(); ++i)
+    nodes.insert(nodes.end(), nodes[i]->children.begin(),
+        nodes[i]->children.end());
+
+  Octree* buffer = static_cast<Octree*>(
+      ::operator new(nodes.size() * sizeof(Octree)));
+
+  // Every parent has been moved before its children, and the move constructor
+  // points the children at their new parent, so we only have to fix the
+  // parent's child pointer.  The moved-from node owns nothing anymore.
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    Octree* node = new (buffer + i) Octree(std::move(*nodes[i]));
+    std::vector<Octree*>& siblings = node->parent->children;
+    *std::find(siblings.begin(), siblings.end(), nodes[i]) = node;
+
+    delete nodes[i];
+  }
+
+  compacted = true;
+}
+
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::DeleteChildren()
+{
+  if (!compacted)
+  {
+    for (size_t i = 0; i < children.size(); ++i)
+      delete children[i];
+  }
+  else
+  {
+    // The descendants are stored in breadth-first order, starting with our
+    // first child.  Count them before anything is destroyed.
+    Octree* buffer = children[0];
+    size_t numNodes = 0;
+    std::vector<Octree*> queue(1, this);
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+      numNodes += queue[i]->children.size();
+      queue.insert(queue.end(), queue[i]->children.begin(),
+          queue[i]->children.end());
+    }
+
+    // The nodes in the buffer must not delete their own children.
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      buffer[i].children.clear();
+      buffer[i].~Octree();
+    }
+
+    ::operator delete(buffer);
+    compacted = false;
+  }
+
   children.clear();
 }
 
@@ -636,9 +765,7 @@ void Octree<MetricType, StatisticType, MatType>::serialize(
   // If we're loading and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    for (size_t i = 0; i < children.size(); ++i)
-      delete children[i];
-    children.clear();
+    DeleteChildren();
 
     if (!parent)
       delete dataset;
@@ -867,6 +994,227 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 }
 
+//! Build the tree below the root from the Morton codes of the points.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::BuildFromMortonCodes(
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  if (count <= maxLeafSize)
+    return;
+
+  // Every level takes one bit per dimension, and as many levels as fit into
+  // 64 bits are encoded.  SplitNode() takes over below the last level.
+  const size_t dims = dataset->n_rows;
+  const size_t levels = (dims > 0 && dims < 64) ? 64 / dims : 0;
+  if (levels == 0)
+  {
+    if (oldFromNew)
+      SplitNode(center, width, *oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, width, maxLeafSize);
+    return;
+  }
+
+  // The code of a point is found by descending through the levels exactly as
+  // SplitNode() does, so the tree is the same as if it had been split node by
+  // node.  The digit of the root is held in the highest bits.
+  std::vector<uint64_t> codes(count);
+  const size_t blockSize = 1024;
+  Threads::ParallelFor(0, (count + blockSize - 1) / blockSize,
+      [&](const size_t block)
+  {
+    arma::vec nodeCenter(dims);
+    const size_t end = std::min(count, (block + 1) * blockSize);
+    for (size_t i = block * blockSize; i < end; ++i)
+    {
+      nodeCenter = center;
+      double nodeWidth = width;
+      uint64_t code = 0;
+      for (size_t l = 0; l < levels; ++l)
+      {
+        nodeWidth /= 2.0;
+        for (size_t d = 0; d < dims; ++d)
+        {
+          if ((*dataset)(d, i) < nodeCenter[d])
+          {
+            nodeCenter[d] -= nodeWidth;
+          }
+          else
+          {
+            code |= (uint64_t) 1 << (dims * (levels - l - 1) + d);
+            nodeCenter[d] += nodeWidth;
+          }
+        }
+      }
+
+      codes[i] = code;
+    }
+  });
+
+  // Sort the points by their codes, and permute the dataset once.
+  std::vector<size_t> order;
+  RadixSort(codes, order, dims * levels);
+
+  MatType sorted(dims, count);
+  Threads::ParallelFor(0, count, [&](const size_t i)
+  {
+    sorted.col(i) = dataset->col(order[i]);
+  });
+  *dataset = std::move(sorted);
+
+  if (oldFromNew)
+  {
+    const std::vector<size_t> previous(*oldFromNew);
+    for (size_t i = 0; i < count; ++i)
+      (*oldFromNew)[i] = previous[order[i]];
+  }
+
+  SplitNodeByCode(codes, 0, levels, center, width, oldFromNew, maxLeafSize);
+}
+
+//! Split the node into the runs of points of its children.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::SplitNodeByCode(
+    const std::vector<uint64_t>& codes,
+    const size_t level,
+    const size_t levels,
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // No need to split if we have fewer than the maximum number of points in this
+  // node.
+  if (count <= maxLeafSize)
+    return;
+
+  // The codes are exhausted; split the rest of the way with SplitNode().
+  if (level == levels)
+  {
+    if (oldFromNew)
+      SplitNode(center, width, *oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, width, maxLeafSize);
+    return;
+  }
+
+  const size_t shift = dataset->n_rows * (levels - level - 1);
+  const uint64_t mask = ((uint64_t) 1 << dataset->n_rows) - 1;
+  auto childIndex = [&](const uint64_t code)
+  {
+    return (size_t) ((code >> shift) & mask);
+  };
+
+  // The points of this node share its code prefix and are sorted, so the
+  // points of every child form a consecutive run, in the order of the child
+  // indices.  Empty children get no run.
+  std::vector<size_t> childBegins(1, begin);
+  while (childBegins.back() < begin + count)
+  {
+    const size_t index = childIndex(codes[childBegins.back()]);
+    childBegins.push_back(std::partition_point(
+        codes.begin() + childBegins.back(), codes.begin() + begin + count,
+        [&](const uint64_t code) { return childIndex(code) == index; }) -
+        codes.begin());
+  }
+
+  // The children work on disjoint points, so they are built in parallel.
+  const size_t numChildren = childBegins.size() - 1;
+  const double childWidth = width / 2.0;
+  std::vector<Octree*> newChildren(numChildren);
+  Threads::ParallelFor(0, numChildren, [&](const size_t c)
+  {
+    // Create the correct center.
+    const size_t i = childIndex(codes[childBegins[c]]);
+    arma::vec childCenter(center.n_elem);
+    for (size_t d = 0; d < center.n_elem; ++d)
+    {
+      // Is the dimension "right" (1) or "left" (0)?
+      if (((i >> d) & 1) == 0)
+        childCenter[d] = center[d] - childWidth;
+      else
+        childCenter[d] = center[d] + childWidth;
+    }
+
+    newChildren[c] = new Octree(this, childBegins[c],
+        childBegins[c + 1] - childBegins[c], codes, level + 1, levels,
+        childCenter, childWidth, oldFromNew, maxLeafSize);
+  });
+
+  children.insert(children.end(), newChildren.begin(), newChildren.end());
+}
+
+//! Sort the codes with a parallel radix sort.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::RadixSort(
+    std::vector<uint64_t>& codes,
+    std::vector<size_t>& order,
+    const size_t bits)
+{
+  const size_t n = codes.size();
+  order.resize(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+
+  // Every block of at least 16384 codes is counted and scattered by its own
+  // thread; the blocks are scattered in order, so the sort is stable.
+  const size_t blocks = std::max((size_t) 1,
+      std::min(Threads::Count(), n / 16384));
+  const size_t blockSize = (n + blocks - 1) / blocks;
+  std::vector<uint64_t> sortedCodes(n);
+  std::vector<size_t> sortedOrder(n);
+  std::vector<size_t> offsets(256 * blocks);
+  for (size_t shift = 0; shift < bits; shift += 8)
+  {
+    std::fill(offsets.begin(), offsets.end(), 0);
+    Threads::ParallelFor(0, blocks, [&](const size_t b)
+    {
+      const size_t end = std::min(n, (b + 1) * blockSize);
+      for (size_t i = b * blockSize; i < end; ++i)
+        ++offsets[256 * b + ((codes[i] >> shift) & 255)];
+    });
+
+    // Turn the counts into the first position of every digit in every block.
+    // If all codes have the same digit, this pass would not move anything.
+    size_t position = 0;
+    bool sameDigit = false;
+    for (size_t digit = 0; digit < 256; ++digit)
+    {
+      const size_t first = position;
+      for (size_t b = 0; b < blocks; ++b)
+      {
+        const size_t digitCount = offsets[256 * b + digit];
+        offsets[256 * b + digit] = position;
+        position += digitCount;
+      }
+
+      if (position - first == n)
+        sameDigit = true;
+    }
+
+    if (sameDigit)
+      continue;
+
+    Threads::ParallelFor(0, blocks, [&](const size_t b)
+    {
+      size_t* blockOffsets = offsets.data() + 256 * b;
+      const size_t end = std::min(n, (b + 1) * blockSize);
+      for (size_t i = b * blockSize; i < end; ++i)
+      {
+        const size_t to = blockOffsets[(codes[i] >> shift) & 255]++;
+        sortedCodes[to] = codes[i];
+        sortedOrder[to] = order[i];
+      }
+    });
+
+    codes.swap(sortedCodes);
+    order.swap(sortedOrder);
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,327 @@
+/**
+ * @file bulk_load.hpp
+ *
+ * Policies that decide how RectangleTree distributes the points when the tree
+ * is bulk loaded: Sort-Tile-Recursive packing, and Hilbert-sort packing for
+ * the Hilbert R tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+// Forward declarations of the auxiliary information that needs special
+// handling.
+template<typename TreeType, template<typename> class HilbertValueType>
+class HilbertRTreeAuxiliaryInformation;
+template<typename TreeElemType>
+class DiscreteHilbertValue;
+template<typename TreeType>
+class RPlusPlusTreeAuxiliaryInformation;
+
+/**
+ * Sort the indices in [begin, end) with the given comparison.  The range is
+ * split into chunks that are sorted in parallel and then merged pairwise.
+ *
+ * @param indices The indices to sort.
+ * @param begin The first index of the range.
+ * @param end One past the last index of the range.
+ * @param compare The comparison to sort with.
+ */
+template<typename CompareType>
+void ParallelSort(std::vector<size_t>& indices,
+                  const size_t begin,
+                  const size_t end,
+                  CompareType compare)
+{
+  // Every chunk holds at least 4096 indices, and the number of chunks is a
+  // power of two.
+  const size_t n = end - begin;
+  size_t chunks = 1;
+  while (2 * chunks <= Threads::Count() && n / (2 * chunks) >= 4096)
+    chunks *= 2;
+
+  if (chunks == 1 || Threads::InParallel())
+  {
+    std::sort(indices.begin() + begin, indices.begin() + end, compare);
+    return;
+  }
+
+  const size_t chunkSize = (n + chunks - 1) / chunks;
+  auto bound = [&](const size_t chunk)
+  {
+    return indices.begin() + begin + std::min(n, chunk * chunkSize);
+  };
+
+  Threads::ParallelFor(0, chunks, [&](const size_t chunk)
+  {
+    std::sort(bound(chunk), bound(chunk + 1), compare);
+  });
+
+  for (size_t width = 1; width < chunks; width *= 2)
+  {
+    Threads::ParallelFor(0, chunks / (2 * width), [&](const size_t pair)
+    {
+      const size_t first = 2 * pair * width;
+      std::inplace_merge(bound(first), bound(first + width),
+          bound(first + 2 * width), compare);
+    });
+  }
+}
+
+/**
+ * Sort-Tile-Recursive (STR) packing.  The points of a node are sorted along
+ * the first dimension and cut into slabs, every slab is sorted along the next
+ * dimension and cut again, and so on, until there is one tile per child.  The
+ * tiles are applied top-down, so the children of a node cover disjoint
+ * regions of space.
+ *
+ * @tparam TreeType The type of the tree being built.
+ */
+template<typename TreeType>
+class SortTileRecursivePacking
+{
+ public:
+  //! The element type held by the tree.
+  typedef typename TreeType::ElemType ElemType;
+
+  /**
+   * Prepare the order of the points before the tree is built.  The tiles are
+   * found per node, so there is nothing to do here.
+   */
+  void Order(const typename TreeType::Mat& /* dataset */,
+             std::vector<size_t>& /* order */)
+  { }
+
+  /**
+   * Distribute the points of a node among the given number of children.  The
+   * points of child i are order[bounds[i]] to order[bounds[i + 1] - 1], and
+   * the region of space assigned to it is cells[i] (the first column holds
+   * the lower and the second column the upper end of every dimension).
+   *
+   * @param dataset The dataset of the tree.
+   * @param order The order of the points; it is modified.
+   * @param begin The first point of the node in the order.
+   * @param end One past the last point of the node in the order.
+   * @param groups The number of children.
+   * @param cell The region of space assigned to the node.
+   * @param bounds The first point of every child (and one past the last).
+   * @param cells The region of space assigned to every child.
+   */
+  void Partition(const typename TreeType::Mat& dataset,
+                 std::vector<size_t>& order,
+                 const size_t begin,
+                 const size_t end,
+                 const size_t groups,
+                 const arma::Mat<ElemType>& cell,
+                 std::vector<size_t>& bounds,
+                 std::vector<arma::Mat<ElemType>>& cells)
+  {
+    bounds.resize(groups + 1);
+    for (size_t i = 0; i <= groups; ++i)
+      bounds[i] = begin + (end - begin) * i / groups;
+
+    cells.assign(groups, cell);
+    Tile(dataset, order, bounds, cells, 0, groups, 0);
+  }
+
+  /**
+   * Update the node once its subtree has been built.  Nothing to do here.
+   */
+  void UpdateNode(TreeType* /* node */, const arma::Mat<ElemType>& /* cell */)
+  { }
+
+ private:
+  /**
+   * Tile the points of the children [firstGroup, lastGroup) along the given
+   * dimension and the following ones.
+   */
+  void Tile(const typename TreeType::Mat& dataset,
+            std::vector<size_t>& order,
+            const std::vector<size_t>& bounds,
+            std::vector<arma::Mat<ElemType>>& cells,
+            const size_t firstGroup,
+            const size_t lastGroup,
+            const size_t dim)
+  {
+    const size_t groups = lastGroup - firstGroup;
+    if (groups <= 1 || dim >= dataset.n_rows)
+      return;
+
+    ParallelSort(order, bounds[firstGroup], bounds[lastGroup],
+        [&](const size_t a, const size_t b)
+        { return dataset(dim, a) < dataset(dim, b); });
+
+    // Use the smallest number of slabs whose power over the remaining
+    // dimensions is at least the number of children; the last dimension gets
+    // one slab per child.
+    const size_t remainingDims = dataset.n_rows - dim;
+    size_t slabs = 1;
+    while (slabs < groups && std::pow((double) slabs, (double) remainingDims) <
+        (double) groups)
+    {
+      ++slabs;
+    }
+
+    size_t first = firstGroup;
+    for (size_t s = 0; s < slabs; ++s)
+    {
+      const size_t last = first + groups / slabs +
+          (s < groups % slabs ? 1 : 0);
+
+      // The cells are split halfway between the neighboring slabs.
+      if (last < lastGroup)
+      {
+        const ElemType split = (dataset(dim, order[bounds[last] - 1]) +
+            dataset(dim, order[bounds[last]])) / 2;
+        for (size_t g = first; g < last; ++g)
+          cells[g](dim, 1) = split;
+        for (size_t g = last; g < lastGroup; ++g)
+          cells[g](dim, 0) = split;
+      }
+
+      Tile(dataset, order, bounds, cells, first, last, dim + 1);
+      first = last;
+    }
+  }
+};
+
+/**
+ * The bulk-loading policy of a RectangleTree, chosen by its auxiliary
+ * information.  By default the points are packed with Sort-Tile-Recursive
+ * packing.
+ *
+ * @tparam TreeType The type of the tree being built.
+ * @tparam AuxiliaryInformationType The auxiliary information of the tree.
+ */
+template<typename TreeType,
+         typename AuxiliaryInformationType =
+             typename TreeType::AuxiliaryInformation>
+class BulkLoadPolicy : public SortTileRecursivePacking<TreeType>
+{ };
+
+/**
+ * The R++ tree is packed with Sort-Tile-Recursive packing as well; the tiles
+ * become the maximum bounding rectangles of the nodes.
+ */
+template<typename TreeType>
+class BulkLoadPolicy<TreeType, RPlusPlusTreeAuxiliaryInformation<TreeType>> :
+    public SortTileRecursivePacking<TreeType>
+{
+ public:
+  //! The element type held by the tree.
+  typedef typename TreeType::ElemType ElemType;
+
+  /**
+   * Use the region of space assigned to the node as its maximum bounding
+   * rectangle.
+   */
+  void UpdateNode(TreeType* node, const arma::Mat<ElemType>& cell)
+  {
+    for (size_t k = 0; k < cell.n_rows; ++k)
+    {
+      node->AuxiliaryInfo().OuterBound()[k].Lo() = cell(k, 0);
+      node->AuxiliaryInfo().OuterBound()[k].Hi() = cell(k, 1);
+    }
+  }
+};
+
+/**
+ * The Hilbert R tree is packed along the Hilbert curve: the points are sorted
+ * by their Hilbert value once, and every node takes a consecutive run of
+ * them.  The Hilbert values of the leaves and the largest Hilbert value of
+ * every node are set up as the insertion would.
+ */
+template<typename TreeType>
+class BulkLoadPolicy<TreeType,
+    HilbertRTreeAuxiliaryInformation<TreeType, DiscreteHilbertValue>>
+{
+ public:
+  //! The element type held by the tree.
+  typedef typename TreeType::ElemType ElemType;
+  //! The type of the Hilbert values.
+  typedef DiscreteHilbertValue<ElemType> HilbertValue;
+
+  /**
+   * Sort the points by their Hilbert value.
+   *
+   * @param dataset The dataset of the tree.
+   * @param order The indices of the points to sort.
+   */
+  void Order(const typename TreeType::Mat& dataset, std::vector<size_t>& order)
+  {
+    values.resize(dataset.n_cols);
+    Threads::ParallelFor(0, order.size(), [&](const size_t i)
+    {
+      values[order[i]] = HilbertValue::CalculateValue(
+          dataset.unsafe_col(order[i]));
+    });
+
+    ParallelSort(order, 0, order.size(), [&](const size_t a, const size_t b)
+        { return HilbertValue::CompareValues(values[a], values[b]) < 0; });
+  }
+
+  /**
+   * Cut the points of a node, which are already in Hilbert order, into
+   * consecutive runs of (almost) the same size.
+   */
+  void Partition(const typename TreeType::Mat& /* dataset */,
+                 std::vector<size_t>& /* order */,
+                 const size_t begin,
+                 const size_t end,
+                 const size_t groups,
+                 const arma::Mat<ElemType>& cell,
+                 std::vector<size_t>& bounds,
+                 std::vector<arma::Mat<ElemType>>& cells)
+  {
+    bounds.resize(groups + 1);
+    for (size_t i = 0; i <= groups; ++i)
+      bounds[i] = begin + (end - begin) * i / groups;
+
+    cells.assign(groups, cell);
+  }
+
+  /**
+   * Store the Hilbert values of the points of a leaf, or point an inner node
+   * to the largest Hilbert value of its last child.
+   */
+  void UpdateNode(TreeType* node, const arma::Mat<ElemType>& /* cell */)
+  {
+    HilbertValue& value = node->AuxiliaryInfo().HilbertValue();
+    if (node->IsLeaf())
+    {
+      for (size_t i = 0; i < node->NumPoints(); ++i)
+        value.LocalHilbertValues()->col(i) = values[node->Point(i)];
+      value.NumValues() = node->NumPoints();
+    }
+    else
+    {
+      // The root is created as a leaf, but only leaves own Hilbert values.
+      if (value.OwnsLocalHilbertValues())
+      {
+        delete value.LocalHilbertValues();
+        value.LocalHilbertValues() = NULL;
+        value.OwnsLocalHilbertValues() = false;
+      }
+
+      value.UpdateLargestValue(node);
+    }
+  }
+
+ private:
+  //! The Hilbert value of every point.
+  std::vector<arma::Col<typename HilbertValue::HilbertElemType>> values;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -20,6 +20,7 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "bulk_load.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -127,13 +128,16 @@ class RectangleTree
    *      have.
    * @param firstDataIndex The index of the first data point.  UNUSED UNLESS WE
    *      ADD SUPPORT FOR HAVING A "CENTERAL" DATA MATRIX.
+   * @param bulkLoad If true, build the tree with bulk loading (see BulkLoad())
+   *      instead of inserting the points one at a time.
    */
   RectangleTree(const MatType& data,
                 const size_t maxLeafSize = 20,
                 const size_t minLeafSize = 8,
                 const size_t maxNumChildren = 5,
                 const size_t minNumChildren = 2,
-                const size_t firstDataIndex = 0);
+                const size_t firstDataIndex = 0,
+                const bool bulkLoad = false);
 
   /**
    * Construct this as the root node of a rectangle tree type using the given
@@ -148,13 +152,16 @@ class RectangleTree
    *      have.
    * @param firstDataIndex The index of the first data point.  UNUSED UNLESS WE
    *      ADD SUPPORT FOR HAVING A "CENTERAL" DATA MATRIX.
+   * @param bulkLoad If true, build the tree with bulk loading (see BulkLoad())
+   *      instead of inserting the points one at a time.
    */
   RectangleTree(MatType&& data,
                 const size_t maxLeafSize = 20,
                 const size_t minLeafSize = 8,
                 const size_t maxNumChildren = 5,
                 const size_t minNumChildren = 2,
-                const size_t firstDataIndex = 0);
+                const size_t firstDataIndex = 0,
+                const bool bulkLoad = false);
 
   /**
    * Construct this as an empty node with the specified parent.  Copying the
@@ -542,6 +549,37 @@ class RectangleTree
    */
   void SplitNode(std::vector<bool>& relevels);
 
+  /**
+   * Build the tree below this (empty) root node from the points with index
+   * firstDataIndex and higher, without inserting them one at a time.  The
+   * points are distributed top-down by the BulkLoadPolicy of the tree:
+   * Sort-Tile-Recursive packing, or Hilbert-sort packing for the Hilbert R
+   * tree.  All leaves are on the same level, and the nodes are filled as
+   * evenly as possible up to their capacity.  The subtrees of the children of
+   * a node are built in parallel.
+   *
+   * @param firstDataIndex The index of the first point to add.
+   */
+  void BulkLoad(const size_t firstDataIndex);
+
+  /**
+   * Build the subtree of this node from the points order[begin] to
+   * order[end - 1].
+   *
+   * @param policy The bulk-loading policy.
+   * @param order The order of the points.
+   * @param begin The first point of the node in the order.
+   * @param end One past the last point of the node in the order.
+   * @param height The height of the subtree (0 for a leaf).
+   * @param cell The region of space assigned to the node.
+   */
+  void BulkLoadNode(BulkLoadPolicy<RectangleTree, AuxiliaryInformation>& policy,
+                    std::vector<size_t>& order,
+                    const size_t begin,
+                    const size_t end,
+                    const size_t height,
+                    const arma::Mat<ElemType>& cell);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
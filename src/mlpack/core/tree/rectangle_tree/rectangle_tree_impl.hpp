@@ -34,7 +34,8 @@ RectangleTree(const MatType& data,
               const size_t minLeafSize,
               const size_t maxNumChildren,
               const size_t minNumChildren,
-              const size_t firstDataIndex) :
+              const size_t firstDataIndex,
+              const bool bulkLoad) :
     maxNumChildren(maxNumChildren),
     minNumChildren(minNumChildren),
     numChildren(0),
@@ -54,6 +55,12 @@ RectangleTree(const MatType& data,
 {
   stat = StatisticType(*this);
 
+  if (bulkLoad)
+  {
+    BulkLoad(firstDataIndex);
+    return;
+  }
+
   // For now, just insert the points in order.
   RectangleTree* root = this;
 
@@ -74,7 +81,8 @@ RectangleTree(MatType&& data,
               const size_t minLeafSize,
               const size_t maxNumChildren,
               const size_t minNumChildren,
-              const size_t firstDataIndex) :
+              const size_t firstDataIndex,
+              const bool bulkLoad) :
     maxNumChildren(maxNumChildren),
     minNumChildren(minNumChildren),
     numChildren(0),
@@ -94,6 +102,12 @@ RectangleTree(MatType&& data,
 {
   stat = StatisticType(*this);
 
+  if (bulkLoad)
+  {
+    BulkLoad(firstDataIndex);
+    return;
+  }
+
   // For now, just insert the points in order.
   RectangleTree* root = this;
 
@@ -893,6 +907,124 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
   }
 }
 
+/**
+ * Build the tree below this root node with bulk loading.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BulkLoad(const size_t firstDataIndex)
+{
+  if (firstDataIndex >= dataset->n_cols)
+    return;
+
+  std::vector<size_t> order(dataset->n_cols - firstDataIndex);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = firstDataIndex + i;
+
+  BulkLoadPolicy<RectangleTree, AuxiliaryInformation> policy;
+  policy.Order(*dataset, order);
+
+  // Find the height of the lowest tree that can hold all points.
+  const size_t fanout = std::max(maxNumChildren, size_t(2));
+  size_t height = 0;
+  for (size_t capacity = maxLeafSize; capacity < order.size();
+       capacity *= fanout)
+    ++height;
+
+  // The root covers the whole space.
+  arma::Mat<ElemType> cell(dataset->n_rows, 2);
+  cell.col(0).fill(std::numeric_limits<ElemType>::lowest());
+  cell.col(1).fill(std::numeric_limits<ElemType>::max());
+
+  BulkLoadNode(policy, order, 0, order.size(), height, cell);
+}
+
+/**
+ * Build the subtree of this node from the given range of points.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BulkLoadNode(BulkLoadPolicy<RectangleTree, AuxiliaryInformation>& policy,
+                 std::vector<size_t>& order,
+                 const size_t begin,
+                 const size_t end,
+                 const size_t height,
+                 const arma::Mat<ElemType>& cell)
+{
+  numDescendants = end - begin;
+
+  if (height == 0)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      points[count++] = order[i];
+      bound |= dataset->col(order[i]);
+    }
+  }
+  else
+  {
+    // Use as few children as possible, and give them the same number of
+    // points.
+    const size_t fanout = std::max(maxNumChildren, size_t(2));
+    size_t childCapacity = maxLeafSize;
+    for (size_t h = 1; h < height; ++h)
+      childCapacity *= fanout;
+    const size_t groups = (end - begin + childCapacity - 1) / childCapacity;
+
+    std::vector<size_t> bounds;
+    std::vector<arma::Mat<ElemType>> cells;
+    policy.Partition(*dataset, order, begin, end, groups, cell, bounds,
+        cells);
+
+    // The auxiliary information of a new node may look at the first child of
+    // its parent to find out whether the new node is a leaf (see
+    // DiscreteHilbertValue).  While the children are created, the first child
+    // is a stand-in of the right kind: this node for inner nodes, and an
+    // empty node for leaves.
+    children[0] = this;
+    numChildren = 1;
+    RectangleTree* leaf = NULL;
+    if (height == 1)
+    {
+      leaf = new RectangleTree(this);
+      children[0] = leaf;
+    }
+
+    std::vector<RectangleTree*> newChildren(groups);
+    for (size_t i = 0; i < groups; ++i)
+      newChildren[i] = new RectangleTree(this);
+
+    delete leaf;
+    for (size_t i = 0; i < groups; ++i)
+      children[i] = newChildren[i];
+    numChildren = groups;
+
+    Threads::ParallelFor(0, groups, [&](const size_t i)
+    {
+      children[i]->BulkLoadNode(policy, order, bounds[i], bounds[i + 1],
+          height - 1, cells[i]);
+    });
+
+    for (size_t i = 0; i < numChildren; ++i)
+      bound |= children[i]->Bound();
+  }
+
+  policy.UpdateNode(this, cell);
+  stat = StatisticType(*this);
+}
+
 //! Default constructor for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -0,0 +1,189 @@
+/**
+ * @file memory_usage.cpp
+ *
+ * Implementation of MemoryUsage.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "memory_usage.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+  #include <sys/resource.h>
+#endif
+
+using namespace mlpack;
+using namespace std;
+
+std::atomic<bool> MemoryUsage::enabled(false);
+
+namespace {
+
+//! The resident memory of the process when a phase was started.
+struct PhaseStart
+{
+  size_t resident;
+  size_t peak;
+};
+
+//! The statistics of all phases, the started phases of every thread, and the
+//! mutex that protects them.
+struct MemoryUsageRegistry
+{
+  mutex lock;
+  map<string, PhaseMemory> phases;
+  map<pair<thread::id, string>, PhaseStart> started;
+};
+
+MemoryUsageRegistry& Registry()
+{
+  static MemoryUsageRegistry registry;
+  return registry;
+}
+
+#ifdef __linux__
+//! Read the given field (in kB) of /proc/self/status, in bytes.
+size_t ReadStatus(const string& field)
+{
+  ifstream status("/proc/self/status");
+  string line;
+  while (getline(status, line))
+  {
+    if (line.compare(0, field.size(), field) == 0)
+    {
+      istringstream value(line.substr(field.size()));
+      size_t kb = 0;
+      value >> kb;
+      return kb * 1024;
+    }
+  }
+
+  return 0;
+}
+#endif
+
+} // namespace
+
+size_t MemoryUsage::Resident()
+{
+  #ifdef __linux__
+  return ReadStatus("VmRSS:");
+  #else
+  return 0;
+  #endif
+}
+
+size_t MemoryUsage::PeakResident()
+{
+  #if defined(__linux__)
+  return ReadStatus("VmHWM:");
+  #elif !defined(_WIN32)
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+  #if defined(__APPLE__)
+  return (size_t) usage.ru_maxrss; // In bytes.
+  #else
+  return (size_t) usage.ru_maxrss * 1024; // In kB.
+  #endif
+  #else
+  return 0;
+  #endif
+}
+
+void MemoryUsage::StartPhase(const string& name)
+{
+  PhaseStart start;
+  start.resident = Resident();
+  start.peak = PeakResident();
+
+  MemoryUsageRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+  registry.started[make_pair(this_thread::get_id(), name)] = start;
+}
+
+void MemoryUsage::StopPhase(const string& name)
+{
+  const size_t resident = Resident();
+  const size_t peak = PeakResident();
+
+  MemoryUsageRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+  map<pair<thread::id, string>, PhaseStart>::iterator it =
+      registry.started.find(make_pair(this_thread::get_id(), name));
+  if (it == registry.started.end())
+    return;
+
+  PhaseMemory& phase = registry.phases[name];
+  ++phase.calls;
+  phase.residentChange += (long long) resident - (long long) it->second.resident;
+  if (peak > it->second.peak)
+    phase.peakIncrease += peak - it->second.peak;
+  if (peak > phase.peak)
+    phase.peak = peak;
+
+  registry.started.erase(it);
+}
+
+map<string, PhaseMemory> MemoryUsage::GetAll()
+{
+  MemoryUsageRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+  return registry.phases;
+}
+
+void MemoryUsage::Print(ostream& stream, const string& indent)
+{
+  const map<string, PhaseMemory> phases = GetAll();
+  for (map<string, PhaseMemory>::const_iterator it = phases.begin();
+      it != phases.end(); ++it)
+  {
+    const PhaseMemory& phase = it->second;
+    stream << indent << it->first << ": resident "
+        << (phase.residentChange < 0 ? "-" : "+")
+        << FormatBytes((double) (phase.residentChange < 0 ?
+            -phase.residentChange : phase.residentChange))
+        << ", peak +" << FormatBytes((double) phase.peakIncrease)
+        << " (process peak " << FormatBytes((double) phase.peak) << ")"
+        << endl;
+  }
+
+  stream << indent << "peak resident memory: "
+      << FormatBytes((double) PeakResident()) << endl;
+}
+
+void MemoryUsage::Reset()
+{
+  MemoryUsageRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+  registry.phases.clear();
+  registry.started.clear();
+}
+
+string MemoryUsage::FormatBytes(const double bytes)
+{
+  const char* units[] = { "B", "kB", "MB", "GB", "TB" };
+  size_t unit = 0;
+  double value = bytes;
+  while (value >= 1024.0 && unit < 4)
+  {
+    value /= 1024.0;
+    ++unit;
+  }
+
+  ostringstream oss;
+  if (unit == 0)
+    oss << (size_t) value << " " << units[unit];
+  else
+    oss << fixed << setprecision(1) << value << " " << units[unit];
+  return oss.str();
+}
@@ -0,0 +1,170 @@
+/**
+ * @file memory_usage.hpp
+ *
+ * Accounting of the memory used by the process during each phase, and of the
+ * memory held by models.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_MEMORY_USAGE_HPP
+#define MLPACK_CORE_UTIL_MEMORY_USAGE_HPP
+
+#include <mlpack/mlpack_export.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/nvp.hpp>
+
+namespace mlpack {
+
+/**
+ * The memory used by the process during one or more runs of a phase.
+ */
+struct PhaseMemory
+{
+  //! Create empty statistics.
+  PhaseMemory() : calls(0), residentChange(0), peakIncrease(0), peak(0) { }
+
+  //! Number of times the phase was run.
+  size_t calls;
+  //! Total change of the resident memory (in bytes) over the runs; memory that
+  //! is still held after a phase (e.g. a built tree) shows up here.
+  long long residentChange;
+  //! Total increase of the peak resident memory (in bytes) during the runs;
+  //! this is how much higher the process peak went because of the phase.
+  size_t peakIncrease;
+  //! Peak resident memory of the process (in bytes) at the end of the phase.
+  size_t peak;
+};
+
+/**
+ * MemoryUsage tells where the memory of the process goes.  When it is enabled
+ * (the command-line programs enable it with --verbose), each phase timed with
+ * Timer::Start() and Timer::Stop() also records the change of the resident
+ * memory of the process and the increase of its peak, so that the phases that
+ * need the most memory (e.g. loading, tree building, bootstrapping) can be
+ * found.  The results are printed with the timers.
+ *
+ * The memory of a model (e.g. an NSModel, RandomForest or FFN, or a tree) can
+ * be estimated with ModelBytes(), which counts the bytes of its binary
+ * serialization: that holds every matrix, node and parameter of the model.
+ *
+ * The resident memory is read from the operating system; on systems where it
+ * is not available (everything but Linux for the current resident memory),
+ * the functions return 0.
+ */
+class MemoryUsage
+{
+ public:
+  //! Get the current resident memory of the process, in bytes.
+  static size_t Resident();
+
+  //! Get the peak resident memory of the process, in bytes.
+  static size_t PeakResident();
+
+  //! Enable the accounting of phases.
+  static void Enable() { enabled = true; }
+  //! Disable the accounting of phases.
+  static void Disable() { enabled = false; }
+  //! Return whether the accounting of phases is enabled.
+  static bool Enabled() { return enabled; }
+
+  /**
+   * Start the given phase on the calling thread.  Timer::Start() calls this.
+   *
+   * @param name Name of the phase.
+   */
+  static void StartPhase(const std::string& name);
+
+  /**
+   * Stop the given phase on the calling thread, and record its memory.
+   * Timer::Stop() calls this.  If the phase was not started, nothing is done.
+   *
+   * @param name Name of the phase.
+   */
+  static void StopPhase(const std::string& name);
+
+  //! Get a copy of the memory statistics of every phase.
+  static std::map<std::string, PhaseMemory> GetAll();
+
+  /**
+   * Print the memory statistics of every phase, one line per phase, followed
+   * by the peak resident memory of the process.
+   *
+   * @param stream Stream to print to.
+   * @param indent Indentation of each line.
+   */
+  static void Print(std::ostream& stream, const std::string& indent = "  ");
+
+  //! Remove the statistics of every phase, and forget started phases.
+  static void Reset();
+
+  /**
+   * Estimate the memory held by the given model, in bytes, as the size of its
+   * binary serialization.  Nothing is written anywhere.
+   *
+   * @param model Model (or any serializable object) to measure.
+   */
+  template<typename T>
+  static size_t ModelBytes(const T& model);
+
+  //! Format the given number of bytes for printing (e.g. "1.5 MB").
+  static std::string FormatBytes(const double bytes);
+
+ private:
+  //! A stream buffer that only counts the characters written to it.
+  class CountingBuffer : public std::streambuf
+  {
+   public:
+    CountingBuffer() : count(0) { }
+
+    size_t Count() const { return count; }
+
+   protected:
+    std::streamsize xsputn(const char* /* s */, std::streamsize n)
+    {
+      count += (size_t) n;
+      return n;
+    }
+
+    int_type overflow(int_type c)
+    {
+      if (!traits_type::eq_int_type(c, traits_type::eof()))
+        ++count;
+      return traits_type::not_eof(c);
+    }
+
+   private:
+    size_t count;
+  };
+
+  //! Whether the accounting of phases is enabled.
+  static MLPACK_EXPORT std::atomic<bool> enabled;
+};
+
+template<typename T>
+size_t MemoryUsage::ModelBytes(const T& model)
+{
+  CountingBuffer buffer;
+  {
+    std::ostream stream(&buffer);
+    boost::archive::binary_oarchive ar(stream,
+        boost::archive::no_header | boost::archive::no_codecvt);
+    ar << boost::serialization::make_nvp("model", model);
+  }
+
+  return buffer.Count();
+}
+
+} // namespace mlpack
+
+#endif
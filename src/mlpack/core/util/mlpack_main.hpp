@@ -52,6 +52,7 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 static void mlpackMain(); // This is typically defined after this include.
 
@@ -62,6 +63,13 @@ int main(int argc, char** argv)
   // Enable timing.
   mlpack::Timer::EnableTiming();
 
+  // With --serve, the runs are read from stdin, and loaded models are kept.
+  if (mlpack::CLI::HasParam("serve"))
+  {
+    mlpack::bindings::cli::Serve(argv[0], &mlpackMain);
+    return 0;
+  }
+
   // A "total_time" timer is run by default for each mlpack program.
   mlpack::Timer::Start("total_time");
 
@@ -145,6 +153,12 @@ PARAM_FLAG("copy_all_inputs", "If specified, all input parameters will be deep"
     " copied before the method is run.  This is useful for debugging problems "
     "where the input parameters are being modified by the algorithm, but can "
     "slow down the code.", "");
+PARAM_INT_IN("threads", "Number of threads to use for parallel computation (0 "
+    "uses all cores).  The setting is kept for later calls; if it is never "
+    "given, the OMP_NUM_THREADS environment variable is respected.", "", 0);
+PARAM_FLAG("numa", "If specified, the threads are pinned to the cores, spread "
+    "over the sockets, and large matrices are placed on the NUMA nodes of the "
+    "threads that read them.  The setting is kept for later calls.", "");
 
 // Nothing else needs to be defined---the binding will use mlpackMain() as-is.
 
@@ -0,0 +1,273 @@
+/**
+ * @file profiler.cpp
+ *
+ * Implementation of the Profiler.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "profiler.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using namespace mlpack;
+using namespace std;
+using namespace chrono;
+
+std::atomic<bool> Profiler::enabled(false);
+std::atomic<bool> Profiler::recordTrace(false);
+
+namespace {
+
+typedef steady_clock Clock;
+
+//! A node of the call tree of a thread.
+struct ProfileNode
+{
+  //! The call site of the scope (or SIZE_MAX for the root).
+  size_t site;
+  //! The index of the parent node.
+  size_t parent;
+  //! Number of times the scope was entered.
+  size_t count;
+  //! Total time spent in the scope.
+  Clock::duration time;
+  //! Pairs of call sites and node indices of the children.
+  vector<pair<size_t, size_t>> children;
+  //! Time the scope was last entered.
+  Clock::time_point start;
+};
+
+//! A recorded scope, for the trace.
+struct TraceEvent
+{
+  size_t site;
+  Clock::time_point start;
+  Clock::duration time;
+};
+
+//! The results of one thread.
+struct ThreadProfile
+{
+  //! Index of the thread, in the order threads entered their first scope.
+  size_t index;
+  //! The call tree; node 0 is the root.
+  vector<ProfileNode> nodes;
+  //! The node of the innermost open scope.
+  size_t current;
+  //! Recorded scopes.
+  vector<TraceEvent> events;
+};
+
+//! Names of the registered call sites, the profiles of all threads, and the
+//! time the profiler started.  Only accessed with the mutex held.
+struct ProfilerRegistry
+{
+  mutex lock;
+  vector<string> names;
+  vector<shared_ptr<ThreadProfile>> threads;
+  Clock::time_point epoch = Clock::now();
+};
+
+ProfilerRegistry& Registry()
+{
+  static ProfilerRegistry registry;
+  return registry;
+}
+
+//! Create a call tree holding only the root.
+void ResetNodes(vector<ProfileNode>& nodes)
+{
+  nodes.clear();
+  nodes.push_back(ProfileNode { SIZE_MAX, 0, 0, Clock::duration::zero(),
+      vector<pair<size_t, size_t>>(), Clock::time_point() });
+}
+
+//! Get the results of the calling thread, creating them on the first call.
+//! The registry shares ownership, so results outlive their thread.
+ThreadProfile& LocalProfile()
+{
+  thread_local shared_ptr<ThreadProfile> local;
+  if (!local)
+  {
+    local = make_shared<ThreadProfile>();
+    ResetNodes(local->nodes);
+    local->current = 0;
+
+    ProfilerRegistry& registry = Registry();
+    lock_guard<mutex> lock(registry.lock);
+    local->index = registry.threads.size();
+    registry.threads.push_back(local);
+  }
+
+  return *local;
+}
+
+//! Get the child of the given node for the given call site, creating it if
+//! necessary.
+size_t Child(vector<ProfileNode>& nodes, const size_t node, const size_t site)
+{
+  for (size_t i = 0; i < nodes[node].children.size(); ++i)
+    if (nodes[node].children[i].first == site)
+      return nodes[node].children[i].second;
+
+  const size_t child = nodes.size();
+  nodes.push_back(ProfileNode { site, node, 0, Clock::duration::zero(),
+      vector<pair<size_t, size_t>>(), Clock::time_point() });
+  nodes[node].children.push_back(make_pair(site, child));
+  return child;
+}
+
+//! Add the subtree of a thread's call tree to the merged call tree.
+void Merge(vector<ProfileNode>& merged,
+           const size_t mergedNode,
+           const vector<ProfileNode>& nodes,
+           const size_t node)
+{
+  merged[mergedNode].count += nodes[node].count;
+  merged[mergedNode].time += nodes[node].time;
+  for (size_t i = 0; i < nodes[node].children.size(); ++i)
+  {
+    const size_t child = Child(merged, mergedNode,
+        nodes[node].children[i].first);
+    Merge(merged, child, nodes, nodes[node].children[i].second);
+  }
+}
+
+//! Print the subtree of the merged call tree.
+void PrintNode(ostream& stream,
+               const vector<ProfileNode>& nodes,
+               const vector<string>& names,
+               const size_t node,
+               const string& indent)
+{
+  for (size_t i = 0; i < nodes[node].children.size(); ++i)
+  {
+    const ProfileNode& child = nodes[nodes[node].children[i].second];
+    stream << indent << names[child.site] << ": " << fixed
+        << setprecision(6) << duration<double>(child.time).count() << "s ("
+        << child.count << (child.count == 1 ? " call" : " calls") << ")"
+        << endl;
+    PrintNode(stream, nodes, names, nodes[node].children[i].second,
+        indent + "  ");
+  }
+}
+
+//! Write the given string as a JSON string.
+void WriteJSONString(ostream& stream, const string& str)
+{
+  stream << '"';
+  for (size_t i = 0; i < str.size(); ++i)
+  {
+    if (str[i] == '"' || str[i] == '\\')
+      stream << '\\';
+    stream << str[i];
+  }
+  stream << '"';
+}
+
+} // namespace
+
+size_t Profiler::Register(const string& name)
+{
+  ProfilerRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+  registry.names.push_back(name);
+  return registry.names.size() - 1;
+}
+
+void Profiler::Enter(const size_t site)
+{
+  ThreadProfile& profile = LocalProfile();
+  profile.current = Child(profile.nodes, profile.current, site);
+  profile.nodes[profile.current].start = Clock::now();
+}
+
+void Profiler::Exit()
+{
+  const Clock::time_point end = Clock::now();
+  ThreadProfile& profile = LocalProfile();
+  // The results may have been reset while the scope was open.
+  if (profile.current == 0)
+    return;
+
+  ProfileNode& node = profile.nodes[profile.current];
+  ++node.count;
+  node.time += end - node.start;
+  if (RecordTrace())
+    profile.events.push_back(TraceEvent { node.site, node.start,
+        end - node.start });
+
+  profile.current = node.parent;
+}
+
+void Profiler::Print(ostream& stream, const string& indent)
+{
+  ProfilerRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+
+  vector<ProfileNode> merged;
+  ResetNodes(merged);
+  for (size_t t = 0; t < registry.threads.size(); ++t)
+    Merge(merged, 0, registry.threads[t]->nodes, 0);
+
+  const ios::fmtflags flags = stream.flags();
+  const streamsize precision = stream.precision();
+  PrintNode(stream, merged, registry.names, 0, indent);
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+void Profiler::ExportTrace(ostream& stream)
+{
+  ProfilerRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+
+  const ios::fmtflags flags = stream.flags();
+  const streamsize precision = stream.precision();
+  stream << fixed << setprecision(3);
+
+  // Timestamps and durations are in microseconds.
+  stream << "{\"traceEvents\": [";
+  bool first = true;
+  for (size_t t = 0; t < registry.threads.size(); ++t)
+  {
+    const ThreadProfile& profile = *registry.threads[t];
+    for (size_t i = 0; i < profile.events.size(); ++i)
+    {
+      const TraceEvent& event = profile.events[i];
+      stream << (first ? "\n" : ",\n") << "  {\"name\": ";
+      WriteJSONString(stream, registry.names[event.site]);
+      stream << ", \"ph\": \"X\", \"ts\": "
+          << duration<double, micro>(event.start - registry.epoch).count()
+          << ", \"dur\": " << duration<double, micro>(event.time).count()
+          << ", \"pid\": 0, \"tid\": " << profile.index << "}";
+      first = false;
+    }
+  }
+  stream << "\n], \"displayTimeUnit\": \"ms\"}" << endl;
+
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+void Profiler::Reset()
+{
+  ProfilerRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+  for (size_t t = 0; t < registry.threads.size(); ++t)
+  {
+    ResetNodes(registry.threads[t]->nodes);
+    registry.threads[t]->current = 0;
+    registry.threads[t]->events.clear();
+  }
+  registry.epoch = Clock::now();
+}
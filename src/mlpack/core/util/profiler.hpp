@@ -0,0 +1,168 @@
+/**
+ * @file profiler.hpp
+ *
+ * Low-overhead hierarchical profiling of scopes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PROFILER_HPP
+#define MLPACK_CORE_UTIL_PROFILER_HPP
+
+#include <mlpack/mlpack_export.hpp>
+
+#include <atomic>
+#include <ostream>
+#include <string>
+
+namespace mlpack {
+
+/**
+ * The Profiler times scopes of code, and is cheap enough to be used inside hot
+ * loops, where Timer (which looks up named timers behind a mutex) is too
+ * costly.  A scope is instrumented with the MLPACK_PROFILE_SCOPE() macro:
+ *
+ * @code
+ * for (size_t i = 0; i < iterations; ++i)
+ * {
+ *   MLPACK_PROFILE_SCOPE("iteration");
+ *   ...
+ * }
+ * @endcode
+ *
+ * Each call site is registered once, the first time it is reached, and gets
+ * a numeric ID; after that, entering and leaving a scope only touches data
+ * that belongs to the calling thread, so no lock is taken.  Scopes nest: the
+ * time of a scope is accumulated under the scopes that are open when it is
+ * entered, so the results form a call tree, which can be printed with Print().
+ * If RecordTrace() is set, every scope is also recorded as an event, and the
+ * timeline can be written with ExportTrace() in the Chrome trace format (which
+ * can be opened in chrome://tracing or Perfetto).
+ *
+ * Profiling is enabled along with timing (see Timer::EnableTiming()).  When
+ * mlpack is compiled with MLPACK_NO_PROFILING defined (the SCOPED_PROFILING
+ * CMake option), MLPACK_PROFILE_SCOPE() compiles to nothing.
+ *
+ * The results of a thread are read by Print() and ExportTrace() without
+ * synchronization, so those should only be called when no other thread is
+ * inside a profiled scope (e.g. after a parallel region has finished).
+ */
+class Profiler
+{
+ public:
+  /**
+   * Register a call site with the given name, and return its ID.  Several
+   * call sites may have the same name; they are reported separately.
+   *
+   * @param name Name of the call site.
+   */
+  static size_t Register(const std::string& name);
+
+  /**
+   * Enter the scope of the given call site on the calling thread.  Use
+   * MLPACK_PROFILE_SCOPE() instead of calling this directly.
+   *
+   * @param site ID of the call site, as returned by Register().
+   */
+  static void Enter(const size_t site);
+
+  /**
+   * Leave the innermost open scope of the calling thread.
+   */
+  static void Exit();
+
+  //! Enable profiling.  Scopes that are already open are not timed.
+  static void Enable() { enabled = true; }
+  //! Disable profiling.
+  static void Disable() { enabled = false; }
+  //! Get whether profiling is enabled.
+  static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+  //! Set whether each scope is recorded as an event for ExportTrace().
+  static void RecordTrace(const bool record) { recordTrace = record; }
+  //! Get whether each scope is recorded as an event for ExportTrace().
+  static bool RecordTrace()
+  { return recordTrace.load(std::memory_order_relaxed); }
+
+  /**
+   * Print the call tree of the profiled scopes, summed over all threads: for
+   * each scope, its total time and the number of times it was entered.
+   *
+   * @param stream Stream to print to.
+   * @param indent Indentation of the top-level scopes.
+   */
+  static void Print(std::ostream& stream, const std::string& indent = "  ");
+
+  /**
+   * Write the recorded events as JSON in the Chrome trace event format, one
+   * track per thread.  Nothing is recorded unless RecordTrace() is set.
+   *
+   * @param stream Stream to write to.
+   */
+  static void ExportTrace(std::ostream& stream);
+
+  /**
+   * Remove the results of all threads.  Registered call sites are kept.  Do
+   * not run this while scopes are open!
+   */
+  static void Reset();
+
+ private:
+  //! Whether profiling is enabled.
+  static MLPACK_EXPORT std::atomic<bool> enabled;
+  //! Whether each scope is recorded as an event.
+  static MLPACK_EXPORT std::atomic<bool> recordTrace;
+};
+
+/**
+ * Times the enclosing scope: the scope is entered on construction and left on
+ * destruction.  Use MLPACK_PROFILE_SCOPE() instead of this directly.
+ */
+class ProfileScope
+{
+ public:
+  //! Enter the scope of the given call site, if profiling is enabled.
+  ProfileScope(const size_t site) : active(Profiler::Enabled())
+  {
+    if (active)
+      Profiler::Enter(site);
+  }
+
+  //! Leave the scope.
+  ~ProfileScope()
+  {
+    if (active)
+      Profiler::Exit();
+  }
+
+  // Scopes can't be copied, or they would be left twice.
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+ private:
+  //! Whether the scope was entered.
+  bool active;
+};
+
+} // namespace mlpack
+
+#define MLPACK_PROFILE_CONCAT_INNER(A, B) A##B
+#define MLPACK_PROFILE_CONCAT(A, B) MLPACK_PROFILE_CONCAT_INNER(A, B)
+
+#ifndef MLPACK_NO_PROFILING
+/**
+ * Profile the rest of the enclosing scope under the given name.  The call site
+ * is registered the first time it is reached.
+ */
+#define MLPACK_PROFILE_SCOPE(NAME) \
+    static const size_t MLPACK_PROFILE_CONCAT(mlpackProfileSite, __LINE__) = \
+        mlpack::Profiler::Register(NAME); \
+    mlpack::ProfileScope MLPACK_PROFILE_CONCAT(mlpackProfileScope, \
+        __LINE__)(MLPACK_PROFILE_CONCAT(mlpackProfileSite, __LINE__))
+#else
+#define MLPACK_PROFILE_SCOPE(NAME)
+#endif
+
+#endif
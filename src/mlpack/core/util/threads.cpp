@@ -0,0 +1,193 @@
+/**
+ * @file threads.cpp
+ *
+ * Implementation of Threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include "threads.hpp"
+
+#include <fstream>
+#include <thread>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+// Threads are pinned with sched_setaffinity(), which is specific to Linux.
+#if defined(__linux__) && defined(HAS_OPENMP)
+  #include <sched.h>
+  #define MLPACK_THREADS_PIN
+#endif
+
+// OpenBLAS and MKL let the number of threads be set at runtime.  They are
+// referenced weakly, so that nothing is required from other BLAS libraries.
+#if defined(__linux__) && defined(__GNUC__)
+extern "C"
+{
+  void openblas_set_num_threads(int) __attribute__((weak));
+  void MKL_Set_Num_Threads(int) __attribute__((weak));
+}
+#define MLPACK_THREADS_SET_BLAS
+#endif
+
+using namespace mlpack;
+
+bool Threads::numaAware = false;
+
+#ifdef MLPACK_THREADS_PIN
+namespace {
+
+// Get the cores the process may run on, ordered by socket (physical package).
+// They are read once, before any thread is pinned.
+const std::vector<int>& Cores()
+{
+  static std::vector<int> cores;
+  static bool read = false;
+  if (!read)
+  {
+    read = true;
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+      return cores;
+
+    std::vector<std::pair<size_t, int>> packageCores;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+      if (!CPU_ISSET(cpu, &allowed))
+        continue;
+
+      // If the topology is unknown, all cores are taken to be in package 0.
+      size_t package = 0;
+      std::ifstream topology("/sys/devices/system/cpu/cpu" +
+          std::to_string(cpu) + "/topology/physical_package_id");
+      if (!(topology >> package))
+        package = 0;
+      packageCores.push_back(std::make_pair(package, cpu));
+    }
+
+    std::sort(packageCores.begin(), packageCores.end());
+    for (size_t i = 0; i < packageCores.size(); ++i)
+      cores.push_back(packageCores[i].second);
+  }
+
+  return cores;
+}
+
+// Pin thread i of t to core (i * cores / t), so that the threads are spread
+// evenly over the sockets and neighbouring threads share a socket; or, if pin
+// is false, let every thread run on all the cores again.
+void PinThreads(const bool pin)
+{
+  const std::vector<int>& cores = Cores();
+  if (cores.empty())
+    return;
+
+  #pragma omp parallel
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pin)
+    {
+      const size_t thread = (size_t) omp_get_thread_num();
+      const size_t threads = (size_t) omp_get_num_threads();
+      CPU_SET(cores[thread * cores.size() / threads], &set);
+    }
+    else
+    {
+      for (size_t i = 0; i < cores.size(); ++i)
+        CPU_SET(cores[i], &set);
+    }
+
+    // With a pid of 0, only the calling thread is affected.
+    sched_setaffinity(0, sizeof(set), &set);
+  }
+}
+
+} // namespace
+#endif
+
+void Threads::SetCount(const size_t count)
+{
+  const int threads = (int) (count == 0 ? Available() : count);
+
+  #ifdef HAS_OPENMP
+  omp_set_num_threads(threads);
+  #if defined(_OPENMP) && (_OPENMP >= 200805)
+  // Nested sections would oversubscribe the cores.
+  omp_set_max_active_levels(1);
+  #endif
+  #endif
+
+  #ifdef MLPACK_THREADS_SET_BLAS
+  if (openblas_set_num_threads)
+    openblas_set_num_threads(threads);
+  if (MKL_Set_Num_Threads)
+    MKL_Set_Num_Threads(threads);
+  #endif
+
+  #ifdef MLPACK_THREADS_PIN
+  // The new threads of the pool must be pinned too.
+  if (numaAware)
+    PinThreads(true);
+  #endif
+}
+
+size_t Threads::Count()
+{
+  #ifdef HAS_OPENMP
+  return (size_t) omp_get_max_threads();
+  #else
+  return 1;
+  #endif
+}
+
+size_t Threads::Available()
+{
+  #ifdef MLPACK_THREADS_PIN
+  // The OpenMP runtime counts the cores of the calling thread, which is pinned
+  // to a single one.
+  if (numaAware && !Cores().empty())
+    return Cores().size();
+  #endif
+
+  #ifdef HAS_OPENMP
+  return (size_t) omp_get_num_procs();
+  #else
+  const size_t cores = std::thread::hardware_concurrency();
+  return (cores == 0) ? 1 : cores;
+  #endif
+}
+
+bool Threads::InParallel()
+{
+  #ifdef HAS_OPENMP
+  return omp_in_parallel() != 0;
+  #else
+  return false;
+  #endif
+}
+
+size_t Threads::Ranges(const size_t begin, const size_t end)
+{
+  if (InParallel() || end <= begin + 1)
+    return 1;
+
+  return std::min(Count(), end - begin);
+}
+
+void Threads::SetNumaAware(const bool numaAware)
+{
+  #ifdef MLPACK_THREADS_PIN
+  // Read the cores before any thread is pinned.
+  Cores();
+  if (numaAware || Threads::numaAware)
+    PinThreads(numaAware);
+  #endif
+
+  Threads::numaAware = numaAware;
+}
@@ -0,0 +1,291 @@
+/**
+ * @file threads.hpp
+ *
+ * Control of the number of threads mlpack uses, and a parallel loop that
+ * respects it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_THREADS_HPP
+#define MLPACK_CORE_UTIL_THREADS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+
+/**
+ * Threads controls how many threads the parallel parts of mlpack use.  The
+ * count is set once for the whole process (the command-line programs and the
+ * bindings do that with their `threads` option); the existing OpenMP sections
+ * follow it, and new parallel code should use ParallelFor():
+ *
+ * @code
+ * Threads::ParallelFor(0, data.n_cols, [&](const size_t i)
+ * {
+ *   results[i] = Evaluate(data.col(i));
+ * });
+ * @endcode
+ *
+ * Nested parallelism is avoided: a ParallelFor() that is reached from inside a
+ * parallel section runs serially on the calling thread, so parallel methods can
+ * be combined (e.g. a parallel cross-validation of a parallel learner) without
+ * oversubscribing the cores.  SetCount() also limits the threads of the BLAS
+ * library used by Armadillo if it is OpenBLAS or MKL; a BLAS built on OpenMP
+ * runs serially inside a parallel section.
+ *
+ * On machines with several NUMA nodes (sockets), SetNumaAware() pins the
+ * threads to the cores, spread evenly over the sockets, and enables placement
+ * of large matrices: FirstTouch() moves the columns of a matrix to the nodes of
+ * the threads that ParallelRanges() gives them to, and Interleave() spreads a
+ * matrix that every thread reads (such as a reference set) page by page over
+ * all the nodes.  data::Load() calls FirstTouch() on the matrices it loads.
+ * Both are no-ops unless NUMA awareness is enabled.
+ *
+ * If mlpack is compiled without OpenMP, everything runs on the calling thread.
+ */
+class Threads
+{
+ public:
+  /**
+   * Set the number of threads that parallel sections use, for the whole
+   * process.  If the count is 0, all available cores are used.
+   *
+   * @param count Number of threads.
+   */
+  static void SetCount(const size_t count);
+
+  //! Get the number of threads that a parallel section would use.
+  static size_t Count();
+
+  //! Get the number of available cores.
+  static size_t Available();
+
+  //! Return whether the calling thread is inside a parallel section.
+  static bool InParallel();
+
+  /**
+   * Call the given function for every index in [begin, end), in parallel,
+   * with dynamic scheduling.  The calls must be independent.  If a call throws
+   * an exception, the remaining indices are skipped, and the first exception
+   * is rethrown on the calling thread.
+   *
+   * @param begin First index.
+   * @param end One past the last index.
+   * @param function Function to call with each index.
+   */
+  template<typename FunctionType>
+  static void ParallelFor(const size_t begin,
+                          const size_t end,
+                          FunctionType function);
+
+  /**
+   * Get the number of ranges that ParallelRanges() cuts [begin, end) into: one
+   * per thread, at most one per index, and at least one.
+   */
+  static size_t Ranges(const size_t begin, const size_t end);
+
+  /**
+   * Cut [begin, end) into Ranges(begin, end) contiguous ranges of about equal
+   * size, and call the given function with the index of each range and its
+   * bounds, in parallel; range i is handled by thread i, so with pinned
+   * threads the same range always runs on the same core.  Exceptions are
+   * handled like in ParallelFor().
+   *
+   * @param begin First index.
+   * @param end One past the last index.
+   * @param function Function to call as function(range, rangeBegin, rangeEnd).
+   */
+  template<typename FunctionType>
+  static void ParallelRanges(const size_t begin,
+                             const size_t end,
+                             FunctionType function);
+
+  /**
+   * Enable or disable NUMA awareness, for the whole process.  When it is
+   * enabled, the threads are pinned to the cores (again whenever SetCount() is
+   * called), and FirstTouch() and Interleave() move matrices; when it is
+   * disabled, the threads may run on any core again.  Pinning is only
+   * available on Linux.  This must not be called from a parallel section.
+   *
+   * @param numaAware Whether to enable NUMA awareness.
+   */
+  static void SetNumaAware(const bool numaAware);
+
+  //! Return whether NUMA awareness is enabled.
+  static bool NumaAware() { return numaAware; }
+
+  /**
+   * If NUMA awareness is enabled, move the given matrix to new memory whose
+   * columns are first written by the threads of ParallelRanges() over the
+   * columns, so that each range of columns is on the NUMA node of the thread
+   * that handles it.
+   *
+   * @param matrix Matrix to move.
+   */
+  template<typename eT>
+  static void FirstTouch(arma::Mat<eT>& matrix);
+
+  /**
+   * If NUMA awareness is enabled, move the given matrix to new memory whose
+   * pages are first written by every thread in turn, so that they are spread
+   * over all the NUMA nodes.  This suits matrices that all the threads read in
+   * no particular order, such as reference sets.
+   *
+   * @param matrix Matrix to move.
+   */
+  template<typename eT>
+  static void Interleave(arma::Mat<eT>& matrix);
+
+ private:
+  //! Whether NUMA awareness is enabled.
+  static bool numaAware;
+};
+
+template<typename FunctionType>
+void Threads::ParallelFor(const size_t begin,
+                          const size_t end,
+                          FunctionType function)
+{
+  #ifdef HAS_OPENMP
+  if (end > begin + 1 && Count() > 1 && !InParallel())
+  {
+    // Exceptions cannot leave an OpenMP section, so they are kept and
+    // rethrown afterwards.
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+    {
+      if (failed)
+        continue;
+
+      try
+      {
+        function((size_t) i);
+      }
+      catch (...)
+      {
+        #pragma omp critical(mlpack_threads_parallel_for)
+        {
+          if (!error)
+            error = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+
+    if (error)
+      std::rethrow_exception(error);
+    return;
+  }
+  #endif
+
+  for (size_t i = begin; i < end; ++i)
+    function(i);
+}
+
+template<typename FunctionType>
+void Threads::ParallelRanges(const size_t begin,
+                             const size_t end,
+                             FunctionType function)
+{
+  #ifdef HAS_OPENMP
+  const size_t numRanges = Ranges(begin, end);
+  if (numRanges > 1)
+  {
+    const size_t count = end - begin;
+    std::exception_ptr error;
+
+    #pragma omp parallel num_threads((int) numRanges)
+    {
+      // The runtime may give fewer threads than requested.
+      const size_t threads = (size_t) omp_get_num_threads();
+      for (size_t range = (size_t) omp_get_thread_num(); range < numRanges;
+           range += threads)
+      {
+        try
+        {
+          function(range, begin + range * count / numRanges,
+              begin + (range + 1) * count / numRanges);
+        }
+        catch (...)
+        {
+          #pragma omp critical(mlpack_threads_parallel_for)
+          {
+            if (!error)
+              error = std::current_exception();
+          }
+        }
+      }
+    }
+
+    if (error)
+      std::rethrow_exception(error);
+    return;
+  }
+  #endif
+
+  function(0, begin, end);
+}
+
+template<typename eT>
+void Threads::FirstTouch(arma::Mat<eT>& matrix)
+{
+  if (!numaAware || Ranges(0, matrix.n_cols) < 2)
+    return;
+
+  arma::Mat<eT> placed;
+  placed.set_size(matrix.n_rows, matrix.n_cols);
+  ParallelRanges(0, matrix.n_cols, [&](const size_t /* range */,
+                                       const size_t begin,
+                                       const size_t end)
+  {
+    if (end > begin)
+    {
+      std::copy(matrix.colptr(begin), matrix.colptr(end - 1) + matrix.n_rows,
+          placed.colptr(begin));
+    }
+  });
+
+  matrix.steal_mem(placed);
+}
+
+template<typename eT>
+void Threads::Interleave(arma::Mat<eT>& matrix)
+{
+  const size_t pageSize = std::max((size_t) 1, (size_t) 4096 / sizeof(eT));
+  const size_t numPages = (matrix.n_elem + pageSize - 1) / pageSize;
+  if (!numaAware || Count() < 2 || InParallel() || numPages < 2)
+    return;
+
+  arma::Mat<eT> placed;
+  placed.set_size(matrix.n_rows, matrix.n_cols);
+  const eT* source = matrix.memptr();
+  eT* destination = placed.memptr();
+
+  // Page i is written first by thread (i mod threads).
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t i = 0; i < (omp_size_t) numPages; ++i)
+  {
+    const size_t first = (size_t) i * pageSize;
+    const size_t last = std::min(first + pageSize, (size_t) matrix.n_elem);
+    std::copy(source + first, source + last, destination + first);
+  }
+
+  matrix.steal_mem(placed);
+}
+
+} // namespace mlpack
+
+#endif
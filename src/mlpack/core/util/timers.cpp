@@ -13,6 +13,8 @@
  */
 #include "timers.hpp"
 #include "cli.hpp"
+#include "profiler.hpp"
+#include "memory_usage.hpp"
 #include "log.hpp"
 
 #include <map>
@@ -28,6 +30,8 @@ using namespace chrono;
 void Timer::Start(const string& name)
 {
   CLI::GetSingleton().timer.StartTimer(name, this_thread::get_id());
+  if (MemoryUsage::Enabled())
+    MemoryUsage::StartPhase(name);
 }
 
 /**
@@ -36,6 +40,8 @@ void Timer::Start(const string& name)
 void Timer::Stop(const string& name)
 {
   CLI::GetSingleton().timer.StopTimer(name, this_thread::get_id());
+  if (MemoryUsage::Enabled())
+    MemoryUsage::StopPhase(name);
 }
 
 /**
@@ -46,22 +52,26 @@ microseconds Timer::Get(const string& name)
   return CLI::GetSingleton().timer.GetTimer(name);
 }
 
-// Enable timing.
+// Enable timing (and profiling).
 void Timer::EnableTiming()
 {
   CLI::GetSingleton().timer.Enabled() = true;
+  Profiler::Enable();
 }
 
-// Disable timing.
+// Disable timing (and profiling).
 void Timer::DisableTiming()
 {
   CLI::GetSingleton().timer.Enabled() = false;
+  Profiler::Disable();
 }
 
-// Reset all timers.  Save state of enabled.
+// Reset all timers (and the memory usage of their phases).  Save state of
+// enabled.
 void Timer::ResetAll()
 {
   CLI::GetSingleton().timer.Reset();
+  MemoryUsage::Reset();
 }
 
 // Reset a Timers object.
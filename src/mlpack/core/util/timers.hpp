@@ -76,14 +76,14 @@ class Timer
   static std::chrono::microseconds Get(const std::string& name);
 
   /**
-   * Enable timing of mlpack programs.  Do not run this while timers are
-   * running!
+   * Enable timing of mlpack programs, and the Profiler.  Do not run this while
+   * timers are running!
    */
   static void EnableTiming();
 
   /**
-   * Disable timing of mlpack programs.  Do not run this while timers are
-   * running!
+   * Disable timing of mlpack programs, and the Profiler.  Do not run this while
+   * timers are running!
    */
   static void DisableTiming();
 
@@ -0,0 +1,88 @@
+/**
+ * @file work_counters.cpp
+ *
+ * Implementation of WorkCounters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "work_counters.hpp"
+
+#include <mutex>
+
+using namespace mlpack;
+using namespace std;
+
+namespace {
+
+//! The counts of every method, and the mutex that protects them.
+struct WorkCountersRegistry
+{
+  mutex lock;
+  map<string, WorkCounts> counts;
+};
+
+WorkCountersRegistry& Registry()
+{
+  static WorkCountersRegistry registry;
+  return registry;
+}
+
+} // namespace
+
+void WorkCounters::Add(const string& method,
+                       const size_t distanceEvaluations,
+                       const size_t nodeVisits,
+                       const size_t prunes,
+                       const size_t cacheHits)
+{
+  WorkCountersRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+  WorkCounts& counts = registry.counts[method];
+  counts.distanceEvaluations += distanceEvaluations;
+  counts.nodeVisits += nodeVisits;
+  counts.prunes += prunes;
+  counts.cacheHits += cacheHits;
+}
+
+WorkCounts WorkCounters::Get(const string& method)
+{
+  WorkCountersRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+  map<string, WorkCounts>::const_iterator it = registry.counts.find(method);
+  return (it == registry.counts.end()) ? WorkCounts() : it->second;
+}
+
+map<string, WorkCounts> WorkCounters::GetAll()
+{
+  WorkCountersRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+  return registry.counts;
+}
+
+void WorkCounters::WriteJSON(ostream& stream)
+{
+  const map<string, WorkCounts> counts = GetAll();
+
+  stream << "{";
+  for (map<string, WorkCounts>::const_iterator it = counts.begin();
+      it != counts.end(); ++it)
+  {
+    // Method names are identifiers, so they need no escaping.
+    stream << (it == counts.begin() ? "\n" : ",\n") << "  \"" << it->first
+        << "\": {\"distance_evaluations\": " << it->second.distanceEvaluations
+        << ", \"node_visits\": " << it->second.nodeVisits
+        << ", \"prunes\": " << it->second.prunes
+        << ", \"cache_hits\": " << it->second.cacheHits << "}";
+  }
+  stream << (counts.empty() ? "}" : "\n}") << endl;
+}
+
+void WorkCounters::Reset()
+{
+  WorkCountersRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.lock);
+  registry.counts.clear();
+}
@@ -0,0 +1,98 @@
+/**
+ * @file work_counters.hpp
+ *
+ * Counters of the work done by tree-based methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_WORK_COUNTERS_HPP
+#define MLPACK_CORE_UTIL_WORK_COUNTERS_HPP
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace mlpack {
+
+/**
+ * The work done by one or more runs of a tree-based method.
+ */
+struct WorkCounts
+{
+  //! Create counts of zero.
+  WorkCounts() :
+      distanceEvaluations(0),
+      nodeVisits(0),
+      prunes(0),
+      cacheHits(0)
+  { /* Nothing to do here. */ }
+
+  //! Number of distance (or kernel) evaluations, i.e. base cases.
+  size_t distanceEvaluations;
+  //! Number of nodes (or node combinations) that were scored.
+  size_t nodeVisits;
+  //! Number of nodes (or node combinations) that were pruned.
+  size_t prunes;
+  //! Number of base cases that were reused instead of computed.
+  size_t cacheHits;
+};
+
+/**
+ * WorkCounters collects the work done by the tree-based methods: the number of
+ * distance evaluations, node visits, prunes and cache hits.  Each method
+ * counts its work locally while it runs (every thread in its own rules and
+ * traverser objects) and adds the totals once per run, under the name of the
+ * method, so collecting the counts costs nothing in the inner loops.  Adding
+ * is thread-safe.
+ *
+ * The counts are reported by the command-line programs with --verbose, and can
+ * be written as JSON with --work_counters_file.  They can be used to compare
+ * tree types (or traversal modes) on a given dataset.
+ */
+class WorkCounters
+{
+ public:
+  /**
+   * Add the work of a run of the given method.
+   *
+   * @param method Name of the method (e.g. "neighbor_search").
+   * @param distanceEvaluations Number of distance evaluations.
+   * @param nodeVisits Number of nodes (or node combinations) scored.
+   * @param prunes Number of nodes (or node combinations) pruned.
+   * @param cacheHits Number of base cases reused instead of computed.
+   */
+  static void Add(const std::string& method,
+                  const size_t distanceEvaluations,
+                  const size_t nodeVisits,
+                  const size_t prunes,
+                  const size_t cacheHits = 0);
+
+  /**
+   * Get the total work of the given method.
+   *
+   * @param method Name of the method.
+   */
+  static WorkCounts Get(const std::string& method);
+
+  //! Get a copy of the total work of every method.
+  static std::map<std::string, WorkCounts> GetAll();
+
+  /**
+   * Write the total work of every method as a JSON object, with one member per
+   * method.
+   *
+   * @param stream Stream to write to.
+   */
+  static void WriteJSON(std::ostream& stream);
+
+  //! Remove the counts of every method.
+  static void Reset();
+};
+
+} // namespace mlpack
+
+#endif
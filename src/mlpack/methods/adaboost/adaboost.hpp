@@ -176,6 +176,17 @@ class AdaBoost
 
   //! To check for the bound for the Hamming loss.
   double ztProduct;
+
+  //! Classify the given test points with any type of weak learner.
+  void Classify(const MatType& test,
+                arma::Row<size_t>& predictedLabels,
+                const std::false_type& /* stumps */);
+
+  //! Classify the given test points with decision stumps, passing each point
+  //! through all the stumps at once.
+  void Classify(const MatType& test,
+                arma::Row<size_t>& predictedLabels,
+                const std::true_type& /* stumps */);
 }; // class AdaBoost
 
 } // namespace adaboost
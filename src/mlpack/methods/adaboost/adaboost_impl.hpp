@@ -27,10 +27,39 @@
 #define MLPACK_METHODS_ADABOOST_ADABOOST_IMPL_HPP
 
 #include "adaboost.hpp"
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 namespace mlpack {
 namespace adaboost {
 
+/**
+ * This gives us a HasPresortCheck object that we can use to tell whether or not
+ * a weak learner can sort the training data once for all the boosting rounds.
+ */
+HAS_MEM_FUNC(Presort, HasPresortCheck);
+
+//! Let the weak learner presort the data, if it can.
+template<typename WeakLearnerType, typename MatType>
+void PresortWeakLearner(
+    WeakLearnerType& learner,
+    const MatType& data,
+    const typename std::enable_if_t<HasPresortCheck<WeakLearnerType,
+        void(WeakLearnerType::*)(const MatType&)>::value>* = 0)
+{
+  learner.Presort(data);
+}
+
+//! Do nothing for weak learners that can't presort the data.
+template<typename WeakLearnerType, typename MatType>
+void PresortWeakLearner(
+    WeakLearnerType& /* learner */,
+    const MatType& /* data */,
+    const typename std::enable_if_t<!HasPresortCheck<WeakLearnerType,
+        void(WeakLearnerType::*)(const MatType&)>::value>* = 0)
+{
+  // Nothing to do.
+}
+
 /**
  * Constructor. Currently runs the AdaBoost.MH algorithm.
  *
@@ -86,12 +115,11 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   // To be used for prediction by the weak learner.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input data for incorporating weights.
-  MatType tempData(data);
-
-  // This matrix is a helper matrix used to calculate the final hypothesis.
-  arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
-      predictedLabels.n_cols);
+  // The data doesn't change between rounds, so if the weak learner can do
+  // work on the data once for all the rounds (like sorting each dimension), do
+  // it now.
+  WeakLearnerType learner(other);
+  PresortWeakLearner(learner, data);
 
   // Load the initial weights into a 2-D matrix.
   const double initWeight = 1.0 / double(data.n_cols * numClasses);
@@ -101,38 +129,25 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   // Weights are stored in this row vector.
   arma::rowvec weights(predictedLabels.n_cols);
 
-  // This is the final hypothesis.
-  arma::Row<size_t> finalH(predictedLabels.n_cols);
+  // This holds +1 for each point the weak learner classifies correctly and -1
+  // for each other point.
+  arma::rowvec correct(predictedLabels.n_cols);
 
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; i++)
   {
-    // Initialized to zero in every round.  rt is used for calculation of
-    // alphat; it is the weighted error.
-    // rt = (sum) D(i) y(i) ht(xi)
-    rt = 0.0;
-
-    // zt is used for weight normalization.
-    zt = 0.0;
-
     // Build the weight vectors.
     weights = arma::sum(D);
 
     // Use the existing weak learner to train a new one with new weights.
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
-    w.Classify(tempData, predictedLabels);
-
-    // Now from predictedLabels, build ht, the weak hypothesis
-    // buildClassificationMatrix(ht, predictedLabels);
+    WeakLearnerType w(learner, data, labels, numClasses, weights);
+    w.Classify(data, predictedLabels);
 
-    // Now, calculate alpha(t) using ht.
-    for (size_t j = 0; j < D.n_cols; j++) // instead of D, ht
-    {
-      if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
-      else
-        rt -= arma::accu(D.col(j));
-    }
+    // Now, calculate alpha(t) using ht.  rt is the weighted error:
+    // rt = (sum) D(i) y(i) ht(xi)
+    correct = 2.0 * arma::conv_to<arma::rowvec>::from(predictedLabels ==
+        labels) - 1.0;
+    rt = arma::dot(weights, correct);
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
       break;
@@ -155,44 +170,11 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; j++)
-    {
-      const double expo = exp(alphat);
-      if (predictedLabels(j) == labels(j))
-      {
-        for (size_t k = 0; k < D.n_rows; k++)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
-      else
-      {
-        for (size_t k = 0; k < D.n_rows; k++)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
-      }
-    }
-
-    // Normalize D.
+    // Now start modifying the weights: the weights of the correctly
+    // classified points shrink by exp(alphat), and the others grow by the same
+    // factor.  zt is the normalization constant.
+    D.each_row() %= arma::exp(-alphat * correct);
+    zt = arma::accu(D);
     D /= zt;
 
     // Accumulate the value of zt for the Hamming loss bound.
@@ -208,29 +190,117 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
-  arma::mat cMatrix(numClasses, test.n_cols);
-
-  cMatrix.zeros();
   predictedLabels.set_size(test.n_cols);
+  Classify(test, predictedLabels, std::is_same<WeakLearnerType,
+      decision_stump::DecisionStump<MatType>>());
+}
 
+/**
+ * Classify the given test points with any weak learner: each block of points
+ * collects the votes of all the weak learners in its own matrix, and the
+ * blocks are classified in parallel.
+ */
+template<typename WeakLearnerType, typename MatType>
+void AdaBoost<WeakLearnerType, MatType>::Classify(
+    const MatType& test,
+    arma::Row<size_t>& predictedLabels,
+    const std::false_type& /* stumps */)
+{
+  const size_t blockSize = 256;
+  const size_t numBlocks = (test.n_cols + blockSize - 1) / blockSize;
+
+  Threads::ParallelFor(0, numBlocks, [&](const size_t b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) test.n_cols);
+
+    const MatType block = test.cols(begin, end - 1);
+    arma::Row<size_t> blockLabels;
+    arma::mat votes(numClasses, end - begin, arma::fill::zeros);
+    for (size_t i = 0; i < wl.size(); i++)
+    {
+      wl[i].Classify(block, blockLabels);
+      for (size_t j = 0; j < blockLabels.n_elem; j++)
+        votes(blockLabels[j], j) += alpha[i];
+    }
+
+    arma::uword maxIndex = 0;
+    for (size_t j = 0; j < votes.n_cols; j++)
+    {
+      votes.col(j).max(maxIndex);
+      predictedLabels[begin + j] = maxIndex;
+    }
+  });
+}
+
+/**
+ * Classify the given test points with decision stumps.  The stumps are laid
+ * out in flat arrays once, and then each point is passed through all the
+ * stumps in one pass, in parallel over the points.
+ */
+template<typename WeakLearnerType, typename MatType>
+void AdaBoost<WeakLearnerType, MatType>::Classify(
+    const MatType& test,
+    arma::Row<size_t>& predictedLabels,
+    const std::true_type& /* stumps */)
+{
+  // splitOffsets[i] is the index of the first split (and bin label) of stump
+  // i in splits (and binLabels).
+  arma::Col<size_t> dimensions(wl.size());
+  arma::Col<size_t> splitOffsets(wl.size() + 1);
+  splitOffsets[0] = 0;
   for (size_t i = 0; i < wl.size(); i++)
   {
-    wl[i].Classify(test, tempPredictedLabels);
+    dimensions[i] = wl[i].SplitDimension();
+    splitOffsets[i + 1] = splitOffsets[i] + wl[i].Split().n_elem;
+  }
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
-      cMatrix(tempPredictedLabels(j), j) += alpha[i];
+  arma::vec splits(splitOffsets[wl.size()]);
+  arma::Col<size_t> binLabels(splitOffsets[wl.size()]);
+  for (size_t i = 0; i < wl.size(); i++)
+  {
+    if (wl[i].Split().n_elem == 0)
+      continue;
+
+    splits.subvec(splitOffsets[i], splitOffsets[i + 1] - 1) = wl[i].Split();
+    binLabels.subvec(splitOffsets[i], splitOffsets[i + 1] - 1) =
+        wl[i].BinLabels();
   }
 
-  arma::colvec cMRow;
-  arma::uword maxIndex = 0;
+  const size_t blockSize = 256;
+  const size_t numBlocks = (test.n_cols + blockSize - 1) / blockSize;
 
-  for (size_t i = 0; i < predictedLabels.n_cols; i++)
+  Threads::ParallelFor(0, numBlocks, [&](const size_t b)
   {
-    cMRow = cMatrix.unsafe_col(i);
-    cMRow.max(maxIndex);
-    predictedLabels(i) = maxIndex;
-  }
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) test.n_cols);
+
+    arma::vec votes(numClasses);
+    arma::uword maxIndex = 0;
+    for (size_t j = begin; j < end; j++)
+    {
+      votes.zeros();
+      for (size_t i = 0; i < wl.size(); i++)
+      {
+        // Find the bin the point falls into, as DecisionStump::Classify()
+        // does.
+        const double val = test(dimensions[i], j);
+        size_t bin = splitOffsets[i];
+        while (bin < splitOffsets[i + 1] - 1)
+        {
+          if (val < splits[bin + 1])
+            break;
+
+          ++bin;
+        }
+
+        votes[binLabels[bin]] += alpha[i];
+      }
+
+      votes.max(maxIndex);
+      predictedLabels[j] = maxIndex;
+    }
+  });
 }
 
 /**
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_MULT_DIST_UPDATE_RULES_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/lin_alg.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -71,7 +72,24 @@ class NMFMultiplicativeDistanceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    W = (W % (V * H.t())) / (W * H * H.t());
+    W = (W % (V * H.t())) / (W * (H * H.t()));
+  }
+
+  /**
+   * The update rule for the basis matrix W, for sparse matrices.  The product
+   * with V is computed in parallel blocks, and W H is never formed.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  inline static void WUpdate(const arma::sp_mat& V,
+                             arma::mat& W,
+                             const arma::mat& H)
+  {
+    arma::mat vht;
+    math::Multiply(V, H.t(), vht);
+    W = (W % vht) / (W * (H * H.t()));
   }
 
   /**
@@ -93,7 +111,24 @@ class NMFMultiplicativeDistanceUpdate
                              const arma::mat& W,
                              arma::mat& H)
   {
-    H = (H % (W.t() * V)) / (W.t() * W * H);
+    H = (H % (W.t() * V)) / ((W.t() * W) * H);
+  }
+
+  /**
+   * The update rule for the encoding matrix H, for sparse matrices.  The
+   * product with V is computed in parallel blocks, and W H is never formed.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  inline static void HUpdate(const arma::sp_mat& V,
+                             const arma::mat& W,
+                             arma::mat& H)
+  {
+    arma::mat vtw;
+    math::TransposeMultiply(V, W, vtw);
+    H = (H % vtw.t()) / ((W.t() * W) * H);
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
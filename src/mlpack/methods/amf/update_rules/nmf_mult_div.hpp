@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_MULT_DIV_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/lin_alg.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -81,28 +82,31 @@ class NMFMultiplicativeDivergenceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::rowvec t2;
+    const arma::mat ratio = V / (W * H);
+    W %= ratio * H.t();
+    W.each_row() /= arma::sum(H, 1).t();
+  }
 
-    t1 = W * H;
-    for (size_t i = 0; i < W.n_rows; ++i)
-    {
-      for (size_t j = 0; j < W.n_cols; ++j)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = H.row(j) % V.row(i) / t1.row(i);
-        t2.set_size(H.n_cols);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = H(j, k) * V(i, k) / t1(i, k);
-        }
-
-        W(i, j) = W(i, j) * sum(t2) / sum(H.row(j));
-      }
-    }
+  /**
+   * The update rule for the basis matrix W, for sparse matrices.  The ratio
+   * V / (W H) is only computed at the nonzero elements of V, so W H is never
+   * formed, and the products are computed in parallel blocks.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  inline static void WUpdate(const arma::sp_mat& V,
+                             arma::mat& W,
+                             const arma::mat& H)
+  {
+    arma::sp_mat ratio;
+    SparseRatio(V, W, H, ratio);
+
+    arma::mat rht;
+    math::Multiply(ratio, H.t(), rht);
+    W %= rht;
+    W.each_row() /= arma::sum(H, 1).t();
   }
 
   /**
@@ -122,36 +126,72 @@ class NMFMultiplicativeDivergenceUpdate
    */
   template<typename MatType>
   inline static void HUpdate(const MatType& V,
-                            const arma::mat& W,
-                            arma::mat& H)
+                             const arma::mat& W,
+                             arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::colvec t2;
+    const arma::mat ratio = V / (W * H);
+    H %= W.t() * ratio;
+    H.each_col() /= arma::sum(W, 0).t();
+  }
 
-    t1 = W * H;
-    for (size_t i = 0; i < H.n_rows; i++)
-    {
-      for (size_t j = 0; j < H.n_cols; j++)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = W.col(i) % V.col(j) / t1.col(j);
-        t2.set_size(W.n_rows);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = W(k, i) * V(k, j) / t1(k, j);
-        }
-
-        H(i, j) = H(i, j) * sum(t2) / sum(W.col(i));
-      }
-    }
+  /**
+   * The update rule for the encoding matrix H, for sparse matrices.  The ratio
+   * V / (W H) is only computed at the nonzero elements of V, so W H is never
+   * formed, and the products are computed in parallel blocks.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to updated.
+   */
+  inline static void HUpdate(const arma::sp_mat& V,
+                             const arma::mat& W,
+                             arma::mat& H)
+  {
+    arma::sp_mat ratio;
+    SparseRatio(V, W, H, ratio);
+
+    arma::mat rtw;
+    math::TransposeMultiply(ratio, W, rtw);
+    H %= rtw.t();
+    H.each_col() /= arma::sum(W, 0).t();
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  /**
+   * Compute V / (W H) at the nonzero elements of V only (a sampled dense-dense
+   * product), in parallel over the columns of V.  The result has the same
+   * sparsity pattern as V.
+   */
+  static void SparseRatio(const arma::sp_mat& V,
+                          const arma::mat& W,
+                          const arma::mat& H,
+                          arma::sp_mat& ratio)
+  {
+    // The rows of W are needed, so make them contiguous.
+    const arma::mat wt = W.t();
+
+    arma::vec values(V.n_nonzero);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
+    {
+      for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
+      {
+        values[k] = V.values[k] / arma::dot(wt.col(V.row_indices[k]),
+            H.col(j));
+      }
+    }
+
+    const arma::uvec rowIndices(const_cast<arma::uword*>(V.row_indices),
+        V.n_nonzero, false, true);
+    const arma::uvec colPtrs(const_cast<arma::uword*>(V.col_ptrs),
+        V.n_cols + 1, false, true);
+    ratio = arma::sp_mat(rowIndices, colPtrs, values, V.n_rows, V.n_cols);
+  }
 };
 
 } // namespace amf
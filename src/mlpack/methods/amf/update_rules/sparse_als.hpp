@@ -0,0 +1,234 @@
+/**
+ * @file sparse_als.hpp
+ *
+ * Alternating least squares update rules for the factorization of sparse
+ * (partially observed) matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_SPARSE_ALS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_SPARSE_ALS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class implements alternating least squares for matrices whose zero
+ * entries are unobserved, such as rating matrices.  Unlike NMFALSUpdate, which
+ * solves for all of W (or H) at once and treats the zeros as observations,
+ * each row of W and each column of H is the solution of its own small
+ * rank x rank system of normal equations, built only from the observed entries
+ * of the corresponding row or column of V:
+ *
+ * \f[
+ * h_j = (\sum_{i \in O_j} w_i w_i^T + \lambda I)^{-1} \sum_{i \in O_j} V_{ij}
+ * w_i.
+ * \f]
+ *
+ * The systems are independent, so they are solved in parallel.  With implicit
+ * feedback, the entries of V are instead treated as confidences in the
+ * preference of the user for the item, as described in the following paper:
+ *
+ * @code
+ * @inproceedings{hu2008collaborative,
+ *   title={Collaborative Filtering for Implicit Feedback Datasets},
+ *   author={Hu, Y. and Koren, Y. and Volinsky, C.},
+ *   booktitle={Proceedings of the Eighth IEEE International Conference on
+ *       Data Mining (ICDM '08)},
+ *   pages={263--272},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Then every entry is observed, with preference 1 where V is nonzero and 0
+ * elsewhere, weighted by the confidence \f$ 1 + \alpha V_{ij} \f$; the shared
+ * Gram matrix of the fixed factors is computed once per update, so the cost of
+ * each system still only depends on the nonzero entries.
+ *
+ * This update rule is best used with a sparse matrix V; dense matrices are
+ * converted to sparse ones.
+ */
+class SparseALSUpdate
+{
+ public:
+  /**
+   * Create the update rule with the given parameters.
+   *
+   * @param lambda Regularization parameter.
+   * @param implicit Whether the entries of V are implicit feedback.
+   * @param alpha Confidence scaling of the implicit feedback.
+   */
+  SparseALSUpdate(const double lambda = 0.01,
+                  const bool implicit = false,
+                  const double alpha = 40.0) :
+      lambda(lambda),
+      implicit(implicit),
+      alpha(alpha)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Set initial values for the factorization.  This stores the transpose of
+   * the matrix, so that the rows of V can be traversed quickly.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank Rank of the factorization.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& dataset, const size_t /* rank */)
+  {
+    vt = arma::sp_mat(dataset).t();
+  }
+
+  /**
+   * The update rule for the basis matrix W.  Each row of W is computed from
+   * the observed entries of the same row of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& /* V */,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    arma::mat wt;
+    SolveColumns(vt, H, wt);
+    W = wt.t();
+  }
+
+  /**
+   * The update rule for the encoding matrix H.  Each column of H is computed
+   * from the observed entries of the same column of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  inline void HUpdate(const arma::sp_mat& V,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    SolveColumns(V, W.t(), H);
+  }
+
+  /**
+   * The update rule for the encoding matrix H, for dense matrices.  The matrix
+   * is converted to a sparse matrix first.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& V,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    SolveColumns(arma::sp_mat(V), W.t(), H);
+  }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get whether the entries are implicit feedback.
+  bool Implicit() const { return implicit; }
+  //! Modify whether the entries are implicit feedback.
+  bool& Implicit() { return implicit; }
+
+  //! Get the confidence scaling of the implicit feedback.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence scaling of the implicit feedback.
+  double& Alpha() { return alpha; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(implicit);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+  }
+
+ private:
+  /**
+   * Solve the normal equations of every column of the given data, given the
+   * fixed factors (one per row of the data, as columns of factors).
+   */
+  void SolveColumns(const arma::sp_mat& data,
+                    const arma::mat& factors,
+                    arma::mat& result) const
+  {
+    const size_t rank = factors.n_rows;
+    result.zeros(rank, data.n_cols);
+
+    // With implicit feedback the unobserved entries take part too, through
+    // the Gram matrix of all the factors.
+    arma::mat gram;
+    if (implicit)
+      gram = factors * factors.t();
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t begin = data.col_ptrs[j];
+      const size_t count = data.col_ptrs[j + 1] - begin;
+      if (count == 0)
+        continue; // Nothing observed; the solution is zero.
+
+      // Gather the factors of the observed entries.
+      arma::mat observed(rank, count);
+      arma::vec values(count);
+      for (size_t k = 0; k < count; ++k)
+      {
+        observed.col(k) = factors.col(data.row_indices[begin + k]);
+        values[k] = data.values[begin + k];
+      }
+
+      arma::mat a;
+      arma::vec b;
+      if (implicit)
+      {
+        // A = F^T F + F^T (C - I) F, b = F^T C p.
+        arma::mat scaled = observed;
+        scaled.each_row() %= arma::rowvec(alpha * values.t());
+        a = gram + scaled * observed.t();
+        b = observed * (1.0 + alpha * values);
+      }
+      else
+      {
+        a = observed * observed.t();
+        b = observed * values;
+      }
+      a.diag() += lambda;
+
+      arma::vec x;
+      if (!arma::solve(x, a, b))
+        x = arma::pinv(a) * b;
+      result.col(j) = x;
+    }
+  }
+
+  //! Regularization parameter.
+  double lambda;
+  //! Whether the entries are implicit feedback.
+  bool implicit;
+  //! Confidence scaling of the implicit feedback.
+  double alpha;
+  //! Transpose of the matrix being factorized.
+  arma::sp_mat vt;
+}; // class SparseALSUpdate
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
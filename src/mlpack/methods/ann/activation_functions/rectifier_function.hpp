@@ -65,7 +65,8 @@ class RectifierFunction
   template<typename eT>
   static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
   {
-    y = arma::max(arma::zeros<arma::Mat<eT> >(x.n_rows, x.n_cols), x);
+    // A single pass; comparing with a matrix of zeros would allocate it.
+    y = arma::clamp(x, eT(0), std::numeric_limits<eT>::max());
   }
 
   /**
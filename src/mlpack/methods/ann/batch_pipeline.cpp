@@ -0,0 +1,171 @@
+/**
+ * @file batch_pipeline.cpp
+ *
+ * Implementation of the BatchPipeline class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "batch_pipeline.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+BatchPipeline::BatchPipeline() :
+    nextData(NULL),
+    nextBegin(0),
+    nextSize(0)
+{
+  // Nothing to do here.
+}
+
+BatchPipeline::BatchPipeline(const BatchPipeline& other) :
+    nextData(NULL),
+    nextBegin(0),
+    nextSize(0),
+    augmentation(other.augmentation)
+{
+  // Nothing to do here.
+}
+
+BatchPipeline& BatchPipeline::operator=(const BatchPipeline& other)
+{
+  if (this != &other)
+  {
+    Clear();
+    augmentation = other.augmentation;
+  }
+
+  return *this;
+}
+
+BatchPipeline::~BatchPipeline()
+{
+  Clear();
+  if (nextOrder.valid())
+    nextOrder.wait();
+}
+
+void BatchPipeline::Batch(const arma::mat& predictors,
+                          const arma::mat& responses,
+                          const size_t begin,
+                          const size_t batchSize,
+                          const bool prefetch)
+{
+  const size_t numPoints = predictors.n_cols;
+  if (order.n_elem != numPoints)
+  {
+    Clear();
+    order = arma::regspace<arma::uvec>(0, numPoints - 1);
+  }
+
+  bool gathered = false;
+  if (nextBatch.valid())
+  {
+    // This rethrows the exceptions of the augmentation function.
+    nextBatch.get();
+    if (nextData == &predictors && nextBegin == begin && nextSize == batchSize)
+    {
+      currentPredictors.swap(nextPredictors);
+      currentResponses.swap(nextResponses);
+      gathered = true;
+    }
+  }
+
+  if (!gathered)
+  {
+    Gather(predictors, responses, begin, batchSize, currentPredictors,
+        currentResponses);
+  }
+
+  // Gather the next batch of the epoch while this one is used.
+  if (prefetch && begin + batchSize < numPoints)
+  {
+    nextData = &predictors;
+    nextBegin = begin + batchSize;
+    nextSize = std::min(batchSize, numPoints - nextBegin);
+    nextBatch = std::async(std::launch::async, [this, &predictors,
+        &responses]()
+    {
+      Gather(predictors, responses, nextBegin, nextSize, nextPredictors,
+          nextResponses);
+    });
+  }
+}
+
+void BatchPipeline::Shuffle(const size_t numPoints)
+{
+  // The background task reads the current order.
+  Clear();
+
+  if (nextOrder.valid())
+  {
+    arma::uvec newOrder = nextOrder.get();
+    if (newOrder.n_elem == numPoints)
+      order = std::move(newOrder);
+    else
+      order = arma::shuffle(arma::regspace<arma::uvec>(0, numPoints - 1));
+  }
+  else
+  {
+    order = arma::shuffle(arma::regspace<arma::uvec>(0, numPoints - 1));
+  }
+
+  StartShuffle(numPoints);
+}
+
+void BatchPipeline::Clear()
+{
+  if (nextBatch.valid())
+  {
+    nextBatch.wait();
+    nextBatch = std::future<void>();
+  }
+
+  nextData = NULL;
+}
+
+void BatchPipeline::Gather(const arma::mat& predictors,
+                           const arma::mat& responses,
+                           const size_t begin,
+                           const size_t batchSize,
+                           arma::mat& batchPredictors,
+                           arma::mat& batchResponses) const
+{
+  batchPredictors.set_size(predictors.n_rows, batchSize);
+  batchResponses.set_size(responses.n_rows, batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    const size_t point = order[begin + i];
+    std::memcpy(batchPredictors.colptr(i), predictors.colptr(point),
+        predictors.n_rows * sizeof(double));
+    std::memcpy(batchResponses.colptr(i), responses.colptr(point),
+        responses.n_rows * sizeof(double));
+  }
+
+  if (augmentation)
+    augmentation(batchPredictors, batchResponses);
+}
+
+void BatchPipeline::StartShuffle(const size_t numPoints)
+{
+  // The seed is drawn here, so the orders only depend on the random seed.
+  const unsigned int seed = (unsigned int) math::RandInt(
+      std::numeric_limits<int>::max());
+  nextOrder = std::async(std::launch::async, [numPoints, seed]()
+  {
+    arma::uvec newOrder = arma::regspace<arma::uvec>(0, numPoints - 1);
+    std::mt19937 generator(seed);
+    std::shuffle(newOrder.begin(), newOrder.end(), generator);
+    return newOrder;
+  });
+}
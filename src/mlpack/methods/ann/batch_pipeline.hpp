@@ -0,0 +1,153 @@
+/**
+ * @file batch_pipeline.hpp
+ *
+ * Definition of the BatchPipeline class, which gathers shuffled batches of a
+ * dataset in the background.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_BATCH_PIPELINE_HPP
+#define MLPACK_METHODS_ANN_BATCH_PIPELINE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <functional>
+#include <future>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The BatchPipeline hands out the batches of a dataset in a (shuffled)
+ * visitation order, without reordering the dataset itself.  Shuffle() only
+ * changes the visitation order, and Batch() gathers the columns of a batch
+ * into a buffer.  While a batch is used, the next batch of the epoch is
+ * gathered into a second buffer by a background thread, and the visitation
+ * order of the next epoch is generated in the background too, so that
+ * neither the shuffling nor the gathering holds up the computation.
+ *
+ * Optionally an augmentation function is applied to every gathered batch (in
+ * the background thread); it receives the predictors and responses of the
+ * batch and may modify them in place (but has to keep the number of columns).
+ * As it runs concurrently with the caller, it must not touch any state that
+ * the caller uses.
+ *
+ * The dataset is passed to every call of Batch(); it must not be modified
+ * while a batch is gathered in the background, so call Clear() before the
+ * dataset is changed.
+ */
+class BatchPipeline
+{
+ public:
+  //! The type of the augmentation function.
+  typedef std::function<void(arma::mat& /* predictors */,
+                             arma::mat& /* responses */)> AugmentationType;
+
+  //! Create the BatchPipeline object.
+  BatchPipeline();
+
+  //! Copy the settings (the augmentation function) of the given pipeline.
+  BatchPipeline(const BatchPipeline& other);
+
+  //! Copy the settings (the augmentation function) of the given pipeline.
+  BatchPipeline& operator=(const BatchPipeline& other);
+
+  //! Wait for the background work to finish.
+  ~BatchPipeline();
+
+  /**
+   * Gather the points begin, ..., begin + batchSize - 1 of the visitation
+   * order into Predictors() and Responses(), and apply the augmentation
+   * function.  If the batch was gathered in the background already, this only
+   * waits for it.  If the visitation order doesn't match the number of points,
+   * it is reset to the order of the dataset.
+   *
+   * @param predictors The predictors of the dataset.
+   * @param responses The responses of the dataset.
+   * @param begin Position of the first point of the batch in the order.
+   * @param batchSize Number of points in the batch.
+   * @param prefetch Whether to gather the following batch in the background.
+   */
+  void Batch(const arma::mat& predictors,
+             const arma::mat& responses,
+             const size_t begin,
+             const size_t batchSize,
+             const bool prefetch = true);
+
+  /**
+   * Visit the points in a new random order.  The order is generated in the
+   * background after the previous call.
+   *
+   * @param numPoints The number of points of the dataset.
+   */
+  void Shuffle(const size_t numPoints);
+
+  //! Wait for the batch that is gathered in the background and discard it.
+  void Clear();
+
+  //! Get the predictors of the last batch.
+  const arma::mat& Predictors() const { return currentPredictors; }
+  //! Modify the predictors of the last batch.
+  arma::mat& Predictors() { return currentPredictors; }
+
+  //! Get the responses of the last batch.
+  const arma::mat& Responses() const { return currentResponses; }
+  //! Modify the responses of the last batch.
+  arma::mat& Responses() { return currentResponses; }
+
+  //! Get the visitation order.
+  const arma::uvec& Order() const { return order; }
+
+  //! Get the augmentation function.
+  const AugmentationType& Augmentation() const { return augmentation; }
+  //! Modify the augmentation function.
+  AugmentationType& Augmentation() { return augmentation; }
+
+ private:
+  /**
+   * Gather the given points of the visitation order and apply the
+   * augmentation function.
+   */
+  void Gather(const arma::mat& predictors,
+              const arma::mat& responses,
+              const size_t begin,
+              const size_t batchSize,
+              arma::mat& batchPredictors,
+              arma::mat& batchResponses) const;
+
+  //! Start generating the visitation order of the next epoch.
+  void StartShuffle(const size_t numPoints);
+
+  //! The visitation order.
+  arma::uvec order;
+
+  //! The visitation order of the next epoch, if it is being generated.
+  std::future<arma::uvec> nextOrder;
+
+  //! The batch that is handed out.
+  arma::mat currentPredictors;
+  arma::mat currentResponses;
+
+  //! The batch that is gathered in the background.
+  arma::mat nextPredictors;
+  arma::mat nextResponses;
+
+  //! The background task that gathers the next batch.
+  std::future<void> nextBatch;
+
+  //! The dataset and the points of the batch gathered in the background.
+  const arma::mat* nextData;
+  size_t nextBegin;
+  size_t nextSize;
+
+  //! The augmentation function; may be empty.
+  AugmentationType augmentation;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,432 @@
+/**
+ * @file im2col_convolution.hpp
+ *
+ * Implementation of the convolution by unrolling the input into a patch matrix
+ * (im2col) and computing the result with a single matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by rearranging every filter-sized
+ * patch of the input into a row of a patch matrix (im2col), so that the
+ * convolution itself becomes a dense matrix product that is handled by BLAS.
+ * This class allows specification of the type of the border type. The
+ * convolution can be computed with the valid border type of the full border
+ * type (default).
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * Besides the usual per-matrix Convolution() interface shared by all
+ * convolution rules, the class exposes the Im2Col() and Col2Im() primitives.
+ * The Convolution, AtrousConvolution and TransposedConvolution layers detect
+ * this rule (see IsIm2ColConvolution) and use the primitives to unroll every
+ * input map of a sample at once, so that all (input map, output map) pairs of
+ * a layer are computed with one matrix multiplication per sample instead of
+ * one scalar convolution per pair.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Unroll the given slices of the input into a patch matrix. Each row of the
+   * patch matrix holds the receptive field of one output position; the
+   * output positions are stored in column-major order (so that a column of
+   * the product of the patch matrix and the weights is directly a valid
+   * output map). The columns are ordered by slice, then by filter column and
+   * then by filter row, which is the memory layout of a cube of filters.
+   *
+   * @param input Input cube that contains the (already padded) input maps.
+   * @param firstSlice Index of the first input map to unroll.
+   * @param nSlices Number of input maps to unroll.
+   * @param kW Width of the filter/kernel.
+   * @param kH Height of the filter/kernel.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param outputWidth Width of the resulting output map.
+   * @param outputHeight Height of the resulting output map.
+   * @param patches The resulting patch matrix.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t firstSlice,
+                     const size_t nSlices,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     const size_t outputWidth,
+                     const size_t outputHeight,
+                     arma::Mat<eT>& patches)
+  {
+    if (patches.n_rows != outputWidth * outputHeight ||
+        patches.n_cols != kW * kH * nSlices)
+    {
+      patches.set_size(outputWidth * outputHeight, kW * kH * nSlices);
+    }
+
+    eT* patchPtr = patches.memptr();
+    for (size_t s = 0; s < nSlices; ++s)
+    {
+      const arma::Mat<eT>& slice = input.slice(firstSlice + s);
+      for (size_t kj = 0; kj < kH; ++kj)
+      {
+        for (size_t ki = 0; ki < kW; ++ki)
+        {
+          // Every column of the patch matrix is filled contiguously.
+          for (size_t j = 0; j < outputHeight; ++j)
+          {
+            const eT* inputPtr = slice.colptr(j * dH + kj * dilationH) +
+                ki * dilationW;
+            for (size_t i = 0; i < outputWidth; ++i, ++patchPtr,
+                inputPtr += dW)
+              *patchPtr = *inputPtr;
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * Fold a patch matrix back into the given slices of the output, summing the
+   * contributions of overlapping patches. This is the adjoint of Im2Col() and
+   * is used to propagate errors through the convolution.
+   *
+   * @param patches Patch matrix with the same layout as produced by Im2Col().
+   * @param firstSlice Index of the first output map to accumulate into.
+   * @param nSlices Number of output maps.
+   * @param kW Width of the filter/kernel.
+   * @param kH Height of the filter/kernel.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param outputWidth Width of the map that the patches were taken from.
+   * @param outputHeight Height of the map that the patches were taken from.
+   * @param output Cube the unrolled patches are accumulated into.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& patches,
+                     const size_t firstSlice,
+                     const size_t nSlices,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     const size_t outputWidth,
+                     const size_t outputHeight,
+                     arma::Cube<eT>& output)
+  {
+    const eT* patchPtr = patches.memptr();
+    for (size_t s = 0; s < nSlices; ++s)
+    {
+      arma::Mat<eT>& slice = output.slice(firstSlice + s);
+      for (size_t kj = 0; kj < kH; ++kj)
+      {
+        for (size_t ki = 0; ki < kW; ++ki)
+        {
+          for (size_t j = 0; j < outputHeight; ++j)
+          {
+            eT* outputPtr = slice.colptr(j * dH + kj * dilationH) +
+                ki * dilationW;
+            for (size_t i = 0; i < outputWidth; ++i, ++patchPtr,
+                outputPtr += dW)
+              *outputPtr += *patchPtr;
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const size_t outputRows = (input.n_rows - (filter.n_rows - 1) *
+        dilationW - 1) / dW + 1;
+    const size_t outputCols = (input.n_cols - (filter.n_cols - 1) *
+        dilationH - 1) / dH + 1;
+
+    // Alias the input as a single-slice cube, no copy is made.
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> patches;
+    Im2Col(inputCube, 0, 1, filter.n_rows, filter.n_cols, dW, dH, dilationW,
+        dilationH, outputRows, outputCols, patches);
+
+    output.set_size(outputRows, outputCols);
+    arma::Col<eT> outputVec(output.memptr(), output.n_elem, false, true);
+    outputVec = patches * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; i++)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i){
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; i++)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i){
+        outputCols += i;
+        break;
+      }
+    }
+
+    // Pad filter and input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output. The input is unrolled only once and all filters are
+   * applied with a single matrix multiplication.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Cube<eT>& filter,
+              arma::Cube<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const size_t outputRows = (input.n_rows - (filter.n_rows - 1) *
+        dilationW - 1) / dW + 1;
+    const size_t outputCols = (input.n_cols - (filter.n_cols - 1) *
+        dilationH - 1) / dH + 1;
+
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> patches;
+    Im2Col(inputCube, 0, 1, filter.n_rows, filter.n_cols, dW, dH, dilationW,
+        dilationH, outputRows, outputCols, patches);
+
+    output.set_size(outputRows, outputCols, filter.n_slices);
+    arma::Mat<eT> outputMat(output.memptr(), outputRows * outputCols,
+        filter.n_slices, false, true);
+    outputMat = patches * arma::Mat<eT>(const_cast<eT*>(filter.memptr()),
+        filter.n_rows * filter.n_cols, filter.n_slices, false, true);
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Cube<eT>& filter,
+              arma::Cube<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Type trait that is true if the given convolution rule is an
+ * Im2ColConvolution rule, in which case the convolution layers can use the
+ * batched Im2Col()/Col2Im() code path.
+ */
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode> >
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
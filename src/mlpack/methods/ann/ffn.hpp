@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_FFN_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
 
 #include "visitor/delete_visitor.hpp"
 #include "visitor/delta_visitor.hpp"
@@ -24,8 +25,10 @@
 #include "visitor/weight_size_visitor.hpp"
 #include "visitor/copy_visitor.hpp"
 #include "visitor/loss_visitor.hpp"
+#include "visitor/sparse_gradient_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "batch_pipeline.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/init_rules/random_init.hpp>
@@ -37,6 +40,12 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard feed forward network.
  *
+ * The network computes in double precision: its layers are held in the
+ * LayerTypes variant, whose layers work on arma::mat.  The Linear,
+ * LinearNoBias, BatchNorm, LogSoftMax, PReLU and convolution layers can be
+ * instantiated with arma::fmat as InputDataType and OutputDataType and used on
+ * their own in single precision, but not inside an FFN.
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  * @tparam CustomLayers Any set of custom layers that could be a part of the
@@ -92,15 +101,21 @@ class FFN
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
+   * The given callbacks (see core/optimizers/callbacks/callbacks.hpp) are
+   * passed to the optimizer, which has to take callbacks if any are given.
+   *
    * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of the callbacks.
    * @param predictors Input training variables.
    * @param responses Outputs results from input training variables.
    * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callbacks to pass to the optimizer.
    */
-  template<typename OptimizerType>
+  template<typename OptimizerType, typename... CallbackTypes>
   void Train(arma::mat predictors,
              arma::mat responses,
-             OptimizerType& optimizer);
+             OptimizerType& optimizer,
+             CallbackTypes&&... callbacks);
 
   /**
    * Train the feedforward network on the given input data. By default, the
@@ -126,13 +141,46 @@ class FFN
    * reflect the output of the given output layer as returned by the
    * output layer function.
    *
-   * If you want to pass in a parameter and discard the original parameter
-   * object, be sure to use std::move to avoid unnecessary copy.
+   * The predictors are passed through the network in batches of (at most)
+   * batchSize points, in deterministic (inference) mode, without being
+   * copied.  The output of every batch is written directly into the results
+   * matrix, which is only resized if its shape differs.  If the network is
+   * frozen (see Freeze()), the layers write into buffers that are kept between
+   * calls, whatever the batch size, so repeated calls (for instance when
+   * scoring single points) do not have to allocate memory.
    *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Maximum number of points that are passed through the
+   *        network at once; if the network is frozen, the maximum batch size
+   *        given to Freeze() is used instead.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               const size_t batchSize = 128);
+
+  /**
+   * Freeze the network for inference.  The network is switched to
+   * deterministic mode, and the next call to Predict() allocates one output
+   * buffer of maxBatchSize columns for every layer of the network (but not for
+   * the layers inside container layers, like Sequential).  Every later batch,
+   * whatever its size up to maxBatchSize, is then computed into these
+   * buffers, so Predict() doesn't allocate anything but the results.
+   *
+   * The network can still be trained; the buffers are only used by Predict().
+   * Call Freeze() again after changing the layers of the network, and
+   * Unfreeze() to release the buffers.
+   *
+   * @param maxBatchSize Maximum number of points that Predict() passes through
+   *        the network at once.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Freeze(const size_t maxBatchSize = 128);
+
+  //! Release the buffers of a frozen network.
+  void Unfreeze();
+
+  //! Get the maximum batch size of the frozen network (0 if it isn't frozen).
+  size_t FrozenBatchSize() const { return frozenBatchSize; }
 
   /**
    * Evaluate the feedforward network with the given ppredictors and responses.
@@ -233,9 +281,49 @@ class FFN
                 arma::mat& gradient,
                 const size_t batchSize);
 
+  /**
+   * Evaluate the feedforward network and its gradient on a batch of points,
+   * and return the gradient as a sparse matrix.  This is useful for networks
+   * with embedding (Lookup) layers, whose gradient is nonzero only in the
+   * looked-up columns, together with sparse optimizers such as SparseSGD:
+   * the gradient is computed into a buffer that is never cleared as a whole
+   * (each layer overwrites its part, and Lookup layers clear the columns they
+   * wrote before), and only the touched columns of the Lookup layers are
+   * copied into the sparse gradient.  The batch is evaluated by this network
+   * only, even if NumReplicas() is larger than one.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::sp_mat& gradient,
+                              const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the feedforward network on a batch of points as
+   * a sparse matrix.  See the sparse overload of EvaluateWithGradient().
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize);
+
   /**
    * Shuffle the order of function visitation. This may be called by the
-   * optimizer.
+   * optimizer. If Prefetch() is enabled, the data itself is not reordered;
+   * the batches are gathered in the shuffled order instead.
    */
   void Shuffle();
 
@@ -245,14 +333,22 @@ class FFN
    * @param args The layer parameter.
    */
   template <class LayerType, class... Args>
-  void Add(Args... args) { network.push_back(new LayerType(args...)); }
+  void Add(Args... args)
+  {
+    DeleteReplicas();
+    network.push_back(new LayerType(args...));
+  }
 
   /*
    * Add a new module to the model.
    *
    * @param layer The Layer to be added to the model.
    */
-  void Add(LayerTypes<CustomLayers...> layer) { network.push_back(layer); }
+  void Add(LayerTypes<CustomLayers...> layer)
+  {
+    DeleteReplicas();
+    network.push_back(layer);
+  }
 
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
@@ -262,25 +358,214 @@ class FFN
   //! Modify the initial point for the optimization.
   arma::mat& Parameters() { return parameter; }
 
+  /**
+   * Get the number of network replicas used for data-parallel training.  If
+   * this is larger than one, every mini-batch passed to EvaluateWithGradient()
+   * is split into NumReplicas() parts that are evaluated in parallel (with
+   * OpenMP) by copies of the network that share the parameters of this
+   * network, and the gradients of all parts are summed.
+   */
+  size_t NumReplicas() const { return numReplicas; }
+  //! Modify the number of network replicas used for data-parallel training.
+  size_t& NumReplicas() { return numReplicas; }
+
+  /**
+   * Get the checkpoint interval used for training.  If this is 0 (the
+   * default), the output of every layer is kept from the forward pass until
+   * the backward pass.  Otherwise only the outputs of every
+   * CheckpointInterval()-th layer (the checkpoints) are kept during the
+   * forward pass, and the outputs between two checkpoints are computed again
+   * from the first checkpoint when the backward pass reaches them.  This
+   * trades one extra forward pass for less memory: with n layers, an interval
+   * of about sqrt(n) keeps the outputs of about 2 sqrt(n) layers at a time.
+   *
+   * The outputs of the last layer and of layers whose forward pass can't be
+   * repeated exactly (layers with a training mode, such as Dropout and
+   * BatchNorm, see RecomputeVisitor) are always kept.  Only the outputs of the
+   * layers are released; the other intermediate results of a layer are kept.
+   */
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  //! Modify the checkpoint interval used for training.
+  size_t& CheckpointInterval() { return checkpointInterval; }
+
+  /**
+   * Get whether the training batches are prefetched.  If enabled, Shuffle()
+   * only shuffles the order in which the points are visited (the next order is
+   * generated in the background), and the columns of every batch are gathered
+   * into a buffer by a background thread while the previous batch is
+   * evaluated, instead of shuffling a full copy of the data every epoch.  The
+   * augmentation function of Pipeline() is applied to every gathered batch.
+   */
+  bool Prefetch() const { return prefetch; }
+  //! Modify whether the training batches are prefetched.
+  bool& Prefetch() { return prefetch; }
+
+  //! Get the pipeline that gathers the training batches.
+  const BatchPipeline& Pipeline() const { return pipeline; }
+  //! Modify the pipeline that gathers the training batches.
+  BatchPipeline& Pipeline() { return pipeline; }
+
+  /**
+   * Get the sparsity the weights are gradually pruned to during training.  If
+   * this is larger than 0 (the default is 0), the weights of every Linear,
+   * LinearNoBias and Convolution layer with the smallest magnitude are pruned
+   * (set to zero and kept there) while the network is trained.  The sparsity
+   * after the t-th step of the optimizer is s (1 - (1 - t / n)^3), where s is
+   * PruneSparsity() and n is PruneSteps(), so most weights are pruned early,
+   * when the network can still recover from it.  The schedule is advanced by
+   * Train() through an optimizer callback, so the evaluations of a line
+   * search don't count as steps; optimizers that don't take callbacks don't
+   * prune gradually.  The schedule starts again with every call of Train(),
+   * but weights that are already pruned stay pruned.
+   */
+  double PruneSparsity() const { return pruneSparsity; }
+  //! Modify the sparsity the weights are gradually pruned to during training.
+  double& PruneSparsity() { return pruneSparsity; }
+
+  //! Get the number of optimizer steps over which the weights are gradually
+  //! pruned.
+  size_t PruneSteps() const { return pruneSteps; }
+  //! Modify the number of optimizer steps over which the weights are
+  //! gradually pruned.
+  size_t& PruneSteps() { return pruneSteps; }
+
+  //! Get the mask of the pruned parameters (0 for every pruned parameter); it
+  //! is empty if the network hasn't been pruned.
+  const arma::mat& PruneMask() const { return pruneMask; }
+
   //! Get the matrix of responses to the input data points.
   const arma::mat& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
-  arma::mat& Responses() { return responses; }
+  arma::mat& Responses() { pipeline.Clear(); return responses; }
 
   //! Get the matrix of data points (predictors).
   const arma::mat& Predictors() const { return predictors; }
   //! Modify the matrix of data points (predictors).
-  arma::mat& Predictors() { return predictors; }
+  arma::mat& Predictors() { pipeline.Clear(); return predictors; }
 
   /**
    * Reset the module infomration (weights/parameters).
    */
   void ResetParameters();
 
+  /**
+   * Simplify the (trained) network for inference. Every BatchNorm layer that
+   * directly follows a Linear layer is folded into the weights and the bias
+   * of the Linear layer, using the mean and variance collected during
+   * training, and every Linear layer that is directly followed by a sigmoid,
+   * tanh, rectifier or softplus layer is replaced by a FusedLinear layer,
+   * which applies the activation function in the same pass as the bias.
+   *
+   * In deterministic mode the resulting network computes the same function
+   * as before, but with fewer passes over the data.  Since the folded
+   * BatchNorm layers are removed, further training of the network behaves
+   * differently.
+   */
+  void FuseLayers();
+
+  /**
+   * Quantize the (trained) network for inference. Every Linear, LinearNoBias
+   * and Convolution layer is replaced by a QuantizedLinear or
+   * QuantizedConvolution layer, which stores the weights as int8 values with
+   * one scale per output unit (or output map) and multiplies them with the
+   * quantized input with int32 accumulation. The scale of the input of every
+   * quantized layer is calibrated on the given sample of the data, which
+   * should be representative of the data the network is used on. All other
+   * layers keep computing in floating point.
+   *
+   * The quantized layers have no trainable parameters, so the network should
+   * not be trained afterwards. The quantized network can be serialized, and
+   * should be used with Predict().
+   *
+   * @param calibrationData Sample of the input data used to calibrate the
+   *        scale of the input of the quantized layers.
+   */
+  void Quantize(const arma::mat& calibrationData);
+
+  /**
+   * Prune the weights of the network by magnitude: in every Linear,
+   * LinearNoBias and Convolution layer, the given fraction of the weights
+   * with the smallest absolute value is set to zero.  The biases are not
+   * pruned.  The pruned weights are kept at zero if the network is trained
+   * further (see PruneMask()), so the network can be fine-tuned after
+   * pruning.  Use Sparsify() to make use of the zeros for inference.
+   *
+   * @param sparsity The fraction of the weights of every layer to prune (in
+   *        [0, 1)).
+   */
+  void Prune(const double sparsity);
+
+  /**
+   * Convert the pruned layers of the (trained) network for inference. Every
+   * Linear, LinearNoBias and Convolution layer of which at least the given
+   * fraction of the weights is zero is replaced by a SparseLinear or
+   * SparseConvolution layer, which stores only the nonzero weights (in
+   * compressed sparse row format) and computes its output with a
+   * sparse-dense product.  The resulting network computes the same function
+   * as before; the sparse layers have no trainable parameters, so the
+   * network should not be trained afterwards.
+   *
+   * @param minSparsity The fraction of zero weights a layer needs to be
+   *        converted; below about 50% the dense product is faster.
+   */
+  void Sparsify(const double minSparsity = 0.5);
+
+  /**
+   * Prune whole units of the network, which shrinks the dimensions of the
+   * layers instead of producing sparse weights.  For every Linear or
+   * LinearNoBias layer that is connected to another Linear or LinearNoBias
+   * layer only through element-wise layers (activation functions, Dropout),
+   * the given fraction of its output units is removed together with the
+   * matching input units of the next layer; the same is done with the output
+   * maps of Convolution layers that are connected to another Convolution
+   * layer only through element-wise or pooling layers.  The units with the
+   * smallest product of the norms of their incoming and outgoing weights are
+   * removed, so units whose outgoing weights are zero are removed first,
+   * which doesn't change the function of the network.
+   *
+   * The resulting layers are ordinary (smaller) layers, so the network can be
+   * fine-tuned afterwards.
+   *
+   * @param fraction The fraction of the units of every prunable layer to
+   *        remove (in [0, 1)).
+   */
+  void PruneNeurons(const double fraction);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
+  /**
+   * Save the model in the compact binary format.  The file holds a small
+   * header, the serialized layer topology and the parameters as one
+   * contiguous block, in the byte order and floating point format of this
+   * machine.
+   *
+   * If the parameter 'fatal' is set to true, a std::runtime_error exception
+   * will be thrown if the model can't be saved.
+   *
+   * @param filename Name of the file to save the model to.
+   * @param fatal If an error should be reported as fatal (default false).
+   * @return Boolean value indicating success or failure of save.
+   */
+  bool SaveCompact(const std::string& filename, const bool fatal = false) const;
+
+  /**
+   * Load a model that was saved with SaveCompact().  The parameters aren't
+   * copied: the file is mapped into memory and Parameters() points into the
+   * mapping, so processes that load the same file share its pages until the
+   * parameters are modified.  The mapping is private, so modifications (e.g.
+   * further training) never reach the file.
+   *
+   * If the parameter 'fatal' is set to true, a std::runtime_error exception
+   * will be thrown if the model can't be loaded.
+   *
+   * @param filename Name of the file to load the model from.
+   * @param fatal If an error should be reported as fatal (default false).
+   * @return Boolean value indicating success or failure of load.
+   */
+  bool LoadCompact(const std::string& filename, const bool fatal = false);
+
   /**
    * Perform the forward pass of the data in real batch mode.
    *
@@ -353,17 +638,184 @@ class FFN
    */
   void Gradient(arma::mat&& input);
 
+  /**
+   * Choose the layers whose output is kept during the forward pass of the
+   * training, according to the checkpoint interval.
+   */
+  void SelectCheckpoints();
+
+  /**
+   * Compute the backward pass and the gradient segment by segment, from the
+   * last one; the outputs of the layers between two checkpoints are computed
+   * again before the backward pass reaches them, and released afterwards.
+   *
+   * @param input The input of the forward pass.
+   */
+  void CheckpointedBackward(arma::mat&& input);
+
   /**
    * Reset the module status by setting the current deterministic parameter
    * for all modules that implement the Deterministic function.
    */
   void ResetDeterministic();
 
+  /**
+   * Point the output of every layer to its frozen buffer, for a batch of the
+   * given size.  Return false if the buffers aren't allocated (for an input
+   * with the given number of rows).
+   */
+  bool AliasFrozenOutputs(const size_t batchSize, const size_t inputRows);
+
+  /**
+   * Allocate the frozen buffers after a batch with an input of the given
+   * number of rows has been passed through the network.
+   */
+  void AllocateFrozenOutputs(const size_t inputRows);
+
   /**
    * Reset the gradient for all modules that implement the Gradient function.
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Evaluate the network on the given input and target and compute the
+   * gradient with respect to the current parameters. The layers have to be in
+   * the desired (training or testing) mode.
+   *
+   * @param input Input data; it has to stay valid until the function returns.
+   * @param target Target outputs for the input data.
+   * @param gradient Matrix to output gradient into; it has to be of the same
+   *        size as the parameters.
+   * @return The objective of the given batch.
+   */
+  double EvaluateWithGradientBatch(arma::mat&& input,
+                                   arma::mat&& target,
+                                   arma::mat& gradient);
+
+  /**
+   * Make sure there are NumReplicas() - 1 replicas of the network whose
+   * layers use the parameters of this network.
+   */
+  void PrepareReplicas();
+
+  //! Release the network replicas used for data-parallel training.
+  void DeleteReplicas();
+
+  /**
+   * If the given layer is a BaseLayer with the given activation function,
+   * replace it and the given Linear layer by a FusedLinear layer and append
+   * the result to the given network.
+   *
+   * @param linear The Linear layer that produces the input of the layer.
+   * @param layer The layer that should be fused.
+   * @param fusedNetwork Network to append the fused layer to.
+   * @return Whether the layers have been fused.
+   */
+  template<typename ActivationFunction>
+  bool FuseActivation(Linear<arma::mat, arma::mat>* linear,
+                      LayerTypes<CustomLayers...>& layer,
+                      std::vector<LayerTypes<CustomLayers...> >& fusedNetwork);
+
+  /**
+   * Replace the parameters of the network with the given parameters of every
+   * layer, point the layers to the new parameters and reset them.  This is
+   * used after the layers of the network have been replaced.
+   *
+   * @param layerParameters The parameters of every layer of the network.
+   */
+  void SetLayerParameters(const std::vector<arma::mat>& layerParameters);
+
+  /**
+   * Get the number of weights of the given layer that can be pruned; these
+   * are the first parameters of the layer.  This is 0 for all layers except
+   * Linear, LinearNoBias and Convolution.
+   *
+   * @param layer The layer to get the number of prunable weights of.
+   */
+  size_t PrunableWeights(const LayerTypes<CustomLayers...>& layer) const;
+
+  /**
+   * Check whether the output of the given layer depends on every input unit
+   * (or input map, if pooling layers are allowed) on its own.
+   *
+   * @param layer The layer to check.
+   * @param pooling Whether pooling layers are accepted.
+   */
+  bool ElementwiseLayer(const LayerTypes<CustomLayers...>& layer,
+                        const bool pooling) const;
+
+  /**
+   * Compute the mask that prunes the given fraction of the prunable weights
+   * of every layer with the smallest magnitude, and apply it.
+   *
+   * @param sparsity The fraction of the weights of every layer to prune.
+   */
+  void ComputePruneMask(const double sparsity);
+
+  //! Advance the gradual pruning schedule by one step, and compute a new
+  //! mask if the sparsity of the schedule has grown enough.
+  void UpdatePruneMask();
+
+  /**
+   * The callback that Train() passes to the optimizer: after every step, it
+   * advances the gradual pruning schedule and puts the pruned weights back to
+   * zero, in case the optimizer moved them.
+   */
+  class PruneCallback
+  {
+   public:
+    //! Create the callback for the given network.
+    PruneCallback(FFN& network) : network(network) { }
+
+    //! Advance the pruning schedule after a step of the optimizer.
+    template<typename OptimizerType, typename FunctionType>
+    bool StepTaken(OptimizerType& /* optimizer */,
+                   FunctionType& /* function */,
+                   arma::mat& coordinates)
+    {
+      if (network.pruneSparsity > 0.0)
+        network.UpdatePruneMask();
+      if (!network.pruneMask.is_empty())
+        coordinates %= network.pruneMask;
+      return false;
+    }
+
+   private:
+    //! The network that is trained.
+    FFN& network;
+  };
+
+  /**
+   * Run the optimizer on the parameters of the network, with the pruning
+   * callback and the given callbacks.  This overload is only used if the
+   * optimizer takes callbacks.
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  auto Optimize(OptimizerType& optimizer,
+                int /* takesCallbacks */,
+                CallbackTypes&&... callbacks)
+      -> decltype(optimizer.Optimize(std::declval<FFN&>(),
+          std::declval<arma::mat&>(), std::declval<PruneCallback>(),
+          std::forward<CallbackTypes>(callbacks)...));
+
+  /**
+   * Run the optimizer on the parameters of the network, for optimizers that
+   * don't take callbacks (the weights are then not gradually pruned).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Optimize(OptimizerType& optimizer,
+                  long /* takesCallbacks */,
+                  CallbackTypes&&... callbacks);
+
+  /**
+   * Report an error of SaveCompact() or LoadCompact().
+   *
+   * @param message The error message.
+   * @param fatal If the error should be reported as fatal.
+   * @return Always false.
+   */
+  static bool CompactError(const std::string& message, const bool fatal);
+
   /**
    * Swap the content of this network with given network.
    *
@@ -435,6 +887,16 @@ class FFN
   //! The current evaluation mode (training or testing).
   bool deterministic;
 
+  //! The maximum batch size of the frozen network (0 if it isn't frozen).
+  size_t frozenBatchSize;
+
+  //! The number of rows of the input the frozen buffers were allocated for.
+  size_t frozenInputRows;
+
+  //! The output buffers of the layers of the frozen network (empty until
+  //! Predict() allocates them).
+  std::vector<arma::mat> frozenOutputs;
+
   //! Locally-stored delta object.
   arma::mat delta;
 
@@ -450,6 +912,53 @@ class FFN
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
+  //! The number of network replicas used for data-parallel training.
+  size_t numReplicas;
+
+  //! The number of layers between two checkpoints (0 keeps every output).
+  size_t checkpointInterval;
+
+  //! Whether the output of each layer is kept during the forward pass; empty
+  //! if every output is kept.
+  std::vector<bool> checkpoints;
+
+  //! Whether the training batches are gathered by the pipeline.
+  bool prefetch;
+
+  //! The pipeline that gathers the training batches.
+  BatchPipeline pipeline;
+
+  //! The sparsity the weights are gradually pruned to during training.
+  double pruneSparsity;
+
+  //! The number of optimizer steps over which the weights are gradually
+  //! pruned.
+  size_t pruneSteps;
+
+  //! The number of optimizer steps since the start of the gradual pruning.
+  size_t pruneStep;
+
+  //! The sparsity the current mask was computed for.
+  double maskSparsity;
+
+  //! The mask of the pruned parameters; empty if nothing is pruned.
+  arma::mat pruneMask;
+
+  //! Locally-stored replicas of the network (not including this network).
+  std::vector<FFN*> replicas;
+
+  //! Locally-stored gradients of the network replicas.
+  std::vector<arma::mat> replicaGradients;
+
+  //! Memory of the parameters the replica layers currently point to.
+  const double* replicaParameterMemory;
+
+  //! Dense buffer for the sparse gradients; it is never cleared as a whole.
+  arma::mat sparseGradientBuffer;
+
+  //! The mapped file the parameters point into, if loaded by LoadCompact().
+  data::MappedFile mappedParameters;
+
   // The GAN class should have access to internal members.
   template<
     typename Model,
@@ -20,11 +20,29 @@
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
+#include "visitor/recompute_visitor.hpp"
 #include "visitor/set_input_height_visitor.hpp"
 #include "visitor/set_input_width_visitor.hpp"
 
+#include "layer/base_layer.hpp"
+#include "layer/batch_norm.hpp"
+#include "layer/fused_linear.hpp"
+#include "layer/linear.hpp"
+#include "layer/linear_no_bias.hpp"
+#include "layer/convolution.hpp"
+#include "layer/quantized_convolution.hpp"
+#include "layer/quantized_linear.hpp"
+#include "layer/sparse_convolution.hpp"
+#include "layer/sparse_linear.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 #include <boost/serialization/variant.hpp>
 
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -39,7 +57,17 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    frozenBatchSize(0),
+    frozenInputRows(0),
+    numReplicas(1),
+    checkpointInterval(0),
+    prefetch(false),
+    pruneSparsity(0.0),
+    pruneSteps(1000),
+    pruneStep(0),
+    maskSparsity(0.0),
+    replicaParameterMemory(NULL)
 {
   /* Nothing to do here */
 }
@@ -48,6 +76,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::~FFN()
 {
+  DeleteReplicas();
   std::for_each(network.begin(), network.end(),
       boost::apply_visitor(deleteVisitor));
 }
@@ -57,29 +86,37 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
     arma::mat predictors, arma::mat responses)
 {
+  // The pipeline may still gather a batch of the old data.
+  pipeline.Clear();
+
   numFunctions = responses.n_cols;
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
   this->deterministic = true;
   ResetDeterministic();
 
+  // The gradual pruning starts again with the new data.
+  pruneStep = 0;
+
   if (!reset)
     ResetParameters();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
-template<typename OptimizerType>
+template<typename OptimizerType, typename... CallbackTypes>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
       arma::mat predictors,
       arma::mat responses,
-      OptimizerType& optimizer)
+      OptimizerType& optimizer,
+      CallbackTypes&&... callbacks)
 {
   ResetData(std::move(predictors), std::move(responses));
 
   // Train the model.
   Timer::Start("ffn_optimization");
-  const double out = optimizer.Optimize(*this, parameter);
+  const double out = Optimize(optimizer, 0,
+      std::forward<CallbackTypes>(callbacks)...);
   Timer::Stop("ffn_optimization");
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
@@ -98,7 +135,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   // Train the model.
   Timer::Start("ffn_optimization");
-  const double out = optimizer.Optimize(*this, parameter);
+  const double out = Optimize(optimizer, 0);
   Timer::Stop("ffn_optimization");
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
@@ -172,7 +209,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::mat predictors, arma::mat& results)
+    const arma::mat& predictors, arma::mat& results, const size_t batchSize)
 {
   if (parameter.is_empty())
     ResetParameters();
@@ -183,24 +220,114 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(std::move(arma::mat(predictors.colptr(0),
-      predictors.n_rows, 1, false, true)));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
+  if (predictors.n_cols == 0)
+  {
+    results.reset();
+    return;
+  }
 
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
+  const size_t maxBatchSize = (frozenBatchSize > 0) ? frozenBatchSize :
+      batchSize;
+  const size_t effectiveBatchSize = std::max(size_t(1),
+      std::min(maxBatchSize, size_t(predictors.n_cols)));
 
-  for (size_t i = 1; i < predictors.n_cols; i++)
+  for (size_t i = 0; i < predictors.n_cols; i += effectiveBatchSize)
   {
-    Forward(std::move(arma::mat(predictors.colptr(i),
-        predictors.n_rows, 1, false, true)));
+    const size_t currentBatchSize = std::min(effectiveBatchSize,
+        size_t(predictors.n_cols - i));
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
+    // A frozen network computes into its buffers once they are allocated.
+    const bool buffered = (frozenBatchSize > 0) &&
+        AliasFrozenOutputs(currentBatchSize, predictors.n_rows);
+
+    // The layers don't modify their input, so the predictors aren't copied.
+    Forward(std::move(arma::mat(const_cast<arma::mat&>(predictors).colptr(i),
+        predictors.n_rows, currentBatchSize, false, true)));
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
         network.back());
-    results.col(i) = resultsTemp.col(0);
+
+    // The first batch also determines the number of output dimensions.
+    if (i == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+    results.cols(i, i + currentBatchSize - 1) = output;
+
+    if (frozenBatchSize > 0 && !buffered)
+      AllocateFrozenOutputs(predictors.n_rows);
+  }
+
+  // The layers only use the frozen buffers during Predict(), so that training
+  // and changes of the frozen state can't write to them.
+  if (frozenBatchSize > 0)
+  {
+    for (size_t i = 0; i < network.size(); ++i)
+      boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Freeze(
+    const size_t maxBatchSize)
+{
+  if (maxBatchSize == 0)
+  {
+    Log::Fatal << "FFN::Freeze(): the maximum batch size must be positive."
+        << std::endl;
+  }
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  // The buffers are allocated by the next call to Predict().
+  frozenBatchSize = maxBatchSize;
+  frozenInputRows = 0;
+  frozenOutputs.clear();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Unfreeze()
+{
+  frozenBatchSize = 0;
+  frozenInputRows = 0;
+  frozenOutputs.clear();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+AliasFrozenOutputs(const size_t batchSize, const size_t inputRows)
+{
+  if (frozenOutputs.size() != network.size() || frozenInputRows != inputRows)
+    return false;
+
+  // The outputs are non-strict aliases, so a layer whose output doesn't have
+  // the size of its buffer still gets a matrix of the right size.
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    boost::apply_visitor(outputParameterVisitor, network[i]) = arma::mat(
+        frozenOutputs[i].memptr(), frozenOutputs[i].n_rows, batchSize, false,
+        false);
+  }
+
+  return true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+AllocateFrozenOutputs(const size_t inputRows)
+{
+  frozenOutputs.resize(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    frozenOutputs[i].set_size(boost::apply_visitor(outputParameterVisitor,
+        network[i]).n_rows, frozenBatchSize);
   }
+  frozenInputRows = inputRows;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -259,10 +386,18 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  if (prefetch)
+    pipeline.Batch(predictors, responses, begin, batchSize, false);
+
+  arma::mat& batchPredictors = prefetch ? pipeline.Predictors() : predictors;
+  arma::mat& batchResponses = prefetch ? pipeline.Responses() : responses;
+  const size_t batchBegin = prefetch ? 0 : begin;
+
+  Forward(std::move(batchPredictors.cols(batchBegin,
+      batchBegin + batchSize - 1)));
   double res = outputLayer.Forward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)));
+      std::move(batchResponses.cols(batchBegin, batchBegin + batchSize - 1)));
 
   for (size_t i = 0; i < network.size(); ++i)
   {
@@ -320,10 +455,168 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  // With prefetching, the batch is taken from the pipeline (and the next
+  // batch is gathered while this one is evaluated).
+  if (prefetch)
+    pipeline.Batch(predictors, responses, begin, batchSize);
+
+  arma::mat& batchPredictors = prefetch ? pipeline.Predictors() : predictors;
+  arma::mat& batchResponses = prefetch ? pipeline.Responses() : responses;
+  const size_t batchBegin = prefetch ? 0 : begin;
+
+  // Serial case: evaluate the whole batch with this network.
+  if (numReplicas <= 1 || batchSize < numReplicas)
+  {
+    const double res = EvaluateWithGradientBatch(arma::mat(
+        batchPredictors.colptr(batchBegin), batchPredictors.n_rows, batchSize,
+        false, true), arma::mat(batchResponses.colptr(batchBegin),
+        batchResponses.n_rows, batchSize, false, true), gradient);
+
+    if (!pruneMask.is_empty())
+      gradient %= pruneMask;
+
+    return res;
+  }
+
+  // Data-parallel case: split the batch into numReplicas (almost) equal parts;
+  // the first one is evaluated by this network, the others by the replicas.
+  // All of them use the same (read-only) parameters.
+  PrepareReplicas();
+
+  const size_t partSize = batchSize / numReplicas;
+  const size_t remainder = batchSize % numReplicas;
+
+  double res = 0;
+  #pragma omp parallel for reduction(+:res)
+  for (omp_size_t r = 0; r < (omp_size_t) numReplicas; ++r)
+  {
+    const size_t partBegin = batchBegin + r * partSize +
+        std::min((size_t) r, remainder);
+    const size_t currentPartSize = partSize + (((size_t) r < remainder) ?
+        1 : 0);
+
+    FFN& net = (r == 0) ? *this : *replicas[r - 1];
+    arma::mat& partGradient = (r == 0) ? gradient : replicaGradients[r - 1];
+
+    res += net.EvaluateWithGradientBatch(arma::mat(
+        batchPredictors.colptr(partBegin), batchPredictors.n_rows,
+        currentPartSize, false, true), arma::mat(
+        batchResponses.colptr(partBegin), batchResponses.n_rows,
+        currentPartSize, false, true), partGradient);
+  }
+
+  // Reduce the gradients of the replicas.
+  for (size_t r = 0; r < replicaGradients.size(); ++r)
+    gradient += replicaGradients[r];
+
+  if (!pruneMask.is_empty())
+    gradient %= pruneMask;
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+EvaluateWithGradient(const arma::mat& /* parameters */,
+                     const size_t begin,
+                     arma::sp_mat& gradient,
+                     const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (this->deterministic)
+  {
+    this->deterministic = false;
+    ResetDeterministic();
+  }
+
+  // The buffer is only cleared when it is allocated; after that, the dense
+  // layers overwrite their part of it, and the Lookup layers clear the columns
+  // they wrote in the last call.
+  if (sparseGradientBuffer.n_elem != parameter.n_elem)
+    sparseGradientBuffer.zeros(parameter.n_rows, parameter.n_cols);
+
+  if (prefetch)
+    pipeline.Batch(predictors, responses, begin, batchSize);
+
+  arma::mat& batchPredictors = prefetch ? pipeline.Predictors() : predictors;
+  arma::mat& batchResponses = prefetch ? pipeline.Responses() : responses;
+  const size_t batchBegin = prefetch ? 0 : begin;
+
+  const double res = EvaluateWithGradientBatch(arma::mat(
+      batchPredictors.colptr(batchBegin), batchPredictors.n_rows, batchSize,
+      false, true), arma::mat(batchResponses.colptr(batchBegin),
+      batchResponses.n_rows, batchSize, false, true), sparseGradientBuffer);
+
+  // Collect the elements of the gradient that may be nonzero: the touched
+  // columns of the Lookup layers, and everything else.
+  std::vector<arma::uvec> layerIndices;
+  size_t offset = 0;
+  size_t numIndices = 0;
+  arma::uvec indices;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor, network[i]);
+    if (weights == 0)
+      continue;
+
+    if (boost::apply_visitor(SparseGradientVisitor(indices), network[i]))
+      layerIndices.push_back(indices + offset);
+    else
+      layerIndices.push_back(arma::regspace<arma::uvec>(offset,
+          offset + weights - 1));
+
+    numIndices += layerIndices.back().n_elem;
+    offset += weights;
+  }
+
+  arma::umat locations(2, numIndices, arma::fill::zeros);
+  arma::vec values(numIndices);
+  size_t position = 0;
+  for (size_t i = 0; i < layerIndices.size(); ++i)
+  {
+    const arma::uvec& current = layerIndices[i];
+    if (current.n_elem == 0)
+      continue;
+
+    locations.submat(0, position, 0, position + current.n_elem - 1) =
+        current.t();
+    values.subvec(position, position + current.n_elem - 1) =
+        sparseGradientBuffer.elem(current);
+    position += current.n_elem;
+  }
+
+  gradient = arma::sp_mat(locations, values, parameter.n_elem, 1);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+EvaluateWithGradientBatch(arma::mat&& input,
+                          arma::mat&& target,
+                          arma::mat& gradient)
+{
+  SelectCheckpoints();
+
+  Forward(std::move(input));
   double res = outputLayer.Forward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)));
+      std::move(target));
 
   for (size_t i = 0; i < network.size(); ++i)
   {
@@ -332,16 +625,96 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   outputLayer.Backward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)),
-      std::move(error));
+      std::move(target), std::move(error));
 
-  Backward();
-  ResetGradients(gradient);
-  Gradient(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  if (checkpoints.empty())
+  {
+    Backward();
+    ResetGradients(gradient);
+    Gradient(std::move(input));
+  }
+  else
+  {
+    ResetGradients(gradient);
+    CheckpointedBackward(std::move(input));
+    checkpoints.clear();
+  }
 
   return res;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PrepareReplicas()
+{
+  if (replicas.size() != numReplicas - 1)
+  {
+    DeleteReplicas();
+
+    for (size_t r = 0; r < numReplicas - 1; ++r)
+    {
+      FFN* replica = new FFN(outputLayer, initializeRule);
+      for (size_t i = 0; i < network.size(); ++i)
+      {
+        replica->network.push_back(boost::apply_visitor(copyVisitor,
+            network[i]));
+      }
+
+      replica->width = width;
+      replica->height = height;
+      replica->reset = reset;
+      replica->checkpointInterval = checkpointInterval;
+
+      replicas.push_back(replica);
+      replicaGradients.push_back(arma::mat());
+    }
+  }
+
+  // Point the weights of the replica layers to the parameters of this network,
+  // if that hasn't been done yet, or if the memory changed in the meantime.
+  if (replicaParameterMemory != parameter.memptr())
+  {
+    for (size_t r = 0; r < replicas.size(); ++r)
+    {
+      size_t offset = 0;
+      for (size_t i = 0; i < replicas[r]->network.size(); ++i)
+      {
+        offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+            offset), replicas[r]->network[i]);
+
+        boost::apply_visitor(resetVisitor, replicas[r]->network[i]);
+      }
+    }
+
+    replicaParameterMemory = parameter.memptr();
+  }
+
+  for (size_t r = 0; r < replicas.size(); ++r)
+  {
+    if (replicas[r]->deterministic != deterministic)
+    {
+      replicas[r]->deterministic = deterministic;
+      replicas[r]->ResetDeterministic();
+    }
+
+    replicaGradients[r].zeros(parameter.n_rows, parameter.n_cols);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::DeleteReplicas()
+{
+  for (size_t r = 0; r < replicas.size(); ++r)
+    delete replicas[r];
+
+  replicas.clear();
+  replicaGradients.clear();
+  replicaParameterMemory = NULL;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
@@ -357,7 +730,10 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  math::ShuffleData(predictors, responses, predictors, responses);
+  if (prefetch)
+    pipeline.Shuffle(predictors.n_cols);
+  else
+    math::ShuffleData(predictors, responses, predictors, responses);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -371,6 +747,14 @@ void FFN<OutputLayerType, InitializationRuleType,
   NetworkInitialization<InitializationRuleType,
                         CustomLayers...> networkInit(initializeRule);
   networkInit.Initialize(network, parameter);
+
+  // The replicas have to be pointed to the new parameters.
+  replicaParameterMemory = NULL;
+
+  // The layout of the parameters may have changed.
+  sparseGradientBuffer.reset();
+  pruneMask.reset();
+  maskSparsity = 0.0;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -433,6 +817,11 @@ void FFN<OutputLayerType, InitializationRuleType,
         outputParameterVisitor, network[i - 1])), std::move(
         boost::apply_visitor(outputParameterVisitor, network[i]))), network[i]);
 
+    // The output of the previous layer isn't needed anymore, unless it's a
+    // checkpoint.
+    if (!checkpoints.empty() && !checkpoints[i - 1])
+      boost::apply_visitor(outputParameterVisitor, network[i - 1]).reset();
+
     if (!reset)
     {
       // Get the output width.
@@ -493,88 +882,1005 @@ void FFN<OutputLayerType, InitializationRuleType,
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
-template<typename Archive>
-void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
-    Archive& ar, const unsigned int /* version */)
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SelectCheckpoints()
 {
-  ar & BOOST_SERIALIZATION_NVP(parameter);
-  ar & BOOST_SERIALIZATION_NVP(width);
-  ar & BOOST_SERIALIZATION_NVP(height);
-  ar & BOOST_SERIALIZATION_NVP(currentInput);
+  checkpoints.clear();
+  if (checkpointInterval == 0 || network.size() < 3)
+    return;
 
-  // Be sure to clear other layers before loading.
-  if (Archive::is_loading::value)
+  checkpoints.resize(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
   {
-    std::for_each(network.begin(), network.end(),
-        boost::apply_visitor(deleteVisitor));
-    network.clear();
+    checkpoints[i] = ((i + 1) % checkpointInterval == 0) ||
+        (i == network.size() - 1) ||
+        !boost::apply_visitor(RecomputeVisitor(), network[i]);
   }
+}
 
-  ar & BOOST_SERIALIZATION_NVP(network);
-
-  // If we are loading, we need to initialize the weights.
-  if (Archive::is_loading::value)
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::CheckpointedBackward(arma::mat&& input)
+{
+  // Every segment consists of the layers after a checkpoint up to (and
+  // including) the next checkpoint.
+  size_t end = network.size() - 1;
+  while (true)
   {
-    reset = false;
+    size_t begin = end;
+    while (begin > 0 && !checkpoints[begin - 1])
+      --begin;
 
-    size_t offset = 0;
-    for (size_t i = 0; i < network.size(); ++i)
+    // Compute the released outputs of the segment again.
+    for (size_t i = begin; i < end; ++i)
     {
-      offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
-          offset), network[i]);
+      boost::apply_visitor(ForwardVisitor(std::move((i == 0) ? input :
+          boost::apply_visitor(outputParameterVisitor, network[i - 1])),
+          std::move(boost::apply_visitor(outputParameterVisitor,
+          network[i]))), network[i]);
+    }
 
-      boost::apply_visitor(resetVisitor, network[i]);
+    // Like Backward(), this skips the first layer of the network.
+    for (size_t i = end; i >= std::max(begin, (size_t) 1); --i)
+    {
+      boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
+          outputParameterVisitor, network[i])), std::move(
+          (i == network.size() - 1) ? error : boost::apply_visitor(
+          deltaVisitor, network[i + 1])), std::move(boost::apply_visitor(
+          deltaVisitor, network[i]))), network[i]);
     }
 
-    deterministic = true;
-    ResetDeterministic();
+    for (size_t i = begin; i <= end; ++i)
+    {
+      boost::apply_visitor(GradientVisitor(std::move((i == 0) ? input :
+          boost::apply_visitor(outputParameterVisitor, network[i - 1])),
+          std::move((i == network.size() - 1) ? error : boost::apply_visitor(
+          deltaVisitor, network[i + 1]))), network[i]);
+    }
+
+    for (size_t i = begin; i < end; ++i)
+      boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+
+    if (begin == 0)
+      break;
+
+    end = begin - 1;
   }
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
-         CustomLayers...>::Swap(FFN& network)
+         CustomLayers...>::FuseLayers()
 {
-  std::swap(outputLayer, network.outputLayer);
-  std::swap(initializeRule, network.initializeRule);
-  std::swap(width, network.width);
-  std::swap(height, network.height);
-  std::swap(reset, network.reset);
-  std::swap(this->network, network.network);
-  std::swap(predictors, network.predictors);
-  std::swap(responses, network.responses);
-  std::swap(parameter, network.parameter);
-  std::swap(numFunctions, network.numFunctions);
-  std::swap(error, network.error);
-  std::swap(currentInput, network.currentInput);
-  std::swap(deterministic, network.deterministic);
-  std::swap(delta, network.delta);
-  std::swap(inputParameter, network.inputParameter);
-  std::swap(outputParameter, network.outputParameter);
-  std::swap(gradient, network.gradient);
-};
+  if (parameter.is_empty())
+    ResetParameters();
+
+  DeleteReplicas();
+
+  // Collect the new layers together with a copy of their parameters.
+  std::vector<LayerTypes<CustomLayers...> > fusedNetwork;
+  std::vector<arma::mat> fusedParameters;
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor, network[i]);
+    arma::mat layerParameters(parameter.memptr() + offset, weights, 1);
+    offset += weights;
+
+    Linear<arma::mat, arma::mat>** linear =
+        boost::get<Linear<arma::mat, arma::mat>*>(&network[i]);
+    if (linear == NULL)
+    {
+      fusedNetwork.push_back(network[i]);
+      fusedParameters.push_back(std::move(layerParameters));
+      continue;
+    }
+
+    const size_t inSize = (*linear)->InputSize();
+    const size_t outSize = (*linear)->OutputSize();
+    arma::mat weight(layerParameters.memptr(), outSize, inSize, false, true);
+    arma::mat bias(layerParameters.memptr() + weight.n_elem, outSize, 1,
+        false, true);
+
+    // Fold the BatchNorm layer into the weights and the bias:
+    // gamma * (Wx + b - mean) / sqrt(var + eps) + beta.
+    if (i + 1 < network.size())
+    {
+      BatchNorm<arma::mat, arma::mat>** batchNorm =
+          boost::get<BatchNorm<arma::mat, arma::mat>*>(&network[i + 1]);
+      if (batchNorm != NULL && (*batchNorm)->InputSize() == outSize)
+      {
+        const arma::mat gamma(parameter.memptr() + offset, outSize, 1);
+        const arma::mat beta(parameter.memptr() + offset + outSize, outSize,
+            1);
+        offset += 2 * outSize;
+
+        const arma::mat scale = gamma / arma::sqrt(
+            (*batchNorm)->TrainingVariance() + (*batchNorm)->Epsilon());
+        weight.each_col() %= scale;
+        bias = (bias - (*batchNorm)->TrainingMean()) % scale + beta;
+
+        boost::apply_visitor(deleteVisitor, network[i + 1]);
+        ++i;
+      }
+    }
+
+    // Fuse the activation function into the output loop of the layer.
+    if (i + 1 < network.size() && (
+        FuseActivation<LogisticFunction>(*linear, network[i + 1],
+            fusedNetwork) ||
+        FuseActivation<TanhFunction>(*linear, network[i + 1], fusedNetwork) ||
+        FuseActivation<RectifierFunction>(*linear, network[i + 1],
+            fusedNetwork) ||
+        FuseActivation<SoftplusFunction>(*linear, network[i + 1],
+            fusedNetwork)))
+    {
+      ++i;
+    }
+    else
+    {
+      fusedNetwork.push_back(*linear);
+    }
+
+    fusedParameters.push_back(std::move(layerParameters));
+  }
+
+  network = std::move(fusedNetwork);
+  SetLayerParameters(fusedParameters);
+}
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
-FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
-    const FFN& network):
-    outputLayer(network.outputLayer),
-    initializeRule(network.initializeRule),
-    width(network.width),
-    height(network.height),
-    reset(network.reset),
-    predictors(network.predictors),
-    responses(network.responses),
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Quantize(const arma::mat& calibrationData)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  DeleteReplicas();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  // Calibrate the scale of the input of every layer on the given sample.
+  Forward(std::move(arma::mat(const_cast<arma::mat&>(calibrationData).memptr(),
+      calibrationData.n_rows, calibrationData.n_cols, false, true)));
+
+  std::vector<double> inputScales(network.size());
+  inputScales[0] = Int8Quantization::Scale(calibrationData.memptr(),
+      calibrationData.n_elem);
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    const arma::mat& input = boost::apply_visitor(outputParameterVisitor,
+        network[i - 1]);
+    inputScales[i] = Int8Quantization::Scale(input.memptr(), input.n_elem);
+  }
+
+  // Collect the new layers together with a copy of their parameters.
+  std::vector<LayerTypes<CustomLayers...> > quantizedNetwork;
+  std::vector<arma::mat> quantizedParameters;
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor, network[i]);
+    arma::mat layerParameters(parameter.memptr() + offset, weights, 1);
+    offset += weights;
+
+    Linear<arma::mat, arma::mat>** linear =
+        boost::get<Linear<arma::mat, arma::mat>*>(&network[i]);
+    LinearNoBias<arma::mat, arma::mat>** linearNoBias =
+        boost::get<LinearNoBias<arma::mat, arma::mat>*>(&network[i]);
+    Convolution<>** convolution = boost::get<Convolution<>*>(&network[i]);
+
+    if (linear != NULL)
+    {
+      const size_t outSize = (*linear)->OutputSize();
+      const arma::mat weight(layerParameters.memptr(), outSize,
+          (*linear)->InputSize(), false, true);
+      const arma::mat bias(layerParameters.memptr() + weight.n_elem, outSize,
+          1, false, true);
+
+      quantizedNetwork.push_back(new QuantizedLinear<arma::mat, arma::mat>(
+          weight, bias, inputScales[i]));
+    }
+    else if (linearNoBias != NULL)
+    {
+      const arma::mat weight(layerParameters.memptr(),
+          (*linearNoBias)->OutputSize(), (*linearNoBias)->InputSize(), false,
+          true);
+
+      quantizedNetwork.push_back(new QuantizedLinear<arma::mat, arma::mat>(
+          weight, arma::mat(), inputScales[i]));
+    }
+    else if (convolution != NULL)
+    {
+      const Convolution<>& layer = **convolution;
+      const size_t outSize = layer.OutputSize();
+      const arma::mat weight(layerParameters.memptr(), layer.KernelWidth() *
+          layer.KernelHeight() * layer.InputSize(), outSize, false, true);
+      const arma::mat bias(layerParameters.memptr() + weight.n_elem, outSize,
+          1, false, true);
+
+      quantizedNetwork.push_back(new QuantizedConvolution<arma::mat,
+          arma::mat>(layer.InputSize(), outSize, layer.KernelWidth(),
+          layer.KernelHeight(), layer.StrideWidth(), layer.StrideHeight(),
+          layer.PadWidth(), layer.PadHeight(), layer.InputWidth(),
+          layer.InputHeight(), weight, bias, inputScales[i]));
+    }
+    else
+    {
+      quantizedNetwork.push_back(network[i]);
+      quantizedParameters.push_back(std::move(layerParameters));
+      continue;
+    }
+
+    boost::apply_visitor(deleteVisitor, network[i]);
+  }
+
+  network = std::move(quantizedNetwork);
+  SetLayerParameters(quantizedParameters);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Prune(const double sparsity)
+{
+  if (sparsity < 0.0 || sparsity >= 1.0)
+  {
+    throw std::invalid_argument("FFN::Prune(): the sparsity has to be in "
+        "[0, 1)!");
+  }
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  ComputePruneMask(sparsity);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Sparsify(const double minSparsity)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  DeleteReplicas();
+
+  // Collect the new layers together with a copy of their parameters.
+  std::vector<LayerTypes<CustomLayers...> > sparseNetwork;
+  std::vector<arma::mat> sparseParameters;
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor, network[i]);
+    arma::mat layerParameters(parameter.memptr() + offset, weights, 1);
+    offset += weights;
+
+    // Only layers with enough zero weights are converted.
+    const size_t prunable = PrunableWeights(network[i]);
+    if (prunable == 0 || arma::accu(layerParameters.rows(0, prunable - 1) ==
+        0) < minSparsity * prunable)
+    {
+      sparseNetwork.push_back(network[i]);
+      sparseParameters.push_back(std::move(layerParameters));
+      continue;
+    }
+
+    Linear<arma::mat, arma::mat>** linear =
+        boost::get<Linear<arma::mat, arma::mat>*>(&network[i]);
+    LinearNoBias<arma::mat, arma::mat>** linearNoBias =
+        boost::get<LinearNoBias<arma::mat, arma::mat>*>(&network[i]);
+    Convolution<>** convolution = boost::get<Convolution<>*>(&network[i]);
+
+    if (linear != NULL)
+    {
+      const size_t outSize = (*linear)->OutputSize();
+      const arma::mat weight(layerParameters.memptr(), outSize,
+          (*linear)->InputSize(), false, true);
+      const arma::mat bias(layerParameters.memptr() + weight.n_elem, outSize,
+          1, false, true);
+
+      sparseNetwork.push_back(new SparseLinear<arma::mat, arma::mat>(weight,
+          bias));
+    }
+    else if (linearNoBias != NULL)
+    {
+      const arma::mat weight(layerParameters.memptr(),
+          (*linearNoBias)->OutputSize(), (*linearNoBias)->InputSize(), false,
+          true);
+
+      sparseNetwork.push_back(new SparseLinear<arma::mat, arma::mat>(weight,
+          arma::mat()));
+    }
+    else
+    {
+      const Convolution<>& layer = **convolution;
+      const size_t outSize = layer.OutputSize();
+      const arma::mat weight(layerParameters.memptr(), prunable / outSize,
+          outSize, false, true);
+      const arma::mat bias(layerParameters.memptr() + weight.n_elem, outSize,
+          1, false, true);
+
+      sparseNetwork.push_back(new SparseConvolution<arma::mat, arma::mat>(
+          layer.InputSize(), outSize, layer.KernelWidth(),
+          layer.KernelHeight(), layer.StrideWidth(), layer.StrideHeight(),
+          layer.PadWidth(), layer.PadHeight(), layer.InputWidth(),
+          layer.InputHeight(), weight, bias));
+    }
+
+    boost::apply_visitor(deleteVisitor, network[i]);
+  }
+
+  network = std::move(sparseNetwork);
+  SetLayerParameters(sparseParameters);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PruneNeurons(const double fraction)
+{
+  if (fraction < 0.0 || fraction >= 1.0)
+  {
+    throw std::invalid_argument("FFN::PruneNeurons(): the fraction has to be "
+        "in [0, 1)!");
+  }
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  DeleteReplicas();
+
+  // Copy the parameters of every layer, and the dimensions of the layers that
+  // can be shrunk.  The weights of such a layer are handled as a
+  // (area * inSize) x outSize matrix, where the area is the size of a filter
+  // (1 for the linear layers): the incoming weights of an output unit are a
+  // column, and the outgoing weights of an input unit are a block of rows.
+  const size_t layers = network.size();
+  std::vector<arma::mat> layerParameters(layers);
+  std::vector<size_t> inSizes(layers, 0), outSizes(layers, 0), areas(layers, 0);
+  std::vector<bool> convolutional(layers, false), bias(layers, false);
+
+  size_t offset = 0;
+  for (size_t i = 0; i < layers; ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor, network[i]);
+    layerParameters[i] = arma::mat(parameter.memptr() + offset, weights, 1);
+    offset += weights;
+
+    Linear<arma::mat, arma::mat>** linear =
+        boost::get<Linear<arma::mat, arma::mat>*>(&network[i]);
+    LinearNoBias<arma::mat, arma::mat>** linearNoBias =
+        boost::get<LinearNoBias<arma::mat, arma::mat>*>(&network[i]);
+    Convolution<>** convolution = boost::get<Convolution<>*>(&network[i]);
+
+    if (linear != NULL)
+    {
+      inSizes[i] = (*linear)->InputSize();
+      outSizes[i] = (*linear)->OutputSize();
+      areas[i] = 1;
+      bias[i] = true;
+    }
+    else if (linearNoBias != NULL)
+    {
+      inSizes[i] = (*linearNoBias)->InputSize();
+      outSizes[i] = (*linearNoBias)->OutputSize();
+      areas[i] = 1;
+    }
+    else if (convolution != NULL)
+    {
+      inSizes[i] = (*convolution)->InputSize();
+      outSizes[i] = (*convolution)->OutputSize();
+      areas[i] = (*convolution)->KernelWidth() *
+          (*convolution)->KernelHeight();
+      convolutional[i] = true;
+      bias[i] = true;
+    }
+  }
+
+  const std::vector<size_t> originalOutSizes = outSizes;
+  const std::vector<size_t> originalInSizes = inSizes;
+
+  auto weightsOf = [&](const size_t l) -> arma::mat
+  {
+    const size_t n = areas[l] * inSizes[l] * outSizes[l];
+    const arma::mat weight(layerParameters[l].memptr(), n, 1, false, true);
+    if (convolutional[l])
+      return arma::reshape(weight, areas[l] * inSizes[l], outSizes[l]);
+
+    return arma::reshape(weight, outSizes[l], inSizes[l]).t();
+  };
+
+  auto biasOf = [&](const size_t l) -> arma::vec
+  {
+    if (!bias[l])
+      return arma::vec();
+
+    return layerParameters[l].rows(areas[l] * inSizes[l] * outSizes[l],
+        layerParameters[l].n_rows - 1);
+  };
+
+  auto setParameters = [&](const size_t l, const arma::mat& weight,
+                           const arma::vec& layerBias)
+  {
+    layerParameters[l] = arma::join_cols(arma::vectorise(convolutional[l] ?
+        weight : arma::mat(weight.t())), layerBias);
+  };
+
+  for (size_t i = 0; i < layers; ++i)
+  {
+    if (areas[i] == 0)
+      continue;
+
+    // Find the next layer of the same kind, if it is connected only through
+    // layers that handle every unit (or map) on its own.
+    size_t j = i + 1;
+    while (j < layers && ElementwiseLayer(network[j], convolutional[i]))
+      ++j;
+
+    if (j == layers || areas[j] == 0 || convolutional[j] != convolutional[i] ||
+        inSizes[j] != outSizes[i])
+    {
+      continue;
+    }
+
+    const size_t count = (size_t) std::floor(fraction * outSizes[i]);
+    if (count == 0)
+      continue;
+
+    const arma::mat incoming = weightsOf(i);
+    const arma::vec incomingBias = biasOf(i);
+    const arma::mat outgoing = weightsOf(j);
+
+    arma::vec scores(outSizes[i]);
+    for (size_t u = 0; u < outSizes[i]; ++u)
+    {
+      double incomingNorm = arma::norm(incoming.col(u));
+      if (!incomingBias.is_empty())
+        incomingNorm = std::hypot(incomingNorm, incomingBias[u]);
+
+      scores[u] = incomingNorm * arma::norm(arma::vectorise(outgoing.rows(
+          u * areas[j], (u + 1) * areas[j] - 1)));
+    }
+
+    // Keep the units with the largest scores, in their original order.
+    const arma::uvec order = arma::sort_index(scores, "descend");
+    const arma::uvec keep = arma::sort(order.head(outSizes[i] - count));
+
+    arma::uvec keepRows(keep.n_elem * areas[j]);
+    for (size_t k = 0; k < keep.n_elem; ++k)
+      for (size_t a = 0; a < areas[j]; ++a)
+        keepRows[k * areas[j] + a] = keep[k] * areas[j] + a;
+
+    setParameters(i, incoming.cols(keep), incomingBias.is_empty() ?
+        incomingBias : arma::vec(incomingBias.elem(keep)));
+    setParameters(j, outgoing.submat(keepRows, arma::regspace<arma::uvec>(0,
+        outgoing.n_cols - 1)), biasOf(j));
+
+    outSizes[i] = keep.n_elem;
+    inSizes[j] = keep.n_elem;
+  }
+
+  // Replace the layers that have been shrunk.
+  std::vector<LayerTypes<CustomLayers...> > prunedNetwork;
+  for (size_t i = 0; i < layers; ++i)
+  {
+    if (outSizes[i] == originalOutSizes[i] && inSizes[i] == originalInSizes[i])
+    {
+      prunedNetwork.push_back(network[i]);
+      continue;
+    }
+
+    Convolution<>** convolution = boost::get<Convolution<>*>(&network[i]);
+    if (convolution != NULL)
+    {
+      const Convolution<>& layer = **convolution;
+      prunedNetwork.push_back(new Convolution<>(inSizes[i], outSizes[i],
+          layer.KernelWidth(), layer.KernelHeight(), layer.StrideWidth(),
+          layer.StrideHeight(), layer.PadWidth(), layer.PadHeight(),
+          layer.InputWidth(), layer.InputHeight()));
+    }
+    else if (bias[i])
+    {
+      prunedNetwork.push_back(new Linear<arma::mat, arma::mat>(inSizes[i],
+          outSizes[i]));
+    }
+    else
+    {
+      prunedNetwork.push_back(new LinearNoBias<arma::mat, arma::mat>(
+          inSizes[i], outSizes[i]));
+    }
+
+    boost::apply_visitor(deleteVisitor, network[i]);
+  }
+
+  // The new layers get the input dimensions of the layers they replace, so
+  // the network doesn't have to be initialized again before it is trained.
+  const bool layersReset = reset;
+  network = std::move(prunedNetwork);
+  SetLayerParameters(layerParameters);
+  reset = layersReset;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+SetLayerParameters(const std::vector<arma::mat>& layerParameters)
+{
+  size_t weights = 0;
+  for (size_t i = 0; i < layerParameters.size(); ++i)
+    weights += layerParameters[i].n_elem;
+  parameter.set_size(weights, 1);
+
+  // Point the layers to the new parameters.  Some layers (e.g. BatchNorm)
+  // initialize their parameters in Reset(), so the values are copied
+  // afterwards.
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+        offset), network[i]);
+
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+
+  offset = 0;
+  for (size_t i = 0; i < layerParameters.size(); ++i)
+  {
+    if (layerParameters[i].n_elem > 0)
+    {
+      parameter.rows(offset, offset + layerParameters[i].n_elem - 1) =
+          layerParameters[i];
+      offset += layerParameters[i].n_elem;
+    }
+  }
+
+  // The layout of the parameters has changed.
+  replicaParameterMemory = NULL;
+  sparseGradientBuffer.reset();
+  pruneMask.reset();
+  maskSparsity = 0.0;
+
+  reset = false;
+  ResetDeterministic();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+PrunableWeights(const LayerTypes<CustomLayers...>& layer) const
+{
+  Linear<arma::mat, arma::mat>* const* linear =
+      boost::get<Linear<arma::mat, arma::mat>*>(&layer);
+  LinearNoBias<arma::mat, arma::mat>* const* linearNoBias =
+      boost::get<LinearNoBias<arma::mat, arma::mat>*>(&layer);
+  Convolution<>* const* convolution = boost::get<Convolution<>*>(&layer);
+
+  if (linear != NULL)
+    return (*linear)->InputSize() * (*linear)->OutputSize();
+  if (linearNoBias != NULL)
+    return (*linearNoBias)->InputSize() * (*linearNoBias)->OutputSize();
+  if (convolution != NULL)
+  {
+    return (*convolution)->KernelWidth() * (*convolution)->KernelHeight() *
+        (*convolution)->InputSize() * (*convolution)->OutputSize();
+  }
+
+  return 0;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ElementwiseLayer(const LayerTypes<CustomLayers...>& layer,
+                 const bool pooling) const
+{
+  if (pooling && (boost::get<MaxPooling<arma::mat, arma::mat>*>(&layer) ||
+      boost::get<MeanPooling<arma::mat, arma::mat>*>(&layer)))
+  {
+    return true;
+  }
+
+  return boost::get<SigmoidLayer<arma::mat, arma::mat>*>(&layer) ||
+      boost::get<IdentityLayer<arma::mat, arma::mat>*>(&layer) ||
+      boost::get<TanHLayer<arma::mat, arma::mat>*>(&layer) ||
+      boost::get<ReLULayer<arma::mat, arma::mat>*>(&layer) ||
+      boost::get<SoftPlusLayer<arma::mat, arma::mat>*>(&layer) ||
+      boost::get<LeakyReLU<arma::mat, arma::mat>*>(&layer) ||
+      boost::get<ELU<arma::mat, arma::mat>*>(&layer) ||
+      boost::get<HardTanH<arma::mat, arma::mat>*>(&layer) ||
+      boost::get<Dropout<arma::mat, arma::mat>*>(&layer);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ComputePruneMask(const double sparsity)
+{
+  pruneMask.ones(parameter.n_rows, parameter.n_cols);
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t prunable = PrunableWeights(network[i]);
+    if (prunable > 0)
+    {
+      // The weights are the first parameters of the layer; the bias is never
+      // pruned.
+      const arma::vec magnitude = arma::abs(parameter.rows(offset,
+          offset + prunable - 1));
+      const arma::uvec order = arma::sort_index(magnitude);
+      const size_t count = (size_t) std::floor(sparsity * prunable);
+      for (size_t k = 0; k < count; ++k)
+        pruneMask[offset + order[k]] = 0.0;
+    }
+
+    offset += boost::apply_visitor(weightSizeVisitor, network[i]);
+  }
+
+  maskSparsity = sparsity;
+  parameter %= pruneMask;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::UpdatePruneMask()
+{
+  ++pruneStep;
+  const double progress = std::min(1.0, (double) pruneStep /
+      std::max(pruneSteps, (size_t) 1));
+  const double sparsity = pruneSparsity *
+      (1.0 - std::pow(1.0 - progress, 3.0));
+
+  // Computing the mask sorts all weights, so it is only done when the
+  // sparsity has grown by at least 1%, and when the schedule ends.
+  if (sparsity >= maskSparsity + 0.01 ||
+      (progress == 1.0 && sparsity > maskSparsity))
+  {
+    ComputePruneMask(sparsity);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+auto FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Optimize(
+    OptimizerType& optimizer,
+    int /* takesCallbacks */,
+    CallbackTypes&&... callbacks)
+    -> decltype(optimizer.Optimize(std::declval<FFN&>(),
+        std::declval<arma::mat&>(), std::declval<PruneCallback>(),
+        std::forward<CallbackTypes>(callbacks)...))
+{
+  return optimizer.Optimize(*this, parameter, PruneCallback(*this),
+      std::forward<CallbackTypes>(callbacks)...);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Optimize(
+    OptimizerType& optimizer,
+    long /* takesCallbacks */,
+    CallbackTypes&&... callbacks)
+{
+  if (pruneSparsity > 0.0)
+  {
+    Log::Warn << "FFN::Train(): the optimizer does not take callbacks, so the "
+        << "weights are not gradually pruned." << std::endl;
+  }
+
+  return optimizer.Optimize(*this, parameter,
+      std::forward<CallbackTypes>(callbacks)...);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename ActivationFunction>
+bool FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+FuseActivation(Linear<arma::mat, arma::mat>* linear,
+               LayerTypes<CustomLayers...>& layer,
+               std::vector<LayerTypes<CustomLayers...> >& fusedNetwork)
+{
+  if (boost::get<BaseLayer<ActivationFunction, arma::mat, arma::mat>*>(
+      &layer) == NULL)
+  {
+    return false;
+  }
+
+  fusedNetwork.push_back(new FusedLinear<ActivationFunction, arma::mat,
+      arma::mat>(linear->InputSize(), linear->OutputSize()));
+
+  delete linear;
+  boost::apply_visitor(deleteVisitor, layer);
+  return true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename Archive>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameter);
+  ar & BOOST_SERIALIZATION_NVP(width);
+  ar & BOOST_SERIALIZATION_NVP(height);
+  ar & BOOST_SERIALIZATION_NVP(currentInput);
+
+  // Be sure to clear other layers before loading.
+  if (Archive::is_loading::value)
+  {
+    DeleteReplicas();
+    std::for_each(network.begin(), network.end(),
+        boost::apply_visitor(deleteVisitor));
+    network.clear();
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(network);
+
+  // If we are loading, we need to initialize the weights.
+  if (Archive::is_loading::value)
+  {
+    reset = false;
+
+    size_t offset = 0;
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+          offset), network[i]);
+
+      boost::apply_visitor(resetVisitor, network[i]);
+    }
+
+    deterministic = true;
+    ResetDeterministic();
+  }
+}
+
+// The compact format starts with a header of eight 64-bit words: the magic
+// number, a byte order mark, the format version, the size of a parameter
+// element, the size of the serialized topology, the number of rows and columns
+// of the parameter matrix and the offset of the parameters in the file.
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SaveCompact(const std::string& filename,
+                                       const bool fatal) const
+{
+  // Serialize everything but the parameters.
+  std::ostringstream topologyStream;
+  {
+    boost::archive::binary_oarchive ar(topologyStream);
+    ar << BOOST_SERIALIZATION_NVP(width);
+    ar << BOOST_SERIALIZATION_NVP(height);
+    ar << BOOST_SERIALIZATION_NVP(network);
+  }
+  const std::string topology = topologyStream.str();
+
+  // Align the parameters to a cache line, so that they can be used in place.
+  const size_t alignment = 64;
+  const size_t topologyEnd = 8 * sizeof(uint64_t) + topology.size();
+  const size_t offset = (topologyEnd + alignment - 1) / alignment * alignment;
+
+  uint64_t header[8];
+  std::memcpy(&header[0], "MLPKFFN", 8);
+  header[1] = 0x0102030405060708ULL;
+  header[2] = 1;
+  header[3] = sizeof(double);
+  header[4] = topology.size();
+  header[5] = parameter.n_rows;
+  header[6] = parameter.n_cols;
+  header[7] = offset;
+
+  std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary |
+      std::ios::trunc);
+  if (!stream.is_open())
+  {
+    return CompactError("Cannot open file '" + filename + "' for writing.",
+        fatal);
+  }
+
+  const std::string padding(offset - topologyEnd, '\0');
+  stream.write((const char*) header, sizeof(header));
+  stream.write(topology.data(), topology.size());
+  stream.write(padding.data(), padding.size());
+  stream.write((const char*) parameter.memptr(),
+      parameter.n_elem * sizeof(double));
+
+  if (!stream.good())
+    return CompactError("Cannot write to file '" + filename + "'.", fatal);
+
+  return true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::LoadCompact(const std::string& filename,
+                                       const bool fatal)
+{
+  data::MappedFile file;
+  try
+  {
+    file = data::MappedFile(filename);
+  }
+  catch (std::runtime_error& e)
+  {
+    return CompactError("Cannot load model from '" + filename + "': " +
+        e.what() + ".", fatal);
+  }
+
+  uint64_t header[8];
+  if (file.Size() < sizeof(header))
+  {
+    return CompactError("File '" + filename + "' is not a compact model.",
+        fatal);
+  }
+  std::memcpy(header, file.Data(), sizeof(header));
+
+  if (std::memcmp(&header[0], "MLPKFFN", 8) != 0 ||
+      header[1] != 0x0102030405060708ULL || header[2] != 1 ||
+      header[3] != sizeof(double))
+  {
+    return CompactError("File '" + filename + "' is not a compact model "
+        "saved on a compatible machine.", fatal);
+  }
+
+  const uint64_t parameterSize = header[5] * header[6] * sizeof(double);
+  if (header[7] < sizeof(header) + header[4] ||
+      header[7] % sizeof(double) != 0 || header[7] > file.Size() ||
+      parameterSize > file.Size() - header[7])
+  {
+    return CompactError("File '" + filename + "' is truncated or corrupt.",
+        fatal);
+  }
+
+  // Be sure to clear other layers before loading.
+  DeleteReplicas();
+  std::for_each(network.begin(), network.end(),
+      boost::apply_visitor(deleteVisitor));
+  network.clear();
+
+  try
+  {
+    std::istringstream topologyStream(std::string(file.Data() +
+        sizeof(header), header[4]));
+    boost::archive::binary_iarchive ar(topologyStream);
+    ar >> BOOST_SERIALIZATION_NVP(width);
+    ar >> BOOST_SERIALIZATION_NVP(height);
+    ar >> BOOST_SERIALIZATION_NVP(network);
+  }
+  catch (boost::archive::archive_exception& e)
+  {
+    return CompactError("Cannot load model topology from '" + filename +
+        "': " + e.what() + ".", fatal);
+  }
+
+  // Use the mapped parameters in place; the layer weights alias them.
+  parameter = arma::mat((double*) (file.Data() + header[7]), header[5],
+      header[6], false, false);
+  mappedParameters = std::move(file);
+
+  reset = false;
+
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+        offset), network[i]);
+
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+
+  deterministic = true;
+  ResetDeterministic();
+
+  return true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::CompactError(const std::string& message,
+                                        const bool fatal)
+{
+  if (fatal)
+    Log::Fatal << message << std::endl;
+  else
+    Log::Warning << message << std::endl;
+
+  return false;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Swap(FFN& network)
+{
+  // The pipelines may still gather batches of the swapped data; only their
+  // settings are exchanged.
+  pipeline.Clear();
+  network.pipeline.Clear();
+
+  std::swap(outputLayer, network.outputLayer);
+  std::swap(initializeRule, network.initializeRule);
+  std::swap(width, network.width);
+  std::swap(height, network.height);
+  std::swap(reset, network.reset);
+  std::swap(this->network, network.network);
+  std::swap(predictors, network.predictors);
+  std::swap(responses, network.responses);
+  std::swap(parameter, network.parameter);
+  std::swap(numFunctions, network.numFunctions);
+  std::swap(error, network.error);
+  std::swap(currentInput, network.currentInput);
+  std::swap(deterministic, network.deterministic);
+  std::swap(frozenBatchSize, network.frozenBatchSize);
+  std::swap(frozenInputRows, network.frozenInputRows);
+  std::swap(frozenOutputs, network.frozenOutputs);
+  std::swap(delta, network.delta);
+  std::swap(inputParameter, network.inputParameter);
+  std::swap(outputParameter, network.outputParameter);
+  std::swap(gradient, network.gradient);
+  std::swap(numReplicas, network.numReplicas);
+  std::swap(checkpointInterval, network.checkpointInterval);
+  std::swap(prefetch, network.prefetch);
+  std::swap(pipeline.Augmentation(), network.pipeline.Augmentation());
+  std::swap(pruneSparsity, network.pruneSparsity);
+  std::swap(pruneSteps, network.pruneSteps);
+  std::swap(pruneStep, network.pruneStep);
+  std::swap(maskSparsity, network.maskSparsity);
+  std::swap(pruneMask, network.pruneMask);
+  std::swap(replicas, network.replicas);
+  std::swap(replicaGradients, network.replicaGradients);
+  std::swap(replicaParameterMemory, network.replicaParameterMemory);
+  std::swap(sparseGradientBuffer, network.sparseGradientBuffer);
+  std::swap(mappedParameters, network.mappedParameters);
+};
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
+    const FFN& network):
+    outputLayer(network.outputLayer),
+    initializeRule(network.initializeRule),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    predictors(network.predictors),
+    responses(network.responses),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
     error(network.error),
     currentInput(network.currentInput),
     deterministic(network.deterministic),
+    frozenBatchSize(network.frozenBatchSize),
+    frozenInputRows(0),
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    numReplicas(network.numReplicas),
+    checkpointInterval(network.checkpointInterval),
+    prefetch(network.prefetch),
+    pipeline(network.pipeline),
+    pruneSparsity(network.pruneSparsity),
+    pruneSteps(network.pruneSteps),
+    pruneStep(network.pruneStep),
+    maskSparsity(network.maskSparsity),
+    pruneMask(network.pruneMask),
+    replicaParameterMemory(NULL)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -582,6 +1888,24 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     this->network.push_back(boost::apply_visitor(copyVisitor,
         network.network[i]));
   }
+
+  // Point the weights of the new layers to the copied parameters, so that
+  // changing Parameters() changes the copy, as it does for the source network.
+  // Some layers (e.g. BatchNorm) initialize their parameters in Reset(), so
+  // the values are copied back afterwards.
+  if (!parameter.is_empty())
+  {
+    const arma::mat values = parameter;
+    size_t offset = 0;
+    for (size_t i = 0; i < this->network.size(); ++i)
+    {
+      offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+          offset), this->network[i]);
+
+      boost::apply_visitor(resetVisitor, this->network[i]);
+    }
+    parameter = values;
+  }
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -600,12 +1924,31 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     error(std::move(network.error)),
     currentInput(std::move(network.currentInput)),
     deterministic(network.deterministic),
+    frozenBatchSize(network.frozenBatchSize),
+    frozenInputRows(network.frozenInputRows),
+    frozenOutputs(std::move(network.frozenOutputs)),
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    numReplicas(network.numReplicas),
+    checkpointInterval(network.checkpointInterval),
+    prefetch(network.prefetch),
+    pipeline(network.pipeline),
+    pruneSparsity(network.pruneSparsity),
+    pruneSteps(network.pruneSteps),
+    pruneStep(network.pruneStep),
+    maskSparsity(network.maskSparsity),
+    pruneMask(std::move(network.pruneMask)),
+    replicas(std::move(network.replicas)),
+    replicaGradients(std::move(network.replicaGradients)),
+    replicaParameterMemory(network.replicaParameterMemory),
+    sparseGradientBuffer(std::move(network.sparseGradientBuffer)),
+    mappedParameters(std::move(network.mappedParameters))
 {
   this->network = std::move(network.network);
+  network.replicas.clear();
+  network.replicaParameterMemory = NULL;
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -20,6 +20,8 @@
 #include <mlpack/methods/ann/visitor/weight_size_visitor.hpp>
 #include <mlpack/methods/ann/visitor/weight_set_visitor.hpp>
 
+#include <future>
+
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. **/ {
@@ -299,6 +301,34 @@ class GAN
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Evaluate the Discriminator and its gradient on the real batch starting at
+   * the given point, and meanwhile sample noise and run the Generator on it in
+   * another thread.  The two passes are independent, as they only read the
+   * parameters.
+   *
+   * @param i Index of the first point of the real batch.
+   * @return The objective of the Discriminator on the real batch.
+   */
+  double EvaluateRealAndGenerate(const size_t i);
+
+  /**
+   * Evaluate the Discriminator and its gradient (stored in
+   * noiseGradientDiscriminator) on the batch generated last.  The batch is
+   * read from the output of the Generator, without copying it.
+   *
+   * @param label The target of the generated points.
+   * @return The objective of the Discriminator on the generated batch.
+   */
+  double EvaluateGenerated(const double label);
+
+  /**
+   * Compute the gradient of the Generator, by passing the error of the
+   * Discriminator on the generated batch, labeled as real, back through the
+   * Generator.  This uses the forward pass of EvaluateGenerated().
+   */
+  void GeneratorGradient();
+
   //! Locally stored parameter for training data + noise data.
   arma::mat predictors;
   //! Locally stored parameters of the network.
@@ -232,12 +232,13 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   noise.imbue( [&]() { return noiseFunction();} );
   generator.Forward(std::move(noise));
 
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  discriminator.Forward(std::move(discriminator.predictors.cols(numFunctions,
-      numFunctions + batchSize - 1)));
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
+  // The generated batch is passed to the Discriminator without a copy.
+  arma::mat& generated = boost::apply_visitor(outputParameterVisitor,
+      generator.network.back());
+  discriminator.Forward(arma::mat(generated.memptr(), generated.n_rows,
+      generated.n_cols, false, true));
+  discriminator.responses.cols(numFunctions,
+      numFunctions + batchSize - 1).zeros();
 
   currentTarget = arma::mat(discriminator.responses.memptr() + numFunctions,
       1, batchSize, false, false);
@@ -276,16 +277,6 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   else
     gradient.zeros();
 
-  if (noiseGradientDiscriminator.is_empty())
-  {
-    noiseGradientDiscriminator = arma::zeros<arma::mat>(
-        gradientDiscriminator.n_elem, 1);
-  }
-  else
-  {
-    noiseGradientDiscriminator.zeros();
-  }
-
   gradientGenerator = arma::mat(gradient.memptr(),
       generator.Parameters().n_elem, 1, false, false);
 
@@ -294,37 +285,14 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       discriminator.Parameters().n_elem, 1, false, false);
 
   // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
-
-  // Get the gradients of the Generator.
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
+  double res = EvaluateRealAndGenerate(i);
+  res += EvaluateGenerated(0);
   gradientDiscriminator += noiseGradientDiscriminator;
 
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
   {
     // Minimize -log(D(G(noise))).
-    // Pass the error from Discriminator to Generator.
-    discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
-    discriminator.Gradient(discriminator.parameter, numFunctions,
-        noiseGradientDiscriminator, batchSize);
-    generator.error = boost::apply_visitor(deltaVisitor,
-        discriminator.network[1]);
-
-    generator.Predictors() = noise;
-    generator.ResetGradients(gradientGenerator);
-    generator.Gradient(generator.parameter, 0, gradientGenerator, batchSize);
-
-    gradientGenerator *= multiplier;
+    GeneratorGradient();
   }
 
   counter++;
@@ -362,6 +330,97 @@ Gradient(const arma::mat& parameters,
   this->EvaluateWithGradient(parameters, i, gradient, batchSize);
 }
 
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+double GAN<Model, InitializationRuleType, Noise, PolicyType>::
+EvaluateRealAndGenerate(const size_t i)
+{
+  // The Generator is trained on this batch, so its layers are in training
+  // mode.
+  if (generator.deterministic)
+  {
+    generator.deterministic = false;
+    generator.ResetDeterministic();
+  }
+
+  // The noise is sampled on this thread, so it only depends on the seed.
+  noise.imbue( [&]() { return noiseFunction();} );
+  std::future<void> generation = std::async(std::launch::async, [this]()
+  {
+    generator.Forward(std::move(noise));
+  });
+
+  const double res = discriminator.EvaluateWithGradient(
+      discriminator.parameter, i, gradientDiscriminator, batchSize);
+
+  generation.get();
+  return res;
+}
+
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+double GAN<Model, InitializationRuleType, Noise, PolicyType>::
+EvaluateGenerated(const double label)
+{
+  arma::mat& generated = boost::apply_visitor(outputParameterVisitor,
+      generator.network.back());
+  discriminator.responses.cols(numFunctions,
+      numFunctions + batchSize - 1).fill(label);
+
+  // The layers are in training mode after the pass on the real batch.
+  noiseGradientDiscriminator.zeros(discriminator.parameter.n_elem, 1);
+  return discriminator.EvaluateWithGradientBatch(arma::mat(generated.memptr(),
+      generated.n_rows, generated.n_cols, false, true), arma::mat(
+      discriminator.responses.colptr(numFunctions), 1, batchSize, false, true),
+      noiseGradientDiscriminator);
+}
+
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+void GAN<Model, InitializationRuleType, Noise, PolicyType>::
+GeneratorGradient()
+{
+  arma::mat& generated = boost::apply_visitor(outputParameterVisitor,
+      generator.network.back());
+
+  // With checkpoints, the Discriminator released some of its outputs.
+  if (discriminator.CheckpointInterval() != 0)
+  {
+    discriminator.Forward(arma::mat(generated.memptr(), generated.n_rows,
+        generated.n_cols, false, true));
+  }
+
+  // Pass the error of the Discriminator on the generated batch, labeled as
+  // real, back to the Generator.
+  discriminator.responses.cols(numFunctions,
+      numFunctions + batchSize - 1).ones();
+  discriminator.outputLayer.Backward(std::move(boost::apply_visitor(
+      outputParameterVisitor, discriminator.network.back())), arma::mat(
+      discriminator.responses.colptr(numFunctions), 1, batchSize, false, true),
+      std::move(discriminator.error));
+  discriminator.Backward();
+  generator.error = boost::apply_visitor(deltaVisitor,
+      discriminator.network[1]);
+
+  generator.Backward();
+  generator.ResetGradients(gradientGenerator);
+  generator.Gradient(std::move(noise));
+
+  gradientGenerator *= multiplier;
+}
+
 template<
   typename Model,
   typename InitializationRuleType,
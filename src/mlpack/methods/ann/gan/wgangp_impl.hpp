@@ -52,14 +52,13 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   noise.imbue( [&]() { return noiseFunction();} );
   generator.Forward(std::move(noise));
 
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
+  // The generated batch is passed to the Discriminator without a copy.
+  arma::mat& generatedData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      generatedData;
-  discriminator.Forward(std::move(discriminator.predictors.cols(numFunctions,
-      numFunctions + batchSize - 1)));
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
+  discriminator.Forward(arma::mat(generatedData.memptr(),
+      generatedData.n_rows, generatedData.n_cols, false, true));
+  discriminator.responses.cols(numFunctions,
+      numFunctions + batchSize - 1).fill(-1);
 
   currentTarget = arma::mat(discriminator.responses.memptr() + numFunctions,
       1, batchSize, false, false);
@@ -108,16 +107,6 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   else
     gradient.zeros();
 
-  if (noiseGradientDiscriminator.is_empty())
-  {
-    noiseGradientDiscriminator = arma::zeros<arma::mat>(
-        gradientDiscriminator.n_elem, 1);
-  }
-  else
-  {
-    noiseGradientDiscriminator.zeros();
-  }
-
   gradientGenerator = arma::mat(gradient.memptr(),
       generator.Parameters().n_elem, 1, false, false);
 
@@ -129,46 +118,32 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       predictors.n_rows, batchSize, false, false);
 
   // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
+  double res = EvaluateRealAndGenerate(i);
+  const arma::mat& generatedData = boost::apply_visitor(
+      outputParameterVisitor, generator.network.back());
 
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
-      generator.network.back());
-
-  // Gradient Penalty is calculated here.
+  // Gradient Penalty is calculated here.  The interpolated points are stored
+  // in the columns of the Discriminator data reserved for generated points.
   double epsilon = math::Random();
   discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
-  discriminator.Gradient(discriminator.parameter, numFunctions,
-      normGradientDiscriminator, batchSize);
+  discriminator.responses.cols(numFunctions,
+      numFunctions + batchSize - 1).fill(-1);
+  normGradientDiscriminator.zeros(discriminator.parameter.n_elem, 1);
+  discriminator.EvaluateWithGradientBatch(arma::mat(
+      discriminator.predictors.colptr(numFunctions),
+      discriminator.predictors.n_rows, batchSize, false, true), arma::mat(
+      discriminator.responses.colptr(numFunctions), 1, batchSize, false, true),
+      normGradientDiscriminator);
   res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
 
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      generatedData;
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
+  res += EvaluateGenerated(-1);
   gradientDiscriminator += noiseGradientDiscriminator;
 
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
   {
     // Minimize -D(G(noise)).
-    // Pass the error from Discriminator to Generator.
-    discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
-    discriminator.Gradient(discriminator.parameter, numFunctions,
-        noiseGradientDiscriminator, batchSize);
-    generator.error = boost::apply_visitor(deltaVisitor,
-        discriminator.network[1]);
-
-    generator.Predictors() = noise;
-    generator.ResetGradients(gradientGenerator);
-    generator.Gradient(generator.parameter, 0, gradientGenerator, batchSize);
-
-    gradientGenerator *= multiplier;
+    GeneratorGradient();
   }
 
   counter++;
@@ -98,7 +98,7 @@ inline void GlorotInitializationType<false>::Initialize(arma::Mat<eT>& W,
                                                        const size_t cols)
 {
   if (W.is_empty())
-  W = arma::mat(rows, cols);
+  W = arma::Mat<eT>(rows, cols);
 
   double var = 2.0/double(rows + cols);
   GaussianInitialization normalInit(0.0, var);
@@ -112,7 +112,7 @@ inline void GlorotInitializationType<true>::Initialize(arma::Mat<eT>& W,
                                                        const size_t cols)
 {
   if (W.is_empty())
-  W = arma::mat(rows, cols);
+  W = arma::Mat<eT>(rows, cols);
 
   // Limit of distribution.
   double a = sqrt(6) / sqrt(rows + cols);
@@ -129,7 +129,7 @@ inline void GlorotInitializationType<Uniform>::Initialize(arma::Cube<eT>& W,
 {
   if (W.is_empty())
   {
-    W = arma::cube(rows, cols, slices);
+    W = arma::Cube<eT>(rows, cols, slices);
   }
   for (size_t i = 0; i < slices; i++)
     Initialize(W.slice(i), rows, cols);
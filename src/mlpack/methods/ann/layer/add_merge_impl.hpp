@@ -19,6 +19,7 @@
 #include "../visitor/forward_visitor.hpp"
 #include "../visitor/backward_visitor.hpp"
 #include "../visitor/gradient_visitor.hpp"
+#include "branches.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -51,12 +52,12 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Forward(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    ForEachBranch(network.size(), input.n_elem, [&](const size_t i)
     {
       boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
           boost::apply_visitor(outputParameterVisitor, network[i]))),
           network[i]);
-    }
+    });
   }
 
   output = boost::apply_visitor(outputParameterVisitor, network.front());
@@ -74,12 +75,12 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Backward(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    ForEachBranch(network.size(), gy.n_elem, [&](const size_t i)
     {
       boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
           outputParameterVisitor, network[i])), std::move(gy), std::move(
           boost::apply_visitor(deltaVisitor, network[i]))), network[i]);
-    }
+    });
 
     g = boost::apply_visitor(deltaVisitor, network[0]);
     for (size_t i = 1; i < network.size(); ++i)
@@ -101,11 +102,11 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Gradient(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    ForEachBranch(network.size(), error.n_elem, [&](const size_t i)
     {
       boost::apply_visitor(GradientVisitor(std::move(input), std::move(error)),
           network[i]);
-    }
+    });
   }
 }
 
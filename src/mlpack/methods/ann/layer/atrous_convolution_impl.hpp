@@ -96,9 +96,9 @@ void AtrousConvolution<
     OutputDataType
 >::Reset()
 {
-    weight = arma::cube(weights.memptr(), kW, kH,
-        outSize * inSize, false, false);
-    bias = arma::mat(weights.memptr() + weight.n_elem,
+    weight = arma::Cube<typename OutputDataType::elem_type>(weights.memptr(),
+        kW, kH, outSize * inSize, false, false);
+    bias = OutputDataType(weights.memptr() + weight.n_elem,
         outSize, 1, false, false);
 }
 
@@ -119,7 +119,7 @@ void AtrousConvolution<
 >::Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
   batchSize = input.n_cols;
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&&>(input).memptr(),
+  inputTemp = arma::Cube<eT>(const_cast<arma::Mat<eT>&&>(input).memptr(),
       inputWidth, inputHeight, inSize * batchSize, false, false);
 
   if (padW != 0 || padH != 0)
@@ -133,8 +133,36 @@ void AtrousConvolution<
   output.set_size(wConv * hConv * outSize, batchSize);
   outputTemp = arma::Cube<eT>(output.memptr(), wConv, hConv,
       outSize * batchSize, false, false);
-  outputTemp.zeros();
 
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    // Unroll all input maps of a sample into one patch matrix and compute
+    // every output map with a single matrix multiplication. The patches are
+    // kept for the gradient computation.
+    const arma::Cube<eT>& inputSource = (padW != 0 || padH != 0) ?
+        inputPaddedTemp : inputTemp;
+    const arma::Mat<eT> weightMat(weight.memptr(), kW * kH * inSize,
+        outSize, false, true);
+
+    inputPatches.set_size(wConv * hConv, kW * kH * inSize, batchSize);
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      Im2ColConvolution<ValidConvolution>::Im2Col(inputSource, b * inSize,
+          inSize, kW, kH, dW, dH, dilationW, dilationH, wConv, hConv,
+          inputPatches.slice(b));
+
+      arma::Mat<eT> outputMat(output.colptr(b), wConv * hConv, outSize,
+          false, true);
+      outputMat = inputPatches.slice(b) * weightMat;
+      outputMat.each_row() += bias.t();
+    }
+
+    outputWidth = wConv;
+    outputHeight = hConv;
+    return;
+  }
+
+  outputTemp.zeros();
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -188,7 +216,7 @@ void AtrousConvolution<
 >::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError(gy.memptr(), outputWidth, outputHeight,
+  arma::Cube<eT> mappedError(gy.memptr(), outputWidth, outputHeight,
       outSize * batchSize, false, false);
 
   g.set_size(inputTemp.n_rows * inputTemp.n_cols * inSize, batchSize);
@@ -196,6 +224,44 @@ void AtrousConvolution<
       inputTemp.n_cols, inputTemp.n_slices, false, false);
   gTemp.zeros();
 
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    // Propagate the error of all output maps back to the patches with one
+    // matrix multiplication and fold the patches into the input maps.
+    const arma::Mat<eT> weightMat(weight.memptr(), kW * kH * inSize,
+        outSize, false, true);
+
+    arma::Cube<eT>& gSource = (padW != 0 || padH != 0) ? gPaddedTemp : gTemp;
+    if (padW != 0 || padH != 0)
+    {
+      gPaddedTemp.zeros(inputTemp.n_rows + padW * 2,
+          inputTemp.n_cols + padH * 2, inputTemp.n_slices);
+    }
+
+    arma::Mat<eT> patchError;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      const arma::Mat<eT> errorMat(gy.colptr(b), outputWidth * outputHeight,
+          outSize, false, true);
+      patchError = errorMat * weightMat.t();
+
+      Im2ColConvolution<ValidConvolution>::Col2Im(patchError, b * inSize,
+          inSize, kW, kH, dW, dH, dilationW, dilationH, outputWidth,
+          outputHeight, gSource);
+    }
+
+    if (padW != 0 || padH != 0)
+    {
+      for (size_t i = 0; i < gTemp.n_slices; ++i)
+      {
+        gTemp.slice(i) = gPaddedTemp.slice(i).submat(padW, padH,
+            padW + gTemp.n_rows - 1, padH + gTemp.n_cols - 1);
+      }
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -246,7 +312,7 @@ void AtrousConvolution<
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  arma::cube mappedError(error.memptr(), outputWidth, outputHeight,
+  arma::Cube<eT> mappedError(error.memptr(), outputWidth, outputHeight,
       outSize * batchSize, false, false);
 
   gradient.set_size(weights.n_elem, 1);
@@ -254,6 +320,27 @@ void AtrousConvolution<
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
 
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    // Reuse the (dilated) patches of the forward pass; the weight gradient of
+    // a sample is the product of its patch matrix and its error.
+    arma::Mat<eT> gradientMat(gradient.memptr(), kW * kH * inSize, outSize,
+        false, true);
+    arma::Mat<eT> biasGradient(gradient.memptr() + weight.n_elem, 1,
+        outSize, false, true);
+    biasGradient.zeros();
+
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      const arma::Mat<eT> errorMat(error.colptr(b),
+          outputWidth * outputHeight, outSize, false, true);
+      gradientMat += inputPatches.slice(b).t() * errorMat;
+      biasGradient += arma::sum(errorMat);
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -83,9 +83,15 @@ class BaseLayer
                 arma::Mat<eT>&& gy,
                 arma::Mat<eT>&& g)
   {
-    arma::Mat<eT> derivative;
-    ActivationFunction::Deriv(input, derivative);
-    g = gy % derivative;
+    // The derivative is computed in the same pass as the product, so the
+    // backward pass reads the output and the error once and allocates nothing
+    // (unless g has the wrong size).
+    g.set_size(gy.n_rows, gy.n_cols);
+    const eT* y = input.memptr();
+    const eT* error = gy.memptr();
+    eT* out = g.memptr();
+    for (size_t i = 0; i < g.n_elem; ++i)
+      out[i] = error[i] * ActivationFunction::Deriv(y[i]);
   }
 
   //! Get the output parameter.
@@ -138,6 +138,12 @@ class BatchNorm
   //! Get the variance over the training data.
   OutputDataType TrainingVariance() { return runningVariance / count; }
 
+  //! Get the number of input units.
+  size_t InputSize() const { return size; }
+
+  //! Get the epsilon value used for numerical stability.
+  double Epsilon() const { return eps; }
+
   /**
    * Serialize the layer
    */
@@ -178,6 +184,9 @@ class BatchNorm
   //! Locally-stored variance object.
   OutputDataType variance;
 
+  //! Locally-stored inverse standard deviation (1 / sqrt(variance + eps)).
+  OutputDataType stdInv;
+
   //! Locally-stored mean object.
   OutputDataType runningMean;
 
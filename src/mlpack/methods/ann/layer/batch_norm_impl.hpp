@@ -17,6 +17,8 @@
 // In case it is not included.
 #include "batch_norm.hpp"
 
+#include "normalization.hpp"
+
 namespace mlpack {
 namespace ann { /** Artificial Neural Network. */
 
@@ -46,8 +48,9 @@ BatchNorm<InputDataType, OutputDataType>::BatchNorm(
 template<typename InputDataType, typename OutputDataType>
 void BatchNorm<InputDataType, OutputDataType>::Reset()
 {
-  gamma = arma::mat(weights.memptr(), size, 1, false, false);
-  beta = arma::mat(weights.memptr() + gamma.n_elem, size, 1, false, false);
+  gamma = OutputDataType(weights.memptr(), size, 1, false, false);
+  beta = OutputDataType(weights.memptr() + gamma.n_elem, size, 1, false,
+      false);
 
   if (!loading)
   {
@@ -64,67 +67,86 @@ template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
+  output.set_size(arma::size(input));
+
   // Mean and variance over the entire training set will be used to compute
   // the forward pass when deterministic is set to true.
   if (deterministic)
   {
+    const OutputDataType scale = gamma /
+        arma::sqrt(runningVariance / count + eps);
+
     // Normalize the input and scale and shift the output.
-    output = input.each_col() - runningMean;
-    output.each_col() %= gamma / arma::sqrt(runningVariance / count + eps);
-    output.each_col() += beta;
+    ForEachColumnBlock(input.n_rows, input.n_cols,
+        [&](const size_t /* block */, const size_t begin, const size_t end)
+    {
+      for (size_t j = begin; j < end; ++j)
+      {
+        const eT* x = input.colptr(j);
+        eT* y = output.colptr(j);
+        for (size_t i = 0; i < input.n_rows; ++i)
+          y[i] = (x[i] - runningMean[i]) * scale[i] + beta[i];
+      }
+    });
   }
   else
   {
-    mean = arma::mean(input, 1);
-    variance = arma::var(input, 1, 1);
-
-    // Normalize the input.
-    output = input.each_col() - mean;
-    output.each_col() /= arma::sqrt(variance + eps);
-
-    // Use Welford method to compute the sample variance and mean.
-    for (size_t i = 0; i < input.n_cols; i++)
+    OutputDataType m2;
+    RowMoments(input, mean, m2);
+    variance = m2 / input.n_cols;
+    stdInv = 1.0 / arma::sqrt(variance + eps);
+
+    // Add the batch to the mean and variance over the training set.
+    MergeMoments(count, runningMean, runningVariance, input.n_cols, mean, m2);
+    count += input.n_cols;
+
+    // Normalize the input, and scale and shift the output. The normalized
+    // input is reused in the backward and gradient step.
+    normalized.set_size(arma::size(input));
+    ForEachColumnBlock(input.n_rows, input.n_cols,
+        [&](const size_t /* block */, const size_t begin, const size_t end)
     {
-      count += 1;
-
-      OutputDataType delta = input.col(i) - runningMean;
-      runningMean = runningMean + delta / count;
-      runningVariance += delta % (input.col(i) - runningMean);
-    }
-
-    // Reused in the backward and gradient step.
-    normalized = output;
-
-    // Scale and shift the output.
-    output.each_col() %= gamma;
-    output.each_col() += beta;
+      for (size_t j = begin; j < end; ++j)
+      {
+        const eT* x = input.colptr(j);
+        eT* xhat = normalized.colptr(j);
+        eT* y = output.colptr(j);
+        for (size_t i = 0; i < input.n_rows; ++i)
+        {
+          xhat[i] = (x[i] - mean[i]) * stdInv[i];
+          y[i] = xhat[i] * gamma[i] + beta[i];
+        }
+      }
+    });
   }
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Backward(
-    const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  const arma::mat inputMean = input.each_col() - mean;
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // Step 1: dl / dxhat
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 1) %
-      arma::pow(stdInv, 3.0) * -0.5;
-
-  // Step 4: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_col() % stdInv) + (inputMean.each_col() %
-      var * 2 / input.n_cols);
-
-  // Step 3: sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_col() += (arma::sum(norm.each_col() % -stdInv, 1) + (var %
-      arma::mean(-2 * inputMean, 1))) / input.n_cols;
+  // With the normalized input xhat and the number of samples m:
+  // g = gamma * stdInv * (gy - sum(gy) / m - xhat * sum(gy * xhat) / m).
+  arma::Mat<eT> productSums, sums;
+  NormalizedRowSums(normalized, gy, productSums, sums);
+  const arma::Mat<eT> scale = gamma % stdInv;
+  productSums /= gy.n_cols;
+  sums /= gy.n_cols;
+
+  g.set_size(arma::size(gy));
+  ForEachColumnBlock(gy.n_rows, gy.n_cols,
+      [&](const size_t /* block */, const size_t begin, const size_t end)
+  {
+    for (size_t j = begin; j < end; ++j)
+    {
+      const eT* xhat = normalized.colptr(j);
+      const eT* dy = gy.colptr(j);
+      eT* out = g.colptr(j);
+      for (size_t i = 0; i < gy.n_rows; ++i)
+        out[i] = scale[i] * (dy[i] - sums[i] - xhat[i] * productSums[i]);
+    }
+  });
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -134,14 +156,14 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient.set_size(size + size, 1);
+  // The gradient of gamma is sum(dl / dy * xhat), the gradient of beta is
+  // sum(dl / dy).
+  arma::Mat<eT> productSums, sums;
+  NormalizedRowSums(normalized, error, productSums, sums);
 
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
-
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  gradient.set_size(size + size, 1);
+  gradient.submat(0, 0, gamma.n_elem - 1, 0) = productSums;
+  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) = sums;
 }
 
 template<typename InputDataType, typename OutputDataType>
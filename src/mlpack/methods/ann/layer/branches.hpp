@@ -0,0 +1,53 @@
+/**
+ * @file branches.hpp
+ *
+ * Helper to run the independent branches of a layer in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_BRANCHES_HPP
+#define MLPACK_METHODS_ANN_LAYER_BRANCHES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Call the given function for every branch of a layer whose branches are
+ * independent (Concat, AddMerge, MultiplyMerge), such as the towers of a
+ * multi-tower model. Every call may only write to the output, delta and
+ * gradient of its own branch. The branches are run in parallel (see
+ * Threads::ParallelFor()) if the data they work on is large enough to make
+ * up for the cost of the parallel section; the layers inside a branch then
+ * run on a single thread.
+ *
+ * @param branches The number of branches.
+ * @param elements The number of elements of the data passed to every branch.
+ * @param function Function to call with the index of every branch.
+ */
+template<typename FunctionType>
+inline void ForEachBranch(const size_t branches,
+                          const size_t elements,
+                          FunctionType function)
+{
+  // Below this size, starting the threads costs more than a branch.
+  const size_t minParallelElements = 4096;
+  if (elements >= minParallelElements)
+  {
+    Threads::ParallelFor(0, branches, function);
+  }
+  else
+  {
+    for (size_t i = 0; i < branches; ++i)
+      function(i);
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
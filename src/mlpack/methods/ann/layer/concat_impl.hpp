@@ -18,6 +18,7 @@
 #include "../visitor/forward_visitor.hpp"
 #include "../visitor/backward_visitor.hpp"
 #include "../visitor/gradient_visitor.hpp"
+#include "branches.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -45,14 +46,17 @@ template<typename eT>
 void Concat<InputDataType, OutputDataType, CustomLayers...>::Forward(
     arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  size_t outSize = 0;
-
-  for (size_t i = 0; i < network.size(); ++i)
+  // Every branch writes to its own output parameter.
+  ForEachBranch(network.size(), input.n_elem, [&](const size_t i)
   {
     boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
         boost::apply_visitor(outputParameterVisitor, network[i]))),
         network[i]);
+  });
 
+  size_t outSize = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
     if (boost::apply_visitor(
         outputParameterVisitor, network[i]).n_elem > outSize)
     {
@@ -86,18 +90,24 @@ template<typename eT>
 void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  size_t outSize = 0;
-  size_t elements = 0;
+  // The position of the error of every branch.
+  std::vector<size_t> offsets(network.size(), 0);
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    offsets[i] = offsets[i - 1] + boost::apply_visitor(outputParameterVisitor,
+        network[i - 1]).n_elem;
+  }
 
-  for (size_t i = 0, j = 0; i < network.size(); ++i, j += elements)
+  // Every branch gets its own copy of its part of the error.
+  ForEachBranch(network.size(), gy.n_elem, [&](const size_t i)
   {
-    elements = boost::apply_visitor(outputParameterVisitor,
+    const size_t elements = boost::apply_visitor(outputParameterVisitor,
         network[i]).n_elem;
 
     arma::mat delta;
     if (gy.n_cols == 1)
     {
-      delta = gy.submat(j, 0, j + elements - 1, 0);
+      delta = gy.submat(offsets[i], 0, offsets[i] + elements - 1, 0);
     }
     else
     {
@@ -107,7 +117,11 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
     boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
         outputParameterVisitor, network[i])), std::move(delta), std::move(
         boost::apply_visitor(deltaVisitor, network[i]))), network[i]);
+  });
 
+  size_t outSize = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
     if (boost::apply_visitor(deltaVisitor, network[i]).n_elem > outSize)
     {
       outSize = boost::apply_visitor(deltaVisitor, network[i]).n_elem;
@@ -154,11 +168,11 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& /* gradient */)
 {
-  for (size_t i = 0; i < network.size(); ++i)
+  ForEachBranch(network.size(), error.n_elem, [&](const size_t i)
   {
     boost::apply_visitor(GradientVisitor(std::move(input),
         std::move(error)), network[i]);
-  }
+  });
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -75,20 +75,17 @@ void ConcatPerformance<
 {
   const size_t elements = input.n_elem / inSize;
 
-  arma::mat subInput = input.submat(0, 0, elements - 1, 0);
-  arma::mat subOutput;
-
-  outputLayer.Backward(std::move(subInput), std::move(target),
-      std::move(subOutput));
-
-  output = arma::zeros(subOutput.n_elem, inSize);
-  output.col(0) = subOutput;
-
-  for (size_t i = elements, j = 0; i < input.n_elem; i+= elements, j++)
+  // The branches share the output layer, so they are evaluated one after
+  // another; the error of the j-th branch is the j-th column.
+  arma::mat subInput, subOutput;
+  for (size_t i = 0, j = 0; i < input.n_elem; i += elements, ++j)
   {
     subInput = input.submat(i, 0, i + elements - 1, 0);
     outputLayer.Backward(std::move(subInput), std::move(target),
-      std::move(subOutput));
+        std::move(subOutput));
+
+    if (j == 0)
+      output = arma::zeros(subOutput.n_elem, inSize);
 
     output.col(j) = subOutput;
   }
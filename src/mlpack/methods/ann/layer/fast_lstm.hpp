@@ -36,6 +36,13 @@ namespace ann /** Artificial Neural Network. */ {
  * Note that FastLSTM network layer does not use peephole connections between
  * the cell and gates.
  *
+ * The four gates are computed with a single matrix multiplication of the
+ * stacked vector [x; 1; h] per step, and the activations, the cell and the
+ * output are updated in one fused pass. The inputs and gate errors of all
+ * steps are kept in buffers that are allocated once per sequence length, so
+ * the weight gradient of the whole sequence is computed with a single matrix
+ * multiplication instead of one per step.
+ *
  * For more information, see the following.
  *
  * @code
@@ -116,6 +123,16 @@ class FastLSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Prepare the cell for the next window of a truncated BPTT pass. Unlike
+   * ResetCell(), the output and the cell state of the last forward step are
+   * kept as the initial state of the window, so the sequence continues; the
+   * error is not propagated back into that state.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void CarryCell(const size_t size);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -255,6 +272,15 @@ class FastLSTM
   //! Weights between the output and gate.
   OutputDataType output2GateWeight;
 
+  //! All gate weights, [input2GateWeight, input2GateBias, output2GateWeight].
+  OutputDataType gateWeight;
+
+  //! Locally-stored stacked input [x; 1; h] of every step.
+  OutputDataType stackedInput;
+
+  //! Locally-stored gate error of every step.
+  OutputDataType gateError;
+
   //! Weights between the input and gate.
   OutputDataType input2GateWeight;
 
@@ -273,6 +299,9 @@ class FastLSTM
   //! Locally-stored cell parameter.
   OutputDataType cell;
 
+  //! Locally-stored cell state before the first step (empty if it is zero).
+  OutputDataType initialCell;
+
   //! Locally-stored cell activation error.
   OutputDataType cellActivation;
 
@@ -290,6 +319,9 @@ class FastLSTM
 
   //! Current backpropagate through time steps.
   size_t bpttSteps;
+
+  //! Number of gradient steps since the gradient was last computed.
+  size_t gradientSteps;
 }; // class FastLSTM
 
 } // namespace ann
@@ -38,7 +38,8 @@ FastLSTM<InputDataType, OutputDataType>::FastLSTM(
     batchStep(0),
     gradientStepIdx(0),
     rhoSize(rho),
-    bpttSteps(0)
+    bpttSteps(0),
+    gradientSteps(0)
 {
   // Weights for: input to gate layer (4 * outsize * inSize + 4 * outsize)
   // and output to gate (4 * outSize).
@@ -60,6 +61,12 @@ void FastLSTM<InputDataType, OutputDataType>::Reset()
   // (linear no bias layer) using the overall layer parameter matrix.
   output2GateWeight = OutputDataType(weights.memptr() + input2GateWeight.n_elem
       + input2GateBias.n_elem, 4 * outSize, outSize, false, false);
+
+  // The three blocks are stored one after another, so together they form the
+  // matrix [input2GateWeight, input2GateBias, output2GateWeight], which is
+  // applied to the stacked vector [input; 1; previous output].
+  gateWeight = OutputDataType(weights.memptr(), 4 * outSize,
+      inSize + 1 + outSize, false, false);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -76,13 +83,18 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
   bpttSteps = std::min(rho, rhoSize);
   forwardStep = 0;
   gradientStepIdx = 0;
+  gradientSteps = 0;
   backwardStep = batchSize * size - 1;
   gradientStep = batchSize * size - 1;
 
   const size_t rhoBatchSize = size * batchSize;
-  if (gate.is_empty() || gate.n_cols != rhoBatchSize)
+  if (gate.is_empty() || gate.n_cols != rhoBatchSize ||
+      stackedInput.n_cols != rhoBatchSize)
   {
     gate.set_size(4 * outSize, rhoBatchSize);
+    gateError.set_size(4 * outSize, rhoBatchSize);
+    stackedInput.set_size(inSize + 1 + outSize, rhoBatchSize);
+    stackedInput.row(inSize).ones();
     gateActivation.set_size(outSize * 3, rhoBatchSize);
     stateActivation.set_size(outSize, rhoBatchSize);
     cellActivation.set_size(outSize, rhoBatchSize);
@@ -107,6 +119,33 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
       outParameter.resize(outSize, (size + 1) * batchSize);
     }
   }
+
+  // A new sequence starts from a zero output and a zero cell state.
+  outParameter.cols(0, batchSize - 1).zeros();
+  initialCell.reset();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::CarryCell(const size_t size)
+{
+  if (batchSize == 0 || cell.is_empty())
+  {
+    ResetCell(size);
+    return;
+  }
+
+  // The forward step wraps around to 0 after the last step of a window.
+  const size_t last = ((forwardStep == 0) ? bpttSteps :
+      forwardStep / batchSize) - 1;
+  OutputDataType lastCell = cell.cols(last * batchSize,
+      last * batchSize + batchStep);
+  OutputDataType lastOutput = outParameter.cols((last + 1) * batchSize,
+      (last + 1) * batchSize + batchStep);
+
+  ResetCell(size);
+
+  outParameter.cols(0, batchStep) = lastOutput;
+  initialCell = std::move(lastCell);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -123,48 +162,54 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
     ResetCell(rhoSize);
   }
 
-  gate.cols(forwardStep, forwardStep + batchStep) = input2GateWeight * input +
-      output2GateWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-  gate.cols(forwardStep, forwardStep + batchStep).each_col() += input2GateBias;
-
-  FastSigmoid(std::move(
-      gate.submat(0, forwardStep, 3 * outSize - 1, forwardStep + batchStep)),
-      std::move(gateActivation.cols(forwardStep, forwardStep + batchStep)));
-
-  stateActivation.cols(forwardStep, forwardStep + batchStep) = arma::tanh(
-      gate.submat(3 * outSize, forwardStep, 4 * outSize - 1,
-      forwardStep + batchStep));
-
-  // Update the cell: cmul1 + cmul2
-  // where cmul1 is input gate * hidden state and
-  // cmul2 is forget gate * cell (prevCell).
-  if (forwardStep == 0)
+  // Compute all gates of all units with a single matrix multiplication.
+  stackedInput.submat(0, forwardStep, inSize - 1, forwardStep + batchStep) =
+      input;
+  stackedInput.submat(inSize + 1, forwardStep, inSize + outSize,
+      forwardStep + batchStep) = outParameter.cols(forwardStep,
+      forwardStep + batchStep);
+  gate.cols(forwardStep, forwardStep + batchStep) = gateWeight *
+      stackedInput.cols(forwardStep, forwardStep + batchStep);
+
+  // Apply the gate activations and update the cell and the output in a single
+  // pass. The rows of the gate matrix hold the input gate, the output gate,
+  // the forget gate and the hidden state, in that order.
+  for (size_t j = forwardStep; j <= forwardStep + batchStep; ++j)
   {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        gateActivation.submat(0, forwardStep, outSize - 1,
-        forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep);
-  }
-  else
-  {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        gateActivation.submat(0, forwardStep, outSize - 1,
-        forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep) +
-        gateActivation.submat(2 * outSize, forwardStep, 3 * outSize - 1,
-        forwardStep + batchStep) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
+    const ElemType* gateCol = gate.colptr(j);
+    ElemType* gateActivationCol = gateActivation.colptr(j);
+    ElemType* stateActivationCol = stateActivation.colptr(j);
+    ElemType* cellCol = cell.colptr(j);
+    ElemType* cellActivationCol = cellActivation.colptr(j);
+    ElemType* outputCol = outParameter.colptr(j + batchSize);
+    const ElemType* prevCellCol = (forwardStep > 0) ?
+        cell.colptr(j - batchSize) : (initialCell.is_empty() ? NULL :
+        initialCell.colptr(j));
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const ElemType inputGate = FastSigmoid(gateCol[i]);
+      const ElemType outputGate = FastSigmoid(gateCol[outSize + i]);
+      const ElemType forgetGate = FastSigmoid(gateCol[2 * outSize + i]);
+      const ElemType state = std::tanh(gateCol[3 * outSize + i]);
+
+      // Update the cell: cmul1 + cmul2
+      // where cmul1 is input gate * hidden state and
+      // cmul2 is forget gate * cell (prevCell).
+      ElemType c = inputGate * state;
+      if (prevCellCol != NULL)
+        c += forgetGate * prevCellCol[i];
+
+      gateActivationCol[i] = inputGate;
+      gateActivationCol[outSize + i] = outputGate;
+      gateActivationCol[2 * outSize + i] = forgetGate;
+      stateActivationCol[i] = state;
+      cellCol[i] = c;
+      cellActivationCol[i] = std::tanh(c);
+      outputCol[i] = cellActivationCol[i] * outputGate;
+    }
   }
 
-  cellActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(cell.cols(forwardStep, forwardStep + batchStep));
-
-  outParameter.cols(forwardStep + batchSize,
-      forwardStep + batchSize + batchStep) = cellActivation.cols(
-      forwardStep, forwardStep + batchStep) % gateActivation.submat(
-      outSize, forwardStep, 2 * outSize - 1, forwardStep + batchStep);
-
   output = OutputType(outParameter.memptr() +
       (forwardStep + batchSize) * outSize, outSize, batchSize, false, false);
 
@@ -185,50 +230,49 @@ void FastLSTM<InputDataType, OutputDataType>::Backward(
     gy += output2GateWeight.t() * prevError;
   }
 
-  cellActivationError = gy % gateActivation.submat(outSize,
-      backwardStep - batchStep, 2 * outSize - 1, backwardStep) %
-      (1 - arma::pow(cellActivation.cols(backwardStep - batchStep,
-      backwardStep), 2));
-
-  if (gradientStepIdx > 0)
-    cellActivationError += forgetGateError;
-
-  forgetGateError = gateActivation.submat(2 * outSize,
-      backwardStep - batchStep, 3 * outSize - 1, backwardStep) %
-      cellActivationError;
-
-  if (backwardStep > batchStep)
+  // Compute the error of all gates in a single pass.
+  cellActivationError.set_size(outSize, batchSize);
+  forgetGateError.set_size(outSize, batchSize);
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep) =
-        cell.cols((backwardStep - batchSize) - batchStep,
-        (backwardStep - batchSize)) % cellActivationError %
-        gateActivation.submat(2 * outSize, backwardStep - batchStep,
-        3 * outSize - 1, backwardStep) % (1.0 - gateActivation.submat(
-        2 * outSize, backwardStep - batchStep, 3 * outSize - 1, backwardStep));
-  }
-  else
-  {
-    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep).zeros();
+    const size_t col = backwardStep - batchStep + j;
+    const ElemType* gyCol = gy.colptr(j);
+    const ElemType* gateActivationCol = gateActivation.colptr(col);
+    const ElemType* stateActivationCol = stateActivation.colptr(col);
+    const ElemType* cellActivationCol = cellActivation.colptr(col);
+    const ElemType* prevCellCol = (backwardStep > batchStep) ?
+        cell.colptr(col - batchSize) : (initialCell.is_empty() ? NULL :
+        initialCell.colptr(col));
+    ElemType* cellErrorCol = cellActivationError.colptr(j);
+    ElemType* forgetErrorCol = forgetGateError.colptr(j);
+    ElemType* errorCol = prevError.colptr(j);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const ElemType inputGate = gateActivationCol[i];
+      const ElemType outputGate = gateActivationCol[outSize + i];
+      const ElemType forgetGate = gateActivationCol[2 * outSize + i];
+      const ElemType state = stateActivationCol[i];
+      const ElemType cellAct = cellActivationCol[i];
+
+      ElemType cellError = gyCol[i] * outputGate * (1 - cellAct * cellAct);
+      if (gradientStepIdx > 0)
+        cellError += forgetErrorCol[i];
+
+      cellErrorCol[i] = cellError;
+      forgetErrorCol[i] = forgetGate * cellError;
+
+      errorCol[i] = state * cellError * inputGate * (1.0 - inputGate);
+      errorCol[outSize + i] = cellAct * gyCol[i] * outputGate *
+          (1.0 - outputGate);
+      errorCol[2 * outSize + i] = (prevCellCol == NULL) ? 0 :
+          prevCellCol[i] * cellError * forgetGate * (1.0 - forgetGate);
+      errorCol[3 * outSize + i] = inputGate * cellError * (1 - state * state);
+    }
   }
 
-  prevError.submat(0, 0, outSize - 1, batchStep) =
-      stateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellActivationError % gateActivation.submat(
-      0, backwardStep - batchStep, outSize - 1, backwardStep) %
-      (1.0 - gateActivation.submat(
-      0, backwardStep - batchStep, outSize - 1, backwardStep));
-
-  prevError.submat(3 * outSize, 0, 4 * outSize - 1, batchStep) =
-      gateActivation.submat(0, backwardStep - batchStep,
-      outSize - 1, backwardStep) % cellActivationError % (1 - arma::pow(
-      stateActivation.cols(backwardStep - batchStep, backwardStep), 2));
-
-  prevError.submat(outSize, 0, 2 * outSize - 1, batchStep) =
-      cellActivation.cols(backwardStep - batchStep,
-      backwardStep) % gy % gateActivation.submat(
-       outSize, backwardStep - batchStep, 2 * outSize - 1, backwardStep) %
-      (1.0 - gateActivation.submat(
-      outSize, backwardStep - batchStep, 2 * outSize - 1, backwardStep));
+  // Keep the error of this step for the gradient computation.
+  gateError.cols(backwardStep - batchStep, backwardStep) = prevError;
 
   g = input2GateWeight.t() * prevError;
 
@@ -236,7 +280,7 @@ void FastLSTM<InputDataType, OutputDataType>::Backward(
   gradientStepIdx++;
   if (gradientStepIdx == bpttSteps)
   {
-    backwardStep = bpttSteps - 1;
+    backwardStep = batchSize * bpttSteps - 1;
     gradientStepIdx = 0;
   }
 }
@@ -244,27 +288,31 @@ void FastLSTM<InputDataType, OutputDataType>::Backward(
 template<typename InputDataType, typename OutputDataType>
 template<typename InputType, typename ErrorType, typename GradientType>
 void FastLSTM<InputDataType, OutputDataType>::Gradient(
-    InputType&& input, ErrorType&& /* error */, GradientType&& gradient)
+    InputType&& /* input */, ErrorType&& /* error */, GradientType&& gradient)
 {
-  // Gradient of the input to gate layer.
-  gradient.submat(0, 0, input2GateWeight.n_elem - 1, 0) =
-      arma::vectorise(prevError * input.t());
-
-  gradient.submat(input2GateWeight.n_elem, 0, input2GateWeight.n_elem +
-      input2GateBias.n_elem - 1, 0) = arma::sum(prevError, 1);
-
-  // Gradient of the output to gate layer.
-  gradient.submat(input2GateWeight.n_elem + input2GateBias.n_elem, 0,
-      gradient.n_elem - 1, 0) = arma::vectorise(prevError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
+  // The inputs and the errors of all steps are kept, so the gradient of the
+  // whole sequence is computed with a single matrix multiplication once the
+  // first step is reached; the earlier calls only contribute zeros.
+  if (gradientStep > batchStep)
+  {
+    gradient.zeros();
+  }
+  else
+  {
+    const size_t steps = gradientSteps + 1;
+    gradient = arma::vectorise(gateError.cols(0, steps * batchSize - 1) *
+        stackedInput.cols(0, steps * batchSize - 1).t());
+  }
 
   if (gradientStep > batchStep)
   {
     gradientStep -= batchSize;
+    gradientSteps++;
   }
   else
   {
     gradientStep = batchSize * bpttSteps - 1;
+    gradientSteps = 0;
   }
 }
 
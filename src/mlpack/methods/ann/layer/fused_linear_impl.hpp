@@ -0,0 +1,134 @@
+/**
+ * @file fused_linear_impl.hpp
+ *
+ * Implementation of the FusedLinear layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "fused_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear() :
+    errorValid(false)
+{
+  // Nothing to do here.
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+FusedLinear<ActivationFunction, InputDataType, OutputDataType>::FusedLinear(
+    const size_t inSize,
+    const size_t outSize) :
+    inSize(inSize),
+    outSize(outSize),
+    errorValid(false)
+{
+  weights.set_size(outSize * inSize + outSize, 1);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Reset()
+{
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
+      outSize, 1, false, false);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  output = weight * input;
+
+  // Add the bias and apply the activation function in a single pass.
+  const eT* b = bias.memptr();
+  for (size_t j = 0; j < output.n_cols; ++j)
+  {
+    eT* out = output.colptr(j);
+    for (size_t i = 0; i < output.n_rows; ++i)
+      out[i] = ActivationFunction::Fn(out[i] + b[i]);
+  }
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  // The derivative of the activation function is expressed in terms of the
+  // output, just like in BaseLayer.
+  ActivationError(input, gy);
+  errorValid = true;
+
+  g = weight.t() * activationError;
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>&& input,
+    arma::Mat<eT>&& error,
+    arma::Mat<eT>&& gradient)
+{
+  // Backward() is not called for the first layer of a network, so the error
+  // with respect to the affine output may have to be computed here.
+  if (!errorValid)
+    ActivationError(outputParameter, error);
+  errorValid = false;
+
+  gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
+      activationError * input.t());
+  gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
+      arma::sum(activationError, 1);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+template<typename eT>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::
+ActivationError(const arma::Mat<eT>& output, const arma::Mat<eT>& error)
+{
+  // The derivative is computed in the same pass as the product.
+  activationError.set_size(error.n_rows, error.n_cols);
+  const eT* y = output.memptr();
+  const eT* e = error.memptr();
+  eT* out = activationError.memptr();
+  for (size_t i = 0; i < activationError.n_elem; ++i)
+    out[i] = e[i] * ActivationFunction::Deriv(y[i]);
+}
+
+template<typename ActivationFunction, typename InputDataType,
+         typename OutputDataType>
+template<typename Archive>
+void FusedLinear<ActivationFunction, InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+
+  // This is inefficient, but we have to allocate this memory so that
+  // WeightSetVisitor gets the right size.
+  if (Archive::is_loading::value)
+    weights.set_size(outSize * inSize + outSize, 1);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
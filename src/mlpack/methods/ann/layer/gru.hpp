@@ -120,6 +120,16 @@ class GRU
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Prepare the cell for the next window of a truncated BPTT pass. Unlike
+   * ResetCell(), the output of the last forward step is kept as the initial
+   * output of the window, so the sequence continues; the error is not
+   * propagated back into it.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void CarryCell(const size_t size);
+
   //! The value of the deterministic parameter.
   bool Deterministic() const { return deterministic; }
   //! Modify the value of the deterministic parameter.
@@ -220,6 +230,9 @@ class GRU
   //! Matrix of all zeroes to initialize the output
   arma::mat allZeros;
 
+  //! Output of the last step before the step counter wrapped around.
+  arma::mat lastOutput;
+
   //! Iterator pointed to the last output produced by the cell
   std::list<arma::mat>::iterator prevOutput;
 
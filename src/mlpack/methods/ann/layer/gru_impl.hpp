@@ -168,6 +168,8 @@ void GRU<InputDataType, OutputDataType>::Forward(
   forwardStep++;
   if (forwardStep == rho)
   {
+    // The output isn't kept for the next step, but CarryCell() may need it.
+    lastOutput = output;
     forwardStep = 0;
     if (!deterministic)
     {
@@ -381,6 +383,24 @@ void GRU<InputDataType, OutputDataType>::ResetCell(const size_t /* size */)
   backwardStep = 0;
 }
 
+template<typename InputDataType, typename OutputDataType>
+void GRU<InputDataType, OutputDataType>::CarryCell(const size_t size)
+{
+  // The step counter wraps around to 0 after the last step of a window.
+  arma::mat initialOutput = (forwardStep == 0) ? lastOutput : *prevOutput;
+  ResetCell(size);
+
+  if (initialOutput.n_rows != outSize || initialOutput.n_cols != batchSize)
+    return;
+
+  outParameter.clear();
+  outParameter.push_back(std::move(initialOutput));
+
+  prevOutput = outParameter.begin();
+  backIterator = outParameter.end();
+  gradIterator = outParameter.end();
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void GRU<InputDataType, OutputDataType>::serialize(
@@ -0,0 +1,176 @@
+/**
+ * @file int8_quantization.hpp
+ *
+ * Symmetric int8 quantization and the int8 matrix product with int32
+ * accumulation used by the quantized layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_INT8_QUANTIZATION_HPP
+#define MLPACK_METHODS_ANN_LAYER_INT8_QUANTIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Helper functions for the post-training quantization of a network. A value
+ * x is represented by the integer round(x / scale), clamped to [-127, 127],
+ * so the scale of a set of values is max(|x|) / 127. The weights of every
+ * output unit (or output map) have their own scale, while all inputs of a
+ * layer share one scale, which is calibrated on a sample of the data.
+ *
+ * The products of the quantized values are accumulated in 32-bit integers
+ * and only the result is converted back to floating point. The inner loop
+ * runs over contiguous int8 values and is vectorized by the compiler (with
+ * the VNNI/dot product instructions, if they are enabled). The accumulator
+ * can't overflow as long as a layer has fewer than 2^31 / 127^2 (about
+ * 133,000) inputs per output.
+ */
+class Int8Quantization
+{
+ public:
+  /**
+   * Compute the scale of the given values, that is the scale that maps the
+   * largest absolute value to 127. If all values are zero, the scale is one.
+   *
+   * @param values Pointer to the values.
+   * @param n Number of values.
+   */
+  template<typename eT>
+  static double Scale(const eT* values, const size_t n)
+  {
+    double maxValue = 0.0;
+    for (size_t i = 0; i < n; ++i)
+      maxValue = std::max(maxValue, (double) std::abs(values[i]));
+
+    return (maxValue > 0.0) ? maxValue / 127.0 : 1.0;
+  }
+
+  /**
+   * Quantize the given values with the given scale.
+   *
+   * @param values Pointer to the values.
+   * @param n Number of values.
+   * @param scale Scale of the quantized values.
+   * @param quantized Pointer to the memory of the quantized values.
+   */
+  template<typename eT>
+  static void Quantize(const eT* values,
+                       const size_t n,
+                       const double scale,
+                       int8_t* quantized)
+  {
+    const double inverseScale = 1.0 / scale;
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double q = std::round(values[i] * inverseScale);
+      quantized[i] = (int8_t) std::max(-127.0, std::min(127.0, q));
+    }
+  }
+
+  /**
+   * Quantize every column of the given weight matrix with its own scale.
+   *
+   * @param weights Weights, one column per output unit.
+   * @param quantized The quantized weights, stored like the weights.
+   * @param scales The scale of every column.
+   */
+  template<typename eT>
+  static void QuantizeColumns(const arma::Mat<eT>& weights,
+                              std::vector<int8_t>& quantized,
+                              arma::vec& scales)
+  {
+    quantized.resize(weights.n_elem);
+    scales.set_size(weights.n_cols);
+    for (size_t j = 0; j < weights.n_cols; ++j)
+    {
+      scales[j] = Scale(weights.colptr(j), weights.n_rows);
+      Quantize(weights.colptr(j), weights.n_rows, scales[j],
+          quantized.data() + j * weights.n_rows);
+    }
+  }
+
+  /**
+   * Convert quantized weights back to floating point.
+   *
+   * @param quantized The quantized weights, one column per output unit.
+   * @param scales The scale of every column.
+   * @param weights The resulting weights.
+   */
+  template<typename eT>
+  static void Dequantize(const std::vector<int8_t>& quantized,
+                         const arma::vec& scales,
+                         arma::Mat<eT>& weights)
+  {
+    const size_t rows = quantized.size() / scales.n_elem;
+    weights.set_size(rows, scales.n_elem);
+    for (size_t j = 0; j < scales.n_elem; ++j)
+      for (size_t i = 0; i < rows; ++i)
+        weights(i, j) = quantized[i + j * rows] * scales[j];
+  }
+
+  /**
+   * Compute output = W^T * input + bias, where the input is quantized with the
+   * given input scale, and W is given by its quantized columns. The columns
+   * of the input are processed in parallel.
+   *
+   * @param weights The quantized weights (input.n_rows x scales.n_elem).
+   * @param weightScales The scale of every column of the weights.
+   * @param inputScale The scale of the input.
+   * @param bias The bias of every output unit; may be empty.
+   * @param input The input, one point per column.
+   * @param output The resulting output, one point per column.
+   */
+  template<typename eT>
+  static void Product(const std::vector<int8_t>& weights,
+                      const arma::vec& weightScales,
+                      const double inputScale,
+                      const arma::vec& bias,
+                      const arma::Mat<eT>& input,
+                      arma::Mat<eT>& output)
+  {
+    const size_t rows = input.n_rows;
+    const size_t outSize = weightScales.n_elem;
+    output.set_size(outSize, input.n_cols);
+
+    // Every block of columns is quantized once and then stays in the cache
+    // while it is multiplied with all weights.
+    const size_t blockSize = 64;
+    const size_t numBlocks = (input.n_cols + blockSize - 1) / blockSize;
+    Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+    {
+      const size_t begin = block * blockSize;
+      const size_t count = std::min(blockSize, size_t(input.n_cols - begin));
+
+      std::vector<int8_t> quantized(rows * count);
+      Quantize(input.colptr(begin), rows * count, inputScale,
+          quantized.data());
+
+      for (size_t o = 0; o < outSize; ++o)
+      {
+        const int8_t* w = weights.data() + o * rows;
+        const double scale = weightScales[o] * inputScale;
+        const double offset = bias.is_empty() ? 0.0 : bias[o];
+        for (size_t j = 0; j < count; ++j)
+        {
+          const int8_t* x = quantized.data() + j * rows;
+          int32_t sum = 0;
+          for (size_t k = 0; k < rows; ++k)
+            sum += int32_t(w[k]) * int32_t(x[k]);
+
+          output(o, begin + j) = sum * scale + offset;
+        }
+      }
+    });
+  }
+}; // class Int8Quantization
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -27,10 +27,15 @@
 #include "multiply_merge.hpp"
 #include "gru.hpp"
 #include "fast_lstm.hpp"
+#include "fused_linear.hpp"
+#include "quantized_convolution.hpp"
+#include "quantized_linear.hpp"
 #include "recurrent.hpp"
 #include "recurrent_attention.hpp"
 #include "reparametrization.hpp"
 #include "sequential.hpp"
+#include "sparse_convolution.hpp"
+#include "sparse_linear.hpp"
 #include "subview.hpp"
 #include "concat.hpp"
 #include "vr_class_reward.hpp"
@@ -173,6 +173,9 @@ class LayerNorm
   //! Locally-stored variance object.
   OutputDataType variance;
 
+  //! Locally-stored inverse standard deviation (1 / sqrt(variance + eps)).
+  OutputDataType stdInv;
+
   //! Locally-stored gradient object.
   OutputDataType gradient;
 
@@ -16,6 +16,8 @@
 // In case it is not included.
 #include "layer_norm.hpp"
 
+#include "normalization.hpp"
+
 namespace mlpack {
 namespace ann { /** Artificial Neural Network. */
 
@@ -58,46 +60,79 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  mean = arma::mean(input, 0);
-  variance = arma::var(input, 1, 0);
-
-  // Normalize the input.
-  output = input.each_row() - mean;
-
-  output.each_row() /= arma::sqrt(variance + eps);
-
-  // Reused in the backward and gradient step.
-  normalized = output;
-
-  // Scale and shift the output.
-  output.each_col() %= gamma;
-  output.each_col() += beta;
+  mean.set_size(1, input.n_cols);
+  variance.set_size(1, input.n_cols);
+  stdInv.set_size(1, input.n_cols);
+  normalized.set_size(arma::size(input));
+  output.set_size(arma::size(input));
+
+  ForEachColumnBlock(input.n_rows, input.n_cols,
+      [&](const size_t /* block */, const size_t begin, const size_t end)
+  {
+    for (size_t j = begin; j < end; ++j)
+    {
+      // Use Welford method to compute the mean and variance of the column.
+      const eT* x = input.colptr(j);
+      double mu = 0.0, m2 = 0.0;
+      for (size_t i = 0; i < input.n_rows; ++i)
+      {
+        const double delta = x[i] - mu;
+        mu += delta / (i + 1);
+        m2 += delta * (x[i] - mu);
+      }
+
+      mean(j) = mu;
+      variance(j) = m2 / input.n_rows;
+      stdInv(j) = 1.0 / std::sqrt(variance(j) + eps);
+
+      // Normalize the input, and scale and shift the output. The normalized
+      // input is reused in the backward and gradient step.
+      eT* xhat = normalized.colptr(j);
+      eT* y = output.colptr(j);
+      for (size_t i = 0; i < input.n_rows; ++i)
+      {
+        xhat[i] = (x[i] - mu) * stdInv(j);
+        y[i] = xhat[i] * gamma[i] + beta[i];
+      }
+    }
+  });
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Backward(
-    const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  const arma::mat inputMean = input.each_row() - mean;
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // dl / dxhat
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 0) %
-      arma::pow(stdInv, 3.0) * -0.5;
-
-  // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_row() % stdInv) + (inputMean.each_row() %
-      var * 2 / input.n_rows);
-
-  // sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_row() += (arma::sum(norm.each_row() % -stdInv, 0) + (var %
-      arma::mean(-2 * inputMean, 0))) / input.n_rows;
+  g.set_size(arma::size(gy));
+  ForEachColumnBlock(gy.n_rows, gy.n_cols,
+      [&](const size_t /* block */, const size_t begin, const size_t end)
+  {
+    for (size_t j = begin; j < end; ++j)
+    {
+      const eT* xhat = normalized.colptr(j);
+      const eT* dy = gy.colptr(j);
+      eT* out = g.colptr(j);
+
+      // With dl / dxhat = gy * gamma and the number of units m:
+      // g = stdInv * (dl / dxhat - sum(dl / dxhat) / m -
+      //     xhat * sum(dl / dxhat * xhat) / m).
+      double sum = 0.0, productSum = 0.0;
+      for (size_t i = 0; i < gy.n_rows; ++i)
+      {
+        const double norm = dy[i] * gamma[i];
+        sum += norm;
+        productSum += norm * xhat[i];
+      }
+
+      sum /= gy.n_rows;
+      productSum /= gy.n_rows;
+      for (size_t i = 0; i < gy.n_rows; ++i)
+      {
+        out[i] = stdInv(j) * (dy[i] * gamma[i] - sum -
+            xhat[i] * productSum);
+      }
+    }
+  });
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -107,14 +142,14 @@ void LayerNorm<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient.set_size(size + size, 1);
-
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
+  // The gradient of gamma is sum(dl / dy * xhat), the gradient of beta is
+  // sum(dl / dy).
+  arma::Mat<eT> productSums, sums;
+  NormalizedRowSums(normalized, error, productSums, sums);
 
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  gradient.set_size(size + size, 1);
+  gradient.submat(0, 0, gamma.n_elem - 1, 0) = productSums;
+  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) = sums;
 }
 
 template<typename InputDataType, typename OutputDataType>
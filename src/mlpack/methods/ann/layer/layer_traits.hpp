@@ -88,6 +88,10 @@ HAS_MEM_FUNC(Reset, HasResetCheck);
 // we can use with SFINAE to catch when a type has a ResetCell() function.
 HAS_MEM_FUNC(ResetCell, HasResetCellCheck);
 
+// This gives us a HasCarryCellCheck<T, U> type (where U is a function pointer)
+// we can use with SFINAE to catch when a type has a CarryCell() function.
+HAS_MEM_FUNC(CarryCell, HasCarryCellCheck);
+
 // This gives us a HasRewardCheck<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Reward() function.
 HAS_MEM_FUNC(Reward, HasRewardCheck);
@@ -108,6 +112,11 @@ HAS_MEM_FUNC(Rho, HasRho);
 // can use with SFINAE to catch when a type has a Loss() function.
 HAS_MEM_FUNC(Loss, HasLoss);
 
+// This gives us a HasTouchedColumnsCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a TouchedColumns()
+// function.
+HAS_MEM_FUNC(TouchedColumns, HasTouchedColumnsCheck);
+
 } // namespace ann
 } // namespace mlpack
 
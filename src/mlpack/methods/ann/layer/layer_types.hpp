@@ -44,6 +44,7 @@
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 // Loss function modules.
 #include <mlpack/methods/ann/loss_functions/negative_log_likelihood.hpp>
@@ -63,6 +64,21 @@ template<typename InputDataType, typename OutputDataType> class FastLSTM;
 template<typename InputDataType, typename OutputDataType> class VRClassReward;
 template<typename InputDataType, typename OutputDataType> class Concatenate;
 
+template<typename ActivationFunction,
+         typename InputDataType,
+         typename OutputDataType
+>
+class FusedLinear;
+
+template<typename InputDataType, typename OutputDataType>
+class QuantizedConvolution;
+template<typename InputDataType, typename OutputDataType>
+class QuantizedLinear;
+template<typename InputDataType, typename OutputDataType>
+class SparseConvolution;
+template<typename InputDataType, typename OutputDataType>
+class SparseLinear;
+
 template<typename InputDataType,
          typename OutputDataType
 >
@@ -138,13 +154,15 @@ template<typename InputDataType,
 >
 class MultiplyMerge;
 
+// All the layers of the variant work on arma::mat, so FFN and RNN compute in
+// double precision.
 template <typename... CustomLayers>
 using LayerTypes = boost::variant<
     Add<arma::mat, arma::mat>*,
     AddMerge<arma::mat, arma::mat>*,
-    AtrousConvolution<NaiveConvolution<ValidConvolution>,
-                      NaiveConvolution<FullConvolution>,
-                      NaiveConvolution<ValidConvolution>,
+    AtrousConvolution<Im2ColConvolution<ValidConvolution>,
+                      Im2ColConvolution<FullConvolution>,
+                      Im2ColConvolution<ValidConvolution>,
                       arma::mat, arma::mat>*,
     BaseLayer<LogisticFunction, arma::mat, arma::mat>*,
     BaseLayer<IdentityFunction, arma::mat, arma::mat>*,
@@ -158,12 +176,12 @@ using LayerTypes = boost::variant<
     ConcatPerformance<NegativeLogLikelihood<arma::mat, arma::mat>,
                       arma::mat, arma::mat>*,
     Constant<arma::mat, arma::mat>*,
-    Convolution<NaiveConvolution<ValidConvolution>,
-                NaiveConvolution<FullConvolution>,
-                NaiveConvolution<ValidConvolution>, arma::mat, arma::mat>*,
-    TransposedConvolution<NaiveConvolution<ValidConvolution>,
-            NaiveConvolution<FullConvolution>,
-            NaiveConvolution<ValidConvolution>, arma::mat, arma::mat>*,
+    Convolution<Im2ColConvolution<ValidConvolution>,
+                Im2ColConvolution<FullConvolution>,
+                Im2ColConvolution<ValidConvolution>, arma::mat, arma::mat>*,
+    TransposedConvolution<Im2ColConvolution<ValidConvolution>,
+            Im2ColConvolution<FullConvolution>,
+            Im2ColConvolution<ValidConvolution>, arma::mat, arma::mat>*,
     DropConnect<arma::mat, arma::mat>*,
     Dropout<arma::mat, arma::mat>*,
     AlphaDropout<arma::mat, arma::mat>*,
@@ -181,18 +199,26 @@ using LayerTypes = boost::variant<
     LSTM<arma::mat, arma::mat>*,
     GRU<arma::mat, arma::mat>*,
     FastLSTM<arma::mat, arma::mat>*,
+    FusedLinear<LogisticFunction, arma::mat, arma::mat>*,
+    FusedLinear<TanhFunction, arma::mat, arma::mat>*,
+    FusedLinear<RectifierFunction, arma::mat, arma::mat>*,
+    FusedLinear<SoftplusFunction, arma::mat, arma::mat>*,
     MaxPooling<arma::mat, arma::mat>*,
     MeanPooling<arma::mat, arma::mat>*,
     MultiplyConstant<arma::mat, arma::mat>*,
     MultiplyMerge<arma::mat, arma::mat>*,
     NegativeLogLikelihood<arma::mat, arma::mat>*,
     PReLU<arma::mat, arma::mat>*,
+    QuantizedConvolution<arma::mat, arma::mat>*,
+    QuantizedLinear<arma::mat, arma::mat>*,
     Recurrent<arma::mat, arma::mat>*,
     RecurrentAttention<arma::mat, arma::mat>*,
     ReinforceNormal<arma::mat, arma::mat>*,
     Reparametrization<arma::mat, arma::mat>*,
     Select<arma::mat, arma::mat>*,
     Sequential<arma::mat, arma::mat>*,
+    SparseConvolution<arma::mat, arma::mat>*,
+    SparseLinear<arma::mat, arma::mat>*,
     Subview<arma::mat, arma::mat>*,
     VRClassReward<arma::mat, arma::mat>*,
     CustomLayers*...
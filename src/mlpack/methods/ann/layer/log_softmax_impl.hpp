@@ -29,12 +29,9 @@ template<typename InputType, typename OutputType>
 void LogSoftMax<InputDataType, OutputDataType>::Forward(
     const InputType&& input, OutputType&& output)
 {
-  arma::mat maxInput = arma::repmat(arma::max(input), input.n_rows, 1);
-  output = (maxInput - input);
-
   // Approximation of the base-e exponential function. The acuracy however is
   // about 0.00001 lower as using exp. Credits go to Leon Bottou.
-  output.transform([](double x)
+  auto fastExp = [](double x)
   {
     //! Fast approximation of exp(-x) for x positive.
     static constexpr double A0 = 1.0;
@@ -55,10 +52,27 @@ void LogSoftMax<InputDataType, OutputDataType>::Forward(
     }
 
     return 0.0;
-  });
+  };
+
+  // Every column is normalized on its own, so it stays in the cache, and no
+  // temporary matrices are needed.
+  output.set_size(input.n_rows, input.n_cols);
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    const auto* in = input.colptr(j);
+    double maxInput = in[0];
+    for (size_t i = 1; i < input.n_rows; ++i)
+      maxInput = std::max(maxInput, (double) in[i]);
+
+    double sum = 0.0;
+    for (size_t i = 0; i < input.n_rows; ++i)
+      sum += fastExp(maxInput - in[i]);
 
-  maxInput.each_row() += arma::log(arma::sum(output));
-  output = input - maxInput;
+    const double offset = maxInput + std::log(sum);
+    auto* out = output.colptr(j);
+    for (size_t i = 0; i < input.n_rows; ++i)
+      out[i] = in[i] - offset;
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -23,6 +23,13 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the Lookup class. The Lookup class is a particular
  * convolution, where the width of the convolution is 1.
  *
+ * Only the columns of the looked-up embeddings are nonzero in the gradient.
+ * If Gradient() writes into the same memory as in its last call, only the
+ * columns written then are cleared, and TouchedColumns() lists the nonzero
+ * columns, so that the FFN can pass a sparse gradient to optimizers such as
+ * SparseSGD.  The cost of a step is then proportional to the batch size
+ * instead of the size of the embedding table.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -100,6 +107,9 @@ class Lookup
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  //! Get the (sorted, unique) columns that the last Gradient() call wrote.
+  const arma::uvec& TouchedColumns() const { return touchedColumns; }
+
   /**
    * Serialize the layer
    */
@@ -124,6 +134,12 @@ class Lookup
 
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
+
+  //! The columns that the last Gradient() call wrote.
+  arma::uvec touchedColumns;
+
+  //! The memory that the last Gradient() call wrote into.
+  const void* lastGradient;
 }; // class Lookup
 
 // Alias for using as embedding layer.
@@ -24,7 +24,8 @@ Lookup<InputDataType, OutputDataType>::Lookup(
     const size_t inSize,
     const size_t outSize) :
     inSize(inSize),
-    outSize(outSize)
+    outSize(outSize),
+    lastGradient(NULL)
 {
   weights.set_size(outSize, inSize);
 }
@@ -54,8 +55,26 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient = arma::zeros<arma::Mat<eT> >(weights.n_rows, weights.n_cols);
-  gradient.cols(arma::conv_to<arma::uvec>::from(input) - 1) = error;
+  // Clear the columns of the last call if the memory is the same (the rest is
+  // still zero), and the whole gradient otherwise.
+  if (gradient.memptr() == lastGradient && gradient.n_rows == weights.n_rows &&
+      gradient.n_cols == weights.n_cols)
+  {
+    for (size_t i = 0; i < touchedColumns.n_elem; ++i)
+      gradient.col(touchedColumns[i]).zeros();
+  }
+  else
+  {
+    gradient.zeros(weights.n_rows, weights.n_cols);
+  }
+
+  // The same word may be looked up several times, so the errors are summed.
+  const arma::uvec columns = arma::conv_to<arma::uvec>::from(input) - 1;
+  for (size_t i = 0; i < columns.n_elem; ++i)
+    gradient.col(columns[i]) += error.col(i);
+
+  touchedColumns = arma::unique(columns);
+  lastGradient = gradient.memptr();
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -114,6 +114,16 @@ class LSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Prepare the cell for the next window of a truncated BPTT pass. Unlike
+   * ResetCell(), the output and the cell state of the last forward step are
+   * kept as the initial state of the window, so the sequence continues; the
+   * error is not propagated back into that state.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void CarryCell(const size_t size);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -276,6 +286,9 @@ class LSTM
   //! Locally-stored cell parameter.
   OutputDataType cell;
 
+  //! Locally-stored cell state before the first step (empty if it is zero).
+  OutputDataType initialCell;
+
   //! Locally-stored cell activation error.
   OutputDataType cellActivation;
 
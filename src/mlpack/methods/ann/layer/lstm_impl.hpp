@@ -91,6 +91,33 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
       outParameter.resize(outSize, (size + 1) * batchSize);
     }
   }
+
+  // A new sequence starts from a zero output and a zero cell state.
+  outParameter.cols(0, batchSize - 1).zeros();
+  initialCell.reset();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::CarryCell(const size_t size)
+{
+  if (batchSize == 0 || cell.is_empty())
+  {
+    ResetCell(size);
+    return;
+  }
+
+  // The forward step wraps around to 0 after the last step of a window.
+  const size_t last = ((forwardStep == 0) ? bpttSteps :
+      forwardStep / batchSize) - 1;
+  OutputDataType lastCell = cell.cols(last * batchSize,
+      last * batchSize + batchStep);
+  OutputDataType lastOutput = outParameter.cols((last + 1) * batchSize,
+      (last + 1) * batchSize + batchStep);
+
+  ResetCell(size);
+
+  outParameter.cols(0, batchStep) = lastOutput;
+  initialCell = std::move(lastCell);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -195,6 +222,14 @@ void LSTM<InputDataType, OutputDataType>::Forward(
         arma::repmat(cell2GateForgetWeight, 1, batchSize) %
         cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
   }
+  else if (!initialCell.is_empty())
+  {
+    inputGate.cols(0, batchStep) += arma::repmat(cell2GateInputWeight, 1,
+        batchSize) % initialCell;
+
+    forgetGate.cols(0, batchStep) += arma::repmat(cell2GateForgetWeight, 1,
+        batchSize) % initialCell;
+  }
 
   inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
       (1 + arma::exp(-inputGate.cols(forwardStep, forwardStep + batchStep)));
@@ -217,6 +252,13 @@ void LSTM<InputDataType, OutputDataType>::Forward(
     cell.cols(forwardStep, forwardStep + batchStep) =
         inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
         hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
+
+    if (!initialCell.is_empty())
+    {
+      cell.cols(forwardStep, forwardStep + batchStep) +=
+          forgetGateActivation.cols(forwardStep, forwardStep + batchStep) %
+          initialCell;
+    }
   }
   else
   {
@@ -290,6 +332,12 @@ void LSTM<InputDataType, OutputDataType>::Backward(
       backwardStep - batchStep, backwardStep) % (1.0 -
       forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
   }
+  else if (!initialCell.is_empty())
+  {
+    forgetGateError = initialCell % cellError % (forgetGateActivation.cols(
+        backwardStep - batchStep, backwardStep) % (1.0 -
+        forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
+  }
   else
   {
     forgetGateError.zeros();
@@ -407,6 +455,14 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
                   cell.cols((gradientStep - batchSize) - batchStep,
                             (gradientStep - batchSize)), 1);
   }
+  else if (!initialCell.is_empty())
+  {
+    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
+        arma::sum(forgetGateError % initialCell, 1);
+    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
+        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
+        arma::sum(inputGateError % initialCell, 1);
+  }
   else
   {
     gradient.submat(offset, 0, offset +
@@ -136,55 +136,137 @@ class MaxPooling
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
- /**
-   * Apply pooling to the input and store the results.
+  /**
+   * Apply max pooling to every slice of the input and store the results.  The
+   * maximum over the columns of a window is taken for a whole input column at
+   * once, which the compiler can vectorize; the maximum over the rows of the
+   * window is then taken from that column.  If indices are stored, the
+   * position of the maximum within its input slice is written to
+   * poolingIndices, with one column per slice.
    *
+   * @tparam StoreIndices Whether to store the position of the maxima.
+   * @tparam WindowCols Number of columns of the pooling window, or 0 if it is
+   *     only known at runtime.
    * @param input The input to be apply the pooling rule.
    * @param output The pooled result.
    * @param poolingIndices The pooled indices.
    */
-  template<typename eT>
-  void PoolingOperation(const arma::Mat<eT>& input,
-                        arma::Mat<eT>& output,
-                        arma::Mat<eT>& poolingIndices)
+  template<bool StoreIndices, size_t WindowCols, typename eT>
+  void PoolingOperation(const arma::Cube<eT>& input,
+                        arma::Cube<eT>& output,
+                        arma::Mat<arma::u32>& poolingIndices)
   {
-    for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dW)
+    if (output.n_elem == 0)
+      return;
+
+    const size_t windowRows = kW - offset;
+    const size_t windowCols = (WindowCols == 0) ? kH - offset : WindowCols;
+    const size_t rows = std::min((size_t) input.n_rows,
+        (size_t) ((output.n_rows - 1) * dH + windowRows));
+
+    // Maximum (and column of the maximum) of every row of the current window
+    // columns.
+    std::vector<eT> colMax(rows);
+    std::vector<size_t> colArg(rows);
+
+    for (size_t s = 0; s < input.n_slices; ++s)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dH)
-      {
-        arma::mat subInput = input(arma::span(rowidx, rowidx + kW - 1 - offset),
-            arma::span(colidx, colidx + kH - 1 - offset));
+      const eT* slice = input.slice_memptr(s);
+      eT* pooled = output.slice_memptr(s);
 
-        const size_t idx = pooling.Pooling(subInput);
-        output(i, j) = subInput(idx);
+      for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dW)
+      {
+        const eT* column = slice + colidx * input.n_rows;
+        for (size_t r = 0; r < rows; ++r)
+        {
+          colMax[r] = column[r];
+          colArg[r] = 0;
+        }
 
-        if (!deterministic)
+        for (size_t c = 1; c < windowCols; ++c)
         {
-          arma::Mat<size_t> subIndices = indices(arma::span(rowidx,
-              rowidx + kW - 1 - offset),
-              arma::span(colidx, colidx + kH - 1 - offset));
+          column += input.n_rows;
+          for (size_t r = 0; r < rows; ++r)
+          {
+            if (column[r] > colMax[r])
+            {
+              colMax[r] = column[r];
+              colArg[r] = c;
+            }
+          }
+        }
 
-          poolingIndices(i, j) = subIndices(idx);
+        for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dH)
+        {
+          // Ties are resolved in column-major order, so the first maximum of
+          // the window is selected.
+          size_t best = rowidx;
+          for (size_t r = rowidx + 1; r < rowidx + windowRows; ++r)
+          {
+            if (colMax[r] > colMax[best] ||
+                (colMax[r] == colMax[best] && colArg[r] < colArg[best]))
+            {
+              best = r;
+            }
+          }
+
+          pooled[j * output.n_rows + i] = colMax[best];
+          if (StoreIndices)
+          {
+            poolingIndices(j * output.n_rows + i, s) = (arma::u32)
+                ((colidx + colArg[best]) * input.n_rows + best);
+          }
         }
       }
     }
   }
 
+  /**
+   * Select the PoolingOperation() implementation for the size of the pooling
+   * window.
+   *
+   * @param input The input to be apply the pooling rule.
+   * @param output The pooled result.
+   * @param poolingIndices The pooled indices.
+   */
+  template<bool StoreIndices, typename eT>
+  void PoolingOperation(const arma::Cube<eT>& input,
+                        arma::Cube<eT>& output,
+                        arma::Mat<arma::u32>& poolingIndices)
+  {
+    switch (kH - offset)
+    {
+      case 2:
+        PoolingOperation<StoreIndices, 2>(input, output, poolingIndices);
+        break;
+      case 3:
+        PoolingOperation<StoreIndices, 3>(input, output, poolingIndices);
+        break;
+      default:
+        PoolingOperation<StoreIndices, 0>(input, output, poolingIndices);
+    }
+  }
+
   /**
    * Apply unpooling to the input and store the results.
    *
    * @param error The backward error.
-   * @param output The pooled result.
+   * @param output The unpooled result.
    * @param poolingIndices The pooled indices.
    */
   template<typename eT>
-  void Unpooling(const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output,
-                 arma::Mat<eT>& poolingIndices)
+  void Unpooling(const arma::Cube<eT>& error,
+                 arma::Cube<eT>& output,
+                 const arma::Mat<arma::u32>& poolingIndices)
   {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
+    for (size_t s = 0; s < error.n_slices; ++s)
     {
-      output(poolingIndices(i)) += error(i);
+      const eT* sliceError = error.slice_memptr(s);
+      const arma::u32* sliceIndices = poolingIndices.colptr(s);
+      eT* unpooled = output.slice_memptr(s);
+
+      for (size_t i = 0; i < poolingIndices.n_rows; ++i)
+        unpooled[sliceIndices[i]] += sliceError[i];
     }
   }
 
@@ -209,9 +291,6 @@ class MaxPooling
   //! Locally-stored number of output channels.
   size_t outSize;
 
-  //! Locally-stored reset parameter used to initialize the module once.
-  bool reset;
-
   //! Locally-stored input width.
   size_t inputWidth;
 
@@ -242,9 +321,6 @@ class MaxPooling
   //! Locally-stored transformed output parameter.
   arma::cube gTemp;
 
-  //! Locally-stored pooling strategy.
-  MaxPoolingRule pooling;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -254,14 +330,9 @@ class MaxPooling
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored indices matrix parameter.
-  arma::Mat<size_t> indices;
-
-  //! Locally-stored indices column parameter.
-  arma::Col<size_t> indicesCol;
-
-  //! Locally-stored pooling indicies.
-  std::vector<arma::cube> poolingIndices;
+  //! Locally-stored position of the maxima within their input slices, one
+  //! matrix for every forward pass that still has to be backpropagated.
+  std::vector<arma::Mat<arma::u32> > poolingIndices;
 }; // class MaxPooling
 
 } // namespace ann
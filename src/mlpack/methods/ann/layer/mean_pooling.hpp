@@ -117,26 +117,55 @@ class MeanPooling
 
  private:
   /**
-   * Apply pooling to the input and store the results.
+   * Apply pooling to every slice of the input and store the results.  The sum
+   * over the columns of a window is taken for a whole input column at once,
+   * which the compiler can vectorize; the rows of the window are then summed
+   * from that column.
    *
    * @param input The input to be apply the pooling rule.
    * @param output The pooled result.
    */
   template<typename eT>
-  void Pooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+  void Pooling(const arma::Cube<eT>& input, arma::Cube<eT>& output)
   {
-    const size_t rStep = kW;
-    const size_t cStep = kH;
+    if (output.n_elem == 0)
+      return;
 
-    for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dH)
+    const size_t rStep = kW - offset;
+    const size_t cStep = kH - offset;
+    const size_t rows = std::min((size_t) input.n_rows,
+        (size_t) ((output.n_rows - 1) * dW + rStep));
+    const eT norm = eT(1) / (rStep * cStep);
+
+    // Sum of every row of the current window columns.
+    std::vector<eT> colSum(rows);
+
+    for (size_t s = 0; s < input.n_slices; ++s)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dW)
-      {
-        arma::mat subInput = input(
-            arma::span(rowidx, rowidx + rStep - 1 - offset),
-            arma::span(colidx, colidx + cStep - 1 - offset));
+      const eT* slice = input.slice_memptr(s);
+      eT* pooled = output.slice_memptr(s);
 
-        output(i, j) = arma::mean(arma::mean(subInput));
+      for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dH)
+      {
+        const eT* column = slice + colidx * input.n_rows;
+        for (size_t r = 0; r < rows; ++r)
+          colSum[r] = column[r];
+
+        for (size_t c = 1; c < cStep; ++c)
+        {
+          column += input.n_rows;
+          for (size_t r = 0; r < rows; ++r)
+            colSum[r] += column[r];
+        }
+
+        for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dW)
+        {
+          eT sum = colSum[rowidx];
+          for (size_t r = rowidx + 1; r < rowidx + rStep; ++r)
+            sum += colSum[r];
+
+          pooled[j * output.n_rows + i] = sum * norm;
+        }
       }
     }
   }
@@ -0,0 +1,181 @@
+/**
+ * @file normalization.hpp
+ *
+ * Single-pass statistic kernels shared by the normalization layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_NORMALIZATION_HPP
+#define MLPACK_METHODS_ANN_LAYER_NORMALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Get the number of columns of a matrix with the given number of rows that
+ * one block of ForEachColumnBlock() processes.  A block has at least 4096
+ * elements, so that small batches are handled by a single thread.
+ *
+ * @param rows The number of rows of the matrix.
+ */
+inline size_t ColumnBlockSize(const size_t rows)
+{
+  return std::max(size_t(1), size_t(4096) / std::max(rows, size_t(1)));
+}
+
+//! Get the number of blocks that ForEachColumnBlock() uses.
+inline size_t ColumnBlocks(const size_t rows, const size_t cols)
+{
+  const size_t blockSize = ColumnBlockSize(rows);
+  return (cols + blockSize - 1) / blockSize;
+}
+
+/**
+ * Call the given function for consecutive blocks of columns of a matrix, in
+ * parallel.  The function is called with the index of the block, the first
+ * column of the block and one past its last column.
+ *
+ * @param rows The number of rows of the matrix.
+ * @param cols The number of columns of the matrix.
+ * @param function Function to call for every block.
+ */
+template<typename FunctionType>
+inline void ForEachColumnBlock(const size_t rows,
+                               const size_t cols,
+                               FunctionType function)
+{
+  const size_t blockSize = ColumnBlockSize(rows);
+  Threads::ParallelFor(0, ColumnBlocks(rows, cols), [&](const size_t block)
+  {
+    const size_t begin = block * blockSize;
+    function(block, begin, std::min(cols, begin + blockSize));
+  });
+}
+
+/**
+ * Merge the mean and the sum of squared deviations of two sets of samples
+ * (the parallel variant of Welford's method, Chan et al.).  The result is
+ * stored in the first set.
+ *
+ * @param countA The number of samples of the first set.
+ * @param meanA The mean of the first set.
+ * @param m2A The sum of squared deviations of the first set.
+ * @param countB The number of samples of the second set.
+ * @param meanB The mean of the second set.
+ * @param m2B The sum of squared deviations of the second set.
+ */
+template<typename MatType>
+inline void MergeMoments(const size_t countA,
+                         MatType& meanA,
+                         MatType& m2A,
+                         const size_t countB,
+                         const MatType& meanB,
+                         const MatType& m2B)
+{
+  if (countB == 0)
+    return;
+
+  const double total = countA + countB;
+  const MatType delta = meanB - meanA;
+  meanA += delta * (countB / total);
+  m2A += m2B + arma::square(delta) * (countA * (countB / total));
+}
+
+/**
+ * Compute the mean and the sum of squared deviations of every row of the
+ * given matrix in a single pass with Welford's method.  Every block of columns
+ * is processed by its own thread, and the blocks are merged afterwards.
+ *
+ * @param input The samples (one per column).
+ * @param mean The mean of every row.
+ * @param m2 The sum of squared deviations of every row.
+ */
+template<typename eT, typename MatType>
+void RowMoments(const arma::Mat<eT>& input, MatType& mean, MatType& m2)
+{
+  const size_t blockSize = ColumnBlockSize(input.n_rows);
+  const size_t blocks = ColumnBlocks(input.n_rows, input.n_cols);
+  arma::Mat<eT> blockMeans(input.n_rows, blocks, arma::fill::zeros);
+  arma::Mat<eT> blockM2(input.n_rows, blocks, arma::fill::zeros);
+
+  ForEachColumnBlock(input.n_rows, input.n_cols,
+      [&](const size_t block, const size_t begin, const size_t end)
+  {
+    eT* mu = blockMeans.colptr(block);
+    eT* s = blockM2.colptr(block);
+    for (size_t j = begin; j < end; ++j)
+    {
+      const eT* x = input.colptr(j);
+      const eT n = eT(j - begin + 1);
+      for (size_t i = 0; i < input.n_rows; ++i)
+      {
+        const eT delta = x[i] - mu[i];
+        mu[i] += delta / n;
+        s[i] += delta * (x[i] - mu[i]);
+      }
+    }
+  });
+
+  mean = blockMeans.col(0);
+  m2 = blockM2.col(0);
+  size_t count = std::min(blockSize, size_t(input.n_cols));
+  for (size_t b = 1; b < blocks; ++b)
+  {
+    const size_t blockCount = std::min(blockSize,
+        size_t(input.n_cols - b * blockSize));
+    MergeMoments(count, mean, m2, blockCount, MatType(blockMeans.col(b)),
+        MatType(blockM2.col(b)));
+    count += blockCount;
+  }
+}
+
+/**
+ * Compute, in a single pass, the sums over the columns of error % normalized
+ * and of error.  These are the gradients of the scale and shift parameters of
+ * a normalization layer, and also appear in its backward pass.
+ *
+ * @param normalized The normalized input of the layer.
+ * @param error The backpropagated error.
+ * @param productSums The sum of error % normalized of every row.
+ * @param sums The sum of error of every row.
+ */
+template<typename eT>
+void NormalizedRowSums(const arma::Mat<eT>& normalized,
+                       const arma::Mat<eT>& error,
+                       arma::Mat<eT>& productSums,
+                       arma::Mat<eT>& sums)
+{
+  const size_t blocks = ColumnBlocks(error.n_rows, error.n_cols);
+  arma::Mat<eT> blockProducts(error.n_rows, blocks, arma::fill::zeros);
+  arma::Mat<eT> blockSums(error.n_rows, blocks, arma::fill::zeros);
+
+  ForEachColumnBlock(error.n_rows, error.n_cols,
+      [&](const size_t block, const size_t begin, const size_t end)
+  {
+    eT* p = blockProducts.colptr(block);
+    eT* s = blockSums.colptr(block);
+    for (size_t j = begin; j < end; ++j)
+    {
+      const eT* xhat = normalized.colptr(j);
+      const eT* e = error.colptr(j);
+      for (size_t i = 0; i < error.n_rows; ++i)
+      {
+        p[i] += e[i] * xhat[i];
+        s[i] += e[i];
+      }
+    }
+  });
+
+  productSums = arma::sum(blockProducts, 1);
+  sums = arma::sum(blockSums, 1);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file quantized_convolution.hpp
+ *
+ * Definition of the QuantizedConvolution layer class, a convolution layer with
+ * int8 weights for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+
+#include "layer_types.hpp"
+#include "int8_quantization.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the QuantizedConvolution layer class. The layer computes
+ * the same function as a Convolution layer, but the filters are stored as
+ * int8 values with one scale per output map, and the input is quantized with
+ * a fixed scale. Every input sample is unrolled into a patch matrix (see
+ * Im2ColConvolution) which is multiplied with the quantized filters with
+ * int32 accumulation. The bias stays in floating point. The layer has no
+ * trainable parameters; FFN::Quantize() replaces trained Convolution layers
+ * with this layer.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedConvolution
+{
+ public:
+  //! Create the QuantizedConvolution object.
+  QuantizedConvolution();
+
+  /**
+   * Create the QuantizedConvolution layer object from the filters of a trained
+   * layer.
+   *
+   * @param inSize The number of input maps.
+   * @param outSize The number of output maps.
+   * @param kW Width of the filter/kernel.
+   * @param kH Height of the filter/kernel.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param padW Padding width of the input.
+   * @param padH Padding height of the input.
+   * @param inputWidth The width of the input data.
+   * @param inputHeight The height of the input data.
+   * @param weight The filters (kW * kH * inSize x outSize), laid out like the
+   *        filter cube of the Convolution layer.
+   * @param bias The bias of every output map (outSize x 1).
+   * @param inputScale The scale used to quantize the input.
+   */
+  QuantizedConvolution(const size_t inSize,
+                       const size_t outSize,
+                       const size_t kW,
+                       const size_t kH,
+                       const size_t dW,
+                       const size_t dH,
+                       const size_t padW,
+                       const size_t padH,
+                       const size_t inputWidth,
+                       const size_t inputHeight,
+                       const arma::mat& weight,
+                       const arma::mat& bias,
+                       const double inputScale);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f, using the dequantized filters.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the input width.
+  size_t const& InputWidth() const { return inputWidth; }
+  //! Modify input the width.
+  size_t& InputWidth() { return inputWidth; }
+
+  //! Get the input height.
+  size_t const& InputHeight() const { return inputHeight; }
+  //! Modify the input height.
+  size_t& InputHeight() { return inputHeight; }
+
+  //! Get the output width.
+  size_t const& OutputWidth() const { return outputWidth; }
+  //! Modify the output width.
+  size_t& OutputWidth() { return outputWidth; }
+
+  //! Get the output height.
+  size_t const& OutputHeight() const { return outputHeight; }
+  //! Modify the output height.
+  size_t& OutputHeight() { return outputHeight; }
+
+  //! Get the quantized filters (one column per output map).
+  const std::vector<int8_t>& Weights() const { return weights; }
+
+  //! Get the scale of the filters of every output map.
+  const arma::vec& WeightScales() const { return weightScales; }
+
+  //! Get the scale used to quantize the input.
+  double InputScale() const { return inputScale; }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored number of input channels.
+  size_t inSize;
+
+  //! Locally-stored number of output channels.
+  size_t outSize;
+
+  //! Locally-stored filter/kernel width.
+  size_t kW;
+
+  //! Locally-stored filter/kernel height.
+  size_t kH;
+
+  //! Locally-stored stride of the filter in x-direction.
+  size_t dW;
+
+  //! Locally-stored stride of the filter in y-direction.
+  size_t dH;
+
+  //! Locally-stored padding width.
+  size_t padW;
+
+  //! Locally-stored padding height.
+  size_t padH;
+
+  //! Locally-stored quantized filters.
+  std::vector<int8_t> weights;
+
+  //! Locally-stored scale of the filters of every output map.
+  arma::vec weightScales;
+
+  //! Locally-stored bias term parameters.
+  arma::vec bias;
+
+  //! Locally-stored scale of the input.
+  double inputScale;
+
+  //! Locally-stored input width.
+  size_t inputWidth;
+
+  //! Locally-stored input height.
+  size_t inputHeight;
+
+  //! Locally-stored output width.
+  size_t outputWidth;
+
+  //! Locally-stored output height.
+  size_t outputHeight;
+
+  //! Locally-stored transformed padded input parameter.
+  arma::Cube<typename OutputDataType::elem_type> inputPaddedTemp;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedConvolution
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_convolution_impl.hpp"
+
+#endif
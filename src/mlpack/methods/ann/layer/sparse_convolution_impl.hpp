@@ -0,0 +1,168 @@
+/**
+ * @file sparse_convolution_impl.hpp
+ *
+ * Implementation of the SparseConvolution layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SPARSE_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_SPARSE_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "sparse_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+SparseConvolution<InputDataType, OutputDataType>::SparseConvolution() :
+    inSize(0),
+    outSize(0),
+    kW(0),
+    kH(0),
+    dW(1),
+    dH(1),
+    padW(0),
+    padH(0),
+    inputWidth(0),
+    inputHeight(0),
+    outputWidth(0),
+    outputHeight(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+SparseConvolution<InputDataType, OutputDataType>::SparseConvolution(
+    const size_t inSize,
+    const size_t outSize,
+    const size_t kW,
+    const size_t kH,
+    const size_t dW,
+    const size_t dH,
+    const size_t padW,
+    const size_t padH,
+    const size_t inputWidth,
+    const size_t inputHeight,
+    const arma::mat& weight,
+    const arma::mat& bias) :
+    inSize(inSize),
+    outSize(outSize),
+    kW(kW),
+    kH(kH),
+    dW(dW),
+    dH(dH),
+    padW(padW),
+    padH(padH),
+    weights(arma::mat(weight.t())),
+    bias(arma::vectorise(bias)),
+    inputWidth(inputWidth),
+    inputHeight(inputHeight),
+    outputWidth(0),
+    outputHeight(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void SparseConvolution<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  const size_t batchSize = input.n_cols;
+  const arma::Cube<eT> inputTemp(const_cast<arma::Mat<eT>&&>(input).memptr(),
+      inputWidth, inputHeight, inSize * batchSize, false, true);
+
+  if (padW != 0 || padH != 0)
+  {
+    inputPaddedTemp.zeros(inputWidth + padW * 2, inputHeight + padH * 2,
+        inputTemp.n_slices);
+    for (size_t i = 0; i < inputTemp.n_slices; ++i)
+    {
+      inputPaddedTemp.slice(i).submat(padW, padH, padW + inputWidth - 1,
+          padH + inputHeight - 1) = inputTemp.slice(i);
+    }
+  }
+
+  const arma::Cube<eT>& inputSource = (padW != 0 || padH != 0) ?
+      inputPaddedTemp : inputTemp;
+
+  outputWidth = (inputWidth + padW * 2 - kW) / dW + 1;
+  outputHeight = (inputHeight + padH * 2 - kH) / dH + 1;
+  output.set_size(outputWidth * outputHeight * outSize, batchSize);
+
+  // Each sample is handled on its own; the product of a single sample is
+  // parallelized over its output positions instead.
+  Threads::ParallelFor(0, batchSize, [&](const size_t b)
+  {
+    arma::Mat<eT> patches, result;
+    Im2ColConvolution<ValidConvolution>::Im2Col(inputSource, b * inSize,
+        inSize, kW, kH, dW, dH, 1, 1, outputWidth, outputHeight, patches);
+
+    weights.Product(arma::Mat<eT>(patches.t()), bias, result);
+
+    arma::Mat<eT> outputMat(output.colptr(b), outputWidth * outputHeight,
+        outSize, false, true);
+    outputMat = result.t();
+  });
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void SparseConvolution<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  const size_t batchSize = gy.n_cols;
+
+  arma::Cube<eT> gPadded;
+  gPadded.zeros(inputWidth + padW * 2, inputHeight + padH * 2,
+      inSize * batchSize);
+
+  arma::Mat<eT> patchErrorT;
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    const arma::Mat<eT> errorMat(gy.colptr(b), outputWidth * outputHeight,
+        outSize, false, true);
+    weights.TransposeProduct(arma::Mat<eT>(errorMat.t()), patchErrorT);
+    const arma::Mat<eT> patchError = patchErrorT.t();
+
+    Im2ColConvolution<ValidConvolution>::Col2Im(patchError, b * inSize,
+        inSize, kW, kH, dW, dH, 1, 1, outputWidth, outputHeight, gPadded);
+  }
+
+  g.set_size(inputWidth * inputHeight * inSize, batchSize);
+  arma::Cube<eT> gTemp(g.memptr(), inputWidth, inputHeight,
+      inSize * batchSize, false, true);
+  for (size_t i = 0; i < gTemp.n_slices; ++i)
+  {
+    gTemp.slice(i) = gPadded.slice(i).submat(padW, padH,
+        padW + inputWidth - 1, padH + inputHeight - 1);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void SparseConvolution<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(kW);
+  ar & BOOST_SERIALIZATION_NVP(kH);
+  ar & BOOST_SERIALIZATION_NVP(dW);
+  ar & BOOST_SERIALIZATION_NVP(dH);
+  ar & BOOST_SERIALIZATION_NVP(padW);
+  ar & BOOST_SERIALIZATION_NVP(padH);
+  ar & BOOST_SERIALIZATION_NVP(inputWidth);
+  ar & BOOST_SERIALIZATION_NVP(inputHeight);
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
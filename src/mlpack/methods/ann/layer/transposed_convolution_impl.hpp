@@ -92,9 +92,9 @@ void TransposedConvolution<
     OutputDataType
 >::Reset()
 {
-    weight = arma::cube(weights.memptr(), kW, kH,
-        outSize * inSize, false, false);
-    bias = arma::mat(weights.memptr() + weight.n_elem,
+    weight = arma::Cube<typename OutputDataType::elem_type>(weights.memptr(),
+        kW, kH, outSize * inSize, false, false);
+    bias = OutputDataType(weights.memptr() + weight.n_elem,
         outSize, 1, false, false);
 }
 
@@ -115,7 +115,7 @@ void TransposedConvolution<
 >::Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
   batchSize = input.n_cols;
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&&>(input).memptr(),
+  inputTemp = arma::Cube<eT>(const_cast<arma::Mat<eT>&&>(input).memptr(),
       inputWidth, inputHeight, inSize * batchSize, false, false);
 
   outputWidth = TransposedConvOutSize(inputWidth, kW, dW, padW);
@@ -126,6 +126,39 @@ void TransposedConvolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value &&
+      outputWidth == inputWidth + kW - 1 &&
+      outputHeight == inputHeight + kH - 1)
+  {
+    // The full convolution with the rotated filter scatters every input
+    // element into a filter-sized patch of the output; compute the patches of
+    // all input maps with one matrix multiplication per output map and fold
+    // them into the output.
+    arma::Mat<eT> patches;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      const arma::Mat<eT> inputMat(const_cast<arma::Mat<eT>&&>(input).colptr(
+          b), inputWidth * inputHeight, inSize, false, true);
+
+      for (size_t o = 0; o < outSize; ++o)
+      {
+        const arma::Mat<eT> weightMat(weight.slice(o * inSize).memptr(),
+            kW * kH, inSize, false, true);
+        patches = inputMat * weightMat.t();
+
+        Im2ColConvolution<ValidConvolution>::Col2Im(patches,
+            b * outSize + o, 1, kW, kH, 1, 1, 1, 1, inputWidth, inputHeight,
+            outputTemp);
+      }
+
+      arma::Mat<eT> outputMat(output.colptr(b), outputWidth * outputHeight,
+          outSize, false, true);
+      outputMat.each_row() += bias.t();
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -167,7 +200,7 @@ void TransposedConvolution<
 >::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError(gy.memptr(), outputWidth, outputHeight,
+  arma::Cube<eT> mappedError(gy.memptr(), outputWidth, outputHeight,
       outSize * batchSize, false, false);
   g.set_size(inputTemp.n_rows * inputTemp.n_cols * inSize, batchSize);
   gTemp = arma::Cube<eT>(g.memptr(), inputTemp.n_rows,
@@ -175,6 +208,31 @@ void TransposedConvolution<
 
   gTemp.zeros();
 
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value &&
+      outputWidth == inputWidth + kW - 1 &&
+      outputHeight == inputHeight + kH - 1)
+  {
+    // Unroll the error of all output maps of a sample and correlate it with
+    // the filters using one matrix multiplication per output map.
+    arma::Mat<eT> patches;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      Im2ColConvolution<ValidConvolution>::Im2Col(mappedError, b * outSize,
+          outSize, kW, kH, 1, 1, 1, 1, inputWidth, inputHeight, patches);
+
+      arma::Mat<eT> gMat(g.colptr(b), inputWidth * inputHeight, inSize,
+          false, true);
+      for (size_t o = 0; o < outSize; ++o)
+      {
+        const arma::Mat<eT> weightMat(weight.slice(o * inSize).memptr(),
+            kW * kH, inSize, false, true);
+        gMat += patches.cols(o * kW * kH, (o + 1) * kW * kH - 1) * weightMat;
+      }
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -215,7 +273,7 @@ void TransposedConvolution<
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  arma::cube mappedError(error.memptr(), outputWidth,
+  arma::Cube<eT> mappedError(error.memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
 
   gradient.set_size(weights.n_elem, 1);
@@ -223,6 +281,39 @@ void TransposedConvolution<
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
 
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value &&
+      outputWidth == inputWidth + kW - 1 &&
+      outputHeight == inputHeight + kH - 1)
+  {
+    // The weight gradient of an output map is the product of its unrolled
+    // error and the input maps of the sample.
+    arma::Mat<eT> biasGradient(gradient.memptr() + weight.n_elem, 1,
+        outSize, false, true);
+    biasGradient.zeros();
+
+    arma::Mat<eT> patches;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      Im2ColConvolution<ValidConvolution>::Im2Col(mappedError, b * outSize,
+          outSize, kW, kH, 1, 1, 1, 1, inputWidth, inputHeight, patches);
+
+      const arma::Mat<eT> inputMat(inputTemp.slice(b * inSize).memptr(),
+          inputWidth * inputHeight, inSize, false, true);
+      for (size_t o = 0; o < outSize; ++o)
+      {
+        arma::Mat<eT> gradientMat(gradientTemp.slice(o * inSize).memptr(),
+            kW * kH, inSize, false, true);
+        gradientMat += patches.cols(o * kW * kH, (o + 1) * kW * kH - 1).t() *
+            inputMat;
+      }
+
+      biasGradient += arma::sum(arma::Mat<eT>(error.colptr(b),
+          outputWidth * outputHeight, outSize, false, true));
+    }
+
+    return;
+  }
+
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -49,7 +49,8 @@ void NegativeLogLikelihood<InputDataType, OutputDataType>::Backward(
       const TargetType&& target,
       OutputType&& output)
 {
-  output = arma::zeros<OutputType>(input.n_rows, input.n_cols);
+  // The memory of the output is reused if it has the right size.
+  output.zeros(input.n_rows, input.n_cols);
   for (size_t i = 0; i < input.n_cols; ++i)
   {
     size_t currentTarget = target(i) - 1;
@@ -151,7 +151,8 @@ class RBM
 
   /**
    * This function samples the hidden layer given the visible layer using
-   * Bernoulli function.
+   * Bernoulli function.  Every column of the input is a separate chain; the
+   * chains are sampled in parallel.
    *
    * @param input Visible layer input.
    * @param output The sampled hidden layer.
@@ -176,7 +177,8 @@ class RBM
 
   /**
    * This function samples the visible layer given the hidden layer using
-   * Bernoulli function.
+   * Bernoulli function.  Every column of the input is a separate chain; the
+   * chains are sampled in parallel.
    *
    * @param input Hidden layer of the network.
    * @param output The sampled visible layer.
@@ -294,7 +296,11 @@ class RBM
   SampleSlab(DataType&& slabMean, DataType&& slab);
 
   /**
-   * This function does the k-step Gibbs Sampling.
+   * This function does the k-step Gibbs Sampling.  Every column of the input
+   * starts a chain, and all chains are advanced together.  With persistent
+   * CD-k, the chains continue from the state of the last call instead (the
+   * number of chains is the size of the first batch), so the output may have
+   * more columns than the input.
    *
    * @param input Input to the Gibbs function.
    * @param output Used for storing the negative sample.
@@ -374,6 +380,27 @@ class RBM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Replace every element of the given matrix, a probability, by a sample of
+   * the Bernoulli distribution with that probability.  Blocks of elements are
+   * sampled in parallel, each thread with its own random number generator.
+   *
+   * @param values The probabilities, overwritten with the samples.
+   */
+  static void SampleBernoulli(arma::Mat<ElemType>& values);
+
+  /**
+   * Replace every element of the given matrix, a mean, by a sample of the
+   * Normal distribution with that mean and the given standard deviation.
+   * Blocks of elements are sampled in parallel, each thread with its own
+   * random number generator.
+   *
+   * @param values The means, overwritten with the samples.
+   * @param deviation The standard deviation of the distribution.
+   */
+  static void SampleNormal(arma::Mat<ElemType>& values,
+                           const ElemType deviation);
+
   //! Locally stored parameters of the network.
   arma::Mat<ElemType> parameter;
   //! The matrix of data points (predictors).
@@ -436,6 +463,8 @@ class RBM
   arma::Mat<ElemType> positiveGradient;
   //! Locally-stored temporary output of Gibbs chain.
   arma::Mat<ElemType> gibbsTemporary;
+  //! Locally-stored projection of the visible units onto the slab weights.
+  arma::Mat<ElemType> slabProjection;
   //! Locally-stored persistent CD-k boolean flag.
   bool persistence;
   //! Locally-stored reset variable.
@@ -68,6 +68,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::Reset()
   negativeGradient.set_size(shape, 1);
   tempNegativeGradient.set_size(shape, 1);
   negativeSamples.set_size(visibleSize, batchSize);
+  gibbsTemporary.set_size(hiddenSize, batchSize);
+  hiddenReconstruction.set_size(hiddenSize, batchSize);
 
   weight = arma::Cube<ElemType>(parameter.memptr(), hiddenSize, visibleSize, 1,
       false, false);
@@ -138,9 +140,11 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   DataType visibleBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem +
       hiddenBiasGrad.n_elem, visibleSize, 1, false, false);
 
-  HiddenMean(std::move(input), std::move(hiddenBiasGrad));
-  weightGrad.slice(0) = hiddenBiasGrad * input.t();
-  visibleBiasGrad = input;
+  // The statistics are summed over all columns (chains) of the input.
+  HiddenMean(std::move(input), std::move(hiddenReconstruction));
+  weightGrad.slice(0) = hiddenReconstruction * input.t();
+  hiddenBiasGrad = arma::sum(hiddenReconstruction, 1);
+  visibleBiasGrad = arma::sum(input, 1);
 }
 
 template<
@@ -155,8 +159,12 @@ double RBM<InitializationRuleType, DataType, PolicyType>::Evaluate(
 {
   Gibbs(std::move(predictors.cols(i, i + batchSize - 1)),
       std::move(negativeSamples));
+
+  // Persistent chains may be more than the points of the batch.
+  const double chainScale = (double) batchSize / negativeSamples.n_cols;
   return std::fabs(FreeEnergy(std::move(predictors.cols(i,
-      i + batchSize - 1))) - FreeEnergy(std::move(negativeSamples)));
+      i + batchSize - 1))) - chainScale *
+      FreeEnergy(std::move(negativeSamples)));
 }
 
 template<
@@ -171,11 +179,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
     arma::Mat<ElemType>&& output)
 {
   HiddenMean(std::move(input), std::move(output));
-
-  for (size_t i = 0; i < output.n_elem; i++)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  SampleBernoulli(output);
 }
 
 template<
@@ -190,11 +194,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
     arma::Mat<ElemType>&& output)
 {
   VisibleMean(std::move(input), std::move(output));
-
-  for (size_t i = 0; i < output.n_elem; i++)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  SampleBernoulli(output);
 }
 
 template<
@@ -257,6 +257,7 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gibbs(
   }
   if (persistence)
   {
+    // The state keeps its memory after the first call.
     state = output;
   }
 }
@@ -278,18 +279,67 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   Phase(std::move(predictors.cols(i, i + batchSize - 1)),
       std::move(positiveGradient));
 
-  for (size_t i = 0; i < negSteps; i++)
+  for (size_t step = 0; step < negSteps; step++)
   {
     Gibbs(std::move(predictors.cols(i, i + batchSize - 1)),
         std::move(negativeSamples));
     Phase(std::move(negativeSamples), std::move(tempNegativeGradient));
 
-    negativeGradient += tempNegativeGradient;
+    // Persistent chains may be more than the points of the batch.
+    negativeGradient += tempNegativeGradient * ((double) batchSize /
+        negativeSamples.n_cols);
   }
 
   gradient = ((negativeGradient / negSteps) - positiveGradient);
 }
 
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+void RBM<InitializationRuleType, DataType, PolicyType>::SampleBernoulli(
+    arma::Mat<ElemType>& values)
+{
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (values.n_elem + blockSize - 1) / blockSize;
+  Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    std::mt19937& generator = math::ThreadRandGen();
+    std::uniform_real_distribution<> uniform;
+
+    ElemType* value = values.memptr() + block * blockSize;
+    const size_t count = std::min(blockSize,
+        size_t(values.n_elem - block * blockSize));
+    for (size_t i = 0; i < count; ++i)
+      value[i] = (uniform(generator) < value[i]) ? 1 : 0;
+  });
+}
+
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+void RBM<InitializationRuleType, DataType, PolicyType>::SampleNormal(
+    arma::Mat<ElemType>& values,
+    const ElemType deviation)
+{
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (values.n_elem + blockSize - 1) / blockSize;
+  Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    std::mt19937& generator = math::ThreadRandGen();
+    std::normal_distribution<>& normal = math::ThreadRandNormalDist();
+
+    ElemType* value = values.memptr() + block * blockSize;
+    const size_t count = std::min(blockSize,
+        size_t(values.n_elem - block * blockSize));
+    for (size_t i = 0; i < count; ++i)
+      value[i] += deviation * normal(generator);
+  });
+}
+
 template<
   typename InitializationRuleType,
   typename DataType,
@@ -334,6 +384,8 @@ void RBM<InitializationRuleType, DataType, PolicyType>::serialize(
     positiveGradient.set_size(shape, 1);
     negativeGradient.set_size(shape, 1);
     negativeSamples.set_size(visibleSize, batchSize);
+    gibbsTemporary.set_size(hiddenSize, batchSize);
+    hiddenReconstruction.set_size(hiddenSize, batchSize);
     tempNegativeGradient.set_size(shape, 1);
     spikeMean.set_size(hiddenSize, 1);
     spikeSamples.set_size(hiddenSize, 1);
@@ -74,12 +74,17 @@ RBM<InitializationRuleType, DataType, PolicyType>::FreeEnergy(
   freeEnergy -= 0.5 * hiddenSize * poolSize *
       std::log((2.0 * M_PI) / slabPenalty);
 
+  // Project the input onto the slab weights of all hidden units at once; the
+  // weight cube is viewed as a visibleSize x (poolSize * hiddenSize) matrix.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  const arma::Mat<ElemType> squares = arma::reshape(arma::sum(arma::square(
+      input.t() * weights), 0), poolSize, hiddenSize);
+  const arma::Mat<ElemType> sums = arma::sum(squares, 0) /
+      (2.0 * slabPenalty);
+
   for (size_t i = 0; i < hiddenSize; i++)
-  {
-    ElemType sum = arma::accu(arma::square(input.t() * weight.slice(i))) /
-        (2.0 * slabPenalty);
-    freeEnergy -= SoftplusFunction::Fn(spikeBias(i) - sum);
-  }
+    freeEnergy -= SoftplusFunction::Fn(spikeBias(i) - sums(i));
 
   return freeEnergy;
 }
@@ -108,11 +113,9 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   SampleSpike(std::move(spikeMean), std::move(spikeSamples));
   SlabMean(std::move(input), std::move(spikeSamples), std::move(slabMean));
 
+  const DataType inputSum = arma::sum(input, 1);
   for (size_t i = 0 ; i < hiddenSize; i++)
-  {
-    weightGrad.slice(i) = input * arma::repmat(slabMean.col(i).t(),
-        input.n_cols, 1) * spikeMean(i);
-  }
+    weightGrad.slice(i) = spikeMean(i) * inputSum * slabMean.col(i).t();
 
   spikeBiasGrad = spikeMean;
 
@@ -158,14 +161,11 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
   size_t k = 0;
 
   VisibleMean(std::move(input), std::move(visibleMean));
-  output.set_size(visibleSize, 1);
 
   for (k = 0; k < numMaxTrials; k++)
   {
-    for (size_t i = 0; i < visibleSize; i++)
-    {
-      output(i) = math::RandNormal(visibleMean(i), 1.0 / visiblePenalty(0));
-    }
+    output = visibleMean;
+    SampleNormal(output, 1.0 / visiblePenalty(0));
     if (arma::norm(output, 2) < radius)
     {
       break;
@@ -192,18 +192,15 @@ RBM<InitializationRuleType, DataType, PolicyType>::VisibleMean(
     DataType&& input,
     DataType&& output)
 {
-  output.zeros(visibleSize, 1);
-
   DataType spike(input.memptr(), hiddenSize, 1, false, false);
   DataType slab(input.memptr() + hiddenSize, poolSize, hiddenSize, false,
       false);
 
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    output += weight.slice(i) * slab.col(i) * spike(i);
-  }
-
-  output = ((1.0 / visiblePenalty(0)) * output);
+  // Sum the contributions of all hidden units with one product.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  output = (1.0 / visiblePenalty(0)) * (weights *
+      arma::vectorise(slab * arma::diagmat(spike)));
 }
 
 template<
@@ -239,12 +236,18 @@ RBM<InitializationRuleType, DataType, PolicyType>::SpikeMean(
     DataType&& visible,
     DataType&& spikeMean)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    spikeMean(i) = LogisticFunction::Fn(0.5 * (1.0 / slabPenalty) * arma::accu(
-        visible.t() * (weight.slice(i) * weight.slice(i).t()) * visible)
-        / std::pow(visible.n_cols, 2) + spikeBias(i));
-  }
+  // The sum of v^T W_i W_i^T v over all pairs of columns, divided by the
+  // squared number of columns, is the squared norm of the projection of the
+  // mean column onto W_i; so no visibleSize x visibleSize matrix is formed.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  slabProjection = weights.t() * arma::mean(visible, 1);
+  const arma::Mat<ElemType> projection(slabProjection.memptr(), poolSize,
+      hiddenSize, false, true);
+
+  spikeMean = 0.5 * (1.0 / slabPenalty) *
+      arma::sum(arma::square(projection), 0).t() + spikeBias;
+  LogisticFunction::Fn(spikeMean, spikeMean);
 }
 
 template<
@@ -258,10 +261,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSpike(
     DataType&& spikeMean,
     DataType&& spike)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    spike(i) = math::RandBernoulli(spikeMean(i));
-  }
+  spike = spikeMean;
+  SampleBernoulli(spike);
 }
 
 template<
@@ -276,11 +277,14 @@ RBM<InitializationRuleType, DataType, PolicyType>::SlabMean(
     DataType&& spike,
     DataType&& slabMean)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    slabMean.col(i) = arma::mean((1.0 / slabPenalty) * spike(i) *
-        weight.slice(i).t() * visible, 1);
-  }
+  // The mean over the columns is taken before the projection.
+  const arma::Mat<ElemType> weights(weight.memptr(), visibleSize,
+      poolSize * hiddenSize, false, true);
+  slabProjection = weights.t() * arma::mean(visible, 1);
+  const arma::Mat<ElemType> projection(slabProjection.memptr(), poolSize,
+      hiddenSize, false, true);
+
+  slabMean = (1.0 / slabPenalty) * projection * arma::diagmat(spike);
 }
 
 template<
@@ -294,13 +298,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSlab(
     DataType&& slabMean,
     DataType&& slab)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    for (size_t j = 0; j < poolSize; j++)
-    {
-      slab(j, i) = math::RandNormal(slabMean(j, i), 1.0 / slabPenalty);
-    }
-  }
+  slab = slabMean;
+  SampleNormal(slab, 1.0 / slabPenalty);
 }
 
 } // namespace ann
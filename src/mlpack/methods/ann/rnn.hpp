@@ -31,6 +31,9 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard recurrent neural network container.
  *
+ * Like FFN, the network computes in double precision, since its layers are
+ * held in the arma::mat based LayerTypes variant.
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  */
@@ -139,6 +142,12 @@ class RNN
    * So, e.g., predictors(i, j, k) is the i'th dimension of the j'th data point
    * at time slice k.  The responses will be in the same format.
    *
+   * The batches are independent, so they are predicted in parallel when more
+   * than one thread is available (see Threads): every thread runs its batches
+   * through its own copy of the network, which keeps its own recurrent state
+   * but uses the parameters of this network.  The copies are kept for later
+   * calls.
+   *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
    * @param batchSize Number of points to predict at once.
@@ -227,14 +236,22 @@ class RNN
    * @param args The layer parameter.
    */
   template <class LayerType, class... Args>
-  void Add(Args... args) { network.push_back(new LayerType(args...)); }
+  void Add(Args... args)
+  {
+    DeleteReplicas();
+    network.push_back(new LayerType(args...));
+  }
 
   /*
    * Add a new module to the model.
    *
    * @param layer The Layer to be added to the model.
    */
-  void Add(LayerTypes<CustomLayers...> layer) { network.push_back(layer); }
+  void Add(LayerTypes<CustomLayers...> layer)
+  {
+    DeleteReplicas();
+    network.push_back(layer);
+  }
 
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
@@ -249,6 +266,19 @@ class RNN
   //! Modify the maximum length of backpropagation through time.
   size_t& Rho() { return rho; }
 
+  /**
+   * Get the number of time steps of every truncated BPTT window.  If 0 (the
+   * default), only the first rho time steps of every sequence are used.
+   * Otherwise the whole sequence is processed in consecutive windows of
+   * 'stride' time steps (at most rho).  The recurrent cells carry their state
+   * from one window to the next, and every window is only backpropagated
+   * through its own steps, so memory use depends on the window and not on the
+   * length of the sequence.
+   */
+  const size_t& Stride() const { return stride; }
+  //! Modify the number of time steps of every truncated BPTT window.
+  size_t& Stride() { return stride; }
+
   //! Get the matrix of responses to the input data points.
   const arma::cube& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
@@ -287,8 +317,81 @@ class RNN
 
   /**
    * Reset the state of RNN cells in the network for new input sequence.
+   *
+   * @param steps Number of time steps the cells have to keep for BPTT.
    */
-  void ResetCells();
+  void ResetCells(const size_t steps);
+
+  /**
+   * Prepare the RNN cells in the network for the next window of the current
+   * input sequence, keeping the state they reached at the end of the previous
+   * window.
+   *
+   * @param steps Number of time steps the cells have to keep for BPTT.
+   */
+  void CarryCells(const size_t steps);
+
+  /**
+   * Run the forward pass over the time steps [windowBegin, windowEnd) of the
+   * given batch and return their objective.  The first window of a sequence
+   * starts from a freshly reset cell state, the others from the state the
+   * previous window ended in.  If the network isn't deterministic, the outputs
+   * of every step are stored for the backward pass.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param windowBegin First time step of the window.
+   * @param windowEnd One past the last time step of the window.
+   */
+  double ForwardWindow(const size_t begin,
+                       const size_t batchSize,
+                       const size_t windowBegin,
+                       const size_t windowEnd);
+
+  /**
+   * Predict the responses to the given batch of points, window by window,
+   * carrying the cell state from one window to the next.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into (already
+   *     of the right size).
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param sequenceLength Number of time steps to predict.
+   * @param window Number of time steps of every window.
+   */
+  void PredictBatch(const arma::cube& predictors,
+                    arma::cube& results,
+                    const size_t begin,
+                    const size_t batchSize,
+                    const size_t sequenceLength,
+                    const size_t window);
+
+  /**
+   * Make sure there are the given number of replicas of the network whose
+   * layers use the parameters of this network, for parallel prediction.
+   */
+  void PrepareReplicas(const size_t numReplicas);
+
+  //! Release the network replicas used for parallel prediction.
+  void DeleteReplicas();
+
+  /**
+   * Get the number of time steps that will be processed for the given data.
+   * Without a stride only the first rho time steps are used.
+   */
+  size_t SequenceLength(const arma::cube& data) const
+  {
+    return (stride == 0) ? rho : data.n_slices;
+  }
+
+  //! Get the number of time steps of every window for the given sequence
+  //! length.
+  size_t WindowLength(const size_t sequenceLength) const
+  {
+    return std::min((stride == 0) ? rho : std::min(stride, rho),
+        sequenceLength);
+  }
 
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
@@ -317,6 +420,9 @@ class RNN
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
+  //! Number of steps of every truncated BPTT window (0 = no windows).
+  size_t stride;
+
   //! Instantiated outputlayer used to evaluate the network.
   OutputLayerType outputLayer;
 
@@ -380,6 +486,13 @@ class RNN
 
   //! The current gradient for the gradient pass.
   arma::mat currentGradient;
+
+  //! Locally-stored replicas of the network for parallel prediction (not
+  //! including this network).
+  std::vector<RNN*> replicas;
+
+  //! Memory of the parameters the replica layers currently point to.
+  const double* replicaParameterMemory;
 }; // class RNN
 
 } // namespace ann
@@ -20,13 +20,18 @@
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
+#include "visitor/carry_cell_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/weight_set_visitor.hpp"
 
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 #include <boost/serialization/variant.hpp>
 
+#include <sstream>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -38,6 +43,7 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     OutputLayerType outputLayer,
     InitializationRuleType initializeRule) :
     rho(rho),
+    stride(0),
     outputLayer(std::move(outputLayer)),
     initializeRule(std::move(initializeRule)),
     inputSize(0),
@@ -46,7 +52,8 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     reset(false),
     single(single),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    replicaParameterMemory(NULL)
 {
   /* Nothing to do here */
 }
@@ -55,6 +62,8 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::~RNN()
 {
+  DeleteReplicas();
+
   for (LayerTypes<CustomLayers...>& layer : network)
   {
     boost::apply_visitor(deleteVisitor, layer);
@@ -94,11 +103,22 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType,
-         CustomLayers...>::ResetCells()
+         CustomLayers...>::ResetCells(const size_t steps)
+{
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    boost::apply_visitor(ResetCellVisitor(steps), network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::CarryCells(const size_t steps)
 {
   for (size_t i = 1; i < network.size(); ++i)
   {
-    boost::apply_visitor(ResetCellVisitor(rho), network[i]);
+    boost::apply_visitor(CarryCellVisitor(steps), network[i]);
   }
 }
 
@@ -138,8 +158,6 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     arma::cube predictors, arma::cube& results, const size_t batchSize)
 {
-  ResetCells();
-
   if (parameter.is_empty())
   {
     ResetParameters();
@@ -151,24 +169,136 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  results = arma::zeros<arma::cube>(outputSize, predictors.n_cols, rho);
-  // Process in accordance with the given batch size.
-  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  const size_t sequenceLength = SequenceLength(predictors);
+  const size_t window = WindowLength(sequenceLength);
+
+  results = arma::zeros<arma::cube>(outputSize, predictors.n_cols,
+      sequenceLength);
+
+  // The batches are cut into one range per thread; every range is predicted
+  // by its own network, so that the cell states of the threads are separate.
+  const size_t numBatches = (predictors.n_cols + batchSize - 1) / batchSize;
+  const size_t numRanges = Threads::Ranges(0, numBatches);
+  if (numRanges > 1)
+    PrepareReplicas(numRanges - 1);
+
+  Threads::ParallelRanges(0, numBatches, [&](const size_t range,
+                                             const size_t firstBatch,
+                                             const size_t lastBatch)
+  {
+    RNN& net = (range == 0) ? *this : *replicas[range - 1];
+    for (size_t batch = firstBatch; batch < lastBatch; ++batch)
+    {
+      const size_t begin = batch * batchSize;
+      const size_t effectiveBatchSize = std::min(batchSize,
+          size_t(predictors.n_cols - begin));
+      net.PredictBatch(predictors, results, begin, effectiveBatchSize,
+          sequenceLength, window);
+    }
+  });
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PredictBatch(const arma::cube& predictors,
+                                        arma::cube& results,
+                                        const size_t begin,
+                                        const size_t batchSize,
+                                        const size_t sequenceLength,
+                                        const size_t window)
+{
+  // Every window continues from the cell state the previous one ended in.
+  for (size_t windowBegin = 0; windowBegin < sequenceLength;
+      windowBegin += window)
   {
-    const size_t effectiveBatchSize = std::min(batchSize,
-        size_t(predictors.n_cols - begin));
-    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    const size_t windowEnd = std::min(windowBegin + window, sequenceLength);
+    if (windowBegin == 0)
+      ResetCells(windowEnd - windowBegin);
+    else
+      CarryCells(windowEnd - windowBegin);
+
+    for (size_t seqNum = windowBegin; seqNum < windowEnd; ++seqNum)
     {
-      Forward(std::move(arma::mat(predictors.slice(seqNum).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true)));
+      Forward(std::move(arma::mat(const_cast<double*>(
+          predictors.slice(seqNum).colptr(begin)), predictors.n_rows,
+          batchSize, false, true)));
 
       results.slice(seqNum).submat(0, begin, results.n_rows - 1, begin +
-          effectiveBatchSize - 1) = boost::apply_visitor(outputParameterVisitor,
+          batchSize - 1) = boost::apply_visitor(outputParameterVisitor,
           network.back());
     }
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PrepareReplicas(const size_t numReplicas)
+{
+  if (replicas.size() < numReplicas)
+  {
+    // The replicas get their own layers (also the modules inside recurrent
+    // layers) by deserializing the topology of the network.
+    std::ostringstream topologyStream;
+    {
+      boost::archive::binary_oarchive ar(topologyStream);
+      ar << BOOST_SERIALIZATION_NVP(network);
+    }
+    const std::string topology = topologyStream.str();
+
+    while (replicas.size() < numReplicas)
+    {
+      RNN* replica = new RNN(rho, single, outputLayer, initializeRule);
+      std::istringstream replicaStream(topology);
+      boost::archive::binary_iarchive ar(replicaStream);
+      ar >> BOOST_SERIALIZATION_NVP(replica->network);
+
+      replica->stride = stride;
+      replica->inputSize = inputSize;
+      replica->outputSize = outputSize;
+      replica->targetSize = targetSize;
+      replica->reset = true;
+      replica->ResetDeterministic();
+
+      replicas.push_back(replica);
+    }
+
+    replicaParameterMemory = NULL;
+  }
+
+  // Point the weights of the replica layers to the parameters of this network,
+  // if that hasn't been done yet, or if the memory changed in the meantime.
+  if (replicaParameterMemory != parameter.memptr())
+  {
+    for (size_t r = 0; r < replicas.size(); ++r)
+    {
+      size_t offset = 0;
+      for (size_t i = 0; i < replicas[r]->network.size(); ++i)
+      {
+        offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+            offset), replicas[r]->network[i]);
+
+        boost::apply_visitor(resetVisitor, replicas[r]->network[i]);
+      }
+    }
+
+    replicaParameterMemory = parameter.memptr();
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::DeleteReplicas()
+{
+  for (size_t r = 0; r < replicas.size(); ++r)
+    delete replicas[r];
+
+  replicas.clear();
+  replicaParameterMemory = NULL;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
@@ -198,41 +328,20 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
+  const size_t sequenceLength = SequenceLength(predictors);
+  const size_t window = WindowLength(sequenceLength);
 
   double performance = 0;
-  size_t responseSeq = 0;
-
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t windowBegin = 0; windowBegin < sequenceLength;
+      windowBegin += window)
   {
-    // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true);
-    Forward(std::move(stepData));
-    if (!single)
-    {
-      responseSeq = seqNum;
-    }
+    performance += ForwardWindow(begin, batchSize, windowBegin,
+        std::min(windowBegin + window, sequenceLength));
 
+    // The stored outputs are only consumed by the backward pass; discard them
+    // so the next window starts with an empty history.
     if (!deterministic)
-    {
-      for (size_t l = 0; l < network.size(); ++l)
-      {
-        boost::apply_visitor(SaveOutputParameterVisitor(
-            std::move(moduleOutputParameter)), network[l]);
-      }
-    }
-
-    performance += outputLayer.Forward(std::move(boost::apply_visitor(
-        outputParameterVisitor, network.back())),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true)));
-  }
-
-  if (outputSize == 0)
-  {
-    outputSize = boost::apply_visitor(outputParameterVisitor,
-        network.back()).n_elem / batchSize;
+      moduleOutputParameter.clear();
   }
 
   return performance;
@@ -288,43 +397,6 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
-
-  double performance = 0;
-  size_t responseSeq = 0;
-
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true);
-    Forward(std::move(stepData));
-    if (!single)
-    {
-      responseSeq = seqNum;
-    }
-
-    if (!deterministic)
-    {
-      for (size_t l = 0; l < network.size(); ++l)
-      {
-        boost::apply_visitor(SaveOutputParameterVisitor(
-            std::move(moduleOutputParameter)), network[l]);
-      }
-    }
-
-    performance += outputLayer.Forward(std::move(boost::apply_visitor(
-        outputParameterVisitor, network.back())),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true)));
-  }
-
-  if (outputSize == 0)
-  {
-    outputSize = boost::apply_visitor(outputParameterVisitor,
-        network.back()).n_elem / batchSize;
-  }
-
   // Initialize current/working gradient.
   if (currentGradient.is_empty())
   {
@@ -334,40 +406,47 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   ResetGradients(currentGradient);
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  const size_t sequenceLength = SequenceLength(predictors);
+  const size_t window = WindowLength(sequenceLength);
+
+  // Truncated BPTT: the forward pass runs over every step once, carrying the
+  // cell state from one window to the next, and every window backpropagates
+  // through its own steps only.
+  double performance = 0;
+  for (size_t windowBegin = 0; windowBegin < sequenceLength;
+      windowBegin += window)
   {
-    currentGradient.zeros();
+    const size_t windowEnd = std::min(windowBegin + window, sequenceLength);
+    performance += ForwardWindow(begin, batchSize, windowBegin, windowEnd);
 
-    for (size_t l = 0; l < network.size(); ++l)
+    for (size_t seqNum = windowEnd; seqNum-- > windowBegin; )
     {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          std::move(moduleOutputParameter)), network[network.size() - 1 - l]);
-    }
+      currentGradient.zeros();
 
-    if (single && seqNum > 0)
-    {
-      error.zeros();
-    }
-    else if (single && seqNum == 0)
-    {
-      outputLayer.Backward(std::move(boost::apply_visitor(
-          outputParameterVisitor, network.back())),
-          std::move(arma::mat(responses.slice(0).colptr(begin),
-          responses.n_rows, batchSize, false, true)), std::move(error));
-    }
-    else
-    {
-      outputLayer.Backward(std::move(boost::apply_visitor(
-          outputParameterVisitor, network.back())),
-          std::move(arma::mat(responses.slice(rho - seqNum - 1).colptr(begin),
-          responses.n_rows, batchSize, false, true)), std::move(error));
-    }
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        boost::apply_visitor(LoadOutputParameterVisitor(
+            std::move(moduleOutputParameter)), network[network.size() - 1 - l]);
+      }
 
-    Backward();
-    Gradient(std::move(
-        arma::mat(predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true)));
-    gradient += currentGradient;
+      const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+          network.back());
+      if (single && seqNum != sequenceLength - 1)
+      {
+        error.zeros(output.n_rows, output.n_cols);
+      }
+      else
+      {
+        outputLayer.Backward(std::move(output), std::move(arma::mat(
+            responses.slice(single ? 0 : seqNum).colptr(begin),
+            responses.n_rows, batchSize, false, true)), std::move(error));
+      }
+
+      Backward();
+      Gradient(std::move(arma::mat(predictors.slice(seqNum).colptr(begin),
+          predictors.n_rows, batchSize, false, true)));
+      gradient += currentGradient;
+    }
   }
 
   return performance;
@@ -415,7 +494,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Reset()
 {
   ResetParameters();
-  ResetCells();
+  ResetCells(rho);
   currentGradient.zeros();
   ResetGradients(currentGradient);
 }
@@ -462,6 +541,51 @@ void RNN<OutputLayerType, InitializationRuleType,
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double RNN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::ForwardWindow(const size_t begin,
+                                           const size_t batchSize,
+                                           const size_t windowBegin,
+                                           const size_t windowEnd)
+{
+  if (windowBegin == 0)
+    ResetCells(windowEnd - windowBegin);
+  else
+    CarryCells(windowEnd - windowBegin);
+
+  double performance = 0;
+  for (size_t seqNum = windowBegin; seqNum < windowEnd; ++seqNum)
+  {
+    // Wrap a matrix around our data to avoid a copy.
+    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
+        predictors.n_rows, batchSize, false, true);
+    Forward(std::move(stepData));
+
+    if (!deterministic)
+    {
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        boost::apply_visitor(SaveOutputParameterVisitor(
+            std::move(moduleOutputParameter)), network[l]);
+      }
+    }
+
+    performance += outputLayer.Forward(std::move(boost::apply_visitor(
+        outputParameterVisitor, network.back())),
+        std::move(arma::mat(responses.slice(single ? 0 : seqNum).colptr(begin),
+            responses.n_rows, batchSize, false, true)));
+  }
+
+  if (outputSize == 0)
+  {
+    outputSize = boost::apply_visitor(outputParameterVisitor,
+        network.back()).n_elem / batchSize;
+  }
+
+  return performance;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
@@ -515,6 +639,7 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
 
   if (Archive::is_loading::value)
   {
+    DeleteReplicas();
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
@@ -0,0 +1,590 @@
+/**
+ * @file static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, which implements feed forward neural
+ * networks whose layer types are known at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/gradient_set_visitor.hpp"
+#include "visitor/gradient_visitor.hpp"
+#include "visitor/loss_visitor.hpp"
+#include "visitor/output_height_visitor.hpp"
+#include "visitor/output_width_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+#include "init_rules/init_rules_traits.hpp"
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/init_rules/random_init.hpp>
+#include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of a feed forward network whose layers are fixed at compile
+ * time. In contrast to the FFN class, which stores its layers as a vector of
+ * boost::variant objects and dispatches every call through a visitor, the
+ * layers are held by value in a std::tuple, so every Forward(), Backward() and
+ * Gradient() call is resolved statically and can be inlined by the compiler.
+ * This mostly helps small networks, where the per-layer dispatch overhead is
+ * noticeable. StaticFFN provides the same training and prediction interface as
+ * FFN and can be used with the same optimizers, e.g.:
+ *
+ * @code
+ * StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+ *     ReLULayer<>, Linear<>, LogSoftMax<> > model(std::make_tuple(
+ *     Linear<>(10, 20), ReLULayer<>(), Linear<>(20, 3), LogSoftMax<>()));
+ * model.Train(trainData, trainLabels);
+ * @endcode
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam Layers The types of the layers of the network, in order.
+ */
+template<
+  typename OutputLayerType = NegativeLogLikelihood<>,
+  typename InitializationRuleType = RandomInitialization,
+  typename... Layers
+>
+class StaticFFN
+{
+  static_assert(sizeof...(Layers) > 0, "StaticFFN needs at least one layer.");
+
+ public:
+  //! Convenience typedef for the tuple that holds the layers.
+  using NetworkType = std::tuple<Layers...>;
+
+  //! The type of the I-th layer of the network.
+  template<size_t I>
+  using LayerType = typename std::tuple_element<I, NetworkType>::type;
+
+  //! The number of layers of the network.
+  static constexpr size_t NumLayers = sizeof...(Layers);
+
+  /**
+   * Create the StaticFFN object with default constructed layers.
+   *
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Optional instantiated InitializationRule object
+   *        for initializing the network parameter.
+   */
+  StaticFFN(OutputLayerType outputLayer = OutputLayerType(),
+            InitializationRuleType initializeRule = InitializationRuleType());
+
+  /**
+   * Create the StaticFFN object with the given layers.
+   *
+   * @param network Tuple of the (instantiated) layers of the network.
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Optional instantiated InitializationRule object
+   *        for initializing the network parameter.
+   */
+  StaticFFN(NetworkType network,
+            OutputLayerType outputLayer = OutputLayerType(),
+            InitializationRuleType initializeRule = InitializationRuleType());
+
+  //! Copy constructor.
+  StaticFFN(const StaticFFN& network);
+
+  //! Move constructor.
+  StaticFFN(StaticFFN&& network);
+
+  //! Copy assignment operator.
+  StaticFFN& operator=(const StaticFFN& network);
+
+  //! Move assignment operator.
+  StaticFFN& operator=(StaticFFN&& network);
+
+  /**
+   * Train the feedforward network on the given input data using the given
+   * optimizer.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization. If this is not what you want, then you should access the
+   * parameters vector directly with Parameters() and modify it as desired.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   */
+  template<typename OptimizerType>
+  void Train(arma::mat predictors,
+             arma::mat responses,
+             OptimizerType& optimizer);
+
+  /**
+   * Train the feedforward network on the given input data. By default, the
+   * RMSProp optimization algorithm is used, but others can be specified
+   * (such as mlpack::optimization::SGD).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   */
+  template<typename OptimizerType = mlpack::optimization::RMSProp>
+  void Train(arma::mat predictors, arma::mat responses);
+
+  /**
+   * Predict the responses to a given set of predictors. The predictors are
+   * passed through the network in batches of (at most) batchSize points, in
+   * deterministic (inference) mode.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Maximum number of points that are passed through the
+   *        network at once.
+   */
+  void Predict(arma::mat predictors,
+               arma::mat& results,
+               const size_t batchSize = 128);
+
+  /**
+   * Evaluate the feedforward network with the given predictors and responses.
+   * This functions is usually used to monitor progress while training.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  double Evaluate(arma::mat predictors, arma::mat responses);
+
+  /**
+   * Evaluate the feedforward network with the given parameters. This function
+   * is usually called by the optimizer to train the model.
+   *
+   * @param parameters Matrix model parameters.
+   */
+  double Evaluate(const arma::mat& parameters);
+
+  /**
+   * Evaluate the feedforward network with the given parameters, but using only
+   * a number of data points. This is useful for optimizers such as SGD, which
+   * require a separable objective function.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   * @param deterministic Whether or not to train or test the model. Note some
+   *        layer act differently in training or testing mode.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize,
+                  const bool deterministic = true);
+
+  /**
+   * Evaluate the feedforward network with the given parameters. This function
+   * is usually called by the optimizer to train the model. This just calls the
+   * overload of EvaluateWithGradient() with batchSize = 1 for every point.
+   *
+   * @param parameters Matrix model parameters.
+   * @param gradient Matrix to output gradient into.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const arma::mat& parameters, GradType& gradient);
+
+  /**
+   * Evaluate the feedforward network and its gradient with the given
+   * parameters, but using only a number of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              GradType& gradient,
+                              const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the feedforward network with the given parameters,
+   * and with respect to only a number of points in the dataset.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+  /**
+   * Shuffle the order of function visitation. This may be called by the
+   * optimizer.
+   */
+  void Shuffle();
+
+  //! Get the I-th layer of the network.
+  template<size_t I>
+  const LayerType<I>& Layer() const { return std::get<I>(network); }
+  //! Modify the I-th layer of the network.
+  template<size_t I>
+  LayerType<I>& Layer() { return std::get<I>(network); }
+
+  //! Get the layers of the network.
+  const NetworkType& Model() const { return network; }
+
+  //! Return the number of separable functions (the number of predictor points).
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Return the initial point for the optimization.
+  const arma::mat& Parameters() const { return parameter; }
+  //! Modify the initial point for the optimization.
+  arma::mat& Parameters() { return parameter; }
+
+  //! Get the matrix of responses to the input data points.
+  const arma::mat& Responses() const { return responses; }
+  //! Modify the matrix of responses to the input data points.
+  arma::mat& Responses() { return responses; }
+
+  //! Get the matrix of data points (predictors).
+  const arma::mat& Predictors() const { return predictors; }
+  //! Modify the matrix of data points (predictors).
+  arma::mat& Predictors() { return predictors; }
+
+  /**
+   * Reset the module information (weights/parameters).
+   */
+  void ResetParameters();
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Prepare the network for the given input matrix and responses and
+   * initialize the parameters if that hasn't been done yet.
+   *
+   * @param predictors Input data variables.
+   * @param responses Outputs results from input data variables.
+   */
+  void ResetData(arma::mat predictors, arma::mat responses);
+
+  /**
+   * The Forward algorithm (part of the Forward-Backward algorithm). Computes
+   * forward probabilities for each module.
+   *
+   * @param input Data sequence to compute probabilities for.
+   */
+  void Forward(arma::mat&& input) { ForwardLayers<0>(std::move(input)); }
+
+  /**
+   * Compute the objective of the current output of the network with respect
+   * to the given targets, and propagate the error back through the network.
+   *
+   * @param input The input that was passed through the network.
+   * @param target Target outputs of the given input.
+   * @param gradient Matrix to output gradient into.
+   */
+  double BackwardGradient(arma::mat&& input,
+                          arma::mat&& target,
+                          arma::mat& gradient);
+
+  //! Set the deterministic parameter of all layers.
+  void ResetDeterministic() { ResetDeterministicLayers<0>(); }
+
+  //! Point the weights of all layers to the parameter matrix.
+  void ResetWeights()
+  {
+    if (!parameter.is_empty())
+      ResetWeightsLayers<0>(0);
+  }
+
+  //! Point the gradients of all layers to the given gradient matrix.
+  void ResetGradients(arma::mat& gradient)
+  {
+    ResetGradientsLayers<0>(gradient, 0);
+  }
+
+  //! Forward the given input through the I-th and all following layers.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I < NumLayers)>::type>
+  void ForwardLayers(arma::mat&& input)
+  {
+    LayerType<I>& layer = std::get<I>(network);
+
+    // The first layer defines the input width and height itself.
+    if (!reset && I > 0)
+    {
+      SetInputWidthVisitor(width)(&layer);
+      SetInputHeightVisitor(height)(&layer);
+    }
+
+    layer.Forward(std::move(input), std::move(layer.OutputParameter()));
+
+    if (!reset)
+    {
+      if (OutputWidthVisitor()(&layer) != 0)
+        width = OutputWidthVisitor()(&layer);
+
+      if (OutputHeightVisitor()(&layer) != 0)
+        height = OutputHeightVisitor()(&layer);
+    }
+
+    ForwardLayers<I + 1>(std::move(layer.OutputParameter()));
+  }
+
+  //! End of the forward pass.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I >= NumLayers)>::type,
+      typename = void>
+  void ForwardLayers(arma::mat&& /* input */)
+  {
+    reset = true;
+  }
+
+  //! Backpropagate the error gy through the I-th and all preceding layers
+  //! (except the first one, whose delta is never used).
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I > 0)>::type>
+  void BackwardLayers(arma::mat&& gy)
+  {
+    LayerType<I>& layer = std::get<I>(network);
+    layer.Backward(std::move(layer.OutputParameter()), std::move(gy),
+        std::move(layer.Delta()));
+
+    BackwardLayers<I - 1>(std::move(layer.Delta()));
+  }
+
+  //! End of the backward pass.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I == 0)>::type,
+      typename = void>
+  void BackwardLayers(arma::mat&& /* gy */) { }
+
+  //! Compute the gradient of the I-th and all following layers given the
+  //! input of the I-th layer.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I + 1 < NumLayers)>::type>
+  void GradientLayers(arma::mat&& input)
+  {
+    LayerType<I>& layer = std::get<I>(network);
+    GradientVisitor(std::move(input),
+        std::move(std::get<I + 1>(network).Delta()))(&layer);
+
+    GradientLayers<I + 1>(std::move(layer.OutputParameter()));
+  }
+
+  //! Compute the gradient of the last layer.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I + 1 == NumLayers)>::type,
+      typename = void>
+  void GradientLayers(arma::mat&& input)
+  {
+    GradientVisitor(std::move(input), std::move(error))(
+        &std::get<I>(network));
+  }
+
+  //! Return the sum of the additional loss of the I-th and following layers.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I < NumLayers)>::type>
+  double LossLayers()
+  {
+    return LossVisitor()(&std::get<I>(network)) + LossLayers<I + 1>();
+  }
+
+  //! End of the loss computation.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I >= NumLayers)>::type,
+      typename = void>
+  double LossLayers() { return 0; }
+
+  //! Return the number of weights of the I-th and following layers.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I < NumLayers)>::type>
+  size_t WeightSizeLayers()
+  {
+    return WeightSizeVisitor()(&std::get<I>(network)) +
+        WeightSizeLayers<I + 1>();
+  }
+
+  //! End of the weight size computation.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I >= NumLayers)>::type,
+      typename = void>
+  size_t WeightSizeLayers() { return 0; }
+
+  //! Initialize the weights of the I-th and following layers layer by layer,
+  //! starting at the given offset.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I < NumLayers)>::type>
+  void InitializeLayers(const size_t offset)
+  {
+    const size_t weight = WeightSizeVisitor()(&std::get<I>(network));
+    arma::mat tmp = arma::mat(parameter.memptr() + offset, weight, 1, false,
+        false);
+    initializeRule.Initialize(tmp, tmp.n_elem, 1);
+
+    InitializeLayers<I + 1>(offset + weight);
+  }
+
+  //! End of the initialization.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I >= NumLayers)>::type,
+      typename = void>
+  void InitializeLayers(const size_t /* offset */) { }
+
+  //! Point the weights of the I-th and following layers to the parameters,
+  //! starting at the given offset.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I < NumLayers)>::type>
+  void ResetWeightsLayers(const size_t offset)
+  {
+    LayerType<I>& layer = std::get<I>(network);
+    const size_t weight = WeightSetVisitor(std::move(parameter), offset)(
+        &layer);
+    ResetVisitor()(&layer);
+
+    ResetWeightsLayers<I + 1>(offset + weight);
+  }
+
+  //! End of the weight reset.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I >= NumLayers)>::type,
+      typename = void>
+  void ResetWeightsLayers(const size_t /* offset */) { }
+
+  //! Point the gradients of the I-th and following layers to the given
+  //! gradient, starting at the given offset.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I < NumLayers)>::type>
+  void ResetGradientsLayers(arma::mat& gradient, const size_t offset)
+  {
+    const size_t weight = GradientSetVisitor(std::move(gradient), offset)(
+        &std::get<I>(network));
+
+    ResetGradientsLayers<I + 1>(gradient, offset + weight);
+  }
+
+  //! End of the gradient reset.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I >= NumLayers)>::type,
+      typename = void>
+  void ResetGradientsLayers(arma::mat& /* gradient */,
+                            const size_t /* offset */) { }
+
+  //! Set the deterministic parameter of the I-th and following layers.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I < NumLayers)>::type>
+  void ResetDeterministicLayers()
+  {
+    DeterministicSetVisitor(deterministic)(&std::get<I>(network));
+    ResetDeterministicLayers<I + 1>();
+  }
+
+  //! End of the deterministic reset.
+  template<
+      size_t I,
+      typename = typename std::enable_if<(I >= NumLayers)>::type,
+      typename = void>
+  void ResetDeterministicLayers() { }
+
+  //! Serialize the I-th and following layers.
+  template<
+      size_t I,
+      typename Archive,
+      typename = typename std::enable_if<(I < NumLayers)>::type>
+  void SerializeLayers(Archive& ar)
+  {
+    LayerType<I>& layer = std::get<I>(network);
+    ar & BOOST_SERIALIZATION_NVP(layer);
+
+    SerializeLayers<I + 1>(ar);
+  }
+
+  //! End of the serialization.
+  template<
+      size_t I,
+      typename Archive,
+      typename = typename std::enable_if<(I >= NumLayers)>::type,
+      typename = void>
+  void SerializeLayers(Archive& /* ar */) { }
+
+  //! Instantiated outputlayer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! Locally-stored model modules.
+  NetworkType network;
+
+  //! The input width.
+  size_t width;
+
+  //! The input height.
+  size_t height;
+
+  //! Indicator if the input width and height of the layers have been set.
+  bool reset;
+
+  //! The matrix of data points (predictors).
+  arma::mat predictors;
+
+  //! The matrix of responses to the input data points.
+  arma::mat responses;
+
+  //! Matrix of (trained) parameters.
+  arma::mat parameter;
+
+  //! The number of separable functions (the number of predictor points).
+  size_t numFunctions;
+
+  //! The current error for the backward pass.
+  arma::mat error;
+
+  //! The current evaluation mode (training or testing).
+  bool deterministic;
+}; // class StaticFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
@@ -0,0 +1,427 @@
+/**
+ * @file static_ffn_impl.hpp
+ *
+ * Definition of the StaticFFN class, which implements feed forward neural
+ * networks whose layer types are known at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    OutputLayerType outputLayer, InitializationRuleType initializeRule) :
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    NetworkType network,
+    OutputLayerType outputLayer,
+    InitializationRuleType initializeRule) :
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    network(std::move(network)),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    const StaticFFN& network) :
+    outputLayer(network.outputLayer),
+    initializeRule(network.initializeRule),
+    network(network.network),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    predictors(network.predictors),
+    responses(network.responses),
+    parameter(network.parameter),
+    numFunctions(network.numFunctions),
+    error(network.error),
+    deterministic(network.deterministic)
+{
+  // The copied layers have to use the copied parameters.
+  ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    StaticFFN&& network) :
+    outputLayer(std::move(network.outputLayer)),
+    initializeRule(std::move(network.initializeRule)),
+    network(std::move(network.network)),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    predictors(std::move(network.predictors)),
+    responses(std::move(network.responses)),
+    parameter(std::move(network.parameter)),
+    numFunctions(network.numFunctions),
+    error(std::move(network.error)),
+    deterministic(network.deterministic)
+{
+  // Small parameter matrices are not moved but copied by Armadillo, so the
+  // weights have to be reset in any case.
+  ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>&
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::operator=(
+    const StaticFFN& network)
+{
+  if (this != &network)
+  {
+    outputLayer = network.outputLayer;
+    initializeRule = network.initializeRule;
+    this->network = network.network;
+    width = network.width;
+    height = network.height;
+    reset = network.reset;
+    predictors = network.predictors;
+    responses = network.responses;
+    parameter = network.parameter;
+    numFunctions = network.numFunctions;
+    error = network.error;
+    deterministic = network.deterministic;
+
+    ResetWeights();
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>&
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::operator=(
+    StaticFFN&& network)
+{
+  if (this != &network)
+  {
+    outputLayer = std::move(network.outputLayer);
+    initializeRule = std::move(network.initializeRule);
+    this->network = std::move(network.network);
+    width = network.width;
+    height = network.height;
+    reset = network.reset;
+    predictors = std::move(network.predictors);
+    responses = std::move(network.responses);
+    parameter = std::move(network.parameter);
+    numFunctions = network.numFunctions;
+    error = std::move(network.error);
+    deterministic = network.deterministic;
+
+    ResetWeights();
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ResetData(
+    arma::mat predictors, arma::mat responses)
+{
+  numFunctions = responses.n_cols;
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (parameter.is_empty())
+    ResetParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+      arma::mat predictors,
+      arma::mat responses,
+      OptimizerType& optimizer)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "StaticFFN::StaticFFN(): final objective of trained model is "
+      << out << "." << std::endl;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+    arma::mat predictors, arma::mat responses)
+{
+  OptimizerType optimizer;
+  Train(std::move(predictors), std::move(responses), optimizer);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Predict(
+    arma::mat predictors, arma::mat& results, const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  if (predictors.n_cols == 0)
+  {
+    results.reset();
+    return;
+  }
+
+  const size_t effectiveBatchSize = std::max(size_t(1),
+      std::min(batchSize, size_t(predictors.n_cols)));
+
+  // The first batch also determines the number of output dimensions.
+  Forward(std::move(arma::mat(predictors.colptr(0), predictors.n_rows,
+      effectiveBatchSize, false, true)));
+  const arma::mat& firstOutput =
+      std::get<NumLayers - 1>(network).OutputParameter();
+
+  results.set_size(firstOutput.n_rows, predictors.n_cols);
+  results.cols(0, effectiveBatchSize - 1) = firstOutput;
+
+  for (size_t i = effectiveBatchSize; i < predictors.n_cols;
+      i += effectiveBatchSize)
+  {
+    const size_t currentBatchSize = std::min(effectiveBatchSize,
+        size_t(predictors.n_cols - i));
+
+    Forward(std::move(arma::mat(predictors.colptr(i), predictors.n_rows,
+        currentBatchSize, false, true)));
+    results.cols(i, i + currentBatchSize - 1) =
+        std::get<NumLayers - 1>(network).OutputParameter();
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    arma::mat predictors, arma::mat responses)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(std::move(predictors));
+
+  return outputLayer.Forward(std::move(
+      std::get<NumLayers - 1>(network).OutputParameter()),
+      std::move(responses)) + LossLayers<0>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const arma::mat& parameters)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += Evaluate(parameters, i, 1, true);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const arma::mat& /* parameters */,
+    const size_t begin,
+    const size_t batchSize,
+    const bool deterministic)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (deterministic != this->deterministic)
+  {
+    this->deterministic = deterministic;
+    ResetDeterministic();
+  }
+
+  Forward(std::move(arma::mat(predictors.colptr(begin), predictors.n_rows,
+      batchSize, false, true)));
+
+  return outputLayer.Forward(std::move(
+      std::get<NumLayers - 1>(network).OutputParameter()), std::move(
+      arma::mat(responses.colptr(begin), responses.n_rows, batchSize, false,
+      true))) + LossLayers<0>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename GradType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const arma::mat& parameters, GradType& gradient)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += EvaluateWithGradient(parameters, i, gradient, 1);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename GradType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const arma::mat& /* parameters */,
+                     const size_t begin,
+                     GradType& gradient,
+                     const size_t batchSize)
+{
+  if (gradient.is_empty())
+  {
+    if (parameter.is_empty())
+      ResetParameters();
+
+    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+  }
+  else
+  {
+    gradient.zeros();
+  }
+
+  if (this->deterministic)
+  {
+    this->deterministic = false;
+    ResetDeterministic();
+  }
+
+  arma::mat input(predictors.colptr(begin), predictors.n_rows, batchSize,
+      false, true);
+  Forward(std::move(input));
+
+  return BackwardGradient(std::move(input), std::move(arma::mat(
+      responses.colptr(begin), responses.n_rows, batchSize, false, true)),
+      gradient);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+BackwardGradient(arma::mat&& input, arma::mat&& target, arma::mat& gradient)
+{
+  arma::mat& output = std::get<NumLayers - 1>(network).OutputParameter();
+  const double res = outputLayer.Forward(std::move(output), std::move(target)) +
+      LossLayers<0>();
+
+  outputLayer.Backward(std::move(output), std::move(target), std::move(error));
+
+  BackwardLayers<NumLayers - 1>(std::move(error));
+  ResetGradients(gradient);
+  GradientLayers<0>(std::move(input));
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Shuffle()
+{
+  math::ShuffleData(predictors, responses, predictors, responses);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetParameters()
+{
+  ResetDeterministic();
+
+  // Reset the network parameter with the given initialization rule.
+  parameter.set_size(WeightSizeLayers<0>(), 1);
+  if (ann::InitTraits<InitializationRuleType>::UseLayer)
+    InitializeLayers<0>(0);
+  else
+    initializeRule.Initialize(parameter, parameter.n_elem, 1);
+
+  ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameter);
+  ar & BOOST_SERIALIZATION_NVP(width);
+  ar & BOOST_SERIALIZATION_NVP(height);
+
+  SerializeLayers<0>(ar);
+
+  // If we are loading, we need to initialize the weights.
+  if (Archive::is_loading::value)
+  {
+    reset = false;
+    ResetWeights();
+
+    deterministic = true;
+    ResetDeterministic();
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
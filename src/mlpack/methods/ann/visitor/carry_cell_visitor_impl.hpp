@@ -0,0 +1,62 @@
+/**
+ * @file carry_cell_visitor_impl.hpp
+ *
+ * Implementation of the CarryCell() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_CARRY_CELL_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_CARRY_CELL_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "carry_cell_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! CarryCellVisitor visitor class.
+inline CarryCellVisitor::CarryCellVisitor(const size_t size) : size(size)
+{
+  /* Nothing to do here. */
+}
+
+//! CarryCellVisitor visitor class.
+template<typename LayerType>
+inline void CarryCellVisitor::operator()(LayerType* layer) const
+{
+  CarryCell(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasCarryCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+CarryCellVisitor::CarryCell(T* layer) const
+{
+  layer->CarryCell(size);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasCarryCellCheck<T, void(T::*)(const size_t)>::value &&
+    HasResetCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+CarryCellVisitor::CarryCell(T* layer) const
+{
+  layer->ResetCell(size);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasCarryCellCheck<T, void(T::*)(const size_t)>::value &&
+    !HasResetCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+CarryCellVisitor::CarryCell(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file recompute_visitor.hpp
+ *
+ * This file provides a check whether the forward pass of the different layers
+ * can be repeated, which is used for gradient checkpointing.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_RECOMPUTE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_RECOMPUTE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+template<typename InputDataType, typename OutputDataType>
+class Reparametrization;
+
+/**
+ * RecomputeVisitor returns whether the forward pass of the given module can be
+ * repeated during the backward pass, with the same output and without side
+ * effects.  That isn't the case for modules that behave differently in
+ * training mode (they implement Deterministic(), e.g. Dropout draws a new mask
+ * and BatchNorm updates its running statistics), for modules that draw random
+ * numbers in every forward pass (Reparametrization), and for modules that hold
+ * such a module.
+ */
+class RecomputeVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Return whether the forward pass of the module can be repeated.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+  //! The Reparametrization module samples new noise in every forward pass.
+  template<typename InputDataType, typename OutputDataType>
+  bool operator()(
+      Reparametrization<InputDataType, OutputDataType>* /* layer */) const
+  {
+    return false;
+  }
+
+ private:
+  //! Return false if the module implements the Deterministic() function.
+  template<typename T>
+  typename std::enable_if<
+      HasDeterministicCheck<T, bool&(T::*)(void)>::value, bool>::type
+  LayerRecompute(T* layer) const;
+
+  //! Check the modules of a module that implements the Model() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasDeterministicCheck<T, bool&(T::*)(void)>::value &&
+      HasModelCheck<T>::value, bool>::type
+  LayerRecompute(T* layer) const;
+
+  //! Return true if the module doesn't implement the Deterministic() or Model()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      !HasDeterministicCheck<T, bool&(T::*)(void)>::value &&
+      !HasModelCheck<T>::value, bool>::type
+  LayerRecompute(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "recompute_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file recompute_visitor_impl.hpp
+ *
+ * Implementation of the RecomputeVisitor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_RECOMPUTE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_RECOMPUTE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "recompute_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! RecomputeVisitor visitor class.
+template<typename LayerType>
+inline bool RecomputeVisitor::operator()(LayerType* layer) const
+{
+  return LayerRecompute(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasDeterministicCheck<T, bool&(T::*)(void)>::value, bool>::type
+RecomputeVisitor::LayerRecompute(T* /* layer */) const
+{
+  return false;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasDeterministicCheck<T, bool&(T::*)(void)>::value &&
+    HasModelCheck<T>::value, bool>::type
+RecomputeVisitor::LayerRecompute(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+  {
+    if (!boost::apply_visitor(RecomputeVisitor(), layer->Model()[i]))
+      return false;
+  }
+
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasDeterministicCheck<T, bool&(T::*)(void)>::value &&
+    !HasModelCheck<T>::value, bool>::type
+RecomputeVisitor::LayerRecompute(T* /* layer */) const
+{
+  return true;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file sparse_gradient_visitor.hpp
+ *
+ * This file provides an abstraction for the TouchedColumns() function for
+ * different layers and automatically directs any parameter to the right layer
+ * type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SPARSE_GRADIENT_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SPARSE_GRADIENT_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * SparseGradientVisitor returns the indices of the gradient elements that the
+ * last Gradient() call of the given module may have made nonzero, if the
+ * module implements the TouchedColumns() function (e.g. Lookup).  For every
+ * other module, the whole gradient has to be considered.
+ */
+class SparseGradientVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Set the vector to store the indices in.
+  SparseGradientVisitor(arma::uvec& indices);
+
+  //! Store the indices of the nonzero gradient elements and return true, or
+  //! return false if the whole gradient may be nonzero.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+ private:
+  //! The indices of the nonzero gradient elements.
+  arma::uvec& indices;
+
+  //! Store the indices if the module implements the TouchedColumns()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      HasTouchedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+      bool>::type
+  LayerIndices(T* layer) const;
+
+  //! Return false if the module doesn't implement the TouchedColumns()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      !HasTouchedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+      bool>::type
+  LayerIndices(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_gradient_visitor_impl.hpp"
+
+#endif
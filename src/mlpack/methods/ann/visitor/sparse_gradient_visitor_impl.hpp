@@ -0,0 +1,66 @@
+/**
+ * @file sparse_gradient_visitor_impl.hpp
+ *
+ * Implementation of the TouchedColumns() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SPARSE_GRADIENT_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SPARSE_GRADIENT_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_gradient_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! SparseGradientVisitor visitor class.
+inline SparseGradientVisitor::SparseGradientVisitor(arma::uvec& indices) :
+    indices(indices)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline bool SparseGradientVisitor::operator()(LayerType* layer) const
+{
+  return LayerIndices(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasTouchedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+    bool>::type
+SparseGradientVisitor::LayerIndices(T* layer) const
+{
+  // The gradient is stored column-major, so each touched column is a
+  // contiguous range of elements.
+  const arma::uvec& columns = layer->TouchedColumns();
+  const size_t rows = layer->Parameters().n_rows;
+
+  indices.set_size(columns.n_elem * rows);
+  for (size_t i = 0; i < columns.n_elem; ++i)
+  {
+    indices.subvec(i * rows, (i + 1) * rows - 1) = arma::regspace<arma::uvec>(
+        columns[i] * rows, (columns[i] + 1) * rows - 1);
+  }
+
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasTouchedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+    bool>::type
+SparseGradientVisitor::LayerIndices(T* /* layer */) const
+{
+  return false;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
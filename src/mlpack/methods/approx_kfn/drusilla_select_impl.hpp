@@ -16,9 +16,7 @@
 #include "drusilla_select.hpp"
 
 #include <queue>
-#include <mlpack/methods/neighbor_search/neighbor_search_rules.hpp>
-#include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
-#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 #include <algorithm>
 
 namespace mlpack {
@@ -84,14 +82,18 @@ void DrusillaSelect<MatType>::Train(
   arma::vec dataMean(arma::mean(referenceSet, 1));
   arma::vec norms(referenceSet.n_cols);
 
-  MatType refCopy(referenceSet.n_rows, referenceSet.n_cols);
-  for (size_t i = 0; i < refCopy.n_cols; ++i)
+  // The centered data is dense even if the reference set is sparse, and a
+  // dense matrix can be filled from several threads.
+  arma::mat refCopy(referenceSet.n_rows, referenceSet.n_cols);
+  Threads::ParallelFor(0, refCopy.n_cols, [&](const size_t i)
   {
     refCopy.col(i) = referenceSet.col(i) - dataMean;
     norms[i] = arma::norm(refCopy.col(i));
-  }
+  });
 
-  // Find the top m points for each of the l projections...
+  // Find the top m points for each of the l projections.  Each projection
+  // depends on the points taken by the previous ones, so only the scoring of
+  // the points for one projection is done in parallel.
   for (size_t i = 0; i < l; ++i)
   {
     // Pick best index.
@@ -100,10 +102,11 @@ void DrusillaSelect<MatType>::Train(
 
     arma::vec line(refCopy.col(maxIndex) / arma::norm(refCopy.col(maxIndex)));
 
-    // Calculate distortion and offset and make scores.
-    std::vector<bool> closeAngle(referenceSet.n_cols, false);
+    // Calculate distortion and offset and make scores.  (std::vector<bool>
+    // can't be written to from several threads.)
+    std::vector<char> closeAngle(referenceSet.n_cols, false);
     arma::vec sums(referenceSet.n_cols);
-    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+    Threads::ParallelFor(0, referenceSet.n_cols, [&](const size_t j)
     {
       if (norms[j] > 0.0)
       {
@@ -117,7 +120,7 @@ void DrusillaSelect<MatType>::Train(
       {
         sums[j] = norms[j];
       }
-    }
+    });
 
     // Find the top m elements using a priority queue.
     typedef std::pair<double, size_t> Candidate;
@@ -179,23 +182,40 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
     throw std::invalid_argument("DrusillaSelect::Search(): requested k is "
         "greater than number of points in candidate set!  Increase l or m.");
 
-  // We'll use the NeighborSearchRules class to perform our brute-force search.
-  // Note that we aren't using trees for our search, so we can use 'int' as a
-  // TreeType.
-  metric::EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
-      tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
 
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
+  // This is a brute-force search of the candidate set; the queries are
+  // independent, so they are searched in parallel, each with its own heap of
+  // results.  The heap holds (distance, candidate) pairs, with the closest of
+  // the k furthest candidates on top.
+  typedef std::pair<double, size_t> Candidate;
+  Threads::ParallelFor(0, querySet.n_cols, [&](const size_t q)
+  {
+    std::vector<Candidate> clist(k, std::make_pair(-1.0, size_t(-1)));
+    std::priority_queue<Candidate, std::vector<Candidate>,
+        std::greater<Candidate>> pq(std::greater<Candidate>(),
+        std::move(clist));
 
-  rules.GetResults(neighbors, distances);
+    for (size_t r = 0; r < candidateSet.n_cols; ++r)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(
+          querySet.col(q), candidateSet.col(r));
+      if (k > 0 && distance > pq.top().first)
+      {
+        pq.pop();
+        pq.push(std::make_pair(distance, r));
+      }
+    }
 
-  // Map the neighbors back to their original indices in the reference set.
-  for (size_t i = 0; i < neighbors.n_elem; ++i)
-    neighbors[i] = candidateIndices[neighbors[i]];
+    // Map the neighbors back to their original indices in the reference set.
+    for (size_t j = 1; j <= k; ++j)
+    {
+      neighbors(k - j, q) = candidateIndices[pq.top().second];
+      distances(k - j, q) = pq.top().first;
+      pq.pop();
+    }
+  });
 }
 
 //! Serialize the model.
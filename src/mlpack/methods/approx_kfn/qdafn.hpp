@@ -68,11 +68,43 @@ class QDAFN
              const size_t l = 0,
              const size_t m = 0);
 
+  /**
+   * Start training on a stream of reference points: draw new projections and
+   * empty the tables, optionally setting new parameters l and m.  The points
+   * are then given with Update(), one batch at a time.  Only the top m points
+   * of each projection are kept, so a reference set that does not fit in
+   * memory can be used by loading it in batches:
+   *
+   * @code
+   * QDAFN<> qdafn(l, m);
+   * qdafn.Reset(dimensionality);
+   * while (LoadNextBatch(batch))
+   *   qdafn.Update(batch);
+   * @endcode
+   *
+   * @param dimensionality Dimensionality of the reference points.
+   * @param l Number of projections.
+   * @param m Number of elements to store for each projection.
+   */
+  void Reset(const size_t dimensionality,
+             const size_t l = 0,
+             const size_t m = 0);
+
+  /**
+   * Add a batch of reference points to the model.  The points get the indices
+   * after those of the points added before (the first point after Reset() has
+   * index 0).  The tables of the projections are updated in parallel.
+   *
+   * @param batch Batch of reference points.
+   */
+  void Update(const MatType& batch);
+
   /**
    * Search for the k furthest neighbors of the given query set.  (The query set
    * can contain just one point, that is okay.)  The results will be stored in
    * the given neighbors and distances matrices, in the same format as the
-   * mlpack NeighborSearch and LSHSearch classes.
+   * mlpack NeighborSearch and LSHSearch classes.  The query points are searched
+   * in parallel.
    */
   void Search(const MatType& querySet,
               const size_t k,
@@ -81,11 +113,14 @@ class QDAFN
 
   //! Serialize the model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
   //! Get the number of projections.
   size_t NumProjections() const { return candidateSet.size(); }
 
+  //! Get the number of reference points the model was trained on.
+  size_t ReferenceSize() const { return referenceSize; }
+
   //! Get the candidate set for the given projection table.
   const MatType& CandidateSet(const size_t t) const { return candidateSet[t]; }
   //! Modify the candidate set for the given projection table.  Careful!
@@ -98,8 +133,8 @@ class QDAFN
   size_t m;
   //! The random lines we are projecting onto.  Has l columns.
   arma::mat lines;
-  //! Projections of each point onto each random line.
-  arma::mat projections;
+  //! The number of reference points the model was trained on.
+  size_t referenceSize;
 
   //! Indices of the points for each S.
   arma::Mat<size_t> sIndices;
@@ -113,6 +148,10 @@ class QDAFN
 } // namespace neighbor
 } // namespace mlpack
 
+//! Set the serialization version of the QDAFN class.
+BOOST_TEMPLATE_CLASS_VERSION(template<typename MatType>,
+    mlpack::neighbor::QDAFN<MatType>, 1);
+
 // Include implementation.
 #include "qdafn_impl.hpp"
 
@@ -16,6 +16,7 @@
 #include "qdafn.hpp"
 
 #include <queue>
+#include <algorithm>
 #include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
 
 namespace mlpack {
@@ -23,7 +24,10 @@ namespace neighbor {
 
 // Non-training constructor.
 template<typename MatType>
-QDAFN<MatType>::QDAFN(const size_t l, const size_t m) : l(l), m(m)
+QDAFN<MatType>::QDAFN(const size_t l, const size_t m) :
+    l(l),
+    m(m),
+    referenceSize(0)
 {
   if (l == 0)
     throw std::invalid_argument("QDAFN::QDAFN(): l must be greater than 0!");
@@ -37,7 +41,8 @@ QDAFN<MatType>::QDAFN(const MatType& referenceSet,
                       const size_t l,
                       const size_t m) :
     l(l),
-    m(m)
+    m(m),
+    referenceSize(0)
 {
   if (l == 0)
     throw std::invalid_argument("QDAFN::QDAFN(): l must be greater than 0!");
@@ -52,6 +57,16 @@ template<typename MatType>
 void QDAFN<MatType>::Train(const MatType& referenceSet,
                            const size_t lIn,
                            const size_t mIn)
+{
+  Reset(referenceSet.n_rows, lIn, mIn);
+  Update(referenceSet);
+}
+
+// Draw new projections and empty the tables.
+template<typename MatType>
+void QDAFN<MatType>::Reset(const size_t dimensionality,
+                           const size_t lIn,
+                           const size_t mIn)
 {
   if (lIn != 0)
     l = lIn;
@@ -61,32 +76,76 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   // Build tables.  This is done by drawing random points from a Gaussian
   // distribution as the vectors we project onto.  The Gaussian should have zero
   // mean and unit variance.
-  mlpack::distribution::GaussianDistribution gd(referenceSet.n_rows);
-  lines.set_size(referenceSet.n_rows, l);
+  mlpack::distribution::GaussianDistribution gd(dimensionality);
+  lines.set_size(dimensionality, l);
   for (size_t i = 0; i < l; ++i)
     lines.col(i) = gd.Random();
 
-  // Now, project each of the reference points onto each line, and collect the
-  // top m elements.
-  projections = referenceSet.t() * lines;
-
-  // Loop over each projection and find the top m elements.
+  // The tables are empty.
+  referenceSize = 0;
   sIndices.set_size(m, l);
   sValues.set_size(m, l);
+  candidateSet.clear();
   candidateSet.resize(l);
   for (size_t i = 0; i < l; ++i)
+    candidateSet[i].set_size(dimensionality, m);
+}
+
+// Add a batch of reference points.
+template<typename MatType>
+void QDAFN<MatType>::Update(const MatType& batch)
+{
+  if (batch.n_rows != lines.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "QDAFN::Update(): dimensionality of batch (" << batch.n_rows
+        << ") is not equal to the dimensionality of the model ("
+        << lines.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Project each of the points onto each line.
+  const arma::mat projections = batch.t() * lines;
+
+  // The top m elements of each projection are the top m of the elements held
+  // so far and the new elements.  The projections are independent, so they
+  // are updated in parallel.
+  const size_t oldSize = std::min(m, referenceSize);
+  const size_t newSize = std::min(m, referenceSize + (size_t) batch.n_cols);
+  Threads::ParallelFor(0, l, [&](const size_t i)
   {
-    candidateSet[i].set_size(referenceSet.n_rows, m);
-    arma::uvec sortedIndices = arma::sort_index(projections.col(i), "descend");
+    // Each element is (value, position); positions below oldSize are elements
+    // of the table, and the others are points of the batch.
+    std::vector<std::pair<double, size_t>> elements(oldSize + batch.n_cols);
+    for (size_t j = 0; j < oldSize; ++j)
+      elements[j] = std::make_pair(sValues(j, i), j);
+    for (size_t j = 0; j < batch.n_cols; ++j)
+      elements[oldSize + j] = std::make_pair(projections(j, i), oldSize + j);
+
+    std::partial_sort(elements.begin(), elements.begin() + newSize,
+        elements.end(), std::greater<std::pair<double, size_t>>());
 
-    // Grab the top m elements.
-    for (size_t j = 0; j < m; ++j)
+    // Build the new table next to the old one, since the old one is read.
+    const arma::Col<size_t> oldIndices = sIndices.col(i);
+    const MatType oldCandidates = candidateSet[i];
+    for (size_t j = 0; j < newSize; ++j)
     {
-      sIndices(j, i) = sortedIndices[j];
-      sValues(j, i) = projections(sortedIndices[j], i);
-      candidateSet[i].col(j) = referenceSet.col(sortedIndices[j]);
+      const size_t position = elements[j].second;
+      sValues(j, i) = elements[j].first;
+      if (position < oldSize)
+      {
+        sIndices(j, i) = oldIndices[position];
+        candidateSet[i].col(j) = oldCandidates.col(position);
+      }
+      else
+      {
+        sIndices(j, i) = referenceSize + (position - oldSize);
+        candidateSet[i].col(j) = batch.col(position - oldSize);
+      }
     }
-  }
+  });
+
+  referenceSize += batch.n_cols;
 }
 
 // Search.
@@ -100,12 +159,17 @@ void QDAFN<MatType>::Search(const MatType& querySet,
     throw std::invalid_argument("QDAFN::Search(): requested k is greater than "
         "value of m!");
 
+  if (referenceSize < m)
+    throw std::invalid_argument("QDAFN::Search(): the model was trained on "
+        "fewer than m points!");
+
   neighbors.set_size(k, querySet.n_cols);
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
-  // Search for each point.
-  for (size_t q = 0; q < querySet.n_cols; ++q)
+  // Search for each point; the queries are independent, and each has its own
+  // queues.
+  Threads::ParallelFor(0, querySet.n_cols, [&](const size_t q)
   {
     // Initialize a priority queue.
     // The size_t represents the index of the table, and the double represents
@@ -166,19 +230,38 @@ void QDAFN<MatType>::Search(const MatType& querySet,
       distances(k - j, q) = resultsQueue.top().first;
       resultsQueue.pop();
     }
-  }
+  });
 }
 
 template<typename MatType>
 template<typename Archive>
-void QDAFN<MatType>::serialize(Archive& ar, const unsigned int /* version */)
+void QDAFN<MatType>::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(l);
   ar & BOOST_SERIALIZATION_NVP(m);
   ar & BOOST_SERIALIZATION_NVP(lines);
-  ar & BOOST_SERIALIZATION_NVP(projections);
+
+  // Backward compatibility: older versions held the projections of every
+  // reference point, which are not needed for search.
+  if (version == 0)
+  {
+    arma::mat projections;
+    ar & BOOST_SERIALIZATION_NVP(projections);
+  }
+  else
+  {
+    ar & BOOST_SERIALIZATION_NVP(referenceSize);
+  }
+
   ar & BOOST_SERIALIZATION_NVP(sIndices);
   ar & BOOST_SERIALIZATION_NVP(sValues);
+
+  // Older versions did not store the number of reference points; the tables
+  // give a lower bound.
+  if (Archive::is_loading::value && version == 0)
+    referenceSize = sIndices.is_empty() ? 0 : arma::max(arma::vectorise(
+        sIndices)) + 1;
+
   if (Archive::is_loading::value)
     candidateSet.clear();
   ar & BOOST_SERIALIZATION_NVP(candidateSet);
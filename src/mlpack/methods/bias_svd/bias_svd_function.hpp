@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/parallel_sgd.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/stratified_sgd.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/decay_policies/exponential_backoff.hpp>
 
 namespace mlpack {
@@ -102,6 +103,25 @@ class BiasSVDFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Take an SGD step on one training example.  Only the parameters of the
+   * user and the item of the example are modified, so this can be called
+   * concurrently for examples that share neither (see StratifiedSGD).
+   *
+   * @param parameters Parameters(user/item matrices/bias) of the
+   *     decomposition.
+   * @param i Index of the training example.
+   * @param stepSize Step size of the update.
+   */
+  void Update(arma::mat& parameters,
+              const size_t i,
+              const double stepSize) const;
+
+  //! No parameters are shared between examples of different users and items,
+  //! so there is nothing to synchronize.
+  void Synchronize(arma::mat& /* parameters */,
+                   const double /* stepSize */) const { }
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
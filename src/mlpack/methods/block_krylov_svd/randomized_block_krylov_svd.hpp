@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/lin_alg.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -97,8 +98,16 @@ class RandomizedBlockKrylovSVD
    * @param v Second unitary matrix.
    * @param s Diagonal matrix of singular values.
    * @param rank Rank of the approximation.
+   *
+   * The data may be dense or sparse.  Sparse data is only used through
+   * products with dense blocks, which are computed in parallel by streaming
+   * over its columns, so it is never densified; the Krylov basis is
+   * orthonormalized with a parallel (TSQR) QR decomposition.
+   *
+   * @tparam MatType Type of the data matrix (arma::mat or arma::sp_mat).
    */
-  void Apply(const arma::mat& data,
+  template<typename MatType>
+  void Apply(const MatType& data,
              arma::mat& u,
              arma::vec& s,
              arma::mat& v,
@@ -125,4 +134,7 @@ class RandomizedBlockKrylovSVD
 } // namespace svd
 } // namespace mlpack
 
+// Include implementation.
+#include "randomized_block_krylov_svd_impl.hpp"
+
 #endif
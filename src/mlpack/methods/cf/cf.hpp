@@ -19,6 +19,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/amf/amf.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
 #include <mlpack/methods/cf/normalization/no_normalization.hpp>
@@ -28,6 +30,7 @@
 #include <set>
 #include <map>
 #include <iostream>
+#include <typeinfo>
 
 namespace mlpack {
 namespace cf /** Collaborative filtering. **/ {
@@ -153,6 +156,7 @@ class CFType
       return;
     }
     this->numUsersForSimilarity = num;
+    ClearNeighborhoodCache();
   }
 
   //! Gets number of users for calculating similarity.
@@ -197,6 +201,9 @@ class CFType
 
   /**
    * Generates the given number of recommendations for the specified users.
+   * The ratings are computed for blocks of users at once (as a single matrix
+   * product, if the decomposition policy provides GetRatingOfUsers()), and
+   * the best items of each user are selected in parallel.
    *
    * @tparam NeighborSearchPolicy The policy used to search neighbors of
    *     query set in referece set.
@@ -213,6 +220,78 @@ class CFType
                           arma::Mat<size_t>& recommendations,
                           const arma::Col<size_t>& users);
 
+  //! The index used to find the items with the highest ratings quickly.
+  typedef fastmks::FastMKS<kernel::LinearKernel> ItemIndexType;
+
+  /**
+   * Build an index over the item vectors of the decomposition, for use with
+   * the GetRecommendations() overload that takes an index.  The index only
+   * needs to be built once per model, and has to be rebuilt after Train().
+   * The decomposition policy must provide GetItemVectors().
+   *
+   * @param index Index to build.
+   */
+  void BuildItemIndex(ItemIndexType& index) const;
+
+  /**
+   * Generates the given number of recommendations for the specified users,
+   * using a maximum inner product search on the given index (see
+   * BuildItemIndex()) instead of rating every item for every user.  The
+   * decomposition policy must provide GetUserVectors().
+   *
+   * The items are ranked by their normalized ratings, so the recommendations
+   * are the same as those of the other overloads unless the normalization
+   * depends on the item (such as ItemMeanNormalization).
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations.
+   * @param users Users for which recommendations are to be generated.
+   * @param index Index built on the item vectors with BuildItemIndex().
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void GetRecommendations(const size_t numRecs,
+                          arma::Mat<size_t>& recommendations,
+                          const arma::Col<size_t>& users,
+                          ItemIndexType& index);
+
+  /**
+   * Fold the ratings of new or existing users into the trained model, without
+   * retraining it.  The given ratings replace all the existing ratings of the
+   * given users, and each of their user vectors is found by solving a small
+   * regularized least-squares problem against the fixed item vectors (in
+   * parallel).  The factors of all other users and items are left untouched.
+   * All the items must already be in the model (see FoldInItems()).
+   *
+   * The decomposition policy must allow its W() and H() matrices to be
+   * modified, and predict ratings as W H.
+   *
+   * @param data Ratings of the users, as a (user, item, rating) table.
+   * @param lambda Regularization parameter of the least-squares problems.
+   */
+  void FoldInUsers(const arma::mat& data, const double lambda = 0.01);
+
+  /**
+   * Fold the ratings of new or existing items into the trained model, without
+   * retraining it.  The given ratings replace all the existing ratings of the
+   * given items, and each of their item vectors is found by solving a small
+   * regularized least-squares problem against the fixed user vectors (in
+   * parallel).  The factors of all other users and items are left untouched.
+   * All the users must already be in the model (see FoldInUsers()).
+   *
+   * The decomposition policy must allow its W() and H() matrices to be
+   * modified, and predict ratings as W H.
+   *
+   * @param data Ratings of the items, as a (user, item, rating) table.
+   * @param lambda Regularization parameter of the least-squares problems.
+   */
+  void FoldInItems(const arma::mat& data, const double lambda = 0.01);
+
   //! Converts the User, Item, Value Matrix to User-Item Table.
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
 
@@ -271,6 +350,76 @@ class CFType
   //! Data normalization object.
   NormalizationType normalization;
 
+  //! Neighborhoods of all the users, computed the first time they are needed.
+  mutable arma::Mat<size_t> cachedNeighborhood;
+  //! Similarities of all the users to their neighbors.
+  mutable arma::mat cachedSimilarities;
+  //! Neighbor search policy the cached neighborhoods were computed with.
+  mutable const std::type_info* cachedPolicy;
+
+  /**
+   * Get the neighborhoods of the given users, and their similarities, using
+   * the cached neighborhoods of all the users.  These are computed with a
+   * single neighbor search the first time they are needed (or when a
+   * different neighbor search policy is used), and are reused until the model
+   * changes.
+   */
+  template<typename NeighborSearchPolicy>
+  void GetNeighborhood(const arma::Col<size_t>& users,
+                       arma::Mat<size_t>& neighborhood,
+                       arma::mat& similarities) const;
+
+  //! Discard the cached neighborhoods, after the model has changed.
+  void ClearNeighborhoodCache()
+  {
+    cachedNeighborhood.reset();
+    cachedSimilarities.reset();
+    cachedPolicy = NULL;
+  }
+
+  /**
+   * Replace the ratings of the users (or the items) in the given normalized
+   * (user, item, rating) table in the cleaned data, growing it as needed.
+   */
+  void ReplaceRatings(const arma::mat& normalizedData, const bool users);
+
+  /**
+   * Solve the regularized least-squares problem of each user (or item) with
+   * ratings in the given normalized table; keyRow is the row of the table
+   * that holds the IDs to solve for, and the fixed factors are indexed by the
+   * other ID.  The solutions are stored in the columns of result.
+   */
+  static void SolveFoldIn(const arma::mat& normalizedData,
+                          const size_t keyRow,
+                          const arma::mat& factors,
+                          const double lambda,
+                          arma::mat& result);
+
+  /**
+   * Compute the ratings of a block of users, given their neighborhoods and
+   * interpolation weights, as a single product if the decomposition policy
+   * provides GetRatingOfUsers().
+   */
+  template<typename PolicyType>
+  static auto GetRatingsOfBlock(const PolicyType& decomposition,
+                                const arma::Mat<size_t>& neighborhood,
+                                const arma::mat& weights,
+                                arma::mat& ratings,
+                                const int /* preferred */)
+      -> decltype(decomposition.GetRatingOfUsers(neighborhood, weights,
+          ratings), void());
+
+  /**
+   * Compute the ratings of a block of users one user at a time, for
+   * decomposition policies without GetRatingOfUsers().
+   */
+  template<typename PolicyType>
+  static void GetRatingsOfBlock(const PolicyType& decomposition,
+                                const arma::Mat<size_t>& neighborhood,
+                                const arma::mat& weights,
+                                arma::mat& ratings,
+                                const long /* fallback */);
+
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
 
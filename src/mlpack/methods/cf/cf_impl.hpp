@@ -30,7 +30,8 @@ CFType<DecompositionPolicy,
 CFType(const size_t numUsersForSimilarity,
        const size_t rank) :
     numUsersForSimilarity(numUsersForSimilarity),
-    rank(rank)
+    rank(rank),
+    cachedPolicy(NULL)
 {
   // Validate neighbourhood size.
   if (numUsersForSimilarity < 1)
@@ -58,7 +59,8 @@ CFType(const MatType& data,
        const double minResidue,
        const bool mit) :
     numUsersForSimilarity(numUsersForSimilarity),
-    rank(rank)
+    rank(rank),
+    cachedPolicy(NULL)
 {
   // Validate neighbourhood size.
   if (numUsersForSimilarity < 1)
@@ -84,6 +86,7 @@ Train(const arma::mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  ClearNeighborhoodCache();
 
   // Make a copy of data before performing normalization.
   arma::mat normalizedData(data);
@@ -125,6 +128,7 @@ Train(const arma::sp_mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  ClearNeighborhoodCache();
 
   // data is not used in the following decomposition.Apply() method, so we only
   // need to Normalize cleanedData.
@@ -195,85 +199,108 @@ GetRecommendations(const size_t numRecs,
   // weighted sum of both the query user and the local neighborhood of the
   // query user.
   // Calculate the neighborhood of the queried users.
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  GetNeighborhood<NeighborSearchPolicy>(users, neighborhood, similarities);
 
   // Generate recommendations for each query user by finding the maximum numRecs
   // elements in the ratings vector.
   recommendations.set_size(numRecs, users.n_elem);
-  arma::mat values(numRecs, users.n_elem);
   recommendations.fill(SIZE_MAX);
-  values.fill(DBL_MAX);
 
   // Initialization of an InterpolationPolicy object should be put ahead of the
   // following loop, because the initialization may takes a relatively long
   // time and we don't want to repeat the initialization process in each loop.
   InterpolationPolicy interpolation(cleanedData);
 
+  // Calculate interpolation weights.  The interpolation policy may cache
+  // results between calls, so this is done serially.
+  arma::mat weights(numUsersForSimilarity, users.n_elem);
   for (size_t i = 0; i < users.n_elem; i++)
   {
-    // First, calculate the weighted sum of neighborhood values.
-    arma::vec ratings;
-    ratings.zeros(cleanedData.n_rows);
-
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
+    interpolation.GetWeights(weights.col(i), decomposition, users(i),
         neighborhood.col(i), similarities.col(i), cleanedData);
+  }
 
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
-    {
-      arma::vec neighborRatings;
-      decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
-    }
+  // The ratings are computed for blocks of users at once; the block size is
+  // chosen so that the ratings of a block take at most 32MB.
+  const size_t blockSize = std::max((size_t) 1, std::min((size_t) users.n_elem,
+      (size_t) 4194304 / std::max((size_t) cleanedData.n_rows, (size_t) 1)));
+  arma::Col<size_t> incomplete(users.n_elem, arma::fill::zeros);
+
+  for (size_t begin = 0; begin < users.n_elem; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) users.n_elem);
+
+    // First, calculate the weighted sum of neighborhood values.
+    arma::mat ratings(cleanedData.n_rows, end - begin);
+    GetRatingsOfBlock(decomposition, neighborhood.cols(begin, end - 1),
+        weights.cols(begin, end - 1), ratings, 0);
 
-    // Let's build the list of candidate recomendations for the given user.
-    // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
-    std::vector<Candidate> vect(numRecs, def);
-    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        CandidateList;
-    CandidateList pqueue(CandidateCmp(), std::move(vect));
+    // Denormalize the whole block of ratings before comparison.
+    const arma::Col<size_t> blockUsers = users.subvec(begin, end - 1);
+    normalization.Denormalize(blockUsers, ratings);
 
-    // Look through the ratings column corresponding to the current user.
-    for (size_t j = 0; j < ratings.n_rows; ++j)
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
     {
-      // Ensure that the user hasn't already rated the item.
-      // The algorithm omits rating of zero. Thus, when normalizing original
-      // ratings in Normalize(), if normalized rating equals zero, it is set
-      // to the smallest positive double value.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
+      const size_t user = users(i);
+
+      // Let's build the list of candidate recomendations for the given user.
+      // Default candidate: the smallest possible value and invalid item
+      // number.
+      const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
+      std::vector<Candidate> vect(numRecs, def);
+      typedef std::priority_queue<Candidate, std::vector<Candidate>,
+          CandidateCmp> CandidateList;
+      CandidateList pqueue(CandidateCmp(), std::move(vect));
+
+      // Look through the ratings column corresponding to the current user.
+      // The items the user has already rated are visited in order, alongside.
+      arma::sp_mat::const_iterator it = cleanedData.begin_col(user);
+      arma::sp_mat::const_iterator itEnd = cleanedData.end_col(user);
+      for (size_t j = 0; j < ratings.n_rows; ++j)
+      {
+        // Ensure that the user hasn't already rated the item.
+        // The algorithm omits rating of zero. Thus, when normalizing original
+        // ratings in Normalize(), if normalized rating equals zero, it is set
+        // to the smallest positive double value.
+        if (it != itEnd && it.row() == j)
+        {
+          ++it;
+          continue; // The user already rated the item.
+        }
+
+        // Is the estimated value better than the worst candidate?
+        const double realRating = ratings(j, i - begin);
+        if (realRating > pqueue.top().first)
+        {
+          Candidate c = std::make_pair(realRating, j);
+          pqueue.pop();
+          pqueue.push(c);
+        }
+      }
 
-      // Is the estimated value better than the worst candidate?
-      // Denormalize rating before comparison.
-      double realRating = normalization.Denormalize(users(i), j, ratings[j]);
-      if (realRating > pqueue.top().first)
+      for (size_t p = 1; p <= numRecs; p++)
       {
-        Candidate c = std::make_pair(realRating, j);
+        recommendations(numRecs - p, i) = pqueue.top().second;
         pqueue.pop();
-        pqueue.push(c);
       }
-    }
 
-    for (size_t p = 1; p <= numRecs; p++)
-    {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
+      if (recommendations(numRecs - 1, i) == def.second)
+        incomplete(i) = 1;
     }
+  }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
+    if (incomplete(i))
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
   }
 }
 
-// Predict the rating for a single user/item combination.
 template<typename DecompositionPolicy,
          typename NormalizationType>
 template<typename NeighborSearchPolicy,
@@ -297,8 +324,7 @@ Predict(const size_t user, const size_t item) const
   // Calculate the neighborhood of the queried users.
   arma::Col<size_t> users(1);
   users(0) = user;
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  GetNeighborhood<NeighborSearchPolicy>(users, neighborhood, similarities);
 
   arma::vec weights(numUsersForSimilarity);
 
@@ -317,6 +343,316 @@ Predict(const size_t user, const size_t item) const
   return realRating;
 }
 
+// Fold the ratings of new or existing users into the model.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInUsers(const arma::mat& data, const double lambda)
+{
+  if (data.n_cols == 0)
+    return;
+
+  if ((size_t) arma::max(data.row(1)) >= cleanedData.n_rows)
+  {
+    Log::Fatal << "CFType::FoldInUsers(): item " << arma::max(data.row(1))
+        << " is not in the model; fold it in with FoldInItems() first!"
+        << std::endl;
+  }
+
+  ClearNeighborhoodCache();
+
+  // Normalize the ratings with the statistics of the trained model.
+  arma::mat normalizedData(data);
+  normalization.FoldInUsers(normalizedData);
+  ReplaceRatings(normalizedData, true);
+
+  // New users start out with an empty user vector.
+  arma::mat& h = decomposition.H();
+  if (h.n_cols < cleanedData.n_cols)
+    h.resize(h.n_rows, cleanedData.n_cols);
+
+  SolveFoldIn(normalizedData, 0, decomposition.W().t(), lambda, h);
+}
+
+// Fold the ratings of new or existing items into the model.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInItems(const arma::mat& data, const double lambda)
+{
+  if (data.n_cols == 0)
+    return;
+
+  if ((size_t) arma::max(data.row(0)) >= cleanedData.n_cols)
+  {
+    Log::Fatal << "CFType::FoldInItems(): user " << arma::max(data.row(0))
+        << " is not in the model; fold it in with FoldInUsers() first!"
+        << std::endl;
+  }
+
+  ClearNeighborhoodCache();
+
+  // Normalize the ratings with the statistics of the trained model.
+  arma::mat normalizedData(data);
+  normalization.FoldInItems(normalizedData);
+  ReplaceRatings(normalizedData, false);
+
+  // The item vectors are the rows of W; new items start out empty.
+  arma::mat& w = decomposition.W();
+  arma::mat wt = w.t();
+  if (wt.n_cols < cleanedData.n_rows)
+    wt.resize(wt.n_rows, cleanedData.n_rows);
+
+  SolveFoldIn(normalizedData, 1, decomposition.H(), lambda, wt);
+  w = wt.t();
+}
+
+// Replace the ratings of some users or items in the cleaned data.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+ReplaceRatings(const arma::mat& normalizedData, const bool users)
+{
+  const size_t numItems = std::max((size_t) cleanedData.n_rows,
+      (size_t) arma::max(normalizedData.row(1)) + 1);
+  const size_t numUsers = std::max((size_t) cleanedData.n_cols,
+      (size_t) arma::max(normalizedData.row(0)) + 1);
+
+  // Mark the users (or items) whose ratings are replaced.
+  std::vector<bool> replaced(users ? numUsers : numItems, false);
+  for (size_t i = 0; i < normalizedData.n_cols; ++i)
+    replaced[(size_t) normalizedData(users ? 0 : 1, i)] = true;
+
+  // Keep all other ratings, and rebuild the matrix with one batch insert.
+  size_t kept = 0;
+  arma::sp_mat::const_iterator it = cleanedData.begin();
+  for (; it != cleanedData.end(); ++it)
+    if (!replaced[users ? it.col() : it.row()])
+      ++kept;
+
+  arma::umat locations(2, kept + normalizedData.n_cols);
+  arma::vec values(kept + normalizedData.n_cols);
+  size_t index = 0;
+  for (it = cleanedData.begin(); it != cleanedData.end(); ++it)
+  {
+    if (replaced[users ? it.col() : it.row()])
+      continue;
+
+    locations(0, index) = it.row();
+    locations(1, index) = it.col();
+    values(index++) = *it;
+  }
+
+  for (size_t i = 0; i < normalizedData.n_cols; ++i, ++index)
+  {
+    // Items are rows, and users are columns.
+    locations(0, index) = (arma::uword) normalizedData(1, i);
+    locations(1, index) = (arma::uword) normalizedData(0, i);
+    values(index) = normalizedData(2, i);
+  }
+
+  cleanedData = arma::sp_mat(locations, values, numItems, numUsers);
+}
+
+// Solve the least-squares problems of folded in users or items.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+SolveFoldIn(const arma::mat& normalizedData,
+            const size_t keyRow,
+            const arma::mat& factors,
+            const double lambda,
+            arma::mat& result)
+{
+  // Group the ratings by the ID to solve for.
+  const arma::uvec order = arma::stable_sort_index(normalizedData.row(keyRow));
+  std::vector<size_t> starts;
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    if (i == 0 || normalizedData(keyRow, order[i]) !=
+        normalizedData(keyRow, order[i - 1]))
+      starts.push_back(i);
+  }
+  starts.push_back(order.n_elem);
+
+  const size_t otherRow = 1 - keyRow;
+  const size_t rank = factors.n_rows;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t g = 0; g < (omp_size_t) starts.size() - 1; ++g)
+  {
+    const size_t begin = starts[g];
+    const size_t count = starts[g + 1] - begin;
+    const size_t key = (size_t) normalizedData(keyRow, order[begin]);
+
+    // Minimize || r - F^T x ||^2 + lambda || x ||^2 over the observed
+    // ratings r, where the columns of F are the fixed factors.
+    arma::mat observed(rank, count);
+    arma::vec ratings(count);
+    for (size_t k = 0; k < count; ++k)
+    {
+      const size_t point = order[begin + k];
+      observed.col(k) = factors.col((size_t) normalizedData(otherRow, point));
+      ratings[k] = normalizedData(2, point);
+    }
+
+    arma::mat a = observed * observed.t();
+    a.diag() += lambda;
+    arma::vec x;
+    if (!arma::solve(x, a, observed * ratings))
+      x = arma::pinv(a) * (observed * ratings);
+    result.col(key) = x;
+  }
+}
+
+// Build the index over the item vectors.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+BuildItemIndex(ItemIndexType& index) const
+{
+  arma::mat items;
+  decomposition.GetItemVectors(items);
+  index.Train(std::move(items));
+}
+
+// Generate recommendations for the given users with the item index.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRecommendations(const size_t numRecs,
+                   arma::Mat<size_t>& recommendations,
+                   const arma::Col<size_t>& users,
+                   ItemIndexType& index)
+{
+  // Temporary storage for neighborhood of the queried users.
+  arma::Mat<size_t> neighborhood;
+  // Resulting similarities.
+  arma::mat similarities;
+
+  // Calculate the neighborhood of the queried users, as in the other overload.
+  GetNeighborhood<NeighborSearchPolicy>(users, neighborhood, similarities);
+
+  // Calculate interpolation weights.
+  InterpolationPolicy interpolation(cleanedData);
+  arma::mat weights(numUsersForSimilarity, users.n_elem);
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
+    interpolation.GetWeights(weights.col(i), decomposition, users(i),
+        neighborhood.col(i), similarities.col(i), cleanedData);
+  }
+
+  arma::mat queries;
+  decomposition.GetUserVectors(neighborhood, weights, queries);
+
+  // The items the users have already rated may be among the best ones, so
+  // enough items are retrieved to skip all of them.
+  size_t maxRated = 0;
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
+    maxRated = std::max(maxRated, (size_t) (cleanedData.col_ptrs[users(i) + 1]
+        - cleanedData.col_ptrs[users(i)]));
+  }
+  const size_t k = std::min((size_t) cleanedData.n_rows, numRecs + maxRated);
+
+  arma::Mat<size_t> indices;
+  arma::mat kernels;
+  index.Search(queries, k, indices, kernels);
+
+  recommendations.set_size(numRecs, users.n_elem);
+  recommendations.fill(SIZE_MAX);
+  arma::Col<size_t> incomplete(users.n_elem, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
+  {
+    // The rated items of the user are the sorted rows of its column.
+    const arma::uword* ratedBegin = cleanedData.row_indices +
+        cleanedData.col_ptrs[users(i)];
+    const arma::uword* ratedEnd = cleanedData.row_indices +
+        cleanedData.col_ptrs[users(i) + 1];
+
+    size_t found = 0;
+    for (size_t j = 0; j < k && found < numRecs; ++j)
+    {
+      if (indices(j, i) == SIZE_MAX)
+        break;
+      if (std::binary_search(ratedBegin, ratedEnd, indices(j, i)))
+        continue; // The user already rated the item.
+
+      recommendations(found++, i) = indices(j, i);
+    }
+
+    if (found < numRecs)
+    {
+      recommendations.col(i).tail(numRecs - found).fill(cleanedData.n_rows);
+      incomplete(i) = 1;
+    }
+  }
+
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; i++)
+  {
+    if (incomplete(i))
+      Log::Warn << "Could not provide " << numRecs << " recommendations "
+          << "for user " << users(i) << " (not enough un-rated items)!"
+          << std::endl;
+  }
+}
+
+// Compute the ratings of a block of users with a single product.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename PolicyType>
+auto CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRatingsOfBlock(const PolicyType& decomposition,
+                  const arma::Mat<size_t>& neighborhood,
+                  const arma::mat& weights,
+                  arma::mat& ratings,
+                  const int /* preferred */)
+    -> decltype(decomposition.GetRatingOfUsers(neighborhood, weights,
+        ratings), void())
+{
+  decomposition.GetRatingOfUsers(neighborhood, weights, ratings);
+}
+
+// Compute the ratings of a block of users one user at a time.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename PolicyType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRatingsOfBlock(const PolicyType& decomposition,
+                  const arma::Mat<size_t>& neighborhood,
+                  const arma::mat& weights,
+                  arma::mat& ratings,
+                  const long /* fallback */)
+{
+  // The ratings matrix has already been given the size of the block.
+  ratings.zeros();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) neighborhood.n_cols; ++i)
+  {
+    arma::vec neighborRatings;
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+    {
+      decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
+      ratings.col(i) += weights(j, i) * neighborRatings;
+    }
+  }
+}
+
 // Predict the rating for a group of user/item combinations.
 template<typename DecompositionPolicy,
          typename NormalizationType>
@@ -348,8 +684,7 @@ Predict(const arma::Mat<size_t>& combinations,
   // weighted sum of both the query user and the local neighborhood of the
   // query user.
   // Calculate the neighborhood of the queried users.
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  GetNeighborhood<NeighborSearchPolicy>(users, neighborhood, similarities);
 
   arma::mat weights(numUsersForSimilarity, users.n_elem);
 
@@ -436,6 +771,45 @@ serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(decomposition);
   ar & BOOST_SERIALIZATION_NVP(cleanedData);
   ar & BOOST_SERIALIZATION_NVP(normalization);
+
+  if (Archive::is_loading::value)
+    ClearNeighborhoodCache();
+}
+
+// Get the neighborhoods of some users from the cache.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetNeighborhood(const arma::Col<size_t>& users,
+                arma::Mat<size_t>& neighborhood,
+                arma::mat& similarities) const
+{
+  // Recommendations may be computed from several threads at once, so only one
+  // of them builds the cache.  The columns are copied before the section is
+  // left, since a query with another policy may rebuild the cache after that.
+  #pragma omp critical(cf_neighborhood_cache)
+  {
+    if (cachedPolicy == NULL || *cachedPolicy != typeid(NeighborSearchPolicy))
+    {
+      // One search over all the users is much cheaper than building the
+      // reference tree again for every query.
+      const arma::Col<size_t> allUsers = arma::linspace<arma::Col<size_t>>(0,
+          cleanedData.n_cols - 1, cleanedData.n_cols);
+      decomposition.template GetNeighborhood<NeighborSearchPolicy>(allUsers,
+          numUsersForSimilarity, cachedNeighborhood, cachedSimilarities);
+      cachedPolicy = &typeid(NeighborSearchPolicy);
+    }
+
+    neighborhood.set_size(cachedNeighborhood.n_rows, users.n_elem);
+    similarities.set_size(cachedSimilarities.n_rows, users.n_elem);
+    for (size_t i = 0; i < users.n_elem; ++i)
+    {
+      neighborhood.col(i) = cachedNeighborhood.col(users[i]);
+      similarities.col(i) = cachedSimilarities.col(users[i]);
+    }
+  }
 }
 
 } // namespace cf
@@ -24,6 +24,7 @@
 #include <mlpack/methods/cf/decomposition_policies/svd_incomplete_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/bias_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/svdplusplus_method.hpp>
+#include <mlpack/methods/cf/decomposition_policies/als_method.hpp>
 
 using namespace mlpack;
 using namespace mlpack::cf;
@@ -71,6 +72,7 @@ PROGRAM_INFO("Collaborative Filtering", "This program performs collaborative "
     " - 'SVDCompleteIncremental' -- SVD complete incremental learning\n"
     " - 'BiasSVD' -- Bias SVD using a SGD optimizer\n"
     " - 'SVDPP' -- SVD++ using a SGD optimizer\n"
+    " - 'ALS' -- Alternating least squares on the observed ratings only\n"
     "\n"
     "A trained model may be saved to with the " +
     PRINT_PARAM_STRING("output_model") + " output parameter."
@@ -262,6 +264,10 @@ void AssembleFactorizerType(const std::string& algorithm,
         "when max_iterations is reached");
     PerformAction<SVDPlusPlusPolicy>(dataset, rank, maxIterations, minResidue);
   }
+  else if (algorithm == "ALS")
+  {
+    PerformAction<ALSPolicy>(dataset, rank, maxIterations, minResidue);
+  }
 }
 
 static void mlpackMain()
@@ -285,7 +291,7 @@ static void mlpackMain()
 
   RequireParamInSet<string>("algorithm", { "NMF", "BatchSVD",
       "SVDIncompleteIncremental", "SVDCompleteIncremental", "RegSVD",
-      "RandSVD", "BiasSVD", "SVDPP" }, true, "unknown algorithm");
+      "RandSVD", "BiasSVD", "SVDPP", "ALS" }, true, "unknown algorithm");
 
   ReportIgnoredParam({{ "iteration_only_termination", true }}, "min_residue");
 
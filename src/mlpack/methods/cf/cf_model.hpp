@@ -23,6 +23,7 @@
 #include <mlpack/methods/cf/decomposition_policies/svd_incomplete_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/bias_svd_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/svdplusplus_method.hpp>
+#include <mlpack/methods/cf/decomposition_policies/als_method.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -100,6 +101,40 @@ class RecommendationVisitor : public boost::static_visitor<void>
   void operator()(CFType<DecompositionPolicy>* c) const;
 };
 
+/**
+ * FoldInVisitor folds the given ratings of users or items into the CFType
+ * object.  This throws an exception if the decomposition policy does not
+ * support it.
+ */
+class FoldInVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! Ratings to fold in, as a (user, item, rating) table.
+  const arma::mat& data;
+  //! Whether users (or items) are folded in.
+  const bool users;
+  //! Regularization parameter of the least-squares problems.
+  const double lambda;
+
+  //! Fold in the ratings, if the decomposition policy supports it.
+  template<typename DecompositionPolicy>
+  auto FoldIn(CFType<DecompositionPolicy>* c, const int /* supported */) const
+      -> decltype(std::declval<DecompositionPolicy&>().W() = arma::mat(),
+          void());
+
+  //! Throw an exception for decomposition policies that don't support it.
+  template<typename DecompositionPolicy>
+  void FoldIn(CFType<DecompositionPolicy>* c, const long /* fallback */) const;
+
+ public:
+  //! Visitor constructor.
+  FoldInVisitor(const arma::mat& data, const bool users, const double lambda);
+
+  //! Fold in the ratings.
+  template<typename DecompositionPolicy>
+  void operator()(CFType<DecompositionPolicy>* c) const;
+};
+
 /**
  * The model to save to disk.
  */
@@ -118,7 +153,8 @@ class CFModel
                  CFType<SVDCompletePolicy>*,
                  CFType<SVDIncompletePolicy>*,
                  CFType<BiasSVDPolicy>*,
-                 CFType<SVDPlusPlusPolicy>*> cf;
+                 CFType<SVDPlusPlusPolicy>*,
+                 CFType<ALSPolicy>*> cf;
 
  public:
   //! Create an empty CF model.
@@ -154,6 +190,12 @@ class CFModel
   void GetRecommendations(const size_t numRecs,
                           arma::Mat<size_t>& recommendations);
 
+  //! Fold the ratings of new or existing users into the model.
+  void FoldInUsers(const arma::mat& data, const double lambda = 0.01);
+
+  //! Fold the ratings of new or existing items into the model.
+  void FoldInItems(const arma::mat& data, const double lambda = 0.01);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -79,6 +79,45 @@ void RecommendationVisitor::operator()(CFType<DecompositionPolicy>* c) const
     c->GetRecommendations(numRecs, recommendations);
 }
 
+FoldInVisitor::FoldInVisitor(const arma::mat& data,
+                             const bool users,
+                             const double lambda) :
+    data(data),
+    users(users),
+    lambda(lambda)
+{ }
+
+template<typename DecompositionPolicy>
+auto FoldInVisitor::FoldIn(CFType<DecompositionPolicy>* c,
+                           const int /* supported */) const
+    -> decltype(std::declval<DecompositionPolicy&>().W() = arma::mat(), void())
+{
+  if (users)
+    c->FoldInUsers(data, lambda);
+  else
+    c->FoldInItems(data, lambda);
+}
+
+template<typename DecompositionPolicy>
+void FoldInVisitor::FoldIn(CFType<DecompositionPolicy>* /* c */,
+                           const long /* fallback */) const
+{
+  throw std::invalid_argument("the decomposition policy of this cf model does "
+      "not support folding in users or items");
+}
+
+template<typename DecompositionPolicy>
+void FoldInVisitor::operator()(CFType<DecompositionPolicy>* c) const
+{
+  if (!c)
+  {
+    throw std::runtime_error("no cf model initialized");
+    return;
+  }
+
+  FoldIn(c, 0);
+}
+
 CFModel::~CFModel()
 {
   boost::apply_visitor(DeleteVisitor(), cf);
@@ -128,6 +167,20 @@ void CFModel::GetRecommendations(const size_t numRecs,
   boost::apply_visitor(recommendation, cf);
 }
 
+//! Fold the ratings of new or existing users into the model.
+void CFModel::FoldInUsers(const arma::mat& data, const double lambda)
+{
+  FoldInVisitor foldIn(data, true, lambda);
+  boost::apply_visitor(foldIn, cf);
+}
+
+//! Fold the ratings of new or existing items into the model.
+void CFModel::FoldInItems(const arma::mat& data, const double lambda)
+{
+  FoldInVisitor foldIn(data, false, lambda);
+  boost::apply_visitor(foldIn, cf);
+}
+
 template<typename DecompositionPolicy>
 const CFType<DecompositionPolicy>* CFModel::CFPtr() const
 {
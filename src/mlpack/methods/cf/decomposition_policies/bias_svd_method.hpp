@@ -106,6 +106,71 @@ class BiasSVDPolicy
     rating = w * h.col(user) + p + q(user);
   }
 
+  /**
+   * Get predicted ratings for a set of weighted combinations of users at once.
+   * Column i of the result holds the ratings of the users in column i of
+   * neighbors, weighted by column i of weights and summed.  The latent
+   * vectors are combined first, so all the ratings are a single product.
+   *
+   * @param neighbors Users to combine (one combination per column).
+   * @param weights Weights of the users in each combination.
+   * @param ratings Resulting rating matrix.
+   */
+  void GetRatingOfUsers(const arma::Mat<size_t>& neighbors,
+                        const arma::mat& weights,
+                        arma::mat& ratings) const
+  {
+    arma::mat combined(h.n_rows, neighbors.n_cols, arma::fill::zeros);
+    arma::rowvec userBias(neighbors.n_cols, arma::fill::zeros);
+    for (size_t i = 0; i < neighbors.n_cols; ++i)
+    {
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+      {
+        combined.col(i) += weights(j, i) * h.col(neighbors(j, i));
+        userBias(i) += weights(j, i) * q(neighbors(j, i));
+      }
+    }
+
+    // Each combination also gets the weighted sum of the biases.
+    ratings = w * combined + p * arma::sum(weights);
+    ratings.each_row() += userBias;
+  }
+
+  /**
+   * Get the vectors of all items, for maximum inner product search.  The
+   * rating of an item for a user is the inner product of the item vector and
+   * the user vector (see GetUserVectors()), plus the bias of the user.  The
+   * last element of each item vector is the bias of the item.
+   *
+   * @param items Resulting item vectors (one per column).
+   */
+  void GetItemVectors(arma::mat& items) const
+  {
+    items = arma::join_cols(w.t(), p.t());
+  }
+
+  /**
+   * Get the vectors of a set of weighted combinations of users, for maximum
+   * inner product search against the vectors of GetItemVectors().  The bias
+   * of the users does not change the order of the items, so it is left out.
+   *
+   * @param neighbors Users to combine (one combination per column).
+   * @param weights Weights of the users in each combination.
+   * @param users Resulting user vectors (one per column).
+   */
+  void GetUserVectors(const arma::Mat<size_t>& neighbors,
+                      const arma::mat& weights,
+                      arma::mat& users) const
+  {
+    users.zeros(h.n_rows + 1, neighbors.n_cols);
+    for (size_t i = 0; i < neighbors.n_cols; ++i)
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+        users.col(i).head(h.n_rows) += weights(j, i) * h.col(neighbors(j, i));
+
+    // The item biases are weighted by the total weight of each combination.
+    users.row(h.n_rows) = arma::sum(weights);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -113,6 +113,55 @@ class RandomizedSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get predicted ratings for a set of weighted combinations of users at once.
+   * Column i of the result holds the ratings of the users in column i of
+   * neighbors, weighted by column i of weights and summed.  The latent
+   * vectors are combined first, so all the ratings are a single product.
+   *
+   * @param neighbors Users to combine (one combination per column).
+   * @param weights Weights of the users in each combination.
+   * @param ratings Resulting rating matrix.
+   */
+  void GetRatingOfUsers(const arma::Mat<size_t>& neighbors,
+                        const arma::mat& weights,
+                        arma::mat& ratings) const
+  {
+    arma::mat combined;
+    GetUserVectors(neighbors, weights, combined);
+    ratings = w * combined;
+  }
+
+  /**
+   * Get the vectors of all items, for maximum inner product search.  The
+   * rating of an item for a user is the inner product of the item vector and
+   * the user vector (see GetUserVectors()).
+   *
+   * @param items Resulting item vectors (one per column).
+   */
+  void GetItemVectors(arma::mat& items) const
+  {
+    items = w.t();
+  }
+
+  /**
+   * Get the vectors of a set of weighted combinations of users, for maximum
+   * inner product search against the vectors of GetItemVectors().
+   *
+   * @param neighbors Users to combine (one combination per column).
+   * @param weights Weights of the users in each combination.
+   * @param users Resulting user vectors (one per column).
+   */
+  void GetUserVectors(const arma::Mat<size_t>& neighbors,
+                      const arma::mat& weights,
+                      arma::mat& users) const
+  {
+    users.zeros(h.n_rows, neighbors.n_cols);
+    for (size_t i = 0; i < neighbors.n_cols; ++i)
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+        users.col(i) += weights(j, i) * h.col(neighbors(j, i));
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -154,8 +203,12 @@ class RandomizedSVDPolicy
 
   //! Get the Item Matrix.
   const arma::mat& W() const { return w; }
+  //! Modify the Item Matrix.
+  arma::mat& W() { return w; }
   //! Get the User Matrix.
   const arma::mat& H() const { return h; }
+  //! Modify the User Matrix.
+  arma::mat& H() { return h; }
 
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
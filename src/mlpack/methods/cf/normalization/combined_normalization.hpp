@@ -60,6 +60,28 @@ class CombinedNormalization
     SequenceNormalize<0>(data);
   }
 
+  /**
+   * Normalize the ratings of users that are folded into a trained model by
+   * calling FoldInUsers() in each normalization object.
+   *
+   * @param data Ratings of the users in the form of coordinate list.
+   */
+  void FoldInUsers(arma::mat& data)
+  {
+    SequenceFoldIn<0>(data, true);
+  }
+
+  /**
+   * Normalize the ratings of items that are folded into a trained model by
+   * calling FoldInItems() in each normalization object.
+   *
+   * @param data Ratings of the items in the form of coordinate list.
+   */
+  void FoldInItems(arma::mat& data)
+  {
+    SequenceFoldIn<0>(data, false);
+  }
+
   /**
    * Denormalize rating by calling Denormalize() in each normalization object.
    * Note that the order of objects calling Denormalize() should be the
@@ -90,6 +112,18 @@ class CombinedNormalization
     SequenceDenormalize<0>(combinations, predictions);
   }
 
+  /**
+   * Denormalize a block of ratings by calling Denormalize() in each
+   * normalization object, in the reversed order of Normalize().
+   *
+   * @param users Users of the columns of the block.
+   * @param ratings Computed ratings before denormalization.
+   */
+  void Denormalize(const arma::Col<size_t>& users, arma::mat& ratings) const
+  {
+    SequenceDenormalize<0>(users, ratings);
+  }
+
   /**
    * Return normalizations tuple.
    */
@@ -130,6 +164,26 @@ class CombinedNormalization
       typename = void>
   void SequenceNormalize(MatType& /* data */) { }
 
+  //! Unpack normalizations tuple to normalize folded in ratings.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I < std::tuple_size<TupleType>::value)>>
+  void SequenceFoldIn(arma::mat& data, const bool users)
+  {
+    if (users)
+      std::get<I>(normalizations).FoldInUsers(data);
+    else
+      std::get<I>(normalizations).FoldInItems(data);
+    SequenceFoldIn<I+1>(data, users);
+  }
+
+  //! End of tuple unpacking.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I >= std::tuple_size<TupleType>::value)>,
+      typename = void>
+  void SequenceFoldIn(arma::mat& /* data */, const bool /* users */) { }
+
   //! Unpack normalizations tuple to denormalize.
   template<
       int I, /* Which normalization in tuple to use */
@@ -179,6 +233,27 @@ class CombinedNormalization
   void SequenceDenormalize(const arma::Mat<size_t>& /* combinations */,
                            arma::vec& /* predictions */) const { }
 
+  //! Unpack normalizations tuple to denormalize a block of ratings.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I < std::tuple_size<TupleType>::value)>>
+  void SequenceDenormalize(const arma::Col<size_t>& users,
+                           arma::mat& ratings) const
+  {
+    // The order of denormalization should be the reversed order
+    // of normalization.
+    SequenceDenormalize<I+1>(users, ratings);
+    std::get<I>(normalizations).Denormalize(users, ratings);
+  }
+
+  //! End of tuple unpacking.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I >= std::tuple_size<TupleType>::value)>,
+      typename = void>
+  void SequenceDenormalize(const arma::Col<size_t>& /* users */,
+                           arma::mat& /* ratings */) const { }
+
   //! Unpack normalizations tuple to serialize.
   template<
       int I, /* Which normalization in tuple to serialize */
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_CF_NORMALIZATION_ITEM_MEAN_NORMALIZATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "rating_statistics.hpp"
 
 namespace mlpack {
 namespace cf {
@@ -50,35 +51,20 @@ class ItemMeanNormalization
   void Normalize(arma::mat& data)
   {
     const size_t itemNum = arma::max(data.row(1)) + 1;
-    itemMean = arma::vec(itemNum, arma::fill::zeros);
-    // Number of ratings for each item.
-    arma::Row<size_t> ratingNum(itemNum, arma::fill::zeros);
-
-    // Sum ratings for each item.
-    data.each_col([&](arma::vec& datapoint)
-    {
-      const size_t item = (size_t) datapoint(1);
-      const double rating = datapoint(2);
-      itemMean(item) += rating;
-      ratingNum(item) += 1;
-    });
+    // Sum the ratings of each item and count them, in one parallel pass.
+    arma::vec ratingNum;
+    GroupRatingSums(data, 1, itemNum, itemMean, ratingNum);
 
     // Calculate item mean and subtract item mean from ratings.
     // Set item mean to 0 if the item has no rating.
-    for (size_t i = 0; i < itemNum; i++)
-    {
-      if (ratingNum(i) != 0)
-        itemMean(i) /= ratingNum(i);
-    }
+    const arma::uvec rated = arma::find(ratingNum);
+    itemMean.elem(rated) /= ratingNum.elem(rated);
 
-    data.each_col([&](arma::vec& datapoint)
+    TransformRatings(data, [&](const size_t /* user */,
+                               const size_t item,
+                               const double rating)
     {
-      const size_t item = (size_t) datapoint(1);
-      datapoint(2) -= itemMean(item);
-      // The algorithm omits rating of zero. If normalized rating equals zero,
-      // it is set to the smallest positive double value.
-      if (datapoint(2) == 0)
-        datapoint(2) = std::numeric_limits<double>::min();
+      return rating - itemMean(item);
     });
   }
 
@@ -90,31 +76,76 @@ class ItemMeanNormalization
   void Normalize(arma::sp_mat& cleanedData)
   {
     // Calculate itemMean.
-    itemMean = arma::vec(cleanedData.n_rows, arma::fill::zeros);
-    arma::Col<size_t> ratingNum(cleanedData.n_rows, arma::fill::zeros);
-    arma::sp_mat::iterator it = cleanedData.begin();
-    arma::sp_mat::iterator it_end = cleanedData.end();
-    for (; it != it_end; ++it)
+    arma::vec ratingNum;
+    GroupRatingSums(cleanedData, false, itemMean, ratingNum);
+    const arma::uvec rated = arma::find(ratingNum);
+    itemMean.elem(rated) /= ratingNum.elem(rated);
+
+    // Normalize the data.
+    TransformRatings(cleanedData, [&](const size_t /* user */,
+                                      const size_t item,
+                                      const double rating)
     {
-      itemMean(it.row()) += *it;
-      ratingNum(it.row()) += 1;
+      return rating - itemMean(item);
+    });
+  }
+
+  /**
+   * Normalize the ratings of items that are folded into a trained model.
+   * The mean of each of the given items is recomputed from the given
+   * ratings, which must be all the ratings of those items.
+   *
+   * @param data Ratings of the items in the form of coordinate list.
+   */
+  void FoldInItems(arma::mat& data)
+  {
+    const size_t num = std::max((size_t) itemMean.n_elem,
+        (size_t) arma::max(data.row(1)) + 1);
+    itemMean.resize(num);
+
+    // Recompute the means of the given items only.
+    arma::vec sums(num, arma::fill::zeros);
+    arma::Col<size_t> ratingNum(num, arma::fill::zeros);
+    for (size_t i = 0; i < data.n_cols; i++)
+    {
+      sums((size_t) data(1, i)) += data(2, i);
+      ratingNum((size_t) data(1, i)) += 1;
     }
-    for (size_t i = 0; i < itemMean.n_elem; i++)
+    for (size_t i = 0; i < num; i++)
     {
       if (ratingNum(i) != 0)
-        itemMean(i) /= ratingNum(i);
+        itemMean(i) = sums(i) / ratingNum(i);
     }
 
-    // Normalize the data.
-    it = cleanedData.begin();
-    for (; it != cleanedData.end(); ++it)
+    data.each_col([&](arma::vec& datapoint)
     {
-      *it = *it - itemMean(it.row());
+      datapoint(2) -= itemMean((size_t) datapoint(1));
       // The algorithm omits rating of zero. If normalized rating equals zero,
       // it is set to the smallest positive double value.
-      if (*it == 0)
-        *it = std::numeric_limits<double>::min();
-    }
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
+  }
+
+  /**
+   * Normalize the ratings of users that are folded into a trained
+   * model.  The item means are kept fixed (items that are new to the model
+   * have a mean of zero).
+   *
+   * @param data Ratings of the users in the form of coordinate list.
+   */
+  void FoldInUsers(arma::mat& data) const
+  {
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      if (item < itemMean.n_elem)
+        datapoint(2) -= itemMean(item);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
   }
 
   /**
@@ -140,11 +171,21 @@ class ItemMeanNormalization
   void Denormalize(const arma::Mat<size_t>& combinations,
                    arma::vec& predictions) const
   {
-    for (size_t i = 0; i < predictions.n_elem; i++)
-    {
-      const size_t item = combinations(1, i);
-      predictions(i) += itemMean(item);
-    }
+    predictions += itemMean.elem(
+        arma::conv_to<arma::uvec>::from(combinations.row(1)));
+  }
+
+  /**
+   * Denormalize a block of computed ratings by adding item mean, where
+   * ratings(i, j) is the rating of item i by user users(j).
+   *
+   * @param users Users of the columns of the block.
+   * @param ratings Computed ratings before denormalization.
+   */
+  void Denormalize(const arma::Col<size_t>& /* users */,
+                   arma::mat& ratings) const
+  {
+    ratings.each_col() += itemMean;
   }
 
   /**
@@ -36,6 +36,20 @@ class NoNormalization
   template<typename MatType>
   inline void Normalize(const MatType& /* data */) const { }
 
+  /**
+   * Do nothing.
+   *
+   * @param data Ratings of the users to fold in.
+   */
+  inline void FoldInUsers(const arma::mat& /* data */) const { }
+
+  /**
+   * Do nothing.
+   *
+   * @param data Ratings of the items to fold in.
+   */
+  inline void FoldInItems(const arma::mat& /* data */) const { }
+
   /**
    * Do nothing.
    *
@@ -60,6 +74,16 @@ class NoNormalization
                           const arma::vec& /* predictions */) const
   { }
 
+  /**
+   * Do nothing.
+   *
+   * @param users Users of the columns of the block.
+   * @param ratings Block of computed ratings.
+   */
+  inline void Denormalize(const arma::Col<size_t>& /* users */,
+                          const arma::mat& /* ratings */) const
+  { }
+
   /**
    * Serialization.
    */
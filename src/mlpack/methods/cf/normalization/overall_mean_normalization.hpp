@@ -90,6 +90,32 @@ class OverallMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of users that are folded into a trained model by
+   * subtracting the mean of the original ratings, which is kept fixed.
+   *
+   * @param data Ratings of the users in the form of coordinate list.
+   */
+  void FoldInUsers(arma::mat& data) const
+  {
+    data.row(2) -= mean;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive double value.
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<double>::min();
+    });
+  }
+
+  /**
+   * Normalize the ratings of items that are folded into a trained model.  The
+   * mean is kept fixed, so this is the same as FoldInUsers().
+   *
+   * @param data Ratings of the items in the form of coordinate list.
+   */
+  void FoldInItems(arma::mat& data) const { FoldInUsers(data); }
+
   /**
    * Denormalize computed rating by adding mean.
    *
@@ -116,6 +142,18 @@ class OverallMeanNormalization
     predictions += mean;
   }
 
+  /**
+   * Denormalize a block of computed ratings by adding mean.
+   *
+   * @param users Users of the columns of the block.
+   * @param ratings Computed ratings before denormalization.
+   */
+  void Denormalize(const arma::Col<size_t>& /* users */,
+                   arma::mat& ratings) const
+  {
+    ratings += mean;
+  }
+
   /**
    * Return mean.
    */
@@ -0,0 +1,246 @@
+/**
+ * @file rating_statistics.hpp
+ *
+ * Parallel passes over the ratings of a coordinate list or of a sparse rating
+ * matrix, shared by the normalization classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_NORMALIZATION_RATING_STATISTICS_HPP
+#define MLPACK_METHODS_CF_NORMALIZATION_RATING_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Return the number of chunks a pass over n elements is split into: one chunk
+ * per thread, with at least 65536 elements in each chunk.
+ */
+inline size_t RatingChunks(const size_t n)
+{
+  return std::max((size_t) 1, std::min(Threads::Count(), n / 65536));
+}
+
+//! Return the index of the first element of the given chunk of n elements.
+inline size_t ChunkBegin(const size_t chunk,
+                         const size_t numChunks,
+                         const size_t n)
+{
+  return (n * chunk) / numChunks;
+}
+
+/**
+ * Compute the sum and the number of the ratings of each user (if row is 0) or
+ * of each item (if row is 1) of the given coordinate list, in one parallel
+ * pass.  Each chunk of the list is accumulated into its own column, and the
+ * columns are added at the end.
+ *
+ * @param data Ratings in the form of coordinate list.
+ * @param row Row of the coordinate list that holds the group of each rating.
+ * @param numGroups Number of users or items.
+ * @param sums Vector to store the sum of the ratings of each group in.
+ * @param counts Vector to store the number of ratings of each group in.
+ */
+inline void GroupRatingSums(const arma::mat& data,
+                            const size_t row,
+                            const size_t numGroups,
+                            arma::vec& sums,
+                            arma::vec& counts)
+{
+  const size_t numChunks = RatingChunks(data.n_cols);
+  arma::mat chunkSums(numGroups, numChunks, arma::fill::zeros);
+  arma::mat chunkCounts(numGroups, numChunks, arma::fill::zeros);
+
+  Threads::ParallelFor(0, numChunks, [&](const size_t c)
+  {
+    const size_t end = ChunkBegin(c + 1, numChunks, data.n_cols);
+    for (size_t i = ChunkBegin(c, numChunks, data.n_cols); i < end; ++i)
+    {
+      const size_t group = (size_t) data(row, i);
+      chunkSums(group, c) += data(2, i);
+      chunkCounts(group, c) += 1;
+    }
+  });
+
+  sums = arma::sum(chunkSums, 1);
+  counts = arma::sum(chunkCounts, 1);
+}
+
+/**
+ * Compute the sum and the number of the ratings of each user (if users is
+ * true) or of each item of the given sparse matrix, where each column holds
+ * the ratings of one user, in one parallel pass over chunks of users.
+ *
+ * @param data Ratings as a sparse matrix.
+ * @param users Whether to sum the ratings of each user or of each item.
+ * @param sums Vector to store the sum of the ratings of each group in.
+ * @param counts Vector to store the number of ratings of each group in.
+ */
+inline void GroupRatingSums(const arma::sp_mat& data,
+                            const bool users,
+                            arma::vec& sums,
+                            arma::vec& counts)
+{
+  // The ratings of a user are all in the same chunk, so users can be summed
+  // in place; items need an accumulator for each chunk.
+  const size_t numChunks = std::max((size_t) 1, std::min(
+      RatingChunks(data.n_nonzero), (size_t) data.n_cols));
+  const size_t numGroups = users ? data.n_cols : data.n_rows;
+  arma::mat chunkSums(numGroups, users ? 1 : numChunks, arma::fill::zeros);
+  arma::mat chunkCounts(numGroups, users ? 1 : numChunks, arma::fill::zeros);
+
+  Threads::ParallelFor(0, numChunks, [&](const size_t c)
+  {
+    const size_t begin = ChunkBegin(c, numChunks, data.n_cols);
+    const size_t end = ChunkBegin(c + 1, numChunks, data.n_cols);
+    if (begin == end)
+      return;
+
+    const size_t column = users ? 0 : c;
+    arma::sp_mat::const_iterator it = data.begin_col(begin);
+    arma::sp_mat::const_iterator itEnd = data.end_col(end - 1);
+    for (; it != itEnd; ++it)
+    {
+      const size_t group = users ? it.col() : it.row();
+      chunkSums(group, column) += *it;
+      chunkCounts(group, column) += 1;
+    }
+  });
+
+  sums = arma::sum(chunkSums, 1);
+  counts = arma::sum(chunkCounts, 1);
+}
+
+/**
+ * Compute the mean and the standard deviation (normalized by n - 1, like
+ * arma::stddev()) of the given ratings in one parallel pass.  Each chunk
+ * computes its mean and its sum of squared deviations with Welford's update,
+ * and the chunks are merged with the pairwise update of Chan et al.
+ *
+ * @param ratings Pointer to the first rating.
+ * @param n Number of ratings.
+ * @param stride Distance between two consecutive ratings.
+ * @param mean Variable to store the mean in.
+ * @param stddev Variable to store the standard deviation in.
+ */
+inline void RatingMoments(const double* ratings,
+                          const size_t n,
+                          const size_t stride,
+                          double& mean,
+                          double& stddev)
+{
+  const size_t numChunks = RatingChunks(n);
+  arma::vec chunkMeans(numChunks, arma::fill::zeros);
+  arma::vec chunkSquares(numChunks, arma::fill::zeros);
+
+  Threads::ParallelFor(0, numChunks, [&](const size_t c)
+  {
+    const size_t begin = ChunkBegin(c, numChunks, n);
+    const size_t end = ChunkBegin(c + 1, numChunks, n);
+    double chunkMean = 0.0, chunkSquare = 0.0;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double delta = ratings[i * stride] - chunkMean;
+      chunkMean += delta / (i - begin + 1);
+      chunkSquare += delta * (ratings[i * stride] - chunkMean);
+    }
+
+    chunkMeans[c] = chunkMean;
+    chunkSquares[c] = chunkSquare;
+  });
+
+  double count = 0.0, square = 0.0;
+  mean = 0.0;
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    const double chunkCount = ChunkBegin(c + 1, numChunks, n) -
+        ChunkBegin(c, numChunks, n);
+    if (chunkCount == 0)
+      continue;
+
+    const double delta = chunkMeans[c] - mean;
+    const double total = count + chunkCount;
+    mean += delta * chunkCount / total;
+    square += chunkSquares[c] + delta * delta * count * chunkCount / total;
+    count = total;
+  }
+
+  stddev = (count > 1) ? std::sqrt(square / (count - 1)) : 0.0;
+}
+
+/**
+ * Replace each rating of the given coordinate list by
+ * function(user, item, rating), in parallel over chunks of the list.  The
+ * algorithm omits ratings of zero, so a new rating of zero is set to the
+ * smallest positive double value.
+ *
+ * @param data Ratings in the form of coordinate list.
+ * @param function Function that returns the new value of a rating.
+ */
+template<typename FunctionType>
+void TransformRatings(arma::mat& data, FunctionType function)
+{
+  const size_t numChunks = RatingChunks(data.n_cols);
+  Threads::ParallelFor(0, numChunks, [&](const size_t c)
+  {
+    const size_t end = ChunkBegin(c + 1, numChunks, data.n_cols);
+    for (size_t i = ChunkBegin(c, numChunks, data.n_cols); i < end; ++i)
+    {
+      data(2, i) = function((size_t) data(0, i), (size_t) data(1, i),
+          data(2, i));
+      if (data(2, i) == 0)
+        data(2, i) = std::numeric_limits<double>::min();
+    }
+  });
+}
+
+/**
+ * Replace each rating of the given sparse matrix, where each column holds the
+ * ratings of one user, by function(user, item, rating), in parallel over
+ * chunks of users.  The algorithm omits ratings of zero, so a new rating of
+ * zero is set to the smallest positive double value.  The new ratings are
+ * computed into a separate vector, and the matrix is rebuilt from it with
+ * the same structure.
+ *
+ * @param data Ratings as a sparse matrix.
+ * @param function Function that returns the new value of a rating.
+ */
+template<typename FunctionType>
+void TransformRatings(arma::sp_mat& data, FunctionType function)
+{
+  // nonzeros() gives the ratings in column-major order, and brings the
+  // compressed arrays of the matrix up to date, so they can be read directly.
+  arma::vec ratings = arma::nonzeros(data);
+
+  const size_t numChunks = std::max((size_t) 1, std::min(
+      RatingChunks(data.n_nonzero), (size_t) data.n_cols));
+  Threads::ParallelFor(0, numChunks, [&](const size_t c)
+  {
+    const size_t end = ChunkBegin(c + 1, numChunks, data.n_cols);
+    for (size_t u = ChunkBegin(c, numChunks, data.n_cols); u < end; ++u)
+    {
+      for (size_t k = data.col_ptrs[u]; k < data.col_ptrs[u + 1]; ++k)
+      {
+        ratings[k] = function(u, data.row_indices[k], ratings[k]);
+        if (ratings[k] == 0)
+          ratings[k] = std::numeric_limits<double>::min();
+      }
+    }
+  });
+
+  const arma::uvec rowIndices(const_cast<arma::uword*>(data.row_indices),
+      data.n_nonzero, false, true);
+  const arma::uvec colPtrs(const_cast<arma::uword*>(data.col_ptrs),
+      data.n_cols + 1, false, true);
+  data = arma::sp_mat(rowIndices, colPtrs, ratings, data.n_rows, data.n_cols);
+}
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_CF_NORMALIZATION_USER_MEAN_NORMALIZATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "rating_statistics.hpp"
 
 namespace mlpack {
 namespace cf {
@@ -50,35 +51,20 @@ class UserMeanNormalization
   void Normalize(arma::mat& data)
   {
     const size_t userNum = arma::max(data.row(0)) + 1;
-    userMean = arma::vec(userNum, arma::fill::zeros);
-    // Number of ratings for each user.
-    arma::Row<size_t> ratingNum(userNum, arma::fill::zeros);
-
-    // Sum ratings for each user.
-    data.each_col([&](arma::vec& datapoint)
-    {
-      const size_t user = (size_t) datapoint(0);
-      const double rating = datapoint(2);
-      userMean(user) += rating;
-      ratingNum(user) += 1;
-    });
+    // Sum the ratings of each user and count them, in one parallel pass.
+    arma::vec ratingNum;
+    GroupRatingSums(data, 0, userNum, userMean, ratingNum);
 
     // Calculate user mean and subtract user mean from ratings.
     // Set user mean to 0 if the user has no rating.
-    for (size_t i = 0; i < userNum; i++)
-    {
-      if (ratingNum(i) != 0)
-        userMean(i) /= ratingNum(i);
-    }
+    const arma::uvec rated = arma::find(ratingNum);
+    userMean.elem(rated) /= ratingNum.elem(rated);
 
-    data.each_col([&](arma::vec& datapoint)
+    TransformRatings(data, [&](const size_t user,
+                               const size_t /* item */,
+                               const double rating)
     {
-      const size_t user = (size_t) datapoint(0);
-      datapoint(2) -= userMean(user);
-      // The algorithm omits rating of zero. If normalized rating equals zero,
-      // it is set to the smallest positive double value.
-      if (datapoint(2) == 0)
-        datapoint(2) = std::numeric_limits<double>::min();
+      return rating - userMean(user);
     });
   }
 
@@ -90,31 +76,76 @@ class UserMeanNormalization
   void Normalize(arma::sp_mat& cleanedData)
   {
     // Calculate userMean.
-    userMean = arma::vec(cleanedData.n_cols, arma::fill::zeros);
-    arma::Col<size_t> ratingNum(cleanedData.n_cols, arma::fill::zeros);
-    arma::sp_mat::iterator it = cleanedData.begin();
-    arma::sp_mat::iterator it_end = cleanedData.end();
-    for (; it != it_end; ++it)
+    arma::vec ratingNum;
+    GroupRatingSums(cleanedData, true, userMean, ratingNum);
+    const arma::uvec rated = arma::find(ratingNum);
+    userMean.elem(rated) /= ratingNum.elem(rated);
+
+    // Normalize the data.
+    TransformRatings(cleanedData, [&](const size_t user,
+                                      const size_t /* item */,
+                                      const double rating)
     {
-      userMean(it.col()) += *it;
-      ratingNum(it.col()) += 1;
+      return rating - userMean(user);
+    });
+  }
+
+  /**
+   * Normalize the ratings of users that are folded into a trained model.
+   * The mean of each of the given users is recomputed from the given
+   * ratings, which must be all the ratings of those users.
+   *
+   * @param data Ratings of the users in the form of coordinate list.
+   */
+  void FoldInUsers(arma::mat& data)
+  {
+    const size_t num = std::max((size_t) userMean.n_elem,
+        (size_t) arma::max(data.row(0)) + 1);
+    userMean.resize(num);
+
+    // Recompute the means of the given users only.
+    arma::vec sums(num, arma::fill::zeros);
+    arma::Col<size_t> ratingNum(num, arma::fill::zeros);
+    for (size_t i = 0; i < data.n_cols; i++)
+    {
+      sums((size_t) data(0, i)) += data(2, i);
+      ratingNum((size_t) data(0, i)) += 1;
     }
-    for (size_t i = 0; i < userMean.n_elem; i++)
+    for (size_t i = 0; i < num; i++)
     {
       if (ratingNum(i) != 0)
-        userMean(i) /= ratingNum(i);
+        userMean(i) = sums(i) / ratingNum(i);
     }
 
-    // Normalize the data.
-    it = cleanedData.begin();
-    for (; it != cleanedData.end(); ++it)
+    data.each_col([&](arma::vec& datapoint)
     {
-      *it = *it - userMean(it.col());
+      datapoint(2) -= userMean((size_t) datapoint(0));
       // The algorithm omits rating of zero. If normalized rating equals zero,
       // it is set to the smallest positive double value.
-      if (*it == 0)
-        *it = std::numeric_limits<double>::min();
-    }
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
+  }
+
+  /**
+   * Normalize the ratings of items that are folded into a trained
+   * model.  The user means are kept fixed (users that are new to the model
+   * have a mean of zero).
+   *
+   * @param data Ratings of the items in the form of coordinate list.
+   */
+  void FoldInItems(arma::mat& data) const
+  {
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      if (user < userMean.n_elem)
+        datapoint(2) -= userMean(user);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
   }
 
   /**
@@ -140,11 +171,22 @@ class UserMeanNormalization
   void Denormalize(const arma::Mat<size_t>& combinations,
                    arma::vec& predictions) const
   {
-    for (size_t i = 0; i < predictions.n_elem; i++)
-    {
-      const size_t user = combinations(0, i);
-      predictions(i) += userMean(user);
-    }
+    predictions += userMean.elem(
+        arma::conv_to<arma::uvec>::from(combinations.row(0)));
+  }
+
+  /**
+   * Denormalize a block of computed ratings by adding user mean, where
+   * ratings(i, j) is the rating of item i by user users(j).
+   *
+   * @param users Users of the columns of the block.
+   * @param ratings Computed ratings before denormalization.
+   */
+  void Denormalize(const arma::Col<size_t>& users,
+                   arma::mat& ratings) const
+  {
+    ratings.each_row() += userMean.elem(
+        arma::conv_to<arma::uvec>::from(users)).t();
   }
 
   /**
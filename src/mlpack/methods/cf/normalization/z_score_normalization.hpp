@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_CF_NORMALIZATION_Z_SCORE_NORMALIZATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "rating_statistics.hpp"
 
 namespace mlpack {
 namespace cf {
@@ -48,8 +49,8 @@ class ZScoreNormalization
    */
   void Normalize(arma::mat& data)
   {
-    mean = arma::mean(data.row(2));
-    stddev = arma::stddev(data.row(2));
+    // Compute the mean and the standard deviation in one parallel pass.
+    RatingMoments(data.memptr() + 2, data.n_cols, data.n_rows, mean, stddev);
 
     if (std::fabs(stddev) < 1e-14)
     {
@@ -58,13 +59,11 @@ class ZScoreNormalization
           << std::endl;
     }
 
-    data.row(2) = (data.row(2) - mean) / stddev;
-    // The algorithm omits rating of zero. If normalized rating equals zero,
-    // it is set to the smallest positive double value.
-    data.row(2).for_each([](double& x)
+    TransformRatings(data, [&](const size_t /* user */,
+                               const size_t /* item */,
+                               const double rating)
     {
-      if (x == 0)
-        x = std::numeric_limits<double>::min();
+      return (rating - mean) / stddev;
     });
   }
 
@@ -76,9 +75,8 @@ class ZScoreNormalization
   void Normalize(arma::sp_mat& cleanedData)
   {
     // Caculate mean and stdev of all non zero ratings.
-    arma::vec ratings = arma::nonzeros(cleanedData);
-    mean = arma::mean(ratings);
-    stddev = arma::stddev(ratings);
+    const arma::vec ratings = arma::nonzeros(cleanedData);
+    RatingMoments(ratings.memptr(), ratings.n_elem, 1, mean, stddev);
 
     if (std::fabs(stddev) < 1e-14)
     {
@@ -88,18 +86,42 @@ class ZScoreNormalization
     }
 
     // Subtract mean from existing rating and divide it by stddev.
-    arma::sp_mat::iterator it = cleanedData.begin();
-    arma::sp_mat::iterator it_end = cleanedData.end();
-    for (; it != it_end; ++it)
+    TransformRatings(cleanedData, [&](const size_t /* user */,
+                                      const size_t /* item */,
+                                      const double rating)
     {
-      *it = (*it - mean) / stddev;
-      // The algorithm omits rating of zero. If normalized rating equals zero,
-      // it is set to the smallest positive double value.
-      if (*it == 0)
-        *it = std::numeric_limits<double>::min();
-    }
+      return (rating - mean) / stddev;
+    });
+  }
+
+  /**
+   * Normalize the ratings of users that are folded into a trained model with
+   * the mean and standard deviation of the original ratings, which are kept
+   * fixed.
+   *
+   * @param data Ratings of the users in the form of coordinate list.
+   */
+  void FoldInUsers(arma::mat& data) const
+  {
+    data.row(2) = (data.row(2) - mean) / stddev;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive double value.
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<double>::min();
+    });
   }
 
+  /**
+   * Normalize the ratings of items that are folded into a trained model.  The
+   * mean and standard deviation are kept fixed, so this is the same as
+   * FoldInUsers().
+   *
+   * @param data Ratings of the items in the form of coordinate list.
+   */
+  void FoldInItems(arma::mat& data) const { FoldInUsers(data); }
+
   /**
    * Denormalize computed rating by adding mean and multiplying stddev.
    *
@@ -126,6 +148,20 @@ class ZScoreNormalization
     predictions = predictions * stddev + mean;
   }
 
+  /**
+   * Denormalize a block of computed ratings by adding mean and multiplying
+   * stddev.
+   *
+   * @param users Users of the columns of the block.
+   * @param ratings Computed ratings before denormalization.
+   */
+  void Denormalize(const arma::Col<size_t>& /* users */,
+                   arma::mat& ratings) const
+  {
+    ratings *= stddev;
+    ratings += mean;
+  }
+
   /**
    * Return mean.
    */
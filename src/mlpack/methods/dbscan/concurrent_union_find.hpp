@@ -0,0 +1,100 @@
+/**
+ * @file concurrent_union_find.hpp
+ *
+ * A lock-free union-find structure that can be modified by several threads at
+ * once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_DBSCAN_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace dbscan {
+
+/**
+ * A union-find structure with the same interface as emst::UnionFind, whose
+ * Find() and Union() may be called concurrently from any number of threads
+ * without locking.  Every parent pointer is an atomic that only ever moves
+ * towards a smaller index: Union() links the root with the larger index under
+ * the other root with a compare-and-swap (retrying if another thread linked
+ * that root first), and Find() halves the paths it walks.  The parent of an
+ * element is therefore never larger than the element, so no cycles can form,
+ * and the root of each component is its smallest element.
+ */
+class ConcurrentUnionFind
+{
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the component containing an element.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load(std::memory_order_acquire);
+      if (p == x)
+        return x;
+
+      // Path halving: point x to its grandparent.  If another thread got
+      // there first, it can only have moved x closer to the root too.
+      const size_t grandparent = parent[p].load(std::memory_order_acquire);
+      if (grandparent != p)
+        parent[x].compare_exchange_weak(p, grandparent,
+            std::memory_order_acq_rel);
+
+      x = grandparent;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x one component
+   * @param y the other component
+   */
+  void Union(size_t x, size_t y)
+  {
+    while (true)
+    {
+      x = Find(x);
+      y = Find(y);
+      if (x == y)
+        return;
+
+      if (x < y)
+        std::swap(x, y);
+
+      // x is the larger root; it stays a root until it is linked.
+      size_t expected = x;
+      if (parent[x].compare_exchange_strong(expected, y,
+          std::memory_order_acq_rel))
+        return;
+    }
+  }
+
+ private:
+  //! The parent of each element.
+  std::vector<std::atomic<size_t>> parent;
+}; // class ConcurrentUnionFind
+
+} // namespace dbscan
+} // namespace mlpack
+
+#endif
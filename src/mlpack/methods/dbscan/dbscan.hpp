@@ -15,7 +15,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
-#include <mlpack/methods/emst/union_find.hpp>
+#include "concurrent_union_find.hpp"
 #include "random_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
 
@@ -57,19 +57,26 @@ class DBSCAN
    * parameter should be set to false in the case where RAM issues will be
    * encountered (i.e. if the dataset is very large or if epsilon is large).
    * When batchMode is false, each point will be searched iteratively, which
-   * could be slower but will use less memory.
+   * could be slower but will use less memory.  In either mode, the
+   * neighborhoods are merged into the clusters as they are found, so they are
+   * never stored.  In batch mode, a nonzero chunkSize searches the points in
+   * chunks of chunkSize points, so that the query tree of each search is
+   * smaller.
    *
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
    * @param batchMode If true, all points are searched in batch.
    * @param rangeSearch Optional instantiated RangeSearch object.
    * @param pointSelector OptionL instantiated PointSelectionPolicy object.
+   * @param chunkSize Number of points to search at once in batch mode (0
+   *     searches all points at once).
    */
   DBSCAN(const double epsilon,
          const size_t minPoints,
          const bool batchMode = true,
          RangeSearchType rangeSearch = RangeSearchType(),
-         PointSelectionPolicy pointSelector = PointSelectionPolicy());
+         PointSelectionPolicy pointSelector = PointSelectionPolicy(),
+         const size_t chunkSize = 0);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -122,6 +129,9 @@ class DBSCAN
   //! Whether or not to perform the search in batch mode.  If false, single
   bool batchMode;
 
+  //! The number of points to search at once in batch mode (0 means all).
+  size_t chunkSize;
+
   //! Instantiated range search policy.
   RangeSearchType rangeSearch;
 
@@ -140,7 +150,7 @@ class DBSCAN
    */
   template<typename MatType>
   void PointwiseCluster(const MatType& data,
-                        emst::UnionFind& uf);
+                        ConcurrentUnionFind& uf);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -153,7 +163,7 @@ class DBSCAN
    */
   template<typename MatType>
   void BatchCluster(const MatType& data,
-                    emst::UnionFind& uf);
+                    ConcurrentUnionFind& uf);
 };
 
 } // namespace dbscan
@@ -26,10 +26,12 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     const size_t minPoints,
     const bool batchMode,
     RangeSearchType rangeSearch,
-    PointSelectionPolicy pointSelector) :
+    PointSelectionPolicy pointSelector,
+    const size_t chunkSize) :
     epsilon(epsilon),
     minPoints(minPoints),
     batchMode(batchMode),
+    chunkSize(chunkSize),
     rangeSearch(rangeSearch),
     pointSelector(pointSelector)
 {
@@ -101,7 +103,7 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     arma::Row<size_t>& assignments)
 {
   // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
+  ConcurrentUnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
   if (batchMode)
@@ -111,7 +113,8 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
 
   // Now set assignments.
   assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     assignments[i] = uf.Find(i);
 
   // Get a count of all clusters.
@@ -150,23 +153,18 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    ConcurrentUnionFind& uf)
 {
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
-
   for (size_t i = 0; i < data.n_cols; ++i)
   {
     if (i % 10000 == 0 && i > 0)
       Log::Info << "DBSCAN clustering on point " << i << "..." << std::endl;
 
-    // Do the range search for only this point.
-    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), neighbors,
-        distances);
-
-    // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[0].size(); ++j)
-      uf.Union(i, neighbors[0][j]);
+    // Do the range search for only this point, and union to all neighbors as
+    // they are found.
+    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon),
+        [&](const size_t /* queryIndex */, const size_t neighbor,
+            const double /* distance */) { uf.Union(i, neighbor); });
   }
 }
 
@@ -179,23 +177,32 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    ConcurrentUnionFind& uf)
 {
-  // For each point, find the points in epsilon-nighborhood and their distances.
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
+  // For each point, find the points in its epsilon-neighborhood, and union
+  // the point to each of them as they are found, so that no neighborhoods are
+  // stored.  The roots of the union-find structure do not depend on the order
+  // of the unions.  If a chunk size is given, one chunk of points is searched
+  // at a time.
+  const size_t step = (chunkSize == 0) ? data.n_cols : chunkSize;
   Log::Info << "Performing range search." << std::endl;
   rangeSearch.Train(data);
-  rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
-  Log::Info << "Range search complete." << std::endl;
-
-  // Now loop over all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
+  for (size_t begin = 0; begin < data.n_cols; begin += step)
   {
-    // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[i].size(); ++j)
-      uf.Union(i, neighbors[i][j]);
+    const size_t end = std::min(begin + step, (size_t) data.n_cols);
+    auto unionNeighbor = [&](const size_t queryIndex, const size_t neighbor,
+                             const double /* distance */)
+    {
+      uf.Union(begin + queryIndex, neighbor);
+    };
+
+    if (step == data.n_cols)
+      rangeSearch.Search(data, math::Range(0.0, epsilon), unionNeighbor);
+    else
+      rangeSearch.Search(data.cols(begin, end - 1), math::Range(0.0, epsilon),
+          unionNeighbor);
   }
+  Log::Info << "Range search complete." << std::endl;
 }
 
 } // namespace dbscan
@@ -53,7 +53,10 @@ PROGRAM_INFO("DBSCAN clustering",
     " 'hilbert-r', 'r-plus', 'r-plus-plus', 'cover', 'ball'. The " +
     PRINT_PARAM_STRING("single_mode") + " parameter will force single-tree "
     "search (as opposed to the default dual-tree search), and '" +
-    PRINT_PARAM_STRING("naive") + " will force brute-force range search."
+    PRINT_PARAM_STRING("naive") + " will force brute-force range search.  "
+    "For large datasets, the memory used by batch (dual-tree or brute-force) "
+    "search can be bounded with the " + PRINT_PARAM_STRING("chunk_size") +
+    " parameter, which searches that many points at a time."
     "\n\n"
     "An example usage to run DBSCAN on the dataset in " +
     PRINT_DATASET("input") + " with a radius of 0.5 and a minimum cluster size"
@@ -76,6 +79,8 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
+PARAM_INT_IN("chunk_size", "Number of points to search at once when not using "
+    "single-tree search (0 searches all points at once).", "c", 0);
 
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType>
@@ -90,8 +95,10 @@ void RunDBSCAN(RangeSearchType rs = RangeSearchType())
   const double epsilon = CLI::GetParam<double>("epsilon");
   const size_t minSize = (size_t) CLI::GetParam<int>("min_size");
 
+  const size_t chunkSize = (size_t) CLI::GetParam<int>("chunk_size");
+
   DBSCAN<RangeSearchType> d(epsilon, minSize, !CLI::HasParam("single_mode"),
-      rs);
+      rs, RandomPointSelection(), chunkSize);
 
   // If possible, avoid the overhead of calculating centroids.
   arma::Row<size_t> assignments;
@@ -118,6 +125,9 @@ static void mlpackMain()
       "no output will be saved");
 
   ReportIgnoredParam({{ "naive", true }}, "single_mode");
+  ReportIgnoredParam({{ "single_mode", true }}, "chunk_size");
+  RequireParamValue<int>("chunk_size", [](int x) { return x >= 0; }, true,
+      "chunk size must be nonnegative");
 
   RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star", "x",
       "hilbert-r", "r-plus", "r-plus-plus", "ball" }, true,
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_DECISION_STUMP_DECISION_STUMP_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <memory>
 
 namespace mlpack {
 namespace decision_stump {
@@ -114,6 +115,17 @@ class DecisionStump
    */
   void Classify(const MatType& test, arma::Row<size_t>& predictedLabels);
 
+  /**
+   * Sort each dimension of the given dataset once, so that the stumps trained
+   * on that same dataset with the constructor that copies the parameters of
+   * this stump (as AdaBoost does in each round) do not need to sort it again.
+   * The sorted orders are shared with copies of this stump; they are not
+   * serialized, and stumps trained from this one do not keep them.
+   *
+   * @param data Dataset the stumps will be trained on.
+   */
+  void Presort(const MatType& data);
+
   //! Access the splitting dimension.
   size_t SplitDimension() const { return splitDimension; }
   //! Modify the splitting dimension (be careful!).
@@ -145,6 +157,20 @@ class DecisionStump
   arma::vec split;
   //! Stores the labels for each splitting bin.
   arma::Col<size_t> binLabels;
+  //! The indices of the points sorted by each dimension (one column per
+  //! dimension), if Presort() was called.
+  std::shared_ptr<const arma::umat> sortedIndices;
+
+  //! Allow stumps of other matrix types to use our sorted indices.
+  template<typename> friend class DecisionStump;
+
+  /**
+   * Get the presorted indices if they were computed for a dataset of the same
+   * size as the given one, or NULL.
+   */
+  static const arma::umat* PresortedIndices(
+      const std::shared_ptr<const arma::umat>& indices,
+      const MatType& data);
 
   /**
    * Sets up dimension as if it were splitting on it and finds entropy when
@@ -152,12 +178,14 @@ class DecisionStump
    *
    * @param dimension A row from the training data, which might be a
    *     candidate for the splitting dimension.
+   * @param order Indices of the points sorted (stably) by the dimension.
    * @tparam UseWeights Whether we need to run a weighted Decision Stump.
    */
   template<bool UseWeights, typename VecType>
   double SetupSplitDimension(const VecType& dimension,
+                             const arma::uword* order,
                              const arma::Row<size_t>& labels,
-                             const arma::rowvec& weightD);
+                             const arma::rowvec& weightD) const;
 
   /**
    * After having decided the dimension on which to split, train on that
@@ -165,9 +193,11 @@ class DecisionStump
    *
    * @tparam dimension dimension is the dimension decided by the constructor
    *      on which we now train the decision stump.
+   * @param order Indices of the points sorted (stably) by the dimension.
    */
   template<typename VecType>
   void TrainOnDim(const VecType& dimension,
+                  const arma::uword* order,
                   const arma::Row<size_t>& labels);
 
   /**
@@ -191,7 +221,7 @@ class DecisionStump
    * @param featureRow The dimension which is checked for identical values.
    */
   template<typename VecType>
-  int IsDistinct(const VecType& featureRow);
+  int IsDistinct(const VecType& featureRow) const;
 
   /**
    * Calculate the entropy of the given dimension.
@@ -204,7 +234,7 @@ class DecisionStump
    */
   template<bool UseWeights, typename VecType, typename WeightVecType>
   double CalculateEntropy(const VecType& labels,
-                          const WeightVecType& weights);
+                          const WeightVecType& weights) const;
 
   /**
    * Train the decision stump on the given data and labels.
@@ -212,13 +242,16 @@ class DecisionStump
    * @param data Dataset to train on.
    * @param labels Labels for dataset.
    * @param weights Weights for this set of labels.
+   * @param presorted Indices of the points sorted by each dimension, or NULL
+   *      if the dimensions must be sorted.
    * @tparam UseWeights If true, the weights in the weight vector will be used
    *      (otherwise they are ignored).
    */
   template<bool UseWeights>
   void Train(const MatType& data,
              const arma::Row<size_t>& labels,
-             const arma::rowvec& weights);
+             const arma::rowvec& weights,
+             const arma::umat* presorted);
 };
 
 } // namespace decision_stump
@@ -35,7 +35,7 @@ DecisionStump<MatType>::DecisionStump(const MatType& data,
     bucketSize(bucketSize)
 {
   arma::rowvec weights;
-  Train<false>(data, labels, weights);
+  Train<false>(data, labels, weights, NULL);
 }
 
 /**
@@ -67,7 +67,7 @@ void DecisionStump<MatType>::Train(const MatType& data,
 
   // Pass to unweighted training function.
   arma::rowvec weights;
-  Train<false>(data, labels, weights);
+  Train<false>(data, labels, weights, PresortedIndices(sortedIndices, data));
 }
 
 /**
@@ -86,7 +86,7 @@ void DecisionStump<MatType>::Train(const MatType& data,
   this->bucketSize = bucketSize;
 
   // Pass to weighted training function.
-  Train<true>(data, labels, weights);
+  Train<true>(data, labels, weights, PresortedIndices(sortedIndices, data));
 }
 
 /**
@@ -100,40 +100,57 @@ template<typename MatType>
 template<bool UseWeights>
 void DecisionStump<MatType>::Train(const MatType& data,
                                    const arma::Row<size_t>& labels,
-                                   const arma::rowvec& weights)
+                                   const arma::rowvec& weights,
+                                   const arma::umat* presorted)
 {
   // If classLabels are not all identical, proceed with training.
-  size_t bestDim = 0;
-  double entropy;
   const double rootEntropy = CalculateEntropy<UseWeights>(labels, weights);
 
-  double gain, bestGain = 0.0;
-  for (size_t i = 0; i < data.n_rows; i++)
+  // The dimensions are independent, so evaluate them in parallel.  A dimension
+  // with identical values can't be split on; it keeps a gain of 0.
+  arma::vec gains(data.n_rows, arma::fill::zeros);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; i++)
   {
     // Go through each dimension of the data.
     if (IsDistinct(data.row(i)))
     {
       // For each dimension with non-identical values, treat it as a potential
-      // splitting dimension and calculate entropy if split on it.
-      entropy = SetupSplitDimension<UseWeights>(data.row(i), labels, weights);
+      // splitting dimension and calculate entropy if split on it.  Sort the
+      // dimension unless that was done already.
+      arma::uvec order;
+      if (presorted == NULL)
+        order = arma::stable_sort_index(data.row(i).t());
 
-      gain = rootEntropy - entropy;
-      // Find the dimension with the best entropy so that the gain is
-      // maximized.
+      const double entropy = SetupSplitDimension<UseWeights>(data.row(i),
+          (presorted == NULL) ? order.memptr() : presorted->colptr(i), labels,
+          weights);
 
-      // We are maximizing gain, which is what is returned from
-      // SetupSplitDimension().
-      if (gain < bestGain)
-      {
-        bestDim = i;
-        bestGain = gain;
-      }
+      gains[i] = rootEntropy - entropy;
+    }
+  }
+
+  // Find the dimension with the best entropy so that the gain is maximized.
+  // We are maximizing gain, which is what is returned from
+  // SetupSplitDimension().  Ties go to the first dimension.
+  size_t bestDim = 0;
+  double bestGain = 0.0;
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    if (gains[i] < bestGain)
+    {
+      bestDim = i;
+      bestGain = gains[i];
     }
   }
   splitDimension = bestDim;
 
   // Once the splitting column/dimension has been decided, train on it.
-  TrainOnDim(data.row(splitDimension), labels);
+  arma::uvec order;
+  if (presorted == NULL)
+    order = arma::stable_sort_index(data.row(splitDimension).t());
+  TrainOnDim(data.row(splitDimension), (presorted == NULL) ? order.memptr() :
+      presorted->colptr(splitDimension), labels);
 }
 
 /**
@@ -190,7 +207,40 @@ DecisionStump<MatType>::DecisionStump(const DecisionStump<>& other,
     numClasses(numClasses),
     bucketSize(other.bucketSize)
 {
-  Train<true>(data, labels, weights);
+  // Reuse the sorted orders of the other stump, if it has them for this data.
+  Train<true>(data, labels, weights,
+      PresortedIndices(other.sortedIndices, data));
+}
+
+/**
+ * Sort each dimension of the dataset once, for the stumps trained on it.
+ */
+template<typename MatType>
+void DecisionStump<MatType>::Presort(const MatType& data)
+{
+  std::shared_ptr<arma::umat> indices(new arma::umat(data.n_cols,
+      data.n_rows));
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; i++)
+    indices->col(i) = arma::stable_sort_index(data.row(i).t());
+
+  sortedIndices = indices;
+}
+
+/**
+ * Get the presorted indices if they match the size of the data.
+ */
+template<typename MatType>
+const arma::umat* DecisionStump<MatType>::PresortedIndices(
+    const std::shared_ptr<const arma::umat>& indices,
+    const MatType& data)
+{
+  if (indices && indices->n_rows == data.n_cols &&
+      indices->n_cols == data.n_rows)
+    return indices.get();
+
+  return NULL;
 }
 
 /**
@@ -222,26 +272,25 @@ template<typename MatType>
 template<bool UseWeights, typename VecType>
 double DecisionStump<MatType>::SetupSplitDimension(
     const VecType& dimension,
+    const arma::uword* order,
     const arma::Row<size_t>& labels,
-    const arma::rowvec& weights)
+    const arma::rowvec& weights) const
 {
   size_t i, count, begin, end;
   double entropy = 0.0;
 
-  // Store the indices of the sorted dimension to build a vector of sorted
-  // labels.  This sort is stable.
-  arma::uvec sortedIndexDim = arma::stable_sort_index(dimension.t());
-
+  // Use the (stably) sorted indices of the dimension to build a vector of
+  // sorted labels.
   arma::Row<size_t> sortedLabels(dimension.n_elem);
   arma::rowvec sortedWeights(dimension.n_elem);
 
   for (i = 0; i < dimension.n_elem; i++)
   {
-    sortedLabels(i) = labels(sortedIndexDim(i));
+    sortedLabels(i) = labels(order[i]);
 
     // Apply weights if necessary.
     if (UseWeights)
-      sortedWeights(i) = weights(sortedIndexDim(i));
+      sortedWeights(i) = weights(order[i]);
   }
 
   i = 0;
@@ -311,17 +360,18 @@ double DecisionStump<MatType>::SetupSplitDimension(
 template<typename MatType>
 template<typename VecType>
 void DecisionStump<MatType>::TrainOnDim(const VecType& dimension,
+                                        const arma::uword* order,
                                         const arma::Row<size_t>& labels)
 {
   size_t i, count, begin, end;
 
-  typename MatType::row_type sortedSplitDim = arma::sort(dimension);
-  arma::uvec sortedSplitIndexDim = arma::stable_sort_index(dimension.t());
+  typename MatType::row_type sortedSplitDim(dimension.n_elem);
   arma::Row<size_t> sortedLabels(dimension.n_elem);
-  sortedLabels.fill(0);
-
   for (i = 0; i < dimension.n_elem; i++)
-    sortedLabels(i) = labels(sortedSplitIndexDim(i));
+  {
+    sortedSplitDim(i) = dimension(order[i]);
+    sortedLabels(i) = labels(order[i]);
+  }
 
   arma::rowvec subCols;
   double mostFreq;
@@ -443,7 +493,7 @@ double DecisionStump<MatType>::CountMostFreq(const VecType& subCols)
  */
 template<typename MatType>
 template<typename VecType>
-int DecisionStump<MatType>::IsDistinct(const VecType& featureRow)
+int DecisionStump<MatType>::IsDistinct(const VecType& featureRow) const
 {
   typename VecType::elem_type val = featureRow(0);
   for (size_t i = 1; i < featureRow.n_elem; ++i)
@@ -462,7 +512,7 @@ template<typename MatType>
 template<bool UseWeights, typename VecType, typename WeightVecType>
 double DecisionStump<MatType>::CalculateEntropy(
     const VecType& labels,
-    const WeightVecType& weights)
+    const WeightVecType& weights) const
 {
   double entropy = 0.0;
   size_t j;
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_DECISION_TREE_ALL_CATEGORICAL_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "category_counts.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -86,6 +87,36 @@ class AllCategoricalSplit
       const ElemType& point,
       const arma::Col<ElemType>& classProbabilities,
       const AuxiliarySplitInfo<ElemType>& /* aux */);
+
+ private:
+  /**
+   * Calculate the gain of the split from a category x class table built in
+   * one pass over the points.  This is used when the fitness function
+   * provides EvaluateCounts().
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType,
+           typename F = FitnessFunction>
+  static auto Gain(const VecType& data,
+                   const size_t numCategories,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const WeightVecType& weights,
+                   const int /* preferred */)
+      -> decltype(F::EvaluateCounts(arma::vec(), 0.0), double());
+
+  /**
+   * Calculate the gain of the split by gathering the labels of every child and
+   * evaluating the fitness function on them, for fitness functions without
+   * EvaluateCounts().
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType,
+           typename F = FitnessFunction>
+  static double Gain(const VecType& data,
+                     const size_t numCategories,
+                     const arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     const WeightVecType& weights,
+                     const long /* fallback */);
 };
 
 } // namespace tree
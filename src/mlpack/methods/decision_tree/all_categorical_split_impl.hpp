@@ -32,6 +32,74 @@ double AllCategoricalSplit<FitnessFunction>::SplitIfBetter(
   // Count the number of elements in each potential child.
   const double epsilon = 1e-7; // Tolerance for floating-point errors.
   arma::Col<size_t> counts(numCategories, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+    counts[(size_t) data[i]]++;
+
+  // If each child will have the minimum number of points in it, we can split.
+  // Otherwise we can't.
+  if (arma::min(counts) < minimumLeafSize)
+    return bestGain;
+
+  const double overallGain = Gain<UseWeights>(data, numCategories, labels,
+      numClasses, weights, 0);
+
+  if (overallGain > bestGain + minimumGainSplit + epsilon)
+  {
+    // This is better, so set up the class probabilities vector and return.
+    classProbabilities.set_size(1);
+    classProbabilities[0] = numCategories;
+    return overallGain;
+  }
+
+  // Otherwise there was no improvement.
+  return bestGain;
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType,
+         typename F>
+auto AllCategoricalSplit<FitnessFunction>::Gain(
+    const VecType& data,
+    const size_t numCategories,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const int /* preferred */)
+    -> decltype(F::EvaluateCounts(arma::vec(), 0.0), double())
+{
+  // Count (or sum the weights of) every class in every child at once.
+  CategoryCounts<double> table(numCategories, numClasses);
+  table.template Add<UseWeights>(data, labels, weights);
+
+  const arma::mat counts = table.Table();
+  const arma::rowvec childWeightSums = arma::sum(counts, 0);
+  const double sumWeight = arma::accu(childWeightSums);
+
+  double overallGain = 0.0;
+  for (size_t i = 0; i < counts.n_cols; ++i)
+  {
+    // Calculate the gain of this child.
+    const double childPct = childWeightSums[i] / sumWeight;
+    overallGain += childPct * F::EvaluateCounts(counts.unsafe_col(i),
+        childWeightSums[i]);
+  }
+
+  return overallGain;
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType,
+         typename F>
+double AllCategoricalSplit<FitnessFunction>::Gain(
+    const VecType& data,
+    const size_t numCategories,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const long /* fallback */)
+{
+  // Count the number of elements in each potential child.
+  arma::Col<size_t> counts(numCategories, arma::fill::zeros);
 
   // If we are using weighted training, learn the weights for each child too.
   arma::vec childWeightSums;
@@ -50,11 +118,6 @@ double AllCategoricalSplit<FitnessFunction>::SplitIfBetter(
     }
   }
 
-  // If each child will have the minimum number of points in it, we can split.
-  // Otherwise we can't.
-  if (arma::min(counts) < minimumLeafSize)
-    return bestGain;
-
   // Calculate the gain of the split.  First we have to calculate the labels
   // that would be assigned to each child.
   arma::uvec childPositions(numCategories, arma::fill::zeros);
@@ -91,22 +154,13 @@ double AllCategoricalSplit<FitnessFunction>::SplitIfBetter(
     const double childPct = UseWeights ?
         double(childWeightSums[i]) / sumWeight :
         double(counts[i]) / double(data.n_elem);
-    const double childGain = FitnessFunction::template Evaluate<UseWeights>(
+    const double childGain = F::template Evaluate<UseWeights>(
         childLabels[i], numClasses, childWeights[i]);
 
     overallGain += childPct * childGain;
   }
 
-  if (overallGain > bestGain + minimumGainSplit + epsilon)
-  {
-    // This is better, so set up the class probabilities vector and return.
-    classProbabilities.set_size(1);
-    classProbabilities[0] = numCategories;
-    return overallGain;
-  }
-
-  // Otherwise there was no improvement.
-  return bestGain;
+  return overallGain;
 }
 
 template<typename FitnessFunction>
@@ -62,6 +62,45 @@ class BestBinaryNumericSplit
       arma::Col<typename VecType::elem_type>& classProbabilities,
       AuxiliarySplitInfo<typename VecType::elem_type>& aux);
 
+  /**
+   * Check if we can split a node on a sparse dimension, like SplitIfBetter(),
+   * given only the nonzero values of the dimension.  The points whose value is
+   * zero are never visited: they are handled as one block, through the sums
+   * of their weights (or their counts) for each class, so the search takes
+   * time in the number of nonzero values only.  This is only available with
+   * fitness functions that provide EvaluateCounts().
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param values Nonzero values of the dimension, in ascending order.
+   * @param labels Labels of the points of the nonzero values.
+   * @param weights Weights of the points of the nonzero values (ignored if
+   *      UseWeights is false).
+   * @param zeroCounts Sum of the weights (or number) of the points of each
+   *      class whose value is zero.
+   * @param numZeros Number of points whose value is zero.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename ElemType, typename F = FitnessFunction>
+  static auto SplitIfBetterSparse(
+      const double bestGain,
+      const arma::Row<ElemType>& values,
+      const arma::Row<size_t>& labels,
+      const arma::rowvec& weights,
+      const arma::vec& zeroCounts,
+      const size_t numZeros,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<ElemType>& classProbabilities,
+      AuxiliarySplitInfo<ElemType>& aux)
+      -> decltype(F::EvaluateCounts(arma::vec(), 0.0), double());
+
   /**
    * Returns 2, since the binary split always has two children.
    */
@@ -84,6 +123,45 @@ class BestBinaryNumericSplit
       const ElemType& point,
       const arma::Col<ElemType>& classProbabilities,
       const AuxiliarySplitInfo<ElemType>& /* aux */);
+
+ private:
+  /**
+   * Find the best split point of the sorted data in one pass, keeping running
+   * class counts (or sums of weights) for both children.  Each split point
+   * takes O(numClasses) time to evaluate, instead of a pass over the labels.
+   * This is used when the fitness function provides EvaluateCounts().
+   */
+  template<bool UseWeights, typename VecType, typename F = FitnessFunction>
+  static auto Sweep(
+      const double bestGain,
+      const VecType& data,
+      const arma::uvec& sortedIndices,
+      const arma::Row<size_t>& sortedLabels,
+      const size_t numClasses,
+      const arma::rowvec& sortedWeights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      const int /* preferred */)
+      -> decltype(F::EvaluateCounts(arma::vec(), 0.0), double());
+
+  /**
+   * Find the best split point of the sorted data by evaluating the labels of
+   * both children at every split point, for fitness functions without
+   * EvaluateCounts().
+   */
+  template<bool UseWeights, typename VecType, typename F = FitnessFunction>
+  static double Sweep(
+      const double bestGain,
+      const VecType& data,
+      const arma::uvec& sortedIndices,
+      const arma::Row<size_t>& sortedLabels,
+      const size_t numClasses,
+      const arma::rowvec& sortedWeights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      const long /* fallback */);
 };
 
 } // namespace tree
@@ -48,6 +48,115 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       sortedWeights[i] = weights[sortedIndices[i]];
   }
 
+  // Sweep through the split points with running class counts, if the fitness
+  // function can be evaluated from class counts.
+  return Sweep<UseWeights>(bestGain, data, sortedIndices, sortedLabels,
+      numClasses, sortedWeights, minimumLeafSize, minimumGainSplit,
+      classProbabilities, 0);
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename F>
+auto BestBinaryNumericSplit<FitnessFunction>::Sweep(
+    const double bestGain,
+    const VecType& data,
+    const arma::uvec& sortedIndices,
+    const arma::Row<size_t>& sortedLabels,
+    const size_t numClasses,
+    const arma::rowvec& sortedWeights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    const int /* preferred */)
+    -> decltype(F::EvaluateCounts(arma::vec(), 0.0), double())
+{
+  // All the points start in the right child.
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  arma::vec rightCounts(numClasses, arma::fill::zeros);
+  for (size_t i = 0; i < sortedLabels.n_elem; ++i)
+    rightCounts[sortedLabels[i]] += UseWeights ? sortedWeights[i] : 1.0;
+  const double fullWeight = arma::accu(rightCounts);
+
+  // Move the points to the left child one at a time, in sorted order, and
+  // evaluate the split after each point.  Also, force a minimum leaf size of 1
+  // (empty children don't make sense).
+  double bestFoundGain = bestGain;
+  double leftWeights = 0.0;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  for (size_t index = 1; index < data.n_elem - (minimum - 1); ++index)
+  {
+    const double weight = UseWeights ? sortedWeights[index - 1] : 1.0;
+    leftCounts[sortedLabels[index - 1]] += weight;
+    rightCounts[sortedLabels[index - 1]] -= weight;
+    leftWeights += weight;
+
+    if (index < minimum)
+      continue;
+
+    // Make sure that the value has changed.
+    if (data[sortedIndices[index]] == data[sortedIndices[index - 1]])
+      continue;
+
+    // Calculate the gain for the left and right child.
+    const double rightWeights = fullWeight - leftWeights;
+    const double leftGain = F::EvaluateCounts(leftCounts, leftWeights);
+    const double rightGain = F::EvaluateCounts(rightCounts, rightWeights);
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = (leftWeights / fullWeight) * leftGain +
+          (rightWeights / fullWeight) * rightGain;
+    }
+    else
+    {
+      // Calculate the fraction of points in the left and right children.
+      const double leftRatio = double(index) / double(sortedLabels.n_elem);
+      const double rightRatio = 1.0 - leftRatio;
+
+      // Calculate the gain at this split point.
+      gain = leftRatio * leftGain + rightRatio * rightGain;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.
+      classProbabilities.set_size(1);
+      // The actual split value will be halfway between the value at index - 1
+      // and index.
+      classProbabilities[0] = (data[sortedIndices[index - 1]] +
+          data[sortedIndices[index]]) / 2.0;
+      return gain;
+    }
+    else if (gain > bestFoundGain + minimumGainSplit)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (data[sortedIndices[index - 1]] +
+          data[sortedIndices[index]]) / 2.0;
+    }
+  }
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename F>
+double BestBinaryNumericSplit<FitnessFunction>::Sweep(
+    const double bestGain,
+    const VecType& data,
+    const arma::uvec& sortedIndices,
+    const arma::Row<size_t>& sortedLabels,
+    const size_t numClasses,
+    const arma::rowvec& sortedWeights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    const long /* fallback */)
+{
   // Loop through all possible split points, choosing the best one.  Also, force
   // a minimum leaf size of 1 (empty children don't make sense).
   double bestFoundGain = bestGain;
@@ -118,6 +227,123 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   return bestFoundGain;
 }
 
+template<typename FitnessFunction>
+template<bool UseWeights, typename ElemType, typename F>
+auto BestBinaryNumericSplit<FitnessFunction>::SplitIfBetterSparse(
+    const double bestGain,
+    const arma::Row<ElemType>& values,
+    const arma::Row<size_t>& labels,
+    const arma::rowvec& weights,
+    const arma::vec& zeroCounts,
+    const size_t numZeros,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<ElemType>& classProbabilities,
+    AuxiliarySplitInfo<ElemType>& /* aux */)
+    -> decltype(F::EvaluateCounts(arma::vec(), 0.0), double())
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  const size_t numPoints = values.n_elem + numZeros;
+  if (numPoints < (minimumLeafSize * 2))
+    return bestGain;
+
+  // All the points start in the right child.
+  arma::vec leftCounts(zeroCounts.n_elem, arma::fill::zeros);
+  arma::vec rightCounts(zeroCounts);
+  for (size_t i = 0; i < values.n_elem; ++i)
+    rightCounts[labels[i]] += UseWeights ? weights[i] : 1.0;
+  const double fullWeight = arma::accu(rightCounts);
+  const double zeroWeight = arma::accu(zeroCounts);
+
+  // In sorted order, the block of zero values comes right after the negative
+  // values.  The steps of the sweep are the nonzero values and that block.
+  const size_t numNegative = std::lower_bound(values.begin(), values.end(),
+      ElemType(0)) - values.begin();
+  const bool hasZeros = (numZeros > 0);
+  const size_t numSteps = values.n_elem + (hasZeros ? 1 : 0);
+  auto stepValue = [&](const size_t step) -> ElemType
+  {
+    if (hasZeros && step == numNegative)
+      return ElemType(0);
+    return values[(hasZeros && step > numNegative) ? step - 1 : step];
+  };
+
+  // Move the steps to the left child one at a time, in sorted order, and
+  // evaluate the split after each step, like Sweep() does with every point.
+  // Also, force a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = bestGain;
+  double leftWeights = 0.0;
+  size_t leftPoints = 0;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  for (size_t step = 0; step + 1 < numSteps; ++step)
+  {
+    if (hasZeros && step == numNegative)
+    {
+      leftCounts += zeroCounts;
+      rightCounts -= zeroCounts;
+      leftWeights += zeroWeight;
+      leftPoints += numZeros;
+    }
+    else
+    {
+      const size_t i = (hasZeros && step > numNegative) ? step - 1 : step;
+      const double weight = UseWeights ? weights[i] : 1.0;
+      leftCounts[labels[i]] += weight;
+      rightCounts[labels[i]] -= weight;
+      leftWeights += weight;
+      ++leftPoints;
+    }
+
+    if (leftPoints < minimum || numPoints - leftPoints < minimum)
+      continue;
+
+    // Make sure that the value has changed.
+    const ElemType value = stepValue(step);
+    const ElemType nextValue = stepValue(step + 1);
+    if (value == nextValue)
+      continue;
+
+    // Calculate the gain for the left and right child.
+    const double rightWeights = fullWeight - leftWeights;
+    const double leftGain = F::EvaluateCounts(leftCounts, leftWeights);
+    const double rightGain = F::EvaluateCounts(rightCounts, rightWeights);
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = (leftWeights / fullWeight) * leftGain +
+          (rightWeights / fullWeight) * rightGain;
+    }
+    else
+    {
+      // Calculate the fraction of points in the left and right children.
+      const double leftRatio = double(leftPoints) / double(numPoints);
+      const double rightRatio = 1.0 - leftRatio;
+
+      // Calculate the gain at this split point.
+      gain = leftRatio * leftGain + rightRatio * rightGain;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // No split will be better than this, so just take this one.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (value + nextValue) / 2.0;
+      return gain;
+    }
+    else if (gain > bestFoundGain + minimumGainSplit)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (value + nextValue) / 2.0;
+    }
+  }
+
+  return bestFoundGain;
+}
+
 template<typename FitnessFunction>
 template<typename ElemType>
 size_t BestBinaryNumericSplit<FitnessFunction>::CalculateDirection(
@@ -0,0 +1,115 @@
+/**
+ * @file binary_categorical_split_impl.hpp
+ *
+ * Implementation of the BinaryCategoricalSplit categorical split class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "binary_categorical_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double BinaryCategoricalSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const size_t numCategories,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  const double epsilon = 1e-7; // Tolerance for floating-point errors.
+
+  // Build the category x class table (of weights, if there are any) and the
+  // number of points of every category in one pass.
+  CategoryCounts<double> table(numCategories, numClasses);
+  CategoryCounts<size_t> points(numCategories, 1);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t category = (size_t) data[i];
+    table.Add(category, labels[i], UseWeights ? (double) weights[i] : 1.0);
+    points.Add(category, 0);
+  }
+
+  const arma::mat counts = table.Table();
+  const arma::vec classCounts = arma::sum(counts, 1);
+  const double sumWeight = arma::accu(classCounts);
+
+  // Sort the categories of the node by the proportion of the majority class.
+  arma::uword majorityClass;
+  classCounts.max(majorityClass);
+  std::vector<size_t> order;
+  table.SortByProportion(majorityClass, order);
+  if (order.size() < 2)
+    return bestGain;
+
+  // Move the categories from the right child to the left child one by one.
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  double leftWeight = 0.0;
+  size_t leftPoints = 0;
+  double bestSplitGain = bestGain;
+  size_t bestPrefix = 0;
+  for (size_t k = 0; k + 1 < order.size(); ++k)
+  {
+    const size_t column = order[k];
+    leftCounts += counts.unsafe_col(column);
+    leftWeight += arma::accu(counts.unsafe_col(column));
+    leftPoints += points.Count(table.Category(column), 0);
+
+    if (leftPoints < minimumLeafSize)
+      continue;
+    if (data.n_elem - leftPoints < minimumLeafSize)
+      break;
+
+    const double rightWeight = sumWeight - leftWeight;
+    const double gain =
+        (leftWeight / sumWeight) *
+            FitnessFunction::EvaluateCounts(leftCounts, leftWeight) +
+        (rightWeight / sumWeight) *
+            FitnessFunction::EvaluateCounts(classCounts - leftCounts,
+            rightWeight);
+
+    if (gain > bestSplitGain)
+    {
+      bestSplitGain = gain;
+      bestPrefix = k + 1;
+    }
+  }
+
+  if (bestPrefix > 0 && bestSplitGain > bestGain + minimumGainSplit + epsilon)
+  {
+    // Send the categories without points to the heavier child, and the
+    // categories of the prefix to the left child.
+    double prefixWeight = 0.0;
+    for (size_t k = 0; k < bestPrefix; ++k)
+      prefixWeight += arma::accu(counts.unsafe_col(order[k]));
+
+    classProbabilities.set_size(numCategories);
+    classProbabilities.fill((2 * prefixWeight >= sumWeight) ? 0 : 1);
+    for (size_t k = 0; k < order.size(); ++k)
+      classProbabilities[table.Category(order[k])] = (k < bestPrefix) ? 0 : 1;
+
+    return bestSplitGain;
+  }
+
+  // Otherwise there was no improvement.
+  return bestGain;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
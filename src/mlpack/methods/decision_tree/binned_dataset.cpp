@@ -0,0 +1,85 @@
+/**
+ * @file binned_dataset.cpp
+ *
+ * Implementation of the quantization of a numeric dataset into bins.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "binned_dataset.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+BinnedDataset::BinnedDataset() :
+    binOffsets(1, arma::fill::zeros)
+{
+  // Nothing to do.
+}
+
+BinnedDataset::BinnedDataset(const arma::mat& data, const size_t maxBins) :
+    codes(data.n_cols, data.n_rows),
+    thresholds(data.n_rows)
+{
+  if (maxBins < 2 || maxBins > 256)
+  {
+    std::ostringstream oss;
+    oss << "BinnedDataset::BinnedDataset(): the number of bins must be "
+        << "between 2 and 256 (" << maxBins << " given)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+  {
+    const arma::vec sorted = arma::sort(data.row(d).t());
+    const arma::vec values = arma::unique(sorted);
+
+    std::vector<double> dimThresholds;
+    if (values.n_elem <= maxBins)
+    {
+      // Every distinct value gets its own bin.
+      for (size_t i = 1; i < values.n_elem; ++i)
+        dimThresholds.push_back((values[i - 1] + values[i]) / 2.0);
+    }
+    else
+    {
+      // Put the thresholds just after the quantiles of the values; a value
+      // that is repeated many times may take the place of several quantiles.
+      for (size_t b = 1; b < maxBins; ++b)
+      {
+        const double value = sorted[b * sorted.n_elem / maxBins - 1];
+        const double* next = std::upper_bound(sorted.memptr(),
+            sorted.memptr() + sorted.n_elem, value);
+        if (next == sorted.memptr() + sorted.n_elem)
+          break;
+
+        const double threshold = (value + *next) / 2.0;
+        if (dimThresholds.empty() || threshold > dimThresholds.back())
+          dimThresholds.push_back(threshold);
+      }
+    }
+    thresholds[d] = arma::vec(dimThresholds);
+
+    // A value goes to the first bin whose threshold is not below it.
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      codes(i, d) = (unsigned char) (std::lower_bound(dimThresholds.begin(),
+          dimThresholds.end(), data(d, i)) - dimThresholds.begin());
+    }
+  }
+
+  binOffsets.zeros(data.n_rows + 1);
+  for (size_t d = 0; d < data.n_rows; ++d)
+    binOffsets[d + 1] = binOffsets[d] + thresholds[d].n_elem + 1;
+}
+
+void BinnedDataset::Select(const arma::uvec& points,
+                           BinnedDataset& subset) const
+{
+  subset.codes = codes.rows(points);
+  subset.thresholds = thresholds;
+  subset.binOffsets = binOffsets;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file binned_dataset.hpp
+ *
+ * A numeric dataset whose dimensions are quantized into a small number of bins,
+ * for histogram-based decision tree training.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINNED_DATASET_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINNED_DATASET_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The BinnedDataset quantizes each dimension of a numeric dataset into at most
+ * 256 bins, and stores the bin of each value as a one-byte code.  The codes are
+ * stored with one column per dimension, so that the codes of one dimension are
+ * contiguous in memory.  The bins of a dimension are separated by thresholds:
+ * a value is in bin b if it is greater than threshold b - 1 and less than or
+ * equal to threshold b.  If a dimension has no more distinct values than bins,
+ * the thresholds are the midpoints between consecutive distinct values, so no
+ * information about the ordering of the values is lost; otherwise the
+ * thresholds are (approximate) quantiles of the values.
+ *
+ * A decision tree can be trained on a BinnedDataset with
+ * DecisionTree::TrainBinned(), which finds the splits of each node from
+ * histograms of the class counts in each bin instead of sorting the points.
+ * The trained tree splits on the thresholds, so it can classify the original
+ * (unquantized) points.
+ *
+ * @code
+ * extern arma::mat data;
+ * extern arma::Row<size_t> labels;
+ *
+ * BinnedDataset binnedData(data);
+ * DecisionTree<> tree;
+ * tree.TrainBinned(binnedData, labels, numClasses);
+ * @endcode
+ */
+class BinnedDataset
+{
+ public:
+  /**
+   * Create an empty binned dataset.
+   */
+  BinnedDataset();
+
+  /**
+   * Quantize the given dataset (one point per column).  This is done in
+   * parallel over the dimensions.
+   *
+   * @param data Dataset to quantize.
+   * @param maxBins Maximum number of bins in each dimension (between 2 and
+   *     256).
+   */
+  BinnedDataset(const arma::mat& data, const size_t maxBins = 256);
+
+  /**
+   * Store the points with the given indices (which may be repeated) in the
+   * given binned dataset, with the same thresholds.
+   *
+   * @param points Indices of the points to select.
+   * @param subset Binned dataset to store the points in.
+   */
+  void Select(const arma::uvec& points, BinnedDataset& subset) const;
+
+  //! Get the number of points.
+  size_t NumPoints() const { return codes.n_rows; }
+  //! Get the number of dimensions.
+  size_t Dimensionality() const { return codes.n_cols; }
+
+  //! Get the number of bins of the given dimension.
+  size_t NumBins(const size_t dim) const
+  {
+    return binOffsets[dim + 1] - binOffsets[dim];
+  }
+
+  //! Get the total number of bins of all the dimensions.
+  size_t TotalBins() const { return binOffsets[binOffsets.n_elem - 1]; }
+
+  /**
+   * Get the offsets of the bins of each dimension when the bins of all the
+   * dimensions are numbered consecutively (there is one more offset than there
+   * are dimensions).
+   */
+  const arma::Col<size_t>& BinOffsets() const { return binOffsets; }
+
+  //! Get the threshold between the given bin and the next one.
+  double Threshold(const size_t dim, const size_t bin) const
+  {
+    return thresholds[dim][bin];
+  }
+
+  //! Get the bin codes (one row per point, one column per dimension).
+  const arma::Mat<unsigned char>& Codes() const { return codes; }
+
+ private:
+  //! The bin codes of each point.
+  arma::Mat<unsigned char> codes;
+  //! The thresholds between the bins of each dimension.
+  std::vector<arma::vec> thresholds;
+  //! The offset of the bins of each dimension.
+  arma::Col<size_t> binOffsets;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,228 @@
+/**
+ * @file category_counts.hpp
+ *
+ * A table of the number of points (or the sum of their weights) of every class
+ * in every category of a categorical feature, shared by the categorical splits
+ * of decision trees and Hoeffding trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_CATEGORY_COUNTS_HPP
+#define MLPACK_METHODS_DECISION_TREE_CATEGORY_COUNTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <unordered_map>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The CategoryCounts class holds a category x class count table of a
+ * categorical feature.  The table has one column per category, holding the
+ * count of every class.  For features with few categories, the table is dense
+ * and column i belongs to category i.  When the dense table would be larger
+ * than the given limit, it is sparse: it only has columns for the categories
+ * that have been seen, in the order they were first seen, so its size is
+ * bounded by the number of points and not by the number of categories.
+ *
+ * Categories that have not been seen have zero counts, so fitness functions
+ * that sum over the categories can be evaluated directly on Table().
+ *
+ * @tparam CountType Type of the counts (size_t for counts of points, double for
+ *     sums of weights).
+ */
+template<typename CountType>
+class CategoryCounts
+{
+ public:
+  /**
+   * Create an empty table.
+   *
+   * @param numCategories Number of categories of the feature.
+   * @param numClasses Number of classes.
+   * @param maxDenseSize Largest number of entries of a dense table.
+   */
+  CategoryCounts(const size_t numCategories = 0,
+                 const size_t numClasses = 0,
+                 const size_t maxDenseSize = 1 << 20) :
+      numCategories(numCategories),
+      numClasses(numClasses),
+      sparse(numCategories * numClasses > maxDenseSize),
+      numColumns(sparse ? 0 : numCategories)
+  {
+    counts.assign(numColumns * numClasses, CountType(0));
+  }
+
+  /**
+   * Add a point of the given category and class.
+   *
+   * @param category Category of the point.
+   * @param label Class of the point.
+   * @param weight Weight of the point.
+   */
+  void Add(const size_t category,
+           const size_t label,
+           const CountType weight = CountType(1))
+  {
+    counts[AddColumn(category) * numClasses + label] += weight;
+  }
+
+  /**
+   * Add all of the given points in one pass.
+   *
+   * @param data Category of every point.
+   * @param labels Class of every point.
+   * @param weights Weight of every point (ignored unless UseWeights is true).
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  void Add(const VecType& data,
+           const arma::Row<size_t>& labels,
+           const WeightVecType& weights)
+  {
+    for (size_t i = 0; i < data.n_elem; ++i)
+    {
+      Add((size_t) data[i], labels[i],
+          UseWeights ? CountType(weights[i]) : CountType(1));
+    }
+  }
+
+  //! Get the number of categories of the feature.
+  size_t NumCategories() const { return numCategories; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get whether the table only holds the categories that have been seen.
+  bool IsSparse() const { return sparse; }
+  //! Get the number of columns of the table.
+  size_t NumColumns() const { return numColumns; }
+
+  /**
+   * Get the table (numClasses x NumColumns()).  The matrix is an alias of the
+   * counts, so it is only valid until the next point is added.
+   */
+  const arma::Mat<CountType> Table() const
+  {
+    return arma::Mat<CountType>(const_cast<CountType*>(counts.data()),
+        numClasses, numColumns, false, true);
+  }
+
+  //! Get the category of the given column of the table.
+  size_t Category(const size_t column) const
+  { return sparse ? categories[column] : column; }
+
+  //! Get the column of the given category, or NumColumns() if it has not been
+  //! seen.
+  size_t Column(const size_t category) const
+  {
+    if (!sparse)
+      return category;
+
+    std::unordered_map<size_t, size_t>::const_iterator it =
+        columns.find(category);
+    return (it == columns.end()) ? numColumns : it->second;
+  }
+
+  //! Get the count of the given class in the given category.
+  CountType Count(const size_t category, const size_t label) const
+  {
+    const size_t column = Column(category);
+    return (column == numColumns) ? CountType(0) :
+        counts[column * numClasses + label];
+  }
+
+  //! Get the count of every class over all categories.
+  arma::Col<CountType> ClassCounts() const { return arma::sum(Table(), 1); }
+
+  //! Get the total count of every column of the table.
+  arma::Row<CountType> ColumnTotals() const { return arma::sum(Table(), 0); }
+
+  /**
+   * Get the columns of the table with a nonzero total, sorted by the
+   * proportion of the given class in them.  For two classes, the best binary
+   * partition of the categories (for impurities like the Gini impurity or the
+   * entropy) splits this order into a prefix and a suffix.
+   *
+   * @param label Class to sort by.
+   * @param order Set to the sorted columns.
+   */
+  void SortByProportion(const size_t label, std::vector<size_t>& order) const
+  {
+    const arma::Row<CountType> totals = ColumnTotals();
+    std::vector<double> proportions(numColumns);
+    order.clear();
+    for (size_t c = 0; c < numColumns; ++c)
+    {
+      if (totals[c] > CountType(0))
+      {
+        proportions[c] = double(counts[c * numClasses + label]) /
+            double(totals[c]);
+        order.push_back(c);
+      }
+    }
+
+    std::stable_sort(order.begin(), order.end(),
+        [&](const size_t a, const size_t b)
+        { return proportions[a] < proportions[b]; });
+  }
+
+  //! Serialize the table.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numCategories);
+    ar & BOOST_SERIALIZATION_NVP(numClasses);
+    ar & BOOST_SERIALIZATION_NVP(sparse);
+    ar & BOOST_SERIALIZATION_NVP(numColumns);
+    ar & BOOST_SERIALIZATION_NVP(counts);
+    ar & BOOST_SERIALIZATION_NVP(categories);
+
+    if (Archive::is_loading::value)
+    {
+      columns.clear();
+      for (size_t c = 0; c < categories.size(); ++c)
+        columns[categories[c]] = c;
+    }
+  }
+
+ private:
+  //! The number of categories of the feature.
+  size_t numCategories;
+  //! The number of classes.
+  size_t numClasses;
+  //! Whether the table only holds the categories that have been seen.
+  bool sparse;
+  //! The number of columns of the table.
+  size_t numColumns;
+  //! The counts, column by column.
+  std::vector<CountType> counts;
+  //! The category of every column, if the table is sparse.
+  std::vector<size_t> categories;
+  //! The column of every category that has been seen, if the table is sparse.
+  std::unordered_map<size_t, size_t> columns;
+
+  //! Get the column of the given category, adding it if needed.
+  size_t AddColumn(const size_t category)
+  {
+    if (!sparse)
+      return category;
+
+    std::pair<std::unordered_map<size_t, size_t>::iterator, bool> result =
+        columns.insert(std::make_pair(category, numColumns));
+    if (result.second)
+    {
+      categories.push_back(category);
+      counts.resize(counts.size() + numClasses, CountType(0));
+      ++numColumns;
+    }
+
+    return result.first->second;
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -17,9 +17,19 @@
 #include "gini_gain.hpp"
 #include "best_binary_numeric_split.hpp"
 #include "all_categorical_split.hpp"
+#include "binary_categorical_split.hpp"
 #include "all_dimension_select.hpp"
+#include "binned_dataset.hpp"
+#include "node_values.hpp"
+#include "sparse_column.hpp"
 #include <type_traits>
 
+// Subtrees are built with OpenMP tasks, which are available since OpenMP 3.0.
+#if defined(HAS_OPENMP) && defined(_OPENMP) && (_OPENMP >= 200805)
+  #include <omp.h>
+  #define MLPACK_DECISION_TREE_USE_TASKS
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -29,6 +39,23 @@ namespace tree {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * Nodes with at least ParallelThreshold points are trained in parallel when
+ * OpenMP is available: the dimensions are searched for the best split at the
+ * same time, and the children are built as OpenMP tasks (so the idle threads
+ * of an enclosing parallel region, like the one of RandomForest::Train(), can
+ * help building the tree).  Each dimension of such a node is searched on its
+ * own, so the tree does not depend on the number of threads; the chosen split
+ * can only differ from the one of a sequential search between splits whose
+ * gains are within minimumGainSplit of each other.
+ *
+ * The data may also be an arma::SpMat (for instance, wide hashed features).
+ * The points are then never reordered or made dense: each node gathers the
+ * nonzero values of its points, only the dimensions where some point of the
+ * node is nonzero are searched, and BestBinaryNumericSplit scans only the
+ * nonzero values of a dimension, with the zero values handled as one block.
+ * Sparse points are classified by reading only the dimensions the tree splits
+ * on.
  */
 template<typename FitnessFunction = GiniGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -276,6 +303,101 @@ class DecisionTree :
              const std::enable_if_t<arma::is_arma_type<typename
                  std::remove_reference<WeightsType>::type>::value>* = 0);
 
+  /**
+   * Train the decision tree on the given points of the data, each with the
+   * given weight, without copying the data.  This will overwrite the existing
+   * model.  The data may have numeric and categorical types, specified by the
+   * datasetInfo parameter.  A point given with weight w is equivalent to w
+   * copies of the point, except that it only counts as one point for the
+   * minimum leaf size, so a bootstrap sample of the data can be given as the
+   * distinct points of the sample with their multiplicities as weights.
+   *
+   * @param data Dataset to take the points from.
+   * @param datasetInfo Type information for each dimension.
+   * @param points Indices of the points to train on.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of the points to train on (one for each index).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   */
+  template<typename MatType>
+  void TrainSubset(const MatType& data,
+                   const data::DatasetInfo& datasetInfo,
+                   const arma::uvec& points,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const arma::rowvec& weights,
+                   const size_t minimumLeafSize = 10,
+                   const double minimumGainSplit = 1e-7);
+
+  /**
+   * Train the decision tree on the given points of the data, each with the
+   * given weight, without copying the data and assuming that all dimensions
+   * are numeric.  This will overwrite the existing model.  See the overload
+   * with dataset information for details.
+   *
+   * @param data Dataset to take the points from.
+   * @param points Indices of the points to train on.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of the points to train on (one for each index).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   */
+  template<typename MatType>
+  void TrainSubset(const MatType& data,
+                   const arma::uvec& points,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const arma::rowvec& weights,
+                   const size_t minimumLeafSize = 10,
+                   const double minimumGainSplit = 1e-7);
+
+  /**
+   * Train the decision tree on the given binned data.  This will overwrite the
+   * existing model.  The splits of each node are found from histograms of the
+   * class counts in each bin of each dimension, so the points are never
+   * sorted; the histograms of the smaller child of each split are computed
+   * from its points, and those of the larger child are obtained by subtracting
+   * them from the histograms of the parent.  The possible splits are the
+   * thresholds between the bins, so if every dimension has at most as many
+   * distinct values as bins, the tree is the same as the one Train() builds.
+   *
+   * This is only available with BestBinaryNumericSplit, and with fitness
+   * functions that provide EvaluateCounts() (like GiniGain and
+   * InformationGain).
+   *
+   * @param data Binned dataset to train on.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   */
+  void TrainBinned(const BinnedDataset& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const size_t minimumLeafSize = 10,
+                   const double minimumGainSplit = 1e-7);
+
+  /**
+   * Train the decision tree on the given weighted binned data.  This will
+   * overwrite the existing model.  See the unweighted overload for details.
+   *
+   * @param data Binned dataset to train on.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   */
+  void TrainBinned(const BinnedDataset& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const arma::rowvec& weights,
+                   const size_t minimumLeafSize = 10,
+                   const double minimumGainSplit = 1e-7);
+
   /**
    * Classify the given point, using the entire tree.  The predicted label is
    * returned.
@@ -325,6 +447,32 @@ class DecisionTree :
                 arma::Row<size_t>& predictions,
                 arma::mat& probabilities) const;
 
+  /**
+   * Classify the given sparse points, using the entire tree.  The columns of
+   * the matrix are read directly, without making them dense.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename eT>
+  void Classify(const arma::SpMat<eT>& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given sparse points and also return estimates of the
+   * probabilities for each class in the given matrix.  The columns of the
+   * matrix are read directly, without making them dense.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename eT>
+  void Classify(const arma::SpMat<eT>& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
   /**
    * Serialize the tree.
    */
@@ -339,6 +487,24 @@ class DecisionTree :
   //! Modify the child of the given index (be careful!).
   DecisionTree& Child(const size_t i) { return *children[i]; }
 
+  //! Get the dimension this node splits on (only meaningful if it has
+  //! children).
+  size_t SplitDimension() const { return splitDimension; }
+
+  //! Get the type of the dimension this node splits on (only meaningful if it
+  //! has children).
+  data::Datatype SplitDimensionType() const
+  {
+    return (data::Datatype) dimensionTypeOrMajorityClass;
+  }
+
+  /**
+   * Get the class probabilities of a leaf.  If the node has children, this
+   * holds the split information of the split type instead (for instance, the
+   * threshold of a BestBinaryNumericSplit).
+   */
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -379,6 +545,26 @@ class DecisionTree :
   typedef typename CategoricalSplit::template AuxiliarySplitInfo<ElemType>
       CategoricalAuxiliarySplitInfo;
 
+  //! The number of points above which a node is trained in parallel.
+  static const size_t ParallelThreshold = 2048;
+
+  /**
+   * Call function(i) for each i in [0, n).  If parallel is true, this is done
+   * with tasks of the current team of threads, or in a new team of threads if
+   * there is no current team.
+   */
+  template<typename FunctionType>
+  static void ParallelFor(const size_t n,
+                          const bool parallel,
+                          FunctionType& function);
+
+  /**
+   * Get the dimensions to search for a split, in order.  The dimension
+   * selection may use the random number generator, so this is done in a
+   * critical section.
+   */
+  static std::vector<size_t> SelectDimensions(const size_t dimensionality);
+
   /**
    * Calculate the class probabilities of the given labels.
    */
@@ -436,6 +622,110 @@ class DecisionTree :
              arma::rowvec& weights,
              const size_t minimumLeafSize = 10,
              const double minimumGainSplit = 1e-7);
+
+  /**
+   * Train on the given sparse data.  Reordering the columns of a sparse matrix
+   * would rebuild it, so the points are given to TrainSubset() by index (with
+   * weights of 1 if UseWeights is false).
+   */
+  template<bool UseWeights, typename eT>
+  void Train(arma::SpMat<eT>& data,
+             const size_t begin,
+             const size_t count,
+             const data::DatasetInfo& datasetInfo,
+             arma::Row<size_t>& labels,
+             const size_t numClasses,
+             arma::rowvec& weights,
+             const size_t minimumLeafSize = 10,
+             const double minimumGainSplit = 1e-7);
+
+  /**
+   * Train on the given sparse data, assuming all dimensions are numeric.  See
+   * the overload with dataset information for details.
+   */
+  template<bool UseWeights, typename eT>
+  void Train(arma::SpMat<eT>& data,
+             const size_t begin,
+             const size_t count,
+             arma::Row<size_t>& labels,
+             const size_t numClasses,
+             arma::rowvec& weights,
+             const size_t minimumLeafSize = 10,
+             const double minimumGainSplit = 1e-7);
+
+  /**
+   * Train a node on the given points of the data.  The points of the node are
+   * points[begin, begin + count), with weights weights[begin, begin + count);
+   * both are reordered so that the points of each child are contiguous.
+   *
+   * @param data Dataset to take the points from.
+   * @param datasetInfo Type information for each dimension (ignored if
+   *      UseDatasetInfo is false, in which case all dimensions are numeric).
+   * @param points Indices of the points of each node (will be reordered).
+   * @param weights Weights of the points of each node (will be reordered).
+   * @param begin Index in points of the first point of this node.
+   * @param count Number of points in this node.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   */
+  template<bool UseDatasetInfo, typename MatType>
+  void TrainSubset(const MatType& data,
+                   const data::DatasetInfo& datasetInfo,
+                   arma::uvec& points,
+                   arma::rowvec& weights,
+                   const size_t begin,
+                   const size_t count,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const size_t minimumLeafSize,
+                   const double minimumGainSplit);
+
+  /**
+   * Train a node on the given binned data.  The points of the node are
+   * points[begin, begin + count), and the histogram holds the sum of the
+   * weights of each class in each bin (one column per bin of each dimension;
+   * see BinnedDataset::BinOffsets()), with the number of points in each bin in
+   * the last row.  The histogram is used as storage for the histograms of
+   * the children, so it is modified.
+   *
+   * @param data Binned dataset to train on.
+   * @param points Indices of the points of each node (will be reordered).
+   * @param begin Index in points of the first point of this node.
+   * @param count Number of points in this node.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels (ignored without weights).
+   * @param histogram Histogram of the points of this node.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   */
+  template<bool UseWeights>
+  void TrainBinned(const BinnedDataset& data,
+                   arma::uvec& points,
+                   const size_t begin,
+                   const size_t count,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const arma::rowvec& weights,
+                   arma::mat& histogram,
+                   const size_t minimumLeafSize,
+                   const double minimumGainSplit);
+
+  /**
+   * Compute the histogram of the given points of the binned data (see
+   * TrainBinned()).  This is done in parallel over the dimensions.
+   */
+  template<bool UseWeights>
+  static void BuildHistogram(const BinnedDataset& data,
+                             const arma::uvec& points,
+                             const size_t begin,
+                             const size_t count,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses,
+                             const arma::rowvec& weights,
+                             arma::mat& histogram);
 };
 
 /**
@@ -550,47 +550,120 @@ void DecisionTree<FitnessFunction,
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
-  DimensionSelectionType dimensions(datasetInfo.Dimensionality());
-  for (size_t i = dimensions.Begin(); i != dimensions.End();
-       i = dimensions.Next())
+  const std::vector<size_t> dimensions =
+      SelectDimensions(datasetInfo.Dimensionality());
+  if (count < ParallelThreshold)
   {
-    double dimGain = -DBL_MAX;
-    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    for (size_t k = 0; k < dimensions.size(); ++k)
     {
-      dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-          data.cols(begin, begin + count - 1).row(i),
-          datasetInfo.NumMappings(i),
-          labels.subvec(begin, begin + count - 1),
-          numClasses,
-          UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-          minimumLeafSize,
-          minimumGainSplit,
-          classProbabilities,
-          *this);
+      const size_t i = dimensions[k];
+      double dimGain = -DBL_MAX;
+      if (datasetInfo.Type(i) == data::Datatype::categorical)
+      {
+        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(
+            bestGain,
+            data.cols(begin, begin + count - 1).row(i),
+            datasetInfo.NumMappings(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            classProbabilities,
+            *this);
+      }
+      else if (datasetInfo.Type(i) == data::Datatype::numeric)
+      {
+        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+            data.cols(begin, begin + count - 1).row(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            classProbabilities,
+            *this);
+      }
+
+      // Was there an improvement?  If so mark that it's the new best
+      // dimension.
+      if (dimGain > bestGain)
+      {
+        bestDim = i;
+        bestGain = dimGain;
+      }
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
     }
-    else if (datasetInfo.Type(i) == data::Datatype::numeric)
+  }
+  else
+  {
+    // Search each dimension on its own against the gain of the node, with its
+    // own auxiliary information, and then take the first dimension that
+    // improves enough on the dimensions before it.
+    const double nodeGain = bestGain;
+    std::vector<double> dimGains(dimensions.size(), nodeGain);
+    std::vector<arma::vec> dimProbabilities(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+    std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(
+        dimensions.size());
+    auto searchDimension = [&](const size_t k)
     {
-      dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-          data.cols(begin, begin + count - 1).row(i),
-          labels.subvec(begin, begin + count - 1),
-          numClasses,
-          UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-          minimumLeafSize,
-          minimumGainSplit,
-          classProbabilities,
-          *this);
-    }
+      const size_t i = dimensions[k];
+      if (datasetInfo.Type(i) == data::Datatype::categorical)
+      {
+        dimGains[k] = CategoricalSplit::template SplitIfBetter<UseWeights>(
+            nodeGain,
+            data.cols(begin, begin + count - 1).row(i),
+            datasetInfo.NumMappings(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            dimProbabilities[k],
+            categoricalAux[k]);
+      }
+      else if (datasetInfo.Type(i) == data::Datatype::numeric)
+      {
+        dimGains[k] = NumericSplit::template SplitIfBetter<UseWeights>(
+            nodeGain,
+            data.cols(begin, begin + count - 1).row(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            dimProbabilities[k],
+            numericAux[k]);
+      }
+    };
+    ParallelFor(dimensions.size(), true, searchDimension);
 
-    // Was there an improvement?  If so mark that it's the new best dimension.
-    if (dimGain > bestGain)
+    for (size_t k = 0; k < dimensions.size(); ++k)
     {
-      bestDim = i;
-      bestGain = dimGain;
-    }
+      if (dimGains[k] > nodeGain && (dimGains[k] >= 0.0 ||
+          dimGains[k] > bestGain + minimumGainSplit))
+      {
+        bestDim = dimensions[k];
+        bestGain = dimGains[k];
+        classProbabilities = std::move(dimProbabilities[k]);
+        if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+        {
+          CategoricalAuxiliarySplitInfo::operator=(categoricalAux[k]);
+        }
+        else
+        {
+          NumericAuxiliarySplitInfo::operator=(numericAux[k]);
+        }
+      }
 
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -629,11 +702,12 @@ void DecisionTree<FitnessFunction,
       childCounts[childAssignments[i - begin]]++;
 
     // Split into children.
+    std::vector<size_t> childBegins(numChildren + 1, begin + count);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -646,22 +720,19 @@ void DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit);
-      }
-      else
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit);
-      }
-      children.push_back(child);
+      children.push_back(new DecisionTree());
     }
+
+    // Now build the children recursively.  They own disjoint ranges of
+    // columns, so they can be built at the same time.
+    auto buildChild = [&](const size_t i)
+    {
+      const size_t childCount = childBegins[i + 1] - childBegins[i];
+      children[i]->Train<UseWeights>(data, childBegins[i], childCount,
+          datasetInfo, labels, numClasses, weights,
+          NoRecursion ? childCount : minimumLeafSize, minimumGainSplit);
+    };
+    ParallelFor(numChildren, count >= ParallelThreshold, buildChild);
   }
   else
   {
@@ -717,30 +788,72 @@ void DecisionTree<FitnessFunction,
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = data.n_rows; // This means "no split".
-  for (size_t i = 0; i < data.n_rows; ++i)
+  if (count < ParallelThreshold)
   {
-    const double dimGain = NumericSplitType<FitnessFunction>::template
-        SplitIfBetter<UseWeights>(bestGain,
-                                  data.cols(begin, begin + count - 1).row(i),
-                                  labels.cols(begin, begin + count - 1),
-                                  numClasses,
-                                  UseWeights ?
-                                      weights.cols(begin, begin + count - 1) :
-                                      weights,
-                                  minimumLeafSize,
-                                  minimumGainSplit,
-                                  classProbabilities,
-                                  *this);
-
-    if (dimGain > bestGain)
+    for (size_t i = 0; i < data.n_rows; ++i)
     {
-      bestDim = i;
-      bestGain = dimGain;
+      const double dimGain = NumericSplitType<FitnessFunction>::template
+          SplitIfBetter<UseWeights>(bestGain,
+                                    data.cols(begin, begin + count - 1).row(i),
+                                    labels.cols(begin, begin + count - 1),
+                                    numClasses,
+                                    UseWeights ?
+                                        weights.cols(begin, begin + count - 1) :
+                                        weights,
+                                    minimumLeafSize,
+                                    minimumGainSplit,
+                                    classProbabilities,
+                                    *this);
+
+      if (dimGain > bestGain)
+      {
+        bestDim = i;
+        bestGain = dimGain;
+      }
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
     }
+  }
+  else
+  {
+    // Search each dimension on its own against the gain of the node, with its
+    // own auxiliary information, and then take the first dimension that
+    // improves enough on the dimensions before it.
+    const double nodeGain = bestGain;
+    std::vector<double> dimGains(data.n_rows, nodeGain);
+    std::vector<arma::vec> dimProbabilities(data.n_rows);
+    std::vector<NumericAuxiliarySplitInfo> numericAux(data.n_rows);
+    auto searchDimension = [&](const size_t i)
+    {
+      dimGains[i] = NumericSplit::template SplitIfBetter<UseWeights>(nodeGain,
+          data.cols(begin, begin + count - 1).row(i),
+          labels.cols(begin, begin + count - 1),
+          numClasses,
+          UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+          minimumLeafSize,
+          minimumGainSplit,
+          dimProbabilities[i],
+          numericAux[i]);
+    };
+    ParallelFor(data.n_rows, true, searchDimension);
+
+    for (size_t i = 0; i < data.n_rows; ++i)
+    {
+      if (dimGains[i] > nodeGain && (dimGains[i] >= 0.0 ||
+          dimGains[i] > bestGain + minimumGainSplit))
+      {
+        bestDim = i;
+        bestGain = dimGains[i];
+        classProbabilities = std::move(dimProbabilities[i]);
+        NumericAuxiliarySplitInfo::operator=(numericAux[i]);
+      }
 
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -766,11 +879,12 @@ void DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
       childCounts[childAssignments[j - begin]]++;
 
+    std::vector<size_t> childBegins(numChildren + 1, begin + count);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -783,34 +897,772 @@ void DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
+      children.push_back(new DecisionTree());
+    }
+
+    // Now build the children recursively.  They own disjoint ranges of
+    // columns, so they can be built at the same time.
+    auto buildChild = [&](const size_t i)
+    {
+      const size_t childCount = childBegins[i + 1] - childBegins[i];
+      children[i]->Train<UseWeights>(data, childBegins[i], childCount, labels,
+          numClasses, weights, NoRecursion ? childCount : minimumLeafSize,
+          minimumGainSplit);
+    };
+    ParallelFor(numChildren, count >= ParallelThreshold, buildChild);
+  }
+  else
+  {
+    // We won't be needing these members, so reset them.
+    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+
+    // Calculate class probabilities because we are a leaf.
+    CalculateClassProbabilities<UseWeights>(
+        labels.subvec(begin, begin + count - 1),
+        numClasses,
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  }
+}
+
+//! Train on the given sparse data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename eT>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::Train(arma::SpMat<eT>& data,
+                                      const size_t begin,
+                                      const size_t count,
+                                      const data::DatasetInfo& datasetInfo,
+                                      arma::Row<size_t>& labels,
+                                      const size_t numClasses,
+                                      arma::rowvec& weights,
+                                      const size_t minimumLeafSize,
+                                      const double minimumGainSplit)
+{
+  arma::uvec points = arma::regspace<arma::uvec>(begin, begin + count - 1);
+  arma::rowvec pointWeights;
+  if (UseWeights)
+    pointWeights = weights.subvec(begin, begin + count - 1);
+  else
+    pointWeights.ones(count);
+
+  TrainSubset<true>(data, datasetInfo, points, pointWeights, 0, count, labels,
+      numClasses, minimumLeafSize, minimumGainSplit);
+}
+
+//! Train on the given sparse data, assuming all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename eT>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::Train(arma::SpMat<eT>& data,
+                                      const size_t begin,
+                                      const size_t count,
+                                      arma::Row<size_t>& labels,
+                                      const size_t numClasses,
+                                      arma::rowvec& weights,
+                                      const size_t minimumLeafSize,
+                                      const double minimumGainSplit)
+{
+  arma::uvec points = arma::regspace<arma::uvec>(begin, begin + count - 1);
+  arma::rowvec pointWeights;
+  if (UseWeights)
+    pointWeights = weights.subvec(begin, begin + count - 1);
+  else
+    pointWeights.ones(count);
+
+  data::DatasetInfo info; // Ignored by TrainSubset().
+  TrainSubset<false>(data, info, points, pointWeights, 0, count, labels,
+      numClasses, minimumLeafSize, minimumGainSplit);
+}
+
+//! Train on the given weighted points of the data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::TrainSubset(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    const arma::uvec& points,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit)
+{
+  // Sanity check on data.
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::TrainSubset(): number of points (" << data.n_cols
+        << ") does not match number of labels (" << labels.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (points.n_elem != weights.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::TrainSubset(): number of indices (" << points.n_elem
+        << ") does not match number of weights (" << weights.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Only the indices and weights are copied, since they will be reordered.
+  arma::uvec tmpPoints(points);
+  arma::rowvec tmpWeights(weights);
+  TrainSubset<true>(data, datasetInfo, tmpPoints, tmpWeights, 0,
+      tmpPoints.n_elem, labels, numClasses, minimumLeafSize, minimumGainSplit);
+}
+
+//! Train on the given weighted points of the data, assuming all dimensions are
+//! numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::TrainSubset(
+    const MatType& data,
+    const arma::uvec& points,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit)
+{
+  // Sanity check on data.
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::TrainSubset(): number of points (" << data.n_cols
+        << ") does not match number of labels (" << labels.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (points.n_elem != weights.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::TrainSubset(): number of indices (" << points.n_elem
+        << ") does not match number of weights (" << weights.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Only the indices and weights are copied, since they will be reordered.
+  data::DatasetInfo info; // Ignored by TrainSubset().
+  arma::uvec tmpPoints(points);
+  arma::rowvec tmpWeights(weights);
+  TrainSubset<false>(data, info, tmpPoints, tmpWeights, 0, tmpPoints.n_elem,
+      labels, numClasses, minimumLeafSize, minimumGainSplit);
+}
+
+//! Train a node on the given weighted points of the data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseDatasetInfo, typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::TrainSubset(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    arma::uvec& points,
+    arma::rowvec& weights,
+    const size_t begin,
+    const size_t count,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit)
+{
+  // Clear children if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // Gather the labels of the points of the node; the values of each dimension
+  // are gathered when the dimension is searched (for sparse data, only the
+  // nonzero values are gathered, once).
+  const arma::uvec nodePoints = points.subvec(begin, begin + count - 1);
+  const arma::Row<size_t> nodeLabels = labels.cols(nodePoints);
+  const arma::rowvec nodeWeights = weights.subvec(begin, begin + count - 1);
+  const NodeValues<MatType> nodeValues(data, nodePoints, nodeLabels,
+      nodeWeights, numClasses);
+
+  auto isCategorical = [&](const size_t i)
+  {
+    return UseDatasetInfo &&
+        datasetInfo.Type(i) == data::Datatype::categorical;
+  };
+
+  // Search the given dimension for a split better than the given gain.
+  auto searchDimension = [&](const size_t i,
+                             const double gain,
+                             arma::vec& probabilities,
+                             NumericAuxiliarySplitInfo& numericAux,
+                             CategoricalAuxiliarySplitInfo& categoricalAux)
+  {
+    if (isCategorical(i))
+    {
+      arma::Row<typename MatType::elem_type> values;
+      nodeValues.Values(i, values);
+      return CategoricalSplit::template SplitIfBetter<true>(gain, values,
+          datasetInfo.NumMappings(i), nodeLabels, numClasses, nodeWeights,
+          minimumLeafSize, minimumGainSplit, probabilities, categoricalAux);
+    }
+    else
+    {
+      return nodeValues.template NumericSplitIfBetter<NumericSplit>(i, gain,
+          numClasses, minimumLeafSize, minimumGainSplit, probabilities,
+          numericAux);
+    }
+  };
+
+  // Look through the list of dimensions and obtain the gain of the best split,
+  // like Train() does.  Dimensions that cannot be split (like the dimensions
+  // of sparse data where all the points of the node are zero) are skipped.
+  double bestGain = FitnessFunction::template Evaluate<true>(nodeLabels,
+      numClasses, nodeWeights);
+  size_t bestDim = data.n_rows; // This means "no split".
+  std::vector<size_t> dimensions;
+  if (!UseDatasetInfo ||
+      std::is_same<DimensionSelectionType, AllDimensionSelect>::value)
+  {
+    dimensions = nodeValues.Dimensions();
+  }
+  else
+  {
+    dimensions = SelectDimensions(datasetInfo.Dimensionality());
+    nodeValues.FilterDimensions(dimensions);
+  }
+
+  if (count < ParallelThreshold)
+  {
+    for (size_t k = 0; k < dimensions.size(); ++k)
+    {
+      const double dimGain = searchDimension(dimensions[k], bestGain,
+          classProbabilities, *this, *this);
+
+      // Was there an improvement?  If so mark that it's the new best
+      // dimension.
+      if (dimGain > bestGain)
+      {
+        bestDim = dimensions[k];
+        bestGain = dimGain;
+      }
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+  else
+  {
+    const double nodeGain = bestGain;
+    std::vector<double> dimGains(dimensions.size(), nodeGain);
+    std::vector<arma::vec> dimProbabilities(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+    std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(
+        dimensions.size());
+    auto searchDimensionAlone = [&](const size_t k)
+    {
+      dimGains[k] = searchDimension(dimensions[k], nodeGain,
+          dimProbabilities[k], numericAux[k], categoricalAux[k]);
+    };
+    ParallelFor(dimensions.size(), true, searchDimensionAlone);
+
+    for (size_t k = 0; k < dimensions.size(); ++k)
+    {
+      if (dimGains[k] > nodeGain && (dimGains[k] >= 0.0 ||
+          dimGains[k] > bestGain + minimumGainSplit))
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit);
+        bestDim = dimensions[k];
+        bestGain = dimGains[k];
+        classProbabilities = std::move(dimProbabilities[k]);
+        if (isCategorical(bestDim))
+          CategoricalAuxiliarySplitInfo::operator=(categoricalAux[k]);
+        else
+          NumericAuxiliarySplitInfo::operator=(numericAux[k]);
+      }
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+
+  // Did we split or not?  If so, then split the points and create the
+  // children.
+  if (bestDim != data.n_rows)
+  {
+    const bool categorical = isCategorical(bestDim);
+    dimensionTypeOrMajorityClass = (size_t) (categorical ?
+        data::Datatype::categorical : data::Datatype::numeric);
+    splitDimension = bestDim;
+
+    // Get the number of children we will have.
+    const size_t numChildren = categorical ?
+        CategoricalSplit::NumChildren(classProbabilities, *this) :
+        NumericSplit::NumChildren(classProbabilities, *this);
+
+    // Calculate all child assignments.
+    arma::Row<typename MatType::elem_type> bestValues;
+    nodeValues.Values(bestDim, bestValues);
+    arma::Row<size_t> childAssignments(count);
+    for (size_t j = 0; j < count; ++j)
+    {
+      const ElemType value = bestValues[j];
+      childAssignments[j] = categorical ?
+          CategoricalSplit::CalculateDirection(value, classProbabilities,
+              *this) :
+          NumericSplit::CalculateDirection(value, classProbabilities, *this);
+    }
+
+    // Split the indices and weights into children.
+    std::vector<size_t> childBegins(numChildren + 1, begin + count);
+    size_t current = begin;
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      childBegins[i] = current;
+      for (size_t j = childBegins[i]; j < begin + count; ++j)
+      {
+        if (childAssignments[j - begin] == i)
+        {
+          childAssignments.swap_cols(current - begin, j - begin);
+          points.swap_rows(current, j);
+          weights.swap_cols(current, j);
+          ++current;
+        }
+      }
+
+      children.push_back(new DecisionTree());
+    }
+
+    // Now build the children recursively.  They own disjoint ranges of
+    // indices, so they can be built at the same time.
+    auto buildChild = [&](const size_t i)
+    {
+      const size_t childCount = childBegins[i + 1] - childBegins[i];
+      children[i]->TrainSubset<UseDatasetInfo>(data, datasetInfo, points,
+          weights, childBegins[i], childCount, labels, numClasses,
+          NoRecursion ? childCount : minimumLeafSize, minimumGainSplit);
+    };
+    ParallelFor(numChildren, count >= ParallelThreshold, buildChild);
+  }
+  else
+  {
+    // Clear auxiliary info objects.
+    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+
+    // Calculate class probabilities because we are a leaf.
+    CalculateClassProbabilities<true>(nodeLabels, numClasses, nodeWeights);
+  }
+}
+
+//! Train on the given binned data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::TrainBinned(
+    const BinnedDataset& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit)
+{
+  // Sanity check on data.
+  if (data.NumPoints() != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::TrainBinned(): number of points ("
+        << data.NumPoints() << ") does not match number of labels ("
+        << labels.n_elem << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::uvec points = arma::linspace<arma::uvec>(0, data.NumPoints() - 1,
+      data.NumPoints());
+  arma::rowvec weights; // Fake weights, not used.
+  arma::mat histogram;
+  BuildHistogram<false>(data, points, 0, points.n_elem, labels, numClasses,
+      weights, histogram);
+
+  TrainBinned<false>(data, points, 0, points.n_elem, labels, numClasses,
+      weights, histogram, minimumLeafSize, minimumGainSplit);
+}
+
+//! Train on the given weighted binned data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::TrainBinned(
+    const BinnedDataset& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit)
+{
+  // Sanity check on data.
+  if (data.NumPoints() != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::TrainBinned(): number of points ("
+        << data.NumPoints() << ") does not match number of labels ("
+        << labels.n_elem << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::uvec points = arma::linspace<arma::uvec>(0, data.NumPoints() - 1,
+      data.NumPoints());
+  arma::mat histogram;
+  BuildHistogram<true>(data, points, 0, points.n_elem, labels, numClasses,
+      weights, histogram);
+
+  TrainBinned<true>(data, points, 0, points.n_elem, labels, numClasses,
+      weights, histogram, minimumLeafSize, minimumGainSplit);
+}
+
+//! Train a node on the given binned data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::TrainBinned(
+    const BinnedDataset& data,
+    arma::uvec& points,
+    const size_t begin,
+    const size_t count,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    arma::mat& histogram,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit)
+{
+  static_assert(std::is_same<NumericSplit,
+      BestBinaryNumericSplit<FitnessFunction>>::value,
+      "DecisionTree::TrainBinned() requires BestBinaryNumericSplit!");
+
+  // Clear children if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // We won't be using these members, so reset them.
+  CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+
+  // The class counts of the node are the sums over the bins of any dimension.
+  const arma::Col<size_t>& offsets = data.BinOffsets();
+  const arma::vec nodeCounts = arma::sum(histogram.submat(0, offsets[0],
+      numClasses - 1, offsets[1] - 1), 1);
+  const double nodeWeight = UseWeights ? arma::accu(nodeCounts) :
+      (double) count;
+
+  // Look through the list of dimensions and obtain the best split, sweeping
+  // through the bins of each dimension with running class counts, like
+  // BestBinaryNumericSplit does with the sorted points.  Also, force a minimum
+  // leaf size of 1 (empty children don't make sense).
+  double bestGain = FitnessFunction::EvaluateCounts(nodeCounts, nodeWeight);
+  size_t bestDim = data.Dimensionality(); // This means "no split".
+  size_t bestBin = 0;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  arma::vec leftCounts(numClasses);
+  const std::vector<size_t> dimensions =
+      SelectDimensions(data.Dimensionality());
+  for (size_t k = 0; k < dimensions.size() && bestGain < 0.0; ++k)
+  {
+    const size_t i = dimensions[k];
+    leftCounts.zeros();
+    size_t leftPoints = 0;
+    for (size_t b = 0; b + 1 < data.NumBins(i); ++b)
+    {
+      // An empty bin gives the same split as the previous one.
+      const size_t bin = offsets[i] + b;
+      if (histogram(numClasses, bin) == 0.0)
+        continue;
+
+      leftCounts += histogram.submat(0, bin, numClasses - 1, bin);
+      leftPoints += (size_t) histogram(numClasses, bin);
+      if (leftPoints < minimum)
+        continue;
+      if (count - leftPoints < minimum)
+        break;
+
+      // Calculate the gain for the left and right child.
+      const double leftWeight = UseWeights ? arma::accu(leftCounts) :
+          (double) leftPoints;
+      const double rightWeight = nodeWeight - leftWeight;
+      const double leftGain = FitnessFunction::EvaluateCounts(leftCounts,
+          leftWeight);
+      const double rightGain = FitnessFunction::EvaluateCounts(
+          nodeCounts - leftCounts, rightWeight);
+
+      double gain;
+      if (UseWeights)
+      {
+        gain = (leftWeight / nodeWeight) * leftGain +
+            (rightWeight / nodeWeight) * rightGain;
       }
       else
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit);
+        const double leftRatio = double(leftPoints) / double(count);
+        const double rightRatio = 1.0 - leftRatio;
+        gain = leftRatio * leftGain + rightRatio * rightGain;
+      }
+
+      // Take the split if it is better, or if it is the best possible split
+      // (in which case we stop looking).
+      if (gain >= 0.0 || gain > bestGain + minimumGainSplit)
+      {
+        bestGain = gain;
+        bestDim = i;
+        bestBin = b;
+        if (gain >= 0.0)
+          break;
       }
-      children.push_back(child);
     }
   }
+
+  // Did we split or not?  If so, then split the points and create the
+  // children.
+  if (bestDim != data.Dimensionality())
+  {
+    // We know that the split is numeric.
+    splitDimension = bestDim;
+    dimensionTypeOrMajorityClass = (size_t) data::Datatype::numeric;
+    classProbabilities.set_size(1);
+    classProbabilities[0] = data.Threshold(bestDim, bestBin);
+
+    // Move the points of the left child to the front.
+    const unsigned char* codes = data.Codes().colptr(bestDim);
+    arma::uword* first = points.memptr() + begin;
+    arma::uword* middle = std::partition(first, first + count,
+        [codes, bestBin](const arma::uword p) { return codes[p] <= bestBin; });
+    const size_t leftCount = (size_t) (middle - first);
+    const size_t rightCount = count - leftCount;
+
+    // Only compute the histogram of the smaller child; the histogram of the
+    // larger child is the difference, and it can take the place of ours.
+    const bool leftSmaller = (leftCount <= rightCount);
+    arma::mat smallHistogram;
+    BuildHistogram<UseWeights>(data, points,
+        leftSmaller ? begin : begin + leftCount,
+        leftSmaller ? leftCount : rightCount, labels, numClasses, weights,
+        smallHistogram);
+    histogram -= smallHistogram;
+
+    // The children own disjoint ranges of points and their own histograms, so
+    // they can be built at the same time.
+    children.push_back(new DecisionTree());
+    children.push_back(new DecisionTree());
+    auto buildChild = [&](const size_t i)
+    {
+      const size_t childBegin = (i == 0) ? begin : begin + leftCount;
+      const size_t childCount = (i == 0) ? leftCount : rightCount;
+      children[i]->TrainBinned<UseWeights>(data, points, childBegin,
+          childCount, labels, numClasses, weights,
+          ((i == 0) == leftSmaller) ? smallHistogram : histogram,
+          NoRecursion ? childCount : minimumLeafSize, minimumGainSplit);
+    };
+    ParallelFor(2, count >= ParallelThreshold, buildChild);
+  }
   else
   {
     // We won't be needing these members, so reset them.
     NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
 
     // Calculate class probabilities because we are a leaf.
-    CalculateClassProbabilities<UseWeights>(
-        labels.subvec(begin, begin + count - 1),
-        numClasses,
-        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+    classProbabilities = nodeCounts / nodeWeight;
+    arma::uword maxIndex = 0;
+    classProbabilities.max(maxIndex);
+    dimensionTypeOrMajorityClass = (size_t) maxIndex;
+  }
+}
+
+//! Compute the histogram of some points of the binned data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::BuildHistogram(
+    const BinnedDataset& data,
+    const arma::uvec& points,
+    const size_t begin,
+    const size_t count,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    arma::mat& histogram)
+{
+  const arma::Col<size_t>& offsets = data.BinOffsets();
+  histogram.zeros(numClasses + 1, data.TotalBins());
+
+  // Each dimension has its own columns of the histogram.
+  #pragma omp parallel for schedule(dynamic) if (count >= 4096)
+  for (omp_size_t d = 0; d < (omp_size_t) data.Dimensionality(); ++d)
+  {
+    const unsigned char* codes = data.Codes().colptr(d);
+    double* bins = histogram.colptr(offsets[d]);
+    for (size_t i = begin; i < begin + count; ++i)
+    {
+      const size_t point = points[i];
+      double* bin = bins + (numClasses + 1) * codes[point];
+      bin[labels[point]] += UseWeights ? weights[point] : 1.0;
+      bin[numClasses] += 1.0;
+    }
+  }
+}
+
+//! Call the function for each index, possibly in parallel.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename FunctionType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::ParallelFor(const size_t n,
+                                            const bool parallel,
+                                            FunctionType& function)
+{
+#ifdef MLPACK_DECISION_TREE_USE_TASKS
+  if (parallel && n > 1)
+  {
+    if (omp_in_parallel())
+    {
+      // Threads of the team that are waiting (for instance at the end of an
+      // enclosing parallel loop) will pick up these tasks.
+      for (size_t i = 0; i < n; ++i)
+      {
+        #pragma omp task shared(function)
+        function(i);
+      }
+
+      #pragma omp taskwait
+    }
+    else
+    {
+      // Any tasks created by the calls will run in this team of threads.
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+        function((size_t) i);
+    }
+
+    return;
   }
+#else
+  (void) parallel;
+#endif
+
+  for (size_t i = 0; i < n; ++i)
+    function(i);
+}
+
+//! Get the dimensions to search for a split.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+std::vector<size_t> DecisionTree<FitnessFunction,
+                                 NumericSplitType,
+                                 CategoricalSplitType,
+                                 DimensionSelectionType,
+                                 ElemType,
+                                 NoRecursion>::SelectDimensions(
+    const size_t dimensionality)
+{
+  std::vector<size_t> dimensions;
+  #pragma omp critical(decision_tree_select_dimensions)
+  {
+    DimensionSelectionType selection(dimensionality);
+    for (size_t i = selection.Begin(); i != selection.End();
+         i = selection.Next())
+      dimensions.push_back(i);
+  }
+
+  return dimensions;
 }
 
 //! Return the class.
@@ -932,6 +1784,67 @@ void DecisionTree<FitnessFunction,
   }
 }
 
+//! Return the class for a set of sparse points.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename eT>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::Classify(const arma::SpMat<eT>& data,
+                                         arma::Row<size_t>& predictions) const
+{
+  predictions.set_size(data.n_cols);
+  if (children.size() == 0)
+  {
+    predictions.fill(dimensionTypeOrMajorityClass);
+    return;
+  }
+
+  // Loop over each point.
+  for (size_t i = 0; i < data.n_cols; ++i)
+    predictions[i] = Classify(SparseColumn<eT>(data, i));
+}
+
+//! Return the class probabilities for a set of sparse points.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename eT>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::Classify(const arma::SpMat<eT>& data,
+                                         arma::Row<size_t>& predictions,
+                                         arma::mat& probabilities) const
+{
+  predictions.set_size(data.n_cols);
+  if (children.size() == 0)
+  {
+    predictions.fill(dimensionTypeOrMajorityClass);
+    probabilities = arma::repmat(classProbabilities, 1, data.n_cols);
+    return;
+  }
+
+  probabilities.set_size(NumClasses(), data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::vec v = probabilities.unsafe_col(i); // Alias of column.
+    Classify(SparseColumn<eT>(data, i), predictions[i], v);
+  }
+}
+
 //! Serialize the tree.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -60,9 +60,6 @@ class GiniGain
     arma::vec counts4(countSpace.memptr() + 3 * numClasses, numClasses, false,
         true);
 
-    // Calculate the Gini impurity of the un-split node.
-    double impurity = 0.0;
-
     if (UseWeights)
     {
       // Sum all the weights up.
@@ -124,15 +121,7 @@ class GiniGain
       accWeights[0] += accWeights[1] + accWeights[2] + accWeights[3];
       counts += counts2 + counts3 + counts4;
 
-      // Catch edge case: if there are no weights, the impurity is zero.
-      if (accWeights[0] == 0.0)
-        return 0.0;
-
-      for (size_t i = 0; i < numClasses; ++i)
-      {
-        const double f = ((double) counts[i] / (double) accWeights[0]);
-        impurity += f * (1.0 - f);
-      }
+      return EvaluateCounts(counts, accWeights[0]);
     }
     else
     {
@@ -164,12 +153,31 @@ class GiniGain
       }
 
       counts += counts2 + counts3 + counts4;
+    }
 
-      for (size_t i = 0; i < numClasses; ++i)
-      {
-        const double f = ((double) counts[i] / (double) labels.n_elem);
-        impurity += f * (1.0 - f);
-      }
+    return EvaluateCounts(counts, (double) labels.n_elem);
+  }
+
+  /**
+   * Evaluate the Gini impurity of a set of points, given the number of points
+   * (or the sum of the weights of the points) in each class.  This takes
+   * O(numClasses) time, so a split search can keep running class counts and
+   * evaluate every split point without going through the labels again.
+   *
+   * @param counts Number of points (or sum of weights) in each class.
+   * @param total Number of points (or sum of weights) in all classes.
+   */
+  static double EvaluateCounts(const arma::vec& counts, const double total)
+  {
+    // Corner case: if there are no points, the impurity is zero.
+    if (total == 0.0)
+      return 0.0;
+
+    double impurity = 0.0;
+    for (size_t i = 0; i < counts.n_elem; ++i)
+    {
+      const double f = ((double) counts[i] / total);
+      impurity += f * (1.0 - f);
     }
 
     return -impurity;
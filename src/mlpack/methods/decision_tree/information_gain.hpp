@@ -44,9 +44,6 @@ class InformationGain
      if (labels.n_elem == 0)
        return 0.0;
 
-    // Calculate the information gain.
-    double gain = 0.0;
-
     // Count the number of elements in each class.  Use four auxiliary vectors
     // to exploit SIMD instructions if possible.
     arma::vec countSpace(4 * numClasses, arma::fill::zeros);
@@ -119,16 +116,7 @@ class InformationGain
       accWeights[0] += accWeights[1] + accWeights[2] + accWeights[3];
       counts += counts2 + counts3 + counts4;
 
-      // Corner case: return 0 if no weight.
-      if (accWeights[0] == 0.0)
-        return 0.0;
-
-      for (size_t i = 0; i < numClasses; ++i)
-      {
-        const double f = ((double) counts[i] / (double) accWeights[0]);
-        if (f > 0.0)
-          gain += f * std::log2(f);
-      }
+      return EvaluateCounts(counts, accWeights[0]);
     }
     else
     {
@@ -160,13 +148,32 @@ class InformationGain
       }
 
       counts += counts2 + counts3 + counts4;
+    }
 
-      for (size_t i = 0; i < numClasses; ++i)
-      {
-        const double f = ((double) counts[i] / (double) labels.n_elem);
-        if (f > 0.0)
-          gain += f * std::log2(f);
-      }
+    return EvaluateCounts(counts, (double) labels.n_elem);
+  }
+
+  /**
+   * Calculate the information gain of a set of points, given the number of
+   * points (or the sum of the weights of the points) in each class.  This
+   * takes O(numClasses) time, so a split search can keep running class counts
+   * and evaluate every split point without going through the labels again.
+   *
+   * @param counts Number of points (or sum of weights) in each class.
+   * @param total Number of points (or sum of weights) in all classes.
+   */
+  static double EvaluateCounts(const arma::vec& counts, const double total)
+  {
+    // Corner case: return 0 if there are no points.
+    if (total == 0.0)
+      return 0.0;
+
+    double gain = 0.0;
+    for (size_t i = 0; i < counts.n_elem; ++i)
+    {
+      const double f = ((double) counts[i] / total);
+      if (f > 0.0)
+        gain += f * std::log2(f);
     }
 
     return gain;
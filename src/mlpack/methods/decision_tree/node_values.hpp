@@ -0,0 +1,323 @@
+/**
+ * @file node_values.hpp
+ *
+ * Access to the values of the points of a decision tree node, for dense and
+ * sparse datasets, used by DecisionTree::TrainSubset().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_NODE_VALUES_HPP
+#define MLPACK_METHODS_DECISION_TREE_NODE_VALUES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The values of the points of a decision tree node, for a dense dataset.  The
+ * values of a dimension are gathered from the columns of the points when the
+ * dimension is searched.
+ *
+ * @tparam MatType Type of the dataset.
+ */
+template<typename MatType>
+class NodeValues
+{
+ public:
+  //! The type of the values.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Prepare access to the values of the given points.
+   *
+   * @param data Dataset to take the points from.
+   * @param points Indices of the points of the node.
+   * @param labels Labels of the points of the node.
+   * @param weights Weights of the points of the node.
+   * @param numClasses Number of classes in the dataset.
+   */
+  NodeValues(const MatType& data,
+             const arma::uvec& points,
+             const arma::Row<size_t>& labels,
+             const arma::rowvec& weights,
+             const size_t /* numClasses */) :
+      data(data),
+      points(points),
+      labels(labels),
+      weights(weights)
+  { }
+
+  //! Get the dimensions that may be split, in order (all of them).
+  std::vector<size_t> Dimensions() const
+  {
+    std::vector<size_t> dimensions(data.n_rows);
+    for (size_t i = 0; i < data.n_rows; ++i)
+      dimensions[i] = i;
+
+    return dimensions;
+  }
+
+  //! Remove the dimensions that cannot be split (there are none).
+  void FilterDimensions(std::vector<size_t>& /* dimensions */) const { }
+
+  //! Store the values of the given dimension, one for each point.
+  void Values(const size_t dimension, arma::Row<ElemType>& values) const
+  {
+    values.set_size(points.n_elem);
+    for (size_t j = 0; j < points.n_elem; ++j)
+      values[j] = data(dimension, points[j]);
+  }
+
+  /**
+   * Search the given numeric dimension for a split better than the given
+   * gain with NumericSplit::SplitIfBetter().
+   */
+  template<typename NumericSplit, typename AuxiliarySplitInfo>
+  double NumericSplitIfBetter(const size_t dimension,
+                              const double gain,
+                              const size_t numClasses,
+                              const size_t minimumLeafSize,
+                              const double minimumGainSplit,
+                              arma::Col<ElemType>& classProbabilities,
+                              AuxiliarySplitInfo& aux) const
+  {
+    arma::Row<ElemType> values;
+    Values(dimension, values);
+    return NumericSplit::template SplitIfBetter<true>(gain, values, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit,
+        classProbabilities, aux);
+  }
+
+ private:
+  //! The dataset.
+  const MatType& data;
+  //! The indices of the points of the node.
+  const arma::uvec& points;
+  //! The labels of the points of the node.
+  const arma::Row<size_t>& labels;
+  //! The weights of the points of the node.
+  const arma::rowvec& weights;
+};
+
+/**
+ * The values of the points of a decision tree node, for a sparse dataset.
+ * The nonzero values of the points are gathered once, from the columns of the
+ * points, and grouped by dimension in ascending order of value.  Dimensions
+ * where all the points are zero cannot be split, so they are never searched,
+ * and numeric dimensions are searched with
+ * NumericSplit::SplitIfBetterSparse() when it is available, which treats the
+ * points whose value is zero as one block.  Otherwise the values of the
+ * searched dimension are made dense.
+ *
+ * @tparam eT Type of the elements of the dataset.
+ */
+template<typename eT>
+class NodeValues<arma::SpMat<eT>>
+{
+ public:
+  //! The type of the values.
+  typedef eT ElemType;
+
+  /**
+   * Gather the nonzero values of the given points.
+   *
+   * @param data Dataset to take the points from.
+   * @param points Indices of the points of the node.
+   * @param labels Labels of the points of the node.
+   * @param weights Weights of the points of the node.
+   * @param numClasses Number of classes in the dataset.
+   */
+  NodeValues(const arma::SpMat<eT>& data,
+             const arma::uvec& points,
+             const arma::Row<size_t>& labels,
+             const arma::rowvec& weights,
+             const size_t numClasses) :
+      numPoints(points.n_elem),
+      labels(labels),
+      weights(weights),
+      classCounts(numClasses, arma::fill::zeros)
+  {
+    for (size_t j = 0; j < points.n_elem; ++j)
+    {
+      typename arma::SpMat<eT>::const_iterator it = data.begin_col(points[j]);
+      for (; it != data.end_col(points[j]); ++it)
+        entries.push_back(Entry(it.row(), j, *it));
+
+      classCounts[labels[j]] += weights[j];
+    }
+
+    // Group the values by dimension, in ascending order.
+    std::sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b)
+        {
+          return (a.dimension < b.dimension) ||
+              (a.dimension == b.dimension && a.value < b.value);
+        });
+
+    for (size_t k = 0; k < entries.size(); ++k)
+    {
+      if (k == 0 || entries[k].dimension != entries[k - 1].dimension)
+      {
+        dimensions.push_back(entries[k].dimension);
+        groupBegins.push_back(k);
+      }
+    }
+    groupBegins.push_back(entries.size());
+  }
+
+  //! Get the dimensions that may be split, in order (the ones with a nonzero
+  //! value).
+  const std::vector<size_t>& Dimensions() const { return dimensions; }
+
+  //! Remove the dimensions that cannot be split (the ones where all values are
+  //! zero), keeping the order of the others.
+  void FilterDimensions(std::vector<size_t>& selected) const
+  {
+    size_t kept = 0;
+    for (size_t k = 0; k < selected.size(); ++k)
+      if (Group(selected[k]) != dimensions.size())
+        selected[kept++] = selected[k];
+
+    selected.resize(kept);
+  }
+
+  //! Store the values of the given dimension, one for each point.
+  void Values(const size_t dimension, arma::Row<ElemType>& values) const
+  {
+    values.zeros(numPoints);
+    const size_t group = Group(dimension);
+    if (group == dimensions.size())
+      return;
+
+    for (size_t k = groupBegins[group]; k < groupBegins[group + 1]; ++k)
+      values[entries[k].position] = entries[k].value;
+  }
+
+  /**
+   * Search the given numeric dimension for a split better than the given
+   * gain, visiting only its nonzero values if the split type allows it.
+   */
+  template<typename NumericSplit, typename AuxiliarySplitInfo>
+  double NumericSplitIfBetter(const size_t dimension,
+                              const double gain,
+                              const size_t numClasses,
+                              const size_t minimumLeafSize,
+                              const double minimumGainSplit,
+                              arma::Col<ElemType>& classProbabilities,
+                              AuxiliarySplitInfo& aux) const
+  {
+    const size_t group = Group(dimension);
+    if (group == dimensions.size())
+      return gain; // All the values are zero.
+
+    return SplitIfBetter<NumericSplit>(dimension, group, gain, numClasses,
+        minimumLeafSize, minimumGainSplit, classProbabilities, aux, 0);
+  }
+
+ private:
+  //! A nonzero value of a point of the node.
+  struct Entry
+  {
+    Entry(const size_t dimension, const size_t position, const eT value) :
+        dimension(dimension), position(position), value(value) { }
+
+    //! The dimension of the value.
+    size_t dimension;
+    //! The index of the point in the node.
+    size_t position;
+    //! The value.
+    eT value;
+  };
+
+  //! Get the group of the given dimension, or the number of groups if all its
+  //! values are zero.
+  size_t Group(const size_t dimension) const
+  {
+    std::vector<size_t>::const_iterator it = std::lower_bound(
+        dimensions.begin(), dimensions.end(), dimension);
+    return (it != dimensions.end() && *it == dimension) ?
+        (it - dimensions.begin()) : dimensions.size();
+  }
+
+  //! Search the nonzero values of the given group with
+  //! NumericSplit::SplitIfBetterSparse().
+  template<typename NumericSplit, typename AuxiliarySplitInfo>
+  auto SplitIfBetter(const size_t /* dimension */,
+                     const size_t group,
+                     const double gain,
+                     const size_t /* numClasses */,
+                     const size_t minimumLeafSize,
+                     const double minimumGainSplit,
+                     arma::Col<ElemType>& classProbabilities,
+                     AuxiliarySplitInfo& aux,
+                     const int /* preferred */) const
+      -> decltype(NumericSplit::template SplitIfBetterSparse<true>(gain,
+          arma::Row<ElemType>(), arma::Row<size_t>(), arma::rowvec(),
+          arma::vec(), size_t(0), minimumLeafSize, minimumGainSplit,
+          classProbabilities, aux))
+  {
+    const size_t begin = groupBegins[group];
+    const size_t count = groupBegins[group + 1] - begin;
+    arma::Row<ElemType> values(count);
+    arma::Row<size_t> valueLabels(count);
+    arma::rowvec valueWeights(count);
+    arma::vec zeroCounts(classCounts);
+    for (size_t k = 0; k < count; ++k)
+    {
+      const Entry& entry = entries[begin + k];
+      values[k] = entry.value;
+      valueLabels[k] = labels[entry.position];
+      valueWeights[k] = weights[entry.position];
+      zeroCounts[valueLabels[k]] -= valueWeights[k];
+    }
+
+    return NumericSplit::template SplitIfBetterSparse<true>(gain, values,
+        valueLabels, valueWeights, zeroCounts, numPoints - count,
+        minimumLeafSize, minimumGainSplit, classProbabilities, aux);
+  }
+
+  //! Search the values of the given dimension, made dense, with
+  //! NumericSplit::SplitIfBetter().
+  template<typename NumericSplit, typename AuxiliarySplitInfo>
+  double SplitIfBetter(const size_t dimension,
+                       const size_t /* group */,
+                       const double gain,
+                       const size_t numClasses,
+                       const size_t minimumLeafSize,
+                       const double minimumGainSplit,
+                       arma::Col<ElemType>& classProbabilities,
+                       AuxiliarySplitInfo& aux,
+                       const long /* fallback */) const
+  {
+    arma::Row<ElemType> values;
+    Values(dimension, values);
+    return NumericSplit::template SplitIfBetter<true>(gain, values, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit,
+        classProbabilities, aux);
+  }
+
+  //! The number of points of the node.
+  size_t numPoints;
+  //! The labels of the points of the node.
+  const arma::Row<size_t>& labels;
+  //! The weights of the points of the node.
+  const arma::rowvec& weights;
+  //! The sum of the weights of the points of each class.
+  arma::vec classCounts;
+  //! The nonzero values, grouped by dimension in ascending order of value.
+  std::vector<Entry> entries;
+  //! The dimensions with a nonzero value, in ascending order.
+  std::vector<size_t> dimensions;
+  //! The index in entries of the first value of each dimension (and the
+  //! number of entries at the end).
+  std::vector<size_t> groupBegins;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file sparse_column.hpp
+ *
+ * A read-only view of one column of a sparse matrix, for classifying sparse
+ * points with decision trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_SPARSE_COLUMN_HPP
+#define MLPACK_METHODS_DECISION_TREE_SPARSE_COLUMN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A point of a sparse matrix.  The nonzero elements of the column are read
+ * once, in ascending order of row, and each element is then found with a
+ * binary search, so the point is never made dense.  A tree only reads the
+ * dimensions it splits on, so this is cheap even with millions of dimensions.
+ *
+ * @tparam eT Type of the elements of the matrix.
+ */
+template<typename eT>
+class SparseColumn
+{
+ public:
+  //! The type of the elements.
+  typedef eT elem_type;
+
+  /**
+   * Read the nonzero elements of the given column.
+   *
+   * @param data Sparse matrix.
+   * @param col Index of the column.
+   */
+  SparseColumn(const arma::SpMat<eT>& data, const size_t col)
+  {
+    typename arma::SpMat<eT>::const_iterator it = data.begin_col(col);
+    for (; it != data.end_col(col); ++it)
+    {
+      rows.push_back(it.row());
+      values.push_back(*it);
+    }
+  }
+
+  //! Get the element of the given row.
+  eT operator[](const size_t row) const
+  {
+    std::vector<size_t>::const_iterator it = std::lower_bound(rows.begin(),
+        rows.end(), row);
+    return (it != rows.end() && *it == row) ? values[it - rows.begin()] :
+        eT(0);
+  }
+
+ private:
+  //! The rows of the nonzero elements, in ascending order.
+  std::vector<size_t> rows;
+  //! The nonzero elements.
+  std::vector<eT> values;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,186 @@
+/**
+ * @file chunk_source.hpp
+ *
+ * Sources of chunks of a dataset, for training density estimation trees with
+ * DTree::GrowHistogram() and HistogramTrainer() without holding the dataset in
+ * memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DET_CHUNK_SOURCE_HPP
+#define MLPACK_METHODS_DET_CHUNK_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace det {
+
+/**
+ * A chunk source that returns consecutive blocks of columns of a matrix that
+ * is already in memory.  This is mostly useful for testing, and as an example
+ * of the interface: a source that reads its chunks from a file or a database
+ * only has to provide Reset() and NextChunk() too.
+ *
+ * @tparam MatType The type of the matrix.
+ */
+template<typename MatType = arma::mat>
+class MatrixChunkSource
+{
+ public:
+  /**
+   * Create the source on the given matrix, which must stay valid while the
+   * source is used.
+   *
+   * @param data Matrix to return the columns of.
+   * @param chunkSize Number of columns in each chunk.
+   */
+  MatrixChunkSource(const MatType& data, const size_t chunkSize = 65536) :
+      data(data),
+      chunkSize(chunkSize),
+      position(0)
+  { /* Nothing to do. */ }
+
+  //! Restart from the first chunk.
+  void Reset() { position = 0; }
+
+  /**
+   * Store the next chunk in the given matrix.
+   *
+   * @param chunk Matrix to store the chunk in.
+   * @return false if there are no more chunks.
+   */
+  bool NextChunk(MatType& chunk)
+  {
+    if (position >= data.n_cols)
+      return false;
+
+    const size_t last = std::min(position + chunkSize, (size_t) data.n_cols);
+    chunk = data.cols(position, last - 1);
+    position = last;
+    return true;
+  }
+
+ private:
+  //! The matrix.
+  const MatType& data;
+  //! The number of columns in each chunk.
+  size_t chunkSize;
+  //! The first column of the next chunk.
+  size_t position;
+};
+
+/**
+ * A view of one cross-validation fold of another chunk source.  The points of
+ * the underlying source with index (in the order the source returns them) in
+ * [begin, end) form the test set of the fold, and all the other points its
+ * training set; the view returns the chunks of one of the two.  Nothing is
+ * copied, apart from the columns of the chunk that is returned.
+ *
+ * @tparam ChunkSourceType The type of the underlying source.
+ * @tparam MatType The type of the chunks.
+ */
+template<typename ChunkSourceType, typename MatType = arma::mat>
+class FoldChunkSource
+{
+ public:
+  /**
+   * Create the view.
+   *
+   * @param source The underlying source.
+   * @param begin Index of the first point of the test set.
+   * @param end Index of the first point after the test set.
+   * @param test If true, the view returns the test set; otherwise, it returns
+   *     the training set.
+   */
+  FoldChunkSource(ChunkSourceType& source,
+                  const size_t begin,
+                  const size_t end,
+                  const bool test) :
+      source(source),
+      begin(begin),
+      end(end),
+      test(test),
+      position(0)
+  { /* Nothing to do. */ }
+
+  //! Restart from the first chunk.
+  void Reset()
+  {
+    source.Reset();
+    position = 0;
+  }
+
+  /**
+   * Store the next non-empty chunk of the fold in the given matrix.
+   *
+   * @param chunk Matrix to store the chunk in.
+   * @return false if there are no more chunks.
+   */
+  bool NextChunk(MatType& chunk)
+  {
+    while (source.NextChunk(buffer))
+    {
+      const size_t first = position;
+      position += buffer.n_cols;
+
+      // The test points of this chunk are the columns [lo, hi).
+      const size_t lo = std::min(std::max(begin, first), position) - first;
+      const size_t hi = std::max(std::min(end, position), first) - first;
+
+      if (test)
+      {
+        if (lo >= hi)
+          continue;
+
+        chunk = buffer.cols(lo, hi - 1);
+      }
+      else if (lo >= hi)
+      {
+        chunk = std::move(buffer);
+      }
+      else if (lo == 0 && hi == buffer.n_cols)
+      {
+        continue;
+      }
+      else if (lo == 0)
+      {
+        chunk = buffer.cols(hi, buffer.n_cols - 1);
+      }
+      else if (hi == buffer.n_cols)
+      {
+        chunk = buffer.cols(0, lo - 1);
+      }
+      else
+      {
+        chunk = arma::join_rows(buffer.cols(0, lo - 1),
+            buffer.cols(hi, buffer.n_cols - 1));
+      }
+
+      return true;
+    }
+
+    return false;
+  }
+
+ private:
+  //! The underlying source.
+  ChunkSourceType& source;
+  //! The index of the first test point.
+  size_t begin;
+  //! The index of the first point after the test points.
+  size_t end;
+  //! Whether the test set or the training set is returned.
+  bool test;
+  //! The index of the first point of the next chunk of the source.
+  size_t position;
+  //! The last chunk of the underlying source.
+  MatType buffer;
+};
+
+} // namespace det
+} // namespace mlpack
+
+#endif
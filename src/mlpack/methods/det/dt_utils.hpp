@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "dtree.hpp"
+#include "chunk_source.hpp"
 
 namespace mlpack {
 namespace det {
@@ -70,6 +71,36 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
                                  const std::string unprunedTreeOutput = "",
                                  const bool skipPruning = false);
 
+/**
+ * Train the optimal decision tree from a stream of chunks of the dataset, using
+ * cross-validation with the given number of folds.  The trees are grown with
+ * DTree::GrowHistogram(), so the dataset is never held in memory; the folds
+ * are views of the source (see FoldChunkSource), so nothing is copied either.
+ * Apart from the passes that grow the trees, one pass is made to find the
+ * bounds of the data, and two per fold: one for the bounds of the training set,
+ * and one to count the test points that fall in each node.  This initializes a
+ * tree on the heap, so you are responsible for deleting it.
+ *
+ * @param source Source of the chunks of the dataset; see
+ *     DTree::GrowHistogram() for the interface it must have.
+ * @param folds Number of folds to use for cross-validation.
+ * @param useVolumeReg If true, use volume regularization.
+ * @param maxLeafSize Maximum number of points allowed in a leaf.
+ * @param minLeafSize Minimum number of points allowed in a leaf.
+ * @param bins Number of histogram bins in each dimension of a node.
+ * @param maxDepth Maximum depth of the trees.
+ * @param skipPruning If true, the unpruned tree is returned.
+ */
+template <typename MatType, typename TagType, typename ChunkSourceType>
+DTree<MatType, TagType>* HistogramTrainer(ChunkSourceType& source,
+                                          const size_t folds,
+                                          const bool useVolumeReg = false,
+                                          const size_t maxLeafSize = 10,
+                                          const size_t minLeafSize = 5,
+                                          const size_t bins = 64,
+                                          const size_t maxDepth = 30,
+                                          const bool skipPruning = false);
+
 /**
  * This class is responsible for caching the path to each node of the tree. Its
  * instance is provided to EnumerateTree() utility ONCE and it caches the paths
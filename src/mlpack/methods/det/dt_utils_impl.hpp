@@ -16,6 +16,9 @@
 #include "dt_utils.hpp"
 #include <mlpack/core/tree/enumerate_tree.hpp>
 
+#include <stack>
+#include <unordered_map>
+
 namespace mlpack {
 namespace det {
 
@@ -104,6 +107,223 @@ void PrintVariableImportance(const DTree<MatType, TagType>* dtree,
 }
 
 
+namespace details {
+
+/**
+ * Sequentially prune the tree, and return the alpha values and the values of
+ * c_t^2 * r_t of the trees in the pruned sequence.
+ */
+template <typename MatType, typename TagType>
+std::vector<std::pair<double, double>> PruningSequence(
+    DTree<MatType, TagType>& dtree,
+    double alpha,
+    const size_t points,
+    const bool useVolumeReg)
+{
+  double oldAlpha = 0.0;
+  std::vector<std::pair<double, double> > prunedSequence;
+  while (dtree.SubtreeLeaves() > 1)
+  {
+    std::pair<double, double> treeSeq(oldAlpha,
+        dtree.SubtreeLeavesLogNegError());
+    prunedSequence.push_back(treeSeq);
+    oldAlpha = alpha;
+    alpha = dtree.PruneAndUpdate(oldAlpha, points, useVolumeReg);
+
+    // Some sanity checks.  It seems that on some datasets, the error does not
+    // increase as the tree is pruned but instead stays the same---hence the
+    // "<=" in the final assert.
+    Log::Assert((alpha < std::numeric_limits<double>::max())
+                || (dtree.SubtreeLeaves() == 1));
+    Log::Assert(alpha > oldAlpha);
+    Log::Assert(dtree.SubtreeLeavesLogNegError() <= treeSeq.second);
+  }
+
+  std::pair<double, double> treeSeq(oldAlpha,
+                                    dtree.SubtreeLeavesLogNegError());
+  prunedSequence.push_back(treeSeq);
+
+  return prunedSequence;
+}
+
+/**
+ * Return the alpha of the pruned sequence with the best cross-validated error.
+ */
+inline double OptimalAlpha(
+    const std::vector<std::pair<double, double>>& prunedSequence,
+    const arma::vec& regularizationConstants)
+{
+  double optimalAlpha = -1.0;
+  long double cvBestError = -std::numeric_limits<long double>::max();
+
+  for (size_t i = 0; i < prunedSequence.size() - 1; ++i)
+  {
+    // We can no longer work in the log-space for this because we have no
+    // guarantee the quantity will be positive.
+    long double thisError = -std::exp((long double) prunedSequence[i].second) +
+        (long double) regularizationConstants[i];
+
+    if (thisError > cvBestError)
+    {
+      cvBestError = thisError;
+      optimalAlpha = prunedSequence[i].first;
+    }
+  }
+
+  return optimalAlpha;
+}
+
+/**
+ * Prune a freshly grown tree (whose growth returned the given alpha) until the
+ * optimal alpha is reached.  Returns the alpha of the pruned tree.
+ */
+template <typename MatType, typename TagType>
+double PruneToAlpha(DTree<MatType, TagType>& dtree,
+                    double alpha,
+                    const double optimalAlpha,
+                    const size_t points,
+                    const bool useVolumeReg)
+{
+  double oldAlpha = -DBL_MAX;
+  while ((oldAlpha < optimalAlpha) && (dtree.SubtreeLeaves() > 1))
+  {
+    oldAlpha = alpha;
+    alpha = dtree.PruneAndUpdate(oldAlpha, points, useVolumeReg);
+
+    // Some sanity checks.
+    Log::Assert((alpha < std::numeric_limits<double>::max()) ||
+        (dtree.SubtreeLeaves() == 1));
+    Log::Assert(alpha > oldAlpha);
+  }
+
+  return oldAlpha;
+}
+
+/**
+ * Find the bounds and the number of points of a chunk source with one pass.
+ */
+template <typename MatType, typename StatType, typename ChunkSourceType>
+size_t ChunkBounds(ChunkSourceType& source,
+                   StatType& maxVals,
+                   StatType& minVals)
+{
+  size_t points = 0;
+  MatType chunk;
+  source.Reset();
+  while (source.NextChunk(chunk))
+  {
+    if (chunk.n_cols == 0)
+      continue;
+
+    const StatType chunkMaxVals = arma::max(chunk, 1);
+    const StatType chunkMinVals = arma::min(chunk, 1);
+    if (points == 0)
+    {
+      maxVals = chunkMaxVals;
+      minVals = chunkMinVals;
+    }
+    else
+    {
+      for (size_t d = 0; d < maxVals.n_elem; ++d)
+      {
+        maxVals[d] = std::max(maxVals[d], chunkMaxVals[d]);
+        minVals[d] = std::min(minVals[d], chunkMinVals[d]);
+      }
+    }
+
+    points += chunk.n_cols;
+  }
+
+  return points;
+}
+
+/**
+ * Count the points of a chunk source that fall in each node of the tree
+ * (inner nodes included) with one pass.  Points outside of the bounds of the
+ * root have a density estimate of zero, so they are not counted.
+ */
+template <typename MatType, typename TagType, typename ChunkSourceType>
+void CountPoints(
+    const DTree<MatType, TagType>& dtree,
+    ChunkSourceType& source,
+    std::unordered_map<const DTree<MatType, TagType>*, size_t>& nodeIndices,
+    arma::Col<size_t>& counts)
+{
+  typedef DTree<MatType, TagType> TreeType;
+
+  nodeIndices.clear();
+  std::stack<const TreeType*> nodes;
+  nodes.push(&dtree);
+  while (!nodes.empty())
+  {
+    const TreeType* node = nodes.top();
+    nodes.pop();
+
+    const size_t index = nodeIndices.size();
+    nodeIndices[node] = index;
+    if (node->Left())
+    {
+      nodes.push(node->Left());
+      nodes.push(node->Right());
+    }
+  }
+
+  counts.zeros(nodeIndices.size());
+
+  MatType chunk;
+  source.Reset();
+  while (source.NextChunk(chunk))
+  {
+    #pragma omp parallel
+    {
+      arma::Col<size_t> localCounts(counts.n_elem, arma::fill::zeros);
+
+      #pragma omp for
+      for (omp_size_t i = 0; i < (omp_size_t) chunk.n_cols; ++i)
+      {
+        const typename MatType::vec_type point = chunk.col(i);
+        if (!dtree.WithinRange(point))
+          continue;
+
+        const TreeType* node = &dtree;
+        ++localCounts[nodeIndices.at(node)];
+        while (node->Left())
+        {
+          node = (point[node->SplitDim()] <= node->SplitValue()) ?
+              node->Left() : node->Right();
+          ++localCounts[nodeIndices.at(node)];
+        }
+      }
+
+      #pragma omp critical(DTreeCountPoints)
+      counts += localCounts;
+    }
+  }
+}
+
+/**
+ * Return the sum of the density estimates of the counted points, for the
+ * current leaves of the tree.
+ */
+template <typename MatType, typename TagType>
+double CountedValue(
+    const DTree<MatType, TagType>& node,
+    const std::unordered_map<const DTree<MatType, TagType>*, size_t>&
+        nodeIndices,
+    const arma::Col<size_t>& counts)
+{
+  if (node.SubtreeLeaves() == 1)
+  {
+    return counts[nodeIndices.at(&node)] *
+        std::exp(std::log(node.Ratio()) - node.LogVolume());
+  }
+
+  return CountedValue(*node.Left(), nodeIndices, counts) +
+      CountedValue(*node.Right(), nodeIndices, counts);
+}
+
+} // namespace details
+
 // This function trains the optimal decision tree using the given number of
 // folds.
 template <typename MatType, typename TagType>
@@ -127,7 +347,6 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   MatType newDataset(dataset);
 
   // Growing the tree
-  double oldAlpha = 0.0;
   double alpha = dtree->Grow(newDataset, oldFromNew, useVolumeReg, maxLeafSize,
       minLeafSize);
 
@@ -147,33 +366,17 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   Timer::Start("pruning_sequence");
 
   // Sequentially prune and save the alpha values and the values of c_t^2 * r_t.
-  std::vector<std::pair<double, double> > prunedSequence;
-  while (dtree->SubtreeLeaves() > 1)
-  {
-    std::pair<double, double> treeSeq(oldAlpha,
-        dtree->SubtreeLeavesLogNegError());
-    prunedSequence.push_back(treeSeq);
-    oldAlpha = alpha;
-    alpha = dtree->PruneAndUpdate(oldAlpha, dataset.n_cols, useVolumeReg);
-
-    // Some sanity checks.  It seems that on some datasets, the error does not
-    // increase as the tree is pruned but instead stays the same---hence the
-    // "<=" in the final assert.
-    Log::Assert((alpha < std::numeric_limits<double>::max())
-                || (dtree->SubtreeLeaves() == 1));
-    Log::Assert(alpha > oldAlpha);
-    Log::Assert(dtree->SubtreeLeavesLogNegError() <= treeSeq.second);
-  }
-
-  std::pair<double, double> treeSeq(oldAlpha,
-                                    dtree->SubtreeLeavesLogNegError());
-  prunedSequence.push_back(treeSeq);
+  const std::vector<std::pair<double, double> > prunedSequence =
+      details::PruningSequence(*dtree, alpha, dataset.n_cols, useVolumeReg);
 
   Timer::Stop("pruning_sequence");
   Log::Info << prunedSequence.size() << " trees in the sequence; maximum alpha:"
-      << " " << oldAlpha << "." << std::endl;
+      << " " << prunedSequence.back().first << "." << std::endl;
 
-  const MatType cvData(dataset);
+  // The dataset isn't modified, so the test points of each fold are used in
+  // place; only the training points are copied, because growing a tree
+  // reorders them.
+  const MatType& cvData = dataset;
   const size_t testSize = dataset.n_cols / folds;
 
   arma::vec regularizationConstants(prunedSequence.size());
@@ -184,8 +387,7 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   // intmax_t because size_t is not yet supported by their OpenMP
   // implementation. omp_size_t is the appropriate type according to the
   // platform.
-  #pragma omp parallel for default(none) \
-      shared(prunedSequence, regularizationConstants)
+  #pragma omp parallel for shared(prunedSequence, regularizationConstants)
   for (omp_size_t fold = 0; fold < (omp_size_t) folds; fold++)
   {
     // Break up data into train and test sets.
@@ -193,8 +395,7 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     const size_t end = std::min((size_t) (fold + 1)
                                 * testSize, (size_t) cvData.n_cols);
 
-    MatType test = cvData.cols(start, end - 1);
-    MatType train(cvData.n_rows, cvData.n_cols - test.n_cols);
+    MatType train(cvData.n_rows, cvData.n_cols - (end - start));
 
     if (start == 0 && end < cvData.n_cols)
     {
@@ -232,9 +433,9 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     {
       // Compute test values for this state of the tree.
       double cvVal = 0.0;
-      for (size_t j = 0; j < test.n_cols; j++)
+      for (size_t j = start; j < end; j++)
       {
-        arma::vec testPoint = test.unsafe_col(j);
+        arma::vec testPoint = cvData.unsafe_col(j);
         cvVal += cvDTree.ComputeValue(testPoint);
       }
 
@@ -249,9 +450,9 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
 
     // Compute test values for this state of the tree.
     double cvVal = 0.0;
-    for (size_t i = 0; i < test.n_cols; ++i)
+    for (size_t i = start; i < end; ++i)
     {
-      typename MatType::vec_type testPoint = test.unsafe_col(i);
+      typename MatType::vec_type testPoint = cvData.unsafe_col(i);
       cvVal += cvDTree.ComputeValue(testPoint);
     }
 
@@ -264,22 +465,8 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   }
   Timer::Stop("cross_validation");
 
-  double optimalAlpha = -1.0;
-  long double cvBestError = -std::numeric_limits<long double>::max();
-
-  for (size_t i = 0; i < prunedSequence.size() - 1; ++i)
-  {
-    // We can no longer work in the log-space for this because we have no
-    // guarantee the quantity will be positive.
-    long double thisError = -std::exp((long double) prunedSequence[i].second) +
-        (long double) regularizationConstants[i];
-
-    if (thisError > cvBestError)
-    {
-      cvBestError = thisError;
-      optimalAlpha = prunedSequence[i].first;
-    }
-  }
+  const double optimalAlpha = details::OptimalAlpha(prunedSequence,
+      regularizationConstants);
 
   Log::Info << "Optimal alpha: " << optimalAlpha << "." << std::endl;
 
@@ -295,24 +482,146 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   newDataset = dataset;
 
   // Grow the tree.
-  oldAlpha = -DBL_MAX;
   alpha = dtree->Grow(newDataset,
-                         oldFromNew,
-                         useVolumeReg,
-                         maxLeafSize,
-                         minLeafSize);
+                      oldFromNew,
+                      useVolumeReg,
+                      maxLeafSize,
+                      minLeafSize);
 
   // Prune with optimal alpha.
-  while ((oldAlpha < optimalAlpha) && (dtree->SubtreeLeaves() > 1))
+  const double oldAlpha = details::PruneToAlpha(*dtree, alpha, optimalAlpha,
+      newDataset.n_cols, useVolumeReg);
+
+  Log::Info << dtree->SubtreeLeaves() << " leaf nodes in the optimally "
+      << "pruned tree; optimal alpha: " << oldAlpha << "." << std::endl;
+
+  return dtree;
+}
+
+// This function trains the optimal decision tree from a stream of chunks,
+// using the given number of folds.
+template <typename MatType, typename TagType, typename ChunkSourceType>
+DTree<MatType, TagType>* HistogramTrainer(ChunkSourceType& source,
+                                          const size_t folds,
+                                          const bool useVolumeReg,
+                                          const size_t maxLeafSize,
+                                          const size_t minLeafSize,
+                                          const size_t bins,
+                                          const size_t maxDepth,
+                                          const bool skipPruning)
+{
+  typedef DTree<MatType, TagType> TreeType;
+  typedef typename TreeType::StatType StatType;
+
+  // Find the bounds of the dataset.
+  StatType maxVals, minVals;
+  const size_t points = details::ChunkBounds<MatType>(source, maxVals,
+      minVals);
+  if (points == 0)
   {
-    oldAlpha = alpha;
-    alpha = dtree->PruneAndUpdate(oldAlpha, newDataset.n_cols, useVolumeReg);
+    Log::Fatal << "HistogramTrainer(): the chunk source has no points!"
+        << std::endl;
+  }
 
-    // Some sanity checks.
-    Log::Assert((alpha < std::numeric_limits<double>::max()) ||
-        (dtree->SubtreeLeaves() == 1));
-    Log::Assert(alpha > oldAlpha);
+  Timer::Start("tree_growing");
+  TreeType* dtree = new TreeType(maxVals, minVals, points);
+  const double alpha = dtree->GrowHistogram(source, useVolumeReg, maxLeafSize,
+      minLeafSize, bins, maxDepth);
+
+  Timer::Stop("tree_growing");
+  Log::Info << dtree->SubtreeLeaves() << " leaf nodes in the tree using full "
+      << "dataset; minimum alpha: " << alpha << "." << std::endl;
+
+  if (skipPruning)
+    return dtree;
+
+  Log::Info << "Performing " << folds << "-fold cross validation." <<
+      std::endl;
+
+  // Keep the unpruned tree, so it doesn't have to be grown again once the
+  // optimal alpha is known.
+  TreeType unprunedTree(*dtree);
+
+  Timer::Start("pruning_sequence");
+  const std::vector<std::pair<double, double> > prunedSequence =
+      details::PruningSequence(*dtree, alpha, points, useVolumeReg);
+
+  Timer::Stop("pruning_sequence");
+  Log::Info << prunedSequence.size() << " trees in the sequence; maximum alpha:"
+      << " " << prunedSequence.back().first << "." << std::endl;
+
+  const size_t testSize = points / folds;
+
+  arma::vec regularizationConstants(prunedSequence.size());
+  regularizationConstants.fill(0.0);
+
+  // The folds share the source, so they are processed one after another; the
+  // passes over the data are parallel.
+  Timer::Start("cross_validation");
+  for (size_t fold = 0; fold < folds; ++fold)
+  {
+    const size_t start = fold * testSize;
+    const size_t end = std::min((fold + 1) * testSize, points);
+    FoldChunkSource<ChunkSourceType, MatType> train(source, start, end, false);
+    FoldChunkSource<ChunkSourceType, MatType> test(source, start, end, true);
+
+    StatType cvMaxVals, cvMinVals;
+    const size_t trainPoints = details::ChunkBounds<MatType>(train, cvMaxVals,
+        cvMinVals);
+
+    TreeType cvDTree(cvMaxVals, cvMinVals, trainPoints);
+    cvDTree.GrowHistogram(train, useVolumeReg, maxLeafSize, minLeafSize, bins,
+        maxDepth);
+
+    // Pruning only turns inner nodes into leaves, so the density estimates of
+    // the test points for every tree of the sequence follow from the number
+    // of test points in each node, which takes a single pass.
+    std::unordered_map<const TreeType*, size_t> nodeIndices;
+    arma::Col<size_t> testCounts;
+    details::CountPoints(cvDTree, test, nodeIndices, testCounts);
+
+    // Sequentially prune with all the values of available alphas and adding
+    // values for test values.  Don't enter this loop if there are less than two
+    // trees in the pruned sequence.
+    arma::vec cvRegularizationConstants(prunedSequence.size());
+    cvRegularizationConstants.fill(0.0);
+    for (size_t i = 0;
+         i < ((prunedSequence.size() < 2) ? 0 : prunedSequence.size() - 2); ++i)
+    {
+      // Compute test values for this state of the tree.
+      const double cvVal = details::CountedValue(cvDTree, nodeIndices,
+          testCounts);
+
+      // Update the cv regularization constant.
+      cvRegularizationConstants[i] += 2.0 * cvVal / (double) points;
+
+      // Determine the new alpha value and prune accordingly.
+      double cvOldAlpha = 0.5 * (prunedSequence[i + 1].first
+                                 + prunedSequence[i + 2].first);
+      cvDTree.PruneAndUpdate(cvOldAlpha, trainPoints, useVolumeReg);
+    }
+
+    // Compute test values for this state of the tree.
+    const double cvVal = details::CountedValue(cvDTree, nodeIndices,
+        testCounts);
+
+    if (prunedSequence.size() > 2)
+      cvRegularizationConstants[prunedSequence.size() - 2] += 2.0 * cvVal
+        / (double) points;
+
+    regularizationConstants += cvRegularizationConstants;
   }
+  Timer::Stop("cross_validation");
+
+  const double optimalAlpha = details::OptimalAlpha(prunedSequence,
+      regularizationConstants);
+
+  Log::Info << "Optimal alpha: " << optimalAlpha << "." << std::endl;
+
+  // Prune the unpruned tree with optimal alpha.
+  *dtree = std::move(unprunedTree);
+  const double oldAlpha = details::PruneToAlpha(*dtree, alpha, optimalAlpha,
+      points, useVolumeReg);
 
   Log::Info << dtree->SubtreeLeaves() << " leaf nodes in the optimally "
       << "pruned tree; optimal alpha: " << oldAlpha << "." << std::endl;
@@ -162,6 +162,42 @@ class DTree
               const size_t maxLeafSize = 10,
               const size_t minLeafSize = 5);
 
+  /**
+   * Greedily expand the tree from a stream of chunks of the dataset, without
+   * holding the dataset in memory.  Instead of sorting the points of each node,
+   * the splits are chosen among the edges of a histogram with the given number
+   * of bins in each dimension of each node.  The tree is grown one level at a
+   * time, with one pass over the chunks per level, so at most maxDepth passes
+   * are made.  The node must have been created with the bounds and the number
+   * of points of the data (see HistogramTrainer()); the dataset is not
+   * reordered, but the Start() and End() of the nodes are assigned as if it
+   * had been.
+   *
+   * The chunk source must provide the following two methods, and return the
+   * same points every time it is reset:
+   *
+   * @code
+   * // Restart from the first chunk.
+   * void Reset();
+   * // Get the next chunk; return false if there are no more chunks.
+   * bool NextChunk(MatType& chunk);
+   * @endcode
+   *
+   * @param source Source of the chunks of the dataset.
+   * @param useVolReg If true, volume regularization is used.
+   * @param maxLeafSize Maximum size of a leaf.
+   * @param minLeafSize Minimum size of a leaf.
+   * @param bins Number of histogram bins in each dimension of a node.
+   * @param maxDepth Maximum depth of the tree.
+   */
+  template<typename ChunkSourceType>
+  double GrowHistogram(ChunkSourceType& source,
+                       const bool useVolReg = false,
+                       const size_t maxLeafSize = 10,
+                       const size_t minLeafSize = 5,
+                       const size_t bins = 64,
+                       const size_t maxDepth = 30);
+
   /**
    * Perform alpha pruning on a tree.  Returns the new value of alpha.
    *
@@ -344,6 +380,61 @@ class DTree
                  double& rightError,
                  const size_t minLeafSize = 5) const;
 
+  /**
+   * Find the dimension to split on, given a function that extracts the
+   * candidate splits (the split values and the number of points left of each
+   * of them) of one dimension.
+   */
+  template<typename SplitExtractorType>
+  bool FindBestSplit(const size_t totalPoints,
+                     const SplitExtractorType& extractSplits,
+                     size_t& splitDim,
+                     ElemType& splitValue,
+                     double& leftError,
+                     double& rightError,
+                     const size_t minLeafSize) const;
+
+  /**
+   * Find the dimension and the histogram edge to split on, given the histogram
+   * of the points of the node and the edges of its bins.  The number of points
+   * left of the split is stored in leftPoints.
+   */
+  bool FindHistogramSplit(const arma::Mat<size_t>& histogram,
+                          const arma::Mat<ElemType>& edges,
+                          const size_t totalPoints,
+                          size_t& splitDim,
+                          ElemType& splitValue,
+                          double& leftError,
+                          double& rightError,
+                          size_t& leftPoints,
+                          const size_t minLeafSize) const;
+
+  /**
+   * Compute the edges between the histogram bins of this node, one column for
+   * each dimension.  Bin b holds the values in (edges[b - 1], edges[b]].
+   */
+  void HistogramEdges(const size_t bins, arma::Mat<ElemType>& edges) const;
+
+  /**
+   * Compute the ratio of the points in the node and its log-volume.
+   */
+  void ComputeRatioAndVolume(const size_t totalPoints);
+
+  /**
+   * Compute the subtree statistics and the upper part of the alpha sum of the
+   * node, once its children (if any) have been grown.  Returns the minimum
+   * g_k(t) of the subtree.
+   */
+  double FinishGrowth(const size_t totalPoints,
+                      const bool useVolReg,
+                      const double leftG,
+                      const double rightG);
+
+  /**
+   * Call FinishGrowth() on every node of the subtree, bottom to top.
+   */
+  double FinishSubtreeGrowth(const size_t totalPoints, const bool useVolReg);
+
   /**
    * Split the data, returning the number of points left of the split.
    */
@@ -13,6 +13,7 @@
  */
 #include "dtree.hpp"
 #include <stack>
+#include <unordered_map>
 #include <vector>
 
 using namespace mlpack;
@@ -448,6 +449,37 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
 
+  // Get the values for splitting. The old implementation:
+  //   dimVec = data.row(dim).subvec(start, end - 1);
+  //   dimVec = arma::sort(dimVec);
+  // could be quite inefficient for sparse matrices, due to
+  // copy operations (3). This one has custom implementation for dense and
+  // sparse matrices.
+  auto extractSplits = [&](const size_t dim, std::vector<SplitItem>& splitVec)
+  {
+    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
+        minLeafSize);
+  };
+
+  return FindBestSplit(data.n_cols, extractSplits, splitDim, splitValue,
+      leftError, rightError, minLeafSize);
+}
+
+// This function finds the best split with respect to the L2-error among the
+// candidate splits given by extractSplits.
+template<typename MatType, typename TagType>
+template<typename SplitExtractorType>
+bool DTree<MatType, TagType>::FindBestSplit(
+    const size_t totalPoints,
+    const SplitExtractorType& extractSplits,
+    size_t& splitDim,
+    ElemType& splitValue,
+    double& leftError,
+    double& rightError,
+    const size_t minLeafSize) const
+{
+  typedef std::pair<ElemType, size_t> SplitItem;
+
   const size_t points = end - start;
 
   double minError = logNegError;
@@ -480,16 +512,8 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     double dimRightError = 0.0; // always be set to something else before use.
     ElemType dimSplitValue = 0.0;
 
-    // Get the values for splitting. The old implementation:
-    //   dimVec = data.row(dim).subvec(start, end - 1);
-    //   dimVec = arma::sort(dimVec);
-    // could be quite inefficient for sparse matrices, due to
-    // copy operations (3). This one has custom implementation for dense and
-    // sparse matrices.
-
     std::vector<SplitItem> splitVec;
-    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
-        minLeafSize);
+    extractSplits(dim, splitVec);
 
     // Iterate on all the splits for this dimension
     for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
@@ -529,7 +553,7 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     }
 
     const double actualMinDimError = std::log(minDimError)
-      - 2 * std::log((double) data.n_cols)
+      - 2 * std::log((double) totalPoints)
       - volumeWithoutDim;
 
 #pragma omp critical(DTreeFindUpdate)
@@ -540,9 +564,9 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
       minError = actualMinDimError;
       splitDim = dim;
       splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
+      leftError = std::log(dimLeftError) - 2 * std::log((double) totalPoints)
         - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
+      rightError = std::log(dimRightError) - 2 * std::log((double) totalPoints)
         - volumeWithoutDim;
       splitFound = true;
     } // end if better split found in this dimension.
@@ -596,16 +620,11 @@ double DTree<MatType, TagType>::Grow(MatType& data,
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
 
-  double leftG, rightG;
-
-  // Compute points ratio.
-  ratio = (double) (end - start) / (double) oldFromNew.n_elem;
+  double leftG = std::numeric_limits<double>::max();
+  double rightG = std::numeric_limits<double>::max();
 
-  // Compute the log of the volume of the node.
-  logVolume = 0;
-  for (size_t i = 0; i < maxVals.n_elem; ++i)
-    if (maxVals[i] - minVals[i] > 0.0)
-      logVolume += std::log(maxVals[i] - minVals[i]);
+  // Compute points ratio and the log of the volume of the node.
+  ComputeRatioAndVolume(oldFromNew.n_elem);
 
   // Check if node is large enough to split.
   if ((size_t) (end - start) > maxLeafSize)
@@ -641,34 +660,243 @@ double DTree<MatType, TagType>::Grow(MatType& data,
                          minLeafSize);
       rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
                            minLeafSize);
+    }
+  }
+  else
+  {
+    // We can make this a leaf node.
+    Log::Assert((size_t) (end - start) >= minLeafSize);
+  }
 
-      // Store values of R(T~) and |T~|.
-      subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
+  return FinishGrowth(data.n_cols, useVolReg, leftG, rightG);
+}
 
-      // Find the log negative error of the subtree leaves.  This is kind of an
-      // odd one because we don't want to represent the error in non-log-space,
-      // but we have to calculate log(E_l + E_r).  So we multiply E_l and E_r by
-      // V_t (remember E_l has an inverse relationship to the volume of the
-      // nodes) and then subtract log(V_t) at the end of the whole expression.
-      // As a result we do leave log-space, but the largest quantity we
-      // represent is on the order of (V_t / V_i) where V_i is the smallest leaf
-      // node below this node, which depends heavily on the depth of the tree.
-      subtreeLeavesLogNegError = std::log(
-          std::exp(logVolume + left->SubtreeLeavesLogNegError()) +
-          std::exp(logVolume + right->SubtreeLeavesLogNegError()))
-          - logVolume;
+// Greedily expand the tree with one streaming pass over the data per level.
+template<typename MatType, typename TagType>
+template<typename ChunkSourceType>
+double DTree<MatType, TagType>::GrowHistogram(ChunkSourceType& source,
+                                              const bool useVolReg,
+                                              const size_t maxLeafSize,
+                                              const size_t minLeafSize,
+                                              const size_t bins,
+                                              const size_t maxDepth)
+{
+  Log::Assert(bins > 1);
+
+  const size_t totalPoints = end - start;
+  const size_t dims = maxVals.n_elem;
+
+  ComputeRatioAndVolume(totalPoints);
+
+  // The nodes of the current level that may still be split.
+  std::vector<DTree*> level;
+  if (totalPoints > maxLeafSize && maxDepth > 0)
+    level.push_back(this);
+
+  for (size_t depth = 0; !level.empty(); ++depth)
+  {
+    std::unordered_map<const DTree*, size_t> levelIndices;
+    std::vector<arma::Mat<size_t>> histograms(level.size());
+    std::vector<arma::Mat<ElemType>> edges(level.size());
+    for (size_t j = 0; j < level.size(); ++j)
+    {
+      levelIndices[level[j]] = j;
+      histograms[j].zeros(bins, dims);
+      level[j]->HistogramEdges(bins, edges[j]);
     }
-    else
+
+    // Fill the histograms of all the nodes of this level with one pass over
+    // the data.
+    MatType chunk;
+    arma::Col<size_t> chunkNodes;
+    source.Reset();
+    while (source.NextChunk(chunk))
     {
-      // No split found so make a leaf out of it.
-      subtreeLeaves = 1;
-      subtreeLeavesLogNegError = logNegError;
+      Log::Assert(chunk.n_rows == dims);
+
+      // Find the leaf of each point; level.size() marks points whose leaf
+      // isn't split any further.
+      chunkNodes.set_size(chunk.n_cols);
+      #pragma omp parallel for
+      for (omp_size_t i = 0; i < (omp_size_t) chunk.n_cols; ++i)
+      {
+        const DTree* node = this;
+        while (node->left)
+        {
+          node = (chunk(node->splitDim, i) <= node->splitValue) ?
+              node->left : node->right;
+        }
+
+        typename std::unordered_map<const DTree*, size_t>::const_iterator it =
+            levelIndices.find(node);
+        chunkNodes[i] = (it == levelIndices.end()) ? level.size() : it->second;
+      }
+
+      // Every thread fills the histograms of its own dimensions.
+      #pragma omp parallel for
+      for (omp_size_t d = 0; d < (omp_size_t) dims; ++d)
+      {
+        for (size_t i = 0; i < chunk.n_cols; ++i)
+        {
+          const size_t j = chunkNodes[i];
+          if (j == level.size())
+            continue;
+
+          // The number of edges below the value is the bin of the value.
+          const ElemType value = chunk(d, i);
+          const ElemType* dimEdges = edges[j].colptr(d);
+          const size_t bin = std::lower_bound(dimEdges, dimEdges + bins - 1,
+              value) - dimEdges;
+          ++histograms[j](bin, d);
+        }
+      }
+    }
+
+    // Split the nodes of this level.
+    std::vector<DTree*> nextLevel;
+    for (size_t j = 0; j < level.size(); ++j)
+    {
+      DTree& node = *level[j];
+
+      size_t dim;
+      ElemType splitValueTmp;
+      double leftError, rightError;
+      size_t leftPoints;
+      if (!node.FindHistogramSplit(histograms[j], edges[j], totalPoints, dim,
+          splitValueTmp, leftError, rightError, leftPoints, minLeafSize))
+        continue;
+
+      // Make max and min vals for the children.
+      StatType maxValsL(node.maxVals);
+      StatType maxValsR(node.maxVals);
+      StatType minValsL(node.minVals);
+      StatType minValsR(node.minVals);
+
+      maxValsL[dim] = splitValueTmp;
+      minValsR[dim] = splitValueTmp;
+
+      node.splitValue = splitValueTmp;
+      node.splitDim = dim;
+
+      // The children get the ranges that their points would have if the data
+      // were reordered like in Grow().
+      const size_t splitIndex = node.start + leftPoints;
+      node.left = new DTree(maxValsL, minValsL, node.start, splitIndex,
+          leftError);
+      node.right = new DTree(maxValsR, minValsR, splitIndex, node.end,
+          rightError);
+
+      for (size_t c = 0; c < 2; ++c)
+      {
+        DTree* child = node.ChildPtr(c);
+        child->ComputeRatioAndVolume(totalPoints);
+        if ((size_t) (child->end - child->start) > maxLeafSize &&
+            depth + 1 < maxDepth)
+          nextLevel.push_back(child);
+      }
     }
+
+    level.swap(nextLevel);
+  }
+
+  return FinishSubtreeGrowth(totalPoints, useVolReg);
+}
+
+// Find the best split among the histogram edges.
+template<typename MatType, typename TagType>
+bool DTree<MatType, TagType>::FindHistogramSplit(
+    const arma::Mat<size_t>& histogram,
+    const arma::Mat<ElemType>& edges,
+    const size_t totalPoints,
+    size_t& splitDim,
+    ElemType& splitValue,
+    double& leftError,
+    double& rightError,
+    size_t& leftPoints,
+    const size_t minLeafSize) const
+{
+  typedef std::pair<ElemType, size_t> SplitItem;
+
+  const size_t points = end - start;
+  auto extractSplits = [&](const size_t dim, std::vector<SplitItem>& splitVec)
+  {
+    // The points left of edge b are the points of the bins up to b.
+    size_t position = 0;
+    for (size_t b = 0; b < edges.n_rows; ++b)
+    {
+      position += histogram(b, dim);
+      if (position >= minLeafSize && points - position >= minLeafSize &&
+          (b == 0 || edges(b, dim) != edges(b - 1, dim)))
+        splitVec.push_back(SplitItem(edges(b, dim), position));
+    }
+  };
+
+  if (!FindBestSplit(totalPoints, extractSplits, splitDim, splitValue,
+      leftError, rightError, minLeafSize))
+    return false;
+
+  // Recover the number of points left of the chosen edge.
+  leftPoints = 0;
+  for (size_t b = 0; b < edges.n_rows && edges(b, splitDim) <= splitValue; ++b)
+    leftPoints += histogram(b, splitDim);
+
+  return true;
+}
+
+// Compute the edges of the histogram bins, equally spaced over the node.
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::HistogramEdges(const size_t bins,
+                                             arma::Mat<ElemType>& edges) const
+{
+  edges.set_size(bins - 1, maxVals.n_elem);
+  for (size_t d = 0; d < maxVals.n_elem; ++d)
+  {
+    const ElemType width = (maxVals[d] - minVals[d]) / bins;
+    for (size_t b = 0; b < bins - 1; ++b)
+      edges(b, d) = minVals[d] + (b + 1) * width;
+  }
+}
+
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::ComputeRatioAndVolume(const size_t totalPoints)
+{
+  // Compute points ratio.
+  ratio = (double) (end - start) / (double) totalPoints;
+
+  // Compute the log of the volume of the node.
+  logVolume = 0;
+  for (size_t i = 0; i < maxVals.n_elem; ++i)
+    if (maxVals[i] - minVals[i] > 0.0)
+      logVolume += std::log(maxVals[i] - minVals[i]);
+}
+
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::FinishGrowth(const size_t totalPoints,
+                                             const bool useVolReg,
+                                             const double leftG,
+                                             const double rightG)
+{
+  if (left)
+  {
+    // Store values of R(T~) and |T~|.
+    subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
+
+    // Find the log negative error of the subtree leaves.  This is kind of an
+    // odd one because we don't want to represent the error in non-log-space,
+    // but we have to calculate log(E_l + E_r).  So we multiply E_l and E_r by
+    // V_t (remember E_l has an inverse relationship to the volume of the
+    // nodes) and then subtract log(V_t) at the end of the whole expression.
+    // As a result we do leave log-space, but the largest quantity we
+    // represent is on the order of (V_t / V_i) where V_i is the smallest leaf
+    // node below this node, which depends heavily on the depth of the tree.
+    subtreeLeavesLogNegError = std::log(
+        std::exp(logVolume + left->SubtreeLeavesLogNegError()) +
+        std::exp(logVolume + right->SubtreeLeavesLogNegError()))
+        - logVolume;
   }
   else
   {
-    // We can make this a leaf node.
-    Log::Assert((size_t) (end - start) >= minLeafSize);
+    // No split was found (or the node is small enough), so this is a leaf.
     subtreeLeaves = 1;
     subtreeLeavesLogNegError = logNegError;
   }
@@ -695,7 +923,7 @@ double DTree<MatType, TagType>::Grow(MatType& data,
 
     if (left->SubtreeLeaves() > 1)
     {
-      const double exponent = 2 * std::log((double) data.n_cols) + logVolume +
+      const double exponent = 2 * std::log((double) totalPoints) + logVolume +
           left->AlphaUpper();
 
       // Whether or not this will overflow is highly dependent on the depth of
@@ -705,14 +933,14 @@ double DTree<MatType, TagType>::Grow(MatType& data,
 
     if (right->SubtreeLeaves() > 1)
     {
-      const double exponent = 2 * std::log((double) data.n_cols)
+      const double exponent = 2 * std::log((double) totalPoints)
         + logVolume
         + right->AlphaUpper();
 
       tmpAlphaSum += std::exp(exponent);
     }
 
-    alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) data.n_cols)
+    alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) totalPoints)
       - logVolume;
 
     double gT;
@@ -734,6 +962,21 @@ double DTree<MatType, TagType>::Grow(MatType& data,
   // -1.0 * subtreeLeavesError.
 }
 
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::FinishSubtreeGrowth(const size_t totalPoints,
+                                                    const bool useVolReg)
+{
+  double leftG = std::numeric_limits<double>::max();
+  double rightG = std::numeric_limits<double>::max();
+  if (left)
+  {
+    leftG = left->FinishSubtreeGrowth(totalPoints, useVolReg);
+    rightG = right->FinishSubtreeGrowth(totalPoints, useVolReg);
+  }
+
+  return FinishGrowth(totalPoints, useVolReg, leftG, rightG);
+}
+
 
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::PruneAndUpdate(const double oldAlpha,
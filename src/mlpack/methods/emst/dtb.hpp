@@ -68,6 +68,14 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * When OpenMP is available, each Boruvka round runs in parallel: the
+ * BinarySpaceTree types (like the default kd-tree) are traversed with the
+ * ParallelDualTreeTraverser, and the naive computation splits the query points
+ * over the threads.  Every thread keeps its own candidate edge for each
+ * component, and the candidates are merged at the end of the round.  These
+ * arrays take 3 * (number of components) * (number of threads) elements; the
+ * number of components at least halves in each round.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -105,12 +113,17 @@ class DualTreeBoruvka
   //! Connections.
   UnionFind connections;
 
-  //! List of edge nodes.
-  arma::Col<size_t> neighborsInComponent;
-  //! List of edge nodes.
-  arma::Col<size_t> neighborsOutComponent;
-  //! List of edge distances.
-  arma::vec neighborsDistances;
+  //! The component of each point in the current round, numbered from 0.
+  arma::Col<size_t> components;
+  //! The number of components in the current round.
+  size_t numComponents;
+
+  //! List of edge nodes, for each component (rows) and thread (columns).
+  arma::Mat<size_t> neighborsInComponent;
+  //! List of edge nodes, for each component (rows) and thread (columns).
+  arma::Mat<size_t> neighborsOutComponent;
+  //! List of edge distances, for each component (rows) and thread (columns).
+  arma::mat neighborsDistances;
 
   //! Total distance of the tree.
   double totalDist;
@@ -183,10 +196,17 @@ class DualTreeBoruvka
   void AddEdge(const size_t e1, const size_t e2, const double distance);
 
   /**
-   * Adds all the edges found in one iteration to the list of neighbors.
+   * Merges the candidate edges found by each thread, and adds the best edge of
+   * every component to the list of neighbors.
    */
   void AddAllEdges();
 
+  /**
+   * Numbers the components of the union-find structure consecutively, and
+   * resets the candidate edges of every thread.
+   */
+  void UpdateComponents();
+
   /**
    * Unpermute the edge list and output it to results.
    */
@@ -14,6 +14,10 @@
 
 #include "dtb_rules.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace emst {
 
@@ -39,6 +43,38 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+//! Traverse the tree with itself, using the dual-tree traverser of the tree.
+//! Returns the number of node combinations that were pruned.
+template<typename TreeType, typename RuleType>
+size_t DualTreeTraversal(TreeType& node, RuleType& rules)
+{
+  typename TreeType::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(node, node);
+  return traverser.NumPrunes();
+}
+
+//! Traverse a BinarySpaceTree with itself, traversing the top levels of the
+//! query tree in parallel.  Returns the number of node combinations that were
+//! pruned.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename RuleType>
+size_t DualTreeTraversal(tree::BinarySpaceTree<MetricType, StatisticType,
+                             MatType, BoundType, SplitType>& node,
+                         RuleType& rules)
+{
+  typedef tree::BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+      SplitType> TreeType;
+  typename TreeType::template ParallelDualTreeTraverser<RuleType>
+      traverser(rules);
+  traverser.Traverse(node, node);
+  return traverser.NumPrunes();
+}
+
 /**
  * Takes in a reference to the data set.  Copies the data, builds the tree,
  * and initializes all of the member variables.
@@ -58,15 +94,11 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(!naive),
     naive(naive),
     connections(dataset.n_cols),
+    numComponents(0),
     totalDist(0.0),
     metric(metric)
 {
   edges.reserve(data.n_cols - 1); // Set size.
-
-  neighborsInComponent.set_size(data.n_cols);
-  neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
 }
 
 template<
@@ -83,15 +115,11 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(false),
     naive(false),
     connections(data.n_cols),
+    numComponents(0),
     totalDist(0.0),
     metric(metric)
 {
   edges.reserve(data.n_cols - 1); // Fill with EdgePairs.
-
-  neighborsInComponent.set_size(data.n_cols);
-  neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
 }
 
 template<
@@ -123,22 +151,36 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
 
   totalDist = 0; // Reset distance.
 
+  // The candidate arrays are sized for the number of threads available now.
+  UpdateComponents();
+
   typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
+  RuleType rules(data, components, neighborsDistances, neighborsInComponent,
                  neighborsOutComponent, metric);
+  size_t prunes = 0;
   while (edges.size() < (data.n_cols - 1))
   {
     if (naive)
     {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
+      // Full O(N^2) traversal.  Each thread counts its base cases in its own
+      // copy of the rules; the candidate edges are kept per thread anyway.
+      #pragma omp parallel
+      {
+        RuleType threadRules(rules);
+        threadRules.BaseCases() = 0;
+
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            threadRules.BaseCase(i, j);
+
+        #pragma omp critical
+        rules.BaseCases() += threadRules.BaseCases();
+      }
     }
     else
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      prunes += DualTreeTraversal(*tree, rules);
     }
 
     AddAllEdges();
@@ -154,6 +196,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     }
   }
 
+  WorkCounters::Add("emst", rules.BaseCases(), rules.Scores(), prunes);
   Timer::Stop("emst/mst_computation");
 
   EmitResults(results);
@@ -195,22 +238,81 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
+  // Reduce the candidates of all threads into the first column.  Ties are
+  // broken towards the lowest thread, so that the edge doesn't depend on the
+  // order in which the threads merge.
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numComponents; ++c)
   {
-    size_t component = connections.Find(i);
-    size_t inEdge = neighborsInComponent[component];
-    size_t outEdge = neighborsOutComponent[component];
+    for (size_t t = 1; t < neighborsDistances.n_cols; ++t)
+    {
+      if (neighborsDistances(c, t) < neighborsDistances(c, 0))
+      {
+        neighborsDistances(c, 0) = neighborsDistances(c, t);
+        neighborsInComponent(c, 0) = neighborsInComponent(c, t);
+        neighborsOutComponent(c, 0) = neighborsOutComponent(c, t);
+      }
+    }
+  }
+
+  for (size_t c = 0; c < numComponents; ++c)
+  {
+    // A component without a candidate can only happen if it is the last one.
+    if (neighborsDistances(c, 0) == DBL_MAX)
+      continue;
+
+    size_t inEdge = neighborsInComponent(c, 0);
+    size_t outEdge = neighborsOutComponent(c, 0);
     if (connections.Find(inEdge) != connections.Find(outEdge))
     {
       // totalDist = totalDist + dist;
       // changed to make this agree with the cover tree code
-      totalDist += neighborsDistances[component];
-      AddEdge(inEdge, outEdge, neighborsDistances[component]);
+      totalDist += neighborsDistances(c, 0);
+      AddEdge(inEdge, outEdge, neighborsDistances(c, 0));
       connections.Union(inEdge, outEdge);
     }
   }
 }
 
+/**
+ * Number the components consecutively and reset the candidate edges.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::UpdateComponents()
+{
+  // UnionFind::Find() compresses paths, so it can't be called from the
+  // traversal threads; instead the component of every point is looked up once
+  // per round.  The components are numbered in the order of their first point,
+  // so before any edge is added the component of each point is the point
+  // itself, which is what DTBStat assumes for single-point leaves.
+  arma::Col<size_t> rootComponents(data.n_cols);
+  rootComponents.fill(data.n_cols); // Invalid value.
+  components.set_size(data.n_cols);
+  numComponents = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const size_t root = connections.Find(i);
+    if (rootComponents[root] == data.n_cols)
+      rootComponents[root] = numComponents++;
+    components[i] = rootComponents[root];
+  }
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  neighborsDistances.set_size(numComponents, numThreads);
+  neighborsDistances.fill(DBL_MAX);
+  neighborsInComponent.zeros(numComponents, numThreads);
+  neighborsOutComponent.zeros(numComponents, numThreads);
+}
+
 /**
  * Unpermute the edge list (if necessary) and output it to results.
  */
@@ -291,7 +393,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
   // if all other components of children and points are the same.
   const int component = (tree->NumChildren() != 0) ?
       tree->Child(0).Stat().ComponentMembership() :
-      connections.Find(tree->Point(0));
+      components[tree->Point(0)];
 
   // Check components of children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
@@ -300,7 +402,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
 
   // Check components of points.
   for (size_t i = 0; i < tree->NumPoints(); ++i)
-    if (connections.Find(tree->Point(i)) != size_t(component))
+    if (components[tree->Point(i)] != size_t(component))
       return;
 
   // If we made it this far, all components are the same.
@@ -318,8 +420,7 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
-    neighborsDistances[i] = DBL_MAX;
+  UpdateComponents();
 
   if (!naive)
     CleanupHelper(tree);
@@ -19,15 +19,37 @@
 namespace mlpack {
 namespace emst {
 
+/**
+ * The rules for one Boruvka round of the DualTreeBoruvka algorithm.  The
+ * candidate edge of each component is kept separately for each OpenMP thread:
+ * column t of the candidate arrays holds the candidates found by thread t, so
+ * copies of the rules can be used by the tasks of a parallel traversal without
+ * locking.  The candidates of the threads are merged after the traversal.
+ * Every candidate is a real edge, so pruning with the candidates of one thread
+ * only is correct (if less effective).
+ */
 template<typename MetricType, typename TreeType>
 class DTBRules
 {
  public:
+  /**
+   * Construct the rules.
+   *
+   * @param dataSet The data points.
+   * @param components The component of each point in this round.  The
+   *     components must be numbered consecutively from 0.
+   * @param neighborsDistances Candidate edge distances, with one row per
+   *     component and one column per thread.
+   * @param neighborsInComponent Candidate edge endpoints inside each component.
+   * @param neighborsOutComponent Candidate edge endpoints outside of each
+   *     component.
+   * @param metric The instantiated metric.
+   */
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
-           arma::vec& neighborsDistances,
-           arma::Col<size_t>& neighborsInComponent,
-           arma::Col<size_t>& neighborsOutComponent,
+           const arma::Col<size_t>& components,
+           arma::mat& neighborsDistances,
+           arma::Mat<size_t>& neighborsInComponent,
+           arma::Mat<size_t>& neighborsOutComponent,
            MetricType& metric);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -101,19 +123,20 @@ class DTBRules
   //! The data points.
   const arma::mat& dataSet;
 
-  //! Stores the tree structure so far
-  UnionFind& connections;
+  //! The component of each point in this round.
+  const arma::Col<size_t>& components;
 
-  //! The distance to the candidate nearest neighbor for each component.
-  arma::vec& neighborsDistances;
+  //! The distance to the candidate nearest neighbor for each component, found
+  //! by each thread.
+  arma::mat& neighborsDistances;
 
   //! The index of the point in the component that is an endpoint of the
-  //! candidate edge.
-  arma::Col<size_t>& neighborsInComponent;
+  //! candidate edge, for each thread.
+  arma::Mat<size_t>& neighborsInComponent;
 
   //! The index of the point outside of the component that is an endpoint
-  //! of the candidate edge.
-  arma::Col<size_t>& neighborsOutComponent;
+  //! of the candidate edge, for each thread.
+  arma::Mat<size_t>& neighborsOutComponent;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -123,6 +146,9 @@ class DTBRules
    */
   inline double CalculateBound(TreeType& queryNode) const;
 
+  //! Get the column of the candidate arrays of the calling thread.
+  size_t Thread() const;
+
   TraversalInfoType traversalInfo;
 
   //! The number of base cases calculated.
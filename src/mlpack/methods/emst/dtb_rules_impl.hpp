@@ -12,20 +12,24 @@
 #ifndef MLPACK_METHODS_EMST_DTB_RULES_IMPL_HPP
 #define MLPACK_METHODS_EMST_DTB_RULES_IMPL_HPP
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace emst {
 
 template<typename MetricType, typename TreeType>
 DTBRules<MetricType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
-         arma::vec& neighborsDistances,
-         arma::Col<size_t>& neighborsInComponent,
-         arma::Col<size_t>& neighborsOutComponent,
+         const arma::Col<size_t>& components,
+         arma::mat& neighborsDistances,
+         arma::Mat<size_t>& neighborsInComponent,
+         arma::Mat<size_t>& neighborsOutComponent,
          MetricType& metric)
 :
   dataSet(dataSet),
-  connections(connections),
+  components(components),
   neighborsDistances(neighborsDistances),
   neighborsInComponent(neighborsInComponent),
   neighborsOutComponent(neighborsOutComponent),
@@ -45,11 +49,12 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
   // If not, return the distance between them.  Also, store a better result as
   // the current neighbor, if necessary.
   double newUpperBound = -1.0;
+  const size_t thread = Thread();
 
   // Find the index of the component the query is in.
-  size_t queryComponentIndex = connections.Find(queryIndex);
+  size_t queryComponentIndex = components[queryIndex];
 
-  size_t referenceComponentIndex = connections.Find(referenceIndex);
+  size_t referenceComponentIndex = components[referenceIndex];
 
   if (queryComponentIndex != referenceComponentIndex)
   {
@@ -57,18 +62,18 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
     double distance = metric.Evaluate(dataSet.col(queryIndex),
                                       dataSet.col(referenceIndex));
 
-    if (distance < neighborsDistances[queryComponentIndex])
+    if (distance < neighborsDistances(queryComponentIndex, thread))
     {
       Log::Assert(queryIndex != referenceIndex);
 
-      neighborsDistances[queryComponentIndex] = distance;
-      neighborsInComponent[queryComponentIndex] = queryIndex;
-      neighborsOutComponent[queryComponentIndex] = referenceIndex;
+      neighborsDistances(queryComponentIndex, thread) = distance;
+      neighborsInComponent(queryComponentIndex, thread) = queryIndex;
+      neighborsOutComponent(queryComponentIndex, thread) = referenceIndex;
     }
   }
 
-  if (newUpperBound < neighborsDistances[queryComponentIndex])
-    newUpperBound = neighborsDistances[queryComponentIndex];
+  if (newUpperBound < neighborsDistances(queryComponentIndex, thread))
+    newUpperBound = neighborsDistances(queryComponentIndex, thread);
 
   Log::Assert(newUpperBound >= 0.0);
 
@@ -79,7 +84,7 @@ template<typename MetricType, typename TreeType>
 double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
                                              TreeType& referenceNode)
 {
-  size_t queryComponentIndex = connections.Find(queryIndex);
+  size_t queryComponentIndex = components[queryIndex];
 
   // If the query belongs to the same component as all of the references,
   // then prune.  The cast is to stop a warning about comparing unsigned to
@@ -93,7 +98,7 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
+  return neighborsDistances(queryComponentIndex, Thread()) < distance
       ? DBL_MAX : distance;
 }
 
@@ -104,7 +109,7 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
+  return (oldScore > neighborsDistances(components[queryIndex], Thread()))
       ? DBL_MAX : oldScore;
 }
 
@@ -149,11 +154,13 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   double worstChildBound = -DBL_MAX;
   double bestChildBound = DBL_MAX;
 
+  const size_t thread = Thread();
+
   // Now, find the best and worst point bounds.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const size_t pointComponent = connections.Find(queryNode.Point(i));
-    const double bound = neighborsDistances[pointComponent];
+    const size_t pointComponent = components[queryNode.Point(i)];
+    const double bound = neighborsDistances(pointComponent, thread);
 
     if (bound > worstPointBound)
       worstPointBound = bound;
@@ -188,6 +195,16 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   return queryNode.Stat().Bound();
 }
 
+template<typename MetricType, typename TreeType>
+inline size_t DTBRules<MetricType, TreeType>::Thread() const
+{
+  #ifdef HAS_OPENMP
+    return omp_get_thread_num();
+  #else
+    return 0;
+  #endif
+}
+
 } // namespace emst
 } // namespace mlpack
 
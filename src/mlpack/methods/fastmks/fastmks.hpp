@@ -144,6 +144,15 @@ class FastMKS
    */
   void Train(const MatType& referenceSet);
 
+  /**
+   * "Train" the FastMKS model on the given reference set, taking ownership of
+   * it (this will just build a tree, if the current search mode is not naive
+   * mode).
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType&& referenceSet);
+
   /**
    * "Train" the FastMKS model on the given reference set and use the given
    * kernel.  This will just build a tree and replace the metric, if the current
@@ -178,6 +187,11 @@ class FastMKS
    * to use single-tree search, either by setting singleMode to false in the
    * constructor or with SingleMode().
    *
+   * The search runs on all threads (see Threads): naive search handles blocks
+   * of query points in parallel, single-tree search hands out batches of query
+   * points to the threads, and dual-tree search splits large query sets into
+   * one chunk per thread, each searched with its own query tree.
+   *
    * @param querySet Set of query points (can be a single point).
    * @param k The number of maximum kernels to find.
    * @param indices Matrix to store resulting indices of max-kernel search in.
@@ -285,6 +299,39 @@ class FastMKS
   //! Use a priority queue to represent the list of candidate points.
   typedef std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp> CandidateList;
+
+  /**
+   * Brute-force search: compute the kernel values between blocks of query
+   * points and blocks of reference points (with one matrix multiplication per
+   * block for kernels with an EvaluateBlock() member), with the blocks of
+   * query points handled in parallel.
+   *
+   * @param querySet Set of query points.
+   * @param sameSet If true, the query set is the reference set, and a point is
+   *     not returned as its own candidate.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix (already sized) to store the indices in.
+   * @param kernels Matrix (already sized) to store the kernel values in.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const bool sameSet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels);
+
+  /**
+   * Traverse the reference tree once for each of the given number of query
+   * points with the single-tree traverser.  The query points are split into
+   * batches that are handed out dynamically to the available OpenMP threads.
+   * Each thread uses its own copy of the rules (copies share the candidate
+   * lists, and the batches are disjoint); the base case and score counts are
+   * added back into the given rules, and the number of prunes is returned.
+   *
+   * @param rules Rules to use for the traversal.
+   * @param numQueries Number of query points.
+   */
+  template<typename RuleType>
+  size_t SingleTreeSearch(RuleType& rules, const size_t numQueries);
 };
 
 } // namespace fastmks
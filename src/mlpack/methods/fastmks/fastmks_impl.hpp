@@ -18,6 +18,13 @@
 #include "fastmks_rules.hpp"
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+
+#include <numeric>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace fastmks {
@@ -227,6 +234,32 @@ void FastMKS<KernelType, MatType, TreeType>::Train(const MatType& referenceSet)
   }
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::Train(MatType&& referenceSet)
+{
+  if (setOwner)
+    delete this->referenceSet;
+
+  if (!naive)
+  {
+    if (treeOwner && referenceTree)
+      delete referenceTree;
+    referenceTree = new Tree(std::move(referenceSet), metric);
+    treeOwner = true;
+    this->referenceSet = &referenceTree->Dataset();
+    this->setOwner = false;
+  }
+  else
+  {
+    this->referenceSet = new MatType(std::move(referenceSet));
+    this->setOwner = true;
+  }
+}
+
 template<typename KernelType,
          typename MatType,
          template<typename TreeMetricType,
@@ -304,33 +337,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, false, k, indices, kernels);
 
     Timer::Stop("computing_products");
 
@@ -345,13 +352,11 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     typedef FastMKSRules<KernelType, Tree> RuleType;
     RuleType rules(*referenceSet, querySet, k, metric.Kernel());
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    const size_t numPrunes = SingleTreeSearch(rules, querySet.n_cols);
 
     Log::Info << rules.BaseCases() << " base cases." << std::endl;
     Log::Info << rules.Scores() << " scores." << std::endl;
+    WorkCounters::Add("fastmks", rules.BaseCases(), rules.Scores(), numPrunes);
 
     rules.GetResults(indices, kernels);
 
@@ -359,11 +364,62 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     return;
   }
 
-  // Dual-tree implementation.  First, we need to build the query tree.  We are
-  // assuming it doesn't map anything...
+  // Dual-tree implementation.  With several threads, the query set is split
+  // into one chunk per thread, and each chunk is searched with its own query
+  // tree.  The query trees don't share anything, and the dual-tree rules only
+  // read the reference tree, so the chunks can be searched at the same time.
+  // Each chunk should be large enough that its query tree still prunes well.
+  const size_t minChunkSize = 1000;
+  const size_t numChunks = std::max((size_t) 1, std::min(Threads::Count(),
+      (size_t) querySet.n_cols / minChunkSize));
+  if (numChunks > 1)
+  {
+    std::vector<size_t> baseCases(numChunks, 0), scores(numChunks, 0),
+        prunes(numChunks, 0);
+    Threads::ParallelFor(0, numChunks, [&](const size_t c)
+    {
+      const size_t begin = c * querySet.n_cols / numChunks;
+      const size_t end = (c + 1) * querySet.n_cols / numChunks;
+
+      // We are assuming the query tree doesn't map anything...
+      MatType chunk = querySet.cols(begin, end - 1);
+      Tree queryTree(std::move(chunk), metric);
+
+      typedef FastMKSRules<KernelType, Tree> RuleType;
+      RuleType rules(*referenceSet, queryTree.Dataset(), k, metric.Kernel());
+
+      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+      traverser.Traverse(queryTree, *referenceTree);
+
+      arma::Mat<size_t> chunkIndices;
+      arma::mat chunkKernels;
+      rules.GetResults(chunkIndices, chunkKernels);
+      indices.cols(begin, end - 1) = chunkIndices;
+      kernels.cols(begin, end - 1) = chunkKernels;
+
+      baseCases[c] = rules.BaseCases();
+      scores[c] = rules.Scores();
+      prunes[c] = traverser.NumPrunes();
+    });
+
+    const size_t totalBaseCases = std::accumulate(baseCases.begin(),
+        baseCases.end(), (size_t) 0);
+    const size_t totalScores = std::accumulate(scores.begin(), scores.end(),
+        (size_t) 0);
+    Log::Info << totalBaseCases << " base cases." << std::endl;
+    Log::Info << totalScores << " scores." << std::endl;
+    WorkCounters::Add("fastmks", totalBaseCases, totalScores,
+        std::accumulate(prunes.begin(), prunes.end(), (size_t) 0));
+
+    Timer::Stop("computing_products");
+    return;
+  }
+
+  // With a single chunk, we build one query tree, with the same kernel as the
+  // reference tree.  We are assuming it doesn't map anything...
   Timer::Stop("computing_products");
   Timer::Start("tree_building");
-  Tree queryTree(querySet);
+  Tree queryTree(querySet, metric);
   Timer::Stop("tree_building");
 
   Search(&queryTree, k, indices, kernels);
@@ -409,6 +465,8 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
 
   Log::Info << rules.BaseCases() << " base cases." << std::endl;
   Log::Info << rules.Scores() << " scores." << std::endl;
+  WorkCounters::Add("fastmks", rules.BaseCases(), rules.Scores(),
+      traverser.NumPrunes());
 
   rules.GetResults(indices, kernels);
 
@@ -433,36 +491,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
-
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(*referenceSet, true, k, indices, kernels);
 
     Timer::Stop("computing_products");
 
@@ -477,18 +506,14 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     typedef FastMKSRules<KernelType, Tree> RuleType;
     RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
     // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
+    const size_t numPrunes = SingleTreeSearch(rules, referenceSet->n_cols);
 
     Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
 
     Log::Info << rules.BaseCases() << " base cases." << std::endl;
     Log::Info << rules.Scores() << " scores." << std::endl;
+    WorkCounters::Add("fastmks", rules.BaseCases(), rules.Scores(), numPrunes);
 
     rules.GetResults(indices, kernels);
 
@@ -502,6 +527,141 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const bool sameSet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels)
+{
+  // The kernel values are computed in blocks of query and reference points;
+  // for kernels with an EvaluateBlock() member (such as the linear and
+  // polynomial kernels) each block is one matrix multiplication.  Blocks of
+  // query points are handled in parallel.
+  const size_t queryBlockSize = 256;
+  const size_t referenceBlockSize = 2048;
+  const size_t numQueryBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  Threads::ParallelFor(0, numQueryBlocks, [&](const size_t block)
+  {
+    const size_t queryBegin = block * queryBlockSize;
+    const size_t queryCount = std::min(queryBlockSize,
+        (size_t) querySet.n_cols - queryBegin);
+    const arma::mat queryBlock(const_cast<double*>(querySet.colptr(
+        queryBegin)), querySet.n_rows, queryCount, false, true);
+
+    const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+    std::vector<CandidateList> pqueues;
+    for (size_t q = 0; q < queryCount; ++q)
+      pqueues.push_back(CandidateList(CandidateCmp(),
+          std::vector<Candidate>(k, def)));
+
+    arma::mat products;
+    for (size_t refBegin = 0; refBegin < referenceSet->n_cols;
+         refBegin += referenceBlockSize)
+    {
+      const size_t refCount = std::min(referenceBlockSize,
+          (size_t) referenceSet->n_cols - refBegin);
+      const arma::mat referenceBlock(const_cast<double*>(
+          referenceSet->colptr(refBegin)), referenceSet->n_rows, refCount,
+          false, true);
+
+      products.set_size(refCount, queryCount);
+      kernel::EvaluateKernelBlock(metric.Kernel(), referenceBlock, queryBlock,
+          products);
+
+      // The reference points are visited in order, so ties are broken the
+      // same way as a point-by-point search.
+      for (size_t q = 0; q < queryCount; ++q)
+      {
+        CandidateList& pqueue = pqueues[q];
+        for (size_t r = 0; r < refCount; ++r)
+        {
+          // Don't return the point as its own candidate.
+          if (sameSet && (queryBegin + q == refBegin + r))
+            continue;
+
+          const double eval = products(r, q);
+          if (eval > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(eval, refBegin + r);
+            pqueue.pop();
+            pqueue.push(c);
+          }
+        }
+      }
+    }
+
+    for (size_t q = 0; q < queryCount; ++q)
+    {
+      CandidateList& pqueue = pqueues[q];
+      for (size_t j = 1; j <= k; j++)
+      {
+        indices(k - j, queryBegin + q) = pqueue.top().second;
+        kernels(k - j, queryBegin + q) = pqueue.top().first;
+        pqueue.pop();
+      }
+    }
+  });
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+size_t FastMKS<KernelType, MatType, TreeType>::SingleTreeSearch(
+    RuleType& rules,
+    const size_t numQueries)
+{
+  // Small batches keep the load balanced; large enough batches keep the
+  // scheduling overhead negligible next to a full tree traversal.
+  const size_t batchSize = 64;
+  const size_t numBatches = (numQueries + batchSize - 1) / batchSize;
+  size_t numPrunes = 0;
+
+  #pragma omp parallel if (numBatches > 1)
+  {
+    RuleType threadRules(rules);
+    threadRules.BaseCases() = 0;
+    threadRules.Scores() = 0;
+
+    #ifdef HAS_OPENMP
+    // The single-tree rules keep kernel values in the reference nodes; that
+    // is only safe when a single traversal is running.
+    if (omp_get_num_threads() > 1)
+      threadRules.CacheInReference() = false;
+    #endif
+
+    typename Tree::template SingleTreeTraverser<RuleType>
+        traverser(threadRules);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
+    {
+      const size_t end = std::min(numQueries, ((size_t) b + 1) * batchSize);
+      for (size_t i = (size_t) b * batchSize; i < end; ++i)
+        traverser.Traverse(i, *referenceTree);
+    }
+
+    #pragma omp critical
+    {
+      rules.BaseCases() += threadRules.BaseCases();
+      rules.Scores() += threadRules.Scores();
+      numPrunes += traverser.NumPrunes();
+    }
+  }
+
+  return numPrunes;
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
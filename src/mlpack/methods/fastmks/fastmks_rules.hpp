@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
 #include <boost/heap/priority_queue.hpp>
+#include <memory>
 
 namespace mlpack {
 namespace fastmks {
@@ -26,6 +27,10 @@ namespace fastmks {
  * performing exact max-kernel search. For each point in the query dataset, it
  * keeps track of the k best candidates in the reference dataset.
  *
+ * Copies of a FastMKSRules object share the candidate lists, so that several
+ * copies can search for disjoint sets of query points at the same time (see
+ * CacheInReference()).
+ *
  * @tparam KernelType Type of kernel to run FastMKS with.
  * @tparam TreeType Type of tree to run FastMKS with; it must satisfy the
  *     TreeType policy API.
@@ -119,6 +124,14 @@ class FastMKSRules
   //! Modify the number of times Score() was called.
   size_t& Scores() { return scores; }
 
+  //! Get whether single-tree kernel evaluations are cached in the reference
+  //! nodes.
+  bool CacheInReference() const { return cacheInReference; }
+  //! Modify whether single-tree kernel evaluations are cached in the reference
+  //! nodes.  This must be false when several rules objects traverse the same
+  //! reference tree concurrently.
+  bool& CacheInReference() { return cacheInReference; }
+
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
 
   const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
@@ -148,8 +161,8 @@ class FastMKSRules
   typedef boost::heap::priority_queue<Candidate,
       boost::heap::compare<CandidateCmp>> CandidateList;
 
-  //! Set of candidates for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidates for each point; this is shared by copies of the rules.
+  std::shared_ptr<std::vector<CandidateList>> candidates;
 
   //! Number of points to search for.
   const size_t k;
@@ -162,12 +175,36 @@ class FastMKSRules
   //! The instantiated kernel.
   KernelType& kernel;
 
-  //! The last query index BaseCase() was called with.
-  size_t lastQueryIndex;
-  //! The last reference index BaseCase() was called with.
-  size_t lastReferenceIndex;
-  //! The last kernel evaluation resulting from BaseCase().
-  double lastKernel;
+  //! A kernel evaluation held in the kernel cache.
+  struct CachedKernel
+  {
+    //! The query index of the evaluation.
+    size_t queryIndex;
+    //! The reference index of the evaluation.
+    size_t referenceIndex;
+    //! The kernel value.
+    double kernel;
+  };
+
+  //! The number of entries in the kernel cache (a power of two).
+  static const size_t kernelCacheSize = 64;
+
+  //! Recent kernel evaluations of BaseCase(), indexed by a hash of the point
+  //! indices, so that a base case that is repeated (e.g. for the self-children
+  //! of a cover tree) is neither evaluated nor inserted twice.
+  std::vector<CachedKernel> kernelCache;
+
+  //! Get the cache entry for the given query and reference indices.
+  CachedKernel& CacheEntry(const size_t queryIndex,
+                           const size_t referenceIndex)
+  {
+    return kernelCache[(referenceIndex * 31 + queryIndex) &
+        (kernelCacheSize - 1)];
+  }
+
+  //! If true, the single-tree Score() keeps the kernel evaluation of each
+  //! reference node in its statistic, for parent-child pruning.
+  bool cacheInReference;
 
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
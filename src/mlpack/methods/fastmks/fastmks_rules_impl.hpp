@@ -28,22 +28,27 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     querySet(querySet),
     k(k),
     kernel(kernel),
-    lastQueryIndex(-1),
-    lastReferenceIndex(-1),
-    lastKernel(0.0),
+    cacheInReference(true),
     baseCases(0),
     scores(0)
 {
   // Precompute each self-kernel.
   queryKernels.set_size(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; ++i)
-    queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
-                                           querySet.col(i)));
+  Threads::ParallelFor(0, querySet.n_cols, [&](const size_t i)
+  {
+    queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i), querySet.col(i)));
+  });
 
   referenceKernels.set_size(referenceSet.n_cols);
-  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+  Threads::ParallelFor(0, referenceSet.n_cols, [&](const size_t i)
+  {
     referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
                                                referenceSet.col(i)));
+  });
+
+  // No evaluation is cached yet.
+  const CachedKernel invalid = { size_t() - 1, size_t() - 1, 0.0 };
+  kernelCache.assign(kernelCacheSize, invalid);
 
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
@@ -60,8 +65,7 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
   pqueue.reserve(k);
   for (size_t i = 0; i < k; i++)
     pqueue.push(def);
-  std::vector<CandidateList> tmp(querySet.n_cols, pqueue);
-  candidates.swap(tmp);
+  candidates.reset(new std::vector<CandidateList>(querySet.n_cols, pqueue));
 }
 
 template<typename KernelType, typename TreeType>
@@ -74,7 +78,7 @@ void FastMKSRules<KernelType, TreeType>::GetResults(
 
   for (size_t i = 0; i < querySet.n_cols; i++)
   {
-    CandidateList& pqueue = candidates[i];
+    CandidateList& pqueue = (*candidates)[i];
     for (size_t j = 1; j <= k; j++)
     {
       indices(k - j, i) = pqueue.top().second;
@@ -92,26 +96,30 @@ double FastMKSRules<KernelType, TreeType>::BaseCase(
 {
   // Score() always happens before BaseCase() for a given node combination.  For
   // cover trees, the kernel evaluation between the two centroid points already
-  // happened.  So we don't need to do it.  Note that this optimizes out if the
-  // first conditional is false (its result is known at compile time).
+  // happened, and the points of self-children repeat those of their parents.
+  // So we don't need to do it again if it is still in the cache.  Note that
+  // this optimizes out if the first conditional is false (its result is known
+  // at compile time).
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
   {
-    if ((queryIndex == lastQueryIndex) &&
-        (referenceIndex == lastReferenceIndex))
-      return lastKernel;
-
-    // Store new values.
-    lastQueryIndex = queryIndex;
-    lastReferenceIndex = referenceIndex;
+    const CachedKernel& cached = CacheEntry(queryIndex, referenceIndex);
+    if ((cached.queryIndex == queryIndex) &&
+        (cached.referenceIndex == referenceIndex))
+      return cached.kernel;
   }
 
   ++baseCases;
   double kernelEval = kernel.Evaluate(querySet.col(queryIndex),
                                       referenceSet.col(referenceIndex));
 
-  // Update the last kernel value, if we need to.
+  // Cache the kernel value, if we need to.
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
-    lastKernel = kernelEval;
+  {
+    CachedKernel& cached = CacheEntry(queryIndex, referenceIndex);
+    cached.queryIndex = queryIndex;
+    cached.referenceIndex = referenceIndex;
+    cached.kernel = kernelEval;
+  }
 
   // If the reference and query sets are identical, we still need to compute the
   // base case (so that things can be bounded properly), but we won't add it to
@@ -129,11 +137,12 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
                                                  TreeType& referenceNode)
 {
   // Compare with the current best.
-  const double bestKernel = candidates[queryIndex].top().first;
+  const double bestKernel = (*candidates)[queryIndex].top().first;
 
-  // See if we can perform a parent-child prune.
+  // See if we can perform a parent-child prune.  This needs the kernel value
+  // of the parent, which is only kept if we cache in the reference nodes.
   const double furthestDist = referenceNode.FurthestDescendantDistance();
-  if (referenceNode.Parent() != NULL)
+  if (cacheInReference && referenceNode.Parent() != NULL)
   {
     double maxKernelBound;
     const double parentDist = referenceNode.ParentDistance();
@@ -171,7 +180,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
   {
     // Could it be that this kernel evaluation has already been calculated?
-    if (tree::TreeTraits<TreeType>::HasSelfChildren &&
+    if (tree::TreeTraits<TreeType>::HasSelfChildren && cacheInReference &&
         referenceNode.Parent() != NULL &&
         referenceNode.Point(0) == referenceNode.Parent()->Point(0))
     {
@@ -190,7 +199,8 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
   }
 
-  referenceNode.Stat().LastKernel() = kernelEval;
+  if (cacheInReference)
+    referenceNode.Stat().LastKernel() = kernelEval;
 
   double maxKernel;
   if (kernel::KernelTraits<KernelType>::IsNormalized)
@@ -334,16 +344,18 @@ double FastMKSRules<KernelType, TreeType>::Score(TreeType& queryNode,
       // Base case already done.
       kernelEval = traversalInfo.LastBaseCase();
 
-      // When BaseCase() is called after Score(), these must be correct so that
-      // another kernel evaluation is not performed.
-      lastQueryIndex = queryNode.Point(0);
-      lastReferenceIndex = referenceNode.Point(0);
+      // When BaseCase() is called after Score(), this must be in the cache so
+      // that another kernel evaluation is not performed.
+      CachedKernel& cached = CacheEntry(queryNode.Point(0),
+          referenceNode.Point(0));
+      cached.queryIndex = queryNode.Point(0);
+      cached.referenceIndex = referenceNode.Point(0);
+      cached.kernel = kernelEval;
     }
     else
     {
       // The kernel must be evaluated, but it is between points in the dataset,
-      // so we can call BaseCase().  BaseCase() will set lastQueryIndex and
-      // lastReferenceIndex correctly.
+      // so we can call BaseCase().  BaseCase() will cache the evaluation.
       kernelEval = BaseCase(queryNode.Point(0), referenceNode.Point(0));
     }
 
@@ -412,7 +424,7 @@ double FastMKSRules<KernelType, TreeType>::Rescore(const size_t queryIndex,
                                                    TreeType& /*referenceNode*/,
                                                    const double oldScore) const
 {
-  const double bestKernel = candidates[queryIndex].top().first;
+  const double bestKernel = (*candidates)[queryIndex].top().first;
 
   return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
 }
@@ -459,7 +471,7 @@ double FastMKSRules<KernelType, TreeType>::CalculateBound(TreeType& queryNode)
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
     const size_t point = queryNode.Point(i);
-    const CandidateList& candidatesPoints = candidates[point];
+    const CandidateList& candidatesPoints = (*candidates)[point];
     if (candidatesPoints.top().first < worstPointKernel)
       worstPointKernel = candidatesPoints.top().first;
 
@@ -529,9 +541,16 @@ inline void FastMKSRules<KernelType, TreeType>::InsertNeighbor(
     const size_t index,
     const double product)
 {
-  CandidateList& pqueue = candidates[queryIndex];
+  CandidateList& pqueue = (*candidates)[queryIndex];
   if (product > pqueue.top().first)
   {
+    // A base case that fell out of the kernel cache may be evaluated again;
+    // the point must not be a candidate twice.
+    typedef typename CandidateList::const_iterator iter;
+    for (iter it = pqueue.begin(); it != pqueue.end(); ++it)
+      if (it->second == index)
+        return;
+
     Candidate c = std::make_pair(product, index);
     pqueue.pop();
     pqueue.push(c);
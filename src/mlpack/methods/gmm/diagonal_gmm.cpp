@@ -0,0 +1,158 @@
+/**
+ * @file diagonal_gmm.cpp
+ *
+ * Implementation of the non-template DiagonalGMM methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "diagonal_gmm.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * Create a GMM with the given number of Gaussians, each of which have the
+ * specified dimensionality.
+ */
+DiagonalGMM::DiagonalGMM(const size_t gaussians, const size_t dimensionality) :
+    gaussians(gaussians),
+    dimensionality(dimensionality),
+    dists(gaussians,
+        distribution::DiagonalGaussianDistribution(dimensionality)),
+    weights(gaussians)
+{
+  // Set equal weights.  Technically this model is still valid, but only barely.
+  weights.fill(1.0 / gaussians);
+}
+
+/**
+ * Return the probability of the given observation being from this GMM.
+ */
+double DiagonalGMM::Probability(const arma::vec& observation) const
+{
+  // Sum the probability for each Gaussian in our mixture (and we have to
+  // multiply by the prior for each Gaussian too).
+  double sum = 0;
+  for (size_t i = 0; i < gaussians; i++)
+    sum += weights[i] * dists[i].Probability(observation);
+
+  return sum;
+}
+
+/**
+ * Return the log probability of the given observation being from this GMM.
+ */
+double DiagonalGMM::LogProbability(const arma::vec& observation) const
+{
+  arma::vec logProbs(gaussians);
+  for (size_t i = 0; i < gaussians; i++)
+    logProbs[i] = std::log(weights[i]) + dists[i].LogProbability(observation);
+
+  const double maxLogProb = logProbs.max();
+  if (maxLogProb == -std::numeric_limits<double>::infinity())
+    return maxLogProb;
+
+  return maxLogProb + std::log(arma::accu(arma::exp(logProbs - maxLogProb)));
+}
+
+/**
+ * Return the probability of the given observation being from the given
+ * component in the mixture.
+ */
+double DiagonalGMM::Probability(const arma::vec& observation,
+                                const size_t component) const
+{
+  // We are only considering one Gaussian component -- so we only need to call
+  // Probability() once.  We do consider the prior probability!
+  return weights[component] * dists[component].Probability(observation);
+}
+
+/**
+ * Return a randomly generated observation according to the probability
+ * distribution defined by this object.
+ */
+arma::vec DiagonalGMM::Random() const
+{
+  // Determine which Gaussian it will be coming from.
+  double gaussRand = math::Random();
+  size_t gaussian = 0;
+
+  double sumProb = 0;
+  for (size_t g = 0; g < gaussians; g++)
+  {
+    sumProb += weights(g);
+    if (gaussRand <= sumProb)
+    {
+      gaussian = g;
+      break;
+    }
+  }
+
+  return dists[gaussian].Random();
+}
+
+/**
+ * Classify the given observations as being from an individual component in this
+ * GMM.
+ */
+void DiagonalGMM::Classify(const arma::mat& observations,
+                           arma::Row<size_t>& labels) const
+{
+  // Compare the weighted log-probabilities of every component, so that points
+  // far away from all the components are still classified.
+  arma::mat logProbs(gaussians, observations.n_cols);
+  arma::vec componentLogProbs;
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    dists[i].LogProbability(observations, componentLogProbs);
+    logProbs.row(i) = componentLogProbs.t() + std::log(weights[i]);
+  }
+
+  labels.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    arma::uword maxIndex;
+    logProbs.col(i).max(maxIndex);
+    labels[i] = maxIndex;
+  }
+}
+
+/**
+ * Get the log-likelihood of this data's fit to the model.
+ */
+double DiagonalGMM::LogLikelihood(
+    const arma::mat& data,
+    const std::vector<distribution::DiagonalGaussianDistribution>& distsL,
+    const arma::vec& weightsL) const
+{
+  arma::mat logLikelihoods(gaussians, data.n_cols);
+  arma::vec logPhis;
+  for (size_t i = 0; i < gaussians; i++)
+  {
+    distsL[i].LogProbability(data, logPhis);
+    logLikelihoods.row(i) = logPhis.t() + std::log(weightsL(i));
+  }
+
+  // Now sum over every point, in log-space.
+  double loglikelihood = 0;
+  for (size_t j = 0; j < data.n_cols; j++)
+  {
+    const double maxLogLikelihood = logLikelihoods.col(j).max();
+    if (maxLogLikelihood == -std::numeric_limits<double>::infinity())
+    {
+      loglikelihood += maxLogLikelihood;
+      continue;
+    }
+
+    loglikelihood += maxLogLikelihood + std::log(arma::accu(
+        arma::exp(logLikelihoods.col(j) - maxLogLikelihood)));
+  }
+
+  return loglikelihood;
+}
+
+} // namespace gmm
+} // namespace mlpack
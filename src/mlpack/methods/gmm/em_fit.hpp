@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
 
 // Default clustering mechanism.
 #include <mlpack/methods/kmeans/kmeans.hpp>
@@ -37,9 +38,19 @@ namespace gmm {
  *
  * This method should create 'clusters' clusters, and return the assignment of
  * each point to a cluster.
+ *
+ * The components of the mixture are of type Distribution, which is either
+ * distribution::GaussianDistribution (the default) or
+ * distribution::DiagonalGaussianDistribution.  For the diagonal distribution
+ * only the diagonal of each covariance is estimated, so every step of the
+ * algorithm takes time and memory linear in the dimensionality, and the
+ * CovarianceConstraintPolicy must be able to constrain a diagonal covariance
+ * stored as an arma::vec (DiagonalConstraint and PositiveDefiniteConstraint
+ * can).
  */
 template<typename InitialClusteringType = kmeans::KMeans<>,
-         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
 class EMFit
 {
  public:
@@ -81,7 +92,7 @@ class EMFit
    *      clustering.
    */
   void Estimate(const arma::mat& observations,
-                std::vector<distribution::GaussianDistribution>& dists,
+                std::vector<Distribution>& dists,
                 arma::vec& weights,
                 const bool useInitialModel = false);
 
@@ -104,7 +115,7 @@ class EMFit
    */
   void Estimate(const arma::mat& observations,
                 const arma::vec& probabilities,
-                std::vector<distribution::GaussianDistribution>& dists,
+                std::vector<Distribution>& dists,
                 arma::vec& weights,
                 const bool useInitialModel = false);
 
@@ -133,6 +144,70 @@ class EMFit
   void serialize(Archive& ar, const unsigned int version);
 
  private:
+  //! The type of the covariance of each component: arma::mat for
+  //! GaussianDistribution, and arma::vec (only the diagonal) for
+  //! DiagonalGaussianDistribution.
+  typedef typename std::decay<decltype(
+      std::declval<const Distribution&>().Covariance())>::type CovarianceType;
+
+  //! Set a full covariance scatter accumulator to zero.
+  static void ZeroScatter(arma::mat& scatter, const size_t dimensionality)
+  {
+    scatter.zeros(dimensionality, dimensionality);
+  }
+
+  //! Set a diagonal covariance scatter accumulator to zero.
+  static void ZeroScatter(arma::vec& scatter, const size_t dimensionality)
+  {
+    scatter.zeros(dimensionality);
+  }
+
+  //! Add the weighted outer products of the columns of diffs to a full
+  //! covariance scatter accumulator.
+  static void AddScatter(const arma::mat& diffs,
+                         const arma::rowvec& diffWeights,
+                         arma::mat& scatter)
+  {
+    scatter += (diffs.each_row() % diffWeights) * diffs.t();
+  }
+
+  //! Add the weighted squares of the columns of diffs to a diagonal covariance
+  //! scatter accumulator.
+  static void AddScatter(const arma::mat& diffs,
+                         const arma::rowvec& diffWeights,
+                         arma::vec& scatter)
+  {
+    scatter += arma::square(diffs) * diffWeights.t();
+  }
+
+  //! Get the diagonal of the covariance of a Gaussian.
+  static arma::vec DiagonalCovariance(
+      const distribution::GaussianDistribution& d)
+  {
+    return d.Covariance().diag();
+  }
+
+  //! Get the diagonal of the covariance of a diagonal Gaussian.
+  static arma::vec DiagonalCovariance(
+      const distribution::DiagonalGaussianDistribution& d)
+  {
+    return d.Covariance();
+  }
+
+  //! Set the covariance of a Gaussian to the given diagonal.
+  static void DiagonalCovariance(distribution::GaussianDistribution& d,
+                                 const arma::vec& diagCovariance)
+  {
+    d.Covariance(arma::diagmat(diagCovariance));
+  }
+
+  //! Set the covariance of a diagonal Gaussian to the given diagonal.
+  static void DiagonalCovariance(distribution::DiagonalGaussianDistribution& d,
+                                 const arma::vec& diagCovariance)
+  {
+    d.Covariance(diagCovariance);
+  }
+
   /**
    * Run the clusterer, and then turn the cluster assignments into Gaussians.
    * This is a helper function for both overloads of Estimate().  The vectors
@@ -144,7 +219,7 @@ class EMFit
    * @param weights Vector to store a priori weights in.
    */
   void InitialClustering(const arma::mat& observations,
-                         std::vector<distribution::GaussianDistribution>& dists,
+                         std::vector<Distribution>& dists,
                          arma::vec& weights);
 
   /**
@@ -158,10 +233,67 @@ class EMFit
    * @param weights Vector of a priori weights.
    */
   double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
+                       const std::vector<Distribution>&
                            dists,
                        const arma::vec& weights) const;
 
+  /**
+   * Compute the weighted log-probabilities log(w_i p_i(x)) of a contiguous
+   * chunk of observations under every component of a model.  Each row of the
+   * result corresponds to one observation, and each column to one component.
+   *
+   * @param observations Data matrix.
+   * @param begin Index of the first observation of the chunk.
+   * @param end Index one past the last observation of the chunk.
+   * @param dists Vector of distributions.
+   * @param weights Vector of a priori weights.
+   * @param logProbs Matrix to store the log-probabilities in.
+   */
+  void ChunkLogProbabilities(
+      const arma::mat& observations,
+      const size_t begin,
+      const size_t end,
+      const std::vector<Distribution>& dists,
+      const arma::vec& weights,
+      arma::mat& logProbs) const;
+
+  /**
+   * The E-step: compute the conditional probability of each component for
+   * each observation.  Chunks of observations are processed in parallel, and
+   * the probabilities are normalized in log-space, so points far away from
+   * every component don't underflow.
+   *
+   * @param observations Data matrix.
+   * @param dists Vector of distributions.
+   * @param weights Vector of a priori weights.
+   * @param condProb Matrix to store the conditional probabilities in (one row
+   *     per observation, one column per component).
+   */
+  void ExpectationStep(
+      const arma::mat& observations,
+      const std::vector<Distribution>& dists,
+      const arma::vec& weights,
+      arma::mat& condProb) const;
+
+  /**
+   * The M-step: update the mean and covariance of each distribution from the
+   * weighted observations.  Each thread reduces the weighted sufficient
+   * statistics of its chunks of observations into its own buffers, and the
+   * buffers are summed at the end.
+   *
+   * @param observations Data matrix.
+   * @param condWeights Weight of each observation for each component (one row
+   *     per observation, one column per component).
+   * @param dists Vector of distributions to update.
+   * @param weightSums Vector to store the sum of the weights of each component
+   *     in.
+   */
+  void MaximizationStep(
+      const arma::mat& observations,
+      const arma::mat& condWeights,
+      std::vector<Distribution>& dists,
+      arma::vec& weightSums);
+
   // Armadillo uses uword internally as an OpenMP index type, which crashes
   // Visual Studio.
   #ifndef _WIN32
@@ -177,7 +309,7 @@ class EMFit
    */
   void ArmadilloGMMWrapper(
       const arma::mat& observations,
-      std::vector<distribution::GaussianDistribution>& dists,
+      std::vector<Distribution>& dists,
       arma::vec& weights,
       const bool useInitialModel);
   #endif
@@ -21,8 +21,12 @@ namespace mlpack {
 namespace gmm {
 
 //! Constructor.
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-EMFit<InitialClusteringType, CovarianceConstraintPolicy>::EMFit(
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+EMFit<InitialClusteringType,
+      CovarianceConstraintPolicy,
+      Distribution>::EMFit(
     const size_t maxIterations,
     const double tolerance,
     InitialClusteringType clusterer,
@@ -33,10 +37,14 @@ EMFit<InitialClusteringType, CovarianceConstraintPolicy>::EMFit(
     constraint(constraint)
 { /* Nothing to do. */ }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType,
+           CovarianceConstraintPolicy,
+           Distribution>::Estimate(
     const arma::mat& observations,
-    std::vector<distribution::GaussianDistribution>& dists,
+    std::vector<Distribution>& dists,
     arma::vec& weights,
     const bool useInitialModel)
 {
@@ -72,52 +80,13 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
 
     // Calculate the conditional probabilities of choosing a particular
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
+    ExpectationStep(observations, dists, weights, condProb);
 
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0)
-        dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i)));
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0.0)
-      {
-        arma::mat covariance = (tmp * trans(tmpB)) / probRowSums[i];
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
+    // Calculate the new values of the means and covariances using the updated
+    // conditional probabilities, and store the sum of the probability of each
+    // state over all the observations.
+    arma::vec probRowSums;
+    MaximizationStep(observations, condProb, dists, probRowSums);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -131,11 +100,15 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType,
+           CovarianceConstraintPolicy,
+           Distribution>::Estimate(
     const arma::mat& observations,
     const arma::vec& probabilities,
-    std::vector<distribution::GaussianDistribution>& dists,
+    std::vector<Distribution>& dists,
     arma::vec& weights,
     const bool useInitialModel)
 {
@@ -156,56 +129,15 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   {
     // Calculate the conditional probabilities of choosing a particular
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      probRowSums[i] = accu(condProb.col(i) % probabilities);
-
-      dists[i].Mean() = (observations * (condProb.col(i) % probabilities)) /
-        probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i) % probabilities));
-
-      arma::mat cov = (tmp * trans(tmpB)) / probRowSums[i];
+    ExpectationStep(observations, dists, weights, condProb);
 
-      // Apply covariance constraint.
-      constraint.ApplyConstraint(cov);
-
-      dists[i].Covariance(std::move(cov));
-    }
+    // Weight the conditional probability of each point being from Gaussian i
+    // by the probability of the point being from this mixture model, and
+    // calculate the new values of the means and covariances.  This also
+    // stores the sum of these probabilities for each state.
+    condProb.each_col() %= probabilities;
+    arma::vec probRowSums;
+    MaximizationStep(observations, condProb, dists, probRowSums);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -219,10 +151,14 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType,
+           CovarianceConstraintPolicy,
+           Distribution>::
 InitialClustering(const arma::mat& observations,
-                  std::vector<distribution::GaussianDistribution>& dists,
+                  std::vector<Distribution>& dists,
                   arma::vec& weights)
 {
   // Assignments from clustering.
@@ -232,15 +168,15 @@ InitialClustering(const arma::mat& observations,
   clusterer.Cluster(observations, dists.size(), assignments);
 
   std::vector<arma::vec> means(dists.size());
-  std::vector<arma::mat> covs(dists.size());
+  std::vector<CovarianceType> covs(dists.size());
+  const arma::rowvec unitWeight = arma::ones<arma::rowvec>(1);
 
   // Now calculate the means, covariances, and weights.
   weights.zeros();
   for (size_t i = 0; i < dists.size(); ++i)
   {
     means[i].zeros(dists[i].Mean().n_elem);
-    covs[i].zeros(dists[i].Covariance().n_rows,
-                  dists[i].Covariance().n_cols);
+    ZeroScatter(covs[i], dists[i].Mean().n_elem);
   }
 
   // From the assignments, generate our means, covariances, and weights.
@@ -252,7 +188,7 @@ InitialClustering(const arma::mat& observations,
     means[cluster] += observations.col(i);
 
     // Add this to the relevant covariance.
-    covs[cluster] += observations.col(i) * trans(observations.col(i));
+    AddScatter(observations.col(i), unitWeight, covs[cluster]);
 
     // Now add one to the weights (we will normalize).
     weights[cluster]++;
@@ -267,8 +203,8 @@ InitialClustering(const arma::mat& observations,
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
     const size_t cluster = assignments[i];
-    const arma::vec normObs = observations.col(i) - means[cluster];
-    covs[cluster] += normObs * normObs.t();
+    AddScatter(observations.col(i) - means[cluster], unitWeight,
+        covs[cluster]);
   }
 
   for (size_t i = 0; i < dists.size(); ++i)
@@ -286,37 +222,236 @@ InitialClustering(const arma::mat& observations,
   weights /= accu(weights);
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double EMFit<InitialClusteringType,
+             CovarianceConstraintPolicy,
+             Distribution>::LogLikelihood(
     const arma::mat& observations,
-    const std::vector<distribution::GaussianDistribution>& dists,
+    const std::vector<Distribution>& dists,
     const arma::vec& weights) const
 {
+  // Chunks of observations are evaluated in parallel, and the likelihood of
+  // each point is summed in log-space.
+  const size_t chunkSize = 1024;
+  const size_t numChunks = (observations.n_cols + chunkSize - 1) / chunkSize;
+
   double logLikelihood = 0;
+  #pragma omp parallel for reduction(+:logLikelihood) schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = c * chunkSize;
+    const size_t end = std::min(begin + chunkSize,
+        (size_t) observations.n_cols);
+
+    arma::mat logProbs;
+    ChunkLogProbabilities(observations, begin, end, dists, weights, logProbs);
+
+    for (size_t j = 0; j < logProbs.n_rows; ++j)
+    {
+      const double maxLogProb = logProbs.row(j).max();
+      if (maxLogProb == -std::numeric_limits<double>::infinity())
+      {
+        #pragma omp critical
+        {
+          Log::Info << "Likelihood of point " << (begin + j) << " is 0!  It is "
+              << "probably an outlier." << std::endl;
+        }
+        logLikelihood += maxLogProb;
+        continue;
+      }
+
+      logLikelihood += maxLogProb +
+          std::log(arma::accu(arma::exp(logProbs.row(j) - maxLogProb)));
+    }
+  }
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType,
+           CovarianceConstraintPolicy,
+           Distribution>::
+ChunkLogProbabilities(
+    const arma::mat& observations,
+    const size_t begin,
+    const size_t end,
+    const std::vector<Distribution>& dists,
+    const arma::vec& weights,
+    arma::mat& logProbs) const
+{
+  const arma::mat chunk = observations.cols(begin, end - 1);
+  logProbs.set_size(chunk.n_cols, dists.size());
+
+  arma::vec componentLogProbs;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    dists[i].LogProbability(chunk, componentLogProbs);
+    logProbs.col(i) = componentLogProbs + std::log(weights[i]);
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType,
+           CovarianceConstraintPolicy,
+           Distribution>::ExpectationStep(
+    const arma::mat& observations,
+    const std::vector<Distribution>& dists,
+    const arma::vec& weights,
+    arma::mat& condProb) const
+{
+  const size_t chunkSize = 1024;
+  const size_t numChunks = (observations.n_cols + chunkSize - 1) / chunkSize;
+  condProb.set_size(observations.n_cols, dists.size());
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = c * chunkSize;
+    const size_t end = std::min(begin + chunkSize,
+        (size_t) observations.n_cols);
+
+    arma::mat logProbs;
+    ChunkLogProbabilities(observations, begin, end, dists, weights, logProbs);
+
+    // Normalize row-wise.
+    for (size_t j = 0; j < logProbs.n_rows; ++j)
+    {
+      // Avoid dividing by zero; if the probability for everything is 0, we
+      // don't want to make it NaN.
+      const double maxLogProb = logProbs.row(j).max();
+      if (maxLogProb == -std::numeric_limits<double>::infinity())
+      {
+        logProbs.row(j).zeros();
+        continue;
+      }
+
+      logProbs.row(j) = arma::exp(logProbs.row(j) - maxLogProb);
+      logProbs.row(j) /= arma::accu(logProbs.row(j));
+    }
+
+    condProb.rows(begin, end - 1) = logProbs;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType,
+           CovarianceConstraintPolicy,
+           Distribution>::
+MaximizationStep(
+    const arma::mat& observations,
+    const arma::mat& condWeights,
+    std::vector<Distribution>& dists,
+    arma::vec& weightSums)
+{
+  const size_t chunkSize = 1024;
+  const size_t numChunks = (observations.n_cols + chunkSize - 1) / chunkSize;
+  const size_t dimensionality = observations.n_rows;
+
+  // First accumulate the sum of the weights and the weighted sum of the
+  // observations of each component.
+  weightSums.zeros(dists.size());
+  arma::mat means(dimensionality, dists.size(), arma::fill::zeros);
+  #pragma omp parallel
+  {
+    arma::vec localWeightSums(dists.size(), arma::fill::zeros);
+    arma::mat localMeans(dimensionality, dists.size(), arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t begin = c * chunkSize;
+      const size_t end = std::min(begin + chunkSize,
+          (size_t) observations.n_cols);
 
-  arma::vec phis;
-  arma::mat likelihoods(dists.size(), observations.n_cols);
+      const arma::mat chunkWeights = condWeights.rows(begin, end - 1);
+      localWeightSums += arma::sum(chunkWeights, 0).t();
+      localMeans += observations.cols(begin, end - 1) * chunkWeights;
+    }
 
+    #pragma omp critical
+    {
+      weightSums += localWeightSums;
+      means += localMeans;
+    }
+  }
+
+  // Don't update if there's no probability of the Gaussian having points.
   for (size_t i = 0; i < dists.size(); ++i)
   {
-    dists[i].Probability(observations, phis);
-    likelihoods.row(i) = weights(i) * trans(phis);
+    if (weightSums[i] != 0.0)
+      means.col(i) /= weightSums[i];
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  // Now accumulate the weighted scatter of the observations around the new
+  // means.  This is a second pass over the data, so the covariances don't
+  // suffer from the cancellation of E[xx^T] - mu mu^T.
+  std::vector<CovarianceType> covariances(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+    ZeroScatter(covariances[i], dimensionality);
+  #pragma omp parallel
   {
-    if (accu(likelihoods.col(j)) == 0)
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    logLikelihood += log(accu(likelihoods.col(j)));
+    std::vector<CovarianceType> localCovariances(dists.size());
+    for (size_t i = 0; i < dists.size(); ++i)
+      ZeroScatter(localCovariances[i], dimensionality);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t begin = c * chunkSize;
+      const size_t end = std::min(begin + chunkSize,
+          (size_t) observations.n_cols);
+
+      const arma::mat chunk = observations.cols(begin, end - 1);
+      for (size_t i = 0; i < dists.size(); ++i)
+      {
+        if (weightSums[i] == 0.0)
+          continue;
+
+        const arma::mat diffs = chunk.each_col() - means.col(i);
+        const arma::rowvec chunkWeights =
+            condWeights(arma::span(begin, end - 1), i).t();
+        AddScatter(diffs, chunkWeights, localCovariances[i]);
+      }
+    }
+
+    #pragma omp critical
+    {
+      for (size_t i = 0; i < dists.size(); ++i)
+        covariances[i] += localCovariances[i];
+    }
   }
 
-  return logLikelihood;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (weightSums[i] == 0.0)
+      continue;
+
+    dists[i].Mean() = means.col(i);
+
+    covariances[i] /= weightSums[i];
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariances[i]);
+    dists[i].Covariance(std::move(covariances[i]));
+  }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
 template<typename Archive>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::serialize(
+void EMFit<InitialClusteringType,
+           CovarianceConstraintPolicy,
+           Distribution>::serialize(
     Archive& ar,
     const unsigned int /* version */)
 {
@@ -329,10 +464,14 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::serialize(
 // Armadillo uses uword internally as an OpenMP index type, which crashes Visual
 // Studio.
 #ifndef _WIN32
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType,
+           CovarianceConstraintPolicy,
+           Distribution>::
 ArmadilloGMMWrapper(const arma::mat& observations,
-                    std::vector<distribution::GaussianDistribution>& dists,
+                    std::vector<Distribution>& dists,
                     arma::vec& weights,
                     const bool useInitialModel)
 {
@@ -361,7 +500,7 @@ ArmadilloGMMWrapper(const arma::mat& observations,
     for (size_t i = 0; i < dists.size(); ++i)
     {
       means.col(i) = dists[i].Mean();
-      covs.col(i) = dists[i].Covariance().diag();
+      covs.col(i) = DiagonalCovariance(dists[i]);
     }
 
     g.reset(observations.n_rows, dists.size());
@@ -383,7 +522,7 @@ ArmadilloGMMWrapper(const arma::mat& observations,
   for (size_t i = 0; i < dists.size(); ++i)
   {
     dists[i].Mean() = g.means.col(i);
-    dists[i].Covariance(arma::diagmat(g.dcovs.col(i)));
+    DiagonalCovariance(dists[i], g.dcovs.col(i));
   }
 }
 #endif
@@ -64,6 +64,22 @@ double GMM::Probability(const arma::vec& observation) const
   return sum;
 }
 
+/**
+ * Return the log probability of the given observation being from this GMM.
+ */
+double GMM::LogProbability(const arma::vec& observation) const
+{
+  arma::vec logProbs(gaussians);
+  for (size_t i = 0; i < gaussians; i++)
+    logProbs[i] = std::log(weights[i]) + dists[i].LogProbability(observation);
+
+  const double maxLogProb = logProbs.max();
+  if (maxLogProb == -std::numeric_limits<double>::infinity())
+    return maxLogProb;
+
+  return maxLogProb + std::log(arma::accu(arma::exp(logProbs - maxLogProb)));
+}
+
 /**
  * Return the probability of the given observation being from the given
  * component in the mixture.
@@ -76,6 +92,27 @@ double GMM::Probability(const arma::vec& observation,
   return weights[component] * dists[component].Probability(observation);
 }
 
+/**
+ * Return the probability of each of the given observations being from this
+ * GMM.
+ */
+void GMM::Probability(const arma::mat& observations,
+                      arma::vec& probabilities) const
+{
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+/**
+ * Return the log probability of each of the given observations being from this
+ * GMM.
+ */
+void GMM::LogProbability(const arma::mat& observations,
+                         arma::vec& logProbabilities) const
+{
+  MixtureLogProbability(observations, dists, weights, &logProbabilities, NULL);
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -108,25 +145,7 @@ arma::vec GMM::Random() const
 void GMM::Classify(const arma::mat& observations,
                    arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
-
-  // We should not have to fill this with values, because each one should be
-  // overwritten.
-  labels.set_size(observations.n_cols);
-  for (size_t i = 0; i < observations.n_cols; ++i)
-  {
-    // Find maximum probability component.
-    double probability = 0;
-    for (size_t j = 0; j < gaussians; ++j)
-    {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
-      {
-        probability = newProb;
-        labels[i] = j;
-      }
-    }
-  }
+  MixtureLogProbability(observations, dists, weights, NULL, &labels);
 }
 
 /**
@@ -137,20 +156,64 @@ double GMM::LogLikelihood(
     const std::vector<distribution::GaussianDistribution>& distsL,
     const arma::vec& weightsL) const
 {
-  double loglikelihood = 0;
-  arma::vec phis;
-  arma::mat likelihoods(gaussians, data.n_cols);
+  arma::vec logProbabilities;
+  MixtureLogProbability(data, distsL, weightsL, &logProbabilities, NULL);
+  return arma::accu(logProbabilities);
+}
 
-  for (size_t i = 0; i < gaussians; i++)
+void GMM::MixtureLogProbability(
+    const arma::mat& observations,
+    const std::vector<distribution::GaussianDistribution>& distsL,
+    const arma::vec& weightsL,
+    arma::vec* logProbabilities,
+    arma::Row<size_t>* labels)
+{
+  if (logProbabilities)
+    logProbabilities->set_size(observations.n_cols);
+  if (labels)
+    labels->set_size(observations.n_cols);
+
+  const arma::vec logWeights = arma::log(weightsL);
+
+  // Blocks of this many points keep the log probabilities of all components
+  // in cache.
+  const size_t blockSize = 1024;
+  const size_t blocks = (observations.n_cols + blockSize - 1) / blockSize;
+  Threads::ParallelFor(0, blocks, [&](const size_t b)
   {
-    distsL[i].Probability(data, phis);
-    likelihoods.row(i) = weightsL(i) * trans(phis);
-  }
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(size_t(observations.n_cols),
+        begin + blockSize);
+    const arma::mat block = observations.cols(begin, end - 1);
+
+    // Row i holds the weighted log probabilities of component i.
+    arma::mat logProbs(distsL.size(), block.n_cols);
+    arma::vec componentLogProbs;
+    for (size_t i = 0; i < distsL.size(); ++i)
+    {
+      distsL[i].LogProbability(block, componentLogProbs);
+      logProbs.row(i) = logWeights[i] + componentLogProbs.t();
+    }
 
-  // Now sum over every point.
-  for (size_t j = 0; j < data.n_cols; j++)
-    loglikelihood += log(accu(likelihoods.col(j)));
-  return loglikelihood;
+    if (labels)
+    {
+      labels->subvec(begin, end - 1) = arma::conv_to<arma::Row<size_t>>::from(
+          arma::index_max(logProbs, 0));
+    }
+
+    if (logProbabilities)
+    {
+      // Sum the probabilities in log-space; points that no component can have
+      // generated keep a log probability of -inf.
+      const arma::rowvec maxLogProbs = arma::max(logProbs, 0);
+      logProbs.each_row() -= maxLogProbs;
+      arma::rowvec sums = arma::log(arma::sum(arma::exp(logProbs), 0)) +
+          maxLogProbs;
+      const double negInf = -std::numeric_limits<double>::infinity();
+      sums.elem(arma::find(maxLogProbs == negInf)).fill(negInf);
+      logProbabilities->subvec(begin, end - 1) = sums.t();
+    }
+  });
 }
 
 } // namespace gmm
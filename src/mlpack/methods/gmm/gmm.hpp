@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_MOG_MOG_EM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
@@ -164,6 +165,15 @@ class GMM
    */
   double Probability(const arma::vec& observation) const;
 
+  /**
+   * Return the log probability that the given observation came from this
+   * distribution.  The weighted probabilities of the components are summed in
+   * log-space, so this does not underflow for unlikely observations.
+   *
+   * @param observation Observation to evaluate the log probability of.
+   */
+  double LogProbability(const arma::vec& observation) const;
+
   /**
    * Return the probability that the given observation came from the given
    * Gaussian component in this distribution.
@@ -174,6 +184,29 @@ class GMM
   double Probability(const arma::vec& observation,
                      const size_t component) const;
 
+  /**
+   * Compute the probability that each of the given observations came from this
+   * distribution.  See LogProbability() for details.
+   *
+   * @param observations List of observations.
+   * @param probabilities Output probability of each observation.
+   */
+  void Probability(const arma::mat& observations,
+                   arma::vec& probabilities) const;
+
+  /**
+   * Compute the log probability that each of the given observations came from
+   * this distribution.  The observations are processed in blocks, in
+   * parallel: the log probabilities of a block are computed for every
+   * component at once (with the cached Cholesky factor of its covariance), and
+   * the components are summed with a log-sum-exp over the whole block.
+   *
+   * @param observations List of observations.
+   * @param logProbabilities Output log probability of each observation.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -195,6 +228,14 @@ class GMM
    * is deterministic after the initial position is given, then 'trials' should
    * be set to 1.
    *
+   * The trials run in parallel (see Threads), each with its own copy of the
+   * fitter and its own random stream (see math::RandomStream()), so the chosen
+   * model does not depend on the number of threads.  The estimation of a
+   * trial that runs in parallel with other trials is serial (see Threads), so
+   * maxParallelTrials can limit how many trials run at once; 1 runs the trials
+   * one after another, each with a parallel estimation, which is faster when
+   * there are many more threads than trials.
+   *
    * @tparam FittingType The type of fitting method which should be used
    *     (EMFit<> is suggested).
    * @param observations Observations of the model.
@@ -202,13 +243,17 @@ class GMM
    *      the greatest log-likelihood will be selected.
    * @param useExistingModel If true, the existing model is used as an initial
    *      model for the estimation.
+   * @param fitter Fitter to use; every trial uses a copy of it.
+   * @param maxParallelTrials Largest number of trials to run at once (0 for as
+   *      many as there are threads).
    * @return The log-likelihood of the best fit.
    */
   template<typename FittingType = EMFit<>>
   double Train(const arma::mat& observations,
                const size_t trials = 1,
                const bool useExistingModel = false,
-               FittingType fitter = FittingType());
+               FittingType fitter = FittingType(),
+               const size_t maxParallelTrials = 0);
 
   /**
    * Estimate the probability distribution directly from the given observations,
@@ -232,6 +277,9 @@ class GMM
    *     the greatest log-likelihood will be selected.
    * @param useExistingModel If true, the existing model is used as an initial
    *     model for the estimation.
+   * @param fitter Fitter to use; every trial uses a copy of it.
+   * @param maxParallelTrials Largest number of trials to run at once (0 for as
+   *     many as there are threads); see the other overload of Train().
    * @return The log-likelihood of the best fit.
    */
   template<typename FittingType = EMFit<>>
@@ -239,7 +287,8 @@ class GMM
                const arma::vec& probabilities,
                const size_t trials = 1,
                const bool useExistingModel = false,
-               FittingType fitter = FittingType());
+               FittingType fitter = FittingType(),
+               const size_t maxParallelTrials = 0);
 
   /**
    * Classify the given observations as being from an individual component in
@@ -267,6 +316,25 @@ class GMM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Run the given number of trials of an estimation, in parallel, and keep the
+   * model with the greatest log-likelihood.  This is used by Train().
+   *
+   * @param observations Observations of the model.
+   * @param trials Number of trials to perform.
+   * @param fitter Fitter to use; every trial uses a copy of it.
+   * @param maxParallelTrials Largest number of trials to run at once.
+   * @param estimate Function that estimates the given model with the given
+   *     fitter.
+   * @return The log-likelihood of the best fit.
+   */
+  template<typename FittingType, typename EstimateType>
+  double TrainTrials(const arma::mat& observations,
+                     const size_t trials,
+                     FittingType& fitter,
+                     const size_t maxParallelTrials,
+                     EstimateType estimate);
+
   /**
    * This function computes the loglikelihood of the given model.  This function
    * is used by GMM::Train().
@@ -280,6 +348,26 @@ class GMM
       const arma::mat& dataPoints,
       const std::vector<distribution::GaussianDistribution>& distsL,
       const arma::vec& weights) const;
+
+  /**
+   * Compute the log probability of each of the given observations under the
+   * given mixture, and optionally the most likely component of each
+   * observation, by blocks of observations in parallel.
+   *
+   * @param observations List of observations.
+   * @param distsL Components of the mixture.
+   * @param weightsL Weights of the components.
+   * @param logProbabilities If not NULL, the log probability of each
+   *     observation is stored here.
+   * @param labels If not NULL, the most likely component of each observation
+   *     is stored here.
+   */
+  static void MixtureLogProbability(
+      const arma::mat& observations,
+      const std::vector<distribution::GaussianDistribution>& distsL,
+      const arma::vec& weightsL,
+      arma::vec* logProbabilities,
+      arma::Row<size_t>* labels);
 };
 
 } // namespace gmm
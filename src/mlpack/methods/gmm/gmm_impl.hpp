@@ -27,78 +27,17 @@ template<typename FittingType>
 double GMM::Train(const arma::mat& observations,
                   const size_t trials,
                   const bool useExistingModel,
-                  FittingType fitter)
+                  FittingType fitter,
+                  const size_t maxParallelTrials)
 {
-  double bestLikelihood; // This will be reported later.
-
-  // We don't need to store temporary models if we are only doing one trial.
-  if (trials == 1)
-  {
-    // Train the model.  The user will have been warned earlier if the GMM was
-    // initialized with no parameters (0 gaussians, dimensionality of 0).
-    fitter.Estimate(observations, dists, weights, useExistingModel);
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-  }
-  else
-  {
-    if (trials == 0)
-      return -DBL_MAX; // It's what they asked for...
-
-    // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
-    arma::vec weightsOrig;
-    if (useExistingModel)
-    {
-      distsOrig = dists;
-      weightsOrig = weights;
-    }
-
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, dists, weights, useExistingModel);
-
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Info << "GMM::Train(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
-    {
-      if (useExistingModel)
+  return TrainTrials(observations, trials, fitter, maxParallelTrials,
+      [&](FittingType& trialFitter,
+          std::vector<distribution::GaussianDistribution>& trialDists,
+          arma::vec& trialWeights)
       {
-        distsTrial = distsOrig;
-        weightsTrial = weightsOrig;
-      }
-
-      fitter.Estimate(observations, distsTrial, weightsTrial, useExistingModel);
-
-      // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
-          weightsTrial);
-
-      Log::Info << "GMM::Train(): Log-likelihood of trial " << trial << " is "
-          << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
-      {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
-
-        dists = distsTrial;
-        weights = weightsTrial;
-      }
-    }
-  }
-
-  // Report final log-likelihood and return it.
-  Log::Info << "GMM::Train(): log-likelihood of trained GMM is "
-      << bestLikelihood << "." << std::endl;
-  return bestLikelihood;
+        trialFitter.Estimate(observations, trialDists, trialWeights,
+            useExistingModel);
+      });
 }
 
 /**
@@ -110,7 +49,29 @@ double GMM::Train(const arma::mat& observations,
                   const arma::vec& probabilities,
                   const size_t trials,
                   const bool useExistingModel,
-                  FittingType fitter)
+                  FittingType fitter,
+                  const size_t maxParallelTrials)
+{
+  return TrainTrials(observations, trials, fitter, maxParallelTrials,
+      [&](FittingType& trialFitter,
+          std::vector<distribution::GaussianDistribution>& trialDists,
+          arma::vec& trialWeights)
+      {
+        trialFitter.Estimate(observations, probabilities, trialDists,
+            trialWeights, useExistingModel);
+      });
+}
+
+/**
+ * Run the given number of trials of the given estimation, and keep the model
+ * with the greatest log-likelihood.
+ */
+template<typename FittingType, typename EstimateType>
+double GMM::TrainTrials(const arma::mat& observations,
+                        const size_t trials,
+                        FittingType& fitter,
+                        const size_t maxParallelTrials,
+                        EstimateType estimate)
 {
   double bestLikelihood; // This will be reported later.
 
@@ -119,8 +80,7 @@ double GMM::Train(const arma::mat& observations,
   {
     // Train the model.  The user will have been warned earlier if the GMM was
     // initialized with no parameters (0 gaussians, dimensionality of 0).
-    fitter.Estimate(observations, probabilities, dists, weights,
-        useExistingModel);
+    estimate(fitter, dists, weights);
     bestLikelihood = LogLikelihood(observations, dists, weights);
   }
   else
@@ -128,57 +88,50 @@ double GMM::Train(const arma::mat& observations,
     if (trials == 0)
       return -DBL_MAX; // It's what they asked for...
 
-    // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
-    arma::vec weightsOrig;
-    if (useExistingModel)
-    {
-      distsOrig = dists;
-      weightsOrig = weights;
-    }
-
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, probabilities, dists, weights,
-        useExistingModel);
-
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Debug << "GMM::Train(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
+    // Every trial starts from a copy of the model (which matters if the
+    // existing model is used), with its own copy of the fitter.
+    std::vector<std::vector<distribution::GaussianDistribution>> trialDists(
+        trials, dists);
+    std::vector<arma::vec> trialWeights(trials, weights);
+    arma::vec likelihoods(trials);
+
+    // The trials are spread over at most maxParallelTrials tasks; with one
+    // task, the estimation of each trial is parallel instead.  Every trial
+    // draws its random numbers from its own stream, so the chosen model does
+    // not depend on how many trials run at once.
+    const size_t firstStream = (size_t) math::ThreadRandGen()();
+    const size_t tasks = std::min(trials, (maxParallelTrials == 0) ?
+        Threads::Count() : maxParallelTrials);
+    Threads::ParallelFor(0, tasks, [&](const size_t task)
     {
-      if (useExistingModel)
+      for (size_t trial = task; trial < trials; trial += tasks)
       {
-        distsTrial = distsOrig;
-        weightsTrial = weightsOrig;
-      }
+        FittingType trialFitter(fitter);
 
-      fitter.Estimate(observations, probabilities, distsTrial, weightsTrial,
-          useExistingModel);
+        std::mt19937& generator = math::ThreadRandGen();
+        const std::mt19937 threadGenerator = generator;
+        generator = math::RandomStream(firstStream + trial);
+        math::ThreadRandNormalDist().reset();
 
-      // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
-          weightsTrial);
+        estimate(trialFitter, trialDists[trial], trialWeights[trial]);
 
-      Log::Debug << "GMM::Train(): Log-likelihood of trial " << trial << " is "
-          << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
-      {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
-
-        dists = distsTrial;
-        weights = weightsTrial;
+        generator = threadGenerator;
+        likelihoods[trial] = LogLikelihood(observations, trialDists[trial],
+            trialWeights[trial]);
       }
+    });
+
+    for (size_t trial = 0; trial < trials; ++trial)
+    {
+      Log::Info << "GMM::Train(): Log-likelihood of trial " << trial << " is "
+          << likelihoods[trial] << "." << std::endl;
     }
+
+    // Keep the first of the best trials.
+    arma::uword bestTrial = 0;
+    bestLikelihood = likelihoods.max(bestTrial);
+    dists = std::move(trialDists[bestTrial]);
+    weights = std::move(trialWeights[bestTrial]);
   }
 
   // Report final log-likelihood and return it.
@@ -37,7 +37,10 @@ PROGRAM_INFO("Gaussian Mixture Model (GMM) Training",
     "initializations may be run, and the result with highest log-likelihood on "
     "the training data will be taken.  The number of trials to run is specified"
     " with the " + PRINT_PARAM_STRING("trials") + " parameter.  By default, "
-    "only one trial is run."
+    "only one trial is run.  The trials run in parallel; the number of trials "
+    "that run at once may be limited with the " +
+    PRINT_PARAM_STRING("parallel_trials") + " parameter.  If it is 1, the "
+    "trials run one after another, and each trial uses all threads instead."
     "\n\n"
     "The tolerance for convergence and maximum number of iterations of the EM "
     "algorithm are specified with the " + PRINT_PARAM_STRING("tolerance") +
@@ -93,6 +96,8 @@ PARAM_INT_IN_REQ("gaussians", "Number of Gaussians in the GMM.", "g");
 
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 PARAM_INT_IN("trials", "Number of trials to perform in training GMM.", "t", 1);
+PARAM_INT_IN("parallel_trials", "Largest number of trials to run at once (0 "
+    "for as many as there are threads).", "", 0);
 
 // Parameters for EM algorithm.
 PARAM_DOUBLE_IN("tolerance", "Tolerance for convergence of EM.", "T", 1e-10);
@@ -136,6 +141,9 @@ static void mlpackMain()
   ReportIgnoredParam({{ "diagonal_covariance", true }}, "no_force_positive");
   RequireAtLeastOnePassed({ "output_model" }, false, "no model will be saved");
 
+  RequireParamValue<int>("parallel_trials", [](int x) { return x >= 0; },
+      true, "number of parallel trials must be nonnegative");
+
   RequireParamValue<double>("noise", [](double x) { return x >= 0.0; }, true,
       "variance of noise must be greater than or equal to 0");
 
@@ -175,6 +183,8 @@ static void mlpackMain()
   const double tolerance = CLI::GetParam<double>("tolerance");
   const bool forcePositive = !CLI::HasParam("no_force_positive");
   const bool diagonalCovariance = CLI::HasParam("diagonal_covariance");
+  const size_t trials = (size_t) CLI::GetParam<int>("trials");
+  const size_t parallelTrials = (size_t) CLI::GetParam<int>("parallel_trials");
 
   // This gets a bit weird because we need different types depending on whether
   // --refined_start is specified.
@@ -203,8 +213,7 @@ static void mlpackMain()
       // Compute the parameters of the model using the EM algorithm.
       Timer::Start("em");
       EMFit<KMeansType, DiagonalConstraint> em(maxIterations, tolerance, k);
-      likelihood = gmm->Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
+      likelihood = gmm->Train(dataPoints, trials, false, em, parallelTrials);
       Timer::Stop("em");
     }
     else if (forcePositive)
@@ -212,8 +221,7 @@ static void mlpackMain()
       // Compute the parameters of the model using the EM algorithm.
       Timer::Start("em");
       EMFit<KMeansType> em(maxIterations, tolerance, k);
-      likelihood = gmm->Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
+      likelihood = gmm->Train(dataPoints, trials, false, em, parallelTrials);
       Timer::Stop("em");
     }
     else
@@ -221,8 +229,7 @@ static void mlpackMain()
       // Compute the parameters of the model using the EM algorithm.
       Timer::Start("em");
       EMFit<KMeansType, NoConstraint> em(maxIterations, tolerance, k);
-      likelihood = gmm->Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
+      likelihood = gmm->Train(dataPoints, trials, false, em, parallelTrials);
       Timer::Stop("em");
     }
   }
@@ -235,8 +242,7 @@ static void mlpackMain()
       // Compute the parameters of the model using the EM algorithm.
       Timer::Start("em");
       EMFit<kmeans::KMeans<>, DiagonalConstraint> em(maxIterations, tolerance);
-      likelihood = gmm->Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
+      likelihood = gmm->Train(dataPoints, trials, false, em, parallelTrials);
       Timer::Stop("em");
     }
     else if (forcePositive)
@@ -244,8 +250,7 @@ static void mlpackMain()
       // Compute the parameters of the model using the EM algorithm.
       Timer::Start("em");
       EMFit<> em(maxIterations, tolerance);
-      likelihood = gmm->Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
+      likelihood = gmm->Train(dataPoints, trials, false, em, parallelTrials);
       Timer::Stop("em");
     }
     else
@@ -253,8 +258,7 @@ static void mlpackMain()
       // Compute the parameters of the model using the EM algorithm.
       Timer::Start("em");
       EMFit<KMeans<>, NoConstraint> em(maxIterations, tolerance);
-      likelihood = gmm->Train(dataPoints, CLI::GetParam<int>("trials"), false,
-          em);
+      likelihood = gmm->Train(dataPoints, trials, false, em, parallelTrials);
       Timer::Stop("em");
     }
   }
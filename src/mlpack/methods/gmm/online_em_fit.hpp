@@ -0,0 +1,243 @@
+/**
+ * @file online_em_fit.hpp
+ *
+ * Utility class to fit a GMM to mini-batches of observations with the
+ * stepwise (online) EM algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+// The initial model is found like EMFit finds it.
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to a stream of observations with the stepwise EM
+ * algorithm (Cappe and Moulines, 2009; Liang and Klein, 2009).  Instead of
+ * iterating over all observations until convergence, every mini-batch of
+ * observations takes one step: the expected sufficient statistics of the
+ * mini-batch (the weight, the weighted sum and the weighted second moment of
+ * each component) are blended into those of the current model with the step
+ * size
+ *
+ *   eta_t = (t + stepOffset)^(-decay),
+ *
+ * where t is the number of steps taken so far, and the model is recomputed
+ * from the blended statistics (the M-step), with the covariance constraint
+ * applied.  Since the statistics of the model are determined by its weights,
+ * means and covariances, the model itself is the state of the algorithm; only
+ * the number of steps is kept in the fitter.  Each observation is visited
+ * once, so the observations do not need to be kept after they are given.
+ *
+ * The fitter provides the same Estimate() functions as EMFit, so it can be
+ * used with GMM::Train() and DiagonalGMM::Train().  Each call to Estimate()
+ * cuts the given observations into mini-batches of BatchSize() observations
+ * and takes one step per mini-batch.  For the first call (when no step has
+ * been taken yet), unless the existing model is used, the initial model is
+ * found from the given observations with the clusterer, like EMFit does;
+ * later calls continue from the given model.  To keep the number of steps
+ * across calls, the fitter must be passed by reference:
+ *
+ * @code
+ * data::ChunkedReader<> reader("stream.csv", 10000);
+ * GMM gmm(5, reader.Dimensionality());
+ * OnlineEMFit<> fitter;
+ * arma::mat chunk;
+ * while (reader.NextChunk(chunk))
+ *   gmm.Train<OnlineEMFit<>&>(chunk, 1, false, fitter);
+ * @endcode
+ *
+ * @tparam InitialClusteringType Type of the clusterer that finds the initial
+ *     model (see EMFit).
+ * @tparam CovarianceConstraintPolicy Constraint applied to the covariances
+ *     after every step.
+ * @tparam Distribution Type of the components of the mixture
+ *     (distribution::GaussianDistribution or
+ *     distribution::DiagonalGaussianDistribution).
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class OnlineEMFit
+{
+ public:
+  /**
+   * Construct the OnlineEMFit object.  The decay of the step size must be in
+   * (0, 1]; the steps converge for a decay in (0.5, 1].
+   *
+   * @param batchSize Number of observations of each step.
+   * @param decay Decay of the step size.
+   * @param stepOffset Offset of the number of steps in the step size; larger
+   *     values make the first steps smaller.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint applied to the covariances.
+   */
+  OnlineEMFit(const size_t batchSize = 1000,
+              const double decay = 0.6,
+              const double stepOffset = 2.0,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Update the model with the given observations, one step per mini-batch.
+   * The size of the vectors (indicating the number of components) must
+   * already be set.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @param useInitialModel If false and no step has been taken yet, the
+   *     initial model is found with the clusterer.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Update the model with the given observations, one step per mini-batch,
+   * taking into account the probabilities of each observation being from this
+   * mixture.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each observation being from this
+   *     mixture.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @param useInitialModel If false and no step has been taken yet, the
+   *     initial model is found with the clusterer.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Forget the steps taken, so that the next Estimate() starts over.
+  void Reset() { steps = 0; }
+
+  //! Get the number of observations of each step.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of observations of each step.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the decay of the step size.
+  double Decay() const { return decay; }
+  //! Modify the decay of the step size.
+  double& Decay() { return decay; }
+
+  //! Get the offset of the number of steps in the step size.
+  double StepOffset() const { return stepOffset; }
+  //! Modify the offset of the number of steps in the step size.
+  double& StepOffset() { return stepOffset; }
+
+  //! Get the number of steps taken.
+  size_t Steps() const { return steps; }
+  //! Modify the number of steps taken.
+  size_t& Steps() { return steps; }
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const
+  { return initialFitter.Clusterer(); }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return initialFitter.Clusterer(); }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const
+  { return initialFitter.Constraint(); }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint()
+  { return initialFitter.Constraint(); }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! The type of the covariance of each component (see EMFit).
+  typedef typename std::decay<decltype(
+      std::declval<const Distribution&>().Covariance())>::type CovarianceType;
+
+  //! Add the weighted outer products of the columns of points to a full
+  //! second moment.
+  static void AddMoment(const arma::mat& points,
+                        const arma::rowvec& pointWeights,
+                        arma::mat& moment)
+  {
+    moment += (points.each_row() % pointWeights) * points.t();
+  }
+
+  //! Add the weighted squares of the columns of points to a diagonal second
+  //! moment.
+  static void AddMoment(const arma::mat& points,
+                        const arma::rowvec& pointWeights,
+                        arma::vec& moment)
+  {
+    moment += arma::square(points) * pointWeights.t();
+  }
+
+  /**
+   * Find the initial model if needed, and take one step per mini-batch of
+   * the given observations.
+   *
+   * @param observations List of observations.
+   * @param probabilities Probability of each observation, or NULL.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @param useInitialModel If false and no step has been taken yet, the
+   *     initial model is found with the clusterer.
+   */
+  void Update(const arma::mat& observations,
+              const arma::vec* probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights,
+              const bool useInitialModel);
+
+  /**
+   * Take one step with the observations [begin, end).
+   *
+   * @param observations List of observations.
+   * @param probabilities Probability of each observation, or NULL.
+   * @param begin First observation of the mini-batch.
+   * @param end One past the last observation of the mini-batch.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   */
+  void Step(const arma::mat& observations,
+            const arma::vec* probabilities,
+            const size_t begin,
+            const size_t end,
+            std::vector<Distribution>& dists,
+            arma::vec& weights);
+
+  //! Number of observations of each step.
+  size_t batchSize;
+  //! Decay of the step size.
+  double decay;
+  //! Offset of the number of steps in the step size.
+  double stepOffset;
+  //! Number of steps taken.
+  size_t steps;
+  //! Fitter that finds the initial model, and holds the clusterer and the
+  //! constraint.
+  EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+      initialFitter;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,238 @@
+/**
+ * @file online_em_fit_impl.hpp
+ *
+ * Implementation of the stepwise EM algorithm for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+OnlineEMFit<InitialClusteringType,
+            CovarianceConstraintPolicy,
+            Distribution>::OnlineEMFit(
+    const size_t batchSize,
+    const double decay,
+    const double stepOffset,
+    InitialClusteringType clusterer,
+    CovarianceConstraintPolicy constraint) :
+    batchSize(batchSize),
+    decay(decay),
+    stepOffset(stepOffset),
+    steps(0),
+    // A single iteration only finds the initial model.
+    initialFitter(1, 1e-10, clusterer, constraint)
+{
+  if (batchSize == 0)
+    throw std::invalid_argument("OnlineEMFit: batch size must be positive!");
+
+  if (decay <= 0.0 || decay > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "OnlineEMFit: decay of the step size (" << decay << ") must be in "
+        << "(0, 1]!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType,
+                 CovarianceConstraintPolicy,
+                 Distribution>::Estimate(
+    const arma::mat& observations,
+    std::vector<Distribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  Update(observations, NULL, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType,
+                 CovarianceConstraintPolicy,
+                 Distribution>::Estimate(
+    const arma::mat& observations,
+    const arma::vec& probabilities,
+    std::vector<Distribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  if (probabilities.n_elem != observations.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "OnlineEMFit::Estimate(): number of probabilities ("
+        << probabilities.n_elem << ") does not match number of observations ("
+        << observations.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Update(observations, &probabilities, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType,
+                 CovarianceConstraintPolicy,
+                 Distribution>::Update(
+    const arma::mat& observations,
+    const arma::vec* probabilities,
+    std::vector<Distribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  if (observations.n_cols == 0)
+    return;
+
+  // The first observations give the initial model, unless there is one.
+  if (!useInitialModel && steps == 0)
+  {
+    if (probabilities)
+    {
+      initialFitter.Estimate(observations, *probabilities, dists, weights,
+          false);
+    }
+    else
+    {
+      initialFitter.Estimate(observations, dists, weights, false);
+    }
+  }
+
+  for (size_t begin = 0; begin < observations.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize,
+        (size_t) observations.n_cols);
+    Step(observations, probabilities, begin, end, dists, weights);
+  }
+
+  Log::Debug << "OnlineEMFit::Estimate(): " << steps << " steps taken."
+      << std::endl;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType,
+                 CovarianceConstraintPolicy,
+                 Distribution>::Step(
+    const arma::mat& observations,
+    const arma::vec* probabilities,
+    const size_t begin,
+    const size_t end,
+    std::vector<Distribution>& dists,
+    arma::vec& weights)
+{
+  // An alias of the observations of the mini-batch; no memory is copied.
+  const arma::mat batch(const_cast<double*>(observations.colptr(begin)),
+      observations.n_rows, end - begin, false, true);
+
+  // The E-step: the conditional probability of each component for each
+  // observation, normalized in log-space.
+  arma::mat condProb(batch.n_cols, dists.size());
+  arma::vec componentLogProbs;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    dists[i].LogProbability(batch, componentLogProbs);
+    condProb.col(i) = componentLogProbs + std::log(weights[i]);
+  }
+
+  for (size_t j = 0; j < condProb.n_rows; ++j)
+  {
+    const double maxLogProb = condProb.row(j).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+    {
+      condProb.row(j).zeros();
+      continue;
+    }
+
+    condProb.row(j) = arma::exp(condProb.row(j) - maxLogProb);
+    condProb.row(j) /= arma::accu(condProb.row(j));
+  }
+
+  if (probabilities)
+    condProb.each_col() %= probabilities->subvec(begin, end - 1);
+
+  // A mini-batch that no component explains says nothing about the model.
+  const double totalWeight = arma::accu(condProb);
+  if (totalWeight <= 0.0)
+    return;
+  condProb /= totalWeight;
+
+  const double stepSize = std::pow(double(steps) + stepOffset, -decay);
+  ++steps;
+
+  // Blend the statistics of the mini-batch (normalized by its weight) into
+  // those of the model, and recompute the model from them.
+  const arma::vec batchWeights = arma::sum(condProb, 0).t();
+  const arma::mat batchSums = batch * condProb;
+  const arma::rowvec unitWeight = arma::ones<arma::rowvec>(1);
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const double weight = (1.0 - stepSize) * weights[i] +
+        stepSize * batchWeights[i];
+    if (weight <= 0.0)
+      continue;
+
+    // The statistics of the current component: w, w mu, and w (Sigma +
+    // mu mu^T).
+    CovarianceType moment = dists[i].Covariance();
+    AddMoment(dists[i].Mean(), unitWeight, moment);
+    moment *= (1.0 - stepSize) * weights[i];
+    arma::vec mean = (1.0 - stepSize) * weights[i] * dists[i].Mean() +
+        stepSize * batchSums.col(i);
+
+    const arma::rowvec batchProbs = condProb.col(i).t();
+    AddMoment(batch, stepSize * batchProbs, moment);
+
+    // The M-step.
+    mean /= weight;
+    moment /= weight;
+    AddMoment(mean, -unitWeight, moment);
+    initialFitter.Constraint().ApplyConstraint(moment);
+
+    dists[i].Mean() = std::move(mean);
+    dists[i].Covariance(std::move(moment));
+    weights[i] = weight;
+  }
+
+  weights /= arma::accu(weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType,
+                 CovarianceConstraintPolicy,
+                 Distribution>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(batchSize);
+  ar & BOOST_SERIALIZATION_NVP(decay);
+  ar & BOOST_SERIALIZATION_NVP(stepOffset);
+  ar & BOOST_SERIALIZATION_NVP(steps);
+  ar & BOOST_SERIALIZATION_NVP(initialFitter);
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
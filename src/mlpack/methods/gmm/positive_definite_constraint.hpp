@@ -62,6 +62,20 @@ class PositiveDefiniteConstraint
     }
   }
 
+  /**
+   * Apply the positive definiteness constraint to the given diagonal
+   * covariance matrix (stored as a vector).  The elements of the diagonal are
+   * its eigenvalues, so they are projected the same way.
+   *
+   * @param diagCovariance Diagonal of the covariance matrix.
+   */
+  static void ApplyConstraint(arma::vec& diagCovariance)
+  {
+    const double maxValue = diagCovariance.max();
+    const double minValue = std::max(maxValue / 1e5, 1e-50);
+    diagCovariance = arma::clamp(diagCovariance, minValue, DBL_MAX);
+  }
+
   //! Serialize the constraint (which stores nothing, so, nothing to do).
   template<typename Archive>
   static void serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -0,0 +1,217 @@
+/**
+ * @file gradient_boosting.cpp
+ *
+ * Implementation of the training of GradientBoosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "gradient_boosting.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+GradientBoosting::GradientBoosting() :
+    numClasses(0)
+{
+  // Nothing to do.
+}
+
+GradientBoosting::GradientBoosting(const arma::mat& data,
+                                   const arma::Row<size_t>& labels,
+                                   const size_t numClasses,
+                                   const size_t numRounds,
+                                   const double learningRate,
+                                   const size_t maxDepth,
+                                   const size_t minimumLeafSize,
+                                   const double lambda,
+                                   const size_t maxBins) :
+    numClasses(0)
+{
+  Train(data, labels, numClasses, numRounds, learningRate, maxDepth,
+      minimumLeafSize, lambda, maxBins);
+}
+
+void GradientBoosting::Train(const arma::mat& data,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses,
+                             const size_t numRounds,
+                             const double learningRate,
+                             const size_t maxDepth,
+                             const size_t minimumLeafSize,
+                             const double lambda,
+                             const size_t maxBins)
+{
+  Train<false>(data, labels, numClasses, arma::mat(), arma::Row<size_t>(), 0,
+      numRounds, learningRate, maxDepth, minimumLeafSize, lambda, maxBins);
+}
+
+void GradientBoosting::Train(const arma::mat& data,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses,
+                             const arma::mat& validationData,
+                             const arma::Row<size_t>& validationLabels,
+                             const size_t patience,
+                             const size_t numRounds,
+                             const double learningRate,
+                             const size_t maxDepth,
+                             const size_t minimumLeafSize,
+                             const double lambda,
+                             const size_t maxBins)
+{
+  Train<true>(data, labels, numClasses, validationData, validationLabels,
+      patience, numRounds, learningRate, maxDepth, minimumLeafSize, lambda,
+      maxBins);
+}
+
+template<bool UseValidation>
+void GradientBoosting::Train(const arma::mat& data,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses,
+                             const arma::mat& validationData,
+                             const arma::Row<size_t>& validationLabels,
+                             const size_t patience,
+                             const size_t numRounds,
+                             const double learningRate,
+                             const size_t maxDepth,
+                             const size_t minimumLeafSize,
+                             const double lambda,
+                             const size_t maxBins)
+{
+  // Sanity check on data.
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Train(): number of points (" << data.n_cols
+        << ") does not match number of labels (" << labels.n_elem << ")!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (UseValidation && validationData.n_cols != validationLabels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Train(): number of validation points ("
+        << validationData.n_cols << ") does not match number of validation "
+        << "labels (" << validationLabels.n_elem << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): there must be at "
+        "least two classes!");
+  }
+
+  this->numClasses = numClasses;
+  trees.clear();
+
+  // With two classes, there is a single score: the log-odds of the second
+  // class.
+  const size_t numScores = (numClasses == 2) ? 1 : numClasses;
+
+  // Start from the (smoothed) prior probability of each class.
+  arma::vec priors(numClasses);
+  priors.fill(1.0);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    priors[labels[i]] += 1.0;
+  priors /= arma::accu(priors);
+  if (numScores == 1)
+    baseScores = arma::vec(1).fill(std::log(priors[1] / priors[0]));
+  else
+    baseScores = arma::log(priors);
+
+  // Quantize the data once; every tree is trained on the bins.
+  const BinnedDataset binnedData(data, maxBins);
+
+  arma::mat scores = arma::repmat(baseScores, 1, data.n_cols);
+  arma::mat validationScores;
+  if (UseValidation)
+    validationScores = arma::repmat(baseScores, 1, validationData.n_cols);
+
+  trees.reserve(numRounds * numScores);
+  arma::mat probabilities;
+  arma::vec gradients(data.n_cols);
+  arma::vec hessians(data.n_cols);
+  arma::vec predictions;
+  double bestLoss = DBL_MAX;
+  size_t bestRounds = 0;
+  for (size_t r = 0; r < numRounds; ++r)
+  {
+    Probabilities(scores, probabilities);
+    for (size_t k = 0; k < numScores; ++k)
+    {
+      // The gradient and hessian of the log-loss with respect to the score of
+      // the class.
+      const size_t c = (numScores == 1) ? 1 : k;
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        const double p = probabilities(c, i);
+        gradients[i] = p - ((labels[i] == c) ? 1.0 : 0.0);
+        hessians[i] = std::max(p * (1.0 - p), 1e-16);
+      }
+
+      trees.push_back(GradientBoostingTree());
+      GradientBoostingTree& tree = trees.back();
+      tree.Train(binnedData, gradients, hessians, predictions, maxDepth,
+          minimumLeafSize, lambda, learningRate);
+      scores.row(k) += predictions.t();
+
+      if (UseValidation)
+      {
+        #pragma omp parallel for
+        for (omp_size_t i = 0; i < (omp_size_t) validationData.n_cols; ++i)
+          validationScores(k, i) += tree.Predict(validationData.col(i));
+      }
+    }
+
+    if (UseValidation)
+    {
+      // Compute the log-loss on the validation set.
+      arma::mat validationProbabilities;
+      Probabilities(validationScores, validationProbabilities);
+      double loss = 0.0;
+      for (size_t i = 0; i < validationData.n_cols; ++i)
+      {
+        loss -= std::log(std::max(
+            validationProbabilities(validationLabels[i], i), 1e-300));
+      }
+
+      if (loss < bestLoss)
+      {
+        bestLoss = loss;
+        bestRounds = r + 1;
+      }
+      else if (r + 1 - bestRounds >= patience)
+      {
+        Log::Info << "GradientBoosting::Train(): stopping after " << (r + 1)
+            << " rounds; the best validation log-loss was after " << bestRounds
+            << " rounds." << std::endl;
+        break;
+      }
+    }
+  }
+
+  // Drop the rounds after the best one.
+  if (UseValidation)
+    trees.resize(bestRounds * numScores);
+}
+
+void GradientBoosting::Probabilities(const arma::mat& scores,
+                                     arma::mat& probabilities) const
+{
+  probabilities.set_size(numClasses, scores.n_cols);
+  if (scores.n_rows == 1)
+  {
+    probabilities.row(1) = 1.0 / (1.0 + arma::exp(-scores.row(0)));
+    probabilities.row(0) = 1.0 - probabilities.row(1);
+  }
+  else
+  {
+    // Subtract the maximum score for numerical stability.
+    probabilities = arma::exp(scores.each_row() - arma::max(scores, 0));
+    probabilities.each_row() /= arma::sum(probabilities, 0);
+  }
+}
@@ -0,0 +1,239 @@
+/**
+ * @file gradient_boosting.hpp
+ *
+ * Definition of the GradientBoosting class, a classifier made of boosted
+ * regression trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/binned_dataset.hpp>
+#include "gradient_boosting_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The GradientBoosting class is a classifier made of regression trees that are
+ * trained one after the other, each on the gradient and hessian of the
+ * log-loss of the trees before it (second-order gradient boosting, as in
+ * XGBoost and LightGBM).  For two classes, each round adds one tree to the
+ * log-odds of the second class; for more classes, each round adds one tree to
+ * the score of each class, and the probabilities are the softmax of the scores.
+ *
+ * The training data is quantized into a BinnedDataset, and the splits of the
+ * trees are found from histograms of the bins, which are built in parallel over
+ * the dimensions when OpenMP is available.  The values of the leaves are shrunk
+ * by the learning rate.  If validation data is given, training stops once the
+ * log-loss on the validation data has not improved for a number of rounds, and
+ * the rounds after the best one are dropped.
+ *
+ * @code
+ * extern arma::mat data;
+ * extern arma::Row<size_t> labels;
+ * extern arma::mat testData;
+ *
+ * GradientBoosting gb(data, labels, numClasses);
+ * arma::Row<size_t> predictions;
+ * gb.Classify(testData, predictions);
+ * @endcode
+ */
+class GradientBoosting
+{
+ public:
+  /**
+   * Create an empty model.  Classify() will throw an exception until Train()
+   * is called.
+   */
+  GradientBoosting();
+
+  /**
+   * Create the model and train it on the given labeled data.  See Train() for
+   * the meaning of the parameters.
+   */
+  GradientBoosting(const arma::mat& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const size_t numRounds = 100,
+                   const double learningRate = 0.1,
+                   const size_t maxDepth = 6,
+                   const size_t minimumLeafSize = 20,
+                   const double lambda = 1.0,
+                   const size_t maxBins = 256);
+
+  /**
+   * Train the model on the given labeled data for the given number of rounds.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels for the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numRounds Number of boosting rounds.
+   * @param learningRate Shrinkage applied to the values of each tree.
+   * @param maxDepth Maximum depth of each tree.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the leaf values.
+   * @param maxBins Maximum number of bins of each dimension (at most 256).
+   */
+  void Train(const arma::mat& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const size_t numRounds = 100,
+             const double learningRate = 0.1,
+             const size_t maxDepth = 6,
+             const size_t minimumLeafSize = 20,
+             const double lambda = 1.0,
+             const size_t maxBins = 256);
+
+  /**
+   * Train the model on the given labeled data, stopping early once the log-loss
+   * on the given validation data has not improved for the given number of
+   * rounds.  The model keeps the rounds up to the one with the lowest
+   * validation log-loss.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels for the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param validationData Dataset to measure the log-loss on.
+   * @param validationLabels Labels for the validation dataset.
+   * @param patience Number of rounds without improvement before stopping.
+   * @param numRounds Maximum number of boosting rounds.
+   * @param learningRate Shrinkage applied to the values of each tree.
+   * @param maxDepth Maximum depth of each tree.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the leaf values.
+   * @param maxBins Maximum number of bins of each dimension (at most 256).
+   */
+  void Train(const arma::mat& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const arma::mat& validationData,
+             const arma::Row<size_t>& validationLabels,
+             const size_t patience = 10,
+             const size_t numRounds = 100,
+             const double learningRate = 0.1,
+             const size_t maxDepth = 6,
+             const size_t minimumLeafSize = 20,
+             const double lambda = 1.0,
+             const size_t maxBins = 256);
+
+  /**
+   * Predict the class of the given point.  If the model has not been trained,
+   * this will throw an exception.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the predicted class
+   * probabilities for each class.  If the model has not been trained, this will
+   * throw an exception.
+   *
+   * @param point Point to be classified.
+   * @param prediction size_t to store predicted class in.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.  If the model has
+   * not been trained, this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities for each point.  The points are classified
+   * in parallel when OpenMP is available.  If the model has not been trained,
+   * this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the number of boosting rounds of the model.
+  size_t NumRounds() const
+  {
+    return trees.empty() ? 0 : trees.size() / baseScores.n_elem;
+  }
+
+  //! Get the number of trees in the model.
+  size_t NumTrees() const { return trees.size(); }
+  //! Access a tree of the model.
+  const GradientBoostingTree& Tree(const size_t i) const { return trees[i]; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numClasses);
+    ar & BOOST_SERIALIZATION_NVP(baseScores);
+    ar & BOOST_SERIALIZATION_NVP(trees);
+  }
+
+ private:
+  /**
+   * Perform the training.  The template bool parameter controls whether or not
+   * the validation data is used for early stopping.
+   */
+  template<bool UseValidation>
+  void Train(const arma::mat& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const arma::mat& validationData,
+             const arma::Row<size_t>& validationLabels,
+             const size_t patience,
+             const size_t numRounds,
+             const double learningRate,
+             const size_t maxDepth,
+             const size_t minimumLeafSize,
+             const double lambda,
+             const size_t maxBins);
+
+  //! Compute the score of each class (or the log-odds) of the given point.
+  template<typename VecType>
+  void Scores(const VecType& point, arma::vec& scores) const;
+
+  /**
+   * Turn scores into class probabilities, with the logistic function if there
+   * is one score per point and with the softmax function otherwise.
+   */
+  void Probabilities(const arma::mat& scores, arma::mat& probabilities) const;
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The initial score of each class (or the initial log-odds).
+  arma::vec baseScores;
+  //! The trees, round after round, with one tree per score in each round.
+  std::vector<GradientBoostingTree> trees;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "gradient_boosting_impl.hpp"
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file gradient_boosting_impl.hpp
+ *
+ * Implementation of the classification functions of GradientBoosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_boosting.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename VecType>
+size_t GradientBoosting::Classify(const VecType& point) const
+{
+  // Pass off to another Classify() overload.
+  size_t predictedClass;
+  arma::vec probabilities;
+  Classify(point, predictedClass, probabilities);
+
+  return predictedClass;
+}
+
+template<typename VecType>
+void GradientBoosting::Classify(const VecType& point,
+                                size_t& prediction,
+                                arma::vec& probabilities) const
+{
+  if (baseScores.n_elem == 0)
+  {
+    probabilities.clear();
+
+    throw std::invalid_argument("GradientBoosting::Classify(): no gradient "
+        "boosting model trained!");
+  }
+
+  arma::vec scores;
+  Scores(point, scores);
+  arma::mat pointProbabilities;
+  Probabilities(scores, pointProbabilities);
+  probabilities = pointProbabilities.col(0);
+
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  prediction = (size_t) maxIndex;
+}
+
+template<typename MatType>
+void GradientBoosting::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void GradientBoosting::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions,
+                                arma::mat& probabilities) const
+{
+  if (baseScores.n_elem == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("GradientBoosting::Classify(): no gradient "
+        "boosting model trained!");
+  }
+
+  arma::mat scores(baseScores.n_elem, data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    arma::vec pointScores;
+    Scores(data.col(i), pointScores);
+    scores.col(i) = pointScores;
+  }
+
+  Probabilities(scores, probabilities);
+  predictions.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::uword maxIndex = 0;
+    probabilities.col(i).max(maxIndex);
+    predictions[i] = (size_t) maxIndex;
+  }
+}
+
+template<typename VecType>
+void GradientBoosting::Scores(const VecType& point, arma::vec& scores) const
+{
+  scores = baseScores;
+  for (size_t t = 0; t < trees.size(); ++t)
+    scores[t % scores.n_elem] += trees[t].Predict(point);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
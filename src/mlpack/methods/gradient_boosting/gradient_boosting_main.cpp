@@ -0,0 +1,289 @@
+/**
+ * @file gradient_boosting_main.cpp
+ *
+ * A program to build and evaluate gradient boosted trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::util;
+using namespace std;
+
+PROGRAM_INFO("Gradient boosted trees",
+    "This program is an implementation of gradient boosting with regression "
+    "trees for classification, in the style of XGBoost and LightGBM: each tree "
+    "is fit to the gradient and hessian of the log-loss of the trees before "
+    "it, and the splits are found from histograms of the quantized training "
+    "data.  A model can be trained and saved for later use, or a model may be "
+    "loaded and predictions or class probabilities for points may be "
+    "generated."
+    "\n\n"
+    "The training set and associated labels are specified with the " +
+    PRINT_PARAM_STRING("training") + " and " + PRINT_PARAM_STRING("labels") +
+    " parameters, respectively.  The labels should be in the range [0, "
+    "num_classes - 1]."
+    "\n\n"
+    "When a model is trained, the " + PRINT_PARAM_STRING("output_model") + " "
+    "output parameter may be used to save the trained model.  A model may be "
+    "loaded for predictions with the " + PRINT_PARAM_STRING("input_model") +
+    " parameter.  The " + PRINT_PARAM_STRING("input_model") + " parameter may "
+    "not be specified when the " + PRINT_PARAM_STRING("training") + " parameter"
+    " is specified.  The " + PRINT_PARAM_STRING("num_rounds") + " parameter "
+    "controls the number of boosting rounds, the " +
+    PRINT_PARAM_STRING("learning_rate") + " parameter the shrinkage of each "
+    "tree, the " + PRINT_PARAM_STRING("max_depth") + " parameter the maximum "
+    "depth of each tree, and the " + PRINT_PARAM_STRING("minimum_leaf_size") +
+    " parameter the minimum number of training points in each leaf.  The " +
+    PRINT_PARAM_STRING("lambda") + " parameter is the L2 regularization of the "
+    "leaf values, and the " + PRINT_PARAM_STRING("max_bins") + " parameter is "
+    "the maximum number of bins each dimension is quantized into."
+    "\n\n"
+    "If a validation set is given with the " +
+    PRINT_PARAM_STRING("validation") + " and " +
+    PRINT_PARAM_STRING("validation_labels") + " parameters, training stops "
+    "once the log-loss on the validation set has not improved for " +
+    PRINT_PARAM_STRING("patience") + " rounds, and the model keeps the rounds "
+    "up to the best one.  If " + PRINT_PARAM_STRING("print_training_accuracy") +
+    " is specified, the calculated accuracy on the training set will be "
+    "printed."
+    "\n\n"
+    "Test data may be specified with the " + PRINT_PARAM_STRING("test") + " "
+    "parameter, and if performance measures are desired for that test set, "
+    "labels for the test points may be specified with the " +
+    PRINT_PARAM_STRING("test_labels") + " parameter.  Predictions for each "
+    "test point may be saved via the " + PRINT_PARAM_STRING("predictions") +
+    " output parameter.  Class probabilities for each prediction may be saved "
+    "with the " + PRINT_PARAM_STRING("probabilities") + " output parameter."
+    "\n\n"
+    "For example, to train a model with 200 rounds and a learning rate of 0.05 "
+    "on the dataset contained in " + PRINT_DATASET("data") + " with labels " +
+    PRINT_DATASET("labels") + ", saving the output model to " +
+    PRINT_MODEL("gb_model") + " and printing the training error, one could "
+    "call"
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "training", "data", "labels", "labels",
+        "num_rounds", 200, "learning_rate", 0.05, "output_model", "gb_model",
+        "print_training_accuracy", true) +
+    "\n\n"
+    "Then, to use that model to classify points in " +
+    PRINT_DATASET("test_set") + " and print the test error given the labels " +
+    PRINT_DATASET("test_labels") + " using that model, while saving the "
+    "predictions for each point to " + PRINT_DATASET("predictions") + ", one "
+    "could call "
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "input_model", "gb_model", "test",
+        "test_set", "test_labels", "test_labels", "predictions",
+        "predictions"));
+
+PARAM_MATRIX_IN("training", "Training dataset.", "t");
+PARAM_UROW_IN("labels", "Labels for training dataset.", "l");
+PARAM_MATRIX_IN("validation", "Validation dataset for early stopping.", "e");
+PARAM_UROW_IN("validation_labels", "Labels for validation dataset.", "E");
+PARAM_MATRIX_IN("test", "Test dataset to produce predictions for.", "T");
+PARAM_UROW_IN("test_labels", "Test dataset labels, if accuracy calculation is "
+    "desired.", "L");
+
+PARAM_FLAG("print_training_accuracy", "If set, then the accuracy of the model "
+    "on the training set will be predicted (verbose must also be specified).",
+    "a");
+
+PARAM_INT_IN("num_rounds", "Maximum number of boosting rounds.", "N", 100);
+PARAM_DOUBLE_IN("learning_rate", "Shrinkage applied to each tree.", "r", 0.1);
+PARAM_INT_IN("max_depth", "Maximum depth of each tree.", "D", 6);
+PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in each leaf "
+    "node.", "n", 20);
+PARAM_DOUBLE_IN("lambda", "L2 regularization of the leaf values.", "g", 1.0);
+PARAM_INT_IN("max_bins", "Maximum number of bins of each dimension (between 2 "
+    "and 256).", "b", 256);
+PARAM_INT_IN("patience", "Number of rounds without improvement of the "
+    "validation log-loss before training stops.", "s", 10);
+
+PARAM_MATRIX_OUT("probabilities", "Predicted class probabilities for each "
+    "point in the test set.", "P");
+PARAM_UROW_OUT("predictions", "Predicted classes for each point in the test "
+    "set.", "p");
+
+/**
+ * This is the class that we will serialize.  It is a simple wrapper around
+ * GradientBoosting.
+ */
+class GradientBoostingModel
+{
+ public:
+  // The model itself, left public for direct access by this program.
+  GradientBoosting gb;
+
+  // Create the model.
+  GradientBoostingModel() { /* Nothing to do. */ }
+
+  // Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(gb);
+  }
+};
+
+PARAM_MODEL_IN(GradientBoostingModel, "input_model", "Pre-trained gradient "
+    "boosting model to use for classification.", "m");
+PARAM_MODEL_OUT(GradientBoostingModel, "output_model", "Model to save trained "
+    "gradient boosting model to.", "M");
+
+static void mlpackMain()
+{
+  // Check for incompatible input parameters.
+  RequireOnlyOnePassed({ "training", "input_model" }, true);
+
+  ReportIgnoredParam({{ "training", false }}, "print_training_accuracy");
+
+  if (CLI::HasParam("test"))
+  {
+    RequireAtLeastOnePassed({ "probabilities", "predictions" }, "no test output"
+        " will be saved");
+  }
+
+  ReportIgnoredParam({{ "test", false }}, "test_labels");
+
+  RequireAtLeastOnePassed({ "test", "output_model", "print_training_accuracy" },
+      "the trained model will not be used or saved");
+
+  if (CLI::HasParam("training"))
+  {
+    RequireAtLeastOnePassed({ "labels" }, true, "must pass labels when training"
+        " set given");
+  }
+
+  if (CLI::HasParam("validation"))
+  {
+    RequireAtLeastOnePassed({ "validation_labels" }, true, "must pass labels "
+        "when validation set given");
+  }
+
+  RequireParamValue<int>("num_rounds", [](int x) { return x > 0; }, true,
+      "number of rounds must be positive");
+  RequireParamValue<double>("learning_rate", [](double x) { return x > 0.0; },
+      true, "learning rate must be positive");
+  RequireParamValue<int>("max_depth", [](int x) { return x >= 0; }, true,
+      "maximum depth must be nonnegative");
+  RequireParamValue<int>("minimum_leaf_size", [](int x) { return x > 0; }, true,
+      "minimum leaf size must be greater than 0");
+  RequireParamValue<double>("lambda", [](double x) { return x >= 0.0; }, true,
+      "lambda must be nonnegative");
+  RequireParamValue<int>("max_bins", [](int x) { return x >= 2 && x <= 256; },
+      true, "maximum number of bins must be between 2 and 256");
+  RequireParamValue<int>("patience", [](int x) { return x > 0; }, true,
+      "patience must be positive");
+
+  ReportIgnoredParam({{ "test", false }}, "predictions");
+  ReportIgnoredParam({{ "test", false }}, "probabilities");
+
+  ReportIgnoredParam({{ "training", false }}, "validation");
+  ReportIgnoredParam({{ "training", false }}, "num_rounds");
+  ReportIgnoredParam({{ "training", false }}, "learning_rate");
+  ReportIgnoredParam({{ "training", false }}, "max_depth");
+  ReportIgnoredParam({{ "training", false }}, "minimum_leaf_size");
+  ReportIgnoredParam({{ "training", false }}, "lambda");
+  ReportIgnoredParam({{ "training", false }}, "max_bins");
+  ReportIgnoredParam({{ "validation", false }}, "patience");
+
+  GradientBoostingModel* gbModel;
+  if (CLI::HasParam("training"))
+  {
+    gbModel = new GradientBoostingModel();
+
+    // Train the model on the given input data.
+    arma::mat data = std::move(CLI::GetParam<arma::mat>("training"));
+    arma::Row<size_t> labels =
+        std::move(CLI::GetParam<arma::Row<size_t>>("labels"));
+    const size_t numRounds = (size_t) CLI::GetParam<int>("num_rounds");
+    const double learningRate = CLI::GetParam<double>("learning_rate");
+    const size_t maxDepth = (size_t) CLI::GetParam<int>("max_depth");
+    const size_t minimumLeafSize =
+        (size_t) CLI::GetParam<int>("minimum_leaf_size");
+    const double lambda = CLI::GetParam<double>("lambda");
+    const size_t maxBins = (size_t) CLI::GetParam<int>("max_bins");
+
+    Log::Info << "Training gradient boosted trees with at most " << numRounds
+        << " rounds..." << endl;
+
+    const size_t numClasses = std::max((size_t) arma::max(labels) + 1,
+        (size_t) 2);
+
+    // Train the model.
+    if (CLI::HasParam("validation"))
+    {
+      arma::mat validationData =
+          std::move(CLI::GetParam<arma::mat>("validation"));
+      arma::Row<size_t> validationLabels =
+          std::move(CLI::GetParam<arma::Row<size_t>>("validation_labels"));
+      const size_t patience = (size_t) CLI::GetParam<int>("patience");
+
+      gbModel->gb.Train(data, labels, numClasses, validationData,
+          validationLabels, patience, numRounds, learningRate, maxDepth,
+          minimumLeafSize, lambda, maxBins);
+    }
+    else
+    {
+      gbModel->gb.Train(data, labels, numClasses, numRounds, learningRate,
+          maxDepth, minimumLeafSize, lambda, maxBins);
+    }
+
+    Log::Info << "Trained " << gbModel->gb.NumRounds() << " rounds." << endl;
+
+    // Did we want training accuracy?
+    if (CLI::HasParam("print_training_accuracy"))
+    {
+      arma::Row<size_t> predictions;
+      gbModel->gb.Classify(data, predictions);
+
+      const size_t correct = arma::accu(predictions == labels);
+
+      Log::Info << correct << " of " << labels.n_elem << " correct on training"
+          << " set (" << (double(correct) / double(labels.n_elem) * 100) << ")."
+          << endl;
+    }
+  }
+  else
+  {
+    // Then we must be loading a model.
+    gbModel = CLI::GetParam<GradientBoostingModel*>("input_model");
+  }
+
+  if (CLI::HasParam("test"))
+  {
+    arma::mat testData = std::move(CLI::GetParam<arma::mat>("test"));
+
+    // Get predictions and probabilities.
+    arma::Row<size_t> predictions;
+    arma::mat probabilities;
+    gbModel->gb.Classify(testData, predictions, probabilities);
+
+    // Did we want to calculate test accuracy?
+    if (CLI::HasParam("test_labels"))
+    {
+      arma::Row<size_t> testLabels =
+          std::move(CLI::GetParam<arma::Row<size_t>>("test_labels"));
+
+      const size_t correct = arma::accu(predictions == testLabels);
+
+      Log::Info << correct << " of " << testLabels.n_elem << " correct on test"
+          << " set (" << (double(correct) / double(testLabels.n_elem) * 100)
+          << ")." << endl;
+    }
+
+    // Save the outputs.
+    CLI::GetParam<arma::mat>("probabilities") = std::move(probabilities);
+    CLI::GetParam<arma::Row<size_t>>("predictions") = std::move(predictions);
+  }
+
+  // Save the output model.
+  CLI::GetParam<GradientBoostingModel*>("output_model") = gbModel;
+}
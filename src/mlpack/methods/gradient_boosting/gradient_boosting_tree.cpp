@@ -0,0 +1,200 @@
+/**
+ * @file gradient_boosting_tree.cpp
+ *
+ * Implementation of the regression trees used by gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "gradient_boosting_tree.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+GradientBoostingTree::GradientBoostingTree()
+{
+  // Nothing to do.
+}
+
+void GradientBoostingTree::Train(const BinnedDataset& data,
+                                 const arma::vec& gradients,
+                                 const arma::vec& hessians,
+                                 arma::vec& predictions,
+                                 const size_t maxDepth,
+                                 const size_t minimumLeafSize,
+                                 const double lambda,
+                                 const double learningRate)
+{
+  if (gradients.n_elem != data.NumPoints() ||
+      hessians.n_elem != data.NumPoints())
+  {
+    std::ostringstream oss;
+    oss << "GradientBoostingTree::Train(): number of points ("
+        << data.NumPoints() << ") does not match number of gradients ("
+        << gradients.n_elem << ") or hessians (" << hessians.n_elem << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Start with a single leaf.
+  dimensions.assign(1, 0);
+  thresholds.assign(1, 0.0);
+  children.assign(1, 0);
+  values.assign(1, 0.0);
+
+  predictions.zeros(data.NumPoints());
+  if (data.NumPoints() == 0)
+    return;
+
+  arma::uvec points = arma::linspace<arma::uvec>(0, data.NumPoints() - 1,
+      data.NumPoints());
+  arma::mat histogram;
+  BuildHistogram(data, points, 0, points.n_elem, gradients, hessians,
+      histogram);
+  TrainNode(data, points, 0, points.n_elem, gradients, hessians, histogram,
+      predictions, 0, 0, maxDepth, minimumLeafSize, lambda, learningRate);
+}
+
+void GradientBoostingTree::TrainNode(const BinnedDataset& data,
+                                     arma::uvec& points,
+                                     const size_t begin,
+                                     const size_t count,
+                                     const arma::vec& gradients,
+                                     const arma::vec& hessians,
+                                     arma::mat& histogram,
+                                     arma::vec& predictions,
+                                     const size_t node,
+                                     const size_t depth,
+                                     const size_t maxDepth,
+                                     const size_t minimumLeafSize,
+                                     const double lambda,
+                                     const double learningRate)
+{
+  // The sums of the node are the sums over the bins of any dimension.
+  const arma::Col<size_t>& offsets = data.BinOffsets();
+  const arma::vec sums = arma::sum(histogram.cols(offsets[0],
+      offsets[1] - 1), 1);
+  const double nodeGradient = sums[0];
+  const double nodeHessian = sums[1];
+  const double nodeScore = nodeGradient * nodeGradient /
+      (nodeHessian + lambda);
+
+  // Sweep through the bins of each dimension with running sums, looking for
+  // the split that most reduces the loss.  Force a minimum leaf size of 1
+  // (empty children don't make sense).
+  double bestGain = 0.0;
+  size_t bestDim = data.Dimensionality(); // This means "no split".
+  size_t bestBin = 0;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  if (depth < maxDepth && count >= 2 * minimum)
+  {
+    for (size_t d = 0; d < data.Dimensionality(); ++d)
+    {
+      double leftGradient = 0.0;
+      double leftHessian = 0.0;
+      size_t leftPoints = 0;
+      for (size_t b = 0; b + 1 < data.NumBins(d); ++b)
+      {
+        // An empty bin gives the same split as the previous one.
+        const size_t bin = offsets[d] + b;
+        if (histogram(2, bin) == 0.0)
+          continue;
+
+        leftGradient += histogram(0, bin);
+        leftHessian += histogram(1, bin);
+        leftPoints += (size_t) histogram(2, bin);
+        if (leftPoints < minimum)
+          continue;
+        if (count - leftPoints < minimum)
+          break;
+
+        const double rightGradient = nodeGradient - leftGradient;
+        const double rightHessian = nodeHessian - leftHessian;
+        const double gain =
+            leftGradient * leftGradient / (leftHessian + lambda) +
+            rightGradient * rightGradient / (rightHessian + lambda) -
+            nodeScore;
+        if (gain > bestGain)
+        {
+          bestGain = gain;
+          bestDim = d;
+          bestBin = b;
+        }
+      }
+    }
+  }
+
+  if (bestDim == data.Dimensionality())
+  {
+    // We are a leaf.
+    children[node] = 0;
+    values[node] = -learningRate * nodeGradient / (nodeHessian + lambda);
+    for (size_t i = begin; i < begin + count; ++i)
+      predictions[points[i]] = values[node];
+
+    return;
+  }
+
+  // Create the children; they are consecutive.
+  const size_t left = values.size();
+  dimensions[node] = bestDim;
+  thresholds[node] = data.Threshold(bestDim, bestBin);
+  children[node] = left;
+  dimensions.resize(left + 2, 0);
+  thresholds.resize(left + 2, 0.0);
+  children.resize(left + 2, 0);
+  values.resize(left + 2, 0.0);
+
+  // Move the points of the left child to the front.
+  const unsigned char* codes = data.Codes().colptr(bestDim);
+  arma::uword* first = points.memptr() + begin;
+  arma::uword* middle = std::partition(first, first + count,
+      [codes, bestBin](const arma::uword p) { return codes[p] <= bestBin; });
+  const size_t leftCount = (size_t) (middle - first);
+  const size_t rightCount = count - leftCount;
+
+  // Only compute the histogram of the smaller child; the histogram of the
+  // larger child is the difference, and it can take the place of ours.
+  const bool leftSmaller = (leftCount <= rightCount);
+  arma::mat smallHistogram;
+  BuildHistogram(data, points, leftSmaller ? begin : begin + leftCount,
+      leftSmaller ? leftCount : rightCount, gradients, hessians,
+      smallHistogram);
+  histogram -= smallHistogram;
+
+  TrainNode(data, points, begin, leftCount, gradients, hessians,
+      leftSmaller ? smallHistogram : histogram, predictions, left, depth + 1,
+      maxDepth, minimumLeafSize, lambda, learningRate);
+  TrainNode(data, points, begin + leftCount, rightCount, gradients, hessians,
+      leftSmaller ? histogram : smallHistogram, predictions, left + 1,
+      depth + 1, maxDepth, minimumLeafSize, lambda, learningRate);
+}
+
+void GradientBoostingTree::BuildHistogram(const BinnedDataset& data,
+                                          const arma::uvec& points,
+                                          const size_t begin,
+                                          const size_t count,
+                                          const arma::vec& gradients,
+                                          const arma::vec& hessians,
+                                          arma::mat& histogram)
+{
+  const arma::Col<size_t>& offsets = data.BinOffsets();
+  histogram.zeros(3, data.TotalBins());
+
+  // Each dimension has its own columns of the histogram.
+  #pragma omp parallel for schedule(dynamic) if (count >= 4096)
+  for (omp_size_t d = 0; d < (omp_size_t) data.Dimensionality(); ++d)
+  {
+    const unsigned char* codes = data.Codes().colptr(d);
+    double* bins = histogram.colptr(offsets[d]);
+    for (size_t i = begin; i < begin + count; ++i)
+    {
+      const size_t point = points[i];
+      double* bin = bins + 3 * codes[point];
+      bin[0] += gradients[point];
+      bin[1] += hessians[point];
+      bin[2] += 1.0;
+    }
+  }
+}
@@ -0,0 +1,147 @@
+/**
+ * @file gradient_boosting_tree.hpp
+ *
+ * A regression tree fit to the gradients and hessians of a loss, for gradient
+ * boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/binned_dataset.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The GradientBoostingTree is a binary regression tree that is fit to the
+ * gradient and hessian of a loss at each point of a BinnedDataset, with the
+ * second-order approximation of the loss used by XGBoost and LightGBM.  The
+ * value of a leaf with gradient sum G and hessian sum H is -G / (H + lambda),
+ * and a node is split on the threshold between two bins that most reduces the
+ * approximate loss.  The splits are found from histograms of the gradient and
+ * hessian sums in each bin, which are built in parallel over the dimensions;
+ * the histogram of the larger child of a node is obtained by subtracting the
+ * histogram of the smaller child from the histogram of the node.
+ *
+ * The nodes are stored in contiguous arrays, and the two children of a node are
+ * consecutive.
+ */
+class GradientBoostingTree
+{
+ public:
+  /**
+   * Create an empty tree.  Predict() may not be called until the tree is
+   * trained.
+   */
+  GradientBoostingTree();
+
+  /**
+   * Fit the tree to the given gradients and hessians of the loss at each point
+   * of the binned data.
+   *
+   * @param data Binned dataset to train on.
+   * @param gradients Gradient of the loss at each point.
+   * @param hessians Second derivative of the loss at each point.
+   * @param predictions Output values of the tree at each point.
+   * @param maxDepth Maximum depth of the tree.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the leaf values.
+   * @param learningRate Shrinkage applied to the leaf values.
+   */
+  void Train(const BinnedDataset& data,
+             const arma::vec& gradients,
+             const arma::vec& hessians,
+             arma::vec& predictions,
+             const size_t maxDepth,
+             const size_t minimumLeafSize,
+             const double lambda,
+             const double learningRate);
+
+  /**
+   * Get the value of the tree at the given point.
+   *
+   * @param point Point to evaluate the tree at.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const
+  {
+    size_t node = 0;
+    while (children[node] != 0)
+    {
+      node = children[node] +
+          ((double) point[dimensions[node]] <= thresholds[node] ? 0 : 1);
+    }
+
+    return values[node];
+  }
+
+  //! Get the number of nodes in the tree.
+  size_t NumNodes() const { return values.size(); }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(dimensions);
+    ar & BOOST_SERIALIZATION_NVP(thresholds);
+    ar & BOOST_SERIALIZATION_NVP(children);
+    ar & BOOST_SERIALIZATION_NVP(values);
+  }
+
+ private:
+  /**
+   * Fit the given node to the points in the range [begin, begin + count) of
+   * the points array, which is reordered so that the points of each child of
+   * the node are contiguous.
+   *
+   * @param histogram Histogram of the points of the node; it may be modified.
+   */
+  void TrainNode(const BinnedDataset& data,
+                 arma::uvec& points,
+                 const size_t begin,
+                 const size_t count,
+                 const arma::vec& gradients,
+                 const arma::vec& hessians,
+                 arma::mat& histogram,
+                 arma::vec& predictions,
+                 const size_t node,
+                 const size_t depth,
+                 const size_t maxDepth,
+                 const size_t minimumLeafSize,
+                 const double lambda,
+                 const double learningRate);
+
+  /**
+   * Compute the histogram of the given points: one column per bin (numbered
+   * consecutively over all the dimensions), holding the gradient sum, the
+   * hessian sum and the number of points in the bin.  This is done in parallel
+   * over the dimensions.
+   */
+  static void BuildHistogram(const BinnedDataset& data,
+                             const arma::uvec& points,
+                             const size_t begin,
+                             const size_t count,
+                             const arma::vec& gradients,
+                             const arma::vec& hessians,
+                             arma::mat& histogram);
+
+  //! The dimension each internal node splits on.
+  std::vector<size_t> dimensions;
+  //! The threshold of each internal node.
+  std::vector<double> thresholds;
+  //! The left child of each internal node (the right child follows it), or 0.
+  std::vector<size_t> children;
+  //! The value of each leaf.
+  std::vector<double> values;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -79,6 +79,20 @@ namespace hmm /** Hidden Markov Models. */ {
  * (with Predict()), generate a sequence (with Generate()), or estimate the
  * probabilities of each state for a sequence of observations (with Train()).
  *
+ * The Distribution type must provide LogProbability() for single
+ * observations; the emission probabilities of each time step are evaluated in
+ * log-space and rescaled before the Forward-Backward recursions, so
+ * observations that are very unlikely under every state (as is common for
+ * high-dimensional emissions) don't underflow.
+ *
+ * If most transitions between states are impossible (for instance, in a banded
+ * or left-right topology), set SparseTransition() to true.  The
+ * Forward-Backward recursions and the Baum-Welch transition statistics then
+ * only visit the nonzero entries of the transition matrix, so their cost is
+ * linear in the number of allowed transitions instead of quadratic in the
+ * number of states.  Entries of the transition matrix that are zero stay zero
+ * during training in either case.
+ *
  * @tparam Distribution Type of emission distribution for this HMM.
  */
 template<typename Distribution = distribution::DiscreteDistribution>
@@ -158,6 +172,12 @@ class HMM
    * log-likelihood of the model between iterations is less than the tolerance,
    * the Baum-Welch algorithm terminates.
    *
+   * The E-steps of the different sequences are run in parallel (when OpenMP
+   * is available), with each thread accumulating its own transition and
+   * emission statistics.  In the M-step, the emission distributions of the
+   * states are fitted in parallel, so Distribution::Train() must be safe to
+   * call on different distributions at the same time.
+   *
    * @note
    * Train() can be called multiple times with different sequences; each time it
    * is called, it uses the current parameters of the HMM as a starting point
@@ -177,7 +197,8 @@ class HMM
    * sequence vector.  For instance, dataSeq[0].col(3) corresponds to the fourth
    * observation in the first data sequence, and its state is stateSeq[0][3].
    * The number of rows in each matrix should be equal to the dimensionality of
-   * the HMM (which is set in the constructor).
+   * the HMM (which is set in the constructor).  The emission distributions of
+   * the states are fitted in parallel.
    *
    * @note
    * Train() can be called multiple times with different sequences; each time it
@@ -259,6 +280,32 @@ class HMM
   double Predict(const arma::mat& dataSeq,
                  arma::Row<size_t>& stateSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence of each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are decoded in
+   * parallel (when OpenMP is available); the model is only read, and each
+   * thread allocates its trellis once, for the longest sequence, and reuses
+   * it for all the sequences it decodes.
+   *
+   * If beamWidth is positive, beam pruning is used: at each time step, only
+   * the states whose log-probability is within beamWidth of the best state are
+   * extended to the next time step.  This makes each step cost O(B N) instead
+   * of O(N^2) for B surviving states, at the risk of missing the most probable
+   * sequence if the beam is too narrow.
+   *
+   * @param dataSeqs Sequences of observations.
+   * @param stateSeqs Vector in which the most probable state sequence of each
+   *    sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of the most
+   *    probable state sequence of each sequence will be stored.
+   * @param beamWidth Width of the beam, in log-probability; 0 disables
+   *    pruning.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeqs,
+               std::vector<arma::Row<size_t>>& stateSeqs,
+               arma::vec& logLikelihoods,
+               const double beamWidth = 0.0) const;
+
   /**
    * Compute the log-likelihood of the given data sequence.
    *
@@ -322,6 +369,11 @@ class HMM
   //! Modify the tolerance of the Baum-Welch algorithm.
   double& Tolerance() { return tolerance; }
 
+  //! Get whether the transition matrix is treated as sparse.
+  bool SparseTransition() const { return sparseTransition; }
+  //! Modify whether the transition matrix is treated as sparse.
+  bool& SparseTransition() { return sparseTransition; }
+
   /**
    * Serialize the object.
    */
@@ -374,6 +426,124 @@ class HMM
 
   //! Tolerance of Baum-Welch algorithm.
   double tolerance;
+
+  //! If true, only the nonzero transitions are used in Forward-Backward.
+  bool sparseTransition;
+
+  /**
+   * The Viterbi algorithm, given the logarithms of the transposed transition
+   * matrix and a trellis of the right size (one row per state, one column per
+   * observation) to work in.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param logTrans Logarithms of the transposed transition matrix.
+   * @param beamWidth Width of the beam; 0 disables pruning.
+   * @param logStateProb Trellis of log-probabilities.
+   * @param stateSeqBack Trellis of back-pointers.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @return Log-likelihood of most probable state sequence.
+   */
+  double Viterbi(const arma::mat& dataSeq,
+                 const arma::mat& logTrans,
+                 const double beamWidth,
+                 arma::mat& logStateProb,
+                 arma::Mat<size_t>& stateSeqBack,
+                 arma::Row<size_t>& stateSeq) const;
+
+  /**
+   * Compute the emission probabilities of each state for each observation in
+   * the given data sequence, rescaled so that the most likely state of each
+   * observation has probability 1.  The logarithms of the scaling factors are
+   * stored in logShifts, so emissionProb(i, t) * exp(logShifts[t]) is the
+   * actual emission probability.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionProb Matrix in which the rescaled emission probabilities
+   *     will be saved (one row per state, one column per observation).
+   * @param logShifts Vector in which the log-scaling factors will be saved.
+   */
+  void EmissionProbabilities(const arma::mat& dataSeq,
+                             arma::mat& emissionProb,
+                             arma::vec& logShifts) const;
+
+  /**
+   * The scaled Forward recursion, given the (rescaled) emission probabilities
+   * of a sequence and the transition matrix to use (either the transition
+   * matrix itself or a sparse copy of it).
+   *
+   * @param emissionProb Emission probabilities of each state and observation.
+   * @param transitionMat Transition matrix.
+   * @param scales Vector in which scaling factors will be saved.
+   * @param forwardProb Matrix in which forward probabilities will be saved.
+   */
+  template<typename MatType>
+  void ForwardScaled(const arma::mat& emissionProb,
+                     const MatType& transitionMat,
+                     arma::vec& scales,
+                     arma::mat& forwardProb) const;
+
+  /**
+   * The scaled Backward recursion, given the (rescaled) emission
+   * probabilities of a sequence, the transition matrix to use, and the scaling
+   * factors found by ForwardScaled() with the same emission probabilities.
+   *
+   * @param emissionProb Emission probabilities of each state and observation.
+   * @param transitionMat Transition matrix.
+   * @param scales Vector of scaling factors.
+   * @param backwardProb Matrix in which backward probabilities will be saved.
+   */
+  template<typename MatType>
+  void BackwardScaled(const arma::mat& emissionProb,
+                      const MatType& transitionMat,
+                      const arma::vec& scales,
+                      arma::mat& backwardProb) const;
+
+  /**
+   * Run the E-step of one Baum-Welch iteration over all the sequences in
+   * parallel, accumulating the statistics needed for the M-step.
+   *
+   * @param dataSeq Set of data sequences to train on.
+   * @param offsets Index of the first observation of each sequence in the
+   *     emission statistics.
+   * @param transitionMat Transition matrix (dense, or a sparse copy).
+   * @param newInitial Vector to add the initial state statistics to.
+   * @param transitionStats Vector to add the transition statistics to; see
+   *     TransitionStatistics().
+   * @param emissionProb Probability of each state for each observation.
+   * @return The log-likelihood of all the sequences.
+   */
+  template<typename MatType>
+  double BaumWelchStep(const std::vector<arma::mat>& dataSeq,
+                       const std::vector<size_t>& offsets,
+                       const MatType& transitionMat,
+                       arma::vec& newInitial,
+                       arma::vec& transitionStats,
+                       std::vector<arma::vec>& emissionProb) const;
+
+  /**
+   * Add the expected number of transitions from state j to state i of a
+   * sequence, sum_t forward(j, t) * weightedBackward(i, t), to the statistics.
+   * For a dense transition matrix, the statistics hold every (i, j) pair in
+   * column-major order; for a sparse one, they only hold the nonzero entries,
+   * in the order of the sparse matrix iterator.
+   *
+   * @param transitionMat Transition matrix.
+   * @param forward Forward probabilities of all but the last time step.
+   * @param weightedBackward Backward probabilities of all but the first time
+   *     step, multiplied by the emission probabilities and divided by the
+   *     scaling factors.
+   * @param stats Statistics to add to.
+   */
+  static void TransitionStatistics(const arma::mat& transitionMat,
+                                   const arma::mat& forward,
+                                   const arma::mat& weightedBackward,
+                                   arma::vec& stats);
+
+  static void TransitionStatistics(const arma::sp_mat& transitionMat,
+                                   const arma::mat& forward,
+                                   const arma::mat& weightedBackward,
+                                   arma::vec& stats);
 };
 
 } // namespace hmm
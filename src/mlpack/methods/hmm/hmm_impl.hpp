@@ -32,7 +32,8 @@ HMM<Distribution>::HMM(const size_t states,
     transition(arma::randu<arma::mat>(states, states)),
     initial(arma::randu<arma::vec>(states) / (double) states),
     dimensionality(emissions.Dimensionality()),
-    tolerance(tolerance)
+    tolerance(tolerance),
+    sparseTransition(false)
 {
   // Normalize the transition probabilities and initial state probabilities.
   initial /= arma::accu(initial);
@@ -52,7 +53,8 @@ HMM<Distribution>::HMM(const arma::vec& initial,
     emission(emission),
     transition(transition),
     initial(initial),
-    tolerance(tolerance)
+    tolerance(tolerance),
+    sparseTransition(false)
 {
   // Set the dimensionality, if we can.
   if (emission.size() > 0)
@@ -104,69 +106,65 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // themselves don't change between iterations, so the list of emission
+  // observations is only assembled once; each sequence owns a contiguous range
+  // of it, starting at its offset.
   std::vector<arma::vec> emissionProb(transition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+    {
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    }
+    sumTime += dataSeq[seq].n_cols;
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
   // Markov Models: Estimation and Control", pp. 36-40.
   for (size_t iter = 0; iter < iterations; iter++)
   {
-    // Clear new transition matrix and emission probabilities.
-    arma::vec newInitial(transition.n_rows);
-    newInitial.zeros();
-    arma::mat newTransition(transition.n_rows, transition.n_cols);
-    newTransition.zeros();
-
-    // Reset log likelihood.
-    loglik = 0;
-
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // Clear new initial probabilities and transition statistics.
+    arma::vec newInitial(transition.n_rows, arma::fill::zeros);
+    arma::mat newTransition(transition.n_rows, transition.n_cols,
+        arma::fill::zeros);
+
+    // Now re-estimate the parameters.  The E-step, which is run for all the
+    // sequences in parallel, computes the log-likelihood and the statistics
+    // for the M-step:
+    //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+    //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
+    //           t + 1)))
+    //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
+    // We postpone multiplication of the old T_ij until later.
+    if (sparseTransition)
     {
-      arma::mat stateProb;
-      arma::mat forward;
-      arma::mat backward;
-      arma::vec scales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += Estimate(dataSeq[seq], stateProb, forward, backward, scales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < transition.n_cols; ++j)
-        newInitial[j] += stateProb(j, 0);
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
-      {
-        for (size_t j = 0; j < transition.n_cols; ++j)
-        {
-          if (t < dataSeq[seq].n_cols - 1)
-          {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
-              newTransition(i, j) += forward(j, t) * backward(i, t + 1) *
-                  emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
-                  scales[t + 1];
-          }
-
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = stateProb(j, t);
-        }
-        sumTime++;
-      }
+      // The sparse copy of the transition matrix only has to be built once per
+      // iteration.
+      const arma::sp_mat sparseTrans(transition);
+      arma::vec transitionStats(sparseTrans.n_nonzero, arma::fill::zeros);
+      loglik = BaumWelchStep(dataSeq, offsets, sparseTrans, newInitial,
+          transitionStats, emissionProb);
+
+      size_t k = 0;
+      for (arma::sp_mat::const_iterator it = sparseTrans.begin();
+           it != sparseTrans.end(); ++it, ++k)
+        newTransition(it.row(), it.col()) = transitionStats[k];
+    }
+    else
+    {
+      arma::vec transitionStats(transition.n_elem, arma::fill::zeros);
+      loglik = BaumWelchStep(dataSeq, offsets, transition, newInitial,
+          transitionStats, emissionProb);
+      newTransition = arma::reshape(transitionStats, transition.n_rows,
+          transition.n_cols);
     }
 
     if (std::abs(oldLoglik - loglik) < tolerance)
@@ -199,9 +197,13 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
         transition.col(i).fill(1.0 / (double) transition.n_rows);
     }
 
-    // Now estimate emission probabilities.
-    for (size_t state = 0; state < transition.n_cols; state++)
+    // Now estimate emission probabilities.  Every state fits its own
+    // distribution on the shared list of observations, so the states are
+    // fitted in parallel.
+    Threads::ParallelFor(0, transition.n_cols, [&](const size_t state)
+    {
       emission[state].Train(emissionList, emissionProb[state]);
+    });
 
     Log::Debug << "Iteration " << iter << ": log-likelihood " << loglik
         << "." << std::endl;
@@ -278,8 +280,9 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq,
       transition.col(col) /= sum;
   }
 
-  // Estimate emission matrix.
-  for (size_t state = 0; state < transition.n_cols; state++)
+  // Estimate emission matrix.  The distributions of the states are fitted in
+  // parallel.
+  Threads::ParallelFor(0, transition.n_cols, [&](const size_t state)
   {
     // Generate full sequence of observations for this state from the list of
     // emissions that are from this state.
@@ -294,7 +297,11 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq,
 
       emission[state].Train(emissions);
     }
-    else
+  });
+
+  for (size_t state = 0; state < transition.n_cols; state++)
+  {
+    if (emissionList[state].size() == 0)
     {
       Log::Warn << "There are no observations in training data with hidden "
           << "state " << state << "!  The corresponding emission distribution "
@@ -315,15 +322,31 @@ double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
                                    arma::vec& scales) const
 {
   // First run the forward-backward algorithm.
-  Forward(dataSeq, scales, forwardProb);
-  Backward(dataSeq, scales, backwardProb);
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  EmissionProbabilities(dataSeq, emissionProb, logShifts);
+  if (sparseTransition)
+  {
+    const arma::sp_mat sparseTrans(transition);
+    ForwardScaled(emissionProb, sparseTrans, scales, forwardProb);
+    BackwardScaled(emissionProb, sparseTrans, scales, backwardProb);
+  }
+  else
+  {
+    ForwardScaled(emissionProb, transition, scales, forwardProb);
+    BackwardScaled(emissionProb, transition, scales, backwardProb);
+  }
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
   stateProb = forwardProb % backwardProb;
 
-  // Finally assemble the log-likelihood and return it.
-  return accu(log(scales));
+  // Finally assemble the log-likelihood and return it.  The scaling factors
+  // were computed with the rescaled emission probabilities, so the
+  // rescaling is added back in.
+  const double loglik = accu(log(scales)) + accu(logShifts);
+  scales = arma::exp(arma::log(scales) + logShifts);
+  return loglik;
 }
 
 /**
@@ -399,42 +422,132 @@ template<typename Distribution>
 double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
-  // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
-  stateSeq.set_size(dataSeq.n_cols);
-  arma::mat logStateProb(transition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(transition.n_rows, dataSeq.n_cols);
-
   // Store the logs of the transposed transition matrix.  This is because we
   // will be using the rows of the transition matrix.
-  arma::mat logTrans(log(trans(transition)));
+  const arma::mat logTrans(log(trans(transition)));
+  arma::mat logStateProb(transition.n_rows, dataSeq.n_cols);
+  arma::Mat<size_t> stateSeqBack(transition.n_rows, dataSeq.n_cols);
+
+  return Viterbi(dataSeq, logTrans, 0.0, logStateProb, stateSeqBack, stateSeq);
+}
+
+/**
+ * Compute the most probable hidden state sequence of each of the given
+ * observation sequences, in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeqs,
+                                std::vector<arma::Row<size_t>>& stateSeqs,
+                                arma::vec& logLikelihoods,
+                                const double beamWidth) const
+{
+  stateSeqs.resize(dataSeqs.size());
+  logLikelihoods.zeros(dataSeqs.size());
+
+  // The model is shared by all threads, so this only has to be computed once.
+  const arma::mat logTrans(log(trans(transition)));
+
+  size_t maxLength = 0;
+  for (size_t seq = 0; seq < dataSeqs.size(); ++seq)
+    maxLength = std::max(maxLength, (size_t) dataSeqs[seq].n_cols);
+
+  #pragma omp parallel
+  {
+    // The trellis of this thread, large enough for every sequence; each
+    // sequence works in an alias of its first columns.
+    arma::mat logStateProbBuffer(transition.n_rows, maxLength);
+    arma::Mat<size_t> stateSeqBackBuffer(transition.n_rows, maxLength);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t seq = 0; seq < (omp_size_t) dataSeqs.size(); ++seq)
+    {
+      const size_t length = dataSeqs[seq].n_cols;
+      if (length == 0)
+      {
+        stateSeqs[seq].reset();
+        continue;
+      }
+
+      arma::mat logStateProb(logStateProbBuffer.memptr(), transition.n_rows,
+          length, false, true);
+      arma::Mat<size_t> stateSeqBack(stateSeqBackBuffer.memptr(),
+          transition.n_rows, length, false, true);
+
+      logLikelihoods[seq] = Viterbi(dataSeqs[seq], logTrans, beamWidth,
+          logStateProb, stateSeqBack, stateSeqs[seq]);
+    }
+  }
+}
+
+template<typename Distribution>
+double HMM<Distribution>::Viterbi(const arma::mat& dataSeq,
+                                  const arma::mat& logTrans,
+                                  const double beamWidth,
+                                  arma::mat& logStateProb,
+                                  arma::Mat<size_t>& stateSeqBack,
+                                  arma::Row<size_t>& stateSeq) const
+{
+  // This is an implementation of the Viterbi algorithm for finding the most
+  // probable sequence of states to produce the observed data sequence.
+  stateSeq.set_size(dataSeq.n_cols);
 
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
-  logStateProb.col(0).zeros();
   for (size_t state = 0; state < transition.n_rows; state++)
   {
-    logStateProb(state, 0) = log(initial[state] *
-        emission[state].Probability(dataSeq.unsafe_col(0)));
+    logStateProb(state, 0) = log(initial[state]) +
+        emission[state].LogProbability(dataSeq.unsafe_col(0));
     stateSeqBack(state, 0) = state;
   }
 
+  // The states that are extended to the next time step.  Without pruning,
+  // these are all the states.
+  std::vector<size_t> active;
+  active.reserve(transition.n_rows);
+
   // Store the best first state.
   arma::uword index;
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
+    if (beamWidth > 0.0)
+    {
+      const double threshold = logStateProb.col(t - 1).max() - beamWidth;
+      active.clear();
+      for (size_t i = 0; i < transition.n_rows; i++)
+        if (logStateProb(i, t - 1) >= threshold)
+          active.push_back(i);
+    }
+
     // Assemble the state probability for this element.
     // Given that we are in state j, we use state with the highest probability
     // of being the previous state.
     for (size_t j = 0; j < transition.n_rows; j++)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          log(emission[j].Probability(dataSeq.unsafe_col(t)));
-        stateSeqBack(j, t) = index;
+      double bestLogProb = -std::numeric_limits<double>::infinity();
+      if (beamWidth > 0.0)
+      {
+        index = active[0];
+        for (size_t a = 0; a < active.size(); a++)
+        {
+          const double logProb = logStateProb(active[a], t - 1) +
+              logTrans(active[a], j);
+          if (logProb > bestLogProb)
+          {
+            bestLogProb = logProb;
+            index = active[a];
+          }
+        }
+      }
+      else
+      {
+        const arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
+        bestLogProb = prob.max(index);
+      }
+
+      logStateProb(j, t) = bestLogProb +
+          emission[j].LogProbability(dataSeq.unsafe_col(t));
+      stateSeqBack(j, t) = index;
     }
   }
 
@@ -454,13 +567,18 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 template<typename Distribution>
 double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
 {
-  arma::mat forward;
-  arma::vec scales;
+  arma::mat emissionProb, forward;
+  arma::vec logShifts, scales;
 
-  Forward(dataSeq, scales, forward);
+  EmissionProbabilities(dataSeq, emissionProb, logShifts);
+  if (sparseTransition)
+    ForwardScaled(emissionProb, arma::sp_mat(transition), scales, forward);
+  else
+    ForwardScaled(emissionProb, transition, scales, forward);
 
-  // The log-likelihood is the log of the scales for each time step.
-  return accu(log(scales));
+  // The log-likelihood is the log of the scales for each time step (plus the
+  // rescaling of the emission probabilities).
+  return accu(log(scales)) + accu(logShifts);
 }
 
 /**
@@ -512,20 +630,87 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& scales,
                                 arma::mat& forwardProb) const
+{
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  EmissionProbabilities(dataSeq, emissionProb, logShifts);
+
+  if (sparseTransition)
+    ForwardScaled(emissionProb, arma::sp_mat(transition), scales, forwardProb);
+  else
+    ForwardScaled(emissionProb, transition, scales, forwardProb);
+
+  // Undo the rescaling of the emission probabilities.
+  scales = arma::exp(arma::log(scales) + logShifts);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& scales,
+                                 arma::mat& backwardProb) const
+{
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  EmissionProbabilities(dataSeq, emissionProb, logShifts);
+
+  // The scaling factors must be rescaled the same way as the emission
+  // probabilities.
+  const arma::vec rescaledScales = arma::exp(arma::log(scales) - logShifts);
+
+  if (sparseTransition)
+  {
+    BackwardScaled(emissionProb, arma::sp_mat(transition), rescaledScales,
+        backwardProb);
+  }
+  else
+  {
+    BackwardScaled(emissionProb, transition, rescaledScales, backwardProb);
+  }
+}
+
+template<typename Distribution>
+void HMM<Distribution>::EmissionProbabilities(const arma::mat& dataSeq,
+                                              arma::mat& emissionProb,
+                                              arma::vec& logShifts) const
+{
+  emissionProb.set_size(transition.n_rows, dataSeq.n_cols);
+  logShifts.set_size(dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+  {
+    for (size_t state = 0; state < transition.n_rows; state++)
+    {
+      emissionProb(state, t) =
+          emission[state].LogProbability(dataSeq.unsafe_col(t));
+    }
+
+    // Rescale so that the largest emission probability is 1.  If no state can
+    // emit this observation, there is nothing to rescale.
+    logShifts[t] = emissionProb.col(t).max();
+    if (logShifts[t] == -std::numeric_limits<double>::infinity())
+      logShifts[t] = 0.0;
+
+    emissionProb.col(t) = arma::exp(emissionProb.col(t) - logShifts[t]);
+  }
+}
+
+template<typename Distribution>
+template<typename MatType>
+void HMM<Distribution>::ForwardScaled(const arma::mat& emissionProb,
+                                      const MatType& transitionMat,
+                                      arma::vec& scales,
+                                      arma::mat& forwardProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardProb.zeros(transition.n_rows, dataSeq.n_cols);
-  scales.zeros(dataSeq.n_cols);
+  forwardProb.zeros(transition.n_rows, emissionProb.n_cols);
+  scales.zeros(emissionProb.n_cols);
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < transition.n_rows; state++)
-    forwardProb(state, 0) = initial(state) *
-        emission[state].Probability(dataSeq.unsafe_col(0));
+  forwardProb.col(0) = initial % emissionProb.col(0);
 
   // Then normalize the column.
   scales[0] = accu(forwardProb.col(0));
@@ -533,17 +718,14 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
     forwardProb.col(0) /= scales[0];
 
   // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  for (size_t t = 1; t < emissionProb.n_cols; t++)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      forwardProb(j, t) = accu(forwardProb.col(t - 1) %
-          trans(transition.row(j))) *
-          emission[j].Probability(dataSeq.unsafe_col(t));
-    }
+    // The forward probability of state j at time t is the sum over all states
+    // of the probability of the previous state transitioning to the current
+    // state and emitting the given observation.  For a sparse transition
+    // matrix, the product only visits the allowed transitions.
+    forwardProb.col(t) = (transitionMat * forwardProb.unsafe_col(t - 1)) %
+        emissionProb.col(t);
 
     // Normalize probability.
     scales[t] = accu(forwardProb.col(t));
@@ -553,34 +735,132 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
 }
 
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& scales,
-                                 arma::mat& backwardProb) const
+template<typename MatType>
+void HMM<Distribution>::BackwardScaled(const arma::mat& emissionProb,
+                                       const MatType& transitionMat,
+                                       const arma::vec& scales,
+                                       arma::mat& backwardProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardProb.zeros(transition.n_rows, dataSeq.n_cols);
+  backwardProb.zeros(transition.n_rows, emissionProb.n_cols);
 
   // The last element probability is 1.
-  backwardProb.col(dataSeq.n_cols - 1).fill(1);
+  backwardProb.col(emissionProb.n_cols - 1).fill(1);
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  for (size_t t = emissionProb.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
+    // The backward probability of state j at time t is the sum over all state
+    // of the probability of the next state having been a transition from the
+    // current state multiplied by the probability of each of those states
+    // emitting the given observation.
+    const arma::vec nextProb = backwardProb.col(t + 1) %
+        emissionProb.col(t + 1);
+    backwardProb.col(t) = (nextProb.t() * transitionMat).t();
+
+    // Normalize by the weights from the forward algorithm.
+    if (scales[t + 1] > 0.0)
+      backwardProb.col(t) /= scales[t + 1];
+  }
+}
+
+template<typename Distribution>
+template<typename MatType>
+double HMM<Distribution>::BaumWelchStep(
+    const std::vector<arma::mat>& dataSeq,
+    const std::vector<size_t>& offsets,
+    const MatType& transitionMat,
+    arma::vec& newInitial,
+    arma::vec& transitionStats,
+    std::vector<arma::vec>& emissionProb) const
+{
+  double loglik = 0.0;
+
+  #pragma omp parallel reduction(+:loglik)
+  {
+    // The statistics of the sequences of this thread.
+    arma::vec localInitial(newInitial.n_elem, arma::fill::zeros);
+    arma::vec localStats(transitionStats.n_elem, arma::fill::zeros);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
     {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-        backwardProb(j, t) += transition(state, j) * backwardProb(state, t + 1)
-            * emission[state].Probability(dataSeq.unsafe_col(t + 1));
-
-      // Normalize by the weights from the forward algorithm.
-      if (scales[t + 1] > 0.0)
-        backwardProb(j, t) /= scales[t + 1];
+      const size_t length = dataSeq[seq].n_cols;
+
+      arma::mat seqEmissionProb, forward, backward;
+      arma::vec scales, logShifts;
+
+      // Add the log-likelihood of this sequence.  This is the E-step.
+      EmissionProbabilities(dataSeq[seq], seqEmissionProb, logShifts);
+      ForwardScaled(seqEmissionProb, transitionMat, scales, forward);
+      BackwardScaled(seqEmissionProb, transitionMat, scales, backward);
+      loglik += accu(log(scales)) + accu(logShifts);
+
+      const arma::mat stateProb = forward % backward;
+
+      // Add to estimate of initial probability for state j.
+      localInitial += stateProb.col(0);
+
+      // Estimate of T_ij (probability of transition from state j to state i).
+      if (length > 1)
+      {
+        arma::mat weightedBackward = backward.cols(1, length - 1) %
+            seqEmissionProb.cols(1, length - 1);
+        weightedBackward.each_row() /= scales.subvec(1, length - 1).t();
+        TransitionStatistics(transitionMat, forward.cols(0, length - 2),
+            weightedBackward, localStats);
+      }
+
+      // Store the state probabilities of each observation, for
+      // Distribution::Train().  Each sequence writes to its own range.
+      for (size_t j = 0; j < transition.n_cols; ++j)
+      {
+        emissionProb[j].subvec(offsets[seq], offsets[seq] + length - 1) =
+            stateProb.row(j).t();
+      }
     }
+
+    #pragma omp critical
+    {
+      newInitial += localInitial;
+      transitionStats += localStats;
+    }
+  }
+
+  return loglik;
+}
+
+template<typename Distribution>
+void HMM<Distribution>::TransitionStatistics(const arma::mat& transitionMat,
+                                             const arma::mat& forward,
+                                             const arma::mat& weightedBackward,
+                                             arma::vec& stats)
+{
+  // The statistics of every pair of states are the product of the two
+  // matrices; view the statistics as a matrix to add it in place.
+  arma::mat statsMat(stats.memptr(), transitionMat.n_rows,
+      transitionMat.n_cols, false, true);
+  statsMat += weightedBackward * forward.t();
+}
+
+template<typename Distribution>
+void HMM<Distribution>::TransitionStatistics(const arma::sp_mat& transitionMat,
+                                             const arma::mat& forward,
+                                             const arma::mat& weightedBackward,
+                                             arma::vec& stats)
+{
+  // Only the allowed transitions are needed.  Transpose first so that the
+  // statistics of each transition are a dot product of two contiguous columns.
+  const arma::mat forwardTrans = forward.t();
+  const arma::mat backwardTrans = weightedBackward.t();
+
+  size_t k = 0;
+  for (arma::sp_mat::const_iterator it = transitionMat.begin();
+       it != transitionMat.end(); ++it, ++k)
+  {
+    stats[k] += arma::dot(backwardTrans.unsafe_col(it.row()),
+        forwardTrans.unsafe_col(it.col()));
   }
 }
 
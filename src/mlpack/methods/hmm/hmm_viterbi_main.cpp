@@ -35,6 +35,15 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Viterbi State Prediction", "This "
     "computed state sequence may be saved using the " +
     PRINT_PARAM_STRING("output") + " output parameter."
     "\n\n"
+    "Many sequences can be decoded at once (and in parallel) by concatenating "
+    "them in the " + PRINT_PARAM_STRING("input") + " matrix and giving the "
+    "length of each one with the " + PRINT_PARAM_STRING("lengths") + " "
+    "parameter; the predicted state sequences are then concatenated in the "
+    "same way.  For large numbers of states, the " +
+    PRINT_PARAM_STRING("beam_width") + " parameter can be used to only extend "
+    "states whose log-probability is within the given width of the best state "
+    "at each time step."
+    "\n\n"
     "For example, to predict the state sequence of the observations " +
     PRINT_DATASET("obs") + " using the HMM " + PRINT_MODEL("hmm") + ", "
     "storing the predicted state sequence to " + PRINT_DATASET("states") +
@@ -46,6 +55,10 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Viterbi State Prediction", "This "
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
+PARAM_UCOL_IN("lengths", "Lengths of the sequences concatenated in the input "
+    "matrix, if more than one sequence is given.", "l");
+PARAM_DOUBLE_IN("beam_width", "Width of the beam (in log-probability) for "
+    "beam pruning; 0 disables pruning.", "b", 0.0);
 
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
@@ -73,17 +86,63 @@ struct Viterbi
           << hmm.Emission()[0].Dimensionality() << ")!" << endl;
     }
 
-    arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    const double beamWidth = CLI::GetParam<double>("beam_width");
+    if (!CLI::HasParam("lengths") && beamWidth == 0.0)
+    {
+      arma::Row<size_t> sequence;
+      hmm.Predict(dataSeq, sequence);
+
+      // Save output.
+      CLI::GetParam<arma::Mat<size_t>>("output") = std::move(sequence);
+      return;
+    }
+
+    // Split the input into its sequences.
+    arma::Col<size_t> lengths;
+    if (CLI::HasParam("lengths"))
+      lengths = std::move(CLI::GetParam<arma::Col<size_t>>("lengths"));
+    else
+      lengths = { (size_t) dataSeq.n_cols };
+
+    if (arma::accu(lengths) != dataSeq.n_cols)
+    {
+      Log::Fatal << "Sum of sequence lengths (" << arma::accu(lengths) << ") "
+          << "does not match the number of observations (" << dataSeq.n_cols
+          << ")!" << endl;
+    }
+
+    vector<mat> dataSeqs(lengths.n_elem);
+    size_t begin = 0;
+    for (size_t i = 0; i < lengths.n_elem; ++i)
+    {
+      if (lengths[i] > 0)
+        dataSeqs[i] = dataSeq.cols(begin, begin + lengths[i] - 1);
+      begin += lengths[i];
+    }
+
+    vector<arma::Row<size_t>> sequences;
+    arma::vec logLikelihoods;
+    hmm.Predict(dataSeqs, sequences, logLikelihoods, beamWidth);
+
+    // Save output, with the sequences concatenated in the same order.
+    arma::Mat<size_t> output(1, dataSeq.n_cols);
+    begin = 0;
+    for (size_t i = 0; i < sequences.size(); ++i)
+    {
+      if (lengths[i] > 0)
+        output.cols(begin, begin + lengths[i] - 1) = sequences[i];
+      begin += lengths[i];
+    }
 
-    // Save output.
-    CLI::GetParam<arma::Mat<size_t>>("output") = std::move(sequence);
+    CLI::GetParam<arma::Mat<size_t>>("output") = std::move(output);
   }
 };
 
 static void mlpackMain()
 {
   RequireAtLeastOnePassed({ "output" }, false, "no results will be saved");
+  RequireParamValue<double>("beam_width", [](double x) { return x >= 0.0; },
+      true, "beam width must be non-negative");
 
   CLI::GetParam<HMMModel*>("input_model")->PerformAction<Viterbi>((void*) NULL);
 }
@@ -0,0 +1,316 @@
+/**
+ * @file hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which answers approximate nearest neighbor
+ * queries with a hierarchical navigable small world graph.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @article{malkov2018efficient,
+ *  title={Efficient and robust approximate nearest neighbor search using
+ *  hierarchical navigable small world graphs},
+ *  author={Malkov, Yu A. and Yashunin, Dmitry A.},
+ *  journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *  volume={42},
+ *  number={4},
+ *  pages={824--836},
+ *  year={2018}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <memory>
+#include <mutex>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world (HNSW)
+ * graph on the reference set and uses it to find the approximate nearest
+ * neighbors of the given queries.  Every point is linked to (roughly) its
+ * nearest neighbors on a random number of levels; the upper levels hold
+ * exponentially fewer points, so a search descends greedily through them and
+ * then runs a beam search on the bottom level, which holds every point.
+ *
+ * The graph is built in parallel, and points can be added later with
+ * Insert().  The width of the search beam trades the recall of Search() for
+ * its speed and can be changed at any time with BeamWidth().  Search() does not
+ * modify the index, so it may be called concurrently.
+ *
+ * @code
+ * HNSWSearch<> hnsw(std::move(referenceSet));
+ *
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * hnsw.Search(queries, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  //! The type of the elements of the data matrix.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Build the graph on the given reference set.
+   *
+   * @param referenceSet Set of reference points (this is taken by the index).
+   * @param maxDegree Maximum number of links of a point on every level but the
+   *     bottom one, which allows twice as many.
+   * @param constructionBeam Width of the beam used to find the links of a new
+   *     point.
+   * @param beamWidth Width of the beam used by Search().
+   * @param metric An optional instance of the metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t maxDegree = 16,
+             const size_t constructionBeam = 200,
+             const size_t beamWidth = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Create an empty index; points may be added with Insert() or Train(), or
+   * the index may be loaded with LoadIndex().
+   *
+   * @param maxDegree Maximum number of links of a point on every level but the
+   *     bottom one, which allows twice as many.
+   * @param constructionBeam Width of the beam used to find the links of a new
+   *     point.
+   * @param beamWidth Width of the beam used by Search().
+   * @param metric An optional instance of the metric.
+   */
+  HNSWSearch(const size_t maxDegree = 16,
+             const size_t constructionBeam = 200,
+             const size_t beamWidth = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Discard the graph and build a new one on the given reference set.
+   *
+   * @param referenceSet Set of reference points (this is taken by the index).
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Add the given points to the index.  They get the indices following the
+   * current reference points, and are linked into the graph in parallel.
+   *
+   * @param points The points to add.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the given query
+   * set.  The beam of the search is at least k points wide.  If fewer than k
+   * points are reached (which may only happen if the graph is disconnected),
+   * the remaining neighbors are set to size_t() - 1, with distance DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Compute the approximate nearest neighbors of every point in the reference
+   * set; a point is not returned as its own neighbor.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Save the index to a file.  Like NeighborSearch::SaveIndex(), the file
+   * holds a small header, the serialized graph, and the reference points as
+   * one raw column-major block, in the byte order and floating point format of
+   * this machine.
+   *
+   * @param filename Name of the file to save the index to.
+   * @param fatal If an error should be reported as fatal (default false).
+   * @return Boolean value indicating success or failure of save.
+   */
+  bool SaveIndex(const std::string& filename, const bool fatal = false) const;
+
+  /**
+   * Load an index that was saved with SaveIndex().  The file is mapped into
+   * memory and the reference set points into the mapping, so the reference
+   * points are read lazily as they are touched, and processes that load the
+   * same file share its pages.
+   *
+   * @param filename Name of the file to load the index from.
+   * @param fatal If an error should be reported as fatal (default false).
+   * @return Boolean value indicating success or failure of load.
+   */
+  bool LoadIndex(const std::string& filename, const bool fatal = false);
+
+  //! Get the reference set.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the maximum number of links of a point on the upper levels.
+  size_t MaxDegree() const { return maxDegree; }
+
+  //! Get the width of the beam used to link new points.
+  size_t ConstructionBeam() const { return constructionBeam; }
+  //! Modify the width of the beam used to link new points.
+  size_t& ConstructionBeam() { return constructionBeam; }
+
+  //! Get the width of the beam used by Search().
+  size_t BeamWidth() const { return beamWidth; }
+  //! Modify the width of the beam used by Search().
+  size_t& BeamWidth() { return beamWidth; }
+
+  //! Get the number of levels of the graph.
+  size_t Levels() const { return graph.empty() ? 0 : maxLevel + 1; }
+
+  //! Get the links of the given point on the given level.
+  const std::vector<size_t>& Links(const size_t point, const size_t level)
+      const { return graph[point][level]; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+
+  //! Serialize the index.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A point reached by a search, with its distance.
+  typedef std::pair<double, size_t> Candidate;
+
+  //! The reference points.
+  MatType referenceSet;
+  //! The maximum number of links of a point on the upper levels.
+  size_t maxDegree;
+  //! The width of the beam used to link new points.
+  size_t constructionBeam;
+  //! The width of the beam used by Search().
+  size_t beamWidth;
+  //! The metric.
+  MetricType metric;
+
+  //! The links of every point on every level it belongs to.
+  std::vector<std::vector<std::vector<size_t>>> graph;
+  //! The point the searches start from; it belongs to the top level.
+  size_t entryPoint;
+  //! The top level of the graph.
+  size_t maxLevel;
+
+  //! The lock of every point while the graph is built, or NULL.
+  std::unique_ptr<std::mutex[]> locks;
+
+  //! The mapped file the reference set points into, if loaded by LoadIndex().
+  data::MappedFile mappedReferences;
+
+  //! Get the maximum number of links of a point on the given level.
+  size_t MaxLinks(const size_t level) const
+  { return (level == 0) ? 2 * maxDegree : maxDegree; }
+
+  //! Draw the top level of a new point.
+  size_t RandomLevel() const;
+
+  //! Link the reference points from the given one onwards into the graph.
+  void Build(const size_t first);
+
+  //! Link the given point into the graph.
+  void InsertPoint(const size_t point, std::mutex& entryLock);
+
+  /**
+   * Add links from the given point to the given targets on the given level,
+   * and prune the links of the point with SelectNeighbors() if there are too
+   * many.
+   */
+  void Link(const size_t point,
+            const std::vector<size_t>& targets,
+            const size_t level,
+            MetricType& localMetric);
+
+  //! Copy the links of the given point on the given level.
+  std::vector<size_t> CopyLinks(const size_t point, const size_t level) const;
+
+  /**
+   * Search the given level of the graph from the given entry points with a
+   * beam of the given width, and return the points of the final beam, nearest
+   * first.
+   */
+  template<typename VecType>
+  std::vector<Candidate> SearchLevel(const VecType& point,
+                                     const std::vector<Candidate>& entries,
+                                     const size_t beam,
+                                     const size_t level,
+                                     MetricType& localMetric) const;
+
+  /**
+   * Descend greedily from the entry point down to the given level, and return
+   * the point reached.
+   */
+  template<typename VecType>
+  std::vector<Candidate> Descend(const VecType& point,
+                                 const size_t entry,
+                                 const size_t topLevel,
+                                 const size_t level,
+                                 MetricType& localMetric) const;
+
+  /**
+   * Keep at most the given number of the given candidates (sorted nearest
+   * first): a candidate is kept only if it is nearer to the point than to
+   * every candidate kept before it, so that the links point in different
+   * directions.  If fewer candidates pass, the nearest rejected ones fill up
+   * the rest.
+   */
+  void SelectNeighbors(std::vector<Candidate>& candidates,
+                       const size_t count,
+                       MetricType& localMetric) const;
+
+  //! Search for the neighbors of the given points, maybe skipping themselves.
+  void SearchPoints(const MatType& querySet,
+                    const size_t k,
+                    arma::Mat<size_t>& neighbors,
+                    arma::mat& distances,
+                    const bool skipSelf) const;
+
+  //! Serialize everything but the reference set.
+  template<typename Archive>
+  void SerializeGraph(Archive& ar);
+
+  /**
+   * Report an error of SaveIndex() or LoadIndex().
+   *
+   * @param message The error message.
+   * @param fatal If the error should be reported as fatal.
+   * @return Always false.
+   */
+  static bool IndexError(const std::string& message, const bool fatal);
+}; // class HNSWSearch
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
@@ -0,0 +1,627 @@
+/**
+ * @file hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <sstream>
+#include <unordered_set>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSet,
+                                            const size_t maxDegree,
+                                            const size_t constructionBeam,
+                                            const size_t beamWidth,
+                                            const MetricType metric) :
+    HNSWSearch(maxDegree, constructionBeam, beamWidth, metric)
+{
+  Train(std::move(referenceSet));
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const size_t maxDegree,
+                                            const size_t constructionBeam,
+                                            const size_t beamWidth,
+                                            const MetricType metric) :
+    maxDegree(maxDegree),
+    constructionBeam(constructionBeam),
+    beamWidth(beamWidth),
+    metric(metric),
+    entryPoint(0),
+    maxLevel(0)
+{
+  if (maxDegree < 2)
+    throw std::invalid_argument("HNSWSearch: the maximum degree must be at "
+        "least 2");
+  if (constructionBeam == 0)
+    throw std::invalid_argument("HNSWSearch: the construction beam must be "
+        "positive");
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSetIn)
+{
+  referenceSet = std::move(referenceSetIn);
+  mappedReferences = data::MappedFile();
+  graph.clear();
+  entryPoint = 0;
+  maxLevel = 0;
+
+  Build(0);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Insert(const MatType& points)
+{
+  if (points.n_cols == 0)
+    return;
+
+  const size_t first = referenceSet.n_cols;
+  if (first == 0)
+  {
+    referenceSet = points;
+  }
+  else
+  {
+    if (points.n_rows != referenceSet.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "HNSWSearch::Insert(): dimensionality of points ("
+          << points.n_rows << ") is not equal to the dimensionality of the "
+          << "reference set (" << referenceSet.n_rows << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    // The reference set is reallocated, so it no longer needs the mapping.
+    referenceSet.insert_cols(first, points);
+  }
+  mappedReferences = data::MappedFile();
+
+  Build(first);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  SearchPoints(querySet, k, neighbors, distances, false);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  if (k >= referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points (and a point is not its own neighbor)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  SearchPoints(referenceSet, k, neighbors, distances, true);
+}
+
+template<typename MetricType, typename MatType>
+size_t HNSWSearch<MetricType, MatType>::RandomLevel() const
+{
+  // The levels are distributed geometrically, so that every level holds about
+  // 1 / maxDegree of the points of the level below it.
+  const double u = math::Random();
+  return (size_t) std::floor(-std::log(1.0 - u) /
+      std::log((double) maxDegree));
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Build(const size_t first)
+{
+  const size_t n = referenceSet.n_cols;
+  if (first >= n)
+    return;
+
+  // The levels are drawn up front and serially, so the random number
+  // generator is not shared between threads, and the lists of links of every
+  // point exist before any point is linked.
+  graph.resize(n);
+  for (size_t i = first; i < n; ++i)
+    graph[i].resize(RandomLevel() + 1);
+
+  locks.reset(new std::mutex[n]);
+  std::mutex entryLock;
+
+  // An empty graph starts with the first point; the first few points are
+  // linked serially, so that the threads do not start on an empty graph.
+  size_t begin = first;
+  if (first == 0)
+  {
+    entryPoint = 0;
+    maxLevel = graph[0].size() - 1;
+    begin = std::min(n, size_t(4 * maxDegree));
+    for (size_t i = 1; i < begin; ++i)
+      InsertPoint(i, entryLock);
+  }
+
+  Threads::ParallelFor(begin, n, [&](const size_t i)
+  {
+    InsertPoint(i, entryLock);
+  });
+
+  locks.reset();
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::InsertPoint(const size_t point,
+                                                  std::mutex& entryLock)
+{
+  MetricType pointMetric(metric);
+  const size_t level = graph[point].size() - 1;
+
+  size_t entry, topLevel;
+  {
+    std::lock_guard<std::mutex> guard(entryLock);
+    entry = entryPoint;
+    topLevel = maxLevel;
+  }
+
+  const auto vec = referenceSet.unsafe_col(point);
+  std::vector<Candidate> entries = Descend(vec, entry, topLevel, level,
+      pointMetric);
+
+  for (size_t l = std::min(level, topLevel) + 1; l-- > 0; )
+  {
+    entries = SearchLevel(vec, entries, constructionBeam, l, pointMetric);
+
+    // Other threads may already have linked the point on this level, so the
+    // search may reach the point itself.
+    std::vector<Candidate> selected;
+    for (size_t i = 0; i < entries.size(); ++i)
+      if (entries[i].second != point)
+        selected.push_back(entries[i]);
+    SelectNeighbors(selected, maxDegree, pointMetric);
+
+    // Link the point to its neighbors and the neighbors back to the point.
+    std::vector<size_t> neighbors(selected.size());
+    for (size_t i = 0; i < selected.size(); ++i)
+      neighbors[i] = selected[i].second;
+    Link(point, neighbors, l, pointMetric);
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      Link(neighbors[i], std::vector<size_t>(1, point), l, pointMetric);
+  }
+
+  if (level > topLevel)
+  {
+    std::lock_guard<std::mutex> guard(entryLock);
+    if (level > maxLevel)
+    {
+      maxLevel = level;
+      entryPoint = point;
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Link(const size_t point,
+                                           const std::vector<size_t>& targets,
+                                           const size_t level,
+                                           MetricType& localMetric)
+{
+  std::lock_guard<std::mutex> guard(locks[point]);
+  std::vector<size_t>& links = graph[point][level];
+  for (size_t i = 0; i < targets.size(); ++i)
+  {
+    // Another thread may have linked the point to the same target already.
+    if (std::find(links.begin(), links.end(), targets[i]) == links.end())
+      links.push_back(targets[i]);
+  }
+
+  if (links.size() <= MaxLinks(level))
+    return;
+
+  // Keep the links that the heuristic selects among all of them.
+  std::vector<Candidate> candidates;
+  candidates.reserve(links.size());
+  for (size_t i = 0; i < links.size(); ++i)
+  {
+    candidates.push_back(Candidate(localMetric.Evaluate(
+        referenceSet.unsafe_col(point), referenceSet.unsafe_col(links[i])),
+        links[i]));
+  }
+  std::sort(candidates.begin(), candidates.end());
+  SelectNeighbors(candidates, MaxLinks(level), localMetric);
+
+  links.clear();
+  for (size_t i = 0; i < candidates.size(); ++i)
+    links.push_back(candidates[i].second);
+}
+
+template<typename MetricType, typename MatType>
+std::vector<size_t> HNSWSearch<MetricType, MatType>::CopyLinks(
+    const size_t point,
+    const size_t level) const
+{
+  // The links are only modified while the graph is built.
+  if (!locks)
+    return graph[point][level];
+
+  std::lock_guard<std::mutex> guard(locks[point]);
+  return graph[point][level];
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+std::vector<typename HNSWSearch<MetricType, MatType>::Candidate>
+HNSWSearch<MetricType, MatType>::SearchLevel(
+    const VecType& point,
+    const std::vector<Candidate>& entries,
+    const size_t beam,
+    const size_t level,
+    MetricType& localMetric) const
+{
+  // The candidates to expand, nearest first, and the beam, farthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> candidates;
+  std::priority_queue<Candidate> results;
+  std::unordered_set<size_t> visited;
+
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    visited.insert(entries[i].second);
+    candidates.push(entries[i]);
+    results.push(entries[i]);
+    if (results.size() > beam)
+      results.pop();
+  }
+
+  while (!candidates.empty())
+  {
+    const Candidate current = candidates.top();
+    if (current.first > results.top().first)
+      break;
+    candidates.pop();
+
+    const std::vector<size_t> links = CopyLinks(current.second, level);
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+      if (!visited.insert(links[i]).second)
+        continue;
+
+      const double distance = localMetric.Evaluate(point,
+          referenceSet.unsafe_col(links[i]));
+      if (results.size() < beam || distance < results.top().first)
+      {
+        candidates.push(Candidate(distance, links[i]));
+        results.push(Candidate(distance, links[i]));
+        if (results.size() > beam)
+          results.pop();
+      }
+    }
+  }
+
+  std::vector<Candidate> beamPoints(results.size());
+  for (size_t i = beamPoints.size(); i-- > 0; )
+  {
+    beamPoints[i] = results.top();
+    results.pop();
+  }
+
+  return beamPoints;
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+std::vector<typename HNSWSearch<MetricType, MatType>::Candidate>
+HNSWSearch<MetricType, MatType>::Descend(
+    const VecType& point,
+    const size_t entry,
+    const size_t topLevel,
+    const size_t level,
+    MetricType& localMetric) const
+{
+  std::vector<Candidate> entries(1, Candidate(localMetric.Evaluate(point,
+      referenceSet.unsafe_col(entry)), entry));
+  for (size_t l = topLevel; l > level; --l)
+    entries = SearchLevel(point, entries, 1, l, localMetric);
+
+  return entries;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    std::vector<Candidate>& candidates,
+    const size_t count,
+    MetricType& localMetric) const
+{
+  if (candidates.size() <= count)
+    return;
+
+  std::vector<Candidate> selected;
+  std::vector<Candidate> rejected;
+  selected.reserve(count);
+  for (size_t i = 0; i < candidates.size() && selected.size() < count; ++i)
+  {
+    bool keep = true;
+    for (size_t j = 0; j < selected.size() && keep; ++j)
+    {
+      keep = (localMetric.Evaluate(
+          referenceSet.unsafe_col(candidates[i].second),
+          referenceSet.unsafe_col(selected[j].second)) > candidates[i].first);
+    }
+
+    if (keep)
+      selected.push_back(candidates[i]);
+    else if (rejected.size() < count)
+      rejected.push_back(candidates[i]);
+  }
+
+  for (size_t i = 0; i < rejected.size() && selected.size() < count; ++i)
+    selected.push_back(rejected[i]);
+
+  candidates.swap(selected);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SearchPoints(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const bool skipSelf) const
+{
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0 || querySet.n_cols == 0)
+    return;
+
+  const size_t wanted = skipSelf ? k + 1 : k;
+  const size_t beam = std::max(beamWidth, wanted);
+  Threads::ParallelFor(0, querySet.n_cols, [&](const size_t q)
+  {
+    MetricType queryMetric(metric);
+    const auto vec = querySet.unsafe_col(q);
+    const std::vector<Candidate> found = SearchLevel(vec,
+        Descend(vec, entryPoint, maxLevel, 0, queryMetric), beam, 0,
+        queryMetric);
+
+    size_t filled = 0;
+    for (size_t i = 0; i < found.size() && filled < k; ++i)
+    {
+      if (skipSelf && found[i].second == q)
+        continue;
+
+      neighbors(filled, q) = found[i].second;
+      distances(filled, q) = found[i].first;
+      ++filled;
+    }
+
+    for (; filled < k; ++filled)
+    {
+      neighbors(filled, q) = size_t() - 1;
+      distances(filled, q) = DBL_MAX;
+    }
+  });
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::SerializeGraph(Archive& ar)
+{
+  ar & BOOST_SERIALIZATION_NVP(maxDegree);
+  ar & BOOST_SERIALIZATION_NVP(constructionBeam);
+  ar & BOOST_SERIALIZATION_NVP(beamWidth);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(graph);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(maxLevel);
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  // The mapping is released only once the reference set no longer points into
+  // it.
+  if (Archive::is_loading::value)
+  {
+    referenceSet.reset();
+    mappedReferences = data::MappedFile();
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  SerializeGraph(ar);
+}
+
+// The index file starts with a header of eight 64-bit words, as the index files
+// of NeighborSearch: a magic number, a byte order mark, the format version, the
+// size of a point coordinate, the size of the serialized graph, the number of
+// rows and columns of the reference set and the offset of the reference set in
+// the file.
+template<typename MetricType, typename MatType>
+bool HNSWSearch<MetricType, MatType>::SaveIndex(
+    const std::string& filename,
+    const bool fatal) const
+{
+  std::ostringstream graphStream;
+  try
+  {
+    boost::archive::binary_oarchive ar(graphStream);
+    const_cast<HNSWSearch&>(*this).SerializeGraph(ar);
+  }
+  catch (boost::archive::archive_exception& e)
+  {
+    return IndexError("Cannot serialize graph: " + std::string(e.what()) +
+        ".", fatal);
+  }
+  const std::string graphData = graphStream.str();
+
+  // Align the points to a cache line, so that they can be used in place.
+  const size_t alignment = 64;
+  const size_t graphEnd = 8 * sizeof(uint64_t) + graphData.size();
+  const size_t offset = (graphEnd + alignment - 1) / alignment * alignment;
+
+  uint64_t header[8];
+  std::memcpy(&header[0], "MLPKHNS", 8);
+  header[1] = 0x0102030405060708ULL;
+  header[2] = 1;
+  header[3] = sizeof(ElemType);
+  header[4] = graphData.size();
+  header[5] = referenceSet.n_rows;
+  header[6] = referenceSet.n_cols;
+  header[7] = offset;
+
+  std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary |
+      std::ios::trunc);
+  if (!stream.is_open())
+  {
+    return IndexError("Cannot open file '" + filename + "' for writing.",
+        fatal);
+  }
+
+  const std::string padding(offset - graphEnd, '\0');
+  stream.write((const char*) header, sizeof(header));
+  stream.write(graphData.data(), graphData.size());
+  stream.write(padding.data(), padding.size());
+  stream.write((const char*) referenceSet.memptr(),
+      referenceSet.n_elem * sizeof(ElemType));
+
+  if (!stream.good())
+    return IndexError("Cannot write to file '" + filename + "'.", fatal);
+
+  return true;
+}
+
+template<typename MetricType, typename MatType>
+bool HNSWSearch<MetricType, MatType>::LoadIndex(
+    const std::string& filename,
+    const bool fatal)
+{
+  data::MappedFile file;
+  try
+  {
+    file = data::MappedFile(filename);
+  }
+  catch (std::runtime_error& e)
+  {
+    return IndexError("Cannot load index from '" + filename + "': " +
+        e.what() + ".", fatal);
+  }
+
+  uint64_t header[8];
+  if (file.Size() < sizeof(header))
+  {
+    return IndexError("File '" + filename + "' is not an HNSW index.",
+        fatal);
+  }
+  std::memcpy(header, file.Data(), sizeof(header));
+
+  if (std::memcmp(&header[0], "MLPKHNS", 8) != 0 ||
+      header[1] != 0x0102030405060708ULL || header[2] != 1 ||
+      header[3] != sizeof(ElemType))
+  {
+    return IndexError("File '" + filename + "' is not an HNSW index saved on "
+        "a compatible machine.", fatal);
+  }
+
+  const uint64_t pointsSize = header[5] * header[6] * sizeof(ElemType);
+  if (header[7] < sizeof(header) + header[4] ||
+      header[7] % sizeof(ElemType) != 0 || header[7] > file.Size() ||
+      pointsSize > file.Size() - header[7])
+  {
+    return IndexError("File '" + filename + "' is truncated or corrupt.",
+        fatal);
+  }
+
+  try
+  {
+    std::istringstream graphStream(std::string(file.Data() + sizeof(header),
+        header[4]));
+    boost::archive::binary_iarchive ar(graphStream);
+    SerializeGraph(ar);
+  }
+  catch (boost::archive::archive_exception& e)
+  {
+    return IndexError("Cannot load graph from '" + filename + "': " +
+        e.what() + ".", fatal);
+  }
+
+  if (graph.size() != header[6])
+  {
+    graph.clear();
+    referenceSet.reset();
+    mappedReferences = data::MappedFile();
+    return IndexError("File '" + filename + "' is truncated or corrupt.",
+        fatal);
+  }
+
+  // Use the mapped points in place.
+  MatType points((ElemType*) (file.Data() + header[7]), header[5], header[6],
+      false, false);
+  referenceSet.steal_mem(points);
+  mappedReferences = std::move(file);
+
+  return true;
+}
+
+template<typename MetricType, typename MatType>
+bool HNSWSearch<MetricType, MatType>::IndexError(const std::string& message,
+                                                 const bool fatal)
+{
+  if (fatal)
+    Log::Fatal << message << std::endl;
+  else
+    Log::Warning << message << std::endl;
+
+  return false;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
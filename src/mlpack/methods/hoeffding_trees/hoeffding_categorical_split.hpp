@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_CATEGORICAL_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/category_counts.hpp>
 #include "categorical_split_info.hpp"
 
 namespace mlpack {
@@ -36,7 +37,9 @@ namespace tree {
  *
  * This class will track the sufficient statistics of the training points it has
  * seen.  The HoeffdingSplit class (and other related classes) can use this
- * class to track categorical features and split decision tree nodes.
+ * class to track categorical features and split decision tree nodes.  For
+ * features with very many categories, only the categories that have been seen
+ * are stored (see CategoryCounts).
  *
  * @tparam FitnessFunction Fitness function to use for calculating gain.
  */
@@ -90,7 +93,7 @@ class HoeffdingCategoricalSplit
       const;
 
   //! Return the number of children, if the node were to split.
-  size_t NumChildren() const { return sufficientStatistics.n_cols; }
+  size_t NumChildren() const { return sufficientStatistics.NumCategories(); }
 
   /**
    * Gather the information for a split: get the labels of the child majorities,
@@ -108,21 +111,22 @@ class HoeffdingCategoricalSplit
 
   //! Serialize the categorical split.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
-  {
-    ar & BOOST_SERIALIZATION_NVP(sufficientStatistics);
-  }
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   //! The sufficient statistics for all points seen so far.  Each column
   //! corresponds to a category, and contains a count of each of the classes
   //! seen for points in that category.
-  arma::Mat<size_t> sufficientStatistics;
+  CategoryCounts<size_t> sufficientStatistics;
 };
 
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the HoeffdingCategoricalSplit class.
+BOOST_TEMPLATE_CLASS_VERSION(template<typename FitnessFunction>,
+    mlpack::tree::HoeffdingCategoricalSplit<FitnessFunction>, 1);
+
 // Include implementation.
 #include "hoeffding_categorical_split_impl.hpp"
 
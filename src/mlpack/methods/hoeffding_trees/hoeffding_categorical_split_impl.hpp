@@ -22,9 +22,9 @@ template<typename FitnessFunction>
 HoeffdingCategoricalSplit<FitnessFunction>::HoeffdingCategoricalSplit(
     const size_t numCategories,
     const size_t numClasses) :
-    sufficientStatistics(numClasses, numCategories)
+    sufficientStatistics(numCategories, numClasses)
 {
-  sufficientStatistics.zeros();
+  // Nothing to do.
 }
 
 template<typename FitnessFunction>
@@ -32,9 +32,9 @@ HoeffdingCategoricalSplit<FitnessFunction>::HoeffdingCategoricalSplit(
     const size_t numCategories,
     const size_t numClasses,
     const HoeffdingCategoricalSplit& /* other */) :
-    sufficientStatistics(numClasses, numCategories)
+    sufficientStatistics(numCategories, numClasses)
 {
-  sufficientStatistics.zeros();
+  // Nothing to do.
 }
 
 template<typename FitnessFunction>
@@ -44,7 +44,7 @@ void HoeffdingCategoricalSplit<FitnessFunction>::Train(eT value,
 {
   // Add this to our counts.
   // 'value' should be categorical, so we should be able to cast to size_t...
-  sufficientStatistics(label, size_t(value))++;
+  sufficientStatistics.Add(size_t(value), label);
 }
 
 template<typename FitnessFunction>
@@ -52,7 +52,9 @@ void HoeffdingCategoricalSplit<FitnessFunction>::EvaluateFitnessFunction(
     double& bestFitness,
     double& secondBestFitness) const
 {
-  bestFitness = FitnessFunction::Evaluate(sufficientStatistics);
+  // Categories that have not been seen do not change the fitness, so only the
+  // stored columns need to be evaluated.
+  bestFitness = FitnessFunction::Evaluate(sufficientStatistics.Table());
   secondBestFitness = 0.0; // We only split one possible way.
 }
 
@@ -61,24 +63,27 @@ void HoeffdingCategoricalSplit<FitnessFunction>::Split(
     arma::Col<size_t>& childMajorities,
     SplitInfo& splitInfo)
 {
-  // We'll make one child for each category.
-  childMajorities.set_size(sufficientStatistics.n_cols);
-  for (size_t i = 0; i < sufficientStatistics.n_cols; ++i)
+  // We'll make one child for each category.  Categories that have not been
+  // seen get class 0 as their majority.
+  const size_t numCategories = sufficientStatistics.NumCategories();
+  const arma::Mat<size_t> table = sufficientStatistics.Table();
+  childMajorities.zeros(numCategories);
+  for (size_t i = 0; i < table.n_cols; ++i)
   {
     arma::uword maxIndex = 0;
-    sufficientStatistics.unsafe_col(i).max(maxIndex);
-    childMajorities[i] = size_t(maxIndex);
+    table.col(i).max(maxIndex);
+    childMajorities[sufficientStatistics.Category(i)] = size_t(maxIndex);
   }
 
   // Create the according SplitInfo object.
-  splitInfo = SplitInfo(sufficientStatistics.n_cols);
+  splitInfo = SplitInfo(numCategories);
 }
 
 template<typename FitnessFunction>
 size_t HoeffdingCategoricalSplit<FitnessFunction>::MajorityClass() const
 {
   // Calculate the class that we have seen the most of.
-  arma::Col<size_t> classCounts = arma::sum(sufficientStatistics, 1);
+  arma::Col<size_t> classCounts = sufficientStatistics.ClassCounts();
 
   arma::uword maxIndex = 0;
   classCounts.max(maxIndex);
@@ -89,11 +94,37 @@ size_t HoeffdingCategoricalSplit<FitnessFunction>::MajorityClass() const
 template<typename FitnessFunction>
 double HoeffdingCategoricalSplit<FitnessFunction>::MajorityProbability() const
 {
-  arma::Col<size_t> classCounts = arma::sum(sufficientStatistics, 1);
+  arma::Col<size_t> classCounts = sufficientStatistics.ClassCounts();
 
   return double(classCounts.max()) / double(arma::accu(classCounts));
 }
 
+template<typename FitnessFunction>
+template<typename Archive>
+void HoeffdingCategoricalSplit<FitnessFunction>::serialize(
+    Archive& ar,
+    const unsigned int version)
+{
+  if (version == 0)
+  {
+    // Older versions stored a dense classes x categories matrix.
+    arma::Mat<size_t> oldStatistics;
+    ar & boost::serialization::make_nvp("sufficientStatistics",
+        oldStatistics);
+
+    sufficientStatistics = CategoryCounts<size_t>(oldStatistics.n_cols,
+        oldStatistics.n_rows);
+    for (size_t c = 0; c < oldStatistics.n_cols; ++c)
+      for (size_t l = 0; l < oldStatistics.n_rows; ++l)
+        if (oldStatistics(l, c) > 0)
+          sufficientStatistics.Add(c, l, oldStatistics(l, c));
+  }
+  else
+  {
+    ar & BOOST_SERIALIZATION_NVP(sufficientStatistics);
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
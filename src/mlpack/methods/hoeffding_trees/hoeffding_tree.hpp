@@ -158,6 +158,12 @@ class HoeffdingTree
    * Train on a set of points, either in streaming mode or in batch mode, with
    * the given labels.
    *
+   * In streaming mode the points are treated as a mini-batch from the stream:
+   * they are first routed to the leaves they fall into, and then the
+   * statistics of the leaves (or, if there is only one leaf, of its
+   * dimensions) are updated in parallel.  The resulting tree is the same as if
+   * each point had been passed to Train() one at a time.
+   *
    * @param data Data points to train on.
    * @param label Labels of data points.
    * @param batchTraining If true, perform training in batch.
@@ -308,6 +314,22 @@ class HoeffdingTree
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Train on the given points of the dataset in streaming mode, in order.  If
+   * the node splits partway through, the rest of the points are passed to the
+   * children.
+   *
+   * @param data Dataset containing the points.
+   * @param labels Labels of all points in the dataset.
+   * @param points Indices of the points to train on.
+   * @param parallel Whether to update the dimensions in parallel.
+   */
+  template<typename MatType>
+  void TrainPoints(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const std::vector<size_t>& points,
+                   const bool parallel);
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
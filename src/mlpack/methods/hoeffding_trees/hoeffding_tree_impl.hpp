@@ -291,9 +291,36 @@ void HoeffdingTree<
   }
   else
   {
-    // We aren't training in batch mode; loop through the points.
+    // We aren't training in batch mode, so treat the points as a mini-batch
+    // from the stream.  First route each point to the leaf it currently falls
+    // into, keeping the order of the points within each leaf.
+    std::vector<HoeffdingTree*> leaves;
+    std::vector<std::vector<size_t>> leafPoints;
+    std::unordered_map<HoeffdingTree*, size_t> leafIndices;
     for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    {
+      HoeffdingTree* node = this;
+      while (node->splitDimension != size_t(-1))
+        node = node->children[node->CalculateDirection(data.col(i))];
+
+      typename std::unordered_map<HoeffdingTree*, size_t>::const_iterator it =
+          leafIndices.find(node);
+      if (it == leafIndices.end())
+      {
+        it = leafIndices.insert(std::make_pair(node, leaves.size())).first;
+        leaves.push_back(node);
+        leafPoints.push_back(std::vector<size_t>());
+      }
+      leafPoints[it->second].push_back(i);
+    }
+
+    // The leaves are disjoint, so each one can be updated by its own thread.
+    // If there is only one leaf, its dimensions are updated in parallel
+    // instead.
+    const bool parallelLeaves = (leaves.size() > 1);
+    #pragma omp parallel for schedule(dynamic) if (parallelLeaves)
+    for (omp_size_t i = 0; i < (omp_size_t) leaves.size(); ++i)
+      leaves[i]->TrainPoints(data, labels, leafPoints[i], !parallelLeaves);
   }
 }
 
@@ -410,6 +437,96 @@ void HoeffdingTree<
   }
 }
 
+//! Train on a subset of points in streaming mode.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainPoints(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const std::vector<size_t>& points,
+               const bool parallel)
+{
+  const size_t dimensionality = categoricalSplits.size() +
+      numericSplits.size();
+
+  size_t start = 0;
+  while (start < points.size() && splitDimension == size_t(-1))
+  {
+    // Take all the points up to the next split check.  No split can happen
+    // before then, so each dimension's statistics can be updated on their own,
+    // as long as the points are seen in the same order.
+    const size_t end = std::min(points.size(),
+        start + checkInterval - (numSamples % checkInterval));
+
+    #pragma omp parallel for schedule(dynamic) \
+        if (parallel && (end - start) * dimensionality >= 16384)
+    for (omp_size_t d = 0; d < (omp_size_t) dimensionality; ++d)
+    {
+      const std::pair<size_t, size_t>& mapping = dimensionMappings->at(d);
+      if (mapping.first == data::Datatype::categorical)
+      {
+        for (size_t j = start; j < end; ++j)
+        {
+          categoricalSplits[mapping.second].Train(data(d, points[j]),
+              labels[points[j]]);
+        }
+      }
+      else
+      {
+        for (size_t j = start; j < end; ++j)
+        {
+          numericSplits[mapping.second].Train(data(d, points[j]),
+              labels[points[j]]);
+        }
+      }
+    }
+    numSamples += end - start;
+    start = end;
+
+    // Grab majority class from splits.
+    if (categoricalSplits.size() > 0)
+    {
+      majorityClass = categoricalSplits[0].MajorityClass();
+      majorityProbability = categoricalSplits[0].MajorityProbability();
+    }
+    else
+    {
+      majorityClass = numericSplits[0].MajorityClass();
+      majorityProbability = numericSplits[0].MajorityProbability();
+    }
+
+    // Check for a split, if we should.
+    if (numSamples % checkInterval == 0)
+    {
+      const size_t numChildren = SplitCheck();
+      if (numChildren > 0)
+      {
+        children.clear();
+        CreateChildren();
+      }
+    }
+  }
+
+  if (start == points.size())
+    return;
+
+  // We have split, so pass the rest of the points down to the children.
+  std::vector<std::vector<size_t>> childPoints(children.size());
+  for (size_t j = start; j < points.size(); ++j)
+    childPoints[CalculateDirection(data.col(points[j]))].push_back(points[j]);
+
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    if (childPoints[i].size() > 0)
+      children[i]->TrainPoints(data, labels, childPoints[i], parallel);
+  }
+}
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType>
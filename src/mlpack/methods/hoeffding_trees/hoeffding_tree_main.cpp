@@ -17,6 +17,7 @@
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/information_gain.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree_model.hpp>
+#include <mlpack/core/data/chunked_reader.hpp>
 #include <queue>
 
 using namespace std;
@@ -44,6 +45,16 @@ PROGRAM_INFO("Hoeffding trees",
     PRINT_PARAM_STRING("batch_mode") + " option, but this may not be the best "
     "option for large datasets."
     "\n\n"
+    "Instead of loading the whole training set, the training points may be "
+    "read as a stream with the " + PRINT_PARAM_STRING("training_stream") +
+    " parameter, which is the name of a file whose last dimension holds the "
+    "labels, or '-' to read numeric CSV points from standard input.  The "
+    "points are read " + PRINT_PARAM_STRING("chunk_size") + " at a time and "
+    "the tree is updated after each chunk, so memory usage does not grow with "
+    "the size of the stream.  If no input model is given, the number of "
+    "classes must be specified with " + PRINT_PARAM_STRING("num_classes") +
+    ", since not all classes may be present in the first chunk."
+    "\n\n"
     "When a model is trained, it may be saved via the " +
     PRINT_PARAM_STRING("output_model") + " output parameter.  A model may be "
     "loaded from file for further training or testing with the " +
@@ -75,6 +86,13 @@ PROGRAM_INFO("Hoeffding trees",
 PARAM_MATRIX_AND_INFO_IN("training", "Training dataset (may be categorical).",
     "t");
 PARAM_UROW_IN("labels", "Labels for training dataset.", "l");
+PARAM_STRING_IN("training_stream", "File to read training points from in "
+    "chunks, with the labels in the last dimension, or '-' to read numeric CSV "
+    "points from standard input.", "S", "");
+PARAM_INT_IN("chunk_size", "Number of points to read from the training stream "
+    "at a time.", "k", 65536);
+PARAM_INT_IN("num_classes", "Number of classes in the training stream "
+    "(required if no input model is given).", "C", 0);
 
 PARAM_DOUBLE_IN("confidence", "Confidence before splitting (between 0 and 1).",
     "c", 0.95);
@@ -113,13 +131,60 @@ PARAM_INT_IN("observations_before_binning", "If the 'domingos' split strategy "
 // Convenience typedef.
 typedef tuple<DatasetInfo, arma::mat> TupleType;
 
+/**
+ * Read up to chunkSize numeric points, one per line with comma or whitespace
+ * separated values, from the given stream.
+ *
+ * @return false if there are no more points.
+ */
+static bool ReadChunk(istream& stream,
+                      const size_t chunkSize,
+                      arma::mat& chunk)
+{
+  vector<double> values;
+  size_t dimensionality = 0;
+  size_t numPoints = 0;
+  string line;
+  while (numPoints < chunkSize && getline(stream, line))
+  {
+    replace(line.begin(), line.end(), ',', ' ');
+    istringstream lineStream(line);
+    size_t lineValues = 0;
+    double value;
+    while (lineStream >> value)
+    {
+      values.push_back(value);
+      ++lineValues;
+    }
+
+    // Skip blank lines.
+    if (lineValues == 0)
+      continue;
+
+    if (numPoints == 0)
+    {
+      dimensionality = lineValues;
+    }
+    else if (lineValues != dimensionality)
+    {
+      Log::Fatal << "Point in training stream has " << lineValues << " values, "
+          << "but the previous points have " << dimensionality << "!" << endl;
+    }
+    ++numPoints;
+  }
+
+  chunk = arma::mat(values.data(), dimensionality, numPoints);
+  return (numPoints > 0);
+}
+
 static void mlpackMain()
 {
   // Check input parameters for validity.
   const string numericSplitStrategy =
       CLI::GetParam<string>("numeric_split_strategy");
 
-  RequireAtLeastOnePassed({ "training", "input_model" }, true);
+  RequireAtLeastOnePassed({ "training", "training_stream", "input_model" },
+      true);
 
   RequireAtLeastOnePassed({ "output_model", "predictions", "probabilities",
       "test_labels" }, false, "no output will be given");
@@ -128,7 +193,22 @@ static void mlpackMain()
   ReportIgnoredParam({{ "test", false }}, "predictions");
 
   ReportIgnoredParam({{ "training", false }}, "batch_mode");
-  ReportIgnoredParam({{ "training", false }}, "passes");
+  ReportIgnoredParam({{ "training", false }, { "training_stream", false }},
+      "passes");
+  ReportIgnoredParam({{ "training", false }}, "labels");
+
+  if (CLI::HasParam("training_stream"))
+  {
+    RequireOnlyOnePassed({ "training", "training_stream" }, true);
+
+    RequireParamValue<int>("chunk_size", [](int x) { return x > 0; }, true,
+        "chunk size must be positive");
+    if (!CLI::HasParam("input_model"))
+    {
+      RequireParamValue<int>("num_classes", [](int x) { return x >= 2; }, true,
+          "there must be at least two classes");
+    }
+  }
 
   if (CLI::HasParam("test"))
   {
@@ -229,6 +309,107 @@ static void mlpackMain()
 
     Timer::Stop("tree_training");
   }
+  else if (CLI::HasParam("training_stream"))
+  {
+    // Load necessary parameters for training.
+    const double confidence = CLI::GetParam<double>("confidence");
+    const size_t maxSamples = (size_t) CLI::GetParam<int>("max_samples");
+    const size_t minSamples = (size_t) CLI::GetParam<int>("min_samples");
+    const size_t bins = (size_t) CLI::GetParam<int>("bins");
+    const size_t observationsBeforeBinning = (size_t)
+        CLI::GetParam<int>("observations_before_binning");
+    const size_t numClasses = (size_t) CLI::GetParam<int>("num_classes");
+    const size_t chunkSize = (size_t) CLI::GetParam<int>("chunk_size");
+    const string streamName = CLI::GetParam<string>("training_stream");
+    size_t passes = (size_t) CLI::GetParam<int>("passes");
+
+    // Files are read with the chunked reader; standard input is read directly,
+    // and can only be passed over once.
+    unique_ptr<ChunkedReader<double>> reader;
+    if (streamName == "-")
+    {
+      if (passes > 1)
+      {
+        Log::Warn << "Only one pass can be taken over standard input; "
+            << PRINT_PARAM_STRING("passes") << " ignored." << endl;
+        passes = 1;
+      }
+    }
+    else
+    {
+      reader.reset(new ChunkedReader<double>(streamName, chunkSize));
+      if (reader->Dimensionality() < 2)
+      {
+        Log::Fatal << "Training stream must have at least one dimension and "
+            << "the labels!" << endl;
+      }
+
+      // The DatasetInfo of the tree doesn't include the labels.
+      const DatasetInfo& streamInfo = reader->Info();
+      datasetInfo = DatasetInfo(reader->Dimensionality() - 1);
+      for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+      {
+        if (streamInfo.Type(i) != Datatype::categorical)
+          continue;
+
+        datasetInfo.Type(i) = Datatype::categorical;
+        for (size_t j = 0; j < streamInfo.NumMappings(i); ++j)
+          datasetInfo.MapString<double>(streamInfo.UnmapString(j, i), i);
+      }
+    }
+
+    Timer::Start("tree_training");
+    size_t numPoints = 0;
+    arma::mat chunk;
+    for (size_t p = 0; p < passes; ++p)
+    {
+      if (p > 0)
+        reader->Reset();
+
+      while (reader ? reader->NextChunk(chunk) :
+          ReadChunk(cin, chunkSize, chunk))
+      {
+        if (chunk.n_rows < 2)
+        {
+          Log::Fatal << "Training stream must have at least one dimension and "
+              << "the labels!" << endl;
+        }
+
+        // Extract the labels from the last dimension of the chunk.
+        labels = arma::conv_to<arma::Row<size_t>>::from(
+            chunk.row(chunk.n_rows - 1));
+        chunk.shed_row(chunk.n_rows - 1);
+        if (numClasses > 0 && arma::max(labels) >= numClasses)
+        {
+          Log::Fatal << "Label " << arma::max(labels) << " in training stream "
+              << "is not less than the number of classes (" << numClasses
+              << ")!" << endl;
+        }
+
+        if (numPoints == 0 && !CLI::HasParam("input_model"))
+        {
+          // Build the model from the first chunk.
+          if (!reader)
+            datasetInfo = DatasetInfo(chunk.n_rows);
+          model->BuildModel(chunk, datasetInfo, labels, numClasses, false,
+              confidence, maxSamples, 100, minSamples, bins,
+              observationsBeforeBinning);
+        }
+        else
+        {
+          model->Train(chunk, labels, false);
+        }
+
+        numPoints += chunk.n_cols;
+        Log::Info << "Trained on " << numPoints << " points from the training "
+            << "stream." << endl;
+      }
+    }
+    Timer::Stop("tree_training");
+
+    if (numPoints == 0)
+      Log::Fatal << "Training stream contains no points!" << endl;
+  }
 
   // Do we need to evaluate the training set error?
   if (CLI::HasParam("training"))
@@ -0,0 +1,162 @@
+/**
+ * @file sketch_numeric_split.hpp
+ *
+ * A numeric splitting procedure for Hoeffding trees that summarizes the
+ * observations with a bounded-size quantile sketch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_SKETCH_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_SKETCH_NUMERIC_SPLIT_HPP
+
+#include "binary_numeric_split_info.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SketchNumericSplit class makes binary splits on a numeric feature, like
+ * BinaryNumericSplit, but instead of keeping every observation it keeps a
+ * quantile sketch in the style of the merging t-digest:
+ *
+ * @code
+ * @article{dunning2019computing,
+ *   title={Computing Extremely Accurate Quantiles Using t-Digests},
+ *   author={Dunning, T. and Ertl, O.},
+ *   journal={arXiv preprint arXiv:1902.04023},
+ *   year={2019}
+ * }
+ * @endcode
+ *
+ * The sketch is a sorted list of at most maxCentroids centroids, each holding
+ * the mean of the observations it summarizes and the number of observations of
+ * each class.  New observations are buffered, and when the buffer is full it
+ * is sorted and merged into the centroids, which are then compressed so that
+ * each covers about the same number of observations.  So Train() takes
+ * O(log(maxCentroids)) amortized time, and the memory used is
+ * O(maxCentroids * numClasses) no matter how many points are seen.
+ *
+ * The candidate splits are the midpoints between neighbouring centroids, so
+ * EvaluateFitnessFunction() takes O(maxCentroids) time.
+ *
+ * @tparam FitnessFunction Fitness function to use for calculating gain.
+ * @tparam ObservationType Type of observation used by this dimension.
+ */
+template<typename FitnessFunction,
+         typename ObservationType = double>
+class SketchNumericSplit
+{
+ public:
+  //! The splitting information required by the SketchNumericSplit.
+  typedef BinaryNumericSplitInfo<ObservationType> SplitInfo;
+
+  /**
+   * Create the SketchNumericSplit object with the given number of classes and
+   * the given sketch size.
+   *
+   * @param numClasses Number of classes in dataset.
+   * @param maxCentroids Maximum number of centroids in the sketch.
+   */
+  SketchNumericSplit(const size_t numClasses = 0,
+                     const size_t maxCentroids = 100);
+
+  /**
+   * Create the SketchNumericSplit object with the given number of classes,
+   * using the sketch size of the given other split.
+   */
+  SketchNumericSplit(const size_t numClasses, const SketchNumericSplit& other);
+
+  /**
+   * Train on the given value with the given label.
+   *
+   * @param value The value to train on.
+   * @param label The label to train on.
+   */
+  void Train(ObservationType value, const size_t label);
+
+  /**
+   * Given the points seen so far, evaluate the fitness function, returning the
+   * best possible gain of a binary split between two centroids of the sketch.
+   *
+   * The best possible split will be stored in bestFitness, and the second best
+   * possible split will be stored in secondBestFitness.
+   *
+   * @param bestFitness Fitness function value for best possible split.
+   * @param secondBestFitness Fitness function value for second best possible
+   *      split.
+   */
+  void EvaluateFitnessFunction(double& bestFitness,
+                               double& secondBestFitness);
+
+  // Return the number of children if this node were to split on this feature.
+  size_t NumChildren() const { return 2; }
+
+  /**
+   * Given that a split should happen, return the majority classes of the (two)
+   * children and an initialized SplitInfo object.
+   *
+   * @param childMajorities Majority classes of the children after the split.
+   * @param splitInfo Split information.
+   */
+  void Split(arma::Col<size_t>& childMajorities, SplitInfo& splitInfo);
+
+  //! The majority class of the points seen so far.
+  size_t MajorityClass() const;
+  //! The probability of the majority class given the points seen so far.
+  double MajorityProbability() const;
+
+  //! Get the maximum number of centroids in the sketch.
+  size_t MaxCentroids() const { return maxCentroids; }
+  //! Get the number of centroids currently in the sketch (not counting
+  //! buffered observations).
+  size_t NumCentroids() const { return means.n_elem; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Merge the buffered observations into the centroids, and compress the
+   * centroids so there are at most maxCentroids of them.
+   */
+  void Compress();
+
+  //! The maximum number of centroids (and the size of the buffer).
+  size_t maxCentroids;
+  //! The means of the centroids, in sorted order.
+  arma::Col<ObservationType> means;
+  //! The number of observations of each class in each centroid.
+  arma::Mat<size_t> centroidCounts;
+
+  //! The observations not yet merged into the centroids.
+  arma::Col<ObservationType> bufferValues;
+  //! The labels of the observations not yet merged into the centroids.
+  arma::Col<size_t> bufferLabels;
+  //! The number of buffered observations.
+  size_t bufferSize;
+
+  //! The classes we have seen so far (for majority calculations).
+  arma::Col<size_t> classCounts;
+
+  //! A cached best split point.
+  ObservationType bestSplit;
+  //! If true, the cached best split point is accurate (that is, we have not
+  //! seen any more samples since we calculated it).
+  bool isAccurate;
+};
+
+// Convenience typedef.
+template<typename FitnessFunction>
+using SketchDoubleNumericSplit = SketchNumericSplit<FitnessFunction, double>;
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "sketch_numeric_split_impl.hpp"
+
+#endif
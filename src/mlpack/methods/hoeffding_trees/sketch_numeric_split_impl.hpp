@@ -0,0 +1,262 @@
+/**
+ * @file sketch_numeric_split_impl.hpp
+ *
+ * Implementation of the SketchNumericSplit class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_SKETCH_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_SKETCH_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sketch_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction, typename ObservationType>
+SketchNumericSplit<FitnessFunction, ObservationType>::SketchNumericSplit(
+    const size_t numClasses,
+    const size_t maxCentroids) :
+    maxCentroids(maxCentroids),
+    centroidCounts(numClasses, 0),
+    bufferValues(maxCentroids),
+    bufferLabels(maxCentroids),
+    bufferSize(0),
+    classCounts(numClasses),
+    bestSplit(std::numeric_limits<ObservationType>::lowest()),
+    isAccurate(true)
+{
+  if (maxCentroids == 0)
+  {
+    throw std::invalid_argument("SketchNumericSplit::SketchNumericSplit(): "
+        "maxCentroids must be positive!");
+  }
+
+  // Zero out class counts.
+  classCounts.zeros();
+}
+
+template<typename FitnessFunction, typename ObservationType>
+SketchNumericSplit<FitnessFunction, ObservationType>::SketchNumericSplit(
+    const size_t numClasses,
+    const SketchNumericSplit& other) :
+    maxCentroids(other.maxCentroids),
+    centroidCounts(numClasses, 0),
+    bufferValues(other.maxCentroids),
+    bufferLabels(other.maxCentroids),
+    bufferSize(0),
+    classCounts(numClasses),
+    bestSplit(std::numeric_limits<ObservationType>::lowest()),
+    isAccurate(true)
+{
+  // Zero out class counts.
+  classCounts.zeros();
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void SketchNumericSplit<FitnessFunction, ObservationType>::Train(
+    ObservationType value,
+    const size_t label)
+{
+  // Buffer the observation, and merge the buffer into the sketch when it is
+  // full.
+  bufferValues[bufferSize] = value;
+  bufferLabels[bufferSize] = label;
+  ++bufferSize;
+  ++classCounts[label];
+
+  if (bufferSize == maxCentroids)
+    Compress();
+
+  // Whatever we have cached is no longer valid.
+  isAccurate = false;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void SketchNumericSplit<FitnessFunction, ObservationType>::
+    EvaluateFitnessFunction(double& bestFitness,
+                            double& secondBestFitness)
+{
+  // Make sure every observation is in the sketch.
+  Compress();
+
+  bestSplit = std::numeric_limits<ObservationType>::lowest();
+
+  // Initialize the sufficient statistics.
+  arma::Mat<size_t> counts(classCounts.n_elem, 2);
+  counts.col(0).zeros();
+  counts.col(1) = classCounts;
+
+  bestFitness = FitnessFunction::Evaluate(counts);
+  secondBestFitness = 0.0;
+
+  for (size_t i = 0; i < means.n_elem; ++i)
+  {
+    // Try splitting between this centroid and the last one, unless they have
+    // the same mean.
+    if ((i > 0) && (means[i] != means[i - 1]))
+    {
+      const double value = FitnessFunction::Evaluate(counts);
+      if (value > bestFitness)
+      {
+        bestFitness = value;
+
+        // Take the midpoint, unless it can't be represented (for integer
+        // observations, for instance).
+        bestSplit = means[i - 1] + (means[i] - means[i - 1]) / 2;
+        if (!(bestSplit > means[i - 1]))
+          bestSplit = means[i];
+      }
+      else if (value > secondBestFitness)
+      {
+        secondBestFitness = value;
+      }
+    }
+
+    // Move the centroid to the left side of the split.
+    counts.col(0) += centroidCounts.col(i);
+    counts.col(1) -= centroidCounts.col(i);
+  }
+
+  isAccurate = true;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void SketchNumericSplit<FitnessFunction, ObservationType>::Split(
+    arma::Col<size_t>& childMajorities,
+    SplitInfo& splitInfo)
+{
+  if (!isAccurate)
+  {
+    double bestGain, secondBestGain;
+    EvaluateFitnessFunction(bestGain, secondBestGain);
+  }
+
+  // Make one child for each side of the split.
+  childMajorities.set_size(2);
+
+  arma::Mat<size_t> counts(classCounts.n_elem, 2);
+  counts.col(0).zeros();
+  counts.col(1) = classCounts;
+  for (size_t i = 0; i < means.n_elem && means[i] < bestSplit; ++i)
+  {
+    counts.col(0) += centroidCounts.col(i);
+    counts.col(1) -= centroidCounts.col(i);
+  }
+
+  // Calculate the majority classes of the children.
+  arma::uword maxIndex;
+  counts.unsafe_col(0).max(maxIndex);
+  childMajorities[0] = size_t(maxIndex);
+  counts.unsafe_col(1).max(maxIndex);
+  childMajorities[1] = size_t(maxIndex);
+
+  // Create the according SplitInfo object.
+  splitInfo = SplitInfo(bestSplit);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+size_t SketchNumericSplit<FitnessFunction, ObservationType>::MajorityClass()
+    const
+{
+  arma::uword maxIndex;
+  classCounts.max(maxIndex);
+  return size_t(maxIndex);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+double SketchNumericSplit<FitnessFunction, ObservationType>::
+    MajorityProbability() const
+{
+  return double(arma::max(classCounts)) / double(arma::accu(classCounts));
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void SketchNumericSplit<FitnessFunction, ObservationType>::Compress()
+{
+  if (bufferSize == 0)
+    return;
+
+  const arma::uvec order = arma::sort_index(
+      bufferValues.subvec(0, bufferSize - 1));
+  const size_t total = arma::accu(classCounts);
+
+  // Walk through the centroids and the sorted buffer together.  Everything is
+  // assigned to one of maxCentroids buckets by the rank of its middle
+  // observation, and each non-empty bucket becomes a new centroid.  Since the
+  // ranks only grow, the new centroids stay sorted.
+  arma::vec sums(maxCentroids, arma::fill::zeros);
+  arma::Col<size_t> weights(maxCentroids, arma::fill::zeros);
+  arma::Mat<size_t> newCounts(classCounts.n_elem, maxCentroids,
+      arma::fill::zeros);
+  size_t centroid = 0;
+  size_t buffered = 0;
+  size_t rank = 0;
+  while (centroid < means.n_elem || buffered < bufferSize)
+  {
+    const bool useCentroid = (centroid < means.n_elem) &&
+        (buffered == bufferSize ||
+         means[centroid] <= bufferValues[order[buffered]]);
+
+    const size_t weight = useCentroid ?
+        arma::accu(centroidCounts.col(centroid)) : 1;
+    const double value = useCentroid ? double(means[centroid]) :
+        double(bufferValues[order[buffered]]);
+    const size_t bucket = std::min(maxCentroids - 1,
+        ((2 * rank + weight) * maxCentroids) / (2 * total));
+
+    sums[bucket] += value * weight;
+    weights[bucket] += weight;
+    if (useCentroid)
+    {
+      newCounts.col(bucket) += centroidCounts.col(centroid);
+      ++centroid;
+    }
+    else
+    {
+      ++newCounts(bufferLabels[order[buffered]], bucket);
+      ++buffered;
+    }
+
+    rank += weight;
+  }
+
+  const arma::uvec nonEmpty = arma::find(weights > 0);
+  const arma::vec newMeans = sums.elem(nonEmpty) /
+      arma::conv_to<arma::vec>::from(weights.elem(nonEmpty));
+  means = arma::conv_to<arma::Col<ObservationType>>::from(newMeans);
+  centroidCounts = newCounts.cols(nonEmpty);
+  bufferSize = 0;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+template<typename Archive>
+void SketchNumericSplit<FitnessFunction, ObservationType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  // Serialize.
+  ar & BOOST_SERIALIZATION_NVP(maxCentroids);
+  ar & BOOST_SERIALIZATION_NVP(means);
+  ar & BOOST_SERIALIZATION_NVP(centroidCounts);
+  ar & BOOST_SERIALIZATION_NVP(bufferValues);
+  ar & BOOST_SERIALIZATION_NVP(bufferLabels);
+  ar & BOOST_SERIALIZATION_NVP(bufferSize);
+  ar & BOOST_SERIALIZATION_NVP(classCounts);
+
+  if (Archive::is_loading::value)
+  {
+    // The cached split has to be recomputed.
+    bestSplit = std::numeric_limits<ObservationType>::lowest();
+    isAccurate = false;
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * @file kde.hpp
+ *
+ * Defines the KDE class, which estimates the density of a set of query points
+ * from a set of reference points with tree-based kernel density estimation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_HPP
+#define MLPACK_METHODS_KDE_KDE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include "kde_rules.hpp"
+
+namespace mlpack {
+namespace kde /** Kernel density estimation. */ {
+
+//! The traversal used to estimate the densities.
+enum KDEMode
+{
+  DUAL_TREE_MODE,
+  SINGLE_TREE_MODE
+};
+
+/**
+ * The KDE class estimates the density of a set of query points from a set of
+ * reference points,
+ *
+ *   f(q) = 1 / (N * h(d)) * sum_r K(||q - r||),
+ *
+ * where N is the number of reference points and h(d) is the normalizer of the
+ * kernel K in d dimensions (kernels without a Normalizer() function, such as
+ * the Laplacian and triangular kernels, give unnormalized estimates).  It is
+ * implemented in the style of a generalized tree-independent dual-tree
+ * algorithm; pairs of nodes whose kernel values are all close to each other are
+ * approximated instead of being visited (see the KDERules class), so that the
+ * estimates have a relative error of at most RelativeError() and an absolute
+ * error of at most AbsoluteError().  With both tolerances set to zero, the
+ * estimates are exact.
+ *
+ * In dual-tree mode a query tree is built and traversed with the reference
+ * tree; for BinarySpaceTree (kd-trees, ball trees, ...), the top of the query
+ * tree is traversed in parallel.  In single-tree mode the reference tree is
+ * traversed for every query point, and the query points are processed in
+ * parallel.
+ *
+ * @code
+ * KDE<> kde(0.05, 0.0, GaussianKernel(0.5));
+ * kde.Train(referenceSet);
+ * arma::vec estimations;
+ * kde.Evaluate(querySet, estimations);
+ * @endcode
+ *
+ * @tparam KernelType Kernel to use; its value must not increase with the
+ *     distance.
+ * @tparam MetricType Metric to use for the distances.
+ * @tparam MatType Type of data to use.
+ * @tparam TreeType Type of tree to use; must satisfy the TreeType policy API,
+ *     and every point must be held by a single leaf (so cover trees and spill
+ *     trees are not supported).
+ */
+template<typename KernelType = kernel::GaussianKernel,
+         typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class KDE
+{
+ public:
+  //! Convenience typedef.
+  typedef TreeType<MetricType, tree::EmptyStatistic, MatType> Tree;
+
+  static_assert(!tree::TreeTraits<Tree>::HasDuplicatedPoints &&
+      tree::TreeTraits<Tree>::UniqueNumDescendants,
+      "KDE: the tree type must hold every point in a single leaf.");
+
+  /**
+   * Initialize the KDE object with the given parameters.  Call Train() before
+   * estimating densities.
+   *
+   * @param relError Relative error tolerance of the estimates.
+   * @param absError Absolute error tolerance of the estimates.
+   * @param kernel Instantiated kernel.
+   * @param mode Traversal used to estimate the densities.
+   * @param metric Instantiated metric.
+   */
+  KDE(const double relError = 0.05,
+      const double absError = 0.0,
+      KernelType kernel = KernelType(),
+      const KDEMode mode = DUAL_TREE_MODE,
+      MetricType metric = MetricType());
+
+  /**
+   * Copy the given KDE object, including its reference tree.
+   *
+   * @param other KDE object to copy.
+   */
+  KDE(const KDE& other);
+
+  /**
+   * Take ownership of the given KDE object.
+   *
+   * @param other KDE object to take ownership of.
+   */
+  KDE(KDE&& other);
+
+  /**
+   * Copy the given KDE object.
+   *
+   * Use std::move to pass in the object if the old copy is no longer needed.
+   *
+   * @param other KDE object to copy.
+   */
+  KDE& operator=(KDE other);
+
+  //! Delete the reference tree.
+  ~KDE();
+
+  /**
+   * Set the reference set and build the reference tree.  Use std::move to
+   * avoid copying the reference set.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Estimate the density of each point of the given query set.
+   *
+   * @param querySet Set of query points.
+   * @param estimations Vector to store the estimates in.
+   */
+  void Evaluate(const MatType& querySet, arma::vec& estimations);
+
+  /**
+   * Estimate the density of each point of the reference set (the reference set
+   * is used as the query set; each point contributes to its own density).
+   *
+   * @param estimations Vector to store the estimates in.
+   */
+  void Evaluate(arma::vec& estimations);
+
+  //! Get the relative error tolerance.
+  double RelativeError() const { return relError; }
+  //! Set the relative error tolerance; it must be in [0, 1].
+  void RelativeError(const double newError);
+
+  //! Get the absolute error tolerance.
+  double AbsoluteError() const { return absError; }
+  //! Set the absolute error tolerance; it must not be negative.
+  void AbsoluteError(const double newError);
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the kernel.
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the traversal used to estimate the densities.
+  KDEMode Mode() const { return mode; }
+  //! Modify the traversal used to estimate the densities.
+  KDEMode& Mode() { return mode; }
+
+  //! Get whether the model has been trained.
+  bool IsTrained() const { return referenceTree != NULL; }
+
+  //! Get the reference tree (or NULL if the model has not been trained).
+  Tree* ReferenceTree() { return referenceTree; }
+  //! Get the reference set.  The model must have been trained.
+  const MatType& ReferenceSet() const { return referenceTree->Dataset(); }
+
+  //! Get the number of base cases during the last estimation.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores during the last estimation.
+  size_t Scores() const { return scores; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! The type of the rules.
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  //! The instantiated kernel.
+  KernelType kernel;
+  //! The instantiated metric.
+  MetricType metric;
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+  //! The traversal used to estimate the densities.
+  KDEMode mode;
+
+  //! The reference tree, which holds the reference set.
+  Tree* referenceTree;
+  //! Mappings to old reference indices.
+  std::vector<size_t> oldFromNewReferences;
+
+  //! The number of base cases during the last estimation.
+  size_t baseCases;
+  //! The number of scores during the last estimation.
+  size_t scores;
+
+  /**
+   * Add the kernel values of the reference points to the densities of the
+   * given query points, with the current mode.
+   *
+   * @param querySet Set of query points.
+   * @param queryTree Tree built on the query points (in dual-tree mode), or
+   *     NULL.
+   * @param densities Densities of the query points (in the order of
+   *     querySet).
+   */
+  void Estimate(const MatType& querySet,
+                Tree* queryTree,
+                arma::vec& densities);
+
+  //! Normalize the kernel sums of the given query points into densities.
+  void Normalize(arma::vec& estimations);
+
+  //! Check that the model has been trained and that the query set has the
+  //! right dimensionality.
+  void CheckQuerySet(const MatType& querySet) const;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_impl.hpp"
+
+#endif
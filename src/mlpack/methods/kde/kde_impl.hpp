@@ -0,0 +1,481 @@
+/**
+ * @file kde_impl.hpp
+ *
+ * Implementation of the KDE class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde.hpp"
+
+namespace mlpack {
+namespace kde {
+
+//! Call the tree constructor that does mapping.
+template<typename TreeType, typename MatType>
+TreeType* BuildTree(
+    MatType&& dataset,
+    std::vector<size_t>& oldFromNew,
+    const typename std::enable_if<
+        tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
+{
+  return new TreeType(std::forward<MatType>(dataset), oldFromNew);
+}
+
+//! Call the tree constructor that does not do mapping.
+template<typename TreeType, typename MatType>
+TreeType* BuildTree(
+    MatType&& dataset,
+    const std::vector<size_t>& /* oldFromNew */,
+    const typename std::enable_if<
+        !tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
+{
+  return new TreeType(std::forward<MatType>(dataset));
+}
+
+//! Traverse the query tree and the reference tree, using the dual-tree
+//! traverser of the tree.  Returns the number of node combinations that were
+//! pruned.
+template<typename TreeType, typename RuleType>
+size_t DualTreeTraversal(TreeType& queryNode,
+                         TreeType& referenceNode,
+                         RuleType& rules)
+{
+  typename TreeType::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryNode, referenceNode);
+  return traverser.NumPrunes();
+}
+
+//! Traverse a BinarySpaceTree query tree and reference tree, traversing the
+//! top levels of the query tree in parallel.  Returns the number of node
+//! combinations that were pruned.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType,
+         typename RuleType>
+size_t DualTreeTraversal(tree::BinarySpaceTree<MetricType, StatisticType,
+                             MatType, BoundType, SplitType>& queryNode,
+                         tree::BinarySpaceTree<MetricType, StatisticType,
+                             MatType, BoundType, SplitType>& referenceNode,
+                         RuleType& rules)
+{
+  typedef tree::BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+      SplitType> TreeType;
+  typename TreeType::template ParallelDualTreeTraverser<RuleType>
+      traverser(rules);
+  traverser.Traverse(queryNode, referenceNode);
+  return traverser.NumPrunes();
+}
+
+//! Get the normalizer of a kernel that has a Normalizer() function.
+template<typename KernelType>
+auto KernelNormalizer(KernelType& kernel,
+                      const size_t dimension,
+                      const int /* preferred */)
+    -> decltype(kernel.Normalizer(dimension))
+{
+  return kernel.Normalizer(dimension);
+}
+
+//! Kernels without a Normalizer() function give unnormalized estimates.
+template<typename KernelType>
+double KernelNormalizer(KernelType& /* kernel */,
+                        const size_t /* dimension */,
+                        const long /* fallback */)
+{
+  return 1.0;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(
+    const double relError,
+    const double absError,
+    KernelType kernel,
+    const KDEMode mode,
+    MetricType metric) :
+    kernel(std::move(kernel)),
+    metric(std::move(metric)),
+    relError(0.0),
+    absError(0.0),
+    mode(mode),
+    referenceTree(NULL),
+    baseCases(0),
+    scores(0)
+{
+  RelativeError(relError);
+  AbsoluteError(absError);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(const KDE& other) :
+    kernel(other.kernel),
+    metric(other.metric),
+    relError(other.relError),
+    absError(other.absError),
+    mode(other.mode),
+    referenceTree(other.referenceTree ? new Tree(*other.referenceTree) :
+        NULL),
+    oldFromNewReferences(other.oldFromNewReferences),
+    baseCases(other.baseCases),
+    scores(other.scores)
+{
+  // Nothing to do.
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(KDE&& other) :
+    kernel(std::move(other.kernel)),
+    metric(std::move(other.metric)),
+    relError(other.relError),
+    absError(other.absError),
+    mode(other.mode),
+    referenceTree(other.referenceTree),
+    oldFromNewReferences(std::move(other.oldFromNewReferences)),
+    baseCases(other.baseCases),
+    scores(other.scores)
+{
+  // Clear the other object.
+  other.referenceTree = NULL;
+  other.baseCases = 0;
+  other.scores = 0;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>&
+KDE<KernelType, MetricType, MatType, TreeType>::operator=(KDE other)
+{
+  // Clean memory first.
+  delete referenceTree;
+
+  // Move the other object.
+  kernel = std::move(other.kernel);
+  metric = std::move(other.metric);
+  relError = other.relError;
+  absError = other.absError;
+  mode = other.mode;
+  referenceTree = other.referenceTree;
+  oldFromNewReferences = std::move(other.oldFromNewReferences);
+  baseCases = other.baseCases;
+  scores = other.scores;
+
+  // The tree is now ours.
+  other.referenceTree = NULL;
+
+  return *this;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::~KDE()
+{
+  delete referenceTree;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Train(
+    MatType referenceSet)
+{
+  if (referenceSet.n_cols == 0)
+    throw std::invalid_argument("KDE::Train(): the reference set is empty!");
+
+  // Clean up the old tree.
+  delete referenceTree;
+  referenceTree = NULL;
+
+  Timer::Start("kde/tree_building");
+  referenceTree = BuildTree<Tree>(std::move(referenceSet),
+      oldFromNewReferences);
+  Timer::Stop("kde/tree_building");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    const MatType& querySet,
+    arma::vec& estimations)
+{
+  CheckQuerySet(querySet);
+
+  Tree* queryTree = NULL;
+  std::vector<size_t> oldFromNewQueries;
+  if (mode == DUAL_TREE_MODE)
+  {
+    Timer::Start("kde/tree_building");
+    queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    Timer::Stop("kde/tree_building");
+  }
+
+  // In dual-tree mode, the densities are in the order of the query tree.
+  arma::vec densities;
+  Estimate(queryTree ? queryTree->Dataset() : querySet, queryTree, densities);
+  delete queryTree;
+
+  if (oldFromNewQueries.empty())
+  {
+    estimations = std::move(densities);
+  }
+  else
+  {
+    estimations.set_size(querySet.n_cols);
+    for (size_t i = 0; i < densities.n_elem; ++i)
+      estimations[oldFromNewQueries[i]] = densities[i];
+  }
+
+  Normalize(estimations);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    arma::vec& estimations)
+{
+  if (!referenceTree)
+    throw std::invalid_argument("KDE::Evaluate(): the model is not trained!");
+
+  // The reference tree is also the query tree; the densities are in the order
+  // of the reference tree.
+  arma::vec densities;
+  Estimate(referenceTree->Dataset(),
+      (mode == DUAL_TREE_MODE) ? referenceTree : NULL, densities);
+
+  if (oldFromNewReferences.empty())
+  {
+    estimations = std::move(densities);
+  }
+  else
+  {
+    estimations.set_size(densities.n_elem);
+    for (size_t i = 0; i < densities.n_elem; ++i)
+      estimations[oldFromNewReferences[i]] = densities[i];
+  }
+
+  Normalize(estimations);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::RelativeError(
+    const double newError)
+{
+  if (newError < 0.0 || newError > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "KDE::RelativeError(): relative error (" << newError << ") must be "
+        << "in [0, 1]!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  relError = newError;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::AbsoluteError(
+    const double newError)
+{
+  if (newError < 0.0)
+  {
+    std::ostringstream oss;
+    oss << "KDE::AbsoluteError(): absolute error (" << newError << ") must "
+        << "not be negative!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  absError = newError;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Estimate(
+    const MatType& querySet,
+    Tree* queryTree,
+    arma::vec& densities)
+{
+  MLPACK_PROFILE_SCOPE("kde");
+  Timer::Start("kde/computing_densities");
+
+  baseCases = 0;
+  scores = 0;
+  size_t prunes = 0;
+
+  densities.zeros(querySet.n_cols);
+
+  // The absolute error tolerance applies to the normalized estimates, so the
+  // tolerance of each kernel value is scaled by the normalizer.
+  const double normalizer = KernelNormalizer(kernel,
+      referenceTree->Dataset().n_rows, 0);
+  RuleType rules(referenceTree->Dataset(), querySet, densities, relError,
+      absError * normalizer, metric, kernel);
+
+  if (queryTree)
+  {
+    prunes += DualTreeTraversal(*queryTree, *referenceTree, rules);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
+  else
+  {
+    // Small batches keep the load balanced; large enough batches keep the
+    // scheduling overhead negligible next to a full tree traversal.
+    const size_t batchSize = 64;
+    const size_t numBatches = (querySet.n_cols + batchSize - 1) / batchSize;
+
+    #pragma omp parallel if (numBatches > 1)
+    {
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(threadRules);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
+      {
+        const size_t end = std::min((size_t) querySet.n_cols,
+            ((size_t) b + 1) * batchSize);
+        for (size_t i = (size_t) b * batchSize; i < end; ++i)
+          traverser.Traverse(i, *referenceTree);
+      }
+
+      #pragma omp critical
+      {
+        baseCases += threadRules.BaseCases();
+        scores += threadRules.Scores();
+        prunes += traverser.NumPrunes();
+      }
+    }
+  }
+
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+
+  Timer::Stop("kde/computing_densities");
+  WorkCounters::Add("kde", baseCases, scores, prunes);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Normalize(
+    arma::vec& estimations)
+{
+  estimations /= referenceTree->Dataset().n_cols *
+      KernelNormalizer(kernel, referenceTree->Dataset().n_rows, 0);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::CheckQuerySet(
+    const MatType& querySet) const
+{
+  if (!referenceTree)
+    throw std::invalid_argument("KDE::Evaluate(): the model is not trained!");
+
+  if (querySet.n_rows != referenceTree->Dataset().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KDE::Evaluate(): dimensionality of query set (" << querySet.n_rows
+        << ") does not match dimensionality of reference set ("
+        << referenceTree->Dataset().n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename Archive>
+void KDE<KernelType, MetricType, MatType, TreeType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(kernel);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(relError);
+  ar & BOOST_SERIALIZATION_NVP(absError);
+  ar & BOOST_SERIALIZATION_NVP(mode);
+
+  // Delete the current reference tree, if we are loading.
+  if (Archive::is_loading::value)
+  {
+    delete referenceTree;
+    referenceTree = NULL;
+    baseCases = 0;
+    scores = 0;
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(referenceTree);
+  ar & BOOST_SERIALIZATION_NVP(oldFromNewReferences);
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * @file kde_main.cpp
+ *
+ * Executable for running kernel density estimation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "kde.hpp"
+#include "kde_model.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("Kernel Density Estimation",
+    "This program performs kernel density estimation: given a set of reference "
+    "points, it estimates the density of each query point as the average of the"
+    " kernel values between the query point and the reference points, divided "
+    "by the normalizer of the kernel.  Trees are built on the points, so that "
+    "pairs of nodes whose kernel values are all close to each other can be "
+    "approximated; the estimates have a relative error of at most the value of "
+    "the " + PRINT_PARAM_STRING("rel_error") + " parameter and an absolute "
+    "error of at most the value of the " + PRINT_PARAM_STRING("abs_error") +
+    " parameter (if both are 0, the estimates are exact)."
+    "\n\n"
+    "The kernel may be chosen with the " + PRINT_PARAM_STRING("kernel") +
+    " parameter ('gaussian', 'epanechnikov', 'laplacian', 'spherical' or "
+    "'triangular'; the Laplacian and triangular kernels give unnormalized "
+    "estimates), with the bandwidth given by " +
+    PRINT_PARAM_STRING("bandwidth") + ".  The tree may be chosen with the " +
+    PRINT_PARAM_STRING("tree") + " parameter ('kd', 'ball', 'octree' or "
+    "'r-tree'), and the traversal with the " +
+    PRINT_PARAM_STRING("algorithm") + " parameter ('dual-tree' or "
+    "'single-tree').  Both traversals run in parallel."
+    "\n\n"
+    "If no query set is given, the density of each reference point is "
+    "estimated (each reference point contributes to its own density).  A model"
+    " may be saved with " + PRINT_PARAM_STRING("output_model") + " and reused "
+    "with " + PRINT_PARAM_STRING("input_model") + "."
+    "\n\n"
+    "For example, the following will estimate the density of the points of " +
+    PRINT_DATASET("query") + " from the points of " +
+    PRINT_DATASET("reference") + " with a Gaussian kernel of bandwidth 0.2, "
+    "storing the estimates in " + PRINT_DATASET("predictions") + ":"
+    "\n\n" +
+    PRINT_CALL("kde", "reference", "reference", "query", "query",
+        "bandwidth", 0.2, "predictions", "predictions"));
+
+// Required options.
+PARAM_MATRIX_IN("reference", "Input reference dataset.", "r");
+PARAM_MATRIX_IN("query", "Query dataset (optional).", "q");
+
+// The option exists to load or save models.
+PARAM_MODEL_IN(KDEModel, "input_model", "Contains pre-trained KDE model.",
+    "m");
+PARAM_MODEL_OUT(KDEModel, "output_model", "If specified, the KDE model will "
+    "be saved here.", "M");
+
+// Parameters of the model.
+PARAM_STRING_IN("kernel", "Kernel to use: 'gaussian', 'epanechnikov', "
+    "'laplacian', 'spherical', 'triangular'.", "k", "gaussian");
+PARAM_STRING_IN("tree", "Tree to use: 'kd', 'ball', 'octree', 'r-tree'.", "t",
+    "kd");
+PARAM_DOUBLE_IN("bandwidth", "Bandwidth of the kernel.", "b", 1.0);
+
+// Parameters of the estimation.
+PARAM_STRING_IN("algorithm", "Traversal to use: 'dual-tree' or "
+    "'single-tree'.", "a", "dual-tree");
+PARAM_DOUBLE_IN("rel_error", "Relative error tolerance of the estimates.",
+    "e", 0.05);
+PARAM_DOUBLE_IN("abs_error", "Absolute error tolerance of the estimates.",
+    "E", 0.0);
+
+// Output.
+PARAM_COL_OUT("predictions", "Vector to store the density estimates in.",
+    "p");
+
+static void mlpackMain()
+{
+  // A user cannot specify both reference data and a model.
+  RequireOnlyOnePassed({ "reference", "input_model" }, true);
+
+  ReportIgnoredParam({{ "input_model", true }}, "tree");
+  ReportIgnoredParam({{ "input_model", true }}, "kernel");
+  ReportIgnoredParam({{ "input_model", true }}, "bandwidth");
+
+  RequireAtLeastOnePassed({ "predictions", "output_model" }, false,
+      "no results will be saved");
+
+  RequireParamInSet<string>("kernel", { "gaussian", "epanechnikov",
+      "laplacian", "spherical", "triangular" }, true, "unknown kernel");
+  RequireParamInSet<string>("tree", { "kd", "ball", "octree", "r-tree" }, true,
+      "unknown tree type");
+  RequireParamInSet<string>("algorithm", { "dual-tree", "single-tree" }, true,
+      "unknown algorithm");
+  RequireParamValue<double>("bandwidth", [](double x) { return x > 0.0; },
+      true, "bandwidth must be positive");
+  RequireParamValue<double>("rel_error",
+      [](double x) { return x >= 0.0 && x <= 1.0; }, true,
+      "relative error must be in [0, 1]");
+  RequireParamValue<double>("abs_error", [](double x) { return x >= 0.0; },
+      true, "absolute error must not be negative");
+
+  KDEModel* kde;
+  if (CLI::HasParam("reference"))
+  {
+    kde = new KDEModel();
+
+    const string kernelStr = CLI::GetParam<string>("kernel");
+    if (kernelStr == "gaussian")
+      kde->KernelType() = KDEModel::GAUSSIAN_KERNEL;
+    else if (kernelStr == "epanechnikov")
+      kde->KernelType() = KDEModel::EPANECHNIKOV_KERNEL;
+    else if (kernelStr == "laplacian")
+      kde->KernelType() = KDEModel::LAPLACIAN_KERNEL;
+    else if (kernelStr == "spherical")
+      kde->KernelType() = KDEModel::SPHERICAL_KERNEL;
+    else if (kernelStr == "triangular")
+      kde->KernelType() = KDEModel::TRIANGULAR_KERNEL;
+
+    const string treeStr = CLI::GetParam<string>("tree");
+    if (treeStr == "kd")
+      kde->TreeType() = KDEModel::KD_TREE;
+    else if (treeStr == "ball")
+      kde->TreeType() = KDEModel::BALL_TREE;
+    else if (treeStr == "octree")
+      kde->TreeType() = KDEModel::OCTREE;
+    else if (treeStr == "r-tree")
+      kde->TreeType() = KDEModel::R_TREE;
+
+    kde->Bandwidth() = CLI::GetParam<double>("bandwidth");
+
+    arma::mat referenceSet = std::move(CLI::GetParam<arma::mat>("reference"));
+
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceSet.n_rows << "x" << referenceSet.n_cols << ")." << endl;
+
+    kde->BuildModel(std::move(referenceSet));
+  }
+  else
+  {
+    // Load the model from file.
+    kde = CLI::GetParam<KDEModel*>("input_model");
+
+    Log::Info << "Using KDE model from '"
+        << CLI::GetPrintableParam<KDEModel>("input_model") << "'." << endl;
+  }
+
+  // The error tolerances and the traversal may change for a loaded model.
+  kde->RelativeError() = CLI::GetParam<double>("rel_error");
+  kde->AbsoluteError() = CLI::GetParam<double>("abs_error");
+  kde->Mode() = (CLI::GetParam<string>("algorithm") == "single-tree") ?
+      SINGLE_TREE_MODE : DUAL_TREE_MODE;
+
+  // Estimate the densities, if desired.
+  if (CLI::HasParam("predictions"))
+  {
+    arma::vec estimations;
+    if (CLI::HasParam("query"))
+    {
+      arma::mat querySet = std::move(CLI::GetParam<arma::mat>("query"));
+      Log::Info << "Using query data from '"
+          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+          << querySet.n_rows << "x" << querySet.n_cols << ")." << endl;
+
+      kde->Evaluate(std::move(querySet), estimations);
+    }
+    else
+    {
+      kde->Evaluate(estimations);
+    }
+
+    CLI::GetParam<arma::vec>("predictions") = std::move(estimations);
+  }
+
+  // Save the output model.
+  CLI::GetParam<KDEModel*>("output_model") = kde;
+}
@@ -0,0 +1,306 @@
+/**
+ * @file kde_model.hpp
+ *
+ * This is a model for kernel density estimation.  It is useful in that it
+ * provides an easy way to serialize a model, abstracts away the different
+ * types of kernels and trees, and also reflects the KDE API and automatically
+ * directs to the right kernel and tree types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_MODEL_HPP
+#define MLPACK_METHODS_KDE_KDE_MODEL_HPP
+
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+#include <mlpack/core/kernels/spherical_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/octree.hpp>
+#include <boost/variant.hpp>
+#include "kde.hpp"
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * Alias template for KDE.
+ */
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+using KDEType = KDE<KernelType, metric::EuclideanDistance, arma::mat,
+    TreeType>;
+
+/**
+ * TrainVisitor sets the reference set of the given KDEType and builds the
+ * reference tree.
+ */
+class TrainVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The reference set to use for training.
+  arma::mat&& referenceSet;
+
+ public:
+  //! Train the given KDEType.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! Construct the TrainVisitor object with the given reference set.
+  TrainVisitor(arma::mat&& referenceSet) :
+      referenceSet(std::move(referenceSet))
+  {};
+};
+
+/**
+ * EvaluateVisitor sets the error tolerances and the mode of the given KDEType,
+ * and estimates the density of the query points (or, if no query set is
+ * given, of the reference points).
+ */
+class EvaluateVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The query set, or NULL for the reference set.
+  const arma::mat* querySet;
+  //! Output estimations.
+  arma::vec& estimations;
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+  //! The traversal to use.
+  KDEMode mode;
+
+ public:
+  //! Estimate the densities with the given KDEType.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! Construct the EvaluateVisitor with the given parameters.
+  EvaluateVisitor(const arma::mat* querySet,
+                  arma::vec& estimations,
+                  const double relError,
+                  const double absError,
+                  const KDEMode mode) :
+      querySet(querySet),
+      estimations(estimations),
+      relError(relError),
+      absError(absError),
+      mode(mode)
+  {};
+};
+
+/**
+ * CopyVisitor returns a copy of the given KDEType instance.
+ */
+template<typename VariantType>
+class CopyVisitor : public boost::static_visitor<VariantType>
+{
+ public:
+  //! Copy the KDEType object.
+  template<typename KDEType>
+  VariantType operator()(const KDEType* kde) const;
+};
+
+/**
+ * DeleteVisitor deletes the given KDEType instance.
+ */
+class DeleteVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Delete the KDEType object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+};
+
+class KDEModel
+{
+ public:
+  enum KernelTypes
+  {
+    GAUSSIAN_KERNEL,
+    EPANECHNIKOV_KERNEL,
+    LAPLACIAN_KERNEL,
+    SPHERICAL_KERNEL,
+    TRIANGULAR_KERNEL
+  };
+
+  enum TreeTypes
+  {
+    KD_TREE,
+    BALL_TREE,
+    OCTREE,
+    R_TREE
+  };
+
+ private:
+  //! The bandwidth of the kernel.
+  double bandwidth;
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+  //! The traversal to use.
+  KDEMode mode;
+  //! The type of kernel.
+  KernelTypes kernelType;
+  //! The type of tree.
+  TreeTypes treeType;
+
+  /**
+   * kdeModel holds an instance of the KDE class for the current kernelType and
+   * treeType.  It is initialized every time BuildModel is executed.  We access
+   * the contained value through the visitor classes defined above.
+   */
+  boost::variant<KDEType<kernel::GaussianKernel, tree::KDTree>*,
+                 KDEType<kernel::GaussianKernel, tree::BallTree>*,
+                 KDEType<kernel::GaussianKernel, tree::Octree>*,
+                 KDEType<kernel::GaussianKernel, tree::RTree>*,
+                 KDEType<kernel::EpanechnikovKernel, tree::KDTree>*,
+                 KDEType<kernel::EpanechnikovKernel, tree::BallTree>*,
+                 KDEType<kernel::EpanechnikovKernel, tree::Octree>*,
+                 KDEType<kernel::EpanechnikovKernel, tree::RTree>*,
+                 KDEType<kernel::LaplacianKernel, tree::KDTree>*,
+                 KDEType<kernel::LaplacianKernel, tree::BallTree>*,
+                 KDEType<kernel::LaplacianKernel, tree::Octree>*,
+                 KDEType<kernel::LaplacianKernel, tree::RTree>*,
+                 KDEType<kernel::SphericalKernel, tree::KDTree>*,
+                 KDEType<kernel::SphericalKernel, tree::BallTree>*,
+                 KDEType<kernel::SphericalKernel, tree::Octree>*,
+                 KDEType<kernel::SphericalKernel, tree::RTree>*,
+                 KDEType<kernel::TriangularKernel, tree::KDTree>*,
+                 KDEType<kernel::TriangularKernel, tree::BallTree>*,
+                 KDEType<kernel::TriangularKernel, tree::Octree>*,
+                 KDEType<kernel::TriangularKernel, tree::RTree>*> kdeModel;
+
+ public:
+  /**
+   * Initialize the KDEModel with the given parameters.  Call BuildModel()
+   * before estimating densities.
+   *
+   * @param bandwidth Bandwidth of the kernel.
+   * @param relError Relative error tolerance of the estimates.
+   * @param absError Absolute error tolerance of the estimates.
+   * @param kernelType Type of kernel to use.
+   * @param treeType Type of tree to use.
+   * @param mode Traversal to use.
+   */
+  KDEModel(const double bandwidth = 1.0,
+           const double relError = 0.05,
+           const double absError = 0.0,
+           const KernelTypes kernelType = KernelTypes::GAUSSIAN_KERNEL,
+           const TreeTypes treeType = TreeTypes::KD_TREE,
+           const KDEMode mode = DUAL_TREE_MODE);
+
+  /**
+   * Copy the given KDEModel.
+   *
+   * @param other KDEModel to copy.
+   */
+  KDEModel(const KDEModel& other);
+
+  /**
+   * Take ownership of the given KDEModel.
+   *
+   * @param other KDEModel to take ownership of.
+   */
+  KDEModel(KDEModel&& other);
+
+  /**
+   * Copy the given KDEModel.
+   *
+   * Use std::move to pass in the model if the old copy is no longer needed.
+   *
+   * @param other KDEModel to copy.
+   */
+  KDEModel& operator=(KDEModel other);
+
+  /**
+   * Clean memory, if necessary.
+   */
+  ~KDEModel();
+
+  //! Serialize the KDE model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+  //! Get the bandwidth of the kernel.
+  double Bandwidth() const { return bandwidth; }
+  //! Modify the bandwidth of the kernel (this takes effect at the next call to
+  //! BuildModel()).
+  double& Bandwidth() { return bandwidth; }
+
+  //! Get the relative error tolerance.
+  double RelativeError() const { return relError; }
+  //! Modify the relative error tolerance.
+  double& RelativeError() { return relError; }
+
+  //! Get the absolute error tolerance.
+  double AbsoluteError() const { return absError; }
+  //! Modify the absolute error tolerance.
+  double& AbsoluteError() { return absError; }
+
+  //! Get the traversal to use.
+  KDEMode Mode() const { return mode; }
+  //! Modify the traversal to use.
+  KDEMode& Mode() { return mode; }
+
+  //! Get the type of kernel.
+  KernelTypes KernelType() const { return kernelType; }
+  //! Modify the type of kernel (this takes effect at the next call to
+  //! BuildModel()).
+  KernelTypes& KernelType() { return kernelType; }
+
+  //! Get the type of tree.
+  TreeTypes TreeType() const { return treeType; }
+  //! Modify the type of tree (this takes effect at the next call to
+  //! BuildModel()).
+  TreeTypes& TreeType() { return treeType; }
+
+  /**
+   * Build the reference tree on the given reference set, with the current
+   * kernel and tree types.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void BuildModel(arma::mat&& referenceSet);
+
+  /**
+   * Estimate the density of each point of the given query set.
+   *
+   * @param querySet Set of query points.
+   * @param estimations Vector to store the estimates in.
+   */
+  void Evaluate(arma::mat&& querySet, arma::vec& estimations);
+
+  /**
+   * Estimate the density of each point of the reference set.
+   *
+   * @param estimations Vector to store the estimates in.
+   */
+  void Evaluate(arma::vec& estimations);
+
+ private:
+  //! Create the KDE object for the given kernel type and the current tree
+  //! type.
+  template<typename KernelClass>
+  void InitializeModel();
+
+  //! Clean up memory.
+  void CleanMemory();
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation (of the templated and inline functions).
+#include "kde_model_impl.hpp"
+
+#endif
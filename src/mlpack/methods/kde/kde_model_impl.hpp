@@ -0,0 +1,238 @@
+/**
+ * @file kde_model_impl.hpp
+ *
+ * Implementation of serialize() and inline functions for KDEModel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_MODEL_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_MODEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_model.hpp"
+
+#include <boost/serialization/variant.hpp>
+
+namespace mlpack {
+namespace kde {
+
+//! Initialize the KDEModel with the given parameters.
+inline KDEModel::KDEModel(const double bandwidth,
+                          const double relError,
+                          const double absError,
+                          const KernelTypes kernelType,
+                          const TreeTypes treeType,
+                          const KDEMode mode) :
+    bandwidth(bandwidth),
+    relError(relError),
+    absError(absError),
+    mode(mode),
+    kernelType(kernelType),
+    treeType(treeType)
+{
+  // Nothing to do.
+}
+
+// Copy constructor.
+inline KDEModel::KDEModel(const KDEModel& other) :
+    bandwidth(other.bandwidth),
+    relError(other.relError),
+    absError(other.absError),
+    mode(other.mode),
+    kernelType(other.kernelType),
+    treeType(other.treeType),
+    kdeModel(boost::apply_visitor(CopyVisitor<decltype(kdeModel)>(),
+        other.kdeModel))
+{
+  // Nothing to do.
+}
+
+// Move constructor.
+inline KDEModel::KDEModel(KDEModel&& other) :
+    bandwidth(other.bandwidth),
+    relError(other.relError),
+    absError(other.absError),
+    mode(other.mode),
+    kernelType(other.kernelType),
+    treeType(other.treeType),
+    kdeModel(std::move(other.kdeModel))
+{
+  // Reset other model.
+  other.kdeModel = decltype(other.kdeModel)();
+}
+
+inline KDEModel& KDEModel::operator=(KDEModel other)
+{
+  CleanMemory();
+
+  bandwidth = other.bandwidth;
+  relError = other.relError;
+  absError = other.absError;
+  mode = other.mode;
+  kernelType = other.kernelType;
+  treeType = other.treeType;
+  kdeModel = std::move(other.kdeModel);
+
+  // The pointer is now ours, so it must not be deleted with other.
+  other.kdeModel = decltype(other.kdeModel)();
+
+  return *this;
+}
+
+// Clean memory, if necessary.
+inline KDEModel::~KDEModel()
+{
+  CleanMemory();
+}
+
+inline void KDEModel::BuildModel(arma::mat&& referenceSet)
+{
+  // Clean memory, if necessary.
+  CleanMemory();
+
+  switch (kernelType)
+  {
+    case GAUSSIAN_KERNEL:
+      InitializeModel<kernel::GaussianKernel>();
+      break;
+
+    case EPANECHNIKOV_KERNEL:
+      InitializeModel<kernel::EpanechnikovKernel>();
+      break;
+
+    case LAPLACIAN_KERNEL:
+      InitializeModel<kernel::LaplacianKernel>();
+      break;
+
+    case SPHERICAL_KERNEL:
+      InitializeModel<kernel::SphericalKernel>();
+      break;
+
+    case TRIANGULAR_KERNEL:
+      InitializeModel<kernel::TriangularKernel>();
+      break;
+  }
+
+  Log::Info << "Building reference tree..." << std::endl;
+  TrainVisitor train(std::move(referenceSet));
+  boost::apply_visitor(train, kdeModel);
+  Log::Info << "Tree built." << std::endl;
+}
+
+inline void KDEModel::Evaluate(arma::mat&& querySet, arma::vec& estimations)
+{
+  EvaluateVisitor evaluate(&querySet, estimations, relError, absError, mode);
+  boost::apply_visitor(evaluate, kdeModel);
+}
+
+inline void KDEModel::Evaluate(arma::vec& estimations)
+{
+  EvaluateVisitor evaluate(NULL, estimations, relError, absError, mode);
+  boost::apply_visitor(evaluate, kdeModel);
+}
+
+template<typename KernelClass>
+void KDEModel::InitializeModel()
+{
+  const KernelClass kernel(bandwidth);
+
+  switch (treeType)
+  {
+    case KD_TREE:
+      kdeModel = new KDEType<KernelClass, tree::KDTree>(relError, absError,
+          kernel, mode);
+      break;
+
+    case BALL_TREE:
+      kdeModel = new KDEType<KernelClass, tree::BallTree>(relError, absError,
+          kernel, mode);
+      break;
+
+    case OCTREE:
+      kdeModel = new KDEType<KernelClass, tree::Octree>(relError, absError,
+          kernel, mode);
+      break;
+
+    case R_TREE:
+      kdeModel = new KDEType<KernelClass, tree::RTree>(relError, absError,
+          kernel, mode);
+      break;
+  }
+}
+
+// Clean memory.
+inline void KDEModel::CleanMemory()
+{
+  boost::apply_visitor(DeleteVisitor(), kdeModel);
+  kdeModel = decltype(kdeModel)();
+}
+
+//! Train the given KDEType.
+template<typename KDEType>
+void TrainVisitor::operator()(KDEType* kde) const
+{
+  if (kde)
+    return kde->Train(std::move(referenceSet));
+  throw std::runtime_error("no KDE model initialized");
+}
+
+//! Estimate the densities with the given KDEType.
+template<typename KDEType>
+void EvaluateVisitor::operator()(KDEType* kde) const
+{
+  if (!kde)
+    throw std::runtime_error("no KDE model initialized");
+
+  kde->RelativeError(relError);
+  kde->AbsoluteError(absError);
+  kde->Mode() = mode;
+
+  if (querySet)
+    kde->Evaluate(*querySet, estimations);
+  else
+    kde->Evaluate(estimations);
+}
+
+//! Copy the given KDEType.
+template<typename VariantType>
+template<typename KDEType>
+VariantType CopyVisitor<VariantType>::operator()(const KDEType* kde) const
+{
+  if (kde)
+    return VariantType(new KDEType(*kde));
+  return VariantType((KDEType*) NULL);
+}
+
+//! For cleaning memory.
+template<typename KDEType>
+void DeleteVisitor::operator()(KDEType* kde) const
+{
+  if (kde)
+    delete kde;
+}
+
+// Serialize the model.
+template<typename Archive>
+void KDEModel::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(bandwidth);
+  ar & BOOST_SERIALIZATION_NVP(relError);
+  ar & BOOST_SERIALIZATION_NVP(absError);
+  ar & BOOST_SERIALIZATION_NVP(mode);
+  ar & BOOST_SERIALIZATION_NVP(kernelType);
+  ar & BOOST_SERIALIZATION_NVP(treeType);
+
+  // This should never happen, but just in case...
+  if (Archive::is_loading::value)
+    CleanMemory();
+
+  ar & BOOST_SERIALIZATION_NVP(kdeModel);
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file kde_rules.hpp
+ *
+ * Rules for kernel density estimation, so that it can be done with arbitrary
+ * tree types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_RULES_HPP
+#define MLPACK_METHODS_KDE_KDE_RULES_HPP
+
+#include <mlpack/core/tree/traversal_info.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * The KDERules class is a template helper class used by the KDE class when
+ * estimating densities.  Each base case adds the kernel value of a query point
+ * and a reference point to the (unnormalized) density of the query point.
+ *
+ * A query node and a reference node are pruned when the kernel values of all
+ * pairs of their points lie within a small enough interval: if the kernel
+ * values lie in [minKernel, maxKernel] (found from the range of distances
+ * between the nodes, since the kernel decreases with the distance), taking the
+ * midpoint of the interval for every pair makes an error of at most
+ * (maxKernel - minKernel) / 2 per pair.  Pruning when
+ *
+ *   maxKernel - minKernel <= 2 (relError * minKernel + absError)
+ *
+ * guarantees that the relative error of each density is at most relError and
+ * that the error of each (unnormalized) kernel sum is at most absError times
+ * the number of reference points.
+ *
+ * The densities are held by reference, so copies of the rules share them; the
+ * parallel traversers give disjoint sets of query points to the copies, so no
+ * locking is necessary.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam KernelType The kernel to use; its value must not increase with the
+ *     distance.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename MetricType, typename KernelType, typename TreeType>
+class KDERules
+{
+ public:
+  //! The type of the datasets.
+  typedef typename TreeType::Mat MatType;
+
+  /**
+   * Construct the KDERules object.  This is usually done from within the KDE
+   * class at evaluation time.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param densities Vector of (unnormalized) densities of the query points,
+   *     which the kernel values are added to.
+   * @param relError Relative error tolerance.
+   * @param absError Absolute error tolerance of each kernel value.
+   * @param metric Instantiated metric.
+   * @param kernel Instantiated kernel.
+   */
+  KDERules(const MatType& referenceSet,
+           const MatType& querySet,
+           arma::vec& densities,
+           const double relError,
+           const double absError,
+           MetricType& metric,
+           const KernelType& kernel);
+
+  /**
+   * Compute the base case between the given query point and reference point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (its contribution to the density has been added).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  Since the pruning bound does
+   * not change during the traversal, this returns the old score.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the nodes should not be recursed
+   * into at all (their contribution to the densities has been added).
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  Since the pruning bound does
+   * not change during the traversal, this returns the old score.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
+
+  //! Get the number of scores (that is, calls to RangeDistance()).
+  size_t Scores() const { return scores; }
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
+
+ private:
+  //! The reference set.
+  const MatType& referenceSet;
+  //! The query set.
+  const MatType& querySet;
+  //! The (unnormalized) densities of the query points.
+  arma::vec& densities;
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance of each kernel value.
+  double absError;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The instantiated kernel.
+  const KernelType& kernel;
+
+  //! Return whether the kernel values for the given range of distances are
+  //! close enough to be approximated, and set the approximation.
+  bool CanPrune(const double minDistance,
+                const double maxDistance,
+                double& kernelValue) const;
+
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_rules_impl.hpp"
+
+#endif
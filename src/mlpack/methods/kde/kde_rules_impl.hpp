@@ -0,0 +1,146 @@
+/**
+ * @file kde_rules_impl.hpp
+ *
+ * Implementation of rules for kernel density estimation with generic trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_RULES_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_rules.hpp"
+
+namespace mlpack {
+namespace kde {
+
+template<typename MetricType, typename KernelType, typename TreeType>
+KDERules<MetricType, KernelType, TreeType>::KDERules(
+    const MatType& referenceSet,
+    const MatType& querySet,
+    arma::vec& densities,
+    const double relError,
+    const double absError,
+    MetricType& metric,
+    const KernelType& kernel) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    densities(densities),
+    relError(relError),
+    absError(absError),
+    metric(metric),
+    kernel(kernel),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
+//! The base case.  Add the kernel value of the two points to the density of
+//! the query point.
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline
+double KDERules<MetricType, KernelType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
+      referenceSet.unsafe_col(referenceIndex));
+  ++baseCases;
+
+  densities[queryIndex] += kernel.Evaluate(distance);
+
+  return distance;
+}
+
+//! Single-tree scoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  const auto distances = referenceNode.RangeDistance(
+      querySet.unsafe_col(queryIndex));
+  ++scores;
+
+  double kernelValue;
+  if (CanPrune(distances.Lo(), distances.Hi(), kernelValue))
+  {
+    densities[queryIndex] += referenceNode.NumDescendants() * kernelValue;
+    return DBL_MAX;
+  }
+
+  // Recurse into the closest nodes first.
+  return distances.Lo();
+}
+
+//! Single-tree rescoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Rescore(
+    const size_t /* queryIndex */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  // If it wasn't pruned before, it isn't pruned now.
+  return oldScore;
+}
+
+//! Dual-tree scoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  const auto distances = referenceNode.RangeDistance(queryNode);
+  ++scores;
+
+  double kernelValue;
+  if (CanPrune(distances.Lo(), distances.Hi(), kernelValue))
+  {
+    // Every query point gets the approximation for every reference point.
+    const double contribution = referenceNode.NumDescendants() * kernelValue;
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+      densities[queryNode.Descendant(i)] += contribution;
+    return DBL_MAX;
+  }
+
+  // Recurse into the closest nodes first.
+  return distances.Lo();
+}
+
+//! Dual-tree rescoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Rescore(
+    TreeType& /* queryNode */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  // If it wasn't pruned before, it isn't pruned now.
+  return oldScore;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline
+bool KDERules<MetricType, KernelType, TreeType>::CanPrune(
+    const double minDistance,
+    const double maxDistance,
+    double& kernelValue) const
+{
+  // The kernel decreases with the distance.
+  const double maxKernel = kernel.Evaluate(minDistance);
+  const double minKernel = kernel.Evaluate(maxDistance);
+
+  if (maxKernel - minKernel > 2.0 * (relError * minKernel + absError))
+    return false;
+
+  kernelValue = (maxKernel + minKernel) / 2.0;
+  return true;
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
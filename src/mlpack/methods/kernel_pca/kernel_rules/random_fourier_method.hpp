@@ -0,0 +1,81 @@
+/**
+ * @file random_fourier_method.hpp
+ *
+ * Use random Fourier features for approximating the kernel principal
+ * components.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * Approximate kernel PCA with random Fourier features (for shift-invariant
+ * kernels such as GaussianKernel and LaplacianKernel).  The points are mapped
+ * to explicit features, and linear PCA is performed on the centered features:
+ * the eigendecomposition is of a (features x features) covariance matrix,
+ * instead of the (points x points) kernel matrix, and no kernel is ever
+ * evaluated.  The eigenvectors are those of the feature space.
+ */
+template<typename KernelType>
+class RandomFourierKernelRule
+{
+ public:
+  /**
+   * Compute the approximate kernel principal components with random Fourier
+   * features.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors (in the feature space) will be written to
+   *     this matrix.
+   * @param rank Rank to be used for matrix approximation; the number of
+   *     features is rank rounded up to an even number.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                KernelType kernel = KernelType())
+  {
+    kernel::RandomFourierFeatures<KernelType> rff(data.n_rows,
+        std::max((size_t) 1, (rank + 1) / 2), kernel);
+    arma::mat features;
+    rff.Transform(data, features);
+
+    // Centering the features centers the approximate kernel matrix, which is
+    // their Gram matrix.
+    features.each_col() -= arma::mean(features, 1);
+
+    // The nonzero eigenvalues of the centered kernel matrix are those of the
+    // scatter matrix of the features.
+    arma::eig_sym(eigval, eigvec, features * features.t());
+
+    // Swap the eigenvalues since they are ordered backwards (we need largest
+    // to smallest).
+    for (size_t i = 0; i < floor(eigval.n_elem / 2.0); ++i)
+      eigval.swap_rows(i, (eigval.n_elem - 1) - i);
+
+    // Flip the coefficients to produce the same effect.
+    eigvec = arma::fliplr(eigvec);
+
+    transformedData = eigvec.t() * features;
+  }
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 
+#include "point_centroid_distance.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -44,6 +46,8 @@ class HamerlyKMeans
   const MatType& dataset;
   //! The instantiated metric.
   MetricType& metric;
+  //! The distances between the points and the centroids.
+  PointCentroidDistance<MetricType, MatType> distance;
 
   //! Minimum cluster distances from each cluster.
   arma::vec minClusterDistances;
@@ -192,7 +192,8 @@ Cluster(const MatType& data,
       centroids.zeros(data.n_rows, clusters);
       for (size_t i = 0; i < data.n_cols; ++i)
       {
-        centroids.col(assignments[i]) += arma::vec(data.col(i));
+        PointCentroidDistance<MetricType, MatType>::AddPoint(data, i,
+            centroids, assignments[i]);
         counts[assignments[i]]++;
       }
 
@@ -213,6 +214,8 @@ Cluster(const MatType& data,
 
   do
   {
+    MLPACK_PROFILE_SCOPE("kmeans_iteration");
+
     // We have two centroid matrices.  We don't want to copy anything, so,
     // depending on the iteration number, we use a different centroid matrix...
     if (iteration % 2 == 0)
@@ -299,7 +302,8 @@ Cluster(const MatType& data,
     centroids.zeros(data.n_rows, clusters);
     for (size_t i = 0; i < data.n_cols; ++i)
     {
-      centroids.col(assignments[i]) += arma::vec(data.col(i));
+      PointCentroidDistance<MetricType, MatType>::AddPoint(data, i, centroids,
+          assignments[i]);
       counts[assignments[i]]++;
     }
 
@@ -313,6 +317,8 @@ Cluster(const MatType& data,
 
   // Calculate final assignments in parallel over the entire dataset.
   assignments.set_size(data.n_cols);
+  PointCentroidDistance<MetricType, MatType> pointDistance(data, metric);
+  pointDistance.Centroids(centroids);
 
   #pragma omp parallel for
   for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
@@ -323,7 +329,7 @@ Cluster(const MatType& data,
 
     for (size_t j = 0; j < centroids.n_cols; j++)
     {
-      const double distance = metric.Evaluate(data.col(i), centroids.col(j));
+      const double distance = pointDistance.Evaluate(i, j);
 
       if (distance < minDistance)
       {
@@ -17,10 +17,13 @@
 #include "allow_empty_clusters.hpp"
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
+#include "kmeans_plus_plus_initialization.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -43,14 +46,23 @@ PROGRAM_INFO("K-Means Clustering", "This program performs K-Means clustering "
     "used in each sample, the " + PRINT_PARAM_STRING("percentage") +
     " parameter is used (it should be a value between 0.0 and 1.0)."
     "\n\n"
+    "Otherwise, the initial points are chosen with the strategy given by the "
+    + PRINT_PARAM_STRING("initialization") + " parameter: 'sample' takes "
+    "random points of the dataset, 'kmeans++' uses k-means++ seeding, and "
+    "'kmeans||' uses scalable k-means++, which samples candidate points in "
+    "a few parallel rounds (" + PRINT_PARAM_STRING("rounds") + ", with about "
+    + PRINT_PARAM_STRING("oversampling") + " candidates per round) and then "
+    "reduces them to the initial points with k-means++."
+    "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the " + PRINT_PARAM_STRING("algorithm") + " "
     " option.  The standard O(kN) approach can be used ('naive').  Other "
     "options include the Pelleg-Moore tree-based algorithm ('pelleg-moore'), "
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
     "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
-    "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "algorithm ('dualtree'), the dual-tree k-means algorithm using the "
+    "cover tree ('dualtree-covertree'), and mini-batch k-means ('minibatch'), "
+    "which only considers a random batch of 1024 points in each iteration."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -120,9 +132,19 @@ PARAM_INT_IN("samplings", "Number of samplings to perform for refined start "
 PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
+// Parameters for the other initial point strategies.
+PARAM_STRING_IN("initialization", "Initial point strategy to use when "
+    "--refined_start is not specified ('sample', 'kmeans++', or 'kmeans||').",
+    "n", "sample");
+PARAM_INT_IN("rounds", "Number of sampling rounds of the 'kmeans||' "
+    "initialization.", "R", 5);
+PARAM_DOUBLE_IN("oversampling", "Expected number of candidate points sampled "
+    "per round of the 'kmeans||' initialization (0 uses twice the number of "
+    "clusters).", "O", 0.0);
+
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', "
+    "'dualtree-covertree', or 'minibatch').", "a", "naive");
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -161,7 +183,28 @@ static void mlpackMain()
         "sample must be greater than 0.0 and less than or equal to 1.0");
     const double percentage = CLI::GetParam<double>("percentage");
 
+    ReportIgnoredParam({{ "refined_start", true }}, "initialization");
     FindEmptyClusterPolicy<RefinedStart>(RefinedStart(samplings, percentage));
+    return;
+  }
+
+  RequireParamInSet<string>("initialization", { "sample", "kmeans++",
+      "kmeans||" }, true, "unknown initialization strategy");
+  const string initialization = CLI::GetParam<string>("initialization");
+  if (initialization == "kmeans++")
+  {
+    FindEmptyClusterPolicy<KMeansPlusPlusInitialization>(
+        KMeansPlusPlusInitialization());
+  }
+  else if (initialization == "kmeans||")
+  {
+    RequireParamValue<int>("rounds", [](int x) { return x >= 0; }, true,
+        "number of rounds must be nonnegative");
+    RequireParamValue<double>("oversampling", [](double x) { return x >= 0.0; },
+        true, "oversampling must be nonnegative");
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(
+        KMeansParallelInitialization(CLI::GetParam<int>("rounds"),
+        CLI::GetParam<double>("oversampling")));
   }
   else
   {
@@ -193,8 +236,8 @@ template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
 void FindLloydStepType(const InitialPartitionPolicy& ipp)
 {
   RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
-      "dualtree", "dualtree-covertree", "naive" }, true, "unknown k-means "
-      "algorithm");
+      "dualtree", "dualtree-covertree", "naive", "minibatch" }, true,
+      "unknown k-means algorithm");
 
   const string algorithm = CLI::GetParam<string>("algorithm");
   if (algorithm == "elkan")
@@ -212,6 +255,9 @@ void FindLloydStepType(const InitialPartitionPolicy& ipp)
         CoverTreeDualTreeKMeans>(ipp);
   else if (algorithm == "naive")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(ipp);
+  else if (algorithm == "minibatch")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        MiniBatchKMeans>(ipp);
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -0,0 +1,182 @@
+/**
+ * @file kmeans_parallel_initialization.hpp
+ *
+ * The scalable k-means++ (k-means||) initialization strategy, which
+ * oversamples candidate centroids in a few parallel rounds and then reduces
+ * them to the initial centroids with a weighted k-means++.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kmeans_plus_plus_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means|| initialization strategy.  k-means++ needs one pass over the
+ * data per centroid; k-means|| instead starts from one random point, and in
+ * each of a few rounds samples every point independently with probability
+ * proportional to its squared distance to the nearest candidate, so that about
+ * 'oversampling' candidates are added per round.  Every candidate is then
+ * weighted by the number of points nearest to it, and the initial centroids
+ * are chosen among the candidates with a weighted k-means++.  This is an
+ * implementation of the following paper:
+ *
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ *
+ * The points are sampled in parallel over blocks, and every block draws from
+ * its own math::RandomStream(), so the candidates only depend on the random
+ * seed and not on the number of threads.
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the initialization, optionally specifying the number of sampling
+   * rounds and the expected number of candidates sampled per round.
+   *
+   * @param rounds Number of sampling rounds.
+   * @param oversampling Expected number of candidates per round; if 0, twice
+   *     the number of clusters is used.
+   */
+  KMeansParallelInitialization(const size_t rounds = 5,
+                               const double oversampling = 0.0) :
+      rounds(rounds), oversampling(oversampling) { }
+
+  /**
+   * Initialize the centroids matrix with k-means||.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids);
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+  //! Get the expected number of candidates per round (0 means 2 * clusters).
+  double Oversampling() const { return oversampling; }
+  //! Modify the expected number of candidates per round (0 means
+  //! 2 * clusters).
+  double& Oversampling() { return oversampling; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(rounds);
+    ar & BOOST_SERIALIZATION_NVP(oversampling);
+  }
+
+ private:
+  //! The number of sampling rounds.
+  size_t rounds;
+  //! The expected number of candidates per round.
+  double oversampling;
+};
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids)
+{
+  typedef KMeansPlusPlusInitialization PlusPlus;
+
+  const double factor = (oversampling > 0.0) ? oversampling :
+      2.0 * clusters;
+
+  arma::vec distances(data.n_cols);
+  distances.fill(DBL_MAX);
+  arma::Row<size_t> nearest(data.n_cols, arma::fill::zeros);
+
+  // Start with one point chosen uniformly.
+  arma::mat candidates(data.n_rows, 1);
+  candidates.col(0) = data.col((size_t) math::RandInt(data.n_cols));
+  PlusPlus::UpdateDistances(data, candidates, 0, 1, distances, nearest);
+
+  // Every block of points of every round gets its own random stream.
+  const size_t blockSize = 1024;
+  const size_t blocks = (data.n_cols + blockSize - 1) / blockSize;
+  const size_t streamBase = (size_t) math::RandInt(
+      std::numeric_limits<int>::max());
+
+  for (size_t round = 0; round < rounds; ++round)
+  {
+    const double cost = arma::accu(distances);
+    if (!(cost > 0.0))
+      break;
+
+    std::vector<std::vector<size_t>> sampled(blocks);
+    Threads::ParallelFor(0, blocks, [&](const size_t block)
+    {
+      std::mt19937 generator = math::RandomStream(streamBase +
+          round * blocks + block);
+      std::uniform_real_distribution<> uniform;
+
+      const size_t end = std::min((size_t) data.n_cols,
+          (block + 1) * blockSize);
+      for (size_t i = block * blockSize; i < end; ++i)
+        if (uniform(generator) * cost < factor * distances[i])
+          sampled[block].push_back(i);
+    });
+
+    const size_t first = candidates.n_cols;
+    size_t count = first;
+    for (size_t block = 0; block < blocks; ++block)
+      count += sampled[block].size();
+
+    candidates.resize(data.n_rows, count);
+    size_t c = first;
+    for (size_t block = 0; block < blocks; ++block)
+      for (size_t i = 0; i < sampled[block].size(); ++i)
+        candidates.col(c++) = data.col(sampled[block][i]);
+
+    PlusPlus::UpdateDistances(data, candidates, first, count, distances,
+        nearest);
+  }
+
+  // Too few candidates may be sampled for a small oversampling factor; the
+  // missing ones are added like in k-means++.
+  while (candidates.n_cols < clusters)
+  {
+    const size_t c = candidates.n_cols;
+    candidates.resize(data.n_rows, c + 1);
+    candidates.col(c) = data.col(PlusPlus::Sample(distances));
+    PlusPlus::UpdateDistances(data, candidates, c, c + 1, distances, nearest);
+  }
+
+  // Weight every candidate by the number of points nearest to it, and reduce
+  // the candidates to the centroids.
+  arma::vec weights(candidates.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    weights[nearest[i]] += 1.0;
+
+  PlusPlus::Seed(candidates, &weights, clusters, centroids);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * @file kmeans_plus_plus_initialization.hpp
+ *
+ * The k-means++ initialization strategy, which chooses every initial centroid
+ * among the points with probability proportional to its squared distance to
+ * the centroids already chosen.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means++ initialization strategy.  The first centroid is a point chosen
+ * uniformly at random, and every further centroid is a point chosen with
+ * probability proportional to its squared distance to the nearest centroid
+ * chosen so far (D^2 sampling).  This is an implementation of the following
+ * paper:
+ *
+ * @inproceedings{arthur2007k,
+ *   title={k-means++: The advantages of careful seeding},
+ *   author={Arthur, David and Vassilvitskii, Sergei},
+ *   booktitle={Proceedings of the Eighteenth Annual ACM-SIAM Symposium on
+ *       Discrete Algorithms (SODA 2007)},
+ *   pages={1027--1035},
+ *   year={2007}
+ * }
+ *
+ * The distance of every point to its nearest centroid is updated in parallel
+ * after each new centroid.  A point is skipped when the triangle inequality
+ * shows that the new centroid cannot be nearer than its current one, which
+ * happens for most points once there are many centroids.
+ */
+class KMeansPlusPlusInitialization
+{
+ public:
+  //! Empty constructor, required by the InitialPartitionPolicy type definition.
+  KMeansPlusPlusInitialization() { }
+
+  /**
+   * Initialize the centroids matrix with k-means++.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids)
+  {
+    Seed(data, NULL, clusters, centroids);
+  }
+
+  /**
+   * Choose the given number of centroids among the given points with D^2
+   * sampling.  If weights are given, every point is chosen with probability
+   * proportional to its weight times its squared distance.
+   *
+   * @param data Points to choose the centroids from.
+   * @param weights Weight of every point, or NULL.
+   * @param clusters Number of centroids to choose.
+   * @param centroids Matrix to put the centroids into.
+   */
+  template<typename MatType>
+  static void Seed(const MatType& data,
+                   const arma::vec* weights,
+                   const size_t clusters,
+                   arma::mat& centroids);
+
+  /**
+   * Update the squared distance of every point to its nearest center and the
+   * index of that center, once the centers [first, last) have been added.  The
+   * update runs in parallel over blocks of points; a point is only compared
+   * with a new center c if the squared distance between c and the current
+   * nearest center of the point is less than four times the squared distance
+   * of the point.
+   *
+   * @param data The points.
+   * @param centers The centers; only the first 'last' columns are used.
+   * @param first The first new center.
+   * @param last One past the last new center.
+   * @param distances Squared distance of every point to its nearest center
+   *     (DBL_MAX if there was none yet).
+   * @param nearest Index of the nearest center of every point.
+   */
+  template<typename MatType>
+  static void UpdateDistances(const MatType& data,
+                              const arma::mat& centers,
+                              const size_t first,
+                              const size_t last,
+                              arma::vec& distances,
+                              arma::Row<size_t>& nearest);
+
+  /**
+   * Draw an index with probability proportional to the given nonnegative
+   * weights, or uniformly if they are all zero.
+   *
+   * @param weights The weight of every index.
+   */
+  static size_t Sample(const arma::vec& weights);
+
+  //! Serialize the initialization (nothing to do).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+};
+
+template<typename MatType>
+void KMeansPlusPlusInitialization::Seed(const MatType& data,
+                                        const arma::vec* weights,
+                                        const size_t clusters,
+                                        arma::mat& centroids)
+{
+  centroids.set_size(data.n_rows, clusters);
+  if (clusters == 0)
+    return;
+
+  arma::vec distances(data.n_cols);
+  distances.fill(DBL_MAX);
+  arma::Row<size_t> nearest(data.n_cols, arma::fill::zeros);
+
+  // The first centroid does not depend on the distances.
+  size_t index = (weights == NULL) ? (size_t) math::RandInt(data.n_cols) :
+      Sample(*weights);
+  centroids.col(0) = data.col(index);
+  UpdateDistances(data, centroids, 0, 1, distances, nearest);
+
+  for (size_t c = 1; c < clusters; ++c)
+  {
+    index = (weights == NULL) ? Sample(distances) :
+        Sample(*weights % distances);
+    centroids.col(c) = data.col(index);
+    UpdateDistances(data, centroids, c, c + 1, distances, nearest);
+  }
+}
+
+template<typename MatType>
+void KMeansPlusPlusInitialization::UpdateDistances(
+    const MatType& data,
+    const arma::mat& centers,
+    const size_t first,
+    const size_t last,
+    arma::vec& distances,
+    arma::Row<size_t>& nearest)
+{
+  typedef metric::SquaredEuclideanDistance Distance;
+
+  // The new centers are handled in groups, so that the distances between the
+  // centers of a group and all the centers stay small.
+  const size_t groupSize = 64;
+  const size_t blockSize = 1024;
+  const size_t blocks = (data.n_cols + blockSize - 1) / blockSize;
+  for (size_t group = first; group < last; group += groupSize)
+  {
+    const size_t groupEnd = std::min(last, group + groupSize);
+
+    // Squared distances between the new centers and every center up to them.
+    arma::mat centerDistances(groupEnd, groupEnd - group);
+    for (size_t c = group; c < groupEnd; ++c)
+      for (size_t o = 0; o < c; ++o)
+        centerDistances(o, c - group) = Distance::Evaluate(centers.col(o),
+            centers.col(c));
+
+    Threads::ParallelFor(0, blocks, [&](const size_t block)
+    {
+      const size_t end = std::min((size_t) data.n_cols,
+          (block + 1) * blockSize);
+      for (size_t i = block * blockSize; i < end; ++i)
+      {
+        for (size_t c = group; c < groupEnd; ++c)
+        {
+          // By the triangle inequality, c can only be nearer to the point than
+          // its nearest center if the centers are less than twice the distance
+          // of the point apart.
+          if (distances[i] != DBL_MAX &&
+              centerDistances(nearest[i], c - group) >= 4 * distances[i])
+            continue;
+
+          const double distance = Distance::Evaluate(data.col(i),
+              centers.col(c));
+          if (distance < distances[i])
+          {
+            distances[i] = distance;
+            nearest[i] = c;
+          }
+        }
+      }
+    });
+  }
+}
+
+inline size_t KMeansPlusPlusInitialization::Sample(const arma::vec& weights)
+{
+  const double total = arma::accu(weights);
+  if (!(total > 0.0))
+    return (size_t) math::RandInt(weights.n_elem);
+
+  const double target = math::Random() * total;
+  double sum = 0.0;
+  size_t last = 0;
+  for (size_t i = 0; i < weights.n_elem; ++i)
+  {
+    if (weights[i] <= 0.0)
+      continue;
+
+    sum += weights[i];
+    last = i;
+    if (sum > target)
+      return i;
+  }
+
+  // Rounding may leave the target just past the sum.
+  return last;
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -45,14 +45,16 @@ void MaxVarianceNewCluster::EmptyCluster(const MatType& data,
     return;
 
   // Now, inside this cluster, find the point which is furthest away.
+  PointCentroidDistance<MetricType, MatType> pointDistance(data, metric);
+  pointDistance.Centroids(newCentroids);
   size_t furthestPoint = data.n_cols;
   double maxDistance = -DBL_MAX;
   for (size_t i = 0; i < data.n_cols; ++i)
   {
     if (assignments[i] == maxVarCluster)
     {
-      const double distance = std::pow(metric.Evaluate(data.col(i),
-          newCentroids.col(maxVarCluster)), 2.0);
+      const double distance = std::pow(pointDistance.Evaluate(i,
+          maxVarCluster), 2.0);
 
       if (distance > maxDistance)
       {
@@ -63,13 +65,16 @@ void MaxVarianceNewCluster::EmptyCluster(const MatType& data,
   }
 
   // Take that point and add it to the empty cluster.
+  arma::vec point(data.n_rows, arma::fill::zeros);
+  PointCentroidDistance<MetricType, MatType>::AddPoint(data, furthestPoint,
+      point, 0);
   newCentroids.col(maxVarCluster) *= (double(clusterCounts[maxVarCluster]) /
       double(clusterCounts[maxVarCluster] - 1));
   newCentroids.col(maxVarCluster) -= (1.0 / (clusterCounts[maxVarCluster] -
-      1.0)) * arma::vec(data.col(furthestPoint));
+      1.0)) * point;
   clusterCounts[maxVarCluster]--;
   clusterCounts[emptyCluster]++;
-  newCentroids.col(emptyCluster) = arma::vec(data.col(furthestPoint));
+  newCentroids.col(emptyCluster) = point;
   assignments[furthestPoint] = emptyCluster;
 
   // Modify the variances, as necessary.
@@ -125,6 +130,8 @@ void MaxVarianceNewCluster::Precalculate(const MatType& data,
 
   // Add the variance of each point's distance away from the cluster.  I think
   // this is the sensible thing to do.
+  PointCentroidDistance<MetricType, MatType> pointDistance(data, metric);
+  pointDistance.Centroids(oldCentroids);
   for (size_t i = 0; i < data.n_cols; ++i)
   {
     // Find the closest centroid to this point.
@@ -133,7 +140,7 @@ void MaxVarianceNewCluster::Precalculate(const MatType& data,
 
     for (size_t j = 0; j < oldCentroids.n_cols; j++)
     {
-      const double distance = metric.Evaluate(data.col(i), oldCentroids.col(j));
+      const double distance = pointDistance.Evaluate(i, j);
 
       if (distance < minDistance)
       {
@@ -143,8 +150,7 @@ void MaxVarianceNewCluster::Precalculate(const MatType& data,
     }
 
     assignments[i] = closestCluster;
-    variances[closestCluster] += std::pow(metric.Evaluate(data.col(i),
-        oldCentroids.col(closestCluster)), 2.0);
+    variances[closestCluster] += std::pow(minDistance, 2.0);
   }
 
   // Divide by the number of points in the cluster to produce the variance,
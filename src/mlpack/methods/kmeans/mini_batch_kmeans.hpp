@@ -0,0 +1,145 @@
+/**
+ * @file mini_batch_kmeans.hpp
+ *
+ * An implementation of mini-batch k-means (Sculley, 2010), where every step
+ * only looks at a small random sample of the dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An implementation of mini-batch k-means as a Lloyd step type.  Each call to
+ * Iterate() assigns a random batch of points to their closest centroids and
+ * moves every centroid towards the points assigned to it, with a per-centroid
+ * learning rate of one over the number of points the centroid has absorbed so
+ * far.  Each centroid is therefore the running mean of all the points that
+ * were ever assigned to it, and the cost of an iteration depends only on the
+ * batch size, not on the size of the dataset.
+ *
+ * The counts returned by Iterate() are the total number of points absorbed by
+ * each centroid, so a cluster is only reported as empty if no point was ever
+ * assigned to it.
+ *
+ * Data that does not fit in memory can be clustered in chunks with Update(),
+ * which takes points that don't have to be part of the dataset:
+ *
+ * @code
+ * arma::mat centroids = ...; // Initial centroids.
+ * arma::mat chunk;
+ * metric::EuclideanDistance metric;
+ * MiniBatchKMeans<metric::EuclideanDistance, arma::mat> step(chunk, metric);
+ * while (source.NextChunk(chunk))
+ *   step.Update(chunk, centroids);
+ * @endcode
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset to sample batches from.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points in each batch.  If the dataset has fewer
+   *     points, every batch is the whole dataset.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1024);
+
+  /**
+   * Run a single mini-batch step on a random batch of the dataset, updating
+   * the given centroids into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Total number of points absorbed by each cluster.
+   * @return The distance the centroids moved.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Update the given centroids in place with a batch of points.  The points
+   * don't have to be part of the dataset, so this can be used to consume data
+   * chunk by chunk.
+   *
+   * @param batch Points to update the centroids with.
+   * @param centroids Cluster centroids to update.
+   * @return The distance the centroids moved.
+   */
+  double Update(const MatType& batch, arma::mat& centroids);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the total number of points absorbed by each cluster.
+  const arma::Col<size_t>& Counts() const { return totalCounts; }
+
+ private:
+  /**
+   * Assign the given columns of the points to their closest centroids, and
+   * move the centroids to the running means of their points.
+   *
+   * @param points Matrix holding the batch.
+   * @param indices Columns of the batch in points.
+   * @param centroids Centroids to update.
+   * @return The distance the centroids moved.
+   */
+  double UpdateCentroids(const MatType& points,
+                         const arma::uvec& indices,
+                         arma::mat& centroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The number of points in each batch.
+  size_t batchSize;
+
+  //! The number of points absorbed by each cluster so far.
+  arma::Col<size_t> totalCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
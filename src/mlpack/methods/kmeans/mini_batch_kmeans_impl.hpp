@@ -0,0 +1,151 @@
+/**
+ * @file mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of mini-batch k-means (Sculley, 2010).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration on a random batch.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
+                                                     arma::mat& newCentroids,
+                                                     arma::Col<size_t>& counts)
+{
+  newCentroids = centroids;
+
+  // Sample the batch (with replacement), or take the whole dataset if it is
+  // small enough.
+  arma::uvec indices;
+  if (batchSize >= dataset.n_cols)
+  {
+    indices = arma::regspace<arma::uvec>(0, dataset.n_cols - 1);
+  }
+  else
+  {
+    // math::RandInt() is limited to the range of an int, which is too small
+    // for the datasets this is meant for.
+    indices.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      indices[i] = std::min((size_t) (math::Random() * dataset.n_cols),
+          (size_t) dataset.n_cols - 1);
+    }
+  }
+
+  const double cNorm = UpdateCentroids(dataset, indices, newCentroids);
+  counts = totalCounts;
+
+  return cNorm;
+}
+
+// Update the centroids with a batch that may not be part of the dataset.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Update(const MatType& batch,
+                                                    arma::mat& centroids)
+{
+  if (batch.n_cols == 0)
+    return 0.0;
+
+  return UpdateCentroids(batch,
+      arma::regspace<arma::uvec>(0, batch.n_cols - 1), centroids);
+}
+
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::UpdateCentroids(
+    const MatType& points,
+    const arma::uvec& indices,
+    arma::mat& centroids)
+{
+  if (totalCounts.n_elem != centroids.n_cols)
+    totalCounts.zeros(centroids.n_cols);
+
+  // Sums and counts of the batch points closest to each centroid.
+  arma::mat batchSums(centroids.n_rows, centroids.n_cols, arma::fill::zeros);
+  arma::Col<size_t> batchCounts(centroids.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel
+  {
+    arma::mat localSums(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) indices.n_elem; ++i)
+    {
+      // Find the closest centroid to this point.
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; j++)
+      {
+        const double distance = metric.Evaluate(points.col(indices[i]),
+            centroids.unsafe_col(j));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+
+      localSums.unsafe_col(closestCluster) += points.col(indices[i]);
+      localCounts(closestCluster)++;
+    }
+
+    #pragma omp critical
+    {
+      batchSums += localSums;
+      batchCounts += localCounts;
+    }
+  }
+
+  distanceCalculations += centroids.n_cols * indices.n_elem;
+
+  // With a learning rate of 1 / (number of absorbed points) per point, taking
+  // the points of the batch one at a time amounts to moving each centroid to
+  // the running mean of everything it absorbed.
+  double cNorm = 0.0;
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    if (batchCounts[j] == 0)
+      continue;
+
+    totalCounts[j] += batchCounts[j];
+    const arma::vec oldCentroid = centroids.col(j);
+    centroids.col(j) += (batchSums.col(j) - (double) batchCounts[j] *
+        oldCentroid) / (double) totalCounts[j];
+
+    cNorm += std::pow(metric.Evaluate(oldCentroid, centroids.col(j)), 2.0);
+    ++distanceCalculations;
+  }
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,8 @@
 #ifndef MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/pairwise_distances.hpp>
+#include "point_centroid_distance.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -25,8 +27,12 @@ namespace kmeans {
  * looking for the mlpack::kmeans::KMeans class instead of this one.  This class
  * is used by KMeans as the actual implementation of the Lloyd iteration.
  *
+ * The dataset may be dense or sparse, and hold doubles or floats; the
+ * distances are computed in the precision of the dataset, while the centroids
+ * are always summed in double precision.
+ *
  * @param MetricType Type of metric used with this implementation.
- * @param MatType Matrix type (arma::mat or arma::sp_mat).
+ * @param MatType Matrix type (such as arma::mat, arma::fmat or arma::sp_mat).
  */
 template<typename MetricType, typename MatType>
 class NaiveKMeans
@@ -61,6 +67,8 @@ class NaiveKMeans
   const MatType& dataset;
   //! The instantiated metric.
   MetricType& metric;
+  //! The distances between the points and the centroids.
+  PointCentroidDistance<MetricType, MatType> distance;
 
   //! Number of distance calculations.
   size_t distanceCalculations;
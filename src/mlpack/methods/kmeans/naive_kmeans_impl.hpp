@@ -4,7 +4,7 @@
  * @author Shikhar Bhardwaj
  *
  * An implementation of a naively-implemented step of the Lloyd algorithm for
- * k-means clustering, using OpenMP for parallelization over multiple threads.
+ * k-means clustering, computed in parallel over multiple threads.
  * This may still be the best choice for small datasets or datasets with very
  * high dimensionality.
  *
@@ -27,6 +27,7 @@ NaiveKMeans<MetricType, MatType>::NaiveKMeans(const MatType& dataset,
                                               MetricType& metric) :
     dataset(dataset),
     metric(metric),
+    distance(dataset, metric),
     distanceCalculations(0)
 { /* Nothing to do. */ }
 
@@ -39,45 +40,58 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
 
-  // Find the closest centroid to each point and update the new centroids.
-  // Computed in parallel over the complete dataset
-  #pragma omp parallel
+  // The distances are computed in the element type of the dataset.
+  typedef typename MatType::elem_type ElemType;
+  distance.Centroids(centroids);
+  const arma::Mat<ElemType>& pointCentroids = distance.CentroidMatrix();
+
+  // The points are cut into ranges, one per thread, and every range is
+  // handled in blocks: the distances between the points of a block and all
+  // centroids are computed at once with math::PairwiseDistances() (one matrix
+  // multiplication for the Euclidean distances).  Every range sums its points
+  // into its own centroids.  The ranges are the ones Threads::FirstTouch()
+  // places, so with NUMA awareness each thread reads its points locally.
+  const size_t blockSize = 1024;
+  const size_t numRanges = Threads::Ranges(0, dataset.n_cols);
+  std::vector<arma::mat> rangeCentroids(numRanges);
+  std::vector<arma::Col<size_t>> rangeCounts(numRanges);
+  Threads::ParallelRanges(0, dataset.n_cols, [&](const size_t range,
+                                                 const size_t rangeBegin,
+                                                 const size_t rangeEnd)
   {
-    // The current state of the K-means is private for each thread
-    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
-        arma::fill::zeros);
-    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+    arma::mat& localCentroids = rangeCentroids[range];
+    arma::Col<size_t>& localCounts = rangeCounts[range];
+    localCentroids.zeros(centroids.n_rows, centroids.n_cols);
+    localCounts.zeros(centroids.n_cols);
 
-    #pragma omp for
-    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    arma::Mat<ElemType> distances;
+    for (size_t begin = rangeBegin; begin < rangeEnd; begin += blockSize)
     {
-      // Find the closest centroid to this point.
-      double minDistance = std::numeric_limits<double>::infinity();
-      size_t closestCluster = centroids.n_cols; // Invalid value.
+      const size_t end = std::min(begin + blockSize, rangeEnd);
+      const MatType block = dataset.cols(begin, end - 1);
+      math::PairwiseDistances(metric, pointCentroids, block, distances);
 
-      for (size_t j = 0; j < centroids.n_cols; j++)
+      for (size_t i = 0; i < block.n_cols; ++i)
       {
-        const double distance = metric.Evaluate(dataset.col(i),
-            centroids.unsafe_col(j));
-        if (distance < minDistance)
-        {
-          minDistance = distance;
-          closestCluster = j;
-        }
-      }
+        // Find the closest centroid to this point.
+        arma::uword closestCluster;
+        const ElemType minDistance =
+            distances.unsafe_col(i).min(closestCluster);
+        Log::Assert(minDistance < std::numeric_limits<ElemType>::infinity());
 
-      Log::Assert(closestCluster != centroids.n_cols);
-
-      // We now have the minimum distance centroid index.  Update that centroid.
-      localCentroids.unsafe_col(closestCluster) += dataset.col(i);
-      localCounts(closestCluster)++;
-    }
-    // Combine calculated state from each thread
-    #pragma omp critical
-    {
-      newCentroids += localCentroids;
-      counts += localCounts;
+        // Update that centroid.
+        PointCentroidDistance<MetricType, MatType>::AddPoint(block, i,
+            localCentroids, closestCluster);
+        localCounts(closestCluster)++;
+      }
     }
+  });
+
+  // Combine the centroids of the ranges.
+  for (size_t range = 0; range < numRanges; ++range)
+  {
+    newCentroids += rangeCentroids[range];
+    counts += rangeCounts[range];
   }
 
   // Now normalize the centroid.
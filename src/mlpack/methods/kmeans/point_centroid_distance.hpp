@@ -0,0 +1,249 @@
+/**
+ * @file point_centroid_distance.hpp
+ *
+ * Distances between the points of a dense or sparse dataset, of any element
+ * type, and a set of centroids, for the k-means step types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_POINT_CENTROID_DISTANCE_HPP
+#define MLPACK_METHODS_KMEANS_POINT_CENTROID_DISTANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/pairwise_distances.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The PointCentroidDistance class computes the distance between a point of a
+ * dataset and a centroid, and adds points of the dataset to centroid sums.
+ * The centroids are always dense and held in double precision (arma::mat),
+ * while the dataset may be any dense or sparse Armadillo matrix:
+ *
+ *  - for dense datasets holding another element type than double (such as
+ *    arma::fmat), the centroids are converted to that type once per call to
+ *    Centroids(), and the distances are computed in that precision;
+ *  - for sparse datasets and the (squared) Euclidean distance, the squared
+ *    distance is computed as ||x||^2 + ||c||^2 - 2 x^T c, with the squared
+ *    norms of the points computed once and those of the centroids once per
+ *    call to Centroids(), so that only the nonzero elements of x are visited;
+ *  - for sparse datasets and other metrics, the point is made dense.
+ *
+ * @tparam MetricType Metric to use.
+ * @tparam MatType Type of the dataset.
+ */
+template<typename MetricType, typename MatType>
+class PointCentroidDistance
+{
+ public:
+  //! The element type of the dataset.
+  typedef typename MatType::elem_type ElemType;
+
+  //! Whether the dataset is sparse.
+  static const bool IsSparse = arma::is_SpMat<MatType>::value;
+  //! Whether the distances of a sparse dataset use the inner products.
+  static const bool UsesInnerProducts = IsSparse &&
+      math::PairwiseDistanceTraits<MetricType>::UsesInnerProducts;
+
+  /**
+   * Prepare the distances to the points of the given dataset.  For sparse
+   * datasets and the Euclidean distance, the squared norms of the points are
+   * computed, in parallel.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   */
+  PointCentroidDistance(const MatType& dataset, MetricType& metric) :
+      dataset(dataset),
+      metric(metric),
+      centroidMatrix(NULL)
+  {
+    if (UsesInnerProducts)
+    {
+      pointNorms.set_size(dataset.n_cols);
+      Threads::ParallelFor(0, dataset.n_cols, [&](const size_t i)
+      {
+        double norm = 0.0;
+        for (typename MatType::const_iterator it = dataset.begin_col(i);
+             it != dataset.end_col(i); ++it)
+          norm += double(*it) * double(*it);
+        pointNorms[i] = norm;
+      });
+    }
+  }
+
+  /**
+   * Set the centroids that the following calls to Evaluate() use.  The
+   * centroids must not change or be destroyed while they are used.
+   *
+   * @param centroids Current cluster centroids.
+   */
+  void Centroids(const arma::mat& centroids)
+  {
+    SetCentroidMatrix(centroids, std::is_same<ElemType, double>());
+    if (UsesInnerProducts)
+    {
+      centroidNorms = arma::conv_to<arma::vec>::from(
+          arma::sum(arma::square(*centroidMatrix), 0));
+    }
+  }
+
+  /**
+   * Get the centroids given to Centroids(), held in the element type of the
+   * dataset.
+   */
+  const arma::Mat<ElemType>& CentroidMatrix() const { return *centroidMatrix; }
+
+  /**
+   * Compute the distance between the given point of the dataset and the given
+   * centroid.  This may be called from several threads at once.
+   *
+   * @param point Index of the point.
+   * @param centroid Index of the centroid.
+   */
+  double Evaluate(const size_t point, const size_t centroid) const
+  {
+    return Evaluate(point, centroid,
+        std::integral_constant<int, IsSparse + UsesInnerProducts>());
+  }
+
+  /**
+   * Add the given point of the dataset to the given column of the sums.
+   *
+   * @param point Index of the point.
+   * @param sums Matrix holding the sums.
+   * @param column Column of the sums to add the point to.
+   */
+  void AddPoint(const size_t point, arma::mat& sums, const size_t column) const
+  {
+    AddPoint(dataset, point, sums, column);
+  }
+
+  /**
+   * Add the given point of the given dataset to the given column of the sums.
+   *
+   * @param dataset Dataset.
+   * @param point Index of the point.
+   * @param sums Matrix holding the sums.
+   * @param column Column of the sums to add the point to.
+   */
+  static void AddPoint(const MatType& dataset,
+                       const size_t point,
+                       arma::mat& sums,
+                       const size_t column)
+  {
+    AddPoint(dataset, point, sums, column,
+        std::integral_constant<int, IsSparse ? 2 :
+            int(std::is_same<ElemType, double>::value)>());
+  }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The centroids, in the element type of the dataset.
+  const arma::Mat<ElemType>* centroidMatrix;
+  //! The converted centroids, if the dataset does not hold doubles.
+  arma::Mat<ElemType> convertedCentroids;
+  //! The squared norms of the points, for the inner products.
+  arma::vec pointNorms;
+  //! The squared norms of the centroids, for the inner products.
+  arma::vec centroidNorms;
+
+  //! Use the centroids directly.
+  void SetCentroidMatrix(const arma::mat& centroids,
+                         const std::true_type& /* isDouble */)
+  {
+    centroidMatrix = &centroids;
+  }
+
+  //! Convert the centroids to the element type of the dataset.
+  void SetCentroidMatrix(const arma::mat& centroids,
+                         const std::false_type& /* isDouble */)
+  {
+    convertedCentroids = arma::conv_to<arma::Mat<ElemType>>::from(centroids);
+    centroidMatrix = &convertedCentroids;
+  }
+
+  //! Evaluate the metric on a dense point.
+  double Evaluate(const size_t point,
+                  const size_t centroid,
+                  const std::integral_constant<int, 0>& /* dense */) const
+  {
+    return metric.Evaluate(dataset.col(point),
+        centroidMatrix->col(centroid));
+  }
+
+  //! Evaluate the metric on a sparse point, made dense.
+  double Evaluate(const size_t point,
+                  const size_t centroid,
+                  const std::integral_constant<int, 1>& /* sparse */) const
+  {
+    const arma::Mat<ElemType> densePoint(dataset.col(point));
+    return metric.Evaluate(densePoint, centroidMatrix->col(centroid));
+  }
+
+  //! Compute the (squared) Euclidean distance from the inner product.
+  double Evaluate(const size_t point,
+                  const size_t centroid,
+                  const std::integral_constant<int, 2>& /* innerProduct */)
+      const
+  {
+    const ElemType* centroidPtr = centroidMatrix->colptr(centroid);
+    double product = 0.0;
+    for (typename MatType::const_iterator it = dataset.begin_col(point);
+         it != dataset.end_col(point); ++it)
+      product += double(*it) * double(centroidPtr[it.row()]);
+
+    const double distance = std::max(pointNorms[point] +
+        centroidNorms[centroid] - 2.0 * product, 0.0);
+    return math::PairwiseDistanceTraits<MetricType>::TakeRoot ?
+        std::sqrt(distance) : distance;
+  }
+
+  //! Add a dense point of another element type than double.
+  static void AddPoint(const MatType& dataset,
+                       const size_t point,
+                       arma::mat& sums,
+                       const size_t column,
+                       const std::integral_constant<int, 0>& /* dense */)
+  {
+    const ElemType* pointPtr = dataset.colptr(point);
+    double* sumPtr = sums.colptr(column);
+    for (size_t r = 0; r < dataset.n_rows; ++r)
+      sumPtr[r] += double(pointPtr[r]);
+  }
+
+  //! Add a dense point of doubles.
+  static void AddPoint(const MatType& dataset,
+                       const size_t point,
+                       arma::mat& sums,
+                       const size_t column,
+                       const std::integral_constant<int, 1>& /* double */)
+  {
+    sums.unsafe_col(column) += dataset.unsafe_col(point);
+  }
+
+  //! Add the nonzero elements of a sparse point.
+  static void AddPoint(const MatType& dataset,
+                       const size_t point,
+                       arma::mat& sums,
+                       const size_t column,
+                       const std::integral_constant<int, 2>& /* sparse */)
+  {
+    double* sumPtr = sums.colptr(column);
+    for (typename MatType::const_iterator it = dataset.begin_col(point);
+         it != dataset.end_col(point); ++it)
+      sumPtr[it.row()] += double(*it);
+  }
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
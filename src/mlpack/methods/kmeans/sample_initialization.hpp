@@ -16,6 +16,8 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/random.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include "point_centroid_distance.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -39,12 +41,13 @@ class SampleInitialization
                              const size_t clusters,
                              arma::mat& centroids)
   {
-    centroids.set_size(data.n_rows, clusters);
+    centroids.zeros(data.n_rows, clusters);
     for (size_t i = 0; i < clusters; ++i)
     {
-      // Randomly sample a point.
+      // Randomly sample a point; it may be sparse or hold floats.
       const size_t index = math::RandInt(0, data.n_cols);
-      centroids.col(i) = data.col(index);
+      PointCentroidDistance<metric::EuclideanDistance, MatType>::AddPoint(data,
+          index, centroids, i);
     }
   }
 };
@@ -83,6 +83,7 @@ void LARS::Train(const arma::mat& matX,
   ignoreSet.clear();
   isIgnored.clear();
   matUtriCholFactor.reset();
+  activeGram.reset();
 
   // This matrix may end up holding the transpose -- if necessary.
   arma::mat dataTrans;
@@ -92,7 +93,8 @@ void LARS::Train(const arma::mat& matX,
     dataTrans = trans(matX);
 
   // Compute X' * y.
-  arma::vec vecXTy = trans(y * dataRef);
+  arma::vec vecXTy;
+  TransposeProduct(dataRef, trans(y), vecXTy);
 
   // Set up active set variables.  In the beginning, the active set has size 0
   // (all dimensions are inactive).
@@ -132,16 +134,10 @@ void LARS::Train(const arma::mat& matX,
     return;
   }
 
-  // Compute the Gram matrix.  If this is the elastic net problem, we will add
-  // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
-  {
-    // In this case, matGram should reference matGramInternal.
-    matGramInternal = trans(dataRef) * dataRef;
-
-    if (elasticNet && !useCholesky)
-      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
-  }
+  // If no Gram matrix was given, the full d x d Gram matrix is never formed;
+  // instead, the Gram matrix of the active variables is updated as variables
+  // enter and leave the active set.
+  const bool fullGram = (matGram->n_elem == dataRef.n_cols * dataRef.n_cols);
 
   // Main loop.
   while (((activeSet.size() + ignoreSet.size()) < dataRef.n_cols) &&
@@ -160,20 +156,40 @@ void LARS::Train(const arma::mat& matX,
 
     if (!lassocond)
     {
-      if (useCholesky)
+      // Compute the Gram matrix entries of the new variable with the active
+      // variables and with itself.
+      arma::vec newGramCol;
+      double newGramDiag;
+      if (fullGram)
       {
-        // vec newGramCol = vec(activeSet.size());
-        // for (size_t i = 0; i < activeSet.size(); i++)
-        // {
-        //   newGramCol[i] = dot(matX.col(activeSet[i]), matX.col(changeInd));
-        // }
-        // This is equivalent to the above 5 lines.
-        arma::vec newGramCol = matGram->elem(changeInd * dataRef.n_cols +
+        // This is equivalent to the loop below.
+        newGramCol = matGram->elem(changeInd * dataRef.n_cols +
             arma::conv_to<arma::uvec>::from(activeSet));
+        newGramDiag = (*matGram)(changeInd, changeInd);
+      }
+      else
+      {
+        const size_t k = activeSet.size();
+        newGramCol.set_size(k);
+        Threads::ParallelFor(0, k, [&](const size_t i)
+        {
+          newGramCol[i] = dot(dataRef.col(activeSet[i]),
+              dataRef.col(changeInd));
+        });
+        newGramDiag = dot(dataRef.col(changeInd), dataRef.col(changeInd));
 
-        CholeskyInsert((*matGram)(changeInd, changeInd), newGramCol);
+        activeGram.resize(k + 1, k + 1);
+        if (k > 0)
+        {
+          activeGram(arma::span(0, k - 1), k) = newGramCol;
+          activeGram(k, arma::span(0, k - 1)) = trans(newGramCol);
+        }
+        activeGram(k, k) = newGramDiag;
       }
 
+      if (useCholesky)
+        CholeskyInsert(newGramDiag, newGramCol);
+
       // Add variable to active set.
       Activate(changeInd);
     }
@@ -229,10 +245,22 @@ void LARS::Train(const arma::mat& matX,
     }
     else
     {
-      arma::mat matGramActive = arma::mat(activeSet.size(), activeSet.size());
-      for (size_t i = 0; i < activeSet.size(); i++)
-        for (size_t j = 0; j < activeSet.size(); j++)
-          matGramActive(i, j) = (*matGram)(activeSet[i], activeSet[j]);
+      arma::mat matGramActive;
+      if (fullGram)
+      {
+        matGramActive.set_size(activeSet.size(), activeSet.size());
+        for (size_t i = 0; i < activeSet.size(); i++)
+          for (size_t j = 0; j < activeSet.size(); j++)
+            matGramActive(i, j) = (*matGram)(activeSet[i], activeSet[j]);
+      }
+      else
+      {
+        // If this is the elastic net problem, we add lambda2 * I to the
+        // matrix.
+        matGramActive = activeGram;
+        if (elasticNet)
+          matGramActive.diag() += lambda2;
+      }
 
       // Check for singularity.
       arma::mat matS = s * arma::ones<arma::mat>(1, activeSet.size());
@@ -267,12 +295,14 @@ void LARS::Train(const arma::mat& matX,
     if ((activeSet.size() + ignoreSet.size()) < dataRef.n_cols)
     {
       // Compute correlations with direction.
+      arma::vec dirCorrs;
+      TransposeProduct(dataRef, yHatDirection, dirCorrs);
       for (size_t ind = 0; ind < dataRef.n_cols; ind++)
       {
         if (isActive[ind] || isIgnored[ind])
           continue;
 
-        double dirCorr = dot(dataRef.col(ind), yHatDirection);
+        const double dirCorr = dirCorrs[ind];
         double val1 = (maxCorr - corr(ind)) / (normalization - dirCorr);
         double val2 = (maxCorr + corr(ind)) / (normalization + dirCorr);
         if ((val1 > 0) && (val1 < gamma))
@@ -334,7 +364,8 @@ void LARS::Train(const arma::mat& matX,
       Deactivate(changeInd);
     }
 
-    corr = vecXTy - trans(dataRef) * yHat;
+    TransposeProduct(dataRef, yHat, corr);
+    corr = vecXTy - corr;
     if (elasticNet)
       corr -= lambda2 * beta;
 
@@ -387,6 +418,14 @@ void LARS::Deactivate(const size_t activeVarInd)
 {
   isActive[activeSet[activeVarInd]] = false;
   activeSet.erase(activeSet.begin() + activeVarInd);
+
+  // The Gram matrix of the active variables is only used if no full Gram
+  // matrix is available.
+  if (activeVarInd < activeGram.n_rows)
+  {
+    activeGram.shed_row(activeVarInd);
+    activeGram.shed_col(activeVarInd);
+  }
 }
 
 void LARS::Activate(const size_t varInd)
@@ -401,6 +440,23 @@ void LARS::Ignore(const size_t varInd)
   ignoreSet.push_back(varInd);
 }
 
+void LARS::TransposeProduct(const arma::mat& matX,
+                            const arma::vec& v,
+                            arma::vec& result)
+{
+  // Each block of columns is multiplied separately, in parallel.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (matX.n_cols + blockSize - 1) / blockSize;
+
+  result.set_size(matX.n_cols);
+  Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    const size_t begin = block * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) matX.n_cols) - 1;
+    result.subvec(begin, end) = trans(matX.cols(begin, end)) * v;
+  });
+}
+
 void LARS::ComputeYHatDirection(const arma::mat& matX,
                                 const arma::vec& betaDirection,
                                 arma::vec& yHatDirection)
@@ -459,21 +515,18 @@ void LARS::CholeskyInsert(double sqNormNewX, const arma::vec& newGramCol)
   }
   else
   {
-    arma::mat matNewR = arma::mat(n + 1, n + 1);
-
     if (elasticNet)
       sqNormNewX += lambda2;
 
     arma::vec matUtriCholFactork = solve(trimatl(trans(matUtriCholFactor)),
         newGramCol);
 
-    matNewR(arma::span(0, n - 1), arma::span(0, n - 1)) = matUtriCholFactor;
-    matNewR(arma::span(0, n - 1), n) = matUtriCholFactork;
-    matNewR(n, arma::span(0, n - 1)).fill(0.0);
-    matNewR(n, n) = sqrt(sqNormNewX - dot(matUtriCholFactork,
-                                          matUtriCholFactork));
-
-    matUtriCholFactor = matNewR;
+    // Grow the factor by one row and column; the old factor is kept.
+    matUtriCholFactor.resize(n + 1, n + 1);
+    matUtriCholFactor(arma::span(0, n - 1), n) = matUtriCholFactork;
+    matUtriCholFactor(n, arma::span(0, n - 1)).fill(0.0);
+    matUtriCholFactor(n, n) = sqrt(sqNormNewX - dot(matUtriCholFactork,
+                                                    matUtriCholFactork));
   }
 }
 
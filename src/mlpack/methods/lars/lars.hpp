@@ -58,6 +58,11 @@ namespace regression {
  * Note: This algorithm is not recommended for use (in terms of efficiency)
  * when \f$ \lambda_1 \f$ = 0.
  *
+ * Unless a precalculated Gram matrix is given, the full Gram matrix
+ * \f$ X^T X \f$ is never formed: only the Gram matrix of the active variables
+ * is kept, so LARS can be used on data with very many dimensions.  The
+ * correlations \f$ X^T r \f$ are computed in parallel blocks (see Threads).
+ *
  * For more details, see the following papers:
  *
  * @code
@@ -252,6 +257,10 @@ class LARS
   //! Upper triangular cholesky factor; initially 0x0 matrix.
   arma::mat matUtriCholFactor;
 
+  //! Gram matrix of the active variables (in the order of activeSet), used
+  //! when no full Gram matrix was given.
+  arma::mat activeGram;
+
   //! Whether or not to use Cholesky decomposition when solving linear system.
   bool useCholesky;
 
@@ -309,6 +318,17 @@ class LARS
    */
   void Ignore(const size_t varInd);
 
+  /**
+   * Compute matX^T v, in parallel blocks of columns of matX.
+   *
+   * @param matX Data matrix (each column is one variable).
+   * @param v Vector to multiply by.
+   * @param result Vector to store matX^T v in.
+   */
+  static void TransposeProduct(const arma::mat& matX,
+                               const arma::vec& v,
+                               arma::vec& result);
+
   // compute "equiangular" direction in output space
   void ComputeYHatDirection(const arma::mat& matX,
                             const arma::vec& betaDirection,
@@ -51,40 +51,145 @@ void LinearRegression::Train(const arma::mat& predictors,
   /*
    * We want to calculate the a_i coefficients of:
    * \sum_{i=0}^n (a_i * x_i^i)
-   * In order to get the intercept value, we will add a row of ones.
+   * In order to get the intercept value, we treat the predictors as if they
+   * had an additional first row of ones.
    */
+  const size_t size = predictors.n_rows + (intercept ? 1 : 0);
+  arma::mat xtx(size, size, arma::fill::zeros);
+  arma::vec xty(size, arma::fill::zeros);
+  AccumulateNormalEquations(predictors, responses, weights, intercept, xtx,
+      xty);
 
-  // We store the number of rows and columns of the predictors.
-  // Reminder: Armadillo stores the data transposed from how we think of it,
-  //           that is, columns are actually rows (see: column major order).
-  const size_t nCols = predictors.n_cols;
-
-  arma::mat p = predictors;
-  arma::rowvec r = responses;
+  SolveNormalEquations(xtx, xty);
+}
 
-  // Here we add the row of ones to the predictors.
-  // The intercept is not penalized. Add an "all ones" row to design and set
-  // intercept = false to get a penalized intercept.
-  if (intercept)
+void LinearRegression::Train(const arma::mat& data,
+                             const size_t responseDimension,
+                             const arma::rowvec& weights,
+                             const bool intercept)
+{
+  if (data.n_rows < 2 || responseDimension >= data.n_rows)
   {
-    p.insert_rows(0, arma::ones<arma::mat>(1, nCols));
+    std::ostringstream oss;
+    oss << "LinearRegression::Train(): response dimension ("
+        << responseDimension << ") is not a dimension of the " << data.n_rows
+        << "-dimensional points, or there are no predictors";
+    throw std::invalid_argument(oss.str());
   }
 
-  if (weights.n_elem > 0)
+  this->intercept = intercept;
+
+  // The normal equations are the Gram matrix of all the dimensions without the
+  // row and column of the response; so the Gram matrix is accumulated on the
+  // points as they are, and the response is dropped afterwards.
+  const size_t offset = intercept ? 1 : 0;
+  const size_t size = data.n_rows + offset;
+  arma::mat gram(size, size, arma::fill::zeros);
+  arma::vec gramY(size, arma::fill::zeros);
+  AccumulateNormalEquations(data, data.row(responseDimension), weights,
+      intercept, gram, gramY);
+
+  arma::uvec keep(size - 1);
+  for (size_t i = 0, j = 0; i < size; ++i)
+    if (i != responseDimension + offset)
+      keep[j++] = i;
+
+  arma::mat xtx = gram.submat(keep, keep);
+  const arma::vec xty = gramY.elem(keep);
+  SolveNormalEquations(xtx, xty);
+}
+
+void LinearRegression::AccumulateNormalEquations(
+    const arma::mat& predictors,
+    const arma::rowvec& responses,
+    const arma::rowvec& weights,
+    const bool intercept,
+    arma::mat& xtx,
+    arma::vec& xty)
+{
+  // Blocks are large enough for efficient matrix multiplications and small
+  // enough to stay in the cache.  Each thread handles a contiguous range of
+  // blocks and keeps its own sums, so the extra memory is O(d^2) per thread
+  // no matter how many points there are.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (predictors.n_cols + blockSize - 1) / blockSize;
+  const size_t numRanges = std::max((size_t) 1,
+      std::min(Threads::Count(), numBlocks));
+  const size_t d = predictors.n_rows;
+  const size_t offset = intercept ? 1 : 0;
+
+  std::vector<arma::mat> rangeXtx(numRanges);
+  std::vector<arma::vec> rangeXty(numRanges);
+  Threads::ParallelFor(0, numRanges, [&](const size_t range)
   {
-    p = p * diagmat(sqrt(weights));
-    r = sqrt(weights) % responses;
+    arma::mat& localXtx = rangeXtx[range];
+    arma::vec& localXty = rangeXty[range];
+    localXtx.zeros(xtx.n_rows, xtx.n_cols);
+    localXty.zeros(xty.n_elem);
+
+    const size_t firstBlock = range * numBlocks / numRanges;
+    const size_t lastBlock = (range + 1) * numBlocks / numRanges;
+    for (size_t block = firstBlock; block < lastBlock; ++block)
+    {
+      const size_t begin = block * blockSize;
+      const size_t count = std::min(blockSize,
+          (size_t) predictors.n_cols - begin);
+
+      // Aliases of the points and responses of the block; no memory is copied.
+      const arma::mat x(const_cast<double*>(predictors.colptr(begin)), d,
+          count, false, true);
+      const arma::rowvec y(const_cast<double*>(responses.memptr()) + begin,
+          count, false, true);
+
+      if (weights.n_elem > 0)
+      {
+        const arma::rowvec w = weights.subvec(begin, begin + count - 1);
+        const arma::mat wx = x.each_row() % w;
+        localXtx.submat(offset, offset, offset + d - 1, offset + d - 1) +=
+            wx * x.t();
+        localXty.subvec(offset, offset + d - 1) += wx * y.t();
+        if (intercept)
+        {
+          const arma::vec sums = arma::sum(wx, 1);
+          localXtx(0, 0) += arma::accu(w);
+          localXtx.submat(1, 0, d, 0) += sums;
+          localXtx.submat(0, 1, 0, d) += sums.t();
+          localXty[0] += arma::dot(w, y);
+        }
+      }
+      else
+      {
+        localXtx.submat(offset, offset, offset + d - 1, offset + d - 1) +=
+            x * x.t();
+        localXty.subvec(offset, offset + d - 1) += x * y.t();
+        if (intercept)
+        {
+          const arma::vec sums = arma::sum(x, 1);
+          localXtx(0, 0) += count;
+          localXtx.submat(1, 0, d, 0) += sums;
+          localXtx.submat(0, 1, 0, d) += sums.t();
+          localXty[0] += arma::accu(y);
+        }
+      }
+    }
+  });
+
+  for (size_t range = 0; range < numRanges; ++range)
+  {
+    xtx += rangeXtx[range];
+    xty += rangeXty[range];
   }
+}
 
-  // Convert to this form:
-  // a * (X X^T) = y X^T.
-  // Then we'll use Armadillo to solve it.
+void LinearRegression::SolveNormalEquations(arma::mat& xtx,
+                                            const arma::vec& xty)
+{
+  // Solve a * (X X^T + lambda I) = y X^T.  The intercept is penalized along
+  // with the other parameters.
   // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
-  // (assuming the SVD is used to solve it)
-  arma::mat cov = p * p.t() +
-      lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
+  xtx.diag() += lambda;
 
-  parameters = arma::solve(cov, p * r.t());
+  parameters = arma::solve(xtx, xty);
 }
 
 void LinearRegression::Predict(const arma::mat& points,
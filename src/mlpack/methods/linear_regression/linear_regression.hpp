@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/chunked_reader.hpp>
 
 namespace mlpack {
 namespace regression /** Regression methods. */ {
@@ -22,6 +23,18 @@ namespace regression /** Regression methods. */ {
  * A simple linear regression algorithm using ordinary least squares.
  * Optionally, this class can perform ridge regression, if the lambda parameter
  * is set to a number greater than zero.
+ *
+ * The model is fit by solving the normal equations.  X^T X and X^T y are
+ * accumulated over blocks of points in parallel (see Threads), with the
+ * intercept handled implicitly, so the predictors are never copied and
+ * training needs O(d^2) memory in addition to the data.  A dataset that does
+ * not fit in memory can be read in chunks with a data::ChunkedReader:
+ *
+ * @code
+ * data::ChunkedReader<> reader("dataset.csv", 100000);
+ * LinearRegression lr;
+ * lr.Train(reader); // The responses are the last dimension.
+ * @endcode
  */
 class LinearRegression
 {
@@ -93,6 +106,37 @@ class LinearRegression
              const arma::rowvec& weights,
              const bool intercept = true);
 
+  /**
+   * Train the LinearRegression model on points that hold their response in
+   * one of their dimensions, with the given weights.  The predictors are the
+   * other dimensions of the points, in order; they are not copied out of the
+   * data.  Careful!  This will completely ignore and overwrite the existing
+   * model.
+   *
+   * @param data Points with their responses.
+   * @param responseDimension Dimension of the points holding the response.
+   * @param weights Observation weights (empty for unit weights).
+   * @param intercept Whether or not to fit an intercept term.
+   */
+  void Train(const arma::mat& data,
+             const size_t responseDimension,
+             const arma::rowvec& weights,
+             const bool intercept = true);
+
+  /**
+   * Train the LinearRegression model on the points read from the given reader,
+   * one chunk at a time, so that only one chunk and the O(d^2) normal
+   * equations are held in memory.  The last dimension of each point is its
+   * response, and the other dimensions are the predictors.  The reader is read
+   * from its current position to the end.  Careful!  This will completely
+   * ignore and overwrite the existing model.
+   *
+   * @param reader Reader to take the points and responses from.
+   * @param intercept Whether or not to fit an intercept term.
+   */
+  template<typename eT>
+  void Train(data::ChunkedReader<eT>& reader, const bool intercept = true);
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -160,8 +204,62 @@ class LinearRegression
 
   //! Indicates whether first parameter is intercept.
   bool intercept;
+
+  /**
+   * Add the contribution of the given points to the normal equations
+   * (X^T W X) b = X^T W y.  If intercept is true, the first row and column
+   * correspond to an implicit row of ones in X.  The points are processed in
+   * blocks, in parallel.
+   *
+   * @param predictors X, the points.
+   * @param responses y, the responses of the points.
+   * @param weights Weights of the points (empty for unit weights).
+   * @param intercept Whether or not to include the intercept term.
+   * @param xtx X^T W X, to add to.
+   * @param xty X^T W y, to add to.
+   */
+  static void AccumulateNormalEquations(const arma::mat& predictors,
+                                        const arma::rowvec& responses,
+                                        const arma::rowvec& weights,
+                                        const bool intercept,
+                                        arma::mat& xtx,
+                                        arma::vec& xty);
+
+  //! Solve the normal equations (with the ridge penalty) for the parameters.
+  void SolveNormalEquations(arma::mat& xtx, const arma::vec& xty);
 };
 
+template<typename eT>
+void LinearRegression::Train(data::ChunkedReader<eT>& reader,
+                             const bool intercept)
+{
+  if (reader.Dimensionality() < 2)
+  {
+    throw std::invalid_argument("LinearRegression::Train(): the points must "
+        "have at least one predictor and a response");
+  }
+
+  this->intercept = intercept;
+
+  const size_t dimensionality = reader.Dimensionality() - 1;
+  const size_t size = dimensionality + (intercept ? 1 : 0);
+  arma::mat xtx(size, size, arma::fill::zeros);
+  arma::vec xty(size, arma::fill::zeros);
+
+  arma::Mat<eT> chunk;
+  while (reader.NextChunk(chunk))
+  {
+    const arma::mat predictors = arma::conv_to<arma::mat>::from(
+        chunk.rows(0, dimensionality - 1));
+    const arma::rowvec responses = arma::conv_to<arma::rowvec>::from(
+        chunk.row(dimensionality));
+    AccumulateNormalEquations(predictors, responses, arma::rowvec(), intercept,
+        xtx, xty);
+  }
+
+  SolveNormalEquations(xtx, xty);
+}
+
 } // namespace regression
 } // namespace mlpack
 
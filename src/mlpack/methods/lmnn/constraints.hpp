@@ -26,6 +26,15 @@ namespace lmnn {
  * of each data point), Impostors() (used for calculating impostors of each
  * data point) and Triplets() (Generates sets of {dataset, target neighbors,
  * impostors} tripltets.)
+ *
+ * The impostors of the points of each class are searched for among the points
+ * of the other classes, with one reference tree per class.  The classes are
+ * searched in parallel (see Threads).  The trees are kept between calls: when
+ * the dataset given to Impostors() has moved (e.g. because the learned
+ * transformation changed), the trees are refitted to the new points, and they
+ * are only rebuilt once the points have moved by more than RebuildTolerance()
+ * relative to the points the trees were built on.  A refitted tree gives exact
+ * results; it is just less efficient than a new one.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class Constraints
@@ -178,6 +187,13 @@ class Constraints
   //! Modify the number of target neighbors (k).
   size_t& K() { return k; }
 
+  //! Get the relative change of the points above which the impostor trees
+  //! are rebuilt instead of refitted.
+  double RebuildTolerance() const { return rebuildTolerance; }
+  //! Modify the relative change of the points above which the impostor trees
+  //! are rebuilt instead of refitted.
+  double& RebuildTolerance() { return rebuildTolerance; }
+
   //! Access the boolean value of precalculated.
   const bool& PreCalulated() const { return precalculated; }
   //! Modify the value of precalculated.
@@ -199,6 +215,47 @@ class Constraints
   //! False if nothing has ever been precalculated.
   bool precalculated;
 
+  //! For each class, the search over the points of the other classes (the
+  //! reference tree of the impostor search).
+  std::vector<KNN> impostorSearch;
+
+  //! For each class, the mapping from the points of its impostor tree to
+  //! their positions in indexDiff.
+  std::vector<std::vector<size_t>> impostorOldFromNew;
+
+  //! The relative change of the points above which the impostor trees are
+  //! rebuilt.
+  double rebuildTolerance;
+
+  /**
+   * Calculate the k differently labeled nearest neighbors (and the distances
+   * to them) of the given points, and store them in the columns of the output
+   * matrices that correspond to the points.
+   *
+   * @param outputNeighbors Matrix to store impostors in.
+   * @param outputDistance Matrix to store distances in (or NULL).
+   * @param dataset Input dataset.
+   * @param labels Input dataset labels.
+   * @param norms Norms of the points, used to order ties.
+   * @param queryPoints Indices of the points to calculate impostors for.
+   */
+  void ComputeImpostors(arma::Mat<size_t>& outputNeighbors,
+                        arma::mat* outputDistance,
+                        const arma::mat& dataset,
+                        const arma::Row<size_t>& labels,
+                        const arma::vec& norms,
+                        const arma::uvec& queryPoints);
+
+  /**
+   * Make the impostor tree of the given class hold the current points of the
+   * other classes: build it if it doesn't exist or the points moved by more
+   * than rebuildTolerance, and refit it otherwise.
+   *
+   * @param dataset Input dataset.
+   * @param classIndex Index of the class.
+   */
+  void UpdateImpostorTree(const arma::mat& dataset, const size_t classIndex);
+
   /**
   * Precalculate the unique labels, and indices of similar
   * and different datapoints on the basis of labels.
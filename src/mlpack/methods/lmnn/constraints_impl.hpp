@@ -24,7 +24,8 @@ Constraints<MetricType>::Constraints(
     const arma::Row<size_t>& labels,
     const size_t k) :
     k(k),
-    precalculated(false)
+    precalculated(false),
+    rebuildTolerance(0.1)
 {
   // Ensure a valid k is passed.
   size_t minCount = arma::min(arma::histc(labels, arma::unique(labels)));
@@ -168,33 +169,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
                                         const arma::Row<size_t>& labels,
                                         const arma::vec& norms)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Perform KNN search with differently labeled points as reference
-    // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputMatrix.cols(indexSame[i]) = neighbors;
-  }
+  ComputeImpostors(outputMatrix, NULL, dataset, labels, norms,
+      arma::regspace<arma::uvec>(0, dataset.n_cols - 1));
 }
 
 // Calculates k differently labeled nearest neighbors. The function
@@ -206,34 +182,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
                                         const arma::Row<size_t>& labels,
                                         const arma::vec& norms)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Perform KNN search with differently labeled points as reference
-    // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputNeighbors.cols(indexSame[i]) = neighbors;
-    outputDistance.cols(indexSame[i]) = distances;
-  }
+  ComputeImpostors(outputNeighbors, &outputDistance, dataset, labels, norms,
+      arma::regspace<arma::uvec>(0, dataset.n_cols - 1));
 }
 
 // Calculates k differently labeled nearest neighbors on a
@@ -246,42 +196,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
                                         const size_t begin,
                                         const size_t batchSize)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputMatrix.cols(begin + subIndexSame) = neighbors;
-  }
+  ComputeImpostors(outputMatrix, NULL, dataset, labels, norms,
+      arma::regspace<arma::uvec>(begin, begin + batchSize - 1));
 }
 
 // Calculates k differently labeled nearest neighbors & distances on a
@@ -295,43 +211,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
                                         const size_t begin,
                                         const size_t batchSize)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
-
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputNeighbors.cols(begin + subIndexSame) = neighbors;
-    outputDistance.cols(begin + subIndexSame) = distances;
-  }
+  ComputeImpostors(outputNeighbors, &outputDistance, dataset, labels, norms,
+      arma::regspace<arma::uvec>(begin, begin + batchSize - 1));
 }
 
 // Calculates k differently labeled nearest neighbors & distances over some
@@ -345,29 +226,49 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
                                         const arma::uvec& points,
                                         const size_t numPoints)
 {
-  // Perform pre-calculation. If neccesary.
-  Precalculate(labels);
+  if (numPoints == 0)
+    return;
 
-  // KNN instance.
-  KNN knn;
+  ComputeImpostors(outputNeighbors, &outputDistance, dataset, labels, norms,
+      points.head(numPoints));
+}
 
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+template<typename MetricType>
+void Constraints<MetricType>::ComputeImpostors(
+    arma::Mat<size_t>& outputNeighbors,
+    arma::mat* outputDistance,
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    const arma::vec& norms,
+    const arma::uvec& queryPoints)
+{
+  // Perform pre-calculation. If neccesary.
+  Precalculate(labels);
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
+  const arma::Row<size_t> queryLabels = labels.cols(queryPoints);
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
+  // Each class has its own reference tree and writes its own columns of the
+  // output, so the classes can be handled in parallel.
+  Threads::ParallelFor(0, uniqueLabels.n_elem, [&](const size_t i)
   {
-    // Calculate impostors.
-    subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
-        uniqueLabels[i]);
+    const arma::uvec classPoints = queryPoints.elem(
+        arma::find(queryLabels == uniqueLabels[i]));
+    if (classPoints.n_elem == 0)
+      return;
+
+    UpdateImpostorTree(dataset, i);
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(points.elem(subIndexSame)),
-        k, neighbors, distances);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    impostorSearch[i].Search(dataset.cols(classPoints), k, neighbors,
+        distances);
+
+    // Map the neighbors from the order of the tree to their positions in
+    // indexDiff.
+    for (size_t j = 0; j < neighbors.n_elem; j++)
+      neighbors(j) = impostorOldFromNew[i][neighbors(j)];
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -378,9 +279,44 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
       neighbors(j) = indexDiff[i].at(neighbors(j));
 
     // Store impostors.
-    outputNeighbors.cols(points.elem(subIndexSame)) = neighbors;
-    outputDistance.cols(points.elem(subIndexSame)) = distances;
+    outputNeighbors.cols(classPoints) = neighbors;
+    if (outputDistance)
+      outputDistance->cols(classPoints) = distances;
+  });
+}
+
+template<typename MetricType>
+void Constraints<MetricType>::UpdateImpostorTree(const arma::mat& dataset,
+                                                 const size_t classIndex)
+{
+  std::vector<size_t>& oldFromNew = impostorOldFromNew[classIndex];
+  KNN& search = impostorSearch[classIndex];
+  const arma::uvec& reference = indexDiff[classIndex];
+
+  if (!oldFromNew.empty() && search.ReferenceSet().n_rows == dataset.n_rows)
+  {
+    // Gather the current positions of the points of the tree, in the order of
+    // the tree.
+    arma::mat points(dataset.n_rows, oldFromNew.size());
+    for (size_t j = 0; j < oldFromNew.size(); ++j)
+      points.col(j) = dataset.col(reference[oldFromNew[j]]);
+
+    const double change = arma::norm(points - search.ReferenceSet(), "fro");
+    if (change == 0.0)
+      return; // The points haven't moved.
+
+    if (change <= rebuildTolerance * arma::norm(search.ReferenceSet(), "fro"))
+    {
+      // Keep the structure of the tree, and only recompute its bounds.
+      search.ReferenceTree().Dataset().swap(points);
+      search.ReferenceTree().RefitBounds();
+      return;
+    }
   }
+
+  oldFromNew.clear();
+  typename KNN::Tree tree(dataset.cols(reference), oldFromNew);
+  search.Train(std::move(tree));
 }
 
 // Generates {data point, target neighbors, impostors} triplets using
@@ -432,6 +368,12 @@ inline void Constraints<MetricType>::Precalculate(
   indexSame.resize(uniqueLabels.n_elem);
   indexDiff.resize(uniqueLabels.n_elem);
 
+  // Any trees built for other labels are no longer valid.
+  impostorSearch.clear();
+  impostorSearch.resize(uniqueLabels.n_elem);
+  impostorOldFromNew.clear();
+  impostorOldFromNew.resize(uniqueLabels.n_elem);
+
   for (size_t i = 0; i < uniqueLabels.n_elem; i++)
   {
     // Store same and diff indices.
@@ -35,32 +35,44 @@ void LocalCoordinateCoding::Encode(const arma::mat& data, arma::mat& codes)
       * data);
 
   arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
 
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; i++)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-    {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-    }
-
-    arma::vec invW = invSqDists.unsafe_col(i);
-    arma::mat dictPrime = dictionary * diagmat(invW);
 
-    arma::mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
+  // The points are independent, so they are encoded in parallel, in batches.
+  // Each batch reuses its weighted dictionary and Gram matrix (which keep
+  // their memory between points) and one LARS object for all its points.
+  const size_t batchSize = 64;
+  const size_t numBatches = (data.n_cols + batchSize - 1) / batchSize;
+  Log::Debug << "Encoding " << data.n_cols << " points." << std::endl;
+  Threads::ParallelFor(0, numBatches, [&](const size_t batch)
+  {
+    arma::mat dictPrime(dictionary.n_rows, dictionary.n_cols);
+    arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
+    arma::rowvec responses;
 
     bool useCholesky = false;
     regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
 
-    // Run LARS for this point, by making an alias of the point and passing
-    // that.
-    arma::vec beta = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictPrime, responses, beta, false);
-    beta %= invW; // Remember, beta is an alias of codes.col(i).
-  }
+    const size_t end = std::min((size_t) data.n_cols, (batch + 1) * batchSize);
+    for (size_t i = batch * batchSize; i < end; ++i)
+    {
+      // dictPrime = dictionary * diagmat(invW), and dictGramTD =
+      // diagmat(invW) * dictGram * diagmat(invW), computed in place.
+      const arma::vec invW = invSqDists.unsafe_col(i);
+      dictPrime = dictionary;
+      dictPrime.each_row() %= invW.t();
+      dictGramTD = dictGram;
+      dictGramTD.each_col() %= invW;
+      dictGramTD.each_row() %= invW.t();
+
+      // Run LARS for this point, by making an alias of the point and passing
+      // that.
+      arma::vec beta = codes.unsafe_col(i);
+      responses = data.col(i).t();
+      lars.Train(dictPrime, responses, beta, false);
+      beta %= invW; // Remember, beta is an alias of codes.col(i).
+    }
+  });
 }
 
 void LocalCoordinateCoding::OptimizeDictionary(const arma::mat& data,
@@ -164,10 +164,14 @@ void LogisticRegressionFunction<MatType>::Gradient(
   const arma::rowvec sigmoids = (1 / (1 + arma::exp(-parameters(0, 0)
       - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
 
+  // The predictors are multiplied by a dense vector, which is efficient for
+  // both dense and sparse predictors (and does not transpose them).
+  const arma::rowvec diffs = sigmoids -
+      arma::conv_to<arma::rowvec>::from(responses);
   gradient.set_size(arma::size(parameters));
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  gradient[0] = arma::accu(diffs);
+  gradient.tail_cols(parameters.n_elem - 1) = (predictors * diffs.t()).t() +
+      regularization;
 }
 
 //! Evaluate the gradient of the logistic regression objective function for a
@@ -191,12 +195,13 @@ void LogisticRegressionFunction<MatType>::Gradient(
   // Calculating the sigmoid function values.
   const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-exponents));
 
+  const arma::rowvec diffs = sigmoids - arma::conv_to<arma::rowvec>::from(
+      responses.subvec(begin, begin + batchSize - 1));
   gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  gradient[0] = arma::accu(diffs);
+  gradient.tail_cols(parameters.n_elem - 1) =
+      (predictors.cols(begin, begin + batchSize - 1) * diffs.t()).t() +
+      regularization;
 }
 
 /**
@@ -220,7 +225,7 @@ void LogisticRegressionFunction<MatType>::PartialGradient(
   }
   else
   {
-    gradient[j] = arma::dot(-predictors.row(j - 1), diffs) + lambda *
+    gradient[j] = -arma::dot(predictors.row(j - 1), diffs) + lambda *
       parameters(0, j);
   }
 }
@@ -243,10 +248,14 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
   const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
       parameters.tail_cols(parameters.n_elem - 1) * predictors)));
 
+  // The predictors are multiplied by a dense vector, which is efficient for
+  // both dense and sparse predictors (and does not transpose them).
+  const arma::rowvec diffs = sigmoids -
+      arma::conv_to<arma::rowvec>::from(responses);
   gradient.set_size(arma::size(parameters));
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  gradient[0] = arma::accu(diffs);
+  gradient.tail_cols(parameters.n_elem - 1) = (predictors * diffs.t()).t() +
+      regularization;
 
   // Now compute the objective function using the sigmoids.
   double result = arma::accu(arma::log(1.0 -
@@ -280,12 +289,13 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
       parameters.tail_cols(parameters.n_elem - 1) *
       predictors.cols(begin, begin + batchSize - 1))));
 
+  const arma::rowvec diffs = sigmoids - arma::conv_to<arma::rowvec>::from(
+      responses.subvec(begin, begin + batchSize - 1));
   gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  gradient[0] = arma::accu(diffs);
+  gradient.tail_cols(parameters.n_elem - 1) =
+      (predictors.cols(begin, begin + batchSize - 1) * diffs.t()).t() +
+      regularization;
 
   // Now compute the objective function using the sigmoids.
   arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
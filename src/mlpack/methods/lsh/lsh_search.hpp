@@ -188,6 +188,33 @@ class LSHSearch
              const size_t bucketSize = 500,
              const arma::cube& projection = arma::cube());
 
+  /**
+   * Add the given points to the reference set, and hash them into the existing
+   * tables; nothing is rehashed.  The new points are held in growable buckets
+   * next to the compact tables, and they are merged into the compact tables
+   * (see Compact()) once they are a quarter of the compact tables, so the cost
+   * of each insertion is amortized constant per table.  The bucket size limit
+   * still holds: points that do not fit in a full bucket are not stored in it.
+   *
+   * The new points get the indices referenceSet.n_cols onwards, in order.
+   * Appending many points at once is faster than appending them one by one,
+   * since the reference set is copied each time.
+   *
+   * @param newPoints Points to add to the reference set.
+   */
+  void Insert(const arma::mat& newPoints);
+
+  /**
+   * Merge the points added with Insert() into the compact tables.  This is done
+   * automatically by Insert() and before the model is saved, but it may be
+   * called to make queries as fast as possible.
+   */
+  void Compact();
+
+  //! Get the number of points (summed over the tables) inserted since the
+  //! tables were last compacted.
+  size_t NumPending() const { return numPending; }
+
   /**
    * Compute the nearest neighbors of the points in the given query set and
    * store the output in the given matrices.  The matrices will be set to the
@@ -280,9 +307,17 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  /**
+   * Get the second hash table, as one vector of point indices per row.  The
+   * table is held in a compact form (see BucketOffsets()), so this builds a
+   * copy; it is meant for inspection, not for use in a loop.
+   */
+  std::vector<arma::Col<size_t>> SecondHashTable() const;
+
+  //! Get the offset of each row of the second hash table in the bucket
+  //! contents; row i holds the points at offsets [i, i + 1).  Length: number of
+  //! rows + 1.
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -297,69 +332,102 @@ class LSHSearch
 
  private:
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * Compute the second hash of every given point in every table, in parallel.
    *
-   * @param queryPoint The query point currently being processed.
-   * @param referenceIndices The list of neighbor candidates obtained from
-   *    hashing the query into all the hash tables and eventually into
-   *    multiple buckets of the second hash table.
-   * @param numTablesToSearch The number of tables to perform the search in. If
-   *    0, all tables are searched.
-   * @param T The number of additional probing bins for multiprobe LSH. If 0,
-   *    single-probe is used.
+   * @param points Points to hash.
+   * @param secondHashVectors Matrix to store the hashes in; the hashes for
+   *     table i are stored in column i.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
-                              arma::uvec& referenceIndices,
-                              size_t numTablesToSearch,
-                              const size_t T) const;
+  void HashPoints(const arma::mat& points,
+                  arma::Mat<size_t>& secondHashVectors) const;
 
   /**
-   * This is a helper function that computes the distance of the query to the
-   * neighbor candidates and appropriately stores the best 'k' candidates.  This
-   * is specific to the monochromatic search case, where the query set is the
-   * reference set.
+   * Find the neighbors of every point of the query set.  Queries are processed
+   * in blocks: the projections of a whole block in all tables are computed
+   * with one matrix multiplication, and then the queries of the block are
+   * processed in parallel.  Each thread reuses its own bitset to find the
+   * distinct candidates of a query, and computes the distances to the
+   * candidates in blocks.
    *
-   * @param queryIndex The index of the query in question
-   * @param referenceIndices The vector of indices of candidate neighbors for
-   *    the query.
+   * @param querySet Set of query points.
+   * @param monochromatic Whether the query set is the reference set (so that
+   *    a query is not returned as its own neighbor).
    * @param k Number of neighbors to search for.
-   * @param neighbors Matrix holding output neighbors.
+   * @param resultingNeighbors Matrix holding output neighbors.
    * @param distances Matrix holding output distances.
+   * @param numTablesToSearch The number of tables to perform the search in.
+   * @param T The number of additional probing bins for multiprobe LSH.
+   * @return The total number of candidates of all queries.
    */
-  void BaseCase(const size_t queryIndex,
-                const arma::uvec& referenceIndices,
-                const size_t k,
-                arma::Mat<size_t>& neighbors,
-                arma::mat& distances) const;
+  size_t SearchBatch(const arma::mat& querySet,
+                     const bool monochromatic,
+                     const size_t k,
+                     arma::Mat<size_t>& resultingNeighbors,
+                     arma::mat& distances,
+                     const size_t numTablesToSearch,
+                     const size_t T) const;
+
+  /**
+   * This function takes the projections of a query in each of the hash tables
+   * and computes the buckets of the second hash table that the query (and, for
+   * multiprobe LSH, its additional probing bins) falls into.
+   *
+   * @param queryCodesNotFloored The projections of the query in each table
+   *    (numProj x numTablesToSearch), without the offsets; the offsets are
+   *    added.
+   * @param numTablesToSearch The number of tables to perform the search in.
+   * @param T The number of additional probing bins for multiprobe LSH. If 0,
+   *    single-probe is used.
+   * @param hashMat Matrix to store the buckets in ((T + 1) x
+   *    numTablesToSearch).
+   */
+  void QueryBuckets(arma::mat& queryCodesNotFloored,
+                    const size_t numTablesToSearch,
+                    const size_t T,
+                    arma::Mat<size_t>& hashMat) const;
+
+  /**
+   * Collect the distinct points held in the given buckets, in increasing order;
+   * these are the neighbor candidates of the query.
+   *
+   * @param hashMat The buckets of the query (see QueryBuckets()).
+   * @param visited Bitset with one entry per reference point; it must be all
+   *    false, and it is all false again when this returns.
+   * @param candidates Vector to store the candidates in.
+   */
+  void CollectCandidates(const arma::Mat<size_t>& hashMat,
+                         std::vector<bool>& visited,
+                         std::vector<size_t>& candidates) const;
 
   /**
    * This is a helper function that computes the distance of the query to the
-   * neighbor candidates and appropriately stores the best 'k' candidates.  This
-   * is specific to bichromatic search, where the query set is not the same as
-   * the reference set.
+   * neighbor candidates and appropriately stores the best 'k' candidates.  The
+   * candidates are copied into a contiguous buffer in blocks, and the distances
+   * of each block are computed at once.
    *
-   * @param queryIndex The index of the query in question
-   * @param referenceIndices The vector of indices of candidate neighbors for
-   *    the query.
+   * @param queryPoint The query point.
+   * @param queryIndex The index of the query; this is the column of the output
+   *    matrices.
+   * @param skipIndex Index of a reference point to ignore (the query itself, in
+   *    the monochromatic case); referenceSet.n_cols ignores nothing.
+   * @param candidates The indices of candidate neighbors for the query.
    * @param k Number of neighbors to search for.
-   * @param querySet Set of query points.
+   * @param buffer Buffer for the blocks of candidates; reused between calls.
    * @param neighbors Matrix holding output neighbors.
    * @param distances Matrix holding output distances.
    */
-  void BaseCase(const size_t queryIndex,
-                const arma::uvec& referenceIndices,
+  void BaseCase(const arma::vec& queryPoint,
+                const size_t queryIndex,
+                const size_t skipIndex,
+                const std::vector<size_t>& candidates,
                 const size_t k,
-                const arma::mat& querySet,
+                arma::mat& buffer,
                 arma::Mat<size_t>& neighbors,
                 arma::mat& distances) const;
 
   /**
    * This function implements the core idea behind Multiprobe LSH. It is called
-   * by ReturnIndicesFromTables when T > 0. Given a query's code and its
+   * by QueryBuckets() when T > 0. Given a query's code and its
    * projection location, GetAdditionalProbingBins will calculate the T most
    * likely alternative bin codes (other than queryCode) where a query's
    * neighbors might be found in.
@@ -440,18 +508,60 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The start of each row of the final hash table in the bucket contents; row
+  //! i holds the points at bucketOffsets[i] to bucketOffsets[i + 1] - 1.  There
+  //! are (< secondHashSize) rows, each with (<= bucketSize) elements.
+  arma::Col<size_t> bucketOffsets;
+
+  //! The points of all rows of the hash table, one row after the other, when
+  //! the reference set is small enough for 32-bit indices (or empty).
+  arma::Col<uint32_t> smallBucketContents;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The points of all rows of the hash table, one row after the other, when
+  //! the reference set is too large for 32-bit indices (or empty).
+  arma::Col<size_t> bucketContents;
 
-  //! For a particular hash value, points to the row in secondHashTable
+  //! For a particular hash value, points to the row in the hash table
   //! corresponding to this value. Length secondHashSize.
   arma::Col<size_t> bucketRowInHashTable;
 
+  //! Points added to each row of the hash table by Insert() since the last
+  //! compaction.  Either empty, or one vector per row.
+  std::vector<std::vector<size_t>> pendingBuckets;
+
+  //! Total number of points held in pendingBuckets.
+  size_t numPending;
+
+  //! Get the number of rows held in the compact hash table.
+  size_t CompactRows() const
+  { return (bucketOffsets.n_elem == 0) ? 0 : bucketOffsets.n_elem - 1; }
+
+  //! Get the number of points in the given row of the hash table.
+  size_t BucketContentSize(const size_t row) const
+  {
+    const size_t compactSize = (row < CompactRows()) ?
+        bucketOffsets[row + 1] - bucketOffsets[row] : 0;
+    return compactSize +
+        ((row < pendingBuckets.size()) ? pendingBuckets[row].size() : 0);
+  }
+
+  //! Get the point at the given offset of the bucket contents.
+  size_t BucketContent(const size_t offset) const
+  {
+    return (bucketContents.n_elem > 0) ? bucketContents[offset] :
+        (size_t) smallBucketContents[offset];
+  }
+
+  /**
+   * Build the compact hash table from one vector of points per row.  This is
+   * used to load models saved with older versions.
+   *
+   * @param table Points of each row.
+   * @param contentSize Number of points held in each row.
+   */
+  void CompactBuckets(const std::vector<arma::Col<size_t>>& table,
+                      const arma::Col<size_t>& contentSize);
+
   //! The number of distance evaluations.
   size_t distanceEvaluations;
 
@@ -476,7 +586,7 @@ class LSHSearch
 
 //! Set the serialization version of the LSHSearch class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::LSHSearch<SortPolicy>, 1);
+    mlpack::neighbor::LSHSearch<SortPolicy>, 2);
 
 // Include implementation.
 #include "lsh_search_impl.hpp"
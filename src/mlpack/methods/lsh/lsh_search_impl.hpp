@@ -32,6 +32,7 @@ LSHSearch(arma::mat referenceSet,
   hashWidth(hashWidthIn),
   secondHashSize(secondHashSize),
   bucketSize(bucketSize),
+  numPending(0),
   distanceEvaluations(0)
 {
   // Pass work to training function.
@@ -52,6 +53,7 @@ LSHSearch(arma::mat referenceSet,
   hashWidth(hashWidthIn),
   secondHashSize(secondHashSize),
   bucketSize(bucketSize),
+  numPending(0),
   distanceEvaluations(0)
 {
   // Pass work to training function.
@@ -67,6 +69,7 @@ LSHSearch<SortPolicy>::LSHSearch() :
     hashWidth(0),
     secondHashSize(99901),
     bucketSize(500),
+    numPending(0),
     distanceEvaluations(0)
 {
 }
@@ -83,9 +86,12 @@ LSHSearch<SortPolicy>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketOffsets(other.bucketOffsets),
+    smallBucketContents(other.smallBucketContents),
+    bucketContents(other.bucketContents),
     bucketRowInHashTable(other.bucketRowInHashTable),
+    pendingBuckets(other.pendingBuckets),
+    numPending(other.numPending),
     distanceEvaluations(other.distanceEvaluations)
 {
   // Nothing to do.
@@ -103,9 +109,12 @@ LSHSearch<SortPolicy>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    smallBucketContents(std::move(other.smallBucketContents)),
+    bucketContents(std::move(other.bucketContents)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
+    pendingBuckets(std::move(other.pendingBuckets)),
+    numPending(other.numPending),
     distanceEvaluations(other.distanceEvaluations)
 {
   // Reset other model to defaults.
@@ -114,6 +123,7 @@ LSHSearch<SortPolicy>::LSHSearch(LSHSearch&& other) :
   other.hashWidth = 0;
   other.secondHashSize = 99901;
   other.bucketSize = 500;
+  other.numPending = 0;
   other.distanceEvaluations = 0;
 }
 
@@ -130,9 +140,12 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(const LSHSearch& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketOffsets = other.bucketOffsets;
+  smallBucketContents = other.smallBucketContents;
+  bucketContents = other.bucketContents;
   bucketRowInHashTable = other.bucketRowInHashTable;
+  pendingBuckets = other.pendingBuckets;
+  numPending = other.numPending;
   distanceEvaluations = other.distanceEvaluations;
 
   return *this;
@@ -151,9 +164,12 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(LSHSearch&& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketOffsets = std::move(other.bucketOffsets);
+  smallBucketContents = std::move(other.smallBucketContents);
+  bucketContents = std::move(other.bucketContents);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
+  pendingBuckets = std::move(other.pendingBuckets);
+  numPending = other.numPending;
   distanceEvaluations = other.distanceEvaluations;
 
   // Reset other model to defaults.
@@ -162,6 +178,7 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(LSHSearch&& other)
   other.hashWidth = 0;
   other.secondHashSize = 99901;
   other.bucketSize = 500;
+  other.numPending = 0;
   other.distanceEvaluations = 0;
 
   return *this;
@@ -177,8 +194,10 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
                                   const size_t bucketSize,
                                   const arma::cube &projection)
 {
-  // Set new reference set.
+  // Set new reference set.  Every thread of a search reads any of its points,
+  // so with NUMA awareness it is spread over all the nodes.
   this->referenceSet = std::move(referenceSet);
+  Threads::Interleave(this->referenceSet);
 
   // Set new parameters.
   this->numProj = numProj;
@@ -251,31 +270,105 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
         "tables provided must be equal to numProj");
   }
 
-  // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
+  // Step IV and V: hash every point in every table.  The second hash vector
+  // for table i will be held in column i.
+  arma::Mat<size_t> secondHashVectors;
+  HashPoints(this->referenceSet, secondHashVectors);
 
-  for (size_t i = 0; i < numTables; i++)
+  // Now, using the hash vectors for each table, count the number of rows we
+  // have in the second hash table.
+  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
+  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
+    secondHashBinCounts[secondHashVectors[i]]++;
+
+  // Enforce the maximum bucket size.
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
+      { return std::min(val, effectiveBucketSize); });
+
+  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
+
+  // Rows are given to buckets in the order the buckets are first seen (table
+  // by table), and each row starts where the previous one ends.
+  bucketOffsets.set_size(numRowsInTable + 1);
+  bucketOffsets[0] = 0;
+  size_t currentRow = 0;
+  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
+  {
+    const size_t hashInd = secondHashVectors[i];
+    if (bucketRowInHashTable[hashInd] == secondHashSize)
+    {
+      bucketRowInHashTable[hashInd] = currentRow;
+      bucketOffsets[currentRow + 1] = bucketOffsets[currentRow] +
+          secondHashBinCounts[hashInd];
+      currentRow++;
+    }
+  }
+
+  // Points are stored with 32-bit indices whenever possible, which halves the
+  // memory of the table.
+  const size_t numElements = bucketOffsets[numRowsInTable];
+  const bool smallIndices = (this->referenceSet.n_cols <= UINT32_MAX);
+  smallBucketContents.set_size(smallIndices ? numElements : 0);
+  bucketContents.set_size(smallIndices ? 0 : numElements);
+
+  // Next we must assign each point in each table to its row, in order, until
+  // the row is full.
+  arma::Col<size_t> rowEnd = bucketOffsets.head(numRowsInTable);
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_rows; ++j)
+    {
+      // The point ID is 'j'.
+      const size_t row = bucketRowInHashTable[secondHashVectors(j, i)];
+      if (rowEnd[row] < bucketOffsets[row + 1])
+      {
+        if (smallIndices)
+          smallBucketContents[rowEnd[row]++] = (uint32_t) j;
+        else
+          bucketContents[rowEnd[row]++] = j;
+      }
+    } // Loop over all points in the reference set.
+  } // Loop over tables.
+
+  // Nothing has been inserted into the new tables yet.
+  pendingBuckets.clear();
+  numPending = 0;
+
+  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
+            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
+            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
+            << std::endl;
+}
+
+// Compute the second hash of every point in every table.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::HashPoints(
+    const arma::mat& points,
+    arma::Mat<size_t>& secondHashVectors) const
+{
+  // Each table writes to its own (contiguous) column.
+  secondHashVectors.set_size(points.n_cols, numTables);
+
+  // The tables are independent, so they are hashed in parallel.
+  Threads::ParallelFor(0, numTables, [&](const size_t i)
   {
     // Step IV: create the 'numProj'-dimensional key for each point in each
     // table.
 
     // The following code performs the task of hashing each point to a
     // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
+    // 'points.n_cols') key matrix.
     //
     // For a single table, let the 'numProj' projections be denoted by 'proj_i'
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
-    arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
-    hashMat += offsetMat;
+    arma::mat hashMat = projections.slice(i).t() * points;
+    hashMat.each_col() += offsets.unsafe_col(i);
     hashMat /= hashWidth;
 
-    // Step V: Putting the points in the 'secondHashTable' by hashing the key.
+    // Step V: Putting the points in the hash table by hashing the key.
     // Now we hash every key, point ID to its corresponding bucket.  We must
     // also normalize the hashes to the range [0, secondHashSize).
     arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
@@ -285,121 +378,159 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
       if (unmodVector[j] >= 0.0)
       {
         const size_t key = size_t(fmod(unmodVector[j], shs));
-        secondHashVectors(i, j) = key;
+        secondHashVectors(j, i) = key;
       }
       else
       {
         const double mod = fmod(-unmodVector[j], shs);
         const size_t key = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
-        secondHashVectors(i, j) = key;
+        secondHashVectors(j, i) = key;
       }
     }
+  });
+}
+
+// Add points to the reference set and to the tables.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::Insert(const arma::mat& newPoints)
+{
+  if (projections.n_slices == 0)
+  {
+    throw std::invalid_argument("LSHSearch::Insert(): the model must be "
+        "trained before points are inserted");
   }
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
+  if (newPoints.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Insert(): dimensionality of new points ("
+        << newPoints.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
 
-  // Enforce the maximum bucket size.
-  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
+  arma::Mat<size_t> secondHashVectors;
+  HashPoints(newPoints, secondHashVectors);
 
-  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
+  const size_t firstIndex = referenceSet.n_cols;
+  referenceSet.insert_cols(firstIndex, newPoints);
 
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
+  // Every row gets a (possibly empty) list of new points.
+  if (pendingBuckets.size() < CompactRows())
+    pendingBuckets.resize(CompactRows());
+
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
   for (size_t i = 0; i < numTables; ++i)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
+    for (size_t j = 0; j < secondHashVectors.n_rows; ++j)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
+      // If this is an empty bucket, it gets a new row, after all the others.
+      const size_t hashInd = secondHashVectors(j, i);
       if (bucketRowInHashTable[hashInd] == secondHashSize)
       {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
+        bucketRowInHashTable[hashInd] = pendingBuckets.size();
+        pendingBuckets.emplace_back();
       }
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
+      const size_t row = bucketRowInHashTable[hashInd];
+      if (BucketContentSize(row) < effectiveBucketSize)
+      {
+        pendingBuckets[row].push_back(firstIndex + j);
+        ++numPending;
+      }
+    }
+  }
 
-  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
-            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
-            << std::endl;
+  // Merge the new points once they are a sizable part of the tables, so that
+  // each merge is paid for by the insertions before it.
+  const size_t numCompact = (CompactRows() == 0) ? 0 :
+      bucketOffsets[CompactRows()];
+  if (4 * numPending > numCompact)
+    Compact();
 }
 
-// Base case where the query set is the reference set.  (So, we can't return
-// ourselves as the nearest neighbor.)
+// Merge the inserted points into the compact tables.
 template<typename SortPolicy>
-inline force_inline
-void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
-                                     const arma::uvec& referenceIndices,
-                                     const size_t k,
-                                     arma::Mat<size_t>& neighbors,
-                                     arma::mat& distances) const
+void LSHSearch<SortPolicy>::Compact()
 {
-  // Let's build the list of candidate neighbors for the given query point.
-  // It will be initialized with k candidates:
-  // (WorstDistance, referenceSet.n_cols)
-  const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
-      referenceSet.n_cols);
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
+  if (pendingBuckets.empty())
+    return;
 
-  for (size_t j = 0; j < referenceIndices.n_elem; ++j)
+  const std::vector<arma::Col<size_t>> table = SecondHashTable();
+  arma::Col<size_t> contentSize(table.size());
+  for (size_t i = 0; i < table.size(); ++i)
+    contentSize[i] = table[i].n_elem;
+
+  pendingBuckets.clear();
+  numPending = 0;
+  CompactBuckets(table, contentSize);
+}
+
+// Build a copy of the second hash table, one vector per row.
+template<typename SortPolicy>
+std::vector<arma::Col<size_t>> LSHSearch<SortPolicy>::SecondHashTable() const
+{
+  const size_t numRows = std::max(CompactRows(), pendingBuckets.size());
+  std::vector<arma::Col<size_t>> table(numRows);
+  for (size_t i = 0; i < numRows; ++i)
   {
-    const size_t referenceIndex = referenceIndices[j];
-    // If the points are the same, skip this point.
-    if (queryIndex == referenceIndex)
-      continue;
+    table[i].set_size(BucketContentSize(i));
 
-    const double distance = metric::EuclideanDistance::Evaluate(
-        referenceSet.unsafe_col(queryIndex),
-        referenceSet.unsafe_col(referenceIndex));
+    size_t j = 0;
+    if (i < CompactRows())
+    {
+      for (size_t k = bucketOffsets[i]; k < bucketOffsets[i + 1]; ++k)
+        table[i][j++] = BucketContent(k);
+    }
 
-    Candidate c = std::make_pair(distance, referenceIndex);
-    // If this distance is better than the worst candidate, let's insert it.
-    if (CandidateCmp()(c, pqueue.top()))
+    if (i < pendingBuckets.size())
     {
-      pqueue.pop();
-      pqueue.push(c);
+      for (size_t k = 0; k < pendingBuckets[i].size(); ++k)
+        table[i][j++] = pendingBuckets[i][k];
     }
   }
 
-  for (size_t j = 1; j <= k; j++)
+  return table;
+}
+
+// Build the compact hash table from one vector of points per row.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::CompactBuckets(
+    const std::vector<arma::Col<size_t>>& table,
+    const arma::Col<size_t>& contentSize)
+{
+  bucketOffsets.set_size(table.size() + 1);
+  bucketOffsets[0] = 0;
+  for (size_t i = 0; i < table.size(); ++i)
   {
-    neighbors(k - j, queryIndex) = pqueue.top().second;
-    distances(k - j, queryIndex) = pqueue.top().first;
-    pqueue.pop();
+    bucketOffsets[i + 1] = bucketOffsets[i] +
+        std::min((size_t) contentSize[i], (size_t) table[i].n_elem);
+  }
+
+  const size_t numElements = bucketOffsets[table.size()];
+  const bool smallIndices = (referenceSet.n_cols <= UINT32_MAX);
+  smallBucketContents.set_size(smallIndices ? numElements : 0);
+  bucketContents.set_size(smallIndices ? 0 : numElements);
+  for (size_t i = 0; i < table.size(); ++i)
+  {
+    for (size_t j = 0; j < BucketContentSize(i); ++j)
+    {
+      if (smallIndices)
+        smallBucketContents[bucketOffsets[i] + j] = (uint32_t) table[i][j];
+      else
+        bucketContents[bucketOffsets[i] + j] = table[i][j];
+    }
   }
 }
 
-// Base case for bichromatic search.
+// Compute the distances to the candidates in blocks, and keep the best k.
 template<typename SortPolicy>
-inline force_inline
-void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
-                                     const arma::uvec& referenceIndices,
+void LSHSearch<SortPolicy>::BaseCase(const arma::vec& queryPoint,
+                                     const size_t queryIndex,
+                                     const size_t skipIndex,
+                                     const std::vector<size_t>& candidates,
                                      const size_t k,
-                                     const arma::mat& querySet,
+                                     arma::mat& buffer,
                                      arma::Mat<size_t>& neighbors,
                                      arma::mat& distances) const
 {
@@ -411,19 +542,41 @@ void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
   std::vector<Candidate> vect(k, def);
   CandidateList pqueue(CandidateCmp(), std::move(vect));
 
-  for (size_t j = 0; j < referenceIndices.n_elem; ++j)
+  // Each block of candidates is copied next to each other, so that all of its
+  // distances are computed in one pass over contiguous memory.
+  const size_t blockSize = 64;
+  if (buffer.n_rows != referenceSet.n_rows || buffer.n_cols != blockSize)
+    buffer.set_size(referenceSet.n_rows, blockSize);
+
+  for (size_t begin = 0; begin < candidates.size(); begin += blockSize)
   {
-    const size_t referenceIndex = referenceIndices[j];
-    const double distance = metric::EuclideanDistance::Evaluate(
-        querySet.unsafe_col(queryIndex),
-        referenceSet.unsafe_col(referenceIndex));
-
-    Candidate c = std::make_pair(distance, referenceIndex);
-    // If this distance is better than the worst candidate, let's insert it.
-    if (CandidateCmp()(c, pqueue.top()))
+    const size_t count = std::min(blockSize, candidates.size() - begin);
+    for (size_t j = 0; j < count; ++j)
+    {
+      const double* point = referenceSet.colptr(candidates[begin + j]);
+      std::copy(point, point + referenceSet.n_rows, buffer.colptr(j));
+    }
+
+    // An alias of the first count columns of the buffer.
+    arma::mat block(buffer.memptr(), referenceSet.n_rows, count, false, true);
+    block.each_col() -= queryPoint;
+    const arma::rowvec blockDistances =
+        arma::sqrt(arma::sum(arma::square(block), 0));
+
+    for (size_t j = 0; j < count; ++j)
     {
-      pqueue.pop();
-      pqueue.push(c);
+      const size_t referenceIndex = candidates[begin + j];
+      // If the points are the same, skip this point.
+      if (referenceIndex == skipIndex)
+        continue;
+
+      Candidate c = std::make_pair(blockDistances[j], referenceIndex);
+      // If this distance is better than the worst candidate, let's insert it.
+      if (CandidateCmp()(c, pqueue.top()))
+      {
+        pqueue.pop();
+        pqueue.push(c);
+      }
     }
   }
 
@@ -696,44 +849,26 @@ void LSHSearch<SortPolicy>::GetAdditionalProbingBins(
   }
 }
 
+// Find the buckets of a query in each table.
 template<typename SortPolicy>
-template<typename VecType>
-void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
-    arma::uvec& referenceIndices,
-    size_t numTablesToSearch,
-    const size_t T) const
+void LSHSearch<SortPolicy>::QueryBuckets(arma::mat& queryCodesNotFloored,
+                                         const size_t numTablesToSearch,
+                                         const size_t T,
+                                         arma::Mat<size_t>& hashMat) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
-
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
-  // 'numProj' projections for each table. This gives us 'numTablesToSearch'
+  // The projections of the query in each table give us 'numTablesToSearch'
   // keys for the query where each key is a 'numProj' dimensional integer
   // vector.
-
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
-  arma::mat queryCodesNotFloored(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; i++)
-    queryCodesNotFloored.unsafe_col(i) = projections.slice(i).t() * queryPoint;
-
   queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
-  allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
+  const arma::mat allProjInTables =
+      arma::floor(queryCodesNotFloored / hashWidth);
 
   // Use hashMat to store the primary probing codes and any additional codes
   // from multiprobe LSH.
-  arma::Mat<size_t> hashMat;
   hashMat.set_size(T + 1, numTablesToSearch);
 
   // Compute the primary hash value of each key of the query into a bucket of
-  // the secondHashTable using the secondHashWeights.
+  // the second hash table using the secondHashWeights.
   hashMat.row(0) = arma::conv_to<arma::Row<size_t>> // Floor by typecasting
       ::from(secondHashWeights.t() * allProjInTables);
   // Mod to compute 2nd-level codes.
@@ -752,8 +887,8 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
                                 T,
                                 additionalProbingBins);
 
-      // Map each probing bin to a bin in secondHashTable (just like we did for
-      // the primary hash table).
+      // Map each probing bin to a bin in the second hash table (just like we
+      // did for the primary hash table).
       hashMat(arma::span(1, T), i) = // Compute code of rows 1:end of column i
         arma::conv_to< arma::Col<size_t> >:: // floor by typecasting to size_t
         from(secondHashWeights.t() * additionalProbingBins);
@@ -761,91 +896,129 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
         hashMat(p, i) = (hashMat(p, i) % secondHashSize);
     }
   }
+}
 
-  // Count number of points hashed in the same bucket as the query.
-  size_t maxNumPoints = 0;
-  for (size_t i = 0; i < numTablesToSearch; ++i)
+// Collect the distinct points in the buckets of a query.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::CollectCandidates(
+    const arma::Mat<size_t>& hashMat,
+    std::vector<bool>& visited,
+    std::vector<size_t>& candidates) const
+{
+  candidates.clear();
+  for (size_t i = 0; i < hashMat.n_elem; ++i)
   {
-    for (size_t p = 0; p < T + 1; ++p)
+    const size_t tableRow = bucketRowInHashTable[hashMat[i]];
+
+    // Points of the compact table.
+    if (tableRow < CompactRows())
     {
-      const size_t hashInd = hashMat(p, i); // find query's bucket
-      const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+      for (size_t j = bucketOffsets[tableRow]; j < bucketOffsets[tableRow + 1];
+           ++j)
+      {
+        const size_t index = BucketContent(j);
+        if (!visited[index])
+        {
+          visited[index] = true;
+          candidates.push_back(index);
+        }
+      }
     }
-  }
 
-  // There are two ways to proceed here:
-  // Either allocate a maxNumPoints-size vector, place all candidates, and run
-  // unique on the vector to discard duplicates.
-  // Or allocate a referenceSet.n_cols size vector (i.e. number of reference
-  // points) of zeros, and mark found indices as 1.
-  // Option 1 runs faster for small maxNumPoints but worse for larger values, so
-  // we choose based on a heuristic.
-  const float cutoff = 0.1;
-  const float selectivity = static_cast<float>(maxNumPoints) /
-      static_cast<float>(referenceSet.n_cols);
-
-  if (selectivity > cutoff)
-  {
-    // Heuristic: larger maxNumPoints means we should use find() because it
-    // should be faster.
-    // Reference points hashed in the same bucket as the query are set to >0.
-    arma::Col<size_t> refPointsConsidered;
-    refPointsConsidered.zeros(referenceSet.n_cols);
-
-    for (size_t i = 0; i < numTablesToSearch; ++i) // for all tables
+    // Points inserted since the last compaction.
+    if (tableRow < pendingBuckets.size())
     {
-      for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
+      for (size_t j = 0; j < pendingBuckets[tableRow].size(); ++j)
       {
-        // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
-
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+        const size_t index = pendingBuckets[tableRow][j];
+        if (!visited[index])
         {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          visited[index] = true;
+          candidates.push_back(index);
         }
       }
     }
-
-    // Only keep reference points found in at least one bucket.
-    referenceIndices = arma::find(refPointsConsidered > 0);
-    return;
   }
-  else
-  {
-    // Heuristic: smaller maxNumPoints means we should use unique() because it
-    // should be faster.
-    // Allocate space for the query's potential neighbors.
-    arma::uvec refPointsConsideredSmall;
-    refPointsConsideredSmall.zeros(maxNumPoints);
 
-    // Retrieve candidates.
-    size_t start = 0;
+  // Clear only the bits we set, so the bitset can be reused by the next query.
+  for (size_t j = 0; j < candidates.size(); ++j)
+    visited[candidates[j]] = false;
+
+  // Sorted candidates are visited in memory order.
+  std::sort(candidates.begin(), candidates.end());
+}
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
+// Find the neighbors of a set of queries, one block of queries at a time.
+template<typename SortPolicy>
+size_t LSHSearch<SortPolicy>::SearchBatch(
+    const arma::mat& querySet,
+    const bool monochromatic,
+    const size_t k,
+    arma::Mat<size_t>& resultingNeighbors,
+    arma::mat& distances,
+    size_t numTablesToSearch,
+    const size_t T) const
+{
+  // Decide on the number of tables to look into.
+  if (numTablesToSearch == 0) // If no user input is given, search all.
+    numTablesToSearch = numTables;
+
+  // Sanity check to make sure that the existing number of tables is not
+  // exceeded.
+  if (numTablesToSearch > numTables)
+    numTablesToSearch = numTables;
+
+  // The projections of the tables are held one after the other in the cube, so
+  // the first 'numTablesToSearch' of them form one matrix.
+  const arma::mat allProjections(const_cast<double*>(projections.memptr()),
+      projections.n_rows, numProj * numTablesToSearch, false, true);
+
+  // The projections of a block of queries in all tables.  A block is large
+  // enough for an efficient matrix multiplication, and small enough to keep
+  // this matrix small.
+  const size_t queryBlockSize = 1024;
+  arma::mat blockProjections;
+
+  size_t numCandidates = 0;
+  #pragma omp parallel reduction(+:numCandidates)
+  {
+    // The state of each thread is reused for all of its queries.
+    std::vector<bool> visited(referenceSet.n_cols, false);
+    std::vector<size_t> candidates;
+    arma::Mat<size_t> hashMat;
+    arma::mat buffer;
+
+    for (size_t begin = 0; begin < querySet.n_cols; begin += queryBlockSize)
     {
-      for (size_t p = 0; p < T + 1; ++p)
+      const size_t end = std::min(begin + queryBlockSize,
+          (size_t) querySet.n_cols);
+
+      #pragma omp single
       {
-        const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
+        blockProjections = allProjections.t() *
+            querySet.cols(begin, end - 1);
+      }
 
-        if (tableRow < secondHashSize)
-        {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+      {
+        // The projections of the query in each table, one table per column.
+        arma::mat queryCodesNotFloored(blockProjections.colptr(i - begin),
+            numProj, numTablesToSearch);
+        QueryBuckets(queryCodesNotFloored, numTablesToSearch, T, hashMat);
+
+        CollectCandidates(hashMat, visited, candidates);
+        numCandidates += candidates.size();
+
+        // Go through all the candidates and save the best 'k' candidates.
+        BaseCase(querySet.unsafe_col(i), i,
+            monochromatic ? (size_t) i : referenceSet.n_cols, candidates, k,
+            buffer, resultingNeighbors, distances);
       }
     }
-
-    // Keep only one copy of each candidate.
-    referenceIndices = arma::unique(refPointsConsideredSmall);
-    return;
   }
+
+  return numCandidates;
 }
 
 // Search for nearest neighbors in a given query set.
@@ -900,34 +1073,12 @@ void LSHSearch<SortPolicy>::Search(const arma::mat& querySet,
     Log::Info << "Running multiprobe LSH with " << Teffective
         <<" additional probing bins per table per query." << std::endl;
 
-  size_t avgIndicesReturned = 0;
-
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
-  {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
-  }
+  // Hash every query into every hash table and eventually into the second
+  // hash table to obtain the neighbor candidates, and keep the best 'k'.
+  size_t avgIndicesReturned = SearchBatch(querySet, false, k,
+      resultingNeighbors, distances, numTablesToSearch, Teffective);
 
   Timer::Stop("computing_neighbors");
 
@@ -966,34 +1117,13 @@ Search(const size_t k,
     Log::Info << "Running multiprobe LSH with " << Teffective <<
       " additional probing bins per table per query."<< std::endl;
 
-  size_t avgIndicesReturned = 0;
-
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
-  {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
-  }
+  // Hash every point into every hash table and eventually into the second
+  // hash table to obtain the neighbor candidates, and keep the best 'k'.  A
+  // point is not its own neighbor.
+  size_t avgIndicesReturned = SearchBatch(referenceSet, true, k,
+      resultingNeighbors, distances, numTablesToSearch, Teffective);
 
   Timer::Stop("computing_neighbors");
 
@@ -1066,74 +1196,93 @@ void LSHSearch<SortPolicy>::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(bucketSize);
   // needs specific handling for new version
 
-  // Backward compatibility: in older versions of LSHSearch, the secondHashTable
-  // was stored as an arma::Mat<size_t>.  So we need to properly load that, then
-  // prune it down to size.
-  if (version == 0)
-  {
-    arma::Mat<size_t> tmpSecondHashTable;
-    ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
-
-    // The old secondHashTable was stored in row-major format, so we transpose
-    // it.
-    tmpSecondHashTable = tmpSecondHashTable.t();
+  // Version 2 stores the compact hash table.  Inserted points are merged into
+  // it first, so that they are saved too.
+  if (Archive::is_saving::value)
+    Compact();
 
-    secondHashTable.resize(tmpSecondHashTable.n_cols);
-    for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
-    {
-      // Find length of each column.  We know we are at the end of the list when
-      // the value referenceSet.n_cols is seen.
-
-      size_t len = 0;
-      for (; len < tmpSecondHashTable.n_rows; ++len)
-        if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
-          break;
+  if (Archive::is_loading::value)
+  {
+    pendingBuckets.clear();
+    numPending = 0;
+  }
 
-      // Set the size of the new column correctly.
-      secondHashTable[i].set_size(len);
-      for (size_t j = 0; j < len; ++j)
-        secondHashTable[i](j) = tmpSecondHashTable(j, i);
-    }
+  if (version >= 2)
+  {
+    ar & BOOST_SERIALIZATION_NVP(bucketOffsets);
+    ar & BOOST_SERIALIZATION_NVP(smallBucketContents);
+    ar & BOOST_SERIALIZATION_NVP(bucketContents);
+    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
   }
   else
   {
-    size_t tables;
-    if (Archive::is_saving::value)
-      tables = secondHashTable.size();
-    ar & BOOST_SERIALIZATION_NVP(tables);
+    // Older versions stored the hash table as one vector per row; we only
+    // ever load that, and then compact it.
+    std::vector<arma::Col<size_t>> secondHashTable;
+    arma::Col<size_t> bucketContentSize;
+
+    // Backward compatibility: in older versions of LSHSearch, the
+    // secondHashTable was stored as an arma::Mat<size_t>.  So we need to
+    // properly load that, then prune it down to size.
+    if (version == 0)
+    {
+      arma::Mat<size_t> tmpSecondHashTable;
+      ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
 
-    // Set size of second hash table if needed.
-    if (Archive::is_loading::value)
+      // The old secondHashTable was stored in row-major format, so we
+      // transpose it.
+      tmpSecondHashTable = tmpSecondHashTable.t();
+
+      secondHashTable.resize(tmpSecondHashTable.n_cols);
+      for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+      {
+        // Find length of each column.  We know we are at the end of the list
+        // when the value referenceSet.n_cols is seen.
+
+        size_t len = 0;
+        for (; len < tmpSecondHashTable.n_rows; ++len)
+          if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
+            break;
+
+        // Set the size of the new column correctly.
+        secondHashTable[i].set_size(len);
+        for (size_t j = 0; j < len; ++j)
+          secondHashTable[i](j) = tmpSecondHashTable(j, i);
+      }
+    }
+    else
     {
-      secondHashTable.clear();
+      size_t tables;
+      ar & BOOST_SERIALIZATION_NVP(tables);
       secondHashTable.resize(tables);
+      ar & BOOST_SERIALIZATION_NVP(secondHashTable);
     }
 
-    ar & BOOST_SERIALIZATION_NVP(secondHashTable);
-  }
-
-  // Backward compatibility: old versions of LSHSearch held bucketContentSize
-  // for all possible buckets (of size secondHashSize), but now we hold a
-  // compressed representation.
-  if (version == 0)
-  {
-    // The vector was stored in the old uncompressed form.  So we need to shrink
-    // it.  But we can't do that until we have bucketRowInHashTable, so we also
-    // have to load that.
-    arma::Col<size_t> tmpBucketContentSize;
-    ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
-    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    // Backward compatibility: old versions of LSHSearch held bucketContentSize
+    // for all possible buckets (of size secondHashSize), but now we hold a
+    // compressed representation.
+    if (version == 0)
+    {
+      // The vector was stored in the old uncompressed form.  So we need to
+      // shrink it.  But we can't do that until we have bucketRowInHashTable,
+      // so we also have to load that.
+      arma::Col<size_t> tmpBucketContentSize;
+      ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+
+      // Compress into a smaller vector by just dropping all of the zeros.
+      bucketContentSize.zeros(secondHashTable.size());
+      for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
+        if (tmpBucketContentSize[i] > 0)
+          bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    }
+    else
+    {
+      ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    }
 
-    // Compress into a smaller vector by just dropping all of the zeros.
-    bucketContentSize.set_size(secondHashTable.size());
-    for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
-      if (tmpBucketContentSize[i] > 0)
-        bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
-  }
-  else
-  {
-    ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
-    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    CompactBuckets(secondHashTable, bucketContentSize);
   }
 
   ar & BOOST_SERIALIZATION_NVP(distanceEvaluations);
@@ -27,6 +27,12 @@ namespace meanshift /** Mean shift clustering. */ {
  * apply mean shift algorithm until maximum iterations or convergence.  Then
  * remove duplicate centroids.
  *
+ * Each shift only visits the points within the radius of the current centroid,
+ * which are found with a range search on a kd-tree built once on the data, and
+ * the seeds are shifted in parallel when OpenMP is available.  Duplicates are
+ * found by hashing the converged centroids into a grid of cells as wide as the
+ * radius.
+ *
  * A simple example of how to run mean shift clustering is shown below.
  *
  * @code
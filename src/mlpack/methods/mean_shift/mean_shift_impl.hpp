@@ -18,7 +18,10 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 
+#include <mlpack/methods/range_search/range_search_rules.hpp>
+
 #include "map"
+#include <unordered_map>
 
 // In case it hasn't been included yet.
 #include "mean_shift.hpp"
@@ -176,6 +179,124 @@ CalculateCentroid(const MatType& data,
   return true;
 }
 
+// Hash function for the grid cells that converged centroids are merged in.
+class CellHash
+{
+ public:
+  size_t operator()(const std::vector<std::ptrdiff_t>& cell) const
+  {
+    size_t hash = cell.size();
+    for (size_t i = 0; i < cell.size(); ++i)
+    {
+      hash ^= std::hash<std::ptrdiff_t>()(cell[i]) + 0x9e3779b9 +
+          (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+};
+
+/**
+ * A uniform grid with cells of side length radius that holds the centroids
+ * found so far.  Two centroids closer than the radius always lie in cells that
+ * differ by at most one in every dimension, so a duplicate of a new centroid
+ * can only be in one of the (at most 3^d) cells around its own.  If there are
+ * fewer occupied cells than that, the occupied cells are scanned instead.
+ */
+class CentroidGrid
+{
+ public:
+  CentroidGrid(const arma::mat& centroids, const double radius) :
+      centroids(centroids),
+      radius(radius)
+  { /* Nothing to do. */ }
+
+  //! Add the centroid with the given index to the grid.
+  void Insert(const size_t index)
+  {
+    cells[Cell(centroids.unsafe_col(index))].push_back(index);
+  }
+
+  //! Return whether a centroid within the radius of the point is in the grid.
+  bool HasNeighbor(const arma::vec& point) const
+  {
+    const std::vector<std::ptrdiff_t> cell = Cell(point);
+
+    // Find out whether enumerating the adjacent cells is cheaper than scanning
+    // the occupied ones.
+    size_t adjacentCells = 1;
+    for (size_t d = 0; d < cell.size() && adjacentCells <= cells.size(); ++d)
+      adjacentCells *= 3;
+
+    if (adjacentCells > cells.size())
+    {
+      for (CellMap::const_iterator it = cells.begin(); it != cells.end(); ++it)
+      {
+        bool adjacent = true;
+        for (size_t d = 0; d < cell.size() && adjacent; ++d)
+          adjacent = (std::abs(it->first[d] - cell[d]) <= 1);
+
+        if (adjacent && HasNeighbor(point, it->second))
+          return true;
+      }
+      return false;
+    }
+
+    // Walk through all offsets in {-1, 0, 1}^d.
+    std::vector<std::ptrdiff_t> offset(cell.size(), -1);
+    std::vector<std::ptrdiff_t> adjacent(cell.size());
+    while (true)
+    {
+      for (size_t d = 0; d < cell.size(); ++d)
+        adjacent[d] = cell[d] + offset[d];
+
+      CellMap::const_iterator it = cells.find(adjacent);
+      if (it != cells.end() && HasNeighbor(point, it->second))
+        return true;
+
+      size_t d = 0;
+      while (d < offset.size() && offset[d] == 1)
+        offset[d++] = -1;
+      if (d == offset.size())
+        return false;
+      ++offset[d];
+    }
+  }
+
+ private:
+  typedef std::unordered_map<std::vector<std::ptrdiff_t>, std::vector<size_t>,
+      CellHash> CellMap;
+
+  //! Compute the cell that the given point falls in.
+  template<typename VecType>
+  std::vector<std::ptrdiff_t> Cell(const VecType& point) const
+  {
+    std::vector<std::ptrdiff_t> cell(point.n_elem);
+    for (size_t d = 0; d < point.n_elem; ++d)
+      cell[d] = (std::ptrdiff_t) std::floor(point[d] / radius);
+    return cell;
+  }
+
+  //! Return whether any of the given centroids is within the radius.
+  bool HasNeighbor(const arma::vec& point,
+                   const std::vector<size_t>& indices) const
+  {
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      if (metric::EuclideanDistance::Evaluate(point,
+          centroids.unsafe_col(indices[i])) < radius)
+        return true;
+    }
+    return false;
+  }
+
+  //! The centroids that the grid indexes.
+  const arma::mat& centroids;
+  //! The side length of each cell.
+  double radius;
+  //! The indices of the centroids in each occupied cell.
+  CellMap cells;
+};
+
 /**
  * Perform Mean Shift clustering on the data set, returning a list of cluster
  * assignments and centroids.
@@ -204,63 +325,103 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
 
   // Holds all centroids before removing duplicate ones.
   arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  // Whether the shift of each seed converged.  (std::vector<bool> can't be
+  // written concurrently.)
+  std::vector<char> converged(pSeeds->n_cols, 0);
 
   assignments.set_size(data.n_cols);
 
-  range::RangeSearch<> rangeSearcher(data);
-  math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
+  // Build a tree on the data once.  Each shift only needs the points within
+  // the radius of the current centroid, which a single-tree range search finds
+  // without looking at the rest of the data.  The traversal doesn't modify the
+  // tree, so the seeds can be shifted in parallel, each with its own rules.
+  // The tree reorders its copy of the data, but the centroids don't depend on
+  // which points are which, so the indices are never mapped back.
+  typedef range::RangeSearch<>::Tree TreeType;
+  typedef range::RangeSearchRules<metric::EuclideanDistance, TreeType>
+      RuleType;
+  std::vector<size_t> oldFromNew;
+  TreeType tree(data, oldFromNew);
+  const arma::mat& treeData = tree.Dataset();
+  const math::Range validRadius(0, radius);
 
   // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  #pragma omp parallel
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-      || forceConvergence; completedIterations++)
-    {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
-
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() <= 1)
-        break;
+    metric::EuclideanDistance distanceMetric;
+    std::vector<std::vector<size_t> > neighbors(1);
+    std::vector<std::vector<double> > distances(1);
+    arma::mat centroid(pSeeds->n_rows, 1);
 
-      // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
-
-      // If the mean shift vector is small enough, it has converged.
-      if (metric::EuclideanDistance::Evaluate(newCentroid,
-          allCentroids.unsafe_col(i)) < 1e-3 * radius)
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) pSeeds->n_cols; ++i)
+    {
+      // Initial centroid is the seed itself.
+      centroid = pSeeds->col(i);
+      for (size_t completedIterations = 0; completedIterations < maxIterations
+        || forceConvergence; completedIterations++)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
+        // Store new centroid in this.
+        arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+
+        neighbors[0].clear();
+        distances[0].clear();
+        RuleType rules(treeData, centroid, validRadius, neighbors, distances,
+            distanceMetric);
+        typename TreeType::template SingleTreeTraverser<RuleType>
+            traverser(rules);
+        traverser.Traverse(0, tree);
+        if (neighbors[0].size() <= 1)
+          break;
+
+        // Calculate new centroid.
+        if (!CalculateCentroid(treeData, neighbors[0], distances[0],
+            newCentroid))
+          newCentroid = centroid.unsafe_col(0);
+
+        // If the mean shift vector is small enough, it has converged.
+        if (metric::EuclideanDistance::Evaluate(newCentroid,
+            centroid.unsafe_col(0)) < 1e-3 * radius)
         {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
+          converged[i] = 1;
+          break;
         }
 
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
-        break;
+        // Update the centroid.
+        centroid.col(0) = newCentroid;
       }
 
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
+      allCentroids.col(i) = centroid.col(0);
     }
   }
 
+  // Merge the converged centroids in the order of the seeds, so that the
+  // result doesn't depend on the thread schedule.  A centroid is dropped if it
+  // is within the radius of one that was kept.
+  const size_t previousCentroids = centroids.n_cols;
+  arma::mat newCentroids(pSeeds->n_rows, pSeeds->n_cols + previousCentroids);
+  if (previousCentroids > 0)
+    newCentroids.cols(0, previousCentroids - 1) = centroids;
+
+  CentroidGrid grid(newCentroids, radius);
+  size_t keptCentroids = previousCentroids;
+  for (size_t k = 0; k < previousCentroids; ++k)
+    grid.Insert(k);
+
+  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  {
+    if (!converged[i] || grid.HasNeighbor(allCentroids.col(i)))
+      continue;
+
+    newCentroids.col(keptCentroids) = allCentroids.col(i);
+    grid.Insert(keptCentroids++);
+  }
+
+  if (keptCentroids == 0)
+    centroids.reset();
+  else
+    centroids = newCentroids.cols(0, keptCentroids - 1);
+
   // If no centroid has converged due to too little iterations and without
   // forcing convergence, take 1 random centroid calculated.
   if (centroids.empty())
@@ -30,82 +30,212 @@ void MVU::Unfold(const size_t newDim,
                  const size_t numNeighbors,
                  arma::mat& outputData)
 {
-  // First we have to choose the output point.  We'll take a linear projection
-  // of the data for now (this is probably not a good final solution).
-//  outputData = trans(data.rows(0, newDim - 1));
-  // Following Nick's idea.
-  outputData.randu(data.n_cols, newDim);
+  // First we run KNN to get the list of nearest neighbors.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
 
-  // The number of constraints is the number of nearest neighbors plus one.
-  LRSDP<arma::sp_mat> mvuSolver(numNeighbors * data.n_cols + 1, outputData);
+  KNN knn(data);
+  knn.Search(numNeighbors, neighbors, distances);
 
-  // Set up the objective.  Because we are maximizing the trace of (R R^T),
-  // we'll instead state it as min(-I_n * (R R^T)), meaning C() is -I_n.
-  mvuSolver.C().eye(data.n_cols, data.n_cols);
-  mvuSolver.C() *= -1;
+  SolveSDP(data, newDim, neighbors, distances, outputData);
 
-  // Now set up each of the constraints.
-  // The first constraint is trace(ones * R * R^T) = 0.
-  mvuSolver.B()[0] = 0;
-  mvuSolver.A()[0].ones(data.n_cols, data.n_cols);
+  // Revert to original data format.
+  outputData = trans(outputData);
+}
 
-  // All of our other constraints will be sparse except the first.  So set that
-  // vector of modes accordingly.
-  mvuSolver.AModes().ones();
-  mvuSolver.AModes()[0] = 0;
+void MVU::UnfoldLandmarks(const size_t newDim,
+                          const size_t numNeighbors,
+                          const size_t numLandmarks,
+                          arma::mat& outputData)
+{
+  const size_t n = data.n_cols;
+  if (numLandmarks >= n)
+  {
+    Unfold(newDim, numNeighbors, outputData);
+    return;
+  }
 
-  // Now all of the other constraints.  We first have to run KNN to get the
-  // list of nearest neighbors.
+  if (numLandmarks <= numNeighbors || numLandmarks < newDim)
+  {
+    std::ostringstream oss;
+    oss << "MVU::UnfoldLandmarks(): the number of landmarks (" << numLandmarks
+        << ") must be greater than the number of neighbors (" << numNeighbors
+        << ") and at least the new dimensionality (" << newDim << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Choose the landmarks at random.  In the reconstruction matrix, the
+  // landmarks come first, so that the blocks of the linear system are
+  // contiguous.
+  const arma::uvec order = arma::randperm(n);
+  arma::uvec positions(n);
+  positions.elem(order) = arma::regspace<arma::uvec>(0, n - 1);
+  const arma::uvec landmarks = order.head(numLandmarks);
+  const arma::uvec others = order.tail(n - numLandmarks);
+
+  // Solve the semidefinite program over the landmarks only, with the
+  // neighborhood graph of the landmarks.
+  const arma::mat landmarkData = data.cols(landmarks);
   arma::Mat<size_t> neighbors;
   arma::mat distances;
+  arma::mat landmarkCoordinates;
+  {
+    KNN knn(landmarkData);
+    knn.Search(numNeighbors, neighbors, distances);
+    SolveSDP(landmarkData, newDim, neighbors, distances, landmarkCoordinates);
+  }
 
+  // Every other point y_i minimizes the reconstruction error
+  // sum_i || y_i - sum_j W_ij y_j ||^2 with the landmarks fixed, which is the
+  // sparse linear system Phi_uu Y_u = -Phi_ul Y_l.
   KNN knn(data);
   knn.Search(numNeighbors, neighbors, distances);
 
+  arma::sp_mat phi;
+  ReconstructionCost(neighbors, positions, phi);
+
+  const arma::sp_mat phiUU = phi.submat(numLandmarks, numLandmarks, n - 1,
+      n - 1);
+  const arma::mat b = -(phi.submat(numLandmarks, 0, n - 1, numLandmarks - 1) *
+      landmarkCoordinates);
+  arma::mat otherCoordinates;
+  ConjugateGradient(phiUU, b, otherCoordinates);
+
+  outputData.set_size(newDim, n);
+  outputData.cols(landmarks) = trans(landmarkCoordinates);
+  outputData.cols(others) = trans(otherCoordinates);
+  outputData.each_col() -= arma::mean(outputData, 1);
+}
+
+void MVU::SolveSDP(const arma::mat& points,
+                   const size_t newDim,
+                   const arma::Mat<size_t>& neighbors,
+                   const arma::mat& distances,
+                   arma::mat& coordinates)
+{
+  const size_t n = points.n_cols;
+  const size_t numNeighbors = neighbors.n_rows;
+
+  // First we have to choose the output point.  Following Nick's idea, it is
+  // random.
+  coordinates.randu(n, newDim);
+
+  // There is one constraint for each nearest neighbor, plus the centering
+  // constraint.
+  LRSDP<SDP<arma::sp_mat>> mvuSolver(numNeighbors * n, 1, coordinates);
+
+  // Set up the objective.  Because we are maximizing the trace of (R R^T),
+  // we'll instead state it as min(-I_n * (R R^T)), meaning C() is -I_n.
+  mvuSolver.SDP().C().eye(n, n);
+  mvuSolver.SDP().C() *= -1;
+
+  // The only dense constraint is trace(ones * R * R^T) = 0.
+  mvuSolver.SDP().DenseB()[0] = 0;
+  mvuSolver.SDP().DenseA()[0].ones(n, n);
+
   // Add each of the other constraints.  They are sparse constraints:
-  //   Tr(A_ij K) = d_ij;
+  //   Tr(A_ij K) = d_ij^2;
   //   A_ij = zeros except for 1 at (i, i), (j, j); -1 at (i, j), (j, i).
-  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  // The solver evaluates them from their nonzeros only.
+  for (size_t i = 0; i < n; ++i)
   {
     for (size_t j = 0; j < numNeighbors; ++j)
     {
       // This is the index of the constraint.
-      const size_t index = (i * numNeighbors) + j + 1;
-
-      arma::mat& aRef = mvuSolver.A()[index];
+      const size_t index = (i * numNeighbors) + j;
+      const size_t neighbor = neighbors(j, i);
 
-      aRef.set_size(3, 4);
+      arma::sp_mat& aRef = mvuSolver.SDP().SparseA()[index];
+      aRef(i, i) = 1;
+      aRef(i, neighbor) = -1;
+      aRef(neighbor, i) = -1;
+      aRef(neighbor, neighbor) = 1;
 
-      // A_ij(i, i) = 1.
-      aRef(0, 0) = i;
-      aRef(1, 0) = i;
-      aRef(2, 0) = 1;
+      // The constraint b_ij is the squared distance between these two points.
+      mvuSolver.SDP().SparseB()[index] = distances(j, i) * distances(j, i);
+    }
+  }
 
-      // A_ij(i, j) = -1.
-      aRef(0, 1) = i;
-      aRef(1, 1) = neighbors(j, i);
-      aRef(2, 1) = -1;
+  // Now on with the solving.
+  double objective = mvuSolver.Optimize(coordinates);
 
-      // A_ij(j, i) = -1.
-      aRef(0, 2) = neighbors(j, i);
-      aRef(1, 2) = i;
-      aRef(2, 2) = -1;
+  Log::Info << "Final objective is " << objective << "." << std::endl;
+}
 
-      // A_ij(j, j) = 1.
-      aRef(0, 3) = neighbors(j, i);
-      aRef(1, 3) = neighbors(j, i);
-      aRef(2, 3) = 1;
+void MVU::ReconstructionCost(const arma::Mat<size_t>& neighbors,
+                             const arma::uvec& positions,
+                             arma::sp_mat& phi) const
+{
+  const size_t n = data.n_cols;
+  const size_t k = neighbors.n_rows;
 
-      // The constraint b_ij is the distance between these two points.
-      mvuSolver.B()[index] = distances(j, i);
+  // The weights of each point sum to one and minimize its reconstruction
+  // error from its neighbors, as in LLE.  Each point is independent.
+  arma::mat weights(k, n);
+  Threads::ParallelFor(0, n, [&](const size_t i)
+  {
+    arma::mat z = data.cols(arma::conv_to<arma::uvec>::from(
+        neighbors.col(i)));
+    z.each_col() -= data.col(i);
+    arma::mat gram = trans(z) * z;
+
+    // Regularize the local Gram matrix, which is singular if k > d.
+    const double trace = arma::trace(gram);
+    gram.diag() += 1e-3 * (trace > 0.0 ? trace : 1.0);
+
+    arma::vec w = arma::solve(gram, arma::ones<arma::vec>(k));
+    weights.col(i) = w / arma::accu(w);
+  });
+
+  // Assemble I - W in the order given by the positions.
+  arma::umat locations(2, n * (k + 1));
+  arma::vec values(n * (k + 1));
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t offset = i * (k + 1);
+    locations(0, offset) = positions[i];
+    locations(1, offset) = positions[i];
+    values[offset] = 1.0;
+    for (size_t j = 0; j < k; ++j)
+    {
+      locations(0, offset + j + 1) = positions[i];
+      locations(1, offset + j + 1) = positions[neighbors(j, i)];
+      values[offset + j + 1] = -weights(j, i);
     }
   }
 
-  // Now on with the solving.
-  double objective = mvuSolver.Optimize(outputData);
+  const arma::sp_mat iw(true, locations, values, n, n);
+  phi = trans(iw) * iw;
+}
 
-  Log::Info << "Final objective is " << objective << "." << std::endl;
+void MVU::ConjugateGradient(const arma::sp_mat& a,
+                            const arma::mat& b,
+                            arma::mat& x)
+{
+  x.zeros(b.n_rows, b.n_cols);
 
-  // Revert to original data format.
-  outputData = trans(outputData);
+  // Each right-hand side is an independent system.
+  Threads::ParallelFor(0, b.n_cols, [&](const size_t c)
+  {
+    arma::vec xc(b.n_rows, arma::fill::zeros);
+    arma::vec r = b.col(c);
+    arma::vec p = r;
+    double rr = arma::dot(r, r);
+    const double threshold = 1e-20 * rr;
+
+    for (size_t iteration = 0; iteration < a.n_rows && rr > threshold;
+        ++iteration)
+    {
+      const arma::vec ap = a * p;
+      const double alpha = rr / arma::dot(p, ap);
+      xc += alpha * p;
+      r -= alpha * ap;
+
+      const double rrNew = arma::dot(r, r);
+      p = r + (rrNew / rr) * p;
+      rr = rrNew;
+    }
+
+    x.col(c) = xc;
+  });
 }
@@ -28,6 +28,27 @@ namespace mvu {
  *
  * - dataset
  * - new dimensionality
+ *
+ * Unfold() solves the semidefinite program over all n points, which needs
+ * O(n^2) memory for the kernel matrix.  UnfoldLandmarks() implements landmark
+ * MVU: the semidefinite program is solved only over m landmarks, and every
+ * other point is placed at the linear combination of its neighbors that best
+ * reconstructs it in the input space (as in LLE), which is a sparse linear
+ * system.  This needs only O(m^2 + nk) memory.
+ *
+ * For more details on landmark MVU, see the following paper:
+ *
+ * @code
+ * @inproceedings{weinberger2005nonlinear,
+ *   title = {Nonlinear Dimensionality Reduction by Semidefinite Programming
+ *       and Kernel Matrix Factorization},
+ *   author = {Weinberger, K.Q. and Packer, B.D. and Saul, L.K.},
+ *   booktitle = {Proceedings of the Tenth International Workshop on
+ *       Artificial Intelligence and Statistics (AISTATS 2005)},
+ *   pages = {381--388},
+ *   year = {2005}
+ * }
+ * @endcode
  */
 class MVU
 {
@@ -38,8 +59,64 @@ class MVU
               const size_t numNeighbors,
               arma::mat& outputCoordinates);
 
+  /**
+   * Unfold the dataset with landmark MVU.  The landmarks are chosen uniformly
+   * at random.
+   *
+   * @param newDim New dimensionality of the dataset.
+   * @param numNeighbors Number of nearest neighbors of each point.
+   * @param numLandmarks Number of landmarks to solve the semidefinite program
+   *     over.
+   * @param outputCoordinates Matrix to store the unfolded dataset in (one
+   *     point per column).
+   */
+  void UnfoldLandmarks(const size_t newDim,
+                       const size_t numNeighbors,
+                       const size_t numLandmarks,
+                       arma::mat& outputCoordinates);
+
  private:
   const arma::mat& data;
+
+  /**
+   * Solve the MVU semidefinite program for the given points and neighbor
+   * graph, and return the coordinates (one point per row).
+   *
+   * @param points Points to unfold.
+   * @param newDim New dimensionality of the points.
+   * @param neighbors Nearest neighbors of each point.
+   * @param distances Distances to the nearest neighbors of each point.
+   * @param coordinates Matrix to store the coordinates in.
+   */
+  static void SolveSDP(const arma::mat& points,
+                       const size_t newDim,
+                       const arma::Mat<size_t>& neighbors,
+                       const arma::mat& distances,
+                       arma::mat& coordinates);
+
+  /**
+   * Compute the weights that reconstruct each point from its neighbors, and
+   * return the sparse matrix Phi = (I - W)^T (I - W).
+   *
+   * @param neighbors Nearest neighbors of each point.
+   * @param positions Row (and column) of each point in Phi.
+   * @param phi Matrix to store Phi in.
+   */
+  void ReconstructionCost(const arma::Mat<size_t>& neighbors,
+                          const arma::uvec& positions,
+                          arma::sp_mat& phi) const;
+
+  /**
+   * Solve A x = b with conjugate gradients, for the sparse symmetric positive
+   * definite matrix A.  Each column of b is solved in parallel.
+   *
+   * @param a Sparse symmetric positive definite matrix.
+   * @param b Right-hand sides.
+   * @param x Matrix to store the solutions in.
+   */
+  static void ConjugateGradient(const arma::sp_mat& a,
+                                const arma::mat& b,
+                                arma::mat& x);
 };
 
 } // namespace mvu
@@ -19,7 +19,12 @@ PROGRAM_INFO("Maximum Variance Unfolding (MVU)", "This program implements "
     "Maximum Variance Unfolding, a nonlinear dimensionality reduction "
     "technique.  The method minimizes dimensionality by unfolding a manifold "
     "such that the distances to the nearest neighbors of each point are held "
-    "constant.");
+    "constant."
+    "\n\n"
+    "If --num_landmarks is specified, landmark MVU is used: the problem is "
+    "only solved over that many randomly chosen landmarks, and the other "
+    "points are reconstructed from their nearest neighbors.  This is much "
+    "faster and uses much less memory for large datasets.");
 
 PARAM_MATRIX_IN_REQ("input", "Input dataset.", "i");
 PARAM_INT_IN_REQ("new_dim", "New dimensionality of dataset.", "d");
@@ -27,6 +32,8 @@ PARAM_INT_IN_REQ("new_dim", "New dimensionality of dataset.", "d");
 PARAM_MATRIX_OUT("output", "Matrix to save unfolded dataset to.", "o");
 PARAM_INT_IN("num_neighbors", "Number of nearest neighbors to consider while "
     "unfolding.", "k", 5);
+PARAM_INT_IN("num_landmarks", "Number of landmarks to use for landmark MVU (0 "
+    "to solve the problem over all points).", "l", 0);
 
 using namespace mlpack;
 using namespace mlpack::mvu;
@@ -43,6 +50,7 @@ int main(int argc, char **argv)
   const string outputFile = CLI::GetParam<string>("output_file");
   const int newDim = CLI::GetParam<int>("new_dim");
   const int numNeighbors = CLI::GetParam<int>("num_neighbors");
+  const int numLandmarks = CLI::GetParam<int>("num_landmarks");
 
   if (!CLI::HasParam("output"))
   {
@@ -71,11 +79,21 @@ int main(int argc, char **argv)
         << data.n_cols << ")." << std::endl;
   }
 
+  // Verify that the number of landmarks is valid.
+  if (numLandmarks < 0)
+  {
+    Log::Fatal << "Invalid number of landmarks (" << numLandmarks << ").  Must "
+        << "be 0 or greater." << std::endl;
+  }
+
   // Now run MVU.
   MVU mvu(data);
 
   mat output;
-  mvu.Unfold(newDim, numNeighbors, output);
+  if (numLandmarks > 0)
+    mvu.UnfoldLandmarks(newDim, numNeighbors, numLandmarks, output);
+  else
+    mvu.Unfold(newDim, numNeighbors, output);
 
   // Save results to file.
   if (CLI::HasParam("output"))
@@ -105,6 +105,10 @@ class NaiveBayesClassifier
    * classes, either re-initialize or call Means(), Variances(), and
    * Probabilities() individually to set them to the right size.
    *
+   * The statistics of the dataset are accumulated in parallel, and with the
+   * incremental algorithm they are then merged into the model, so this can be
+   * used to train on a stream of mini-batches.
+   *
    * @param data The dataset to train on.
    * @param labels The labels for the dataset.
    * @param numClasses The numbe of classes in the dataset.
@@ -225,6 +229,27 @@ class NaiveBayesClassifier
   //! Number of training points seen so far.
   size_t trainingPoints;
 
+  /**
+   * Compute the number of points of each class in the given dataset, and the
+   * sample mean and sum of squared differences from the mean of each feature
+   * for each class.
+   *
+   * @param data Dataset to compute statistics of.
+   * @param labels Labels of the dataset.
+   * @param numClasses Number of classes.
+   * @param counts Column vector to store the number of points of each class in.
+   * @param batchMeans Matrix to store the means of each class in.
+   * @param squaredDiffs Matrix to store the sums of squared differences from
+   *     the means of each class in.
+   */
+  template<typename MatType>
+  void BatchStatistics(const MatType& data,
+                       const arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       ModelMatType& counts,
+                       ModelMatType& batchMeans,
+                       ModelMatType& squaredDiffs) const;
+
   /**
    * Compute the unnormalized posterior log probability of given points (log
    * likelihood). Results are returned as arma::mat, and each column represents
@@ -101,67 +101,59 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     }
   }
 
-  // Calculate the class probabilities as well as the sample mean and variance
-  // for each of the features with respect to each of the labels.
+  // Calculate the class counts as well as the sample mean and the sum of
+  // squared differences from it for each of the features with respect to each
+  // of the labels, for this batch only.
+  ModelMatType counts, batchMeans, squaredDiffs;
+  BatchStatistics(data, labels, numClasses, counts, batchMeans, squaredDiffs);
+
   if (incremental)
   {
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
+    // Use incremental algorithm: merge the statistics of the batch into the
+    // model (Chan, Golub, and LeVeque, 1979).  First, de-normalize
+    // probabilities.
     probabilities *= trainingPoints;
 
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
-    }
-
     for (size_t i = 0; i < probabilities.n_elem; ++i)
     {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
+      if (counts[i] == 0)
+        continue;
+
+      const ElemType oldCount = std::round(probabilities[i]);
+      const ElemType newCount = oldCount + counts[i];
+      const arma::Col<ElemType> delta = batchMeans.col(i) - means.col(i);
+
+      means.col(i) += delta * (counts[i] / newCount);
+      if (oldCount > 1)
+        variances.col(i) *= (oldCount - 1);
+      else
+        variances.col(i).zeros();
+      variances.col(i) += squaredDiffs.col(i) +
+          arma::square(delta) * (oldCount * counts[i] / newCount);
+      if (newCount > 1)
+        variances.col(i) /= (newCount - 1);
+
+      probabilities[i] = newCount;
     }
+
+    trainingPoints += data.n_cols;
   }
   else
   {
-    // Set all parameters to zero.
-    probabilities.zeros();
-    means.zeros();
-    variances.zeros();
-
-    // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
-    // possible to calculate the means and variances using a faster one-pass
-    // algorithm but there are some precision and stability issues.  If this is
-    // too slow, it's an option to use the faster algorithm by default and then
-    // have this (and the incremental algorithm) be other options.
-
-    // Calculate the means.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
-    }
-
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
-
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
-    }
+    // Don't use incremental algorithm; the current model is replaced by the
+    // statistics of the batch.  These are computed with a two-pass algorithm.
+    // It is possible to calculate the means and variances using a faster
+    // one-pass algorithm but there are some precision and stability issues.
+    probabilities = counts;
+    means = batchMeans;
+    variances = squaredDiffs;
 
     // Normalize variances.
     for (size_t i = 0; i < probabilities.n_elem; ++i)
       if (probabilities[i] > 1)
         variances.col(i) /= (probabilities[i] - 1);
+
+    trainingPoints = data.n_cols;
   }
 
   // Ensure that the variances are invertible.
@@ -169,8 +161,7 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     if (variances[i] == 0.0)
       variances[i] = 1e-50;
 
-  probabilities /= data.n_cols;
-  trainingPoints += data.n_cols;
+  probabilities /= trainingPoints;
 }
 
 template<typename ModelMatType>
@@ -198,6 +189,65 @@ void NaiveBayesClassifier<ModelMatType>::Train(const VecType& point,
   probabilities /= trainingPoints;
 }
 
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::BatchStatistics(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    ModelMatType& counts,
+    ModelMatType& batchMeans,
+    ModelMatType& squaredDiffs) const
+{
+  counts.zeros(numClasses, 1);
+  batchMeans.zeros(data.n_rows, numClasses);
+  squaredDiffs.zeros(data.n_rows, numClasses);
+
+  // Calculate the counts and sums of each class.  Each thread accumulates the
+  // statistics of its own points, and these are merged at the end.
+  #pragma omp parallel
+  {
+    ModelMatType threadCounts(numClasses, 1, arma::fill::zeros);
+    ModelMatType threadSums(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      ++threadCounts[label];
+      threadSums.col(label) += data.col(j);
+    }
+
+    #pragma omp critical
+    {
+      counts += threadCounts;
+      batchMeans += threadSums;
+    }
+  }
+
+  // Normalize means.
+  for (size_t i = 0; i < numClasses; ++i)
+    if (counts[i] != 0.0)
+      batchMeans.col(i) /= counts[i];
+
+  // Calculate the sums of squared differences from the means in the same way.
+  #pragma omp parallel
+  {
+    ModelMatType threadDiffs(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      threadDiffs.col(label) += arma::square(data.col(j) -
+          batchMeans.col(label));
+    }
+
+    #pragma omp critical
+    squaredDiffs += threadDiffs;
+  }
+}
+
 template<typename ModelMatType>
 template<typename MatType>
 void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
@@ -208,23 +258,33 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
-
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
+  // This is an adaptation of gmm::phi() for the case where the covariance is a
+  // diagonal matrix.  The terms that don't depend on the point are the same for
+  // every point of a class.
+  const ModelMatType invVar = 1.0 / variances;
+  const ModelMatType constants = arma::log(probabilities) -
+      (data.n_rows / 2.0 * std::log(2 * M_PI)) -
+      0.5 * arma::sum(arma::log(variances), 0).t();
+
+  // Evaluate blocks of points in parallel, so that each block stays in cache
+  // while it is compared with every class.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  logLikelihoods.set_size(means.n_cols, data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    ModelMatType diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = arma::sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        std::log(arma::det(arma::diagmat(variances.col(i)))) + exponents);
+    const size_t begin = b * blockSize;
+    const size_t end = std::min((size_t) data.n_cols, begin + blockSize) - 1;
+    const ModelMatType block = data.cols(begin, end);
+
+    for (size_t i = 0; i < means.n_cols; ++i)
+    {
+      const ModelMatType diffs = block.each_col() - means.col(i);
+      logLikelihoods.submat(i, begin, i, end) = constants[i] - 0.5 *
+          (invVar.col(i).t() * arma::square(diffs));
+    }
   }
 }
 
@@ -290,7 +350,8 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
   ModelMatType logLikelihoods;
   LogLikelihood(data, logLikelihoods);
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
     arma::uword maxIndex = 0;
     logLikelihoods.unsafe_col(i).max(maxIndex);
@@ -318,23 +379,21 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
   ModelMatType logLikelihoods;
   LogLikelihood(data, logLikelihoods);
 
-  // This will hold log(Prob(X)) for each point.
-  arma::Col<ElemType> logProbX(data.n_cols);
-  for (size_t j = 0; j < data.n_cols; ++j)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
   {
-    logProbX(j) = log(arma::accu(exp(logLikelihoods.col(j))));
-    logLikelihoods.col(j) -= logProbX(j);
+    // Subtract log(Prob(X)) from each point, and find the maximum probability.
+    arma::uword maxIndex = 0;
+    const ElemType maxLogLikelihood =
+        logLikelihoods.unsafe_col(j).max(maxIndex);
+    predictions[j] = maxIndex;
+
+    const ElemType logProbX = maxLogLikelihood + std::log(arma::accu(
+        arma::exp(logLikelihoods.col(j) - maxLogLikelihood)));
+    logLikelihoods.col(j) -= logProbX;
   }
 
   predictionProbs = arma::exp(logLikelihoods);
-
-  // Now calculate maximum probabilities for each point.
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    arma::uword maxIndex = 0;
-    logLikelihoods.unsafe_col(i).max(maxIndex);
-    predictions[i] = maxIndex;
-  }
 }
 
 template<typename ModelMatType>
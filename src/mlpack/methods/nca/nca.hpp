@@ -86,6 +86,12 @@ class NCA
   const OptimizerType& Optimizer() const { return optimizer; }
   OptimizerType& Optimizer() { return optimizer; }
 
+  //! Get the error function.
+  const SoftmaxErrorFunction<MetricType>& ErrorFunction() const
+  { return errorFunction; }
+  //! Modify the error function (e.g. to only consider nearest neighbors).
+  SoftmaxErrorFunction<MetricType>& ErrorFunction() { return errorFunction; }
+
  private:
   //! Dataset reference.
   const arma::mat& dataset;
@@ -82,10 +82,18 @@ PROGRAM_INFO("Neighborhood Components Analysis (NCA)",
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
     "literature on L-BFGS."
     "\n\n"
-    "By default, the SGD optimizer is used.");
+    "By default, the SGD optimizer is used."
+    "\n\n"
+    "The learned distance matrix can be saved with " +
+    PRINT_PARAM_STRING("output") + ", and the dataset transformed by it with " +
+    PRINT_PARAM_STRING("transformed_data") + "; the Euclidean distance between "
+    "transformed points is the learned distance, so the transformed data can "
+    "be searched directly (e.g. with the knn program).");
 
 PARAM_MATRIX_IN_REQ("input", "Input dataset to run NCA on.", "i");
 PARAM_MATRIX_OUT("output", "Output matrix for learned distance matrix.", "o");
+PARAM_MATRIX_OUT("transformed_data", "Output matrix for the dataset "
+    "transformed by the learned distance matrix.", "D");
 PARAM_UROW_IN("labels", "Labels for input dataset.", "l");
 PARAM_STRING_IN("optimizer", "Optimizer to use; 'sgd' or 'lbfgs'.", "O", "sgd");
 
@@ -131,7 +139,8 @@ static void mlpackMain()
   else
     math::RandomSeed((size_t) std::time(NULL));
 
-  RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
+  RequireAtLeastOnePassed({ "output", "transformed_data" }, false,
+      "no output will be saved");
 
   const string optimizerType = CLI::GetParam<string>("optimizer");
   RequireParamInSet<string>("optimizer", { "sgd", "lbfgs" },
@@ -245,7 +254,10 @@ static void mlpackMain()
     nca.LearnDistance(distance);
   }
 
-  // Save the output.
+  // Save the output.  The transformed dataset can be searched with the
+  // Euclidean distance and the usual trees to use the learned distance.
+  if (CLI::HasParam("transformed_data"))
+    CLI::GetParam<arma::mat>("transformed_data") = distance * data;
   if (CLI::HasParam("output"))
     CLI::GetParam<arma::mat>("output") = std::move(distance);
 }
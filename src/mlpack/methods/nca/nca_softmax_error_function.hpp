@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 namespace mlpack {
 namespace nca {
@@ -38,6 +39,17 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * Computing p_i exactly takes O(n) time for every point, since every other
+ * point is considered.  If NumNeighbors() is set to some k > 0, only the k
+ * nearest neighbors of each point in the stretched space A x are considered
+ * (the other terms of the sums are tiny for all but the closest points).  The
+ * neighbors are found with a tree (with the Euclidean distance) and are
+ * refreshed after every RefreshInterval() passes over the dataset, so between
+ * refreshes each p_i takes O(k) time.
+ *
+ * The points are handled in parallel (see Threads), so the metric must be
+ * usable from several threads at once.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -129,6 +141,16 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of neighbors considered for each point (0 means all).
+  size_t NumNeighbors() const { return numNeighbors; }
+  //! Modify the number of neighbors considered for each point (0 means all).
+  size_t& NumNeighbors() { return numNeighbors; }
+
+  //! Get the number of passes over the dataset between neighbor refreshes.
+  size_t RefreshInterval() const { return refreshInterval; }
+  //! Modify the number of passes over the dataset between neighbor refreshes.
+  size_t& RefreshInterval() { return refreshInterval; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -145,27 +167,67 @@ class SoftmaxErrorFunction
   arma::mat stretchedDataset;
   //! Holds calculated p_i, for the non-separable Evaluate() and Gradient().
   arma::vec p;
-  //! Holds denominators for calculation of p_ij, for the non-separable
-  //! Evaluate() and Gradient().
-  arma::vec denominators;
 
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
 
+  //! The number of neighbors considered for each point (0 means all).
+  size_t numNeighbors;
+  //! The number of passes over the dataset between neighbor refreshes.
+  size_t refreshInterval;
+  //! The nearest neighbors of each point in the stretched space, if
+  //! numNeighbors is not 0.
+  arma::Mat<size_t> neighbors;
+  //! The number of points evaluated since the neighbors were last found.
+  size_t pointsSinceRefresh;
+
   /**
    * Precalculate the denominators and numerators that will make up the p_ij,
    * but only if the coordinates matrix is different than the last coordinates
    * the Precalculate() method was run with.  This method is only called by the
    * non-separable Evaluate() and Gradient().
    *
-   * This will update last_coordinates_ and stretched_dataset_, and also
-   * calculate the p_i and denominators_ which are used in the calculation of
-   * p_i or p_ij.  The calculation will be O((n * (n + 1)) / 2), which is not
-   * great.
+   * This will update lastCoordinates and stretchedDataset, and also calculate
+   * the p_i.  The calculation is O(n^2) (or O(n k) if NumNeighbors() is set).
    *
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const arma::mat& coordinates);
+
+  /**
+   * Find the nearest neighbors of each point in stretchedDataset if they have
+   * never been found or if RefreshInterval() passes over the dataset have been
+   * made since they were last found.  Nothing is done if NumNeighbors() is 0.
+   *
+   * @param numPoints Number of points about to be evaluated.
+   */
+  void UpdateNeighbors(const size_t numPoints);
+
+  /**
+   * Compute p_i for the points begin, ..., begin + count - 1 of
+   * stretchedDataset, in parallel.  If sum is not NULL, the term
+   *
+   *   sum_k p_ik (p_i - [k in class of i]) x_ik x_ik^T
+   *
+   * of the gradient of each point is added to it.
+   *
+   * @param begin Index of the first point.
+   * @param count Number of points.
+   * @param sum Matrix to add the gradient terms to (or NULL).
+   * @param pOut Vector to store each p_i in (or NULL).
+   * @return The sum of p_i over the points.
+   */
+  double SumTerms(const size_t begin,
+                  const size_t count,
+                  arma::mat* sum,
+                  arma::vec* pOut);
+
+  /**
+   * Compute p_i for one point of stretchedDataset, and add its gradient term
+   * to sum if sum is not NULL.  The denominator of p_i is stored in
+   * denominator; if it is 0, p_i is 0 and nothing is added to sum.
+   */
+  double PointTerms(const size_t i, arma::mat* sum, double& denominator);
 };
 
 } // namespace nca
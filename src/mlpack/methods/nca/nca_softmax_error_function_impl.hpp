@@ -27,7 +27,10 @@ SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
-    precalculated(false)
+    precalculated(false),
+    numNeighbors(0),
+    refreshInterval(1),
+    pointsSinceRefresh(0)
 { /* nothing to do */ }
 
 //! Shuffle the dataset.
@@ -44,6 +47,10 @@ void SoftmaxErrorFunction<MetricType>::Shuffle()
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // The neighbors refer to the old order of the points.
+  neighbors.reset();
+  precalculated = false;
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
@@ -64,45 +71,13 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                                   const size_t begin,
                                                   const size_t batchSize)
 {
-  // Unfortunately each evaluation will take O(N) time because it requires a
-  // scan over all points in the dataset.  Our objective is to compute p_i.
-  double denominator = 0;
-  double numerator = 0;
-  double result = 0;
-
   // It's quicker to do this now than one point at a time later.
   stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; i++)
-  {
-    for (size_t k = 0; k < dataset.n_cols; ++k)
-    {
-      // Don't consider the case where the points are the same.
-      if (k == i)
-        continue;
-
-      // We want to evaluate exp(-D(A x_i, A x_k)).
-      double eval = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                              stretchedDataset.unsafe_col(k)));
-
-      // If they are in the same class, update the numerator.
-      if (labels[i] == labels[k])
-        numerator += eval;
-
-      denominator += eval;
-    }
+  precalculated = false;
+  UpdateNeighbors(0);
 
-    // Now the result is just a simple division, but we have to be sure that the
-    // denominator is not 0.
-    if (denominator == 0.0)
-    {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
-      continue;
-    }
-
-    result += -(numerator / denominator); // Negate because the optimizer is a
-                                          // minimizer.
-  }
-  return result;
+  // Negate because the optimizer is a minimizer.
+  return -SumTerms(begin, batchSize, NULL, NULL);
 }
 
 //! The non-separable implementation, where Precalculate() is used.
@@ -116,38 +91,10 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   // Now, we handle the summation over i:
   //   sum_i (p_i sum_k (p_ik x_ik x_ik^T) -
   //       sum_{j in class of i} (p_ij x_ij x_ij^T)
-  // We can algebraically manipulate the whole thing to produce a more
-  // memory-friendly way to calculate this.  Looping over each i and k (again
-  // O((n * (n + 1)) / 2) as with the last step, we can add the following to the
-  // sum:
-  //
-  //   if class of i is the same as the class of k, add
-  //     (((p_i - (1 / p_i)) p_ik) + ((p_k - (1 / p_k)) p_ki)) x_ik x_ik^T
-  //   otherwise, add
-  //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
+  // which, for each i, is sum_k p_ik (p_i - [k in class of i]) x_ik x_ik^T.
   arma::mat sum;
-  sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
-  {
-    for (size_t k = (i + 1); k < stretchedDataset.n_cols; k++)
-    {
-      // Calculate p_ik and p_ki first.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-      double p_ik = 0, p_ki = 0;
-      p_ik = eval / denominators(i);
-      p_ki = eval / denominators(k);
-
-      // Subtract x_i from x_k.  We are not using stretched points here.
-      arma::vec x_ik = dataset.col(i) - dataset.col(k);
-      arma::mat secondTerm = (x_ik * trans(x_ik));
-
-      if (labels[i] == labels[k])
-        sum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
-      else
-        sum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
-    }
-  }
+  sum.zeros(dataset.n_rows, dataset.n_rows);
+  SumTerms(0, dataset.n_cols, &sum, NULL);
 
   // Assemble the final gradient.
   gradient = -2 * coordinates * sum;
@@ -161,72 +108,19 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 GradType& gradient,
                                                 const size_t batchSize)
 {
-  // The gradient involves two matrix terms which are eventually combined into
-  // one.
-  GradType firstTerm, secondTerm;
-  // We will need to calculate p_i before this evaluation is done, so
-  // these two variables will hold the information necessary for that.
-  double numerator, denominator;
-
-  gradient.zeros(coordinates.n_rows, coordinates.n_rows);
-
   // Compute the stretched dataset.
   stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; i++)
-  {
-    numerator = 0;
-    denominator = 0;
-
-    firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
-    secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
+  precalculated = false;
+  UpdateNeighbors(batchSize);
 
-    for (size_t k = 0; k < dataset.n_cols; ++k)
-    {
-      // Don't consider the case where the points are the same.
-      if (i == k)
-        continue;
-
-      // Calculate the numerator of p_ik.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-
-      // If the points are in the same class, we must add to the second term of
-      // the gradient as well as the numerator of p_i.  We will divide by the
-      // denominator of p_ik later.  For x_ik we are not using stretched points.
-      GradType x_ik = dataset.col(i) - dataset.col(k);
-      if (labels[i] == labels[k])
-      {
-        numerator += eval;
-        secondTerm += eval * x_ik * trans(x_ik);
-      }
-
-      // We always have to add to the denominator of p_i
-      // and the first term of the gradient computation.
-      // We will divide by the denominator of p_ik later.
-      denominator += eval;
-      firstTerm += eval * x_ik * trans(x_ik);
-    }
-
-    // Calculate p_i.
-    double p = 0;
-    if (denominator == 0)
-    {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
-      // If the denominator is zero, then all p_ik should be zero and there is
-      // no gradient contribution from this point.
-      continue;
-    }
-    else
-    {
-      p = numerator / denominator;
-      firstTerm /= denominator;
-      secondTerm /= denominator;
-    }
+  arma::mat sum;
+  sum.zeros(dataset.n_rows, dataset.n_rows);
+  SumTerms(begin, batchSize, &sum, NULL);
 
-    // Now multiply the first term by p_i, and add the two together and multiply
-    // all by 2 * A.  We negate it though, because our optimizer is a minimizer.
-    gradient += -2 * coordinates * (p * firstTerm - secondTerm);
-  }
+  // Multiply all by 2 * A.  We negate it though, because our optimizer is a
+  // minimizer.
+  const arma::mat denseGradient = -2 * coordinates * sum;
+  gradient = GradType(denseGradient);
 }
 
 template<typename MetricType>
@@ -254,54 +148,142 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   // Coordinates are different; save the new ones, and stretch the dataset.
   lastCoordinates = coordinates;
   stretchedDataset = coordinates * dataset;
+  UpdateNeighbors(dataset.n_cols);
 
   // For each point i, we must evaluate the softmax function:
   //   p_ij = exp( -K(x_i, x_j) ) / ( sum_{k != i} ( exp( -K(x_i, x_k) )))
   //   p_i = sum_{j in class of i} p_ij
-  // We will do this by keeping track of the denominators for each i as well as
-  // the numerators (the sum for all j in class of i).  This will be on the
-  // order of O((n * (n + 1)) / 2), which really isn't all that great.
-  p.zeros(stretchedDataset.n_cols);
-  denominators.zeros(stretchedDataset.n_cols);
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+  p.set_size(stretchedDataset.n_cols);
+  SumTerms(0, stretchedDataset.n_cols, NULL, &p);
+
+  // We've done a precalculation.  Mark it as done.
+  precalculated = true;
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::UpdateNeighbors(const size_t numPoints)
+{
+  if (numNeighbors == 0)
+    return;
+
+  pointsSinceRefresh += numPoints;
+  const size_t k = std::min(numNeighbors, (size_t) dataset.n_cols - 1);
+  if (neighbors.n_rows == k && neighbors.n_cols == dataset.n_cols &&
+      pointsSinceRefresh < refreshInterval * dataset.n_cols)
+    return;
+
+  Log::Debug << "Finding " << k << " nearest neighbors of each point in the "
+      << "stretched space." << std::endl;
+  arma::mat distances;
+  neighbor::KNN knn(stretchedDataset);
+  knn.Search(k, neighbors, distances);
+  pointsSinceRefresh = 0;
+}
+
+template<typename MetricType>
+double SoftmaxErrorFunction<MetricType>::SumTerms(const size_t begin,
+                                                  const size_t count,
+                                                  arma::mat* sum,
+                                                  arma::vec* pOut)
+{
+  // Each range of points is handled by one task, with its own sum.
+  const size_t numRanges = std::max((size_t) 1,
+      std::min(Threads::Count(), count));
+  std::vector<arma::mat> rangeSums(numRanges);
+  arma::vec rangeResults(numRanges, arma::fill::zeros);
+  arma::Col<size_t> rangeZeros(numRanges, arma::fill::zeros);
+  Threads::ParallelFor(0, numRanges, [&](const size_t range)
   {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; j++)
+    if (sum)
+      rangeSums[range].zeros(sum->n_rows, sum->n_cols);
+
+    const size_t rangeBegin = begin + range * count / numRanges;
+    const size_t rangeEnd = begin + (range + 1) * count / numRanges;
+    for (size_t i = rangeBegin; i < rangeEnd; ++i)
     {
-      // Evaluate exp(-d(x_i, x_j)).
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(j)));
-
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
-      denominators[i] += eval;
-      denominators[j] += eval;
-
-      // If i and j are the same class, add to numerator of both.
-      if (labels[i] == labels[j])
-      {
-        p[i] += eval;
-        p[j] += eval;
-      }
+      double denominator;
+      const double pi = PointTerms(i, sum ? &rangeSums[range] : NULL,
+          denominator);
+      if (denominator == 0.0)
+        ++rangeZeros[range];
+
+      if (pOut)
+        (*pOut)[i] = pi;
+      rangeResults[range] += pi;
     }
+  });
+
+  if (sum)
+  {
+    for (size_t range = 0; range < numRanges; ++range)
+      *sum += rangeSums[range];
+  }
+
+  if (arma::accu(rangeZeros) > 0)
+  {
+    Log::Debug << "Denominator of p_i is 0 for " << arma::accu(rangeZeros)
+        << " points." << std::endl;
+  }
+
+  return arma::accu(rangeResults);
+}
+
+template<typename MetricType>
+double SoftmaxErrorFunction<MetricType>::PointTerms(const size_t i,
+                                                    arma::mat* sum,
+                                                    double& denominator)
+{
+  // The points k considered for p_i: all other points, or only the nearest
+  // neighbors of i.
+  arma::uvec candidates;
+  if (numNeighbors == 0)
+  {
+    candidates = arma::regspace<arma::uvec>(0, dataset.n_cols - 1);
+    candidates.shed_row(i);
+  }
+  else
+  {
+    candidates = arma::conv_to<arma::uvec>::from(neighbors.col(i));
+  }
+
+  // We want to evaluate exp(-D(A x_i, A x_k)).
+  arma::vec evals(candidates.n_elem);
+  double numerator = 0.0;
+  denominator = 0.0;
+  for (size_t j = 0; j < candidates.n_elem; ++j)
+  {
+    evals[j] = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+        stretchedDataset.unsafe_col(candidates[j])));
+
+    // If they are in the same class, update the numerator.
+    if (labels[i] == labels[candidates[j]])
+      numerator += evals[j];
+
+    denominator += evals[j];
   }
 
-  // Divide p_i by their denominators.
-  p /= denominators;
+  // If the denominator is zero, then all p_ik should be zero and there is no
+  // gradient contribution from this point.
+  if (denominator == 0.0)
+    return 0.0;
 
-  // Clean up any bad values.
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+  const double pi = numerator / denominator;
+  if (sum)
   {
-    if (denominators[i] == 0.0)
+    // Weight each x_ik x_ik^T by p_ik (p_i - [k in class of i]).  For x_ik we
+    // are not using stretched points.
+    for (size_t j = 0; j < candidates.n_elem; ++j)
     {
-      Log::Debug << "Denominator of p_{" << i << ", j} is 0." << std::endl;
-
-      // Set to usable values.
-      denominators[i] = std::numeric_limits<double>::infinity();
-      p[i] = 0;
+      const double same = (labels[i] == labels[candidates[j]]) ? 1.0 : 0.0;
+      evals[j] *= (pi - same) / denominator;
     }
+
+    arma::mat diffs = dataset.cols(candidates);
+    diffs.each_col() -= dataset.col(i);
+    *sum += diffs * (diffs.each_row() % evals.t()).t();
   }
 
-  // We've done a precalculation.  Mark it as done.
-  precalculated = true;
+  return pi;
 }
 
 } // namespace nca
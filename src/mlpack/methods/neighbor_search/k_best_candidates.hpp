@@ -0,0 +1,115 @@
+/**
+ * @file k_best_candidates.hpp
+ *
+ * Definition of KBestCandidates, a flat, preallocated container for the k best
+ * candidate neighbors of every query point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_K_BEST_CANDIDATES_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_K_BEST_CANDIDATES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * KBestCandidates holds the k best candidates (according to the given
+ * SortPolicy) for each of a set of query points.  The candidates of all the
+ * query points live in two k x nQueries matrices, so only two allocations are
+ * made no matter how many query points there are.  Each column is kept sorted
+ * from best to worst with insertion, which is cheaper than a heap for the small
+ * values of k that are typically used.
+ *
+ * Since the columns are sorted, the matrices are directly the results of the
+ * search, and Release() hands them over without any copy.
+ *
+ * @tparam SortPolicy The sort policy for distances.
+ */
+template<typename SortPolicy>
+class KBestCandidates
+{
+ public:
+  /**
+   * Create the candidate lists for the given number of query points, each
+   * holding k candidates (SortPolicy::WorstDistance(), size_t() - 1).
+   *
+   * @param k Number of candidates to keep for each query point.
+   * @param numQueries Number of query points.
+   */
+  KBestCandidates(const size_t k, const size_t numQueries) :
+      neighbors(k, numQueries),
+      distances(k, numQueries)
+  {
+    neighbors.fill(size_t() - 1);
+    distances.fill(SortPolicy::WorstDistance());
+  }
+
+  //! Get the distance of the worst candidate of the given query point.
+  double WorstDistance(const size_t queryIndex) const
+  {
+    return distances(distances.n_rows - 1, queryIndex);
+  }
+
+  /**
+   * Insert a candidate for the given query point, if it is at least as good as
+   * the current worst candidate (which is then dropped).
+   *
+   * @param queryIndex Index of the query point.
+   * @param neighbor Index of the candidate neighbor.
+   * @param distance Distance from the query point to the candidate.
+   */
+  void Insert(const size_t queryIndex,
+              const size_t neighbor,
+              const double distance)
+  {
+    const size_t k = distances.n_rows;
+    double* columnDistances = distances.colptr(queryIndex);
+    size_t* columnNeighbors = neighbors.colptr(queryIndex);
+
+    if (k == 0 || SortPolicy::IsBetter(columnDistances[k - 1], distance))
+      return;
+
+    // Shift the worse candidates down until we find the position of the new
+    // one.
+    size_t pos = k - 1;
+    while (pos > 0 && SortPolicy::IsBetter(distance, columnDistances[pos - 1]))
+    {
+      columnDistances[pos] = columnDistances[pos - 1];
+      columnNeighbors[pos] = columnNeighbors[pos - 1];
+      --pos;
+    }
+
+    columnDistances[pos] = distance;
+    columnNeighbors[pos] = neighbor;
+  }
+
+  /**
+   * Move the candidates into the given matrices; column i holds the candidates
+   * of query point i, from best to worst.  The candidate lists are empty
+   * afterwards.
+   *
+   * @param neighborsOut Matrix to store the indices of the candidates in.
+   * @param distancesOut Matrix to store the distances of the candidates in.
+   */
+  void Release(arma::Mat<size_t>& neighborsOut, arma::mat& distancesOut)
+  {
+    neighborsOut = std::move(neighbors);
+    distancesOut = std::move(distances);
+  }
+
+ private:
+  //! The indices of the candidates, one column per query point.
+  arma::Mat<size_t> neighbors;
+  //! The distances of the candidates, one column per query point.
+  arma::mat distances;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -83,6 +83,10 @@ PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Hold the reference data and the tree in single "
+    "precision, which halves the memory used by the model (only valid for "
+    "kd-trees, ball trees, vp trees, random projection trees and UB trees).",
+    "f");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
@@ -107,6 +111,7 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "single_precision");
 
   // Notify the user of parameters that will be only be considered for query
   // tree.
@@ -183,6 +188,13 @@ static void mlpackMain()
         "ub", "oct" }, true, "unknown tree type");
     const string treeType = CLI::GetParam<string>("tree_type");
     const bool randomBasis = CLI::HasParam("random_basis");
+    const bool singlePrecision = CLI::HasParam("single_precision");
+    if (singlePrecision)
+    {
+      RequireParamInSet<string>("tree_type", { "kd", "ball", "vp", "rp",
+          "max-rp", "ub" }, true, "single precision is not supported for this "
+          "tree type");
+    }
 
     KFNModel::TreeTypes tree = KFNModel::KD_TREE;
     if (treeType == "kd")
@@ -216,6 +228,7 @@ static void mlpackMain()
 
     kfn->TreeType() = tree;
     kfn->RandomBasis() = randomBasis;
+    kfn->SinglePrecision() = singlePrecision;
 
     arma::mat referenceSet = std::move(CLI::GetParam<arma::mat>("reference"));
 
@@ -243,7 +256,7 @@ static void mlpackMain()
 
     Log::Info << "Using kFN model from '"
         << CLI::GetPrintableParam<KFNModel*>("input_model") << "' (trained on "
-        << kfn->Dataset().n_rows << "x" << kfn->Dataset().n_cols
+        << kfn->Dimensionality() << "x" << kfn->NumReferencePoints()
         << " dataset)." << endl;
   }
 
@@ -264,19 +277,19 @@ static void mlpackMain()
     // Sanity check on k value: must be greater than 0, must be less than or
     // equal to the number of reference points.  Since it is unsigned,
     // we only test the upper bound.
-    if (k > kfn->Dataset().n_cols)
+    if (k > kfn->NumReferencePoints())
     {
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
           << "than or equal to the number of reference points ("
-          << kfn->Dataset().n_cols << ")." << endl;
+          << kfn->NumReferencePoints() << ")." << endl;
     }
 
     // Sanity check on k value: must not be equal to the number of reference
     // points when query data has not been provided.
-    if (!CLI::HasParam("query") && k == kfn->Dataset().n_cols)
+    if (!CLI::HasParam("query") && k == kfn->NumReferencePoints())
     {
       Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
-          << "reference points (" << kfn->Dataset().n_cols << ") "
+          << "reference points (" << kfn->NumReferencePoints() << ") "
           << "if query data has not been provided." << endl;
     }
 
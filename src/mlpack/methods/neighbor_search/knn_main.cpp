@@ -23,6 +23,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
 
 using namespace std;
 using namespace mlpack;
@@ -91,14 +92,133 @@ PARAM_DOUBLE_IN("rho", "Balance threshold (only valid for spill trees).", "b",
 
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Hold the reference data and the tree in single "
+    "precision, which halves the memory used by the model (only valid for "
+    "kd-trees, ball trees, vp trees, random projection trees and UB trees).",
+    "f");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
 PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
-    "'dual_tree', 'greedy'.", "a", "dual_tree");
+    "'dual_tree', 'greedy', 'hnsw' (approximate search on an HNSW graph "
+    "instead of a tree; no model is saved).", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
 
+// Settings of the HNSW graph.
+PARAM_INT_IN("graph_degree", "Maximum number of links of a point in the HNSW "
+    "graph (twice as many on the bottom level) (only valid for the 'hnsw' "
+    "algorithm).", "g", 16);
+PARAM_INT_IN("construction_beam", "Width of the beam used to link new points "
+    "into the HNSW graph (only valid for the 'hnsw' algorithm).", "c", 200);
+PARAM_INT_IN("beam_width", "Width of the beam used to search the HNSW graph; "
+    "a wider beam finds more of the true neighbors (only valid for the 'hnsw' "
+    "algorithm).", "w", 50);
+
+/**
+ * Build an HNSW graph on the reference set and search it.  The graph is not a
+ * kNN model, so it can neither be loaded nor saved as one.
+ */
+static void HNSWMain()
+{
+  if (!CLI::HasParam("reference"))
+  {
+    Log::Fatal << "The 'hnsw' algorithm cannot use "
+        << PRINT_PARAM_STRING("input_model") << "; specify "
+        << PRINT_PARAM_STRING("reference") << " instead." << endl;
+  }
+  if (CLI::HasParam("output_model"))
+  {
+    Log::Fatal << "The 'hnsw' algorithm does not build a kNN model, so "
+        << PRINT_PARAM_STRING("output_model") << " cannot be specified."
+        << endl;
+  }
+
+  const string reason = "the 'hnsw' algorithm does not build a tree";
+  ReportIgnoredParam("tree_type", reason);
+  ReportIgnoredParam("leaf_size", reason);
+  ReportIgnoredParam("random_basis", reason);
+  ReportIgnoredParam("single_precision", reason);
+  ReportIgnoredParam("epsilon", reason);
+
+  RequireParamValue<int>("graph_degree", [](int x) { return x >= 2; }, true,
+      "graph degree must be at least 2");
+  RequireParamValue<int>("construction_beam", [](int x) { return x > 0; },
+      true, "construction beam must be positive");
+  RequireParamValue<int>("beam_width", [](int x) { return x > 0; }, true,
+      "beam width must be positive");
+
+  arma::mat referenceSet = std::move(CLI::GetParam<arma::mat>("reference"));
+  Log::Info << "Loaded reference data from '"
+      << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+      << referenceSet.n_rows << " x " << referenceSet.n_cols << ")." << endl;
+
+  Timer::Start("graph_building");
+  HNSWSearch<> hnsw(std::move(referenceSet),
+      (size_t) CLI::GetParam<int>("graph_degree"),
+      (size_t) CLI::GetParam<int>("construction_beam"),
+      (size_t) CLI::GetParam<int>("beam_width"));
+  Timer::Stop("graph_building");
+
+  if (!CLI::HasParam("k"))
+    return;
+
+  const size_t k = (size_t) CLI::GetParam<int>("k");
+  const size_t numReferences = hnsw.ReferenceSet().n_cols;
+  if (k > numReferences || (!CLI::HasParam("query") && k == numReferences))
+  {
+    Log::Fatal << "Invalid k: " << k << "; must be less than or equal to the "
+        << "number of reference points (" << numReferences << "), and less "
+        << "than it if query data has not been provided." << endl;
+  }
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  Timer::Start("computing_neighbors");
+  if (CLI::HasParam("query"))
+  {
+    arma::mat queryData = std::move(CLI::GetParam<arma::mat>("query"));
+    Log::Info << "Loaded query data from '"
+        << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+        << queryData.n_rows << "x" << queryData.n_cols << ")." << endl;
+    hnsw.Search(queryData, k, neighbors, distances);
+  }
+  else
+  {
+    hnsw.Search(k, neighbors, distances);
+  }
+  Timer::Stop("computing_neighbors");
+  Log::Info << "Search complete." << endl;
+
+  if (CLI::HasParam("true_distances"))
+  {
+    arma::mat trueDistances =
+        std::move(CLI::GetParam<arma::mat>("true_distances"));
+    if (trueDistances.n_rows != distances.n_rows ||
+        trueDistances.n_cols != distances.n_cols)
+      Log::Fatal << "The true distances file must have the same number of "
+          << "values than the set of distances being queried!" << endl;
+
+    Log::Info << "Effective error: " << KNN::EffectiveError(distances,
+        trueDistances) << endl;
+  }
+
+  if (CLI::HasParam("true_neighbors"))
+  {
+    arma::Mat<size_t> trueNeighbors =
+        std::move(CLI::GetParam<arma::Mat<size_t>>("true_neighbors"));
+    if (trueNeighbors.n_rows != neighbors.n_rows ||
+        trueNeighbors.n_cols != neighbors.n_cols)
+      Log::Fatal << "The true neighbors file must have the same number of "
+          << "values than the set of neighbors being queried!" << endl;
+
+    Log::Info << "Recall: " << KNN::Recall(neighbors, trueNeighbors) << endl;
+  }
+
+  CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  CLI::GetParam<arma::mat>("distances") = std::move(distances);
+}
+
 static void mlpackMain()
 {
   if (CLI::GetParam<int>("seed") != 0)
@@ -111,6 +231,7 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "single_precision");
   ReportIgnoredParam({{ "input_model", true }}, "tau");
   ReportIgnoredParam({{ "input_model", true }}, "rho");
   if (CLI::HasParam("input_model") && CLI::HasParam("leaf_size"))
@@ -170,7 +291,17 @@ static void mlpackMain()
 
   const string algorithm = CLI::GetParam<string>("algorithm");
   RequireParamInSet<string>("algorithm", { "naive", "single_tree", "dual_tree",
-      "greedy" }, true, "unknown neighbor search algorithm");
+      "greedy", "hnsw" }, true, "unknown neighbor search algorithm");
+  if (algorithm == "hnsw")
+  {
+    HNSWMain();
+    return;
+  }
+
+  ReportIgnoredParam("graph_degree", "the 'hnsw' algorithm is not being used");
+  ReportIgnoredParam("construction_beam", "the 'hnsw' algorithm is not being "
+      "used");
+  ReportIgnoredParam("beam_width", "the 'hnsw' algorithm is not being used");
   NeighborSearchMode searchMode = DUAL_TREE_MODE;
 
   if (algorithm == "naive")
@@ -189,11 +320,18 @@ static void mlpackMain()
     // Get all the parameters.
     const string treeType = CLI::GetParam<string>("tree_type");
     const bool randomBasis = CLI::HasParam("random_basis");
+    const bool singlePrecision = CLI::HasParam("single_precision");
 
     KNNModel::TreeTypes tree = KNNModel::KD_TREE;
     RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star",
         "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill", "vp", "rp",
         "max-rp", "ub", "oct" }, true, "unknown tree type");
+    if (singlePrecision)
+    {
+      RequireParamInSet<string>("tree_type", { "kd", "ball", "vp", "rp",
+          "max-rp", "ub" }, true, "single precision is not supported for this "
+          "tree type");
+    }
     if (treeType == "kd")
       tree = KNNModel::KD_TREE;
     else if (treeType == "cover")
@@ -227,6 +365,7 @@ static void mlpackMain()
 
     knn->TreeType() = tree;
     knn->RandomBasis() = randomBasis;
+    knn->SinglePrecision() = singlePrecision;
     knn->LeafSize() = size_t(lsInt);
     knn->Tau() = tau;
     knn->Rho() = rho;
@@ -238,6 +377,8 @@ static void mlpackMain()
         << referenceSet.n_rows << " x " << referenceSet.n_cols << ")."
         << endl;
 
+    // Every thread of a search visits any part of the reference tree.
+    Threads::Interleave(referenceSet);
     knn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
         epsilon);
   }
@@ -258,7 +399,7 @@ static void mlpackMain()
 
     Log::Info << "Loaded kNN model from '"
         << CLI::GetPrintableParam<KNNModel*>("input_model") << "' (trained on "
-        << knn->Dataset().n_rows << "x" << knn->Dataset().n_cols
+        << knn->Dimensionality() << "x" << knn->NumReferencePoints()
         << " dataset)." << endl;
   }
 
@@ -279,19 +420,19 @@ static void mlpackMain()
     // Sanity check on k value: must be greater than 0, must be less than or
     // equal to the number of reference points.  Since it is unsigned,
     // we only test the upper bound.
-    if (k > knn->Dataset().n_cols)
+    if (k > knn->NumReferencePoints())
     {
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
           << "than or equal to the number of reference points ("
-          << knn->Dataset().n_cols << ")." << endl;
+          << knn->NumReferencePoints() << ")." << endl;
     }
 
     // Sanity check on k value: must not be equal to the number of reference
     // points when query data has not been provided.
-    if (!CLI::HasParam("query") && k == knn->Dataset().n_cols)
+    if (!CLI::HasParam("query") && k == knn->NumReferencePoints())
     {
       Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
-          << "reference points (" << knn->Dataset().n_cols << ") "
+          << "reference points (" << knn->NumReferencePoints() << ") "
           << "if query data has not been provided." << endl;
     }
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
 #include <vector>
 #include <string>
 
@@ -30,10 +31,6 @@ namespace mlpack {
 // all-furthest-neighbors searches.
 namespace neighbor  {
 
-// Forward declaration.
-template<typename SortPolicy>
-class TrainVisitor;
-
 //! NeighborSearchMode represents the different neighbor search modes available.
 enum NeighborSearchMode
 {
@@ -224,6 +221,32 @@ class NeighborSearch
    */
   void Train(Tree&& referenceTree);
 
+  /**
+   * Add the given points to the reference set, without rebuilding the
+   * reference tree from scratch (see BinarySpaceTree::InsertPoints()).  The
+   * new points are given the indices following the largest index of the
+   * current reference points, in the order they are given.  This is only
+   * available for BinarySpaceTree-based tree types, and not in naive mode.
+   *
+   * @param points Points to add to the reference set.
+   * @param leafSize Maximum number of points in a leaf of the reference tree.
+   */
+  void Insert(const MatType& points, const size_t leafSize = 20);
+
+  /**
+   * Remove the points with the given indices from the reference set, without
+   * rebuilding the reference tree from scratch (see
+   * BinarySpaceTree::DeletePoints()).  The indices of the other points do not
+   * change, so the results of Search() without a query set have empty columns
+   * (index size_t() - 1, worst distance) for the deleted points.  This is only
+   * available for BinarySpaceTree-based tree types, and not in naive mode.
+   *
+   * @param indices Indices of the reference points to remove.
+   * @param leafSize Maximum number of points in a leaf of the reference tree.
+   * @return The number of points that were removed.
+   */
+  size_t Delete(const std::vector<size_t>& indices, const size_t leafSize = 20);
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -347,10 +370,55 @@ class NeighborSearch
   //! Modify the reference tree.
   Tree& ReferenceTree() { return *referenceTree; }
 
+  //! Access the mapping from the reference tree's point indices to the indices
+  //! of the original reference set (empty if no mapping is needed).
+  const std::vector<size_t>& OldFromNewReferences() const
+  { return oldFromNewReferences; }
+  //! Modify the mapping from the reference tree's point indices to the indices
+  //! of the original reference set.  This is only meant to be set after
+  //! Train() is called with a tree that was built with a mapping.
+  std::vector<size_t>& OldFromNewReferences() { return oldFromNewReferences; }
+
+  //! Access the instantiated metric.
+  const MetricType& Metric() const { return metric; }
+
   //! Serialize the NeighborSearch model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
+  /**
+   * Save the model as an index file.  The file holds a small header, the
+   * serialized model without the reference points, and the reference points
+   * as one raw column-major block, in the byte order and floating point format
+   * of this machine.  The model is neither modified nor copied, so it can be
+   * searched while it is saved, and saving needs no memory for the reference
+   * points beyond the file buffers.
+   *
+   * If the parameter 'fatal' is set to true, a std::runtime_error exception
+   * will be thrown if the index can't be saved.
+   *
+   * @param filename Name of the file to save the index to.
+   * @param fatal If an error should be reported as fatal (default false).
+   * @return Boolean value indicating success or failure of save.
+   */
+  bool SaveIndex(const std::string& filename, const bool fatal = false) const;
+
+  /**
+   * Load a model that was saved with SaveIndex().  Only the tree nodes are
+   * rebuilt: the file is mapped into memory and the reference set points into
+   * the mapping, so the reference points are read lazily as they are touched,
+   * and processes that load the same file share its pages.  The mapping is
+   * private, so modifications of the reference set never reach the file.
+   *
+   * If the parameter 'fatal' is set to true, a std::runtime_error exception
+   * will be thrown if the index can't be loaded.
+   *
+   * @param filename Name of the file to load the index from.
+   * @param fatal If an error should be reported as fatal (default false).
+   * @return Boolean value indicating success or failure of load.
+   */
+  bool LoadIndex(const std::string& filename, const bool fatal = false);
+
  private:
   //! Permutations of reference points during tree building.
   std::vector<size_t> oldFromNewReferences;
@@ -381,9 +449,33 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
-  //! The NSModel class should have access to internal members.
-  template<typename SortPol>
-  friend class TrainVisitor;
+  //! The mapped file the reference set points into, if loaded by LoadIndex().
+  data::MappedFile mappedReferences;
+
+  /**
+   * Traverse the reference tree once for each of the given number of query
+   * points with the single-tree traverser.  The query points are split into
+   * batches that are handed out dynamically to the available OpenMP threads,
+   * so a thread that finishes early takes over the remaining batches.  Each
+   * thread uses its own copy of the rules (copies share the candidate lists,
+   * and the batches are disjoint); the base case, score and cache hit counts
+   * are added back into the given rules.
+   *
+   * @param rules Rules to use for the traversal.
+   * @param numQueries Number of query points.
+   * @return Number of nodes pruned by the traversals.
+   */
+  template<typename RuleType>
+  size_t SingleTreeSearch(RuleType& rules, const size_t numQueries);
+
+  /**
+   * Report an error of SaveIndex() or LoadIndex().
+   *
+   * @param message The error message.
+   * @param fatal If the error should be reported as fatal.
+   * @return Always false.
+   */
+  static bool IndexError(const std::string& message, const bool fatal);
 }; // class NeighborSearch
 
 } // namespace neighbor
@@ -0,0 +1,154 @@
+/**
+ * @file neighbor_search_engine.hpp
+ *
+ * Defines the NeighborSearchEngine class, which serves batches of neighbor
+ * search queries against a reference tree that is kept in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_ENGINE_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_ENGINE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "neighbor_search.hpp"
+
+#include <mutex>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The NeighborSearchEngine class serves neighbor search queries from a trained
+ * NeighborSearch object, for programs that answer many small batches of queries
+ * over the lifetime of a single reference set.  The reference tree is built (or
+ * deserialized) once and then stays resident, and Search() may be called
+ * concurrently from several threads.
+ *
+ * Each batch is searched either with a single-tree traversal, which needs no
+ * query tree and is the fastest for small batches, or with a dual-tree
+ * traversal over a query tree built for that batch.  The choice is made by
+ * comparing the size of the batch with DualTreeThreshold().
+ *
+ * Unlike NeighborSearch::Search(), Search() does not touch the global timers or
+ * any state of the engine, so it is safe to call concurrently.  For tree types
+ * whose rules cache distances in the reference nodes (those for which the first
+ * point is the centroid, like the cover tree), calls are serialized instead.
+ *
+ * @code
+ * KNN knn(std::move(referenceSet));
+ * NeighborSearchEngine<> engine(std::move(knn));
+ *
+ * // This may be done from any number of threads.
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * engine.Search(queries, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ * @tparam DualTreeTraversalType The type of dual tree traversal to use.
+ * @tparam SingleTreeTraversalType The type of single tree traversal to use.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = mlpack::metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree,
+         template<typename RuleType> class DualTreeTraversalType =
+             TreeType<MetricType,
+                      NeighborSearchStat<SortPolicy>,
+                      MatType>::template DualTreeTraverser,
+         template<typename RuleType> class SingleTreeTraversalType =
+             TreeType<MetricType,
+                      NeighborSearchStat<SortPolicy>,
+                      MatType>::template SingleTreeTraverser>
+class NeighborSearchEngine
+{
+ public:
+  //! The type of NeighborSearch object that the engine serves queries from.
+  typedef NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+      DualTreeTraversalType, SingleTreeTraversalType> NeighborSearchType;
+  //! Convenience typedef.
+  typedef typename NeighborSearchType::Tree Tree;
+
+  /**
+   * Create the engine from a trained NeighborSearch object, which is moved
+   * into the engine.  The NeighborSearch object must hold a reference tree
+   * (i.e. it may not use naive search).
+   *
+   * @param search Trained NeighborSearch object.
+   * @param dualTreeThreshold Minimum batch size for which dual-tree search is
+   *     used.
+   */
+  NeighborSearchEngine(NeighborSearchType&& search,
+                       const size_t dualTreeThreshold = 64);
+
+  /**
+   * Create the engine by building a reference tree on the given reference
+   * set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param dualTreeThreshold Minimum batch size for which dual-tree search is
+   *     used.
+   * @param metric An optional instance of the MetricType class.
+   */
+  NeighborSearchEngine(MatType referenceSet,
+                       const double epsilon = 0,
+                       const size_t dualTreeThreshold = 64,
+                       const MetricType metric = MetricType());
+
+  /**
+   * For each point in the query set, compute the nearest neighbors and store
+   * the output in the given matrices.  The matrices will be set to the size of
+   * k x [number of query points].  This may be called from several threads at
+   * once.
+   *
+   * @param querySet Set of query points (can be just one point).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the minimum batch size for which dual-tree search is used.
+  size_t DualTreeThreshold() const { return dualTreeThreshold; }
+  //! Modify the minimum batch size for which dual-tree search is used.  This
+  //! must not be done while Search() is running.
+  size_t& DualTreeThreshold() { return dualTreeThreshold; }
+
+  //! Access the NeighborSearch object that holds the reference tree.
+  const NeighborSearchType& Model() const { return search; }
+
+ private:
+  //! The NeighborSearch object holding the reference tree and the metric.
+  NeighborSearchType search;
+  //! The root of the reference tree.  The traversals need a non-const tree,
+  //! but the rules do not modify it unless calls are serialized.
+  Tree* referenceTree;
+  //! Minimum batch size for which dual-tree search is used.
+  size_t dualTreeThreshold;
+  //! Serializes calls to Search() for trees that aren't safe to share.
+  mutable std::mutex mutex;
+
+  //! Make sure that the NeighborSearch object can be used by the engine.
+  void CheckModel() const;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "neighbor_search_engine_impl.hpp"
+
+#endif
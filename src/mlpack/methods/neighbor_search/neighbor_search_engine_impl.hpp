@@ -0,0 +1,170 @@
+/**
+ * @file neighbor_search_engine_impl.hpp
+ *
+ * Implementation of NeighborSearchEngine.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_ENGINE_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_ENGINE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "neighbor_search_engine.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+NeighborSearchEngine<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::NeighborSearchEngine(
+    NeighborSearchType&& search,
+    const size_t dualTreeThreshold) :
+    search(std::move(search)),
+    referenceTree(NULL),
+    dualTreeThreshold(dualTreeThreshold)
+{
+  CheckModel();
+  referenceTree = &this->search.ReferenceTree();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+NeighborSearchEngine<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::NeighborSearchEngine(
+    MatType referenceSet,
+    const double epsilon,
+    const size_t dualTreeThreshold,
+    const MetricType metric) :
+    search(std::move(referenceSet), DUAL_TREE_MODE, epsilon, metric),
+    referenceTree(&search.ReferenceTree()),
+    dualTreeThreshold(dualTreeThreshold)
+{
+  // Nothing to do.
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearchEngine<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::CheckModel() const
+{
+  if (search.SearchMode() == NAIVE_MODE)
+  {
+    throw std::invalid_argument("NeighborSearchEngine: the given "
+        "NeighborSearch object does not hold a reference tree (naive mode)");
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearchEngine<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  const MatType& referenceSet = search.ReferenceSet();
+  if (k > referenceSet.n_cols)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << referenceSet.n_cols << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // The single-tree rules of these trees cache distances in the reference
+  // nodes, so concurrent searches would overwrite each other's values.
+  std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+  if (tree::TreeTraits<Tree>::FirstPointIsCentroid)
+    lock.lock();
+
+  // Each search gets its own copy of the metric, in case it has state.
+  MetricType metric(search.Metric());
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  if (querySet.n_cols < dualTreeThreshold)
+  {
+    // Small batches aren't worth building a query tree for.
+    RuleType rules(referenceSet, querySet, k, metric, search.Epsilon());
+    SingleTreeTraversalType<RuleType> traverser(rules);
+
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    rules.GetResults(neighbors, distances);
+  }
+  else
+  {
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+
+    RuleType rules(referenceSet, queryTree->Dataset(), k, metric,
+        search.Epsilon());
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    if (oldFromNewQueries.empty())
+    {
+      rules.GetResults(neighbors, distances);
+    }
+    else
+    {
+      arma::Mat<size_t> treeNeighbors;
+      arma::mat treeDistances;
+      rules.GetResults(treeNeighbors, treeDistances);
+
+      // Put the query points back in their original order.
+      neighbors.set_size(k, querySet.n_cols);
+      distances.set_size(k, querySet.n_cols);
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+      {
+        neighbors.col(oldFromNewQueries[i]) = treeNeighbors.col(i);
+        distances.col(oldFromNewQueries[i]) = treeDistances.col(i);
+      }
+    }
+
+    delete queryTree;
+  }
+
+  // Map the reference indices back to the original reference set.
+  const std::vector<size_t>& oldFromNewReferences =
+      search.OldFromNewReferences();
+  if (!oldFromNewReferences.empty())
+  {
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+      neighbors[i] = oldFromNewReferences[neighbors[i]];
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,17 @@
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace neighbor {
 
@@ -188,7 +199,8 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    treeNeedsReset(other.treeNeedsReset),
+    mappedReferences(std::move(other.mappedReferences))
 {
   // Clear the other model.
   other.referenceSet = new MatType();
@@ -246,6 +258,7 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = false;
+  mappedReferences = data::MappedFile();
 }
 
 // Move operator.
@@ -290,6 +303,7 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = other.treeNeedsReset;
+  mappedReferences = std::move(other.mappedReferences);
 
   // Reset the other object.
   other.referenceSet = new MatType();
@@ -461,6 +475,55 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree&& referenceTree)
   setOwner = false;
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(const MatType& points,
+                                                       const size_t leafSize)
+{
+  if (searchMode == NAIVE_MODE || !referenceTree)
+    throw std::invalid_argument("cannot insert points into the reference set "
+        "without a reference tree");
+
+  referenceTree->InsertPoints(points, oldFromNewReferences, leafSize);
+  referenceSet = &referenceTree->Dataset();
+
+  // The statistics of the nodes that didn't change may still hold the state of
+  // a previous monochromatic search.
+  treeNeedsReset = true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Delete(
+    const std::vector<size_t>& indices,
+    const size_t leafSize)
+{
+  if (searchMode == NAIVE_MODE || !referenceTree)
+    throw std::invalid_argument("cannot delete points from the reference set "
+        "without a reference tree");
+
+  const size_t deleted = referenceTree->DeletePoints(indices,
+      oldFromNewReferences, leafSize);
+  referenceSet = &referenceTree->Dataset();
+  treeNeedsReset = true;
+
+  return deleted;
+}
+
 /**
  * Computes the best neighbors and stores them in resultingNeighbors and
  * distances.
@@ -488,10 +551,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     throw std::invalid_argument(ss.str());
   }
 
+  MLPACK_PROFILE_SCOPE("neighbor_search");
   Timer::Start("computing_neighbors");
 
   baseCases = 0;
   scores = 0;
+  size_t prunes = 0, cacheHits = 0;
 
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
@@ -543,15 +608,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Traverse for each point.
+      prunes += SingleTreeSearch(rules, querySet.n_cols);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
+      cacheHits += rules.CacheHits();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -566,7 +628,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Build the query tree.
       Timer::Stop("computing_neighbors");
       Timer::Start("tree_building");
-      Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+      Tree* queryTree;
+      {
+        MLPACK_PROFILE_SCOPE("query_tree_building");
+        queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+      }
       Timer::Stop("tree_building");
       Timer::Start("computing_neighbors");
 
@@ -580,6 +646,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
+      cacheHits += rules.CacheHits();
+      prunes += traverser.NumPrunes();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -608,6 +676,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
+      cacheHits += rules.CacheHits();
+      prunes += traverser.NumPrunes();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -619,6 +689,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
   }
 
+  WorkCounters::Add("neighbor_search", baseCases, scores, prunes, cacheHits);
   Timer::Stop("computing_neighbors");
 
   // Map points back to original indices, if necessary.
@@ -710,10 +781,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     throw std::invalid_argument("cannot call NeighborSearch::Search() with a "
         "query tree when naive or singleMode are set to true");
 
+  MLPACK_PROFILE_SCOPE("neighbor_search");
   Timer::Start("computing_neighbors");
 
   baseCases = 0;
   scores = 0;
+  size_t prunes = 0, cacheHits = 0;
 
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
@@ -738,6 +811,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   scores += rules.Scores();
   baseCases += rules.BaseCases();
+  cacheHits += rules.CacheHits();
+  prunes += traverser.NumPrunes();
 
   Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
   Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
@@ -747,6 +822,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   Log::Info << rules.Scores() << " node combinations were scored.\n";
   Log::Info << rules.BaseCases() << " base cases were calculated.\n";
 
+  WorkCounters::Add("neighbor_search", baseCases, scores, prunes, cacheHits);
   Timer::Stop("computing_neighbors");
 
   // Do we need to map indices?
@@ -796,10 +872,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     throw std::invalid_argument(ss.str());
   }
 
+  MLPACK_PROFILE_SCOPE("neighbor_search");
   Timer::Start("computing_neighbors");
 
   baseCases = 0;
   scores = 0;
+  size_t prunes = 0, cacheHits = 0;
 
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
@@ -835,15 +913,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Traverse for each point.
+      prunes += SingleTreeSearch(rules, referenceSet->n_cols);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
+      cacheHits += rules.CacheHits();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -892,6 +967,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
+      cacheHits += rules.CacheHits();
+      prunes += traverser.NumPrunes();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -916,6 +993,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
+      cacheHits += rules.CacheHits();
+      prunes += traverser.NumPrunes();
 
       Log::Info << rules.Scores() << " node combinations were scored."
           << std::endl;
@@ -927,16 +1006,28 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   rules.GetResults(*neighborPtr, *distancePtr);
 
+  WorkCounters::Add("neighbor_search", baseCases, scores, prunes, cacheHits);
   Timer::Stop("computing_neighbors");
 
   // Do we need to map the reference indices?
   if (!oldFromNewReferences.empty() &&
       tree::TreeTraits<Tree>::RearrangesDataset)
   {
-    neighbors.set_size(k, referenceSet->n_cols);
-    distances.set_size(k, referenceSet->n_cols);
+    // If points were deleted with Delete(), there may be gaps in the indices
+    // of the reference points; the columns of those gaps are left empty.
+    size_t numColumns = referenceSet->n_cols;
+    for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+      numColumns = std::max(numColumns, oldFromNewReferences[i] + 1);
+
+    neighbors.set_size(k, numColumns);
+    distances.set_size(k, numColumns);
+    if (numColumns > referenceSet->n_cols)
+    {
+      neighbors.fill(size_t() - 1);
+      distances.fill(SortPolicy::WorstDistance());
+    }
 
-    for (size_t i = 0; i < distances.n_cols; ++i)
+    for (size_t i = 0; i < distancePtr->n_cols; ++i)
     {
       // Map distances (copy a column).
       const size_t refMapping = oldFromNewReferences[i];
@@ -1022,6 +1113,62 @@ DualTreeTraversalType, SingleTreeTraversalType>::Recall(
   return ((double) found) / realNeighbors.n_elem;
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SingleTreeSearch(
+    RuleType& rules,
+    const size_t numQueries)
+{
+  // Small batches keep the load balanced; large enough batches keep the
+  // scheduling overhead negligible next to a full tree traversal.
+  const size_t batchSize = 64;
+  const size_t numBatches = (numQueries + batchSize - 1) / batchSize;
+  size_t prunes = 0;
+
+  #pragma omp parallel if (numBatches > 1)
+  {
+    RuleType threadRules(rules);
+    threadRules.BaseCases() = 0;
+    threadRules.Scores() = 0;
+    threadRules.CacheHits() = 0;
+
+    #ifdef HAS_OPENMP
+    // Cover trees cache per-query distances in the reference nodes; that is
+    // only safe when a single traversal is running.
+    if (omp_get_num_threads() > 1)
+      threadRules.CacheInReference() = false;
+    #endif
+
+    SingleTreeTraversalType<RuleType> traverser(threadRules);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBatches; ++b)
+    {
+      const size_t end = std::min(numQueries, ((size_t) b + 1) * batchSize);
+      for (size_t i = (size_t) b * batchSize; i < end; ++i)
+        traverser.Traverse(i, *referenceTree);
+    }
+
+    #pragma omp critical
+    {
+      rules.BaseCases() += threadRules.BaseCases();
+      rules.Scores() += threadRules.Scores();
+      rules.CacheHits() += threadRules.CacheHits();
+      prunes += traverser.NumPrunes();
+    }
+  }
+
+  return prunes;
+}
+
 //! Serialize the NeighborSearch model.
 template<typename SortPolicy,
          typename MetricType,
@@ -1104,6 +1251,185 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
   }
 }
 
+// The index format starts with a header of eight 64-bit words: the magic
+// number, a byte order mark, the format version, the size of a point
+// coordinate, the size of the serialized model, the number of rows and columns
+// of the reference set and the offset of the reference set in the file.
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SaveIndex(
+    const std::string& filename,
+    const bool fatal) const
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Serialize the model with an empty reference set.  The model may be
+  // searched at the same time, and in naive mode the reference set may belong
+  // to the caller, so the reference set is neither modified nor copied: it is
+  // saved as an empty matrix, and its points are written after the model.
+  const MatType& dataset = *referenceSet;
+  std::string model;
+  {
+    std::ostringstream modelStream;
+    MatType::SerializeAsEmpty() = &dataset;
+    try
+    {
+      boost::archive::binary_oarchive ar(modelStream);
+      ar << *this;
+    }
+    catch (boost::archive::archive_exception& e)
+    {
+      MatType::SerializeAsEmpty() = NULL;
+      return IndexError("Cannot serialize model: " + std::string(e.what()) +
+          ".", fatal);
+    }
+    catch (...)
+    {
+      MatType::SerializeAsEmpty() = NULL;
+      throw;
+    }
+    MatType::SerializeAsEmpty() = NULL;
+    model = modelStream.str();
+  }
+
+  // Align the points to a cache line, so that they can be used in place.
+  const size_t alignment = 64;
+  const size_t modelEnd = 8 * sizeof(uint64_t) + model.size();
+  const size_t offset = (modelEnd + alignment - 1) / alignment * alignment;
+
+  uint64_t header[8];
+  std::memcpy(&header[0], "MLPKNSI", 8);
+  header[1] = 0x0102030405060708ULL;
+  header[2] = 1;
+  header[3] = sizeof(ElemType);
+  header[4] = model.size();
+  header[5] = dataset.n_rows;
+  header[6] = dataset.n_cols;
+  header[7] = offset;
+
+  std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary |
+      std::ios::trunc);
+  if (!stream.is_open())
+  {
+    return IndexError("Cannot open file '" + filename + "' for writing.",
+        fatal);
+  }
+
+  const std::string padding(offset - modelEnd, '\0');
+  stream.write((const char*) header, sizeof(header));
+  stream.write(model.data(), model.size());
+  stream.write(padding.data(), padding.size());
+  stream.write((const char*) dataset.memptr(),
+      dataset.n_elem * sizeof(ElemType));
+
+  if (!stream.good())
+    return IndexError("Cannot write to file '" + filename + "'.", fatal);
+
+  return true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::LoadIndex(
+    const std::string& filename,
+    const bool fatal)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  data::MappedFile file;
+  try
+  {
+    file = data::MappedFile(filename);
+  }
+  catch (std::runtime_error& e)
+  {
+    return IndexError("Cannot load index from '" + filename + "': " +
+        e.what() + ".", fatal);
+  }
+
+  uint64_t header[8];
+  if (file.Size() < sizeof(header))
+  {
+    return IndexError("File '" + filename + "' is not a neighbor search "
+        "index.", fatal);
+  }
+  std::memcpy(header, file.Data(), sizeof(header));
+
+  if (std::memcmp(&header[0], "MLPKNSI", 8) != 0 ||
+      header[1] != 0x0102030405060708ULL || header[2] != 1 ||
+      header[3] != sizeof(ElemType))
+  {
+    return IndexError("File '" + filename + "' is not a neighbor search "
+        "index saved on a compatible machine.", fatal);
+  }
+
+  const uint64_t pointsSize = header[5] * header[6] * sizeof(ElemType);
+  if (header[7] < sizeof(header) + header[4] ||
+      header[7] % sizeof(ElemType) != 0 || header[7] > file.Size() ||
+      pointsSize > file.Size() - header[7])
+  {
+    return IndexError("File '" + filename + "' is truncated or corrupt.",
+        fatal);
+  }
+
+  try
+  {
+    std::istringstream modelStream(std::string(file.Data() + sizeof(header),
+        header[4]));
+    boost::archive::binary_iarchive ar(modelStream);
+    ar >> *this;
+  }
+  catch (boost::archive::archive_exception& e)
+  {
+    return IndexError("Cannot load model from '" + filename + "': " +
+        e.what() + ".", fatal);
+  }
+
+  // Use the mapped points in place.  The tree nodes all refer to the dataset
+  // object, so its memory is replaced without moving the object itself.
+  MatType points((ElemType*) (file.Data() + header[7]), header[5], header[6],
+      false, false);
+  const_cast<MatType&>(*referenceSet).steal_mem(points);
+  mappedReferences = std::move(file);
+
+  return true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::IndexError(
+    const std::string& message,
+    const bool fatal)
+{
+  if (fatal)
+    Log::Fatal << message << std::endl;
+  else
+    Log::Warning << message << std::endl;
+
+  return false;
+}
+
 } // namespace neighbor
 } // namespace mlpack
 
@@ -14,12 +14,41 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/indexed_statistic.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
-#include <queue>
+#include "k_best_candidates.hpp"
+#include "neighbor_search_stat.hpp"
+
+#include <memory>
 
 namespace mlpack {
 namespace neighbor {
 
+/**
+ * BlockBaseCaseTraits tells whether NeighborSearchRules::BlockBaseCase() can
+ * compute its distances as one block of squared Euclidean distances,
+ * ||q||^2 + ||r||^2 - 2 q^T r, with a single matrix product.  This is only the
+ * case for the (squared) Euclidean distance on dense matrices; for anything
+ * else BlockBaseCase() just calls BaseCase() for every pair of points.
+ */
+template<typename MetricType, typename MatType>
+struct BlockBaseCaseTraits
+{
+  //! If true, the block kernel is used.
+  static const bool UseBlockKernel = false;
+  //! If true, the square root of the block distances is taken.
+  static const bool TakeRoot = false;
+};
+
+//! The (squared) Euclidean distance on dense matrices uses the block kernel.
+template<bool TakeRootValue>
+struct BlockBaseCaseTraits<metric::LMetric<2, TakeRootValue>, arma::mat>
+{
+  static const bool UseBlockKernel = true;
+  static const bool TakeRoot = TakeRootValue;
+};
+
 /**
  * The NeighborSearchRules class is a template helper class used by
  * NeighborSearch class when performing distance-based neighbor searches.  For
@@ -27,6 +56,14 @@ namespace neighbor {
  * reference dataset which have the 'best' distance according to a given sorting
  * policy.
  *
+ * Copies of a NeighborSearchRules object share the candidate lists, so copies
+ * may be used concurrently as long as they work on different query points.
+ *
+ * The bounds are usually stored in the NeighborSearchStat of every node.  If
+ * the nodes hold a tree::IndexedStatistic instead, they are stored in the
+ * NeighborSearchStatTable of each tree, which must be set with QueryStats() and
+ * ReferenceStats() before the traversal.
+ *
  * @tparam SortPolicy The sort policy for distances.
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
@@ -56,6 +93,8 @@ class NeighborSearchRules
 
   /**
    * Store the list of candidates for each query point in the given matrices.
+   * The candidates are moved into the matrices, so this may only be called
+   * once, at the end of the search.
    *
    * @param neighbors Matrix storing lists of neighbors for each query point.
    * @param distances Matrix storing distances of neighbors for each query
@@ -73,6 +112,23 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between each of the given query points and every
+   * reference point in [referenceBegin, referenceBegin + referenceCount), as
+   * happens when two leaves are reached.  For the Euclidean distance the whole
+   * block of distances is computed at once; it is then used to skip the
+   * reference points that cannot improve the candidate lists, and the other
+   * ones are evaluated exactly with the metric.  The results are therefore the
+   * same as those of calling BaseCase() for every pair.
+   *
+   * @param queries Indices of the query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BlockBaseCase(const std::vector<size_t>& queries,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -149,6 +205,32 @@ class NeighborSearchRules
   //! Modify the number of scores that have been performed.
   size_t& Scores() { return scores; }
 
+  //! Get the number of base cases that were reused instead of computed.
+  size_t CacheHits() const { return cacheHits; }
+  //! Modify the number of base cases that were reused instead of computed.
+  size_t& CacheHits() { return cacheHits; }
+
+  //! Get whether single-tree base cases are cached in the reference nodes.
+  bool CacheInReference() const { return cacheInReference; }
+  //! Modify whether single-tree base cases are cached in the reference nodes.
+  //! This must be false when several rules objects traverse the same reference
+  //! tree concurrently.
+  bool& CacheInReference() { return cacheInReference; }
+
+  //! Get the statistics of the query tree, if its nodes are only indexed.
+  NeighborSearchStatTable<SortPolicy>* QueryStats() const
+  { return queryStats; }
+  //! Modify the statistics of the query tree, if its nodes are only indexed.
+  NeighborSearchStatTable<SortPolicy>*& QueryStats() { return queryStats; }
+
+  //! Get the statistics of the reference tree, if its nodes are only indexed.
+  NeighborSearchStatTable<SortPolicy>* ReferenceStats() const
+  { return referenceStats; }
+  //! Modify the statistics of the reference tree, if its nodes are only
+  //! indexed.
+  NeighborSearchStatTable<SortPolicy>*& ReferenceStats()
+  { return referenceStats; }
+
   //! Convenience typedef.
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
 
@@ -164,23 +246,10 @@ class NeighborSearchRules
   //! The query set.
   const typename TreeType::Mat& querySet;
 
-  //! Candidate represents a possible candidate neighbor (distance, index).
-  typedef std::pair<double, size_t> Candidate;
-
-  //! Compare two candidates based on the distance.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
-    {
-      return !SortPolicy::IsBetter(c2.first, c1.first);
-    };
-  };
-
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
-
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! The k best candidate neighbors of each query point.  This is shared by all
+  //! copies of the rules, so that copies can be used to traverse disjoint query
+  //! subtrees in parallel (see BinarySpaceTree::ParallelDualTreeTraverser).
+  std::shared_ptr<KBestCandidates<SortPolicy> > candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -205,11 +274,53 @@ class NeighborSearchRules
   size_t baseCases;
   //! The number of scores that have been performed.
   size_t scores;
+  //! The number of base cases that were reused instead of computed.
+  size_t cacheHits;
+
+  //! If true (the default), the single-tree Score() of trees with self-children
+  //! stores the base case of each reference node in its statistic, so that
+  //! the self-child can reuse it.
+  bool cacheInReference;
 
   //! Traversal info for the parent combination; this is updated by the
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
 
+  //! The statistics of the query tree, if its nodes hold an IndexedStatistic.
+  //! They are shared by all copies of the rules.
+  NeighborSearchStatTable<SortPolicy>* queryStats;
+  //! The statistics of the reference tree, if its nodes hold an
+  //! IndexedStatistic.  They are shared by all copies of the rules.
+  NeighborSearchStatTable<SortPolicy>* referenceStats;
+
+  // Accessors of the bounds of a node: they are stored in its statistic, or in
+  // the given table if the statistic only holds the index of the node.
+  typedef NeighborSearchStatTable<SortPolicy> StatTable;
+
+  template<typename StatType>
+  static double& FirstBound(StatType& stat, StatTable* /* table */)
+  { return stat.FirstBound(); }
+  static double& FirstBound(tree::IndexedStatistic& stat, StatTable* table)
+  { return table->FirstBound(stat.Index()); }
+
+  template<typename StatType>
+  static double& SecondBound(StatType& stat, StatTable* /* table */)
+  { return stat.SecondBound(); }
+  static double& SecondBound(tree::IndexedStatistic& stat, StatTable* table)
+  { return table->SecondBound(stat.Index()); }
+
+  template<typename StatType>
+  static double& AuxBound(StatType& stat, StatTable* /* table */)
+  { return stat.AuxBound(); }
+  static double& AuxBound(tree::IndexedStatistic& stat, StatTable* table)
+  { return table->AuxBound(stat.Index()); }
+
+  template<typename StatType>
+  static double& LastDistance(StatType& stat, StatTable* /* table */)
+  { return stat.LastDistance(); }
+  static double& LastDistance(tree::IndexedStatistic& stat, StatTable* table)
+  { return table->LastDistance(stat.Index()); }
+
   /**
    * Recalculate the bound for a given query node.
    */
@@ -225,6 +336,28 @@ class NeighborSearchRules
   void InsertNeighbor(const size_t queryIndex,
                       const size_t neighbor,
                       const double distance);
+
+  /**
+   * Compute the block base case with one query-reference pair at a time.
+   */
+  template<typename Metric = MetricType>
+  void BlockBaseCaseImpl(
+      const std::vector<size_t>& queries,
+      const size_t referenceBegin,
+      const size_t referenceCount,
+      const typename std::enable_if_t<!BlockBaseCaseTraits<Metric,
+          typename TreeType::Mat>::UseBlockKernel>* = 0);
+
+  /**
+   * Compute the block base case with the squared Euclidean block kernel.
+   */
+  template<typename Metric = MetricType>
+  void BlockBaseCaseImpl(
+      const std::vector<size_t>& queries,
+      const size_t referenceBegin,
+      const size_t referenceCount,
+      const typename std::enable_if_t<BlockBaseCaseTraits<Metric,
+          typename TreeType::Mat>::UseBlockKernel>* = 0);
 };
 
 } // namespace neighbor
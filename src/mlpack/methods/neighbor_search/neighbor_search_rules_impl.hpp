@@ -36,7 +36,11 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    cacheHits(0),
+    cacheInReference(true),
+    queryStats(NULL),
+    referenceStats(NULL)
 {
   // We must set the traversal info last query and reference node pointers to
   // something that is both invalid (i.e. not a tree node) and not NULL.  We'll
@@ -48,15 +52,7 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
   // It will be initialized with k candidates: (WorstDistance, size_t() - 1)
   // The list of candidates will be updated when visiting new points with the
   // BaseCase() method.
-  const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
-      size_t() - 1);
-
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
-
-  candidates.reserve(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; i++)
-    candidates.push_back(pqueue);
+  candidates.reset(new KBestCandidates<SortPolicy>(k, querySet.n_cols));
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -64,19 +60,7 @@ void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  neighbors.set_size(k, querySet.n_cols);
-  distances.set_size(k, querySet.n_cols);
-
-  for (size_t i = 0; i < querySet.n_cols; i++)
-  {
-    CandidateList& pqueue = candidates[i];
-    for (size_t j = 1; j <= k; j++)
-    {
-      neighbors(k - j, i) = pqueue.top().second;
-      distances(k - j, i) = pqueue.top().first;
-      pqueue.pop();
-    }
-  }
+  candidates->Release(neighbors, distances);
 };
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -91,7 +75,10 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
 
   // If we have already performed this base case, then do not perform it again.
   if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
+  {
+    ++cacheHits;
     return lastBaseCase;
+  }
 
   double distance = metric.Evaluate(querySet.col(queryIndex),
                                     referenceSet.col(referenceIndex));
@@ -107,6 +94,96 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BlockBaseCase(
+    const std::vector<size_t>& queries,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  BlockBaseCaseImpl(queries, referenceBegin, referenceCount);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename Metric>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BlockBaseCaseImpl(
+    const std::vector<size_t>& queries,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename std::enable_if_t<!BlockBaseCaseTraits<Metric,
+        typename TreeType::Mat>::UseBlockKernel>*)
+{
+  const size_t referenceEnd = referenceBegin + referenceCount;
+  for (size_t i = 0; i < queries.size(); ++i)
+    for (size_t ref = referenceBegin; ref < referenceEnd; ++ref)
+      BaseCase(queries[i], ref);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename Metric>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BlockBaseCaseImpl(
+    const std::vector<size_t>& queries,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    const typename std::enable_if_t<BlockBaseCaseTraits<Metric,
+        typename TreeType::Mat>::UseBlockKernel>*)
+{
+  if (queries.empty() || referenceCount == 0)
+    return;
+
+  // Gather the query points, so that all of the dot products can be computed
+  // with one matrix product.  The reference points are contiguous already.
+  arma::mat queryBlock(querySet.n_rows, queries.size());
+  for (size_t i = 0; i < queries.size(); ++i)
+    queryBlock.col(i) = querySet.col(queries[i]);
+  const arma::mat referenceBlock(
+      const_cast<double*>(referenceSet.colptr(referenceBegin)),
+      referenceSet.n_rows, referenceCount, false, true);
+
+  const arma::rowvec queryNorms = arma::sum(arma::square(queryBlock));
+  const arma::rowvec referenceNorms = arma::sum(arma::square(referenceBlock));
+
+  // Column i holds the squared distances from query i to every reference point.
+  arma::mat block = -2.0 * (referenceBlock.t() * queryBlock);
+  block.each_row() += queryNorms;
+  block.each_col() += referenceNorms.t();
+
+  // The expansion suffers from cancellation, so we only use it to rule points
+  // out: the exact squared distance is within tolerance of the block value.
+  const double relativeError = (4.0 + querySet.n_rows) *
+      std::numeric_limits<double>::epsilon();
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    const size_t queryIndex = queries[i];
+    for (size_t j = 0; j < referenceCount; ++j)
+    {
+      const size_t referenceIndex = referenceBegin + j;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      ++baseCases;
+
+      const double tolerance = relativeError *
+          (queryNorms[i] + referenceNorms[j]);
+      double lower = std::max(block(j, i) - tolerance, 0.0);
+      double upper = std::max(block(j, i) + tolerance, 0.0);
+      if (BlockBaseCaseTraits<Metric, typename TreeType::Mat>::TakeRoot)
+      {
+        lower = std::sqrt(lower);
+        upper = std::sqrt(upper);
+      }
+
+      const double worst = candidates->WorstDistance(queryIndex);
+      if (SortPolicy::IsBetter(worst, lower) &&
+          SortPolicy::IsBetter(worst, upper))
+        continue; // This point can't be a candidate.
+
+      const double distance = metric.Evaluate(querySet.col(queryIndex),
+          referenceSet.col(referenceIndex));
+      InsertNeighbor(queryIndex, referenceIndex, distance);
+    }
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -123,14 +200,19 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     {
       // If the parent node is the same, then we have already calculated the
       // base case.
-      if ((referenceNode.Parent() != NULL) &&
+      if (cacheInReference && (referenceNode.Parent() != NULL) &&
           (referenceNode.Point(0) == referenceNode.Parent()->Point(0)))
-        baseCase = referenceNode.Parent()->Stat().LastDistance();
+      {
+        baseCase = LastDistance(referenceNode.Parent()->Stat(),
+            referenceStats);
+        ++cacheHits;
+      }
       else
         baseCase = BaseCase(queryIndex, referenceNode.Point(0));
 
       // Save this evaluation.
-      referenceNode.Stat().LastDistance() = baseCase;
+      if (cacheInReference)
+        LastDistance(referenceNode.Stat(), referenceStats) = baseCase;
     }
 
     distance = SortPolicy::CombineBest(baseCase,
@@ -143,7 +225,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
   }
 
   // Compare against the best k'th distance for this query point so far.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = candidates->WorstDistance(queryIndex);
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ?
@@ -179,7 +261,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   const double distance = SortPolicy::ConvertToDistance(oldScore);
 
   // Just check the score again against the distances.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = candidates->WorstDistance(queryIndex);
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
@@ -307,6 +389,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     {
       // We already calculated it.
       baseCase = traversalInfo.LastBaseCase();
+      ++cacheHits;
     }
     else
     {
@@ -404,7 +487,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // Loop over points held in the node.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double distance = candidates[queryNode.Point(i)].top().first;
+    const double distance = candidates->WorstDistance(queryNode.Point(i));
     if (SortPolicy::IsBetter(worstDistance, distance))
       worstDistance = distance;
     if (SortPolicy::IsBetter(distance, bestPointDistance))
@@ -417,8 +500,10 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // assemble bounds.
   for (size_t i = 0; i < queryNode.NumChildren(); ++i)
   {
-    const double firstBound = queryNode.Child(i).Stat().FirstBound();
-    const double auxBound = queryNode.Child(i).Stat().AuxBound();
+    const double firstBound = FirstBound(queryNode.Child(i).Stat(),
+        queryStats);
+    const double auxBound = AuxBound(queryNode.Child(i).Stat(),
+        queryStats);
 
     if (SortPolicy::IsBetter(worstDistance, firstBound))
       worstDistance = firstBound;
@@ -450,28 +535,32 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
     // The parent's worst distance bound implies that the bound for this node
     // must be at least as good.  Thus, if the parent worst distance bound is
     // better, then take it.
-    if (SortPolicy::IsBetter(queryNode.Parent()->Stat().FirstBound(),
-        worstDistance))
-      worstDistance = queryNode.Parent()->Stat().FirstBound();
+    const double parentFirstBound = FirstBound(queryNode.Parent()->Stat(),
+        queryStats);
+    if (SortPolicy::IsBetter(parentFirstBound, worstDistance))
+      worstDistance = parentFirstBound;
 
     // The parent's best distance bound implies that the bound for this node
     // must be at least as good.  Thus, if the parent best distance bound is
     // better, then take it.
-    if (SortPolicy::IsBetter(queryNode.Parent()->Stat().SecondBound(),
-        bestDistance))
-      bestDistance = queryNode.Parent()->Stat().SecondBound();
+    const double parentSecondBound = SecondBound(queryNode.Parent()->Stat(),
+        queryStats);
+    if (SortPolicy::IsBetter(parentSecondBound, bestDistance))
+      bestDistance = parentSecondBound;
   }
 
   // Could the existing bounds be better?
-  if (SortPolicy::IsBetter(queryNode.Stat().FirstBound(), worstDistance))
-    worstDistance = queryNode.Stat().FirstBound();
-  if (SortPolicy::IsBetter(queryNode.Stat().SecondBound(), bestDistance))
-    bestDistance = queryNode.Stat().SecondBound();
+  double& nodeFirstBound = FirstBound(queryNode.Stat(), queryStats);
+  double& nodeSecondBound = SecondBound(queryNode.Stat(), queryStats);
+  if (SortPolicy::IsBetter(nodeFirstBound, worstDistance))
+    worstDistance = nodeFirstBound;
+  if (SortPolicy::IsBetter(nodeSecondBound, bestDistance))
+    bestDistance = nodeSecondBound;
 
   // Cache bounds for later.
-  queryNode.Stat().FirstBound() = worstDistance;
-  queryNode.Stat().SecondBound() = bestDistance;
-  queryNode.Stat().AuxBound() = auxDistance;
+  nodeFirstBound = worstDistance;
+  nodeSecondBound = bestDistance;
+  AuxBound(queryNode.Stat(), queryStats) = auxDistance;
 
   worstDistance = SortPolicy::Relax(worstDistance, epsilon);
 
@@ -499,14 +588,7 @@ InsertNeighbor(
     const size_t neighbor,
     const double distance)
 {
-  CandidateList& pqueue = candidates[queryIndex];
-  Candidate c = std::make_pair(distance, neighbor);
-
-  if (CandidateCmp()(c, pqueue.top()))
-  {
-    pqueue.pop();
-    pqueue.push(c);
-  }
+  candidates->Insert(queryIndex, neighbor, distance);
 }
 
 } // namespace neighbor
@@ -101,6 +101,88 @@ class NeighborSearchStat
   }
 };
 
+/**
+ * The statistics of every node of a tree whose nodes hold a
+ * tree::IndexedStatistic.  Every field is kept in its own array indexed by the
+ * index of the node, so the bounds that are updated together by Score() lie
+ * next to each other, and the nodes themselves stay small.
+ *
+ * @code
+ * typedef tree::KDTree<metric::EuclideanDistance, tree::IndexedStatistic,
+ *     arma::mat> TreeType;
+ * TreeType tree(dataset);
+ * NeighborSearchStatTable<NearestNeighborSort> table(tree::IndexNodes(&tree));
+ *
+ * NeighborSearchRules<NearestNeighborSort, metric::EuclideanDistance,
+ *     TreeType> rules(tree.Dataset(), tree.Dataset(), k, metric, 0, true);
+ * rules.QueryStats() = &table;
+ * rules.ReferenceStats() = &table;
+ * @endcode
+ */
+template<typename SortPolicy>
+class NeighborSearchStatTable
+{
+ public:
+  /**
+   * Create the statistics of the given number of nodes, initialized with the
+   * worst possible distance according to our sorting policy.
+   *
+   * @param nodes The number of nodes.
+   */
+  NeighborSearchStatTable(const size_t nodes = 0) { Resize(nodes); }
+
+  //! Change the number of nodes, and reset the statistics of every node.
+  void Resize(const size_t nodes)
+  {
+    firstBounds.resize(nodes);
+    secondBounds.resize(nodes);
+    auxBounds.resize(nodes);
+    lastDistances.resize(nodes);
+    Reset();
+  }
+
+  //! Reset the statistics of every node to their initial values.
+  void Reset()
+  {
+    std::fill(firstBounds.begin(), firstBounds.end(),
+        SortPolicy::WorstDistance());
+    std::fill(secondBounds.begin(), secondBounds.end(),
+        SortPolicy::WorstDistance());
+    std::fill(auxBounds.begin(), auxBounds.end(), SortPolicy::WorstDistance());
+    std::fill(lastDistances.begin(), lastDistances.end(), 0.0);
+  }
+
+  //! Get the number of nodes.
+  size_t Nodes() const { return firstBounds.size(); }
+
+  //! Get the first bound of the given node.
+  double FirstBound(const size_t node) const { return firstBounds[node]; }
+  //! Modify the first bound of the given node.
+  double& FirstBound(const size_t node) { return firstBounds[node]; }
+  //! Get the second bound of the given node.
+  double SecondBound(const size_t node) const { return secondBounds[node]; }
+  //! Modify the second bound of the given node.
+  double& SecondBound(const size_t node) { return secondBounds[node]; }
+  //! Get the aux bound of the given node.
+  double AuxBound(const size_t node) const { return auxBounds[node]; }
+  //! Modify the aux bound of the given node.
+  double& AuxBound(const size_t node) { return auxBounds[node]; }
+  //! Get the last distance calculation of the given node.
+  double LastDistance(const size_t node) const { return lastDistances[node]; }
+  //! Modify the last distance calculation of the given node.
+  double& LastDistance(const size_t node) { return lastDistances[node]; }
+
+ private:
+  //! The first bound of every node.
+  std::vector<double> firstBounds;
+  //! The second bound of every node.
+  std::vector<double> secondBounds;
+  //! The aux bound of every node.
+  std::vector<double> auxBounds;
+  //! The last distance evaluation of every node.
+  std::vector<double> lastDistances;
+};
+
 } // namespace neighbor
 } // namespace mlpack
 
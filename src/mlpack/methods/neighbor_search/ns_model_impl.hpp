@@ -33,14 +33,15 @@ void MonoSearchVisitor::operator()(NSType *ns) const
 }
 
 //! Save parameters for bichromatic neighbor search.
-template<typename SortPolicy>
-BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
-                                             const size_t k,
-                                             arma::Mat<size_t>& neighbors,
-                                             arma::mat& distances,
-                                             const size_t leafSize,
-                                             const double tau,
-                                             const double rho) :
+template<typename SortPolicy, typename MatType>
+BiSearchVisitor<SortPolicy, MatType>::BiSearchVisitor(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const size_t leafSize,
+    const double tau,
+    const double rho) :
     querySet(querySet),
     k(k),
     neighbors(neighbors),
@@ -51,11 +52,12 @@ BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
 {}
 
 //! Default Bichromatic neighbor search on the given NSType instance.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<TreeType>* ns) const
 {
   if (ns)
     return ns->Search(querySet, k, neighbors, distances);
@@ -63,8 +65,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType specialized for KDTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -72,8 +75,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType specialized for BallTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -81,8 +85,8 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
 }
 
 //! Bichromatic neighbor search specialized for SPTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(SpillKNN* ns) const
 {
   if (ns)
   {
@@ -102,8 +106,9 @@ void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
 }
 
 //! Bichromatic neighbor search specialized for octrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::Octree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -111,9 +116,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType considering the leafSize.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename NSType>
-void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
+void BiSearchVisitor<SortPolicy, MatType>::SearchLeaf(NSType* ns) const
 {
   if (ns->SearchMode() == DUAL_TREE_MODE)
   {
@@ -139,11 +144,11 @@ void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
 }
 
 //! Save parameters for Train.
-template<typename SortPolicy>
-TrainVisitor<SortPolicy>::TrainVisitor(arma::mat&& referenceSet,
-                                       const size_t leafSize,
-                                       const double tau,
-                                       const double rho) :
+template<typename SortPolicy, typename MatType>
+TrainVisitor<SortPolicy, MatType>::TrainVisitor(MatType&& referenceSet,
+                                                const size_t leafSize,
+                                                const double tau,
+                                                const double rho) :
     referenceSet(std::move(referenceSet)),
     leafSize(leafSize),
     tau(tau),
@@ -151,11 +156,11 @@ TrainVisitor<SortPolicy>::TrainVisitor(arma::mat&& referenceSet,
 {}
 
 //! Default Train on the given NSType instance.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+void TrainVisitor<SortPolicy, MatType>::operator()(NSTypeT<TreeType>* ns) const
 {
   if (ns)
     return ns->Train(std::move(referenceSet));
@@ -163,8 +168,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
 }
 
 //! Train on the given NSType specialized for KDTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -172,8 +178,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
 }
 
 //! Train on the given NSType specialized for BallTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -181,8 +188,8 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
 }
 
 //! Train specialized for SPTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(SpillKNN* ns) const
 {
   if (ns)
   {
@@ -199,8 +206,9 @@ void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
 }
 
 //! Train specialized for Octrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::Octree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -208,9 +216,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
 }
 
 //! Train on the given NSType considering the leafSize.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename NSType>
-void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
+void TrainVisitor<SortPolicy, MatType>::TrainLeaf(NSType* ns) const
 {
   if (ns->SearchMode() == NAIVE_MODE)
     ns->Train(std::move(referenceSet));
@@ -221,7 +229,7 @@ void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
         oldFromNewReferences, leafSize);
     ns->Train(std::move(referenceTree));
     // Set the mappings.
-    ns->oldFromNewReferences = std::move(oldFromNewReferences);
+    ns->OldFromNewReferences() = std::move(oldFromNewReferences);
   }
 }
 
@@ -244,8 +252,9 @@ double& EpsilonVisitor::operator()(NSType* ns) const
 }
 
 //! Expose the referenceSet of the given NSType.
+template<typename MatType>
 template<typename NSType>
-const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
+const MatType& ReferenceSetVisitor<MatType>::operator()(NSType* ns) const
 {
   if (ns)
     return ns->ReferenceSet();
@@ -265,12 +274,15 @@ void DeleteVisitor::operator()(NSType* ns) const
  * basis should be used.
  */
 template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
+NSModel<SortPolicy>::NSModel(TreeTypes treeType,
+                             bool randomBasis,
+                             bool singlePrecision) :
     treeType(treeType),
     leafSize(20),
     tau(0),
     rho(0.7),
-    randomBasis(randomBasis)
+    randomBasis(randomBasis),
+    singlePrecision(singlePrecision)
 {
   // Nothing to do.
 }
@@ -283,7 +295,9 @@ NSModel<SortPolicy>::NSModel(const NSModel& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(other.q),
-    nSearch(other.nSearch)
+    singlePrecision(other.singlePrecision),
+    nSearch(other.nSearch),
+    nSearchFloat(other.nSearchFloat)
 {
   // Nothing to do.
 }
@@ -296,7 +310,9 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    nSearch(other.nSearch)
+    singlePrecision(other.singlePrecision),
+    nSearch(other.nSearch),
+    nSearchFloat(other.nSearchFloat)
 {
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -304,13 +320,15 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   other.tau = 0;
   other.rho = 0.7;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.nSearch = decltype(other.nSearch)();
+  other.nSearchFloat = decltype(other.nSearchFloat)();
 }
 
 template<typename SortPolicy>
 NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
 {
-  boost::apply_visitor(DeleteVisitor(), nSearch);
+  CleanMemory();
 
   treeType = other.treeType;
   leafSize = other.leafSize;
@@ -318,7 +336,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
   rho = other.rho;
   randomBasis = other.randomBasis;
   q = other.q;
+  singlePrecision = other.singlePrecision;
   nSearch = other.nSearch;
+  nSearchFloat = other.nSearchFloat;
 
   return *this;
 }
@@ -326,7 +346,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
 template<typename SortPolicy>
 NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
 {
-  boost::apply_visitor(DeleteVisitor(), nSearch);
+  CleanMemory();
 
   treeType = other.treeType;
   leafSize = other.leafSize;
@@ -334,8 +354,10 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   rho = other.rho;
   randomBasis = other.randomBasis;
   q = std::move(other.q);
+  singlePrecision = other.singlePrecision;
   // Copy the pointer and type.
   nSearch = other.nSearch;
+  nSearchFloat = other.nSearchFloat;
 
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -343,7 +365,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   other.tau = 0;
   other.rho = 0.7;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.nSearch = decltype(other.nSearch)();
+  other.nSearchFloat = decltype(other.nSearchFloat)();
 
   return *this;
 }
@@ -352,7 +376,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
 template<typename SortPolicy>
 NSModel<SortPolicy>::~NSModel()
 {
-  boost::apply_visitor(DeleteVisitor(), nSearch);
+  CleanMemory();
 }
 
 //! Serialize the kNN model.
@@ -372,24 +396,62 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
 
+  // Older versions of NSModel only held double precision models.
+  if (version > 1)
+    ar & BOOST_SERIALIZATION_NVP(singlePrecision);
+  else if (Archive::is_loading::value)
+    singlePrecision = false;
+
   // This should never happen, but just in case, be clean with memory.
   if (Archive::is_loading::value)
-    boost::apply_visitor(DeleteVisitor(), nSearch);
+    CleanMemory();
 
-  ar & BOOST_SERIALIZATION_NVP(nSearch);
+  if (singlePrecision)
+    ar & BOOST_SERIALIZATION_NVP(nSearchFloat);
+  else
+    ar & BOOST_SERIALIZATION_NVP(nSearch);
 }
 
 //! Expose the dataset.
 template<typename SortPolicy>
 const arma::mat& NSModel<SortPolicy>::Dataset() const
 {
-  return boost::apply_visitor(ReferenceSetVisitor(), nSearch);
+  if (singlePrecision)
+    throw std::runtime_error("NSModel::Dataset(): the model is single "
+        "precision; use FloatDataset()");
+  return boost::apply_visitor(ReferenceSetVisitor<>(), nSearch);
+}
+
+//! Expose the dataset of a single precision model.
+template<typename SortPolicy>
+const arma::fmat& NSModel<SortPolicy>::FloatDataset() const
+{
+  if (!singlePrecision)
+    throw std::runtime_error("NSModel::FloatDataset(): the model is not "
+        "single precision; use Dataset()");
+  return boost::apply_visitor(ReferenceSetVisitor<arma::fmat>(), nSearchFloat);
+}
+
+//! Get the dimensionality of the reference set.
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::Dimensionality() const
+{
+  return singlePrecision ? FloatDataset().n_rows : Dataset().n_rows;
+}
+
+//! Get the number of points in the reference set.
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::NumReferencePoints() const
+{
+  return singlePrecision ? FloatDataset().n_cols : Dataset().n_cols;
 }
 
 //! Access the search mode.
 template<typename SortPolicy>
 NeighborSearchMode NSModel<SortPolicy>::SearchMode() const
 {
+  if (singlePrecision)
+    return boost::apply_visitor(SearchModeVisitor(), nSearchFloat);
   return boost::apply_visitor(SearchModeVisitor(), nSearch);
 }
 
@@ -397,18 +459,24 @@ NeighborSearchMode NSModel<SortPolicy>::SearchMode() const
 template<typename SortPolicy>
 NeighborSearchMode& NSModel<SortPolicy>::SearchMode()
 {
+  if (singlePrecision)
+    return boost::apply_visitor(SearchModeVisitor(), nSearchFloat);
   return boost::apply_visitor(SearchModeVisitor(), nSearch);
 }
 
 template<typename SortPolicy>
 double NSModel<SortPolicy>::Epsilon() const
 {
+  if (singlePrecision)
+    return boost::apply_visitor(EpsilonVisitor(), nSearchFloat);
   return boost::apply_visitor(EpsilonVisitor(), nSearch);
 }
 
 template<typename SortPolicy>
 double& NSModel<SortPolicy>::Epsilon()
 {
+  if (singlePrecision)
+    return boost::apply_visitor(EpsilonVisitor(), nSearchFloat);
   return boost::apply_visitor(EpsilonVisitor(), nSearch);
 }
 
@@ -419,6 +487,15 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
                                      const NeighborSearchMode searchMode,
                                      const double epsilon)
 {
+  if (singlePrecision && treeType != KD_TREE && treeType != BALL_TREE &&
+      treeType != VP_TREE && treeType != RP_TREE && treeType != MAX_RP_TREE &&
+      treeType != UB_TREE)
+  {
+    throw std::invalid_argument("NSModel::BuildModel(): single precision is "
+        "only supported for kd-trees, ball trees, vantage point trees, random "
+        "projection trees and UB trees");
+  }
+
   this->leafSize = leafSize;
   // Initialize random basis if necessary.
   if (randomBasis)
@@ -453,7 +530,7 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   }
 
   // Clean memory, if necessary.
-  boost::apply_visitor(DeleteVisitor(), nSearch);
+  CleanMemory();
 
   // Do we need to modify the reference set?
   if (randomBasis)
@@ -465,6 +542,54 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
     Log::Info << "Building reference tree..." << std::endl;
   }
 
+  if (singlePrecision)
+  {
+    switch (treeType)
+    {
+      case KD_TREE:
+        nSearchFloat = new NSType<SortPolicy, tree::KDTree, arma::fmat>(
+            searchMode, epsilon);
+        break;
+      case BALL_TREE:
+        nSearchFloat = new NSType<SortPolicy, tree::BallTree, arma::fmat>(
+            searchMode, epsilon);
+        break;
+      case VP_TREE:
+        nSearchFloat = new NSType<SortPolicy, tree::VPTree, arma::fmat>(
+            searchMode, epsilon);
+        break;
+      case RP_TREE:
+        nSearchFloat = new NSType<SortPolicy, tree::RPTree, arma::fmat>(
+            searchMode, epsilon);
+        break;
+      case MAX_RP_TREE:
+        nSearchFloat = new NSType<SortPolicy, tree::MaxRPTree, arma::fmat>(
+            searchMode, epsilon);
+        break;
+      default:
+        nSearchFloat = new NSType<SortPolicy, tree::UBTree, arma::fmat>(
+            searchMode, epsilon);
+        break;
+    }
+
+    // Convert the reference set, and release the double precision copy before
+    // the tree is built.
+    arma::fmat floatReferenceSet =
+        arma::conv_to<arma::fmat>::from(referenceSet);
+    referenceSet.reset();
+
+    TrainVisitor<SortPolicy, arma::fmat> tn(std::move(floatReferenceSet),
+        leafSize, tau, rho);
+    boost::apply_visitor(tn, nSearchFloat);
+
+    if (searchMode != NAIVE_MODE)
+    {
+      Timer::Stop("tree_building");
+      Log::Info << "Tree built." << std::endl;
+    }
+    return;
+  }
+
   switch (treeType)
   {
     case KD_TREE:
@@ -556,6 +681,17 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
       break;
   }
 
+  if (singlePrecision)
+  {
+    arma::fmat floatQuerySet = arma::conv_to<arma::fmat>::from(querySet);
+    querySet.reset();
+
+    BiSearchVisitor<SortPolicy, arma::fmat> search(floatQuerySet, k, neighbors,
+        distances, leafSize, tau, rho);
+    boost::apply_visitor(search, nSearchFloat);
+    return;
+  }
+
   BiSearchVisitor<SortPolicy> search(querySet, k, neighbors, distances,
       leafSize, tau, rho);
   boost::apply_visitor(search, nSearch);
@@ -591,7 +727,10 @@ void NSModel<SortPolicy>::Search(const size_t k,
         << std::endl;
 
   MonoSearchVisitor search(k, neighbors, distances);
-  boost::apply_visitor(search, nSearch);
+  if (singlePrecision)
+    boost::apply_visitor(search, nSearchFloat);
+  else
+    boost::apply_visitor(search, nSearch);
 }
 
 //! Get the name of the tree type.
@@ -635,6 +774,16 @@ std::string NSModel<SortPolicy>::TreeName() const
   }
 }
 
+//! Clean memory, if necessary.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::CleanMemory()
+{
+  boost::apply_visitor(DeleteVisitor(), nSearch);
+  boost::apply_visitor(DeleteVisitor(), nSearchFloat);
+  nSearch = decltype(nSearch)();
+  nSearchFloat = decltype(nSearchFloat)();
+}
+
 } // namespace neighbor
 } // namespace mlpack
 
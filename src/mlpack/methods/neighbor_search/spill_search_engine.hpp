@@ -0,0 +1,133 @@
+/**
+ * @file spill_search_engine.hpp
+ *
+ * Defines the SpillSearchEngine class, which answers batches of approximate
+ * nearest neighbor queries with defeatist search on a hybrid spill tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_SEARCH_ENGINE_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_SEARCH_ENGINE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/spill_tree.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include "neighbor_search_stat.hpp"
+#include "sort_policies/nearest_neighbor_sort.hpp"
+
+#include <unordered_map>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The SpillSearchEngine class answers batches of approximate k-nearest-neighbor
+ * queries (with the Euclidean distance) on a hybrid spill tree.  Every query
+ * is routed to a single leaf by the splitting hyperplanes, as defeatist search
+ * does on overlapping nodes, but without backtracking on the other nodes.  The
+ * queries are routed in parallel and then grouped by leaf, so the reference
+ * points of every leaf are compared against all of its queries at once, with a
+ * single matrix product; the leaves are handled in parallel.
+ *
+ * The reference points of every leaf are copied into a contiguous block, with
+ * their squared norms, when the engine is created.  This takes as much memory
+ * as the points held by the leaves of the tree (which is more than the
+ * reference set if the tree has overlapping nodes).
+ *
+ * The results are approximate: the neighbors of a query are the exact nearest
+ * neighbors among the points of its leaf.  A larger tau or leaf size increases
+ * the recall.  If the leaf holds fewer than k points, the remaining neighbors
+ * are set to size_t() - 1, with distance DBL_MAX.  Search() does not modify the
+ * engine, so it may be called concurrently.
+ *
+ * @code
+ * SpillSearchEngine<> engine(std::move(referenceSet), 0.1, 100);
+ *
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * engine.Search(queries, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The type of spill tree to use (SPTree or MeanSPTree).
+ */
+template<typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::SPTree>
+class SpillSearchEngine
+{
+ public:
+  //! The type of the reference tree.
+  typedef TreeType<metric::EuclideanDistance,
+                   NeighborSearchStat<NearestNeighborSort>,
+                   MatType> Tree;
+  //! The element type of the data.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the engine by building a spill tree on the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param tau Overlapping size of the spill tree.
+   * @param maxLeafSize Maximum number of points in a leaf of the tree.
+   * @param rho Balance threshold of the spill tree.
+   */
+  SpillSearchEngine(MatType referenceSet,
+                    const double tau = 0,
+                    const size_t maxLeafSize = 20,
+                    const double rho = 0.7);
+
+  //! The leaves are identified by their address, so the engine can't be
+  //! copied.
+  SpillSearchEngine(const SpillSearchEngine&) = delete;
+  //! The leaves are identified by their address, so the engine can't be
+  //! copied.
+  SpillSearchEngine& operator=(const SpillSearchEngine&) = delete;
+
+  /**
+   * For each point in the query set, compute the approximate nearest neighbors
+   * and store the output in the given matrices.  The matrices will be set to
+   * the size of k x [number of query points].
+   *
+   * @param querySet Set of query points (can be just one point).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Access the reference tree.
+  const Tree& ReferenceTree() const { return referenceTree; }
+
+  //! Get the number of leaves of the reference tree.
+  size_t NumLeaves() const { return leafPoints.size(); }
+
+ private:
+  //! The reference tree.  It is mutable because routing a point through it
+  //! needs a non-const tree, but routing does not modify it.
+  mutable Tree referenceTree;
+  //! The index of every leaf of the tree.
+  std::unordered_map<const Tree*, size_t> leafIndices;
+  //! The reference points of every leaf, one per column.
+  std::vector<MatType> leafPoints;
+  //! The squared norm of every reference point of every leaf.
+  std::vector<arma::Col<ElemType>> leafNorms;
+  //! The index of every reference point of every leaf in the reference set.
+  std::vector<arma::Col<size_t>> leafReferences;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "spill_search_engine_impl.hpp"
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * @file spill_search_engine_impl.hpp
+ *
+ * Implementation of SpillSearchEngine.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_SEARCH_ENGINE_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SPILL_SEARCH_ENGINE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "spill_search_engine.hpp"
+
+#include <stack>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+SpillSearchEngine<MatType, TreeType>::SpillSearchEngine(
+    MatType referenceSet,
+    const double tau,
+    const size_t maxLeafSize,
+    const double rho) :
+    referenceTree(std::move(referenceSet), tau, maxLeafSize, rho)
+{
+  // Copy the points of every leaf into a contiguous block.
+  std::stack<Tree*> nodes;
+  nodes.push(&referenceTree);
+  while (!nodes.empty())
+  {
+    Tree* node = nodes.top();
+    nodes.pop();
+
+    if (!node->IsLeaf())
+    {
+      nodes.push(node->Right());
+      nodes.push(node->Left());
+      continue;
+    }
+
+    leafIndices[node] = leafPoints.size();
+
+    MatType points(referenceTree.Dataset().n_rows, node->NumPoints());
+    arma::Col<size_t> references(node->NumPoints());
+    for (size_t i = 0; i < node->NumPoints(); ++i)
+    {
+      references[i] = node->Point(i);
+      points.col(i) = referenceTree.Dataset().col(node->Point(i));
+    }
+
+    leafNorms.push_back(arma::sum(arma::square(points), 0).t());
+    leafPoints.push_back(std::move(points));
+    leafReferences.push_back(std::move(references));
+  }
+}
+
+template<typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void SpillSearchEngine<MatType, TreeType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  if (querySet.n_rows != referenceTree.Dataset().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "SpillSearchEngine::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << referenceTree.Dataset().n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(size_t() - 1);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(DBL_MAX);
+  if (k == 0 || querySet.n_cols == 0)
+    return;
+
+  // Route every query to a leaf.
+  std::vector<size_t> queryLeaves(querySet.n_cols);
+  Threads::ParallelFor(0, querySet.n_cols, [&](const size_t i)
+  {
+    Tree* node = &referenceTree;
+    while (!node->IsLeaf())
+    {
+      node = (node->GetNearestChild(querySet.col(i)) == 0) ? node->Left() :
+          node->Right();
+    }
+
+    queryLeaves[i] = leafIndices.at(node);
+  });
+
+  // Group the queries by leaf with a counting sort.
+  std::vector<size_t> leafBegins(leafPoints.size() + 1, 0);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    ++leafBegins[queryLeaves[i] + 1];
+  for (size_t l = 0; l < leafPoints.size(); ++l)
+    leafBegins[l + 1] += leafBegins[l];
+
+  std::vector<size_t> order(querySet.n_cols);
+  std::vector<size_t> next(leafBegins.begin(), leafBegins.end() - 1);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    order[next[queryLeaves[i]]++] = i;
+
+  std::vector<size_t> activeLeaves;
+  for (size_t l = 0; l < leafPoints.size(); ++l)
+    if (leafBegins[l + 1] > leafBegins[l] && leafPoints[l].n_cols > 0)
+      activeLeaves.push_back(l);
+
+  Threads::ParallelFor(0, activeLeaves.size(), [&](const size_t a)
+  {
+    const size_t l = activeLeaves[a];
+    const size_t begin = leafBegins[l];
+    const size_t count = leafBegins[l + 1] - begin;
+    const MatType& points = leafPoints[l];
+
+    MatType queries(querySet.n_rows, count);
+    for (size_t j = 0; j < count; ++j)
+      queries.col(j) = querySet.col(order[begin + j]);
+
+    // All squared distances of the leaf at once:
+    // ||r - q||^2 = ||r||^2 + ||q||^2 - 2 r^T q.
+    const arma::Mat<ElemType> products = points.t() * queries;
+
+    const size_t found = std::min(k, (size_t) points.n_cols);
+    std::vector<std::pair<ElemType, size_t>> candidates(points.n_cols);
+    for (size_t j = 0; j < count; ++j)
+    {
+      const ElemType queryNorm = arma::dot(queries.col(j), queries.col(j));
+      for (size_t r = 0; r < points.n_cols; ++r)
+      {
+        candidates[r] = std::make_pair(std::max(ElemType(0),
+            leafNorms[l][r] + queryNorm - 2 * products(r, j)), r);
+      }
+
+      std::partial_sort(candidates.begin(), candidates.begin() + found,
+          candidates.end());
+
+      const size_t query = order[begin + j];
+      for (size_t c = 0; c < found; ++c)
+      {
+        neighbors(c, query) = leafReferences[l][candidates[c].second];
+        distances(c, query) = std::sqrt((double) candidates[c].first);
+      }
+    }
+  });
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
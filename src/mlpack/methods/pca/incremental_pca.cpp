@@ -0,0 +1,121 @@
+/**
+ * @file incremental_pca.cpp
+ *
+ * Implementation of incremental PCA.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "incremental_pca.hpp"
+
+using namespace mlpack;
+using namespace mlpack::pca;
+
+IncrementalPCA::IncrementalPCA(const size_t rank) :
+    rank(rank),
+    count(0)
+{
+  // Nothing to do.
+}
+
+void IncrementalPCA::Update(const arma::mat& data)
+{
+  if (data.n_cols == 0)
+    return;
+
+  const arma::vec chunkMean = arma::mean(data, 1);
+  arma::mat centered = data;
+  centered.each_col() -= chunkMean;
+
+  Combine(data.n_cols, chunkMean, centered);
+}
+
+void IncrementalPCA::Merge(const IncrementalPCA& other)
+{
+  if (other.count == 0)
+    return;
+
+  arma::mat factors = other.components;
+  factors.each_row() %= other.singularValues.t();
+
+  Combine(other.count, other.mean, factors);
+}
+
+void IncrementalPCA::Apply(const arma::mat& data,
+                           arma::mat& transformedData) const
+{
+  if (data.n_rows != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "IncrementalPCA::Apply(): the points have " << data.n_rows
+        << " dimensions, but the statistics have " << mean.n_elem << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat centered = data;
+  centered.each_col() -= mean;
+  transformedData = components.t() * centered;
+}
+
+arma::vec IncrementalPCA::EigenValues() const
+{
+  if (count < 2)
+    return arma::zeros<arma::vec>(singularValues.n_elem);
+
+  return arma::square(singularValues) / (count - 1);
+}
+
+void IncrementalPCA::Combine(const size_t otherCount,
+                             const arma::vec& otherMean,
+                             const arma::mat& otherFactors)
+{
+  if (count > 0 && otherMean.n_elem != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "IncrementalPCA: cannot combine points with " << otherMean.n_elem
+        << " dimensions with statistics of " << mean.n_elem << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t k = singularValues.n_elem;
+  const size_t m = otherFactors.n_cols;
+  arma::mat combined(otherMean.n_elem, k + m + (count > 0 ? 1 : 0));
+
+  // The scatter of the union is the sum of the two scatters and the scatter
+  // of the two means, weighted by the number of points.
+  if (k > 0)
+  {
+    combined.cols(0, k - 1) = components;
+    combined.cols(0, k - 1).each_row() %= singularValues.t();
+  }
+  if (m > 0)
+    combined.cols(k, k + m - 1) = otherFactors;
+
+  const double total = (double) count + (double) otherCount;
+  if (count > 0)
+  {
+    combined.col(k + m) = std::sqrt((double) count * (double) otherCount /
+        total) * (mean - otherMean);
+    mean = (count * mean + otherCount * otherMean) / total;
+  }
+  else
+  {
+    mean = otherMean;
+  }
+  count += otherCount;
+
+  // Only the left singular vectors are needed.
+  arma::mat u, v;
+  arma::vec s;
+  if (!arma::svd_econ(u, s, v, combined, "left"))
+  {
+    Log::Fatal << "IncrementalPCA: SVD failed!" << std::endl;
+  }
+
+  const size_t keep = (rank == 0) ? (size_t) s.n_elem :
+      std::min(rank, (size_t) s.n_elem);
+  components = u.head_cols(keep);
+  singularValues = s.head(keep);
+}
@@ -0,0 +1,165 @@
+/**
+ * @file incremental_pca.hpp
+ *
+ * Incremental PCA, which accumulates the mean and a low-rank factorization of
+ * the centered data one chunk at a time, and can merge the results computed on
+ * different shards of a dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_INCREMENTAL_PCA_HPP
+#define MLPACK_METHODS_PCA_INCREMENTAL_PCA_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/chunked_reader.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * This class computes the principal components of a dataset that is given one
+ * chunk at a time, without ever holding (a centered copy of) the full dataset.
+ * The sufficient statistics are the number of points, their mean, and the
+ * leading left singular vectors and singular values of the centered data.  A
+ * chunk is folded in with one thin SVD of the current factors, the centered
+ * chunk and a mean correction, as described in the following paper:
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title={Incremental Learning for Robust Visual Tracking},
+ *   author={Ross, D.A. and Lim, J. and Lin, R.-S. and Yang, M.-H.},
+ *   journal={International Journal of Computer Vision},
+ *   volume={77},
+ *   number={1--3},
+ *   pages={125--141},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Two of these objects, trained on different parts of a dataset (for instance
+ * by different threads or on different nodes), can be combined with Merge() in
+ * the same way.  If the rank is at least the dimensionality of the data the
+ * result is exact; otherwise only the given number of components is kept after
+ * each update, like in the randomized and QUIC-SVD policies of PCA.
+ *
+ * @code
+ * std::vector<IncrementalPCA> partial(numShards, IncrementalPCA(rank));
+ *
+ * #pragma omp parallel for
+ * for (int i = 0; i < numShards; ++i)
+ *   partial[i].Update(shards[i]);
+ *
+ * for (int i = 1; i < numShards; ++i)
+ *   partial[0].Merge(partial[i]);
+ *
+ * arma::mat transformed;
+ * partial[0].Apply(data, transformed);
+ * @endcode
+ */
+class IncrementalPCA
+{
+ public:
+  /**
+   * Create the incremental PCA object.
+   *
+   * @param rank Number of components to keep (0 means the dimensionality of
+   *     the data, which makes the result exact).
+   */
+  IncrementalPCA(const size_t rank = 0);
+
+  /**
+   * Fold the given chunk of points (one per column) into the statistics.
+   *
+   * @param data Chunk of points.
+   */
+  void Update(const arma::mat& data);
+
+  /**
+   * Fold every remaining chunk of the given reader into the statistics.
+   *
+   * @param reader Reader to take the chunks from.
+   */
+  template<typename eT>
+  void Update(data::ChunkedReader<eT>& reader)
+  {
+    arma::Mat<eT> chunk;
+    while (reader.NextChunk(chunk))
+      Update(arma::conv_to<arma::mat>::from(chunk));
+  }
+
+  /**
+   * Fold the statistics of another incremental PCA object (computed on other
+   * points of the same dimensionality) into this one.
+   *
+   * @param other Statistics to merge.
+   */
+  void Merge(const IncrementalPCA& other);
+
+  /**
+   * Project the given points onto the principal components computed so far.
+   * It is safe to pass the same matrix reference for both data and
+   * transformedData.
+   *
+   * @param data Points to project.
+   * @param transformedData Matrix to store the projected points in.
+   */
+  void Apply(const arma::mat& data, arma::mat& transformedData) const;
+
+  //! Get the number of components to keep (0 means all of them).
+  size_t Rank() const { return rank; }
+
+  //! Get the number of points seen so far.
+  size_t Count() const { return count; }
+
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+
+  //! Get the principal components (eigenvectors), one per column.
+  const arma::mat& EigenVectors() const { return components; }
+
+  //! Get the singular values of the centered data.
+  const arma::vec& SingularValues() const { return singularValues; }
+
+  //! Get the eigenvalues of the covariance matrix, in descending order.
+  arma::vec EigenValues() const;
+
+  //! Serialize the statistics.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(rank);
+    ar & BOOST_SERIALIZATION_NVP(count);
+    ar & BOOST_SERIALIZATION_NVP(mean);
+    ar & BOOST_SERIALIZATION_NVP(components);
+    ar & BOOST_SERIALIZATION_NVP(singularValues);
+  }
+
+ private:
+  /**
+   * Merge the statistics of otherCount points with the given mean, whose
+   * centered data is factorized by otherFactors (that is, the centered data is
+   * otherFactors times some matrix with orthonormal rows).
+   */
+  void Combine(const size_t otherCount,
+               const arma::vec& otherMean,
+               const arma::mat& otherFactors);
+
+  //! Number of components to keep.
+  size_t rank;
+  //! Number of points seen so far.
+  size_t count;
+  //! Mean of the points seen so far.
+  arma::vec mean;
+  //! Left singular vectors of the centered data.
+  arma::mat components;
+  //! Singular values of the centered data.
+  arma::vec singularValues;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
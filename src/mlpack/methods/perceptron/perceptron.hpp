@@ -26,6 +26,14 @@ namespace perceptron {
  * network).  It converges if the supplied training dataset is linearly
  * separable.
  *
+ * By default, the points are visited one at a time and the weights are updated
+ * after each misclassified point.  If BatchSize() is larger than 1, the points
+ * are instead scored in blocks of BatchSize() points with one matrix
+ * multiplication (split across threads; see Threads), and the weights are
+ * updated for every misclassified point of the block after the whole block is
+ * scored.  If Average() is true, the final weights are the average of the
+ * weights after each point (or block), which makes the averaged perceptron.
+ *
  * @tparam LearnPolicy Options of SimpleWeightUpdate and GradientDescent.
  * @tparam WeightInitializationPolicy Option of ZeroInitialization and
  *      RandomInitialization.
@@ -127,6 +135,16 @@ class Perceptron
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of points scored together during training.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points scored together during training.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get whether the averaged perceptron is trained.
+  bool Average() const { return average; }
+  //! Modify whether the averaged perceptron is trained.
+  bool& Average() { return average; }
+
   //! Get the number of classes this perceptron has been trained for.
   size_t NumClasses() const { return weights.n_cols; }
 
@@ -144,6 +162,12 @@ class Perceptron
   //! The maximum number of iterations during training.
   size_t maxIterations;
 
+  //! The number of points scored together during training.
+  size_t batchSize;
+
+  //! Whether the averaged perceptron is trained.
+  bool average;
+
   /**
    * Stores the weights for each of the input class labels.  Each column
    * corresponds to the weights for one class label, and each row corresponds to
@@ -154,6 +178,20 @@ class Perceptron
 
   //! The biases for each class.
   arma::vec biases;
+
+  /**
+   * Compute the scores weights^T x + biases of the given columns of data, in
+   * parallel blocks of columns.
+   *
+   * @param data Dataset.
+   * @param begin Index of the first column to score.
+   * @param count Number of columns to score.
+   * @param scores Matrix to store the scores in (numClasses x count).
+   */
+  void Scores(const MatType& data,
+              const size_t begin,
+              const size_t count,
+              arma::mat& scores) const;
 };
 
 } // namespace perceptron
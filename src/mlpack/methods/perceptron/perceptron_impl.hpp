@@ -30,7 +30,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const size_t dimensionality,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(1),
+    average(false)
 {
   WeightInitializationPolicy wip;
   wip.Initialize(weights, biases, dimensionality, numClasses);
@@ -56,7 +58,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(1),
+    average(false)
 {
   // Start training.
   Train(data, labels, numClasses);
@@ -84,7 +88,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const arma::rowvec& instanceWeights) :
-    maxIterations(other.maxIterations)
+    maxIterations(other.maxIterations),
+    batchSize(other.batchSize),
+    average(other.average)
 {
   Train(data, labels, numClasses, instanceWeights);
 }
@@ -106,14 +112,14 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
+  arma::mat scores;
+  Scores(test, 0, test.n_cols, scores);
 
-  // Could probably be faster if done in batch.
+  predictedLabels.set_size(test.n_cols);
+  arma::uword maxIndex = 0;
   for (size_t i = 0; i < test.n_cols; i++)
   {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
+    scores.col(i).max(maxIndex);
     predictedLabels(0, i) = maxIndex;
   }
 }
@@ -145,15 +151,25 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
     wip.Initialize(weights, biases, data.n_rows, numClasses);
   }
 
-  size_t j, i = 0;
+  size_t i = 0;
   bool converged = false;
-  size_t tempLabel;
-  arma::uword maxIndexRow = 0, maxIndexCol = 0;
-  arma::mat tempLabelMat;
+  arma::uword maxIndex = 0;
+  arma::mat scores;
 
   LearnPolicy LP;
 
   const bool hasWeights = (instanceWeights.n_elem > 0);
+  const size_t blockSize = std::max(batchSize, (size_t) 1);
+
+  // For the averaged perceptron, the sum of the weights after each step.
+  arma::mat weightsSum;
+  arma::vec biasesSum;
+  size_t numSteps = 0;
+  if (average)
+  {
+    weightsSum.zeros(arma::size(weights));
+    biasesSum.zeros(arma::size(biases));
+  }
 
   while ((i < maxIterations) && (!converged))
   {
@@ -162,34 +178,78 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
     i++;
     converged = true;
 
-    // Now this inner loop is for going through the dataset in each iteration.
-    for (j = 0; j < data.n_cols; j++)
+    // Now this inner loop is for going through the dataset in each iteration,
+    // one block of points at a time.
+    for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
     {
-      // Multiply for each variable and check whether the current weight vector
-      // correctly classifies this.
-      tempLabelMat = weights.t() * data.col(j) + biases;
+      const size_t count = std::min(blockSize, (size_t) data.n_cols - begin);
 
-      tempLabelMat.max(maxIndexRow, maxIndexCol);
+      // Score the block and check whether the current weights correctly
+      // classify each point.
+      Scores(data, begin, count, scores);
+      for (size_t k = 0; k < count; ++k)
+      {
+        const size_t j = begin + k;
+        scores.col(k).max(maxIndex);
+
+        // Check whether prediction is correct.
+        if (maxIndex != labels(0, j))
+        {
+          // Due to incorrect prediction, convergence set to false.
+          converged = false;
+
+          // Send maxIndex for knowing which weight to update, send j to know
+          // the value of the vector to update it with.  Send labels(0, j) to
+          // know the correct class.
+          if (hasWeights)
+            LP.UpdateWeights(data.col(j), weights, biases, maxIndex,
+                labels(0, j), instanceWeights(j));
+          else
+            LP.UpdateWeights(data.col(j), weights, biases, maxIndex,
+                labels(0, j));
+        }
+      }
 
-      // Check whether prediction is correct.
-      if (maxIndexRow != labels(0, j))
+      if (average)
       {
-        // Due to incorrect prediction, convergence set to false.
-        converged = false;
-        tempLabel = labels(0, j);
-
-        // Send maxIndexRow for knowing which weight to update, send j to know
-        // the value of the vector to update it with.  Send tempLabel to know
-        // the correct class.
-        if (hasWeights)
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow, tempLabel,
-              instanceWeights(j));
-        else
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
-              tempLabel);
+        weightsSum += weights;
+        biasesSum += biases;
+        ++numSteps;
       }
     }
   }
+
+  if (average && numSteps > 0)
+  {
+    weights = weightsSum / numSteps;
+    biases = biasesSum / numSteps;
+  }
+}
+
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Scores(
+    const MatType& data,
+    const size_t begin,
+    const size_t count,
+    arma::mat& scores) const
+{
+  // Each block is large enough for an efficient matrix multiplication.
+  const size_t scoreBlockSize = 256;
+  const size_t numBlocks = (count + scoreBlockSize - 1) / scoreBlockSize;
+
+  scores.set_size(weights.n_cols, count);
+  Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    const size_t first = block * scoreBlockSize;
+    const size_t last = std::min(first + scoreBlockSize, count) - 1;
+    scores.cols(first, last) = weights.t() * data.cols(begin + first,
+        begin + last);
+    scores.cols(first, last).each_col() += biases;
+  });
 }
 
 //! Serialize the perceptron.
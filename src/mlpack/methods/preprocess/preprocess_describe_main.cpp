@@ -12,6 +12,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/chunked_reader.hpp>
+#include <mlpack/core/math/descriptive_statistics.hpp>
 
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
@@ -37,6 +39,14 @@ PROGRAM_INFO("Descriptive Statistics", "This utility takes a dataset and "
     "dataset should be considered as a population.  Otherwise, the dataset "
     "will be considered as a sample."
     "\n\n"
+    "The statistics are computed in a single parallel pass over the data.  "
+    "Instead of " + PRINT_PARAM_STRING("input") + ", the " +
+    PRINT_PARAM_STRING("input_stream") + " parameter can name a file that is "
+    "read in chunks of " + PRINT_PARAM_STRING("chunk_size") + " points, so "
+    "the dataset does not need to fit in memory.  The median is approximated "
+    "with a quantile sketch, unless " + PRINT_PARAM_STRING("exact") + " is "
+    "specified, in which case every value is kept in memory."
+    "\n\n"
     "So, a simple example where we want to print out statistical facts about "
     "the dataset " + PRINT_DATASET("X") + " using the default settings, we "
     "could run "
@@ -50,7 +60,13 @@ PROGRAM_INFO("Descriptive Statistics", "This utility takes a dataset and "
         "verbose", true));
 
 // Define parameters for data.
-PARAM_MATRIX_IN_REQ("input", "Matrix containing data,", "i");
+PARAM_MATRIX_IN("input", "Matrix containing data,", "i");
+PARAM_STRING_IN("input_stream", "File containing data, which is read in "
+    "chunks (instead of input).", "s", "");
+PARAM_INT_IN("chunk_size", "Number of points read at a time from "
+    "input_stream.", "c", 65536);
+PARAM_FLAG("exact", "If specified, compute the median exactly, keeping every "
+    "value in memory, instead of approximating it.", "e");
 PARAM_INT_IN("dimension", "Dimension of the data. Use this to specify a "
     "dimension", "d", 0);
 PARAM_INT_IN("precision", "Precision of the output statistics.", "p", 4);
@@ -62,91 +78,12 @@ PARAM_FLAG("row_major", "If specified, the program will calculate statistics "
     "across rows, not across columns.  (Remember that in mlpack, a column "
     "represents a point, so this option is generally not necessary.)", "r");
 
-/**
- * Calculates the sum of deviations to the Nth Power.
- *
- * @param input Vector that captures a dimension of a dataset.
- * @param rowMean Mean of the given vector.
- * @param n Degree of power.
- * @return sum of nth power deviations.
- */
-double SumNthPowerDeviations(const arma::rowvec& input,
-                             const double& fMean,
-                             size_t n)
-{
-  return arma::sum(arma::pow(input - fMean, static_cast<double>(n)));
-}
-
-/**
- * Calculates Skewness of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Skewness of the given vector.
- */
-double Skewness(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double skewness = 0;
-  const double S3 = pow(fStd, 3);
-  const double M3 = SumNthPowerDeviations(input, fMean, 3);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population skewness
-    skewness = M3 / (n * S3);
-  }
-  else
-  {
-    // Calculate sample skewness.
-    skewness = n * M3 / ((n - 1) * (n - 2) * S3);
-  }
-  return skewness;
-}
-
-/**
- * Calculates excess kurtosis of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Kurtosis of the given vector.
- */
-double Kurtosis(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double kurtosis = 0;
-  const double M4 = SumNthPowerDeviations(input, fMean, 4);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population excess kurtosis.
-    const double M2 = SumNthPowerDeviations(input, fMean, 2);
-    kurtosis = n * (M4 / pow(M2, 2)) - 3;
-  }
-  else
-  {
-    // Calculate sample excess kurtosis.
-    const double S4 = pow(fStd, 4);
-    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
-    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
-    const double normM = M4 / S4;
-    kurtosis = normC * normM - norm3;
-  }
-  return kurtosis;
-}
-
 /**
  * Calculates standard error of standard deviation.
  *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @return Standard error of the stanrdard devation of the given vector.
+ * @param size Number of values.
+ * @param fStd Standard Deviation of the values.
+ * @return Standard error of the stanrdard devation of the values.
  */
 double StandardError(const size_t size, const double& fStd)
 {
@@ -161,8 +98,17 @@ static void mlpackMain()
   const bool population = CLI::HasParam("population");
   const bool rowMajor = CLI::HasParam("row_major");
 
-  // Load the data.
-  arma::mat& data = CLI::GetParam<arma::mat>("input");
+  RequireOnlyOnePassed({ "input", "input_stream" }, true);
+  if (CLI::HasParam("input_stream"))
+  {
+    ReportIgnoredParam({{ "input_stream", true }}, "row_major");
+    RequireParamValue<int>("chunk_size", [](int x) { return x > 0; }, true,
+        "chunk size must be positive");
+  }
+  else
+  {
+    ReportIgnoredParam({{ "input", true }}, "chunk_size");
+  }
 
   // Generate boost format recipe.
   const string widthPrecision("%-" + to_string(width) + "." +
@@ -179,39 +125,69 @@ static void mlpackMain()
   }
 
   Timer::Start("statistics");
+
+  // Compute the statistics of every dimension in one pass.  In memory, only
+  // the requested dimension is used.
+  math::DescriptiveStatistics statistics;
+  size_t firstDimension = 0;
+  if (CLI::HasParam("input_stream"))
+  {
+    ChunkedReader<double> reader(CLI::GetParam<string>("input_stream"),
+        (size_t) CLI::GetParam<int>("chunk_size"));
+    statistics = math::DescriptiveStatistics(reader.Dimensionality(),
+        CLI::HasParam("exact"));
+
+    arma::mat chunk;
+    while (reader.NextChunk(chunk))
+      statistics.Add(chunk);
+  }
+  else
+  {
+    arma::mat& data = CLI::GetParam<arma::mat>("input");
+    arma::mat transposed;
+    if (rowMajor)
+      transposed = data.t();
+    const arma::mat& points = rowMajor ? transposed : data;
+    if (CLI::HasParam("dimension"))
+    {
+      statistics = math::DescriptiveStatistics(1, CLI::HasParam("exact"));
+      statistics.Add(points.row(dimension));
+      firstDimension = dimension;
+    }
+    else
+    {
+      statistics = math::DescriptiveStatistics(points.n_rows,
+          CLI::HasParam("exact"));
+      statistics.Add(points);
+    }
+  }
+
   // Print the headers.
   Log::Info << boost::format(stringFormat)
       % "dim" % "var" % "mean" % "std" % "median" % "min" % "max"
       % "range" % "skew" % "kurt" % "SE" << endl;
 
   // Lambda function to print out the results.
-  auto PrintStatResults = [&](size_t dim, bool rowMajor)
+  auto PrintStatResults = [&](const size_t dim, const size_t index)
   {
-    arma::rowvec feature;
-    if (rowMajor)
-      feature = arma::conv_to<arma::rowvec>::from(data.col(dim));
-    else
-      feature = data.row(dim);
-
     // f at the front of the variable names means "feature".
-    const double fMax = arma::max(feature);
-    const double fMin = arma::min(feature);
-    const double fMean = arma::mean(feature);
-    const double fStd = arma::stddev(feature, population);
+    const double fMax = statistics.Max(index);
+    const double fMin = statistics.Min(index);
+    const double fStd = statistics.StandardDeviation(index, population);
 
     // Print statistics of the given dimension.
     Log::Info << boost::format(numberFormat)
         % dim
-        % arma::var(feature, population)
-        % fMean
+        % statistics.Variance(index, population)
+        % statistics.Mean(index)
         % fStd
-        % arma::median(feature)
+        % statistics.Median(index)
         % fMin
         % fMax
         % (fMax - fMin) // range
-        % Skewness(feature, fStd, fMean, population)
-        % Kurtosis(feature, fStd, fMean, population)
-        % StandardError(feature.n_elem, fStd)
+        % statistics.Skewness(index, population)
+        % statistics.Kurtosis(index, population)
+        % StandardError(statistics.Count(), fStd)
         << endl;
   };
 
@@ -219,16 +195,14 @@ static void mlpackMain()
   // dimension. If a dimension is not specified, describe all dimensions.
   if (CLI::HasParam("dimension"))
   {
-    PrintStatResults(dimension, rowMajor);
+    if (dimension - firstDimension >= statistics.Dimensionality())
+      Log::Fatal << "Invalid dimension " << dimension << "!" << endl;
+    PrintStatResults(dimension, dimension - firstDimension);
   }
   else
   {
-    const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
-    for (size_t i = 0; i < dimensions; ++i)
-    {
-      PrintStatResults(i, rowMajor);
-    }
+    for (size_t i = 0; i < statistics.Dimensionality(); ++i)
+      PrintStatResults(i, i);
   }
   Timer::Stop("statistics");
 }
-
@@ -30,7 +30,10 @@ PROGRAM_INFO("Split Data", "This utility takes a dataset and optionally labels "
     "labels works the same way as splitting the data. The output training and "
     "test labels may be saved with the " +
     PRINT_PARAM_STRING("training_labels") + " and " +
-    PRINT_PARAM_STRING("test_labels") + " output parameters, respectively."
+    PRINT_PARAM_STRING("test_labels") + " output parameters, respectively.  "
+    "If " + PRINT_PARAM_STRING("stratify_data") + " is specified, the test "
+    "set holds the same fraction of the points of each class, so that the "
+    "class proportions are the same in both sets."
     "\n\n"
     "So, a simple example where we want to split the dataset " +
     PRINT_DATASET("X") + " into " + PRINT_DATASET("X_train") + " and " +
@@ -65,6 +68,8 @@ PARAM_DOUBLE_IN("test_ratio", "Ratio of test set; if not set,"
     "the ratio defaults to 0.2", "r", 0.2);
 
 PARAM_INT_IN("seed", "Random seed (0 for std::time(NULL)).", "s", 0);
+PARAM_FLAG("stratify_data", "Split each class of the labels with the test "
+    "ratio, so that both sets have the same class proportions.", "S");
 
 using namespace mlpack;
 using namespace mlpack::util;
@@ -98,6 +103,7 @@ static void mlpackMain()
   {
     ReportIgnoredParam({{ "input_labels", true }}, "training_labels");
     ReportIgnoredParam({{ "input_labels", true }}, "test_labels");
+    ReportIgnoredParam({{ "input_labels", true }}, "stratify_data");
   }
 
   // Check test_ratio.
@@ -121,7 +127,8 @@ static void mlpackMain()
         CLI::GetParam<arma::Mat<size_t>>("input_labels");
     arma::Row<size_t> labelsRow = labels.row(0);
 
-    const auto value = data::Split(data, labelsRow, testRatio);
+    const auto value = data::Split(data, labelsRow, testRatio,
+        CLI::HasParam("stratify_data"));
     Log::Info << "Training data contains " << get<0>(value).n_cols << " points."
         << endl;
     Log::Info << "Test data contains " << get<1>(value).n_cols << " points."
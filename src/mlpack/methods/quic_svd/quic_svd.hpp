@@ -49,6 +49,15 @@ namespace svd {
  * // Get the factorization in the constructor.
  * QUIC_SVD(data, u, v, sigma, epsilon, delta);
  * @endcode
+ *
+ * If the subspace has to be computed within a given time, the cosine tree can
+ * be grown under a sampling budget instead; the basis is then the best one
+ * found when the budget runs out.
+ *
+ * @code
+ * // Use at most 50 basis vectors, and spend at most 2 seconds on the tree.
+ * QUIC_SVD(data, u, v, sigma, epsilon, delta, 50, 2.0);
+ * @endcode
  */
 class QUIC_SVD
 {
@@ -66,13 +75,19 @@ class QUIC_SVD
    * @param sigma Diagonal matrix of singular values.
    * @param epsilon Error tolerance fraction for calculated subspace.
    * @param delta Cumulative probability for Monte Carlo error lower bound.
+   * @param maxBasisSize Maximum number of basis vectors of the subspace (0
+   *     means no limit).
+   * @param timeLimit Maximum number of seconds to spend building the cosine
+   *     tree (0 means no limit).
    */
   QUIC_SVD(const arma::mat& dataset,
            arma::mat& u,
            arma::mat& v,
            arma::mat& sigma,
            const double epsilon = 0.03,
-           const double delta = 0.1);
+           const double delta = 0.1,
+           const size_t maxBasisSize = 0,
+           const double timeLimit = 0.0);
 
   /**
    * This function uses the vector subspace created using a cosine tree to
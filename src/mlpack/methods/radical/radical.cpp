@@ -37,8 +37,12 @@ Radical::Radical(const double noiseStdDev,
 void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 {
   Timer::Start("radical_copy_and_perturb");
-  xNew = repmat(x, replicates, 1) + noiseStdDev * randn(replicates * x.n_rows,
-      x.n_cols);
+  // Fill the buffer in place, so that it is not reallocated for every pair of
+  // dimensions.
+  xNew.randn(replicates * x.n_rows, x.n_cols);
+  xNew *= noiseStdDev;
+  for (size_t r = 0; r < replicates; ++r)
+    xNew.rows(r * x.n_rows, (r + 1) * x.n_rows - 1) += x;
   Timer::Stop("radical_copy_and_perturb");
 }
 
@@ -46,15 +50,12 @@ void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 double Radical::Vasicek(vec& z) const
 {
   z = sort(z);
+  return SortedVasicek(z);
+}
 
-  // Apparently slower.
-  /*
-  vec logs = log(z.subvec(m, z.n_elem - 1) - z.subvec(0, z.n_elem - 1 - m));
-  //vec val = sum(log(z.subvec(m, nPoints - 1) - z.subvec(0, nPoints - 1 - m)));
-  return (double) sum(logs);
-  */
-
-  // Apparently faster.
+double Radical::SortedVasicek(const vec& z) const
+{
+  // Apparently faster than sum(log(...)) on subvectors.
   double sum = 0;
   uword range = z.n_elem - m;
   for (uword i = 0; i < range; i++)
@@ -65,32 +66,86 @@ double Radical::Vasicek(vec& z) const
   return sum;
 }
 
+double Radical::ProjectionEntropy(const mat& x,
+                                  const double a,
+                                  const double b,
+                                  uvec& order,
+                                  vec& z) const
+{
+  const size_t n = x.n_rows;
+  if (order.n_elem != n)
+  {
+    z = a * x.col(0) + b * x.col(1);
+    order = sort_index(z);
+    z = z.elem(order);
+    return SortedVasicek(z);
+  }
+
+  // Project the points in the sorted order of the previous angle.
+  const double* x0 = x.colptr(0);
+  const double* x1 = x.colptr(1);
+  z.set_size(n);
+  for (size_t k = 0; k < n; ++k)
+    z[k] = a * x0[order[k]] + b * x1[order[k]];
+
+  // The order is almost right, so insertion sort is fast; if there are too
+  // many inversions, fall back to a full sort.
+  const size_t maxMoves = 2 * n * (size_t) std::ceil(std::log2(n + 1.0));
+  size_t moves = 0;
+  for (size_t k = 1; k < n && moves <= maxMoves; ++k)
+  {
+    const double value = z[k];
+    const uword index = order[k];
+    size_t l = k;
+    while (l > 0 && z[l - 1] > value)
+    {
+      z[l] = z[l - 1];
+      order[l] = order[l - 1];
+      --l;
+    }
+    z[l] = value;
+    order[l] = index;
+    moves += k - l;
+  }
+
+  if (moves > maxMoves)
+  {
+    const uvec permutation = sort_index(z);
+    order = order.elem(permutation);
+    z = z.elem(permutation);
+  }
+
+  return SortedVasicek(z);
+}
 
 double Radical::DoRadical2D(const mat& matX)
 {
   CopyAndPerturb(perturbed, matX);
 
-  mat::fixed<2, 2> matJacobi;
+  // Each range of angles keeps its own sorted orders, so the ranges can be
+  // evaluated in parallel.
+  const size_t numRanges = std::max((size_t) 1, std::min(Threads::Count(),
+      angles));
+  const size_t rangeSize = (angles + numRanges - 1) / numRanges;
 
   vec values(angles);
-
-  for (size_t i = 0; i < angles; i++)
+  Threads::ParallelFor(0, numRanges, [&](const size_t r)
   {
-    const double theta = (i / (double) angles) * M_PI / 2.0;
-    const double cosTheta = cos(theta);
-    const double sinTheta = sin(theta);
-
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
-
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
-
-    values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
-  }
+    uvec order1, order2;
+    vec z;
+    const size_t end = std::min(angles, (r + 1) * rangeSize);
+    for (size_t i = r * rangeSize; i < end; i++)
+    {
+      const double theta = (i / (double) angles) * M_PI / 2.0;
+      const double cosTheta = cos(theta);
+      const double sinTheta = sin(theta);
+
+      // These are the columns of the rotated data perturbed * J, where
+      // J = [cos(theta), sin(theta); -sin(theta), cos(theta)].
+      values(i) = ProjectionEntropy(perturbed, cosTheta, -sinTheta, order1, z) +
+          ProjectionEntropy(perturbed, sinTheta, cosTheta, order2, z);
+    }
+  });
 
   uword indOpt = 0;
   values.min(indOpt); // we ignore the return value; we don't care about it
@@ -134,8 +189,6 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
 
   mat matYSubspace(nPoints, 2);
 
-  mat matJ = eye(nDims, nDims);
-
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
@@ -155,19 +208,12 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
         const double cosThetaOpt = cos(thetaOpt);
         const double sinThetaOpt = sin(thetaOpt);
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
-
-        matY *= matJ;
-
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+        // Multiplying by the Jacobi rotation only changes columns i and j of
+        // matY, so only those are computed.
+        matY.col(i) = cosThetaOpt * matYSubspace.col(0) -
+            sinThetaOpt * matYSubspace.col(1);
+        matY.col(j) = sinThetaOpt * matYSubspace.col(0) +
+            cosThetaOpt * matYSubspace.col(1);
       }
     }
   }
@@ -27,6 +27,11 @@ namespace radical {
  * The goal is to find a square unmixing matrix W such that Y = W X and
  * the rows of Y are independent components.
  *
+ * The angles of each two-dimensional search are split into ranges that are
+ * evaluated in parallel (see Threads).  Consecutive angles only rotate the
+ * data slightly, so within a range the sorted order of the projections at the
+ * previous angle is kept and repaired, instead of sorting from scratch.
+ *
  * For more details, see the following paper:
  *
  * @code
@@ -91,6 +96,13 @@ class Radical
   //! Two-dimensional version of RADICAL.
   double DoRadical2D(const arma::mat& matX);
 
+  //! Get the value of m used by Vasicek's m-spacing estimator (0 for the
+  //! default).
+  size_t M() const { return m; }
+  //! Modify the value of m used by Vasicek's m-spacing estimator (0 for the
+  //! default).
+  size_t& M() { return m; }
+
   //! Get the standard deviation of the additive Gaussian noise.
   double NoiseStdDev() const { return noiseStdDev; }
   //! Modify the standard deviation of the additive Gaussian noise.
@@ -131,8 +143,27 @@ class Radical
 
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
+
+  /**
+   * Estimate the entropy of the projection a * x.col(0) + b * x.col(1) with
+   * Vasicek's estimator.  The projection is computed in the given order of
+   * the points, which is then sorted (with insertion sort if it is almost
+   * sorted already) and kept for the next call.
+   *
+   * @param x Two-dimensional data, one point per row.
+   * @param a Coefficient of the first dimension.
+   * @param b Coefficient of the second dimension.
+   * @param order Order of the points; empty to sort from scratch.
+   * @param z Buffer for the sorted projection.
+   */
+  double ProjectionEntropy(const arma::mat& x,
+                           const double a,
+                           const double b,
+                           arma::uvec& order,
+                           arma::vec& z) const;
+
+  //! Vasicek's estimator of entropy, for a sorted sample.
+  double SortedVasicek(const arma::vec& z) const;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
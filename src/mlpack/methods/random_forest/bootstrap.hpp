@@ -13,6 +13,9 @@
 #ifndef MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 #define MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/binned_dataset.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -47,6 +50,66 @@ void Bootstrap(const MatType& dataset,
   }
 }
 
+/**
+ * Draw a bootstrap sample of the points of a dataset without copying them: the
+ * distinct points of the sample are stored in bootstrapPoints, and the number
+ * of times each of them was drawn (times its weight, if UseWeights is true) in
+ * bootstrapWeights.  A decision tree can be trained on the sample with
+ * DecisionTree::TrainSubset().
+ */
+template<bool UseWeights, typename WeightsType>
+void Bootstrap(const size_t numPoints,
+               const WeightsType& weights,
+               arma::uvec& bootstrapPoints,
+               arma::rowvec& bootstrapWeights)
+{
+  // Random sampling with replacement.
+  arma::uvec indices = arma::randi<arma::uvec>(numPoints,
+      arma::distr_param(0, numPoints - 1));
+  arma::Col<size_t> draws(numPoints, arma::fill::zeros);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    ++draws[indices[i]];
+
+  bootstrapPoints = arma::find(draws);
+  bootstrapWeights.set_size(bootstrapPoints.n_elem);
+  for (size_t i = 0; i < bootstrapPoints.n_elem; ++i)
+  {
+    bootstrapWeights[i] = (double) draws[bootstrapPoints[i]];
+    if (UseWeights)
+      bootstrapWeights[i] *= weights[bootstrapPoints[i]];
+  }
+}
+
+/**
+ * Given a binned dataset, create another binned dataset (with the same bins)
+ * via bootstrap sampling, with labels.
+ */
+template<bool UseWeights,
+         typename LabelsType,
+         typename WeightsType>
+void Bootstrap(const BinnedDataset& dataset,
+               const LabelsType& labels,
+               const WeightsType& weights,
+               BinnedDataset& bootstrapDataset,
+               LabelsType& bootstrapLabels,
+               WeightsType& bootstrapWeights)
+{
+  // Random sampling with replacement.
+  arma::uvec indices = arma::randi<arma::uvec>(dataset.NumPoints(),
+      arma::distr_param(0, dataset.NumPoints() - 1));
+  dataset.Select(indices, bootstrapDataset);
+
+  bootstrapLabels.set_size(labels.n_elem);
+  if (UseWeights)
+    bootstrapWeights.set_size(weights.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    bootstrapLabels[i] = labels[indices[i]];
+    if (UseWeights)
+      bootstrapWeights[i] = weights[indices[i]];
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
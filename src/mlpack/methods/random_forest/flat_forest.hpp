@@ -0,0 +1,194 @@
+/**
+ * @file flat_forest.hpp
+ *
+ * A trained decision tree or random forest flattened into contiguous arrays,
+ * for fast batch classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The FlatForest holds the nodes of a trained DecisionTree or RandomForest in
+ * contiguous arrays: for each node, the dimension it splits on, its threshold
+ * and the index of its first child (the children of a node are consecutive),
+ * and for each leaf, its class probabilities.  The nodes of each tree are
+ * stored level by level.  The trees must use BestBinaryNumericSplit and
+ * AllCategoricalSplit.
+ *
+ * Batches of points are classified one block of points at a time: all the
+ * points of a block go down each tree together, one level at a time, so the
+ * top levels of the tree stay in cache and the descents of the different points
+ * are independent.  The blocks are classified in parallel when OpenMP is
+ * available.  The predictions and probabilities are the same as the ones of
+ * the original model.
+ *
+ * @code
+ * extern RandomForest<> forest;
+ * extern arma::mat data;
+ *
+ * FlatForest flatForest(forest);
+ * arma::Row<size_t> predictions;
+ * flatForest.Classify(data, predictions);
+ * @endcode
+ */
+class FlatForest
+{
+ public:
+  /**
+   * Create an empty flat forest.  Classify() will throw an exception until a
+   * trained model is flattened into it.
+   */
+  FlatForest() : numClasses(0), roots(0), depths(0) { }
+
+  /**
+   * Flatten the given trained decision tree.
+   *
+   * @param tree Decision tree to flatten.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           typename ElemType,
+           bool NoRecursion>
+  FlatForest(const DecisionTree<FitnessFunction,
+                                NumericSplitType,
+                                CategoricalSplitType,
+                                DimensionSelectionType,
+                                ElemType,
+                                NoRecursion>& tree);
+
+  /**
+   * Flatten the given trained random forest.
+   *
+   * @param forest Random forest to flatten.
+   */
+  template<typename FitnessFunction,
+           typename DimensionSelectionType,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename ElemType>
+  FlatForest(const RandomForest<FitnessFunction,
+                                DimensionSelectionType,
+                                NumericSplitType,
+                                CategoricalSplitType,
+                                ElemType>& forest);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.
+   *
+   * @param data Dataset to classify.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities for each point.
+   *
+   * @param data Dataset to classify.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.n_elem; }
+  //! Get the number of nodes of all the trees.
+  size_t NumNodes() const { return types.n_elem; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Serialize the flat forest.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numClasses);
+    ar & BOOST_SERIALIZATION_NVP(roots);
+    ar & BOOST_SERIALIZATION_NVP(depths);
+    ar & BOOST_SERIALIZATION_NVP(types);
+    ar & BOOST_SERIALIZATION_NVP(dimensions);
+    ar & BOOST_SERIALIZATION_NVP(thresholds);
+    ar & BOOST_SERIALIZATION_NVP(next);
+    ar & BOOST_SERIALIZATION_NVP(leafProbabilities);
+  }
+
+ private:
+  //! The kinds of nodes.
+  enum NodeType : unsigned char
+  {
+    LEAF,
+    NUMERIC,
+    CATEGORICAL
+  };
+
+  //! The number of points that go down the trees together.
+  static const size_t BlockSize = 64;
+
+  /**
+   * Append the nodes of the given trained decision tree.
+   */
+  template<typename TreeType>
+  void AddTree(const TreeType& tree);
+
+  //! Get the node a point at the given node goes to (itself for leaves).
+  template<typename VecType>
+  size_t Next(const size_t node, const VecType& point) const
+  {
+    const double value = (double) point[dimensions[node]];
+    if (types[node] == NUMERIC)
+      return next[node] + (value <= thresholds[node] ? 0 : 1);
+    else if (types[node] == CATEGORICAL)
+      return next[node] + (size_t) value;
+    else
+      return node;
+  }
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The root node of each tree.
+  arma::Col<size_t> roots;
+  //! The number of levels of internal nodes of each tree.
+  arma::Col<size_t> depths;
+  //! The kind of each node.
+  arma::Col<unsigned char> types;
+  //! The dimension each internal node splits on.
+  arma::Col<size_t> dimensions;
+  //! The threshold of each numeric node.
+  arma::vec thresholds;
+  //! The first child of each internal node, or the leaf index of each leaf.
+  arma::Col<size_t> next;
+  //! The class probabilities of each leaf (one column per leaf).
+  arma::mat leafProbabilities;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
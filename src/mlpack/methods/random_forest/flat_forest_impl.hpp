@@ -0,0 +1,215 @@
+/**
+ * @file flat_forest_impl.hpp
+ *
+ * Implementation of the flattening of trained decision trees and random
+ * forests, and of the batch classification of the flattened model.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+FlatForest::FlatForest(const DecisionTree<FitnessFunction,
+                                          NumericSplitType,
+                                          CategoricalSplitType,
+                                          DimensionSelectionType,
+                                          ElemType,
+                                          NoRecursion>& tree) :
+    numClasses(tree.NumClasses()),
+    roots(0),
+    depths(0)
+{
+  static_assert(std::is_same<NumericSplitType<FitnessFunction>,
+      BestBinaryNumericSplit<FitnessFunction>>::value,
+      "FlatForest requires BestBinaryNumericSplit!");
+  static_assert(std::is_same<CategoricalSplitType<FitnessFunction>,
+      AllCategoricalSplit<FitnessFunction>>::value,
+      "FlatForest requires AllCategoricalSplit!");
+
+  AddTree(tree);
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+FlatForest::FlatForest(const RandomForest<FitnessFunction,
+                                          DimensionSelectionType,
+                                          NumericSplitType,
+                                          CategoricalSplitType,
+                                          ElemType>& forest) :
+    numClasses(0),
+    roots(0),
+    depths(0)
+{
+  static_assert(std::is_same<NumericSplitType<FitnessFunction>,
+      BestBinaryNumericSplit<FitnessFunction>>::value,
+      "FlatForest requires BestBinaryNumericSplit!");
+  static_assert(std::is_same<CategoricalSplitType<FitnessFunction>,
+      AllCategoricalSplit<FitnessFunction>>::value,
+      "FlatForest requires AllCategoricalSplit!");
+
+  if (forest.NumTrees() > 0)
+    numClasses = forest.Tree(0).NumClasses();
+
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i));
+}
+
+template<typename TreeType>
+void FlatForest::AddTree(const TreeType& tree)
+{
+  // Collect the nodes level by level; the children of each node are then
+  // consecutive.
+  std::vector<const TreeType*> nodes(1, &tree);
+  std::vector<size_t> levels(1, 0);
+  size_t depth = 0;
+  size_t numLeaves = 0;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (nodes[i]->NumChildren() == 0)
+    {
+      ++numLeaves;
+      continue;
+    }
+
+    depth = std::max(depth, levels[i] + 1);
+    for (size_t j = 0; j < nodes[i]->NumChildren(); ++j)
+    {
+      nodes.push_back(&nodes[i]->Child(j));
+      levels.push_back(levels[i] + 1);
+    }
+  }
+
+  const size_t offset = types.n_elem;
+  const size_t leafOffset = leafProbabilities.n_cols;
+  roots.resize(roots.n_elem + 1);
+  roots[roots.n_elem - 1] = offset;
+  depths.resize(depths.n_elem + 1);
+  depths[depths.n_elem - 1] = depth;
+
+  types.resize(offset + nodes.size());
+  dimensions.resize(offset + nodes.size());
+  thresholds.resize(offset + nodes.size());
+  next.resize(offset + nodes.size());
+  leafProbabilities.resize(numClasses, leafOffset + numLeaves);
+
+  size_t firstChild = offset + 1;
+  size_t leaf = leafOffset;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const TreeType& node = *nodes[i];
+    const size_t index = offset + i;
+    if (node.NumChildren() == 0)
+    {
+      types[index] = LEAF;
+      dimensions[index] = 0;
+      thresholds[index] = 0.0;
+      next[index] = leaf;
+      leafProbabilities.col(leaf++) = node.ClassProbabilities();
+      continue;
+    }
+
+    dimensions[index] = node.SplitDimension();
+    next[index] = firstChild;
+    firstChild += node.NumChildren();
+    if (node.SplitDimensionType() == data::Datatype::categorical)
+    {
+      types[index] = CATEGORICAL;
+      thresholds[index] = 0.0;
+    }
+    else
+    {
+      types[index] = NUMERIC;
+      thresholds[index] = node.ClassProbabilities()[0];
+    }
+  }
+}
+
+template<typename VecType>
+size_t FlatForest::Classify(const VecType& point) const
+{
+  arma::Row<size_t> predictions;
+  Classify(arma::mat(point), predictions);
+  return predictions[0];
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions,
+                          arma::mat& probabilities) const
+{
+  if (roots.n_elem == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatForest::Classify(): no trained model "
+        "flattened!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(numClasses, data.n_cols);
+
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t count = std::min(BlockSize, (size_t) data.n_cols - begin);
+    size_t nodes[BlockSize];
+    for (size_t t = 0; t < roots.n_elem; ++t)
+    {
+      for (size_t j = 0; j < count; ++j)
+        nodes[j] = roots[t];
+
+      // The points that reach a leaf early stay there.
+      for (size_t level = 0; level < depths[t]; ++level)
+      {
+        for (size_t j = 0; j < count; ++j)
+          nodes[j] = Next(nodes[j], data.col(begin + j));
+      }
+
+      for (size_t j = 0; j < count; ++j)
+        probabilities.col(begin + j) += leafProbabilities.col(next[nodes[j]]);
+    }
+
+    // Average the probabilities like RandomForest::Classify() does.
+    for (size_t j = 0; j < count; ++j)
+    {
+      probabilities.col(begin + j) /= roots.n_elem;
+      arma::uword maxIndex = 0;
+      probabilities.col(begin + j).max(maxIndex);
+      predictions[begin + j] = (size_t) maxIndex;
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
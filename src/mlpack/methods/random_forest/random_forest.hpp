@@ -201,6 +201,42 @@ class RandomForest
              const size_t numTrees = 50,
              const size_t minimumLeafSize = 20);
 
+  /**
+   * Train the random forest on the given labeled binned training data with the
+   * given number of trees.  Each tree is trained on a bootstrap sample of the
+   * binned data with DecisionTree::TrainBinned(), so the splits are found from
+   * histograms of the bins instead of by sorting the points.
+   *
+   * @param data Binned dataset to train on.
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   */
+  void TrainBinned(const BinnedDataset& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const size_t numTrees = 50,
+                   const size_t minimumLeafSize = 20);
+
+  /**
+   * Train the random forest on the given weighted labeled binned training data
+   * with the given number of trees.  See the unweighted overload for details.
+   *
+   * @param data Binned dataset to train on.
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param weights Weights (importances) of each point in the dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   */
+  void TrainBinned(const BinnedDataset& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const arma::rowvec& weights,
+                   const size_t numTrees = 50,
+                   const size_t minimumLeafSize = 20);
+
   /**
    * Predict the class of the given point.  If the random forest has not been
    * trained, this will throw an exception.
@@ -249,6 +285,33 @@ class RandomForest
                 arma::Row<size_t>& predictions,
                 arma::mat& probabilities) const;
 
+  /**
+   * Predict the classes of each point in the given sparse dataset.  The
+   * columns of the matrix are read directly, without making them dense.  If
+   * the random forest has not been trained, this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename eT>
+  void Classify(const arma::SpMat<eT>& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given sparse dataset, also
+   * returning the predicted class probabilities for each point.  The columns
+   * of the matrix are read directly, without making them dense.  If the random
+   * forest has not been trained, this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename eT>
+  void Classify(const arma::SpMat<eT>& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
   //! Access a tree in the forest.
   const DecisionTreeType& Tree(const size_t i) const { return trees[i]; }
   //! Modify a tree in the forest (be careful!).
@@ -289,6 +352,19 @@ class RandomForest
              const size_t numTrees,
              const size_t minimumLeafSize);
 
+  /**
+   * Perform the training of the decision trees on the binned data.  The
+   * template bool parameter controls whether or not the weights should be
+   * ignored.
+   */
+  template<bool UseWeights>
+  void TrainBinned(const BinnedDataset& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const arma::rowvec& weights,
+                   const size_t numTrees,
+                   const size_t minimumLeafSize);
+
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
 };
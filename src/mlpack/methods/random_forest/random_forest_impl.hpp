@@ -203,7 +203,7 @@ void RandomForest<
 {
   // Pass off to Train().
   data::DatasetInfo info; // Ignored by Train().
-  Train<false, true>(dataset, info, labels, numClasses, weights, numTrees,
+  Train<true, false>(dataset, info, labels, numClasses, weights, numTrees,
       minimumLeafSize);
 }
 
@@ -234,6 +234,56 @@ void RandomForest<
       minimumLeafSize);
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::TrainBinned(const BinnedDataset& dataset,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numTrees,
+               const size_t minimumLeafSize)
+{
+  // Pass off to TrainBinned().
+  arma::rowvec weights; // Ignored by TrainBinned().
+  TrainBinned<false>(dataset, labels, numClasses, weights, numTrees,
+      minimumLeafSize);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::TrainBinned(const BinnedDataset& dataset,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const arma::rowvec& weights,
+               const size_t numTrees,
+               const size_t minimumLeafSize)
+{
+  // Pass off to TrainBinned().
+  TrainBinned<true>(dataset, labels, numClasses, weights, numTrees,
+      minimumLeafSize);
+}
+
 template<
     typename FitnessFunction,
     typename DimensionSelectionType,
@@ -376,6 +426,77 @@ void RandomForest<
   }
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename eT>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Classify(const arma::SpMat<eT>& data,
+            arma::Row<size_t>& predictions) const
+{
+  // Check edge case.
+  if (trees.size() == 0)
+  {
+    predictions.clear();
+
+    throw std::invalid_argument("RandomForest::Classify(): no random forest "
+        "trained!");
+  }
+
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < data.n_cols; ++i)
+    predictions[i] = Classify(SparseColumn<eT>(data, i));
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename eT>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Classify(const arma::SpMat<eT>& data,
+            arma::Row<size_t>& predictions,
+            arma::mat& probabilities) const
+{
+  // Check edge case.
+  if (trees.size() == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("RandomForest::Classify(): no random forest "
+        "trained!");
+  }
+
+  probabilities.set_size(trees[0].NumClasses(), data.n_cols);
+  predictions.set_size(data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::vec probs = probabilities.unsafe_col(i);
+    Classify(SparseColumn<eT>(data, i), predictions[i], probs);
+  }
+}
+
 template<
     typename FitnessFunction,
     typename DimensionSelectionType,
@@ -432,10 +553,59 @@ void RandomForest<
   // Train each tree individually.
   trees.resize(numTrees); // This will fill the vector with untrained trees.
 
+  // The bootstrap samples are given to the trees as the indices of the
+  // distinct points drawn, weighted by the number of times they were drawn, so
+  // the dataset is never copied.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < numTrees; ++i)
+  {
+    arma::uvec bootstrapPoints;
+    arma::rowvec bootstrapWeights;
+    Bootstrap<UseWeights>(dataset.n_cols, weights, bootstrapPoints,
+        bootstrapWeights);
+
+    // Now build the decision tree.
+    if (UseDatasetInfo)
+    {
+      trees[i].TrainSubset(dataset, datasetInfo, bootstrapPoints, labels,
+          numClasses, bootstrapWeights, minimumLeafSize);
+    }
+    else
+    {
+      trees[i].TrainSubset(dataset, bootstrapPoints, labels, numClasses,
+          bootstrapWeights, minimumLeafSize);
+    }
+  }
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<bool UseWeights>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::TrainBinned(const BinnedDataset& dataset,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const arma::rowvec& weights,
+               const size_t numTrees,
+               const size_t minimumLeafSize)
+{
+  // Train each tree individually.
+  trees.resize(numTrees); // This will fill the vector with untrained trees.
+
   #pragma omp parallel for
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
-    MatType bootstrapDataset;
+    BinnedDataset bootstrapDataset;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
     Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
@@ -444,27 +614,13 @@ void RandomForest<
     // Now build the decision tree.
     if (UseWeights)
     {
-      if (UseDatasetInfo)
-      {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses, weights,
-            minimumLeafSize);
-      }
-      else
-      {
-        trees[i].Train(dataset, labels, numClasses, weights, minimumLeafSize);
-      }
+      trees[i].TrainBinned(bootstrapDataset, bootstrapLabels, numClasses,
+          bootstrapWeights, minimumLeafSize);
     }
     else
     {
-      if (UseDatasetInfo)
-      {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses,
-            minimumLeafSize);
-      }
-      else
-      {
-        trees[i].Train(dataset, labels, numClasses, minimumLeafSize);
-      }
+      trees[i].TrainBinned(bootstrapDataset, bootstrapLabels, numClasses,
+          minimumLeafSize);
     }
   }
 }
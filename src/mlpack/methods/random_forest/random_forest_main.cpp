@@ -172,7 +172,9 @@ static void mlpackMain()
 
     const size_t numClasses = arma::max(labels) + 1;
 
-    // Train the model.
+    // Train the model.  The bootstrap samples of the trees are drawn from the
+    // whole dataset, so with NUMA awareness it is spread over all the nodes.
+    Threads::Interleave(data);
     rfModel->rf.Train(data, labels, numClasses, numTrees, minimumLeafSize);
 
     // Did we want training accuracy?
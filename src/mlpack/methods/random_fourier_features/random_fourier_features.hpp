@@ -0,0 +1,167 @@
+/**
+ * @file random_fourier_features.hpp
+ *
+ * Random Fourier features: an explicit, randomized feature map whose inner
+ * products approximate a shift-invariant kernel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_HPP
+#define MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Draw the frequencies of the random Fourier features of the Gaussian kernel.
+ * Its spectral density is a normal distribution with variance 1 / mu^2 in
+ * each dimension.
+ *
+ * @param kernel Gaussian kernel to approximate.
+ * @param dimensionality Dimensionality of the input points.
+ * @param numFrequencies Number of frequencies to draw.
+ * @param frequencies Matrix to store the frequencies in, one per row.
+ */
+inline void SampleFourierFrequencies(const GaussianKernel& kernel,
+                                     const size_t dimensionality,
+                                     const size_t numFrequencies,
+                                     arma::mat& frequencies)
+{
+  frequencies = arma::randn<arma::mat>(numFrequencies, dimensionality) /
+      kernel.Bandwidth();
+}
+
+/**
+ * Draw the frequencies of the random Fourier features of the Laplacian kernel
+ * (which uses the Euclidean distance).  Its spectral density is a
+ * multivariate Cauchy distribution with scale 1 / mu, so each frequency is a
+ * normal vector divided by mu times the absolute value of a normal variable.
+ *
+ * @param kernel Laplacian kernel to approximate.
+ * @param dimensionality Dimensionality of the input points.
+ * @param numFrequencies Number of frequencies to draw.
+ * @param frequencies Matrix to store the frequencies in, one per row.
+ */
+inline void SampleFourierFrequencies(const LaplacianKernel& kernel,
+                                     const size_t dimensionality,
+                                     const size_t numFrequencies,
+                                     arma::mat& frequencies)
+{
+  frequencies = arma::randn<arma::mat>(numFrequencies, dimensionality);
+  const arma::vec scales = kernel.Bandwidth() *
+      arma::abs(arma::randn<arma::vec>(numFrequencies));
+  frequencies.each_col() /= scales;
+}
+
+/**
+ * Random Fourier features map each point x to
+ *
+ * @f[
+ * z(x) = \sqrt{1 / D} [\cos(W x); \sin(W x)],
+ * @f]
+ *
+ * where the D rows of W are drawn from the spectral density of a
+ * shift-invariant kernel K, so that z(x)^T z(y) is an unbiased estimate of
+ * K(x, y).  The map needs no training on the data: it is one matrix
+ * multiplication followed by elementwise cosines and sines, and each point is
+ * transformed independently, so large datasets can be transformed in chunks.
+ * The features can be passed to any linear method (for instance
+ * LinearRegression or LogisticRegression) to approximate the corresponding
+ * kernel method, and KernelPCA can use them through RandomFourierKernelRule.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{rahimi2008random,
+ *   title = {Random Features for Large-Scale Kernel Machines},
+ *   author = {Rahimi, Ali and Recht, Benjamin},
+ *   booktitle = {Advances in Neural Information Processing Systems 20},
+ *   pages = {1177--1184},
+ *   year = {2008}
+ * }
+ * @endcode
+ *
+ * @tparam KernelType Shift-invariant kernel to approximate (GaussianKernel or
+ *     LaplacianKernel; other kernels need an overload of
+ *     SampleFourierFrequencies()).
+ */
+template<typename KernelType>
+class RandomFourierFeatures
+{
+ public:
+  /**
+   * Create the feature map by drawing the given number of frequencies.  The
+   * map has twice as many features as frequencies (a cosine and a sine for
+   * each).
+   *
+   * @param dimensionality Dimensionality of the points to transform.
+   * @param numFrequencies Number of frequencies to draw.
+   * @param kernel Kernel to approximate.
+   */
+  RandomFourierFeatures(const size_t dimensionality,
+                        const size_t numFrequencies,
+                        const KernelType& kernel = KernelType());
+
+  /**
+   * Create an empty feature map; call Reset() or load a map before using it.
+   */
+  RandomFourierFeatures();
+
+  /**
+   * Draw new frequencies for the given dimensionality.
+   *
+   * @param dimensionality Dimensionality of the points to transform.
+   * @param numFrequencies Number of frequencies to draw.
+   */
+  void Reset(const size_t dimensionality, const size_t numFrequencies);
+
+  /**
+   * Map the given points (one per column) to their random Fourier features.
+   * The points are transformed in blocks, in parallel.
+   *
+   * @param data Points to transform.
+   * @param features Matrix to store the features in (2 * NumFrequencies() x
+   *     data.n_cols).
+   */
+  void Transform(const arma::mat& data, arma::mat& features) const;
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+
+  //! Get the frequencies, one per row.
+  const arma::mat& Frequencies() const { return frequencies; }
+
+  //! Get the dimensionality of the points the map transforms.
+  size_t Dimensionality() const { return frequencies.n_cols; }
+
+  //! Get the number of frequencies.
+  size_t NumFrequencies() const { return frequencies.n_rows; }
+
+  //! Get the number of features (twice the number of frequencies).
+  size_t NumFeatures() const { return 2 * frequencies.n_rows; }
+
+  //! Serialize the feature map.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The kernel to approximate.
+  KernelType kernel;
+  //! The frequencies, one per row.
+  arma::mat frequencies;
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "random_fourier_features_impl.hpp"
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file random_fourier_features_impl.hpp
+ *
+ * Implementation of the RandomFourierFeatures class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_fourier_features.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+template<typename KernelType>
+RandomFourierFeatures<KernelType>::RandomFourierFeatures(
+    const size_t dimensionality,
+    const size_t numFrequencies,
+    const KernelType& kernel) :
+    kernel(kernel)
+{
+  Reset(dimensionality, numFrequencies);
+}
+
+template<typename KernelType>
+RandomFourierFeatures<KernelType>::RandomFourierFeatures()
+{
+  // Nothing to do.
+}
+
+template<typename KernelType>
+void RandomFourierFeatures<KernelType>::Reset(const size_t dimensionality,
+                                              const size_t numFrequencies)
+{
+  if (numFrequencies == 0)
+  {
+    throw std::invalid_argument("RandomFourierFeatures::Reset(): the number "
+        "of frequencies must be positive");
+  }
+
+  SampleFourierFrequencies(kernel, dimensionality, numFrequencies,
+      frequencies);
+}
+
+template<typename KernelType>
+void RandomFourierFeatures<KernelType>::Transform(const arma::mat& data,
+                                                  arma::mat& features) const
+{
+  if (data.n_rows != frequencies.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "RandomFourierFeatures::Transform(): the points have "
+        << data.n_rows << " dimensions, but the feature map was built for "
+        << frequencies.n_cols << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t numFrequencies = frequencies.n_rows;
+  const double scale = std::sqrt(1.0 / numFrequencies);
+
+  // Each block is large enough for an efficient matrix multiplication, and
+  // small enough that the projections of a block stay in cache.
+  const size_t blockSize = 256;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  features.set_size(2 * numFrequencies, data.n_cols);
+  Threads::ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    const size_t begin = block * blockSize;
+    const size_t count = std::min(blockSize, (size_t) data.n_cols - begin);
+
+    // An alias of the columns of the block; no memory is copied.
+    const arma::mat dataBlock(const_cast<double*>(data.colptr(begin)),
+        data.n_rows, count, false, true);
+    const arma::mat projections = frequencies * dataBlock;
+
+    features.submat(0, begin, numFrequencies - 1, begin + count - 1) =
+        scale * arma::cos(projections);
+    features.submat(numFrequencies, begin, 2 * numFrequencies - 1,
+        begin + count - 1) = scale * arma::sin(projections);
+  });
+}
+
+template<typename KernelType>
+template<typename Archive>
+void RandomFourierFeatures<KernelType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(kernel);
+  ar & BOOST_SERIALIZATION_NVP(frequencies);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/lin_alg.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -158,26 +159,30 @@ class RandomizedSVD
     if (iteratedPower == 0)
       iteratedPower = rank + 2;
 
+    // The data is never centered explicitly: it is only used through the
+    // products below, which (for sparse data) are blocked and parallel and
+    // stream over the columns of the data.
+    const arma::vec mean = arma::vec(arma::mat(rowMean));
     arma::mat R, Q, Qdata;
 
     // Apply the centered data matrix to a random matrix, obtaining Q.
     if (data.n_cols >= data.n_rows)
     {
       R = arma::randn<arma::mat>(data.n_rows, iteratedPower);
-      Q = (data.t() * R) - arma::repmat(arma::trans(R.t() * rowMean),
-          data.n_cols, 1);
+      CenteredTransposeMultiply(data, mean, R, Q);
     }
     else
     {
       R = arma::randn<arma::mat>(data.n_cols, iteratedPower);
-      Q = (data * R) - (rowMean * (arma::ones(1, data.n_cols) * R));
+      CenteredMultiply(data, mean, R, Q);
     }
 
     // Form a matrix Q whose columns constitute a
     // well-conditioned basis for the columns of the earlier Q.
     if (maxIterations == 0)
     {
-      arma::qr_econ(Q, v, Q);
+      math::TSQR(Q, R, v);
+      Q = std::move(R);
     }
     else
     {
@@ -189,28 +194,29 @@ class RandomizedSVD
     {
       if (data.n_cols >= data.n_rows)
       {
-        Q = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
-        arma::lu(Q, v, Q);
-        Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
+        CenteredMultiply(data, mean, Q, Qdata);
+        arma::lu(Q, v, Qdata);
+        CenteredTransposeMultiply(data, mean, Q, Qdata);
       }
       else
       {
-        Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
-        arma::lu(Q, v, Q);
-        Q = (data * Q) - (rowMean * (arma::ones(1, data.n_cols) * Q));
+        CenteredTransposeMultiply(data, mean, Q, Qdata);
+        arma::lu(Q, v, Qdata);
+        CenteredMultiply(data, mean, Q, Qdata);
       }
 
       // Computing the LU decomposition is more efficient than computing the QR
       // decomposition, so we only use it in the last iteration, a pivoted QR
       // decomposition which renormalizes Q, ensuring that the columns of Q are
-      // orthonormal.
+      // orthonormal.  The QR decomposition of the tall matrix is computed in
+      // parallel blocks of rows.
       if (i < (maxIterations - 1))
       {
-        arma::lu(Q, v, Q);
+        arma::lu(Q, v, Qdata);
       }
       else
       {
-        arma::qr_econ(Q, v, Q);
+        math::TSQR(Qdata, Q, v);
       }
     }
 
@@ -219,14 +225,16 @@ class RandomizedSVD
     // applied to Q.
     if (data.n_cols >= data.n_rows)
     {
-      Qdata = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+      CenteredMultiply(data, mean, Q, Qdata);
       arma::svd_econ(u, s, v, Qdata);
       v = Q * v;
     }
     else
     {
-      Qdata = (Q.t() * data) - arma::repmat(Q.t() * rowMean, 1,  data.n_cols);
-      arma::svd_econ(u, s, v, Qdata);
+      // Qdata holds the transpose of Q^T (data - mean), so the roles of the
+      // singular vectors are swapped.
+      CenteredTransposeMultiply(data, mean, Q, Qdata);
+      arma::svd_econ(v, s, u, Qdata);
       u = Q * u;
     }
   }
@@ -247,6 +255,28 @@ class RandomizedSVD
   double& Epsilon() { return eps; }
 
  private:
+  //! Compute result = (data - mean * 1^T) * x.
+  template<typename MatType>
+  static void CenteredMultiply(const MatType& data,
+                               const arma::vec& mean,
+                               const arma::mat& x,
+                               arma::mat& result)
+  {
+    math::Multiply(data, x, result);
+    result -= mean * arma::sum(x, 0);
+  }
+
+  //! Compute result = (data - mean * 1^T)^T * x.
+  template<typename MatType>
+  static void CenteredTransposeMultiply(const MatType& data,
+                                        const arma::vec& mean,
+                                        const arma::mat& x,
+                                        arma::mat& result)
+  {
+    math::TransposeMultiply(data, x, result);
+    result.each_row() -= mean.t() * x;
+  }
+
   //! Locally stored size of the normalized power iterations.
   size_t iteratedPower;
 
@@ -22,6 +22,7 @@ namespace mlpack {
 namespace range /** Range-search routines. */ {
 
 //! Forward declaration.
+template<typename MatType>
 class TrainVisitor;
 
 /**
@@ -262,6 +263,96 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, and call function(queryIndex, referenceIndex, distance) for
+   * each result as soon as it is found, instead of storing the results.  The
+   * indices are those of the original query and reference sets.  This needs
+   * no memory for the results, so it is the way to go when they are only
+   * consumed once (e.g. to merge clusters or to accumulate a sum).
+   *
+   * The function is called from the searching thread, in no particular order.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param function Callable object to pass each result to.
+   */
+  template<typename FunctionType>
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              FunctionType function);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, and call function(queryIndex, referenceIndex, distance) for each
+   * result as soon as it is found, instead of storing the results.  A point is
+   * not returned in its own range.
+   *
+   * @param range Range of distances in which to search.
+   * @param function Callable object to pass each result to.
+   */
+  template<typename FunctionType>
+  void Search(const math::Range& range, FunctionType function);
+
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, returning the results in a compressed (CSR) layout: the
+   * neighbors of query point i are neighbors[offsets[i]] to
+   * neighbors[offsets[i + 1] - 1], and their distances are at the same
+   * positions in distances.  Unlike the vector-of-vectors layout, this holds
+   * no per-query-point allocations.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param offsets Will hold the offset of the results of each query point
+   *      (querySet.n_cols + 1 elements).
+   * @param neighbors Will hold the neighbors of every query point.
+   * @param distances Will hold the distances of every query point.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, returning the results in a compressed (CSR) layout; see the overload
+   * that takes a query set.
+   *
+   * @param range Range of distances in which to search.
+   * @param offsets Will hold the offset of the results of each point.
+   * @param neighbors Will hold the neighbors of every point.
+   * @param distances Will hold the distances of every point.
+   */
+  void Search(const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Count the reference points in the given range of each point in the query
+   * set, without storing them.  The distances to the points of nodes that lie
+   * entirely inside the range are not computed.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param counts Will hold the number of reference points in the range of
+   *      each query point.
+   */
+  void Count(const MatType& querySet,
+             const math::Range& range,
+             arma::Col<size_t>& counts);
+
+  /**
+   * Count the points in the given range of each point in the reference set
+   * (not counting the point itself), without storing them.
+   *
+   * @param range Range of distances in which to search.
+   * @param counts Will hold the number of points in the range of each point.
+   */
+  void Count(const math::Range& range, arma::Col<size_t>& counts);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -312,7 +403,33 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  /**
+   * Search for the points in the given range of each query point, passing
+   * each result (with its original indices) to the given result object.
+   */
+  template<typename ResultType>
+  void SearchWith(const MatType& querySet,
+                  const math::Range& range,
+                  ResultType& results);
+
+  /**
+   * Search for the points in the given range of each reference point, passing
+   * each result (with its original indices) to the given result object.
+   */
+  template<typename ResultType>
+  void SearchWith(const math::Range& range, ResultType& results);
+
+  //! Sort results given in any order by query point into a CSR layout.
+  static void ToCSR(const size_t numQueries,
+                    const std::vector<size_t>& queries,
+                    const std::vector<size_t>& references,
+                    const std::vector<double>& resultDistances,
+                    arma::Col<size_t>& offsets,
+                    arma::Col<size_t>& neighbors,
+                    arma::vec& distances);
+
   //! For access to mappings when building models.
+  template<typename VisitorMatType>
   friend class TrainVisitor;
 };
 
@@ -273,177 +273,75 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     std::vector<std::vector<size_t>>& neighbors,
     std::vector<std::vector<double>>& distances)
 {
-  if (querySet.n_rows != referenceSet->n_rows)
-  {
-    std::ostringstream oss;
-    oss << "RangeSearch::Search(): dimensionalities of query set ("
-        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
-        << ") do not match!";
-    throw std::invalid_argument(oss.str());
-  }
-
-  // If there are no points, there is no search to be done.
-  if (referenceSet->n_cols == 0)
-    return;
-
-  Timer::Start("range_search/computing_neighbors");
-
-  // This will hold mappings for query points, if necessary.
-  std::vector<size_t> oldFromNewQueries;
-
-  // If we have built the trees ourselves, then we will have to map all the
-  // indices back to their original indices when this computation is finished.
-  // To avoid extra copies, we will store the unmapped neighbors and distances
-  // in a separate object.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<double>>* distancePtr = &distances;
-
-  // Mapping is only necessary if the tree rearranges points.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    // Query indices only need to be mapped if we are building the query tree
-    // ourselves.
-    if (!singleMode && !naive)
-    {
-      distancePtr = new std::vector<std::vector<double>>;
-      neighborPtr = new std::vector<std::vector<size_t>>;
-    }
-
-    // Reference indices only need to be mapped if we built the reference tree
-    // ourselves.
-    else if (treeOwner)
-      neighborPtr = new std::vector<std::vector<size_t>>;
-  }
-
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distancePtr->clear();
-  distancePtr->resize(querySet.n_cols);
-
-  // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-
-  // Reset counts.
-  baseCases = 0;
-  scores = 0;
-
-  if (naive)
-  {
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-
-    // The naive brute-force solution.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+  // Each result is added to the vector of its (original) query point as soon
+  // as it is found, so no temporary copy of the results is needed to map the
+  // indices.
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(querySet.n_cols);
+  distances.clear();
+  distances.resize(querySet.n_cols);
 
-    baseCases += (querySet.n_cols * referenceSet->n_cols);
-  }
-  else if (singleMode)
-  {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+  VectorRangeResults results(neighbors, distances);
+  SearchWith(querySet, range, results);
+}
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename FunctionType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    FunctionType function)
+{
+  FunctionRangeResults<FunctionType> results(function);
+  SearchWith(querySet, range, results);
+}
 
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
-  }
-  else // Dual-tree recursion.
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  // Collect the results in the order they are found, then sort them by query
+  // point.
+  std::vector<size_t> queries, references;
+  std::vector<double> resultDistances;
+  Search(querySet, range, [&](const size_t queryIndex,
+                              const size_t referenceIndex,
+                              const double distance)
   {
-    // Build the query tree.
-    Timer::Stop("range_search/computing_neighbors");
-    Timer::Start("range_search/tree_building");
-    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
-    Timer::Stop("range_search/tree_building");
-    Timer::Start("range_search/computing_neighbors");
-
-    // Create the traverser.
-    RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-        *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*queryTree, *referenceTree);
-
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
-
-    // Clean up tree memory.
-    delete queryTree;
-  }
+    queries.push_back(queryIndex);
+    references.push_back(referenceIndex);
+    resultDistances.push_back(distance);
+  });
 
-  Timer::Stop("range_search/computing_neighbors");
+  ToCSR(querySet.n_cols, queries, references, resultDistances, offsets,
+      neighbors, distances);
+}
 
-  // Map points back to original indices, if necessary.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    if (!singleMode && !naive && treeOwner)
-    {
-      // We must map both query and reference indices.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); i++)
-      {
-        // Map distances (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-
-        // Copy each neighbor individually, because we need to map it.
-        neighbors[queryMapping].resize(distances[queryMapping].size());
-        for (size_t j = 0; j < distances[queryMapping].size(); j++)
-          neighbors[queryMapping][j] =
-              oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (!singleMode && !naive)
-    {
-      // We must map query indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); ++i)
-      {
-        // Map distances and neighbors (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-        neighbors[queryMapping] = (*neighborPtr)[i];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (treeOwner)
-    {
-      // We must map reference indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < neighbors.size(); i++)
-      {
-        neighbors[i].resize((*neighborPtr)[i].size());
-        for (size_t j = 0; j < neighbors[i].size(); j++)
-          neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary object.
-      delete neighborPtr;
-    }
-  }
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  counts.zeros(querySet.n_cols);
+  CountRangeResults results(counts);
+  SearchWith(querySet, range, results);
 }
 
 template<typename MetricType,
@@ -497,6 +395,8 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   baseCases = rules.BaseCases();
   scores = rules.Scores();
+  WorkCounters::Add("range_search", baseCases, scores,
+      traverser.NumPrunes());
 
   // Do we need to map indices?
   if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
@@ -527,34 +427,201 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     std::vector<std::vector<size_t>>& neighbors,
     std::vector<std::vector<double>>& distances)
 {
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(referenceSet->n_cols);
+  distances.clear();
+  distances.resize(referenceSet->n_cols);
+
+  VectorRangeResults results(neighbors, distances);
+  SearchWith(range, results);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename FunctionType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    FunctionType function)
+{
+  FunctionRangeResults<FunctionType> results(function);
+  SearchWith(range, results);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  std::vector<size_t> queries, references;
+  std::vector<double> resultDistances;
+  Search(range, [&](const size_t queryIndex,
+                    const size_t referenceIndex,
+                    const double distance)
+  {
+    queries.push_back(queryIndex);
+    references.push_back(referenceIndex);
+    resultDistances.push_back(distance);
+  });
+
+  ToCSR(referenceSet->n_cols, queries, references, resultDistances, offsets,
+      neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  counts.zeros(referenceSet->n_cols);
+  CountRangeResults results(counts);
+  SearchWith(range, results);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultType>
+void RangeSearch<MetricType, MatType, TreeType>::SearchWith(
+    const MatType& querySet,
+    const math::Range& range,
+    ResultType& results)
+{
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Search(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
   // If there are no points, there is no search to be done.
   if (referenceSet->n_cols == 0)
     return;
 
   Timer::Start("range_search/computing_neighbors");
 
-  // Here, we will use the query set as the reference set.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<double>>* distancePtr = &distances;
+  // Reference indices only need to be mapped if we built the reference tree
+  // ourselves and it rearranges the points.
+  const std::vector<size_t>* referenceMapping =
+      (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset) ?
+      &oldFromNewReferences : NULL;
 
-  if (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner)
+  // The results are mapped to the original indices as they are found.
+  typedef MappedRangeResults<ResultType> MappedResultType;
+  typedef RangeSearchRules<MetricType, Tree, MappedResultType> RuleType;
+
+  // Reset counts.
+  baseCases = 0;
+  scores = 0;
+  size_t prunes = 0;
+
+  if (naive)
   {
-    // We will always need to rearrange in this case.
-    distancePtr = new std::vector<std::vector<double>>;
-    neighborPtr = new std::vector<std::vector<size_t>>;
+    MappedResultType mappedResults(results, NULL, referenceMapping);
+    RuleType rules(*referenceSet, querySet, range, mappedResults, metric);
+
+    // The naive brute-force solution.
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    baseCases += (querySet.n_cols * referenceSet->n_cols);
   }
+  else if (singleMode)
+  {
+    // Create the traverser.
+    MappedResultType mappedResults(results, NULL, referenceMapping);
+    RuleType rules(*referenceSet, querySet, range, mappedResults, metric);
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(referenceSet->n_cols);
-  distancePtr->clear();
-  distancePtr->resize(referenceSet->n_cols);
+    // Now have it traverse for each point.
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+    prunes += traverser.NumPrunes();
+  }
+  else // Dual-tree recursion.
+  {
+    // Build the query tree.
+    Timer::Stop("range_search/computing_neighbors");
+    Timer::Start("range_search/tree_building");
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    Timer::Stop("range_search/tree_building");
+    Timer::Start("range_search/computing_neighbors");
+
+    // Query indices need to be mapped if the query tree rearranged them.
+    MappedResultType mappedResults(results,
+        tree::TreeTraits<Tree>::RearrangesDataset ? &oldFromNewQueries : NULL,
+        referenceMapping);
+
+    // Create the traverser.
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, mappedResults,
+        metric);
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+    prunes += traverser.NumPrunes();
+
+    // Clean up tree memory.
+    delete queryTree;
+  }
+
+  WorkCounters::Add("range_search", baseCases, scores, prunes);
+  Timer::Stop("range_search/computing_neighbors");
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultType>
+void RangeSearch<MetricType, MatType, TreeType>::SearchWith(
+    const math::Range& range,
+    ResultType& results)
+{
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  Timer::Start("range_search/computing_neighbors");
+
+  // Here, we will use the query set as the reference set, so both query and
+  // reference indices need to be mapped if we built the tree ourselves.
+  const std::vector<size_t>* mapping =
+      (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset) ?
+      &oldFromNewReferences : NULL;
+  typedef MappedRangeResults<ResultType> MappedResultType;
+  MappedResultType mappedResults(results, mapping, mapping);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
+  typedef RangeSearchRules<MetricType, Tree, MappedResultType> RuleType;
+  RuleType rules(*referenceSet, *referenceSet, range, mappedResults, metric,
+      true /* don't return the query in the results */);
 
+  size_t prunes = 0;
   if (naive)
   {
     // The naive brute-force solution.
@@ -576,6 +643,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
     baseCases = rules.BaseCases();
     scores = rules.Scores();
+    prunes = traverser.NumPrunes();
   }
   else // Dual-tree recursion.
   {
@@ -586,35 +654,43 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
     baseCases = rules.BaseCases();
     scores = rules.Scores();
+    prunes = traverser.NumPrunes();
   }
 
+  WorkCounters::Add("range_search", baseCases, scores, prunes);
   Timer::Stop("range_search/computing_neighbors");
+}
 
-  // Do we need to map the reference indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::ToCSR(
+    const size_t numQueries,
+    const std::vector<size_t>& queries,
+    const std::vector<size_t>& references,
+    const std::vector<double>& resultDistances,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  // Count the results of each query point.
+  offsets.zeros(numQueries + 1);
+  for (size_t i = 0; i < queries.size(); ++i)
+    ++offsets[queries[i] + 1];
+  for (size_t i = 0; i < numQueries; ++i)
+    offsets[i + 1] += offsets[i];
+
+  // Place each result; the results of each query point keep their order.
+  arma::Col<size_t> next = offsets.head(numQueries);
+  neighbors.set_size(queries.size());
+  distances.set_size(queries.size());
+  for (size_t i = 0; i < queries.size(); ++i)
   {
-    neighbors.clear();
-    neighbors.resize(referenceSet->n_cols);
-    distances.clear();
-    distances.resize(referenceSet->n_cols);
-
-    for (size_t i = 0; i < distances.size(); i++)
-    {
-      // Map distances (copy a column).
-      const size_t refMapping = oldFromNewReferences[i];
-      distances[refMapping] = (*distancePtr)[i];
-
-      // Copy each neighbor individually, because we need to map it.
-      neighbors[refMapping].resize(distances[refMapping].size());
-      for (size_t j = 0; j < distances[refMapping].size(); j++)
-      {
-        neighbors[refMapping][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-    }
-
-    // Finished with temporary objects.
-    delete neighborPtr;
-    delete distancePtr;
+    const size_t position = next[queries[i]]++;
+    neighbors[position] = references[i];
+    distances[position] = resultDistances[i];
   }
 }
 
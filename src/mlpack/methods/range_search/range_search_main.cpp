@@ -84,6 +84,10 @@ PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Hold the reference data and the tree in single "
+    "precision, which halves the memory used by the model (only valid for "
+    "kd-trees, ball trees, vp trees, random projection trees and UB trees).",
+    "f");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
@@ -103,6 +107,7 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "single_precision");
   ReportIgnoredParam({{ "input_model", true }}, "leaf_size");
   ReportIgnoredParam({{ "input_model", true }}, "naive");
 
@@ -149,6 +154,13 @@ static void mlpackMain()
         "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "vp", "rp", "max-rp",
         "ub", "oct" }, true, "unknown tree type");
     const bool randomBasis = CLI::HasParam("random_basis");
+    const bool singlePrecision = CLI::HasParam("single_precision");
+    if (singlePrecision)
+    {
+      RequireParamInSet<string>("tree_type", { "kd", "ball", "vp", "rp",
+          "max-rp", "ub" }, true, "single precision is not supported for this "
+          "tree type");
+    }
 
     RSModel::TreeTypes tree = RSModel::KD_TREE;
     if (treeType == "kd")
@@ -182,6 +194,7 @@ static void mlpackMain()
 
     rs->TreeType() = tree;
     rs->RandomBasis() = randomBasis;
+    rs->SinglePrecision() = singlePrecision;
 
     arma::mat referenceSet = std::move(CLI::GetParam<arma::mat>("reference"));
 
@@ -200,8 +213,8 @@ static void mlpackMain()
 
     Log::Info << "Using range search model from '"
         << CLI::GetPrintableParam<RSModel>("input_model") << "' ("
-        << "trained on " << rs->Dataset().n_rows << "x" << rs->Dataset().n_cols
-        << " dataset)." << endl;
+        << "trained on " << rs->Dimensionality() << "x"
+        << rs->NumReferencePoints() << " dataset)." << endl;
 
     // Adjust singleMode and naive if necessary.
     rs->SingleMode() = CLI::HasParam("single_mode");
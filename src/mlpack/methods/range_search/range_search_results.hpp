@@ -0,0 +1,183 @@
+/**
+ * @file range_search_results.hpp
+ *
+ * Result types for range search.  RangeSearchRules hands each result (a query
+ * index, a reference index and their distance) to one of these objects as
+ * soon as it is found, so results can be stored as vectors, counted, or passed
+ * to a callback without being stored at all.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * Store the results in one vector of neighbors and one vector of distances for
+ * each query point.  This is the layout returned by RangeSearch::Search().
+ *
+ * Every result type has the same interface:
+ *
+ *  - NeedsDistances: if false, the distance passed to Add() may be 0 when
+ *    the point is known to be in the range without evaluating the metric.
+ *  - Reserve(queryIndex, count): at most count results are about to be added
+ *    for the given query point.
+ *  - Add(queryIndex, referenceIndex, distance): add one result.
+ */
+class VectorRangeResults
+{
+ public:
+  //! The distances are stored.
+  static const bool NeedsDistances = true;
+
+  //! Store the results in the given vectors (which must already be sized).
+  VectorRangeResults(std::vector<std::vector<size_t>>& neighbors,
+                     std::vector<std::vector<double>>& distances) :
+      neighbors(neighbors), distances(distances) { }
+
+  //! Make room for count more results of the given query point.
+  void Reserve(const size_t queryIndex, const size_t count)
+  {
+    neighbors[queryIndex].reserve(neighbors[queryIndex].size() + count);
+    distances[queryIndex].reserve(distances[queryIndex].size() + count);
+  }
+
+  //! Add a result.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    neighbors[queryIndex].push_back(referenceIndex);
+    distances[queryIndex].push_back(distance);
+  }
+
+ private:
+  //! The neighbors of each query point.
+  std::vector<std::vector<size_t>>& neighbors;
+  //! The distances of each query point.
+  std::vector<std::vector<double>>& distances;
+};
+
+/**
+ * Only count the results of each query point.  The metric is not evaluated
+ * for nodes that lie entirely inside the range.
+ */
+class CountRangeResults
+{
+ public:
+  //! The distances are not needed.
+  static const bool NeedsDistances = false;
+
+  //! Count the results in the given vector (which must already be zeroed).
+  CountRangeResults(arma::Col<size_t>& counts) : counts(counts) { }
+
+  //! Nothing is stored, so nothing is reserved.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+  //! Count a result.
+  void Add(const size_t queryIndex,
+           const size_t /* referenceIndex */,
+           const double /* distance */)
+  {
+    ++counts[queryIndex];
+  }
+
+ private:
+  //! The number of results of each query point.
+  arma::Col<size_t>& counts;
+};
+
+/**
+ * Pass each result to a callable object, as function(queryIndex,
+ * referenceIndex, distance), without storing it.
+ *
+ * @tparam FunctionType Type of the callable object.
+ */
+template<typename FunctionType>
+class FunctionRangeResults
+{
+ public:
+  //! The distances are passed to the function.
+  static const bool NeedsDistances = true;
+
+  //! Pass the results to the given function.
+  FunctionRangeResults(FunctionType& function) : function(function) { }
+
+  //! Nothing is stored, so nothing is reserved.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+  //! Pass a result to the function.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    function(queryIndex, referenceIndex, distance);
+  }
+
+ private:
+  //! The function to call for each result.
+  FunctionType& function;
+};
+
+/**
+ * Map the query and reference indices of each result (e.g. from the indices of
+ * points in a tree that rearranges its dataset back to the original indices)
+ * before passing it to another result type.
+ *
+ * @tparam ResultType Type of the results the mapped results are passed to.
+ */
+template<typename ResultType>
+class MappedRangeResults
+{
+ public:
+  //! The distances are needed if the wrapped results need them.
+  static const bool NeedsDistances = ResultType::NeedsDistances;
+
+  /**
+   * Map the results passed to the given results.  A NULL mapping means that
+   * the indices are not mapped.
+   */
+  MappedRangeResults(ResultType& results,
+                     const std::vector<size_t>* queryMapping,
+                     const std::vector<size_t>* referenceMapping) :
+      results(results),
+      queryMapping(queryMapping),
+      referenceMapping(referenceMapping) { }
+
+  //! Make room for count more results of the given query point.
+  void Reserve(const size_t queryIndex, const size_t count)
+  {
+    results.Reserve(queryMapping ? (*queryMapping)[queryIndex] : queryIndex,
+        count);
+  }
+
+  //! Map and add a result.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    results.Add(queryMapping ? (*queryMapping)[queryIndex] : queryIndex,
+        referenceMapping ? (*referenceMapping)[referenceIndex] :
+        referenceIndex, distance);
+  }
+
+ private:
+  //! The results the mapped results are passed to.
+  ResultType& results;
+  //! The mapping of query indices (or NULL).
+  const std::vector<size_t>* queryMapping;
+  //! The mapping of reference indices (or NULL).
+  const std::vector<size_t>* referenceMapping;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
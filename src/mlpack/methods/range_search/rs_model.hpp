@@ -20,6 +20,7 @@
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
 #include <boost/variant.hpp>
+#include <boost/serialization/version.hpp>
 #include "range_search.hpp"
 
 namespace mlpack {
@@ -30,8 +31,9 @@ namespace range {
  */
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-using RSType = RangeSearch<metric::EuclideanDistance, arma::mat, TreeType>;
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
+using RSType = RangeSearch<metric::EuclideanDistance, MatType, TreeType>;
 
 /**
  * MonoSearchVisitor executes a monochromatic range search on the given
@@ -68,11 +70,12 @@ class MonoSearchVisitor : public  boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, before doing range search,
  * a query tree with proper leafSize is built from the querySet.
  */
+template<typename MatType = arma::mat>
 class BiSearchVisitor : public boost::static_visitor<void>
 {
  private:
   //! The query set for the bichromatic search.
-  const arma::mat& querySet;
+  const MatType& querySet;
   //! Range to search neighbours for.
   const math::Range& range;
   //! The result vector for neighbors.
@@ -91,7 +94,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using RSTypeT = RSType<TreeType>;
+  using RSTypeT = RSType<TreeType, MatType>;
 
   //! Default Bichromatic range search on the given RSType instance.
   template<template<typename TreeMetricType,
@@ -109,7 +112,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   void operator()(RSTypeT<tree::Octree>* rs) const;
 
   //! Construct the BiSearchVisitor.
-  BiSearchVisitor(const arma::mat& querySet,
+  BiSearchVisitor(const MatType& querySet,
                   const math::Range& range,
                   std::vector<std::vector<size_t>>& neighbors,
                   std::vector<std::vector<double>>& distances,
@@ -122,11 +125,12 @@ class BiSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, a reference tree with proper
  * leafSize is built from the referenceSet.
  */
+template<typename MatType = arma::mat>
 class TrainVisitor : public boost::static_visitor<void>
 {
  private:
   //! The reference set to use for training.
-  arma::mat&& referenceSet;
+  MatType&& referenceSet;
   //! The leaf size, used only by BinarySpaceTree.
   size_t leafSize;
   //! Train on the given RsType considering the leafSize.
@@ -138,7 +142,7 @@ class TrainVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using RSTypeT = RSType<TreeType>;
+  using RSTypeT = RSType<TreeType, MatType>;
 
   //! Default Train on the given RSType instance.
   template<template<typename TreeMetricType,
@@ -156,19 +160,20 @@ class TrainVisitor : public boost::static_visitor<void>
   void operator()(RSTypeT<tree::Octree>* rs) const;
 
   //! Construct the TrainVisitor object with the given reference set, leafSize
-  TrainVisitor(arma::mat&& referenceSet,
+  TrainVisitor(MatType&& referenceSet,
                const size_t leafSize);
 };
 
 /**
  * ReferenceSetVisitor exposes the referenceSet of the given RSType.
  */
-class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
+template<typename MatType = arma::mat>
+class ReferenceSetVisitor : public boost::static_visitor<const MatType&>
 {
  public:
   //! Return the reference set.
   template<typename RSType>
-  const arma::mat& operator()(RSType* rs) const;
+  const MatType& operator()(RSType* rs) const;
 };
 
 /**
@@ -238,6 +243,8 @@ class RSModel
   bool randomBasis;
   //! Random projection matrix.
   arma::mat q;
+  //! If true, the model holds the reference set in single precision.
+  bool singlePrecision;
 
   /**
    * rSearch holds an instance of the RangeSearch class for the current
@@ -259,6 +266,18 @@ class RSModel
                  RSType<tree::UBTree>*,
                  RSType<tree::Octree>*> rSearch;
 
+  /**
+   * rSearchFloat holds the RangeSearch instance of a single precision model,
+   * for the tree types that support it.  Only one of rSearch and rSearchFloat
+   * is used, depending on singlePrecision.
+   */
+  boost::variant<RSType<tree::KDTree, arma::fmat>*,
+                 RSType<tree::BallTree, arma::fmat>*,
+                 RSType<tree::VPTree, arma::fmat>*,
+                 RSType<tree::RPTree, arma::fmat>*,
+                 RSType<tree::MaxRPTree, arma::fmat>*,
+                 RSType<tree::UBTree, arma::fmat>*> rSearchFloat;
+
  public:
   /**
    * Initialize the RSModel with the given type and whether or not a random
@@ -266,9 +285,12 @@ class RSModel
    *
    * @param treeType Type of tree to use.
    * @param randomBasis Whether or not to use a random basis.
+   * @param singlePrecision Whether or not to hold the reference set in single
+   *      precision.
    */
   RSModel(const TreeTypes treeType = TreeTypes::KD_TREE,
-          const bool randomBasis = false);
+          const bool randomBasis = false,
+          const bool singlePrecision = false);
 
   /**
    * Copy the given RSModel.
@@ -300,10 +322,17 @@ class RSModel
 
   //! Serialize the range search model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
-  //! Expose the dataset.
+  //! Expose the dataset (only for models that are not single precision).
   const arma::mat& Dataset() const;
+  //! Expose the dataset of a single precision model.
+  const arma::fmat& FloatDataset() const;
+
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const;
+  //! Get the number of points in the reference set.
+  size_t NumReferencePoints() const;
 
   //! Get whether the model is in single-tree search mode.
   bool SingleMode() const;
@@ -331,6 +360,12 @@ class RSModel
   //! been built).
   bool& RandomBasis() { return randomBasis; }
 
+  //! Get whether the model is single precision.
+  bool SinglePrecision() const { return singlePrecision; }
+  //! Modify whether the model is single precision (don't do this after the
+  //! model has been built).
+  bool& SinglePrecision() { return singlePrecision; }
+
   /**
    * Build the reference tree on the given dataset with the given parameters.
    * This takes possession of the reference set to avoid a copy.
@@ -389,6 +424,9 @@ class RSModel
 } // namespace range
 } // namespace mlpack
 
+//! Set the serialization version of the RSModel class.
+BOOST_CLASS_VERSION(mlpack::range::RSModel, 1);
+
 // Include implementation (of serialize() and inline functions).
 #include "rs_model_impl.hpp"
 
@@ -25,10 +25,13 @@ namespace range {
  * Initialize the RSModel with the given tree type and whether or not a random
  * basis should be used.
  */
-inline RSModel::RSModel(TreeTypes treeType, bool randomBasis) :
+inline RSModel::RSModel(TreeTypes treeType,
+                        bool randomBasis,
+                        bool singlePrecision) :
     treeType(treeType),
     leafSize(0),
-    randomBasis(randomBasis)
+    randomBasis(randomBasis),
+    singlePrecision(singlePrecision)
 {
   // Nothing to do.
 }
@@ -39,7 +42,9 @@ inline RSModel::RSModel(const RSModel& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(other.q),
-    rSearch(other.rSearch)
+    singlePrecision(other.singlePrecision),
+    rSearch(other.rSearch),
+    rSearchFloat(other.rSearchFloat)
 {
   // Nothing to do.
 }
@@ -50,24 +55,34 @@ inline RSModel::RSModel(RSModel&& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    rSearch(std::move(other.rSearch))
+    singlePrecision(other.singlePrecision),
+    rSearch(std::move(other.rSearch)),
+    rSearchFloat(std::move(other.rSearchFloat))
 {
   // Reset other model.
   other.treeType = TreeTypes::KD_TREE;
   other.leafSize = 0;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.rSearch = decltype(other.rSearch)();
+  other.rSearchFloat = decltype(other.rSearchFloat)();
 }
 
 inline RSModel& RSModel::operator=(RSModel other)
 {
-  boost::apply_visitor(DeleteVisitor(), rSearch);
+  CleanMemory();
 
   treeType = other.treeType;
   leafSize = other.leafSize;
   randomBasis = other.randomBasis;
   q = std::move(other.q);
+  singlePrecision = other.singlePrecision;
   rSearch = std::move(other.rSearch);
+  rSearchFloat = std::move(other.rSearchFloat);
+
+  // The pointers are now ours, so they must not be deleted with other.
+  other.rSearch = decltype(other.rSearch)();
+  other.rSearchFloat = decltype(other.rSearchFloat)();
 
   return *this;
 }
@@ -75,7 +90,7 @@ inline RSModel& RSModel::operator=(RSModel other)
 // Clean memory, if necessary.
 inline RSModel::~RSModel()
 {
-  boost::apply_visitor(DeleteVisitor(), rSearch);
+  CleanMemory();
 }
 
 inline void RSModel::BuildModel(arma::mat&& referenceSet,
@@ -83,6 +98,15 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
                                 const bool naive,
                                 const bool singleMode)
 {
+  if (singlePrecision && treeType != KD_TREE && treeType != BALL_TREE &&
+      treeType != VP_TREE && treeType != RP_TREE && treeType != MAX_RP_TREE &&
+      treeType != UB_TREE)
+  {
+    throw std::invalid_argument("RSModel::BuildModel(): single precision is "
+        "only supported for kd-trees, ball trees, vantage point trees, random "
+        "projection trees and UB trees");
+  }
+
   // Initialize random basis if necessary.
   if (randomBasis)
   {
@@ -93,7 +117,7 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
   this->leafSize = leafSize;
 
   // Clean memory, if necessary.
-  boost::apply_visitor(DeleteVisitor(), rSearch);
+  CleanMemory();
 
   // Do we need to modify the reference set?
   if (randomBasis)
@@ -105,6 +129,54 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
     Log::Info << "Building reference tree..." << std::endl;
   }
 
+  if (singlePrecision)
+  {
+    switch (treeType)
+    {
+      case KD_TREE:
+        rSearchFloat = new RSType<tree::KDTree, arma::fmat>(naive, singleMode);
+        break;
+
+      case BALL_TREE:
+        rSearchFloat = new RSType<tree::BallTree, arma::fmat>(naive,
+            singleMode);
+        break;
+
+      case VP_TREE:
+        rSearchFloat = new RSType<tree::VPTree, arma::fmat>(naive, singleMode);
+        break;
+
+      case RP_TREE:
+        rSearchFloat = new RSType<tree::RPTree, arma::fmat>(naive, singleMode);
+        break;
+
+      case MAX_RP_TREE:
+        rSearchFloat = new RSType<tree::MaxRPTree, arma::fmat>(naive,
+            singleMode);
+        break;
+
+      default:
+        rSearchFloat = new RSType<tree::UBTree, arma::fmat>(naive, singleMode);
+        break;
+    }
+
+    // Convert the reference set, and release the double precision copy before
+    // the tree is built.
+    arma::fmat floatReferenceSet =
+        arma::conv_to<arma::fmat>::from(referenceSet);
+    referenceSet.reset();
+
+    TrainVisitor<arma::fmat> tn(std::move(floatReferenceSet), leafSize);
+    boost::apply_visitor(tn, rSearchFloat);
+
+    if (!naive)
+    {
+      Timer::Stop("tree_building");
+      Log::Info << "Tree built." << std::endl;
+    }
+    return;
+  }
+
   switch (treeType)
   {
     case KD_TREE:
@@ -164,7 +236,7 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
       break;
   }
 
-  TrainVisitor tn(std::move(referenceSet), leafSize);
+  TrainVisitor<> tn(std::move(referenceSet), leafSize);
   boost::apply_visitor(tn, rSearch);
 
   if (!naive)
@@ -194,7 +266,18 @@ inline void RSModel::Search(arma::mat&& querySet,
     Log::Info << "brute-force (naive) search..." << std::endl;
 
 
-  BiSearchVisitor search(querySet, range, neighbors, distances,
+  if (singlePrecision)
+  {
+    arma::fmat floatQuerySet = arma::conv_to<arma::fmat>::from(querySet);
+    querySet.reset();
+
+    BiSearchVisitor<arma::fmat> search(floatQuerySet, range, neighbors,
+        distances, leafSize);
+    boost::apply_visitor(search, rSearchFloat);
+    return;
+  }
+
+  BiSearchVisitor<> search(querySet, range, neighbors, distances,
       leafSize);
   boost::apply_visitor(search, rSearch);
 }
@@ -214,7 +297,10 @@ inline void RSModel::Search(const math::Range& range,
     Log::Info << "brute-force (naive) search..." << std::endl;
 
   MonoSearchVisitor search(range, neighbors, distances);
-  boost::apply_visitor(search, rSearch);
+  if (singlePrecision)
+    boost::apply_visitor(search, rSearchFloat);
+  else
+    boost::apply_visitor(search, rSearch);
 }
 
 // Get the name of the tree type.
@@ -259,6 +345,9 @@ inline std::string RSModel::TreeName() const
 inline void RSModel::CleanMemory()
 {
   boost::apply_visitor(DeleteVisitor(), rSearch);
+  boost::apply_visitor(DeleteVisitor(), rSearchFloat);
+  rSearch = decltype(rSearch)();
+  rSearchFloat = decltype(rSearchFloat)();
 }
 
 //! Monochromatic range search on the given RSType instance.
@@ -271,11 +360,13 @@ void MonoSearchVisitor::operator()(RSType* rs) const
 }
 
 //! Save parameters for bichromatic range search.
-BiSearchVisitor::BiSearchVisitor(const arma::mat& querySet,
-                                 const math::Range& range,
-                                 std::vector<std::vector<size_t>>& neighbors,
-                                 std::vector<std::vector<double>>& distances,
-                                 const size_t leafSize):
+template<typename MatType>
+BiSearchVisitor<MatType>::BiSearchVisitor(
+    const MatType& querySet,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    const size_t leafSize):
     querySet(querySet),
     range(range),
     neighbors(neighbors),
@@ -284,10 +375,11 @@ BiSearchVisitor::BiSearchVisitor(const arma::mat& querySet,
 {}
 
 //! Default Bichromatic range search on the given RSType instance.
+template<typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void BiSearchVisitor::operator()(RSTypeT<TreeType>* rs) const
+void BiSearchVisitor<MatType>::operator()(RSTypeT<TreeType>* rs) const
 {
   if (rs)
     return rs->Search(querySet, range, neighbors, distances);
@@ -295,7 +387,8 @@ void BiSearchVisitor::operator()(RSTypeT<TreeType>* rs) const
 }
 
 //! Bichromatic range search on the given RSType specialized for KDTrees.
-void BiSearchVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::KDTree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -303,7 +396,8 @@ void BiSearchVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
 }
 
 //! Bichromatic range search on the given RSType specialized for BallTrees.
-void BiSearchVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::BallTree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -311,7 +405,8 @@ void BiSearchVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
 }
 
 //! Bichromatic range search specialized for Ocrees.
-void BiSearchVisitor::operator()(RSTypeT<tree::Octree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::Octree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -319,8 +414,9 @@ void BiSearchVisitor::operator()(RSTypeT<tree::Octree>* rs) const
 }
 
 //! Bichromatic range search on the given RSType considering the leafSize.
+template<typename MatType>
 template<typename RSType>
-void BiSearchVisitor::SearchLeaf(RSType* rs) const
+void BiSearchVisitor<MatType>::SearchLeaf(RSType* rs) const
 {
   if (!rs->Naive() && !rs->SingleMode())
   {
@@ -351,17 +447,19 @@ void BiSearchVisitor::SearchLeaf(RSType* rs) const
 }
 
 //! Save parameters for Train.
-TrainVisitor::TrainVisitor(arma::mat&& referenceSet,
-                           const size_t leafSize) :
+template<typename MatType>
+TrainVisitor<MatType>::TrainVisitor(MatType&& referenceSet,
+                                    const size_t leafSize) :
     referenceSet(std::move(referenceSet)),
     leafSize(leafSize)
 {}
 
 //! Default Train on the given RSType instance.
+template<typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void TrainVisitor::operator()(RSTypeT<TreeType>* rs) const
+void TrainVisitor<MatType>::operator()(RSTypeT<TreeType>* rs) const
 {
   if (rs)
     return rs->Train(std::move(referenceSet));
@@ -369,7 +467,8 @@ void TrainVisitor::operator()(RSTypeT<TreeType>* rs) const
 }
 
 //! Train on the given RSType specialized for KDTrees.
-void TrainVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::KDTree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -377,7 +476,8 @@ void TrainVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
 }
 
 //! Train on the given RSType specialized for BallTrees.
-void TrainVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::BallTree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -385,7 +485,8 @@ void TrainVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
 }
 
 //! Train specialized for Octrees.
-void TrainVisitor::operator()(RSTypeT<tree::Octree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::Octree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -393,8 +494,9 @@ void TrainVisitor::operator()(RSTypeT<tree::Octree>* rs) const
 }
 
 //! Train on the given RSType considering the leafSize.
+template<typename MatType>
 template<typename RSType>
-void TrainVisitor::TrainLeaf(RSType* rs) const
+void TrainVisitor<MatType>::TrainLeaf(RSType* rs) const
 {
   if (rs->Naive())
     rs->Train(std::move(referenceSet));
@@ -413,8 +515,9 @@ void TrainVisitor::TrainLeaf(RSType* rs) const
 }
 
 //! Expose the referenceSet of the given RSType.
+template<typename MatType>
 template<typename RSType>
-const arma::mat& ReferenceSetVisitor::operator()(RSType* rs) const
+const MatType& ReferenceSetVisitor<MatType>::operator()(RSType* rs) const
 {
   if (rs)
     return rs->ReferenceSet();
@@ -449,42 +552,80 @@ bool& NaiveVisitor::operator()(RSType* rs) const
 
 // Serialize the model.
 template<typename Archive>
-void RSModel::serialize(Archive& ar, const unsigned int /* version */)
+void RSModel::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
   ar & BOOST_SERIALIZATION_NVP(q);
 
+  // Older versions of RSModel only held double precision models.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(singlePrecision);
+  else if (Archive::is_loading::value)
+    singlePrecision = false;
+
   // This should never happen, but just in case...
   if (Archive::is_loading::value)
-    boost::apply_visitor(DeleteVisitor(), rSearch);
+    CleanMemory();
 
   // We'll only need to serialize one of the model objects, based on the type.
-  ar & BOOST_SERIALIZATION_NVP(rSearch);
+  if (singlePrecision)
+    ar & BOOST_SERIALIZATION_NVP(rSearchFloat);
+  else
+    ar & BOOST_SERIALIZATION_NVP(rSearch);
 }
 
 inline const arma::mat& RSModel::Dataset() const
 {
-  return boost::apply_visitor(ReferenceSetVisitor(), rSearch);
+  if (singlePrecision)
+    throw std::runtime_error("RSModel::Dataset(): the model is single "
+        "precision; use FloatDataset()");
+  return boost::apply_visitor(ReferenceSetVisitor<>(), rSearch);
+}
+
+inline const arma::fmat& RSModel::FloatDataset() const
+{
+  if (!singlePrecision)
+    throw std::runtime_error("RSModel::FloatDataset(): the model is not single "
+        "precision; use Dataset()");
+  return boost::apply_visitor(ReferenceSetVisitor<arma::fmat>(), rSearchFloat);
+}
+
+inline size_t RSModel::Dimensionality() const
+{
+  return singlePrecision ? FloatDataset().n_rows : Dataset().n_rows;
+}
+
+inline size_t RSModel::NumReferencePoints() const
+{
+  return singlePrecision ? FloatDataset().n_cols : Dataset().n_cols;
 }
 
 inline bool RSModel::SingleMode() const
 {
+  if (singlePrecision)
+    return boost::apply_visitor(SingleModeVisitor(), rSearchFloat);
   return boost::apply_visitor(SingleModeVisitor(), rSearch);
 }
 
 inline bool& RSModel::SingleMode()
 {
+  if (singlePrecision)
+    return boost::apply_visitor(SingleModeVisitor(), rSearchFloat);
   return boost::apply_visitor(SingleModeVisitor(), rSearch);
 }
 
 inline bool RSModel::Naive() const
 {
+  if (singlePrecision)
+    return boost::apply_visitor(NaiveVisitor(), rSearchFloat);
   return boost::apply_visitor(NaiveVisitor(), rSearch);
 }
 
 inline bool& RSModel::Naive()
 {
+  if (singlePrecision)
+    return boost::apply_visitor(NaiveVisitor(), rSearchFloat);
   return boost::apply_visitor(NaiveVisitor(), rSearch);
 }
 
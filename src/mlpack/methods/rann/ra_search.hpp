@@ -391,6 +391,28 @@ class RASearch
   //! Instantiation of kernel.
   MetricType metric;
 
+  /**
+   * Call the given function on every query point.  The query points are split
+   * into batches of 64 consecutive points that are handed out to the available
+   * threads (see Threads); each batch has its own copy of the rules (copies
+   * share the candidate lists), and the distance calculation counts are added
+   * back into the given rules.  The function is called as function(rules,
+   * begin, end) for the query points [begin, end) of a batch.
+   *
+   * When more than one thread is used, each batch draws its random samples
+   * from its own stream (see math::RandomStream()), so the results do not
+   * depend on which thread handles which batch; otherwise all the samples are
+   * drawn from the random number generator of the calling thread, as before.
+   *
+   * @param rules Rules to use for the search.
+   * @param numQueries Number of query points.
+   * @param function Function to call for each batch of query points.
+   */
+  template<typename RuleType, typename FunctionType>
+  void SearchQueries(RuleType& rules,
+                     const size_t numQueries,
+                     FunctionType function);
+
   //! For access to mappings when building models.
   template<typename SortPol>
   friend class TrainVisitor;
@@ -17,6 +17,8 @@
 
 #include "ra_search_rules.hpp"
 
+#include <numeric>
+
 namespace mlpack {
 namespace neighbor {
 
@@ -306,9 +308,12 @@ Search(const MatType& querySet,
 
     // Run the base case on each combination of query point and sampled
     // reference point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        rules.BaseCase(i, (size_t) distinctSamples[j]);
+    SearchQueries(rules, querySet.n_cols, [&](RuleType& batchRules,
+        const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        batchRules.BaseCases(i, distinctSamples);
+    });
 
     rules.GetResults(*neighborPtr, *distancePtr);
   }
@@ -323,12 +328,15 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Traverse for each point, with one traverser per batch of points.
+      SearchQueries(rules, querySet.n_cols, [&](RuleType& batchRules,
+          const size_t begin, const size_t end)
+      {
+        typename Tree::template SingleTreeTraverser<RuleType>
+            traverser(batchRules);
+        for (size_t i = begin; i < end; ++i)
+          traverser.Traverse(i, *referenceTree);
+      });
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
@@ -533,18 +541,26 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
         distinctSamples);
 
     // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    const arma::uvec allPoints = arma::regspace<arma::uvec>(0,
+        referenceSet->n_cols - 1);
+    SearchQueries(rules, referenceSet->n_cols, [&](RuleType& batchRules,
+        const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        batchRules.BaseCases(i, allPoints);
+    });
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Traverse for each point, with one traverser per batch of points.
+    SearchQueries(rules, referenceSet->n_cols, [&](RuleType& batchRules,
+        const size_t begin, const size_t end)
+    {
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(batchRules);
+      for (size_t i = begin; i < end; ++i)
+        traverser.Traverse(i, *referenceTree);
+    });
   }
   else
   {
@@ -581,6 +597,56 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType, typename FunctionType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::SearchQueries(
+    RuleType& rules,
+    const size_t numQueries,
+    FunctionType function)
+{
+  // Small batches keep the load balanced; large enough batches keep the
+  // scheduling overhead negligible next to the search of each point.
+  const size_t batchSize = 64;
+  const size_t numBatches = (numQueries + batchSize - 1) / batchSize;
+
+  if (numBatches <= 1 || Threads::Count() <= 1 || Threads::InParallel())
+  {
+    function(rules, 0, numQueries);
+    return;
+  }
+
+  // The streams of this search start at a random offset, so that successive
+  // searches draw different samples.
+  const size_t firstStream = (size_t) math::ThreadRandGen()();
+
+  std::vector<size_t> distComputations(numBatches, 0);
+  Threads::ParallelFor(0, numBatches, [&](const size_t b)
+  {
+    RuleType batchRules(rules);
+    batchRules.NumDistComputations() = 0;
+
+    // Sample from the stream of this batch, and then give the thread its own
+    // generator back.
+    std::mt19937& generator = math::ThreadRandGen();
+    const std::mt19937 threadGenerator = generator;
+    generator = math::RandomStream(firstStream + b);
+
+    function(batchRules, b * batchSize,
+        std::min(numQueries, (b + 1) * batchSize));
+
+    generator = threadGenerator;
+    distComputations[b] = batchRules.NumDistComputations();
+  });
+
+  rules.NumDistComputations() += std::accumulate(distComputations.begin(),
+      distComputations.end(), (size_t) 0);
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
@@ -15,8 +15,10 @@
 #define MLPACK_METHODS_RANN_RA_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/neighbor_search/k_best_candidates.hpp>
 
-#include <queue>
+#include <memory>
 
 namespace mlpack {
 namespace neighbor {
@@ -25,6 +27,10 @@ namespace neighbor {
  * The RASearchRules class is a template helper class used by RASearch class
  * when performing rank-approximate search via random-sampling.
  *
+ * Copies of the rules share the candidate lists and the sample counts of the
+ * query points, so that the query points can be split between several
+ * threads, each with its own copy.
+ *
  * @tparam SortPolicy The sort policy for distances.
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
@@ -68,6 +74,8 @@ class RASearchRules
 
   /**
    * Store the list of candidates for each query point in the given matrices.
+   * The candidates are moved into the matrices, so this may only be called
+   * once, at the end of the search.
    *
    * @param neighbors Matrix storing lists of neighbors for each query point.
    * @param distances Matrix storing distances of neighbors for each query
@@ -84,6 +92,18 @@ class RASearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Run the base case for the given query point and each of the given
+   * reference points, in order.  The reference points are gathered in small
+   * contiguous blocks, and the distances of each block are computed at once
+   * (with one vectorized expression for the Euclidean distance).  This gives
+   * the same results as calling BaseCase() for each reference point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndices Indices of reference points.
+   */
+  void BaseCases(const size_t queryIndex, const arma::uvec& referenceIndices);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -227,13 +247,16 @@ class RASearchRules
                  const double oldScore);
 
 
-  size_t NumDistComputations() { return numDistComputations; }
+  //! Get the number of distance calculations performed by these rules.
+  size_t NumDistComputations() const { return numDistComputations; }
+  //! Modify the number of distance calculations performed by these rules.
+  size_t& NumDistComputations() { return numDistComputations; }
   size_t NumEffectiveSamples()
   {
-    if (numSamplesMade.n_elem == 0)
+    if (numSamplesMade->n_elem == 0)
       return 0;
     else
-      return arma::sum(numSamplesMade);
+      return arma::sum(*numSamplesMade);
   }
 
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
@@ -248,23 +271,10 @@ class RASearchRules
   //! The query set.
   const arma::mat& querySet;
 
-  //! Candidate represents a possible candidate neighbor (distance, index).
-  typedef std::pair<double, size_t> Candidate;
-
-  //! Compare two candidates based on the distance.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
-    {
-      return !SortPolicy::IsBetter(c2.first, c1.first);
-    };
-  };
-
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
-
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! The k best candidate neighbors of each query point; initialized with k
+  //! candidates (WorstDistance, size_t() - 1), and updated by BaseCase().
+  //! Copies of the rules (one per thread) share the candidates.
+  std::shared_ptr<KBestCandidates<SortPolicy>> candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -284,8 +294,9 @@ class RASearchRules
   //! The minimum number of samples required per query.
   size_t numSamplesReqd;
 
-  //! The number of samples made for every query.
-  arma::Col<size_t> numSamplesMade;
+  //! The number of samples made for every query (shared by copies of the
+  //! rules).
+  std::shared_ptr<arma::Col<size_t>> numSamplesMade;
 
   //! The sampling ratio.
   double samplingRatio;
@@ -298,6 +309,43 @@ class RASearchRules
 
   TraversalInfoType traversalInfo;
 
+  //! Scratch space for the samples of a node.
+  arma::uvec distinctSamples;
+  //! Scratch space for the reference indices of the samples of a node.
+  arma::uvec sampleIndices;
+  //! Scratch space for a block of sampled reference points.
+  arma::mat sampleBlock;
+  //! Scratch space for the distances to a block of sampled reference points.
+  arma::rowvec sampleDistances;
+
+  /**
+   * Approximate the given reference node for the given query point, by
+   * running the base case on samplesReqd distinct points sampled uniformly
+   * from the descendants of the node.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Reference node to sample from.
+   * @param samplesReqd Number of samples to take.
+   */
+  void SampleNode(const size_t queryIndex,
+                  TreeType& referenceNode,
+                  const size_t samplesReqd);
+
+  //! Compute the distances from a point to each column of a block.
+  template<typename MetricT>
+  static void BlockDistances(MetricT& metric,
+                             const arma::vec& point,
+                             const arma::mat& block,
+                             arma::rowvec& distances);
+
+  //! Compute the L2 distances from a point to each column of a block, with
+  //! one vectorized expression.
+  template<bool TakeRoot>
+  static void BlockDistances(metric::LMetric<2, TakeRoot>& metric,
+                             const arma::vec& point,
+                             const arma::mat& block,
+                             arma::rowvec& distances);
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
@@ -33,6 +33,7 @@ RASearchRules(const arma::mat& referenceSet,
               const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(new KBestCandidates<SortPolicy>(k, querySet.n_cols)),
     k(k),
     metric(metric),
     sampleAtLeaves(sampleAtLeaves),
@@ -63,36 +64,21 @@ RASearchRules(const arma::mat& referenceSet,
   Timer::Stop("computing_number_of_samples_reqd");
 
   // Initialize some statistics to be collected during the search.
-  numSamplesMade = arma::zeros<arma::Col<size_t> >(querySet.n_cols);
+  numSamplesMade.reset(new arma::Col<size_t>(querySet.n_cols,
+      arma::fill::zeros));
   numDistComputations = 0;
   samplingRatio = (double) numSamplesReqd / (double) n;
 
   Log::Info << "Minimum samples required per query: " << numSamplesReqd <<
     ", sampling ratio: " << samplingRatio << std::endl;
 
-  // Let's build the list of candidate neighbors for each query point.
-  // It will be initialized with k candidates: (WorstDistance, size_t() - 1)
-  // The list of candidates will be updated when visiting new points with the
-  // BaseCase() method.
-  const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
-      size_t() - 1);
-
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
-
-  candidates.reserve(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; i++)
-    candidates.push_back(pqueue);
-
   if (naive) // No tree traversal; just do naive sampling here.
   {
     // Sample enough points.
-    arma::uvec distinctSamples;
     for (size_t i = 0; i < querySet.n_cols; ++i)
     {
       math::ObtainDistinctSamples(0, n, numSamplesReqd, distinctSamples);
-      for (size_t j = 0; j < distinctSamples.n_elem; j++)
-        BaseCase(i, (size_t) distinctSamples[j]);
+      BaseCases(i, distinctSamples);
     }
   }
 }
@@ -102,19 +88,7 @@ void RASearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  neighbors.set_size(k, querySet.n_cols);
-  distances.set_size(k, querySet.n_cols);
-
-  for (size_t i = 0; i < querySet.n_cols; i++)
-  {
-    CandidateList& pqueue = candidates[i];
-    for (size_t j = 1; j <= k; j++)
-    {
-      neighbors(k - j, i) = pqueue.top().second;
-      distances(k - j, i) = pqueue.top().first;
-      pqueue.pop();
-    }
-  }
+  candidates->Release(neighbors, distances);
 };
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -133,13 +107,95 @@ double RASearchRules<SortPolicy, MetricType, TreeType>::BaseCase(
 
   InsertNeighbor(queryIndex, referenceIndex, distance);
 
-  numSamplesMade[queryIndex]++;
+  (*numSamplesMade)[queryIndex]++;
 
   numDistComputations++;
 
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::BaseCases(
+    const size_t queryIndex,
+    const arma::uvec& referenceIndices)
+{
+  // Small blocks stay in the cache.
+  const size_t blockSize = 64;
+  const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
+
+  for (size_t begin = 0; begin < referenceIndices.n_elem; begin += blockSize)
+  {
+    const size_t count = std::min(blockSize,
+        (size_t) referenceIndices.n_elem - begin);
+
+    // Gather the sampled points into one contiguous block.
+    sampleBlock.set_size(referenceSet.n_rows, count);
+    for (size_t j = 0; j < count; ++j)
+    {
+      const double* point = referenceSet.colptr(referenceIndices[begin + j]);
+      std::copy(point, point + referenceSet.n_rows, sampleBlock.colptr(j));
+    }
+
+    BlockDistances(metric, queryPoint, sampleBlock, sampleDistances);
+
+    for (size_t j = 0; j < count; ++j)
+    {
+      // As in BaseCase(), a point is not its own neighbor.
+      const size_t referenceIndex = referenceIndices[begin + j];
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      InsertNeighbor(queryIndex, referenceIndex, sampleDistances[j]);
+      (*numSamplesMade)[queryIndex]++;
+      numDistComputations++;
+    }
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void RASearchRules<SortPolicy, MetricType, TreeType>::SampleNode(
+    const size_t queryIndex,
+    TreeType& referenceNode,
+    const size_t samplesReqd)
+{
+  math::ObtainDistinctSamples(0, referenceNode.NumDescendants(), samplesReqd,
+      distinctSamples);
+
+  sampleIndices.set_size(distinctSamples.n_elem);
+  for (size_t i = 0; i < distinctSamples.n_elem; ++i)
+    sampleIndices[i] = referenceNode.Descendant(distinctSamples[i]);
+
+  // The counting of the samples is done in BaseCases(), so no book-keeping is
+  // required here.
+  BaseCases(queryIndex, sampleIndices);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<typename MetricT>
+void RASearchRules<SortPolicy, MetricType, TreeType>::BlockDistances(
+    MetricT& metric,
+    const arma::vec& point,
+    const arma::mat& block,
+    arma::rowvec& distances)
+{
+  distances.set_size(block.n_cols);
+  for (size_t j = 0; j < block.n_cols; ++j)
+    distances[j] = metric.Evaluate(point, block.unsafe_col(j));
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+template<bool TakeRoot>
+void RASearchRules<SortPolicy, MetricType, TreeType>::BlockDistances(
+    metric::LMetric<2, TakeRoot>& /* metric */,
+    const arma::vec& point,
+    const arma::mat& block,
+    arma::rowvec& distances)
+{
+  distances = arma::sum(arma::square(block.each_col() - point), 0);
+  if (TakeRoot)
+    distances = arma::sqrt(distances);
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -148,7 +204,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
   const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
   const double distance = SortPolicy::BestPointToNodeDistance(queryPoint,
       &referenceNode);
-  const double bestDistance = candidates[queryIndex].top().first;
+  const double bestDistance = candidates->WorstDistance(queryIndex);
 
   return Score(queryIndex, referenceNode, distance, bestDistance);
 }
@@ -162,7 +218,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
   const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
   const double distance = SortPolicy::BestPointToNodeDistance(queryPoint,
       &referenceNode, baseCaseResult);
-  const double bestDistance = candidates[queryIndex].top().first;
+  const double bestDistance = candidates->WorstDistance(queryIndex);
 
   return Score(queryIndex, referenceNode, distance, bestDistance);
 }
@@ -178,19 +234,19 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
   // will be something down this node.  Also check if enough samples are already
   // made for this query.
   if (SortPolicy::IsBetter(distance, bestDistance)
-      && numSamplesMade[queryIndex] < numSamplesReqd)
+      && (*numSamplesMade)[queryIndex] < numSamplesReqd)
   {
     // We cannot prune this node; try approximating it by sampling.
 
     // If we are required to visit the first leaf (to find possible duplicates),
     // make sure we do not approximate.
-    if (numSamplesMade[queryIndex] > 0 || !firstLeafExact)
+    if ((*numSamplesMade)[queryIndex] > 0 || !firstLeafExact)
     {
       // Check if this node can be approximated by sampling.
       size_t samplesReqd = (size_t) std::ceil(samplingRatio *
           (double) referenceNode.NumDescendants());
       samplesReqd = std::min(samplesReqd,
-          numSamplesReqd - numSamplesMade[queryIndex]);
+          numSamplesReqd - (*numSamplesMade)[queryIndex]);
 
       if (samplesReqd > singleSampleLimit && !referenceNode.IsLeaf())
       {
@@ -203,13 +259,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
         {
           // Then samplesReqd <= singleSampleLimit.
           // Hence, approximate the node by sampling enough number of points.
-          arma::uvec distinctSamples;
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
-          for (size_t i = 0; i < distinctSamples.n_elem; i++)
-            // The counting of the samples are done in the 'BaseCase' function
-            // so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+          SampleNode(queryIndex, referenceNode, samplesReqd);
 
           // Node approximated, so we can prune it.
           return DBL_MAX;
@@ -219,14 +269,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           if (sampleAtLeaves) // If allowed to sample at leaves.
           {
             // Approximate node by sampling enough number of points.
-            arma::uvec distinctSamples;
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
-            for (size_t i = 0; i < distinctSamples.n_elem; i++)
-              // The counting of the samples are done in the 'BaseCase' function
-              // so no book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[i]));
+            SampleNode(queryIndex, referenceNode, samplesReqd);
 
             // (Leaf) node approximated, so we can prune it.
             return DBL_MAX;
@@ -256,7 +299,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
 
     // If enough samples are already made, this step does not change the result
     // of the search.
-    numSamplesMade[queryIndex] += (size_t) std::floor(
+    (*numSamplesMade)[queryIndex] += (size_t) std::floor(
         samplingRatio * (double) referenceNode.NumDescendants());
 
     return DBL_MAX;
@@ -274,13 +317,13 @@ Rescore(const size_t queryIndex,
     return oldScore;
 
   // Just check the score again against the distances.
-  const double bestDistance = candidates[queryIndex].top().first;
+  const double bestDistance = candidates->WorstDistance(queryIndex);
 
   // If this is better than the best distance we've seen so far,
   // maybe there will be something down this node.
   // Also check if enough samples are already made for this query.
   if (SortPolicy::IsBetter(oldScore, bestDistance)
-      && numSamplesMade[queryIndex] < numSamplesReqd)
+      && (*numSamplesMade)[queryIndex] < numSamplesReqd)
   {
     // We cannot prune this node; thus, we try approximating this node by
     // sampling.
@@ -293,7 +336,7 @@ Rescore(const size_t queryIndex,
     size_t samplesReqd = (size_t) std::ceil(samplingRatio *
         (double) referenceNode.NumDescendants());
     samplesReqd = std::min(samplesReqd, numSamplesReqd -
-        numSamplesMade[queryIndex]);
+        (*numSamplesMade)[queryIndex]);
 
     if (samplesReqd > singleSampleLimit && !referenceNode.IsLeaf())
     {
@@ -307,13 +350,7 @@ Rescore(const size_t queryIndex,
       {
         // Then, samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough number of points.
-        arma::uvec distinctSamples;
-        math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-            samplesReqd, distinctSamples);
-        for (size_t i = 0; i < distinctSamples.n_elem; i++)
-          // The counting of the samples are done in the 'BaseCase' function so
-          // no book-keeping is required here.
-          BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+        SampleNode(queryIndex, referenceNode, samplesReqd);
 
         // Node approximated, so we can prune it.
         return DBL_MAX;
@@ -323,13 +360,7 @@ Rescore(const size_t queryIndex,
         if (sampleAtLeaves)
         {
           // Approximate node by sampling enough points.
-          arma::uvec distinctSamples;
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
-          for (size_t i = 0; i < distinctSamples.n_elem; i++)
-            // The counting of the samples are done in the 'BaseCase' function
-            // so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+          SampleNode(queryIndex, referenceNode, samplesReqd);
 
           // (Leaf) node approximated, so we can prune it.
           return DBL_MAX;
@@ -350,7 +381,7 @@ Rescore(const size_t queryIndex,
     // Add 'fake' samples from this node; they are fake because the distances to
     // these samples need not be computed.  If enough samples are already made,
     // this step does not change the result of the search.
-    numSamplesMade[queryIndex] += (size_t) std::floor(samplingRatio *
+    (*numSamplesMade)[queryIndex] += (size_t) std::floor(samplingRatio *
         (double) referenceNode.NumDescendants());
 
     return DBL_MAX;
@@ -374,7 +405,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
 
   for (size_t i = 0; i < queryNode.NumPoints(); i++)
   {
-    const double bound = candidates[queryNode.Point(i)].top().first
+    const double bound = candidates->WorstDistance(queryNode.Point(i))
         + maxDescendantDistance;
     if (bound < pointBound)
       pointBound = bound;
@@ -413,7 +444,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
 
   for (size_t i = 0; i < queryNode.NumPoints(); i++)
   {
-    const double bound = candidates[queryNode.Point(i)].top().first
+    const double bound = candidates->WorstDistance(queryNode.Point(i))
         + maxDescendantDistance;
     if (bound < pointBound)
       pointBound = bound;
@@ -507,18 +538,8 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
         {
           // Then samplesReqd <= singleSampleLimit.  Hence, approximate node by
           // sampling enough number of points for every query in the query node.
-          arma::uvec distinctSamples;
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-          {
-            const size_t queryIndex = queryNode.Descendant(i);
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
-            for (size_t j = 0; j < distinctSamples.n_elem; j++)
-              // The counting of the samples are done in the 'BaseCase' function
-              // so no book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[j]));
-          }
+            SampleNode(queryNode.Descendant(i), referenceNode, samplesReqd);
 
           // Update the number of samples made for the queryNode and also update
           // the number of sample made for the child nodes.
@@ -537,18 +558,8 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           {
             // Approximate node by sampling enough number of points for every
             // query in the query node.
-            arma::uvec distinctSamples;
             for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-            {
-              const size_t queryIndex = queryNode.Descendant(i);
-              math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                  samplesReqd, distinctSamples);
-              for (size_t j = 0; j < distinctSamples.n_elem; j++)
-                // The counting of the samples are done in the 'BaseCase'
-                // function so no book-keeping is required here.
-                BaseCase(queryIndex,
-                    referenceNode.Descendant(distinctSamples[j]));
-            }
+              SampleNode(queryNode.Descendant(i), referenceNode, samplesReqd);
 
             // Update the number of samples made for the queryNode and also
             // update the number of sample made for the child nodes.
@@ -627,7 +638,7 @@ Rescore(TreeType& queryNode,
 
   for (size_t i = 0; i < queryNode.NumPoints(); i++)
   {
-    const double bound = candidates[queryNode.Point(i)].top().first
+    const double bound = candidates->WorstDistance(queryNode.Point(i))
         + maxDescendantDistance;
     if (bound < pointBound)
       pointBound = bound;
@@ -712,17 +723,8 @@ Rescore(TreeType& queryNode,
       {
         // then samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough points for every query in the query node.
-        arma::uvec distinctSamples;
         for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-        {
-          const size_t queryIndex = queryNode.Descendant(i);
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
-          for (size_t j = 0; j < distinctSamples.n_elem; j++)
-            // The counting of the samples are done in the 'BaseCase'
-            // function so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[j]));
-        }
+          SampleNode(queryNode.Descendant(i), referenceNode, samplesReqd);
 
         // Update the number of samples made for the query node and also update
         // the number of samples made for the child nodes.
@@ -741,18 +743,8 @@ Rescore(TreeType& queryNode,
         {
           // Approximate node by sampling enough points for every query in the
           // query node.
-          arma::uvec distinctSamples;
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-          {
-            const size_t queryIndex = queryNode.Descendant(i);
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
-            for (size_t j = 0; j < distinctSamples.n_elem; j++)
-              // The counting of the samples are done in BaseCase() so no
-              // book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[j]));
-          }
+            SampleNode(queryNode.Descendant(i), referenceNode, samplesReqd);
 
           // Update the number of samples made for the query node and also
           // update the number of samples made for the child nodes.
@@ -812,14 +804,7 @@ InsertNeighbor(
     const size_t neighbor,
     const double distance)
 {
-  CandidateList& pqueue = candidates[queryIndex];
-  Candidate c = std::make_pair(distance, neighbor);
-
-  if (CandidateCmp()(c, pqueue.top()))
-  {
-    pqueue.pop();
-    pqueue.push(c);
-  }
+  candidates->Insert(queryIndex, neighbor, distance);
 }
 
 } // namespace neighbor
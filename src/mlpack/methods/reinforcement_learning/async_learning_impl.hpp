@@ -14,7 +14,7 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "queue"
+#include <atomic>
 
 namespace mlpack {
 namespace rl {
@@ -68,22 +68,18 @@ void AsyncLearning<
   NetworkType learningNetwork = std::move(this->learningNetwork);
   if (learningNetwork.Parameters().is_empty())
     learningNetwork.ResetParameters();
-  NetworkType targetNetwork = learningNetwork;
   size_t totalSteps = 0;
   PolicyType policy = this->policy;
-  bool stop = false;
+  std::atomic<bool> stop(false);
 
-  // Set up worker pool, worker 0 will be deterministic for evaluation.
+  // Set up worker pool, worker 0 will be deterministic for evaluation.  Each
+  // worker keeps its own copy of the target network.
   std::vector<WorkerType> workers;
   for (size_t i = 0; i <= config.NumWorkers(); ++i)
   {
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
 
   /**
    * Compute the number of threads for the for-loop. In general, we should use
@@ -93,11 +89,18 @@ void AsyncLearning<
   size_t numThreads = 0;
   #pragma omp parallel reduction(+:numThreads)
   numThreads++;
+  numThreads = std::min(numThreads, workers.size());
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
-      targetNetwork, totalSteps, policy)
-  for (omp_size_t i = 0; i < numThreads; ++i)
+  /**
+   * Each worker is bound to one thread (worker i to thread i % numThreads), and
+   * each thread steps its workers in turn, so no thread ever waits for a
+   * worker.  The workers update the shared learning network without locks, in
+   * the style of Hogwild!.
+   */
+  #pragma omp parallel for num_threads(numThreads) shared(stop, workers, \
+      learningNetwork, totalSteps, policy)
+  for (omp_size_t i = 0; i < (omp_size_t) numThreads; ++i)
   {
     #pragma omp critical
     {
@@ -106,34 +109,23 @@ void AsyncLearning<
             " started." << std::endl;
       #endif
     }
-    size_t task = std::numeric_limits<size_t>::max();
+
+    size_t task = i;
     while (!stop)
     {
-      // Assign task to current thread from queue.
-      #pragma omp critical
-      {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
-        {
-          task = tasks.front();
-          tasks.pop();
-        }
-      };
-
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
-        continue;
-
       // Get corresponding worker.
       WorkerType& worker = workers[task];
       double episodeReturn;
-      if (worker.Step(learningNetwork, targetNetwork, totalSteps,
-          policy, episodeReturn) && !task)
+      if (worker.Step(learningNetwork, totalSteps, policy, episodeReturn) &&
+          !task)
       {
         stop = measure(episodeReturn);
       }
+
+      // Move to the next worker of this thread.
+      task += numThreads;
+      if (task >= workers.size())
+        task = i;
     }
   }
 
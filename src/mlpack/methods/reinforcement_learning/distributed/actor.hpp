@@ -0,0 +1,220 @@
+/**
+ * @file actor.hpp
+ *
+ * An actor for distributed reinforcement learning, which runs an environment
+ * and sends the transitions it sees to a learner.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_DISTRIBUTED_ACTOR_HPP
+#define MLPACK_METHODS_RL_DISTRIBUTED_ACTOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * An actor runs its own copy of an environment with a behavior policy (such
+ * as GreedyPolicy or AggregatedPolicy) and its own copy of the network, and
+ * sends the transitions it sees to a learner through a transport (such as
+ * LocalTransport).  The learner (QLearning::Learn()) stores the transitions in
+ * its replay memory, trains on them, and publishes its parameters, which the
+ * actor picks up every few steps.  This is the architecture of Ape-X:
+ *
+ * @code
+ * @inproceedings{horgan2018distributed,
+ *   title     = {Distributed Prioritized Experience Replay},
+ *   author    = {Horgan, Dan and Quan, John and Budden, David and
+ *                Barth-Maron, Gabriel and Hessel, Matteo and
+ *                van Hasselt, Hado and Silver, David},
+ *   booktitle = {International Conference on Learning Representations},
+ *   year      = {2018}
+ * }
+ * @endcode
+ *
+ * Since the actors only need the transport to reach the learner, many actors
+ * can run on many threads (or, with a suitable transport, processes) while one
+ * learner trains.  For instance, with OpenMP:
+ *
+ * @code
+ * LocalTransport<CartPole> transport;
+ * #pragma omp parallel
+ * {
+ *   if (omp_get_thread_num() == 0)
+ *   {
+ *     while (...)
+ *       agent.Learn(transport);
+ *   }
+ *   else
+ *   {
+ *     Actor<CartPole, NetworkType, GreedyPolicy<CartPole>,
+ *         LocalTransport<CartPole>> actor(network, policy);
+ *     double episodeReturn;
+ *     while (...)
+ *       actor.Step(transport, episodeReturn);
+ *   }
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType The environment to run.
+ * @tparam NetworkType The network to compute action values.
+ * @tparam PolicyType The behavior policy.
+ * @tparam TransportType The transport to the learner.
+ */
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename PolicyType,
+  typename TransportType
+>
+class Actor
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for the transitions sent to the learner.
+  using TransitionType = std::tuple<StateType, ActionType, double, StateType,
+      bool>;
+
+  /**
+   * Create the actor, and start its first episode.
+   *
+   * @param network The network to compute action values; its parameters are
+   *     replaced by the ones published by the learner.
+   * @param policy The behavior policy.
+   * @param environment The environment to run.
+   * @param pushInterval Number of steps between pushes of transitions.
+   * @param syncInterval Number of steps between fetches of the parameters.
+   * @param stepLimit Maximum number of steps of each episode (0 means no
+   *     limit).
+   */
+  Actor(NetworkType network,
+        PolicyType policy,
+        EnvironmentType environment = EnvironmentType(),
+        const size_t pushInterval = 50,
+        const size_t syncInterval = 400,
+        const size_t stepLimit = 0) :
+      network(std::move(network)),
+      policy(std::move(policy)),
+      environment(std::move(environment)),
+      pushInterval(pushInterval),
+      syncInterval(syncInterval),
+      stepLimit(stepLimit),
+      version(0),
+      totalSteps(0)
+  {
+    if (this->network.Parameters().is_empty())
+      this->network.ResetParameters();
+    Reset();
+  }
+
+  /**
+   * Take one step in the environment.  Every pushInterval steps, and at the end
+   * of each episode, the new transitions are pushed to the learner; every
+   * syncInterval steps, the latest parameters of the learner are fetched.
+   *
+   * @param transport The transport to the learner.
+   * @param episodeReturn This will be the episode return if the episode ends
+   *     after this step.  Otherwise this is invalid.
+   * @return Whether the episode ended after this step.
+   */
+  bool Step(TransportType& transport, double& episodeReturn)
+  {
+    if (totalSteps % syncInterval == 0)
+      version = transport.Fetch(network.Parameters(), version);
+
+    arma::colvec actionValue;
+    network.Predict(state.Encode(), actionValue);
+    const ActionType action = policy.Sample(actionValue);
+    StateType nextState;
+    const double reward = environment.Sample(state, action, nextState);
+    const bool terminal = environment.IsTerminal(nextState);
+
+    pending.push_back(std::make_tuple(state, action, reward, nextState,
+        terminal));
+    currentReturn += reward;
+    steps++;
+    totalSteps++;
+    policy.Anneal();
+
+    const bool ended = terminal || (stepLimit != 0 && steps >= stepLimit);
+    if (ended || pending.size() >= pushInterval)
+      transport.Push(pending);
+
+    if (ended)
+    {
+      episodeReturn = currentReturn;
+      Reset();
+      return true;
+    }
+
+    state = nextState;
+    return false;
+  }
+
+  //! Get the total number of steps taken by the actor.
+  size_t TotalSteps() const { return totalSteps; }
+
+  //! Get the behavior policy.
+  const PolicyType& Policy() const { return policy; }
+  //! Modify the behavior policy.
+  PolicyType& Policy() { return policy; }
+
+ private:
+  //! Start a new episode.
+  void Reset()
+  {
+    steps = 0;
+    currentReturn = 0.0;
+    state = environment.InitialSample();
+  }
+
+  //! Locally-stored network.
+  NetworkType network;
+
+  //! Locally-stored behavior policy.
+  PolicyType policy;
+
+  //! Locally-stored environment.
+  EnvironmentType environment;
+
+  //! Number of steps between pushes of transitions.
+  size_t pushInterval;
+
+  //! Number of steps between fetches of the parameters.
+  size_t syncInterval;
+
+  //! Maximum number of steps of each episode.
+  size_t stepLimit;
+
+  //! Version of the parameters of the network.
+  size_t version;
+
+  //! Total number of steps taken.
+  size_t totalSteps;
+
+  //! Number of steps in the current episode.
+  size_t steps;
+
+  //! Return so far of the current episode.
+  double currentReturn;
+
+  //! Current state.
+  StateType state;
+
+  //! Transitions not pushed yet.
+  std::vector<TransitionType> pending;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * @file local_transport.hpp
+ *
+ * A transport between actors and a learner that run in the same process.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_DISTRIBUTED_LOCAL_TRANSPORT_HPP
+#define MLPACK_METHODS_RL_DISTRIBUTED_LOCAL_TRANSPORT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A transport carries transitions from Actor objects to a learner (see
+ * QLearning::Learn()), and the parameters of the learning network back to the
+ * actors.  Any class with the following interface can be used as a transport,
+ * so the actors and the learner can be in different threads, processes or
+ * machines, as long as the transport can move the data between them:
+ *
+ * @code
+ * // Send the given transitions to the learner, and clear them.
+ * void Push(std::vector<TransitionType>& transitions);
+ *
+ * // Store all the transitions sent so far in the given replay memory, and
+ * // return how many there were.
+ * template<typename ReplayType>
+ * size_t Pull(ReplayType& replay);
+ *
+ * // Send new parameters to the actors.
+ * void Publish(const arma::mat& parameters);
+ *
+ * // If parameters newer than the given version have been published, copy
+ * // them; return the version of the parameters that are now held.
+ * size_t Fetch(arma::mat& parameters, const size_t version);
+ * @endcode
+ *
+ * LocalTransport is the transport for actors and a learner that run on
+ * different threads of the same process.  It keeps the pushed transitions and
+ * the last published parameters in memory, behind locks.
+ *
+ * @tparam EnvironmentType The environment the actors run.
+ */
+template<typename EnvironmentType>
+class LocalTransport
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! A transition: state, action, reward, next state and whether the next
+  //! state is terminal.
+  using TransitionType = std::tuple<StateType, ActionType, double, StateType,
+      bool>;
+
+  //! Create the transport, with no transitions and no parameters.
+  LocalTransport() : version(0) { /* Nothing to do here. */ }
+
+  /**
+   * Send the given transitions to the learner.  The given vector is emptied.
+   *
+   * @param newTransitions Transitions to send.
+   */
+  void Push(std::vector<TransitionType>& newTransitions)
+  {
+    #pragma omp critical(LocalTransportTransitions)
+    {
+      transitions.insert(transitions.end(),
+          std::make_move_iterator(newTransitions.begin()),
+          std::make_move_iterator(newTransitions.end()));
+    }
+
+    newTransitions.clear();
+  }
+
+  /**
+   * Store all the transitions sent so far in the given replay memory.
+   *
+   * @param replay Replay memory to store the transitions in.
+   * @return Number of transitions stored.
+   */
+  template<typename ReplayType>
+  size_t Pull(ReplayType& replay)
+  {
+    // Take the transitions out of the lock before storing them, so that the
+    // actors are not held up.
+    std::vector<TransitionType> pulled;
+    #pragma omp critical(LocalTransportTransitions)
+    {
+      pulled.swap(transitions);
+    }
+
+    for (size_t i = 0; i < pulled.size(); ++i)
+    {
+      replay.Store(std::get<0>(pulled[i]), std::get<1>(pulled[i]),
+          std::get<2>(pulled[i]), std::get<3>(pulled[i]),
+          std::get<4>(pulled[i]));
+    }
+
+    return pulled.size();
+  }
+
+  /**
+   * Send new parameters to the actors.
+   *
+   * @param newParameters Parameters of the learning network.
+   */
+  void Publish(const arma::mat& newParameters)
+  {
+    // Copy outside of the lock, then swap the copy in.
+    arma::mat copy = newParameters;
+    #pragma omp critical(LocalTransportParameters)
+    {
+      parameters.swap(copy);
+      version++;
+    }
+  }
+
+  /**
+   * Copy the last published parameters, if they are newer than the given
+   * version.
+   *
+   * @param parametersOut Parameters to overwrite.
+   * @param currentVersion Version of the parameters held by the caller.
+   * @return Version of the parameters now held by the caller.
+   */
+  size_t Fetch(arma::mat& parametersOut, const size_t currentVersion)
+  {
+    size_t newVersion;
+    #pragma omp critical(LocalTransportParameters)
+    {
+      newVersion = version;
+      if (newVersion != currentVersion)
+        parametersOut = parameters;
+    }
+
+    return newVersion;
+  }
+
+  //! Get the number of transitions waiting to be pulled.
+  size_t Pending()
+  {
+    size_t pending;
+    #pragma omp critical(LocalTransportTransitions)
+    {
+      pending = transitions.size();
+    }
+
+    return pending;
+  }
+
+ private:
+  //! The transitions pushed but not pulled yet.
+  std::vector<TransitionType> transitions;
+
+  //! The last published parameters.
+  arma::mat parameters;
+
+  //! The number of times parameters have been published.
+  size_t version;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
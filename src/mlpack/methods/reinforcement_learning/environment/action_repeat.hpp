@@ -0,0 +1,125 @@
+/**
+ * @file action_repeat.hpp
+ *
+ * Action repeat wrapper for RL environments.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_ACTION_REPEAT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_ACTION_REPEAT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Wrapper that repeats each action for NumRepeats steps of an environment (or
+ * until a terminal state is reached), and returns the sum of the rewards, so
+ * that the agent only has to choose an action every NumRepeats steps.  The
+ * intermediate states are kept in a state held by the wrapper, so stepping
+ * does not allocate memory.
+ *
+ * See FrameStack for how the wrappers can be nested.
+ *
+ * @tparam EnvironmentType A type of Environment that is being wrapped.
+ * @tparam NumRepeats Number of steps each action is taken for.
+ */
+template <typename EnvironmentType, size_t NumRepeats>
+class ActionRepeat
+{
+ public:
+  //! Convenient typedef for state.
+  using State = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using Action = typename EnvironmentType::Action;
+
+  /**
+   * Constructor for creating an ActionRepeat instance.
+   *
+   * @param environment An instance of the environment used for actual
+   *                    simulations.
+   */
+  ActionRepeat(const EnvironmentType& environment = EnvironmentType()) :
+      environment(environment)
+  {
+    static_assert(NumRepeats > 0, "ActionRepeat needs at least one repeat.");
+  }
+
+  /**
+   * Get the initial state of the wrapped environment.
+   */
+  State InitialSample()
+  {
+    return environment.InitialSample();
+  }
+
+  /**
+   * Checks whether given state is a terminal state of the wrapped environment.
+   *
+   * @param state desired state.
+   * @return true if state is a terminal state, otherwise false.
+   */
+  bool IsTerminal(const State& state) const
+  {
+    return environment.IsTerminal(state);
+  }
+
+  /**
+   * Dynamics of Environment.  The action is taken NumRepeats times, or until
+   * a terminal state is reached.
+   *
+   * @param state The current state.
+   * @param action The current action.
+   * @param nextState The next state.
+   * @return Sum of the rewards of the steps.
+   */
+  double Sample(const State& state,
+                const Action& action,
+                State& nextState)
+  {
+    double reward = environment.Sample(state, action, nextState);
+    for (size_t i = 1; i < NumRepeats && !environment.IsTerminal(nextState);
+        ++i)
+    {
+      reward += environment.Sample(nextState, action, scratch);
+      std::swap(nextState, scratch);
+    }
+
+    return reward;
+  }
+
+  /**
+   * Dynamics of Environment.
+   *
+   * @param state The current state.
+   * @param action The current action.
+   * @return Sum of the rewards of the steps.
+   */
+  double Sample(const State& state, const Action& action)
+  {
+    State nextState;
+    return Sample(state, action, nextState);
+  }
+
+  //! Get the environment.
+  const EnvironmentType& Environment() const { return environment; }
+  //! Modify the environment.
+  EnvironmentType& Environment() { return environment; }
+
+ private:
+  //! Locally-stored wrapped environment.
+  EnvironmentType environment;
+
+  //! Intermediate state of the repeated steps.
+  State scratch;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * @file batch_environment.hpp
+ *
+ * An adapter that runs several instances of an RL environment and writes their
+ * observations into buffers given by the caller.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_BATCH_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_BATCH_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A batch environment runs several instances of a task at once, and writes
+ * what it observes into buffers that the caller owns, so that a training loop
+ * can reuse the same matrices at every step.  Any class with the following
+ * interface is a batch environment:
+ *
+ * @code
+ * // Get the number of instances.
+ * size_t NumEnvironments() const;
+ *
+ * // Get the dimension of an observation.
+ * size_t Dimension() const;
+ *
+ * // Start a new episode in each instance, and write the initial observations
+ * // into the columns of the given matrix.
+ * void Reset(arma::mat& observations);
+ *
+ * // Take the given action in each instance, and write the next observations,
+ * // the rewards, and whether each episode is done.  An instance that was done
+ * // after the previous call ignores its action, and starts a new episode
+ * // instead (with reward 0 and done false).
+ * void Step(const arma::Col<size_t>& actions,
+ *           arma::mat& observations,
+ *           arma::rowvec& rewards,
+ *           arma::urowvec& done);
+ * @endcode
+ *
+ * The buffers are only resized if they do not have the right size already, so
+ * a loop that passes the same buffers at each step does not allocate memory.
+ * Since done instances restart on the following step, the observation written
+ * when an episode ends is still the last (e.g. terminal) one.
+ *
+ * BatchEnvironment adapts any of the environments in this directory (like
+ * CartPole or MountainCar) to the interface; ExternalEnvironment connects to a
+ * simulator that runs outside of mlpack.
+ *
+ * @tparam EnvironmentType The environment to run.
+ */
+template <typename EnvironmentType>
+class BatchEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the environment.  Reset() must be
+   * called before the first Step().
+   *
+   * @param numEnvironments Number of environment instances.
+   * @param environment Environment to copy.
+   * @param stepLimit Maximum number of steps of each episode (0 means no
+   *     limit).
+   * @param dimension The dimension of an encoded state.
+   */
+  BatchEnvironment(const size_t numEnvironments,
+                   const EnvironmentType& environment = EnvironmentType(),
+                   const size_t stepLimit = 0,
+                   const size_t dimension = StateType::dimension) :
+      environments(numEnvironments, environment),
+      states(numEnvironments),
+      nextStates(numEnvironments),
+      steps(numEnvironments, 0),
+      ended(numEnvironments, true),
+      stepLimit(stepLimit),
+      dimension(dimension)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Start a new episode in each instance.
+   *
+   * @param observations Matrix to write the initial observations into.
+   */
+  void Reset(arma::mat& observations)
+  {
+    observations.set_size(dimension, environments.size());
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      Restart(i);
+      observations.col(i) = states[i].Encode();
+    }
+  }
+
+  /**
+   * Take the given action in each instance (or start a new episode, if the
+   * instance was done), and write what is observed.
+   *
+   * @param actions Action to take in each instance.
+   * @param observations Matrix to write the next observations into.
+   * @param rewards Vector to write the rewards into.
+   * @param done Vector to write whether each episode is done into.
+   */
+  void Step(const arma::Col<size_t>& actions,
+            arma::mat& observations,
+            arma::rowvec& rewards,
+            arma::urowvec& done)
+  {
+    observations.set_size(dimension, environments.size());
+    rewards.set_size(environments.size());
+    done.set_size(environments.size());
+
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      if (ended[i])
+      {
+        Restart(i);
+        rewards[i] = 0.0;
+      }
+      else
+      {
+        rewards[i] = environments[i].Sample(states[i],
+            static_cast<ActionType>(actions[i]), nextStates[i]);
+        std::swap(states[i], nextStates[i]);
+        ++steps[i];
+        ended[i] = environments[i].IsTerminal(states[i]) ||
+            (stepLimit != 0 && steps[i] >= stepLimit);
+      }
+
+      observations.col(i) = states[i].Encode();
+      done[i] = ended[i];
+    }
+  }
+
+  //! Get the number of environment instances.
+  size_t NumEnvironments() const { return environments.size(); }
+
+  //! Get the dimension of an observation.
+  size_t Dimension() const { return dimension; }
+
+  //! Get the given environment instance.
+  const EnvironmentType& Environment(const size_t i) const
+  { return environments[i]; }
+  //! Modify the given environment instance.
+  EnvironmentType& Environment(const size_t i) { return environments[i]; }
+
+  //! Get the current state of the given instance.
+  const StateType& State(const size_t i) const { return states[i]; }
+
+  //! Get the maximum number of steps of each episode.
+  size_t StepLimit() const { return stepLimit; }
+  //! Modify the maximum number of steps of each episode (0 means no limit).
+  size_t& StepLimit() { return stepLimit; }
+
+ private:
+  //! Start a new episode in the given instance.
+  void Restart(const size_t i)
+  {
+    states[i] = environments[i].InitialSample();
+    steps[i] = 0;
+    ended[i] = false;
+  }
+
+  //! The environment instances.
+  std::vector<EnvironmentType> environments;
+
+  //! The current state of each instance.
+  std::vector<StateType> states;
+
+  //! Scratch space for the next state of each instance.
+  std::vector<StateType> nextStates;
+
+  //! The number of steps in the current episode of each instance.
+  std::vector<size_t> steps;
+
+  //! Whether the episode of each instance is done.
+  std::vector<bool> ended;
+
+  //! The maximum number of steps of each episode.
+  size_t stepLimit;
+
+  //! The dimension of an observation.
+  size_t dimension;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
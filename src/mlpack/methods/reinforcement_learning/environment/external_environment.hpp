@@ -0,0 +1,173 @@
+/**
+ * @file external_environment.hpp
+ *
+ * A batch environment backed by a simulator that runs outside of mlpack and
+ * exchanges data through memory buffers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_EXTERNAL_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_EXTERNAL_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <functional>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * ExternalEnvironment is a batch environment (see BatchEnvironment) for a
+ * simulator that runs outside of mlpack, in another library or another
+ * process.  The simulator and mlpack share four buffers, for instance in a
+ * shared memory segment mapped into both processes:
+ *
+ *  - the actions (numEnvironments size_t values), written by mlpack;
+ *  - the observations (dimension x numEnvironments doubles, column-major),
+ *    written by the simulator;
+ *  - the rewards (numEnvironments doubles), written by the simulator;
+ *  - whether each episode is done (numEnvironments arma::uword values),
+ *    written by the simulator.
+ *
+ * The two given callbacks tell the simulator to reset or to step (e.g. by
+ * posting a semaphore) and must only return once the simulator has filled the
+ * buffers.  The simulator must follow the semantics of Step() described in
+ * BatchEnvironment.
+ *
+ * The observations, rewards and done flags are used in place: Observations(),
+ * Rewards() and Done() are matrices that alias the shared buffers, and when
+ * they are the buffers passed to Reset() and Step(), nothing is copied at all.
+ * Other buffers get a copy.
+ *
+ * @code
+ * ExternalEnvironment env(dimension, numEnvironments, actions, observations,
+ *     rewards, done, [&]() { simulator.Reset(); },
+ *     [&]() { simulator.Step(); });
+ * env.Reset(env.Observations());
+ * while (...)
+ * {
+ *   network.Predict(env.Observations(), actionValues);
+ *   env.Step(BestAction(actionValues), env.Observations(), env.Rewards(),
+ *       env.Done());
+ * }
+ * @endcode
+ */
+class ExternalEnvironment
+{
+ public:
+  /**
+   * Create the environment over the given buffers, which must stay valid for
+   * the lifetime of the object.
+   *
+   * @param dimension Dimension of an observation.
+   * @param numEnvironments Number of instances run by the simulator.
+   * @param actions Buffer for the actions.
+   * @param observations Buffer for the observations.
+   * @param rewards Buffer for the rewards.
+   * @param done Buffer for whether each episode is done.
+   * @param reset Callback that makes the simulator reset every instance.
+   * @param step Callback that makes the simulator take the actions.
+   */
+  ExternalEnvironment(const size_t dimension,
+                      const size_t numEnvironments,
+                      size_t* actions,
+                      double* observations,
+                      double* rewards,
+                      arma::uword* done,
+                      std::function<void()> reset,
+                      std::function<void()> step) :
+      actions(actions),
+      observations(observations, dimension, numEnvironments, false, true),
+      rewards(rewards, numEnvironments, false, true),
+      done(done, numEnvironments, false, true),
+      reset(std::move(reset)),
+      step(std::move(step))
+  { /* Nothing to do here. */ }
+
+  //! A copy would not alias the shared buffers, so copying is not allowed.
+  ExternalEnvironment(const ExternalEnvironment&) = delete;
+  //! A copy would not alias the shared buffers, so copying is not allowed.
+  ExternalEnvironment& operator=(const ExternalEnvironment&) = delete;
+
+  /**
+   * Make the simulator start a new episode in each instance.
+   *
+   * @param observationsOut Matrix to write the initial observations into.
+   */
+  void Reset(arma::mat& observationsOut)
+  {
+    reset();
+    observationsOut = observations;
+  }
+
+  /**
+   * Make the simulator take the given action in each instance.
+   *
+   * @param actionsIn Action to take in each instance.
+   * @param observationsOut Matrix to write the next observations into.
+   * @param rewardsOut Vector to write the rewards into.
+   * @param doneOut Vector to write whether each episode is done into.
+   */
+  void Step(const arma::Col<size_t>& actionsIn,
+            arma::mat& observationsOut,
+            arma::rowvec& rewardsOut,
+            arma::urowvec& doneOut)
+  {
+    for (size_t i = 0; i < observations.n_cols; ++i)
+      actions[i] = actionsIn[i];
+
+    step();
+
+    // Nothing is copied if the outputs are the shared buffers themselves.
+    observationsOut = observations;
+    rewardsOut = rewards;
+    doneOut = done;
+  }
+
+  //! Get the number of environment instances.
+  size_t NumEnvironments() const { return observations.n_cols; }
+
+  //! Get the dimension of an observation.
+  size_t Dimension() const { return observations.n_rows; }
+
+  //! Get the shared observations.
+  const arma::mat& Observations() const { return observations; }
+  //! Get the shared observations, to pass to Reset() and Step().
+  arma::mat& Observations() { return observations; }
+
+  //! Get the shared rewards.
+  const arma::rowvec& Rewards() const { return rewards; }
+  //! Get the shared rewards, to pass to Step().
+  arma::rowvec& Rewards() { return rewards; }
+
+  //! Get the shared done flags.
+  const arma::urowvec& Done() const { return done; }
+  //! Get the shared done flags, to pass to Step().
+  arma::urowvec& Done() { return done; }
+
+ private:
+  //! The shared actions.
+  size_t* actions;
+
+  //! The shared observations.
+  arma::mat observations;
+
+  //! The shared rewards.
+  arma::rowvec rewards;
+
+  //! The shared done flags.
+  arma::urowvec done;
+
+  //! Callback that makes the simulator reset.
+  std::function<void()> reset;
+
+  //! Callback that makes the simulator step.
+  std::function<void()> step;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
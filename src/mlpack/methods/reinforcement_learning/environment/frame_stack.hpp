@@ -0,0 +1,172 @@
+/**
+ * @file frame_stack.hpp
+ *
+ * Frame stacking wrapper for RL environments.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_FRAME_STACK_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_FRAME_STACK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Wrapper that makes the encoded state of an environment the concatenation of
+ * the encoded states of the last NumFrames steps, oldest first, so that an
+ * agent can see how the state changes.  At the start of an episode, the
+ * initial state fills every frame.
+ *
+ * Like the other wrappers (RewardClipping, ObservationNormalization and
+ * ActionRepeat), this is itself an environment, so wrappers can be nested,
+ * e.g. ActionRepeat<FrameStack<CartPole, 4>, 2>; the calls are resolved at
+ * compile time.  Each state holds its stacked frames, whose size is fixed, so
+ * stepping does not allocate memory.
+ *
+ * @tparam EnvironmentType A type of Environment that is being wrapped.
+ * @tparam NumFrames Number of frames to stack.
+ */
+template <typename EnvironmentType, size_t NumFrames>
+class FrameStack
+{
+ public:
+  //! Convenient typedef for the state of the wrapped environment.
+  using InnerState = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using Action = typename EnvironmentType::Action;
+
+  /**
+   * The state of the wrapped environment, along with the stacked frames.
+   */
+  class State
+  {
+   public:
+    /**
+     * Construct a state instance.
+     */
+    State() : data(dimension, arma::fill::zeros)
+    { /* Nothing to do here. */ }
+
+    /**
+     * Construct a state instance whose frames are all the given state.
+     *
+     * @param inner State of the wrapped environment.
+     */
+    State(const InnerState& inner) :
+        inner(inner),
+        data(arma::repmat(inner.Encode(), NumFrames, 1))
+    { /* Nothing to do here. */ }
+
+    //! Get the state of the wrapped environment.
+    const InnerState& Inner() const { return inner; }
+    //! Modify the state of the wrapped environment.
+    InnerState& Inner() { return inner; }
+
+    //! Modify the stacked frames.
+    arma::colvec& Data() { return data; }
+
+    //! Encode the state to a column vector.
+    const arma::colvec& Encode() const { return data; }
+
+    //! Dimension of the encoded state.
+    static constexpr size_t dimension = NumFrames * InnerState::dimension;
+
+   private:
+    //! Locally-stored state of the wrapped environment.
+    InnerState inner;
+
+    //! Locally-stored frames, oldest first.
+    arma::colvec data;
+  };
+
+  /**
+   * Constructor for creating a FrameStack instance.
+   *
+   * @param environment An instance of the environment used for actual
+   *                    simulations.
+   */
+  FrameStack(const EnvironmentType& environment = EnvironmentType()) :
+      environment(environment)
+  {
+    static_assert(NumFrames > 0, "FrameStack needs at least one frame.");
+  }
+
+  /**
+   * Get the initial state, with the initial state of the wrapped environment
+   * in every frame.
+   */
+  State InitialSample()
+  {
+    return State(environment.InitialSample());
+  }
+
+  /**
+   * Checks whether given state is a terminal state of the wrapped environment.
+   *
+   * @param state desired state.
+   * @return true if state is a terminal state, otherwise false.
+   */
+  bool IsTerminal(const State& state) const
+  {
+    return environment.IsTerminal(state.Inner());
+  }
+
+  /**
+   * Dynamics of Environment.  The frames of the next state are the frames of
+   * the given state, shifted by one, and the next state of the wrapped
+   * environment.
+   *
+   * @param state The current state.
+   * @param action The current action.
+   * @param nextState The next state.
+   * @return Reward of the wrapped environment.
+   */
+  double Sample(const State& state,
+                const Action& action,
+                State& nextState)
+  {
+    const double reward = environment.Sample(state.Inner(), action,
+        nextState.Inner());
+
+    const size_t frame = InnerState::dimension;
+    arma::colvec& next = nextState.Data();
+    if (NumFrames > 1)
+      next.head(next.n_elem - frame) = state.Encode().tail(next.n_elem - frame);
+    next.tail(frame) = nextState.Inner().Encode();
+
+    return reward;
+  }
+
+  /**
+   * Dynamics of Environment.
+   *
+   * @param state The current state.
+   * @param action The current action.
+   * @return Reward of the wrapped environment.
+   */
+  double Sample(const State& state, const Action& action)
+  {
+    State nextState;
+    return Sample(state, action, nextState);
+  }
+
+  //! Get the environment.
+  const EnvironmentType& Environment() const { return environment; }
+  //! Modify the environment.
+  EnvironmentType& Environment() { return environment; }
+
+ private:
+  //! Locally-stored wrapped environment.
+  EnvironmentType environment;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,217 @@
+/**
+ * @file observation_normalization.hpp
+ *
+ * Observation normalization wrapper for RL environments.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_OBSERVATION_NORMALIZATION_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_OBSERVATION_NORMALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Wrapper that normalizes the encoded states of an environment, with the
+ * running mean and variance of all the encoded states it has seen:
+ *
+ * \f$ \hat{x} = \max(-c, \min(c, (x - \mu) / \sqrt{\sigma^2 + \epsilon})) \f$
+ *
+ * The statistics are updated at every step, unless Update() is set to false
+ * (e.g. to evaluate an agent).  Each copy of the wrapper keeps its own
+ * statistics.  The statistics and the normalized data of each state are
+ * allocated once, so stepping does not allocate memory.
+ *
+ * See FrameStack for how the wrappers can be nested.
+ *
+ * @tparam EnvironmentType A type of Environment that is being wrapped.
+ */
+template <typename EnvironmentType>
+class ObservationNormalization
+{
+ public:
+  //! Convenient typedef for the state of the wrapped environment.
+  using InnerState = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using Action = typename EnvironmentType::Action;
+
+  /**
+   * The state of the wrapped environment, along with its normalized encoding.
+   */
+  class State
+  {
+   public:
+    /**
+     * Construct a state instance.
+     */
+    State() : data(dimension, arma::fill::zeros)
+    { /* Nothing to do here. */ }
+
+    //! Get the state of the wrapped environment.
+    const InnerState& Inner() const { return inner; }
+    //! Modify the state of the wrapped environment.
+    InnerState& Inner() { return inner; }
+
+    //! Modify the normalized encoding.
+    arma::colvec& Data() { return data; }
+
+    //! Encode the state to a column vector.
+    const arma::colvec& Encode() const { return data; }
+
+    //! Dimension of the encoded state.
+    static constexpr size_t dimension = InnerState::dimension;
+
+   private:
+    //! Locally-stored state of the wrapped environment.
+    InnerState inner;
+
+    //! Locally-stored normalized encoding.
+    arma::colvec data;
+  };
+
+  /**
+   * Constructor for creating an ObservationNormalization instance.
+   *
+   * @param environment An instance of the environment used for actual
+   *                    simulations.
+   * @param clip Maximum absolute value of a normalized element.
+   * @param epsilon Value added to the variance, for numerical stability.
+   */
+  ObservationNormalization(const EnvironmentType& environment =
+                               EnvironmentType(),
+                           const double clip = 10.0,
+                           const double epsilon = 1e-8) :
+      environment(environment),
+      clip(clip),
+      epsilon(epsilon),
+      update(true),
+      count(0),
+      mean(State::dimension, arma::fill::zeros),
+      sumSquares(State::dimension, arma::fill::zeros)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Get the initial state of the wrapped environment, normalized.
+   */
+  State InitialSample()
+  {
+    State state;
+    state.Inner() = environment.InitialSample();
+    Normalize(state);
+    return state;
+  }
+
+  /**
+   * Checks whether given state is a terminal state of the wrapped environment.
+   *
+   * @param state desired state.
+   * @return true if state is a terminal state, otherwise false.
+   */
+  bool IsTerminal(const State& state) const
+  {
+    return environment.IsTerminal(state.Inner());
+  }
+
+  /**
+   * Dynamics of Environment.  The next state of the wrapped environment is
+   * normalized.
+   *
+   * @param state The current state.
+   * @param action The current action.
+   * @param nextState The next state.
+   * @return Reward of the wrapped environment.
+   */
+  double Sample(const State& state,
+                const Action& action,
+                State& nextState)
+  {
+    const double reward = environment.Sample(state.Inner(), action,
+        nextState.Inner());
+    Normalize(nextState);
+    return reward;
+  }
+
+  /**
+   * Dynamics of Environment.
+   *
+   * @param state The current state.
+   * @param action The current action.
+   * @return Reward of the wrapped environment.
+   */
+  double Sample(const State& state, const Action& action)
+  {
+    State nextState;
+    return Sample(state, action, nextState);
+  }
+
+  //! Get the environment.
+  const EnvironmentType& Environment() const { return environment; }
+  //! Modify the environment.
+  EnvironmentType& Environment() { return environment; }
+
+  //! Get whether the statistics are updated at every step.
+  bool Update() const { return update; }
+  //! Modify whether the statistics are updated at every step.
+  bool& Update() { return update; }
+
+  //! Get the running mean of the encoded states.
+  const arma::colvec& Mean() const { return mean; }
+
+  //! Get the number of encoded states seen.
+  size_t Count() const { return count; }
+
+ private:
+  //! Update the statistics with the given state (if enabled), and normalize
+  //! its encoding.
+  void Normalize(State& state)
+  {
+    const arma::colvec& encoded = state.Inner().Encode();
+    if (update)
+    {
+      // Welford's update of the mean and the sum of squared differences.
+      ++count;
+      for (size_t d = 0; d < encoded.n_elem; ++d)
+      {
+        const double delta = encoded[d] - mean[d];
+        mean[d] += delta / count;
+        sumSquares[d] += delta * (encoded[d] - mean[d]);
+      }
+    }
+
+    const double n = std::max(count, (size_t) 1);
+    state.Data() = arma::clamp((encoded - mean) /
+        arma::sqrt(sumSquares / n + epsilon), -clip, clip);
+  }
+
+  //! Locally-stored wrapped environment.
+  EnvironmentType environment;
+
+  //! Maximum absolute value of a normalized element.
+  double clip;
+
+  //! Value added to the variance.
+  double epsilon;
+
+  //! Whether the statistics are updated at every step.
+  bool update;
+
+  //! Number of encoded states seen.
+  size_t count;
+
+  //! Running mean of the encoded states.
+  arma::colvec mean;
+
+  //! Running sum of squared differences from the mean.
+  arma::colvec sumSquares;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
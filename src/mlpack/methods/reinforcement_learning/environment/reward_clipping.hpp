@@ -22,6 +22,8 @@ namespace rl {
  * (Clipping here is implemented as
  * \f$ g_{\text{clipped}} = \max(g_{\text{min}}, \min(g_{\text{min}}, g))) \f$.)
  *
+ * See FrameStack for how the wrappers can be nested.
+ *
  * @tparam EnvironmentType A type of Environment that is being wrapped.
  */
 
@@ -110,7 +112,7 @@ class RewardClipping
   }
 
   //! Get the environment.
-  EnvironmentType& Environment() const { return environment; }
+  const EnvironmentType& Environment() const { return environment; }
   //! Modify the environment.
   EnvironmentType& Environment() { return environment; }
 
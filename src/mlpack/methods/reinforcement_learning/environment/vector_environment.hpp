@@ -0,0 +1,196 @@
+/**
+ * @file vector_environment.hpp
+ *
+ * A wrapper that steps several instances of an RL environment in lockstep.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * VectorEnvironment holds several instances of an environment, each with its
+ * own current state, and steps all of them at once.  The encoded current
+ * states are kept together as the columns of one matrix, so that the values of
+ * all the states can be computed with a single forward pass of a network.
+ *
+ * One step is taken in two calls: Sample() takes an action in each instance and
+ * keeps the rewards and next states, which can then be read (to store the
+ * transitions, for instance), and Advance() moves each instance to its next
+ * state.  When an episode ends, either in a terminal state or when the step
+ * limit is reached, its return is saved and the instance starts a new episode.
+ *
+ * @tparam EnvironmentType The environment to run.
+ */
+template <typename EnvironmentType>
+class VectorEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the environment, and start an
+   * episode in each.
+   *
+   * @param numEnvironments Number of environment instances.
+   * @param environment Environment to copy.
+   * @param stepLimit Maximum number of steps of each episode (0 means no
+   *     limit).
+   * @param dimension The dimension of an encoded state.
+   */
+  VectorEnvironment(const size_t numEnvironments,
+                    const EnvironmentType& environment = EnvironmentType(),
+                    const size_t stepLimit = 0,
+                    const size_t dimension = StateType::dimension) :
+      environments(numEnvironments, environment),
+      states(numEnvironments),
+      nextStates(numEnvironments),
+      encodedStates(dimension, numEnvironments),
+      rewards(numEnvironments),
+      terminal(numEnvironments),
+      steps(numEnvironments),
+      returns(numEnvironments),
+      stepLimit(stepLimit)
+  {
+    Reset();
+  }
+
+  //! Start a new episode in each environment instance.
+  void Reset()
+  {
+    for (size_t i = 0; i < environments.size(); ++i)
+      Restart(i);
+  }
+
+  /**
+   * Take the given action in each environment instance, from its current
+   * state.  The rewards, next states and whether they are terminal can be read
+   * afterwards; the current states do not change until Advance() is called.
+   *
+   * @param actions Action to take in each instance.
+   */
+  void Sample(const std::vector<ActionType>& actions)
+  {
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      rewards[i] = environments[i].Sample(states[i], actions[i],
+          nextStates[i]);
+      terminal[i] = environments[i].IsTerminal(nextStates[i]);
+    }
+  }
+
+  /**
+   * Move each environment instance to the next state given by the last call to
+   * Sample().  Instances whose episodes have ended start new ones.
+   */
+  void Advance()
+  {
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      returns[i] += rewards[i];
+      ++steps[i];
+      if (terminal[i] || (stepLimit != 0 && steps[i] >= stepLimit))
+      {
+        episodeReturns.push_back(returns[i]);
+        Restart(i);
+      }
+      else
+      {
+        states[i] = nextStates[i];
+        encodedStates.col(i) = states[i].Encode();
+      }
+    }
+  }
+
+  //! Get the number of environment instances.
+  size_t NumEnvironments() const { return environments.size(); }
+
+  //! Get the given environment instance.
+  const EnvironmentType& Environment(const size_t i) const
+  { return environments[i]; }
+  //! Modify the given environment instance.
+  EnvironmentType& Environment(const size_t i) { return environments[i]; }
+
+  //! Get the current state of the given instance.
+  const StateType& State(const size_t i) const { return states[i]; }
+  //! Get the encoded current states, one in each column.
+  const arma::mat& EncodedStates() const { return encodedStates; }
+
+  //! Get the rewards of the last call to Sample().
+  const arma::rowvec& Rewards() const { return rewards; }
+  //! Get the next state of the given instance from the last call to Sample().
+  const StateType& NextState(const size_t i) const { return nextStates[i]; }
+  //! Get whether the next state of the given instance is terminal.
+  bool IsTerminal(const size_t i) const { return terminal[i]; }
+  //! Get whether the episode of the given instance ends with the last call to
+  //! Sample(), in a terminal state or at the step limit.
+  bool EpisodeEnds(const size_t i) const
+  { return terminal[i] || (stepLimit != 0 && steps[i] + 1 >= stepLimit); }
+
+  //! Get the returns of the episodes that have ended, in order.
+  const std::vector<double>& EpisodeReturns() const { return episodeReturns; }
+  //! Modify the returns of the episodes that have ended (e.g. to clear them).
+  std::vector<double>& EpisodeReturns() { return episodeReturns; }
+
+  //! Get the maximum number of steps of each episode.
+  size_t StepLimit() const { return stepLimit; }
+  //! Modify the maximum number of steps of each episode (0 means no limit).
+  size_t& StepLimit() { return stepLimit; }
+
+ private:
+  //! Start a new episode in the given instance.
+  void Restart(const size_t i)
+  {
+    states[i] = environments[i].InitialSample();
+    encodedStates.col(i) = states[i].Encode();
+    steps[i] = 0;
+    returns[i] = 0.0;
+  }
+
+  //! The environment instances.
+  std::vector<EnvironmentType> environments;
+
+  //! The current state of each instance.
+  std::vector<StateType> states;
+
+  //! The next state of each instance, from the last call to Sample().
+  std::vector<StateType> nextStates;
+
+  //! The encoded current states.
+  arma::mat encodedStates;
+
+  //! The rewards of the last call to Sample().
+  arma::rowvec rewards;
+
+  //! Whether each next state is terminal.
+  std::vector<bool> terminal;
+
+  //! The number of steps in the current episode of each instance.
+  std::vector<size_t> steps;
+
+  //! The return so far of the current episode of each instance.
+  arma::rowvec returns;
+
+  //! The maximum number of steps of each episode.
+  size_t stepLimit;
+
+  //! The returns of the episodes that have ended.
+  std::vector<double> episodeReturns;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,225 @@
+/**
+ * @file ppo.hpp
+ *
+ * This file is the definition of the PPO class, which implements the Proximal
+ * Policy Optimization actor-critic algorithm for continuous actions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_PPO_HPP
+#define MLPACK_METHODS_RL_PPO_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "environment/vector_environment.hpp"
+#include "training_config.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of Proximal Policy Optimization (PPO), an actor-critic
+ * algorithm for tasks with continuous actions, such as Pendulum or
+ * ContinuousMountainCar.
+ *
+ * For more details, see the following:
+ * @code
+ * @article{schulman2017proximal,
+ *   title   = {Proximal Policy Optimization Algorithms},
+ *   author  = {Schulman, John and Wolski, Filip and Dhariwal, Prafulla and
+ *              Radford, Alec and Klimov, Oleg},
+ *   journal = {CoRR},
+ *   year    = {2017},
+ *   url     = {http://arxiv.org/abs/1707.06347}
+ * }
+ * @endcode
+ *
+ * The policy is a Gaussian with a fixed standard deviation, whose mean is the
+ * output of the actor network; the critic network estimates the value of a
+ * state.  Each call to Rollout() steps several copies of the environment in
+ * lockstep for a fixed number of steps (each step is one batched forward pass
+ * of the actor), computes the generalized advantage estimates of the whole
+ * rollout at once, and then trains both networks for a few epochs over
+ * shuffled mini-batches of the rollout.
+ *
+ * Both networks are trained through their mean squared error output layer:
+ * the critic towards the returns, and the actor towards means shifted along
+ * the gradient of the clipped PPO objective.  Since the mini-batches go
+ * through FFN::EvaluateWithGradient(), the networks can split each of them
+ * across replicas (see FFN::NumReplicas()).
+ *
+ * The step size, the discount rate and the step limit of each episode are
+ * taken from the given TrainingConfig.
+ *
+ * @tparam EnvironmentType The environment of the reinforcement learning task.
+ * @tparam ActorNetworkType The network to compute the mean of the actions.
+ * @tparam CriticNetworkType The network to compute the value of a state.
+ * @tparam UpdaterType How to apply gradients when training.
+ */
+template <
+  typename EnvironmentType,
+  typename ActorNetworkType,
+  typename CriticNetworkType,
+  typename UpdaterType
+>
+class PPO
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the PPO object with given settings.
+   *
+   * @param config Hyper-parameters for training.
+   * @param actor The network to compute the mean of the actions.
+   * @param critic The network to compute the value of a state.
+   * @param numEnvironments Number of environment instances stepped together.
+   * @param rolloutLength Number of steps of each instance in a rollout.
+   * @param epochs Number of passes over each rollout.
+   * @param batchSize Number of transitions in each mini-batch.
+   * @param gaeLambda Decay of the generalized advantage estimates.
+   * @param clipRange Maximum change of the probability ratio of an action.
+   * @param actionStd Standard deviation of the actions.
+   * @param updater How to apply gradients when training.
+   * @param environment Reinforcement learning task.
+   */
+  PPO(TrainingConfig config,
+      ActorNetworkType actor,
+      CriticNetworkType critic,
+      const size_t numEnvironments = 8,
+      const size_t rolloutLength = 128,
+      const size_t epochs = 4,
+      const size_t batchSize = 64,
+      const double gaeLambda = 0.95,
+      const double clipRange = 0.2,
+      const double actionStd = 0.5,
+      UpdaterType updater = UpdaterType(),
+      EnvironmentType environment = EnvironmentType());
+
+  /**
+   * Collect a rollout of RolloutLength() steps from every environment
+   * instance, and train the actor and the critic on it.  In test mode, the
+   * mean actions are taken and nothing is trained.  The returns of the
+   * episodes that end are kept by Environments().
+   *
+   * @return Total reward of the rollout.
+   */
+  double Rollout();
+
+  /**
+   * Compute the generalized advantage estimates of a rollout.  Each of the
+   * given matrices has one row per environment instance and one column per
+   * step.
+   *
+   * @param rewards Reward of each step.
+   * @param values Estimated value of the state of each step.
+   * @param nextValues Estimated value of the next state of each step.
+   * @param terminal Whether the next state of each step is terminal (1 or 0).
+   * @param ended Whether the episode ends after each step (1 or 0).
+   * @param discount Discount rate of the rewards.
+   * @param lambda Decay of the estimates.
+   * @param advantages Matrix to store the advantage of each step in.
+   */
+  static void Advantages(const arma::mat& rewards,
+                         const arma::mat& values,
+                         const arma::mat& nextValues,
+                         const arma::mat& terminal,
+                         const arma::mat& ended,
+                         const double discount,
+                         const double lambda,
+                         arma::mat& advantages);
+
+  //! Get the environment instances.
+  const VectorEnvironment<EnvironmentType>& Environments() const
+  { return environments; }
+  //! Modify the environment instances (e.g. to clear the episode returns).
+  VectorEnvironment<EnvironmentType>& Environments() { return environments; }
+
+  //! Get the actor network.
+  const ActorNetworkType& Actor() const { return actor; }
+  //! Get the critic network.
+  const CriticNetworkType& Critic() const { return critic; }
+
+  //! Get the number of steps of each instance in a rollout.
+  size_t RolloutLength() const { return rolloutLength; }
+
+  //! Get the total steps taken, in all instances.
+  size_t TotalSteps() const { return totalSteps; }
+
+  //! Modify the training mode / test mode indicator.
+  bool& Deterministic() { return deterministic; }
+  //! Get the indicator of training mode / test mode.
+  const bool& Deterministic() const { return deterministic; }
+
+ private:
+  //! Train both networks on the rollout held in the buffers.
+  void Train();
+
+  //! Locally-stored hyper-parameters.
+  TrainingConfig config;
+
+  //! Locally-stored actor network.
+  ActorNetworkType actor;
+
+  //! Locally-stored critic network.
+  CriticNetworkType critic;
+
+  //! Number of steps of each instance in a rollout.
+  size_t rolloutLength;
+
+  //! Number of passes over each rollout.
+  size_t epochs;
+
+  //! Number of transitions in each mini-batch.
+  size_t batchSize;
+
+  //! Decay of the generalized advantage estimates.
+  double gaeLambda;
+
+  //! Maximum change of the probability ratio of an action.
+  double clipRange;
+
+  //! Standard deviation of the actions.
+  double actionStd;
+
+  //! Locally-stored updater of the actor.
+  UpdaterType actorUpdater;
+
+  //! Locally-stored updater of the critic.
+  UpdaterType criticUpdater;
+
+  //! Locally-stored environment instances.
+  VectorEnvironment<EnvironmentType> environments;
+
+  //! Total steps from the beginning of the task.
+  size_t totalSteps;
+
+  //! Locally-stored flag indicating training mode or test mode.
+  bool deterministic;
+
+  //! Rollout buffers, with one column per transition (step-major), kept
+  //! between rollouts so they are not reallocated.
+  arma::mat states;
+  arma::mat nextStates;
+  arma::mat actions;
+  arma::mat means;
+
+  //! Rollout buffers, with one row per instance and one column per step.
+  arma::mat rewards;
+  arma::mat terminal;
+  arma::mat ended;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+// Include implementation
+#include "ppo_impl.hpp"
+#endif
@@ -0,0 +1,275 @@
+/**
+ * @file ppo_impl.hpp
+ *
+ * This file is the implementation of the PPO class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_PPO_IMPL_HPP
+#define MLPACK_METHODS_RL_PPO_IMPL_HPP
+
+#include "ppo.hpp"
+
+namespace mlpack {
+namespace rl {
+
+template <
+  typename EnvironmentType,
+  typename ActorNetworkType,
+  typename CriticNetworkType,
+  typename UpdaterType
+>
+PPO<
+  EnvironmentType,
+  ActorNetworkType,
+  CriticNetworkType,
+  UpdaterType
+>::PPO(TrainingConfig config,
+       ActorNetworkType actor,
+       CriticNetworkType critic,
+       const size_t numEnvironments,
+       const size_t rolloutLength,
+       const size_t epochs,
+       const size_t batchSize,
+       const double gaeLambda,
+       const double clipRange,
+       const double actionStd,
+       UpdaterType updater,
+       EnvironmentType environment) :
+    config(std::move(config)),
+    actor(std::move(actor)),
+    critic(std::move(critic)),
+    rolloutLength(rolloutLength),
+    epochs(epochs),
+    batchSize(batchSize),
+    gaeLambda(gaeLambda),
+    clipRange(clipRange),
+    actionStd(actionStd),
+    actorUpdater(updater),
+    criticUpdater(std::move(updater)),
+    environments(numEnvironments, environment, this->config.StepLimit()),
+    totalSteps(0),
+    deterministic(false)
+{
+  if (numEnvironments == 0 || rolloutLength == 0 || batchSize == 0)
+  {
+    throw std::invalid_argument("PPO::PPO(): the number of environments, the "
+        "rollout length and the batch size must be positive!");
+  }
+
+  if (this->actor.Parameters().is_empty())
+    this->actor.ResetParameters();
+  if (this->critic.Parameters().is_empty())
+    this->critic.ResetParameters();
+
+  actorUpdater.Initialize(this->actor.Parameters().n_rows,
+      this->actor.Parameters().n_cols);
+  criticUpdater.Initialize(this->critic.Parameters().n_rows,
+      this->critic.Parameters().n_cols);
+}
+
+template <
+  typename EnvironmentType,
+  typename ActorNetworkType,
+  typename CriticNetworkType,
+  typename UpdaterType
+>
+double PPO<
+  EnvironmentType,
+  ActorNetworkType,
+  CriticNetworkType,
+  UpdaterType
+>::Rollout()
+{
+  const size_t n = environments.NumEnvironments();
+  const size_t dimension = environments.EncodedStates().n_rows;
+  const size_t actionSize = ActionType().size;
+
+  states.set_size(dimension, n * rolloutLength);
+  nextStates.set_size(dimension, n * rolloutLength);
+  actions.set_size(actionSize, n * rolloutLength);
+  means.set_size(actionSize, n * rolloutLength);
+  rewards.set_size(n, rolloutLength);
+  terminal.set_size(n, rolloutLength);
+  ended.set_size(n, rolloutLength);
+
+  std::vector<ActionType> stepActions(n);
+  arma::mat stepMeans;
+  for (size_t t = 0; t < rolloutLength; ++t)
+  {
+    const size_t first = t * n;
+    const size_t last = first + n - 1;
+
+    // Choose the actions of all the instances from one forward pass.
+    states.cols(first, last) = environments.EncodedStates();
+    actor.Predict(environments.EncodedStates(), stepMeans);
+    means.cols(first, last) = stepMeans;
+    if (deterministic)
+      actions.cols(first, last) = stepMeans;
+    else
+      actions.cols(first, last) = stepMeans + actionStd *
+          arma::randn<arma::mat>(actionSize, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t d = 0; d < actionSize; ++d)
+        stepActions[i].action[d] = actions(d, first + i);
+    }
+
+    environments.Sample(stepActions);
+    rewards.col(t) = environments.Rewards().t();
+    for (size_t i = 0; i < n; ++i)
+    {
+      nextStates.col(first + i) = environments.NextState(i).Encode();
+      terminal(i, t) = environments.IsTerminal(i);
+      ended(i, t) = environments.EpisodeEnds(i);
+    }
+    environments.Advance();
+  }
+
+  totalSteps += n * rolloutLength;
+
+  if (!deterministic)
+    Train();
+
+  return arma::accu(rewards);
+}
+
+template <
+  typename EnvironmentType,
+  typename ActorNetworkType,
+  typename CriticNetworkType,
+  typename UpdaterType
+>
+void PPO<
+  EnvironmentType,
+  ActorNetworkType,
+  CriticNetworkType,
+  UpdaterType
+>::Advantages(const arma::mat& rewards,
+              const arma::mat& values,
+              const arma::mat& nextValues,
+              const arma::mat& terminal,
+              const arma::mat& ended,
+              const double discount,
+              const double lambda,
+              arma::mat& advantages)
+{
+  // The temporal-difference errors of all the steps at once; terminal states
+  // have no value.
+  const arma::mat deltas = rewards + discount * (nextValues % (1.0 - terminal))
+      - values;
+
+  // The estimates decay backwards through each episode, so they are
+  // accumulated from the last step, for all the instances at once.
+  advantages.set_size(rewards.n_rows, rewards.n_cols);
+  const size_t last = rewards.n_cols - 1;
+  advantages.col(last) = deltas.col(last);
+  for (size_t t = last; t > 0; --t)
+  {
+    advantages.col(t - 1) = deltas.col(t - 1) + discount * lambda *
+        ((1.0 - ended.col(t - 1)) % advantages.col(t));
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename ActorNetworkType,
+  typename CriticNetworkType,
+  typename UpdaterType
+>
+void PPO<
+  EnvironmentType,
+  ActorNetworkType,
+  CriticNetworkType,
+  UpdaterType
+>::Train()
+{
+  const size_t n = environments.NumEnvironments();
+  const size_t numTransitions = states.n_cols;
+
+  // Evaluate the states and the next states of the whole rollout at once.  The
+  // values of transition t * n + i are at (i, t) of the reshaped matrices.
+  arma::mat values, nextValues;
+  critic.Predict(states, values);
+  critic.Predict(nextStates, nextValues);
+  values.reshape(n, rolloutLength);
+  nextValues.reshape(n, rolloutLength);
+
+  arma::mat advantages;
+  Advantages(rewards, values, nextValues, terminal, ended, config.Discount(),
+      gaeLambda, advantages);
+  const arma::rowvec returns = arma::vectorise(advantages + values).t();
+
+  // Normalize the advantages over the rollout.
+  arma::rowvec normalized = arma::vectorise(advantages).t();
+  normalized = (normalized - arma::mean(normalized)) /
+      (arma::stddev(normalized) + 1e-8);
+
+  // For a Gaussian policy with standard deviation s, the gradient of the
+  // log-probability of action a with respect to the mean m is (a - m) / s^2.
+  const double variance = actionStd * actionStd;
+  const arma::rowvec oldSquaredDistances = arma::sum(arma::square(actions -
+      means), 0);
+
+  arma::mat actorGradient, criticGradient;
+  arma::mat batchMeans;
+  for (size_t epoch = 0; epoch < epochs; ++epoch)
+  {
+    // Shuffle the rollout once per epoch; the mini-batches are then contiguous
+    // blocks of columns.
+    const arma::uvec order = arma::shuffle(arma::linspace<arma::uvec>(0,
+        numTransitions - 1, numTransitions));
+    actor.Predictors() = states.cols(order);
+    actor.Responses().set_size(actions.n_rows, numTransitions);
+    critic.Predictors() = actor.Predictors();
+    critic.Responses() = returns.cols(order);
+
+    for (size_t begin = 0; begin < numTransitions; begin += batchSize)
+    {
+      const size_t size = std::min(batchSize, numTransitions - begin);
+      const arma::uvec batch = order.subvec(begin, begin + size - 1);
+
+      // The probability ratio of each action under the current policy.
+      actor.Predict(actor.Predictors().cols(begin, begin + size - 1),
+          batchMeans);
+      const arma::mat differences = actions.cols(batch) - batchMeans;
+      const arma::rowvec ratios = arma::exp((oldSquaredDistances.cols(batch) -
+          arma::sum(arma::square(differences), 0)) / (2.0 * variance));
+      const arma::rowvec batchAdvantages = normalized.cols(batch);
+
+      // The clipped objective has no gradient where the ratio has moved past
+      // the clip range in the direction favored by the advantage.
+      const arma::rowvec active = arma::conv_to<arma::rowvec>::from(
+          ((batchAdvantages > 0) % (ratios > 1.0 + clipRange)) +
+          ((batchAdvantages < 0) % (ratios < 1.0 - clipRange)) == 0);
+
+      // The mean squared error gradient of each output is proportional to
+      // (output - target) / size, so shifting the targets by half the policy
+      // gradient scaled by the variance makes the network ascend the
+      // objective.
+      const arma::rowvec coefficients = ratios % batchAdvantages % active /
+          (2.0 * variance);
+      actor.Responses().cols(begin, begin + size - 1) = batchMeans +
+          differences.each_row() % coefficients;
+
+      actor.EvaluateWithGradient(actor.Parameters(), begin, actorGradient,
+          size);
+      actorUpdater.Update(actor.Parameters(), config.StepSize(),
+          actorGradient);
+
+      critic.EvaluateWithGradient(critic.Parameters(), begin, criticGradient,
+          size);
+      criticUpdater.Update(critic.Parameters(), config.StepSize(),
+          criticGradient);
+    }
+  }
+}
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,9 @@
 #include <mlpack/prereqs.hpp>
 
 #include "replay/random_replay.hpp"
+#include "replay/prioritized_replay.hpp"
+#include "replay/compact_replay.hpp"
+#include "environment/vector_environment.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -45,7 +48,8 @@ namespace rl {
  * @tparam NetworkType The network to compute action value.
  * @tparam UpdaterType How to apply gradients when training.
  * @tparam PolicyType Behavior policy of the agent.
- * @tparam ReplayType Experience replay method.
+ * @tparam ReplayType Experience replay method, such as RandomReplay,
+ *     CompactReplay or PrioritizedReplay.
  */
 template <
   typename EnvironmentType,
@@ -89,12 +93,62 @@ class QLearning
    */
   double Step();
 
+  /**
+   * Execute a step in each instance of the given vectorized environment, in
+   * lockstep.  The actions of all the instances are chosen from one batched
+   * forward pass of the learning network, all the transitions are stored for
+   * replay, and then the network is trained once from a sampled batch, as in
+   * Step().  Unlike Step(), this also counts the steps, syncs the target
+   * network and anneals the policy, as Episode() does.  Instances whose
+   * episodes end start new ones; their returns are kept by the vectorized
+   * environment.
+   *
+   * The environment held by this object is not used.
+   *
+   * @param environments Environment instances to step.
+   * @return Total reward of the steps.
+   */
+  double Step(VectorEnvironment<EnvironmentType>& environments);
+
   /**
    * Execute an episode.
    * @return Return of the episode.
    */
   double Episode();
 
+  /**
+   * Execute the given number of training episodes, acting in the environment
+   * and training the learning network at the same time on two threads, with the
+   * replay memory in between.  The acting thread uses its own copy of the
+   * learning network, which it refreshes from the parameters published by the
+   * learning thread after each update.  The learning thread trains the network
+   * at most once for each step taken after the exploration steps (as Step()
+   * does), and syncs the target network every TargetNetworkSyncInterval()
+   * updates.
+   *
+   * If only one thread is available, or in test mode, this just runs
+   * Episode() the given number of times.
+   *
+   * @param numEpisodes Number of episodes to run.
+   * @return Return of each episode.
+   */
+  arma::vec ConcurrentEpisodes(const size_t numEpisodes);
+
+  /**
+   * Act as the learner for Actor objects: store the transitions the actors
+   * have pushed to the given transport in the replay memory, train the learning
+   * network once from a sampled batch (after the exploration steps), and
+   * publish the new parameters to the actors.  The transitions received count
+   * as steps, and the target network is synced every
+   * TargetNetworkSyncInterval() of them.  The policy and environment held by
+   * this object are not used.
+   *
+   * @param transport The transport from the actors (such as LocalTransport).
+   * @return Number of transitions received.
+   */
+  template<typename TransportType>
+  size_t Learn(TransportType& transport);
+
   /**
    * @return Total steps from beginning.
    */
@@ -113,6 +167,19 @@ class QLearning
    */
   arma::Col<size_t> BestAction(const arma::mat& actionValues);
 
+  /**
+   * Train the learning network once from a batch of transitions sampled from
+   * the replay memory.
+   */
+  void TrainAgent();
+
+  /**
+   * Move the parameters of the target network towards those of the learning
+   * network, by the sync rate given in the config.  Only the parameters are
+   * copied, into the existing target network.
+   */
+  void SyncTargetNetwork();
+
   //! Locally-stored hyper-parameters.
   TrainingConfig config;
 
@@ -142,6 +209,14 @@ class QLearning
 
   //! Locally-stored flag indicating training mode or test mode.
   bool deterministic;
+
+  //! Buffers for the sampled experience, kept between steps so they are not
+  //! reallocated.
+  arma::mat sampledStates;
+  arma::icolvec sampledActions;
+  arma::colvec sampledRewards;
+  arma::mat sampledNextStates;
+  arma::icolvec isTerminal;
 };
 
 } // namespace rl
@@ -14,6 +14,9 @@
 
 #include "q_learning.hpp"
 
+#include <atomic>
+#include <thread>
+
 namespace mlpack {
 namespace rl {
 
@@ -68,11 +71,11 @@ arma::Col<size_t> QLearning<
 >::BestAction(const arma::mat& actionValues)
 {
   arma::Col<size_t> bestActions(actionValues.n_cols);
-  arma::rowvec maxActionValues = arma::max(actionValues, 0);
   for (size_t i = 0; i < actionValues.n_cols; ++i)
   {
-    bestActions(i) = arma::as_scalar(
-        arma::find(actionValues.col(i) == maxActionValues[i], 1));
+    arma::uword bestAction;
+    actionValues.unsafe_col(i).max(bestAction);
+    bestActions(i) = bestAction;
   }
   return bestActions;
 };
@@ -114,56 +117,327 @@ double QLearning<
     return reward;
 
   // Start experience replay.
+  TrainAgent();
+
+  return reward;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+double QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Step(VectorEnvironment<EnvironmentType>& environments)
+{
+  // Get the action values of all the current states at once.
+  arma::mat actionValues;
+  learningNetwork.Predict(environments.EncodedStates(), actionValues);
+
+  // Select an action for each instance according to the behavior policy.
+  std::vector<ActionType> actions(environments.NumEnvironments());
+  for (size_t i = 0; i < actions.size(); ++i)
+    actions[i] = policy.Sample(actionValues.unsafe_col(i), deterministic);
+
+  // Interact with the environments, and store the transitions for replay.
+  environments.Sample(actions);
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    replayMethod.Store(environments.State(i), actions[i],
+        environments.Rewards()[i], environments.NextState(i),
+        environments.IsTerminal(i));
+  }
+  const double reward = arma::accu(environments.Rewards());
+  environments.Advance();
+
+  if (deterministic)
+    return reward;
+
+  // Count the steps as Episode() does.
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    totalSteps++;
+
+    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
+      SyncTargetNetwork();
+
+    if (totalSteps > config.ExplorationSteps())
+      policy.Anneal();
+  }
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  arma::icolvec sampledActions;
-  arma::colvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::icolvec isTerminal;
+  if (totalSteps < config.ExplorationSteps())
+    return reward;
+
+  // Start experience replay.
+  TrainAgent();
+
+  return reward;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::TrainAgent()
+{
+  // Sample from previous experience.  The replay memory may be shared with an
+  // acting thread (see ConcurrentEpisodes()).
+  #pragma omp critical(QLearningReplay)
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
 
-  // Compute action value for next state with target network.
+  // Compute the value of the next state of each transition with the target
+  // network.  With double Q-learning, the learning network selects the action.
+  const size_t batchSize = sampledNextStates.n_cols;
   arma::mat nextActionValues;
   targetNetwork.Predict(sampledNextStates, nextActionValues);
 
-  arma::Col<size_t> bestActions;
+  arma::colvec nextValues;
   if (config.DoubleQLearning())
   {
-    // If use double Q-Learning, use learning network to select the best action.
-    arma::mat nextActionValues;
-    learningNetwork.Predict(sampledNextStates, nextActionValues);
-    bestActions = BestAction(nextActionValues);
+    arma::mat learningActionValues;
+    learningNetwork.Predict(sampledNextStates, learningActionValues);
+    const arma::uvec bestActions = arma::conv_to<arma::uvec>::from(
+        BestAction(learningActionValues));
+    nextValues = nextActionValues.elem(bestActions + nextActionValues.n_rows *
+        arma::linspace<arma::uvec>(0, batchSize - 1, batchSize));
   }
   else
   {
-    bestActions = BestAction(nextActionValues);
+    nextValues = arma::max(nextActionValues, 0).t();
   }
 
-  // Compute the update target.
-  arma::mat target;
-  learningNetwork.Forward(sampledStates, target);
   /**
    * If the agent is at a terminal state, then we don't need to add the
    * discounted reward. At terminal state, the agent wont perform any
-   * action.
+   * action.  The replay method may return n-step transitions, whose rewards
+   * are already discounted sums over n steps.
    */
-  for (size_t i = 0; i < sampledNextStates.n_cols; ++i)
-  {
-    if (isTerminal[i])
-      target(sampledActions[i], i) = sampledRewards[i];
-    else
-      target(sampledActions[i], i) = sampledRewards[i] + config.Discount() *
-          nextActionValues(bestActions[i], i);
-  }
+  const double discount = std::pow(config.Discount(), replayMethod.NSteps());
+  const arma::colvec targetValues = sampledRewards + discount *
+      (nextValues % (1.0 - arma::conv_to<arma::colvec>::from(isTerminal)));
+
+  // Compute the update target.
+  arma::mat target;
+  learningNetwork.Forward(sampledStates, target);
+  const arma::uvec actionIndices = arma::conv_to<arma::uvec>::from(
+      sampledActions) + target.n_rows *
+      arma::linspace<arma::uvec>(0, batchSize - 1, batchSize);
+  const arma::colvec actionValues = target.elem(actionIndices);
+  const arma::colvec tdErrors = targetValues - actionValues;
+
+  // Let the replay method learn from the errors (e.g. to update priorities),
+  // and scale the error of each transition by its importance-sampling weight.
+  arma::colvec weights;
+  #pragma omp critical(QLearningReplay)
+  replayMethod.Update(tdErrors, weights);
+  target.elem(actionIndices) = actionValues + weights % tdErrors;
 
   // Learn form experience.
   arma::mat gradients;
   learningNetwork.Backward(target, gradients);
   updater.Update(learningNetwork.Parameters(), config.StepSize(), gradients);
+}
 
-  return reward;
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::SyncTargetNetwork()
+{
+  const double rate = config.TargetNetworkSyncRate();
+  if (rate == 1.0)
+  {
+    targetNetwork.Parameters() = learningNetwork.Parameters();
+  }
+  else
+  {
+    targetNetwork.Parameters() *= (1.0 - rate);
+    targetNetwork.Parameters() += rate * learningNetwork.Parameters();
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+arma::vec QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::ConcurrentEpisodes(const size_t numEpisodes)
+{
+  arma::vec returns(numEpisodes);
+
+  // The acting thread uses its own copy of the learning network, since
+  // Predict() changes the state of the network.  The learning thread publishes
+  // its parameters after each update by swapping them into a shared buffer.
+  NetworkType actingNetwork = learningNetwork;
+  arma::mat sharedParameters = learningNetwork.Parameters();
+  arma::mat publishedParameters;
+  size_t sharedVersion = 0;
+
+  // The number of steps taken so far, and whether the acting thread is done.
+  std::atomic<size_t> steps(totalSteps);
+  std::atomic<bool> done(false);
+
+  #pragma omp parallel num_threads(2)
+  {
+    #ifdef HAS_OPENMP
+      const bool concurrent = !deterministic && (omp_get_num_threads() > 1);
+      const bool acting = (omp_get_thread_num() == 0);
+    #else
+      const bool concurrent = false;
+      const bool acting = true;
+    #endif
+
+    if (acting && !concurrent)
+    {
+      for (size_t e = 0; e < numEpisodes; ++e)
+        returns[e] = Episode();
+    }
+    else if (acting)
+    {
+      size_t version = 0;
+      for (size_t e = 0; e < numEpisodes; ++e)
+      {
+        state = environment.InitialSample();
+        size_t episodeSteps = 0;
+        double episodeReturn = 0.0;
+        while (!environment.IsTerminal(state))
+        {
+          if (config.StepLimit() && episodeSteps >= config.StepLimit())
+            break;
+
+          // Pick up the latest parameters of the learning thread.
+          #pragma omp critical(QLearningParameters)
+          {
+            if (version != sharedVersion)
+            {
+              actingNetwork.Parameters() = sharedParameters;
+              version = sharedVersion;
+            }
+          }
+
+          arma::colvec actionValue;
+          actingNetwork.Predict(state.Encode(), actionValue);
+          ActionType action = policy.Sample(actionValue);
+          StateType nextState;
+          const double reward = environment.Sample(state, action, nextState);
+
+          #pragma omp critical(QLearningReplay)
+          replayMethod.Store(state, action, reward, nextState,
+              environment.IsTerminal(nextState));
+
+          state = nextState;
+          episodeReturn += reward;
+          episodeSteps++;
+
+          totalSteps++;
+          steps = totalSteps;
+          if (totalSteps > config.ExplorationSteps())
+            policy.Anneal();
+        }
+
+        returns[e] = episodeReturn;
+      }
+
+      done = true;
+    }
+    else if (concurrent)
+    {
+      size_t updates = 0;
+      while (!done)
+      {
+        // Train at most once for each step after the exploration steps.
+        const size_t currentSteps = steps;
+        if (currentSteps <= config.ExplorationSteps() ||
+            updates >= currentSteps - config.ExplorationSteps())
+        {
+          std::this_thread::yield();
+          continue;
+        }
+
+        TrainAgent();
+        updates++;
+        if (updates % config.TargetNetworkSyncInterval() == 0)
+          SyncTargetNetwork();
+
+        // Publish the new parameters.
+        publishedParameters = learningNetwork.Parameters();
+        #pragma omp critical(QLearningParameters)
+        {
+          sharedParameters.swap(publishedParameters);
+          sharedVersion++;
+        }
+      }
+    }
+  }
+
+  return returns;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+template<typename TransportType>
+size_t QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Learn(TransportType& transport)
+{
+  const size_t received = transport.Pull(replayMethod);
+
+  // Sync the target network if the new steps passed a sync interval.
+  const size_t interval = config.TargetNetworkSyncInterval();
+  if ((totalSteps + received) / interval != totalSteps / interval)
+    SyncTargetNetwork();
+  totalSteps += received;
+
+  if (totalSteps < config.ExplorationSteps() || replayMethod.Size() == 0)
+    return received;
+
+  TrainAgent();
+  transport.Publish(learningNetwork.Parameters());
+
+  return received;
 }
 
 template <
@@ -206,7 +480,7 @@ double QLearning<
 
     // Update target network
     if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-      targetNetwork = learningNetwork;
+      SyncTargetNetwork();
 
     if (totalSteps > config.ExplorationSteps())
       policy.Anneal();
@@ -0,0 +1,290 @@
+/**
+ * @file compact_replay.hpp
+ *
+ * This file is an implementation of random experience replay that stores each
+ * state only once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_COMPACT_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_COMPACT_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of random experience replay with compact storage.
+ *
+ * Like RandomReplay, transitions are kept in a First-In-First-Out buffer and
+ * sampled uniformly, but the encoded states are kept in a separate ring buffer
+ * and each transition only holds the indices of its state and next state.
+ * Within an episode, the state of each transition is the next state of the one
+ * before, so it is stored once instead of twice.  The states are stored with
+ * the given element type, so, e.g., image frames with integer pixel values can
+ * be stored as unsigned char instead of double (the encoded values are cast to
+ * ElemType when they are stored).
+ *
+ * Each episode takes one more state than it has transitions, so the state
+ * buffer holds capacity + 1 states by default; when it is full, the oldest
+ * transitions are dropped to make room, and the memory may hold a few
+ * transitions less than its capacity.  A larger state capacity can be given to
+ * avoid that.
+ *
+ * Store() and Sample() do not allocate any memory, as long as the same output
+ * matrices are passed to Sample() each time.
+ *
+ * @tparam EnvironmentType Desired task.
+ * @tparam ElemType Type used to store the elements of the encoded states.
+ */
+template <typename EnvironmentType, typename ElemType = double>
+class CompactReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of compact experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param dimension The dimension of an encoded state.
+   * @param stateCapacity Number of states the memory can hold (0 means
+   *        capacity + 1).
+   */
+  CompactReplay(const size_t batchSize,
+                const size_t capacity,
+                const size_t dimension = StateType::dimension,
+                const size_t stateCapacity = 0) :
+      batchSize(batchSize),
+      capacity(capacity),
+      first(0),
+      count(0),
+      states(dimension, (stateCapacity == 0) ? capacity + 1 : stateCapacity),
+      stateIndices(capacity),
+      nextStateIndices(capacity),
+      actions(capacity),
+      rewards(capacity),
+      isTerminal(capacity),
+      nextSlot(0),
+      numStates(0)
+  {
+    if (states.n_cols < 2)
+    {
+      throw std::invalid_argument("CompactReplay::CompactReplay(): the memory "
+          "must be able to hold at least two states!");
+    }
+  }
+
+  /**
+   * Store the given experience.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   */
+  void Store(const StateType& state,
+             ActionType action,
+             double reward,
+             const StateType& nextState,
+             bool isEnd)
+  {
+    // Make room for the new transition.
+    if (count == capacity)
+    {
+      first = (first + 1) % capacity;
+      --count;
+    }
+
+    // If the state is the last stored next state (as it is inside an episode),
+    // reuse it.
+    const size_t stateIndex = IsLastState(state.Encode()) ?
+        LastSlot() : StoreState(state.Encode());
+    const size_t nextStateIndex = StoreState(nextState.Encode());
+
+    // Storing the states may have dropped old transitions, so only now can we
+    // find the position of the new one.
+    const size_t position = (first + count) % capacity;
+    stateIndices[position] = stateIndex;
+    nextStateIndices[position] = nextStateIndex;
+    actions(position) = action;
+    rewards(position) = reward;
+    isTerminal(position) = isEnd;
+    ++count;
+  }
+
+  /**
+   * Sample some experiences.  The outputs are only resized if they do not
+   * already have the right size.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal)
+  {
+    sampledStates.set_size(states.n_rows, batchSize);
+    sampledActions.set_size(batchSize);
+    sampledRewards.set_size(batchSize);
+    sampledNextStates.set_size(states.n_rows, batchSize);
+    isTerminal.set_size(batchSize);
+
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      const size_t index = (first + math::RandInt(count)) % capacity;
+      for (size_t d = 0; d < states.n_rows; ++d)
+      {
+        sampledStates(d, i) = double(states(d, stateIndices[index]));
+        sampledNextStates(d, i) = double(states(d, nextStateIndices[index]));
+      }
+      sampledActions[i] = actions[index];
+      sampledRewards[i] = rewards[index];
+      isTerminal[i] = this->isTerminal[index];
+    }
+  }
+
+  /**
+   * Update the replay from the temporal-difference errors of the transitions
+   * returned by the last call to Sample(), and get the importance-sampling
+   * weights of the updates.  Uniform sampling needs no correction, so all the
+   * weights are 1.
+   *
+   * @param tdErrors Temporal-difference error of each sampled transition.
+   * @param weights Importance-sampling weight of each sampled transition.
+   */
+  void Update(const arma::colvec& tdErrors, arma::colvec& weights)
+  {
+    weights.ones(tdErrors.n_elem);
+  }
+
+  //! Get the number of steps of each transition (always 1).
+  size_t NSteps() const { return 1; }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size
+   */
+  const size_t& Size()
+  {
+    return count;
+  }
+
+  //! Get the number of states held in the memory.
+  size_t NumStates() const { return numStates; }
+  //! Get the maximum number of states the memory can hold.
+  size_t StateCapacity() const { return states.n_cols; }
+
+ private:
+  //! Get the slot of the most recently stored state.
+  size_t LastSlot() const
+  {
+    return (nextSlot + states.n_cols - 1) % states.n_cols;
+  }
+
+  //! Return whether the given encoded state is the most recently stored state.
+  bool IsLastState(const arma::colvec& encoded) const
+  {
+    if (numStates == 0)
+      return false;
+
+    const size_t last = LastSlot();
+    for (size_t d = 0; d < states.n_rows; ++d)
+    {
+      if (states(d, last) != ElemType(encoded[d]))
+        return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Store the given encoded state in the next slot of the state buffer, and
+   * return the slot.  If the buffer is full, the oldest state is overwritten
+   * and the transitions that use it are dropped.
+   */
+  size_t StoreState(const arma::colvec& encoded)
+  {
+    const size_t slot = nextSlot;
+    if (numStates == states.n_cols)
+    {
+      // The states are stored in the same order as the transitions, so only
+      // the oldest transitions can use the oldest state.
+      while (count > 0 && (stateIndices[first] == slot ||
+                           nextStateIndices[first] == slot))
+      {
+        first = (first + 1) % capacity;
+        --count;
+      }
+    }
+    else
+    {
+      ++numStates;
+    }
+
+    for (size_t d = 0; d < states.n_rows; ++d)
+      states(d, slot) = ElemType(encoded[d]);
+
+    nextSlot = (nextSlot + 1) % states.n_cols;
+    return slot;
+  }
+
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! The position of the oldest transition.
+  size_t first;
+
+  //! The number of transitions in the memory.
+  size_t count;
+
+  //! Ring buffer of encoded states.
+  arma::Mat<ElemType> states;
+
+  //! The slot of the state of each transition.
+  arma::Col<size_t> stateIndices;
+
+  //! The slot of the next state of each transition.
+  arma::Col<size_t> nextStateIndices;
+
+  //! Locally-stored previous actions.
+  arma::icolvec actions;
+
+  //! Locally-stored previous rewards.
+  arma::colvec rewards;
+
+  //! Locally-stored termination information of previous experience.
+  arma::icolvec isTerminal;
+
+  //! The slot the next state will be stored in.
+  size_t nextSlot;
+
+  //! The number of states in the memory.
+  size_t numStates;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * @file prioritized_replay.hpp
+ *
+ * This file is an implementation of prioritized experience replay.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include "sum_tree.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of prioritized experience replay.
+ *
+ * Like RandomReplay, the interactions between the agent and the environment
+ * are saved to a First-In-First-Out buffer, but transitions are sampled with
+ * probability proportional to their priority, p_i^alpha, where p_i is the
+ * magnitude of the last temporal-difference error of the transition.  New
+ * transitions get the largest priority seen so far, so each is sampled at
+ * least once soon after it is stored.  The priorities are held in a SumTree, so
+ * sampling and updating a priority take O(log n) time.
+ *
+ * Because the sampling is not uniform, each sampled transition has an
+ * importance-sampling weight (N * P(i))^-beta, normalized so that the largest
+ * weight in the batch is 1; the update from each transition should be scaled
+ * by its weight.  Beta is annealed linearly to 1 over the given number of
+ * calls to Sample().
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{schaul2015prioritized,
+ *  title   = {Prioritized Experience Replay},
+ *  author  = {Schaul, Tom and Quan, John and Antonoglou, Ioannis and
+ *             Silver, David},
+ *  journal = {arXiv preprint arXiv:1511.05952},
+ *  year    = {2015}
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType Desired task.
+ */
+template <typename EnvironmentType>
+class PrioritizedReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of prioritized experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param alpha How much prioritization is used (0 is uniform sampling).
+   * @param beta Initial importance-sampling correction exponent.
+   * @param betaSteps Number of calls to Sample() over which beta is annealed
+   *        to 1 (0 keeps beta fixed).
+   * @param dimension The dimension of an encoded state.
+   */
+  PrioritizedReplay(const size_t batchSize,
+                    const size_t capacity,
+                    const double alpha = 0.6,
+                    const double beta = 0.4,
+                    const size_t betaSteps = 0,
+                    const size_t dimension = StateType::dimension) :
+      batchSize(batchSize),
+      capacity(capacity),
+      position(0),
+      states(dimension, capacity),
+      actions(capacity),
+      rewards(capacity),
+      nextStates(dimension, capacity),
+      isTerminal(capacity),
+      full(false),
+      alpha(alpha),
+      beta(beta),
+      betaIncrement((betaSteps == 0) ? 0.0 : (1.0 - beta) / betaSteps),
+      priorities(capacity),
+      maxPriority(1.0)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the given experience, with the largest priority seen so far.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   */
+  void Store(const StateType& state,
+             ActionType action,
+             double reward,
+             const StateType& nextState,
+             bool isEnd)
+  {
+    states.col(position) = state.Encode();
+    actions(position) = action;
+    rewards(position) = reward;
+    nextStates.col(position) = nextState.Encode();
+    isTerminal(position) = isEnd;
+    priorities.Set(position, std::pow(maxPriority, alpha));
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+  }
+
+  /**
+   * Sample some experiences in proportion to their priorities.  The indices
+   * and importance-sampling weights of the sampled transitions are kept until
+   * the next call to Sample().
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal)
+  {
+    // Split the total priority into batchSize equal segments, and sample one
+    // transition from each.
+    const double segment = priorities.Sum() / batchSize;
+    sampledIndices.set_size(batchSize);
+    weights.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      const double mass = (i + math::Random()) * segment;
+      sampledIndices[i] = priorities.FindPrefixSum(mass);
+
+      // The weights are only needed up to a constant factor, since they are
+      // normalized below.
+      weights[i] = std::pow(priorities.Get(sampledIndices[i]), -beta);
+    }
+    weights /= arma::max(weights);
+    beta = std::min(beta + betaIncrement, 1.0);
+
+    sampledStates = states.cols(sampledIndices);
+    sampledActions = actions.elem(sampledIndices);
+    sampledRewards = rewards.elem(sampledIndices);
+    sampledNextStates = nextStates.cols(sampledIndices);
+    isTerminal = this->isTerminal.elem(sampledIndices);
+  }
+
+  /**
+   * Update the priorities of the transitions returned by the last call to
+   * Sample() from their temporal-difference errors, and get the
+   * importance-sampling weights of the updates.
+   *
+   * @param tdErrors Temporal-difference error of each sampled transition.
+   * @param weights Importance-sampling weight of each sampled transition.
+   */
+  void Update(const arma::colvec& tdErrors, arma::colvec& weights)
+  {
+    UpdatePriorities(sampledIndices, tdErrors);
+    weights = this->weights;
+  }
+
+  /**
+   * Set the priorities of the given transitions from their temporal-difference
+   * errors.
+   *
+   * @param indices Indices of the transitions in the memory.
+   * @param tdErrors Temporal-difference error of each transition.
+   */
+  void UpdatePriorities(const arma::uvec& indices,
+                        const arma::colvec& tdErrors)
+  {
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      // A small constant keeps every transition possible to sample.
+      const double priority = std::abs(tdErrors[i]) + 1e-6;
+      maxPriority = std::max(maxPriority, priority);
+      priorities.Set(indices[i], std::pow(priority, alpha));
+    }
+  }
+
+  //! Get the number of steps of each transition (always 1).
+  size_t NSteps() const { return 1; }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size
+   */
+  const size_t& Size()
+  {
+    return full ? capacity : position;
+  }
+
+  //! Get the indices of the transitions returned by the last call to Sample().
+  const arma::uvec& SampledIndices() const { return sampledIndices; }
+  //! Get the importance-sampling weights of the last sampled transitions.
+  const arma::colvec& Weights() const { return weights; }
+
+  //! Get the prioritization exponent.
+  double Alpha() const { return alpha; }
+  //! Get the current importance-sampling correction exponent.
+  double Beta() const { return beta; }
+  //! Modify the current importance-sampling correction exponent.
+  double& Beta() { return beta; }
+
+  //! Get the priority of the given transition (raised to the power alpha).
+  double Priority(const size_t index) const { return priorities.Get(index); }
+
+ private:
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! Indicate the position to store new transition.
+  size_t position;
+
+  //! Locally-stored encoded previous states.
+  arma::mat states;
+
+  //! Locally-stored previous actions.
+  arma::icolvec actions;
+
+  //! Locally-stored previous rewards.
+  arma::colvec rewards;
+
+  //! Locally-stored encoded previous next states.
+  arma::mat nextStates;
+
+  //! Locally-stored termination information of previous experience.
+  arma::icolvec isTerminal;
+
+  //! Locally-stored indicator that whether the memory is full or not
+  bool full;
+
+  //! The prioritization exponent.
+  double alpha;
+
+  //! The importance-sampling correction exponent.
+  double beta;
+
+  //! The amount beta is increased by after each call to Sample().
+  double betaIncrement;
+
+  //! The priorities of the transitions, raised to the power alpha.
+  SumTree<double> priorities;
+
+  //! The largest priority seen so far.
+  double maxPriority;
+
+  //! The indices of the last sampled transitions.
+  arma::uvec sampledIndices;
+
+  //! The importance-sampling weights of the last sampled transitions.
+  arma::colvec weights;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
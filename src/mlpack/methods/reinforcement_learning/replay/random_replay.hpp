@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_RL_REPLAY_RANDOM_REPLAY_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <deque>
 
 namespace mlpack {
 namespace rl {
@@ -26,6 +27,12 @@ namespace rl {
  * train the agent. Typically this would be a random sample and
  * the memory will be a First-In-First-Out buffer.
  *
+ * If nSteps is more than 1, the memory holds n-step transitions: the reward of
+ * each is the discounted sum of the rewards of the next n steps, and its next
+ * state is the state n steps later (or the terminal state, if the episode ends
+ * sooner).  The last transitions of an episode that is cut off without
+ * reaching a terminal state can't be completed, and are not stored.
+ *
  * For more information, see the following.
  *
  * @code
@@ -55,10 +62,15 @@ class RandomReplay
    * @param batchSize Number of examples returned at each sample.
    * @param capacity Total memory size in terms of number of examples.
    * @param dimension The dimension of an encoded state.
+   * @param nSteps Number of steps of each stored transition.
+   * @param discount Discount rate of the rewards of n-step transitions; it
+   *        should be the same as the discount rate used for training.
    */
   RandomReplay(const size_t batchSize,
                const size_t capacity,
-               const size_t dimension = StateType::dimension) :
+               const size_t dimension = StateType::dimension,
+               const size_t nSteps = 1,
+               const double discount = 0.99) :
       batchSize(batchSize),
       capacity(capacity),
       position(0),
@@ -67,7 +79,9 @@ class RandomReplay
       rewards(capacity),
       nextStates(dimension, capacity),
       isTerminal(capacity),
-      full(false)
+      full(false),
+      nSteps(nSteps),
+      discount(discount)
   { /* Nothing to do here. */ }
 
   /**
@@ -85,16 +99,34 @@ class RandomReplay
              const StateType& nextState,
              bool isEnd)
   {
-    states.col(position) = state.Encode();
-    actions(position) = action;
-    rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
-    isTerminal(position) = isEnd;
-    position++;
-    if (position == capacity)
+    if (nSteps == 1)
     {
-      full = true;
-      position = 0;
+      StoreTransition(state.Encode(), action, reward, nextState.Encode(),
+          isEnd);
+      return;
+    }
+
+    // If this step doesn't follow the pending ones, their episode was cut off,
+    // so their n-step rewards can't be completed.
+    if (!pending.empty() && arma::any(pendingNextState != state.Encode()))
+      pending.clear();
+
+    pending.push_back(std::make_tuple(state.Encode(), action, reward));
+    pendingNextState = nextState.Encode();
+
+    if (isEnd)
+    {
+      // Every pending transition ends in the terminal state.
+      while (!pending.empty())
+      {
+        StorePending(true);
+        pending.pop_front();
+      }
+    }
+    else if (pending.size() == nSteps)
+    {
+      StorePending(false);
+      pending.pop_front();
     }
   }
 
@@ -125,6 +157,23 @@ class RandomReplay
     isTerminal = this->isTerminal.elem(sampledIndices);
   }
 
+  /**
+   * Update the replay from the temporal-difference errors of the transitions
+   * returned by the last call to Sample(), and get the importance-sampling
+   * weights of the updates.  Uniform sampling needs no correction, so all the
+   * weights are 1.
+   *
+   * @param tdErrors Temporal-difference error of each sampled transition.
+   * @param weights Importance-sampling weight of each sampled transition.
+   */
+  void Update(const arma::colvec& tdErrors, arma::colvec& weights)
+  {
+    weights.ones(tdErrors.n_elem);
+  }
+
+  //! Get the number of steps of each transition.
+  size_t NSteps() const { return nSteps; }
+
   /**
    * Get the number of transitions in the memory.
    *
@@ -136,6 +185,37 @@ class RandomReplay
   }
 
  private:
+  //! Store the given transition in the memory.
+  void StoreTransition(const arma::colvec& state,
+                       ActionType action,
+                       double reward,
+                       const arma::colvec& nextState,
+                       bool isEnd)
+  {
+    states.col(position) = state;
+    actions(position) = action;
+    rewards(position) = reward;
+    nextStates.col(position) = nextState;
+    isTerminal(position) = isEnd;
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+  }
+
+  //! Store the n-step transition that starts at the oldest pending step.
+  void StorePending(bool isEnd)
+  {
+    double nStepReward = 0.0;
+    for (size_t i = pending.size(); i > 0; --i)
+      nStepReward = std::get<2>(pending[i - 1]) + discount * nStepReward;
+
+    StoreTransition(std::get<0>(pending.front()), std::get<1>(pending.front()),
+        nStepReward, pendingNextState, isEnd);
+  }
+
   //! Locally-stored number of examples of each sample.
   size_t batchSize;
 
@@ -162,6 +242,19 @@ class RandomReplay
 
   //! Locally-stored indicator that whether the memory is full or not
   bool full;
+
+  //! Number of steps of each transition.
+  size_t nSteps;
+
+  //! Discount rate of the rewards of n-step transitions.
+  double discount;
+
+  //! The steps of the current episode whose n-step transitions are not
+  //! complete yet (encoded state, action and reward).
+  std::deque<std::tuple<arma::colvec, ActionType, double>> pending;
+
+  //! The next state of the last pending step.
+  arma::colvec pendingNextState;
 };
 
 } // namespace rl
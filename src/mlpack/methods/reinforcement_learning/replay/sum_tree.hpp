@@ -0,0 +1,114 @@
+/**
+ * @file sum_tree.hpp
+ *
+ * An array-based sum tree, used for sampling proportionally to priorities.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+#define MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A sum tree holds a fixed number of non-negative values, and each internal
+ * node holds the sum of the values below it.  It is stored in one array, as a
+ * complete binary tree whose leaves are the values: node i has children 2i and
+ * 2i + 1, and the root is node 1.  Setting a value and finding the value at a
+ * given prefix sum (which is how values are sampled in proportion to their
+ * size) both take O(log n) time.
+ *
+ * @tparam T Type of the values.
+ */
+template<typename T = double>
+class SumTree
+{
+ public:
+  /**
+   * Create a sum tree holding the given number of values, all zero.
+   *
+   * @param size Number of values.
+   */
+  SumTree(const size_t size = 0) :
+      size(size),
+      leaves(1)
+  {
+    while (leaves < size)
+      leaves *= 2;
+    tree.zeros(2 * leaves);
+  }
+
+  /**
+   * Set the value at the given index, and update the sums above it.
+   *
+   * @param index Index of the value.
+   * @param value New value; it must not be negative.
+   */
+  void Set(const size_t index, const T value)
+  {
+    size_t node = leaves + index;
+    tree[node] = value;
+    while (node > 1)
+    {
+      node /= 2;
+      tree[node] = tree[2 * node] + tree[2 * node + 1];
+    }
+  }
+
+  //! Get the value at the given index.
+  T Get(const size_t index) const { return tree[leaves + index]; }
+
+  //! Get the sum of all values.
+  T Sum() const { return tree[1]; }
+
+  //! Get the number of values.
+  size_t Size() const { return size; }
+
+  /**
+   * Find the index of the value at which the running sum of the values, in
+   * order, passes the given mass.  If the mass is drawn uniformly from [0,
+   * Sum()), each index is found with probability proportional to its value.
+   * Values of zero are never found, unless all the values are zero.
+   *
+   * @param mass Prefix sum to find.
+   */
+  size_t FindPrefixSum(T mass) const
+  {
+    size_t node = 1;
+    while (node < leaves)
+    {
+      // Go right only if the mass is past the left subtree and there is
+      // anything to the right; this guards against rounding errors.
+      if (mass < tree[2 * node] || tree[2 * node + 1] <= 0)
+      {
+        node = 2 * node;
+      }
+      else
+      {
+        mass -= tree[2 * node];
+        node = 2 * node + 1;
+      }
+    }
+
+    return node - leaves;
+  }
+
+ private:
+  //! The number of values.
+  size_t size;
+  //! The number of leaves (the number of values, rounded up to a power of 2).
+  size_t leaves;
+  //! The nodes of the tree; node 0 is unused.
+  arma::Col<T> tree;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
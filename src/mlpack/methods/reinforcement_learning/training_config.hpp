@@ -25,7 +25,8 @@ class TrainingConfig
       stepLimit(0),
       explorationSteps(1),
       gradientLimit(40),
-      doubleQLearning(false)
+      doubleQLearning(false),
+      targetNetworkSyncRate(1.0)
   { /* Nothing to do here. */ }
 
   TrainingConfig(
@@ -37,7 +38,8 @@ class TrainingConfig
       double stepSize,
       double discount,
       double gradientLimit,
-      bool doubleQLearning) :
+      bool doubleQLearning,
+      double targetNetworkSyncRate = 1.0) :
       numWorkers(numWorkers),
       updateInterval(updateInterval),
       targetNetworkSyncInterval(targetNetworkSyncInterval),
@@ -46,7 +48,8 @@ class TrainingConfig
       stepSize(stepSize),
       discount(discount),
       gradientLimit(gradientLimit),
-      doubleQLearning(doubleQLearning)
+      doubleQLearning(doubleQLearning),
+      targetNetworkSyncRate(targetNetworkSyncRate)
   { /* Nothing to do here. */ }
 
   //! Get the amount of workers.
@@ -98,6 +101,15 @@ class TrainingConfig
   //! Modify the indicator of double q-learning.
   bool& DoubleQLearning() { return doubleQLearning; }
 
+  //! Get the rate of target network syncs.
+  double TargetNetworkSyncRate() const { return targetNetworkSyncRate; }
+  /**
+   * Modify the rate of target network syncs.  At each sync, the target network
+   * parameters move this fraction of the way to the learning network
+   * parameters; 1 copies them, and smaller values give soft (Polyak) updates.
+   */
+  double& TargetNetworkSyncRate() { return targetNetworkSyncRate; }
+
  private:
   /**
    * Locally-stored number of workers.
@@ -155,6 +167,12 @@ class TrainingConfig
    * This is valid only for q-learning agent.
    */
   bool doubleQLearning;
+
+  /**
+   * Locally-stored rate of target network syncs.
+   * This is valid only for q-learning agent.
+   */
+  double targetNetworkSyncRate;
 };
 
 } // namespace rl
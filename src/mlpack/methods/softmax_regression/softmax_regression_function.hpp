@@ -18,6 +18,18 @@
 namespace mlpack {
 namespace regression {
 
+/**
+ * The objective function of softmax regression: the negative log-likelihood
+ * of the training points with L2-regularization.
+ *
+ * The data may be dense or sparse; the probabilities of the points are
+ * computed in blocks of a few thousand points, so the dense memory needed does
+ * not grow with the number of points, and the gradient is assembled as the
+ * product of the (possibly sparse) data and a dense matrix.
+ *
+ * @tparam MatType Type of the data matrix (arma::mat or arma::sp_mat).
+ */
+template<typename MatType = arma::mat>
 class SoftmaxRegressionFunction
 {
  public:
@@ -32,7 +44,7 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
+  SoftmaxRegressionFunction(const MatType& data,
                             const arma::Row<size_t>& labels,
                             const size_t numClasses,
                             const double lambda = 0.0001,
@@ -80,7 +92,7 @@ class SoftmaxRegressionFunction
    * @param groundTruth Pointer to arma::mat which stores the computed matrix.
    */
   void GetGroundTruthMatrix(const arma::Row<size_t>& labels,
-                            arma::sp_mat& groundTruth);
+                            arma::sp_mat& groundTruth) const;
 
   /**
    * Evaluate the probabilities matrix with the passed parameters.
@@ -151,6 +163,33 @@ class SoftmaxRegressionFunction
                 arma::mat& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the objective function and its gradient given the current set of
+   * parameters, computing the probabilities of the points only once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix to store gradient into.
+   * @return The objective function.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective function and its gradient given the current set of
+   * parameters, on a subset of the data, computing the probabilities of the
+   * points only once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Matrix to store gradient into.
+   * @param batchSize Number of data points to evaluate gradient for.
+   * @return The objective function.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t start,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters for a single feature indexed by j.
@@ -185,10 +224,35 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
+  /**
+   * Compute the probabilities of the given points in blocks, subtract 1 from
+   * the probability of the label of each point (this gives the probabilities
+   * minus the ground truth matrix), and call function(begin, inner) for each
+   * block, where begin is the index of the first point of the block and inner
+   * is the resulting matrix.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param batchSize Number of data points to use.
+   * @param function Function to call for each block.
+   * @return The log-likelihood of the points.
+   */
+  template<typename FunctionType>
+  double ForEachBlock(const arma::mat& parameters,
+                      const size_t start,
+                      const size_t batchSize,
+                      FunctionType function) const;
+
+  //! Add the gradient of the log-likelihood for one block to gradient.
+  void AddBlockGradient(const size_t begin,
+                        const arma::mat& inner,
+                        arma::mat& gradient) const;
+
   //! Training data matrix.  This is an alias until the data is shuffled.
-  arma::mat data;
-  //! Label matrix for the provided data.
-  arma::sp_mat groundTruth;
+  MatType data;
+  //! Labels of the training data.  This is an alias until the data is
+  //! shuffled.
+  arma::Row<size_t> labels;
   //! Initial parameter point.
   arma::mat initialPoint;
   //! Number of classes.
@@ -202,4 +266,7 @@ class SoftmaxRegressionFunction
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
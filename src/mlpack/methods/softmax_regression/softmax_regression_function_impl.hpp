@@ -0,0 +1,351 @@
+/**
+ * @file softmax_regression_function_impl.hpp
+ * @author Siddharth Agrawal
+ *
+ * Implementation of function to be optimized for softmax regression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "softmax_regression_function.hpp"
+#include <mlpack/core/math/make_alias.hpp>
+
+namespace mlpack {
+namespace regression {
+
+template<typename MatType>
+SoftmaxRegressionFunction<MatType>::SoftmaxRegressionFunction(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const double lambda,
+    const bool fitIntercept) :
+    // We promise to be well-behaved... the elements won't be modified.
+    data(math::MakeAlias(const_cast<MatType&>(data), false)),
+    labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
+    numClasses(numClasses),
+    lambda(lambda),
+    fitIntercept(fitIntercept)
+{
+  // Initialize the parameters to suitable values.
+  initialPoint = InitializeWeights();
+}
+
+/**
+ * Shuffle the data.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Shuffle()
+{
+  MatType newData;
+  arma::Row<size_t> newLabels;
+
+  math::ShuffleData(data, labels, newData, newLabels);
+
+  // If we are an alias, make sure we don't write to the original data.
+  math::ClearAlias(data);
+  math::ClearAlias(labels);
+
+  // Take ownership of the new data.
+  data = std::move(newData);
+  labels = std::move(newLabels);
+}
+
+/**
+ * Initializes parameter weights to random values taken from a scaled standard
+ * normal distribution. The weights cannot be initialized to zero, as that will
+ * lead to each class output being the same.
+ */
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunction<MatType>::InitializeWeights()
+{
+  return InitializeWeights(data.n_rows, numClasses, fitIntercept);
+}
+
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunction<MatType>::InitializeWeights(
+    const size_t featureSize,
+    const size_t numClasses,
+    const bool fitIntercept)
+{
+    arma::mat parameters;
+    InitializeWeights(parameters, featureSize, numClasses, fitIntercept);
+    return parameters;
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::InitializeWeights(
+    arma::mat &weights,
+    const size_t featureSize,
+    const size_t numClasses,
+    const bool fitIntercept)
+{
+  // Initialize values to 0.005 * r. 'r' is a matrix of random values taken from
+  // a Gaussian distribution with mean zero and variance one.
+  // If the fitIntercept flag is true, parameters.col(0) is the intercept.
+  if (fitIntercept)
+    weights.randn(numClasses, featureSize + 1);
+  else
+    weights.randn(numClasses, featureSize);
+  weights *= 0.005;
+}
+
+/**
+ * This is equivalent to applying the indicator function to the training
+ * labels. The output is in the form of a matrix.  Evaluate() and Gradient() do
+ * not build this matrix; they use the labels directly.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetGroundTruthMatrix(
+    const arma::Row<size_t>& labels, arma::sp_mat& groundTruth) const
+{
+  // Calculate the ground truth matrix according to the labels passed. The
+  // ground truth matrix is a matrix of dimensions 'numClasses * numExamples',
+  // where each column contains a single entry of '1', marking the label
+  // corresponding to that example.
+
+  // Row pointers and column pointers corresponding to the entries.
+  arma::uvec rowPointers(labels.n_elem);
+  arma::uvec colPointers(labels.n_elem + 1);
+
+  // Row pointers are the labels of the examples, and column pointers are the
+  // number of cumulative entries made uptil that column.
+  colPointers(0) = 0;
+  for (size_t i = 0; i < labels.n_elem; i++)
+  {
+    rowPointers(i) = labels(i);
+    colPointers(i + 1) = i + 1;
+  }
+
+  // All entries are '1'.
+  arma::vec values;
+  values.ones(labels.n_elem);
+
+  // Calculate the matrix.
+  groundTruth = arma::sp_mat(rowPointers, colPointers, values, numClasses,
+                             labels.n_elem);
+}
+
+/**
+ * Evaluate the probabilities matrix. If fitIntercept flag is true,
+ * it should consider the parameters.cols(0) intercept term.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetProbabilitiesMatrix(
+    const arma::mat& parameters,
+    arma::mat& probabilities,
+    const size_t start,
+    const size_t batchSize) const
+{
+  if (fitIntercept)
+  {
+    // In order to add the intercept term, we should compute following matrix:
+    //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
+    //     hypothesis = arma::exp(parameters * [1; data]).
+    //
+    // Since the cost of join may be high due to the copy of original data,
+    // split the hypothesis computation to two components.
+    probabilities = parameters.cols(1, parameters.n_cols - 1) *
+        data.cols(start, start + batchSize - 1);
+    probabilities.each_col() += parameters.col(0);
+  }
+  else
+  {
+    probabilities = parameters * data.cols(start, start + batchSize - 1);
+  }
+
+  // Subtracting the largest value of each column does not change the
+  // probabilities, but keeps exp() from overflowing.
+  probabilities.each_row() -= arma::max(probabilities, 0);
+  probabilities = arma::exp(probabilities);
+  probabilities.each_row() /= arma::sum(probabilities, 0);
+}
+
+template<typename MatType>
+template<typename FunctionType>
+double SoftmaxRegressionFunction<MatType>::ForEachBlock(
+    const arma::mat& parameters,
+    const size_t start,
+    const size_t batchSize,
+    FunctionType function) const
+{
+  // Only the probabilities of one block are held at a time.
+  const size_t blockSize = 4096;
+
+  double logLikelihood = 0.0;
+  arma::mat inner;
+  for (size_t begin = start; begin < start + batchSize; begin += blockSize)
+  {
+    const size_t count = std::min(blockSize, start + batchSize - begin);
+    GetProbabilitiesMatrix(parameters, inner, begin, count);
+
+    // The ground truth matrix has a single 1 in each column, at the label of
+    // the point, so it is never built.
+    for (size_t i = 0; i < count; ++i)
+    {
+      double& probability = inner(labels[begin + i], i);
+      logLikelihood += std::log(probability);
+      probability -= 1.0;
+    }
+
+    function(begin, inner);
+  }
+
+  return logLikelihood;
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::AddBlockGradient(
+    const size_t begin,
+    const arma::mat& inner,
+    arma::mat& gradient) const
+{
+  // The data is multiplied by a dense matrix, which is efficient for both
+  // dense and sparse data (and does not transpose the data).
+  const arma::mat product =
+      (data.cols(begin, begin + inner.n_cols - 1) * inner.t()).t();
+  if (fitIntercept)
+  {
+    // Treating the intercept term parameters.col(0) seperately to avoid
+    // the cost of building matrix [1; data].
+    gradient.col(0) += arma::sum(inner, 1);
+    gradient.cols(1, gradient.n_cols - 1) += product;
+  }
+  else
+  {
+    gradient += product;
+  }
+}
+
+/**
+ * Evaluates the objective function given the parameters.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters) const
+{
+  // The objective function is the negative log likelihood of the model
+  // calculated over all the training examples. Mathematically it is as follows:
+  // log likelihood = sum(1{y_i = j} * log(probability(j))) / m
+  // The sum is over all 'i's and 'j's, where 'i' points to a training example
+  // and 'j' points to a particular class. 1{x} is an indicator function whose
+  // value is 1 only when 'x' is satisfied, otherwise it is 0.
+  // 'm' is the number of training examples.
+  // The cost also takes into account the regularization to control the
+  // parameter weights.
+  return Evaluate(parameters, 0, data.n_cols);
+}
+
+/**
+ * Evaluate the objective function for the given points given the parameters.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t start,
+    const size_t batchSize) const
+{
+  // Calculate the class probabilities for each training example. The
+  // probabilities for each of the classes are given by:
+  // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
+  // The sum is calculated over all the classes.
+  // x_i is the input vector for a particular training example.
+  // theta_j is the parameter vector associated with a particular class.
+  const double logLikelihood = ForEachBlock(parameters, start, batchSize,
+      [](const size_t /* begin */, const arma::mat& /* inner */) { });
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters %
+      parameters);
+
+  // The cost is the sum of the negative log likelihood and the regularization
+  // terms.
+  return -logLikelihood / batchSize + weightDecay;
+}
+
+/**
+ * Calculates and stores the gradient values given a set of parameters.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(const arma::mat& parameters,
+                                                  arma::mat& gradient) const
+{
+  Gradient(parameters, 0, gradient, data.n_cols);
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(const arma::mat& parameters,
+                                                  const size_t start,
+                                                  arma::mat& gradient,
+                                                  const size_t batchSize) const
+{
+  EvaluateWithGradient(parameters, start, gradient, batchSize);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return EvaluateWithGradient(parameters, 0, gradient, data.n_cols);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t start,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  // The gradient is (probabilities - groundTruth) * [1; data]^T / m, plus the
+  // regularization.
+  gradient.zeros(parameters.n_rows, parameters.n_cols);
+  const double logLikelihood = ForEachBlock(parameters, start, batchSize,
+      [&](const size_t begin, const arma::mat& inner)
+      {
+        AddBlockGradient(begin, inner, gradient);
+      });
+
+  gradient /= batchSize;
+  gradient += lambda * parameters;
+
+  return -logLikelihood / batchSize +
+      0.5 * lambda * arma::accu(parameters % parameters);
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::PartialGradient(
+    const arma::mat& parameters,
+    const size_t j,
+    arma::sp_mat& gradient) const
+{
+  gradient.zeros(arma::size(parameters));
+
+  // Calculate the required part of the gradient.
+  arma::vec partial(parameters.n_rows, arma::fill::zeros);
+  ForEachBlock(parameters, 0, data.n_cols,
+      [&](const size_t begin, const arma::mat& inner)
+      {
+        if (fitIntercept && j == 0)
+        {
+          partial += arma::sum(inner, 1);
+        }
+        else
+        {
+          const size_t feature = fitIntercept ? j - 1 : j;
+          partial += inner * data.submat(feature, begin, feature,
+              begin + inner.n_cols - 1).t();
+        }
+      });
+
+  gradient.col(j) = partial / data.n_cols + lambda * parameters.col(j);
+}
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
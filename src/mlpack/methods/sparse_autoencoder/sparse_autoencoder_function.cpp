@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "sparse_autoencoder_function.hpp"
+#include <mlpack/core/math/make_alias.hpp>
 
 using namespace mlpack;
 using namespace mlpack::nn;
@@ -21,7 +22,8 @@ SparseAutoencoderFunction::SparseAutoencoderFunction(const arma::mat& data,
                                                      const double lambda,
                                                      const double beta,
                                                      const double rho) :
-    data(data),
+    // We promise to be well-behaved... the elements won't be modified.
+    data(math::MakeAlias(const_cast<arma::mat&>(data), false)),
     visibleSize(visibleSize),
     hiddenSize(hiddenSize),
     lambda(lambda),
@@ -71,9 +73,65 @@ const arma::mat SparseAutoencoderFunction::InitializeWeights()
   return parameters;
 }
 
+void SparseAutoencoderFunction::Shuffle()
+{
+  arma::mat newData = data.cols(arma::randperm(data.n_cols));
+
+  // If we are an alias, make sure we don't write to the original data.
+  math::ClearAlias(data);
+  data = std::move(newData);
+}
+
 /** Evaluates the objective function given the parameters.
   */
 double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
+{
+  return Compute(parameters, 0, data.n_cols, NULL);
+}
+
+double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t begin,
+                                           const size_t batchSize) const
+{
+  return Compute(parameters, begin, batchSize, NULL);
+}
+
+/** Calculates and stores the gradient values given a set of parameters.
+  */
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         arma::mat& gradient) const
+{
+  Compute(parameters, 0, data.n_cols, &gradient);
+}
+
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         const size_t begin,
+                                         arma::mat& gradient,
+                                         const size_t batchSize) const
+{
+  Compute(parameters, begin, batchSize, &gradient);
+}
+
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return Compute(parameters, 0, data.n_cols, &gradient);
+}
+
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  return Compute(parameters, begin, batchSize, &gradient);
+}
+
+double SparseAutoencoderFunction::Compute(const arma::mat& parameters,
+                                          const size_t begin,
+                                          const size_t batchSize,
+                                          arma::mat* gradient) const
 {
   // The objective function is the average squared reconstruction error of the
   // network. w1 and b1 are the weights and biases associated with the hidden
@@ -96,31 +154,51 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
 
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
+  // The points are split into ranges with their own activation buffers.
+  const size_t minRangeSize = 256;
+  const size_t numRanges = std::max((size_t) 1, std::min(Threads::Count(),
+      batchSize / minRangeSize));
+  const size_t rangeSize = (batchSize + numRanges - 1) / numRanges;
+  hiddenLayers.resize(numRanges);
+  outputLayers.resize(numRanges);
+
+  // Compute activations of the hidden and output layers of each range, the
+  // reconstruction error, and the delta values of the output layer.  The
+  // delta vector for the output layer is given by diff * f'(z), where z is the
+  // preactivation and f is the activation function. The derivative of the
+  // sigmoid function turns out to be f(z) * (1 - f(z)).
+  std::vector<double> errors(numRanges, 0.0);
+  arma::mat hiddenSums(l1, numRanges, arma::fill::zeros);
+  Threads::ParallelFor(0, numRanges, [&](const size_t r)
+  {
+    const size_t first = begin + r * rangeSize;
+    if (first >= begin + batchSize)
+      return;
+    const size_t last = std::min(first + rangeSize, begin + batchSize) - 1;
+
+    arma::mat& hiddenLayer = hiddenLayers[r];
+    hiddenLayer = parameters.submat(0, 0, l1 - 1, l2 - 1) *
+        data.cols(first, last);
+    hiddenLayer.each_col() += parameters.submat(0, l2, l1 - 1, l2);
+    Sigmoid(hiddenLayer, hiddenLayer);
+
+    arma::mat& outputLayer = outputLayers[r];
+    outputLayer = parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer;
+    outputLayer.each_col() += parameters.submat(l3, 0, l3, l2 - 1).t();
+    Sigmoid(outputLayer, outputLayer);
+
+    errors[r] = arma::accu(arma::square(outputLayer - data.cols(first, last)));
+    if (gradient)
+    {
+      outputLayer = (outputLayer - data.cols(first, last)) % outputLayer %
+          (1 - outputLayer);
+    }
+
+    hiddenSums.col(r) = arma::sum(hiddenLayer, 1);
+  });
 
   // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  double wL2SquaredNorm;
-
-  // Calculate squared L2-norms of w1 and w2.
-  wL2SquaredNorm = arma::accu(parameters.submat(0, 0, l3 - 1, l2 - 1) %
-      parameters.submat(0, 0, l3 - 1, l2 - 1));
-
-  double sumOfSquaresError, weightDecay, klDivergence, cost;
+  const arma::vec rhoCap = arma::sum(hiddenSums, 1) / batchSize;
 
   // Calculate the reconstruction error, the regularization cost and the KL
   // divergence cost terms. 'sumOfSquaresError' is the average squared l2-norm
@@ -128,83 +206,61 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
   // activations not being low. It is given by the following formula:
   // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
-  sumOfSquaresError = 0.5 * arma::accu(diff % diff) / data.n_cols;
-  weightDecay = 0.5 * lambda * wL2SquaredNorm;
-  klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) + (1 - rho) *
-      arma::log((1 - rho) / (1 - rhoCap)));
+  double sumOfSquaresError = 0.0;
+  for (size_t r = 0; r < numRanges; ++r)
+    sumOfSquaresError += errors[r];
+  sumOfSquaresError *= 0.5 / batchSize;
+  const double weightDecay = 0.5 * lambda * arma::accu(arma::square(
+      parameters.submat(0, 0, l3 - 1, l2 - 1)));
+  const double klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) +
+      (1 - rho) * arma::log((1 - rho) / (1 - rhoCap)));
 
   // The cost is the sum of the terms calculated above.
-  cost = sumOfSquaresError + weightDecay + klDivergence;
+  const double cost = sumOfSquaresError + weightDecay + klDivergence;
+  if (!gradient)
+    return cost;
+
+  // For every other layer in the neural network which comes before the output
+  // layer, the delta values are given del_n = w_n' * del_(n+1) * f'(z_n).
+  // Since our cost function also includes the KL divergence term, we adjust
+  // for that in the formula below.  The delta values are then used with input
+  // layer and hidden layer activations to get the parameter gradients of each
+  // range.
+  const arma::vec klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
+      (1 - rhoCap));
+  std::vector<arma::mat> gradients(numRanges);
+  Threads::ParallelFor(0, numRanges, [&](const size_t r)
+  {
+    arma::mat& g = gradients[r];
+    g.zeros(2 * hiddenSize + 1, visibleSize + 1);
+
+    const size_t first = begin + r * rangeSize;
+    if (first >= begin + batchSize)
+      return;
+    const size_t last = std::min(first + rangeSize, begin + batchSize) - 1;
+
+    const arma::mat& delOut = outputLayers[r];
+    arma::mat& hiddenLayer = hiddenLayers[r];
+    g.submat(l1, 0, l3 - 1, l2 - 1) = hiddenLayer * delOut.t();
+    g.submat(l3, 0, l3, l2 - 1) = arma::sum(delOut, 1).t();
+
+    // The hidden buffer is overwritten with the hidden delta values.
+    arma::mat delHid = parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut;
+    delHid.each_col() += klDivGrad;
+    hiddenLayer %= (1 - hiddenLayer) % delHid;
+
+    g.submat(0, 0, l1 - 1, l2 - 1) = hiddenLayer * data.cols(first, last).t();
+    g.submat(0, l2, l1 - 1, l2) = arma::sum(hiddenLayer, 1);
+  });
+
+  gradient->zeros(2 * hiddenSize + 1, visibleSize + 1);
+  for (size_t r = 0; r < numRanges; ++r)
+    *gradient += gradients[r];
+  *gradient /= batchSize;
+
+  // Account for the regularization terms in the objective function.
+  gradient->submat(0, 0, l3 - 1, l2 - 1) += lambda *
+      parameters.submat(0, 0, l3 - 1, l2 - 1);
 
   return cost;
 }
-
-/** Calculates and stores the gradient values given a set of parameters.
-  */
-void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
-                                         arma::mat& gradient) const
-{
-  // Performs a feedforward pass of the neural network, and computes the
-  // activations of the output layer as in the Evaluate() method. It uses the
-  // Backpropagation algorithm to calculate the delta values at each layer,
-  // except for the input layer. The delta values are then used with input layer
-  // and hidden layer activations to get the parameter gradients.
-
-  // Compute the limits for the parameters w1, w2, b1 and b2.
-  const size_t l1 = hiddenSize;
-  const size_t l2 = visibleSize;
-  const size_t l3 = 2 * hiddenSize;
-
-  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
-  // used in their place to avoid copying data. The following representations
-  // are used:
-  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
-  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
-  // b1 <- parameters.submat(0, l2, l1-1, l2)
-  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
-
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
-
-  // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  arma::mat klDivGrad, delOut, delHid;
-
-  // The delta vector for the output layer is given by diff * f'(z), where z is
-  // the preactivation and f is the activation function. The derivative of the
-  // sigmoid function turns out to be f(z) * (1 - f(z)). For every other layer
-  // in the neural network which comes before the output layer, the delta values
-  // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
-  // includes the KL divergence term, we adjust for that in the formula below.
-  klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) / (1 - rhoCap));
-  delOut = diff % outputLayer % (1 - outputLayer);
-  delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
-      arma::repmat(klDivGrad, 1, data.n_cols)) % hiddenLayer %
-      (1 - hiddenLayer);
-
-  gradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
-
-  // Compute the gradient values using the activations and the delta values. The
-  // formula also accounts for the regularization terms in the objective.
-  // function.
-  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * data.t() / data.n_cols +
-      lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
-  gradient.submat(l1, 0, l3 - 1, l2 - 1) =
-      (delOut * hiddenLayer.t() / data.n_cols +
-      lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
-  gradient.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / data.n_cols;
-  gradient.submat(l3, 0, l3, l2 - 1) = (arma::sum(delOut, 1) / data.n_cols).t();
-}
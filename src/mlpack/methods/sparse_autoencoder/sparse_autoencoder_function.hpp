@@ -22,6 +22,13 @@ namespace nn {
  * This is a class for the sparse autoencoder objective function. It can be used
  * to create learning models like self-taught learning, stacked autoencoders,
  * conditional random fields (CRFs), and so forth.
+ *
+ * The function is decomposable, so it can be optimized with mini-batch
+ * optimizers such as SGD; on a batch, the sparsity term uses the average
+ * activations of the batch.  EvaluateWithGradient() shares one forward pass
+ * between the objective and the gradient.  The columns of a batch are split
+ * into ranges that are handled in parallel (see Threads), and the activations
+ * of each range are kept in buffers that are reused across calls.
  */
 class SparseAutoencoderFunction
 {
@@ -70,6 +77,61 @@ class SparseAutoencoderFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluate the objective function and its gradient with one feedforward
+   * pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective function on the given batch of points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the gradient of the objective function on the given batch of
+   * points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the objective function and its gradient on the given batch of
+   * points, with one feedforward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
+  //! Shuffle the points of the dataset.
+  void Shuffle();
+
+  //! Return the number of separable functions (the number of points).
+  size_t NumFunctions() const { return data.n_cols; }
+
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
    * function of a real number 'x' is [1 / (1 + exp(-x))].
@@ -145,8 +207,21 @@ class SparseAutoencoderFunction
   }
 
  private:
-  //! The matrix of data points.
-  const arma::mat& data;
+  /**
+   * Evaluate the objective function on the given batch of points, and its
+   * gradient if gradient is not NULL.
+   */
+  double Compute(const arma::mat& parameters,
+                 const size_t begin,
+                 const size_t batchSize,
+                 arma::mat* gradient) const;
+
+  //! The matrix of data points (an alias, unless it has been shuffled).
+  arma::mat data;
+  //! The hidden activations of each range of points, kept between calls.
+  mutable std::vector<arma::mat> hiddenLayers;
+  //! The output deltas of each range of points, kept between calls.
+  mutable std::vector<arma::mat> outputLayers;
   //! Initial parameter vector.
   arma::mat initialPoint;
   //! Size of the visible layer.
@@ -40,22 +40,29 @@ void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
   arma::mat matGram = trans(dictionary) * dictionary;
 
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
 
+  // The points are independent, so they are encoded in parallel, in batches;
+  // each batch reuses one LARS object (and its buffers) for all its points.
+  const size_t batchSize = 64;
+  const size_t numBatches = (data.n_cols + batchSize - 1) / batchSize;
+  Log::Debug << "Encoding " << data.n_cols << " points." << std::endl;
+  Threads::ParallelFor(0, numBatches, [&](const size_t batch)
+  {
     bool useCholesky = true;
     regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
+    arma::rowvec responses;
 
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    arma::vec code = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictionary, responses, code, false);
-  }
+    const size_t end = std::min((size_t) data.n_cols, (batch + 1) * batchSize);
+    for (size_t i = batch * batchSize; i < end; ++i)
+    {
+      // Create an alias of the code (using the same memory), and then LARS
+      // will place the result directly into that; then we will not need to
+      // have an extra copy.
+      arma::vec code = codes.unsafe_col(i);
+      responses = data.col(i).t();
+      lars.Train(dictionary, responses, code, false);
+    }
+  });
 }
 
 // Dictionary step for optimization.
@@ -14,14 +14,34 @@
 #define MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
 
+namespace mlpack {
+namespace svm {
+
+/**
+ * The hinge loss function of a linear SVM,
+ *
+ *   f(w) = sum_i max(0, 1 - y_i w^T x_i),
+ *
+ * for a sparse dataset x and labels y in {-1, 1}.  The parameters w are a
+ * column vector with one element per dimension.  The points of a batch are
+ * scored with one sparse-dense product, and EvaluateWithGradient() splits
+ * large batches across threads (see Threads).
+ */
 class SparseSVMFunction
 {
  public:
   //! Nothing to do for the default constructor.
   SparseSVMFunction() {}
 
-  //! Member initialization constructor.
+  /**
+   * Member initialization constructor.
+   *
+   * @param dataset The sparse training points, one per column.
+   * @param labels The labels of the points, either -1 or 1.
+   */
   SparseSVMFunction(const arma::sp_mat& dataset, const arma::vec& labels);
 
   /**
@@ -29,29 +49,80 @@ class SparseSVMFunction
    */
   void Shuffle();
 
+  /**
+   * Evaluate the hinge loss function on all the datapoints.
+   *
+   * @param parameters The parameters of the SVM.
+   * @return The value of the loss function at the given parameters.
+   */
+  double Evaluate(const arma::mat& parameters) const;
+
   /**
    * Evaluate the hinge loss function on the specified datapoints.
    *
    * @param parameters The parameters of the SVM.
-   * @param startId First index of the datapoints to use for function
+   * @param firstId First index of the datapoints to use for function
    *      evaluation.
    * @param batchSize Size of batch to process.
    * @return The value of the loss function at the given parameters.
    */
   double Evaluate(const arma::mat& parameters,
-                  const size_t startId,
-                  const size_t batchSize = 1);
+                  const size_t firstId,
+                  const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the gradient of the hinge loss function on all the datapoints.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param gradient Matrix (dense or sparse) to output the gradient into.
+   */
+  template<typename GradType>
+  void Gradient(const arma::mat& parameters, GradType& gradient) const;
 
   /**
-   * Evaluate the gradient the gradient of the hinge loss function, following
-   * the SparseFunctionType requirements on the Gradient function.
+   * Evaluate the gradient of the hinge loss function on the specified
+   * datapoints, following the SparseFunctionType requirements on the Gradient
+   * function.
    *
    * @param parameters The parameters of the SVM.
-   * @param id Index of the datapoint to use for the gradient evaluation.
-   * @param gradient Sparse matrix to output the gradient into.
+   * @param firstId First index of the datapoints to use for the gradient
+   *      evaluation.
+   * @param gradient Matrix (dense or sparse) to output the gradient into.
+   * @param batchSize Size of batch to process.
+   */
+  template<typename GradType>
+  void Gradient(const arma::mat& parameters,
+                const size_t firstId,
+                GradType& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the hinge loss function and its gradient on all the datapoints.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param gradient Matrix (dense or sparse) to output the gradient into.
+   * @return The value of the loss function at the given parameters.
    */
-  template <typename GradType>
-  void Gradient(const arma::mat& parameters, size_t id, GradType& gradient);
+  template<typename GradType>
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              GradType& gradient) const;
+
+  /**
+   * Evaluate the hinge loss function and its gradient on the specified
+   * datapoints.  The batch is split into ranges that are handled in parallel,
+   * and the partial results of the ranges are summed afterwards.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param firstId First index of the datapoints to use.
+   * @param gradient Matrix (dense or sparse) to output the gradient into.
+   * @param batchSize Size of batch to process.
+   * @return The value of the loss function at the given parameters.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t firstId,
+                              GradType& gradient,
+                              const size_t batchSize = 1) const;
 
   //! Return the initial point for the optimization.
   const arma::mat& InitialPoint() const { return initialPoint; }
@@ -69,9 +140,18 @@ class SparseSVMFunction
   arma::vec& Labels() { return labels; }
 
   //! Return the number of functions.
-  size_t NumFunctions();
+  size_t NumFunctions() const;
 
  private:
+  /**
+   * Compute the hinge loss of the given range of points, and, if gradient is
+   * not NULL, store the (unnormalized) gradient of the range in it.
+   */
+  double RangeLoss(const arma::mat& parameters,
+                   const size_t firstId,
+                   const size_t count,
+                   arma::vec* gradient) const;
+
   //! The initial point, from which to start the optimization.
   arma::mat initialPoint;
 
@@ -82,6 +162,9 @@ class SparseSVMFunction
   arma::vec labels;
 };
 
+} // namespace svm
+} // namespace mlpack
+
 // Include implementation
 #include "sparse_svm_function_impl.hpp"
 
@@ -16,13 +16,18 @@
 // In case it hasn't been included yet.
 #include "sparse_svm_function.hpp"
 
-SparseSVMFunction::SparseSVMFunction(
+namespace mlpack {
+namespace svm {
+
+inline SparseSVMFunction::SparseSVMFunction(
     const arma::sp_mat& dataset, const arma::vec& labels) :
     dataset(dataset),
     labels(math::MakeAlias(const_cast<arma::vec&>(labels), false))
-{ /* Nothing to do */ }
+{
+  initialPoint.zeros(dataset.n_rows, 1);
+}
 
-void SparseSVMFunction::Shuffle()
+inline void SparseSVMFunction::Shuffle()
 {
   arma::sp_mat newDataset;
   arma::vec newLabels;
@@ -30,51 +35,126 @@ void SparseSVMFunction::Shuffle()
   // Shuffle the data.
   math::ShuffleData(dataset, labels, newDataset, newLabels);
 
-  math::ClearAlias(newLabels);
+  // If we are an alias, make sure we don't write to the original labels.
+  math::ClearAlias(labels);
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
 }
 
-double SparseSVMFunction::Evaluate(const arma::mat& parameters,
-                                   const size_t firstId,
-                                   const size_t batchSize)
+inline double SparseSVMFunction::RangeLoss(const arma::mat& parameters,
+                                           const size_t firstId,
+                                           const size_t count,
+                                           arma::vec* gradient) const
+{
+  const size_t lastId = firstId + count - 1;
+
+  // The margins y_i w^T x_i of all the points, with one sparse-dense product.
+  const arma::rowvec margins = (parameters.t() * dataset.cols(firstId,
+      lastId)) % labels.subvec(firstId, lastId).t();
+
+  // Only the points inside the margin contribute -y_i x_i to the gradient, so
+  // their coefficients are collected and multiplied by the data at once.
+  double loss = 0.0;
+  arma::vec coefficients(count, arma::fill::zeros);
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (margins[i] < 1.0)
+    {
+      loss += 1.0 - margins[i];
+      coefficients[i] = -labels[firstId + i];
+    }
+  }
+
+  if (gradient)
+    *gradient = dataset.cols(firstId, lastId) * coefficients;
+
+  return loss;
+}
+
+inline double SparseSVMFunction::Evaluate(const arma::mat& parameters) const
+{
+  return Evaluate(parameters, 0, dataset.n_cols);
+}
+
+inline double SparseSVMFunction::Evaluate(const arma::mat& parameters,
+                                          const size_t firstId,
+                                          const size_t batchSize) const
+{
+  return RangeLoss(parameters, firstId, batchSize, NULL);
+}
+
+template<typename GradType>
+void SparseSVMFunction::Gradient(const arma::mat& parameters,
+                                 GradType& gradient) const
+{
+  EvaluateWithGradient(parameters, 0, gradient, dataset.n_cols);
+}
+
+template<typename GradType>
+void SparseSVMFunction::Gradient(const arma::mat& parameters,
+                                 const size_t firstId,
+                                 GradType& gradient,
+                                 const size_t batchSize) const
+{
+  EvaluateWithGradient(parameters, firstId, gradient, batchSize);
+}
+
+template<typename GradType>
+double SparseSVMFunction::EvaluateWithGradient(const arma::mat& parameters,
+                                               GradType& gradient) const
 {
-  // The hinge loss function.
-  const size_t lastId = firstId + batchSize - 1;
-  return arma::accu(arma::max(0.0, 1 - labels.subvec(firstId, lastId) %
-      dataset.cols(firstId, lastId) *
-      arma::repmat(parameters, 1, batchSize).t()));
+  return EvaluateWithGradient(parameters, 0, gradient, dataset.n_cols);
 }
 
-template <typename GradType>
-void SparseSVMFunction::Gradient(
-    const arma::mat& parameters,
-    const size_t firstId,
-    GradType& gradient,
-    const size_t batchSize)
+template<typename GradType>
+double SparseSVMFunction::EvaluateWithGradient(const arma::mat& parameters,
+                                               const size_t firstId,
+                                               GradType& gradient,
+                                               const size_t batchSize) const
 {
-  // Evaluate the gradient of the hinge loss function.
-  const size_t lastId = firstId + batchSize - 1;
-  arma::vec dots = 1 - labels.subvec(firstId, lastId) %
-      dataset.cols(firstId, lastId) *
-      arma::repmat(parameters, 1, batchSize).t();
-  gradient = GradType(parameters.n_rows, 1);
-  for (size_t i = 0; i < batchSize; ++i)
+  // Small batches (as used by SGD) are not worth splitting.
+  const size_t minRangeSize = 1024;
+  const size_t numRanges = std::max((size_t) 1, std::min(Threads::Count(),
+      batchSize / minRangeSize));
+  const size_t rangeSize = (batchSize + numRanges - 1) / numRanges;
+
+  // Each range has its own partial loss and gradient.
+  std::vector<double> losses(numRanges, 0.0);
+  std::vector<arma::vec> gradients(numRanges);
+  Threads::ParallelFor(0, numRanges, [&](const size_t r)
   {
-    if (dots[i] >= 0)
+    const size_t begin = r * rangeSize;
+    if (begin >= batchSize)
     {
-      // Is this correct?
-      gradient += -1 * GradType(dataset.col(id) * labels(id));
+      gradients[r].zeros(dataset.n_rows);
+      return;
     }
+
+    const size_t count = std::min(rangeSize, batchSize - begin);
+    losses[r] = RangeLoss(parameters, firstId + begin, count, &gradients[r]);
+  });
+
+  double loss = 0.0;
+  arma::vec sum(dataset.n_rows, arma::fill::zeros);
+  for (size_t r = 0; r < numRanges; ++r)
+  {
+    loss += losses[r];
+    sum += gradients[r];
   }
+
+  gradient = GradType(sum);
+  return loss;
 }
 
-size_t SparseSVMFunction::NumFunctions()
+inline size_t SparseSVMFunction::NumFunctions() const
 {
   // The number of points in the dataset is the number of functions, as this
   // is a data dependent function.
   return dataset.n_cols;
 }
 
+} // namespace svm
+} // namespace mlpack
+
 #endif // MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_FUNCTION_IMPL_HPP
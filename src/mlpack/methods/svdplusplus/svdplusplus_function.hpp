@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/parallel_sgd.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/stratified_sgd.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/decay_policies/exponential_backoff.hpp>
 
 namespace mlpack {
@@ -105,6 +106,33 @@ class SVDPlusPlusFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Take an SGD step on one training example.  The user and item parameters
+   * are updated directly.  The implicit item factors that the rating depends
+   * on are shared with other users, so their update is only accumulated into
+   * the user's slot, and applied by the next call to Synchronize().  Thus this
+   * can be called concurrently for examples that share neither their user nor
+   * their item (see StratifiedSGD).
+   *
+   * @param parameters Parameters(user/item matrices, user/item bias,
+   *     item implicit matrix) of the decomposition.
+   * @param i Index of the training example.
+   * @param stepSize Step size of the update.
+   */
+  void Update(arma::mat& parameters,
+              const size_t i,
+              const double stepSize);
+
+  /**
+   * Apply the accumulated updates of the implicit item factors, in parallel
+   * over the items.
+   *
+   * @param parameters Parameters(user/item matrices, user/item bias,
+   *     item implicit matrix) of the decomposition.
+   * @param stepSize Step size of the updates.
+   */
+  void Synchronize(arma::mat& parameters, const double stepSize);
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
@@ -144,6 +172,12 @@ class SVDPlusPlusFunction
   size_t numUsers;
   //! Number of items in the given dataset.
   size_t numItems;
+  //! The implicit feedback data, with one column per item.
+  arma::sp_mat implicitUsers;
+  //! Accumulated updates of the implicit factors, with one column per user.
+  arma::mat implicitGradient;
+  //! Accumulated regularization weight of the implicit factors, per user.
+  arma::vec implicitWeight;
 };
 
 } // namespace svd
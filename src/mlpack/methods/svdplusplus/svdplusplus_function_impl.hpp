@@ -43,6 +43,10 @@ SVDPlusPlusFunction<MatType>::SVDPlusPlusFunction(const MatType& data,
   // Unused:
   //     row(rank).subvec(numUsers + numItems, numUsers + 2 * numItems - 1)
   initialPoint.randu(rank + 1, numUsers + 2 * numItems);
+
+  // Storage for the deferred updates of the implicit factors.
+  implicitGradient.zeros(rank, numUsers);
+  implicitWeight.zeros(numUsers);
 }
 
 template<typename MatType>
@@ -284,6 +288,94 @@ void SVDPlusPlusFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void SVDPlusPlusFunction<MatType>::Update(arma::mat& parameters,
+                                          const size_t i,
+                                          const double stepSize)
+{
+  // Indices for accessing the the correct parameter columns.
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+  const size_t implicitStart = numUsers + numItems;
+
+  // Iterate through each item which the user interacted with to calculate
+  // user vector.
+  arma::vec userVec(rank, arma::fill::zeros);
+  arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+  arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+  size_t implicitCount = 0;
+  for (; it != it_end; ++it)
+  {
+    userVec += parameters.col(implicitStart + it.row()).subvec(0, rank - 1);
+    implicitCount += 1;
+  }
+  if (implicitCount != 0)
+    userVec /= std::sqrt(implicitCount);
+  userVec += parameters.col(user).subvec(0, rank - 1);
+
+  // Prediction error for the example.
+  const double rating = data(2, i);
+  const double userBias = parameters(rank, user);
+  const double itemBias = parameters(rank, item);
+  const double ratingError = rating - userBias - itemBias -
+      arma::dot(userVec, parameters.col(item).subvec(0, rank - 1));
+
+  // Defer the update of the implicit factors, which may be shared with users
+  // that are being updated at the same time.
+  if (implicitCount != 0)
+  {
+    implicitGradient.col(user) += ratingError / std::sqrt(implicitCount) *
+        parameters.col(item).subvec(0, rank - 1);
+    implicitWeight[user] += lambda / implicitCount;
+  }
+
+  const arma::vec userVecUpdate = stepSize * 2 * (
+      lambda * parameters.col(user).subvec(0, rank - 1) -
+      ratingError * parameters.col(item).subvec(0, rank - 1));
+  parameters.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * parameters.col(item).subvec(0, rank - 1) -
+      ratingError * userVec);
+  parameters.col(user).subvec(0, rank - 1) -= userVecUpdate;
+  parameters(rank, user) -= stepSize * 2 * (lambda * userBias - ratingError);
+  parameters(rank, item) -= stepSize * 2 * (lambda * itemBias - ratingError);
+}
+
+template <typename MatType>
+void SVDPlusPlusFunction<MatType>::Synchronize(arma::mat& parameters,
+                                               const double stepSize)
+{
+  if (implicitUsers.n_cols != implicitData.n_rows)
+    implicitUsers = implicitData.t();
+
+  const size_t implicitStart = numUsers + numItems;
+  const size_t numImplicit = std::min((size_t) implicitUsers.n_cols, numItems);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) numImplicit; ++j)
+  {
+    // Sum the updates of all the users that interacted with the item.
+    double weight = 0.0;
+    arma::vec gradient(rank, arma::fill::zeros);
+    for (size_t k = implicitUsers.col_ptrs[j];
+         k < implicitUsers.col_ptrs[j + 1]; ++k)
+    {
+      const size_t user = implicitUsers.row_indices[k];
+      if (user >= numUsers)
+        continue;
+
+      weight += implicitWeight[user];
+      gradient += implicitGradient.col(user);
+    }
+
+    parameters.col(implicitStart + j).subvec(0, rank - 1) -= stepSize * 2 * (
+        weight * parameters.col(implicitStart + j).subvec(0, rank - 1) -
+        gradient);
+  }
+
+  implicitGradient.zeros();
+  implicitWeight.zeros();
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -399,159 +491,11 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
     mlpack::svd::SVDPlusPlusFunction<arma::mat>& function,
     arma::mat& iterate)
 {
-  double overallObjective = DBL_MAX;
-  double lastObjective;
-
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
-
-  const arma::mat data = function.Dataset();
-  const arma::sp_mat implicitData = function.ImplicitDataset();
-  const size_t numUsers = function.NumUsers();
-  const size_t numItems = function.NumItems();
-  const double lambda = function.Lambda();
-
-  // Rank of decomposition.
-  const size_t rank = function.Rank();
-
-  // Iterate till the objective is within tolerance or the maximum number of
-  // allowed iterations is reached. If maxIterations is 0, this will iterate
-  // till convergence.
-  for (size_t i = 1; i != maxIterations; ++i)
-  {
-    // Calculate the overall objective.
-    lastObjective = overallObjective;
-    overallObjective = 0;
-
-    #pragma omp parallel for reduction(+:overallObjective)
-    for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
-    {
-      overallObjective += function.Evaluate(iterate, j);
-    }
-
-    // Output current objective function.
-    Log::Info << "Parallel SGD: iteration " << i << ", objective "
-      << overallObjective << "." << std::endl;
-
-    if (std::isnan(overallObjective) || std::isinf(overallObjective))
-    {
-      Log::Warn << "Parallel SGD: converged to " << overallObjective
-        << "; terminating with failure. Try a smaller step size?"
-        << std::endl;
-      return overallObjective;
-    }
-
-    if (std::abs(lastObjective - overallObjective) < tolerance)
-    {
-      Log::Info << "SGD: minimized within tolerance " << tolerance << "; "
-        << "terminating optimization." << std::endl;
-      return overallObjective;
-    }
-
-    // Get the stepsize for this iteration
-    double stepSize = decayPolicy.StepSize(i);
-
-    if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
-
-    #pragma omp parallel
-    {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-        const size_t implicitStart = numUsers + numItems;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        // Iterate through each item which the user interacted with to calculate
-        // user vector.
-        arma::vec userVec(rank, arma::fill::zeros);
-        arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-        arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-        size_t implicitCount = 0;
-        for (; it != it_end; ++it)
-        {
-          userVec += iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
-          implicitCount += 1;
-        }
-        if (implicitCount != 0)
-          userVec /= std::sqrt(implicitCount);
-        userVec += iterate.col(user).subvec(0, rank - 1);
-
-        double ratingError = rating - userBias - itemBias -
-        arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * userVec);
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Update of item implicit vectors.
-        arma::mat itemImplicitUpdate(rank, implicitCount);
-        arma::Col<size_t> implicitItems(implicitCount);
-        it = implicitData.begin_col(user);
-        it_end = implicitData.end_col(user);
-        size_t implicitIndex = 0;
-        for (; it != it_end; ++it, ++implicitIndex)
-        {
-          itemImplicitUpdate.col(implicitIndex) =
-              stepSize * 2.0 * (lambda / implicitCount *
-              iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
-              ratingError / std::sqrt(implicitCount) *
-              iterate.col(item).subvec(0, rank - 1));
-          implicitItems(implicitIndex) = it.row();
-        }
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
-        }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-        for (size_t k = 0; k < implicitCount; ++k)
-        {
-          for (size_t i = 0; i < rank; ++i)
-          {
-            #pragma omp atomic
-            iterate(i, implicitStart + implicitItems(k)) -=
-                itemImplicitUpdate(i, k);
-          }
-        }
-      }
-    }
-  }
-  Log::Info << "\n Parallel SGD terminated with objective : "
-    << overallObjective << std::endl;
-
-  return overallObjective;
+  // The ratings are processed in blocks that share no users and no items, so
+  // the threads never update the same parameters and no atomics are needed.
+  StratifiedSGD<ExponentialBackoff> optimizer(maxIterations, tolerance, shuffle,
+      decayPolicy);
+  return optimizer.Optimize(function, iterate);
 }
 
 } // namespace optimization
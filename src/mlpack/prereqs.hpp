@@ -65,7 +65,7 @@ using enable_if_t = typename enable_if<B, T>::type;
 #undef BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
 #undef BOOST_MPL_LIMIT_LIST_SIZE
 #define BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
-#define BOOST_MPL_LIMIT_LIST_SIZE 50
+#define BOOST_MPL_LIMIT_LIST_SIZE 60
 
 // We'll need the necessary boost::serialization features, as well as what we
 // use with mlpack.  In Boost 1.59 and newer, the BOOST_PFTO code is no longer
@@ -115,6 +115,8 @@ or upgrade Boost to 1.59 or newer.
 // All code should have access to logging.
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
+#include <mlpack/core/util/profiler.hpp>
+#include <mlpack/core/util/work_counters.hpp>
 
 // This can be removed with Visual Studio supports an OpenMP version with
 // unsigned loop variables.
@@ -124,6 +126,9 @@ or upgrade Boost to 1.59 or newer.
   #define omp_size_t size_t
 #endif
 
+// Parallel code is controlled through the Threads class.
+#include <mlpack/core/util/threads.hpp>
+
 // We need to be able to mark functions deprecated.
 #include <mlpack/core/util/deprecated.hpp>
 
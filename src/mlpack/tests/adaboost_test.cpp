@@ -891,4 +891,55 @@ BOOST_AUTO_TEST_CASE(DecisionStumpSerializationTest)
   }
 }
 
+/**
+ * Compute the weighted votes of the weak learners of the given AdaBoost model
+ * one learner at a time, and make sure Classify() gives the same labels.
+ */
+template<typename WeakLearnerType>
+void CheckClassifyMatchesVotes(AdaBoost<WeakLearnerType>& a,
+                               const arma::mat& data)
+{
+  arma::mat votes(a.NumClasses(), data.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < a.WeakLearners(); ++i)
+  {
+    arma::Row<size_t> learnerLabels;
+    a.WeakLearner(i).Classify(data, learnerLabels);
+    for (size_t j = 0; j < data.n_cols; ++j)
+      votes(learnerLabels[j], j) += a.Alpha(i);
+  }
+
+  arma::Row<size_t> predictedLabels;
+  a.Classify(data, predictedLabels);
+
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, data.n_cols);
+  arma::uword maxIndex;
+  for (size_t j = 0; j < data.n_cols; ++j)
+  {
+    votes.col(j).max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictedLabels[j], maxIndex);
+  }
+}
+
+/**
+ * The blocked classification, and the one-pass classification with decision
+ * stumps, must give the labels of the weighted votes of the weak learners.
+ */
+BOOST_AUTO_TEST_CASE(ClassifyMatchesVotesTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 1000);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (data(0, i) + data(2, i) > 1.0) ? 1 :
+        ((data(1, i) > 0.7) ? 2 : 0);
+
+  DecisionStump<> ds(data, labels, 3, 10);
+  AdaBoost<DecisionStump<>> stumps(data, labels, 3, ds, 40, 1e-10);
+  BOOST_REQUIRE_GT(stumps.WeakLearners(), 1);
+  CheckClassifyMatchesVotes(stumps, data);
+
+  Perceptron<> p(data, labels, 3, 100);
+  AdaBoost<> perceptrons(data, labels, 3, p, 20, 1e-10);
+  CheckClassifyMatchesVotes(perceptrons, data);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -424,6 +424,73 @@ BOOST_AUTO_TEST_CASE(GradientLinearLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Make sure the FusedLinear layer computes the same output as a Linear layer
+ * followed by the activation layer.
+ */
+BOOST_AUTO_TEST_CASE(SimpleFusedLinearLayerTest)
+{
+  arma::mat output, linearOutput, expectedOutput, input;
+  FusedLinear<TanhFunction> module(10, 5);
+  module.Parameters().randu();
+  module.Reset();
+
+  Linear<> linear(10, 5);
+  linear.Parameters() = module.Parameters();
+  linear.Reset();
+  TanHLayer<> activation;
+
+  input = arma::randn(10, 4);
+  module.Forward(std::move(input), std::move(output));
+  linear.Forward(std::move(input), std::move(linearOutput));
+  activation.Forward(std::move(linearOutput), std::move(expectedOutput));
+
+  CheckMatrices(output, expectedOutput, 1e-10);
+}
+
+/**
+ * FusedLinear layer numerical gradient test, for the first layer (which does
+ * not get a Backward() call) and a hidden layer.
+ */
+BOOST_AUTO_TEST_CASE(GradientFusedLinearLayerTest)
+{
+  // FusedLinear function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(10, 1);
+      target = arma::mat("1");
+
+      model = new FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<FusedLinear<TanhFunction> >(10, 5);
+      model->Add<FusedLinear<LogisticFunction> >(5, 2);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
 /**
  * Simple linear no bias module test.
  */
@@ -900,6 +967,100 @@ BOOST_AUTO_TEST_CASE(GradientFastLSTMLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 0.2);
 }
 
+/**
+ * FastLSTM layer numerical gradient test with a batch of several sequences.
+ */
+BOOST_AUTO_TEST_CASE(GradientFastLSTMLayerBatchTest)
+{
+  // Fast LSTM function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(1, 4, 5);
+      target = arma::ones(1, 4, 5);
+      target.tube(0, 1, 0, 2).fill(2);
+      const size_t rho = 5;
+
+      model = new RNN<NegativeLogLikelihood<> >(rho);
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(1, 10);
+      model->Add<FastLSTM<> >(10, 3, rho);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 4);
+      model->Gradient(model->Parameters(), 0, gradient, 4);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    RNN<NegativeLogLikelihood<> >* model;
+    arma::cube input, target;
+  } function;
+
+  // See GradientFastLSTMLayerTest for the threshold.
+  BOOST_REQUIRE_LE(CheckGradient(function), 0.2);
+}
+
+/**
+ * FastLSTM layer numerical gradient test with truncated backpropagation
+ * through time: rho is shorter than the sequences, so the objective is the sum
+ * over windows of rho steps.
+ */
+BOOST_AUTO_TEST_CASE(GradientFastLSTMLayerTruncatedTest)
+{
+  // Fast LSTM function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(1, 2, 7);
+      target = arma::ones(1, 2, 7);
+      target.tube(0, 1, 0, 1).fill(3);
+      const size_t rho = 3;
+
+      model = new RNN<NegativeLogLikelihood<> >(rho);
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(1, 10);
+      model->Add<FastLSTM<> >(10, 3, rho);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 2);
+      model->Gradient(model->Parameters(), 0, gradient, 2);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    RNN<NegativeLogLikelihood<> >* model;
+    arma::cube input, target;
+  } function;
+
+  // See GradientFastLSTMLayerTest for the threshold.
+  BOOST_REQUIRE_LE(CheckGradient(function), 0.2);
+}
+
 /**
  * Check if the gradients computed by GRU cell are close enough to the
  * approximation of the gradients.
@@ -1629,6 +1790,148 @@ BOOST_AUTO_TEST_CASE(GradientAtrousConvolutionLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-3);
 }
 
+/**
+ * Make sure the im2col based Convolution layer returns the same results as the
+ * naive convolution rule.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvolutionLayerTest)
+{
+  arma::mat input, naiveOutput, output, naiveDelta, delta;
+  arma::mat naiveGradient, gradient;
+  input = arma::randu(5 * 5 * 2, 1);
+
+  Convolution<NaiveConvolution<ValidConvolution>,
+              NaiveConvolution<FullConvolution>,
+              NaiveConvolution<ValidConvolution> > naiveModule(2, 3, 3, 3, 1,
+      1, 1, 1, 5, 5);
+  naiveModule.Parameters() = arma::randu(2 * 3 * 3 * 3 + 3, 1);
+  naiveModule.Reset();
+
+  Convolution<> module(2, 3, 3, 3, 1, 1, 1, 1, 5, 5);
+  module.Parameters() = naiveModule.Parameters();
+  module.Reset();
+
+  // Test the Forward function.
+  naiveModule.Forward(std::move(input), std::move(naiveOutput));
+  module.Forward(std::move(input), std::move(output));
+  CheckMatrices(naiveOutput, output, 1e-6);
+
+  // Test the Backward function.
+  naiveModule.Backward(std::move(input), std::move(naiveOutput),
+      std::move(naiveDelta));
+  module.Backward(std::move(input), std::move(output), std::move(delta));
+  CheckMatrices(naiveDelta, delta, 1e-6);
+
+  // Test the Gradient function.
+  naiveModule.Gradient(std::move(input), std::move(naiveOutput),
+      std::move(naiveGradient));
+  module.Gradient(std::move(input), std::move(output), std::move(gradient));
+  CheckMatrices(naiveGradient, gradient, 1e-6);
+}
+
+/**
+ * Convolution layer numerical gradient test (strided and padded).
+ */
+BOOST_AUTO_TEST_CASE(GradientConvolutionLayerTest)
+{
+  // Add function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(6 * 6 * 2, 1);
+      target = arma::mat("1");
+
+      model = new FFN<NegativeLogLikelihood<>, RandomInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<Convolution<> >(2, 2, 3, 3, 2, 2, 1, 1, 6, 6);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, RandomInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-3);
+}
+
+/**
+ * Make sure that the dense and convolution layers can be used with single
+ * precision matrices and return the same results as in double precision.
+ */
+BOOST_AUTO_TEST_CASE(FloatLayerTest)
+{
+  arma::mat input = arma::randu(5 * 5 * 2, 3);
+  arma::fmat inputFloat = arma::conv_to<arma::fmat>::from(input);
+
+  // Linear layer followed by a LogSoftMax layer.
+  Linear<> linear(50, 10);
+  linear.Parameters() = arma::randu(50 * 10 + 10, 1);
+  linear.Reset();
+  Linear<arma::fmat, arma::fmat> linearFloat(50, 10);
+  linearFloat.Parameters() = arma::conv_to<arma::fmat>::from(
+      linear.Parameters());
+  linearFloat.Reset();
+
+  LogSoftMax<> logSoftMax;
+  LogSoftMax<arma::fmat, arma::fmat> logSoftMaxFloat;
+
+  arma::mat linearOutput, output, delta;
+  arma::fmat linearOutputFloat, outputFloat, deltaFloat;
+  linear.Forward(std::move(input), std::move(linearOutput));
+  linearFloat.Forward(std::move(inputFloat), std::move(linearOutputFloat));
+  CheckMatrices(linearOutput,
+      arma::conv_to<arma::mat>::from(linearOutputFloat), 1e-3);
+
+  logSoftMax.Forward(std::move(linearOutput), std::move(output));
+  logSoftMaxFloat.Forward(std::move(linearOutputFloat),
+      std::move(outputFloat));
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(outputFloat), 1e-3);
+
+  linear.Backward(std::move(input), std::move(output), std::move(delta));
+  linearFloat.Backward(std::move(inputFloat), std::move(outputFloat),
+      std::move(deltaFloat));
+  CheckMatrices(delta, arma::conv_to<arma::mat>::from(deltaFloat), 1e-3);
+
+  // Convolution layer.
+  Convolution<> conv(2, 3, 3, 3, 1, 1, 1, 1, 5, 5);
+  conv.Parameters() = arma::randu(2 * 3 * 3 * 3 + 3, 1);
+  conv.Reset();
+  Convolution<Im2ColConvolution<ValidConvolution>,
+              Im2ColConvolution<FullConvolution>,
+              Im2ColConvolution<ValidConvolution>,
+              arma::fmat, arma::fmat> convFloat(2, 3, 3, 3, 1, 1, 1, 1, 5, 5);
+  convFloat.Parameters() = arma::conv_to<arma::fmat>::from(conv.Parameters());
+  convFloat.Reset();
+
+  conv.Forward(std::move(input), std::move(output));
+  convFloat.Forward(std::move(inputFloat), std::move(outputFloat));
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(outputFloat), 1e-3);
+
+  arma::mat gradient;
+  arma::fmat gradientFloat;
+  conv.Gradient(std::move(input), std::move(output), std::move(gradient));
+  convFloat.Gradient(std::move(inputFloat), std::move(outputFloat),
+      std::move(gradientFloat));
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(gradientFloat),
+      1e-2);
+}
+
 /**
  * Tests the LayerNorm layer.
  */
@@ -2028,4 +2331,207 @@ BOOST_AUTO_TEST_CASE(GradientReparametrizationLayerBetaTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Compare the MaxPooling and MeanPooling layers with a direct implementation,
+ * for the common 2x2 and 3x3 windows with stride 2.
+ */
+BOOST_AUTO_TEST_CASE(SimplePoolingLayerTest)
+{
+  const size_t width = 7, height = 7, channels = 2, batchSize = 3;
+  const size_t slices = channels * batchSize;
+
+  for (size_t kernel = 2; kernel <= 3; ++kernel)
+  {
+    const size_t outputSize = (width - kernel) / 2 + 1;
+    arma::mat input = arma::randu(width * height * channels, batchSize);
+
+    MaxPooling<> maxPooling(kernel, kernel, 2, 2);
+    maxPooling.InputWidth() = width;
+    maxPooling.InputHeight() = height;
+    MeanPooling<> meanPooling(kernel, kernel, 2, 2);
+    meanPooling.InputWidth() = width;
+    meanPooling.InputHeight() = height;
+
+    arma::mat maxOutput, meanOutput;
+    maxPooling.Forward(std::move(input), std::move(maxOutput));
+    meanPooling.Forward(std::move(input), std::move(meanOutput));
+    BOOST_REQUIRE_EQUAL(maxOutput.n_rows, outputSize * outputSize * channels);
+    BOOST_REQUIRE_EQUAL(meanOutput.n_rows, outputSize * outputSize * channels);
+
+    arma::mat error = arma::randu(maxOutput.n_rows, batchSize);
+    arma::cube inputCube(input.memptr(), width, height, slices, false, false);
+    arma::cube maxCube(maxOutput.memptr(), outputSize, outputSize, slices,
+        false, false);
+    arma::cube meanCube(meanOutput.memptr(), outputSize, outputSize, slices,
+        false, false);
+    arma::cube errorCube(error.memptr(), outputSize, outputSize, slices, false,
+        false);
+    arma::cube expectedDelta = arma::zeros<arma::cube>(width, height, slices);
+
+    for (size_t s = 0; s < slices; ++s)
+    {
+      for (size_t j = 0; j < outputSize; ++j)
+      {
+        for (size_t i = 0; i < outputSize; ++i)
+        {
+          arma::mat window = inputCube.slice(s).submat(i * 2, j * 2,
+              i * 2 + kernel - 1, j * 2 + kernel - 1);
+
+          arma::uword index;
+          BOOST_REQUIRE_CLOSE(maxCube(i, j, s), window.max(index), 1e-10);
+          BOOST_REQUIRE_CLOSE(meanCube(i, j, s),
+              arma::accu(window) / (kernel * kernel), 1e-10);
+
+          expectedDelta(i * 2 + index % kernel, j * 2 + index / kernel, s) +=
+              errorCube(i, j, s);
+        }
+      }
+    }
+
+    arma::mat delta;
+    maxPooling.Backward(std::move(input), std::move(error), std::move(delta));
+    CheckMatrices(delta, arma::mat(expectedDelta.memptr(), delta.n_rows,
+        batchSize));
+  }
+}
+
+/**
+ * Make sure that the single pass backward kernels of the activation layers and
+ * the single pass forward kernel of LogSoftMax give the same results as the
+ * matrix expressions.
+ */
+BOOST_AUTO_TEST_CASE(SinglePassActivationKernelTest)
+{
+  arma::mat input = arma::randn(9, 7);
+  arma::mat error = arma::randn(9, 7);
+
+  ReLULayer<> relu;
+  arma::mat output, delta;
+  relu.Forward(std::move(input), std::move(output));
+  CheckMatrices(output, arma::mat(arma::max(input,
+      arma::zeros(arma::size(input)))));
+  relu.Backward(std::move(output), std::move(error), std::move(delta));
+  CheckMatrices(delta, arma::mat(error % arma::sign(output)));
+
+  SigmoidLayer<> sigmoid;
+  sigmoid.Forward(std::move(input), std::move(output));
+  sigmoid.Backward(std::move(output), std::move(error), std::move(delta));
+  CheckMatrices(delta, arma::mat(error % output % (1.0 - output)));
+
+  TanHLayer<> tanhLayer;
+  tanhLayer.Forward(std::move(input), std::move(output));
+  tanhLayer.Backward(std::move(output), std::move(error), std::move(delta));
+  CheckMatrices(delta, arma::mat(error % (1.0 - arma::square(output))));
+
+  // The reference uses the exact exponential function.
+  LogSoftMax<> logSoftMax;
+  logSoftMax.Forward(std::move(input), std::move(output));
+  arma::mat expected = input;
+  expected.each_row() -= arma::log(arma::sum(arma::exp(input)));
+  BOOST_REQUIRE_LT(arma::abs(output - expected).max(), 1e-4);
+}
+
+/**
+ * Make sure that the branches of AddMerge and Concat give the same results
+ * when they are large enough to be evaluated in parallel.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBranchesTest)
+{
+  arma::mat input = arma::randu(64, 100);
+  arma::mat error = arma::randu(32, 100);
+
+  AddMerge<> addMerge(true, true);
+  Concat<> concat(true);
+  std::vector<Linear<>*> linear(4);
+  for (size_t i = 0; i < linear.size(); ++i)
+  {
+    linear[i] = new Linear<>(64, 32);
+    linear[i]->Parameters().randu();
+    linear[i]->Reset();
+  }
+  addMerge.Add(linear[0]);
+  addMerge.Add(linear[1]);
+  concat.Add(linear[2]);
+  concat.Add(linear[3]);
+
+  // The parameters of a Linear layer are the weights and then the bias.
+  std::vector<arma::mat> weights, biases;
+  for (size_t i = 0; i < linear.size(); ++i)
+  {
+    const arma::mat& parameters = linear[i]->Parameters();
+    weights.push_back(arma::mat(parameters.memptr(), 32, 64));
+    biases.push_back(parameters.rows(2048, 2079));
+  }
+
+  arma::mat expected = arma::zeros(32, 100);
+  arma::mat expectedDelta = arma::zeros(64, 100);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    expected += weights[i] * input;
+    expected.each_col() += arma::vec(biases[i]);
+    expectedDelta += weights[i].t() * error;
+  }
+
+  arma::mat output, delta;
+  addMerge.Forward(std::move(input), std::move(output));
+  CheckMatrices(output, expected);
+  addMerge.Backward(std::move(output), std::move(error), std::move(delta));
+  CheckMatrices(delta, expectedDelta);
+
+  // The output of every branch is one column of the Concat output.
+  concat.Forward(std::move(input), std::move(output));
+  BOOST_REQUIRE_EQUAL(output.n_cols, 2);
+  for (size_t i = 2; i < 4; ++i)
+  {
+    arma::mat branchOutput = weights[i] * input;
+    branchOutput.each_col() += arma::vec(biases[i]);
+    CheckMatrices(arma::mat(output.col(i - 2)),
+        arma::mat(arma::vectorise(branchOutput)));
+  }
+
+  // Unlike Concat, AddMerge doesn't own its layers.
+  delete linear[0];
+  delete linear[1];
+}
+
+/**
+ * Make sure that the blocked, single-pass statistics of the BatchNorm and
+ * LayerNorm layers match the two-pass results over several blocks.
+ */
+BOOST_AUTO_TEST_CASE(NormalizationBlockedStatisticsTest)
+{
+  // 10 rows: the batches are split into blocks of 409 columns.
+  arma::mat first = arma::randn(10, 1000) * 3 + 2;
+  arma::mat second = arma::randn(10, 700) * 3 + 2;
+  arma::mat output;
+
+  BatchNorm<> batchNorm(10);
+  batchNorm.Reset();
+  batchNorm.Forward(std::move(first), std::move(output));
+
+  arma::mat expected = first.each_col() - arma::mean(first, 1);
+  expected.each_col() /= arma::sqrt(arma::var(first, 1, 1) + 1e-8);
+  CheckMatrices(output, expected);
+
+  // The training statistics are merged over both batches.
+  batchNorm.Forward(std::move(second), std::move(output));
+  const arma::mat all = arma::join_rows(first, second);
+  CheckMatrices(batchNorm.TrainingMean(), arma::mat(arma::mean(all, 1)));
+  CheckMatrices(batchNorm.TrainingVariance(),
+      arma::mat(arma::var(all, 1, 1)));
+
+  // 5000 rows: every column is its own block.
+  arma::mat input = arma::randn(5000, 4) * 3 + 2;
+  LayerNorm<> layerNorm(5000);
+  layerNorm.Reset();
+  layerNorm.Forward(std::move(input), std::move(output));
+
+  expected = input.each_row() - arma::mean(input, 0);
+  expected.each_row() /= arma::sqrt(arma::var(input, 1, 0) + 1e-8);
+  CheckMatrices(output, expected);
+  CheckMatrices(layerNorm.Mean(), arma::mat(arma::mean(input, 0)));
+  CheckMatrices(layerNorm.Variance(),
+      arma::mat(arma::var(input, 1, 0)));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -109,4 +109,31 @@ BOOST_AUTO_TEST_CASE(RandomizedBlockKrylovSVDNoisyLowRankTest)
   BOOST_REQUIRE_SMALL(error, 1e-2);
 }
 
+/*
+ * Check that sparse data gives the same singular values as the same data in
+ * a dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedBlockKrylovSVDSparseTest)
+{
+  arma::mat dense;
+  CreateNoisyLowRankMatrix(dense, 200, 1000, 5, 0.5);
+
+  // Keep only part of the entries.
+  dense.elem(arma::find(arma::randu<arma::mat>(200, 1000) < 0.7)).zeros();
+  const arma::sp_mat data(dense);
+
+  const size_t rank = 5;
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, dense);
+
+  svd::RandomizedBlockKrylovSVD rSVDB(10, 20);
+  rSVDB.Apply(data, U2, s2, V2, rank);
+
+  double error = arma::max(arma::abs(s1.subvec(0, rank) - s2.subvec(0, rank)));
+  BOOST_REQUIRE_SMALL(error, 1e-2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
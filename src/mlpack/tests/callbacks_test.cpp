@@ -0,0 +1,171 @@
+/**
+ * @file callbacks_test.cpp
+ *
+ * Test the callbacks of the optimizers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
+#include <mlpack/core/optimizers/callbacks/callbacks.hpp>
+#include <mlpack/core/optimizers/problems/sgd_test_function.hpp>
+#include <mlpack/core/optimizers/problems/rosenbrock_function.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::optimization::test;
+
+BOOST_AUTO_TEST_SUITE(CallbacksTest);
+
+/**
+ * A callback that counts the events, and asks to terminate after the given
+ * number of steps.
+ */
+class CountingCallback
+{
+ public:
+  CountingCallback(const size_t maxSteps = 0) :
+      maxSteps(maxSteps), begin(0), end(0), steps(0), gradients(0), epochs(0)
+  { }
+
+  template<typename OptimizerType, typename FunctionType>
+  void BeginOptimization(OptimizerType&, FunctionType&, arma::mat&)
+  {
+    ++begin;
+  }
+
+  template<typename OptimizerType, typename FunctionType>
+  void EndOptimization(OptimizerType&, FunctionType&, arma::mat&)
+  {
+    ++end;
+  }
+
+  template<typename OptimizerType, typename FunctionType>
+  bool StepTaken(OptimizerType&, FunctionType&, arma::mat&)
+  {
+    return (++steps == maxSteps);
+  }
+
+  template<typename OptimizerType, typename FunctionType>
+  bool Gradient(OptimizerType&, FunctionType&, const arma::mat&,
+                const arma::mat&)
+  {
+    ++gradients;
+    return false;
+  }
+
+  template<typename OptimizerType, typename FunctionType>
+  bool EndEpoch(OptimizerType&, FunctionType&, const arma::mat&,
+                const size_t epoch, const double)
+  {
+    BOOST_REQUIRE_EQUAL(epoch, ++epochs);
+    return false;
+  }
+
+  size_t maxSteps;
+  size_t begin;
+  size_t end;
+  size_t steps;
+  size_t gradients;
+  size_t epochs;
+};
+
+/**
+ * Make sure SGD calls every event of a callback the right number of times,
+ * and that an optimization with callbacks gives the same result as one
+ * without.
+ */
+BOOST_AUTO_TEST_CASE(SGDCallbackEventsTest)
+{
+  SGDTestFunction f;
+  // The negative tolerance keeps SGD from terminating early.
+  StandardSGD s(0.0003, 1, 300, -1.0, false);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  arma::mat coordinates2 = f.GetInitialPoint();
+  CountingCallback counter;
+  const double result = s.Optimize(f, coordinates, counter);
+  const double result2 = s.Optimize(f, coordinates2);
+
+  BOOST_REQUIRE_EQUAL(counter.begin, 1);
+  BOOST_REQUIRE_EQUAL(counter.end, 1);
+  BOOST_REQUIRE_EQUAL(counter.steps, 300);
+  BOOST_REQUIRE_EQUAL(counter.gradients, 300);
+  // There are three functions, and the last epoch isn't finished when the
+  // maximum number of iterations is reached.
+  BOOST_REQUIRE_EQUAL(counter.epochs, 99);
+
+  BOOST_REQUIRE_CLOSE(result, result2, 1e-10);
+  CheckMatrices(coordinates, coordinates2);
+
+  // A callback can stop the optimization.
+  CountingCallback stopper(10);
+  coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates, stopper);
+  BOOST_REQUIRE_EQUAL(stopper.steps, 10);
+  BOOST_REQUIRE_EQUAL(stopper.end, 1);
+}
+
+/**
+ * Make sure EarlyStopAtMinLoss stops when the validation loss doesn't improve,
+ * and that TimeBudget and the callbacks of L-BFGS work.
+ */
+BOOST_AUTO_TEST_CASE(EarlyStopAndTimeBudgetTest)
+{
+  SGDTestFunction f;
+  StandardSGD s(0.0003, 1, 300, -1.0, false);
+
+  // A validation loss that never improves after the first epoch.
+  arma::mat coordinates = f.GetInitialPoint();
+  CountingCallback counter;
+  EarlyStopAtMinLoss earlyStop([](const arma::mat&) { return 1.0; }, 5);
+  s.Optimize(f, coordinates, earlyStop, counter);
+  BOOST_REQUIRE_EQUAL(counter.epochs, 6);
+  BOOST_REQUIRE_EQUAL(earlyStop.BestLoss(), 1.0);
+
+  // An exhausted budget stops after the first step.
+  coordinates = f.GetInitialPoint();
+  CountingCallback counter2;
+  s.Optimize(f, coordinates, TimeBudget(0.0), counter2);
+  BOOST_REQUIRE_EQUAL(counter2.steps, 1);
+
+  // Stop L-BFGS after three iterations.
+  RosenbrockFunction rf;
+  L_BFGS lbfgs;
+  coordinates = rf.GetInitialPoint();
+  CountingCallback counter3(3);
+  lbfgs.Optimize(rf, coordinates, counter3);
+  BOOST_REQUIRE_EQUAL(counter3.steps, 3);
+  BOOST_REQUIRE_EQUAL(counter3.epochs, 3);
+  BOOST_REQUIRE_EQUAL(counter3.gradients, 4);
+}
+
+/**
+ * Make sure L-BFGS returns the objective of the coordinates restored by
+ * EarlyStopAtMinLoss, not the objective of the last iterate.
+ */
+BOOST_AUTO_TEST_CASE(LBFGSRestoreBestObjectiveTest)
+{
+  RosenbrockFunction rf;
+  L_BFGS lbfgs;
+
+  // A validation loss that gets worse every epoch, so the coordinates after
+  // the first iteration are restored.
+  size_t epochs = 0;
+  EarlyStopAtMinLoss earlyStop([&epochs](const arma::mat&)
+      { return (double) ++epochs; }, 2, true);
+  arma::mat coordinates = rf.GetInitialPoint();
+  const double result = lbfgs.Optimize(rf, coordinates, earlyStop);
+
+  BOOST_REQUIRE_EQUAL(epochs, 3);
+  BOOST_REQUIRE_CLOSE(result, rf.Evaluate(coordinates), 1e-10);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
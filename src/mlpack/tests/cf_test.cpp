@@ -20,6 +20,7 @@
 #include <mlpack/methods/cf/decomposition_policies/svd_complete_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/svd_incomplete_method.hpp>
 #include <mlpack/methods/cf/decomposition_policies/svdplusplus_method.hpp>
+#include <mlpack/methods/cf/decomposition_policies/als_method.hpp>
 #include <mlpack/methods/cf/normalization/no_normalization.hpp>
 #include <mlpack/methods/cf/normalization/overall_mean_normalization.hpp>
 #include <mlpack/methods/cf/normalization/user_mean_normalization.hpp>
@@ -117,6 +118,101 @@ void GetRecommendationsAllUsers()
   BOOST_REQUIRE_EQUAL(recommendations.n_cols, numUsers);
 }
 
+/**
+ * Make sure that the ratings of a whole block of weighted user combinations
+ * match the weighted sums of the ratings of the individual users.
+ */
+template<typename DecompositionPolicy>
+void GetRatingOfUsers()
+{
+  DecompositionPolicy decomposition;
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  // Random combinations of 5 users each.
+  const size_t numUsers = c.CleanedData().n_cols;
+  arma::Mat<size_t> neighbors = arma::randi<arma::Mat<size_t>>(5, 20,
+      arma::distr_param(0, (int) numUsers - 1));
+  arma::mat weights(5, 20, arma::fill::randu);
+
+  arma::mat ratings;
+  c.Decomposition().GetRatingOfUsers(neighbors, weights, ratings);
+
+  BOOST_REQUIRE_EQUAL(ratings.n_rows, c.CleanedData().n_rows);
+  BOOST_REQUIRE_EQUAL(ratings.n_cols, 20);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    arma::vec expected(ratings.n_rows, arma::fill::zeros);
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      arma::vec userRatings;
+      c.Decomposition().GetRatingOfUser(neighbors(j, i), userRatings);
+      expected += weights(j, i) * userRatings;
+    }
+
+    for (size_t k = 0; k < expected.n_elem; ++k)
+      BOOST_REQUIRE_SMALL(ratings(k, i) - expected(k), 1e-8);
+  }
+}
+
+/**
+ * Make sure that the recommendations for all users are the same as the
+ * recommendations that each user gets on its own.
+ */
+template<typename DecompositionPolicy>
+void GetRecommendationsBatchConsistency()
+{
+  DecompositionPolicy decomposition;
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(5, recommendations);
+
+  for (size_t i = 0; i < recommendations.n_cols; i += 13)
+  {
+    arma::Col<size_t> users(1);
+    users(0) = i;
+    arma::Mat<size_t> userRecommendations;
+    c.GetRecommendations(5, userRecommendations, users);
+
+    for (size_t j = 0; j < 5; ++j)
+      BOOST_REQUIRE_EQUAL(userRecommendations(j, 0), recommendations(j, i));
+  }
+}
+
+/**
+ * Make sure that the recommendations found with the item index are the same as
+ * the recommendations found by rating every item.
+ */
+template<typename DecompositionPolicy>
+void GetRecommendationsItemIndex()
+{
+  DecompositionPolicy decomposition;
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0, 199, 200);
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(5, recommendations, users);
+
+  typename CFType<DecompositionPolicy>::ItemIndexType index;
+  c.BuildItemIndex(index);
+  arma::Mat<size_t> indexRecommendations;
+  c.GetRecommendations(5, indexRecommendations, users, index);
+
+  BOOST_REQUIRE_EQUAL(indexRecommendations.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(indexRecommendations.n_cols, 200);
+  for (size_t i = 0; i < recommendations.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(indexRecommendations[i], recommendations[i]);
+}
+
 /**
  * Make sure that the recommendations are generated for queried users only.
  */
@@ -1160,6 +1256,69 @@ BOOST_AUTO_TEST_CASE(SerializationCombinedNormalizationTest)
                     ItemMeanNormalization>>();
 }
 
+/**
+ * Normalizing the same ratings as a coordinate list and as a sparse matrix
+ * must give the same normalized ratings, and denormalizing a block of ratings
+ * must give the same results as denormalizing each rating.  There are enough
+ * ratings for the passes to be split into several chunks.
+ */
+template<typename NormalizationType>
+void CheckNormalization()
+{
+  const size_t numUsers = 500, numItems = 400;
+  const arma::umat rated = (arma::randu<arma::mat>(numItems, numUsers) < 0.7);
+  const arma::uvec locations = arma::find(rated);
+  arma::mat data(3, locations.n_elem);
+  for (size_t i = 0; i < locations.n_elem; ++i)
+  {
+    data(0, i) = locations[i] / numItems;
+    data(1, i) = locations[i] % numItems;
+    data(2, i) = 1.0 + 4.0 * arma::randu();
+  }
+
+  arma::sp_mat cleanedData;
+  CFType<>::CleanData(data, cleanedData);
+
+  NormalizationType coordinateNormalization, sparseNormalization;
+  coordinateNormalization.Normalize(data);
+  sparseNormalization.Normalize(cleanedData);
+
+  arma::sp_mat normalizedData;
+  CFType<>::CleanData(data, normalizedData);
+  BOOST_REQUIRE_EQUAL(normalizedData.n_nonzero, cleanedData.n_nonzero);
+  BOOST_REQUIRE_SMALL(arma::abs(arma::mat(normalizedData) -
+      arma::mat(cleanedData)).max(), 1e-10);
+
+  arma::Col<size_t> users(20);
+  for (size_t j = 0; j < users.n_elem; ++j)
+    users[j] = (j * 37) % numUsers;
+  const arma::mat ratings = arma::randn<arma::mat>(numItems, users.n_elem);
+  arma::mat denormalized(ratings);
+  coordinateNormalization.Denormalize(users, denormalized);
+
+  for (size_t j = 0; j < users.n_elem; ++j)
+  {
+    for (size_t i = 0; i < numItems; ++i)
+    {
+      BOOST_REQUIRE_SMALL(denormalized(i, j) -
+          coordinateNormalization.Denormalize(users[j], i, ratings(i, j)),
+          1e-10);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(NormalizationConsistencyTest)
+{
+  CheckNormalization<OverallMeanNormalization>();
+  CheckNormalization<UserMeanNormalization>();
+  CheckNormalization<ItemMeanNormalization>();
+  CheckNormalization<ZScoreNormalization>();
+  CheckNormalization<CombinedNormalization<
+                         OverallMeanNormalization,
+                         UserMeanNormalization,
+                         ItemMeanNormalization>>();
+}
+
 /**
  * Make sure that Predict() is returning reasonable results for
  * EuclideanSearch.
@@ -1223,4 +1382,182 @@ BOOST_AUTO_TEST_CASE(CFPredictRegressionInterpolation)
             RegressionInterpolation>();
 }
 
+/**
+ * Make sure the blocked ratings of the plain and the biased decompositions
+ * match the per-user ratings.
+ */
+BOOST_AUTO_TEST_CASE(GetRatingOfUsersTest)
+{
+  GetRatingOfUsers<NMFPolicy>();
+  GetRatingOfUsers<BiasSVDPolicy>();
+}
+
+/**
+ * Make sure the blocked and parallel recommendations for all users match
+ * those of single users, with and without GetRatingOfUsers().
+ */
+BOOST_AUTO_TEST_CASE(GetRecommendationsBatchConsistencyTest)
+{
+  GetRecommendationsBatchConsistency<RegSVDPolicy>();
+  GetRecommendationsBatchConsistency<SVDPlusPlusPolicy>();
+}
+
+/**
+ * Make sure the maximum inner product search on the item index gives the same
+ * recommendations, with and without biases.
+ */
+BOOST_AUTO_TEST_CASE(GetRecommendationsItemIndexTest)
+{
+  GetRecommendationsItemIndex<RegSVDPolicy>();
+  GetRecommendationsItemIndex<BiasSVDPolicy>();
+}
+
+/**
+ * Make sure that the recommendations are generated for all users with the
+ * sparse ALS decomposition.
+ */
+BOOST_AUTO_TEST_CASE(CFGetRecommendationsAllUsersALSTest)
+{
+  GetRecommendationsAllUsers<ALSPolicy>();
+}
+
+/**
+ * Make sure that a new user can be folded into a trained model, that its user
+ * vector solves its least-squares problem, and that the other users are left
+ * untouched.
+ */
+BOOST_AUTO_TEST_CASE(FoldInUsersTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  RegSVDPolicy decomposition;
+  CFType<RegSVDPolicy> c(dataset, decomposition, 5, 5, 30);
+  const size_t numUsers = c.CleanedData().n_cols;
+  const arma::mat oldH = c.Decomposition().H();
+
+  // The new user rates the same items as user 0.
+  arma::uvec ratedBy0 = arma::find(dataset.row(0) == 0);
+  arma::mat newRatings = dataset.cols(ratedBy0);
+  newRatings.row(0).fill(numUsers);
+
+  c.FoldInUsers(newRatings, 0.01);
+
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, numUsers + 1);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().H().n_cols, numUsers + 1);
+  for (size_t i = 0; i < newRatings.n_cols; ++i)
+  {
+    const size_t item = (size_t) newRatings(1, i);
+    BOOST_REQUIRE_CLOSE(c.CleanedData()(item, numUsers), newRatings(2, i),
+        1e-5);
+  }
+  CheckMatrices(c.Decomposition().H().cols(0, numUsers - 1), oldH);
+
+  // The gradient of the regularized least-squares objective must vanish.
+  const arma::mat& w = c.Decomposition().W();
+  const arma::vec h = c.Decomposition().H().col(numUsers);
+  arma::vec gradient = 0.01 * h;
+  for (size_t i = 0; i < newRatings.n_cols; ++i)
+  {
+    const size_t item = (size_t) newRatings(1, i);
+    gradient += w.row(item).t() *
+        (arma::dot(w.row(item), h) - newRatings(2, i));
+  }
+  for (size_t k = 0; k < gradient.n_elem; ++k)
+    BOOST_REQUIRE_SMALL(gradient[k], 1e-6);
+
+  // Recommendations for the new user must skip the items it rated.
+  arma::Col<size_t> users(1);
+  users(0) = numUsers;
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(5, recommendations, users);
+  for (size_t j = 0; j < 5; ++j)
+  {
+    BOOST_REQUIRE_EQUAL((double) c.CleanedData()(recommendations(j, 0),
+        numUsers), 0.0);
+  }
+}
+
+/**
+ * Make sure that a new item can be folded into a trained model with user mean
+ * normalization, and that the other items are left untouched.
+ */
+BOOST_AUTO_TEST_CASE(FoldInItemsTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  NMFPolicy decomposition;
+  CFType<NMFPolicy, UserMeanNormalization> c(dataset, decomposition, 5, 5,
+      30);
+  const size_t numItems = c.CleanedData().n_rows;
+  const arma::mat oldW = c.Decomposition().W();
+
+  // The new item is rated by a few users.
+  arma::mat newRatings(3, 10);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    newRatings(0, i) = 3 * i;
+    newRatings(1, i) = numItems;
+    newRatings(2, i) = 1 + (i % 5);
+  }
+
+  c.FoldInItems(newRatings);
+
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_rows, numItems + 1);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().W().n_rows, numItems + 1);
+  CheckMatrices(c.Decomposition().W().rows(0, numItems - 1), oldW);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().row(numItems).n_nonzero, 10);
+
+  // The predictions for the new item are denormalized with the user means.
+  arma::Mat<size_t> combinations(2, 10);
+  combinations.row(0) = arma::conv_to<arma::Row<size_t>>::from(
+      newRatings.row(0));
+  combinations.row(1).fill(numItems);
+  arma::vec predictions;
+  c.Predict(combinations, predictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE(std::isfinite(predictions[i]));
+}
+
+/**
+ * Make sure that the cached neighborhoods give the same recommendations as the
+ * first search, with and without switching the neighbor search policy or the
+ * neighborhood size in between.
+ */
+BOOST_AUTO_TEST_CASE(CachedNeighborhoodTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<RegSVDPolicy> c(dataset, RegSVDPolicy(), 5, 5, 30);
+
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0, 9, 10);
+  arma::Mat<size_t> recommendations, cosineRecommendations;
+  c.GetRecommendations<CosineSearch>(5, cosineRecommendations, users);
+
+  // Search with another policy, then again with the first one.
+  c.GetRecommendations<EuclideanSearch>(5, recommendations, users);
+  arma::Mat<size_t> secondRecommendations;
+  c.GetRecommendations<CosineSearch>(5, secondRecommendations, users);
+  CheckMatrices(cosineRecommendations, secondRecommendations);
+
+  // A model with a different neighborhood size must not reuse the cache.
+  CFType<RegSVDPolicy> d(c);
+  d.NumUsersForSimilarity(3);
+  c.NumUsersForSimilarity(3);
+  arma::Mat<size_t> fresh, cached;
+  d.GetRecommendations<CosineSearch>(5, fresh, users);
+  c.GetRecommendations<CosineSearch>(5, cached, users);
+  CheckMatrices(fresh, cached);
+
+  // Predictions for single users come from the same cache.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    const double prediction = c.Predict<CosineSearch>(users[i], 0);
+    BOOST_REQUIRE_CLOSE(c.Predict<CosineSearch>(users[i], 0), prediction,
+        1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
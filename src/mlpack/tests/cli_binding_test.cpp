@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/bindings/cli/cli_option.hpp>
+#include <mlpack/bindings/cli/model_cache.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -631,4 +632,55 @@ BOOST_AUTO_TEST_CASE(DeleteAllocatedMemoryModelTest)
       (const void*) NULL, (void*) NULL);
 }
 
+/**
+ * Make sure that a model in a text format is added to the model cache, that
+ * the cached copy is used by later loads, and that it is not used anymore once
+ * the model file changes.
+ */
+BOOST_AUTO_TEST_CASE(ModelCacheTest)
+{
+  GaussianKernel gk(5.0);
+  data::Save("kernel_cache.xml", "model", gk);
+
+  const string cachePath = ModelCachePath("kernel_cache.xml", ".");
+  BOOST_REQUIRE(!cachePath.empty());
+  BOOST_REQUIRE_EQUAL(ModelCachePath("kernel_cache_missing.xml", "."), "");
+  remove(cachePath.c_str());
+
+  // The first load adds the model to the cache.
+  GaussianKernel loaded;
+  LoadCachedModel("kernel_cache.xml", ".", loaded);
+  BOOST_REQUIRE_EQUAL(loaded.Bandwidth(), 5.0);
+
+  GaussianKernel cached;
+  BOOST_REQUIRE(data::Load(cachePath, "model", cached, false,
+      data::format::binary));
+  BOOST_REQUIRE_EQUAL(cached.Bandwidth(), 5.0);
+
+  // Later loads use the cached copy.
+  GaussianKernel other(3.0);
+  data::Save(cachePath, "model", other, true, data::format::binary);
+  GaussianKernel loaded2;
+  LoadCachedModel("kernel_cache.xml", ".", loaded2);
+  BOOST_REQUIRE_EQUAL(loaded2.Bandwidth(), 3.0);
+
+  // A changed model file is loaded again.  (The trailing newline makes sure
+  // that the size of the file changes.)
+  GaussianKernel changed(12.5);
+  data::Save("kernel_cache.xml", "model", changed);
+  {
+    std::ofstream stream("kernel_cache.xml", std::ios::app);
+    stream << std::endl;
+  }
+  const string newCachePath = ModelCachePath("kernel_cache.xml", ".");
+  BOOST_REQUIRE_NE(newCachePath, cachePath);
+  GaussianKernel loaded3;
+  LoadCachedModel("kernel_cache.xml", ".", loaded3);
+  BOOST_REQUIRE_EQUAL(loaded3.Bandwidth(), 12.5);
+
+  remove("kernel_cache.xml");
+  remove(cachePath.c_str());
+  remove(newCachePath.c_str());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
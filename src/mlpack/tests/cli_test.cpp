@@ -27,6 +27,7 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -1125,4 +1126,73 @@ BOOST_AUTO_TEST_CASE(CppNameTest)
   BOOST_REQUIRE_EQUAL(CLI::Parameters().at("double").cppType, "double");
 }
 
+// The bandwidths seen by the runs of ServeTestMain().
+static std::vector<double> serveBandwidths;
+
+// A program for ServeTest.  It modifies its input model, and removes the file
+// of the first model, which must not be loaded again.
+static void ServeTestMain()
+{
+  GaussianKernel* kernel = CLI::GetParam<GaussianKernel*>("kernel");
+  serveBandwidths.push_back(kernel->Bandwidth() *
+      CLI::GetParam<double>("scale"));
+  kernel->Bandwidth(10.0 * kernel->Bandwidth());
+  remove("serve_kernel.txt");
+}
+
+/**
+ * Make sure that --serve runs each request with the options of the command
+ * line, and keeps the loaded model until a request gives another one, without
+ * the changes a run makes to it.
+ */
+BOOST_AUTO_TEST_CASE(ServeTest)
+{
+  AddRequiredCLIOptions();
+  CLIOption<bool> serve(false, "serve", "Serve runs.", "", "bool");
+
+  PARAM_MODEL_IN(GaussianKernel, "kernel", "Test kernel", "k");
+  PARAM_DOUBLE_IN("scale", "Test scale", "s", 1.0);
+
+  GaussianKernel kernel(0.5), kernel2(2.0);
+  data::Save("serve_kernel.txt", "model", kernel, true);
+  data::Save("serve_kernel2.txt", "model", kernel2, true);
+
+  const char* argv[4];
+  argv[0] = "./test";
+  argv[1] = "--kernel_file";
+  argv[2] = "serve_kernel.txt";
+  argv[3] = "--serve";
+
+  int argc = 4;
+
+  ParseCommandLine(argc, const_cast<char**>(argv));
+
+  serveBandwidths.clear();
+  std::istringstream in("--scale 2\n"
+                        "-s 3\n"
+                        "--unknown\n"
+                        "--kernel_file \"serve_kernel2.txt\"\n"
+                        "\n"
+                        "--scale 5\n");
+  std::ostringstream out;
+  Log::Fatal.ignoreInput = true;
+  Serve("./test", &ServeTestMain, in, out);
+  Log::Fatal.ignoreInput = false;
+
+  // The unknown option fails, and serving stops at the empty line.
+  BOOST_REQUIRE(out.str().find("mlpack: ok\nmlpack: ok\nmlpack: error: ") ==
+      0);
+  BOOST_REQUIRE(out.str().find("\nmlpack: ok\n") != std::string::npos);
+
+  // The model is loaded once, every run sees it unmodified, and the options
+  // of each request are reset.
+  BOOST_REQUIRE_EQUAL(serveBandwidths.size(), (size_t) 3);
+  BOOST_REQUIRE_CLOSE(serveBandwidths[0], 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(serveBandwidths[1], 1.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(serveBandwidths[2], 2.0, 1e-5);
+
+  remove("serve_kernel.txt");
+  remove("serve_kernel2.txt");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
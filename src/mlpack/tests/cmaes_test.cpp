@@ -162,4 +162,38 @@ BOOST_AUTO_TEST_CASE(ApproxCMAESLogisticRegressionTest)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * Run CMA-ES with the random selection policy on logistic regression, with
+ * the population evaluated by several threads, and make sure the results are
+ * acceptable.
+ */
+BOOST_AUTO_TEST_CASE(ParallelApproxCMAESLogisticRegressionTest)
+{
+  const size_t trials = 3;
+  bool success = false;
+  for (size_t trial = 0; trial < trials; ++trial)
+  {
+    arma::mat data, testData, shuffledData;
+    arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+    CreateLogisticRegressionTestData(data, testData, shuffledData,
+        responses, testResponses, shuffledResponses);
+
+    ApproxCMAES<> cmaes(0, -1, 1, 32, 200, 1e-3, RandomSelection(), 4);
+    BOOST_REQUIRE_EQUAL(cmaes.NumThreads(), 4);
+    LogisticRegression<> lr(shuffledData, shuffledResponses, cmaes, 0.5);
+
+    // Ensure that the error is close to zero.
+    const double acc = lr.ComputeAccuracy(data, responses);
+    const double testAcc = lr.ComputeAccuracy(testData, testResponses);
+    if (acc >= 99.7 && testAcc >= 99.4)
+    {
+      success = true;
+      break;
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(success, true);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
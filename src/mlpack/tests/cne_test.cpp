@@ -151,6 +151,39 @@ BOOST_AUTO_TEST_CASE(CNELogisticRegressionTest)
   BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
 }
 
+/**
+ * Train a logistic regression function with CNE, evaluating the population
+ * with several threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelCNELogisticRegressionTest)
+{
+  // Generate a two-Gaussian dataset, and a test set.
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000), testData(3, 1000);
+  arma::Row<size_t> responses(1000), testResponses(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    data.col(i) = (i < 500) ? g1.Random() : g2.Random();
+    responses[i] = (i < 500) ? 0 : 1;
+    testData.col(i) = (i < 500) ? g1.Random() : g2.Random();
+    testResponses[i] = responses[i];
+  }
+
+  CNE opt(200, 10000, 0.2, 0.2, 0.3, 65, -1, 4);
+  BOOST_REQUIRE_EQUAL(opt.NumThreads(), 4);
+
+  LogisticRegression<> lr(data, responses, opt, 0.5);
+
+  // Ensure that the error is close to zero.
+  const double acc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 0.3); // 0.3% error tolerance.
+
+  const double testAcc = lr.ComputeAccuracy(testData, testResponses);
+  BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
+}
+
 /**
  * Training a vanilla network on a larger dataset using CNE optimizer.
  */
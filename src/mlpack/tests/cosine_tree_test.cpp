@@ -222,4 +222,32 @@ BOOST_AUTO_TEST_CASE(CosineTreeModifiedGramSchmidt)
   }
 }
 
+/**
+ * Grow a cosine tree to an unreachable error under a basis size budget, and
+ * make sure that the budget is respected and that the basis is orthonormal.
+ */
+BOOST_AUTO_TEST_CASE(CosineTreeBasisBudget)
+{
+  arma::mat data = arma::randu(50, 200);
+
+  CosineTree ctree(data, 1e-10, 0.1, 10);
+  arma::mat basis;
+  ctree.GetFinalBasis(basis);
+
+  BOOST_REQUIRE_LE(basis.n_cols, 10);
+  BOOST_REQUIRE_GT(basis.n_cols, 1);
+
+  const arma::mat gram = basis.t() * basis;
+  for (size_t i = 0; i < gram.n_rows; ++i)
+  {
+    for (size_t j = 0; j < gram.n_cols; ++j)
+    {
+      if (i == j)
+        BOOST_REQUIRE_CLOSE(gram(i, j), 1.0, 1e-5);
+      else
+        BOOST_REQUIRE_SMALL(gram(i, j), 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -35,6 +35,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include "mock_categorical_data.hpp"
+#include "test_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -442,6 +443,31 @@ BOOST_AUTO_TEST_CASE(KFoldCVAccuracyTest)
   cv.Model();
 }
 
+/**
+ * Make sure that running the folds in parallel gives the same result as
+ * running them one by one.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVThreadsTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 500);
+  arma::rowvec responses = arma::randu<arma::rowvec>(4) * data +
+      0.1 * arma::randn<arma::rowvec>(500);
+
+  KFoldCV<LinearRegression, MSE> cv(10, data, responses, false);
+
+  const size_t threads = Threads::Count();
+  Threads::SetCount(1);
+  const double serialMSE = cv.Evaluate(0.1);
+  const arma::vec serialParameters = cv.Model().Parameters();
+
+  Threads::SetCount(4);
+  const double parallelMSE = cv.Evaluate(0.1);
+  Threads::SetCount(threads);
+
+  BOOST_REQUIRE_CLOSE(parallelMSE, serialMSE, 1e-5);
+  CheckMatrices(cv.Model().Parameters(), serialParameters);
+}
+
 /**
  * Test k-fold cross-validation with weighted linear regression.
  */
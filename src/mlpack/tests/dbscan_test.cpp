@@ -271,4 +271,33 @@ BOOST_AUTO_TEST_CASE(GaussiansSingleModeTest)
   }
 }
 
+
+/**
+ * Make sure searching in chunks gives the same clustering as searching all
+ * points at once.
+ */
+BOOST_AUTO_TEST_CASE(ChunkedBatchModeTest)
+{
+  arma::mat points(3, 1000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    points.col(i) = arma::randn<arma::vec>(3);
+    points(0, i) += 8.0 * (i % 4);
+  }
+
+  DBSCAN<> d(0.5, 4);
+  arma::Row<size_t> assignments;
+  const size_t clusters = d.Cluster(points, assignments);
+
+  const size_t chunkSizes[] = { 1, 97, 1000, 5000 };
+  for (size_t c = 0; c < 4; ++c)
+  {
+    DBSCAN<> chunked(0.5, 4, true, range::RangeSearch<>(),
+        RandomPointSelection(), chunkSizes[c]);
+    arma::Row<size_t> chunkedAssignments;
+    BOOST_REQUIRE_EQUAL(chunked.Cluster(points, chunkedAssignments), clusters);
+    CheckMatrices(assignments, chunkedAssignments);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -391,4 +391,39 @@ BOOST_AUTO_TEST_CASE(IntTest)
   BOOST_CHECK_EQUAL(predictedLabels(0, 7), 2);
 }
 
+/**
+ * Make sure that stumps trained from a stump that presorted the data are the
+ * same as stumps that sort the data themselves.
+ */
+BOOST_AUTO_TEST_CASE(PresortTest)
+{
+  arma::mat trainingData = arma::randu<arma::mat>(10, 500);
+  trainingData.row(3) = arma::floor(10 * trainingData.row(3));
+  arma::Row<size_t> labels(500);
+  for (size_t i = 0; i < 500; ++i)
+    labels[i] = (trainingData(3, i) + trainingData(7, i) > 5.5) ? 1 : 0;
+
+  DecisionStump<> other(trainingData, labels, 2, 5);
+  DecisionStump<> presortedOther(other);
+  presortedOther.Presort(trainingData);
+
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    arma::rowvec weights = arma::randu<arma::rowvec>(500);
+    weights /= arma::accu(weights);
+
+    DecisionStump<> ds(other, trainingData, labels, 2, weights);
+    DecisionStump<> presortedDs(presortedOther, trainingData, labels, 2,
+        weights);
+
+    BOOST_REQUIRE_EQUAL(ds.SplitDimension(), presortedDs.SplitDimension());
+    BOOST_REQUIRE_EQUAL(ds.Split().n_elem, presortedDs.Split().n_elem);
+    for (size_t i = 0; i < ds.Split().n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(ds.Split()[i], presortedDs.Split()[i]);
+      BOOST_REQUIRE_EQUAL(ds.BinLabels()[i], presortedDs.BinLabels()[i]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -367,6 +367,84 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * A fitness function that can only be evaluated on labels, so that
+ * BestBinaryNumericSplit has to evaluate every split point from scratch.
+ */
+template<typename FitnessFunction>
+class LabelsOnlyFitness
+{
+ public:
+  template<bool UseWeights, typename RowType, typename WeightVecType>
+  static double Evaluate(const RowType& labels,
+                         const size_t numClasses,
+                         const WeightVecType& weights)
+  {
+    return FitnessFunction::template Evaluate<UseWeights>(labels, numClasses,
+        weights);
+  }
+};
+
+/**
+ * Check that the one-pass split search with running class counts finds the
+ * same split as the evaluation of every split point from scratch.
+ */
+template<typename FitnessFunction>
+void CheckSweepSplit()
+{
+  arma::vec values = arma::round(100 * arma::randu<arma::vec>(1000));
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (values[i] > 60) ? 2 : (size_t) math::RandInt(2);
+  arma::rowvec weights = arma::randu<arma::rowvec>(1000);
+
+  const double bestGain = FitnessFunction::template Evaluate<false>(labels, 3,
+      weights);
+  const double bestWeightedGain = FitnessFunction::template Evaluate<true>(
+      labels, 3, weights);
+
+  arma::vec classProbabilities, expectedClassProbabilities;
+  typename BestBinaryNumericSplit<FitnessFunction>::template
+      AuxiliarySplitInfo<double> aux;
+  typename BestBinaryNumericSplit<LabelsOnlyFitness<FitnessFunction>>::
+      template AuxiliarySplitInfo<double> expectedAux;
+
+  const double gain = BestBinaryNumericSplit<FitnessFunction>::template
+      SplitIfBetter<false>(bestGain, values, labels, 3, weights, 5, 1e-7,
+      classProbabilities, aux);
+  const double expectedGain = BestBinaryNumericSplit<LabelsOnlyFitness<
+      FitnessFunction>>::template SplitIfBetter<false>(bestGain, values,
+      labels, 3, weights, 5, 1e-7, expectedClassProbabilities, expectedAux);
+
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_CLOSE(gain, expectedGain, 1e-5);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_EQUAL(expectedClassProbabilities.n_elem, 1);
+  BOOST_REQUIRE_EQUAL(classProbabilities[0], expectedClassProbabilities[0]);
+
+  const double weightedGain = BestBinaryNumericSplit<FitnessFunction>::template
+      SplitIfBetter<true>(bestWeightedGain, values, labels, 3, weights, 5,
+      1e-7, classProbabilities, aux);
+  const double expectedWeightedGain = BestBinaryNumericSplit<
+      LabelsOnlyFitness<FitnessFunction>>::template SplitIfBetter<true>(
+      bestWeightedGain, values, labels, 3, weights, 5, 1e-7,
+      expectedClassProbabilities, expectedAux);
+
+  BOOST_REQUIRE_GT(weightedGain, bestWeightedGain);
+  BOOST_REQUIRE_CLOSE(weightedGain, expectedWeightedGain, 1e-5);
+  BOOST_REQUIRE_EQUAL(classProbabilities[0], expectedClassProbabilities[0]);
+}
+
+BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitSweepGiniTest)
+{
+  CheckSweepSplit<GiniGain>();
+}
+
+BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitSweepInformationGainTest)
+{
+  CheckSweepSplit<InformationGain>();
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -465,6 +543,131 @@ BOOST_AUTO_TEST_CASE(AllCategoricalSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Make sure that the dense and the sparse CategoryCounts tables hold the same
+ * counts.
+ */
+BOOST_AUTO_TEST_CASE(CategoryCountsSparseTest)
+{
+  arma::vec values = arma::floor(100 * arma::randu<arma::vec>(500));
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(500,
+      arma::distr_param(0, 3));
+  arma::rowvec weights = arma::randu<arma::rowvec>(500);
+
+  CategoryCounts<double> dense(100, 4);
+  CategoryCounts<double> sparse(100, 4, 100);
+  dense.Add<true>(values, labels, weights);
+  sparse.Add<true>(values, labels, weights);
+
+  BOOST_REQUIRE(!dense.IsSparse());
+  BOOST_REQUIRE(sparse.IsSparse());
+  BOOST_REQUIRE_EQUAL(dense.NumColumns(), 100);
+  BOOST_REQUIRE_LE(sparse.NumColumns(), 100);
+
+  for (size_t c = 0; c < 100; ++c)
+    for (size_t l = 0; l < 4; ++l)
+      BOOST_REQUIRE_CLOSE(dense.Count(c, l) + 1.0, sparse.Count(c, l) + 1.0,
+          1e-10);
+
+  CheckMatrices(dense.ClassCounts(), sparse.ClassCounts());
+  BOOST_REQUIRE_CLOSE(accu(dense.Table()), accu(sparse.Table()), 1e-10);
+}
+
+/**
+ * Check that the BinaryCategoricalSplit groups the categories with the same
+ * class together.
+ */
+BOOST_AUTO_TEST_CASE(BinaryCategoricalSplitSimpleSplitTest)
+{
+  arma::vec values("0 0 0 1 1 1 2 2 2 3 3 3 4 4");
+  arma::Row<size_t> labels("0 0 0 1 1 1 0 0 0 1 1 1 0 0");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  BinaryCategoricalSplit<GiniGain>::AuxiliarySplitInfo<double> aux;
+
+  // Category 5 has no points.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BinaryCategoricalSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, 6, labels, 2, weights, 3, 1e-7, classProbabilities,
+      aux);
+  const double weightedGain =
+      BinaryCategoricalSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      6, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // The split is perfect.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+  BOOST_REQUIRE_EQUAL(gain, weightedGain);
+
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 6);
+  BOOST_REQUIRE_EQUAL(BinaryCategoricalSplit<GiniGain>::NumChildren(
+      classProbabilities, aux), 2);
+  const size_t left = (size_t) classProbabilities[0];
+  BOOST_REQUIRE_EQUAL((size_t) classProbabilities[2], left);
+  BOOST_REQUIRE_EQUAL((size_t) classProbabilities[4], left);
+  BOOST_REQUIRE_NE((size_t) classProbabilities[1], left);
+  BOOST_REQUIRE_EQUAL((size_t) classProbabilities[3],
+      (size_t) classProbabilities[1]);
+
+  // The category without points goes to the heavier child.
+  BOOST_REQUIRE_EQUAL((size_t) classProbabilities[5], left);
+
+  // No split is made if the children would be too small.
+  classProbabilities.clear();
+  const double noGain = BinaryCategoricalSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, 6, labels, 2, weights, 8, 1e-7, classProbabilities,
+      aux);
+  BOOST_REQUIRE_EQUAL(noGain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
+/**
+ * Make sure that a decision tree with binary categorical splits can be built
+ * on a simple categorical dataset.
+ */
+BOOST_AUTO_TEST_CASE(BinaryCategoricalBuildTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+  arma::Row<size_t> testLabels = l.subvec(2000, 3999);
+
+  DecisionTree<GiniGain, BestBinaryNumericSplit, BinaryCategoricalSplit>
+      tree(trainingData, di, trainingLabels, 5, 10);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(testData, predictions);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+  size_t correct = 0;
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    if (testLabels[i] == predictions[i])
+      ++correct;
+
+  // Every node has at most two children.
+  std::vector<const DecisionTree<GiniGain, BestBinaryNumericSplit,
+      BinaryCategoricalSplit>*> nodes(1, &tree);
+  while (!nodes.empty())
+  {
+    const DecisionTree<GiniGain, BestBinaryNumericSplit,
+        BinaryCategoricalSplit>* node = nodes.back();
+    nodes.pop_back();
+    BOOST_REQUIRE_LE(node->NumChildren(), 2);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      nodes.push_back(&node->Child(i));
+  }
+
+  const double correctPct = double(correct) / double(testData.n_cols);
+  BOOST_REQUIRE_GT(correctPct, 0.70);
+}
+
 /**
  * A basic construction of the decision tree---ensure that we can create the
  * tree and that it split at least once.
@@ -1126,4 +1329,194 @@ BOOST_AUTO_TEST_CASE(RegularisedDecisionTree)
   BOOST_REQUIRE_GT(count, 0);
 }
 
+/**
+ * Make sure that every value of a binned dataset is between the thresholds of
+ * its bin, and that the number of bins is respected.
+ */
+BOOST_AUTO_TEST_CASE(BinnedDatasetThresholdsTest)
+{
+  arma::mat dataset = arma::randn<arma::mat>(4, 2000);
+  dataset.row(3) = arma::round(5 * dataset.row(3)); // Few distinct values.
+
+  BinnedDataset binnedData(dataset, 32);
+
+  BOOST_REQUIRE_EQUAL(binnedData.NumPoints(), 2000);
+  BOOST_REQUIRE_EQUAL(binnedData.Dimensionality(), 4);
+  for (size_t d = 0; d < dataset.n_rows; ++d)
+  {
+    BOOST_REQUIRE_LE(binnedData.NumBins(d), 32);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      const size_t bin = binnedData.Codes()(i, d);
+      BOOST_REQUIRE_LT(bin, binnedData.NumBins(d));
+      if (bin > 0)
+        BOOST_REQUIRE_GT(dataset(d, i), binnedData.Threshold(d, bin - 1));
+      if (bin + 1 < binnedData.NumBins(d))
+        BOOST_REQUIRE_LE(dataset(d, i), binnedData.Threshold(d, bin));
+    }
+  }
+
+  // The last dimension has fewer distinct values than bins, so each value
+  // should have its own bin.
+  const arma::vec values = arma::unique(dataset.row(3).t());
+  BOOST_REQUIRE_EQUAL(binnedData.NumBins(3), values.n_elem);
+
+  BOOST_REQUIRE_THROW(BinnedDataset(dataset, 257), std::invalid_argument);
+}
+
+/**
+ * When no dimension has more distinct values than bins, the histogram-based
+ * training should build the same tree as the exact training.
+ */
+BOOST_AUTO_TEST_CASE(BinnedTrainingMatchesExactTrainingTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  BinnedDataset binnedData(dataset);
+
+  DecisionTree<> tree(dataset, labels, 3, 5);
+  DecisionTree<> binnedTree;
+  binnedTree.TrainBinned(binnedData, labels, 3, 5);
+
+  arma::Row<size_t> predictions, binnedPredictions;
+  tree.Classify(testDataset, predictions);
+  binnedTree.Classify(testDataset, binnedPredictions);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != binnedPredictions), 0);
+
+  // The same must hold with weights.
+  arma::rowvec weights = arma::randu<arma::rowvec>(dataset.n_cols);
+  DecisionTree<InformationGain> weightedTree(dataset, labels, 3, weights, 5);
+  DecisionTree<InformationGain> binnedWeightedTree;
+  binnedWeightedTree.TrainBinned(binnedData, labels, 3, weights, 5);
+
+  weightedTree.Classify(testDataset, predictions);
+  binnedWeightedTree.Classify(testDataset, binnedPredictions);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != binnedPredictions), 0);
+}
+
+/**
+ * Make sure that large nodes, which are trained in parallel, give the same tree
+ * with and without dataset information, and learn the data well.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainingTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 10000);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    if (dataset(0, i) + dataset(2, i) <= 1.0)
+      labels[i] = 0;
+    else
+      labels[i] = (dataset(1, i) > 0.3) ? 2 : 1;
+  }
+
+  data::DatasetInfo info(dataset.n_rows);
+  DecisionTree<> tree(dataset, labels, 3, 10);
+  DecisionTree<> infoTree(dataset, info, labels, 3, 10);
+
+  arma::Row<size_t> predictions, infoPredictions;
+  tree.Classify(dataset, predictions);
+  infoTree.Classify(dataset, infoPredictions);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != infoPredictions), 0);
+  BOOST_REQUIRE_GT(arma::accu(predictions == labels), 0.95 * dataset.n_cols);
+}
+
+/**
+ * Training on weighted indices of a dataset should give the same tree as
+ * training on a weighted copy of the indexed points.
+ */
+BOOST_AUTO_TEST_CASE(TrainSubsetMatchesCopyTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  // Take two thirds of the points, with random weights.
+  arma::uvec points = arma::find(arma::randu<arma::vec>(dataset.n_cols) <
+      0.66);
+  arma::rowvec weights = arma::randi<arma::rowvec>(points.n_elem,
+      arma::distr_param(1, 3));
+
+  const arma::mat subset = dataset.cols(points);
+  const arma::Row<size_t> subsetLabels = labels.cols(points);
+  DecisionTree<> tree(subset, subsetLabels, 3, weights, 5);
+  DecisionTree<> subsetTree;
+  subsetTree.TrainSubset(dataset, points, labels, 3, weights, 5);
+
+  arma::Row<size_t> predictions, subsetPredictions;
+  tree.Classify(testDataset, predictions);
+  subsetTree.Classify(testDataset, subsetPredictions);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != subsetPredictions), 0);
+
+  // The same must hold with dataset information.
+  data::DatasetInfo info(dataset.n_rows);
+  DecisionTree<> infoTree(subset, info, subsetLabels, 3, weights, 5);
+  DecisionTree<> infoSubsetTree;
+  infoSubsetTree.TrainSubset(dataset, info, points, labels, 3, weights, 5);
+
+  infoTree.Classify(testDataset, predictions);
+  infoSubsetTree.Classify(testDataset, subsetPredictions);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != subsetPredictions), 0);
+}
+
+/**
+ * Create a sparse dataset whose labels depend on a few of its dimensions.
+ */
+void SparseLabeledData(arma::sp_mat& data, arma::Row<size_t>& labels)
+{
+  data.sprandu(30, 600, 0.15);
+  labels.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (data(3, i) > 0.5 ? 1 : 0) + (data(17, i) > 0.2 ? 1 : 0);
+}
+
+/**
+ * A tree trained on a sparse dataset must be the same as a tree trained on the
+ * same dataset made dense, with and without weights.
+ */
+BOOST_AUTO_TEST_CASE(SparseTrainingMatchesDenseTest)
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  SparseLabeledData(data, labels);
+  const arma::mat denseData(data);
+
+  arma::sp_mat testData;
+  arma::Row<size_t> testLabels;
+  SparseLabeledData(testData, testLabels);
+  const arma::mat denseTestData(testData);
+
+  DecisionTree<> tree(data, labels, 3, 5);
+  DecisionTree<> denseTree(denseData, labels, 3, 5);
+
+  arma::Row<size_t> predictions, densePredictions, sparsePredictions;
+  tree.Classify(denseTestData, predictions);
+  denseTree.Classify(denseTestData, densePredictions);
+  tree.Classify(testData, sparsePredictions);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != densePredictions), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != sparsePredictions), 0);
+  BOOST_REQUIRE_GT(arma::accu(predictions == testLabels), 0.9 * 600);
+
+  // Integer weights keep the class counts exact, so the trees still match.
+  arma::rowvec weights = arma::randi<arma::rowvec>(data.n_cols,
+      arma::distr_param(1, 3));
+  DecisionTree<> weightedTree(data, labels, 3, weights, 5);
+  DecisionTree<> denseWeightedTree(denseData, labels, 3, weights, 5);
+
+  arma::mat probabilities, denseProbabilities;
+  weightedTree.Classify(testData, predictions, probabilities);
+  denseWeightedTree.Classify(denseTestData, densePredictions,
+      denseProbabilities);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != densePredictions), 0);
+  CheckMatrices(probabilities, denseProbabilities);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
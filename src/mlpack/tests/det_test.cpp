@@ -778,4 +778,77 @@ BOOST_AUTO_TEST_CASE(MoveOperatorTest)
   BOOST_REQUIRE_CLOSE(testDTree2.Right()->SplitValue(), 0.5, 1e-5);
 }
 
+/**
+ * Make sure the points of each leaf of a tree grown from a stream of chunks are
+ * the points that fall in the leaf.
+ */
+BOOST_AUTO_TEST_CASE(TestHistogramGrow)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 1000);
+  MatrixChunkSource<> source(data, 64);
+
+  const arma::vec maxVals = arma::max(data, 1);
+  const arma::vec minVals = arma::min(data, 1);
+  DTree<arma::mat> tree(maxVals, minVals, data.n_cols);
+  tree.GrowHistogram(source, false, 20, 5, 32);
+  BOOST_REQUIRE_GT(tree.SubtreeLeaves(), 1);
+
+  const int leaves = tree.TagTree();
+  BOOST_REQUIRE_EQUAL(leaves, (int) tree.SubtreeLeaves());
+
+  arma::Col<size_t> counts(leaves, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    ++counts[tree.FindBucket(data.col(i))];
+
+  // Walk the leaves and compare with their ranges.
+  std::vector<const DTree<arma::mat>*> nodes;
+  nodes.push_back(&tree);
+  size_t total = 0;
+  while (!nodes.empty())
+  {
+    const DTree<arma::mat>* node = nodes.back();
+    nodes.pop_back();
+    if (node->Left())
+    {
+      nodes.push_back(node->Left());
+      nodes.push_back(node->Right());
+      continue;
+    }
+
+    BOOST_REQUIRE_EQUAL(counts[node->BucketTag()], node->End() -
+        node->Start());
+    total += node->End() - node->Start();
+  }
+
+  BOOST_REQUIRE_EQUAL(total, data.n_cols);
+}
+
+/**
+ * Make sure the tree trained from a stream doesn't depend on the size of the
+ * chunks.
+ */
+BOOST_AUTO_TEST_CASE(TestHistogramTrainerChunkSize)
+{
+  arma::mat data = arma::randn<arma::mat>(2, 500);
+
+  MatrixChunkSource<> smallSource(data, 7);
+  MatrixChunkSource<> largeSource(data, 1000);
+
+  DTree<arma::mat>* smallTree = HistogramTrainer<arma::mat, int>(smallSource,
+      5, false, 10, 5, 16);
+  DTree<arma::mat>* largeTree = HistogramTrainer<arma::mat, int>(largeSource,
+      5, false, 10, 5, 16);
+
+  BOOST_REQUIRE_EQUAL(smallTree->SubtreeLeaves(), largeTree->SubtreeLeaves());
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const arma::vec point = data.col(i);
+    BOOST_REQUIRE_CLOSE(smallTree->ComputeValue(point),
+        largeTree->ComputeValue(point), 1e-5);
+  }
+
+  delete smallTree;
+  delete largeTree;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,180 @@
+/**
+ * @file distributed_sgd_test.cpp
+ *
+ * Test file for DistributedSGD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/distributed_sgd/distributed_sgd.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression_function.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+using namespace std;
+using namespace arma;
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::regression;
+
+BOOST_AUTO_TEST_SUITE(DistributedSGDTest);
+
+/**
+ * Create a dataset for logistic regression.
+ */
+void CreateDistributedSGDTestData(arma::mat& data, arma::Row<size_t>& labels)
+{
+  data.randu(5, 1024);
+  labels.set_size(1024);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (arma::accu(data.col(i)) > 2.5) ? 1 : 0;
+}
+
+/**
+ * With a single node, DistributedSGD should take exactly the same steps as
+ * SGD.
+ */
+BOOST_AUTO_TEST_CASE(SingleNodeDistributedSGDTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  CreateDistributedSGDTestData(data, labels);
+
+  LogisticRegressionFunction<> lrf(data, labels, 0.5);
+
+  SGD<> sgd(0.01, 16, 5 * 1024, 1e-8, false);
+  DistributedSGD<> distributedSgd(0.01, 16, 5 * 1024, 1e-8, false);
+
+  arma::mat coordinates = lrf.InitialPoint();
+  arma::mat distributedCoordinates = coordinates;
+  const double objective = sgd.Optimize(lrf, coordinates);
+  const double distributedObjective = distributedSgd.Optimize(lrf,
+      distributedCoordinates);
+
+  BOOST_REQUIRE_CLOSE(distributedObjective, objective, 1e-8);
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(distributedCoordinates[i], coordinates[i], 1e-8);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * A transport that simulates the nodes with the threads of an OpenMP parallel
+ * region, which share the given buffers.
+ */
+class SharedMemoryTransport
+{
+ public:
+  SharedMemoryTransport(std::vector<arma::mat>* buffers) : buffers(buffers) { }
+
+  size_t Rank() const { return omp_get_thread_num(); }
+
+  size_t NumNodes() const { return omp_get_num_threads(); }
+
+  void AllReduce(arma::mat& matrix)
+  {
+    (*buffers)[Rank()] = matrix;
+    #pragma omp barrier
+    matrix.zeros();
+    for (size_t i = 0; i < NumNodes(); ++i)
+      matrix += (*buffers)[i];
+    #pragma omp barrier
+  }
+
+  void Broadcast(arma::mat& matrix)
+  {
+    if (Rank() == 0)
+      (*buffers)[0] = matrix;
+    #pragma omp barrier
+    matrix = (*buffers)[0];
+    #pragma omp barrier
+  }
+
+ private:
+  std::vector<arma::mat>* buffers;
+};
+
+/**
+ * Run DistributedSGD on four simulated nodes, each with a quarter of the data,
+ * and make sure it takes the same steps as SGD with four times the batch size
+ * on the data ordered the same way.
+ */
+BOOST_AUTO_TEST_CASE(SimulatedNodesDistributedSGDTest)
+{
+  const size_t nodes = 4;
+  const size_t batchSize = 8;
+  const size_t shardSize = 256;
+
+  arma::mat data;
+  arma::Row<size_t> labels;
+  CreateDistributedSGDTestData(data, labels);
+
+  // Node k gets the columns [k * shardSize, (k + 1) * shardSize).  Each step
+  // of SGD on the reordered data then sees the batches of all the nodes.
+  arma::mat orderedData(data.n_rows, data.n_cols);
+  arma::Row<size_t> orderedLabels(data.n_cols);
+  size_t col = 0;
+  for (size_t b = 0; b < shardSize; b += batchSize)
+  {
+    for (size_t k = 0; k < nodes; ++k)
+    {
+      for (size_t j = 0; j < batchSize; ++j, ++col)
+      {
+        orderedData.col(col) = data.col(k * shardSize + b + j);
+        orderedLabels[col] = labels[k * shardSize + b + j];
+      }
+    }
+  }
+
+  // The shards have a different size than the whole dataset, so the
+  // regularization would not match.
+  LogisticRegressionFunction<> lrf(orderedData, orderedLabels, 0.0);
+  SGD<> sgd(0.01, nodes * batchSize, 5 * data.n_cols, -1.0, false);
+  arma::mat coordinates = lrf.InitialPoint();
+  const double objective = sgd.Optimize(lrf, coordinates);
+
+  std::vector<arma::mat> buffers(nodes);
+  std::vector<arma::mat> results(nodes);
+  std::vector<double> objectives(nodes);
+  size_t actualNodes = 0;
+  #pragma omp parallel num_threads(nodes)
+  {
+    const size_t k = omp_get_thread_num();
+    #pragma omp single
+    actualNodes = omp_get_num_threads();
+
+    LogisticRegressionFunction<> shard(
+        data.cols(k * shardSize, (k + 1) * shardSize - 1),
+        labels.cols(k * shardSize, (k + 1) * shardSize - 1), 0.0);
+
+    DistributedSGD<VanillaUpdate, SharedMemoryTransport> distributedSgd(0.01,
+        batchSize, 5 * shardSize, -1.0, false, VanillaUpdate(),
+        SharedMemoryTransport(&buffers));
+    results[k] = shard.InitialPoint();
+    objectives[k] = distributedSgd.Optimize(shard, results[k]);
+  }
+
+  BOOST_REQUIRE_EQUAL(actualNodes, nodes);
+  for (size_t k = 0; k < nodes; ++k)
+  {
+    BOOST_REQUIRE_CLOSE(objectives[k], objective, 1e-5);
+    for (size_t i = 0; i < coordinates.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(results[k][i], results[0][i]);
+      BOOST_REQUIRE_CLOSE(results[k][i], coordinates[i], 1e-5);
+    }
+  }
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -7,6 +7,7 @@
  *  * mlpack::distribution::DiscreteDistribution
  *  * mlpack::distribution::GaussianDistribution
  *  * mlpack::distribution::GammaDistribution
+ *  * mlpack::distribution::RegressionDistribution
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -14,6 +15,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core.hpp>
+#include <mlpack/core/dists/regression_distribution.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -580,6 +582,75 @@ BOOST_AUTO_TEST_CASE(GaussianDistributionTrainWithTwoDistProbabilitiesTest)
   BOOST_REQUIRE_CLOSE(guDist.Covariance()[0], cov1[0], 5);
 }
 
+/******************************************/
+/** Diagonal Gaussian Distribution Tests **/
+/******************************************/
+
+/**
+ * Make sure the diagonal Gaussian gives the same probabilities as a full
+ * Gaussian with the diagonal covariance, for single points and batches.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionProbabilityTest)
+{
+  const arma::vec mean("1.0 -2.0 0.5 3.0");
+  const arma::vec cov("0.5 2.0 1.5 0.1");
+  DiagonalGaussianDistribution d(mean, cov);
+  GaussianDistribution g(mean, arma::diagmat(cov));
+
+  BOOST_REQUIRE_EQUAL(d.Dimensionality(), 4);
+
+  arma::mat points(4, 100);
+  for (size_t i = 0; i < 100; ++i)
+    points.col(i) = g.Random();
+
+  arma::vec dLogProbs, gLogProbs;
+  d.LogProbability(points, dLogProbs);
+  g.LogProbability(points, gLogProbs);
+
+  for (size_t i = 0; i < 100; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(dLogProbs[i], gLogProbs[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(d.LogProbability(points.unsafe_col(i)), gLogProbs[i],
+        1e-5);
+  }
+}
+
+/**
+ * Make sure that training a diagonal Gaussian recovers the variance of each
+ * dimension, with and without probabilities.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionTrainTest)
+{
+  const arma::vec mean("5.0 -1.0 2.0");
+  const arma::vec cov("1.0 4.0 0.25");
+  DiagonalGaussianDistribution d(mean, cov);
+
+  arma::mat points(3, 10000);
+  for (size_t i = 0; i < 10000; ++i)
+    points.col(i) = d.Random();
+
+  DiagonalGaussianDistribution trained;
+  trained.Train(points);
+
+  BOOST_REQUIRE_EQUAL(trained.Covariance().n_elem, 3);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(trained.Mean()[i], mean[i], 5.0);
+    BOOST_REQUIRE_CLOSE(trained.Covariance()[i], cov[i], 5.0);
+  }
+
+  // Unit probabilities give the biased estimate of the covariance, which is
+  // almost the same for this many points.
+  DiagonalGaussianDistribution trainedProb;
+  trainedProb.Train(points, arma::ones<arma::vec>(10000));
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(trainedProb.Mean()[i], trained.Mean()[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(trainedProb.Covariance()[i], trained.Covariance()[i],
+        0.1);
+  }
+}
+
 /******************************/
 /** Gamma Distribution Tests **/
 /******************************/
@@ -958,4 +1029,104 @@ BOOST_AUTO_TEST_CASE(GammaDistributionLogProbabilityTest)
   BOOST_REQUIRE_CLOSE(prob3(1), std::log(0.026165), 1e-3);
 }
 
+/**
+ * Make sure that the sufficient statistics of two halves of a dataset, merged,
+ * give the same distributions as training on the whole dataset, for datasets
+ * large enough to be accumulated by several threads.
+ */
+BOOST_AUTO_TEST_CASE(SufficientStatisticsMergeTest)
+{
+  const size_t n = 20000;
+  const arma::vec probabilities = arma::randu<arma::vec>(n);
+  const arma::vec firstProbabilities = probabilities.subvec(0, n / 2 - 1);
+  const arma::vec secondProbabilities = probabilities.subvec(n / 2, n - 1);
+
+  // Discrete distribution.
+  arma::mat discreteData = arma::floor(4 * arma::randu<arma::mat>(2, n));
+  DiscreteDistribution discrete(arma::Col<size_t>("4 4"));
+  DiscreteDistribution::SufficientStatistics discreteStats =
+      discrete.Statistics(discreteData.cols(0, n / 2 - 1),
+      &firstProbabilities);
+  discreteStats.Merge(discrete.Statistics(discreteData.cols(n / 2, n - 1),
+      &secondProbabilities));
+  DiscreteDistribution merged(arma::Col<size_t>("4 4"));
+  merged.Train(discreteStats);
+  discrete.Train(discreteData, probabilities);
+  for (size_t d = 0; d < 2; ++d)
+    CheckMatrices(merged.Probabilities(d), discrete.Probabilities(d));
+
+  // Gaussian distribution, with and without probabilities.
+  arma::mat gaussianData = arma::randn<arma::mat>(3, n);
+  gaussianData.row(1) += 2 * gaussianData.row(0) + 5;
+  GaussianDistribution gaussian, mergedGaussian;
+  GaussianDistribution::SufficientStatistics gaussianStats =
+      GaussianDistribution::Statistics(gaussianData.cols(0, n / 2 - 1));
+  gaussianStats.Merge(GaussianDistribution::Statistics(
+      gaussianData.cols(n / 2, n - 1)));
+  BOOST_REQUIRE_EQUAL(gaussianStats.Count(), n);
+  mergedGaussian.Train(gaussianStats);
+  gaussian.Train(gaussianData);
+  CheckMatrices(mergedGaussian.Mean(), gaussian.Mean(), 1e-5);
+  CheckMatrices(mergedGaussian.Covariance(), gaussian.Covariance(), 1e-5);
+  CheckMatrices(gaussian.Mean(), arma::mean(gaussianData, 1), 1e-5);
+  CheckMatrices(gaussian.Covariance(), arma::cov(gaussianData.t()), 1e-5);
+
+  gaussianStats = GaussianDistribution::Statistics(
+      gaussianData.cols(0, n / 2 - 1), &firstProbabilities);
+  gaussianStats.Merge(GaussianDistribution::Statistics(
+      gaussianData.cols(n / 2, n - 1), &secondProbabilities));
+  mergedGaussian.Train(gaussianStats);
+  gaussian.Train(gaussianData, probabilities);
+  CheckMatrices(mergedGaussian.Mean(), gaussian.Mean(), 1e-5);
+  CheckMatrices(mergedGaussian.Covariance(), gaussian.Covariance(), 1e-5);
+
+  // Gamma distribution.
+  arma::mat gammaData(2, n);
+  std::gamma_distribution<double> dist(2.0, 3.0);
+  for (size_t i = 0; i < gammaData.n_elem; ++i)
+    gammaData[i] = dist(math::randGen);
+  GammaDistribution gamma, mergedGamma;
+  GammaDistribution::SufficientStatistics gammaStats =
+      GammaDistribution::Statistics(gammaData.cols(0, n / 2 - 1),
+      &firstProbabilities);
+  gammaStats.Merge(GammaDistribution::Statistics(gammaData.cols(n / 2, n - 1),
+      &secondProbabilities));
+  mergedGamma.Train(gammaStats);
+  gamma.Train(gammaData, probabilities);
+  for (size_t d = 0; d < 2; ++d)
+  {
+    BOOST_REQUIRE_CLOSE(mergedGamma.Alpha(d), gamma.Alpha(d), 1e-5);
+    BOOST_REQUIRE_CLOSE(mergedGamma.Beta(d), gamma.Beta(d), 1e-5);
+  }
+}
+
+/**
+ * Make sure that weighted training of a RegressionDistribution fits the same
+ * regression and error as fitting them on copies of the predictors.
+ */
+BOOST_AUTO_TEST_CASE(RegressionDistributionWeightedTrainTest)
+{
+  arma::mat predictors = arma::randu<arma::mat>(3, 2000);
+  arma::rowvec responses = 3.0 * predictors.row(1) - predictors.row(2) + 1.0 +
+      0.1 * arma::randn<arma::rowvec>(2000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(2000);
+  const arma::mat observations = arma::join_cols(responses, predictors);
+
+  RegressionDistribution rd;
+  rd.Train(observations, weights);
+
+  regression::LinearRegression lr(predictors, responses, weights, 0.0, true);
+  arma::rowvec fitted;
+  lr.Predict(predictors, fitted);
+  GaussianDistribution err;
+  err.Train(responses - fitted, weights.t());
+
+  BOOST_REQUIRE_EQUAL(rd.Rf().Parameters().n_elem, 4);
+  for (size_t i = 0; i < 4; ++i)
+    BOOST_REQUIRE_CLOSE(rd.Rf().Parameters()[i], lr.Parameters()[i], 1e-5);
+  BOOST_REQUIRE_CLOSE(rd.Err().Mean()[0] + 1.0, err.Mean()[0] + 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(rd.Err().Covariance()(0, 0), err.Covariance()(0, 0),
+      1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -167,4 +167,32 @@ BOOST_AUTO_TEST_CASE(SparseTest)
   BOOST_REQUIRE_EQUAL(distances.n_rows, 3);
 }
 
+/**
+ * Make sure the results are the same with one thread and with several.
+ */
+BOOST_AUTO_TEST_CASE(DrusillaSelectThreadsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 800);
+  arma::mat querySet = arma::randu<arma::mat>(5, 300);
+
+  const size_t threads = Threads::Count();
+  Threads::SetCount(1);
+  DrusillaSelect<> sequentialDs(dataset, 5, 10);
+  arma::Mat<size_t> sequentialNeighbors;
+  arma::mat sequentialDistances;
+  sequentialDs.Search(querySet, 3, sequentialNeighbors, sequentialDistances);
+
+  Threads::SetCount(4);
+  DrusillaSelect<> parallelDs(dataset, 5, 10);
+  arma::Mat<size_t> parallelNeighbors;
+  arma::mat parallelDistances;
+  parallelDs.Search(querySet, 3, parallelNeighbors, parallelDistances);
+  Threads::SetCount(threads);
+
+  CheckMatrices(sequentialDs.CandidateIndices(),
+      parallelDs.CandidateIndices());
+  CheckMatrices(sequentialNeighbors, parallelNeighbors);
+  CheckMatrices(sequentialDistances, parallelDistances);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -278,4 +278,40 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the MST computed with all threads is the same as the one
+ * computed with a single thread, both for the parallel dual-tree traversal and
+ * the naive computation.
+ */
+BOOST_AUTO_TEST_CASE(ParallelVsSerialTest)
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  for (size_t naive = 0; naive < 2; ++naive)
+  {
+    DualTreeBoruvka<> parallelDTB(inputData, naive == 1);
+    arma::mat parallelResults;
+    parallelDTB.ComputeMST(parallelResults);
+
+    const size_t prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    DualTreeBoruvka<> serialDTB(inputData, naive == 1);
+    arma::mat serialResults;
+    serialDTB.ComputeMST(serialResults);
+    omp_set_num_threads(prevNumThreads);
+
+    BOOST_REQUIRE_EQUAL(parallelResults.n_cols, serialResults.n_cols);
+    for (size_t i = 0; i < serialResults.n_cols; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(parallelResults(0, i), serialResults(0, i));
+      BOOST_REQUIRE_EQUAL(parallelResults(1, i), serialResults(1, i));
+      BOOST_REQUIRE_CLOSE(parallelResults(2, i), serialResults(2, i), 1e-5);
+    }
+  }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1082,4 +1082,55 @@ BOOST_AUTO_TEST_CASE(CopyAssignmentTest)
   }
 }
 
+/**
+ * Make sure that naive, single-tree and dual-tree search with several threads
+ * (which use blocked kernel evaluations, parallel query batches and one query
+ * tree per thread, respectively) give the same results as a serial naive
+ * search, both with and without a query set.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSearchTest)
+{
+  arma::mat referenceData;
+  referenceData.randn(5, 3000);
+  arma::mat queryData;
+  queryData.randn(5, 2500);
+  PolynomialKernel pk(2.0, 1.0);
+
+  const size_t oldThreads = Threads::Count();
+
+  // Serial naive results.
+  Threads::SetCount(1);
+  FastMKS<PolynomialKernel> serial(referenceData, pk, false, true);
+  arma::Mat<size_t> serialIndices, serialMonoIndices;
+  arma::mat serialKernels, serialMonoKernels;
+  serial.Search(queryData, 5, serialIndices, serialKernels);
+  serial.Search(5, serialMonoIndices, serialMonoKernels);
+
+  Threads::SetCount(4);
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    FastMKS<PolynomialKernel> f(referenceData, pk, mode == 1, mode == 0);
+
+    arma::Mat<size_t> indices, monoIndices;
+    arma::mat kernels, monoKernels;
+    f.Search(queryData, 5, indices, kernels);
+    f.Search(5, monoIndices, monoKernels);
+
+    BOOST_REQUIRE_EQUAL(indices.n_cols, queryData.n_cols);
+    BOOST_REQUIRE_EQUAL(monoIndices.n_cols, referenceData.n_cols);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(indices[i], serialIndices[i]);
+      BOOST_REQUIRE_CLOSE(kernels[i], serialKernels[i], 1e-5);
+    }
+    for (size_t i = 0; i < monoIndices.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(monoIndices[i], serialMonoIndices[i]);
+      BOOST_REQUIRE_CLOSE(monoKernels[i], serialMonoKernels[i], 1e-5);
+    }
+  }
+
+  Threads::SetCount(oldThreads);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,11 +12,13 @@
  */
 #include <mlpack/core.hpp>
 
+#include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
 #include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
 #include <mlpack/core/optimizers/sgd/update_policies/vanilla_update.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -503,6 +505,38 @@ BOOST_AUTO_TEST_CASE(FFNMiscTest)
   movedModel = std::move(copiedModel);
 }
 
+/**
+ * Test that the layers of a copied FFN use the parameters of the copy, so that
+ * writing to Parameters() of the copy changes its output, but not the output
+ * of the source network.
+ */
+BOOST_AUTO_TEST_CASE(FFNCopyParametersTest)
+{
+  arma::mat input = arma::randu<arma::mat>(2, 10);
+
+  FFN<MeanSquaredError<>> model;
+  model.Add<Linear<>>(2, 3);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(3, 1);
+
+  arma::mat output;
+  model.Predict(input, output);
+
+  FFN<MeanSquaredError<>> copiedModel(model);
+  arma::mat copiedOutput;
+  copiedModel.Predict(input, copiedOutput);
+  CheckMatrices(output, copiedOutput);
+
+  // With all weights and biases set to zero, the output is zero.
+  copiedModel.Parameters().zeros();
+  copiedModel.Predict(input, copiedOutput);
+  BOOST_REQUIRE_SMALL(arma::accu(arma::abs(copiedOutput)), 1e-10);
+
+  arma::mat sourceOutput;
+  model.Predict(input, sourceOutput);
+  CheckMatrices(output, sourceOutput);
+}
+
 /**
  * Test that serialization works ok.
  */
@@ -667,4 +701,690 @@ BOOST_AUTO_TEST_CASE(PartialForwardTest)
   CheckMatrices(output, arma::ones(10, 1) * 20);
 }
 
+/**
+ * Make sure that the batched Predict() returns the same results independent of
+ * the batch size, also when the model is reused for multiple calls.
+ */
+BOOST_AUTO_TEST_CASE(PredictBatchSizeTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >(0.3);
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat data = arma::randu(10, 25);
+
+  // Reference predictions, computed point by point.
+  arma::mat reference;
+  model.Predict(data, reference, 1);
+  BOOST_REQUIRE_EQUAL(reference.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(reference.n_cols, 25);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  CheckMatrices(reference, predictions);
+
+  // Use a batch size that does not divide the number of points.
+  model.Predict(data, predictions, 7);
+  CheckMatrices(reference, predictions);
+
+  // A batch size larger than the number of points.
+  model.Predict(data, predictions, 100);
+  CheckMatrices(reference, predictions);
+
+  // Single point calls reuse the same buffers.
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    model.Predict(data.col(i), predictions);
+    CheckMatrices(reference.col(i), predictions);
+  }
+}
+
+/**
+ * Make sure that a frozen network predicts the same results as before, with
+ * batches of any size computed into the same buffers, and that it can still
+ * be trained.
+ */
+BOOST_AUTO_TEST_CASE(FreezePredictTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >(0.3);
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat data = arma::randu(10, 25);
+  arma::mat reference;
+  model.Predict(data, reference);
+
+  model.Freeze(7);
+  BOOST_REQUIRE_EQUAL(model.FrozenBatchSize(), 7);
+
+  // The first call allocates the buffers; the following ones, with batches of
+  // other sizes, reuse them.
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  CheckMatrices(reference, predictions);
+  model.Predict(data, predictions);
+  CheckMatrices(reference, predictions);
+  model.Predict(data.cols(0, 2), predictions);
+  CheckMatrices(reference.cols(0, 2), predictions);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    model.Predict(data.col(i), predictions);
+    CheckMatrices(reference.col(i), predictions);
+  }
+
+  // Training doesn't use the buffers, and the frozen network predicts with the
+  // new parameters.
+  arma::mat labels = arma::ones(1, 25);
+  model.Train(data, labels);
+  model.Predict(data, reference, 1);
+  model.Predict(data, predictions);
+  CheckMatrices(reference, predictions);
+
+  model.Unfreeze();
+  BOOST_REQUIRE_EQUAL(model.FrozenBatchSize(), 0);
+  model.Predict(data, predictions);
+  CheckMatrices(reference, predictions);
+}
+
+/**
+ * Make sure that splitting a batch over several replicas gives the same
+ * objective and gradient as the serial evaluation.
+ */
+BOOST_AUTO_TEST_CASE(ReplicaEvaluateWithGradientTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  model.Predictors() = arma::randu(10, 30);
+  model.Responses() = arma::floor(arma::randu(1, 30) * 3) + 1;
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 30);
+
+  model.NumReplicas() = 4;
+  BOOST_REQUIRE_EQUAL(model.NumReplicas(), 4);
+
+  // Use a batch size that does not divide the number of replicas, and call
+  // twice to make sure the replicas are reused correctly.
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    arma::mat replicaGradient;
+    const double replicaObjective = model.EvaluateWithGradient(
+        model.Parameters(), 0, replicaGradient, 30);
+
+    BOOST_REQUIRE_CLOSE(objective, replicaObjective, 1e-5);
+    CheckMatrices(gradient, replicaGradient, 1e-5);
+  }
+
+  // A batch smaller than the number of replicas falls back to the serial case.
+  arma::mat smallGradient, smallReplicaGradient;
+  model.NumReplicas() = 1;
+  const double smallObjective = model.EvaluateWithGradient(model.Parameters(),
+      5, smallGradient, 2);
+  model.NumReplicas() = 4;
+  const double smallReplicaObjective = model.EvaluateWithGradient(
+      model.Parameters(), 5, smallReplicaGradient, 2);
+
+  BOOST_REQUIRE_CLOSE(smallObjective, smallReplicaObjective, 1e-5);
+  CheckMatrices(smallGradient, smallReplicaGradient, 1e-5);
+}
+
+/**
+ * Make sure that a StaticFFN gives the same results as the equivalent FFN.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<> > staticModel(std::make_tuple(
+      Linear<>(10, 8), SigmoidLayer<>(), Linear<>(8, 3), LogSoftMax<>()));
+  staticModel.ResetParameters();
+  BOOST_REQUIRE_EQUAL(staticModel.Parameters().n_elem,
+      model.Parameters().n_elem);
+  staticModel.Parameters() = model.Parameters();
+
+  arma::mat data = arma::randu(10, 20);
+  arma::mat labels = arma::floor(arma::randu(1, 20) * 3) + 1;
+
+  arma::mat predictions, staticPredictions;
+  model.Predict(data, predictions);
+  staticModel.Predict(data, staticPredictions, 7);
+  CheckMatrices(predictions, staticPredictions);
+
+  BOOST_REQUIRE_CLOSE(model.Evaluate(data, labels),
+      staticModel.Evaluate(data, labels), 1e-5);
+
+  model.Predictors() = data;
+  model.Responses() = labels;
+  staticModel.Predictors() = data;
+  staticModel.Responses() = labels;
+
+  arma::mat gradient, staticGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 20);
+  const double staticObjective = staticModel.EvaluateWithGradient(
+      staticModel.Parameters(), 0, staticGradient, 20);
+
+  BOOST_REQUIRE_CLOSE(objective, staticObjective, 1e-5);
+  CheckMatrices(gradient, staticGradient, 1e-5);
+
+  // A copy has to use its own parameters.
+  StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<> > copy(staticModel);
+  copy.Parameters().zeros();
+  staticModel.Predict(data, staticPredictions);
+  CheckMatrices(predictions, staticPredictions);
+
+  // Train the network; the objective should decrease.
+  const double initialObjective = staticModel.Evaluate(data, labels);
+  RMSProp opt(0.01, 1, 0.88, 1e-8, 20 * data.n_cols, -1);
+  staticModel.Train(data, labels, opt);
+  BOOST_REQUIRE_LT(staticModel.Evaluate(data, labels), initialObjective);
+}
+
+/**
+ * Make sure that folding BatchNorm layers and fusing activation functions into
+ * the preceding Linear layers does not change the predictions.
+ */
+BOOST_AUTO_TEST_CASE(FuseLayersTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<BatchNorm<> >(8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 6);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(6, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  // Use some non-trivial scale and shift parameters for the BatchNorm layer.
+  model.Parameters().rows(88, 103).randu();
+
+  // Collect the BatchNorm statistics in training mode.
+  model.Predictors() = arma::randu(10, 50);
+  model.Responses() = arma::floor(arma::randu(1, 50) * 3) + 1;
+  arma::mat gradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 50);
+
+  arma::mat data = arma::randu(10, 20);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  const size_t parameters = model.Parameters().n_elem;
+  model.FuseLayers();
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, parameters - 16);
+
+  arma::mat fusedPredictions;
+  model.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions, 1e-5);
+
+  // The fused network can still be trained.
+  arma::mat fusedGradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, fusedGradient, 50);
+  BOOST_REQUIRE_EQUAL(fusedGradient.n_elem, parameters - 16);
+}
+
+/**
+ * Make sure a network loaded from the compact binary format gives the same
+ * predictions as the network that was saved, and that invalid files are
+ * rejected.
+ */
+BOOST_AUTO_TEST_CASE(CompactFormatTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<BatchNorm<> >(8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  model.Predictors() = arma::randu(10, 50);
+  model.Responses() = arma::floor(arma::randu(1, 50) * 3) + 1;
+  arma::mat gradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 50);
+
+  arma::mat data = arma::randu(10, 20);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  BOOST_REQUIRE(model.SaveCompact("ffn_compact_test.bin"));
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> loadedModel;
+  loadedModel.Add<Linear<> >(4, 4);
+  BOOST_REQUIRE(loadedModel.LoadCompact("ffn_compact_test.bin"));
+
+  CheckMatrices(model.Parameters(), loadedModel.Parameters());
+
+  arma::mat loadedPredictions;
+  loadedModel.Predict(data, loadedPredictions);
+  CheckMatrices(predictions, loadedPredictions);
+
+  // The loaded model can still be copied and trained.
+  FFN<NegativeLogLikelihood<>, RandomInitialization> copiedModel(loadedModel);
+  copiedModel.Predictors() = model.Predictors();
+  copiedModel.Responses() = model.Responses();
+  arma::mat copiedGradient;
+  copiedModel.EvaluateWithGradient(copiedModel.Parameters(), 0, copiedGradient,
+      50);
+  BOOST_REQUIRE_EQUAL(copiedGradient.n_elem, model.Parameters().n_elem);
+
+  remove("ffn_compact_test.bin");
+
+  // Neither a missing file nor a file in another format is accepted.
+  BOOST_REQUIRE(!loadedModel.LoadCompact("ffn_compact_test.bin"));
+
+  std::ofstream invalid("ffn_compact_test.bin");
+  invalid << "This is not a model, but it is long enough to have a header.";
+  invalid.close();
+  BOOST_REQUIRE(!loadedModel.LoadCompact("ffn_compact_test.bin"));
+  remove("ffn_compact_test.bin");
+}
+
+/**
+ * Make sure that the sparse gradient of a network with a Lookup layer matches
+ * the dense gradient, and that it only stores the looked-up columns of the
+ * embedding table.
+ */
+BOOST_AUTO_TEST_CASE(SparseLookupGradientTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Lookup<> >(50, 6);
+  model.Add<Linear<> >(6, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  model.Predictors() = arma::floor(arma::randu(1, 40) * 50) + 1;
+  model.Responses() = arma::floor(arma::randu(1, 40) * 3) + 1;
+
+  // Look up the same word twice in the first batch.
+  model.Predictors()(0, 1) = model.Predictors()(0, 0);
+
+  std::vector<arma::mat> gradients(4);
+  std::vector<double> objectives(4);
+  for (size_t b = 0; b < 4; ++b)
+  {
+    objectives[b] = model.EvaluateWithGradient(model.Parameters(), 10 * b,
+        gradients[b], 10);
+  }
+
+  // Consecutive sparse calls only clear the columns of the previous batch.
+  for (size_t b = 0; b < 4; ++b)
+  {
+    arma::sp_mat sparseGradient;
+    const double objective = model.EvaluateWithGradient(model.Parameters(),
+        10 * b, sparseGradient, 10);
+
+    BOOST_REQUIRE_CLOSE(objective, objectives[b], 1e-5);
+    CheckMatrices(gradients[b], arma::mat(sparseGradient), 1e-5);
+
+    // At most 10 columns of the embedding table, and the Linear layer.
+    BOOST_REQUIRE_LE(sparseGradient.n_nonzero, 10 * 6 + 6 * 3 + 3);
+  }
+}
+
+/**
+ * Make sure that a network with int8 quantized Linear, LinearNoBias and
+ * Convolution layers gives nearly the same predictions as the original
+ * network, and that it can be serialized.
+ */
+BOOST_AUTO_TEST_CASE(QuantizeTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Convolution<> >(1, 4, 3, 3, 1, 1, 1, 1, 6, 6);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(144, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<LinearNoBias<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+  model.Parameters() *= 0.2;
+
+  arma::mat data = arma::randu(36, 40);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  model.Quantize(data.cols(0, 19));
+
+  // None of the remaining layers has parameters.
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, 0);
+
+  arma::mat quantizedPredictions;
+  model.Predict(data, quantizedPredictions);
+  BOOST_REQUIRE_EQUAL(quantizedPredictions.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(quantizedPredictions.n_cols, 40);
+  BOOST_REQUIRE_LT(arma::abs(predictions - quantizedPredictions).max(), 0.05);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> xmlModel, textModel,
+      binaryModel;
+  xmlModel.Add<Linear<> >(10, 10); // Layer that will get removed.
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(quantizedPredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that gradient checkpointing gives the same objective and gradient
+ * as keeping the outputs of all layers, also with layers that can't be
+ * recomputed and with several replicas.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointIntervalTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 8);
+  model.Add<ReLULayer<> >();
+  model.Add<Dropout<> >(0.3);
+  model.Add<Linear<> >(8, 6);
+  model.Add<TanHLayer<> >();
+  model.Add<Linear<> >(6, 6);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(6, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  model.Predictors() = arma::randu(10, 50);
+  model.Responses() = arma::floor(arma::randu(1, 50) * 3) + 1;
+
+  arma::mat gradient;
+  math::RandomSeed(7);
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 50);
+
+  for (size_t interval = 1; interval < 5; ++interval)
+  {
+    for (size_t replicas = 1; replicas < 3; ++replicas)
+    {
+      model.CheckpointInterval() = interval;
+      model.NumReplicas() = replicas;
+
+      arma::mat checkpointGradient;
+      math::RandomSeed(7);
+      const double checkpointObjective = model.EvaluateWithGradient(
+          model.Parameters(), 0, checkpointGradient, 50);
+
+      // The replicas draw their own dropout masks.
+      if (replicas == 1)
+      {
+        BOOST_REQUIRE_CLOSE(objective, checkpointObjective, 1e-5);
+        CheckMatrices(gradient, checkpointGradient, 1e-5);
+      }
+      else
+      {
+        BOOST_REQUIRE_EQUAL(checkpointGradient.n_elem, gradient.n_elem);
+      }
+    }
+  }
+
+  // Predictions don't depend on the checkpoints.
+  arma::mat predictions, checkpointPredictions;
+  model.CheckpointInterval() = 0;
+  model.Predict(model.Predictors(), predictions);
+  model.CheckpointInterval() = 3;
+  model.Predict(model.Predictors(), checkpointPredictions);
+  CheckMatrices(predictions, checkpointPredictions);
+}
+
+/**
+ * Make sure that the prefetched batches are the shuffled (and augmented)
+ * columns of the data, and that the data itself is not reordered.
+ */
+BOOST_AUTO_TEST_CASE(PrefetchBatchTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  model.Predictors() = arma::randu(10, 50);
+  model.Responses() = arma::floor(arma::randu(1, 50) * 3) + 1;
+  const arma::mat predictors = model.Predictors();
+  const arma::mat responses = model.Responses();
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> reference(model);
+
+  model.Prefetch() = true;
+  model.Pipeline().Augmentation() = [](arma::mat& x, arma::mat& /* y */)
+  {
+    x *= 2.0;
+  };
+
+  for (size_t epoch = 0; epoch < 3; ++epoch)
+  {
+    model.Shuffle();
+    CheckMatrices(model.Predictors(), predictors);
+
+    const arma::uvec order = model.Pipeline().Order();
+    BOOST_REQUIRE_EQUAL(order.n_elem, 50);
+    BOOST_REQUIRE(arma::all(arma::sort(order) ==
+        arma::regspace<arma::uvec>(0, 49)));
+
+    for (size_t begin = 0; begin < 50; begin += 10)
+    {
+      arma::mat gradient;
+      const double objective = model.EvaluateWithGradient(model.Parameters(),
+          begin, gradient, 10);
+
+      const arma::uvec batch = order.subvec(begin, begin + 9);
+      reference.Predictors() = 2.0 * predictors.cols(batch);
+      reference.Responses() = responses.cols(batch);
+
+      arma::mat referenceGradient;
+      const double referenceObjective = reference.EvaluateWithGradient(
+          reference.Parameters(), 0, referenceGradient, 10);
+
+      BOOST_REQUIRE_CLOSE(objective, referenceObjective, 1e-5);
+      CheckMatrices(gradient, referenceGradient, 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that magnitude pruning zeros the given fraction of the weights of
+ * every Linear, LinearNoBias and Convolution layer, and that the sparse layers
+ * give the same predictions as the pruned network.
+ */
+BOOST_AUTO_TEST_CASE(PruneSparsifyTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Convolution<> >(1, 4, 3, 3, 1, 1, 1, 1, 6, 6);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(144, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<LinearNoBias<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  model.Prune(0.9);
+
+  // The layers have 36 + 4, 1152 + 8 and 24 parameters.
+  const arma::mat& parameters = model.Parameters();
+  BOOST_REQUIRE_EQUAL(arma::accu(parameters.rows(0, 35) == 0), 32);
+  BOOST_REQUIRE_EQUAL(arma::accu(parameters.rows(40, 1191) == 0), 1036);
+  BOOST_REQUIRE_EQUAL(arma::accu(parameters.rows(1200, 1223) == 0), 21);
+  BOOST_REQUIRE_EQUAL(arma::accu(parameters.rows(36, 39) == 0), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(model.PruneMask() == 0), 32 + 1036 + 21);
+
+  arma::mat data = arma::randu(36, 40);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  model.Sparsify();
+
+  // None of the remaining layers has parameters.
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, 0);
+
+  arma::mat sparsePredictions;
+  model.Predict(data, sparsePredictions);
+  CheckMatrices(predictions, sparsePredictions);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> xmlModel, textModel,
+      binaryModel;
+  xmlModel.Add<Linear<> >(10, 10); // Layer that will get removed.
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(sparsePredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that the weights reach the given sparsity when they are gradually
+ * pruned during training, and that the pruned weights stay zero.
+ */
+BOOST_AUTO_TEST_CASE(GradualPruneTest)
+{
+  arma::mat data = arma::randu(10, 200);
+  arma::mat labels = arma::floor(arma::randu(1, 200) * 3) + 1;
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 16);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(16, 3);
+  model.Add<LogSoftMax<> >();
+  model.PruneSparsity() = 0.8;
+  model.PruneSteps() = 100;
+
+  RMSProp opt(0.01, 10, 0.88, 1e-8, 40 * data.n_cols, -1);
+  model.Train(data, labels, opt);
+
+  // The layers have 160 + 16 and 48 + 3 parameters.
+  const arma::mat& parameters = model.Parameters();
+  BOOST_REQUIRE_GE(arma::accu(parameters.rows(0, 159) == 0), 128);
+  BOOST_REQUIRE_GE(arma::accu(parameters.rows(176, 223) == 0), 38);
+  BOOST_REQUIRE_EQUAL(arma::accu(model.PruneMask() == 0), 128 + 38);
+  BOOST_REQUIRE_EQUAL(arma::accu(parameters.rows(160, 175) == 0), 0);
+}
+
+/**
+ * A callback that counts the steps of the optimizer.
+ */
+class StepCounter
+{
+ public:
+  StepCounter(size_t& steps) : steps(steps) { }
+
+  template<typename OptimizerType, typename FunctionType>
+  bool StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 arma::mat& /* coordinates */)
+  {
+    ++steps;
+    return false;
+  }
+
+ private:
+  size_t& steps;
+};
+
+/**
+ * Make sure that the gradual pruning schedule is advanced once per step of
+ * L-BFGS, and not by the evaluations of its line search, and that the
+ * callbacks given to Train() are passed to the optimizer.
+ */
+BOOST_AUTO_TEST_CASE(GradualPruneLBFGSTest)
+{
+  arma::mat data = arma::randu(10, 200);
+  arma::mat labels = arma::floor(arma::randu(1, 200) * 3) + 1;
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 16);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(16, 3);
+  model.Add<LogSoftMax<> >();
+  model.PruneSparsity() = 0.8;
+  model.PruneSteps() = 10;
+
+  size_t steps = 0;
+  L_BFGS lbfgs(10, 5);
+  model.Train(data, labels, lbfgs, StepCounter(steps));
+
+  BOOST_REQUIRE_GT(steps, 0);
+  BOOST_REQUIRE_LE(steps, 5);
+
+  // With at most 5 of the 10 steps, the mask is recomputed after every step.
+  const double sparsity = 0.8 * (1.0 - std::pow(1.0 - steps / 10.0, 3.0));
+  const arma::mat& mask = model.PruneMask();
+  const double pruned1 = arma::accu(mask.rows(0, 159) == 0);
+  const double pruned2 = arma::accu(mask.rows(176, 223) == 0);
+  BOOST_REQUIRE_LE(std::abs(pruned1 - sparsity * 160), 1.0);
+  BOOST_REQUIRE_LE(std::abs(pruned2 - sparsity * 48), 1.0);
+
+  // The pruned weights are zero.
+  BOOST_REQUIRE_EQUAL(arma::accu(model.Parameters() % (1 - mask) != 0), 0);
+}
+
+/**
+ * Make sure that units whose outgoing weights are zero are removed by
+ * structured pruning, which shrinks the layers without changing the
+ * predictions.
+ */
+BOOST_AUTO_TEST_CASE(PruneNeuronsTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Convolution<> >(1, 4, 3, 3, 1, 1, 1, 1, 6, 6);
+  model.Add<ReLULayer<> >();
+  model.Add<Convolution<> >(4, 2, 3, 3, 1, 1, 1, 1, 6, 6);
+  model.Add<Linear<> >(72, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  // The layers have 36 + 4, 72 + 2, 576 + 8 and 24 + 3 parameters.  Remove
+  // the outgoing weights of the third map of the first layer and of the
+  // second and sixth unit of the third layer.
+  arma::mat& parameters = model.Parameters();
+  for (size_t c = 0; c < 2; ++c)
+    parameters.rows(40 + 18 + c * 36, 40 + 26 + c * 36).zeros();
+  parameters.rows(698 + 3, 698 + 5).zeros();
+  parameters.rows(698 + 15, 698 + 17).zeros();
+
+  arma::mat data = arma::randu(36, 20);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  model.PruneNeurons(0.25);
+
+  // The first layer has lost a map, the third layer two units.
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, 30 + 56 + 438 + 21);
+
+  arma::mat prunedPredictions;
+  model.Predict(data, prunedPredictions);
+  CheckMatrices(predictions, prunedPredictions);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
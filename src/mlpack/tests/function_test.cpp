@@ -12,7 +12,9 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/function.hpp>
+#include <mlpack/core/optimizers/function/parallel_decomposable_function.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression_function.hpp>
+#include <mlpack/methods/softmax_regression/softmax_regression_function.hpp>
 #include <mlpack/core/optimizers/sdp/sdp.hpp>
 #include <mlpack/core/optimizers/sdp/lrsdp.hpp>
 #include <mlpack/core/optimizers/aug_lagrangian/aug_lagrangian.hpp>
@@ -20,6 +22,10 @@
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::optimization;
 using namespace mlpack::optimization::traits; // For some SFINAE checks.
@@ -678,4 +684,64 @@ BOOST_AUTO_TEST_CASE(ResolvableFunctionTypeCheckTest)
       "CheckPartialGradient static check failed.");
 }
 
+/**
+ * Make sure that ParallelDecomposableFunction gives the same batch objectives
+ * and gradients as the function it wraps, both for functions that sum over the
+ * batch and for functions that average over it.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDecomposableFunctionTest)
+{
+  #ifdef HAS_OPENMP
+    const int oldThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+  #endif
+
+  arma::mat data(10, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    labels[i] = (arma::accu(data.col(i)) > 5.0) ? 1 : 0;
+
+  LogisticRegressionFunction<> lrf(data, labels, 0.5);
+  ParallelDecomposableFunction<LogisticRegressionFunction<>> parallelLrf(lrf,
+      16);
+  const arma::mat lrfPoint(1, 11, arma::fill::randn);
+
+  SoftmaxRegressionFunction<> srf(data, labels, 2, 0.1);
+  ParallelDecomposableFunction<SoftmaxRegressionFunction<>> parallelSrf(srf, 16,
+      true);
+  const arma::mat srfPoint(2, 10, arma::fill::randn);
+
+  // Try batches that split evenly and unevenly between the threads, and one
+  // too small to split.
+  const size_t begins[] = { 0, 100, 977 };
+  const size_t sizes[] = { 800, 333, 20 };
+  for (size_t t = 0; t < 3; ++t)
+  {
+    arma::mat gradient, parallelGradient;
+    double objective = lrf.EvaluateWithGradient(lrfPoint, begins[t], gradient,
+        sizes[t]);
+    double parallelObjective = parallelLrf.EvaluateWithGradient(lrfPoint,
+        begins[t], parallelGradient, sizes[t]);
+    BOOST_REQUIRE_CLOSE(parallelObjective, objective, 1e-5);
+    BOOST_REQUIRE_CLOSE(parallelLrf.Evaluate(lrfPoint, begins[t], sizes[t]),
+        objective, 1e-5);
+    BOOST_REQUIRE_EQUAL(parallelGradient.n_elem, gradient.n_elem);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(parallelGradient[i], gradient[i], 1e-5);
+
+    objective = srf.Evaluate(srfPoint, begins[t], sizes[t]);
+    srf.Gradient(srfPoint, begins[t], gradient, sizes[t]);
+    parallelObjective = parallelSrf.EvaluateWithGradient(srfPoint, begins[t],
+        parallelGradient, sizes[t]);
+    BOOST_REQUIRE_CLOSE(parallelObjective, objective, 1e-5);
+    BOOST_REQUIRE_EQUAL(parallelGradient.n_elem, gradient.n_elem);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(parallelGradient[i], gradient[i], 1e-5);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(oldThreads);
+  #endif
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -245,4 +245,63 @@ BOOST_AUTO_TEST_CASE(GANMNISTTest)
   Log::Info << "Output generated!" << std::endl;
 }
 
+/*
+ * Compare the gradient of the Generator with the finite differences of the
+ * Discriminator error on the generated batch, labeled as real.
+ */
+BOOST_AUTO_TEST_CASE(GANGeneratorGradientTest)
+{
+  const size_t noiseDim = 2, batchSize = 8;
+  arma::mat trainData = arma::randn(3, 40);
+
+  FFN<CrossEntropyError<> > discriminator;
+  discriminator.Add<Linear<> >(3, 4);
+  discriminator.Add<SigmoidLayer<> >();
+  discriminator.Add<Linear<> >(4, 1);
+  discriminator.Add<SigmoidLayer<> >();
+
+  FFN<CrossEntropyError<> > generator;
+  generator.Add<Linear<> >(noiseDim, 4);
+  generator.Add<SigmoidLayer<> >();
+  generator.Add<Linear<> >(4, 3);
+
+  GaussianInitialization gaussian(0, 0.5);
+  std::function<double()> noiseFunction = [](){ return math::RandNormal(); };
+  GAN<FFN<CrossEntropyError<> >, GaussianInitialization,
+      std::function<double()> > gan(trainData, generator, discriminator,
+      gaussian, noiseFunction, noiseDim, batchSize, 1, 0, 1);
+  gan.Reset();
+
+  arma::mat gradient;
+  math::RandomSeed(5);
+  gan.EvaluateWithGradient(gan.Parameters(), 0, gradient, batchSize);
+
+  // The noise of the call above.
+  math::RandomSeed(5);
+  arma::mat noise(noiseDim, batchSize);
+  noise.imbue([&]() { return noiseFunction(); });
+
+  FFN<CrossEntropyError<> > generatorCopy(gan.Generator());
+  FFN<CrossEntropyError<> > discriminatorCopy(gan.Discriminator());
+  auto objective = [&]()
+  {
+    arma::mat generated;
+    generatorCopy.Predict(noise, generated);
+    return discriminatorCopy.Evaluate(generated, arma::ones(1, batchSize));
+  };
+
+  const double eps = 1e-6;
+  for (size_t j = 0; j < generatorCopy.Parameters().n_elem; ++j)
+  {
+    const double value = generatorCopy.Parameters()(j);
+    generatorCopy.Parameters()(j) = value + eps;
+    const double upper = objective();
+    generatorCopy.Parameters()(j) = value - eps;
+    const double lower = objective();
+    generatorCopy.Parameters()(j) = value;
+
+    BOOST_REQUIRE_SMALL((upper - lower) / (2 * eps) - gradient(j), 1e-4);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -13,6 +13,8 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/gmm/diagonal_gmm.hpp>
+#include <mlpack/methods/gmm/online_em_fit.hpp>
 
 #include <mlpack/methods/gmm/no_constraint.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
@@ -347,6 +349,49 @@ BOOST_AUTO_TEST_CASE(GMMTrainEMMultipleGaussiansWithProbability)
           - d3.Covariance()(row, col)), 0.7);
 }
 
+/**
+ * The E-step and M-step work on chunks of observations, so make sure that
+ * training with unit probabilities on a dataset spanning several (uneven)
+ * chunks gives the same model as training without probabilities.
+ */
+BOOST_AUTO_TEST_CASE(GMMTrainEMUnitProbabilityChunksTest)
+{
+  distribution::GaussianDistribution d1("0.0 1.0", "1.0 0.2; 0.2 1.0");
+  distribution::GaussianDistribution d2("5.0 -3.0", "2.0 -0.5; -0.5 1.0");
+
+  arma::mat observations(2, 2500);
+  for (size_t i = 0; i < 2500; ++i)
+    observations.col(i) = (i % 2 == 0) ? d1.Random() : d2.Random();
+
+  // Start both models from the same initial position.
+  GMM g1(2, 2);
+  g1.Component(0) = distribution::GaussianDistribution("1.0 0.0",
+      "1.0 0.0; 0.0 1.0");
+  g1.Component(1) = distribution::GaussianDistribution("4.0 -2.0",
+      "1.0 0.0; 0.0 1.0");
+  g1.Weights() = "0.5 0.5";
+  GMM g2(g1);
+
+  const double l1 = g1.Train(observations, 1, true);
+  const double l2 = g2.Train(observations, arma::ones<arma::vec>(2500), 1,
+      true);
+
+  BOOST_REQUIRE_CLOSE(l1, l2, 1e-5);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(g1.Weights()[i], g2.Weights()[i], 1e-5);
+    CheckMatrices(g1.Component(i).Mean(), g2.Component(i).Mean(), 1e-5);
+    CheckMatrices(g1.Component(i).Covariance(), g2.Component(i).Covariance(),
+        1e-5);
+  }
+
+  // The model should be close to the true distributions, too.
+  const size_t first = (g1.Component(0).Mean()[0] < 2.5) ? 0 : 1;
+  BOOST_REQUIRE_SMALL(g1.Component(first).Mean()[0], 0.2);
+  BOOST_REQUIRE_CLOSE(g1.Component(1 - first).Mean()[0], 5.0, 5.0);
+  BOOST_REQUIRE_CLOSE(g1.Weights()[0], 0.5, 5.0);
+}
+
 /**
  * Make sure generating observations randomly works.  We'll do this by
  * generating a bunch of random observations and then re-training on them, and
@@ -856,4 +901,216 @@ BOOST_AUTO_TEST_CASE(DiagonalGMMTrainTest)
   }
 }
 
+/**
+ * Make sure the DiagonalGMM, which only stores the diagonal of each
+ * covariance, can fit a mixture, both with the default fitter and with the
+ * generic EM implementation.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGMMClassTrainTest)
+{
+  distribution::DiagonalGaussianDistribution d1("0.0 1.0 0.0",
+      "1.0 0.8 1.0");
+  distribution::DiagonalGaussianDistribution d2("8.0 -4.0 5.0",
+      "3.0 1.2 1.3");
+
+  arma::mat points(3, 4000);
+  for (size_t i = 0; i < 4000; ++i)
+    points.col(i) = (math::Random() <= 0.3) ? d1.Random() : d2.Random();
+
+  DiagonalGMM g(2, 3);
+  g.Train(points, 3);
+
+  // The generic EM implementation with a constraint that doesn't go through
+  // Armadillo's gmm_diag.
+  DiagonalGMM g2(2, 3);
+  g2.Train<EMFit<kmeans::KMeans<>, PositiveDefiniteConstraint,
+      distribution::DiagonalGaussianDistribution>>(points, 3);
+
+  for (const DiagonalGMM* model : { &g, &g2 })
+  {
+    const arma::uvec sortedIndices = sort_index(model->Weights());
+    const distribution::DiagonalGaussianDistribution& c1 =
+        model->Component(sortedIndices[0]);
+    const distribution::DiagonalGaussianDistribution& c2 =
+        model->Component(sortedIndices[1]);
+
+    BOOST_REQUIRE_EQUAL(c1.Covariance().n_elem, 3);
+    BOOST_REQUIRE_SMALL(model->Weights()[sortedIndices[0]] - 0.3, 0.05);
+    for (size_t i = 0; i < 3; ++i)
+    {
+      BOOST_REQUIRE_SMALL(c1.Mean()[i] - d1.Mean()[i], 0.3);
+      BOOST_REQUIRE_SMALL(c2.Mean()[i] - d2.Mean()[i], 0.3);
+      BOOST_REQUIRE_SMALL(c1.Covariance()[i] - d1.Covariance()[i], 0.4);
+      BOOST_REQUIRE_SMALL(c2.Covariance()[i] - d2.Covariance()[i], 0.4);
+    }
+
+    // Points drawn near each mean should be classified to its component.
+    arma::Row<size_t> labels;
+    model->Classify(arma::join_rows(d1.Mean(), d2.Mean()), labels);
+    BOOST_REQUIRE_EQUAL(labels[0], sortedIndices[0]);
+    BOOST_REQUIRE_EQUAL(labels[1], sortedIndices[1]);
+  }
+}
+
+/**
+ * Make sure that the batch probabilities and classifications of a GMM match
+ * the ones computed one point at a time, over several blocks of points.
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchProbabilityTest)
+{
+  GMM gmm(3, 4);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    arma::mat factor = arma::randu<arma::mat>(4, 4);
+    gmm.Component(i) = distribution::GaussianDistribution(
+        3 * arma::randu<arma::vec>(4),
+        factor * factor.t() + 0.5 * arma::eye<arma::mat>(4, 4));
+  }
+  gmm.Weights() = "0.2 0.5 0.3";
+
+  // Some points are so far away that their probability underflows.
+  arma::mat observations = 4 * arma::randu<arma::mat>(4, 5000);
+  observations.col(17).fill(1e3);
+
+  arma::vec logProbabilities, probabilities;
+  gmm.LogProbability(observations, logProbabilities);
+  gmm.Probability(observations, probabilities);
+  arma::Row<size_t> labels;
+  gmm.Classify(observations, labels);
+
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, observations.n_cols);
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, observations.n_cols);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbabilities[i],
+        gmm.LogProbability(observations.col(i)), 1e-5);
+    if (probabilities[i] > 1e-100)
+    {
+      BOOST_REQUIRE_CLOSE(probabilities[i],
+          gmm.Probability(observations.col(i)), 1e-5);
+    }
+
+    size_t best = 0;
+    for (size_t j = 1; j < 3; ++j)
+    {
+      if (gmm.Probability(observations.col(i), j) >
+          gmm.Probability(observations.col(i), best))
+        best = j;
+    }
+    if (i != 17)
+      BOOST_REQUIRE_EQUAL(labels[i], best);
+  }
+
+  BOOST_REQUIRE(std::isfinite(logProbabilities[17]));
+}
+
+/**
+ * Make sure that the model chosen from several trials does not depend on how
+ * many trials run at once.
+ */
+BOOST_AUTO_TEST_CASE(GMMParallelTrialsTest)
+{
+  // Three clusters in two dimensions.
+  arma::mat data(2, 600);
+  data.randn();
+  data.cols(200, 399).each_col() += arma::vec("8.0 0.0");
+  data.cols(400, 599).each_col() += arma::vec("0.0 8.0");
+
+  GMM serialGmm(3, 2);
+  math::RandomSeed(17);
+  const double serialLikelihood = serialGmm.Train(data, 6, false, EMFit<>(),
+      1);
+
+  GMM parallelGmm(3, 2);
+  math::RandomSeed(17);
+  const double parallelLikelihood = parallelGmm.Train(data, 6, false,
+      EMFit<>(), 0);
+
+  GMM pairGmm(3, 2);
+  math::RandomSeed(17);
+  const double pairLikelihood = pairGmm.Train(data, 6, false, EMFit<>(), 2);
+
+  BOOST_REQUIRE_CLOSE(serialLikelihood, parallelLikelihood, 1e-5);
+  BOOST_REQUIRE_CLOSE(serialLikelihood, pairLikelihood, 1e-5);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    CheckMatrices(serialGmm.Component(i).Mean(),
+        parallelGmm.Component(i).Mean(), 1e-5);
+    CheckMatrices(serialGmm.Component(i).Mean(), pairGmm.Component(i).Mean(),
+        1e-5);
+    BOOST_REQUIRE_CLOSE(serialGmm.Weights()[i], parallelGmm.Weights()[i],
+        1e-5);
+  }
+}
+
+/**
+ * Make sure that the online EM fitter, given a stream of mini-batches, finds
+ * the components of a mixture, for full and diagonal covariances.
+ */
+BOOST_AUTO_TEST_CASE(OnlineEMFitStreamTest)
+{
+  distribution::GaussianDistribution d1("0.0 1.0 0.0",
+      "1.0 0.3 0.0; 0.3 1.0 0.0; 0.0 0.0 1.0");
+  distribution::GaussianDistribution d2("8.0 -4.0 5.0",
+      "2.0 0.0 0.5; 0.0 1.0 0.0; 0.5 0.0 1.5");
+
+  GMM gmm(2, 3);
+  DiagonalGMM diagonalGmm(2, 3);
+  OnlineEMFit<> fitter(250);
+  OnlineEMFit<kmeans::KMeans<>, PositiveDefiniteConstraint,
+      distribution::DiagonalGaussianDistribution> diagonalFitter(250);
+
+  // Twenty chunks of a stream; no chunk is kept.
+  for (size_t c = 0; c < 20; ++c)
+  {
+    arma::mat chunk(3, 1000);
+    for (size_t i = 0; i < chunk.n_cols; ++i)
+      chunk.col(i) = (math::Random() <= 0.3) ? d1.Random() : d2.Random();
+
+    gmm.Train<OnlineEMFit<>&>(chunk, 1, false, fitter);
+    diagonalGmm.Train<OnlineEMFit<kmeans::KMeans<>,
+        PositiveDefiniteConstraint,
+        distribution::DiagonalGaussianDistribution>&>(chunk, 1, false,
+        diagonalFitter);
+  }
+
+  BOOST_REQUIRE_EQUAL(fitter.Steps(), 80);
+  BOOST_REQUIRE_EQUAL(diagonalFitter.Steps(), 80);
+
+  const arma::uvec sorted = sort_index(gmm.Weights());
+  BOOST_REQUIRE_SMALL(gmm.Weights()[sorted[0]] - 0.3, 0.05);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_SMALL(gmm.Component(sorted[0]).Mean()[i] - d1.Mean()[i],
+        0.2);
+    BOOST_REQUIRE_SMALL(gmm.Component(sorted[1]).Mean()[i] - d2.Mean()[i],
+        0.2);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_SMALL(gmm.Component(sorted[0]).Covariance()(i, j) -
+          d1.Covariance()(i, j), 0.3);
+      BOOST_REQUIRE_SMALL(gmm.Component(sorted[1]).Covariance()(i, j) -
+          d2.Covariance()(i, j), 0.3);
+    }
+  }
+
+  const arma::uvec diagonalSorted = sort_index(diagonalGmm.Weights());
+  BOOST_REQUIRE_SMALL(diagonalGmm.Weights()[diagonalSorted[0]] - 0.3, 0.05);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_SMALL(diagonalGmm.Component(diagonalSorted[0]).Mean()[i] -
+        d1.Mean()[i], 0.2);
+    BOOST_REQUIRE_SMALL(diagonalGmm.Component(diagonalSorted[1]).Mean()[i] -
+        d2.Mean()[i], 0.2);
+    BOOST_REQUIRE_SMALL(
+        diagonalGmm.Component(diagonalSorted[1]).Covariance()[i] -
+        d2.Covariance()(i, i), 0.3);
+  }
+
+  // Invalid step sizes are rejected.
+  BOOST_REQUIRE_THROW(OnlineEMFit<>(100, 1.5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(OnlineEMFit<>(0), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,182 @@
+/**
+ * @file gradient_boosting_test.cpp
+ *
+ * Tests for the GradientBoosting class and related classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(GradientBoostingTest);
+
+/**
+ * Make sure that a single tree fit to the gradients of a step function finds
+ * the step and gives the regularized leaf values.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingTreeStepTest)
+{
+  arma::mat dataset(1, 100);
+  dataset.row(0) = arma::linspace<arma::rowvec>(0, 99, 100);
+  arma::vec gradients(100);
+  gradients.subvec(0, 49).fill(-1.0);
+  gradients.subvec(50, 99).fill(1.0);
+  arma::vec hessians(100, arma::fill::ones);
+
+  BinnedDataset binnedData(dataset);
+  GradientBoostingTree tree;
+  arma::vec predictions;
+  tree.Train(binnedData, gradients, hessians, predictions, 1, 1, 0.0, 1.0);
+
+  BOOST_REQUIRE_EQUAL(tree.NumNodes(), 3);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const double expected = (i < 50) ? 1.0 : -1.0;
+    BOOST_REQUIRE_CLOSE(predictions[i], expected, 1e-5);
+    BOOST_REQUIRE_CLOSE(tree.Predict(dataset.col(i)), expected, 1e-5);
+  }
+}
+
+/**
+ * Make sure that gradient boosting classifies the three-class vc2 dataset
+ * well, and that the probabilities of each point sum to one.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingMulticlassTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  GradientBoosting gb(dataset, labels, 3, 50, 0.1, 4, 5);
+  BOOST_REQUIRE_EQUAL(gb.NumRounds(), 50);
+  BOOST_REQUIRE_EQUAL(gb.NumTrees(), 150);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  gb.Classify(testDataset, predictions, probabilities);
+
+  const size_t correct = arma::accu(predictions == testLabels);
+  BOOST_REQUIRE_GE(correct, size_t(0.7 * testDataset.n_cols));
+
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 3);
+  for (size_t i = 0; i < probabilities.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+
+    // The single-point overload should agree.
+    size_t prediction;
+    arma::vec pointProbabilities;
+    gb.Classify(testDataset.col(i), prediction, pointProbabilities);
+    BOOST_REQUIRE_EQUAL(prediction, predictions[i]);
+    for (size_t c = 0; c < 3; ++c)
+    {
+      BOOST_REQUIRE_CLOSE(pointProbabilities[c] + 1.0,
+          probabilities(c, i) + 1.0, 1e-10);
+    }
+  }
+}
+
+/**
+ * Make sure that gradient boosting learns a two-class problem with one tree per
+ * round.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingBinaryTest)
+{
+  // The class is whether the point is inside a circle.
+  arma::mat dataset(2, 2000, arma::fill::randu);
+  arma::Row<size_t> labels(2000);
+  for (size_t i = 0; i < 2000; ++i)
+    labels[i] = (arma::norm(dataset.col(i) - 0.5) < 0.35) ? 1 : 0;
+
+  GradientBoosting gb(dataset.cols(0, 999), labels.subvec(0, 999), 2, 100);
+  BOOST_REQUIRE_EQUAL(gb.NumTrees(), 100);
+
+  arma::Row<size_t> predictions;
+  gb.Classify(dataset.cols(1000, 1999), predictions);
+
+  const size_t correct = arma::accu(predictions == labels.subvec(1000, 1999));
+  BOOST_REQUIRE_GE(correct, 900);
+}
+
+/**
+ * Make sure that training with a validation set stops early when the labels
+ * are noise, and keeps fewer rounds than the maximum.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingEarlyStoppingTest)
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(1000,
+      arma::distr_param(0, 1));
+  arma::mat validationDataset(3, 500, arma::fill::randu);
+  arma::Row<size_t> validationLabels = arma::randi<arma::Row<size_t>>(500,
+      arma::distr_param(0, 1));
+
+  GradientBoosting gb;
+  gb.Train(dataset, labels, 2, validationDataset, validationLabels, 5, 500,
+      0.3, 6, 1);
+
+  BOOST_REQUIRE_GT(gb.NumRounds(), 0);
+  BOOST_REQUIRE_LT(gb.NumRounds(), 500);
+}
+
+/**
+ * Make sure that an untrained model can't classify.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingUntrainedTest)
+{
+  GradientBoosting gb;
+  arma::mat dataset(3, 10, arma::fill::randu);
+  arma::Row<size_t> predictions;
+
+  BOOST_REQUIRE_THROW(gb.Classify(dataset, predictions),
+      std::invalid_argument);
+}
+
+// Make sure we can serialize a gradient boosting model.
+BOOST_AUTO_TEST_CASE(GradientBoostingSerializationTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  GradientBoosting gb(dataset, labels, 3, 20);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  gb.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  GradientBoosting xmlModel, textModel, binaryModel;
+  binaryModel.Train(dataset, labels, 3, 5);
+  SerializeObjectAll(gb, xmlModel, textModel, binaryModel);
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
+
+  xmlModel.Classify(dataset, xmlPredictions, xmlProbabilities);
+  textModel.Classify(dataset, textPredictions, textProbabilities);
+  binaryModel.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(beforePredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -106,6 +106,60 @@ BOOST_AUTO_TEST_CASE(BorodovskyHMMTestViterbi)
   BOOST_REQUIRE_EQUAL(states[8], 2);
 }
 
+/**
+ * Make sure batched Viterbi decoding gives the same results as decoding each
+ * sequence on its own, and that a wide beam doesn't change anything.
+ */
+BOOST_AUTO_TEST_CASE(BatchedViterbiTest)
+{
+  std::vector<GaussianDistribution> emission;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    emission.push_back(GaussianDistribution(arma::vec(2).fill(2.0 * i),
+        arma::eye<arma::mat>(2, 2)));
+  }
+
+  arma::mat transition = arma::randu<arma::mat>(5, 5);
+  for (size_t i = 0; i < 5; ++i)
+    transition.col(i) /= arma::accu(transition.col(i));
+  HMM<GaussianDistribution> hmm(arma::vec(5).fill(0.2), transition, emission);
+
+  // Sequences of different lengths, so the trellis buffers are reused for
+  // shorter sequences.
+  std::vector<arma::mat> dataSeqs(50);
+  for (size_t i = 0; i < dataSeqs.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    hmm.Generate(5 + (i * 7) % 40, dataSeqs[i], states);
+  }
+
+  std::vector<arma::Row<size_t>> stateSeqs, beamStateSeqs, narrowStateSeqs;
+  arma::vec logLikelihoods, beamLogLikelihoods, narrowLogLikelihoods;
+  hmm.Predict(dataSeqs, stateSeqs, logLikelihoods);
+  hmm.Predict(dataSeqs, beamStateSeqs, beamLogLikelihoods, 1e10);
+  hmm.Predict(dataSeqs, narrowStateSeqs, narrowLogLikelihoods, 1.0);
+
+  BOOST_REQUIRE_EQUAL(stateSeqs.size(), dataSeqs.size());
+  for (size_t i = 0; i < dataSeqs.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    const double logLikelihood = hmm.Predict(dataSeqs[i], states);
+
+    BOOST_REQUIRE_CLOSE(logLikelihoods[i], logLikelihood, 1e-5);
+    BOOST_REQUIRE_CLOSE(beamLogLikelihoods[i], logLikelihood, 1e-5);
+    BOOST_REQUIRE_EQUAL(stateSeqs[i].n_elem, states.n_elem);
+    BOOST_REQUIRE_EQUAL(narrowStateSeqs[i].n_elem, states.n_elem);
+    for (size_t t = 0; t < states.n_elem; ++t)
+    {
+      BOOST_REQUIRE_EQUAL(stateSeqs[i][t], states[t]);
+      BOOST_REQUIRE_EQUAL(beamStateSeqs[i][t], states[t]);
+    }
+
+    // A narrow beam can't find a better sequence than the exact search.
+    BOOST_REQUIRE_LE(narrowLogLikelihoods[i], logLikelihood + 1e-5);
+  }
+}
+
 /**
  * Ensure that the forward-backward algorithm is correct.
  */
@@ -731,6 +785,97 @@ BOOST_AUTO_TEST_CASE(GaussianHMMTrainTest)
   }
 }
 
+/**
+ * Train a left-right Gaussian HMM with and without the sparse transition
+ * option, and make sure both give the same model and that the impossible
+ * transitions stay impossible.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMSparseTransitionTest)
+{
+  // Each state either stays or moves to the next state.
+  arma::mat transition("0.6 0.0 0.0 0.0;"
+                       "0.4 0.7 0.0 0.0;"
+                       "0.0 0.3 0.8 0.0;"
+                       "0.0 0.0 0.2 1.0");
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(GaussianDistribution("0.0", "1.0"));
+  emission.push_back(GaussianDistribution("4.0", "1.0"));
+  emission.push_back(GaussianDistribution("8.0", "1.0"));
+  emission.push_back(GaussianDistribution("12.0", "1.0"));
+  HMM<GaussianDistribution> trueHMM(arma::vec("1.0 0.0 0.0 0.0"), transition,
+      emission);
+
+  std::vector<arma::mat> observations(30);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    trueHMM.Generate(40, observations[i], states);
+  }
+
+  // Start both models from the same guess, with the same topology.
+  arma::mat guessTransition("0.5 0.0 0.0 0.0;"
+                            "0.5 0.5 0.0 0.0;"
+                            "0.0 0.5 0.5 0.0;"
+                            "0.0 0.0 0.5 1.0");
+  std::vector<GaussianDistribution> guessEmission;
+  guessEmission.push_back(GaussianDistribution("1.0", "2.0"));
+  guessEmission.push_back(GaussianDistribution("3.0", "2.0"));
+  guessEmission.push_back(GaussianDistribution("9.0", "2.0"));
+  guessEmission.push_back(GaussianDistribution("11.0", "2.0"));
+  HMM<GaussianDistribution> denseHMM(arma::vec("0.25 0.25 0.25 0.25"),
+      guessTransition, guessEmission);
+  HMM<GaussianDistribution> sparseHMM(denseHMM);
+  sparseHMM.SparseTransition() = true;
+
+  denseHMM.Train(observations);
+  sparseHMM.Train(observations);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_SMALL(denseHMM.Initial()[i] - sparseHMM.Initial()[i], 1e-5);
+    BOOST_REQUIRE_SMALL(denseHMM.Emission()[i].Mean()[0] -
+        sparseHMM.Emission()[i].Mean()[0], 1e-4);
+    BOOST_REQUIRE_SMALL(sparseHMM.Emission()[i].Mean()[0] -
+        emission[i].Mean()[0], 0.5);
+
+    for (size_t j = 0; j < 4; ++j)
+    {
+      BOOST_REQUIRE_SMALL(denseHMM.Transition()(i, j) -
+          sparseHMM.Transition()(i, j), 1e-5);
+      if (guessTransition(i, j) == 0.0)
+        BOOST_REQUIRE_EQUAL(sparseHMM.Transition()(i, j), 0.0);
+    }
+  }
+
+  BOOST_REQUIRE_CLOSE(denseHMM.LogLikelihood(observations[0]),
+      sparseHMM.LogLikelihood(observations[0]), 1e-5);
+}
+
+/**
+ * The emission probabilities are rescaled in log-space, so the log-likelihood
+ * of a sequence should still be finite when every emission probability
+ * underflows.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMUnlikelyObservationsTest)
+{
+  HMM<GaussianDistribution> hmm(3, GaussianDistribution(50));
+
+  // Every observation is about 100 standard deviations away from every state,
+  // so each emission probability is about exp(-250000).
+  arma::mat observations(50, 10);
+  observations.fill(100.0);
+
+  const double logLikelihood = hmm.LogLikelihood(observations);
+  BOOST_REQUIRE(std::isfinite(logLikelihood));
+  BOOST_REQUIRE_CLOSE(logLikelihood,
+      10 * GaussianDistribution(50).LogProbability(observations.col(0)), 1e-5);
+
+  arma::mat stateProb;
+  hmm.Estimate(observations, stateProb);
+  for (size_t t = 0; t < 10; ++t)
+    BOOST_REQUIRE_CLOSE(arma::accu(stateProb.col(t)), 1.0, 1e-5);
+}
+
 /**
  * Make sure that a random sequence generated by a Gaussian HMM fits the
  * distribution correctly.
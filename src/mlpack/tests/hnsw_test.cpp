@@ -0,0 +1,183 @@
+/**
+ * @file hnsw_test.cpp
+ *
+ * Unit tests for the 'HNSWSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(HNSWTest);
+
+/**
+ * Make sure that the graph finds most of the true nearest neighbors, and that
+ * the distances it returns are right.
+ */
+BOOST_AUTO_TEST_CASE(HNSWRecallTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(10, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(10, 200);
+  const size_t k = 10;
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, k, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, k);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, queryData.n_cols);
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.9);
+
+  for (size_t q = 0; q < queryData.n_cols; ++q)
+  {
+    for (size_t i = 0; i < k; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(distances(i, q), metric::EuclideanDistance::Evaluate(
+          queryData.col(q), referenceData.col(neighbors(i, q))), 1e-5);
+      if (i > 0)
+        BOOST_REQUIRE_LE(distances(i - 1, q), distances(i, q));
+    }
+  }
+
+  // A wider beam does not find fewer neighbors.
+  hnsw.BeamWidth() = 200;
+  arma::Mat<size_t> wideNeighbors;
+  hnsw.Search(queryData, k, wideNeighbors, distances);
+  BOOST_REQUIRE_GE(KNN::Recall(wideNeighbors, trueNeighbors), 0.95);
+}
+
+/**
+ * Make sure that a search without a query set does not return a point as its
+ * own neighbor.
+ */
+BOOST_AUTO_TEST_CASE(HNSWMonochromaticTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 1000);
+  const size_t k = 5;
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 8, 100, 50);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(k, neighbors, distances);
+
+  for (size_t q = 0; q < neighbors.n_cols; ++q)
+    for (size_t i = 0; i < k; ++i)
+      BOOST_REQUIRE_NE(neighbors(i, q), q);
+
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.9);
+}
+
+/**
+ * Make sure that points inserted into an existing graph are found, and that
+ * an index built incrementally is as good as one built at once.
+ */
+BOOST_AUTO_TEST_CASE(HNSWInsertTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(6, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(6, 200);
+  const size_t k = 5;
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw;
+  hnsw.Insert(referenceData.cols(0, 499));
+  hnsw.Insert(referenceData.cols(500, 1499));
+  hnsw.Insert(referenceData.cols(1500, 1999));
+  BOOST_REQUIRE_EQUAL(hnsw.ReferenceSet().n_cols, referenceData.n_cols);
+  CheckMatrices(hnsw.ReferenceSet(), referenceData);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, k, neighbors, distances);
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.9);
+
+  // The inserted points find themselves.
+  hnsw.Search(referenceData.cols(1500, 1999), 1, neighbors, distances);
+  size_t found = 0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    if (neighbors(0, i) == 1500 + i)
+      ++found;
+  BOOST_REQUIRE_GE(found, 490);
+
+  // Points of the wrong dimensionality are rejected.
+  arma::mat wrongData = arma::randu<arma::mat>(5, 10);
+  BOOST_REQUIRE_THROW(hnsw.Insert(wrongData), std::invalid_argument);
+}
+
+/**
+ * Make sure that an index saved to a file gives the same results when it is
+ * loaded, and that points can still be inserted into it.
+ */
+BOOST_AUTO_TEST_CASE(HNSWIndexFileTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(4, 100);
+
+  HNSWSearch<> hnsw(referenceData, 10, 100, 40);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 5, neighbors, distances);
+
+  BOOST_REQUIRE(hnsw.SaveIndex("hnsw_index_test.bin"));
+
+  HNSWSearch<> loaded;
+  BOOST_REQUIRE(loaded.LoadIndex("hnsw_index_test.bin"));
+  BOOST_REQUIRE_EQUAL(loaded.MaxDegree(), 10);
+  BOOST_REQUIRE_EQUAL(loaded.BeamWidth(), 40);
+  BOOST_REQUIRE_EQUAL(loaded.Levels(), hnsw.Levels());
+  CheckMatrices(loaded.ReferenceSet(), referenceData);
+
+  arma::Mat<size_t> loadedNeighbors;
+  arma::mat loadedDistances;
+  loaded.Search(queryData, 5, loadedNeighbors, loadedDistances);
+  CheckMatrices(loadedNeighbors, neighbors);
+  CheckMatrices(loadedDistances, distances);
+
+  // The loaded index copies the mapped points when points are inserted.
+  loaded.Insert(queryData);
+  loaded.Search(queryData, 1, loadedNeighbors, loadedDistances);
+  size_t found = 0;
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+    if (loadedNeighbors(0, i) == 1000 + i)
+      ++found;
+  BOOST_REQUIRE_GE(found, 98);
+  CheckMatrices(loaded.ReferenceSet().cols(0, 999), referenceData);
+
+  remove("hnsw_index_test.bin");
+
+  // Neither a missing file nor a file in another format is accepted.
+  BOOST_REQUIRE(!loaded.LoadIndex("hnsw_index_test.bin"));
+
+  std::ofstream invalid("hnsw_index_test.bin");
+  invalid << "This is not an index, but it is long enough to have a header.";
+  invalid.close();
+  BOOST_REQUIRE(!loaded.LoadIndex("hnsw_index_test.bin"));
+  remove("hnsw_index_test.bin");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -15,6 +15,7 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_categorical_split.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
+#include <mlpack/methods/hoeffding_trees/sketch_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree_model.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -339,6 +340,39 @@ BOOST_AUTO_TEST_CASE(HoeffdingCategoricalSplitSplitTest)
   BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(2), 2);
 }
 
+/**
+ * Make sure that a categorical split with very many categories only stores the
+ * categories it has seen, and still finds the right majorities.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingCategoricalSplitManyCategoriesTest)
+{
+  HoeffdingCategoricalSplit<GiniImpurity> split(1000000, 3);
+  HoeffdingCategoricalSplit<GiniImpurity> denseSplit(100, 3);
+
+  for (size_t i = 0; i < 300; ++i)
+  {
+    split.Train(size_t(i % 100) * 10000, (i % 100) % 3);
+    denseSplit.Train(size_t(i % 100), (i % 100) % 3);
+  }
+
+  BOOST_REQUIRE_EQUAL(split.NumChildren(), 1000000);
+  BOOST_REQUIRE_EQUAL(split.MajorityClass(), denseSplit.MajorityClass());
+  BOOST_REQUIRE_CLOSE(split.MajorityProbability(),
+      denseSplit.MajorityProbability(), 1e-5);
+
+  double bestFitness, secondBestFitness, denseBestFitness;
+  split.EvaluateFitnessFunction(bestFitness, secondBestFitness);
+  denseSplit.EvaluateFitnessFunction(denseBestFitness, secondBestFitness);
+  BOOST_REQUIRE_CLOSE(bestFitness, denseBestFitness, 1e-5);
+
+  arma::Col<size_t> childMajorities;
+  HoeffdingCategoricalSplit<GiniImpurity>::SplitInfo splitInfo(1000000);
+  split.Split(childMajorities, splitInfo);
+  BOOST_REQUIRE_EQUAL(childMajorities.n_elem, 1000000);
+  for (size_t c = 0; c < 100; ++c)
+    BOOST_REQUIRE_EQUAL(childMajorities[c * 10000], c % 3);
+}
+
 /**
  * If we feed the HoeffdingTree a ton of points of the same class, it should
  * not suggest that we split.
@@ -863,6 +897,42 @@ BOOST_AUTO_TEST_CASE(NumericHoeffdingTreeTest)
   BOOST_REQUIRE_GT(batchCorrect, 6000);
 }
 
+/**
+ * Create a SketchNumericSplit object and feed it many more samples than it has
+ * centroids, where anything less than 1.0 is class 0 and anything greater is
+ * class 1.  Make sure the sketch stays small and still finds a good split.
+ */
+BOOST_AUTO_TEST_CASE(SketchNumericSplitSimpleSplitTest)
+{
+  SketchNumericSplit<GiniImpurity> split(2, 20); // 2 classes, 20 centroids.
+
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    split.Train(mlpack::math::Random(), 0);
+    split.Train(mlpack::math::Random() + 1.0, 1);
+    BOOST_REQUIRE_LE(split.NumCentroids(), 20);
+  }
+
+  // The Gini impurity for the unsplit node is 0.5, and the best split should
+  // give nearly pure children.
+  double bestGain, secondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  BOOST_REQUIRE_LE(split.NumCentroids(), 20);
+  BOOST_REQUIRE_GT(bestGain, 0.45);
+  BOOST_REQUIRE_GE(bestGain, secondBestGain);
+
+  arma::Col<size_t> childMajorities;
+  BinaryNumericSplitInfo<> splitInfo;
+  split.Split(childMajorities, splitInfo);
+
+  BOOST_REQUIRE_EQUAL(childMajorities[0], 0);
+  BOOST_REQUIRE_EQUAL(childMajorities[1], 1);
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(0.5), 0);
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(1.5), 1);
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(-1.0), 0);
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(3.0), 1);
+}
+
 /**
  * The same as the previous test, but with the numeric binary split, and with a
  * categorical feature.
@@ -1220,6 +1290,129 @@ BOOST_AUTO_TEST_CASE(MultipleSerializationTest)
   }
 }
 
+/**
+ * Make sure that a Hoeffding tree can be trained with the sketch numeric split,
+ * and survives serialization.
+ */
+BOOST_AUTO_TEST_CASE(SketchNumericHoeffdingTreeTest)
+{
+  // Generate data.
+  arma::mat dataset(3, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(3); // All features are numeric.
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    labels[i + 2] = 1;
+  }
+
+  typedef HoeffdingTree<GiniImpurity, SketchDoubleNumericSplit> TreeType;
+  TreeType tree(info, 3);
+  tree.Train(dataset, labels, false);
+
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(tree.SplitDimension(), 1);
+
+  TreeType xmlTree, textTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, textTree, binaryTree);
+
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions;
+  tree.Classify(dataset, predictions);
+  xmlTree.Classify(dataset, xmlPredictions);
+  textTree.Classify(dataset, textPredictions);
+  binaryTree.Classify(dataset, binaryPredictions);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], xmlPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], textPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], binaryPredictions[i]);
+
+    if (labels[i] == predictions[i])
+      ++correct;
+  }
+
+  // 66% accuracy shouldn't be too much to ask...
+  BOOST_REQUIRE_GT(correct, 6000);
+}
+
+/**
+ * Make sure that streaming training on mini-batches gives the same tree as
+ * training on the points one at a time, even when the batches don't line up
+ * with the split checks.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchHoeffdingTreeTest)
+{
+  // Generate data.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString<double>("0", 3);
+  info.MapString<double>("1", 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = 0.0;
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    dataset(3, i + 1) = 1.0;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    dataset(3, i + 2) = 0.0;
+    labels[i + 2] = 1;
+  }
+
+  typedef HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit> TreeType;
+  TreeType pointTree(info, 3, 0.95, 5000, 100, 100);
+  TreeType batchTree(info, 3, 0.95, 5000, 100, 100);
+  for (size_t i = 0; i < 9000; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+  for (size_t i = 0; i < 9000; i += 1000)
+  {
+    // Batches of 999 points and then a batch of 1 point.
+    const arma::mat batch = dataset.cols(i, i + 998);
+    const arma::mat point = dataset.col(i + 999);
+    batchTree.Train(batch, labels.subvec(i, i + 998), false);
+    batchTree.Train(point, labels.subvec(i + 999, i + 999), false);
+  }
+
+  BOOST_REQUIRE_GT(pointTree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(pointTree.NumChildren(), batchTree.NumChildren());
+  BOOST_REQUIRE_EQUAL(pointTree.SplitDimension(), batchTree.SplitDimension());
+
+  arma::Row<size_t> pointPredictions, batchPredictions;
+  arma::rowvec pointProbabilities, batchProbabilities;
+  pointTree.Classify(dataset, pointPredictions, pointProbabilities);
+  batchTree.Classify(dataset, batchPredictions, batchProbabilities);
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(pointPredictions[i], batchPredictions[i]);
+    BOOST_REQUIRE_CLOSE(pointProbabilities[i], batchProbabilities[i], 1e-5);
+  }
+}
+
 // Test the Hoeffding tree model.
 BOOST_AUTO_TEST_CASE(HoeffdingTreeModelTest)
 {
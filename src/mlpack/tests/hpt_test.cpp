@@ -16,6 +16,7 @@
 #include <mlpack/core/hpt/fixed.hpp>
 #include <mlpack/core/hpt/hpt.hpp>
 #include <mlpack/core/optimizers/grid_search/grid_search.hpp>
+#include <mlpack/core/optimizers/successive_halving/successive_halving.hpp>
 #include <mlpack/core/optimizers/gradient_descent/gradient_descent.cpp>
 #include <mlpack/methods/lars/lars.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
@@ -228,6 +229,130 @@ BOOST_AUTO_TEST_CASE(GridSearchTest)
   BOOST_REQUIRE_CLOSE(expectedLambda2, actualParameters(1, 0), 1e-5);
 }
 
+/**
+ * Test that SimpleCV trains on the random subset of the training set given by
+ * the subset seed when the training fraction is less than 1.
+ */
+BOOST_AUTO_TEST_CASE(SimpleCVTrainingFractionTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  SimpleCV<LARS, MSE> cv(validationSize, xs, ys);
+  BOOST_REQUIRE_CLOSE(cv.TrainingFraction(), 1.0, 1e-5);
+  cv.TrainingFraction() = 0.5;
+  cv.SubsetSeed() = 7;
+  const double objective = cv.Evaluate(true, false, 0.1, 0.05);
+
+  // The training set holds the first 7 points, so the model is trained on 4.
+  const size_t validationFirstColumn =
+      round(xs.n_cols * (1.0 - validationSize));
+  const arma::uvec subset = CVBase<LARS, arma::mat, arma::rowvec,
+      void*>::RandomSubset(validationFirstColumn, 4, 7);
+  BOOST_REQUIRE_EQUAL(subset.n_elem, (size_t) 4);
+  BOOST_REQUIRE(arma::all(subset < validationFirstColumn));
+  LARS model(xs.cols(subset), ys.cols(subset), true, false, 0.1, 0.05);
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  BOOST_REQUIRE_CLOSE(objective,
+      MSE::Evaluate(model, validationXs, validationYs), 1e-5);
+
+  cv.TrainingFraction() = 0.0;
+  BOOST_REQUIRE_THROW(cv.Evaluate(true, false, 0.1, 0.05),
+      std::invalid_argument);
+}
+
+/**
+ * Test that successive halving with a single rung gives the same result as
+ * grid search.
+ */
+BOOST_AUTO_TEST_CASE(SuccessiveHalvingFullBudgetTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  SimpleCV<LARS, MSE> cv(validationSize, xs, ys);
+  CVFunction<decltype(cv), LARS, 4, FixedArg<bool, 0>, FixedArg<bool, 1>>
+      cvFun(cv, 0.0, 0.0, {transposeData}, {useCholesky});
+
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 2);
+  for (double lambda1 : lambda1Set)
+    datasetInfo.MapString<size_t>(lambda1, 0);
+  for (double lambda2 : lambda2Set)
+    datasetInfo.MapString<size_t>(lambda2, 1);
+
+  SuccessiveHalving optimizer(1.0);
+  arma::mat actualParameters;
+  double actualObjective =
+      optimizer.Optimize(cvFun, actualParameters, datasetInfo);
+
+  BOOST_REQUIRE_CLOSE(expectedObjective, actualObjective, 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda1, actualParameters(0, 0), 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda2, actualParameters(1, 0), 1e-5);
+  BOOST_REQUIRE_CLOSE(cv.TrainingFraction(), 1.0, 1e-5);
+
+  // Invalid parameters should be rejected.
+  optimizer.MinFraction() = 0.0;
+  BOOST_REQUIRE_THROW(optimizer.Optimize(cvFun, actualParameters,
+      datasetInfo), std::invalid_argument);
+  optimizer.MinFraction() = 0.5;
+  optimizer.Eta() = 1;
+  BOOST_REQUIRE_THROW(optimizer.Optimize(cvFun, actualParameters,
+      datasetInfo), std::invalid_argument);
+}
+
+/**
+ * Test HyperParameterTuner with successive halving: the chosen values should
+ * come from the given sets, and the best model should be trained with the
+ * full training set.
+ */
+BOOST_AUTO_TEST_CASE(HPTSuccessiveHalvingTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, SuccessiveHalving>
+      hpt(validationSize, xs, ys);
+  hpt.Optimizer().MinFraction() = 0.25;
+  hpt.Optimizer().Eta() = 2;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(true),
+      Fixed(false), lambda1Set, lambda2Set);
+
+  BOOST_REQUIRE(arma::any(lambda1Set == actualLambda1));
+  BOOST_REQUIRE(arma::any(lambda2Set == actualLambda2));
+
+  SimpleCV<LARS, MSE> cv(validationSize, xs, ys);
+  BOOST_REQUIRE_CLOSE(hpt.BestObjective(),
+      cv.Evaluate(true, false, actualLambda1, actualLambda2), 1e-5);
+
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  double objective = MSE::Evaluate(hpt.BestModel(), validationXs, validationYs);
+  BOOST_REQUIRE_CLOSE(hpt.BestObjective(), objective, 1e-5);
+}
+
 /**
  * Test HyperParameterTuner.
  */
@@ -229,6 +229,22 @@ BOOST_AUTO_TEST_CASE(MedianImputationTest)
   BOOST_REQUIRE_CLOSE(rowWiseInput(2, 2), 4.0, 1e-5);
 }
 
+/**
+ * Make sure MedianImputation fails if every value of a dimension is missing,
+ * like MeanImputation.
+ */
+BOOST_AUTO_TEST_CASE(MedianImputationAllMissingTest)
+{
+  arma::mat input("3.0 1.0 2.0 4.0;"
+                  "0.0 0.0 0.0 0.0;"
+                  "9.0 8.0 4.0 8.0;");
+
+  MedianImputation<double> imputer;
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(imputer.Impute(input, 0.0, 1, true), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 /**
  * Make sure ListwiseDeletion method deletes the whole column (if column wise)
  * or the row (if row wise) containing value of 0.
@@ -314,4 +330,51 @@ BOOST_AUTO_TEST_CASE(DatasetMapperPointerMapping)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(2, 0), &c);
 }
 
+/**
+ * Make sure that imputing many dimensions at once with MeanImputation and
+ * MedianImputation gives the same result as imputing them one by one, for
+ * both column-major and row-major matrices.
+ */
+BOOST_AUTO_TEST_CASE(MultipleDimensionImputationTest)
+{
+  // Make sure there are several blocks of points, and several chunks of
+  // dimensions for the median.
+  arma::mat input = arma::floor(10 * arma::randu<arma::mat>(150, 9001));
+  input.elem(arma::find(arma::randu<arma::mat>(150, 9001) < 0.1)).fill(-1);
+  input(3, 5) = std::numeric_limits<double>::quiet_NaN();
+
+  std::vector<size_t> dimensions;
+  for (size_t d = 0; d < 150; d += 2)
+    dimensions.push_back(d);
+  const std::vector<double> mappedValues(dimensions.size(), -1.0);
+
+  for (size_t columnMajor = 0; columnMajor < 2; ++columnMajor)
+  {
+    const arma::mat original = columnMajor ? input : arma::mat(input.t());
+
+    arma::mat meanOne(original), meanAll(original);
+    arma::mat medianOne(original), medianAll(original);
+    MeanImputation<double> mean;
+    MedianImputation<double> median;
+    for (size_t d : dimensions)
+    {
+      mean.Impute(meanOne, -1.0, d, columnMajor);
+      median.Impute(medianOne, -1.0, d, columnMajor);
+    }
+    mean.Impute(meanAll, mappedValues, dimensions, columnMajor);
+    median.Impute(medianAll, mappedValues, dimensions, columnMajor);
+
+    for (size_t i = 0; i < original.n_elem; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(meanAll[i], meanOne[i], 1e-5);
+      BOOST_REQUIRE_EQUAL(medianAll[i], medianOne[i]);
+    }
+
+    // The dimensions that weren't imputed still hold their missing values.
+    const size_t count = columnMajor ? arma::accu(meanAll.row(1) == -1) :
+        arma::accu(meanAll.col(1) == -1);
+    BOOST_REQUIRE_EQUAL(count, (size_t) arma::accu(input.row(1) == -1));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
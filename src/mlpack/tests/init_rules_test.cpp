@@ -380,4 +380,34 @@ BOOST_AUTO_TEST_CASE(LecunNormalInitTest)
   BOOST_REQUIRE_EQUAL(weights3d.n_slices, slices);
 }
 
+/**
+ * Make sure the initialization rules can be used with single precision
+ * matrices.
+ */
+BOOST_AUTO_TEST_CASE(FloatInitTest)
+{
+  arma::fmat weights;
+
+  GlorotInitialization glorotInit;
+  glorotInit.Initialize(weights, 10, 20);
+  BOOST_REQUIRE_EQUAL(weights.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(weights.n_cols, 20);
+
+  weights.reset();
+  HeInitialization heInit;
+  heInit.Initialize(weights, 10, 20);
+  BOOST_REQUIRE_EQUAL(weights.n_elem, 200);
+
+  weights.reset();
+  LecunNormalInitialization lecunInit;
+  lecunInit.Initialize(weights, 10, 20);
+  BOOST_REQUIRE_EQUAL(weights.n_elem, 200);
+
+  arma::fcube weightsCube;
+  RandomInitialization randomInit(-1, 1);
+  randomInit.Initialize(weightsCube, 5, 5, 2);
+  BOOST_REQUIRE_EQUAL(weightsCube.n_slices, 2);
+  BOOST_REQUIRE_LE(arma::abs(weightsCube).max(), 1.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
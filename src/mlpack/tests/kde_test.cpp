@@ -0,0 +1,251 @@
+/**
+ * @file kde_test.cpp
+ *
+ * Tests for the KDE class and the KDEModel class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/kde/kde_model.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::kernel;
+using namespace mlpack::tree;
+using namespace mlpack::metric;
+
+BOOST_AUTO_TEST_SUITE(KDETest);
+
+/**
+ * Compute the (unnormalized) kernel sums of the query points by brute force.
+ */
+template<typename KernelType>
+arma::vec BruteForceKernelSums(const arma::mat& referenceSet,
+                               const arma::mat& querySet,
+                               const KernelType& kernel)
+{
+  EuclideanDistance metric;
+  arma::vec sums(querySet.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+      sums[i] += kernel.Evaluate(metric.Evaluate(querySet.col(i),
+          referenceSet.col(j)));
+
+  return sums;
+}
+
+/**
+ * With no error tolerance, the dual-tree and single-tree estimates must be the
+ * exact densities, for every supported tree type.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckExactEstimates(const arma::mat& referenceSet,
+                         const arma::mat& querySet)
+{
+  GaussianKernel kernel(0.8);
+  arma::vec expected = BruteForceKernelSums(referenceSet, querySet, kernel);
+  expected /= referenceSet.n_cols * kernel.Normalizer(referenceSet.n_rows);
+
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, TreeType> kde(0.0, 0.0,
+      kernel);
+  kde.Train(referenceSet);
+
+  arma::vec dualEstimations, singleEstimations;
+  kde.Evaluate(querySet, dualEstimations);
+  kde.Mode() = SINGLE_TREE_MODE;
+  kde.Evaluate(querySet, singleEstimations);
+
+  BOOST_REQUIRE_EQUAL(dualEstimations.n_elem, querySet.n_cols);
+  BOOST_REQUIRE_EQUAL(singleEstimations.n_elem, querySet.n_cols);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(dualEstimations[i], expected[i], 1e-8);
+    BOOST_REQUIRE_CLOSE(singleEstimations[i], expected[i], 1e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(KDEExactTreeTypesTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 500);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  CheckExactEstimates<KDTree>(referenceSet, querySet);
+  CheckExactEstimates<BallTree>(referenceSet, querySet);
+  CheckExactEstimates<Octree>(referenceSet, querySet);
+  CheckExactEstimates<RTree>(referenceSet, querySet);
+}
+
+/**
+ * The estimates must respect the relative error tolerance.
+ */
+BOOST_AUTO_TEST_CASE(KDERelativeErrorTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(2, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(2, 300);
+
+  GaussianKernel kernel(0.3);
+  arma::vec expected = BruteForceKernelSums(referenceSet, querySet, kernel);
+  expected /= referenceSet.n_cols * kernel.Normalizer(referenceSet.n_rows);
+
+  const double relError = 0.05;
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    KDE<> kde(relError, 0.0, kernel, (mode == 0) ? DUAL_TREE_MODE :
+        SINGLE_TREE_MODE);
+    kde.Train(referenceSet);
+
+    arma::vec estimations;
+    kde.Evaluate(querySet, estimations);
+
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      BOOST_REQUIRE_LE(std::abs(estimations[i] - expected[i]),
+          relError * expected[i] + 1e-12);
+    }
+  }
+}
+
+/**
+ * The estimates must respect the absolute error tolerance, and the
+ * approximation must save base cases.
+ */
+BOOST_AUTO_TEST_CASE(KDEAbsoluteErrorTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(2, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(2, 200);
+
+  EpanechnikovKernel kernel(0.4);
+  arma::vec expected = BruteForceKernelSums(referenceSet, querySet, kernel);
+  expected /= referenceSet.n_cols * kernel.Normalizer(referenceSet.n_rows);
+
+  const double absError = 0.01;
+  KDE<EpanechnikovKernel, EuclideanDistance, arma::mat, BallTree> kde(0.0,
+      absError, kernel);
+  kde.Train(referenceSet);
+
+  arma::vec estimations;
+  kde.Evaluate(querySet, estimations);
+
+  BOOST_REQUIRE_LT(kde.BaseCases(), referenceSet.n_cols * querySet.n_cols);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    BOOST_REQUIRE_LE(std::abs(estimations[i] - expected[i]), absError + 1e-12);
+}
+
+/**
+ * Estimating the densities of the reference set must give the same results as
+ * passing the reference set as the query set, in the original order.
+ */
+BOOST_AUTO_TEST_CASE(KDEMonochromaticTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(4, 400);
+
+  KDE<> kde(0.0, 0.0, GaussianKernel(0.5));
+  kde.Train(referenceSet);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    kde.Mode() = (mode == 0) ? DUAL_TREE_MODE : SINGLE_TREE_MODE;
+
+    arma::vec monoEstimations, biEstimations;
+    kde.Evaluate(monoEstimations);
+    kde.Evaluate(referenceSet, biEstimations);
+
+    BOOST_REQUIRE_EQUAL(monoEstimations.n_elem, referenceSet.n_cols);
+    for (size_t i = 0; i < referenceSet.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(monoEstimations[i], biEstimations[i], 1e-8);
+  }
+}
+
+/**
+ * Kernels without a normalizer give the average of the kernel values.
+ */
+BOOST_AUTO_TEST_CASE(KDEUnnormalizedKernelTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 300);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+
+  LaplacianKernel kernel(0.5);
+  arma::vec expected = BruteForceKernelSums(referenceSet, querySet, kernel);
+  expected /= referenceSet.n_cols;
+
+  KDE<LaplacianKernel> kde(0.0, 0.0, kernel);
+  kde.Train(referenceSet);
+
+  arma::vec estimations;
+  kde.Evaluate(querySet, estimations);
+
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(estimations[i], expected[i], 1e-8);
+}
+
+/**
+ * Invalid error tolerances and query sets must be rejected.
+ */
+BOOST_AUTO_TEST_CASE(KDEInvalidParametersTest)
+{
+  BOOST_REQUIRE_THROW(KDE<>(-0.1, 0.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(1.5, 0.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(0.05, -1.0), std::invalid_argument);
+
+  KDE<> kde;
+  arma::vec estimations;
+  BOOST_REQUIRE_THROW(kde.Evaluate(estimations), std::invalid_argument);
+
+  kde.Train(arma::randu<arma::mat>(3, 100));
+  BOOST_REQUIRE_THROW(kde.Evaluate(arma::randu<arma::mat>(4, 10),
+      estimations), std::invalid_argument);
+}
+
+/**
+ * Every kernel and tree type of KDEModel must give the same estimates after
+ * serialization and after copying.
+ */
+BOOST_AUTO_TEST_CASE(KDEModelSerializationTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 300);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+
+  for (size_t k = 0; k < 5; ++k)
+  {
+    for (size_t t = 0; t < 4; ++t)
+    {
+      KDEModel model(0.6, 0.0, 0.0, (KDEModel::KernelTypes) k,
+          (KDEModel::TreeTypes) t);
+      model.BuildModel(arma::mat(referenceSet));
+
+      arma::vec estimations;
+      model.Evaluate(arma::mat(querySet), estimations);
+      BOOST_REQUIRE_EQUAL(estimations.n_elem, querySet.n_cols);
+
+      KDEModel xmlModel, textModel, binaryModel;
+      SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+      arma::vec xmlEstimations, textEstimations, binaryEstimations;
+      xmlModel.Evaluate(arma::mat(querySet), xmlEstimations);
+      textModel.Evaluate(arma::mat(querySet), textEstimations);
+      binaryModel.Evaluate(arma::mat(querySet), binaryEstimations);
+
+      CheckMatrices(estimations, xmlEstimations, 1e-8);
+      CheckMatrices(estimations, textEstimations, 1e-8);
+      CheckMatrices(estimations, binaryEstimations, 1e-8);
+
+      // A copy of the model must not share the tree.
+      KDEModel copy(model);
+      model = KDEModel();
+      arma::vec copyEstimations;
+      copy.Evaluate(arma::mat(querySet), copyEstimations);
+      CheckMatrices(estimations, copyEstimations, 1e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
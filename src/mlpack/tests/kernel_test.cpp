@@ -18,6 +18,8 @@
 #include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/core/kernels/polynomial_kernel.hpp>
 #include <mlpack/core/kernels/spherical_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
@@ -420,135 +422,135 @@ BOOST_AUTO_TEST_CASE(PSpectrumSubstringExtractionTest)
   PSpectrumStringKernel p(datasets, 3);
 
   // Ensure the sizes are correct.
-  BOOST_REQUIRE_EQUAL(p.Counts().size(), 2);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0].size(), 4);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1].size(), 7);
+  BOOST_REQUIRE_EQUAL(p.Spectra().size(), 2);
+  BOOST_REQUIRE_EQUAL(p.Spectra()[0].size(), 4);
+  BOOST_REQUIRE_EQUAL(p.Spectra()[1].size(), 7);
 
   // herpgle: her, erp, rpg, pgl, gle
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0].size(), 5);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0]["her"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0]["erp"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0]["rpg"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0]["pgl"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][0]["gle"], 1);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(0, 0), 5);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 0, "her"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 0, "erp"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 0, "rpg"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 0, "pgl"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 0, "gle"), 1);
 
   // herpagkle: her, erp, rpa, pag, agk, gkl, kle
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1].size(), 7);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["her"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["erp"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["rpa"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["pag"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["agk"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["gkl"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][1]["kle"], 1);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(0, 1), 7);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "her"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "erp"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "rpa"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "pag"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "agk"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "gkl"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 1, "kle"), 1);
 
   // klunktor: klu, lun, unk, nkt, kto, tor
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2].size(), 6);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["klu"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["lun"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["unk"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["nkt"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["kto"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][2]["tor"], 1);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(0, 2), 6);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "klu"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "lun"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "unk"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "nkt"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "kto"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 2, "tor"), 1);
 
   // flibbynopple: fli lib ibb bby byn yno nop opp ppl ple
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3].size(), 10);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["fli"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["lib"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["ibb"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["bby"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["byn"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["yno"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["nop"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["opp"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["ppl"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[0][3]["ple"], 1);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(0, 3), 10);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "fli"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "lib"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "ibb"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "bby"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "byn"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "yno"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "nop"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "opp"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "ppl"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(0, 3, "ple"), 1);
 
   // floggy3245: flo log ogg ggy gy3 y32 324 245
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0].size(), 8);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["flo"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["log"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["ogg"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["ggy"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["gy3"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["y32"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["324"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][0]["245"], 1);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(1, 0), 8);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "flo"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "log"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "ogg"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "ggy"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "gy3"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "y32"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "324"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 0, "245"), 1);
 
   // flippydopflip: fli lip ipp ppy pyd ydo dop opf pfl fli lip
   // fli(2) lip(2) ipp ppy pyd ydo dop opf pfl
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1].size(), 9);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["fli"], 2);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["lip"], 2);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["ipp"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["ppy"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["pyd"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["ydo"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["dop"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["opf"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][1]["pfl"], 1);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(1, 1), 9);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "fli"), 2);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "lip"), 2);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "ipp"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "ppy"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "pyd"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "ydo"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "dop"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "opf"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 1, "pfl"), 1);
 
   // stupid fricking cat: stu tup upi pid fri ric ick cki kin ing cat
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2].size(), 11);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["stu"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["tup"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["upi"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["pid"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["fri"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["ric"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["ick"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["cki"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["kin"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["ing"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][2]["cat"], 1);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(1, 2), 11);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "stu"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "tup"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "upi"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "pid"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "fri"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "ric"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "ick"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "cki"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "kin"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "ing"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 2, "cat"), 1);
 
   // food time isn't until later: foo ood tim ime isn unt nti til lat ate ter
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3].size(), 11);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["foo"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["ood"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["tim"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["ime"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["isn"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["unt"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["nti"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["til"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["lat"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["ate"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][3]["ter"], 1);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(1, 3), 11);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "foo"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "ood"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "tim"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "ime"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "isn"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "unt"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "nti"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "til"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "lat"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "ate"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 3, "ter"), 1);
 
   // leave me alone until 6:00: lea eav ave alo lon one unt nti til
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4].size(), 9);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["lea"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["eav"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["ave"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["alo"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["lon"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["one"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["unt"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["nti"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][4]["til"], 1);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(1, 4), 9);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "lea"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "eav"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "ave"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "alo"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "lon"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "one"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "unt"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "nti"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 4, "til"), 1);
 
   // only after that do you get any food.:
   // onl nly aft fte ter tha hat you get any foo ood
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5].size(), 12);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["onl"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["nly"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["aft"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["fte"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["ter"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["tha"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["hat"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["you"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["get"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["any"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["foo"], 1);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][5]["ood"], 1);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(1, 5), 12);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "onl"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "nly"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "aft"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "fte"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "ter"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "tha"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "hat"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "you"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "get"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "any"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "foo"), 1);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 5, "ood"), 1);
 
   // obloblobloblobloblobloblob: obl(8) blo(8) lob(8)
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][6].size(), 3);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][6]["obl"], 8);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][6]["blo"], 8);
-  BOOST_REQUIRE_EQUAL(p.Counts()[1][6]["lob"], 8);
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(1, 6), 3);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 6, "obl"), 8);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 6, "blo"), 8);
+  BOOST_REQUIRE_EQUAL(p.Count(1, 6, "lob"), 8);
 }
 
 BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
@@ -608,4 +610,129 @@ BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
   BOOST_REQUIRE_CLOSE(p.Evaluate(b, a), 11.0, 1e-5);
 }
 
+/**
+ * Make sure that the p-spectrum kernel ignores case and gives the same result
+ * as a direct comparison of all substrings, both for short substrings (which
+ * are coded exactly) and for long ones (which are hashed).
+ */
+BOOST_AUTO_TEST_CASE(PSpectrumStringLongSubstringTest)
+{
+  std::vector<std::vector<std::string> > dataset(1);
+  dataset[0].push_back("ACGTACGTTTGACCAGTACGTACGTTTGACCA");
+  dataset[0].push_back("acgtacgtttgaccagtTTGACCAGTACGTACG");
+  dataset[0].push_back("GGGCCCAAATTT acgtacgtttgacc agtac");
+
+  for (size_t length = 3; length <= 20; length += 17)
+  {
+    PSpectrumStringKernel p(dataset, length);
+
+    for (size_t i = 0; i < dataset[0].size(); ++i)
+    {
+      for (size_t j = 0; j < dataset[0].size(); ++j)
+      {
+        // Count the pairs of equal substrings directly.
+        double count = 0;
+        const std::string& a = dataset[0][i];
+        const std::string& b = dataset[0][j];
+        for (size_t s = 0; s + length <= a.length(); ++s)
+        {
+          std::string subA = a.substr(s, length);
+          if (subA.find(' ') != std::string::npos)
+            continue;
+          std::transform(subA.begin(), subA.end(), subA.begin(), ::tolower);
+          for (size_t t = 0; t + length <= b.length(); ++t)
+          {
+            std::string subB = b.substr(t, length);
+            std::transform(subB.begin(), subB.end(), subB.begin(), ::tolower);
+            if (subA == subB)
+              ++count;
+          }
+        }
+
+        arma::vec x(2), y(2);
+        x[0] = 0;
+        x[1] = i;
+        y[0] = 0;
+        y[1] = j;
+        BOOST_REQUIRE_EQUAL(p.Evaluate(x, y), count);
+      }
+    }
+
+    // Counting a substring ignores case.
+    const std::string first = dataset[0][0].substr(0, length);
+    std::string lower = first;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    BOOST_REQUIRE_GT(p.Count(0, 0, first), 0);
+    BOOST_REQUIRE_EQUAL(p.Count(0, 0, first), p.Count(0, 0, lower));
+    BOOST_REQUIRE_EQUAL(p.Count(0, 2, first), p.Count(0, 2, lower));
+  }
+}
+
+/**
+ * Check that KernelMatrix() gives the same results as evaluating the kernel on
+ * each pair of points, for the given kernel.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(KernelType kernel)
+{
+  // More than one block of columns, and a few points with a norm of 0.
+  arma::mat a = arma::randu<arma::mat>(5, 40);
+  arma::mat b = arma::randu<arma::mat>(5, 300);
+  a.col(3).zeros();
+  b.col(100).zeros();
+
+  arma::mat result;
+  KernelMatrix(kernel, a, b, result);
+  BOOST_REQUIRE_EQUAL(result.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(result.n_cols, b.n_cols);
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const double value = kernel.Evaluate(a.col(i), b.col(j));
+      if (std::abs(value) < 1e-8)
+        BOOST_REQUIRE_SMALL(result(i, j), 1e-6);
+      else
+        BOOST_REQUIRE_CLOSE(result(i, j), value, 1e-4);
+    }
+  }
+
+  // The symmetric version.
+  KernelMatrix(kernel, a, result);
+  BOOST_REQUIRE_EQUAL(result.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(result.n_cols, a.n_cols);
+  for (size_t j = 0; j < a.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const double value = kernel.Evaluate(a.col(i), a.col(j));
+      if (std::abs(value) < 1e-8)
+        BOOST_REQUIRE_SMALL(result(i, j), 1e-6);
+      else
+        BOOST_REQUIRE_CLOSE(result(i, j), value, 1e-4);
+    }
+  }
+}
+
+/**
+ * Make sure the kernel matrices computed in blocks are right.
+ */
+BOOST_AUTO_TEST_CASE(KernelMatrixTest)
+{
+  BOOST_REQUIRE(HasEvaluateBlock<GaussianKernel>::value);
+  BOOST_REQUIRE(HasEvaluateBlock<LinearKernel>::value);
+  BOOST_REQUIRE(HasEvaluateBlock<CosineDistance>::value);
+  BOOST_REQUIRE(!HasEvaluateBlock<PSpectrumStringKernel>::value);
+
+  CheckKernelMatrix(LinearKernel());
+  CheckKernelMatrix(PolynomialKernel(3.0, 0.5));
+  CheckKernelMatrix(HyperbolicTangentKernel(0.5, 0.1));
+  CheckKernelMatrix(CosineDistance());
+  CheckKernelMatrix(GaussianKernel(0.7));
+  CheckKernelMatrix(LaplacianKernel(0.7));
+  CheckKernelMatrix(EpanechnikovKernel(1.5));
+  CheckKernelMatrix(TriangularKernel(1.5));
+  CheckKernelMatrix(SphericalKernel(0.8));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
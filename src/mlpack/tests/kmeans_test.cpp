@@ -16,7 +16,10 @@
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_plus_plus_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
@@ -534,6 +537,54 @@ BOOST_AUTO_TEST_CASE(SparseKMeansTest)
   BOOST_REQUIRE_EQUAL(assignments[11], clusterTwo);
 }
 
+/**
+ * Make sure that the naive, Elkan and Hamerly step types give the same
+ * clusters on sparse data as on the same data held in a dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(SparseStepTypesTest)
+{
+  arma::sp_mat data;
+  data.sprandu(50, 800, 0.1);
+  const arma::mat denseData(data);
+
+  const size_t k = 6;
+  arma::mat centroids(denseData.cols(0, k - 1));
+
+  arma::mat denseCentroids(centroids);
+  arma::Row<size_t> denseAssignments;
+  KMeans<> km;
+  km.Cluster(denseData, k, denseAssignments, denseCentroids, false, true);
+
+  arma::mat naiveCentroids(centroids);
+  arma::Row<size_t> naiveAssignments;
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, NaiveKMeans, arma::sp_mat> naive;
+  naive.Cluster(data, k, naiveAssignments, naiveCentroids, false, true);
+
+  arma::mat elkanCentroids(centroids);
+  arma::Row<size_t> elkanAssignments;
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, ElkanKMeans, arma::sp_mat> elkan;
+  elkan.Cluster(data, k, elkanAssignments, elkanCentroids, false, true);
+
+  arma::mat hamerlyCentroids(centroids);
+  arma::Row<size_t> hamerlyAssignments;
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, HamerlyKMeans, arma::sp_mat> hamerly;
+  hamerly.Cluster(data, k, hamerlyAssignments, hamerlyCentroids, false, true);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(naiveAssignments[i], denseAssignments[i]);
+    BOOST_REQUIRE_EQUAL(elkanAssignments[i], denseAssignments[i]);
+    BOOST_REQUIRE_EQUAL(hamerlyAssignments[i], denseAssignments[i]);
+  }
+
+  CheckMatrices(naiveCentroids, denseCentroids, 1e-5);
+  CheckMatrices(elkanCentroids, denseCentroids, 1e-5);
+  CheckMatrices(hamerlyCentroids, denseCentroids, 1e-5);
+}
+
 #endif // ARMA_HAS_SPMAT
 
 BOOST_AUTO_TEST_CASE(ElkanTest)
@@ -737,4 +788,181 @@ BOOST_AUTO_TEST_CASE(SampleInitializationTest)
   }
 }
 
+
+/**
+ * Make sure mini-batch k-means finds the centers of well-separated clusters,
+ * both when run by KMeans and when the data is given in chunks.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  arma::mat centers("0.0 10.0 -10.0;"
+                    "0.0 10.0 5.0");
+  arma::mat dataset(2, 6000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = centers.col(i % 3) + 0.3 * arma::randn<arma::vec>(2);
+
+  // Start from one point of each cluster.
+  arma::mat initialCentroids = dataset.cols(0, 2);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans(200);
+  arma::Row<size_t> assignments;
+  arma::mat centroids(initialCentroids);
+  kmeans.Cluster(dataset, 3, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], i % 3);
+  for (size_t i = 0; i < centers.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(centroids[i] - centers[i], 0.1);
+
+  // Now feed the dataset in chunks.
+  metric::EuclideanDistance metric;
+  arma::mat chunk;
+  MiniBatchKMeans<metric::EuclideanDistance, arma::mat> step(chunk, metric);
+  centroids = initialCentroids;
+  for (size_t i = 0; i < dataset.n_cols; i += 500)
+  {
+    chunk = dataset.cols(i, i + 499);
+    step.Update(chunk, centroids);
+  }
+
+  BOOST_REQUIRE_EQUAL(step.Counts().n_elem, 3);
+  BOOST_REQUIRE_EQUAL(arma::accu(step.Counts()), dataset.n_cols);
+  for (size_t i = 0; i < centers.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(centroids[i] - centers[i], 0.1);
+}
+
+/**
+ * Make sure that k-means++ and k-means|| put one initial centroid into each of
+ * many well-separated clusters, that the pruned distance updates are exact, and
+ * that k-means started from k-means|| finds the clusters.
+ */
+BOOST_AUTO_TEST_CASE(KMeansPlusPlusInitializationTest)
+{
+  // 25 clusters on a grid, far apart compared to their spread.
+  const size_t clusters = 25;
+  arma::mat centers(2, clusters);
+  for (size_t c = 0; c < clusters; ++c)
+  {
+    centers(0, c) = 20.0 * (c % 5);
+    centers(1, c) = 20.0 * (c / 5);
+  }
+
+  arma::mat dataset(2, 5000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    dataset.col(i) = centers.col(i % clusters) +
+        0.5 * arma::randn<arma::vec>(2);
+  }
+
+  // Every cluster must contain exactly one of the initial centroids.
+  auto checkCentroids = [&](const arma::mat& centroids)
+  {
+    BOOST_REQUIRE_EQUAL(centroids.n_rows, 2);
+    BOOST_REQUIRE_EQUAL(centroids.n_cols, clusters);
+    arma::Col<size_t> found(clusters, arma::fill::zeros);
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      const arma::rowvec distances = arma::sum(arma::square(
+          centers.each_col() - centroids.col(c)), 0);
+      ++found[distances.index_min()];
+    }
+
+    for (size_t c = 0; c < clusters; ++c)
+      BOOST_REQUIRE_EQUAL(found[c], 1);
+  };
+
+  arma::mat centroids;
+  KMeansPlusPlusInitialization plusPlus;
+  plusPlus.Cluster(dataset, clusters, centroids);
+  checkCentroids(centroids);
+
+  KMeansParallelInitialization parallel(3);
+  parallel.Cluster(dataset, clusters, centroids);
+  checkCentroids(centroids);
+
+  // A small oversampling factor still gives enough candidates.
+  parallel.Oversampling() = 1.0;
+  parallel.Cluster(dataset, clusters, centroids);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, clusters);
+
+  // The distances of the pruned updates are the exact nearest distances.
+  arma::vec distances(dataset.n_cols);
+  distances.fill(DBL_MAX);
+  arma::Row<size_t> nearest(dataset.n_cols, arma::fill::zeros);
+  KMeansPlusPlusInitialization::UpdateDistances(dataset, centers, 0, 10,
+      distances, nearest);
+  KMeansPlusPlusInitialization::UpdateDistances(dataset, centers, 10, clusters,
+      distances, nearest);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    const arma::rowvec exact = arma::sum(arma::square(
+        centers.each_col() - dataset.col(i)), 0);
+    BOOST_REQUIRE_EQUAL(nearest[i], exact.index_min());
+    BOOST_REQUIRE_CLOSE(distances[i], exact.min(), 1e-5);
+  }
+
+  // k-means started from k-means|| recovers the clusters.
+  KMeans<EuclideanDistance, KMeansParallelInitialization> kmeans;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(dataset, clusters, assignments, centroids);
+  for (size_t i = clusters; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[i % clusters]);
+}
+
+/**
+ * Make sure that the naive, Elkan and Hamerly step types work on data held in
+ * single precision, and give the same clusters as on double precision data.
+ */
+BOOST_AUTO_TEST_CASE(FloatStepTypesTest)
+{
+  // Three well-separated clusters.
+  arma::mat denseData(5, 600);
+  denseData.randn();
+  denseData.cols(200, 399) += 10.0;
+  denseData.cols(400, 599) -= 10.0;
+  const arma::fmat data = arma::conv_to<arma::fmat>::from(denseData);
+
+  const size_t k = 3;
+  arma::mat centroids(5, k);
+  centroids.col(0) = denseData.col(0);
+  centroids.col(1) = denseData.col(200);
+  centroids.col(2) = denseData.col(400);
+
+  arma::mat denseCentroids(centroids);
+  arma::Row<size_t> denseAssignments;
+  KMeans<> km;
+  km.Cluster(denseData, k, denseAssignments, denseCentroids, false, true);
+
+  arma::mat naiveCentroids(centroids);
+  arma::Row<size_t> naiveAssignments;
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, NaiveKMeans, arma::fmat> naive;
+  naive.Cluster(data, k, naiveAssignments, naiveCentroids, false, true);
+
+  arma::mat elkanCentroids(centroids);
+  arma::Row<size_t> elkanAssignments;
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, ElkanKMeans, arma::fmat> elkan;
+  elkan.Cluster(data, k, elkanAssignments, elkanCentroids, false, true);
+
+  arma::mat hamerlyCentroids(centroids);
+  arma::Row<size_t> hamerlyAssignments;
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, HamerlyKMeans, arma::fmat> hamerly;
+  hamerly.Cluster(data, k, hamerlyAssignments, hamerlyCentroids, false, true);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(denseAssignments[i], i / 200);
+    BOOST_REQUIRE_EQUAL(naiveAssignments[i], denseAssignments[i]);
+    BOOST_REQUIRE_EQUAL(elkanAssignments[i], denseAssignments[i]);
+    BOOST_REQUIRE_EQUAL(hamerlyAssignments[i], denseAssignments[i]);
+  }
+
+  CheckMatrices(naiveCentroids, denseCentroids, 1e-3);
+  CheckMatrices(elkanCentroids, denseCentroids, 1e-3);
+  CheckMatrices(hamerlyCentroids, denseCentroids, 1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
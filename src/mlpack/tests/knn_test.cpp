@@ -10,6 +10,8 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search_engine.hpp>
+#include <mlpack/methods/neighbor_search/spill_search_engine.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
@@ -719,6 +721,173 @@ BOOST_AUTO_TEST_CASE(DualTreeVsNaive2)
   }
 }
 
+/**
+ * Test the dual-tree nearest-neighbors method with the parallel dual-tree
+ * traverser against the naive method, with and without a query dataset.
+ *
+ * Errors are produced if the results are not identical.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsNaive)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      KDTree, KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat>::ParallelDualTreeTraverser> ParallelKNN;
+
+  ParallelKNN knn(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+  knn.Search(querySet, 10, neighborsTree, distancesTree);
+  naive.Search(querySet, 10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+
+  knn.Search(10, neighborsTree, distancesTree);
+  naive.Search(10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+}
+
+/**
+ * Test the level-synchronous parallel breadth-first dual-tree traverser against
+ * the naive method.  The results must be identical to the naive results.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBreadthFirstDualTreeVsNaive)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      KDTree, KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat>::ParallelBreadthFirstDualTreeTraverser> ParallelKNN;
+
+  ParallelKNN knn(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+  knn.Search(querySet, 10, neighborsTree, distancesTree);
+  naive.Search(querySet, 10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+
+  knn.Search(10, neighborsTree, distancesTree);
+  naive.Search(10, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+}
+
+/**
+ * Traverse a kd-tree with blocks of query points using the batched single-tree
+ * traverser, and make sure that the results are identical to the naive
+ * results.
+ */
+BOOST_AUTO_TEST_CASE(BatchSingleTreeVsNaive)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      TreeType> RuleType;
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew);
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+
+  EuclideanDistance metric;
+  RuleType rules(tree.Dataset(), querySet, 10, metric);
+  TreeType::BatchSingleTreeTraverser<RuleType> traverser(rules);
+
+  // Blocks of 64 query points, and a last block of 44.
+  std::vector<size_t> block;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    block.push_back(i);
+    if (block.size() == 64 || i == querySet.n_cols - 1)
+    {
+      traverser.Traverse(block, tree);
+      block.clear();
+    }
+  }
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+  rules.GetResults(neighborsTree, distancesTree);
+
+  KNN naive(dataset, NAIVE_MODE);
+  naive.Search(querySet, 10, neighborsNaive, distancesNaive);
+
+  BOOST_REQUIRE_GT(traverser.NumPrunes(), 0);
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(oldFromNew[neighborsTree[i]], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+}
+
+/**
+ * Test the dual-tree nearest-neighbors method against the naive method on
+ * high-dimensional data, where the leaf-leaf base cases are computed in blocks.
+ * The results must be identical to the naive results.
+ */
+BOOST_AUTO_TEST_CASE(HighDimensionalDualTreeVsNaive)
+{
+  arma::mat dataset = arma::randu<arma::mat>(30, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(30, 500);
+
+  KNN knn(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+  knn.Search(querySet, 5, neighborsTree, distancesTree);
+  naive.Search(querySet, 5, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_EQUAL(distancesTree[i], distancesNaive[i]);
+  }
+
+  knn.Search(5, neighborsTree, distancesTree);
+  naive.Search(5, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_EQUAL(distancesTree[i], distancesNaive[i]);
+  }
+}
+
 /**
  * Test the single-tree nearest-neighbors method with the naive method.  This
  * uses only a reference dataset.
@@ -1143,6 +1312,68 @@ BOOST_AUTO_TEST_CASE(KNNModelTest)
   }
 }
 
+/**
+ * Ensure that single precision NSModels give the same results as a double
+ * precision search on the same (float-representable) data, and that tree types
+ * without single precision support are rejected.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelSinglePrecisionTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  // Round the data to single precision, so that the baseline sees exactly the
+  // same points as the single precision models.
+  arma::mat referenceData = arma::conv_to<arma::mat>::from(
+      arma::randu<arma::fmat>(10, 200));
+  arma::mat queryData = arma::conv_to<arma::mat>::from(
+      arma::randu<arma::fmat>(10, 50));
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  knn.Search(queryData, 3, baselineNeighbors, baselineDistances);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::KD_TREE,
+      KNNModel::BALL_TREE, KNNModel::VP_TREE, KNNModel::RP_TREE,
+      KNNModel::MAX_RP_TREE, KNNModel::UB_TREE };
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE,
+      NAIVE_MODE };
+
+  for (size_t t = 0; t < 6; ++t)
+  {
+    for (size_t m = 0; m < 3; ++m)
+    {
+      KNNModel model(treeTypes[t], false, true);
+
+      arma::mat referenceCopy(referenceData);
+      arma::mat queryCopy(queryData);
+      model.BuildModel(std::move(referenceCopy), 20, modes[m]);
+
+      BOOST_REQUIRE(model.SinglePrecision());
+      BOOST_REQUIRE_EQUAL(model.FloatDataset().n_cols, referenceData.n_cols);
+      BOOST_REQUIRE_EQUAL(model.Dimensionality(), referenceData.n_rows);
+      BOOST_REQUIRE_EQUAL(model.NumReferencePoints(), referenceData.n_cols);
+
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      model.Search(std::move(queryCopy), 3, neighbors, distances);
+
+      BOOST_REQUIRE_EQUAL(neighbors.n_rows, baselineNeighbors.n_rows);
+      BOOST_REQUIRE_EQUAL(neighbors.n_cols, baselineNeighbors.n_cols);
+      BOOST_REQUIRE_EQUAL(distances.n_rows, baselineDistances.n_rows);
+      BOOST_REQUIRE_EQUAL(distances.n_cols, baselineDistances.n_cols);
+      for (size_t k = 0; k < distances.n_elem; ++k)
+        BOOST_REQUIRE_CLOSE(distances[k], baselineDistances[k], 1e-3);
+    }
+  }
+
+  // Trees that don't support single precision can't be built.
+  KNNModel coverModel(KNNModel::COVER_TREE, false, true);
+  arma::mat referenceCopy(referenceData);
+  BOOST_REQUIRE_THROW(coverModel.BuildModel(std::move(referenceCopy), 20,
+      DUAL_TREE_MODE), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_CASE(KNNModelMonochromaticTest)
 {
   // Ensure that we can build an NSModel<NearestNeighborSearch> and get correct
@@ -1466,4 +1697,397 @@ BOOST_AUTO_TEST_CASE(GreedyTreeSearch)
       0);
 }
 
+/**
+ * Make sure that KBestCandidates keeps the k best candidates of each query
+ * point in sorted order.
+ */
+BOOST_AUTO_TEST_CASE(KBestCandidatesTest)
+{
+  KBestCandidates<NearestNeighborSort> candidates(3, 2);
+
+  BOOST_REQUIRE_EQUAL(candidates.WorstDistance(0), DBL_MAX);
+
+  candidates.Insert(0, 0, 5.0);
+  candidates.Insert(0, 1, 2.0);
+  candidates.Insert(0, 2, 7.0);
+  candidates.Insert(0, 3, 1.0);
+  candidates.Insert(0, 4, 9.0);
+  candidates.Insert(1, 5, 4.0);
+
+  BOOST_REQUIRE_EQUAL(candidates.WorstDistance(0), 5.0);
+  BOOST_REQUIRE_EQUAL(candidates.WorstDistance(1), DBL_MAX);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  candidates.Release(neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 2);
+  BOOST_REQUIRE_EQUAL(neighbors(0, 0), 3);
+  BOOST_REQUIRE_EQUAL(neighbors(1, 0), 1);
+  BOOST_REQUIRE_EQUAL(neighbors(2, 0), 0);
+  BOOST_REQUIRE_EQUAL(distances(0, 0), 1.0);
+  BOOST_REQUIRE_EQUAL(distances(1, 0), 2.0);
+  BOOST_REQUIRE_EQUAL(distances(2, 0), 5.0);
+  BOOST_REQUIRE_EQUAL(neighbors(0, 1), 5);
+  BOOST_REQUIRE_EQUAL(distances(0, 1), 4.0);
+  BOOST_REQUIRE_EQUAL(neighbors(1, 1), size_t() - 1);
+}
+
+/**
+ * Make sure that NeighborSearchEngine gives the same results as naive search,
+ * both for batches that are searched with a single-tree traversal and for
+ * batches that are searched with a dual-tree traversal.
+ */
+BOOST_AUTO_TEST_CASE(NeighborSearchEngineTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+
+  KNN naive(dataset, NAIVE_MODE);
+  NeighborSearchEngine<> engine(KNN(dataset), 50);
+
+  for (size_t batchSize : { 1, 10, 49, 50, 300 })
+  {
+    arma::mat querySet = arma::randu<arma::mat>(5, batchSize);
+
+    arma::Mat<size_t> neighbors, neighborsNaive;
+    arma::mat distances, distancesNaive;
+    engine.Search(querySet, 4, neighbors, distances);
+    naive.Search(querySet, 4, neighborsNaive, distancesNaive);
+
+    BOOST_REQUIRE_EQUAL(neighbors.n_rows, 4);
+    BOOST_REQUIRE_EQUAL(neighbors.n_cols, batchSize);
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], neighborsNaive[i]);
+      BOOST_REQUIRE_CLOSE(distances[i], distancesNaive[i], 1e-5);
+    }
+  }
+
+  // The engine can't be used without a reference tree.
+  KNN naiveKNN(dataset, NAIVE_MODE);
+  BOOST_REQUIRE_THROW(NeighborSearchEngine<> e(std::move(naiveKNN)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that inserting points into and deleting points from a KNN model
+ * gives the same results as a model built on the resulting reference set.
+ */
+BOOST_AUTO_TEST_CASE(KNNInsertDeleteTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1500);
+  arma::mat querySet = arma::randu<arma::mat>(4, 200);
+
+  KNN knn(dataset.cols(0, 999));
+  knn.Insert(dataset.cols(1000, 1499));
+
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, neighborsNaive;
+  arma::mat distances, distancesNaive;
+  knn.Search(querySet, 5, neighbors, distances);
+  naive.Search(querySet, 5, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], distancesNaive[i], 1e-5);
+  }
+
+  // Now remove the first half of the points.
+  std::vector<size_t> toDelete;
+  for (size_t i = 0; i < 750; ++i)
+    toDelete.push_back(i);
+  BOOST_REQUIRE_EQUAL(knn.Delete(toDelete), 750);
+
+  KNN naiveRemaining(dataset.cols(750, 1499), NAIVE_MODE);
+  knn.Search(querySet, 5, neighbors, distances);
+  naiveRemaining.Search(querySet, 5, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], neighborsNaive[i] + 750);
+    BOOST_REQUIRE_CLOSE(distances[i], distancesNaive[i], 1e-5);
+  }
+}
+
+
+/**
+ * Make sure batched single-tree search on a cover tree gives the same results
+ * as naive search when the number of queries is not a multiple of the batch
+ * size, and that the base case counts of all batches are collected.
+ */
+BOOST_AUTO_TEST_CASE(BatchedSingleTreeSearchTest)
+{
+  arma::mat referenceData;
+  referenceData.randu(5, 2000);
+  arma::mat queryData;
+  queryData.randu(5, 1001);
+
+  NeighborSearch<NearestNeighborSort, LMetric<2>, arma::mat, StandardCoverTree>
+      coverTreeSearch(referenceData, SINGLE_TREE_MODE);
+  KNN naive(referenceData, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  coverTreeSearch.Search(queryData, 7, neighbors, distances);
+  naive.Search(queryData, 7, naiveNeighbors, naiveDistances);
+
+  BOOST_REQUIRE_GE(coverTreeSearch.BaseCases(), queryData.n_cols);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+
+  // Now the monochromatic case.
+  coverTreeSearch.Search(7, neighbors, distances);
+  naive.Search(7, naiveNeighbors, naiveDistances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+}
+
+
+/**
+ * Make sure a model loaded from an index file finds the same neighbors as the
+ * model that was saved, for tree and naive search, and that invalid files are
+ * rejected.
+ */
+BOOST_AUTO_TEST_CASE(KNNIndexFileTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 500);
+  arma::mat queryData = arma::randu<arma::mat>(4, 100);
+
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, NAIVE_MODE };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    KNN knn(referenceData, modes[m]);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(queryData, 5, neighbors, distances);
+
+    BOOST_REQUIRE(knn.SaveIndex("knn_index_test.bin"));
+
+    KNN loaded;
+    BOOST_REQUIRE(loaded.LoadIndex("knn_index_test.bin"));
+    BOOST_REQUIRE_EQUAL(loaded.SearchMode(), modes[m]);
+    CheckMatrices(loaded.ReferenceSet(), knn.ReferenceSet());
+
+    arma::Mat<size_t> loadedNeighbors;
+    arma::mat loadedDistances;
+    loaded.Search(queryData, 5, loadedNeighbors, loadedDistances);
+    CheckMatrices(loadedNeighbors, neighbors);
+    CheckMatrices(loadedDistances, distances);
+
+    // The saved model is unchanged, and is still serialized with its
+    // reference set.
+    knn.Search(queryData, 5, loadedNeighbors, loadedDistances);
+    CheckMatrices(loadedNeighbors, neighbors);
+
+    std::stringstream stream;
+    {
+      boost::archive::binary_oarchive ar(stream);
+      ar << knn;
+    }
+    KNN serialized;
+    {
+      boost::archive::binary_iarchive ar(stream);
+      ar >> serialized;
+    }
+    CheckMatrices(serialized.ReferenceSet(), knn.ReferenceSet());
+
+    remove("knn_index_test.bin");
+  }
+
+  // Neither a missing file nor a file in another format is accepted.
+  KNN knn;
+  BOOST_REQUIRE(!knn.LoadIndex("knn_index_test.bin"));
+
+  std::ofstream invalid("knn_index_test.bin");
+  invalid << "This is not an index, but it is long enough to have a header.";
+  invalid.close();
+  BOOST_REQUIRE(!knn.LoadIndex("knn_index_test.bin"));
+  remove("knn_index_test.bin");
+}
+
+/**
+ * The work counters of a search should match the counts of the search, and
+ * the pruning of the dual-tree search should show up in them.
+ */
+BOOST_AUTO_TEST_CASE(KNNWorkCountersTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE,
+      NAIVE_MODE };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    WorkCounters::Reset();
+    KNN knn(referenceData, modes[m]);
+    knn.Search(queryData, 3, neighbors, distances);
+
+    const WorkCounts counts = WorkCounters::Get("neighbor_search");
+    BOOST_REQUIRE_EQUAL(counts.distanceEvaluations, knn.BaseCases());
+    BOOST_REQUIRE_EQUAL(counts.nodeVisits, knn.Scores());
+    if (modes[m] == NAIVE_MODE)
+    {
+      BOOST_REQUIRE_EQUAL(counts.prunes, (size_t) 0);
+      BOOST_REQUIRE_EQUAL(counts.distanceEvaluations, (size_t) 500 * 100);
+    }
+    else
+    {
+      BOOST_REQUIRE_GT(counts.prunes, (size_t) 0);
+      BOOST_REQUIRE_LT(counts.distanceEvaluations, (size_t) 500 * 100);
+    }
+
+    // A second search is added to the counts.
+    knn.Search(queryData, 3, neighbors, distances);
+    BOOST_REQUIRE_EQUAL(WorkCounters::Get("neighbor_search").nodeVisits,
+        2 * counts.nodeVisits);
+  }
+
+  std::ostringstream oss;
+  WorkCounters::WriteJSON(oss);
+  const std::string expected = "\"neighbor_search\": "
+      "{\"distance_evaluations\": " + std::to_string(2 * 500 * 100);
+  BOOST_REQUIRE(oss.str().find(expected) != std::string::npos);
+
+  WorkCounters::Reset();
+  BOOST_REQUIRE(WorkCounters::GetAll().empty());
+}
+
+/**
+ * Make sure that the SpillSearchEngine returns, for every query, the exact
+ * nearest neighbors among the points of the leaf that the query is routed to.
+ */
+BOOST_AUTO_TEST_CASE(SpillSearchEngineLeafNeighborsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 500);
+
+  SpillSearchEngine<> engine(dataset, 0.05, 40);
+  BOOST_REQUIRE_GT(engine.NumLeaves(), 1);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  engine.Search(querySet, 5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, querySet.n_cols);
+
+  // The same tree, to route the queries by hand.
+  typedef SpillSearchEngine<>::Tree TreeType;
+  TreeType tree(dataset, 0.05, 40);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    TreeType* node = &tree;
+    while (!node->IsLeaf())
+    {
+      node = (node->GetNearestChild(querySet.col(i)) == 0) ? node->Left() :
+          node->Right();
+    }
+
+    std::vector<std::pair<double, size_t>> leafNeighbors;
+    for (size_t j = 0; j < node->NumPoints(); ++j)
+    {
+      leafNeighbors.push_back(std::make_pair(EuclideanDistance::Evaluate(
+          querySet.col(i), dataset.col(node->Point(j))), node->Point(j)));
+    }
+    std::sort(leafNeighbors.begin(), leafNeighbors.end());
+
+    for (size_t j = 0; j < 5; ++j)
+    {
+      if (j < leafNeighbors.size())
+      {
+        BOOST_REQUIRE_EQUAL(neighbors(j, i), leafNeighbors[j].second);
+        BOOST_REQUIRE_CLOSE(distances(j, i), leafNeighbors[j].first, 1e-5);
+      }
+      else
+      {
+        BOOST_REQUIRE_EQUAL(neighbors(j, i), size_t() - 1);
+        BOOST_REQUIRE_EQUAL(distances(j, i), DBL_MAX);
+      }
+    }
+  }
+}
+
+/**
+ * Keep the statistics of the tree nodes in a NeighborSearchStatTable, and make
+ * sure that dual-tree and single-tree searches give the naive results.
+ */
+BOOST_AUTO_TEST_CASE(IndexedStatisticVsNaive)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+  const size_t k = 5;
+  EuclideanDistance metric;
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighborsNaive, neighborsTree;
+  arma::mat distancesNaive, distancesTree;
+
+  // Monochromatic dual-tree search with a kd-tree.
+  typedef KDTree<EuclideanDistance, IndexedStatistic, arma::mat> KDTreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      KDTreeType> KDRuleType;
+
+  std::vector<size_t> oldFromNew;
+  KDTreeType kdTree(dataset, oldFromNew);
+  NeighborSearchStatTable<NearestNeighborSort> kdStats(IndexNodes(&kdTree));
+  BOOST_REQUIRE_EQUAL(kdTree.Stat().Index(), 0);
+  BOOST_REQUIRE_EQUAL(kdTree.Child(0).Stat().Index(), 1);
+  BOOST_REQUIRE_GT(kdTree.Child(1).Stat().Index(), 1);
+  BOOST_REQUIRE_LT(kdTree.Child(1).Stat().Index(), kdStats.Nodes());
+
+  KDRuleType kdRules(kdTree.Dataset(), kdTree.Dataset(), k, metric, 0, true);
+  kdRules.QueryStats() = &kdStats;
+  kdRules.ReferenceStats() = &kdStats;
+  KDTreeType::DualTreeTraverser<KDRuleType> dualTraverser(kdRules);
+  dualTraverser.Traverse(kdTree, kdTree);
+  kdRules.GetResults(neighborsTree, distancesTree);
+
+  naive.Search(k, neighborsNaive, distancesNaive);
+  for (size_t i = 0; i < neighborsTree.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(oldFromNew[neighborsTree(j, i)],
+          neighborsNaive(j, oldFromNew[i]));
+      BOOST_REQUIRE_CLOSE(distancesTree(j, i),
+          distancesNaive(j, oldFromNew[i]), 1e-5);
+    }
+  }
+
+  // Single-tree search with a cover tree, which caches the last distance of
+  // the reference nodes.
+  typedef StandardCoverTree<EuclideanDistance, IndexedStatistic, arma::mat>
+      CoverTreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      CoverTreeType> CoverRuleType;
+
+  CoverTreeType coverTree(dataset);
+  NeighborSearchStatTable<NearestNeighborSort> coverStats(
+      IndexNodes(&coverTree));
+
+  CoverRuleType coverRules(coverTree.Dataset(), querySet, k, metric);
+  coverRules.ReferenceStats() = &coverStats;
+  CoverTreeType::SingleTreeTraverser<CoverRuleType> singleTraverser(
+      coverRules);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    singleTraverser.Traverse(i, coverTree);
+  coverRules.GetResults(neighborsTree, distancesTree);
+
+  naive.Search(querySet, k, neighborsNaive, distancesNaive);
+  CheckMatrices(neighborsTree, neighborsNaive);
+  CheckMatrices(distancesTree, distancesNaive);
+  BOOST_REQUIRE_GT(coverRules.CacheHits(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -19,6 +19,7 @@
 
 #include <mlpack/methods/rann/ra_search.hpp>
 #include <mlpack/methods/rann/ra_model.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 using namespace std;
 using namespace mlpack;
@@ -715,4 +716,44 @@ BOOST_AUTO_TEST_CASE(RAModelTest)
   }
 }
 
+// Make sure that parallel rank-approximate search does not depend on the number
+// of threads, and that parallel naive search with one dataset is exact.
+BOOST_AUTO_TEST_CASE(ParallelSearchTest)
+{
+  const size_t oldThreads = Threads::Count();
+
+  arma::mat dataset(5, 1000);
+  dataset.randn();
+  arma::mat queries(5, 500);
+  queries.randn();
+
+  RASearch<> single(dataset, false, true);
+
+  // Each batch of query points samples from its own stream, so the same seed
+  // gives the same results with any number of threads.
+  arma::Mat<size_t> neighbors1, neighbors2;
+  arma::mat distances1, distances2;
+  Threads::SetCount(2);
+  math::RandomSeed(42);
+  single.Search(queries, 3, neighbors1, distances1);
+  Threads::SetCount(4);
+  math::RandomSeed(42);
+  single.Search(queries, 3, neighbors2, distances2);
+
+  CheckMatrices(neighbors1, neighbors2);
+  CheckMatrices(distances1, distances2);
+
+  // The naive search with one dataset computes every distance.
+  RASearch<> naive(dataset, true);
+  naive.Search(3, neighbors1, distances1);
+
+  KNN knn(dataset, NAIVE_MODE);
+  knn.Search(3, neighbors2, distances2);
+
+  CheckMatrices(neighbors1, neighbors2);
+  CheckMatrices(distances1, distances2);
+
+  Threads::SetCount(oldThreads);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -352,4 +352,38 @@ BOOST_AUTO_TEST_CASE(TrainingConstructorWithNonDefaultsTest)
     BOOST_REQUIRE_CLOSE(beta[i], lars2.Beta()[i], 1e-5);
 }
 
+/**
+ * Training without a Gram matrix (so that only the Gram matrix of the active
+ * variables is computed) should give the same solution as training with a
+ * precalculated Gram matrix, with any number of threads.
+ */
+BOOST_AUTO_TEST_CASE(ActiveGramMatrixTest)
+{
+  arma::mat X;
+  arma::rowvec y;
+  GenerateProblem(X, y, 200, 3000);
+  const arma::mat gram = X * X.t();
+
+  const size_t threads = Threads::Count();
+  for (const bool useCholesky : { false, true })
+  {
+    for (const double lambda2 : { 0.0, 0.1 })
+    {
+      Threads::SetCount(1);
+      LARS lars1(useCholesky, gram, 0.5, lambda2);
+      arma::vec beta1;
+      lars1.Train(X, y, beta1);
+
+      Threads::SetCount(4);
+      LARS lars2(useCholesky, 0.5, lambda2);
+      arma::vec beta2;
+      lars2.Train(X, y, beta2);
+
+      CheckMatrices(beta1, beta2, 1e-4);
+    }
+  }
+
+  Threads::SetCount(threads);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -16,12 +16,15 @@
 #include <mlpack/core/optimizers/problems/rosenbrock_function.hpp>
 #include <mlpack/core/optimizers/problems/rosenbrock_wood_function.hpp>
 #include <mlpack/core/optimizers/problems/colville_function.hpp>
+#include <mlpack/core/optimizers/function/parallel_decomposable_function.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression_function.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
 using namespace mlpack::optimization;
 using namespace mlpack::optimization::test;
+using namespace mlpack::regression;
 
 BOOST_AUTO_TEST_SUITE(LBFGSTest);
 
@@ -137,4 +140,55 @@ BOOST_AUTO_TEST_CASE(RosenbrockWoodFunctionTest)
   }
 }
 
+/**
+ * Make sure that evaluating several line search trials at once follows the
+ * same path as the serial line search.
+ */
+BOOST_AUTO_TEST_CASE(SpeculativeLineSearchTest)
+{
+  GeneralizedRosenbrockFunction f(64);
+  L_BFGS lbfgs(20);
+  L_BFGS speculativeLbfgs(20);
+  speculativeLbfgs.SpeculativeTrials() = 4;
+
+  arma::mat coords = f.GetInitialPoint();
+  arma::mat speculativeCoords = coords;
+  const double objective = lbfgs.Optimize(f, coords);
+  const double speculativeObjective = speculativeLbfgs.Optimize(f,
+      speculativeCoords);
+
+  BOOST_REQUIRE_SMALL(speculativeObjective, 1e-5);
+  BOOST_REQUIRE_EQUAL(speculativeObjective, objective);
+  for (size_t i = 0; i < coords.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(speculativeCoords[i], coords[i]);
+}
+
+/**
+ * Optimize a logistic regression function wrapped in a
+ * ParallelDecomposableFunction with L-BFGS, and make sure the result matches
+ * the unwrapped function.
+ */
+BOOST_AUTO_TEST_CASE(ParallelLogisticRegressionLBFGSTest)
+{
+  arma::mat data(10, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    labels[i] = (arma::accu(data.col(i)) > 5.0) ? 1 : 0;
+
+  LogisticRegressionFunction<> lrf(data, labels, 0.5);
+  ParallelDecomposableFunction<LogisticRegressionFunction<>> parallelLrf(lrf,
+      16);
+
+  L_BFGS lbfgs;
+  arma::mat coords = lrf.InitialPoint();
+  arma::mat parallelCoords = coords;
+  const double objective = lbfgs.Optimize(lrf, coords);
+  const double parallelObjective = lbfgs.Optimize(parallelLrf,
+      parallelCoords);
+
+  BOOST_REQUIRE_CLOSE(parallelObjective, objective, 1e-3);
+  for (size_t i = 0; i < coords.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(parallelCoords[i], coords[i], 1e-2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -289,4 +289,96 @@ BOOST_AUTO_TEST_CASE(TestSymKronId)
   }
 }
 
+/**
+ * Make sure the blocked TSQR decomposition gives an orthonormal Q and an upper
+ * triangular R that reconstruct the matrix.
+ */
+BOOST_AUTO_TEST_CASE(TestTSQR)
+{
+  const arma::mat x = arma::randn<arma::mat>(1000, 7);
+
+  arma::mat q, r;
+  BOOST_REQUIRE(TSQR(x, q, r, 8));
+
+  BOOST_REQUIRE_EQUAL(q.n_rows, 1000);
+  BOOST_REQUIRE_EQUAL(q.n_cols, 7);
+  BOOST_REQUIRE_EQUAL(r.n_rows, 7);
+  BOOST_REQUIRE_EQUAL(r.n_cols, 7);
+
+  BOOST_REQUIRE_SMALL(arma::norm(q * r - x, "fro"), 1e-8);
+  BOOST_REQUIRE_SMALL(arma::norm(q.t() * q - arma::eye<arma::mat>(7, 7),
+      "fro"), 1e-8);
+  BOOST_REQUIRE_SMALL(arma::norm(arma::trimatl(r, -1), "fro"), 1e-12);
+}
+
+/**
+ * Make sure the sparse products match the dense ones.
+ */
+BOOST_AUTO_TEST_CASE(TestSparseMultiply)
+{
+  const arma::sp_mat x = arma::sprandu<arma::sp_mat>(300, 200, 0.05);
+  const arma::mat dense(x);
+  const arma::mat y = arma::randu<arma::mat>(200, 6);
+  const arma::mat z = arma::randu<arma::mat>(300, 6);
+
+  arma::mat product, transposeProduct;
+  Multiply(x, y, product);
+  TransposeMultiply(x, z, transposeProduct);
+
+  BOOST_REQUIRE_SMALL(arma::norm(product - dense * y, "fro"), 1e-10);
+  BOOST_REQUIRE_SMALL(arma::norm(transposeProduct - dense.t() * z, "fro"),
+      1e-10);
+}
+
+/**
+ * Make sure that the blocked covariance matches ccov() for dense and sparse
+ * matrices, and that the in-place variants match the copying ones.
+ */
+BOOST_AUTO_TEST_CASE(TestCovarianceInPlace)
+{
+  // Enough points for several blocks of columns, away from the origin.
+  mat data = randu<mat>(5, 10000) + 10.0;
+  sp_mat sparseData = sprandu<sp_mat>(5, 10000, 0.2);
+
+  vec mean;
+  mat covariance;
+  Covariance(data, mean, covariance);
+  CheckMatrices(mean, arma::mean(data, 1));
+  CheckMatrices(covariance, ccov(data));
+
+  vec sparseMean;
+  mat sparseCovariance;
+  Covariance(sparseData, sparseMean, sparseCovariance);
+  const mat denseData(sparseData);
+  CheckMatrices(sparseMean, arma::mean(denseData, 1));
+  CheckMatrices(sparseCovariance, ccov(denseData));
+
+  // Centering in place gives the same result as centering into a copy.
+  mat centered;
+  Center(data, centered);
+  mat inPlace(data);
+  Center(inPlace);
+  CheckMatrices(inPlace, centered);
+  BOOST_REQUIRE_SMALL(arma::max(arma::abs(arma::mean(inPlace, 1))), 1e-10);
+
+  // Sparse and dense whitening give the same whitening matrix (the signs of
+  // the eigenvectors cancel out in the SVD version), and the whitened data
+  // has unit covariance.
+  mat whitened, whiteningMatrix, sparseWhitened, sparseWhiteningMatrix;
+  WhitenUsingSVD(denseData, whitened, whiteningMatrix);
+  WhitenUsingSVD(sparseData, sparseWhitened, sparseWhiteningMatrix);
+  CheckMatrices(sparseWhiteningMatrix, whiteningMatrix);
+  CheckMatrices(sparseWhitened, whitened);
+  CheckMatrices(ccov(sparseWhitened), eye<mat>(5, 5));
+
+  WhitenUsingEig(sparseData, sparseWhitened, sparseWhiteningMatrix);
+  CheckMatrices(ccov(sparseWhitened), eye<mat>(5, 5));
+
+  // Orthogonalizing in place gives the same result as into a copy.
+  mat orth;
+  Orthogonalize(data, orth);
+  Orthogonalize(data);
+  CheckMatrices(data, orth);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
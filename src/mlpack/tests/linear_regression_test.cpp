@@ -199,4 +199,105 @@ BOOST_AUTO_TEST_CASE(LinearRegressionTrainTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrTrain.Parameters()[i], 1e-5);
 }
 
+/**
+ * Make sure that training on many blocks of points in parallel, with and
+ * without weights, gives the solution of the dense normal equations.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionBlockTest)
+{
+  const size_t oldThreads = Threads::Count();
+  Threads::SetCount(4);
+
+  arma::mat dataset = arma::randu<arma::mat>(6, 20000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(20000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(20000);
+
+  // The dense solution, with a row of ones for the intercept.
+  arma::mat p = arma::join_cols(arma::ones<arma::rowvec>(20000), dataset);
+  const arma::mat wp = p.each_row() % weights;
+  const arma::vec expected = arma::solve(p * p.t(), p * responses.t());
+  const arma::vec expectedWeighted = arma::solve(
+      wp * p.t() + 0.1 * arma::eye<arma::mat>(7, 7), wp * responses.t());
+
+  LinearRegression lr(dataset, responses);
+  LinearRegression lrWeighted(dataset, responses, weights, 0.1);
+
+  Threads::SetCount(oldThreads);
+
+  BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, 7);
+  BOOST_REQUIRE_EQUAL(lrWeighted.Parameters().n_elem, 7);
+  for (size_t i = 0; i < 7; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], expected[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(lrWeighted.Parameters()[i], expectedWeighted[i],
+        1e-5);
+  }
+}
+
+/**
+ * Make sure that training from a ChunkedReader gives the same model as
+ * training on the whole dataset.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionChunkedTrainTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1000);
+  arma::rowvec responses = 2.0 * dataset.row(0) - dataset.row(3) + 0.5 +
+      0.01 * arma::randn<arma::rowvec>(1000);
+
+  const arma::mat points = arma::join_cols(dataset, responses);
+  data::Save("linreg_chunks.bin", points);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const bool intercept = (i == 0);
+    LinearRegression lr(dataset, responses, 0.0, intercept);
+
+    data::ChunkedReader<> reader("linreg_chunks.bin", 77);
+    LinearRegression lrChunked;
+    lrChunked.Train(reader, intercept);
+
+    BOOST_REQUIRE_EQUAL(lrChunked.Intercept(), intercept);
+    BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, lrChunked.Parameters().n_elem);
+    for (size_t j = 0; j < lr.Parameters().n_elem; ++j)
+      BOOST_REQUIRE_CLOSE(lr.Parameters()[j], lrChunked.Parameters()[j], 1e-5);
+  }
+
+  remove("linreg_chunks.bin");
+}
+
+/**
+ * Make sure that training on points that hold their responses in one of their
+ * dimensions gives the same model as training on separate predictors.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionResponseDimensionTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1000);
+  arma::rowvec responses = 2.0 * dataset.row(0) - dataset.row(3) + 0.5 +
+      0.01 * arma::randn<arma::rowvec>(1000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(1000);
+
+  // Put the responses in the middle of the points.
+  const arma::mat points = arma::join_cols(arma::join_cols(
+      dataset.rows(0, 1), responses), dataset.rows(2, 3));
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const bool intercept = (i == 0);
+    LinearRegression lr(dataset, responses, weights, 0.0, intercept);
+
+    LinearRegression lrPoints;
+    lrPoints.Train(points, 2, weights, intercept);
+
+    BOOST_REQUIRE_EQUAL(lrPoints.Intercept(), intercept);
+    BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, lrPoints.Parameters().n_elem);
+    for (size_t j = 0; j < lr.Parameters().n_elem; ++j)
+      BOOST_REQUIRE_CLOSE(lr.Parameters()[j], lrPoints.Parameters()[j], 1e-5);
+  }
+
+  // The response dimension must be a dimension of the points.
+  LinearRegression lrInvalid;
+  BOOST_REQUIRE_THROW(lrInvalid.Train(points, 5, weights),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -101,6 +101,50 @@ BOOST_AUTO_TEST_CASE(LMNNImpostorsTest)
   BOOST_REQUIRE_EQUAL(impostors(0, 5), 2);
 }
 
+/**
+ * Impostors computed with the cached (refitted or rebuilt) trees after the
+ * dataset is transformed should match those of a new Constraints object.
+ */
+BOOST_AUTO_TEST_CASE(LMNNCachedImpostorsTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  data::Load("iris.csv", dataset);
+  data::Load("iris_labels.txt", labels);
+
+  const size_t threads = Threads::Count();
+  Threads::SetCount(4);
+
+  Constraints<> constraint(dataset, labels, 3);
+  arma::Mat<size_t> impostors(3, dataset.n_cols);
+  arma::mat distances(3, dataset.n_cols);
+  arma::vec norm = arma::sqrt(arma::sum(arma::square(dataset), 0)).t();
+  constraint.Impostors(impostors, distances, dataset, labels, norm);
+
+  // A small change refits the trees; a large change rebuilds them.
+  for (const double scale : { 0.01, 0.5 })
+  {
+    arma::mat transformation = arma::eye(dataset.n_rows, dataset.n_rows) +
+        scale * arma::randu(dataset.n_rows, dataset.n_rows);
+    arma::mat transformedDataset = transformation * dataset;
+    norm = arma::sqrt(arma::sum(arma::square(transformedDataset), 0)).t();
+
+    constraint.Impostors(impostors, distances, transformedDataset, labels,
+        norm);
+
+    Constraints<> freshConstraint(transformedDataset, labels, 3);
+    arma::Mat<size_t> freshImpostors(3, dataset.n_cols);
+    arma::mat freshDistances(3, dataset.n_cols);
+    freshConstraint.Impostors(freshImpostors, freshDistances,
+        transformedDataset, labels, norm);
+
+    CheckMatrices(impostors, freshImpostors);
+    CheckMatrices(distances, freshDistances);
+  }
+
+  Threads::SetCount(threads);
+}
+
 //
 // Tests for the LMNNFunction
 //
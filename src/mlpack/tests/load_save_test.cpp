@@ -12,12 +12,17 @@
 #include <sstream>
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/chunked_reader.hpp>
 #include <mlpack/core/data/load_arff.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
+#ifdef HAS_ZLIB
+  #include <zlib.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::data;
 using namespace std;
@@ -883,6 +888,50 @@ BOOST_AUTO_TEST_CASE(LoadBinaryTest)
   BOOST_REQUIRE_EQUAL(y.inb.s, x.inb.s);
 }
 
+/**
+ * Make sure that binary models start with the header, that models saved
+ * without one still load, and that models from incompatible platforms are
+ * rejected.
+ */
+BOOST_AUTO_TEST_CASE(BinaryModelHeaderTest)
+{
+  Test x(10, 12);
+  BOOST_REQUIRE_EQUAL(data::Save("test.bin", "x", x, false), true);
+
+  std::ifstream input("test.bin", std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(input)),
+      std::istreambuf_iterator<char>());
+  input.close();
+  BOOST_REQUIRE_GT(contents.size(), sizeof(data::details::ModelHeader));
+  BOOST_REQUIRE_EQUAL(contents.substr(0, 8), "MLPKMODL");
+
+  // A model written without the header, like older versions of mlpack did.
+  {
+    std::ofstream output("test_old.bin", std::ios::binary);
+    boost::archive::binary_oarchive ar(output);
+    ar << boost::serialization::make_nvp("x", x);
+  }
+
+  Test y(11, 14);
+  BOOST_REQUIRE_EQUAL(data::Load("test_old.bin", "x", y, false), true);
+  BOOST_REQUIRE_EQUAL(y.x, x.x);
+  BOOST_REQUIRE_EQUAL(y.inb.s, x.inb.s);
+
+  // Change the byte order in the header.
+  const uint32_t byteOrder = 0x04030201;
+  contents.replace(12, 4, (const char*) &byteOrder, 4);
+  std::ofstream output("test.bin", std::ios::binary);
+  output.write(contents.data(), contents.size());
+  output.close();
+
+  Test z(11, 14);
+  BOOST_REQUIRE_EQUAL(data::Load("test.bin", "x", z, false), false);
+  BOOST_REQUIRE_EQUAL(z.x, 11);
+
+  remove("test.bin");
+  remove("test_old.bin");
+}
+
 /**
  * Make sure we can load and save.
  */
@@ -1054,6 +1103,386 @@ BOOST_AUTO_TEST_CASE(NontransposedCSVDatasetInfoLoad)
   }
 }
 
+/**
+ * Load a CSV large enough to be split into several chunks, with numeric and
+ * categorical dimensions and no newline at the end, and make sure the mappings
+ * follow the order of the file.
+ */
+BOOST_AUTO_TEST_CASE(LargeMixedCSVDatasetInfoLoad)
+{
+  const char* categories[] = { "a", "b", "c" };
+
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    f << i << ", " << (0.5 * i) << ", " << categories[i % 3] << ", ";
+    if (i == 1500)
+      f << "x";
+    else
+      f << i;
+
+    if (i != 2999)
+      f << endl;
+  }
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  data::Load("test.csv", matrix, info, true);
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 3000);
+
+  BOOST_REQUIRE(info.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(3) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 3);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(3), 3000);
+
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(matrix(0, i), (double) i);
+    BOOST_REQUIRE_EQUAL(matrix(1, i), 0.5 * i);
+    BOOST_REQUIRE_EQUAL(matrix(2, i), (double) (i % 3));
+    // Each token of the last dimension is new, so it gets the next mapping.
+    BOOST_REQUIRE_EQUAL(matrix(3, i), (double) i);
+  }
+
+  BOOST_REQUIRE_EQUAL(info.UnmapString(1500, 3), "x");
+
+  remove("test.csv");
+}
+
+#ifdef HAS_ZLIB
+
+/**
+ * Make sure that a gzip-compressed CSV loads the same as the uncompressed one,
+ * with and without a DatasetInfo.
+ */
+BOOST_AUTO_TEST_CASE(LoadGzipCSVTest)
+{
+  std::ostringstream oss;
+  for (size_t i = 0; i < 5000; ++i)
+    oss << i << ", " << (0.25 * i) << ", " << ((i % 3 == 0) ? "a" : "b")
+        << "\n";
+  const std::string contents = oss.str();
+
+  gzFile file = gzopen("test.csv.gz", "wb");
+  BOOST_REQUIRE(file != NULL);
+  gzwrite(file, contents.data(), (unsigned int) contents.size());
+  gzclose(file);
+
+  arma::mat matrix;
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test.csv.gz", matrix, info, true));
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 5000);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(matrix(0, i), (double) i);
+    BOOST_REQUIRE_EQUAL(matrix(1, i), 0.25 * i);
+    BOOST_REQUIRE_EQUAL(matrix(2, i), (i % 3 == 0) ? 0.0 : 1.0);
+  }
+
+  // Without a DatasetInfo, the dataset must be numeric.
+  arma::mat numeric = matrix.rows(0, 1);
+  data::Save("test.csv", numeric);
+  std::ifstream input("test.csv");
+  const std::string numericContents((std::istreambuf_iterator<char>(input)),
+      std::istreambuf_iterator<char>());
+  file = gzopen("test.csv.gz", "wb");
+  gzwrite(file, numericContents.data(), (unsigned int) numericContents.size());
+  gzclose(file);
+
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test.csv.gz", loaded, true));
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, 5000);
+  for (size_t i = 0; i < loaded.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(loaded[i], numeric[i], 1e-5);
+
+  remove("test.csv");
+  remove("test.csv.gz");
+}
+
+#endif
+
+/**
+ * Save a dataset with categorical dimensions to a columnar file, and make sure
+ * that loading it gives back the same matrix, types and mappings.
+ */
+BOOST_AUTO_TEST_CASE(SaveLoadColumnarTest)
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < 10000; ++i)
+    f << (0.5 * i) << ", " << ((i % 4 == 0) ? "red" : "blue") << ", " << i
+        << ", t" << (i % 13) << endl;
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test.csv", matrix, info, true));
+  BOOST_REQUIRE(data::Save("test.mlcol", matrix, info, true));
+
+  arma::mat loaded;
+  DatasetInfo loadedInfo;
+  BOOST_REQUIRE(data::Load("test.mlcol", loaded, loadedInfo, true));
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, matrix.n_rows);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, matrix.n_cols);
+  for (size_t i = 0; i < matrix.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(loaded[i], matrix[i]);
+
+  BOOST_REQUIRE_EQUAL(loadedInfo.Dimensionality(), 4);
+  for (size_t d = 0; d < 4; ++d)
+  {
+    BOOST_REQUIRE(loadedInfo.Type(d) == info.Type(d));
+    BOOST_REQUIRE_EQUAL(loadedInfo.NumMappings(d), info.NumMappings(d));
+  }
+  BOOST_REQUIRE(loadedInfo.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(loadedInfo.UnmapString(0, 1), info.UnmapString(0, 1));
+  BOOST_REQUIRE_EQUAL(loadedInfo.UnmapString(1, 1), info.UnmapString(1, 1));
+  for (size_t v = 0; v < 13; ++v)
+    BOOST_REQUIRE_EQUAL(loadedInfo.UnmapString(v, 3),
+        info.UnmapString(v, 3));
+
+  // Without a DatasetInfo, only the values are loaded.
+  arma::mat values;
+  BOOST_REQUIRE(data::Load("test.mlcol", values, true));
+  BOOST_REQUIRE_EQUAL(values.n_rows, matrix.n_rows);
+  BOOST_REQUIRE_EQUAL(values.n_cols, matrix.n_cols);
+  for (size_t i = 0; i < matrix.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(values[i], matrix[i]);
+
+  remove("test.csv");
+  remove("test.mlcol");
+}
+
+/**
+ * Make sure that LoadDimensions() loads only the requested dimensions of a
+ * columnar file, in the requested order, with their mappings.
+ */
+BOOST_AUTO_TEST_CASE(LoadColumnarDimensionsTest)
+{
+  arma::fmat matrix(6, 500, arma::fill::randu);
+  matrix.row(4) = arma::floor(3 * matrix.row(4));
+  DatasetInfo info(6);
+  info.Type(4) = Datatype::categorical;
+  info.MapString<size_t>("low", 4);
+  info.MapString<size_t>("medium", 4);
+  info.MapString<size_t>("high", 4);
+  BOOST_REQUIRE(data::Save("test.mlcol", matrix, info, true));
+
+  std::vector<size_t> dimensions;
+  dimensions.push_back(4);
+  dimensions.push_back(1);
+  arma::fmat loaded;
+  DatasetInfo loadedInfo;
+  BOOST_REQUIRE(data::LoadDimensions("test.mlcol", loaded, loadedInfo,
+      dimensions, true));
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, 500);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(loaded(0, i), matrix(4, i));
+    BOOST_REQUIRE_EQUAL(loaded(1, i), matrix(1, i));
+  }
+
+  BOOST_REQUIRE_EQUAL(loadedInfo.Dimensionality(), 2);
+  BOOST_REQUIRE(loadedInfo.Type(0) == Datatype::categorical);
+  BOOST_REQUIRE(loadedInfo.Type(1) == Datatype::numeric);
+  BOOST_REQUIRE_EQUAL(loadedInfo.UnmapString(2, 0), "high");
+
+  // A dimension that isn't in the file is an error.
+  dimensions.push_back(6);
+  BOOST_REQUIRE(!data::LoadDimensions("test.mlcol", loaded, loadedInfo,
+      dimensions));
+
+  remove("test.mlcol");
+}
+
+/**
+ * Make sure that categorical values repeated across the whole of a large CSV
+ * are mapped in the order of their first appearance, and consistently.
+ */
+BOOST_AUTO_TEST_CASE(LargeRepeatedCategoriesCSVLoad)
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < 20000; ++i)
+    f << "c" << (i % 7) << ", " << i << ", x" << ((3 * i) % 11) << endl;
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  data::Load("test.csv", matrix, info, true);
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 20000);
+  BOOST_REQUIRE(info.Type(0) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(1) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(0), 7);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 11);
+
+  // The first eleven points hold the values of the last dimension in their
+  // order of first appearance.
+  for (size_t i = 0; i < 11; ++i)
+  {
+    std::ostringstream oss;
+    oss << "x" << ((3 * i) % 11);
+    BOOST_REQUIRE_EQUAL(info.UnmapString(i, 2), oss.str());
+  }
+
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(matrix(0, i), (double) (i % 7));
+    BOOST_REQUIRE_EQUAL(matrix(1, i), (double) i);
+    BOOST_REQUIRE_EQUAL(matrix(2, i), (double) (i % 11));
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure that reading a CSV with categorical dimensions in chunks gives the
+ * same points and mappings as data::Load(), on every pass.
+ */
+BOOST_AUTO_TEST_CASE(ChunkedReaderCSVTest)
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < 100; ++i)
+    f << i << ", " << ((i % 4 == 0) ? "hello" : "goodbye") << ", " << (i % 7)
+        << endl;
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  data::Load("test.csv", matrix, info, true);
+
+  data::ChunkedReader<> reader("test.csv", 7);
+  BOOST_REQUIRE_EQUAL(reader.Dimensionality(), 3);
+  BOOST_REQUIRE(reader.Info().Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(reader.Info().Type(1) == Datatype::categorical);
+  BOOST_REQUIRE(reader.Info().Type(2) == Datatype::numeric);
+
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    reader.Reset();
+    arma::mat chunk;
+    size_t points = 0;
+    while (reader.NextChunk(chunk))
+    {
+      BOOST_REQUIRE_LE(chunk.n_cols, 7);
+      BOOST_REQUIRE_EQUAL(chunk.n_rows, 3);
+      for (size_t i = 0; i < chunk.n_cols; ++i)
+        for (size_t d = 0; d < 3; ++d)
+          BOOST_REQUIRE_EQUAL(chunk(d, i), matrix(d, points + i));
+
+      points += chunk.n_cols;
+    }
+
+    BOOST_REQUIRE_EQUAL(points, 100);
+  }
+
+  BOOST_REQUIRE_EQUAL(reader.Info().NumMappings(1), 2);
+  BOOST_REQUIRE_EQUAL(reader.Info().UnmapString(0, 1), "hello");
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure that a matrix saved with data::Save() can be loaded into mapped
+ * memory, and that the mapped elements are used in place.
+ */
+BOOST_AUTO_TEST_CASE(LoadMappedMatrixTest)
+{
+  arma::mat dataset(7, 50, arma::fill::randu);
+  data::Save("test.bin", dataset, true, false);
+
+  data::MappedFile mapping;
+  arma::mat matrix;
+  BOOST_REQUIRE(data::LoadMapped("test.bin", matrix, mapping));
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 7);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 50);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(matrix[i], dataset[i]);
+
+  // The elements must be inside the mapping.
+  const char* memory = (const char*) matrix.memptr();
+  BOOST_REQUIRE(memory >= mapping.Data());
+  BOOST_REQUIRE(memory + matrix.n_elem * sizeof(double) <=
+      mapping.Data() + mapping.Size());
+
+  // The regular loader must still read the padded header.
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test.bin", loaded, true, false));
+  BOOST_REQUIRE_EQUAL(accu(loaded != dataset), 0);
+
+  remove("test.bin");
+}
+
+/**
+ * Load a vector into mapped memory, from a file that holds it as a row.
+ */
+BOOST_AUTO_TEST_CASE(LoadMappedVectorTest)
+{
+  arma::rowvec row(20, arma::fill::randu);
+  data::Save("test.bin", row, true, false);
+
+  data::MappedFile mapping;
+  arma::vec vec;
+  BOOST_REQUIRE(data::LoadMapped("test.bin", vec, mapping));
+  BOOST_REQUIRE_EQUAL(vec.n_elem, 20);
+  for (size_t i = 0; i < row.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(vec[i], row[i]);
+
+  // A matrix isn't a vector.
+  arma::mat dataset(3, 4, arma::fill::randu);
+  data::Save("test.bin", dataset, true, false);
+  data::MappedFile otherMapping;
+  arma::rowvec rowvec;
+  Log::Warn.ignoreInput = true;
+  BOOST_REQUIRE(!data::LoadMapped("test.bin", rowvec, otherMapping));
+  Log::Warn.ignoreInput = false;
+
+  remove("test.bin");
+}
+
+/**
+ * Make sure that reading an Armadillo binary file in chunks gives the saved
+ * points.
+ */
+BOOST_AUTO_TEST_CASE(ChunkedReaderBinaryTest)
+{
+  arma::mat dataset(5, 100, arma::fill::randu);
+  data::Save("test.bin", dataset);
+
+  data::ChunkedReader<> reader("test.bin", 13);
+  BOOST_REQUIRE_EQUAL(reader.Dimensionality(), 5);
+
+  arma::mat chunk;
+  size_t points = 0;
+  while (reader.NextChunk(chunk))
+  {
+    BOOST_REQUIRE_LE(chunk.n_cols, 13);
+    for (size_t i = 0; i < chunk.n_cols; ++i)
+      for (size_t d = 0; d < 5; ++d)
+        BOOST_REQUIRE_EQUAL(chunk(d, i), dataset(d, points + i));
+
+    points += chunk.n_cols;
+  }
+
+  BOOST_REQUIRE_EQUAL(points, 100);
+
+  remove("test.bin");
+}
+
 /**
  * Create a file with a categorical string feature, then load it.
  */
@@ -1994,4 +2423,92 @@ BOOST_AUTO_TEST_CASE(DatasetMapperNonUniqueTest)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(nan, 0, 2), "cheese");
 }
 
+/**
+ * Make sure that a libsvm file is loaded with the right points and labels, and
+ * that saving it gives the same file back.
+ */
+BOOST_AUTO_TEST_CASE(LoadLibSVMTest)
+{
+  std::fstream f;
+  f.open("test.svm", std::fstream::out);
+  f << "1 1:0.5 3:-2" << std::endl;
+  f << "# A comment." << std::endl;
+  f << "-1 qid:3 2:1e-3 # Another comment." << std::endl;
+  f << "2" << std::endl;
+  f << "0 4:7";
+  f.close();
+
+  arma::sp_mat matrix;
+  arma::Row<int> labels;
+  BOOST_REQUIRE(data::LoadLibSVM("test.svm", matrix, labels));
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 4);
+  BOOST_REQUIRE_EQUAL(matrix.n_nonzero, 4);
+  BOOST_REQUIRE_CLOSE(matrix(0, 0), 0.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(matrix(2, 0), -2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(matrix(1, 1), 1e-3, 1e-5);
+  BOOST_REQUIRE_CLOSE(matrix(3, 3), 7.0, 1e-5);
+
+  BOOST_REQUIRE_EQUAL(labels.n_elem, 4);
+  BOOST_REQUIRE_EQUAL(labels[0], 1);
+  BOOST_REQUIRE_EQUAL(labels[1], -1);
+  BOOST_REQUIRE_EQUAL(labels[2], 2);
+  BOOST_REQUIRE_EQUAL(labels[3], 0);
+
+  // Load() gives the same points.
+  arma::sp_mat points;
+  BOOST_REQUIRE(data::Load("test.svm", points));
+  BOOST_REQUIRE_EQUAL(arma::accu(points != matrix), 0);
+
+  BOOST_REQUIRE(data::SaveLibSVM("test.svm", matrix, labels));
+  arma::sp_mat savedMatrix;
+  arma::Row<int> savedLabels;
+  BOOST_REQUIRE(data::LoadLibSVM("test.svm", savedMatrix, savedLabels));
+  BOOST_REQUIRE_EQUAL(arma::accu(savedMatrix != matrix), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(savedLabels != labels), 0);
+
+  // An index must be positive.
+  f.open("test.svm", std::fstream::out);
+  f << "1 0:1.0" << std::endl;
+  f.close();
+  Log::Warn.ignoreInput = true;
+  BOOST_REQUIRE(!data::LoadLibSVM("test.svm", matrix, labels));
+  Log::Warn.ignoreInput = false;
+
+  remove("test.svm");
+}
+
+/**
+ * Make sure that a large sparse matrix survives saving and loading as a
+ * coordinate list, with and without transposing.
+ */
+BOOST_AUTO_TEST_CASE(SaveLoadCoordinateListTest)
+{
+  arma::sp_mat matrix;
+  matrix.sprandu(300, 5000, 0.01);
+  matrix(299, 4999) = 0.0;
+
+  BOOST_REQUIRE(data::Save("test.coo", matrix));
+  arma::sp_mat loaded;
+  BOOST_REQUIRE(data::Load("test.coo", loaded));
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, matrix.n_rows);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, matrix.n_cols);
+  BOOST_REQUIRE_EQUAL(loaded.n_nonzero, matrix.n_nonzero);
+  BOOST_REQUIRE_EQUAL(arma::accu(loaded != matrix), 0);
+
+  // The rows of the file are the points.
+  arma::sp_mat transposed;
+  BOOST_REQUIRE(data::Load("test.coo", transposed, true, false));
+  BOOST_REQUIRE_EQUAL(transposed.n_rows, matrix.n_cols);
+  BOOST_REQUIRE_EQUAL(transposed.n_cols, matrix.n_rows);
+  BOOST_REQUIRE_EQUAL(arma::accu(transposed != matrix.t()), 0);
+
+  BOOST_REQUIRE(data::Save("test.coo", matrix, true, false));
+  BOOST_REQUIRE(data::Load("test.coo", loaded, true, false));
+  BOOST_REQUIRE_EQUAL(arma::accu(loaded != matrix), 0);
+
+  remove("test.coo");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -165,4 +165,29 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   BOOST_REQUIRE_EQUAL(lcc.MaxIterations(), lccBinary.MaxIterations());
 }
 
+/**
+ * Make sure that encoding the points in parallel gives the same codes as
+ * encoding them on one thread.
+ */
+BOOST_AUTO_TEST_CASE(LocalCoordinateCodingParallelEncodeTest)
+{
+  const size_t oldThreads = Threads::Count();
+
+  mat X;
+  X.load("mnist_first250_training_4s_and_9s.arm");
+  for (uword i = 0; i < X.n_cols; i++)
+    X.col(i) /= norm(X.col(i), 2);
+
+  LocalCoordinateCoding lcc(X, 10, 0.1, 2);
+
+  mat serialCodes, parallelCodes;
+  Threads::SetCount(1);
+  lcc.Encode(X, serialCodes);
+  Threads::SetCount(4);
+  lcc.Encode(X, parallelCodes);
+  Threads::SetCount(oldThreads);
+
+  CheckMatrices(serialCodes, parallelCodes);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -314,4 +314,63 @@ BOOST_AUTO_TEST_CASE(Keller4LovaszThetaSDP)
   }
 }*/
 
+/**
+ * Make sure the evaluation of the augmented Lagrangian of an LRSDP, which
+ * never forms R * R^T, matches the dense formulas, with both sparse and dense
+ * constraints.
+ */
+BOOST_AUTO_TEST_CASE(SparseAugLagrangianEvaluationTest)
+{
+  const size_t n = 20;
+  const size_t r = 3;
+
+  arma::mat coordinates(n, r, arma::fill::randn);
+  LRSDPFunction<SDP<arma::sp_mat>> f(15, 3, coordinates);
+
+  arma::sp_mat c = arma::sprandu<arma::sp_mat>(n, n, 0.1);
+  f.SDP().C() = c + c.t();
+  for (size_t i = 0; i < 15; ++i)
+  {
+    arma::sp_mat a = arma::sprandu<arma::sp_mat>(n, n, 0.05);
+    f.SDP().SparseA()[i] = a + a.t();
+    f.SDP().SparseB()[i] = math::Random();
+  }
+  for (size_t i = 0; i < 3; ++i)
+  {
+    arma::mat a(n, n, arma::fill::randu);
+    f.SDP().DenseA()[i] = a + a.t();
+    f.SDP().DenseB()[i] = math::Random();
+  }
+
+  const arma::vec lambda(18, arma::fill::randu);
+  const double sigma = 2.5;
+  AugLagrangianFunction<LRSDPFunction<SDP<arma::sp_mat>>> alf(f, lambda,
+      sigma);
+
+  // Compute the objective and the gradient with R * R^T.
+  const arma::mat rrt = coordinates * coordinates.t();
+  double objective = arma::accu(arma::mat(f.SDP().C()) % rrt);
+  arma::mat s(f.SDP().C());
+  for (size_t i = 0; i < 18; ++i)
+  {
+    const arma::mat a = (i < 15) ? arma::mat(f.SDP().SparseA()[i]) :
+        f.SDP().DenseA()[i - 15];
+    const double b = (i < 15) ? f.SDP().SparseB()[i] :
+        f.SDP().DenseB()[i - 15];
+    const double constraint = arma::accu(a % rrt) - b;
+    BOOST_REQUIRE_CLOSE(f.EvaluateConstraint(i, coordinates), constraint,
+        1e-8);
+
+    objective += -lambda[i] * constraint + (sigma / 2) * constraint *
+        constraint;
+    s -= (lambda[i] - sigma * constraint) * a;
+  }
+
+  BOOST_REQUIRE_CLOSE(alf.Evaluate(coordinates), objective, 1e-8);
+
+  arma::mat gradient;
+  alf.Gradient(coordinates, gradient);
+  CheckMatrices(gradient, 2 * s * coordinates, 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
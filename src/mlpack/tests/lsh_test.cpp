@@ -912,4 +912,126 @@ BOOST_AUTO_TEST_CASE(MoveOperatorTest)
   CheckMatrices(distances, distances2);
 }
 
+/**
+ * Make sure the tables built with several threads are the same as the tables
+ * built with one thread, and that the compact buckets respect the bucket size.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+  const size_t bucketSize = 50;
+
+  const size_t threads = Threads::Count();
+  Threads::SetCount(1);
+  math::RandomSeed(42);
+  LSHSearch<> sequentialLsh(dataset, 4, 12, 0.5, 99901, bucketSize);
+
+  Threads::SetCount(4);
+  math::RandomSeed(42);
+  LSHSearch<> parallelLsh(dataset, 4, 12, 0.5, 99901, bucketSize);
+  Threads::SetCount(threads);
+
+  const std::vector<arma::Col<size_t>> sequentialTable =
+      sequentialLsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> parallelTable =
+      parallelLsh.SecondHashTable();
+  BOOST_REQUIRE_EQUAL(sequentialTable.size(), parallelTable.size());
+  BOOST_REQUIRE_EQUAL(parallelLsh.BucketOffsets().n_elem,
+      parallelTable.size() + 1);
+
+  for (size_t i = 0; i < parallelTable.size(); ++i)
+  {
+    BOOST_REQUIRE_LE(parallelTable[i].n_elem, bucketSize);
+    BOOST_REQUIRE_GT(parallelTable[i].n_elem, 0);
+    CheckMatrices(sequentialTable[i], parallelTable[i]);
+  }
+
+  arma::Mat<size_t> sequentialNeighbors, parallelNeighbors;
+  arma::mat sequentialDistances, parallelDistances;
+  sequentialLsh.Search(3, sequentialNeighbors, sequentialDistances);
+  parallelLsh.Search(3, parallelNeighbors, parallelDistances);
+
+  CheckMatrices(sequentialNeighbors, parallelNeighbors);
+  CheckMatrices(sequentialDistances, parallelDistances);
+}
+
+/**
+ * Make sure that a model trained on part of a dataset, with the rest of the
+ * points inserted afterwards, gives the same results as a model trained on the
+ * whole dataset with the same hash functions.
+ */
+BOOST_AUTO_TEST_CASE(InsertTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1000);
+  arma::cube projections = arma::randn<arma::cube>(4, 3, 8);
+
+  // A bucket size of 0 means no limit, so no point is dropped from a bucket.
+  math::RandomSeed(7);
+  LSHSearch<> fullLsh(dataset, projections, 1.0, 99901, 0);
+  math::RandomSeed(7);
+  LSHSearch<> streamedLsh(dataset.cols(0, 499), projections, 1.0, 99901, 0);
+
+  for (size_t i = 0; i < 5; ++i)
+    streamedLsh.Insert(dataset.cols(500 + 100 * i, 599 + 100 * i));
+
+  BOOST_REQUIRE_EQUAL(streamedLsh.ReferenceSet().n_cols, 1000);
+
+  arma::Mat<size_t> neighbors, streamedNeighbors;
+  arma::mat distances, streamedDistances;
+  fullLsh.Search(3, neighbors, distances);
+  streamedLsh.Search(3, streamedNeighbors, streamedDistances);
+
+  CheckMatrices(neighbors, streamedNeighbors);
+  CheckMatrices(distances, streamedDistances);
+
+  // The results must not change when the inserted points are compacted.
+  streamedLsh.Compact();
+  BOOST_REQUIRE_EQUAL(streamedLsh.NumPending(), 0);
+  streamedLsh.Search(3, streamedNeighbors, streamedDistances);
+
+  CheckMatrices(neighbors, streamedNeighbors);
+  CheckMatrices(distances, streamedDistances);
+
+  // Points of the wrong dimensionality can't be inserted.
+  BOOST_REQUIRE_THROW(streamedLsh.Insert(arma::randu<arma::mat>(3, 10)),
+      std::invalid_argument);
+
+  // Neither can points be inserted into an untrained model.
+  LSHSearch<> emptyLsh;
+  BOOST_REQUIRE_THROW(emptyLsh.Insert(dataset), std::invalid_argument);
+}
+
+/**
+ * With a huge hash width every point falls into the same bucket, so LSH is
+ * exact.  Use more queries than one block of the batched search, and make sure
+ * the results are those of exact search.
+ */
+BOOST_AUTO_TEST_CASE(BatchedSearchExactTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(3, 300);
+  arma::mat qdata = arma::randu<arma::mat>(3, 2500);
+
+  LSHSearch<> lsh(rdata, 3, 4, 1e6, 99901, 500);
+  KNN knn(rdata);
+
+  arma::Mat<size_t> lshNeighbors, knnNeighbors;
+  arma::mat lshDistances, knnDistances;
+  lsh.Search(qdata, 5, lshNeighbors, lshDistances);
+  knn.Search(qdata, 5, knnNeighbors, knnDistances);
+
+  CheckMatrices(lshNeighbors, knnNeighbors);
+  CheckMatrices(lshDistances, knnDistances);
+
+  // Each query has every reference point as a candidate.
+  BOOST_REQUIRE_EQUAL(lsh.DistanceEvaluations(), 300 * 2500);
+
+  // The same holds for monochromatic search, where a point is not its own
+  // neighbor.
+  lsh.Search(5, lshNeighbors, lshDistances);
+  knn.Search(5, knnNeighbors, knnDistances);
+
+  CheckMatrices(lshNeighbors, knnNeighbors);
+  CheckMatrices(lshDistances, knnDistances);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
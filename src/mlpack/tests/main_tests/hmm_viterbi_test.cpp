@@ -174,4 +174,41 @@ BOOST_AUTO_TEST_CASE(HMMViterbiGMMHMMCheckDimensionsTest)
   BOOST_REQUIRE_EQUAL(out.n_cols, observations.n_cols);
 }
 
+/**
+ * Make sure that concatenated sequences given with their lengths are decoded
+ * separately.
+ */
+BOOST_AUTO_TEST_CASE(HMMViterbiLengthsTest)
+{
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  HMMModel* h = new HMMModel(GaussianHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(&trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(&trainSeq);
+
+  // Decode each half on its own.
+  const size_t half = inp.n_cols / 2;
+  arma::Row<size_t> first, second;
+  h->GaussianHMM()->Predict(inp.cols(0, half - 1), first);
+  h->GaussianHMM()->Predict(inp.cols(half, inp.n_cols - 1), second);
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", inp);
+  arma::Col<size_t> lengths = { half, (size_t) inp.n_cols - half };
+  SetInputParam("lengths", std::move(lengths));
+
+  mlpackMain();
+
+  arma::Mat<size_t> out = CLI::GetParam<arma::Mat<size_t> >("output");
+
+  BOOST_REQUIRE_EQUAL(out.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(out.n_cols, inp.n_cols);
+  for (size_t i = 0; i < half; ++i)
+    BOOST_REQUIRE_EQUAL(out[i], first[i]);
+  for (size_t i = half; i < inp.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(out[i], second[i - half]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
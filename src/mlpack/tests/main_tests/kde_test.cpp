@@ -0,0 +1,119 @@
+/**
+ * @file kde_test.cpp
+ *
+ * Test mlpackMain() of kde_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "KernelDensityEstimation";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/kde/kde_main.cpp>
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct KDETestFixture
+{
+ public:
+  KDETestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~KDETestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(KDEMainTest, KDETestFixture);
+
+/**
+ * Check that we can't specify both a reference set and an input model.
+ */
+BOOST_AUTO_TEST_CASE(KDERefModelTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(2, 80);
+  SetInputParam("reference", std::move(referenceData));
+
+  // The memory will be cleaned by CleanMemory().
+  KDEModel* m = new KDEModel();
+  SetInputParam("input_model", m);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Check that an invalid kernel or bandwidth is rejected.
+ */
+BOOST_AUTO_TEST_CASE(KDEInvalidParametersTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(2, 80);
+  SetInputParam("reference", referenceData);
+  SetInputParam("kernel", std::string("cosine"));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  SetInputParam("kernel", std::string("gaussian"));
+  SetInputParam("bandwidth", -1.0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Check that the estimates of a saved model are the same as those of the
+ * program that built it.
+ */
+BOOST_AUTO_TEST_CASE(KDEModelReuseTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("query", queryData);
+  SetInputParam("bandwidth", 0.5);
+  SetInputParam("rel_error", 0.0);
+
+  mlpackMain();
+
+  arma::vec estimations = std::move(CLI::GetParam<arma::vec>("predictions"));
+  BOOST_REQUIRE_EQUAL(estimations.n_elem, 100);
+  KDEModel* model = new KDEModel(*CLI::GetParam<KDEModel*>("output_model"));
+
+  bindings::tests::CleanMemory();
+
+  // Reset passed parameters.
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["query"].wasPassed = false;
+
+  // Use the saved model with the same query set, in single-tree mode.
+  SetInputParam("input_model", model);
+  SetInputParam("query", queryData);
+  SetInputParam("algorithm", std::string("single-tree"));
+
+  mlpackMain();
+
+  CheckMatrices(estimations, CLI::GetParam<arma::vec>("predictions"));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -109,6 +109,30 @@ BOOST_AUTO_TEST_CASE(NCALBFGSTest)
   BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_cols, 3);
 }
 
+/**
+ * Ensure that the transformed dataset is the input transformed by the learned
+ * distance matrix.
+ */
+BOOST_AUTO_TEST_CASE(NCATransformedDataTest)
+{
+  arma::mat x;
+  x.randu(3, 100);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(100,
+      arma::distr_param(0, 1));
+
+  SetInputParam("input", x);
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("max_iterations", (int) 100);
+
+  mlpackMain();
+
+  const arma::mat& distance = CLI::GetParam<arma::mat>("output");
+  const arma::mat& transformed = CLI::GetParam<arma::mat>("transformed_data");
+  BOOST_REQUIRE_EQUAL(transformed.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(transformed.n_cols, 100);
+  CheckMatrices(transformed, distance * x);
+}
+
 /**
  * Ensure that if labels are of a different size than required
  * by the input, an error occurs.
@@ -10,6 +10,8 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core/math/clamp.hpp>
+#include <mlpack/core/math/descriptive_statistics.hpp>
+#include <mlpack/core/math/pairwise_distances.hpp>
 #include <mlpack/core/math/random.hpp>
 #include <mlpack/core/math/range.hpp>
 #include <boost/test/unit_test.hpp>
@@ -1009,4 +1011,287 @@ BOOST_AUTO_TEST_CASE(InplaceSparseShuffleWeightsTest)
   }
 }
 
+/**
+ * Make sure that random streams are reproducible and distinct.
+ */
+BOOST_AUTO_TEST_CASE(RandomStreamTest)
+{
+  RandomSeed(42);
+  arma::Mat<size_t> values(10, 4);
+  for (size_t s = 0; s < values.n_cols; ++s)
+  {
+    std::mt19937 generator = RandomStream(s);
+    for (size_t i = 0; i < values.n_rows; ++i)
+      values(i, s) = generator();
+  }
+
+  // Reseeding gives the same streams.
+  RandomSeed(42);
+  for (size_t s = 0; s < values.n_cols; ++s)
+  {
+    std::mt19937 generator = RandomStream(s);
+    for (size_t i = 0; i < values.n_rows; ++i)
+      BOOST_REQUIRE_EQUAL(values(i, s), (size_t) generator());
+  }
+
+  // Different streams give different numbers.
+  for (size_t s = 1; s < values.n_cols; ++s)
+    BOOST_REQUIRE(arma::any(values.col(s) != values.col(0)));
+
+  RandomSeed(std::time(NULL));
+}
+
+/**
+ * Make sure that the threads of a parallel section draw reproducible and
+ * distinct random numbers.
+ */
+BOOST_AUTO_TEST_CASE(ThreadRandomTest)
+{
+  const size_t previousCount = Threads::Count();
+  Threads::SetCount(4);
+
+  arma::mat values(10, Threads::Count());
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    RandomSeed(42);
+    arma::mat trialValues(values.n_rows, values.n_cols);
+
+    #pragma omp parallel
+    {
+      #ifdef HAS_OPENMP
+      const size_t thread = (size_t) omp_get_thread_num();
+      #else
+      const size_t thread = 0;
+      #endif
+      for (size_t i = 0; i < trialValues.n_rows; ++i)
+        trialValues(i, thread) = Random();
+    }
+
+    if (trial == 0)
+      values = trialValues;
+    else
+      CheckMatrices(values, trialValues);
+  }
+
+  for (size_t t = 1; t < values.n_cols; ++t)
+    BOOST_REQUIRE(arma::any(values.col(t) != values.col(0)));
+
+  Threads::SetCount(previousCount);
+  RandomSeed(std::time(NULL));
+}
+
+/**
+ * Make sure that the statistics computed in chunks, in parallel, and merged
+ * match the statistics computed directly, and that the quantile sketch gives a
+ * close median.
+ */
+BOOST_AUTO_TEST_CASE(DescriptiveStatisticsTest)
+{
+  arma::mat data = arma::randn<arma::mat>(4, 10000);
+  data.row(1) = arma::exp(data.row(1));
+  data.row(2) += 1e6;
+
+  DescriptiveStatistics exact(4, true);
+  DescriptiveStatistics first(4), second(4);
+  for (size_t i = 0; i < data.n_cols; i += 1500)
+  {
+    const size_t end = std::min((size_t) data.n_cols, i + 1500) - 1;
+    exact.Add(data.cols(i, end));
+    if (i < 6000)
+      first.Add(data.cols(i, end));
+    else
+      second.Add(data.cols(i, end));
+  }
+  first.Merge(second);
+  BOOST_REQUIRE_EQUAL(exact.Count(), data.n_cols);
+  BOOST_REQUIRE_EQUAL(first.Count(), data.n_cols);
+
+  for (size_t d = 0; d < 4; ++d)
+  {
+    const arma::rowvec x = data.row(d);
+    const double n = x.n_elem;
+    const double mean = arma::mean(x);
+    const double deviation = arma::stddev(x, 1);
+    const double m3 = arma::accu(arma::pow(x - mean, 3.0));
+    const double m4 = arma::accu(arma::pow(x - mean, 4.0));
+
+    for (const DescriptiveStatistics* s : { &exact, &first })
+    {
+      BOOST_REQUIRE_EQUAL(s->Min(d), x.min());
+      BOOST_REQUIRE_EQUAL(s->Max(d), x.max());
+      BOOST_REQUIRE_CLOSE(s->Mean(d), mean, 1e-8);
+      BOOST_REQUIRE_CLOSE(s->Variance(d), arma::var(x), 1e-6);
+      BOOST_REQUIRE_CLOSE(s->StandardDeviation(d, true), deviation, 1e-6);
+      BOOST_REQUIRE_CLOSE(s->Skewness(d, true),
+          m3 / (n * std::pow(deviation, 3.0)), 1e-4);
+      BOOST_REQUIRE_CLOSE(s->Kurtosis(d, true) + 3.0,
+          n * m4 / std::pow(arma::accu(arma::square(x - mean)), 2.0), 1e-4);
+    }
+
+    BOOST_REQUIRE_EQUAL(exact.Median(d), arma::median(x));
+
+    // The rank of the approximate median is close to the middle.
+    const double median = first.Median(d);
+    const double rank = arma::accu(x < median) / n;
+    BOOST_REQUIRE_SMALL(rank - 0.5, 0.02);
+  }
+
+  // Points of the wrong dimensionality are rejected.
+  BOOST_REQUIRE_THROW(exact.Add(arma::randu<arma::mat>(3, 10)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the pairwise distances match the distances computed one pair
+ * at a time, for the metrics computed with a matrix multiplication and for the
+ * others.
+ */
+BOOST_AUTO_TEST_CASE(PairwiseDistancesTest)
+{
+  // The points are far from the origin, which the matrix multiplication has
+  // to handle without losing precision.
+  arma::mat a = arma::randu<arma::mat>(5, 300) + 100.0;
+  arma::mat b = arma::randu<arma::mat>(5, 700) + 100.0;
+
+  metric::EuclideanDistance euclidean;
+  metric::SquaredEuclideanDistance squared;
+  metric::ManhattanDistance manhattan;
+
+  arma::mat distances, squaredDistances, manhattanDistances;
+  PairwiseDistances(euclidean, a, b, distances);
+  PairwiseDistances(squared, a, b, squaredDistances);
+  PairwiseDistances(manhattan, a, b, manhattanDistances);
+
+  BOOST_REQUIRE_EQUAL(distances.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, b.n_cols);
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(distances(i, j),
+          euclidean.Evaluate(a.col(i), b.col(j)), 1e-5);
+      BOOST_REQUIRE_CLOSE(squaredDistances(i, j),
+          squared.Evaluate(a.col(i), b.col(j)), 1e-5);
+      BOOST_REQUIRE_CLOSE(manhattanDistances(i, j),
+          manhattan.Evaluate(a.col(i), b.col(j)), 1e-8);
+    }
+  }
+
+  // The distance matrix of one set is symmetric with a zero diagonal.
+  arma::mat selfDistances, selfManhattan;
+  PairwiseDistances(euclidean, a, selfDistances);
+  PairwiseDistances(manhattan, a, selfManhattan);
+  for (size_t j = 0; j < a.n_cols; ++j)
+  {
+    BOOST_REQUIRE_EQUAL(selfDistances(j, j), 0.0);
+    BOOST_REQUIRE_EQUAL(selfManhattan(j, j), 0.0);
+    for (size_t i = 0; i < j; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(selfDistances(i, j), selfDistances(j, i));
+      BOOST_REQUIRE_CLOSE(selfDistances(i, j),
+          euclidean.Evaluate(a.col(i), a.col(j)), 1e-5);
+      BOOST_REQUIRE_EQUAL(selfManhattan(i, j), selfManhattan(j, i));
+      BOOST_REQUIRE_CLOSE(selfManhattan(i, j),
+          manhattan.Evaluate(a.col(i), a.col(j)), 1e-8);
+    }
+  }
+
+  // Single precision points give single precision distances.
+  arma::fmat fa = arma::conv_to<arma::fmat>::from(a);
+  arma::fmat fb = arma::conv_to<arma::fmat>::from(b);
+  arma::fmat fDistances;
+  PairwiseDistances(euclidean, fa, fb, fDistances);
+  for (size_t j = 0; j < b.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      BOOST_REQUIRE_SMALL(fDistances(i, j) - distances(i, j), 1e-3);
+
+  // Sets of different dimensionality are rejected.
+  arma::mat c = arma::randu<arma::mat>(4, 10);
+  BOOST_REQUIRE_THROW(PairwiseDistances(euclidean, a, c, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that shuffling many points, in place and into other matrices, and
+ * dense and sparse, keeps every point with its label and weight.
+ */
+BOOST_AUTO_TEST_CASE(LargeShuffleTest)
+{
+  const size_t n = 5000;
+  arma::mat data(4, n, arma::fill::randu);
+  data.row(0) = arma::linspace<arma::rowvec>(0, n - 1, n);
+  arma::Row<size_t> labels = arma::linspace<arma::Row<size_t>>(0, n - 1, n);
+  arma::rowvec weights = 2.0 * arma::conv_to<arma::rowvec>::from(labels);
+  arma::sp_mat sparseData = arma::sprandu<arma::sp_mat>(4, n, 0.3);
+  sparseData.row(0) = data.row(0) + 1.0;
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    arma::mat outputData;
+    arma::Row<size_t> outputLabels, sparseLabels;
+    arma::rowvec outputWeights;
+    arma::sp_mat outputSparseData;
+    if (trial == 0)
+    {
+      ShuffleData(data, labels, weights, outputData, outputLabels,
+          outputWeights);
+      ShuffleData(sparseData, labels, outputSparseData, sparseLabels);
+    }
+    else
+    {
+      outputData = data;
+      outputLabels = labels;
+      outputWeights = weights;
+      ShuffleData(outputData, outputLabels, outputWeights, outputData,
+          outputLabels, outputWeights);
+
+      outputSparseData = sparseData;
+      sparseLabels = labels;
+      ShuffleData(outputSparseData, sparseLabels, outputSparseData,
+          sparseLabels);
+    }
+
+    arma::Row<size_t> counts(n, arma::fill::zeros);
+    arma::Row<size_t> sparseCounts(n, arma::fill::zeros);
+    for (size_t i = 0; i < n; ++i)
+    {
+      const size_t label = outputLabels[i];
+      counts[label]++;
+      BOOST_REQUIRE_EQUAL((size_t) outputData(0, i), label);
+      BOOST_REQUIRE_EQUAL(outputData(3, i), data(3, label));
+      BOOST_REQUIRE_EQUAL(outputWeights[i], weights[label]);
+
+      const size_t sparseLabel = sparseLabels[i];
+      sparseCounts[sparseLabel]++;
+      BOOST_REQUIRE_EQUAL((double) outputSparseData(0, i), sparseLabel + 1.0);
+      BOOST_REQUIRE_EQUAL((double) outputSparseData(2, i),
+          (double) sparseData(2, sparseLabel));
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(counts[i], 1);
+      BOOST_REQUIRE_EQUAL(sparseCounts[i], 1);
+    }
+  }
+}
+
+/**
+ * Make sure that RandomBasis() gives a rotation.
+ */
+BOOST_AUTO_TEST_CASE(RandomBasisTest)
+{
+  for (size_t d = 1; d < 150; d += 37)
+  {
+    arma::mat basis;
+    RandomBasis(basis, d);
+
+    BOOST_REQUIRE_EQUAL(basis.n_rows, d);
+    BOOST_REQUIRE_EQUAL(basis.n_cols, d);
+    CheckMatrices(basis.t() * basis + 1.0,
+        arma::eye<arma::mat>(d, d) + 1.0, 1e-6);
+    BOOST_REQUIRE_CLOSE(arma::det(basis), 1.0, 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -83,4 +83,34 @@ BOOST_AUTO_TEST_CASE(ColumnToBlocksChangeBlockSize)
   TestResults(output, matlabResults);
 }
 
+/**
+ * Make sure that blocks without an input column are left as buffer, and that
+ * scaling works.
+ */
+BOOST_AUTO_TEST_CASE(ColumnToBlocksFewerColumns)
+{
+  arma::mat input = arma::randu<arma::mat>(4, 3);
+  arma::mat output;
+  mlpack::math::ColumnsToBlocks ctb(2, 2);
+  ctb.Transform(input, output);
+
+  BOOST_REQUIRE_EQUAL(output.n_rows, 7);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 7);
+  for (size_t k = 0; k < 3; ++k)
+  {
+    const size_t row = 1 + (k / 2) * 3;
+    const size_t col = 1 + (k % 2) * 3;
+    for (size_t i = 0; i < 4; ++i)
+      BOOST_REQUIRE_EQUAL(output(row + i % 2, col + i / 2), input(i, k));
+  }
+
+  // The fourth block is only buffer.
+  BOOST_REQUIRE_EQUAL(arma::accu(output.submat(4, 4, 5, 5)), -4.0);
+
+  ctb.Scale(true);
+  ctb.Transform(input, output);
+  BOOST_REQUIRE_SMALL(output.min(), 1e-10);
+  BOOST_REQUIRE_CLOSE(output.max(), 255.0, 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
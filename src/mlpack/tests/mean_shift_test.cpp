@@ -90,6 +90,43 @@ BOOST_AUTO_TEST_CASE(MeanShiftSimpleTest)
     BOOST_REQUIRE_EQUAL(assignments(i), thirdClass);
 }
 
+/**
+ * Shift every point of the 30-point data set instead of the binned seeds, so
+ * that many shifts converge to the same mode, and make sure that the duplicate
+ * centroids are merged.
+ */
+BOOST_AUTO_TEST_CASE(MeanShiftAllPointsDuplicateTest)
+{
+  MeanShift<> meanShift;
+
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster((arma::mat) trans(meanShiftData), assignments, centroids,
+      true, false);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 3);
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    for (size_t j = i + 1; j < centroids.n_cols; ++j)
+    {
+      BOOST_REQUIRE_GE(metric::EuclideanDistance::Evaluate(centroids.col(i),
+          centroids.col(j)), meanShift.Radius());
+    }
+  }
+
+  // Each class must get its own cluster.
+  for (size_t i = 1; i < 13; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), assignments(0));
+  for (size_t i = 14; i < 20; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), assignments(13));
+  for (size_t i = 21; i < 30; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), assignments(20));
+
+  BOOST_REQUIRE_NE(assignments(0), assignments(13));
+  BOOST_REQUIRE_NE(assignments(0), assignments(20));
+  BOOST_REQUIRE_NE(assignments(13), assignments(20));
+}
+
 // Generate samples from four Gaussians, and make sure mean shift nearly
 // recovers those four centers.
 BOOST_AUTO_TEST_CASE(GaussianClustering)
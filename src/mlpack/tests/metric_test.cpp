@@ -10,6 +10,8 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/mahalanobis_distance.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -87,4 +89,105 @@ BOOST_AUTO_TEST_CASE(LINFMetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+/**
+ * Make sure the direct loops used for dense points (including the fixed-length
+ * loops for low dimensions) agree with the Armadillo expressions, for columns
+ * of matrices and for sparse points.
+ */
+BOOST_AUTO_TEST_CASE(LMetricDimensionsTest)
+{
+  for (size_t d = 1; d <= 20; ++d)
+  {
+    arma::mat points = arma::randn<arma::mat>(d, 2);
+    arma::vec a = points.col(0);
+    arma::vec b = points.col(1);
+    arma::sp_vec sa(a);
+    arma::sp_vec sb(b);
+
+    const double l1 = arma::accu(arma::abs(a - b));
+    const double l2 = std::sqrt(arma::accu(arma::square(a - b)));
+    const double l3 = std::pow(arma::accu(arma::pow(arma::abs(a - b), 3.0)),
+        1.0 / 3.0);
+    const double lInf = arma::abs(a - b).max();
+
+    BOOST_REQUIRE_CLOSE(ManhattanDistance::Evaluate(a, b), l1, 1e-8);
+    BOOST_REQUIRE_CLOSE(ManhattanDistance::Evaluate(points.col(0),
+        points.col(1)), l1, 1e-8);
+    BOOST_REQUIRE_CLOSE(ManhattanDistance::Evaluate(sa, sb), l1, 1e-8);
+
+    BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(a, b), l2, 1e-8);
+    BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(points.col(0), b), l2,
+        1e-8);
+    BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(sa, sb), l2, 1e-8);
+    BOOST_REQUIRE_CLOSE(SquaredEuclideanDistance::Evaluate(a,
+        points.col(1)), l2 * l2, 1e-8);
+
+    BOOST_REQUIRE_CLOSE(LMetric<3, true>::Evaluate(a, b), l3, 1e-8);
+    BOOST_REQUIRE_CLOSE(LMetric<3, true>::Evaluate(points.col(0),
+        points.col(1)), l3, 1e-8);
+
+    BOOST_REQUIRE_CLOSE(ChebyshevDistance::Evaluate(a, b), lInf, 1e-8);
+    BOOST_REQUIRE_CLOSE(ChebyshevDistance::Evaluate(points.col(0),
+        points.col(1)), lInf, 1e-8);
+  }
+}
+
+/**
+ * Make sure that the Euclidean distance between points stretched by
+ * MahalanobisDistance::Transform() is the Mahalanobis distance, and that a
+ * search on the stretched points finds the Mahalanobis nearest neighbors.
+ */
+BOOST_AUTO_TEST_CASE(MahalanobisTransformTest)
+{
+  arma::mat a = arma::randn<arma::mat>(4, 4);
+  const arma::mat covariance = a.t() * a + 0.1 * arma::eye<arma::mat>(4, 4);
+  MahalanobisDistance<> distance(covariance);
+
+  arma::mat references = arma::randu<arma::mat>(4, 200);
+  arma::mat queries = arma::randu<arma::mat>(4, 20);
+  arma::mat stretchedReferences, stretchedQueries;
+  distance.Transform(references, stretchedReferences);
+  distance.Transform(queries, stretchedQueries);
+
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(stretchedQueries.col(i),
+        stretchedReferences.col(i)), distance.Evaluate(queries.col(i),
+        references.col(i)), 1e-5);
+  }
+
+  mlpack::neighbor::KNN knn(std::move(stretchedReferences));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(stretchedQueries, 1, neighbors, distances);
+
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    size_t best = 0;
+    double bestDistance = DBL_MAX;
+    for (size_t j = 0; j < references.n_cols; ++j)
+    {
+      const double d = distance.Evaluate(queries.col(i), references.col(j));
+      if (d < bestDistance)
+      {
+        bestDistance = d;
+        best = j;
+      }
+    }
+
+    BOOST_REQUIRE_EQUAL(neighbors(0, i), best);
+    BOOST_REQUIRE_CLOSE(distances(0, i), bestDistance, 1e-5);
+  }
+
+  // A singular covariance matrix is decomposed too.
+  arma::mat singular = covariance;
+  singular.row(3).zeros();
+  singular.col(3).zeros();
+  MahalanobisDistance<> singularDistance(singular);
+  singularDistance.Transform(queries, stretchedQueries);
+  BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(stretchedQueries.col(0),
+      stretchedQueries.col(1)), singularDistance.Evaluate(queries.col(0),
+      queries.col(1)), 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,135 @@
+/**
+ * @file mvu_test.cpp
+ *
+ * Test file for MVU and landmark MVU.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/mvu/mvu.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+BOOST_AUTO_TEST_SUITE(MVUTest);
+
+using namespace mlpack;
+using namespace mlpack::mvu;
+
+/**
+ * Create a grid of points on half of a cylinder of radius 1 in three
+ * dimensions, and the same grid unfolded into a rectangle of size pi x 1.
+ */
+void HalfCylinder(arma::mat& dataset, arma::mat& unfolded)
+{
+  const size_t rows = 10, cols = 4;
+  dataset.set_size(3, rows * cols);
+  unfolded.set_size(2, rows * cols);
+  for (size_t i = 0; i < rows; ++i)
+  {
+    for (size_t j = 0; j < cols; ++j)
+    {
+      const double angle = M_PI * i / (rows - 1);
+      const double height = (double) j / (cols - 1);
+      const size_t point = i * cols + j;
+      dataset(0, point) = std::cos(angle);
+      dataset(1, point) = std::sin(angle);
+      dataset(2, point) = height;
+      unfolded(0, point) = angle;
+      unfolded(1, point) = height;
+    }
+  }
+}
+
+/**
+ * Return the relative difference between the pairwise distances of the points
+ * of a and the pairwise distances of the points of b.
+ */
+double DistanceError(const arma::mat& a, const arma::mat& b)
+{
+  arma::mat distancesA(a.n_cols, a.n_cols), distancesB(b.n_cols, b.n_cols);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < a.n_cols; ++j)
+    {
+      distancesA(i, j) = arma::norm(a.col(i) - a.col(j));
+      distancesB(i, j) = arma::norm(b.col(i) - b.col(j));
+    }
+  }
+
+  return arma::norm(distancesA - distancesB, "fro") /
+      arma::norm(distancesB, "fro");
+}
+
+/**
+ * Make sure that landmark MVU unfolds the half cylinder into the rectangle (up
+ * to a rigid transformation).
+ */
+BOOST_AUTO_TEST_CASE(LandmarkUnfoldTest)
+{
+  math::RandomSeed(42);
+
+  arma::mat dataset, unfolded;
+  HalfCylinder(dataset, unfolded);
+
+  MVU mvu(dataset);
+  arma::mat output;
+  mvu.UnfoldLandmarks(2, 6, 25, output);
+
+  BOOST_REQUIRE_EQUAL(output.n_rows, (size_t) 2);
+  BOOST_REQUIRE_EQUAL(output.n_cols, dataset.n_cols);
+
+  // The output is centered.
+  BOOST_REQUIRE_SMALL(arma::norm(arma::mean(output, 1)), 1e-5);
+
+  BOOST_REQUIRE_LT(DistanceError(output, unfolded), 0.25);
+}
+
+/**
+ * Make sure that landmark MVU gives about the same embedding as MVU over all
+ * the points, on a small dataset.
+ */
+BOOST_AUTO_TEST_CASE(LandmarkMatchesExactTest)
+{
+  math::RandomSeed(42);
+
+  arma::mat dataset, unfolded;
+  HalfCylinder(dataset, unfolded);
+
+  MVU mvu(dataset);
+  arma::mat exactOutput, landmarkOutput;
+  mvu.Unfold(2, 6, exactOutput);
+  mvu.UnfoldLandmarks(2, 6, 25, landmarkOutput);
+
+  BOOST_REQUIRE_EQUAL(exactOutput.n_rows, (size_t) 2);
+  BOOST_REQUIRE_EQUAL(exactOutput.n_cols, dataset.n_cols);
+
+  BOOST_REQUIRE_LT(DistanceError(landmarkOutput, exactOutput), 0.25);
+}
+
+/**
+ * Make sure that landmark MVU falls back to MVU over all the points if there
+ * are as many landmarks as points, and rejects too few landmarks.
+ */
+BOOST_AUTO_TEST_CASE(LandmarkCountTest)
+{
+  arma::mat dataset, unfolded;
+  HalfCylinder(dataset, unfolded);
+
+  MVU mvu(dataset);
+  arma::mat exactOutput, landmarkOutput;
+
+  math::RandomSeed(42);
+  mvu.Unfold(2, 6, exactOutput);
+  math::RandomSeed(42);
+  mvu.UnfoldLandmarks(2, 6, dataset.n_cols, landmarkOutput);
+  CheckMatrices(exactOutput, landmarkOutput);
+
+  BOOST_REQUIRE_THROW(mvu.UnfoldLandmarks(2, 6, 6, landmarkOutput),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -314,4 +314,76 @@ BOOST_AUTO_TEST_CASE(SeparateTrainIndividualIncrementalTest)
   }
 }
 
+/**
+ * Ensure that incremental training on mini-batches gives the same model as
+ * training on the whole dataset at once.
+ */
+BOOST_AUTO_TEST_CASE(SeparateTrainMiniBatchIncrementalTest)
+{
+  const char* trainFilename = "trainSet.csv";
+  size_t classes = 2;
+
+  arma::mat trainData;
+  data::Load(trainFilename, trainData, true);
+
+  // Get the labels out.
+  arma::Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = trainData(trainData.n_rows - 1, i);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  NaiveBayesClassifier<> nbc(trainData, labels, classes, false);
+  NaiveBayesClassifier<> nbcTrain(trainData.n_rows, classes);
+  const size_t batchSize = trainData.n_cols / 3 + 1;
+  for (size_t i = 0; i < trainData.n_cols; i += batchSize)
+  {
+    const size_t end = std::min((size_t) trainData.n_cols, i + batchSize) - 1;
+    nbcTrain.Train(trainData.cols(i, end), labels.subvec(i, end), classes,
+        true);
+  }
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+  {
+    if (std::abs(nbc.Means()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcTrain.Means()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Means()[i], nbcTrain.Means()[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < nbc.Variances().n_elem; ++i)
+  {
+    if (std::abs(nbc.Variances()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcTrain.Variances()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Variances()[i], nbcTrain.Variances()[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < nbc.Probabilities().n_elem; ++i)
+  {
+    if (std::abs(nbc.Probabilities()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcTrain.Probabilities()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Probabilities()[i], nbcTrain.Probabilities()[i],
+          1e-5);
+  }
+
+  // The predictions for the whole dataset should match the predictions for
+  // each point.
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  nbc.Classify(trainData, predictions, probabilities);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    nbc.Classify(trainData.col(i), prediction, pointProbabilities);
+    BOOST_REQUIRE_EQUAL(prediction, predictions[i]);
+    for (size_t c = 0; c < classes; ++c)
+    {
+      BOOST_REQUIRE_CLOSE(pointProbabilities[c] + 1e-5,
+          probabilities(c, i) + 1e-5, 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -249,6 +249,44 @@ BOOST_AUTO_TEST_CASE(SoftmaxSeparableGradient)
   BOOST_REQUIRE_CLOSE(gradient(1, 1), -2.0 * -0.1435886, 0.01);
 }
 
+/**
+ * When every other point is a neighbor, the truncated error function should
+ * give the same results as the exact one, with any number of threads.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxTruncatedParallelTest)
+{
+  arma::mat data = arma::randu(3, 80);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(80,
+      arma::distr_param(0, 2));
+  arma::mat coordinates = arma::eye(3, 3) + 0.2 * arma::randu(3, 3);
+
+  const size_t threads = Threads::Count();
+  Threads::SetCount(1);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  const double objective = sef.Evaluate(coordinates);
+  arma::mat gradient, separableGradient;
+  sef.Gradient(coordinates, gradient);
+  const double separableObjective = sef.Evaluate(coordinates, 10, 30);
+  sef.Gradient(coordinates, 10, separableGradient, 30);
+
+  Threads::SetCount(4);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> truncated(data, labels);
+  truncated.NumNeighbors() = 79;
+  arma::mat truncatedGradient, truncatedSeparableGradient;
+  BOOST_REQUIRE_CLOSE(truncated.Evaluate(coordinates), objective, 1e-5);
+  truncated.Gradient(coordinates, truncatedGradient);
+  BOOST_REQUIRE_CLOSE(truncated.Evaluate(coordinates, 10, 30),
+      separableObjective, 1e-5);
+  truncated.Gradient(coordinates, 10, truncatedSeparableGradient, 30);
+
+  CheckMatrices(gradient, truncatedGradient, 1e-5);
+  CheckMatrices(separableGradient, truncatedSeparableGradient, 1e-5);
+
+  Threads::SetCount(threads);
+}
+
 //
 // Tests for the NCA algorithm.
 //
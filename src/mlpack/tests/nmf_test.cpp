@@ -16,6 +16,7 @@
 #include <mlpack/methods/amf/update_rules/nmf_mult_div.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
+#include <mlpack/methods/amf/update_rules/sparse_als.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -295,4 +296,110 @@ BOOST_AUTO_TEST_CASE(NonNegNMFALSTest)
       && arma::all(arma::vectorise(h) >= 0));
 }
 
+/**
+ * Check that sparse ALS recovers a low-rank matrix from a subset of its
+ * entries, both on the observed and on the unobserved entries.
+ */
+BOOST_AUTO_TEST_CASE(SparseALSTest)
+{
+  mat w0 = randu<mat>(50, 3);
+  mat h0 = randu<mat>(3, 40);
+  mat full = w0 * h0;
+
+  // Observe about 40% of the entries.
+  mat mask = randu<mat>(50, 40);
+  sp_mat v(full % (mask < 0.4));
+
+  MaxIterationTermination iter(100);
+  AMF<MaxIterationTermination, RandomInitialization, SparseALSUpdate> als(
+      iter, RandomInitialization(), SparseALSUpdate(1e-8));
+  mat w, h;
+  als.Apply(v, 3, w, h);
+
+  const mat vp = w * h;
+  double observedError = 0.0, unobservedError = 0.0;
+  size_t observed = 0;
+  for (size_t i = 0; i < full.n_elem; ++i)
+  {
+    const double error = std::pow(vp[i] - full[i], 2.0);
+    if (mask[i] < 0.4)
+    {
+      observedError += error;
+      ++observed;
+    }
+    else
+    {
+      unobservedError += error;
+    }
+  }
+
+  BOOST_REQUIRE_SMALL(std::sqrt(observedError / observed), 1e-3);
+  BOOST_REQUIRE_SMALL(std::sqrt(unobservedError / (full.n_elem - observed)),
+      0.05);
+}
+
+/**
+ * Check the implicit feedback update of H against the dense normal equations
+ * with the confidence weights.
+ */
+BOOST_AUTO_TEST_CASE(SparseALSImplicitTest)
+{
+  sp_mat v;
+  v.sprandu(30, 20, 0.2);
+  mat w = randu<mat>(30, 4);
+  mat h;
+
+  const double lambda = 0.1;
+  const double alpha = 10.0;
+  SparseALSUpdate update(lambda, true, alpha);
+  update.Initialize(v, 4);
+  update.HUpdate(v, w, h);
+
+  const mat dv(v);
+  for (size_t j = 0; j < dv.n_cols; ++j)
+  {
+    const vec c = 1.0 + alpha * dv.col(j);
+    const vec p = conv_to<vec>::from(dv.col(j) > 0);
+    const mat a = w.t() * diagmat(c) * w + lambda * eye<mat>(4, 4);
+    vec expected = solve(a, w.t() * (c % p));
+    if (accu(p) == 0)
+      expected.zeros();
+
+    for (size_t k = 0; k < 4; ++k)
+      BOOST_REQUIRE_SMALL(h(k, j) - expected(k), 1e-8);
+  }
+}
+
+/**
+ * The sparse multiplicative update rules, which avoid forming W * H, should
+ * give the same updates as the dense rules.
+ */
+BOOST_AUTO_TEST_CASE(SparseMultiplicativeUpdateTest)
+{
+  const arma::sp_mat v = arma::sprandu<arma::sp_mat>(100, 80, 0.1);
+  const arma::mat denseV(v);
+  const arma::mat w = arma::randu<arma::mat>(100, 5) + 0.1;
+  const arma::mat h = arma::randu<arma::mat>(5, 80) + 0.1;
+
+  arma::mat w1 = w, w2 = w, h1 = h, h2 = h;
+  NMFMultiplicativeDistanceUpdate::WUpdate(v, w1, h);
+  NMFMultiplicativeDistanceUpdate::WUpdate(denseV, w2, h);
+  NMFMultiplicativeDistanceUpdate::HUpdate(v, w, h1);
+  NMFMultiplicativeDistanceUpdate::HUpdate(denseV, w, h2);
+  BOOST_REQUIRE_SMALL(arma::norm(w1 - w2, "fro") / arma::norm(w2, "fro"),
+      1e-10);
+  BOOST_REQUIRE_SMALL(arma::norm(h1 - h2, "fro") / arma::norm(h2, "fro"),
+      1e-10);
+
+  w1 = w; w2 = w; h1 = h; h2 = h;
+  NMFMultiplicativeDivergenceUpdate::WUpdate(v, w1, h);
+  NMFMultiplicativeDivergenceUpdate::WUpdate(denseV, w2, h);
+  NMFMultiplicativeDivergenceUpdate::HUpdate(v, w, h1);
+  NMFMultiplicativeDivergenceUpdate::HUpdate(denseV, w, h2);
+  BOOST_REQUIRE_SMALL(arma::norm(w1 - w2, "fro") / arma::norm(w2, "fro"),
+      1e-10);
+  BOOST_REQUIRE_SMALL(arma::norm(h1 - h2, "fro") / arma::norm(h2, "fro"),
+      1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
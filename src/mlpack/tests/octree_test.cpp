@@ -12,6 +12,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/tree/octree.hpp>
 
+#include <queue>
+
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 #include "serialization.hpp"
@@ -346,4 +348,120 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   delete textTree;
 }
 
+/**
+ * Make sure that compacting an octree keeps its structure, stores the nodes
+ * contiguously in breadth-first order, and that compacted trees can be copied,
+ * moved and serialized.
+ */
+BOOST_AUTO_TEST_CASE(CompactLayoutTest)
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+
+  Octree<> t(dataset);
+  Octree<> tcopy(t);
+  t.CompactLayout();
+
+  BOOST_REQUIRE(t.IsCompacted());
+  BOOST_REQUIRE(!tcopy.IsCompacted());
+
+  // Walk both trees in breadth-first order; the nodes of the compacted tree
+  // must be consecutive, and the same as the nodes of the copy.
+  std::queue<Octree<>*> queue, copyQueue;
+  queue.push(&t);
+  copyQueue.push(&tcopy);
+  Octree<>* next = (t.NumChildren() > 0) ? &t.Child(0) : NULL;
+  while (!queue.empty())
+  {
+    Octree<>* node = queue.front();
+    Octree<>* copyNode = copyQueue.front();
+    queue.pop();
+    copyQueue.pop();
+
+    CheckSameNode(*node, *copyNode);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(&node->Child(i), next);
+      BOOST_REQUIRE_EQUAL(node->Child(i).Parent(), node);
+      ++next;
+      queue.push(&node->Child(i));
+      copyQueue.push(&copyNode->Child(i));
+    }
+  }
+
+  // A copy of a compacted tree is an ordinary tree.
+  Octree<> t2(t);
+  BOOST_REQUIRE(!t2.IsCompacted());
+  CheckSameNode(t, t2);
+
+  // Moving the root keeps the layout.
+  Octree<> t3(std::move(t));
+  BOOST_REQUIRE(t3.IsCompacted());
+  BOOST_REQUIRE(!t.IsCompacted());
+  CheckSameNode(t3, tcopy);
+
+  Octree<>* xmlTree;
+  Octree<>* binaryTree;
+  Octree<>* textTree;
+
+  SerializePointerObjectAll(&t3, xmlTree, binaryTree, textTree);
+
+  CheckSameNode(t3, *xmlTree);
+  CheckSameNode(t3, *binaryTree);
+  CheckSameNode(t3, *textTree);
+
+  delete xmlTree;
+  delete binaryTree;
+  delete textTree;
+}
+
+/**
+ * Make sure that the children of every node hold consecutive runs of the
+ * points of the node, in order, and that no leaf is too large.
+ */
+template<typename TreeType>
+void CheckChildRanges(TreeType& node, const size_t maxLeafSize)
+{
+  if (node.NumChildren() == 0)
+  {
+    BOOST_REQUIRE_LE(node.NumPoints(), maxLeafSize);
+    return;
+  }
+
+  size_t next = node.Descendant(0);
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_GT(node.Child(i).NumDescendants(), 0);
+    BOOST_REQUIRE_EQUAL(node.Child(i).Descendant(0), next);
+    next += node.Child(i).NumDescendants();
+    CheckChildRanges(node.Child(i), maxLeafSize);
+  }
+
+  BOOST_REQUIRE_EQUAL(next, node.Descendant(0) + node.NumDescendants());
+}
+
+/**
+ * Build a tree large enough for the points to be sorted by their Morton codes
+ * in parallel.  A tight cluster of points has to be split deeper than the
+ * codes reach.
+ */
+BOOST_AUTO_TEST_CASE(MortonOrderTest)
+{
+  arma::mat dataset(3, 50000, arma::fill::randu);
+  dataset.cols(0, 49) = 0.5 + 1e-9 * arma::randu<arma::mat>(3, 50);
+  arma::mat datacopy(dataset);
+
+  std::vector<size_t> oldFromNew, newFromOld;
+  Octree<> t(dataset, oldFromNew, newFromOld, 10);
+
+  BOOST_REQUIRE_EQUAL(t.NumDescendants(), dataset.n_cols);
+  CheckChildRanges(t, 10);
+  CheckOverlap(t);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(newFromOld[oldFromNew[i]], i);
+    BOOST_REQUIRE_EQUAL(arma::norm(datacopy.col(oldFromNew[i]) -
+        t.Dataset().col(i)), 0.0);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -103,8 +103,59 @@ BOOST_AUTO_TEST_CASE(GeneralizedRosenbrockTest)
   }
 }
 
+/**
+ * Make sure that ParallelSGD also converges with unsynchronized (HOGWILD!)
+ * updates; the updates of the sparse test function are disjoint.
+ */
+BOOST_AUTO_TEST_CASE(UnsynchronizedParallelSGDTest)
+{
+  SparseTestFunction f;
+  ConstantStep decayPolicy(0.4);
+
+  const size_t threads = omp_get_max_threads();
+  const size_t batchSize = std::ceil((float) f.NumFunctions() / threads);
+  ParallelSGD<ConstantStep> s(10000, batchSize, 1e-5, true, decayPolicy,
+      false);
+  BOOST_REQUIRE(!s.AtomicUpdates());
+
+  arma::mat coordinates = f.GetInitialPoint();
+  double result = s.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+  BOOST_REQUIRE_CLOSE(coordinates[0], 2, 0.02);
+  BOOST_REQUIRE_CLOSE(coordinates[1], 1, 0.02);
+  BOOST_REQUIRE_CLOSE(coordinates[2], 1.5, 0.02);
+  BOOST_REQUIRE_CLOSE(coordinates[3], 4, 0.02);
+}
+
 #endif
 
+/**
+ * Make sure that every shuffled VisitationOrder is a permutation.
+ */
+BOOST_AUTO_TEST_CASE(VisitationOrderPermutationTest)
+{
+  const size_t sizes[] = { 1, 2, 7, 64, 97, 1000, 4096 };
+  for (size_t n : sizes)
+  {
+    VisitationOrder order(n);
+    BOOST_REQUIRE_EQUAL(order.Size(), n);
+    for (size_t trial = 0; trial < 5; ++trial)
+    {
+      order.Shuffle();
+      std::vector<size_t> counts(n, 0);
+      for (size_t k = 0; k < n; ++k)
+      {
+        BOOST_REQUIRE_LT(order[k], n);
+        ++counts[order[k]];
+      }
+
+      for (size_t i = 0; i < n; ++i)
+        BOOST_REQUIRE_EQUAL(counts[i], 1);
+    }
+  }
+}
+
 /**
  * Test the correctness of the Exponential backoff stepsize decay policy.
  */
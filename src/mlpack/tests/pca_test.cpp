@@ -12,6 +12,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
+#include <mlpack/methods/pca/incremental_pca.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
@@ -337,5 +338,82 @@ BOOST_AUTO_TEST_CASE(PCAScalingTest)
   BOOST_REQUIRE_CLOSE(accu(eigval), 3.0, 0.1); // 10% tolerance.
 }
 
+/**
+ * Feeding the data to IncrementalPCA in chunks should give the same
+ * eigenvalues and projection as exact PCA on the whole dataset.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCAChunksTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 1000);
+  data.row(1) += 2 * data.row(0);
+
+  arma::mat coeff, score;
+  arma::vec eigVal;
+  PCA<ExactSVDPolicy> exact;
+  exact.Apply(data, score, eigVal, coeff);
+
+  IncrementalPCA incremental;
+  for (size_t i = 0; i < data.n_cols; i += 150)
+  {
+    const size_t end = std::min(i + 150, (size_t) data.n_cols);
+    incremental.Update(data.cols(i, end - 1));
+  }
+
+  BOOST_REQUIRE_EQUAL(incremental.Count(), 1000);
+  const arma::vec incrementalEigVal = incremental.EigenValues();
+  BOOST_REQUIRE_EQUAL(incrementalEigVal.n_elem, eigVal.n_elem);
+  for (size_t i = 0; i < eigVal.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(eigVal[i], incrementalEigVal[i], 1e-5);
+
+  // The projections match up to the sign of each component.
+  arma::mat transformed;
+  incremental.Apply(data, transformed);
+  for (size_t i = 0; i < transformed.n_rows; ++i)
+  {
+    const double sign = (arma::dot(transformed.row(i), score.row(i)) < 0) ?
+        -1.0 : 1.0;
+    BOOST_REQUIRE_SMALL(arma::norm(sign * transformed.row(i) - score.row(i)) /
+        arma::norm(score.row(i)), 1e-5);
+  }
+}
+
+/**
+ * Merging the statistics of shards should give the same result as one pass
+ * over the whole dataset, including with a truncated rank.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCAMergeTest)
+{
+  arma::mat data = arma::randn<arma::mat>(10, 1200);
+  data.row(3) += 3 * data.row(7);
+  data.row(5) *= 4;
+
+  IncrementalPCA full(10);
+  full.Update(data);
+
+  std::vector<IncrementalPCA> shards(4, IncrementalPCA(10));
+  for (size_t i = 0; i < shards.size(); ++i)
+    shards[i].Update(data.cols(300 * i, 300 * (i + 1) - 1));
+  for (size_t i = 1; i < shards.size(); ++i)
+    shards[0].Merge(shards[i]);
+
+  BOOST_REQUIRE_EQUAL(shards[0].Count(), full.Count());
+  for (size_t i = 0; i < data.n_rows; ++i)
+    BOOST_REQUIRE_CLOSE(shards[0].Mean()[i], full.Mean()[i], 1e-5);
+  for (size_t i = 0; i < data.n_rows; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(shards[0].EigenValues()[i], full.EigenValues()[i],
+        1e-5);
+  }
+
+  // With a truncated rank, the leading components are still close.
+  IncrementalPCA truncated(3);
+  for (size_t i = 0; i < data.n_cols; i += 100)
+    truncated.Update(data.cols(i, i + 99));
+
+  BOOST_REQUIRE_EQUAL(truncated.EigenVectors().n_cols, 3);
+  BOOST_REQUIRE_CLOSE(truncated.EigenValues()[0], full.EigenValues()[0], 5.0);
+  BOOST_REQUIRE_GT(std::abs(arma::dot(truncated.EigenVectors().col(0),
+      full.EigenVectors().col(0))), 0.98);
+}
 
 BOOST_AUTO_TEST_SUITE_END();
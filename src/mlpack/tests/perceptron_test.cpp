@@ -255,4 +255,50 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * Make sure that mini-batch and averaged training classify two well-separated
+ * Gaussians correctly, and that the results do not depend on the number of
+ * threads.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchAveragedPerceptronTest)
+{
+  const size_t oldCount = Threads::Count();
+
+  mat trainData(3, 2000);
+  Row<size_t> labels(2000);
+  trainData.cols(0, 999) = randn<mat>(3, 1000);
+  trainData.cols(1000, 1999) = randn<mat>(3, 1000) + 8.0;
+  labels.subvec(0, 999).fill(0);
+  labels.subvec(1000, 1999).fill(1);
+
+  for (size_t batchSize : { 1, 64, 700 })
+  {
+    for (bool average : { false, true })
+    {
+      Perceptron<> p1;
+      p1.BatchSize() = batchSize;
+      p1.Average() = average;
+      Threads::SetCount(1);
+      p1.Train(trainData, labels, 2);
+
+      Perceptron<> p2;
+      p2.BatchSize() = batchSize;
+      p2.Average() = average;
+      Threads::SetCount(4);
+      p2.Train(trainData, labels, 2);
+
+      CheckMatrices(p1.Weights(), p2.Weights());
+      CheckMatrices(p1.Biases(), p2.Biases());
+
+      Row<size_t> predictedLabels;
+      p2.Classify(trainData, predictedLabels);
+      BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, trainData.n_cols);
+      const size_t correct = accu(predictedLabels == labels);
+      BOOST_REQUIRE_GE(correct, 1980);
+    }
+  }
+
+  Threads::SetCount(oldCount);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
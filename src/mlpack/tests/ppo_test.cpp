@@ -0,0 +1,102 @@
+/**
+ * @file ppo_test.cpp
+ *
+ * Test for the PPO implementation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <mlpack/core.hpp>
+
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/init_rules/gaussian_init.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <mlpack/methods/reinforcement_learning/ppo.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
+#include <mlpack/core/optimizers/adam/adam_update.hpp>
+#include <mlpack/methods/reinforcement_learning/training_config.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::optimization;
+using namespace mlpack::rl;
+
+BOOST_AUTO_TEST_SUITE(PPOTest);
+
+//! Convenient typedef for the networks used in the tests.
+using NetworkType = FFN<MeanSquaredError<>, GaussianInitialization>;
+
+//! Convenient typedef for the agent used in the tests.
+using AgentType = PPO<Pendulum, NetworkType, NetworkType, AdamUpdate>;
+
+//! Make sure the generalized advantage estimates are computed correctly.
+BOOST_AUTO_TEST_CASE(PPOAdvantagesTest)
+{
+  // Two instances, three steps.  The first episode of the first instance ends
+  // in a terminal state after the third step; the first episode of the second
+  // instance is cut off after the first step.
+  const arma::mat rewards("1 1 1; 0 2 0");
+  const arma::mat values(2, 3, arma::fill::zeros);
+  const arma::mat nextValues(2, 3, arma::fill::ones);
+  const arma::mat terminal("0 0 1; 0 0 0");
+  const arma::mat ended("0 0 1; 1 0 0");
+
+  arma::mat advantages;
+  AgentType::Advantages(rewards, values, nextValues, terminal, ended, 0.5, 0.5,
+      advantages);
+
+  const arma::mat expected("1.9375 1.75 1; 0.5 2.625 0.5");
+  CheckMatrices(expected, advantages);
+}
+
+//! Make sure PPO steps all the instances, and only trains in training mode.
+BOOST_AUTO_TEST_CASE(PendulumWithPPO)
+{
+  NetworkType actor(MeanSquaredError<>(), GaussianInitialization(0, 0.1));
+  actor.Add<Linear<>>(2, 16);
+  actor.Add<ReLULayer<>>();
+  actor.Add<Linear<>>(16, 1);
+
+  NetworkType critic(MeanSquaredError<>(), GaussianInitialization(0, 0.1));
+  critic.Add<Linear<>>(2, 16);
+  critic.Add<ReLULayer<>>();
+  critic.Add<Linear<>>(16, 1);
+
+  TrainingConfig config;
+  config.StepSize() = 0.001;
+  config.Discount() = 0.99;
+  config.StepLimit() = 50;
+
+  AgentType agent(std::move(config), std::move(actor), std::move(critic), 4,
+      50, 2, 32);
+
+  // Each rollout ends one episode in each instance.
+  const arma::mat actorParameters = agent.Actor().Parameters();
+  const arma::mat criticParameters = agent.Critic().Parameters();
+  const double rolloutReward = agent.Rollout();
+  BOOST_REQUIRE_EQUAL(agent.TotalSteps(), 200);
+  BOOST_REQUIRE_EQUAL(agent.Environments().EpisodeReturns().size(), 4);
+  BOOST_REQUIRE_CLOSE(rolloutReward, arma::accu(arma::vec(
+      agent.Environments().EpisodeReturns())), 1e-5);
+  BOOST_REQUIRE(arma::any(arma::vectorise(agent.Actor().Parameters() !=
+      actorParameters)));
+  BOOST_REQUIRE(arma::any(arma::vectorise(agent.Critic().Parameters() !=
+      criticParameters)));
+
+  // Nothing is trained in test mode.
+  agent.Deterministic() = true;
+  const arma::mat trainedParameters = agent.Actor().Parameters();
+  agent.Rollout();
+  BOOST_REQUIRE_EQUAL(agent.TotalSteps(), 400);
+  BOOST_REQUIRE_EQUAL(agent.Environments().EpisodeReturns().size(), 8);
+  CheckMatrices(trainedParameters, agent.Actor().Parameters());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -25,6 +25,8 @@
 #include <mlpack/core/optimizers/adam/adam_update.hpp>
 #include <mlpack/core/optimizers/rmsprop/rmsprop_update.hpp>
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
+#include <mlpack/methods/reinforcement_learning/distributed/actor.hpp>
+#include <mlpack/methods/reinforcement_learning/distributed/local_transport.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -239,4 +241,185 @@ BOOST_AUTO_TEST_CASE(AcrobatWithDQN)
   BOOST_REQUIRE(converged);
 }
 
+//! Test DQN in Cart Pole task, stepping several environments at once.
+BOOST_AUTO_TEST_CASE(CartPoleWithVectorDQN)
+{
+  // Set up the network.
+  FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+      GaussianInitialization(0, 0.001));
+  model.Add<Linear<>>(4, 128);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(128, 128);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(128, 2);
+
+  // Set up the policy and replay method.
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+  config.DoubleQLearning() = false;
+
+  // Set up DQN agent.
+  QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy)>
+      agent(std::move(config), std::move(model), std::move(policy),
+      std::move(replayMethod));
+
+  VectorEnvironment<CartPole> environments(4, CartPole(), 200);
+
+  arma::running_stat<double> averageReturn;
+  bool converged = false;
+  size_t episodes = 0;
+  while (episodes <= 1000)
+  {
+    agent.Step(environments);
+
+    for (size_t i = 0; i < environments.EpisodeReturns().size(); ++i)
+      averageReturn(environments.EpisodeReturns()[i]);
+    episodes += environments.EpisodeReturns().size();
+    environments.EpisodeReturns().clear();
+
+    // Reaching running average return 35 is enough to show it works.
+    if (averageReturn.count() > 0 && averageReturn.mean() > 35)
+    {
+      converged = true;
+      break;
+    }
+  }
+
+  // Each call to Step() takes one step in each environment.
+  BOOST_REQUIRE_EQUAL(agent.TotalSteps() % 4, 0);
+  BOOST_REQUIRE(converged);
+}
+
+//! Test DQN in Cart Pole task, acting and learning on separate threads, with
+//! soft target network updates.
+BOOST_AUTO_TEST_CASE(CartPoleWithConcurrentDQN)
+{
+  // Set up the network.
+  FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+      GaussianInitialization(0, 0.001));
+  model.Add<Linear<>>(4, 128);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(128, 128);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(128, 2);
+
+  // Set up the policy and replay method.
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 10;
+  config.TargetNetworkSyncRate() = 0.1;
+  config.ExplorationSteps() = 100;
+  config.DoubleQLearning() = false;
+  config.StepLimit() = 200;
+
+  // Set up DQN agent.
+  QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy)>
+      agent(std::move(config), std::move(model), std::move(policy),
+      std::move(replayMethod));
+
+  arma::running_stat<double> averageReturn;
+  bool converged = false;
+  for (size_t episodes = 0; episodes < 1000; episodes += 10)
+  {
+    const arma::vec returns = agent.ConcurrentEpisodes(10);
+    BOOST_REQUIRE_EQUAL(returns.n_elem, 10);
+    for (size_t i = 0; i < returns.n_elem; ++i)
+      averageReturn(returns[i]);
+
+    // Reaching running average return 35 is enough to show it works.
+    if (averageReturn.mean() > 35)
+    {
+      converged = true;
+      break;
+    }
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
+//! Test DQN in Cart Pole task, with several actors feeding one learner.
+BOOST_AUTO_TEST_CASE(CartPoleWithActorsAndLearner)
+{
+  // Set up the network.
+  FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+      GaussianInitialization(0, 0.001));
+  model.Add<Linear<>>(4, 128);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(128, 128);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(128, 2);
+  model.ResetParameters();
+
+  // Set up the actors, each with its own exploration rate.
+  typedef LocalTransport<CartPole> TransportType;
+  typedef Actor<CartPole, decltype(model), GreedyPolicy<CartPole>,
+      TransportType> ActorType;
+  std::vector<ActorType> actors;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    actors.push_back(ActorType(model,
+        GreedyPolicy<CartPole>(1.0, 250, 0.05 + 0.05 * i), CartPole(), 10, 10,
+        200));
+  }
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+  config.DoubleQLearning() = false;
+
+  // Set up the learner; its policy is not used.
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+  QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy)>
+      learner(std::move(config), std::move(model), std::move(policy),
+      std::move(replayMethod));
+
+  // Take turns, so the test does not depend on the number of threads: each
+  // actor takes a few steps, and then the learner trains once for each step.
+  TransportType transport;
+  arma::running_stat<double> averageReturn;
+  size_t episodes = 0;
+  bool converged = false;
+  while (episodes <= 1000 && !converged)
+  {
+    for (size_t i = 0; i < actors.size(); ++i)
+    {
+      for (size_t step = 0; step < 10; ++step)
+      {
+        double episodeReturn;
+        if (actors[i].Step(transport, episodeReturn))
+        {
+          averageReturn(episodeReturn);
+          ++episodes;
+        }
+      }
+    }
+
+    for (size_t step = 0; step < 10 * actors.size(); ++step)
+      learner.Learn(transport);
+
+    // Reaching running average return 35 is enough to show it works.
+    converged = (averageReturn.count() > 0 && averageReturn.mean() > 35);
+  }
+
+  // The learner can only have received the steps the actors took.
+  size_t actorSteps = 0;
+  for (size_t i = 0; i < actors.size(); ++i)
+    actorSteps += actors[i].TotalSteps();
+  BOOST_REQUIRE_LE(learner.TotalSteps(), actorSteps);
+  BOOST_REQUIRE(converged);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -208,4 +208,39 @@ BOOST_AUTO_TEST_CASE(SparseTest)
   BOOST_REQUIRE_EQUAL(distances.n_cols, 1000);
 }
 
+/**
+ * Make sure that training on batches of the reference set gives the same model
+ * as training on the whole reference set.
+ */
+BOOST_AUTO_TEST_CASE(StreamingTrainTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 1000);
+
+  math::RandomSeed(5);
+  QDAFN<> qdafn(dataset, 10, 30);
+
+  math::RandomSeed(5);
+  QDAFN<> streamingQdafn(10, 30);
+  streamingQdafn.Reset(dataset.n_rows);
+  for (size_t i = 0; i < 1000; i += 150)
+    streamingQdafn.Update(dataset.cols(i, std::min(i + 149, (size_t) 999)));
+
+  BOOST_REQUIRE_EQUAL(streamingQdafn.ReferenceSize(), 1000);
+  BOOST_REQUIRE_EQUAL(streamingQdafn.NumProjections(), 10);
+  for (size_t i = 0; i < 10; ++i)
+    CheckMatrices(qdafn.CandidateSet(i), streamingQdafn.CandidateSet(i));
+
+  arma::Mat<size_t> neighbors, streamingNeighbors;
+  arma::mat distances, streamingDistances;
+  qdafn.Search(dataset, 3, neighbors, distances);
+  streamingQdafn.Search(dataset, 3, streamingNeighbors, streamingDistances);
+
+  CheckMatrices(neighbors, streamingNeighbors);
+  CheckMatrices(distances, streamingDistances);
+
+  // Batches of the wrong dimensionality can't be added.
+  BOOST_REQUIRE_THROW(streamingQdafn.Update(arma::randu<arma::mat>(5, 10)),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -58,4 +58,45 @@ BOOST_AUTO_TEST_CASE(Radical_Test_Radical3D)
   BOOST_REQUIRE_CLOSE(valBest, valEst, 2.0);
 }
 
+/**
+ * Make sure that the parallel angle search of DoRadical2D(), which repairs the
+ * sorted order of the previous angle instead of sorting, finds the same angle
+ * as sorting every rotation from scratch, for any number of threads.
+ */
+BOOST_AUTO_TEST_CASE(Radical2DAngleSearchTest)
+{
+  const size_t oldCount = Threads::Count();
+
+  mat matX = randu<mat>(200, 2);
+  matX.col(1) += 0.5 * matX.col(0);
+
+  Radical rad(0.175, 10, 150);
+  rad.M() = 20;
+
+  // Find the best angle by sorting every rotated projection.
+  math::RandomSeed(12);
+  mat perturbed;
+  rad.CopyAndPerturb(perturbed, matX);
+  vec values(rad.Angles());
+  for (size_t i = 0; i < rad.Angles(); ++i)
+  {
+    const double theta = (i / (double) rad.Angles()) * M_PI / 2.0;
+    vec y1 = cos(theta) * perturbed.col(0) - sin(theta) * perturbed.col(1);
+    vec y2 = sin(theta) * perturbed.col(0) + cos(theta) * perturbed.col(1);
+    values(i) = rad.Vasicek(y1) + rad.Vasicek(y2);
+  }
+  uword best = 0;
+  values.min(best);
+  const double bestTheta = (best / (double) rad.Angles()) * M_PI / 2.0;
+
+  for (size_t threads = 1; threads <= 4; threads += 3)
+  {
+    Threads::SetCount(threads);
+    math::RandomSeed(12);
+    BOOST_REQUIRE_CLOSE(rad.DoRadical2D(matX), bestTheta, 1e-10);
+  }
+
+  Threads::SetCount(oldCount);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -96,6 +97,42 @@ BOOST_AUTO_TEST_CASE(BootstrapWeightsTest)
   }
 }
 
+/**
+ * Make sure bootstrap sampling of indices gives distinct points whose
+ * multiplicities add up to the number of points.
+ */
+BOOST_AUTO_TEST_CASE(BootstrapIndicesTest)
+{
+  arma::rowvec weights(1000, arma::fill::randu);
+
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::uvec points;
+    arma::rowvec multiplicities, bootstrapWeights;
+    Bootstrap<false>(1000, weights, points, multiplicities);
+
+    BOOST_REQUIRE_EQUAL(multiplicities.n_elem, points.n_elem);
+    BOOST_REQUIRE_CLOSE(arma::accu(multiplicities), 1000.0, 1e-5);
+    for (size_t i = 0; i < points.n_elem; ++i)
+    {
+      BOOST_REQUIRE_LT(points[i], 1000);
+      if (i > 0)
+        BOOST_REQUIRE_GT(points[i], points[i - 1]);
+      BOOST_REQUIRE_GE(multiplicities[i], 1.0);
+    }
+
+    // With weights, each multiplicity is scaled by the weight of the point.
+    Bootstrap<true>(1000, weights, points, bootstrapWeights);
+    BOOST_REQUIRE_EQUAL(bootstrapWeights.n_elem, points.n_elem);
+    for (size_t i = 0; i < points.n_elem; ++i)
+    {
+      const double multiplicity = bootstrapWeights[i] / weights[points[i]];
+      BOOST_REQUIRE_GE(multiplicity, 1.0 - 1e-5);
+      BOOST_REQUIRE_SMALL(multiplicity - std::round(multiplicity), 1e-5);
+    }
+  }
+}
+
 /**
  * Make sure an empty forest cannot predict.
  */
@@ -395,4 +432,103 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
       binaryProbabilities);
 }
 
+/**
+ * Make sure that a random forest trained on binned data classifies well.
+ */
+BOOST_AUTO_TEST_CASE(BinnedNumericLearningTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  // Use fewer bins than distinct values, so that the bins are quantiles.
+  BinnedDataset binnedData(dataset, 32);
+  RandomForest<GiniGain, RandomDimensionSelect> rf;
+  rf.TrainBinned(binnedData, labels, 3, 10 /* 10 trees */, 5);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testDataset, predictions);
+
+  const size_t correct = arma::accu(predictions == testLabels);
+  BOOST_REQUIRE_GE(correct, size_t(0.7 * testDataset.n_cols));
+}
+
+/**
+ * A flattened forest or tree should give the same predictions and
+ * probabilities as the model it was flattened from, with categorical and
+ * numeric splits.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestMatchesForestTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 15 /* 15 trees */, 5);
+  DecisionTree<> dt(trainingData, di, trainingLabels, 5, 5);
+  FlatForest flatForest(rf);
+  FlatForest flatTree(dt);
+  BOOST_REQUIRE_EQUAL(flatForest.NumTrees(), 15);
+  BOOST_REQUIRE_EQUAL(flatTree.NumTrees(), 1);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(testData, predictions, probabilities);
+  flatForest.Classify(testData, flatPredictions, flatProbabilities);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != flatPredictions), 0);
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(probabilities[i] + 1.0, flatProbabilities[i] + 1.0,
+        1e-10);
+
+  dt.Classify(testData, predictions);
+  flatTree.Classify(testData, flatPredictions);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != flatPredictions), 0);
+  BOOST_REQUIRE_EQUAL(flatTree.Classify(testData.col(0)), predictions[0]);
+}
+
+/**
+ * A random forest trained on a sparse dataset must classify sparse points the
+ * same way as the same points made dense.
+ */
+BOOST_AUTO_TEST_CASE(SparseLearningTest)
+{
+  arma::sp_mat data;
+  data.sprandu(30, 1000, 0.15);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (data(3, i) > 0.5 ? 1 : 0) + (data(17, i) > 0.2 ? 1 : 0);
+
+  const arma::sp_mat trainingData = data.cols(0, 599);
+  const arma::Row<size_t> trainingLabels = labels.subvec(0, 599);
+  const arma::sp_mat testData = data.cols(600, 999);
+  const arma::mat denseTestData(testData);
+
+  RandomForest<GiniGain, RandomDimensionSelect> rf(trainingData,
+      trainingLabels, 3, 20 /* 20 trees */, 1);
+
+  arma::Row<size_t> predictions, densePredictions;
+  arma::mat probabilities, denseProbabilities;
+  rf.Classify(testData, predictions, probabilities);
+  rf.Classify(denseTestData, densePredictions, denseProbabilities);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != densePredictions), 0);
+  CheckMatrices(probabilities, denseProbabilities);
+
+  rf.Classify(testData, predictions);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != densePredictions), 0);
+
+  const size_t correct = arma::accu(predictions == labels.subvec(600, 999));
+  BOOST_REQUIRE_GT(correct, 0.85 * 400);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,163 @@
+/**
+ * @file random_fourier_features_test.cpp
+ *
+ * Test the RandomFourierFeatures class and its use in KernelPCA.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
+#include <mlpack/methods/kernel_pca/kernel_pca.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_method.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kernel;
+using namespace mlpack::kpca;
+
+BOOST_AUTO_TEST_SUITE(RandomFourierFeaturesTest);
+
+/**
+ * Check that the inner products of the features approximate the kernel.
+ */
+template<typename KernelType>
+void CheckKernelApproximation(const KernelType& kernel)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 40);
+
+  RandomFourierFeatures<KernelType> rff(3, 4000, kernel);
+  BOOST_REQUIRE_EQUAL(rff.NumFeatures(), 8000);
+
+  arma::mat features;
+  rff.Transform(data, features);
+  BOOST_REQUIRE_EQUAL(features.n_rows, 8000);
+  BOOST_REQUIRE_EQUAL(features.n_cols, 40);
+
+  const arma::mat approximation = features.t() * features;
+  double error = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    // The inner product of a point with itself is exactly 1.
+    BOOST_REQUIRE_CLOSE(approximation(i, i), 1.0, 1e-5);
+    for (size_t j = 0; j < data.n_cols; ++j)
+      error += std::abs(approximation(i, j) - kernel.Evaluate(data.col(i),
+          data.col(j)));
+  }
+
+  BOOST_REQUIRE_LT(error / (data.n_cols * data.n_cols), 0.03);
+}
+
+BOOST_AUTO_TEST_CASE(GaussianApproximationTest)
+{
+  CheckKernelApproximation(GaussianKernel(0.5));
+}
+
+BOOST_AUTO_TEST_CASE(LaplacianApproximationTest)
+{
+  CheckKernelApproximation(LaplacianKernel(0.8));
+}
+
+/**
+ * Transforming a dataset in chunks must give the same features as
+ * transforming it at once, and points of the wrong dimensionality must be
+ * rejected.
+ */
+BOOST_AUTO_TEST_CASE(ChunkedTransformTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 700);
+  RandomFourierFeatures<GaussianKernel> rff(4, 50);
+
+  arma::mat features, firstFeatures, lastFeatures;
+  rff.Transform(data, features);
+  rff.Transform(data.cols(0, 299), firstFeatures);
+  rff.Transform(data.cols(300, 699), lastFeatures);
+
+  const arma::mat joinedFeatures = arma::join_rows(firstFeatures,
+      lastFeatures);
+  CheckMatrices(features, joinedFeatures);
+
+  BOOST_REQUIRE_THROW(rff.Transform(arma::randu<arma::mat>(3, 10), features),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(rff.Reset(4, 0), std::invalid_argument);
+}
+
+/**
+ * A serialized feature map must give the same features.
+ */
+BOOST_AUTO_TEST_CASE(SerializationTest)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+  RandomFourierFeatures<LaplacianKernel> rff(3, 20, LaplacianKernel(2.0));
+
+  RandomFourierFeatures<LaplacianKernel> xmlRff, textRff, binaryRff;
+  SerializeObjectAll(rff, xmlRff, textRff, binaryRff);
+
+  arma::mat features, xmlFeatures, textFeatures, binaryFeatures;
+  rff.Transform(data, features);
+  xmlRff.Transform(data, xmlFeatures);
+  textRff.Transform(data, textFeatures);
+  binaryRff.Transform(data, binaryFeatures);
+
+  CheckMatrices(features, xmlFeatures);
+  CheckMatrices(features, textFeatures);
+  CheckMatrices(features, binaryFeatures);
+}
+
+/**
+ * KernelPCA with random Fourier features must project the centered features
+ * onto their principal components, which preserves their Gram matrix, and the
+ * result must approximate the centered kernel matrix.
+ */
+BOOST_AUTO_TEST_CASE(KernelPCARandomFourierTest)
+{
+  arma::mat data = arma::randu<arma::mat>(2, 50);
+  GaussianKernel kernel(0.5);
+
+  math::RandomSeed(42);
+  arma::mat transformedData, eigvec;
+  arma::vec eigval;
+  KernelPCA<GaussianKernel, RandomFourierKernelRule<GaussianKernel>>
+      kpca(kernel);
+  kpca.Apply(data, transformedData, eigval, eigvec, 2000);
+
+  BOOST_REQUIRE_EQUAL(transformedData.n_rows, 2000);
+  BOOST_REQUIRE_EQUAL(transformedData.n_cols, 50);
+  for (size_t i = 1; i < eigval.n_elem; ++i)
+    BOOST_REQUIRE_GE(eigval[i - 1], eigval[i]);
+
+  // Draw the same features again.
+  math::RandomSeed(42);
+  RandomFourierFeatures<GaussianKernel> rff(2, 1000, kernel);
+  arma::mat features;
+  rff.Transform(data, features);
+  features.each_col() -= arma::mean(features, 1);
+
+  const arma::mat gram = transformedData.t() * transformedData;
+  const arma::mat featureGram = features.t() * features;
+  CheckMatrices(gram, featureGram, 1e-3);
+
+  // Center the exact kernel matrix.
+  arma::mat kernelMatrix(data.n_cols, data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    for (size_t j = 0; j < data.n_cols; ++j)
+      kernelMatrix(i, j) = kernel.Evaluate(data.col(i), data.col(j));
+  arma::rowvec rowMean = arma::sum(kernelMatrix, 0) / kernelMatrix.n_cols;
+  kernelMatrix.each_col() -= arma::sum(kernelMatrix, 1) / kernelMatrix.n_cols;
+  kernelMatrix.each_row() -= rowMean;
+  kernelMatrix += arma::sum(rowMean) / kernelMatrix.n_cols;
+
+  BOOST_REQUIRE_LT(arma::mean(arma::vectorise(arma::abs(gram -
+      kernelMatrix))), 0.05);
+
+  // Dimensionality reduction keeps the requested number of components.
+  kpca.Apply(data, 3);
+  BOOST_REQUIRE_EQUAL(data.n_rows, 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
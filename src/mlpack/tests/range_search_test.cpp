@@ -1334,6 +1334,68 @@ BOOST_AUTO_TEST_CASE(RSModelTest)
   }
 }
 
+/**
+ * Ensure that single precision RSModels give the same results as a double
+ * precision search on the same (float-representable) data.
+ */
+BOOST_AUTO_TEST_CASE(RSModelSinglePrecisionTest)
+{
+  arma::mat referenceData = arma::conv_to<arma::mat>::from(
+      arma::randu<arma::fmat>(10, 200));
+  arma::mat queryData = arma::conv_to<arma::mat>::from(
+      arma::randu<arma::fmat>(10, 50));
+
+  RangeSearch<> rs(referenceData);
+  vector<vector<size_t>> baselineNeighbors;
+  vector<vector<double>> baselineDistances;
+  rs.Search(queryData, math::Range(0.25, 0.75), baselineNeighbors,
+      baselineDistances);
+
+  vector<vector<pair<double, size_t>>> baselineSorted;
+  SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+
+  const RSModel::TreeTypes treeTypes[] = { RSModel::KD_TREE,
+      RSModel::BALL_TREE, RSModel::VP_TREE, RSModel::RP_TREE,
+      RSModel::MAX_RP_TREE, RSModel::UB_TREE };
+
+  for (size_t t = 0; t < 6; ++t)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      RSModel model(treeTypes[t], false, true);
+
+      arma::mat referenceCopy(referenceData);
+      arma::mat queryCopy(queryData);
+      model.BuildModel(std::move(referenceCopy), 5, (j == 2), (j == 1));
+
+      BOOST_REQUIRE(model.SinglePrecision());
+      BOOST_REQUIRE_EQUAL(model.NumReferencePoints(), referenceData.n_cols);
+
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      model.Search(std::move(queryCopy), math::Range(0.25, 0.75), neighbors,
+          distances);
+
+      BOOST_REQUIRE_EQUAL(neighbors.size(), baselineNeighbors.size());
+      BOOST_REQUIRE_EQUAL(distances.size(), baselineDistances.size());
+
+      vector<vector<pair<double, size_t>>> sorted;
+      SortResults(neighbors, distances, sorted);
+
+      for (size_t k = 0; k < sorted.size(); ++k)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[k].size(), baselineSorted[k].size());
+        for (size_t l = 0; l < sorted[k].size(); ++l)
+        {
+          BOOST_REQUIRE_EQUAL(sorted[k][l].second, baselineSorted[k][l].second);
+          BOOST_REQUIRE_CLOSE(sorted[k][l].first, baselineSorted[k][l].first,
+              1e-3);
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(RSModelMonochromaticTest)
 {
   // Ensure that we can build an RSModel and get correct results.
@@ -1696,4 +1758,103 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+/**
+ * Make sure that the callback, compressed (CSR) and counting searches return
+ * the same results as the regular search, for every search mode, both with a
+ * query set and without one.
+ */
+BOOST_AUTO_TEST_CASE(StreamingResultsTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 400);
+  arma::mat queryData = arma::randu<arma::mat>(3, 150);
+  const math::Range range(0.1, 0.35);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceData, mode == 0, mode == 1);
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      const size_t numQueries = mono ? referenceData.n_cols : queryData.n_cols;
+
+      // The regular search.
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      if (mono)
+        rs.Search(range, neighbors, distances);
+      else
+        rs.Search(queryData, range, neighbors, distances);
+      vector<vector<pair<double, size_t>>> sortedResults;
+      SortResults(neighbors, distances, sortedResults);
+
+      // The callback search.
+      vector<vector<size_t>> callbackNeighbors(numQueries);
+      vector<vector<double>> callbackDistances(numQueries);
+      auto collect = [&](const size_t queryIndex,
+                         const size_t referenceIndex,
+                         const double distance)
+      {
+        callbackNeighbors[queryIndex].push_back(referenceIndex);
+        callbackDistances[queryIndex].push_back(distance);
+      };
+      if (mono)
+        rs.Search(range, collect);
+      else
+        rs.Search(queryData, range, collect);
+      vector<vector<pair<double, size_t>>> sortedCallbackResults;
+      SortResults(callbackNeighbors, callbackDistances, sortedCallbackResults);
+
+      // The CSR search.
+      arma::Col<size_t> offsets, csrNeighbors;
+      arma::vec csrDistances;
+      if (mono)
+        rs.Search(range, offsets, csrNeighbors, csrDistances);
+      else
+        rs.Search(queryData, range, offsets, csrNeighbors, csrDistances);
+      BOOST_REQUIRE_EQUAL(offsets.n_elem, numQueries + 1);
+      vector<vector<size_t>> csrNeighborVectors(numQueries);
+      vector<vector<double>> csrDistanceVectors(numQueries);
+      for (size_t i = 0; i < numQueries; ++i)
+      {
+        for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+        {
+          csrNeighborVectors[i].push_back(csrNeighbors[j]);
+          csrDistanceVectors[i].push_back(csrDistances[j]);
+        }
+      }
+      vector<vector<pair<double, size_t>>> sortedCSRResults;
+      SortResults(csrNeighborVectors, csrDistanceVectors, sortedCSRResults);
+
+      // The counting search.
+      arma::Col<size_t> counts;
+      if (mono)
+        rs.Count(range, counts);
+      else
+        rs.Count(queryData, range, counts);
+      BOOST_REQUIRE_EQUAL(counts.n_elem, numQueries);
+
+      for (size_t i = 0; i < numQueries; ++i)
+      {
+        BOOST_REQUIRE_EQUAL(sortedCallbackResults[i].size(),
+            sortedResults[i].size());
+        BOOST_REQUIRE_EQUAL(sortedCSRResults[i].size(),
+            sortedResults[i].size());
+        BOOST_REQUIRE_EQUAL(counts[i], sortedResults[i].size());
+
+        for (size_t j = 0; j < sortedResults[i].size(); ++j)
+        {
+          BOOST_REQUIRE_EQUAL(sortedCallbackResults[i][j].second,
+              sortedResults[i][j].second);
+          BOOST_REQUIRE_CLOSE(sortedCallbackResults[i][j].first,
+              sortedResults[i][j].first, 1e-5);
+          BOOST_REQUIRE_EQUAL(sortedCSRResults[i][j].second,
+              sortedResults[i][j].second);
+          BOOST_REQUIRE_CLOSE(sortedCSRResults[i][j].first,
+              sortedResults[i][j].first, 1e-5);
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
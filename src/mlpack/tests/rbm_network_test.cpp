@@ -249,4 +249,73 @@ BOOST_AUTO_TEST_CASE(MiscTest)
   BuildVanillaNetwork<arma::Mat<float>>(X, 2);
 }
 
+/*
+ * Check that the persistent chains keep their number, that the samples are
+ * binary, and that the sampling frequencies match the means.
+ */
+BOOST_AUTO_TEST_CASE(BinaryRBMGibbsChainsTest)
+{
+  arma::mat data = arma::conv_to<arma::mat>::from(arma::randu(20, 40) > 0.5);
+
+  GaussianInitialization gaussian(0, 0.5);
+  RBM<GaussianInitialization> model(data, gaussian, 20, 10, 8, 2, 1, 2, 8, 1,
+      true);
+  model.Reset();
+
+  arma::mat output;
+  model.Gibbs(std::move(data.cols(0, 7)), std::move(output));
+  BOOST_REQUIRE_EQUAL(output.n_rows, 20);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 8);
+  BOOST_REQUIRE(arma::all(arma::vectorise((output == 0) + (output == 1)) ==
+      1));
+
+  // The chains continue, even if the batch is smaller.
+  model.Gibbs(std::move(data.cols(8, 10)), std::move(output));
+  BOOST_REQUIRE_EQUAL(output.n_cols, 8);
+
+  // Sample many chains from the same point.
+  arma::mat mean, samples;
+  model.HiddenMean(std::move(data.col(0)), std::move(mean));
+  model.SampleHidden(std::move(arma::repmat(data.col(0), 1, 10000)),
+      std::move(samples));
+  BOOST_REQUIRE_EQUAL(samples.n_cols, 10000);
+  for (size_t i = 0; i < mean.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(arma::mean(samples.row(i)) - mean(i), 0.03);
+}
+
+/*
+ * Compare the means of the spike and slab variables with the definition.
+ */
+BOOST_AUTO_TEST_CASE(ssRBMMeanTest)
+{
+  const size_t visibleSize = 6, hiddenSize = 4, poolSize = 3;
+  const double slabPenalty = 8;
+  arma::mat data = arma::randu(visibleSize, 5);
+
+  GaussianInitialization gaussian(0, 0.5);
+  RBM<GaussianInitialization, arma::mat, SpikeSlabRBM> model(data, gaussian,
+      visibleSize, hiddenSize, 5, 1, 1, poolSize, slabPenalty, 10);
+  model.Reset();
+
+  arma::mat spikeMean(hiddenSize, 1), slabMean(poolSize, hiddenSize);
+  model.SpikeMean(std::move(data), std::move(spikeMean));
+  arma::mat spike = arma::conv_to<arma::mat>::from(arma::randu(hiddenSize) >
+      0.5);
+  model.SlabMean(std::move(data), std::move(spike), std::move(slabMean));
+
+  for (size_t i = 0; i < hiddenSize; ++i)
+  {
+    const arma::mat& w = model.Weight().slice(i);
+    const double expectedSpike = 1.0 / (1.0 + std::exp(-(0.5 / slabPenalty *
+        arma::accu(data.t() * (w * w.t()) * data) / std::pow(data.n_cols, 2) +
+        model.SpikeBias()(i))));
+    BOOST_REQUIRE_CLOSE(spikeMean(i), expectedSpike, 1e-5);
+
+    const arma::vec expectedSlab = arma::mean((1.0 / slabPenalty) * spike(i) *
+        w.t() * data, 1);
+    for (size_t j = 0; j < poolSize; ++j)
+      BOOST_REQUIRE_SMALL(slabMean(j, i) - expectedSlab(j), 1e-8);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
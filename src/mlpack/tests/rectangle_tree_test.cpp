@@ -1384,4 +1384,111 @@ BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Build the given tree type with bulk loading and check the structure of the
+ * tree and the results of a nearest neighbor search with it.
+ */
+template<template<typename, typename, typename> class TreeType>
+void CheckBulkLoad(const arma::mat& dataset,
+                   void (*checkTree)(const TreeType<EuclideanDistance,
+                       NeighborSearchStat<NearestNeighborSort>, arma::mat>&))
+{
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+
+  Tree tree(dataset, 20, 6, 5, 2, 0, true);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), dataset.n_cols);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  CheckFills(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+  BOOST_REQUIRE_EQUAL(tree.TreeDepth(), GetMinLevel(tree));
+  checkTree(tree);
+
+  arma::Mat<size_t> neighbors1, neighbors2;
+  arma::mat distances1, distances2;
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      TreeType> knn1(std::move(tree), SINGLE_TREE_MODE);
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+template<typename TreeType>
+void CheckNothing(const TreeType& /* tree */) { }
+
+template<typename TreeType>
+void CheckHilbertRTree(const TreeType& tree)
+{
+  CheckHilbertOrdering(tree);
+  CheckDiscreteHilbertValueSync(tree);
+  CheckHilbertValue(tree);
+}
+
+/**
+ * Make sure that bulk-loaded trees of every type are valid.  With 1000 points,
+ * 20 points per leaf and 5 children per node, every node is filled to
+ * capacity.
+ */
+BOOST_AUTO_TEST_CASE(RectangleTreeBulkLoadTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef NeighborSearchStat<NearestNeighborSort> StatType;
+
+  CheckBulkLoad<RTree>(dataset,
+      CheckNothing<RTree<EuclideanDistance, StatType, arma::mat>>);
+  CheckBulkLoad<RStarTree>(dataset,
+      CheckNothing<RStarTree<EuclideanDistance, StatType, arma::mat>>);
+  CheckBulkLoad<XTree>(dataset,
+      CheckNothing<XTree<EuclideanDistance, StatType, arma::mat>>);
+  CheckBulkLoad<HilbertRTree>(dataset,
+      CheckHilbertRTree<HilbertRTree<EuclideanDistance, StatType, arma::mat>>);
+  CheckBulkLoad<RPlusTree>(dataset,
+      CheckOverlap<RPlusTree<EuclideanDistance, StatType, arma::mat>>);
+  CheckBulkLoad<RPlusPlusTree>(dataset,
+      CheckRPlusPlusTreeBound<RPlusPlusTree<EuclideanDistance, StatType,
+          arma::mat>>);
+}
+
+/**
+ * Make sure that points can still be inserted into a bulk-loaded tree.
+ */
+BOOST_AUTO_TEST_CASE(RectangleTreeBulkLoadInsertionTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef HilbertRTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> TreeType;
+
+  TreeType tree(dataset, 20, 6, 5, 2, 0, true);
+
+  // Add new points to the dataset that the tree holds, and insert them.
+  const size_t numIter = 500;
+  tree.Dataset().reshape(8, 1000 + numIter);
+  tree.Dataset().cols(1000, 1000 + numIter - 1).randu();
+  for (size_t i = 0; i < numIter; i++)
+    tree.InsertPoint(1000 + i);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000 + numIter);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  CheckHilbertRTree(tree);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
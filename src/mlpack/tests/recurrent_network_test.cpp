@@ -883,6 +883,167 @@ BOOST_AUTO_TEST_CASE(GRUBatchSizeTest)
   BatchSizeTest<GRU<>>();
 }
 
+/**
+ * Make sure truncated BPTT with a single window matches the full BPTT pass, and
+ * that a sequence processed in smaller windows, which carry the cell state
+ * over, gives the same objective and predictions as the full forward pass.
+ */
+template<typename RecurrentLayerType>
+void TruncatedBPTTTest()
+{
+  const size_t rho = 10;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, rho, 6);
+
+  arma::cube labels = arma::zeros<arma::cube>(1, labelsTemp.n_cols, rho);
+  for (size_t i = 0; i < labelsTemp.n_cols; ++i)
+  {
+    const int value = arma::as_scalar(arma::find(
+        arma::max(labelsTemp.col(i)) == labelsTemp.col(i), 1)) + 1;
+    labels.tube(0, i).fill(value);
+  }
+
+  RNN<> model(rho);
+  model.Add<Linear<>>(1, 10);
+  model.Add<SigmoidLayer<>>();
+  model.Add<RecurrentLayerType>(10, 10);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(10, 10);
+  model.Add<LogSoftMax<>>();
+
+  model.Reset();
+  model.Predictors() = input;
+  model.Responses() = labels;
+
+  arma::mat gradient, windowGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 4);
+
+  arma::cube prediction;
+  model.Predict(input, prediction);
+
+  // A stride equal to the sequence length gives a single window.
+  model.Stride() = rho;
+  double windowObjective = model.EvaluateWithGradient(model.Parameters(), 0,
+      windowGradient, 4);
+
+  BOOST_REQUIRE_CLOSE(objective, windowObjective, 1e-5);
+  CheckMatrices(gradient, windowGradient);
+
+  // Backpropagate through windows of 2 steps.  The forward pass still runs
+  // over the whole sequence, so only the gradient changes.
+  model.Rho() = 4;
+  model.Stride() = 2;
+  windowObjective = model.EvaluateWithGradient(model.Parameters(), 0,
+      windowGradient, 4);
+
+  BOOST_REQUIRE_CLOSE(objective, windowObjective, 1e-5);
+  BOOST_REQUIRE_EQUAL(windowGradient.n_elem, model.Parameters().n_elem);
+  BOOST_REQUIRE(windowGradient.is_finite());
+
+  // Windows of 3 steps leave a shorter last window.
+  model.Stride() = 3;
+  BOOST_REQUIRE_CLOSE(objective, model.Evaluate(model.Parameters(), 0, 4),
+      1e-5);
+
+  arma::cube windowPrediction;
+  model.Predict(input, windowPrediction);
+
+  BOOST_REQUIRE_EQUAL(windowPrediction.n_cols, input.n_cols);
+  BOOST_REQUIRE_EQUAL(windowPrediction.n_slices, rho);
+  CheckMatrices(prediction, windowPrediction);
+}
+
+/**
+ * Test truncated BPTT with LSTM cells.
+ */
+BOOST_AUTO_TEST_CASE(LSTMTruncatedBPTTTest)
+{
+  TruncatedBPTTTest<LSTM<>>();
+}
+
+/**
+ * Test truncated BPTT with fast LSTM cells.
+ */
+BOOST_AUTO_TEST_CASE(FastLSTMTruncatedBPTTTest)
+{
+  TruncatedBPTTTest<FastLSTM<>>();
+}
+
+/**
+ * Test truncated BPTT with GRU cells.
+ */
+BOOST_AUTO_TEST_CASE(GRUTruncatedBPTTTest)
+{
+  TruncatedBPTTTest<GRU<>>();
+}
+
+/**
+ * Make sure that predicting the batches in parallel, with copies of the
+ * network that have their own cell state, gives the same predictions as
+ * predicting them serially, also after the parameters are changed.
+ */
+BOOST_AUTO_TEST_CASE(ParallelPredictTest)
+{
+  const size_t rho = 10;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, rho, 6);
+
+  arma::cube labels = arma::zeros<arma::cube>(1, labelsTemp.n_cols, rho);
+  for (size_t i = 0; i < labelsTemp.n_cols; ++i)
+  {
+    const int value = arma::as_scalar(arma::find(
+        arma::max(labelsTemp.col(i)) == labelsTemp.col(i), 1)) + 1;
+    labels.tube(0, i).fill(value);
+  }
+
+  RNN<> model(rho);
+  model.Add<Linear<>>(1, 10);
+  model.Add<LSTM<>>(10, 10);
+  model.Add<GRU<>>(10, 10);
+  model.Add<Linear<>>(10, 10);
+  model.Add<LogSoftMax<>>();
+
+  model.Reset();
+  model.Predictors() = input;
+  model.Responses() = labels;
+  model.Evaluate(model.Parameters(), 0, 4);
+
+  const size_t previousCount = Threads::Count();
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    if (trial == 1)
+      model.Parameters() *= 0.5; // The copies use the same memory.
+    else if (trial == 2)
+      model.Reset(); // The copies have to use the new parameters.
+
+    arma::cube prediction, parallelPrediction;
+    Threads::SetCount(1);
+    model.Predict(input, prediction, 3);
+    Threads::SetCount(4);
+    model.Predict(input, parallelPrediction, 3);
+
+    BOOST_REQUIRE_EQUAL(parallelPrediction.n_cols, input.n_cols);
+    CheckMatrices(prediction, parallelPrediction);
+  }
+
+  // The same must hold with windows.
+  model.Rho() = 4;
+  model.Stride() = 2;
+  arma::cube prediction, parallelPrediction;
+  Threads::SetCount(1);
+  model.Predict(input, prediction, 5);
+  Threads::SetCount(4);
+  model.Predict(input, parallelPrediction, 5);
+  CheckMatrices(prediction, parallelPrediction);
+
+  Threads::SetCount(previousCount);
+}
+
 /**
  * Make sure the RNN can be properly serialized.
  */
@@ -19,6 +19,15 @@
 #include <mlpack/methods/reinforcement_learning/environment/acrobat.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/prioritized_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/compact_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/vector_environment.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/batch_environment.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/external_environment.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/frame_stack.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/observation_normalization.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/action_repeat.hpp>
+#include <mlpack/methods/reinforcement_learning/distributed/local_transport.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -166,6 +175,631 @@ BOOST_AUTO_TEST_CASE(RandomReplayTest)
   }
 }
 
+/**
+ * Make sure that the sum tree keeps the sums of its values, and finds each
+ * value by its prefix sum.
+ */
+BOOST_AUTO_TEST_CASE(SumTreeTest)
+{
+  SumTree<> tree(5);
+  BOOST_REQUIRE_EQUAL(tree.Size(), 5);
+  BOOST_REQUIRE_EQUAL(tree.Sum(), 0.0);
+
+  for (size_t i = 0; i < 5; ++i)
+    tree.Set(i, i + 1.0);
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 15.0, 1e-5);
+
+  // The prefix sums are 1, 3, 6, 10, 15.
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(0.0), 0);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(0.5), 0);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(2.0), 1);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(5.9), 2);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(6.1), 3);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(14.9), 4);
+
+  // Masses past the end find the last nonzero value.
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(20.0), 4);
+
+  // Zero values are never found.
+  tree.Set(1, 0.0);
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 13.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(tree.Get(1), 0.0);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(1.0), 2);
+}
+
+/**
+ * Construct a prioritized replay instance and make sure that transitions are
+ * sampled according to their priorities, with the right weights.
+ */
+BOOST_AUTO_TEST_CASE(PrioritizedReplayTest)
+{
+  PrioritizedReplay<MountainCar> replay(1, 3, 1.0, 1.0);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+  double reward = env.Sample(state, action, nextState);
+  replay.Store(state, action, reward, nextState, false);
+  replay.Store(nextState, action, reward, state, true);
+  BOOST_REQUIRE_EQUAL(2, replay.Size());
+
+  // New transitions get the maximum priority.
+  BOOST_REQUIRE_CLOSE(replay.Priority(0), 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(replay.Priority(1), 1.0, 1e-5);
+
+  // Make the second transition much more likely than the first.
+  replay.UpdatePriorities(arma::uvec({ 0, 1 }), arma::colvec({ 0.01, 10.0 }));
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  size_t secondCount = 0;
+  for (size_t i = 0; i < 200; ++i)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+
+    // A batch of one transition always has weight 1.
+    BOOST_REQUIRE_CLOSE(replay.Weights()[0], 1.0, 1e-5);
+    if (replay.SampledIndices()[0] == 1)
+    {
+      CheckMatrices(nextState.Encode(), sampledState);
+      BOOST_REQUIRE_EQUAL(true, arma::as_scalar(sampledTerminal));
+      ++secondCount;
+    }
+  }
+  BOOST_REQUIRE_GT(secondCount, 190);
+
+  // Updating from the TD errors of the last sample should set the priority of
+  // the sampled transition.
+  arma::colvec weights;
+  const size_t sampled = replay.SampledIndices()[0];
+  replay.Update(arma::colvec({ 3.0 }), weights);
+  BOOST_REQUIRE_EQUAL(weights.n_elem, 1);
+  BOOST_REQUIRE_CLOSE(replay.Priority(sampled), 3.0 + 1e-6, 1e-5);
+}
+
+/**
+ * Make sure the importance-sampling weights of a prioritized replay batch
+ * undo the bias of the sampling.
+ */
+BOOST_AUTO_TEST_CASE(PrioritizedReplayWeightsTest)
+{
+  PrioritizedReplay<MountainCar> replay(2, 2, 1.0, 1.0);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+  double reward = env.Sample(state, action, nextState);
+  replay.Store(state, action, reward, nextState, false);
+  replay.Store(state, action, reward, nextState, false);
+
+  // The second transition is three times as likely to be sampled.
+  replay.UpdatePriorities(arma::uvec({ 0, 1 }), arma::colvec({ 1.0, 3.0 }));
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+
+    // With beta = 1, the weight is inversely proportional to the priority.
+    const arma::uvec& indices = replay.SampledIndices();
+    const arma::colvec& weights = replay.Weights();
+    for (size_t j = 0; j < 2; ++j)
+    {
+      const double expected = (indices[j] == 0) ? 1.0 :
+          ((indices[0] == 0 || indices[1] == 0) ? 1.0 / 3.0 : 1.0);
+      BOOST_REQUIRE_CLOSE(weights[j], expected, 1e-3);
+    }
+  }
+}
+
+/**
+ * Make sure that the compact replay returns the stored transitions, and stores
+ * the states shared by consecutive transitions only once.
+ */
+BOOST_AUTO_TEST_CASE(CompactReplayTest)
+{
+  CompactReplay<MountainCar> replay(1, 5);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+  double reward = env.Sample(state, action, nextState);
+  replay.Store(state, action, reward, nextState, false);
+
+  // The second transition starts where the first ended.
+  MountainCar::State lastState;
+  env.Sample(nextState, action, lastState);
+  replay.Store(nextState, action, reward, lastState, true);
+
+  BOOST_REQUIRE_EQUAL(replay.Size(), 2);
+  BOOST_REQUIRE_EQUAL(replay.NumStates(), 3);
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+
+    BOOST_REQUIRE_EQUAL(sampledState.n_cols, 1);
+    BOOST_REQUIRE_EQUAL(sampledAction[0], action);
+    BOOST_REQUIRE_CLOSE(sampledReward[0], reward, 1e-5);
+    if (sampledTerminal[0])
+    {
+      CheckMatrices(nextState.Encode(), sampledState);
+      CheckMatrices(lastState.Encode(), sampledNextState);
+    }
+    else
+    {
+      CheckMatrices(state.Encode(), sampledState);
+      CheckMatrices(nextState.Encode(), sampledNextState);
+    }
+  }
+}
+
+/**
+ * Make sure that when the state buffer of the compact replay is full, the
+ * transitions that used the overwritten states are dropped.
+ */
+BOOST_AUTO_TEST_CASE(CompactReplayStateCapacityTest)
+{
+  CompactReplay<MountainCar> replay(1, 3, MountainCar::State::dimension, 4);
+  BOOST_REQUIRE_EQUAL(replay.StateCapacity(), 4);
+
+  // Store transitions that do not share any states.
+  std::vector<MountainCar::State> states;
+  for (size_t i = 0; i < 6; ++i)
+  {
+    arma::colvec data(2);
+    data.fill(i);
+    states.push_back(MountainCar::State(data));
+  }
+
+  replay.Store(states[0], MountainCar::Action::forward, 0.0, states[1], false);
+  replay.Store(states[2], MountainCar::Action::forward, 1.0, states[3], false);
+  BOOST_REQUIRE_EQUAL(replay.Size(), 2);
+  BOOST_REQUIRE_EQUAL(replay.NumStates(), 4);
+
+  // This needs two more states, so the first transition has to go.
+  replay.Store(states[4], MountainCar::Action::forward, 2.0, states[5], true);
+  BOOST_REQUIRE_EQUAL(replay.Size(), 2);
+  BOOST_REQUIRE_EQUAL(replay.NumStates(), 4);
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+
+    const size_t reward = (size_t) sampledReward[0];
+    BOOST_REQUIRE_GE(reward, 1);
+    CheckMatrices(states[2 * reward].Encode(), sampledState);
+    CheckMatrices(states[2 * reward + 1].Encode(), sampledNextState);
+  }
+}
+
+/**
+ * Make sure the compact replay can store the states with a smaller type.
+ */
+BOOST_AUTO_TEST_CASE(CompactReplayElemTypeTest)
+{
+  CompactReplay<MountainCar, unsigned char> replay(2, 2);
+
+  arma::colvec data1({ 3, 250 });
+  arma::colvec data2({ 17, 0 });
+  MountainCar::State state(data1), nextState(data2);
+  replay.Store(state, MountainCar::Action::backward, -1.0, nextState, false);
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+
+  BOOST_REQUIRE_EQUAL(sampledState.n_cols, 2);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    CheckMatrices(data1, arma::mat(sampledState.col(i)));
+    CheckMatrices(data2, arma::mat(sampledNextState.col(i)));
+  }
+}
+
+/**
+ * Make sure that an n-step random replay accumulates the discounted rewards,
+ * completes the transitions at the end of an episode, and drops the ones of an
+ * episode that is cut off.
+ */
+BOOST_AUTO_TEST_CASE(NStepRandomReplayTest)
+{
+  RandomReplay<MountainCar> replay(50, 10, MountainCar::State::dimension, 3,
+      0.5);
+  BOOST_REQUIRE_EQUAL(replay.NSteps(), 3);
+
+  // State k is encoded as (k, 0).
+  auto state = [](const double k)
+  {
+    return MountainCar::State(arma::colvec({ k, 0.0 }));
+  };
+
+  // A whole episode, with rewards 1, 2, 4 and 8.
+  replay.Store(state(0), MountainCar::Action::forward, 1.0, state(1), false);
+  replay.Store(state(1), MountainCar::Action::forward, 2.0, state(2), false);
+  BOOST_REQUIRE_EQUAL(replay.Size(), 0);
+  replay.Store(state(2), MountainCar::Action::forward, 4.0, state(3), false);
+  BOOST_REQUIRE_EQUAL(replay.Size(), 1);
+  replay.Store(state(3), MountainCar::Action::forward, 8.0, state(4), true);
+  BOOST_REQUIRE_EQUAL(replay.Size(), 4);
+
+  // An episode cut off after one step, then one that doesn't end.
+  replay.Store(state(10), MountainCar::Action::forward, 1.0, state(11), false);
+  replay.Store(state(20), MountainCar::Action::forward, 1.0, state(21), false);
+  replay.Store(state(21), MountainCar::Action::forward, 1.0, state(22), false);
+  replay.Store(state(22), MountainCar::Action::forward, 1.0, state(23), false);
+  BOOST_REQUIRE_EQUAL(replay.Size(), 5);
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+
+  for (size_t i = 0; i < sampledState.n_cols; ++i)
+  {
+    const size_t k = (size_t) sampledState(0, i);
+    double reward = 0.0, next = 0.0;
+    int terminal = 0;
+    switch (k)
+    {
+      case 0: reward = 3.0; next = 3; terminal = 0; break;
+      case 1: reward = 6.0; next = 4; terminal = 1; break;
+      case 2: reward = 8.0; next = 4; terminal = 1; break;
+      case 3: reward = 8.0; next = 4; terminal = 1; break;
+      case 20: reward = 1.75; next = 23; terminal = 0; break;
+      default: BOOST_FAIL("unexpected sampled state");
+    }
+
+    BOOST_REQUIRE_CLOSE(sampledReward[i], reward, 1e-5);
+    BOOST_REQUIRE_EQUAL(sampledNextState(0, i), next);
+    BOOST_REQUIRE_EQUAL(sampledTerminal[i], terminal);
+  }
+}
+
+/**
+ * Make sure that a vectorized environment steps each of its instances like the
+ * environment itself would, and restarts the episodes that end.
+ */
+BOOST_AUTO_TEST_CASE(VectorEnvironmentTest)
+{
+  VectorEnvironment<CartPole> environments(3, CartPole(), 5);
+  BOOST_REQUIRE_EQUAL(environments.NumEnvironments(), 3);
+  BOOST_REQUIRE_EQUAL(environments.EncodedStates().n_rows,
+      CartPole::State::dimension);
+  BOOST_REQUIRE_EQUAL(environments.EncodedStates().n_cols, 3);
+
+  std::vector<CartPole::Action> actions(3, CartPole::Action::backward);
+  actions[1] = CartPole::Action::forward;
+  for (size_t step = 0; step < 5; ++step)
+  {
+    environments.Sample(actions);
+    for (size_t i = 0; i < 3; ++i)
+    {
+      CheckMatrices(environments.State(i).Encode(),
+          arma::mat(environments.EncodedStates().col(i)));
+
+      CartPole::State nextState;
+      const double reward = environments.Environment(i).Sample(
+          environments.State(i), actions[i], nextState);
+      BOOST_REQUIRE_CLOSE(reward, environments.Rewards()[i], 1e-5);
+      CheckMatrices(nextState.Encode(), environments.NextState(i).Encode());
+    }
+
+    environments.Advance();
+  }
+
+  // All the episodes reached the step limit, unless they ended earlier.
+  BOOST_REQUIRE_GE(environments.EpisodeReturns().size(), 3);
+}
+
+/**
+ * Make sure that a batch environment writes the observations each instance
+ * would give, and restarts the instances on the step after they are done.
+ */
+BOOST_AUTO_TEST_CASE(BatchEnvironmentTest)
+{
+  BatchEnvironment<CartPole> environments(2, CartPole(), 3);
+  BOOST_REQUIRE_EQUAL(environments.NumEnvironments(), 2);
+  BOOST_REQUIRE_EQUAL(environments.Dimension(), CartPole::State::dimension);
+
+  arma::mat observations;
+  arma::rowvec rewards;
+  arma::urowvec done(2, arma::fill::zeros);
+  environments.Reset(observations);
+  BOOST_REQUIRE_EQUAL(observations.n_rows, CartPole::State::dimension);
+  BOOST_REQUIRE_EQUAL(observations.n_cols, 2);
+
+  arma::Col<size_t> actions(2);
+  actions[0] = CartPole::Action::backward;
+  actions[1] = CartPole::Action::forward;
+  for (size_t step = 0; step < 4; ++step)
+  {
+    const arma::mat previous = observations;
+    const arma::urowvec previousDone = done;
+    const double* memory = observations.memptr();
+    environments.Step(actions, observations, rewards, done);
+
+    // The buffers are reused.
+    BOOST_REQUIRE_EQUAL(observations.memptr(), memory);
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+      CheckMatrices(environments.State(i).Encode(),
+          arma::mat(observations.col(i)));
+      if (previousDone[i])
+      {
+        // A new episode has started.
+        BOOST_REQUIRE_EQUAL(rewards[i], 0.0);
+        BOOST_REQUIRE_EQUAL(done[i], 0);
+        continue;
+      }
+
+      CartPole::State nextState;
+      const double reward = environments.Environment(i).Sample(
+          CartPole::State(arma::colvec(previous.col(i))),
+          static_cast<CartPole::Action>(actions[i]), nextState);
+      BOOST_REQUIRE_CLOSE(rewards[i], reward, 1e-5);
+      CheckMatrices(nextState.Encode(), arma::mat(observations.col(i)));
+    }
+
+    // The step limit ends both episodes after the third step.
+    if (step == 2)
+      BOOST_REQUIRE_EQUAL(arma::accu(done), 2);
+  }
+}
+
+/**
+ * Make sure that an external environment exchanges the actions and the
+ * observations through the shared buffers.
+ */
+BOOST_AUTO_TEST_CASE(ExternalEnvironmentTest)
+{
+  // A simulator with 3 instances and 2-dimensional observations: an instance
+  // observes (steps, action), gets the action as reward, and is done after
+  // action 1.
+  std::vector<size_t> sharedActions(3);
+  std::vector<double> sharedObservations(6);
+  std::vector<double> sharedRewards(3);
+  std::vector<arma::uword> sharedDone(3);
+  size_t steps = 0;
+  auto reset = [&]()
+  {
+    steps = 0;
+    std::fill(sharedObservations.begin(), sharedObservations.end(), 0.0);
+  };
+  auto step = [&]()
+  {
+    ++steps;
+    for (size_t i = 0; i < 3; ++i)
+    {
+      sharedObservations[2 * i] = steps;
+      sharedObservations[2 * i + 1] = sharedActions[i];
+      sharedRewards[i] = sharedActions[i];
+      sharedDone[i] = (sharedActions[i] == 1);
+    }
+  };
+
+  ExternalEnvironment environment(2, 3, sharedActions.data(),
+      sharedObservations.data(), sharedRewards.data(), sharedDone.data(),
+      reset, step);
+  BOOST_REQUIRE_EQUAL(environment.NumEnvironments(), 3);
+  BOOST_REQUIRE_EQUAL(environment.Dimension(), 2);
+
+  // The shared buffers are used in place.
+  BOOST_REQUIRE_EQUAL(environment.Observations().memptr(),
+      sharedObservations.data());
+  environment.Reset(environment.Observations());
+  BOOST_REQUIRE_EQUAL(arma::accu(environment.Observations()), 0.0);
+
+  arma::Col<size_t> actions(3);
+  actions[0] = 0;
+  actions[1] = 1;
+  actions[2] = 2;
+  environment.Step(actions, environment.Observations(), environment.Rewards(),
+      environment.Done());
+  BOOST_REQUIRE_EQUAL(environment.Observations().memptr(),
+      sharedObservations.data());
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(sharedActions[i], actions[i]);
+    BOOST_REQUIRE_EQUAL(environment.Observations()(0, i), 1.0);
+    BOOST_REQUIRE_EQUAL(environment.Observations()(1, i), actions[i]);
+    BOOST_REQUIRE_EQUAL(environment.Rewards()[i], actions[i]);
+  }
+
+  // Other buffers get a copy.
+  arma::mat observations;
+  arma::rowvec rewards;
+  arma::urowvec done;
+  environment.Step(actions, observations, rewards, done);
+  CheckMatrices(observations, environment.Observations());
+  BOOST_REQUIRE_EQUAL(observations(0, 0), 2.0);
+  BOOST_REQUIRE_EQUAL(rewards[2], 2.0);
+  BOOST_REQUIRE_EQUAL(done[0], 0);
+  BOOST_REQUIRE_EQUAL(done[1], 1);
+}
+
+/**
+ * Make sure that frame stacking shifts the frames, and appends the state of
+ * the wrapped environment.
+ */
+BOOST_AUTO_TEST_CASE(FrameStackTest)
+{
+  typedef FrameStack<CartPole, 3> StackedCartPole;
+  BOOST_REQUIRE_EQUAL(StackedCartPole::State::dimension, 12);
+
+  StackedCartPole task;
+  StackedCartPole::State state = task.InitialSample();
+  for (size_t i = 0; i < 3; ++i)
+  {
+    CheckMatrices(state.Inner().Encode(),
+        arma::mat(state.Encode().subvec(4 * i, 4 * i + 3)));
+  }
+
+  StackedCartPole::State nextState;
+  const double reward = task.Sample(state, CartPole::Action::forward,
+      nextState);
+
+  CartPole::State innerNextState;
+  const double innerReward = CartPole().Sample(state.Inner(),
+      CartPole::Action::forward, innerNextState);
+  BOOST_REQUIRE_CLOSE(reward, innerReward, 1e-5);
+  CheckMatrices(innerNextState.Encode(), nextState.Inner().Encode());
+  CheckMatrices(arma::mat(state.Encode().tail(8)),
+      arma::mat(nextState.Encode().head(8)));
+  CheckMatrices(innerNextState.Encode(), arma::mat(nextState.Encode().tail(4)));
+}
+
+/**
+ * Make sure that observation normalization keeps the running mean of the
+ * states, and only updates it when asked to.
+ */
+BOOST_AUTO_TEST_CASE(ObservationNormalizationTest)
+{
+  ObservationNormalization<CartPole> task;
+  ObservationNormalization<CartPole>::State state = task.InitialSample();
+  arma::mat seen(4, 6);
+  seen.col(0) = state.Inner().Encode();
+  for (size_t i = 1; i < 6; ++i)
+  {
+    ObservationNormalization<CartPole>::State nextState;
+    task.Sample(state, CartPole::Action::backward, nextState);
+    seen.col(i) = nextState.Inner().Encode();
+    state = nextState;
+  }
+
+  BOOST_REQUIRE_EQUAL(task.Count(), 6);
+  CheckMatrices(arma::mean(seen, 1), task.Mean());
+
+  // The normalized encoding of the last state uses the statistics of all the
+  // states.
+  const arma::colvec expected = (seen.col(5) - arma::mean(seen, 1)) /
+      arma::sqrt(arma::var(seen, 1, 1) + 1e-8);
+  CheckMatrices(expected, state.Encode());
+
+  task.Update() = false;
+  task.Sample(state, CartPole::Action::backward);
+  BOOST_REQUIRE_EQUAL(task.Count(), 6);
+}
+
+/**
+ * Make sure that action repeat takes the action the given number of times and
+ * sums the rewards, and that the wrappers can be nested.
+ */
+BOOST_AUTO_TEST_CASE(ActionRepeatTest)
+{
+  ActionRepeat<CartPole, 3> task;
+  CartPole::State state = task.InitialSample();
+  CartPole::State nextState;
+  const double reward = task.Sample(state, CartPole::Action::forward,
+      nextState);
+
+  CartPole innerTask;
+  CartPole::State expected = state, step;
+  double expectedReward = 0.0;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    expectedReward += innerTask.Sample(expected, CartPole::Action::forward,
+        step);
+    expected = step;
+  }
+
+  BOOST_REQUIRE_CLOSE(reward, expectedReward, 1e-5);
+  CheckMatrices(expected.Encode(), nextState.Encode());
+
+  // The same steps, through nested wrappers.
+  typedef ActionRepeat<FrameStack<ObservationNormalization<CartPole>, 2>, 3>
+      NestedCartPole;
+  BOOST_REQUIRE_EQUAL(NestedCartPole::State::dimension, 8);
+  NestedCartPole nested;
+  NestedCartPole::State nestedState = nested.InitialSample();
+  nestedState.Inner().Inner() = state;
+  NestedCartPole::State nestedNextState;
+  BOOST_REQUIRE_CLOSE(nested.Sample(nestedState, CartPole::Action::forward,
+      nestedNextState), expectedReward, 1e-5);
+  CheckMatrices(expected.Encode(), nestedNextState.Inner().Inner().Encode());
+}
+
+/**
+ * Make sure that the local transport delivers the pushed transitions and the
+ * published parameters.
+ */
+BOOST_AUTO_TEST_CASE(LocalTransportTest)
+{
+  LocalTransport<MountainCar> transport;
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+  double reward = env.Sample(state, action, nextState);
+
+  std::vector<LocalTransport<MountainCar>::TransitionType> transitions;
+  transitions.push_back(std::make_tuple(state, action, reward, nextState,
+      true));
+  transport.Push(transitions);
+  BOOST_REQUIRE_EQUAL(transitions.size(), 0);
+  BOOST_REQUIRE_EQUAL(transport.Pending(), 1);
+
+  RandomReplay<MountainCar> replay(1, 3);
+  BOOST_REQUIRE_EQUAL(transport.Pull(replay), 1);
+  BOOST_REQUIRE_EQUAL(transport.Pending(), 0);
+  BOOST_REQUIRE_EQUAL(replay.Size(), 1);
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+  CheckMatrices(state.Encode(), sampledState);
+  CheckMatrices(nextState.Encode(), sampledNextState);
+  BOOST_REQUIRE_EQUAL(true, arma::as_scalar(sampledTerminal));
+
+  // Nothing is copied until parameters are published.
+  arma::mat parameters(5, 1, arma::fill::zeros);
+  BOOST_REQUIRE_EQUAL(transport.Fetch(parameters, 0), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(parameters), 0.0);
+
+  arma::mat published(5, 1, arma::fill::ones);
+  transport.Publish(published);
+  BOOST_REQUIRE_EQUAL(transport.Fetch(parameters, 0), 1);
+  CheckMatrices(published, parameters);
+
+  // Nothing is copied if the version is current.
+  parameters.zeros();
+  BOOST_REQUIRE_EQUAL(transport.Fetch(parameters, 1), 1);
+  BOOST_REQUIRE_EQUAL(arma::accu(parameters), 0.0);
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -96,6 +96,67 @@ BOOST_AUTO_TEST_CASE(GreedyDescentTest)
   BOOST_REQUIRE_EQUAL(descentPolicy.DescentFeature(0, point, f), 1);
 }
 
+/**
+ * Make sure the incremental greedy descent policy optimizes a separable
+ * function, and that the greedy descent policy works with logistic
+ * regression, both with the default refresh interval and with a full
+ * recomputation at every call.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalGreedyDescentTest)
+{
+  // The partial gradients of the sparse test function only depend on their
+  // own coordinate, so the tree never needs to be refreshed.
+  SparseTestFunction f;
+  SCD<GreedyDescent> s(0.4, 100000, 1e-5, 1e3, GreedyDescent(0));
+
+  arma::mat iterate = f.GetInitialPoint();
+  double result = s.Optimize(f, iterate);
+
+  BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+  BOOST_REQUIRE_CLOSE(iterate[0], 2, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[1], 1, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[2], 1.5, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[3], 4, 0.02);
+
+  arma::mat predictors("0 0 0.4; 0 0 0.6; 0 0.3 0; 0.2 0 0; 0.2 -0.5 0;");
+  arma::Row<size_t> responses("1  1  0;");
+  LogisticRegressionFunction<arma::mat> lrf(predictors, responses, 0.0001);
+
+  SCD<GreedyDescent> s2(0.02, 60000, 1e-5);
+  iterate = lrf.InitialPoint();
+  BOOST_REQUIRE_LE(s2.Optimize(lrf, iterate), 0.055);
+
+  SCD<GreedyDescent> s3(0.02, 60000, 1e-5, 1e3, GreedyDescent(1));
+  iterate = lrf.InitialPoint();
+  BOOST_REQUIRE_LE(s3.Optimize(lrf, iterate), 0.055);
+}
+
+/**
+ * Test SCD with several coordinates updated in parallel at each iteration.
+ */
+BOOST_AUTO_TEST_CASE(BlockSCDTest)
+{
+  SparseTestFunction f;
+  SCD<CyclicDescent> s(0.4, 100000, 1e-5, 1e3, CyclicDescent(), 4);
+
+  arma::mat iterate = f.GetInitialPoint();
+  double result = s.Optimize(f, iterate);
+
+  BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+  BOOST_REQUIRE_CLOSE(iterate[0], 2, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[1], 1, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[2], 1.5, 0.02);
+  BOOST_REQUIRE_CLOSE(iterate[3], 4, 0.02);
+
+  arma::mat predictors("0 0 0.4; 0 0 0.6; 0 0.3 0; 0.2 0 0; 0.2 -0.5 0;");
+  arma::Row<size_t> responses("1  1  0;");
+  LogisticRegressionFunction<arma::mat> lrf(predictors, responses, 0.0001);
+
+  SCD<> s2(0.02, 30000, 1e-5, 1e3, RandomDescent(), 2);
+  iterate = lrf.InitialPoint();
+  BOOST_REQUIRE_LE(s2.Optimize(lrf, iterate), 0.055);
+}
+
 /**
  * Test the cyclic descent policy.
  */
@@ -193,7 +254,7 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionPartialGradientTest)
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Create a random set of parameters.
   arma::mat parameters;
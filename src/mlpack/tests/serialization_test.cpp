@@ -1240,16 +1240,19 @@ BOOST_AUTO_TEST_CASE(LSHTest)
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), textLsh.BucketSize());
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), binaryLsh.BucketSize());
 
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      xmlLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      textLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      binaryLsh.SecondHashTable().size());
-
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      textLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  // SecondHashTable() builds a copy, so only do it once per model.
+  const std::vector<arma::Col<size_t>> table = lsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> xmlTable = xmlLsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> textTable = textLsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> binaryTable =
+      binaryLsh.SecondHashTable();
+
+  BOOST_REQUIRE_EQUAL(table.size(), xmlTable.size());
+  BOOST_REQUIRE_EQUAL(table.size(), textTable.size());
+  BOOST_REQUIRE_EQUAL(table.size(), binaryTable.size());
+
+  for (size_t i = 0; i < table.size(); ++i)
+    CheckMatrices(table[i], xmlTable[i], textTable[i], binaryTable[i]);
 }
 
 // Make sure serialization works for the decision stump.
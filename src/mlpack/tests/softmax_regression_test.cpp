@@ -39,7 +39,7 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // Create a SoftmaxRegressionFunction. Regularization term ignored.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -84,9 +84,9 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionRegularizationEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // 3 objects for comparing regularization costs.
-  SoftmaxRegressionFunction srfNoReg(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srfSmallReg(data, labels, numClasses, 1);
-  SoftmaxRegressionFunction srfBigReg(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srfNoReg(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srfSmallReg(data, labels, numClasses, 1);
+  SoftmaxRegressionFunction<> srfBigReg(data, labels, numClasses, 20);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -126,8 +126,8 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf1(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srf2(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srf1(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf2(data, labels, numClasses, 20);
 
   // Create a random set of parameters.
   arma::mat parameters;
@@ -669,4 +669,70 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionComputeProbabilitiesAndLabelsTest)
   }
 }
 
+/**
+ * The objective function and gradient should be the same for sparse and dense
+ * data, with and without the intercept, including when the points are split
+ * into several blocks.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionSparseTest)
+{
+  arma::sp_mat data;
+  data.sprandu(20, 5000, 0.2);
+  const arma::mat denseData(data);
+  const arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(5000,
+      arma::distr_param(0, 3));
+
+  for (const bool fitIntercept : { false, true })
+  {
+    SoftmaxRegressionFunction<> srf(denseData, labels, 4, 0.1, fitIntercept);
+    SoftmaxRegressionFunction<arma::sp_mat> srfSparse(data, labels, 4, 0.1,
+        fitIntercept);
+
+    const arma::mat parameters = srf.GetInitialPoint() + 0.5 *
+        arma::randn(arma::size(srf.GetInitialPoint()));
+
+    BOOST_REQUIRE_CLOSE(srf.Evaluate(parameters),
+        srfSparse.Evaluate(parameters), 1e-5);
+    BOOST_REQUIRE_CLOSE(srf.Evaluate(parameters, 100, 50),
+        srfSparse.Evaluate(parameters, 100, 50), 1e-5);
+
+    arma::mat gradient, sparseGradient;
+    const double objective = srf.EvaluateWithGradient(parameters, gradient);
+    srfSparse.Gradient(parameters, sparseGradient);
+    BOOST_REQUIRE_CLOSE(objective, srf.Evaluate(parameters), 1e-5);
+    CheckMatrices(gradient, sparseGradient);
+
+    srf.Gradient(parameters, 100, gradient, 50);
+    srfSparse.Gradient(parameters, 100, sparseGradient, 50);
+    CheckMatrices(gradient, sparseGradient);
+  }
+}
+
+/**
+ * Training with sparse data should give the same model as training with the
+ * same data as a dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionSparseTrainTest)
+{
+  arma::sp_mat data;
+  data.sprandu(10, 800, 0.3);
+  const arma::mat denseData(data);
+  const arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(800,
+      arma::distr_param(0, 2));
+
+  SoftmaxRegression sr(10, 3, true);
+  SoftmaxRegression srSparse(10, 3, true);
+  srSparse.Parameters() = sr.Parameters();
+
+  sr.Train(denseData, labels, 3);
+  srSparse.Train(data, labels, 3);
+
+  CheckMatrices(sr.Parameters(), srSparse.Parameters(), 1e-3);
+
+  arma::Row<size_t> predictions, sparsePredictions;
+  sr.Classify(denseData, predictions);
+  srSparse.Classify(data, sparsePredictions);
+  CheckMatrices(predictions, sparsePredictions);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
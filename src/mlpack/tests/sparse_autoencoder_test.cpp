@@ -268,4 +268,63 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionGradient)
   }
 }
 
+/**
+ * Make sure that EvaluateWithGradient() matches Evaluate() and Gradient(), on
+ * the whole dataset and on a batch, for any number of threads, and that the
+ * gradient of a batch is correct.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionEvaluateWithGradient)
+{
+  const size_t oldCount = Threads::Count();
+
+  const size_t vSize = 20;
+  const size_t hSize = 10;
+  arma::mat data;
+  data.randu(vSize, 2000);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.1, 2, 0.05);
+  const arma::mat parameters = saf.GetInitialPoint();
+
+  Threads::SetCount(1);
+  arma::mat gradient, batchGradient;
+  const double cost = saf.Evaluate(parameters);
+  saf.Gradient(parameters, gradient);
+  const double batchCost = saf.Evaluate(parameters, 300, 700);
+  saf.Gradient(parameters, 300, batchGradient, 700);
+
+  for (size_t threads = 1; threads <= 4; threads += 3)
+  {
+    Threads::SetCount(threads);
+
+    arma::mat fusedGradient;
+    BOOST_REQUIRE_CLOSE(saf.EvaluateWithGradient(parameters, fusedGradient),
+        cost, 1e-8);
+    CheckMatrices(fusedGradient, gradient);
+
+    BOOST_REQUIRE_CLOSE(saf.EvaluateWithGradient(parameters, 300,
+        fusedGradient, 700), batchCost, 1e-8);
+    CheckMatrices(fusedGradient, batchGradient);
+  }
+
+  // Check a few elements of the batch gradient numerically.
+  const double epsilon = 0.0001;
+  arma::mat perturbed = parameters;
+  for (size_t k = 0; k < 20; ++k)
+  {
+    const size_t i = k % (2 * hSize + 1);
+    const size_t j = (3 * k) % vSize;
+
+    perturbed(i, j) += epsilon;
+    const double costPlus = saf.Evaluate(perturbed, 300, 700);
+    perturbed(i, j) -= 2 * epsilon;
+    const double costMinus = saf.Evaluate(perturbed, 300, 700);
+    perturbed(i, j) += epsilon;
+
+    BOOST_REQUIRE_CLOSE((costPlus - costMinus) / (2 * epsilon),
+        batchGradient(i, j), 1e-2);
+  }
+
+  Threads::SetCount(oldCount);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -190,4 +190,30 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
 }
 
 
+/**
+ * Make sure that encoding the points in parallel gives the same codes as
+ * encoding them on one thread.
+ */
+BOOST_AUTO_TEST_CASE(SparseCodingParallelEncodeTest)
+{
+  const size_t oldThreads = Threads::Count();
+
+  mat X;
+  X.load("mnist_first250_training_4s_and_9s.arm");
+  for (uword i = 0; i < X.n_cols; ++i)
+    X.col(i) /= norm(X.col(i), 2);
+
+  SparseCoding sc(25, 0.1, 0.2);
+  DataDependentRandomInitializer::Initialize(X, 25, sc.Dictionary());
+
+  mat serialCodes, parallelCodes;
+  Threads::SetCount(1);
+  sc.Encode(X, serialCodes);
+  Threads::SetCount(4);
+  sc.Encode(X, parallelCodes);
+  Threads::SetCount(oldThreads);
+
+  CheckMatrices(serialCodes, parallelCodes);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
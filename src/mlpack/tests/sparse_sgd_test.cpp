@@ -0,0 +1,93 @@
+/**
+ * @file sparse_sgd_test.cpp
+ *
+ * Test file for SparseSGD and the lazy update policies.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/sparse_sgd/sparse_sgd.hpp>
+#include <mlpack/core/optimizers/sgd/update_policies/momentum_update.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/sparse_test_function.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace std;
+using namespace arma;
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::optimization::test;
+
+BOOST_AUTO_TEST_SUITE(SparseSGDTest);
+
+/**
+ * Make sure that the lazy momentum update with weight decay gives the same
+ * iterate as the dense momentum update with the regularized gradient.
+ */
+BOOST_AUTO_TEST_CASE(LazyMomentumMatchesDenseMomentumTest)
+{
+  const double stepSize = 0.05;
+  const double lambda = 0.3;
+
+  arma::mat lazyIterate(20, 3, arma::fill::randu);
+  arma::mat denseIterate = lazyIterate;
+
+  LazyMomentumUpdate lazy(0.7, lambda);
+  MomentumUpdate dense(0.7);
+  lazy.Initialize(20, 3);
+  dense.Initialize(20, 3);
+
+  for (size_t i = 0; i < 50; ++i)
+  {
+    arma::sp_mat gradient = arma::sprandu<arma::sp_mat>(20, 3, 0.05);
+
+    lazy.Update(lazyIterate, stepSize, gradient);
+    arma::mat denseGradient = arma::mat(gradient) + lambda * denseIterate;
+    dense.Update(denseIterate, stepSize, denseGradient);
+  }
+
+  lazy.Finalize(lazyIterate, stepSize);
+  for (size_t i = 0; i < lazyIterate.n_elem; ++i)
+  {
+    if (std::abs(denseIterate[i]) < 1e-10)
+      BOOST_REQUIRE_SMALL(lazyIterate[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(lazyIterate[i], denseIterate[i], 1e-6);
+  }
+}
+
+/**
+ * Minimize the sparse test function with SparseSGD and both lazy update
+ * policies.
+ */
+BOOST_AUTO_TEST_CASE(SimpleSparseSGDTest)
+{
+  SparseTestFunction f;
+
+  SparseSGD<> s(0.1, 1, 100000, 1e-9, true, LazyMomentumUpdate(0.5));
+  arma::mat coordinates = f.GetInitialPoint();
+  double result = s.Optimize(f, coordinates);
+
+  // The optimum is at the vertices of the parabolas.
+  BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+  BOOST_REQUIRE_CLOSE(coordinates[0], 2, 0.02);
+  BOOST_REQUIRE_CLOSE(coordinates[1], 1, 0.02);
+  BOOST_REQUIRE_CLOSE(coordinates[2], 1.5, 0.02);
+  BOOST_REQUIRE_CLOSE(coordinates[3], 4, 0.02);
+
+  LazyAdam adam(0.01, 1, 100000, 1e-9, true);
+  coordinates = f.GetInitialPoint();
+  result = adam.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_CLOSE(result, 123.75, 0.1);
+  BOOST_REQUIRE_CLOSE(coordinates[0], 2, 1.0);
+  BOOST_REQUIRE_CLOSE(coordinates[1], 1, 1.0);
+  BOOST_REQUIRE_CLOSE(coordinates[2], 1.5, 1.0);
+  BOOST_REQUIRE_CLOSE(coordinates[3], 4, 1.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
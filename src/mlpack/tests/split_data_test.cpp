@@ -170,4 +170,71 @@ BOOST_AUTO_TEST_CASE(SplitLabeledDataLargerTest)
   CheckDuplication(std::get<2>(value), std::get<3>(value));
 }
 
+/**
+ * Make sure that SplitInPlace() rearranges the input so that the returned
+ * aliases hold all the points, once each.
+ */
+BOOST_AUTO_TEST_CASE(SplitLabeledDataInPlaceTest)
+{
+  mat input(10, 497);
+  input.randu();
+  const mat original(input);
+
+  // Set the labels to the column ID.
+  Row<size_t> labels = arma::linspace<Row<size_t>>(0, input.n_cols - 1,
+      input.n_cols);
+
+  const auto value = SplitInPlace(input, labels, 0.3);
+  BOOST_REQUIRE_EQUAL(std::get<0>(value).n_cols, 497 - size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(std::get<1>(value).n_cols, size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(std::get<2>(value).n_cols, 497 - size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(std::get<3>(value).n_cols, size_t(0.3 * 497));
+
+  // The results are views of the input.
+  BOOST_REQUIRE_EQUAL(std::get<0>(value).memptr(), input.memptr());
+  BOOST_REQUIRE_EQUAL(std::get<1>(value).memptr(),
+      input.colptr(std::get<0>(value).n_cols));
+  BOOST_REQUIRE_EQUAL(std::get<2>(value).memptr(), labels.memptr());
+
+  CompareData(original, std::get<0>(value), std::get<2>(value));
+  CompareData(original, std::get<1>(value), std::get<3>(value));
+  CompareData(original, input, labels);
+
+  CheckDuplication(std::get<2>(value), std::get<3>(value));
+}
+
+/**
+ * Make sure that a stratified split holds out the same fraction of each class,
+ * both when copying and in place.
+ */
+BOOST_AUTO_TEST_CASE(StratifiedSplitTest)
+{
+  // 300 points of class 0, 100 points of class 1 and 50 of class 2.
+  mat input(3, 450);
+  input.randu();
+  Row<size_t> labels(450);
+  labels.subvec(0, 299).fill(0);
+  labels.subvec(300, 399).fill(1);
+  labels.subvec(400, 449).fill(2);
+
+  mat trainData, testData;
+  Row<size_t> trainLabels, testLabels;
+  Split(input, labels, trainData, testData, trainLabels, testLabels, 0.2,
+      true);
+  BOOST_REQUIRE_EQUAL(trainData.n_cols, 360);
+  BOOST_REQUIRE_EQUAL(testData.n_cols, 90);
+  BOOST_REQUIRE_EQUAL(accu(testLabels == 0), 60);
+  BOOST_REQUIRE_EQUAL(accu(testLabels == 1), 20);
+  BOOST_REQUIRE_EQUAL(accu(testLabels == 2), 10);
+  BOOST_REQUIRE_EQUAL(accu(trainLabels == 0), 240);
+  BOOST_REQUIRE_EQUAL(accu(trainLabels == 1), 80);
+  BOOST_REQUIRE_EQUAL(accu(trainLabels == 2), 40);
+
+  const auto value = SplitInPlace(input, labels, 0.2, true);
+  BOOST_REQUIRE_EQUAL(std::get<1>(value).n_cols, 90);
+  BOOST_REQUIRE_EQUAL(accu(std::get<3>(value) == 0), 60);
+  BOOST_REQUIRE_EQUAL(accu(std::get<3>(value) == 1), 20);
+  BOOST_REQUIRE_EQUAL(accu(std::get<3>(value) == 2), 10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -74,4 +74,41 @@ BOOST_AUTO_TEST_CASE(SVRGBBLogisticRegressionTest)
   }
 }
 
+/**
+ * Make sure the full gradient computed with several threads is the same as the
+ * one computed serially.
+ */
+BOOST_AUTO_TEST_CASE(ParallelFullGradientTest)
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  LogisticRegressionFunction<> lrf(shuffledData, shuffledResponses, 0.5);
+  arma::mat coordinates(1, shuffledData.n_rows + 1, arma::fill::randu);
+
+  arma::mat gradient, parallelGradient;
+  const double objective = FullEvaluateWithGradient(lrf, coordinates, 37,
+      gradient, 1);
+  const double parallelObjective = FullEvaluateWithGradient(lrf,
+      coordinates, 37, parallelGradient, 4);
+
+  BOOST_REQUIRE_CLOSE(objective, lrf.Evaluate(coordinates), 1e-8);
+  BOOST_REQUIRE_CLOSE(parallelObjective, objective, 1e-8);
+  CheckMatrices(parallelGradient, gradient, 1e-8);
+
+  // Run SVRG with all the threads.
+  SVRG optimizer(0.001, 40, 250, 0, 1e-3, true, SVRGUpdate(), NoDecay(), true,
+      0);
+  LogisticRegression<> lr(shuffledData, shuffledResponses, optimizer, 0.5);
+
+  const double acc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 1.5); // 1.5% error tolerance.
+
+  const double testAcc = lr.ComputeAccuracy(testData, testResponses);
+  BOOST_REQUIRE_CLOSE(testAcc, 100.0, 1.5); // 1.5% error tolerance.
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,149 @@
+/**
+ * @file threads_test.cpp
+ *
+ * Tests for the Threads class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+
+BOOST_AUTO_TEST_SUITE(ThreadsTest);
+
+/**
+ * Make sure that ParallelFor() calls the function once for every index, also
+ * when it is nested.
+ */
+BOOST_AUTO_TEST_CASE(ParallelForTest)
+{
+  const size_t previousCount = Threads::Count();
+  Threads::SetCount(4);
+
+  arma::Mat<size_t> calls(10, 1000, arma::fill::zeros);
+  Threads::ParallelFor(0, 1000, [&](const size_t i)
+  {
+    Threads::ParallelFor(0, 10, [&](const size_t j) { ++calls(j, i); });
+  });
+
+  for (size_t i = 0; i < calls.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(calls[i], (size_t) 1);
+
+  Threads::SetCount(previousCount);
+}
+
+/**
+ * Make sure that an exception thrown by a call reaches the caller.
+ */
+BOOST_AUTO_TEST_CASE(ParallelForExceptionTest)
+{
+  BOOST_REQUIRE_THROW(Threads::ParallelFor(0, 100, [](const size_t i)
+  {
+    if (i == 50)
+      throw std::invalid_argument("failure");
+  }), std::invalid_argument);
+}
+
+/**
+ * Make sure that the number of threads can be set.
+ */
+BOOST_AUTO_TEST_CASE(SetCountTest)
+{
+  const size_t previousCount = Threads::Count();
+
+  Threads::SetCount(1);
+  BOOST_REQUIRE_EQUAL(Threads::Count(), (size_t) 1);
+
+  // Without OpenMP, there is only ever one thread.
+  #ifdef HAS_OPENMP
+  Threads::SetCount(3);
+  BOOST_REQUIRE_EQUAL(Threads::Count(), (size_t) 3);
+  Threads::SetCount(0);
+  BOOST_REQUIRE_EQUAL(Threads::Count(), Threads::Available());
+  #endif
+
+  Threads::SetCount(previousCount);
+}
+
+/**
+ * Make sure that ParallelRanges() cuts the indices into contiguous ranges that
+ * cover every index once.
+ */
+BOOST_AUTO_TEST_CASE(ParallelRangesTest)
+{
+  const size_t previousCount = Threads::Count();
+  Threads::SetCount(4);
+
+  const size_t numRanges = Threads::Ranges(10, 1010);
+  BOOST_REQUIRE_GE(numRanges, (size_t) 1);
+  BOOST_REQUIRE_LE(numRanges, (size_t) 4);
+  BOOST_REQUIRE_EQUAL(Threads::Ranges(5, 6), (size_t) 1);
+
+  arma::Col<size_t> calls(1010, arma::fill::zeros);
+  arma::Col<size_t> rangeBegins(numRanges), rangeEnds(numRanges);
+  Threads::ParallelRanges(10, 1010, [&](const size_t range,
+                                        const size_t begin,
+                                        const size_t end)
+  {
+    rangeBegins[range] = begin;
+    rangeEnds[range] = end;
+    for (size_t i = begin; i < end; ++i)
+      ++calls[i];
+  });
+
+  for (size_t i = 0; i < calls.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(calls[i], (size_t) (i < 10 ? 0 : 1));
+  BOOST_REQUIRE_EQUAL(rangeBegins[0], (size_t) 10);
+  BOOST_REQUIRE_EQUAL(rangeEnds[numRanges - 1], (size_t) 1010);
+  for (size_t i = 1; i < numRanges; ++i)
+    BOOST_REQUIRE_EQUAL(rangeBegins[i], rangeEnds[i - 1]);
+
+  BOOST_REQUIRE_THROW(Threads::ParallelRanges(0, 100, [](const size_t range,
+                                                         const size_t,
+                                                         const size_t)
+  {
+    if (range == 0)
+      throw std::invalid_argument("failure");
+  }), std::invalid_argument);
+
+  Threads::SetCount(previousCount);
+}
+
+/**
+ * Make sure that placing matrices on the NUMA nodes keeps their contents, and
+ * that the number of available cores does not change.
+ */
+BOOST_AUTO_TEST_CASE(NumaPlacementTest)
+{
+  const size_t previousCount = Threads::Count();
+  const size_t available = Threads::Available();
+  Threads::SetCount(4);
+  Threads::SetNumaAware(true);
+  BOOST_REQUIRE(Threads::NumaAware());
+  BOOST_REQUIRE_EQUAL(Threads::Available(), available);
+
+  const arma::mat original = arma::randu<arma::mat>(13, 5000);
+  arma::mat matrix(original);
+  Threads::FirstTouch(matrix);
+  CheckMatrices(matrix, original);
+  Threads::Interleave(matrix);
+  CheckMatrices(matrix, original);
+
+  arma::fmat empty;
+  Threads::FirstTouch(empty);
+  Threads::Interleave(empty);
+  BOOST_REQUIRE_EQUAL(empty.n_elem, 0);
+
+  Threads::SetNumaAware(false);
+  BOOST_REQUIRE(!Threads::NumaAware());
+  BOOST_REQUIRE_EQUAL(Threads::Available(), available);
+  Threads::SetCount(previousCount);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
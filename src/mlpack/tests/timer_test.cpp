@@ -147,4 +147,129 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+/**
+ * Nested profiled scopes should be accumulated as a call tree.
+ */
+BOOST_AUTO_TEST_CASE(ProfilerNestedScopeTest)
+{
+  Timer::EnableTiming();
+  Profiler::Reset();
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    MLPACK_PROFILE_SCOPE("profiler_outer");
+    for (size_t j = 0; j < 2; ++j)
+    {
+      MLPACK_PROFILE_SCOPE("profiler_inner");
+    }
+  }
+
+  std::ostringstream oss;
+  Profiler::Print(oss);
+  Timer::DisableTiming();
+
+#ifndef MLPACK_NO_PROFILING
+  const std::string profile = oss.str();
+  const size_t outer = profile.find("  profiler_outer: ");
+  const size_t inner = profile.find("    profiler_inner: ");
+  BOOST_REQUIRE(outer != std::string::npos);
+  BOOST_REQUIRE(inner != std::string::npos);
+  BOOST_REQUIRE_GT(inner, outer);
+  BOOST_REQUIRE(profile.find("(3 calls)") != std::string::npos);
+  BOOST_REQUIRE(profile.find("(6 calls)") != std::string::npos);
+#else
+  BOOST_REQUIRE(oss.str().empty());
+#endif
+}
+
+/**
+ * Scopes entered in several threads should all be recorded in the trace, and
+ * nothing should be recorded while profiling is disabled.
+ */
+BOOST_AUTO_TEST_CASE(ProfilerTraceTest)
+{
+  Timer::EnableTiming();
+  Profiler::Reset();
+  Profiler::RecordTrace(true);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    threads.push_back(std::thread([]()
+        {
+          MLPACK_PROFILE_SCOPE("profiler_\"thread\"");
+        }));
+  }
+
+  for (size_t i = 0; i < 3; ++i)
+    threads[i].join();
+
+  Timer::DisableTiming();
+  {
+    MLPACK_PROFILE_SCOPE("profiler_disabled");
+  }
+
+  std::ostringstream oss;
+  Profiler::ExportTrace(oss);
+  Profiler::RecordTrace(false);
+
+  const std::string trace = oss.str();
+  BOOST_REQUIRE_EQUAL(trace.find("{\"traceEvents\": ["), (size_t) 0);
+  BOOST_REQUIRE(trace.find("profiler_disabled") == std::string::npos);
+
+#ifndef MLPACK_NO_PROFILING
+  // The quotes in the name must be escaped.
+  const std::string name = "\"name\": \"profiler_\\\"thread\\\"\"";
+  size_t events = 0;
+  for (size_t pos = trace.find(name); pos != std::string::npos;
+      pos = trace.find(name, pos + 1))
+  {
+    ++events;
+  }
+  BOOST_REQUIRE_EQUAL(events, 3);
+#endif
+}
+
+/**
+ * Make sure that timed phases record the memory they use.
+ */
+BOOST_AUTO_TEST_CASE(MemoryUsagePhaseTest)
+{
+  Timer::EnableTiming();
+  MemoryUsage::Enable();
+  MemoryUsage::Reset();
+
+  Timer::Start("memory_phase");
+  arma::mat data(1000, 10000);
+  data.fill(1.0);
+  Timer::Stop("memory_phase");
+
+  const std::map<std::string, PhaseMemory> phases = MemoryUsage::GetAll();
+  BOOST_REQUIRE_EQUAL(phases.count("memory_phase"), (size_t) 1);
+  BOOST_REQUIRE_EQUAL(phases.at("memory_phase").calls, (size_t) 1);
+
+  // The resident memory can only be read on some systems.
+  if (MemoryUsage::Resident() > 0)
+  {
+    BOOST_REQUIRE_GT(phases.at("memory_phase").residentChange,
+        (long long) (data.n_elem * sizeof(double) / 2));
+  }
+
+  MemoryUsage::Disable();
+  MemoryUsage::Reset();
+  Timer::ResetAll();
+}
+
+/**
+ * Make sure that the size of a model is estimated correctly.
+ */
+BOOST_AUTO_TEST_CASE(MemoryUsageModelBytesTest)
+{
+  arma::mat data(100, 1000, arma::fill::randu);
+  const size_t bytes = MemoryUsage::ModelBytes(data);
+
+  BOOST_REQUIRE_GE(bytes, data.n_elem * sizeof(double));
+  BOOST_REQUIRE_LT(bytes, data.n_elem * sizeof(double) + 1024);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1041,6 +1041,63 @@ BOOST_AUTO_TEST_CASE(HRectBoundDiameter)
   BOOST_REQUIRE_SMALL(d.Diameter(), 1e-5);
 }
 
+/**
+ * Ensure that the batched distances to several bounds are the same as the
+ * distances to each bound, and that they match a brute-force computation for a
+ * metric that is neither L1 nor L2.
+ */
+BOOST_AUTO_TEST_CASE(HRectBoundBatchDistance)
+{
+  arma::mat corners = arma::randu<arma::mat>(10, 2);
+  HRectBound<LMetric<3, true>> b(5);
+  for (size_t d = 0; d < 5; ++d)
+    b[d] = math::Range(corners(d, 0), corners(d, 0) + corners(d, 1));
+
+  std::vector<HRectBound<LMetric<3, true>>> others(20,
+      HRectBound<LMetric<3, true>>(5));
+  std::vector<const HRectBound<LMetric<3, true>>*> otherPtrs;
+  for (size_t i = 0; i < others.size(); ++i)
+  {
+    arma::vec lo = 3.0 * arma::randu<arma::vec>(5) - 1.0;
+    arma::vec width = arma::randu<arma::vec>(5);
+    for (size_t d = 0; d < 5; ++d)
+      others[i][d] = math::Range(lo[d], lo[d] + width[d]);
+    otherPtrs.push_back(&others[i]);
+  }
+
+  arma::vec minDistances, maxDistances;
+  b.MinDistance(otherPtrs, minDistances);
+  b.MaxDistance(otherPtrs, maxDistances);
+  BOOST_REQUIRE_EQUAL(minDistances.n_elem, others.size());
+  BOOST_REQUIRE_EQUAL(maxDistances.n_elem, others.size());
+
+  for (size_t i = 0; i < others.size(); ++i)
+  {
+    double minSum = 0.0, maxSum = 0.0;
+    for (size_t d = 0; d < 5; ++d)
+    {
+      const double gap = std::max(0.0, std::max(others[i][d].Lo() - b[d].Hi(),
+          b[d].Lo() - others[i][d].Hi()));
+      const double span = std::max(others[i][d].Hi() - b[d].Lo(),
+          b[d].Hi() - others[i][d].Lo());
+      minSum += std::pow(gap, 3.0);
+      maxSum += std::pow(span, 3.0);
+    }
+
+    BOOST_REQUIRE_EQUAL(minDistances[i], b.MinDistance(others[i]));
+    BOOST_REQUIRE_EQUAL(maxDistances[i], b.MaxDistance(others[i]));
+    if (minSum == 0.0)
+      BOOST_REQUIRE_SMALL(minDistances[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(minDistances[i], std::pow(minSum, 1.0 / 3.0), 1e-5);
+    BOOST_REQUIRE_CLOSE(maxDistances[i], std::pow(maxSum, 1.0 / 3.0), 1e-5);
+
+    const math::Range range = b.RangeDistance(others[i]);
+    BOOST_REQUIRE_EQUAL(range.Lo(), minDistances[i]);
+    BOOST_REQUIRE_EQUAL(range.Hi(), maxDistances[i]);
+  }
+}
+
 /**
  * It seems as though Bill has stumbled across a bug where
  * BinarySpaceTree<>::count() returns something different than
@@ -1359,6 +1416,182 @@ BOOST_AUTO_TEST_CASE(KdTreeTest)
   TreeType root(dataset);
 }
 
+/**
+ * The subtrees of large nodes may be built concurrently; make sure that the
+ * resulting tree and point permutation don't depend on that.
+ */
+BOOST_AUTO_TEST_CASE(KdTreeDeterministicBuildTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset = arma::randu<arma::mat>(4, 10000);
+
+  std::vector<size_t> oldFromNew, otherOldFromNew;
+  TreeType root(dataset, oldFromNew);
+  TreeType otherRoot(dataset, otherOldFromNew);
+
+  BOOST_REQUIRE(oldFromNew == otherOldFromNew);
+  BOOST_REQUIRE_EQUAL(root.NumDescendants(), otherRoot.NumDescendants());
+  BOOST_REQUIRE(CheckPointBounds(root));
+
+  std::vector<TreeType*> nodes, otherNodes;
+  GenerateVectorOfTree(&root, 1, nodes);
+  GenerateVectorOfTree(&otherRoot, 1, otherNodes);
+
+  BOOST_REQUIRE_EQUAL(nodes.size(), otherNodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(nodes[i] == NULL, otherNodes[i] == NULL);
+    if (nodes[i] != NULL)
+    {
+      BOOST_REQUIRE_EQUAL(nodes[i]->Begin(), otherNodes[i]->Begin());
+      BOOST_REQUIRE_EQUAL(nodes[i]->Count(), otherNodes[i]->Count());
+    }
+  }
+}
+
+/**
+ * Make sure that compacting a kd-tree keeps its structure intact and places all
+ * of the descendants of the root next to each other, in breadth-first order.
+ */
+BOOST_AUTO_TEST_CASE(KdTreeCompactLayoutTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+
+  TreeType root(dataset);
+  TreeType otherRoot(root);
+  root.CompactLayout();
+
+  BOOST_REQUIRE(root.IsCompacted());
+  BOOST_REQUIRE(!otherRoot.IsCompacted());
+  BOOST_REQUIRE(CheckPointBounds(root));
+
+  std::vector<TreeType*> nodes, otherNodes;
+  GenerateVectorOfTree(&root, 1, nodes);
+  GenerateVectorOfTree(&otherRoot, 1, otherNodes);
+
+  BOOST_REQUIRE_EQUAL(nodes.size(), otherNodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(nodes[i] == NULL, otherNodes[i] == NULL);
+    if (nodes[i] != NULL)
+    {
+      BOOST_REQUIRE_EQUAL(nodes[i]->Begin(), otherNodes[i]->Begin());
+      BOOST_REQUIRE_EQUAL(nodes[i]->Count(), otherNodes[i]->Count());
+      if (nodes[i]->Parent() != NULL)
+      {
+        BOOST_REQUIRE((nodes[i]->Parent()->Left() == nodes[i]) ||
+                      (nodes[i]->Parent()->Right() == nodes[i]));
+      }
+    }
+  }
+
+  // Walk the tree in breadth-first order; the nodes must be consecutive.
+  std::queue<TreeType*> queue;
+  queue.push(&root);
+  TreeType* next = root.Left();
+  while (!queue.empty())
+  {
+    TreeType* node = queue.front();
+    queue.pop();
+    if (node->IsLeaf())
+      continue;
+
+    BOOST_REQUIRE_EQUAL(node->Left(), next);
+    BOOST_REQUIRE_EQUAL(node->Right(), next + 1);
+    next += 2;
+    queue.push(node->Left());
+    queue.push(node->Right());
+  }
+
+  // A copy of a compacted tree is an ordinary tree.
+  TreeType copy(root);
+  BOOST_REQUIRE(!copy.IsCompacted());
+  BOOST_REQUIRE_EQUAL(copy.NumDescendants(), root.NumDescendants());
+}
+
+/**
+ * Check that the children of every node split its range of points exactly, and
+ * that no leaf is empty (unless it is the root).
+ */
+template<typename TreeType>
+bool CheckNodeRanges(const TreeType& node)
+{
+  if (node.IsLeaf())
+    return (node.Count() > 0) || (node.Parent() == NULL);
+
+  if (node.Left()->Begin() != node.Begin() ||
+      node.Right()->Begin() != node.Begin() + node.Left()->Count() ||
+      node.Left()->Count() + node.Right()->Count() != node.Count())
+    return false;
+
+  return CheckNodeRanges(*node.Left()) && CheckNodeRanges(*node.Right());
+}
+
+/**
+ * Insert points into a kd-tree and delete points from it, and make sure that
+ * the tree stays consistent with its dataset after every change.
+ */
+BOOST_AUTO_TEST_CASE(KdTreeInsertDeleteTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat points = arma::randu<arma::mat>(3, 2500);
+  // Make the later points fall into a small region, so that some subtrees get
+  // much deeper than the others.
+  points.cols(1000, 2499) *= 0.05;
+
+  std::vector<size_t> oldFromNew;
+  TreeType root(points.cols(0, 999), oldFromNew);
+
+  for (size_t batch = 0; batch < 3; ++batch)
+  {
+    root.InsertPoints(points.cols(1000 + 500 * batch, 1499 + 500 * batch),
+        oldFromNew);
+
+    BOOST_REQUIRE_EQUAL(root.Count(), 1500 + 500 * batch);
+    BOOST_REQUIRE_EQUAL(oldFromNew.size(), root.Dataset().n_cols);
+    BOOST_REQUIRE(CheckNodeRanges(root));
+    BOOST_REQUIRE(CheckPointBounds(root));
+    for (size_t i = 0; i < oldFromNew.size(); ++i)
+    {
+      BOOST_REQUIRE_SMALL(arma::norm(root.Dataset().col(i) -
+          points.col(oldFromNew[i])), 1e-12);
+    }
+  }
+
+  // Delete every third point, and an identifier that isn't in the tree.
+  std::vector<size_t> toDelete;
+  for (size_t i = 0; i < 2500; i += 3)
+    toDelete.push_back(i);
+  toDelete.push_back(10000);
+
+  BOOST_REQUIRE_EQUAL(root.DeletePoints(toDelete, oldFromNew), 834);
+  BOOST_REQUIRE_EQUAL(root.Count(), 2500 - 834);
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), root.Dataset().n_cols);
+  BOOST_REQUIRE(CheckNodeRanges(root));
+  BOOST_REQUIRE(CheckPointBounds(root));
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    BOOST_REQUIRE_NE(oldFromNew[i] % 3, (size_t) 0);
+    BOOST_REQUIRE_SMALL(arma::norm(root.Dataset().col(i) -
+        points.col(oldFromNew[i])), 1e-12);
+  }
+
+  // Deleting everything leaves an empty root, which can be filled again.
+  std::vector<size_t> all(oldFromNew);
+  root.DeletePoints(all, oldFromNew);
+  BOOST_REQUIRE_EQUAL(root.Count(), 0);
+  BOOST_REQUIRE(root.IsLeaf());
+
+  root.InsertPoints(points.cols(0, 99), oldFromNew);
+  BOOST_REQUIRE_EQUAL(root.Count(), 100);
+  BOOST_REQUIRE(CheckNodeRanges(root));
+  BOOST_REQUIRE(CheckPointBounds(root));
+}
+
 BOOST_AUTO_TEST_CASE(MaxRPTreeTest)
 {
   typedef MaxRPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
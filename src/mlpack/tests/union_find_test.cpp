@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/dbscan/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,35 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+
+/**
+ * Union a set of chains from several threads at once, and make sure the
+ * concurrent union-find ends up with the right components, each rooted at its
+ * smallest element.
+ */
+BOOST_AUTO_TEST_CASE(TestConcurrentUnion)
+{
+  static const size_t testSize = 10000;
+  static const size_t components = 7;
+  dbscan::ConcurrentUnionFind testUnionFind(testSize);
+
+  // Point i belongs to component i % components; link it to the next point
+  // of the same component and to a random one.
+  arma::Col<size_t> partners(testSize);
+  for (size_t i = 0; i < testSize; ++i)
+    partners[i] = math::RandInt(testSize / components) * components +
+        i % components;
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) testSize; ++i)
+  {
+    testUnionFind.Union(i, partners[i]);
+    if ((size_t) i + components < testSize)
+      testUnionFind.Union(i, i + components);
+  }
+
+  for (size_t i = 0; i < testSize; ++i)
+    BOOST_REQUIRE_EQUAL(testUnionFind.Find(i), i % components);
+}
+
 BOOST_AUTO_TEST_SUITE_END();